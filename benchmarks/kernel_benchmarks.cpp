@@ -0,0 +1,438 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+// Kernel microbenchmarks over synthetic Gaussian sets. Every case is warmed up and then timed
+// with a CUDA event pair per repetition, results are the median, p95, min and mean over the
+// repetitions. With --baseline the run fails when a median regresses past --tolerance, so kernel
+// changes can be gated in CI:
+//
+//   lichtfeld_kernel_benchmarks --sizes 100000,1000000,10000000 --resolutions 1280x720,1920x1080 \
+//       --output bench.json [--filter fastgs] [--baseline main.json --tolerance 0.1]
+
+#include "Ops.h"
+#include "config.h"
+#include "core/camera.hpp"
+#include "core/splat_data.hpp"
+#include "kernels/fused_ssim.cuh"
+#include "kernels/kmeans.cuh"
+#include "kernels/morton_encoding.cuh"
+#include "optimizers/fused_adam.hpp"
+#include "rasterization/fast_rasterizer.hpp"
+#include "rasterization/rasterizer.hpp"
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <print>
+#include <string>
+#include <torch/torch.h>
+#include <vector>
+
+namespace {
+
+    constexpr int SH_DEGREE = 3;
+    constexpr int SH_REST = (SH_DEGREE + 1) * (SH_DEGREE + 1) - 1;
+
+    struct Options {
+        std::vector<int64_t> sizes = {100'000, 1'000'000};
+        std::vector<std::pair<int, int>> resolutions = {{1280, 720}, {1920, 1080}};
+        int warmup = 5;
+        int repeat = 30;
+        std::string filter;
+        std::string output;
+        std::string baseline;
+        double tolerance = 0.1;
+    };
+
+    struct Timing {
+        double median_ms = 0.0;
+        double p95_ms = 0.0;
+        double min_ms = 0.0;
+        double mean_ms = 0.0;
+        int samples = 0;
+    };
+
+    struct Result {
+        std::string kernel;
+        int64_t gaussians = 0;
+        std::string resolution; // Empty for kernels without an image
+        Timing timing;
+    };
+
+    // prepare runs untimed before every repetition (e.g. the forward a backward needs),
+    // only run is enclosed by the event pair
+    Timing time_kernel(int warmup, int repeat, const std::function<void()>& prepare, const std::function<void()>& run) {
+        for (int i = 0; i < warmup; ++i) {
+            prepare();
+            run();
+        }
+        at::cuda::CUDAEvent begin(cudaEventDefault);
+        at::cuda::CUDAEvent end(cudaEventDefault);
+        std::vector<double> samples;
+        samples.reserve(repeat);
+        for (int i = 0; i < repeat; ++i) {
+            prepare();
+            const auto stream = at::cuda::getCurrentCUDAStream();
+            begin.record(stream);
+            run();
+            end.record(stream);
+            end.synchronize();
+            samples.push_back(begin.elapsed_time(end));
+        }
+        std::sort(samples.begin(), samples.end());
+
+        Timing timing;
+        timing.samples = repeat;
+        if (samples.empty()) {
+            return timing;
+        }
+        const auto at = [&](double q) { return samples[std::min(samples.size() - 1, static_cast<size_t>(q * (samples.size() - 1) + 0.5))]; };
+        timing.median_ms = at(0.5);
+        timing.p95_ms = at(0.95);
+        timing.min_ms = samples.front();
+        double sum = 0.0;
+        for (double sample : samples) {
+            sum += sample;
+        }
+        timing.mean_ms = sum / static_cast<double>(samples.size());
+        return timing;
+    }
+
+    // Gaussians filling the view frustum of the benchmark camera at depths 2 to 6, sized so the
+    // screen coverage stays roughly the same at every count
+    gs::SplatData make_gaussians(int64_t n) {
+        const auto cuda = torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA);
+        torch::Tensor means = torch::rand({n, 3}, cuda);
+        const torch::Tensor depth = means.select(1, 2) * 4.f + 2.f;
+        means.select(1, 0).sub_(0.5f).mul_(depth * 1.2f);
+        means.select(1, 1).sub_(0.5f).mul_(depth * 0.7f);
+        means.select(1, 2).copy_(depth);
+
+        const float scale = 2.f / std::cbrt(static_cast<float>(n));
+        torch::Tensor scaling = torch::log(torch::rand({n, 3}, cuda) * scale + scale * 0.1f);
+        torch::Tensor rotation = torch::nn::functional::normalize(torch::randn({n, 4}, cuda),
+                                                                  torch::nn::functional::NormalizeFuncOptions().dim(1));
+        torch::Tensor opacity = torch::randn({n, 1}, cuda);
+        torch::Tensor sh0 = torch::rand({n, 1, 3}, cuda) - 0.5f;
+        torch::Tensor shN = torch::randn({n, SH_REST, 3}, cuda) * 0.05f;
+
+        gs::SplatData model(SH_DEGREE, means.set_requires_grad(true), sh0.set_requires_grad(true),
+                            shN.set_requires_grad(true), scaling.set_requires_grad(true),
+                            rotation.set_requires_grad(true), opacity.set_requires_grad(true), 1.f);
+        model.set_active_sh_degree(SH_DEGREE);
+        return model;
+    }
+
+    gs::Camera make_camera(int width, int height) {
+        const float fov = static_cast<float>(M_PI) / 3.f;
+        return gs::Camera(torch::eye(3, torch::kFloat32), torch::zeros({3}, torch::kFloat32),
+                          gs::fov2focal(fov, width), gs::fov2focal(fov, height),
+                          0.5f * width, 0.5f * height,
+                          torch::empty({0}, torch::kFloat32), torch::empty({0}, torch::kFloat32),
+                          gsplat::CameraModelType::PINHOLE, "benchmark", "", width, height, 0);
+    }
+
+    torch::Tensor binomials(int n_max) {
+        torch::Tensor binoms = torch::zeros({n_max, n_max}, torch::kFloat32);
+        auto accessor = binoms.accessor<float, 2>();
+        for (int n = 0; n < n_max; ++n) {
+            for (int k = 0; k <= n; ++k) {
+                accessor[n][k] = static_cast<float>(std::round(std::exp(
+                    std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0))));
+            }
+        }
+        return binoms.to(torch::kCUDA);
+    }
+
+    class Suite {
+    public:
+        explicit Suite(const Options& options) : options_(options) {}
+
+        const std::vector<Result>& results() const { return results_; }
+
+        void run() {
+            for (const int64_t n : options_.sizes) {
+                gs::SplatData model = make_gaussians(n);
+                for (const auto& [width, height] : options_.resolutions) {
+                    rasterization(model, width, height);
+                }
+                adam(model, n);
+                morton(model, n);
+                relocation(model, n);
+                kmeans(model, n);
+            }
+            for (const auto& [width, height] : options_.resolutions) {
+                ssim(width, height);
+            }
+        }
+
+    private:
+        bool wanted(const std::string& kernel) const {
+            return options_.filter.empty() || kernel.find(options_.filter) != std::string::npos;
+        }
+
+        void add(const std::string& kernel, int64_t gaussians, const std::string& resolution,
+                 const std::function<void()>& prepare, const std::function<void()>& run) {
+            if (!wanted(kernel)) {
+                return;
+            }
+            Result result{kernel, gaussians, resolution,
+                          time_kernel(options_.warmup, options_.repeat, prepare, run)};
+            std::println("{:<24} {:>10} {:>10}  median {:9.3f} ms  p95 {:9.3f} ms",
+                         kernel, gaussians, resolution, result.timing.median_ms, result.timing.p95_ms);
+            results_.push_back(std::move(result));
+        }
+
+        void rasterization(gs::SplatData& model, int width, int height) {
+            gs::Camera camera = make_camera(width, height);
+            torch::Tensor bg = torch::zeros({3}, torch::TensorOptions().device(torch::kCUDA));
+            const std::string resolution = std::format("{}x{}", width, height);
+            const int64_t n = model.size();
+            const auto nothing = [] {};
+
+            fast_gs::rasterization::RasterizerContext context;
+            torch::Tensor loss;
+            add("fastgs_forward", n, resolution, nothing, [&] {
+                loss = gs::training::fast_rasterize(camera, model, bg, &context).image.sum();
+            });
+            add("fastgs_backward", n, resolution,
+                [&] { loss = gs::training::fast_rasterize(camera, model, bg, &context).image.sum(); },
+                [&] { loss.backward(); });
+            fast_gs::rasterization::RasterizerContext render_context;
+            add("fastgs_render", n, resolution, nothing, [&] {
+                gs::training::fast_render(camera, model, bg, &render_context);
+            });
+            add("gsplat_forward", n, resolution, nothing, [&] {
+                loss = gs::training::rasterize(camera, model, bg).image.sum();
+            });
+            add("gsplat_backward", n, resolution,
+                [&] { loss = gs::training::rasterize(camera, model, bg).image.sum(); },
+                [&] { loss.backward(); });
+            loss = torch::Tensor();
+            clear_grads(model);
+        }
+
+        void adam(gs::SplatData& model, int64_t n) {
+            std::vector<torch::Tensor> params = {model.means(), model.sh0(), model.shN(),
+                                                 model.scaling_raw(), model.rotation_raw(), model.opacity_raw()};
+            for (auto& param : params) {
+                param.mutable_grad() = torch::randn_like(param) * 1e-3f;
+            }
+            gs::training::FusedAdam optimizer(params, std::make_unique<gs::training::FusedAdam::Options>(1e-3));
+            int iteration = 0;
+            add("fused_adam", n, "", [] {}, [&] { optimizer.step(++iteration); });
+            clear_grads(model);
+        }
+
+        void morton(const gs::SplatData& model, int64_t n) {
+            torch::NoGradGuard no_grad;
+            const torch::Tensor means = model.means().detach();
+            add("morton_encode", n, "", [] {}, [&] { gs::morton_encode(means); });
+            const torch::Tensor codes = gs::morton_encode(means);
+            add("morton_sort", n, "", [] {}, [&] { gs::morton_sort_indices(codes); });
+        }
+
+        void relocation(const gs::SplatData& model, int64_t n) {
+            torch::NoGradGuard no_grad;
+            constexpr int n_max = 51;
+            const torch::Tensor binoms = binomials(n_max);
+            const torch::Tensor opacities = torch::sigmoid(model.opacity_raw().detach().reshape({-1}));
+            const torch::Tensor scales = torch::exp(model.scaling_raw().detach());
+            const torch::Tensor ratios = torch::randint(1, n_max, {n}, torch::TensorOptions().dtype(torch::kInt32).device(torch::kCUDA));
+            add("mcmc_relocation", n, "", [] {}, [&] { gsplat::relocation(opacities, scales, ratios, binoms, n_max); });
+
+            // A relocation step moves about a twentieth of the model
+            const int64_t moved = std::max<int64_t>(1, n / 20);
+            const torch::Tensor perm = torch::randperm(n, torch::TensorOptions().dtype(torch::kInt64).device(torch::kCUDA));
+            const torch::Tensor src = perm.narrow(0, 0, moved);
+            const torch::Tensor dst = perm.narrow(0, moved, moved);
+            std::vector<torch::Tensor> copied = {model.means().detach().clone(), model.shN().detach().clone()};
+            std::vector<torch::Tensor> zeroed = {torch::zeros_like(copied[0]), torch::zeros_like(copied[1])};
+            add("mcmc_relocate_rows", n, "", [] {}, [&] { gsplat::relocate_rows(src, dst, copied, zeroed); });
+        }
+
+        void kmeans(const gs::SplatData& model, int64_t n) {
+            torch::NoGradGuard no_grad;
+            // The SH codebook palette: shN rows into 4096 entries
+            const torch::Tensor data = model.shN().detach().reshape({n, -1});
+            add("kmeans_shN_4096", n, "", [] {}, [&] { gs::cuda::kmeans(data, 4096, 10); });
+            const torch::Tensor opacities = model.opacity_raw().detach().reshape({-1});
+            add("kmeans_1d_256", n, "", [] {}, [&] { gs::cuda::kmeans_1d(opacities, 256, 10); });
+        }
+
+        void ssim(int width, int height) {
+            const auto cuda = torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA);
+            const torch::Tensor image = torch::rand({1, 3, height, width}, cuda).set_requires_grad(true);
+            const torch::Tensor gt = torch::rand({1, 3, height, width}, cuda);
+            const std::string resolution = std::format("{}x{}", width, height);
+            torch::Tensor loss;
+            add("fused_ssim_forward", 0, resolution, [] {}, [&] { loss = fused_ssim(image, gt, "valid", true); });
+            add("fused_ssim_backward", 0, resolution,
+                [&] { loss = fused_ssim(image, gt, "valid", true); },
+                [&] { loss.backward(); });
+            add("fused_photometric_loss", 0, resolution, [] {}, [&] {
+                fused_photometric_loss(image, gt, 0.2f).backward();
+            });
+        }
+
+        static void clear_grads(gs::SplatData& model) {
+            for (auto* param : {&model.means(), &model.sh0(), &model.shN(),
+                                &model.scaling_raw(), &model.rotation_raw(), &model.opacity_raw()}) {
+                param->mutable_grad() = torch::Tensor();
+            }
+        }
+
+        const Options& options_;
+        std::vector<Result> results_;
+    };
+
+    template <typename T>
+    std::vector<T> parse_list(const std::string& text, const std::function<T(const std::string&)>& parse) {
+        std::vector<T> values;
+        size_t begin = 0;
+        while (begin <= text.size()) {
+            const size_t end = std::min(text.find(',', begin), text.size());
+            if (end > begin) {
+                values.push_back(parse(text.substr(begin, end - begin)));
+            }
+            begin = end + 1;
+        }
+        return values;
+    }
+
+    std::optional<Options> parse_options(int argc, char** argv) {
+        Options options;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+                std::println("usage: {} [--sizes N,...] [--resolutions WxH,...] [--warmup N] [--repeat N]\n"
+                             "          [--filter kernel] [--output report.json] [--baseline report.json] [--tolerance 0.1]",
+                             argv[0]);
+                return std::nullopt;
+            }
+            const std::string value = argv[++i];
+            if (arg == "--sizes") {
+                options.sizes = parse_list<int64_t>(value, [](const std::string& s) { return std::stoll(s); });
+            } else if (arg == "--resolutions") {
+                options.resolutions = parse_list<std::pair<int, int>>(value, [](const std::string& s) {
+                    const size_t x = s.find('x');
+                    return std::pair{std::stoi(s.substr(0, x)), std::stoi(s.substr(x + 1))};
+                });
+            } else if (arg == "--warmup") {
+                options.warmup = std::stoi(value);
+            } else if (arg == "--repeat") {
+                options.repeat = std::max(1, std::stoi(value));
+            } else if (arg == "--filter") {
+                options.filter = value;
+            } else if (arg == "--output") {
+                options.output = value;
+            } else if (arg == "--baseline") {
+                options.baseline = value;
+            } else if (arg == "--tolerance") {
+                options.tolerance = std::stod(value);
+            } else {
+                std::println(stderr, "Unknown option '{}'", arg);
+                return std::nullopt;
+            }
+        }
+        return options;
+    }
+
+    nlohmann::json to_json(const Options& options, const std::vector<Result>& results) {
+        nlohmann::json report;
+        report["commit"] = GIT_COMMIT_HASH_SHORT;
+        cudaDeviceProp prop{};
+        if (cudaGetDeviceProperties(&prop, at::cuda::current_device()) == cudaSuccess) {
+            report["gpu"] = prop.name;
+        }
+        report["warmup"] = options.warmup;
+        report["repeat"] = options.repeat;
+        auto entries = nlohmann::json::array();
+        for (const auto& result : results) {
+            entries.push_back({{"kernel", result.kernel},
+                               {"gaussians", result.gaussians},
+                               {"resolution", result.resolution},
+                               {"median_ms", result.timing.median_ms},
+                               {"p95_ms", result.timing.p95_ms},
+                               {"min_ms", result.timing.min_ms},
+                               {"mean_ms", result.timing.mean_ms},
+                               {"samples", result.timing.samples}});
+        }
+        report["results"] = std::move(entries);
+        return report;
+    }
+
+    // Number of cases whose median is slower than the baseline's by more than the tolerance
+    int compare(const Options& options, const std::vector<Result>& results) {
+        std::ifstream file(options.baseline);
+        if (!file) {
+            std::println(stderr, "Cannot read baseline '{}'", options.baseline);
+            return 1;
+        }
+        const auto baseline = nlohmann::json::parse(file, nullptr, false);
+        if (baseline.is_discarded() || !baseline.contains("results")) {
+            std::println(stderr, "Baseline '{}' is not a benchmark report", options.baseline);
+            return 1;
+        }
+
+        int regressions = 0;
+        for (const auto& result : results) {
+            for (const auto& entry : baseline["results"]) {
+                if (entry.value("kernel", "") != result.kernel || entry.value("gaussians", int64_t{0}) != result.gaussians ||
+                    entry.value("resolution", "") != result.resolution) {
+                    continue;
+                }
+                const double before = entry.value("median_ms", 0.0);
+                if (before > 0.0 && result.timing.median_ms > before * (1.0 + options.tolerance)) {
+                    std::println(stderr, "REGRESSION {} {} {}: {:.3f} ms -> {:.3f} ms (+{:.1f}%)",
+                                 result.kernel, result.gaussians, result.resolution, before, result.timing.median_ms,
+                                 100.0 * (result.timing.median_ms / before - 1.0));
+                    ++regressions;
+                }
+                break;
+            }
+        }
+        return regressions;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const auto options = parse_options(argc, argv);
+    if (!options) {
+        return 2;
+    }
+    if (!torch::cuda::is_available()) {
+        std::println(stderr, "CUDA is not available");
+        return 2;
+    }
+    torch::manual_seed(42);
+
+    Suite suite(*options);
+    try {
+        suite.run();
+    } catch (const std::exception& e) {
+        std::println(stderr, "Benchmark failed: {}", e.what());
+        return 2;
+    }
+
+    if (!options->output.empty()) {
+        std::ofstream file(options->output);
+        file << to_json(*options, suite.results()).dump(2) << '\n';
+        if (!file) {
+            std::println(stderr, "Failed to write '{}'", options->output);
+            return 2;
+        }
+    }
+    if (!options->baseline.empty()) {
+        return compare(*options, suite.results()) > 0 ? 1 : 0;
+    }
+    return 0;
+}
@@ -4,12 +4,48 @@
 
 #pragma once
 
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
+#include <cuda_runtime.h>
+
 namespace fast_gs::optimizer {
 
+    // Tensors one multi-tensor launch can update, the list is passed by value as a kernel argument
+    inline constexpr int max_multi_tensor_count = 8;
+
+    // Per-tensor hyperparameters of a multi-tensor step, passed by value with the tensor list so a
+    // step needs no host to device copy before its launches
+    struct AdamHyperparameters {
+        float lr;
+        float beta1;
+        float beta2;
+        float eps;
+        float log_beta1; // log(beta1) and log(beta2) from double, the bias corrections are computed
+        float log_beta2; // as -expm1(step * log(beta)) without the cancellation of 1 - pow(beta, step)
+        unsigned int step;
+        unsigned int seed;
+    };
+
+    template <typename TParam, typename TMoment>
+    struct AdamTensorList {
+        TParam* param[max_multi_tensor_count];
+        TMoment* exp_avg[max_multi_tensor_count];
+        TMoment* exp_avg_sq[max_multi_tensor_count];
+        const float* param_grad[max_multi_tensor_count];
+        int n_elements[max_multi_tensor_count];
+        AdamHyperparameters hyperparameters[max_multi_tensor_count];
+        int row_size[max_multi_tensor_count]; // elements per primitive of sparse tensors, 0 updates all elements
+        const bool* visibility;               // [n_primitives] rows a sparse step updates, nullptr for dense steps
+        int block_offset[max_multi_tensor_count + 1]; // first block of each tensor, block_offset[n_tensors] is the grid size
+        int n_tensors;
+    };
+
+    // Instantiated for float params with float moments and for half/bf16 params with bf16 moments
+    template <typename TParam, typename TMoment>
     void adam_step(
-        float* param,
-        float* exp_avg,
-        float* exp_avg_sq,
+        TParam* param,
+        TMoment* exp_avg,
+        TMoment* exp_avg_sq,
         const float* param_grad,
         const int n_elements,
         const float lr,
@@ -17,6 +53,13 @@ namespace fast_gs::optimizer {
         const float beta2,
         const float eps,
         const float bias_correction1_rcp,
-        const float bias_correction2_sqrt_rcp);
+        const float bias_correction2_sqrt_rcp,
+        const unsigned int seed,
+        cudaStream_t stream);
+
+    template <typename TParam, typename TMoment>
+    void adam_step_multi_tensor(
+        const AdamTensorList<TParam, TMoment>& tensors,
+        cudaStream_t stream);
 
 }
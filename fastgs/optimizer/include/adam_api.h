@@ -4,10 +4,16 @@
 
 #pragma once
 
+#include "adam.h"
 #include <torch/torch.h>
+#include <vector>
 
 namespace fast_gs::optimizer {
 
+    // Storage dtype of exp_avg and exp_avg_sq for a param of the given dtype
+    torch::ScalarType moment_dtype(torch::ScalarType param_dtype);
+
+    // param may be float32, float16 or bfloat16, seed drives the stochastic rounding of reduced-precision stores
     void adam_step_wrapper(
         torch::Tensor& param,
         torch::Tensor& exp_avg,
@@ -18,6 +24,20 @@ namespace fast_gs::optimizer {
         const float beta2,
         const float eps,
         const float bias_correction1,
-        const float bias_correction2_sqrt);
+        const float bias_correction2_sqrt,
+        const unsigned int seed = 0);
+
+    // Updates all params with as few launches as possible: one per storage dtype and group of
+    // max_multi_tensor_count tensors. params[i] uses hyperparameters[i], they travel as kernel
+    // arguments so a step never waits on an upload.
+    // With a defined bool visibility of n_primitives entries, params whose first dimension is
+    // n_primitives only update the visible rows (sparse Adam), all others update densely.
+    void adam_step_multi_tensor_wrapper(
+        std::vector<torch::Tensor>& params,
+        std::vector<torch::Tensor>& exp_avgs,
+        std::vector<torch::Tensor>& exp_avg_sqs,
+        const std::vector<torch::Tensor>& param_grads,
+        const std::vector<AdamHyperparameters>& hyperparameters,
+        const torch::Tensor& visibility = {});
 
 }
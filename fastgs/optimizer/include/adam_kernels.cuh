@@ -4,16 +4,87 @@
 
 #pragma once
 
+#include "adam.h"
+#include "optimizer_config.h"
 #include <cooperative_groups.h>
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
 namespace cg = cooperative_groups;
 
 namespace fast_gs::optimizer::kernels::adam {
 
+    __device__ __forceinline__ float load_float(const float value) { return value; }
+    __device__ __forceinline__ float load_float(const __half value) { return __half2float(value); }
+    __device__ __forceinline__ float load_float(const __nv_bfloat16 value) { return __bfloat162float(value); }
+
+    // pcg hash, one independent stream per element and step
+    __device__ __forceinline__ uint random_bits(const uint idx, const uint seed) {
+        uint state = idx * 747796405u + seed * 2891336453u + 2891336453u;
+        const uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+        return (word >> 22u) ^ word;
+    }
+
+    // Reduced-precision stores round stochastically, so updates smaller than half an ulp
+    // still move the stored value in expectation instead of being rounded away
+    __device__ __forceinline__ void store_rounded(float* dst, const float value, const uint) {
+        *dst = value;
+    }
+
+    __device__ __forceinline__ void store_rounded(__nv_bfloat16* dst, const float value, const uint bits) {
+        if (!isfinite(value)) {
+            *dst = __float2bfloat16(value);
+            return;
+        }
+        // bf16 is the upper half of fp32, adding random low bits before truncation rounds up with
+        // probability equal to the discarded fraction
+        const uint rounded = (__float_as_uint(value) + (bits & 0xffffu)) & 0xffff0000u;
+        *dst = __ushort_as_bfloat16(static_cast<unsigned short>(rounded >> 16));
+    }
+
+    __device__ __forceinline__ void store_rounded(__half* dst, const float value, const uint bits) {
+        const __half down = __float2half_rz(value);
+        const float down_value = __half2float(down);
+        if (down_value == value || !isfinite(value)) {
+            *dst = __float2half_rn(value);
+            return;
+        }
+        // rz truncates towards zero, the next encoding is one ulp further away from it
+        const __half up = __ushort_as_half(static_cast<unsigned short>(__half_as_ushort(down) + 1));
+        const float fraction = (value - down_value) / (__half2float(up) - down_value);
+        *dst = static_cast<float>(bits >> 8) * 0x1.0p-24f < fraction ? up : down;
+    }
+
     // based on https://github.com/pytorch/pytorch/blob/9d32aa9789fc0ef0cad01a788157ecc2121db810/torch/csrc/api/src/optim/adam.cpp#L72-L142
+    // all math is fp32, TParam and TMoment only set the storage precision
+    template <typename TParam, typename TMoment>
+    __device__ __forceinline__ void adam_update_element(
+        TParam* param,
+        TMoment* exp_avg,
+        TMoment* exp_avg_sq,
+        const float* param_grad,
+        const uint idx,
+        const float lr,
+        const float beta1,
+        const float beta2,
+        const float eps,
+        const float bias_correction1_rcp,
+        const float bias_correction2_sqrt_rcp,
+        const uint seed) {
+        const float grad = param_grad[idx];
+        const float moment1 = beta1 * load_float(exp_avg[idx]) + (1.0f - beta1) * grad;
+        const float moment2 = beta2 * load_float(exp_avg_sq[idx]) + (1.0f - beta2) * grad * grad;
+        const float denom = sqrtf(moment2) * bias_correction2_sqrt_rcp + eps;
+        const float step_size = lr * bias_correction1_rcp;
+        store_rounded(param + idx, load_float(param[idx]) - step_size * moment1 / denom, random_bits(3 * idx, seed));
+        store_rounded(exp_avg + idx, moment1, random_bits(3 * idx + 1, seed));
+        store_rounded(exp_avg_sq + idx, moment2, random_bits(3 * idx + 2, seed));
+    }
+
+    template <typename TParam, typename TMoment>
     __global__ void adam_step_cu(
-        float* param,
-        float* exp_avg,
-        float* exp_avg_sq,
+        TParam* param,
+        TMoment* exp_avg,
+        TMoment* exp_avg_sq,
         const float* param_grad,
         const int n_elements,
         const float lr,
@@ -21,18 +92,37 @@ namespace fast_gs::optimizer::kernels::adam {
         const float beta2,
         const float eps,
         const float bias_correction1_rcp,
-        const float bias_correction2_sqrt_rcp) {
+        const float bias_correction2_sqrt_rcp,
+        const uint seed) {
         auto idx = cg::this_grid().thread_rank();
         if (idx >= n_elements)
             return;
-        const float grad = param_grad[idx];
-        const float moment1 = beta1 * exp_avg[idx] + (1.0f - beta1) * grad;
-        const float moment2 = beta2 * exp_avg_sq[idx] + (1.0f - beta2) * grad * grad;
-        const float denom = sqrtf(moment2) * bias_correction2_sqrt_rcp + eps;
-        const float step_size = lr * bias_correction1_rcp;
-        param[idx] -= step_size * moment1 / denom;
-        exp_avg[idx] = moment1;
-        exp_avg_sq[idx] = moment2;
+        adam_update_element(
+            param, exp_avg, exp_avg_sq, param_grad, idx,
+            lr, beta1, beta2, eps, bias_correction1_rcp, bias_correction2_sqrt_rcp, seed);
+    }
+
+    // One launch for up to max_multi_tensor_count tensors, each block belongs to exactly one of them
+    template <typename TParam, typename TMoment>
+    __global__ void adam_step_multi_tensor_cu(
+        const AdamTensorList<TParam, TMoment> tensors) {
+        const int block_idx = cg::this_thread_block().group_index().x;
+        int tensor = 0;
+        while (tensor + 1 < tensors.n_tensors && block_idx >= tensors.block_offset[tensor + 1])
+            ++tensor;
+        const uint idx = (block_idx - tensors.block_offset[tensor]) * config::block_size_adam_step + cg::this_thread_block().thread_rank();
+        if (idx >= tensors.n_elements[tensor])
+            return;
+        // sparse steps leave params and moments of primitives that were not rendered untouched
+        if (tensors.row_size[tensor] > 0 && !tensors.visibility[idx / tensors.row_size[tensor]])
+            return;
+        const AdamHyperparameters& h = tensors.hyperparameters[tensor];
+        const float step = static_cast<float>(h.step);
+        const float bias_correction1_rcp = 1.0f / -expm1f(step * h.log_beta1);
+        const float bias_correction2_sqrt_rcp = rsqrtf(-expm1f(step * h.log_beta2));
+        adam_update_element(
+            tensors.param[tensor], tensors.exp_avg[tensor], tensors.exp_avg_sq[tensor], tensors.param_grad[tensor], idx,
+            h.lr, h.beta1, h.beta2, h.eps, bias_correction1_rcp, bias_correction2_sqrt_rcp, h.seed);
     }
 
 } // namespace fast_gs::optimizer::kernels::adam
@@ -7,10 +7,11 @@
 #include "optimizer_config.h"
 #include "utils.h"
 
+template <typename TParam, typename TMoment>
 void fast_gs::optimizer::adam_step(
-    float* param,
-    float* exp_avg,
-    float* exp_avg_sq,
+    TParam* param,
+    TMoment* exp_avg,
+    TMoment* exp_avg_sq,
     const float* param_grad,
     const int n_elements,
     const float lr,
@@ -18,8 +19,10 @@ void fast_gs::optimizer::adam_step(
     const float beta2,
     const float eps,
     const float bias_correction1_rcp,
-    const float bias_correction2_sqrt_rcp) {
-    kernels::adam::adam_step_cu<<<div_round_up(n_elements, config::block_size_adam_step), config::block_size_adam_step>>>(
+    const float bias_correction2_sqrt_rcp,
+    const unsigned int seed,
+    cudaStream_t stream) {
+    kernels::adam::adam_step_cu<<<div_round_up(n_elements, config::block_size_adam_step), config::block_size_adam_step, 0, stream>>>(
         param,
         exp_avg,
         exp_avg_sq,
@@ -30,6 +33,32 @@ void fast_gs::optimizer::adam_step(
         beta2,
         eps,
         bias_correction1_rcp,
-        bias_correction2_sqrt_rcp);
+        bias_correction2_sqrt_rcp,
+        seed);
     CHECK_CUDA(config::debug, "adam step")
 }
+
+template <typename TParam, typename TMoment>
+void fast_gs::optimizer::adam_step_multi_tensor(
+    const AdamTensorList<TParam, TMoment>& tensors,
+    cudaStream_t stream) {
+    const int n_blocks = tensors.block_offset[tensors.n_tensors];
+    if (n_blocks == 0)
+        return;
+    kernels::adam::adam_step_multi_tensor_cu<<<n_blocks, config::block_size_adam_step, 0, stream>>>(tensors);
+    CHECK_CUDA(config::debug, "adam step (multi-tensor)")
+}
+
+template void fast_gs::optimizer::adam_step<float, float>(
+    float*, float*, float*, const float*, int, float, float, float, float, float, float, unsigned int, cudaStream_t);
+template void fast_gs::optimizer::adam_step<__half, __nv_bfloat16>(
+    __half*, __nv_bfloat16*, __nv_bfloat16*, const float*, int, float, float, float, float, float, float, unsigned int, cudaStream_t);
+template void fast_gs::optimizer::adam_step<__nv_bfloat16, __nv_bfloat16>(
+    __nv_bfloat16*, __nv_bfloat16*, __nv_bfloat16*, const float*, int, float, float, float, float, float, float, unsigned int, cudaStream_t);
+
+template void fast_gs::optimizer::adam_step_multi_tensor<float, float>(
+    const AdamTensorList<float, float>&, cudaStream_t);
+template void fast_gs::optimizer::adam_step_multi_tensor<__half, __nv_bfloat16>(
+    const AdamTensorList<__half, __nv_bfloat16>&, cudaStream_t);
+template void fast_gs::optimizer::adam_step_multi_tensor<__nv_bfloat16, __nv_bfloat16>(
+    const AdamTensorList<__nv_bfloat16, __nv_bfloat16>&, cudaStream_t);
@@ -4,6 +4,16 @@
 
 #include "adam.h"
 #include "adam_api.h"
+#include "optimizer_config.h"
+#include "utils.h"
+#include <ATen/cuda/CUDAContext.h>
+#include <algorithm>
+#include <stdexcept>
+
+torch::ScalarType fast_gs::optimizer::moment_dtype(const torch::ScalarType param_dtype) {
+    // fp16 moments would flush squared gradients below ~6e-8 to zero, bf16 keeps the fp32 range
+    return param_dtype == torch::kFloat32 ? torch::kFloat32 : torch::kBFloat16;
+}
 
 void fast_gs::optimizer::adam_step_wrapper(
     torch::Tensor& param,
@@ -15,19 +25,145 @@ void fast_gs::optimizer::adam_step_wrapper(
     const float beta2,
     const float eps,
     const float bias_correction1_rcp,
-    const float bias_correction2_sqrt_rcp) {
+    const float bias_correction2_sqrt_rcp,
+    const unsigned int seed) {
     const int n_elements = param.numel();
+    if (exp_avg.scalar_type() != moment_dtype(param.scalar_type()) || exp_avg_sq.scalar_type() != exp_avg.scalar_type()) {
+        throw std::runtime_error("adam_step_wrapper: moments must be stored as moment_dtype(param)");
+    }
+    // gradients of reduced-precision params are widened, the update itself is fp32
+    const torch::Tensor grad = param_grad.scalar_type() == torch::kFloat32 ? param_grad : param_grad.to(torch::kFloat32);
+    const cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+
+    switch (param.scalar_type()) {
+    case torch::kFloat32:
+        adam_step(
+            param.data_ptr<float>(),
+            exp_avg.data_ptr<float>(),
+            exp_avg_sq.data_ptr<float>(),
+            grad.data_ptr<float>(),
+            n_elements,
+            lr,
+            beta1,
+            beta2,
+            eps,
+            bias_correction1_rcp,
+            bias_correction2_sqrt_rcp,
+            seed,
+            stream);
+        break;
+    case torch::kFloat16:
+        adam_step(
+            reinterpret_cast<__half*>(param.data_ptr<at::Half>()),
+            reinterpret_cast<__nv_bfloat16*>(exp_avg.data_ptr<at::BFloat16>()),
+            reinterpret_cast<__nv_bfloat16*>(exp_avg_sq.data_ptr<at::BFloat16>()),
+            grad.data_ptr<float>(),
+            n_elements,
+            lr,
+            beta1,
+            beta2,
+            eps,
+            bias_correction1_rcp,
+            bias_correction2_sqrt_rcp,
+            seed,
+            stream);
+        break;
+    case torch::kBFloat16:
+        adam_step(
+            reinterpret_cast<__nv_bfloat16*>(param.data_ptr<at::BFloat16>()),
+            reinterpret_cast<__nv_bfloat16*>(exp_avg.data_ptr<at::BFloat16>()),
+            reinterpret_cast<__nv_bfloat16*>(exp_avg_sq.data_ptr<at::BFloat16>()),
+            grad.data_ptr<float>(),
+            n_elements,
+            lr,
+            beta1,
+            beta2,
+            eps,
+            bias_correction1_rcp,
+            bias_correction2_sqrt_rcp,
+            seed,
+            stream);
+        break;
+    default:
+        throw std::runtime_error("adam_step_wrapper: unsupported parameter dtype");
+    }
+}
+
+namespace {
+
+    template <typename TParam, typename TMoment>
+    void launch_multi_tensor(
+        const std::vector<int>& members,
+        std::vector<torch::Tensor>& params,
+        std::vector<torch::Tensor>& exp_avgs,
+        std::vector<torch::Tensor>& exp_avg_sqs,
+        const std::vector<torch::Tensor>& grads,
+        const std::vector<fast_gs::optimizer::AdamHyperparameters>& hyperparameters,
+        const torch::Tensor& visibility) {
+        for (size_t first = 0; first < members.size(); first += fast_gs::optimizer::max_multi_tensor_count) {
+            fast_gs::optimizer::AdamTensorList<TParam, TMoment> tensors{};
+            tensors.visibility = visibility.defined() ? visibility.data_ptr<bool>() : nullptr;
+            tensors.n_tensors = static_cast<int>(std::min(members.size() - first, static_cast<size_t>(fast_gs::optimizer::max_multi_tensor_count)));
+            for (int t = 0; t < tensors.n_tensors; ++t) {
+                const int i = members[first + t];
+                tensors.param[t] = reinterpret_cast<TParam*>(params[i].data_ptr());
+                tensors.exp_avg[t] = reinterpret_cast<TMoment*>(exp_avgs[i].data_ptr());
+                tensors.exp_avg_sq[t] = reinterpret_cast<TMoment*>(exp_avg_sqs[i].data_ptr());
+                tensors.param_grad[t] = grads[i].data_ptr<float>();
+                tensors.n_elements[t] = static_cast<int>(params[i].numel());
+                tensors.hyperparameters[t] = hyperparameters[i];
+                const bool sparse = tensors.visibility != nullptr && params[i].dim() > 0 && params[i].size(0) == visibility.numel();
+                tensors.row_size[t] = sparse ? static_cast<int>(params[i].numel() / params[i].size(0)) : 0;
+                tensors.block_offset[t + 1] = tensors.block_offset[t] + div_round_up(tensors.n_elements[t], config::block_size_adam_step);
+            }
+            fast_gs::optimizer::adam_step_multi_tensor(tensors, at::cuda::getCurrentCUDAStream());
+        }
+    }
+
+} // namespace
+
+void fast_gs::optimizer::adam_step_multi_tensor_wrapper(
+    std::vector<torch::Tensor>& params,
+    std::vector<torch::Tensor>& exp_avgs,
+    std::vector<torch::Tensor>& exp_avg_sqs,
+    const std::vector<torch::Tensor>& param_grads,
+    const std::vector<AdamHyperparameters>& hyperparameters,
+    const torch::Tensor& visibility) {
+    const size_t n_params = params.size();
+    if (exp_avgs.size() != n_params || exp_avg_sqs.size() != n_params || param_grads.size() != n_params) {
+        throw std::runtime_error("adam_step_multi_tensor_wrapper: params, moments and grads must have the same length");
+    }
+    if (hyperparameters.size() != n_params) {
+        throw std::runtime_error("adam_step_multi_tensor_wrapper: hyperparameters must hold one entry per param");
+    }
+    if (visibility.defined() && (!visibility.is_cuda() || visibility.scalar_type() != torch::kBool || !visibility.is_contiguous())) {
+        throw std::runtime_error("adam_step_multi_tensor_wrapper: visibility must be a contiguous bool tensor on the device");
+    }
+
+    // gradients of reduced-precision params are widened, the update itself is fp32
+    std::vector<torch::Tensor> grads(n_params);
+    std::vector<int> float_members, half_members, bfloat16_members;
+    for (size_t i = 0; i < n_params; ++i) {
+        if (exp_avgs[i].scalar_type() != moment_dtype(params[i].scalar_type()) || exp_avg_sqs[i].scalar_type() != exp_avgs[i].scalar_type()) {
+            throw std::runtime_error("adam_step_multi_tensor_wrapper: moments must be stored as moment_dtype(param)");
+        }
+        grads[i] = param_grads[i].scalar_type() == torch::kFloat32 ? param_grads[i] : param_grads[i].to(torch::kFloat32);
+        switch (params[i].scalar_type()) {
+        case torch::kFloat32:
+            float_members.push_back(static_cast<int>(i));
+            break;
+        case torch::kFloat16:
+            half_members.push_back(static_cast<int>(i));
+            break;
+        case torch::kBFloat16:
+            bfloat16_members.push_back(static_cast<int>(i));
+            break;
+        default:
+            throw std::runtime_error("adam_step_multi_tensor_wrapper: unsupported parameter dtype");
+        }
+    }
 
-    adam_step(
-        param.data_ptr<float>(),
-        exp_avg.data_ptr<float>(),
-        exp_avg_sq.data_ptr<float>(),
-        param_grad.data_ptr<float>(),
-        n_elements,
-        lr,
-        beta1,
-        beta2,
-        eps,
-        bias_correction1_rcp,
-        bias_correction2_sqrt_rcp);
+    launch_multi_tensor<float, float>(float_members, params, exp_avgs, exp_avg_sqs, grads, hyperparameters, visibility);
+    launch_multi_tensor<__half, __nv_bfloat16>(half_members, params, exp_avgs, exp_avg_sqs, grads, hyperparameters, visibility);
+    launch_multi_tensor<__nv_bfloat16, __nv_bfloat16>(bfloat16_members, params, exp_avgs, exp_avg_sqs, grads, hyperparameters, visibility);
 }
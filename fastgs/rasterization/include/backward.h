@@ -5,11 +5,16 @@
 #pragma once
 
 #include "helper_math.h"
+#include "projection.h"
+#include "sh_storage.h"
+#include "tile_config.h"
+#include <cuda_runtime.h>
 #include <functional>
 
 namespace fast_gs::rasterization {
 
     void backward(
+        cudaStream_t stream,
         const float* grad_image,
         const float* grad_alpha,
         const float* image,
@@ -17,7 +22,8 @@ namespace fast_gs::rasterization {
         const float3* means,
         const float3* scales_raw,
         const float4* rotations_raw,
-        const float3* sh_coefficients_rest,
+        const void* sh_coefficients_rest,
+        const SHPrecision sh_precision,
         const float4* w2c,
         const float3* cam_position,
         char* per_primitive_buffers_blob,
@@ -33,7 +39,8 @@ namespace fast_gs::rasterization {
         float2* grad_mean2d_helper,
         float* grad_conic_helper,
         float4* grad_w2c,
-        float* densification_info,
+        __half2* densification_info, // [N] (visible count, mean2d gradient norm sum)
+        float* max_contribution,     // [N] largest blending weight in any pixel, raised with atomicMax
         const int n_primitives,
         const int n_visible_primitives,
         const int n_instances,
@@ -47,6 +54,10 @@ namespace fast_gs::rasterization {
         const float fx,
         const float fy,
         const float cx,
-        const float cy);
+        const float cy,
+        const Projection projection,
+        const TileShape tile_shape,
+        const int bucket_replay_chunk,      // from the forward, 0: the bucket states were kept
+        float4* bucket_replay_states);      // [bucket_replay_chunk * tile pixels] states of one chunk
 
 }
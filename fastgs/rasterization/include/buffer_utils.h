@@ -46,8 +46,10 @@ namespace fast_gs::rasterization {
         float2* mean2d;
         float4* conic_opacity;
         float3* color;
+        float* depth;
         uint* n_visible_primitives;
         uint* n_instances;
+        uint* n_bounding_instances;
 
         static PerPrimitiveBuffers from_blob(char*& blob, size_t n_primitives) {
             PerPrimitiveBuffers buffers;
@@ -67,6 +69,7 @@ namespace fast_gs::rasterization {
             obtain(blob, buffers.mean2d, n_primitives, 128);
             obtain(blob, buffers.conic_opacity, n_primitives, 128);
             obtain(blob, buffers.color, n_primitives, 128);
+            obtain(blob, buffers.depth, n_primitives, 128);
             cub::DeviceScan::ExclusiveSum(
                 nullptr, buffers.cub_workspace_size,
                 buffers.offset, buffers.offset,
@@ -80,6 +83,7 @@ namespace fast_gs::rasterization {
             obtain(blob, buffers.cub_workspace, buffers.cub_workspace_size, 128);
             obtain(blob, buffers.n_visible_primitives, 1, 128);
             obtain(blob, buffers.n_instances, 1, 128);
+            obtain(blob, buffers.n_bounding_instances, 1, 128);
             return buffers;
         }
     };
@@ -120,13 +124,13 @@ namespace fast_gs::rasterization {
         uint* max_n_contributions;
         uint* n_contributions;
 
-        static PerTileBuffers from_blob(char*& blob, size_t n_tiles) {
+        static PerTileBuffers from_blob(char*& blob, size_t n_tiles, size_t n_tile_pixels) {
             PerTileBuffers buffers;
             obtain(blob, buffers.instance_ranges, n_tiles, 128);
             obtain(blob, buffers.n_buckets, n_tiles, 128);
             obtain(blob, buffers.bucket_offsets, n_tiles, 128);
             obtain(blob, buffers.max_n_contributions, n_tiles, 128);
-            obtain(blob, buffers.n_contributions, n_tiles * config::block_size_blend, 128);
+            obtain(blob, buffers.n_contributions, n_tiles * n_tile_pixels, 128);
             cub::DeviceScan::InclusiveSum(
                 nullptr, buffers.cub_workspace_size,
                 buffers.n_buckets, buffers.bucket_offsets,
@@ -140,10 +144,33 @@ namespace fast_gs::rasterization {
         uint* tile_index;
         float4* color_transmittance;
 
-        static PerBucketBuffers from_blob(char*& blob, size_t n_buckets) {
+        // n_state_pixels 0 leaves out the states, for a backward that replays them
+        static PerBucketBuffers from_blob(char*& blob, size_t n_buckets, size_t n_state_pixels) {
             PerBucketBuffers buffers;
-            obtain(blob, buffers.tile_index, n_buckets * config::block_size_blend, 128);
-            obtain(blob, buffers.color_transmittance, n_buckets * config::block_size_blend, 128);
+            obtain(blob, buffers.tile_index, n_buckets, 128);
+            obtain(blob, buffers.color_transmittance, n_buckets * n_state_pixels, 128);
+            return buffers;
+        }
+    };
+
+    // Work lists and partial results of the load-balanced blend, sized by upper bounds of the
+    // number of heavy tiles and segments
+    struct PerSegmentBuffers {
+        uint2* heavy_tiles; // tile index, first segment
+        uint* n_heavy_tiles;
+        uint2* segments; // tile index, segment index within the tile
+        uint* n_segments;
+        float4* color_transmittance;
+        uint* n_contributions;
+
+        static PerSegmentBuffers from_blob(char*& blob, size_t n_segments, size_t n_heavy_tiles, size_t n_tile_pixels) {
+            PerSegmentBuffers buffers;
+            obtain(blob, buffers.heavy_tiles, n_heavy_tiles, 128);
+            obtain(blob, buffers.n_heavy_tiles, 1, 128);
+            obtain(blob, buffers.segments, n_segments, 128);
+            obtain(blob, buffers.n_segments, 1, 128);
+            obtain(blob, buffers.color_transmittance, n_segments * n_tile_pixels, 128);
+            obtain(blob, buffers.n_contributions, n_segments * n_tile_pixels, 128);
             return buffers;
         }
     };
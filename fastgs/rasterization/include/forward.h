@@ -5,12 +5,19 @@
 #pragma once
 
 #include "helper_math.h"
+#include "projection.h"
+#include "rasterizer_context.h"
+#include "sh_storage.h"
 #include <functional>
 #include <tuple>
 
 namespace fast_gs::rasterization {
 
-    std::tuple<int, int, int, int, int> forward(
+    // n_visible_primitives, n_instances, n_buckets, the two selectors and the bucket replay chunk:
+    // buckets per chunk the backward replays the states of, 0 when the forward kept them
+    std::tuple<int, int, int, int, int, int> forward(
+        RasterizerContext& context,
+        cudaStream_t stream,
         std::function<char*(size_t)> per_primitive_buffers_func,
         std::function<char*(size_t)> per_tile_buffers_func,
         std::function<char*(size_t)> per_instance_buffers_func,
@@ -20,11 +27,15 @@ namespace fast_gs::rasterization {
         const float4* rotations_raw,
         const float* opacities_raw,
         const float3* sh_coefficients_0,
-        const float3* sh_coefficients_rest,
+        const void* sh_coefficients_rest,
+        const SHPrecision sh_precision,
         const float4* w2c,
         const float3* cam_position,
         float* image,
         float* alpha,
+        float* depth, // [2, H, W] expected and median depth, nullptr skips them
+        const bool render_only, // no backward state, per_bucket_buffers_func is not called
+        const float* pixel_mask, // [H, W], tiles without a nonzero pixel are not blended, nullptr blends all
         const int n_primitives,
         const int active_sh_bases,
         const int total_bases_sh_rest,
@@ -35,6 +46,7 @@ namespace fast_gs::rasterization {
         const float cx,
         const float cy,
         const float near,
-        const float far);
+        const float far,
+        const Projection projection);
 
 }
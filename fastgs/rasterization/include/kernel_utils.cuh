@@ -5,32 +5,35 @@
 #pragma once
 
 #include "helper_math.h"
+#include "projection.h"
 #include "rasterization_config.h"
+#include "sh_storage.h"
 #include "utils.h"
 #include <cooperative_groups.h>
 namespace cg = cooperative_groups;
 
 namespace fast_gs::rasterization::kernels {
 
+    // ACTIVE_SH_BASES is a template parameter so the lower degrees compile without the higher-order terms
+    template <uint ACTIVE_SH_BASES, typename SHT>
     __device__ inline float3 convert_sh_to_color(
         const float3* sh_coefficients_0,
-        const float3* sh_coefficients_rest,
+        const SHT* sh_coefficients_rest,
         const float3& position,
         const float3& cam_position,
         const uint primitive_idx,
-        const uint active_sh_bases,
         const uint total_bases_sh_rest) {
         // computation adapted from https://github.com/NVlabs/tiny-cuda-nn/blob/212104156403bd87616c1a4f73a1c5f2c2e172a9/include/tiny-cuda-nn/common_device.h#L340
         float3 result = 0.5f + 0.28209479177387814f * sh_coefficients_0[primitive_idx];
-        if (active_sh_bases > 1) {
-            const float3* coefficients_ptr = sh_coefficients_rest + primitive_idx * total_bases_sh_rest;
+        if constexpr (ACTIVE_SH_BASES > 1) {
+            const SHCoefficientsView<SHT> coefficients_ptr{sh_coefficients_rest + 3 * primitive_idx * total_bases_sh_rest};
             auto [x, y, z] = normalize(position - cam_position);
             result = result + (-0.48860251190291987f * y) * coefficients_ptr[0] + (0.48860251190291987f * z) * coefficients_ptr[1] + (-0.48860251190291987f * x) * coefficients_ptr[2];
-            if (active_sh_bases > 4) {
+            if constexpr (ACTIVE_SH_BASES > 4) {
                 const float xx = x * x, yy = y * y, zz = z * z;
                 const float xy = x * y, xz = x * z, yz = y * z;
                 result = result + (1.0925484305920792f * xy) * coefficients_ptr[3] + (-1.0925484305920792f * yz) * coefficients_ptr[4] + (0.94617469575755997f * zz - 0.31539156525251999f) * coefficients_ptr[5] + (-1.0925484305920792f * xz) * coefficients_ptr[6] + (0.54627421529603959f * xx - 0.54627421529603959f * yy) * coefficients_ptr[7];
-                if (active_sh_bases > 9) {
+                if constexpr (ACTIVE_SH_BASES > 9) {
                     result = result + (0.59004358992664352f * y * (-3.0f * xx + yy)) * coefficients_ptr[8] + (2.8906114426405538f * xy * z) * coefficients_ptr[9] + (0.45704579946446572f * y * (1.0f - 5.0f * zz)) * coefficients_ptr[10] + (0.3731763325901154f * z * (5.0f * zz - 3.0f)) * coefficients_ptr[11] + (0.45704579946446572f * x * (1.0f - 5.0f * zz)) * coefficients_ptr[12] + (1.4453057213202769f * z * (xx - yy)) * coefficients_ptr[13] + (0.59004358992664352f * x * (-xx + 3.0f * yy)) * coefficients_ptr[14];
                 }
             }
@@ -38,23 +41,23 @@ namespace fast_gs::rasterization::kernels {
         return result;
     }
 
+    template <uint ACTIVE_SH_BASES, typename SHT>
     __device__ inline float3 convert_sh_to_color_backward(
-        const float3* sh_coefficients_rest,
+        const SHT* sh_coefficients_rest,
         float3* grad_sh_coefficients_0,
         float3* grad_sh_coefficients_rest,
         const float3& position,
         const float3& cam_position,
         const uint primitive_idx,
-        const uint active_sh_bases,
         const uint total_bases_sh_rest) {
         // computation adapted from https://github.com/NVlabs/tiny-cuda-nn/blob/212104156403bd87616c1a4f73a1c5f2c2e172a9/include/tiny-cuda-nn/common_device.h#L340
         const int coefficients_base_idx = primitive_idx * total_bases_sh_rest;
-        const float3* coefficients_ptr = sh_coefficients_rest + coefficients_base_idx;
+        const SHCoefficientsView<SHT> coefficients_ptr{sh_coefficients_rest + 3 * coefficients_base_idx};
         float3* grad_coefficients_ptr = grad_sh_coefficients_rest + coefficients_base_idx;
         const float3 grad_color = grad_sh_coefficients_0[primitive_idx];
         grad_sh_coefficients_0[primitive_idx] = 0.28209479177387814f * grad_color;
         float3 dcolor_dposition = make_float3(0.0f);
-        if (active_sh_bases > 1) {
+        if constexpr (ACTIVE_SH_BASES > 1) {
             auto [x_raw, y_raw, z_raw] = position - cam_position;
             auto [x, y, z] = normalize(make_float3(x_raw, y_raw, z_raw));
             grad_coefficients_ptr[0] = (-0.48860251190291987f * y) * grad_color;
@@ -63,7 +66,7 @@ namespace fast_gs::rasterization::kernels {
             float3 grad_direction_x = -0.48860251190291987f * coefficients_ptr[2];
             float3 grad_direction_y = -0.48860251190291987f * coefficients_ptr[0];
             float3 grad_direction_z = 0.48860251190291987f * coefficients_ptr[1];
-            if (active_sh_bases > 4) {
+            if constexpr (ACTIVE_SH_BASES > 4) {
                 const float xx = x * x, yy = y * y, zz = z * z;
                 const float xy = x * y, xz = x * z, yz = y * z;
                 grad_coefficients_ptr[3] = (1.0925484305920792f * xy) * grad_color;
@@ -74,7 +77,7 @@ namespace fast_gs::rasterization::kernels {
                 grad_direction_x = grad_direction_x + (1.0925484305920792f * y) * coefficients_ptr[3] + (-1.0925484305920792f * z) * coefficients_ptr[6] + (1.0925484305920792f * x) * coefficients_ptr[7];
                 grad_direction_y = grad_direction_y + (1.0925484305920792f * x) * coefficients_ptr[3] + (-1.0925484305920792f * z) * coefficients_ptr[4] + (-1.0925484305920792f * y) * coefficients_ptr[7];
                 grad_direction_z = grad_direction_z + (-1.0925484305920792f * y) * coefficients_ptr[4] + (1.8923493915151202f * z) * coefficients_ptr[5] + (-1.0925484305920792f * x) * coefficients_ptr[6];
-                if (active_sh_bases > 9) {
+                if constexpr (ACTIVE_SH_BASES > 9) {
                     grad_coefficients_ptr[8] = (0.59004358992664352f * y * (-3.0f * xx + yy)) * grad_color;
                     grad_coefficients_ptr[9] = (2.8906114426405538f * xy * z) * grad_color;
                     grad_coefficients_ptr[10] = (0.45704579946446572f * y * (1.0f - 5.0f * zz)) * grad_color;
@@ -104,15 +107,59 @@ namespace fast_gs::rasterization::kernels {
         return dcolor_dposition;
     }
 
+    // conservative test of a world-space box against the view frustum: the box is culled only if all
+    // eight corners lie outside the same plane. the side planes pass through the camera center, so the
+    // test holds for corners behind the camera as well. padding widens the image by that many pixels.
+    // orthographic side planes are parallel to the view axis instead.
+    template <Projection PROJECTION>
+    __device__ inline bool is_box_in_frustum(
+        const float3& box_min,
+        const float3& box_max,
+        const float4* w2c,
+        const float w,
+        const float h,
+        const float fx,
+        const float fy,
+        const float cx,
+        const float cy,
+        const float near_,
+        const float far_,
+        const float padding) {
+        const float4 w2c_r1 = w2c[0];
+        const float4 w2c_r2 = w2c[1];
+        const float4 w2c_r3 = w2c[2];
+        bool all_near = true, all_far = true, all_left = true, all_right = true, all_top = true, all_bottom = true;
+#pragma unroll
+        for (int corner_idx = 0; corner_idx < 8; ++corner_idx) {
+            const float3 corner = make_float3(
+                corner_idx & 1 ? box_max.x : box_min.x,
+                corner_idx & 2 ? box_max.y : box_min.y,
+                corner_idx & 4 ? box_max.z : box_min.z);
+            const float x = w2c_r1.x * corner.x + w2c_r1.y * corner.y + w2c_r1.z * corner.z + w2c_r1.w;
+            const float y = w2c_r2.x * corner.x + w2c_r2.y * corner.y + w2c_r2.z * corner.z + w2c_r2.w;
+            const float z = w2c_r3.x * corner.x + w2c_r3.y * corner.y + w2c_r3.z * corner.z + w2c_r3.w;
+            all_near &= z < near_;
+            all_far &= z > far_;
+            const float side_z = PROJECTION == Projection::Orthographic ? 1.0f : z;
+            all_left &= x * fx + (cx + padding) * side_z < 0.0f;
+            all_right &= (w - cx + padding) * side_z - x * fx < 0.0f;
+            all_top &= y * fy + (cy + padding) * side_z < 0.0f;
+            all_bottom &= (h - cy + padding) * side_z - y * fy < 0.0f;
+        }
+        return !(all_near || all_far || all_left || all_right || all_top || all_bottom);
+    }
+
     // based on https://github.com/r4dl/StopThePop-Rasterization/blob/d8cad09919ff49b11be3d693d1e71fa792f559bb/cuda_rasterizer/stopthepop/stopthepop_common.cuh#L131
     __device__ inline bool will_primitive_contribute(
         const float2& mean,
         const float3& conic,
         const uint tile_x,
         const uint tile_y,
+        const uint tile_width,
+        const uint tile_height,
         const float power_threshold) {
-        const float2 rect_min = make_float2(static_cast<float>(tile_x * config::tile_width), static_cast<float>(tile_y * config::tile_height));
-        const float2 rect_max = make_float2(static_cast<float>((tile_x + 1) * config::tile_width - 1), static_cast<float>((tile_y + 1) * config::tile_height - 1));
+        const float2 rect_min = make_float2(static_cast<float>(tile_x * tile_width), static_cast<float>(tile_y * tile_height));
+        const float2 rect_max = make_float2(static_cast<float>((tile_x + 1) * tile_width - 1), static_cast<float>((tile_y + 1) * tile_height - 1));
 
         const float x_min_diff = rect_min.x - mean.x;
         const float x_left = static_cast<float>(x_min_diff > 0.0f);
@@ -131,8 +178,8 @@ namespace fast_gs::rasterization::kernels {
         const float2 diff = mean - closest_corner;
 
         const float2 d = make_float2(
-            copysignf(static_cast<float>(config::tile_width - 1), x_min_diff),
-            copysignf(static_cast<float>(config::tile_height - 1), y_min_diff));
+            copysignf(static_cast<float>(tile_width - 1), x_min_diff),
+            copysignf(static_cast<float>(tile_height - 1), y_min_diff));
         const float2 t = make_float2(
             not_in_y_range * __saturatef((d.x * conic.x * diff.x + d.x * conic.y * diff.y) / (d.x * conic.x * d.x)),
             not_in_x_range * __saturatef((d.y * conic.y * diff.x + d.y * conic.z * diff.y) / (d.y * conic.z * d.y)));
@@ -149,6 +196,8 @@ namespace fast_gs::rasterization::kernels {
         const uint4& screen_bounds,
         const float power_threshold,
         const uint tile_count,
+        const uint tile_width,
+        const uint tile_height,
         const bool active) {
         const float2 mean2d_shifted = mean2d - 0.5f;
 
@@ -158,7 +207,7 @@ namespace fast_gs::rasterization::kernels {
             for (uint instance_idx = 0; instance_idx < tile_count && instance_idx < config::n_sequential_threshold; instance_idx++) {
                 const uint tile_y = screen_bounds.z + (instance_idx / screen_bounds_width);
                 const uint tile_x = screen_bounds.x + (instance_idx % screen_bounds_width);
-                if (will_primitive_contribute(mean2d_shifted, conic, tile_x, tile_y, power_threshold))
+                if (will_primitive_contribute(mean2d_shifted, conic, tile_x, tile_y, tile_width, tile_height, power_threshold))
                     n_touched_tiles++;
             }
         }
@@ -199,7 +248,7 @@ namespace fast_gs::rasterization::kernels {
                 const int active_current = instance_idx < tile_count_coop;
                 const uint tile_y = screen_bounds_coop.z + (instance_idx / screen_bounds_width_coop);
                 const uint tile_x = screen_bounds_coop.x + (instance_idx % screen_bounds_width_coop);
-                const uint contributes = active_current && will_primitive_contribute(mean2d_shifted_coop, conic_coop, tile_x, tile_y, power_threshold_coop);
+                const uint contributes = active_current && will_primitive_contribute(mean2d_shifted_coop, conic_coop, tile_x, tile_y, tile_width, tile_height, power_threshold_coop);
                 const uint contributes_ballot = __ballot_sync(0xffffffffu, contributes);
                 const uint n_contributes = __popc(contributes_ballot);
                 n_touched_tiles += (current_lane == lane_idx) * n_contributes;
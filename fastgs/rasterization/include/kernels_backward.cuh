@@ -10,16 +10,39 @@
 #include "rasterization_config.h"
 #include "utils.h"
 #include <cooperative_groups.h>
+#include <cooperative_groups/reduce.h>
 #include <cstdint>
 namespace cg = cooperative_groups;
 
 namespace fast_gs::rasterization::kernels::backward {
 
+    __device__ __forceinline__ void add_gradient(float* address, const float value, const bool exclusive) {
+        if (exclusive)
+            *address += value;
+        else
+            atomicAdd(address, value);
+    }
+
+    __device__ __forceinline__ void add_gradient(float2* address, const float2 value, const bool exclusive) {
+        if (exclusive) {
+            *address += value;
+            return;
+        }
+#if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 900
+        // one vector atomic instead of two scalar ones
+        atomicAdd(address, value);
+#else
+        atomicAdd(&address->x, value.x);
+        atomicAdd(&address->y, value.y);
+#endif
+    }
+
+    template <uint ACTIVE_SH_BASES, Projection PROJECTION, typename SHT>
     __global__ void preprocess_backward_cu(
         const float3* means,
         const float3* raw_scales,
         const float4* raw_rotations,
-        const float3* sh_coefficients_rest,
+        const SHT* sh_coefficients_rest,
         const float4* w2c,
         const float3* cam_position,
         const uint* primitive_n_touched_tiles,
@@ -31,9 +54,8 @@ namespace fast_gs::rasterization::kernels::backward {
         float3* grad_sh_coefficients_0,
         float3* grad_sh_coefficients_rest,
         float4* grad_w2c,
-        float* densification_info,
+        __half2* densification_info,
         const uint n_primitives,
-        const uint active_sh_bases,
         const uint total_bases_sh_rest,
         const float w,
         const float h,
@@ -41,202 +63,250 @@ namespace fast_gs::rasterization::kernels::backward {
         const float fy,
         const float cx,
         const float cy) {
+        auto block = cg::this_thread_block();
         auto primitive_idx = cg::this_grid().thread_rank();
-        if (primitive_idx >= n_primitives || primitive_n_touched_tiles[primitive_idx] == 0)
-            return;
-
-        // load 3d mean
-        const float3 mean3d = means[primitive_idx];
-
-        // sh evaluation backward
-        const float3 dL_dmean3d_from_color = convert_sh_to_color_backward(
-            sh_coefficients_rest, grad_sh_coefficients_0, grad_sh_coefficients_rest,
-            mean3d, cam_position[0],
-            primitive_idx, active_sh_bases, total_bases_sh_rest);
-
-        const float4 w2c_r3 = w2c[2];
-        const float depth = w2c_r3.x * mean3d.x + w2c_r3.y * mean3d.y + w2c_r3.z * mean3d.z + w2c_r3.w;
-        const float4 w2c_r1 = w2c[0];
-        const float x = (w2c_r1.x * mean3d.x + w2c_r1.y * mean3d.y + w2c_r1.z * mean3d.z + w2c_r1.w) / depth;
-        const float4 w2c_r2 = w2c[1];
-        const float y = (w2c_r2.x * mean3d.x + w2c_r2.y * mean3d.y + w2c_r2.z * mean3d.z + w2c_r2.w) / depth;
-
-        // compute 3d covariance from raw scale and rotation
-        const float3 raw_scale = raw_scales[primitive_idx];
-        const float3 variance = make_float3(expf(2.0f * raw_scale.x), expf(2.0f * raw_scale.y), expf(2.0f * raw_scale.z));
-        auto [qr, qx, qy, qz] = raw_rotations[primitive_idx];
-        const float qrr_raw = qr * qr, qxx_raw = qx * qx, qyy_raw = qy * qy, qzz_raw = qz * qz;
-        const float q_norm_sq = qrr_raw + qxx_raw + qyy_raw + qzz_raw;
-        const float qxx = 2.0f * qxx_raw / q_norm_sq, qyy = 2.0f * qyy_raw / q_norm_sq, qzz = 2.0f * qzz_raw / q_norm_sq;
-        const float qxy = 2.0f * qx * qy / q_norm_sq, qxz = 2.0f * qx * qz / q_norm_sq, qyz = 2.0f * qy * qz / q_norm_sq;
-        const float qrx = 2.0f * qr * qx / q_norm_sq, qry = 2.0f * qr * qy / q_norm_sq, qrz = 2.0f * qr * qz / q_norm_sq;
-        const mat3x3 rotation = {
-            1.0f - (qyy + qzz), qxy - qrz, qry + qxz,
-            qrz + qxy, 1.0f - (qxx + qzz), qyz - qrx,
-            qxz - qry, qrx + qyz, 1.0f - (qxx + qyy)};
-        const mat3x3 rotation_scaled = {
-            rotation.m11 * variance.x, rotation.m12 * variance.y, rotation.m13 * variance.z,
-            rotation.m21 * variance.x, rotation.m22 * variance.y, rotation.m23 * variance.z,
-            rotation.m31 * variance.x, rotation.m32 * variance.y, rotation.m33 * variance.z};
-        const mat3x3_triu cov3d{
-            rotation_scaled.m11 * rotation.m11 + rotation_scaled.m12 * rotation.m12 + rotation_scaled.m13 * rotation.m13,
-            rotation_scaled.m11 * rotation.m21 + rotation_scaled.m12 * rotation.m22 + rotation_scaled.m13 * rotation.m23,
-            rotation_scaled.m11 * rotation.m31 + rotation_scaled.m12 * rotation.m32 + rotation_scaled.m13 * rotation.m33,
-            rotation_scaled.m21 * rotation.m21 + rotation_scaled.m22 * rotation.m22 + rotation_scaled.m23 * rotation.m23,
-            rotation_scaled.m21 * rotation.m31 + rotation_scaled.m22 * rotation.m32 + rotation_scaled.m23 * rotation.m33,
-            rotation_scaled.m31 * rotation.m31 + rotation_scaled.m32 * rotation.m32 + rotation_scaled.m33 * rotation.m33,
-        };
-
-        // ewa splatting gradient helpers
-        const float clip_left = (-0.15f * w - cx) / fx;
-        const float clip_right = (1.15f * w - cx) / fx;
-        const float clip_top = (-0.15f * h - cy) / fy;
-        const float clip_bottom = (1.15f * h - cy) / fy;
-        const float tx = clamp(x, clip_left, clip_right);
-        const float ty = clamp(y, clip_top, clip_bottom);
-        const float j11 = fx / depth;
-        const float j13 = -j11 * tx;
-        const float j22 = fy / depth;
-        const float j23 = -j22 * ty;
-        const float3 jw_r1 = make_float3(
-            j11 * w2c_r1.x + j13 * w2c_r3.x,
-            j11 * w2c_r1.y + j13 * w2c_r3.y,
-            j11 * w2c_r1.z + j13 * w2c_r3.z);
-        const float3 jw_r2 = make_float3(
-            j22 * w2c_r2.x + j23 * w2c_r3.x,
-            j22 * w2c_r2.y + j23 * w2c_r3.y,
-            j22 * w2c_r2.z + j23 * w2c_r3.z);
-        const float3 jwc_r1 = make_float3(
-            jw_r1.x * cov3d.m11 + jw_r1.y * cov3d.m12 + jw_r1.z * cov3d.m13,
-            jw_r1.x * cov3d.m12 + jw_r1.y * cov3d.m22 + jw_r1.z * cov3d.m23,
-            jw_r1.x * cov3d.m13 + jw_r1.y * cov3d.m23 + jw_r1.z * cov3d.m33);
-        const float3 jwc_r2 = make_float3(
-            jw_r2.x * cov3d.m11 + jw_r2.y * cov3d.m12 + jw_r2.z * cov3d.m13,
-            jw_r2.x * cov3d.m12 + jw_r2.y * cov3d.m22 + jw_r2.z * cov3d.m23,
-            jw_r2.x * cov3d.m13 + jw_r2.y * cov3d.m23 + jw_r2.z * cov3d.m33);
-
-        // 2d covariance gradient
-        const float a = dot(jwc_r1, jw_r1) + config::dilation, b = dot(jwc_r1, jw_r2), c = dot(jwc_r2, jw_r2) + config::dilation;
-        const float aa = a * a, bb = b * b, cc = c * c;
-        const float ac = a * c, ab = a * b, bc = b * c;
-        const float determinant = ac - bb;
-        const float determinant_rcp = 1.0f / determinant;
-        const float determinant_rcp_sq = determinant_rcp * determinant_rcp;
-        const float3 dL_dconic = make_float3(
-            grad_conic[primitive_idx],
-            grad_conic[n_primitives + primitive_idx],
-            grad_conic[2 * n_primitives + primitive_idx]);
-        const float3 dL_dcov2d = determinant_rcp_sq * make_float3(
-                                                          2.0f * bc * dL_dconic.y - cc * dL_dconic.x - bb * dL_dconic.z,
-                                                          bc * dL_dconic.x - (ac + bb) * dL_dconic.y + ab * dL_dconic.z,
-                                                          2.0f * ab * dL_dconic.y - bb * dL_dconic.x - aa * dL_dconic.z);
-
-        // 3d covariance gradient
-        const mat3x3_triu dL_dcov3d = {
-            (jw_r1.x * jw_r1.x) * dL_dcov2d.x + 2.0f * (jw_r1.x * jw_r2.x) * dL_dcov2d.y + (jw_r2.x * jw_r2.x) * dL_dcov2d.z,
-            (jw_r1.x * jw_r1.y) * dL_dcov2d.x + (jw_r1.x * jw_r2.y + jw_r1.y * jw_r2.x) * dL_dcov2d.y + (jw_r2.x * jw_r2.y) * dL_dcov2d.z,
-            (jw_r1.x * jw_r1.z) * dL_dcov2d.x + (jw_r1.x * jw_r2.z + jw_r1.z * jw_r2.x) * dL_dcov2d.y + (jw_r2.x * jw_r2.z) * dL_dcov2d.z,
-            (jw_r1.y * jw_r1.y) * dL_dcov2d.x + 2.0f * (jw_r1.y * jw_r2.y) * dL_dcov2d.y + (jw_r2.y * jw_r2.y) * dL_dcov2d.z,
-            (jw_r1.y * jw_r1.z) * dL_dcov2d.x + (jw_r1.y * jw_r2.z + jw_r1.z * jw_r2.y) * dL_dcov2d.y + (jw_r2.y * jw_r2.z) * dL_dcov2d.z,
-            (jw_r1.z * jw_r1.z) * dL_dcov2d.x + 2.0f * (jw_r1.z * jw_r2.z) * dL_dcov2d.y + (jw_r2.z * jw_r2.z) * dL_dcov2d.z,
-        };
-
-        // gradient of J * W
-        const float3 dL_djw_r1 = 2.0f * make_float3(
-                                            jwc_r1.x * dL_dcov2d.x + jwc_r2.x * dL_dcov2d.y,
-                                            jwc_r1.y * dL_dcov2d.x + jwc_r2.y * dL_dcov2d.y,
-                                            jwc_r1.z * dL_dcov2d.x + jwc_r2.z * dL_dcov2d.y);
-        const float3 dL_djw_r2 = 2.0f * make_float3(
-                                            jwc_r1.x * dL_dcov2d.y + jwc_r2.x * dL_dcov2d.z,
-                                            jwc_r1.y * dL_dcov2d.y + jwc_r2.y * dL_dcov2d.z,
-                                            jwc_r1.z * dL_dcov2d.y + jwc_r2.z * dL_dcov2d.z);
-
-        // gradient of non-zero entries in J
-        const float dL_dj11 = w2c_r1.x * dL_djw_r1.x + w2c_r1.y * dL_djw_r1.y + w2c_r1.z * dL_djw_r1.z;
-        const float dL_dj22 = w2c_r2.x * dL_djw_r2.x + w2c_r2.y * dL_djw_r2.y + w2c_r2.z * dL_djw_r2.z;
-        const float dL_dj13 = w2c_r3.x * dL_djw_r1.x + w2c_r3.y * dL_djw_r1.y + w2c_r3.z * dL_djw_r1.z;
-        const float dL_dj23 = w2c_r3.x * dL_djw_r2.x + w2c_r3.y * dL_djw_r2.y + w2c_r3.z * dL_djw_r2.z;
-
-        // mean3d camera space gradient from J and mean2d
-        // TODO: original 3dgs accounts for clamping of tx/ty here, but it seems that this is not necessary
-        float djwr1_dz_helper = dL_dj11 - 2.0f * tx * dL_dj13;
-        float djwr2_dz_helper = dL_dj22 - 2.0f * ty * dL_dj23;
-        const float2 dL_dmean2d = grad_mean2d[primitive_idx];
-        const float3 dL_dmean3d_cam = make_float3(
-            j11 * (dL_dmean2d.x - dL_dj13 / depth),
-            j22 * (dL_dmean2d.y - dL_dj23 / depth),
-            -j11 * (x * dL_dmean2d.x + djwr1_dz_helper / depth) - j22 * (y * dL_dmean2d.y + djwr2_dz_helper / depth));
+        // inactive threads stay alive for the block-wide pose gradient reduction
+        const bool active = primitive_idx < n_primitives && primitive_n_touched_tiles[primitive_idx] != 0;
+        float3 dL_dmean3d_cam_out = make_float3(0.0f);
+        float3 mean3d_out = make_float3(0.0f);
+
+        if (active) {
+            // load 3d mean
+            const float3 mean3d = means[primitive_idx];
+
+            // sh evaluation backward
+            const float3 dL_dmean3d_from_color = convert_sh_to_color_backward<ACTIVE_SH_BASES>(
+                sh_coefficients_rest, grad_sh_coefficients_0, grad_sh_coefficients_rest,
+                mean3d, cam_position[0],
+                primitive_idx, total_bases_sh_rest);
+            // gradient buffers are uninitialized, coefficients above the active degree get zeros
+            for (uint basis = ACTIVE_SH_BASES - 1; basis < total_bases_sh_rest; ++basis)
+                grad_sh_coefficients_rest[primitive_idx * total_bases_sh_rest + basis] = make_float3(0.0f);
+
+            constexpr bool orthographic = PROJECTION == Projection::Orthographic;
+            const float4 w2c_r3 = w2c[2];
+            const float depth = w2c_r3.x * mean3d.x + w2c_r3.y * mean3d.y + w2c_r3.z * mean3d.z + w2c_r3.w;
+            const float4 w2c_r1 = w2c[0];
+            const float4 w2c_r2 = w2c[1];
+            const float x_cam = w2c_r1.x * mean3d.x + w2c_r1.y * mean3d.y + w2c_r1.z * mean3d.z + w2c_r1.w;
+            const float y_cam = w2c_r2.x * mean3d.x + w2c_r2.y * mean3d.y + w2c_r2.z * mean3d.z + w2c_r2.w;
+            const float x = orthographic ? x_cam : x_cam / depth;
+            const float y = orthographic ? y_cam : y_cam / depth;
+
+            // compute 3d covariance from raw scale and rotation
+            const float3 raw_scale = raw_scales[primitive_idx];
+            const float3 variance = make_float3(expf(2.0f * raw_scale.x), expf(2.0f * raw_scale.y), expf(2.0f * raw_scale.z));
+            auto [qr, qx, qy, qz] = raw_rotations[primitive_idx];
+            const float qrr_raw = qr * qr, qxx_raw = qx * qx, qyy_raw = qy * qy, qzz_raw = qz * qz;
+            const float q_norm_sq = qrr_raw + qxx_raw + qyy_raw + qzz_raw;
+            const float qxx = 2.0f * qxx_raw / q_norm_sq, qyy = 2.0f * qyy_raw / q_norm_sq, qzz = 2.0f * qzz_raw / q_norm_sq;
+            const float qxy = 2.0f * qx * qy / q_norm_sq, qxz = 2.0f * qx * qz / q_norm_sq, qyz = 2.0f * qy * qz / q_norm_sq;
+            const float qrx = 2.0f * qr * qx / q_norm_sq, qry = 2.0f * qr * qy / q_norm_sq, qrz = 2.0f * qr * qz / q_norm_sq;
+            const mat3x3 rotation = {
+                1.0f - (qyy + qzz), qxy - qrz, qry + qxz,
+                qrz + qxy, 1.0f - (qxx + qzz), qyz - qrx,
+                qxz - qry, qrx + qyz, 1.0f - (qxx + qyy)};
+            const mat3x3 rotation_scaled = {
+                rotation.m11 * variance.x, rotation.m12 * variance.y, rotation.m13 * variance.z,
+                rotation.m21 * variance.x, rotation.m22 * variance.y, rotation.m23 * variance.z,
+                rotation.m31 * variance.x, rotation.m32 * variance.y, rotation.m33 * variance.z};
+            const mat3x3_triu cov3d{
+                rotation_scaled.m11 * rotation.m11 + rotation_scaled.m12 * rotation.m12 + rotation_scaled.m13 * rotation.m13,
+                rotation_scaled.m11 * rotation.m21 + rotation_scaled.m12 * rotation.m22 + rotation_scaled.m13 * rotation.m23,
+                rotation_scaled.m11 * rotation.m31 + rotation_scaled.m12 * rotation.m32 + rotation_scaled.m13 * rotation.m33,
+                rotation_scaled.m21 * rotation.m21 + rotation_scaled.m22 * rotation.m22 + rotation_scaled.m23 * rotation.m23,
+                rotation_scaled.m21 * rotation.m31 + rotation_scaled.m22 * rotation.m32 + rotation_scaled.m23 * rotation.m33,
+                rotation_scaled.m31 * rotation.m31 + rotation_scaled.m32 * rotation.m32 + rotation_scaled.m33 * rotation.m33,
+            };
+
+            // ewa splatting gradient helpers, the orthographic jacobian is constant
+            float tx = x, ty = y;
+            float j11 = fx, j13 = 0.0f, j22 = fy, j23 = 0.0f;
+            if constexpr (!orthographic) {
+                const float clip_left = (-0.15f * w - cx) / fx;
+                const float clip_right = (1.15f * w - cx) / fx;
+                const float clip_top = (-0.15f * h - cy) / fy;
+                const float clip_bottom = (1.15f * h - cy) / fy;
+                tx = clamp(x, clip_left, clip_right);
+                ty = clamp(y, clip_top, clip_bottom);
+                j11 = fx / depth;
+                j13 = -j11 * tx;
+                j22 = fy / depth;
+                j23 = -j22 * ty;
+            }
+            const float3 jw_r1 = make_float3(
+                j11 * w2c_r1.x + j13 * w2c_r3.x,
+                j11 * w2c_r1.y + j13 * w2c_r3.y,
+                j11 * w2c_r1.z + j13 * w2c_r3.z);
+            const float3 jw_r2 = make_float3(
+                j22 * w2c_r2.x + j23 * w2c_r3.x,
+                j22 * w2c_r2.y + j23 * w2c_r3.y,
+                j22 * w2c_r2.z + j23 * w2c_r3.z);
+            const float3 jwc_r1 = make_float3(
+                jw_r1.x * cov3d.m11 + jw_r1.y * cov3d.m12 + jw_r1.z * cov3d.m13,
+                jw_r1.x * cov3d.m12 + jw_r1.y * cov3d.m22 + jw_r1.z * cov3d.m23,
+                jw_r1.x * cov3d.m13 + jw_r1.y * cov3d.m23 + jw_r1.z * cov3d.m33);
+            const float3 jwc_r2 = make_float3(
+                jw_r2.x * cov3d.m11 + jw_r2.y * cov3d.m12 + jw_r2.z * cov3d.m13,
+                jw_r2.x * cov3d.m12 + jw_r2.y * cov3d.m22 + jw_r2.z * cov3d.m23,
+                jw_r2.x * cov3d.m13 + jw_r2.y * cov3d.m23 + jw_r2.z * cov3d.m33);
+
+            // 2d covariance gradient
+            const float a = dot(jwc_r1, jw_r1) + config::dilation, b = dot(jwc_r1, jw_r2), c = dot(jwc_r2, jw_r2) + config::dilation;
+            const float aa = a * a, bb = b * b, cc = c * c;
+            const float ac = a * c, ab = a * b, bc = b * c;
+            const float determinant = ac - bb;
+            const float determinant_rcp = 1.0f / determinant;
+            const float determinant_rcp_sq = determinant_rcp * determinant_rcp;
+            const float3 dL_dconic = make_float3(
+                grad_conic[primitive_idx],
+                grad_conic[n_primitives + primitive_idx],
+                grad_conic[2 * n_primitives + primitive_idx]);
+            const float3 dL_dcov2d = determinant_rcp_sq * make_float3(
+                                                              2.0f * bc * dL_dconic.y - cc * dL_dconic.x - bb * dL_dconic.z,
+                                                              bc * dL_dconic.x - (ac + bb) * dL_dconic.y + ab * dL_dconic.z,
+                                                              2.0f * ab * dL_dconic.y - bb * dL_dconic.x - aa * dL_dconic.z);
+
+            // 3d covariance gradient
+            const mat3x3_triu dL_dcov3d = {
+                (jw_r1.x * jw_r1.x) * dL_dcov2d.x + 2.0f * (jw_r1.x * jw_r2.x) * dL_dcov2d.y + (jw_r2.x * jw_r2.x) * dL_dcov2d.z,
+                (jw_r1.x * jw_r1.y) * dL_dcov2d.x + (jw_r1.x * jw_r2.y + jw_r1.y * jw_r2.x) * dL_dcov2d.y + (jw_r2.x * jw_r2.y) * dL_dcov2d.z,
+                (jw_r1.x * jw_r1.z) * dL_dcov2d.x + (jw_r1.x * jw_r2.z + jw_r1.z * jw_r2.x) * dL_dcov2d.y + (jw_r2.x * jw_r2.z) * dL_dcov2d.z,
+                (jw_r1.y * jw_r1.y) * dL_dcov2d.x + 2.0f * (jw_r1.y * jw_r2.y) * dL_dcov2d.y + (jw_r2.y * jw_r2.y) * dL_dcov2d.z,
+                (jw_r1.y * jw_r1.z) * dL_dcov2d.x + (jw_r1.y * jw_r2.z + jw_r1.z * jw_r2.y) * dL_dcov2d.y + (jw_r2.y * jw_r2.z) * dL_dcov2d.z,
+                (jw_r1.z * jw_r1.z) * dL_dcov2d.x + 2.0f * (jw_r1.z * jw_r2.z) * dL_dcov2d.y + (jw_r2.z * jw_r2.z) * dL_dcov2d.z,
+            };
+
+            // gradient of J * W
+            const float3 dL_djw_r1 = 2.0f * make_float3(
+                                                jwc_r1.x * dL_dcov2d.x + jwc_r2.x * dL_dcov2d.y,
+                                                jwc_r1.y * dL_dcov2d.x + jwc_r2.y * dL_dcov2d.y,
+                                                jwc_r1.z * dL_dcov2d.x + jwc_r2.z * dL_dcov2d.y);
+            const float3 dL_djw_r2 = 2.0f * make_float3(
+                                                jwc_r1.x * dL_dcov2d.y + jwc_r2.x * dL_dcov2d.z,
+                                                jwc_r1.y * dL_dcov2d.y + jwc_r2.y * dL_dcov2d.z,
+                                                jwc_r1.z * dL_dcov2d.y + jwc_r2.z * dL_dcov2d.z);
+
+            const float2 dL_dmean2d = grad_mean2d[primitive_idx];
+            float3 dL_dmean3d_cam;
+            if constexpr (orthographic) {
+                // neither J nor the projection depend on depth
+                dL_dmean3d_cam = make_float3(fx * dL_dmean2d.x, fy * dL_dmean2d.y, 0.0f);
+            } else {
+                // gradient of non-zero entries in J
+                const float dL_dj11 = w2c_r1.x * dL_djw_r1.x + w2c_r1.y * dL_djw_r1.y + w2c_r1.z * dL_djw_r1.z;
+                const float dL_dj22 = w2c_r2.x * dL_djw_r2.x + w2c_r2.y * dL_djw_r2.y + w2c_r2.z * dL_djw_r2.z;
+                const float dL_dj13 = w2c_r3.x * dL_djw_r1.x + w2c_r3.y * dL_djw_r1.y + w2c_r3.z * dL_djw_r1.z;
+                const float dL_dj23 = w2c_r3.x * dL_djw_r2.x + w2c_r3.y * dL_djw_r2.y + w2c_r3.z * dL_djw_r2.z;
+
+                // mean3d camera space gradient from J and mean2d
+                // TODO: original 3dgs accounts for clamping of tx/ty here, but it seems that this is not necessary
+                float djwr1_dz_helper = dL_dj11 - 2.0f * tx * dL_dj13;
+                float djwr2_dz_helper = dL_dj22 - 2.0f * ty * dL_dj23;
+                dL_dmean3d_cam = make_float3(
+                    j11 * (dL_dmean2d.x - dL_dj13 / depth),
+                    j22 * (dL_dmean2d.y - dL_dj23 / depth),
+                    -j11 * (x * dL_dmean2d.x + djwr1_dz_helper / depth) - j22 * (y * dL_dmean2d.y + djwr2_dz_helper / depth));
+            }
 
-        if (grad_w2c != nullptr) {
-            atomicAdd(&grad_w2c[0].w, dL_dmean3d_cam.x);
-            atomicAdd(&grad_w2c[1].w, dL_dmean3d_cam.y);
-            atomicAdd(&grad_w2c[2].w, dL_dmean3d_cam.z);
-            atomicAdd(&grad_w2c[0].x, dL_dmean3d_cam.x * mean3d.x);
-            atomicAdd(&grad_w2c[0].y, dL_dmean3d_cam.x * mean3d.y);
-            atomicAdd(&grad_w2c[0].z, dL_dmean3d_cam.x * mean3d.z);
-            atomicAdd(&grad_w2c[1].x, dL_dmean3d_cam.y * mean3d.x);
-            atomicAdd(&grad_w2c[1].y, dL_dmean3d_cam.y * mean3d.y);
-            atomicAdd(&grad_w2c[1].z, dL_dmean3d_cam.y * mean3d.z);
-            atomicAdd(&grad_w2c[2].x, dL_dmean3d_cam.z * mean3d.x);
-            atomicAdd(&grad_w2c[2].y, dL_dmean3d_cam.z * mean3d.y);
-            atomicAdd(&grad_w2c[2].z, dL_dmean3d_cam.z * mean3d.z);
+            dL_dmean3d_cam_out = dL_dmean3d_cam;
+            mean3d_out = mean3d;
+
+            // 3d mean gradient from splatting
+            const float3 dL_dmean3d_from_splatting = make_float3(
+                w2c_r1.x * dL_dmean3d_cam.x + w2c_r2.x * dL_dmean3d_cam.y + w2c_r3.x * dL_dmean3d_cam.z,
+                w2c_r1.y * dL_dmean3d_cam.x + w2c_r2.y * dL_dmean3d_cam.y + w2c_r3.y * dL_dmean3d_cam.z,
+                w2c_r1.z * dL_dmean3d_cam.x + w2c_r2.z * dL_dmean3d_cam.y + w2c_r3.z * dL_dmean3d_cam.z);
+
+            // write total 3d mean gradient
+            const float3 dL_dmean3d = dL_dmean3d_from_splatting + dL_dmean3d_from_color;
+            grad_means[primitive_idx] = dL_dmean3d;
+
+            // raw scale gradient
+            const float dL_dvariance_x = rotation.m11 * rotation.m11 * dL_dcov3d.m11 + rotation.m21 * rotation.m21 * dL_dcov3d.m22 + rotation.m31 * rotation.m31 * dL_dcov3d.m33 +
+                                         2.0f * (rotation.m11 * rotation.m21 * dL_dcov3d.m12 + rotation.m11 * rotation.m31 * dL_dcov3d.m13 + rotation.m21 * rotation.m31 * dL_dcov3d.m23);
+            const float dL_dvariance_y = rotation.m12 * rotation.m12 * dL_dcov3d.m11 + rotation.m22 * rotation.m22 * dL_dcov3d.m22 + rotation.m32 * rotation.m32 * dL_dcov3d.m33 +
+                                         2.0f * (rotation.m12 * rotation.m22 * dL_dcov3d.m12 + rotation.m12 * rotation.m32 * dL_dcov3d.m13 + rotation.m22 * rotation.m32 * dL_dcov3d.m23);
+            const float dL_dvariance_z = rotation.m13 * rotation.m13 * dL_dcov3d.m11 + rotation.m23 * rotation.m23 * dL_dcov3d.m22 + rotation.m33 * rotation.m33 * dL_dcov3d.m33 +
+                                         2.0f * (rotation.m13 * rotation.m23 * dL_dcov3d.m12 + rotation.m13 * rotation.m33 * dL_dcov3d.m13 + rotation.m23 * rotation.m33 * dL_dcov3d.m23);
+            const float3 dL_draw_scale = make_float3(
+                2.0f * variance.x * dL_dvariance_x,
+                2.0f * variance.y * dL_dvariance_y,
+                2.0f * variance.z * dL_dvariance_z);
+            grad_raw_scales[primitive_idx] = dL_draw_scale;
+
+            // raw rotation gradient
+            const mat3x3 dL_drotation = {
+                2.0f * (rotation_scaled.m11 * dL_dcov3d.m11 + rotation_scaled.m21 * dL_dcov3d.m12 + rotation_scaled.m31 * dL_dcov3d.m13),
+                2.0f * (rotation_scaled.m12 * dL_dcov3d.m11 + rotation_scaled.m22 * dL_dcov3d.m12 + rotation_scaled.m32 * dL_dcov3d.m13),
+                2.0f * (rotation_scaled.m13 * dL_dcov3d.m11 + rotation_scaled.m23 * dL_dcov3d.m12 + rotation_scaled.m33 * dL_dcov3d.m13),
+                2.0f * (rotation_scaled.m11 * dL_dcov3d.m12 + rotation_scaled.m21 * dL_dcov3d.m22 + rotation_scaled.m31 * dL_dcov3d.m23),
+                2.0f * (rotation_scaled.m12 * dL_dcov3d.m12 + rotation_scaled.m22 * dL_dcov3d.m22 + rotation_scaled.m32 * dL_dcov3d.m23),
+                2.0f * (rotation_scaled.m13 * dL_dcov3d.m12 + rotation_scaled.m23 * dL_dcov3d.m22 + rotation_scaled.m33 * dL_dcov3d.m23),
+                2.0f * (rotation_scaled.m11 * dL_dcov3d.m13 + rotation_scaled.m21 * dL_dcov3d.m23 + rotation_scaled.m31 * dL_dcov3d.m33),
+                2.0f * (rotation_scaled.m12 * dL_dcov3d.m13 + rotation_scaled.m22 * dL_dcov3d.m23 + rotation_scaled.m32 * dL_dcov3d.m33),
+                2.0f * (rotation_scaled.m13 * dL_dcov3d.m13 + rotation_scaled.m23 * dL_dcov3d.m23 + rotation_scaled.m33 * dL_dcov3d.m33)};
+            const float dL_dqxx = -dL_drotation.m22 - dL_drotation.m33;
+            const float dL_dqyy = -dL_drotation.m11 - dL_drotation.m33;
+            const float dL_dqzz = -dL_drotation.m11 - dL_drotation.m22;
+            const float dL_dqxy = dL_drotation.m12 + dL_drotation.m21;
+            const float dL_dqxz = dL_drotation.m13 + dL_drotation.m31;
+            const float dL_dqyz = dL_drotation.m23 + dL_drotation.m32;
+            const float dL_dqrx = dL_drotation.m32 - dL_drotation.m23;
+            const float dL_dqry = dL_drotation.m13 - dL_drotation.m31;
+            const float dL_dqrz = dL_drotation.m21 - dL_drotation.m12;
+            const float dL_dq_norm_helper = qxx * dL_dqxx + qyy * dL_dqyy + qzz * dL_dqzz + qxy * dL_dqxy + qxz * dL_dqxz + qyz * dL_dqyz + qrx * dL_dqrx + qry * dL_dqry + qrz * dL_dqrz;
+            const float4 dL_draw_rotation = 2.0f * make_float4(qx * dL_dqrx + qy * dL_dqry + qz * dL_dqrz - qr * dL_dq_norm_helper, 2.0f * qx * dL_dqxx + qy * dL_dqxy + qz * dL_dqxz + qr * dL_dqrx - qx * dL_dq_norm_helper, 2.0f * qy * dL_dqyy + qx * dL_dqxy + qz * dL_dqyz + qr * dL_dqry - qy * dL_dq_norm_helper, 2.0f * qz * dL_dqzz + qx * dL_dqxz + qy * dL_dqyz + qr * dL_dqrz - qz * dL_dq_norm_helper) / q_norm_sq;
+            grad_raw_rotations[primitive_idx] = dL_draw_rotation;
+
+            // only needed for adaptive density control from the original 3dgs. One (count, gradient
+            // sum) half pair per primitive, this thread owns it so the update needs no atomics
+            if (densification_info != nullptr) {
+                const float2 info = __half22float2(densification_info[primitive_idx]);
+                densification_info[primitive_idx] = __floats2half2_rn(
+                    info.x + 1.0f,
+                    info.y + length(dL_dmean2d * make_float2(0.5f * w, 0.5f * h)));
+            }
+        } else if (primitive_idx < n_primitives) {
+            // primitives that were not rendered get zero gradients, nothing else writes their entries
+            grad_means[primitive_idx] = make_float3(0.0f);
+            grad_raw_scales[primitive_idx] = make_float3(0.0f);
+            grad_raw_rotations[primitive_idx] = make_float4(0.0f);
+            for (uint basis = 0; basis < total_bases_sh_rest; ++basis)
+                grad_sh_coefficients_rest[primitive_idx * total_bases_sh_rest + basis] = make_float3(0.0f);
         }
 
-        // 3d mean gradient from splatting
-        const float3 dL_dmean3d_from_splatting = make_float3(
-            w2c_r1.x * dL_dmean3d_cam.x + w2c_r2.x * dL_dmean3d_cam.y + w2c_r3.x * dL_dmean3d_cam.z,
-            w2c_r1.y * dL_dmean3d_cam.x + w2c_r2.y * dL_dmean3d_cam.y + w2c_r3.y * dL_dmean3d_cam.z,
-            w2c_r1.z * dL_dmean3d_cam.x + w2c_r2.z * dL_dmean3d_cam.y + w2c_r3.z * dL_dmean3d_cam.z);
-
-        // write total 3d mean gradient
-        const float3 dL_dmean3d = dL_dmean3d_from_splatting + dL_dmean3d_from_color;
-        grad_means[primitive_idx] = dL_dmean3d;
-
-        // raw scale gradient
-        const float dL_dvariance_x = rotation.m11 * rotation.m11 * dL_dcov3d.m11 + rotation.m21 * rotation.m21 * dL_dcov3d.m22 + rotation.m31 * rotation.m31 * dL_dcov3d.m33 +
-                                     2.0f * (rotation.m11 * rotation.m21 * dL_dcov3d.m12 + rotation.m11 * rotation.m31 * dL_dcov3d.m13 + rotation.m21 * rotation.m31 * dL_dcov3d.m23);
-        const float dL_dvariance_y = rotation.m12 * rotation.m12 * dL_dcov3d.m11 + rotation.m22 * rotation.m22 * dL_dcov3d.m22 + rotation.m32 * rotation.m32 * dL_dcov3d.m33 +
-                                     2.0f * (rotation.m12 * rotation.m22 * dL_dcov3d.m12 + rotation.m12 * rotation.m32 * dL_dcov3d.m13 + rotation.m22 * rotation.m32 * dL_dcov3d.m23);
-        const float dL_dvariance_z = rotation.m13 * rotation.m13 * dL_dcov3d.m11 + rotation.m23 * rotation.m23 * dL_dcov3d.m22 + rotation.m33 * rotation.m33 * dL_dcov3d.m33 +
-                                     2.0f * (rotation.m13 * rotation.m23 * dL_dcov3d.m12 + rotation.m13 * rotation.m33 * dL_dcov3d.m13 + rotation.m23 * rotation.m33 * dL_dcov3d.m23);
-        const float3 dL_draw_scale = make_float3(
-            2.0f * variance.x * dL_dvariance_x,
-            2.0f * variance.y * dL_dvariance_y,
-            2.0f * variance.z * dL_dvariance_z);
-        grad_raw_scales[primitive_idx] = dL_draw_scale;
-
-        // raw rotation gradient
-        const mat3x3 dL_drotation = {
-            2.0f * (rotation_scaled.m11 * dL_dcov3d.m11 + rotation_scaled.m21 * dL_dcov3d.m12 + rotation_scaled.m31 * dL_dcov3d.m13),
-            2.0f * (rotation_scaled.m12 * dL_dcov3d.m11 + rotation_scaled.m22 * dL_dcov3d.m12 + rotation_scaled.m32 * dL_dcov3d.m13),
-            2.0f * (rotation_scaled.m13 * dL_dcov3d.m11 + rotation_scaled.m23 * dL_dcov3d.m12 + rotation_scaled.m33 * dL_dcov3d.m13),
-            2.0f * (rotation_scaled.m11 * dL_dcov3d.m12 + rotation_scaled.m21 * dL_dcov3d.m22 + rotation_scaled.m31 * dL_dcov3d.m23),
-            2.0f * (rotation_scaled.m12 * dL_dcov3d.m12 + rotation_scaled.m22 * dL_dcov3d.m22 + rotation_scaled.m32 * dL_dcov3d.m23),
-            2.0f * (rotation_scaled.m13 * dL_dcov3d.m12 + rotation_scaled.m23 * dL_dcov3d.m22 + rotation_scaled.m33 * dL_dcov3d.m23),
-            2.0f * (rotation_scaled.m11 * dL_dcov3d.m13 + rotation_scaled.m21 * dL_dcov3d.m23 + rotation_scaled.m31 * dL_dcov3d.m33),
-            2.0f * (rotation_scaled.m12 * dL_dcov3d.m13 + rotation_scaled.m22 * dL_dcov3d.m23 + rotation_scaled.m32 * dL_dcov3d.m33),
-            2.0f * (rotation_scaled.m13 * dL_dcov3d.m13 + rotation_scaled.m23 * dL_dcov3d.m23 + rotation_scaled.m33 * dL_dcov3d.m33)};
-        const float dL_dqxx = -dL_drotation.m22 - dL_drotation.m33;
-        const float dL_dqyy = -dL_drotation.m11 - dL_drotation.m33;
-        const float dL_dqzz = -dL_drotation.m11 - dL_drotation.m22;
-        const float dL_dqxy = dL_drotation.m12 + dL_drotation.m21;
-        const float dL_dqxz = dL_drotation.m13 + dL_drotation.m31;
-        const float dL_dqyz = dL_drotation.m23 + dL_drotation.m32;
-        const float dL_dqrx = dL_drotation.m32 - dL_drotation.m23;
-        const float dL_dqry = dL_drotation.m13 - dL_drotation.m31;
-        const float dL_dqrz = dL_drotation.m21 - dL_drotation.m12;
-        const float dL_dq_norm_helper = qxx * dL_dqxx + qyy * dL_dqyy + qzz * dL_dqzz + qxy * dL_dqxy + qxz * dL_dqxz + qyz * dL_dqyz + qrx * dL_dqrx + qry * dL_dqry + qrz * dL_dqrz;
-        const float4 dL_draw_rotation = 2.0f * make_float4(qx * dL_dqrx + qy * dL_dqry + qz * dL_dqrz - qr * dL_dq_norm_helper, 2.0f * qx * dL_dqxx + qy * dL_dqxy + qz * dL_dqxz + qr * dL_dqrx - qx * dL_dq_norm_helper, 2.0f * qy * dL_dqyy + qx * dL_dqxy + qz * dL_dqyz + qr * dL_dqry - qy * dL_dq_norm_helper, 2.0f * qz * dL_dqzz + qx * dL_dqxz + qy * dL_dqyz + qr * dL_dqrz - qz * dL_dq_norm_helper) / q_norm_sq;
-        grad_raw_rotations[primitive_idx] = dL_draw_rotation;
-
-        // TODO: only needed for adaptive density control from the original 3dgs
-        if (densification_info != nullptr) {
-            densification_info[primitive_idx] += 1.0f;
-            densification_info[n_primitives + primitive_idx] += length(dL_dmean2d * make_float2(0.5f * w, 0.5f * h));
+        // every primitive adds to the same 12 entries of grad_w2c, so reduce over the block first
+        // and issue 12 atomics per block instead of 12 per primitive
+        if (grad_w2c != nullptr) {
+            const float w2c_grads[12] = {
+                dL_dmean3d_cam_out.x * mean3d_out.x, dL_dmean3d_cam_out.x * mean3d_out.y, dL_dmean3d_cam_out.x * mean3d_out.z, dL_dmean3d_cam_out.x,
+                dL_dmean3d_cam_out.y * mean3d_out.x, dL_dmean3d_cam_out.y * mean3d_out.y, dL_dmean3d_cam_out.y * mean3d_out.z, dL_dmean3d_cam_out.y,
+                dL_dmean3d_cam_out.z * mean3d_out.x, dL_dmean3d_cam_out.z * mean3d_out.y, dL_dmean3d_cam_out.z * mean3d_out.z, dL_dmean3d_cam_out.z};
+            constexpr uint n_warps = config::block_size_preprocess_backward / 32;
+            __shared__ float collected_w2c_grads[n_warps][12];
+            auto warp = cg::tiled_partition<32>(block);
+#pragma unroll
+            for (int i = 0; i < 12; ++i) {
+                const float warp_sum = cg::reduce(warp, w2c_grads[i], cg::plus<float>());
+                if (warp.thread_rank() == 0)
+                    collected_w2c_grads[warp.meta_group_rank()][i] = warp_sum;
+            }
+            block.sync();
+            const uint entry = block.thread_rank();
+            if (entry < 12) {
+                float block_sum = 0.0f;
+#pragma unroll
+                for (int i = 0; i < n_warps; ++i)
+                    block_sum += collected_w2c_grads[i][entry];
+                // rows of the 3x4 matrix are float4s, so entries are contiguous floats
+                atomicAdd(reinterpret_cast<float*>(grad_w2c) + entry, block_sum);
+            }
         }
     }
 
     // based on https://github.com/humansensinglab/taming-3dgs/blob/fd0f7d9edfe135eb4eefd3be82ee56dada7f2a16/submodules/diff-gaussian-rasterization/cuda_rasterizer/backward.cu#L404
+    template <typename Tile>
     __global__ void blend_backward_cu(
         const uint2* tile_instance_ranges,
         const uint* tile_bucket_offsets,
@@ -252,18 +322,23 @@ namespace fast_gs::rasterization::kernels::backward {
         const uint* tile_n_contributions,
         const uint* bucket_tile_index,
         const float4* bucket_color_transmittance,
+        const uint* primitive_n_touched_tiles,
         float2* grad_mean2d,
         float* grad_conic,
         float* grad_raw_opacity,
         float3* grad_color,
+        float* max_contribution,
+        const uint* n_buckets_total,
+        const uint bucket_begin, // bucket of the first block and the first state in bucket_color_transmittance
         const uint n_buckets,
         const uint n_primitives,
         const uint width,
         const uint height,
         const uint grid_width) {
         auto block = cg::this_thread_block();
-        const uint bucket_idx = block.group_index().x;
-        if (bucket_idx >= n_buckets)
+        const uint bucket_idx = bucket_begin + block.group_index().x;
+        // n_buckets is the launch size, which is a capacity rather than the count in upper-bound mode
+        if (bucket_idx >= n_buckets || bucket_idx >= *n_buckets_total)
             return;
         auto warp = cg::tiled_partition<32>(block);
         const uint lane_idx = warp.thread_rank();
@@ -273,12 +348,15 @@ namespace fast_gs::rasterization::kernels::backward {
         const int tile_n_primitives = tile_instance_range.y - tile_instance_range.x;
         const uint tile_first_bucket_offset = tile_idx == 0 ? 0 : tile_bucket_offsets[tile_idx - 1];
         const int tile_bucket_idx = bucket_idx - tile_first_bucket_offset;
-        if (tile_bucket_idx * 32 >= tile_max_n_contributions[tile_idx])
-            return;
-
         const int tile_primitive_idx = tile_bucket_idx * 32 + lane_idx;
         const int instance_idx = tile_instance_range.x + tile_primitive_idx;
         const bool valid_primitive = tile_primitive_idx < tile_n_primitives;
+        if (tile_bucket_idx * 32 >= tile_max_n_contributions[tile_idx]) {
+            // hidden behind saturated pixels: rasterized, but without any contribution here
+            if (max_contribution != nullptr && valid_primitive)
+                atomicMax(reinterpret_cast<int*>(&max_contribution[instance_primitive_indices[instance_idx]]), 0);
+            return;
+        }
 
         // load gaussian data
         uint primitive_idx = 0;
@@ -311,10 +389,11 @@ namespace fast_gs::rasterization::kernels::backward {
         float3 dL_dconic_accum = {0.0f, 0.0f, 0.0f};
         float dL_draw_opacity_partial_accum = 0.0f;
         float3 dL_dcolor_accum = {0.0f, 0.0f, 0.0f};
+        float max_blending_weight = 0.0f;
 
         // tile metadata
         const uint2 tile_coords = {tile_idx % grid_width, tile_idx / grid_width};
-        const uint2 start_pixel_coords = {tile_coords.x * config::tile_width, tile_coords.y * config::tile_height};
+        const uint2 start_pixel_coords = {tile_coords.x * Tile::width, tile_coords.y * Tile::height};
 
         uint last_contributor;
         float3 color_pixel_after;
@@ -322,18 +401,18 @@ namespace fast_gs::rasterization::kernels::backward {
         float3 grad_color_pixel;
         float grad_alpha_common;
 
-        bucket_color_transmittance += bucket_idx * config::block_size_blend;
+        bucket_color_transmittance += (bucket_idx - bucket_begin) * Tile::n_pixels;
         __shared__ uint collected_last_contributor[32];
         __shared__ float4 collected_color_pixel_after_transmittance[32];
         __shared__ float4 collected_grad_info_pixel[32];
 
 // iterate over all pixels in the tile
 #pragma unroll
-        for (int i = 0; i < config::block_size_blend + 31; ++i) {
+        for (int i = 0; i < Tile::n_pixels + 31; ++i) {
             if (i % 32 == 0) {
                 const uint local_idx = i + lane_idx;
                 const float4 color_transmittance = bucket_color_transmittance[local_idx];
-                const uint2 pixel_coords = {start_pixel_coords.x + local_idx % config::tile_width, start_pixel_coords.y + local_idx / config::tile_width};
+                const uint2 pixel_coords = {start_pixel_coords.x + local_idx % Tile::width, start_pixel_coords.y + local_idx / Tile::width};
                 const uint pixel_idx = width * pixel_coords.y + pixel_coords.x;
                 // final values from forward pass before background blend and the respective gradients
                 float3 color_pixel, grad_color_pixel;
@@ -374,11 +453,11 @@ namespace fast_gs::rasterization::kernels::backward {
 
             // which pixel index should this thread deal with?
             const int idx = i - static_cast<int>(lane_idx);
-            const uint2 pixel_coords = {start_pixel_coords.x + idx % config::tile_width, start_pixel_coords.y + idx / config::tile_width};
+            const uint2 pixel_coords = {start_pixel_coords.x + idx % Tile::width, start_pixel_coords.y + idx / Tile::width};
             const bool valid_pixel = pixel_coords.x < width && pixel_coords.y < height;
 
             // leader thread loads values from shared memory into registers
-            if (valid_primitive && valid_pixel && lane_idx == 0 && idx < config::block_size_blend) {
+            if (valid_primitive && valid_pixel && lane_idx == 0 && idx < Tile::n_pixels) {
                 const int current_shmem_index = i % 32;
                 last_contributor = collected_last_contributor[current_shmem_index];
                 const float4 color_pixel_after_transmittance = collected_color_pixel_after_transmittance[current_shmem_index];
@@ -389,7 +468,7 @@ namespace fast_gs::rasterization::kernels::backward {
                 grad_alpha_common = grad_info_pixel.w;
             }
 
-            const bool skip = !valid_primitive || !valid_pixel || idx < 0 || idx >= config::block_size_blend || tile_primitive_idx >= last_contributor;
+            const bool skip = !valid_primitive || !valid_pixel || idx < 0 || idx >= Tile::n_pixels || tile_primitive_idx >= last_contributor;
             if (skip)
                 continue;
 
@@ -405,6 +484,7 @@ namespace fast_gs::rasterization::kernels::backward {
             const float one_minus_alpha = 1.0f - alpha;
 
             const float blending_weight = transmittance * alpha;
+            max_blending_weight = fmaxf(max_blending_weight, blending_weight);
 
             // color gradient
             const float3 dL_dcolor = blending_weight * grad_color_pixel * color_grad_factor;
@@ -433,18 +513,24 @@ namespace fast_gs::rasterization::kernels::backward {
             transmittance *= one_minus_alpha;
         }
 
-        // finally add the gradients using atomics
+        // finally add the gradients
+        // lanes of a bucket always hold distinct primitives of one tile, so there is nothing to
+        // aggregate within the warp. contention comes from other tiles' buckets instead, and a
+        // primitive that touches a single tile has exactly one instance and therefore one writer.
         if (valid_primitive) {
-            atomicAdd(&grad_mean2d[primitive_idx].x, dL_dmean2d_accum.x);
-            atomicAdd(&grad_mean2d[primitive_idx].y, dL_dmean2d_accum.y);
-            atomicAdd(&grad_conic[primitive_idx], dL_dconic_accum.x);
-            atomicAdd(&grad_conic[n_primitives + primitive_idx], dL_dconic_accum.y);
-            atomicAdd(&grad_conic[2 * n_primitives + primitive_idx], dL_dconic_accum.z);
+            const bool exclusive = primitive_n_touched_tiles[primitive_idx] == 1;
+            add_gradient(&grad_mean2d[primitive_idx], dL_dmean2d_accum, exclusive);
+            add_gradient(&grad_conic[primitive_idx], dL_dconic_accum.x, exclusive);
+            add_gradient(&grad_conic[n_primitives + primitive_idx], dL_dconic_accum.y, exclusive);
+            add_gradient(&grad_conic[2 * n_primitives + primitive_idx], dL_dconic_accum.z, exclusive);
             const float dL_draw_opacity = dL_draw_opacity_partial_accum * (1.0f - opacity);
-            atomicAdd(&grad_raw_opacity[primitive_idx], dL_draw_opacity);
-            atomicAdd(&grad_color[primitive_idx].x, dL_dcolor_accum.x);
-            atomicAdd(&grad_color[primitive_idx].y, dL_dcolor_accum.y);
-            atomicAdd(&grad_color[primitive_idx].z, dL_dcolor_accum.z);
+            add_gradient(&grad_raw_opacity[primitive_idx], dL_draw_opacity, exclusive);
+            add_gradient(&grad_color[primitive_idx].x, dL_dcolor_accum.x, exclusive);
+            add_gradient(&grad_color[primitive_idx].y, dL_dcolor_accum.y, exclusive);
+            add_gradient(&grad_color[primitive_idx].z, dL_dcolor_accum.z, exclusive);
+            // the weights are never negative, so their bits order like ints
+            if (max_contribution != nullptr)
+                atomicMax(reinterpret_cast<int*>(&max_contribution[primitive_idx]), __float_as_int(max_blending_weight));
         }
     }
 
@@ -15,13 +15,14 @@ namespace cg = cooperative_groups;
 
 namespace fast_gs::rasterization::kernels::forward {
 
+    template <uint ACTIVE_SH_BASES, Projection PROJECTION, typename SHT>
     __global__ void preprocess_cu(
         const float3* means,
         const float3* raw_scales,
         const float4* raw_rotations,
         const float* raw_opacities,
         const float3* sh_coefficients_0,
-        const float3* sh_coefficients_rest,
+        const SHT* sh_coefficients_rest,
         const float4* w2c,
         const float3* cam_position,
         uint* primitive_depth_keys,
@@ -31,13 +32,19 @@ namespace fast_gs::rasterization::kernels::forward {
         float2* primitive_mean2d,
         float4* primitive_conic_opacity,
         float3* primitive_color,
+        float* primitive_depth,
         uint* n_visible_primitives,
         uint* n_instances,
+        uint* n_bounding_instances,
+        const uint* chunk_primitive_indices,
+        const float3* chunk_bounds,
         const uint n_primitives,
         const uint grid_width,
         const uint grid_height,
-        const uint active_sh_bases,
+        const uint tile_width,
+        const uint tile_height,
         const uint total_bases_sh_rest,
+        const uint depth_key_shift,
         const float w,
         const float h,
         const float fx,
@@ -52,10 +59,20 @@ namespace fast_gs::rasterization::kernels::forward {
             active = false;
             primitive_idx = n_primitives - 1;
         }
+        // with a spatial index every block is one chunk of morton-ordered primitives
+        if (chunk_primitive_indices != nullptr)
+            primitive_idx = chunk_primitive_indices[primitive_idx];
 
         if (active)
             primitive_n_touched_tiles[primitive_idx] = 0;
 
+        // the test is uniform per block, so a culled chunk leaves before touching any primitive data
+        if (chunk_bounds != nullptr) {
+            const uint chunk_idx = cg::this_thread_block().group_index().x;
+            if (!is_box_in_frustum<PROJECTION>(chunk_bounds[2 * chunk_idx], chunk_bounds[2 * chunk_idx + 1], w2c, w, h, fx, fy, cx, cy, near_, far_, config::chunk_culling_padding))
+                return;
+        }
+
         // load 3d mean
         const float3 mean3d = means[primitive_idx];
 
@@ -104,22 +121,28 @@ namespace fast_gs::rasterization::kernels::forward {
         };
 
         // compute 2d mean in normalized image coordinates
+        constexpr bool orthographic = PROJECTION == Projection::Orthographic;
         const float4 w2c_r1 = w2c[0];
-        const float x = (w2c_r1.x * mean3d.x + w2c_r1.y * mean3d.y + w2c_r1.z * mean3d.z + w2c_r1.w) / depth;
         const float4 w2c_r2 = w2c[1];
-        const float y = (w2c_r2.x * mean3d.x + w2c_r2.y * mean3d.y + w2c_r2.z * mean3d.z + w2c_r2.w) / depth;
-
-        // ewa splatting
-        const float clip_left = (-0.15f * w - cx) / fx;
-        const float clip_right = (1.15f * w - cx) / fx;
-        const float clip_top = (-0.15f * h - cy) / fy;
-        const float clip_bottom = (1.15f * h - cy) / fy;
-        const float tx = clamp(x, clip_left, clip_right);
-        const float ty = clamp(y, clip_top, clip_bottom);
-        const float j11 = fx / depth;
-        const float j13 = -j11 * tx;
-        const float j22 = fy / depth;
-        const float j23 = -j22 * ty;
+        const float x_cam = w2c_r1.x * mean3d.x + w2c_r1.y * mean3d.y + w2c_r1.z * mean3d.z + w2c_r1.w;
+        const float y_cam = w2c_r2.x * mean3d.x + w2c_r2.y * mean3d.y + w2c_r2.z * mean3d.z + w2c_r2.w;
+        const float x = orthographic ? x_cam : x_cam / depth;
+        const float y = orthographic ? y_cam : y_cam / depth;
+
+        // ewa splatting, the orthographic jacobian is constant
+        float j11 = fx, j13 = 0.0f, j22 = fy, j23 = 0.0f;
+        if constexpr (!orthographic) {
+            const float clip_left = (-0.15f * w - cx) / fx;
+            const float clip_right = (1.15f * w - cx) / fx;
+            const float clip_top = (-0.15f * h - cy) / fy;
+            const float clip_bottom = (1.15f * h - cy) / fy;
+            const float tx = clamp(x, clip_left, clip_right);
+            const float ty = clamp(y, clip_top, clip_bottom);
+            j11 = fx / depth;
+            j13 = -j11 * tx;
+            j22 = fy / depth;
+            j23 = -j22 * ty;
+        }
         const float3 jw_r1 = make_float3(
             j11 * w2c_r1.x + j13 * w2c_r3.x,
             j11 * w2c_r1.y + j13 * w2c_r3.y,
@@ -161,10 +184,10 @@ namespace fast_gs::rasterization::kernels::forward {
         float extent_x = fmaxf(power_threshold_factor * sqrtf(cov2d.x) - 0.5f, 0.0f);
         float extent_y = fmaxf(power_threshold_factor * sqrtf(cov2d.z) - 0.5f, 0.0f);
         const uint4 screen_bounds = make_uint4(
-            min(grid_width, static_cast<uint>(max(0, __float2int_rd((mean2d.x - extent_x) / static_cast<float>(config::tile_width))))),   // x_min
-            min(grid_width, static_cast<uint>(max(0, __float2int_ru((mean2d.x + extent_x) / static_cast<float>(config::tile_width))))),   // x_max
-            min(grid_height, static_cast<uint>(max(0, __float2int_rd((mean2d.y - extent_y) / static_cast<float>(config::tile_height))))), // y_min
-            min(grid_height, static_cast<uint>(max(0, __float2int_ru((mean2d.y + extent_y) / static_cast<float>(config::tile_height)))))  // y_max
+            min(grid_width, static_cast<uint>(max(0, __float2int_rd((mean2d.x - extent_x) / static_cast<float>(tile_width))))),   // x_min
+            min(grid_width, static_cast<uint>(max(0, __float2int_ru((mean2d.x + extent_x) / static_cast<float>(tile_width))))),   // x_max
+            min(grid_height, static_cast<uint>(max(0, __float2int_rd((mean2d.y - extent_y) / static_cast<float>(tile_height))))), // y_min
+            min(grid_height, static_cast<uint>(max(0, __float2int_ru((mean2d.y + extent_y) / static_cast<float>(tile_height)))))  // y_max
         );
         const uint n_touched_tiles_max = (screen_bounds.y - screen_bounds.x) * (screen_bounds.w - screen_bounds.z);
         if (n_touched_tiles_max == 0)
@@ -177,7 +200,12 @@ namespace fast_gs::rasterization::kernels::forward {
         // compute exact number of tiles the primitive overlaps
         const uint n_touched_tiles = compute_exact_n_touched_tiles(
             mean2d, conic, screen_bounds,
-            power_threshold, n_touched_tiles_max, active);
+            power_threshold, n_touched_tiles_max,
+            tile_width, tile_height, active);
+
+        // statistics only, instances the bounding rectangle alone would have created
+        if (n_bounding_instances != nullptr && active)
+            atomicAdd(n_bounding_instances, n_touched_tiles_max);
 
         // cooperative threads no longer needed
         if (n_touched_tiles == 0 || !active)
@@ -192,13 +220,16 @@ namespace fast_gs::rasterization::kernels::forward {
             static_cast<ushort>(screen_bounds.w));
         primitive_mean2d[primitive_idx] = mean2d;
         primitive_conic_opacity[primitive_idx] = make_float4(conic, opacity);
-        primitive_color[primitive_idx] = convert_sh_to_color(
+        primitive_color[primitive_idx] = convert_sh_to_color<ACTIVE_SH_BASES>(
             sh_coefficients_0, sh_coefficients_rest,
             mean3d, cam_position[0],
-            primitive_idx, active_sh_bases, total_bases_sh_rest);
+            primitive_idx, total_bases_sh_rest);
+        if (primitive_depth != nullptr)
+            primitive_depth[primitive_idx] = depth;
 
         const uint offset = atomicAdd(n_visible_primitives, 1);
-        const uint depth_key = __float_as_uint(depth);
+        // positive floats order like their bits, relative to near they span only the sorted bit range
+        const uint depth_key = (__float_as_uint(depth) - __float_as_uint(near_)) >> depth_key_shift;
         primitive_depth_keys[offset] = depth_key;
         primitive_indices[offset] = primitive_idx;
         atomicAdd(n_instances, n_touched_tiles);
@@ -208,10 +239,16 @@ namespace fast_gs::rasterization::kernels::forward {
         const uint* primitive_indices_sorted,
         const uint* primitive_n_touched_tiles,
         uint* primitive_offset,
-        const uint n_visible_primitives) {
+        const uint* n_visible_primitives,
+        const uint n_items) {
         auto idx = cg::this_grid().thread_rank();
-        if (idx >= n_visible_primitives)
+        if (idx >= n_items)
+            return;
+        // entries past the visible count only exist in upper-bound mode and must not add instances
+        if (idx >= *n_visible_primitives) {
+            primitive_offset[idx] = 0;
             return;
+        }
         const uint primitive_idx = primitive_indices_sorted[idx];
         primitive_offset[idx] = primitive_n_touched_tiles[primitive_idx];
     }
@@ -226,10 +263,14 @@ namespace fast_gs::rasterization::kernels::forward {
         ushort* instance_keys,
         uint* instance_primitive_indices,
         const uint grid_width,
-        const uint n_visible_primitives) {
+        const uint tile_width,
+        const uint tile_height,
+        const uint* n_visible_primitives_ptr,
+        const uint n_max_instances) {
         auto block = cg::this_thread_block();
         auto warp = cg::tiled_partition<32u>(block);
         uint idx = cg::this_grid().thread_rank();
+        const uint n_visible_primitives = *n_visible_primitives_ptr;
 
         bool active = true;
         if (idx >= n_visible_primitives) {
@@ -264,10 +305,12 @@ namespace fast_gs::rasterization::kernels::forward {
             for (uint instance_idx = 0; instance_idx < tile_count && instance_idx < config::n_sequential_threshold; instance_idx++) {
                 const uint tile_y = screen_bounds.z + (instance_idx / screen_bounds_width);
                 const uint tile_x = screen_bounds.x + (instance_idx % screen_bounds_width);
-                if (will_primitive_contribute(mean2d_shifted, conic, tile_x, tile_y, power_threshold)) {
-                    const ushort tile_key = static_cast<ushort>(tile_y * grid_width + tile_x);
-                    instance_keys[current_write_offset] = tile_key;
-                    instance_primitive_indices[current_write_offset] = primitive_idx;
+                if (will_primitive_contribute(mean2d_shifted, conic, tile_x, tile_y, tile_width, tile_height, power_threshold)) {
+                    if (current_write_offset < n_max_instances) {
+                        const ushort tile_key = static_cast<ushort>(tile_y * grid_width + tile_x);
+                        instance_keys[current_write_offset] = tile_key;
+                        instance_primitive_indices[current_write_offset] = primitive_idx;
+                    }
                     current_write_offset++;
                 }
             }
@@ -303,12 +346,13 @@ namespace fast_gs::rasterization::kernels::forward {
                 const int active_current = instance_idx < tile_count_coop;
                 const uint tile_y = screen_bounds_coop.z + (instance_idx / screen_bounds_width_coop);
                 const uint tile_x = screen_bounds_coop.x + (instance_idx % screen_bounds_width_coop);
-                const uint write = active_current && will_primitive_contribute(mean2d_shifted_coop, conic_coop, tile_x, tile_y, power_threshold_coop);
+                const uint write = active_current && will_primitive_contribute(mean2d_shifted_coop, conic_coop, tile_x, tile_y, tile_width, tile_height, power_threshold_coop);
                 const uint write_ballot = __ballot_sync(0xffffffffu, write);
                 const uint n_writes = __popc(write_ballot);
                 const uint write_offset_current = __popc(write_ballot & lane_mask_allprev_excl);
                 const uint write_offset = current_write_offset_coop + write_offset_current;
-                if (write) {
+                // offsets follow depth order, so an overflowing instance buffer drops the farthest instances
+                if (write && write_offset < n_max_instances) {
                     const ushort tile_key = static_cast<ushort>(tile_y * grid_width + tile_x);
                     instance_keys[write_offset] = tile_key;
                     instance_primitive_indices[write_offset] = primitive_idx_coop;
@@ -323,8 +367,10 @@ namespace fast_gs::rasterization::kernels::forward {
     __global__ void extract_instance_ranges_cu(
         const ushort* instance_keys,
         uint2* tile_instance_ranges,
-        const uint n_instances) {
+        const uint* n_instances_ptr,
+        const uint n_max_instances) {
         auto instance_idx = cg::this_grid().thread_rank();
+        const uint n_instances = min(*n_instances_ptr, n_max_instances);
         if (instance_idx >= n_instances)
             return;
         const ushort instance_tile_idx = instance_keys[instance_idx];
@@ -341,6 +387,21 @@ namespace fast_gs::rasterization::kernels::forward {
             tile_instance_ranges[instance_tile_idx].y = n_instances;
     }
 
+    // One block of tile size per tile: empties the instance range of every tile whose pixels are all
+    // zero in the mask, the instances stay sorted but nothing reads them
+    __global__ void mask_tiles_cu(
+        const float* pixel_mask,
+        uint2* tile_instance_ranges,
+        const uint width,
+        const uint height,
+        const uint grid_width) {
+        const uint2 pixel_coords = make_uint2(blockIdx.x * blockDim.x + threadIdx.x, blockIdx.y * blockDim.y + threadIdx.y);
+        const bool inside = pixel_coords.x < width && pixel_coords.y < height;
+        const bool covered = inside && pixel_mask[width * pixel_coords.y + pixel_coords.x] != 0.0f;
+        if (!__syncthreads_or(covered) && threadIdx.x == 0 && threadIdx.y == 0)
+            tile_instance_ranges[blockIdx.y * grid_width + blockIdx.x] = make_uint2(0, 0);
+    }
+
     __global__ void extract_bucket_counts(
         uint2* tile_instance_ranges,
         uint* tile_n_buckets,
@@ -353,68 +414,67 @@ namespace fast_gs::rasterization::kernels::forward {
         tile_n_buckets[tile_idx] = n_buckets;
     }
 
-    __global__ void __launch_bounds__(config::block_size_blend) blend_cu(
-        const uint2* tile_instance_ranges,
-        const uint* tile_bucket_offsets,
+    // Front-to-back blending of the instances [range_start, range_end) of one tile, starting from an empty
+    // pixel. Stores the color and transmittance in front of every bucket of 32 instances for the backward.
+    // With DEPTH it also accumulates the alpha-weighted depth and tracks the median depth, the depth of
+    // the contribution that takes the transmittance below 0.5 (or the last one). RENDER_ONLY skips the
+    // bucket states, nothing is written for a backward. Only the states of the buckets in
+    // [bucket_window_begin, bucket_window_end) are stored, relative to bucket_window_begin.
+    template <typename Tile, bool DEPTH, bool RENDER_ONLY = false>
+    __device__ inline void blend_instance_range(
+        const cg::thread_block& block,
+        const uint range_start,
+        const uint range_end,
+        uint bucket_offset,
+        const uint bucket_window_begin,
+        const uint bucket_window_end,
         const uint* instance_primitive_indices,
         const float2* primitive_mean2d,
         const float4* primitive_conic_opacity,
         const float3* primitive_color,
-        float* image,
-        float* alpha_map,
-        uint* tile_max_n_contributions,
-        uint* tile_n_contributions,
-        uint* bucket_tile_index,
+        const float* primitive_depth,
         float4* bucket_color_transmittance,
-        const uint width,
-        const uint height,
-        const uint grid_width) {
-        auto block = cg::this_thread_block();
-        const dim3 group_index = block.group_index();
-        const dim3 thread_index = block.thread_index();
+        const float2 pixel,
+        bool& done,
+        float3& color_pixel,
+        float& transmittance,
+        uint& n_contributions,
+        float& depth_pixel,
+        float& median_depth) {
         const uint thread_rank = block.thread_rank();
-        const uint2 pixel_coords = make_uint2(group_index.x * config::tile_width + thread_index.x, group_index.y * config::tile_height + thread_index.y);
-        const bool inside = pixel_coords.x < width && pixel_coords.y < height;
-        const float2 pixel = make_float2(__uint2float_rn(pixel_coords.x), __uint2float_rn(pixel_coords.y)) + 0.5f;
-
-        const uint tile_idx = group_index.y * grid_width + group_index.x;
-        const uint2 tile_range = tile_instance_ranges[tile_idx];
-        const int n_points_total = tile_range.y - tile_range.x;
-
-        uint bucket_offset = tile_idx == 0 ? 0 : tile_bucket_offsets[tile_idx - 1];
-        const int n_buckets = div_round_up(n_points_total, 32); // re-computing is faster than reading from tile_n_buckets
-        for (int n_buckets_remaining = n_buckets, current_bucket_idx = thread_rank; n_buckets_remaining > 0; n_buckets_remaining -= config::block_size_blend, current_bucket_idx += config::block_size_blend) {
-            if (current_bucket_idx < n_buckets)
-                bucket_tile_index[bucket_offset + current_bucket_idx] = tile_idx;
-        }
-
         // setup shared memory
-        __shared__ float2 collected_mean2d[config::block_size_blend];
-        __shared__ float4 collected_conic_opacity[config::block_size_blend];
-        __shared__ float3 collected_color[config::block_size_blend];
+        __shared__ float2 collected_mean2d[Tile::n_pixels];
+        __shared__ float4 collected_conic_opacity[Tile::n_pixels];
+        __shared__ float3 collected_color[Tile::n_pixels];
+        __shared__ float collected_depth[DEPTH ? Tile::n_pixels : 1];
         // initialize local storage
-        float3 color_pixel = make_float3(0.0f);
-        float transmittance = 1.0f;
+        color_pixel = make_float3(0.0f);
+        transmittance = 1.0f;
+        n_contributions = 0;
+        depth_pixel = 0.0f;
+        median_depth = 0.0f;
         uint n_possible_contributions = 0;
-        uint n_contributions = 0;
-        bool done = !inside;
         // collaborative loading and processing
-        for (int n_points_remaining = n_points_total, current_fetch_idx = tile_range.x + thread_rank; n_points_remaining > 0; n_points_remaining -= config::block_size_blend, current_fetch_idx += config::block_size_blend) {
-            if (__syncthreads_count(done) == config::block_size_blend)
+        for (int n_points_remaining = range_end - range_start, current_fetch_idx = range_start + thread_rank; n_points_remaining > 0; n_points_remaining -= Tile::n_pixels, current_fetch_idx += Tile::n_pixels) {
+            if (__syncthreads_count(done) == Tile::n_pixels)
                 break;
-            if (current_fetch_idx < tile_range.y) {
+            if (current_fetch_idx < range_end) {
                 const uint primitive_idx = instance_primitive_indices[current_fetch_idx];
                 collected_mean2d[thread_rank] = primitive_mean2d[primitive_idx];
                 collected_conic_opacity[thread_rank] = primitive_conic_opacity[primitive_idx];
                 const float3 color = fmaxf(primitive_color[primitive_idx], 0.0f);
                 collected_color[thread_rank] = color;
+                if constexpr (DEPTH)
+                    collected_depth[thread_rank] = primitive_depth[primitive_idx];
             }
             block.sync();
-            const int current_batch_size = min(config::block_size_blend, n_points_remaining);
+            const int current_batch_size = min(Tile::n_pixels, n_points_remaining);
             for (int j = 0; !done && j < current_batch_size; ++j) {
-                if (j % 32 == 0) {
-                    const float4 current_color_transmittance = make_float4(color_pixel, transmittance);
-                    bucket_color_transmittance[bucket_offset * config::block_size_blend + thread_rank] = current_color_transmittance;
+                if (!RENDER_ONLY && j % 32 == 0) {
+                    if (bucket_offset >= bucket_window_begin && bucket_offset < bucket_window_end) {
+                        const float4 current_color_transmittance = make_float4(color_pixel, transmittance);
+                        bucket_color_transmittance[(bucket_offset - bucket_window_begin) * Tile::n_pixels + thread_rank] = current_color_transmittance;
+                    }
                     bucket_offset++;
                 }
                 n_possible_contributions++;
@@ -435,10 +495,32 @@ namespace fast_gs::rasterization::kernels::forward {
                     continue;
                 }
                 color_pixel += transmittance * alpha * collected_color[j];
+                if constexpr (DEPTH) {
+                    depth_pixel += transmittance * alpha * collected_depth[j];
+                    if (transmittance > 0.5f)
+                        median_depth = collected_depth[j];
+                }
                 transmittance = next_transmittance;
                 n_contributions = n_possible_contributions;
             }
         }
+    }
+
+    template <typename Tile, bool RENDER_ONLY = false>
+    __device__ inline void store_tile_results(
+        const cg::thread_block& block,
+        const uint tile_idx,
+        const uint2 pixel_coords,
+        const bool inside,
+        const float3 color_pixel,
+        const float transmittance,
+        uint n_contributions,
+        float* image,
+        float* alpha_map,
+        uint* tile_max_n_contributions,
+        uint* tile_n_contributions,
+        const uint width,
+        const uint height) {
         if (inside) {
             const int pixel_idx = width * pixel_coords.y + pixel_coords.x;
             const int n_pixels = width * height;
@@ -447,15 +529,287 @@ namespace fast_gs::rasterization::kernels::forward {
             image[pixel_idx + n_pixels] = color_pixel.y;
             image[pixel_idx + n_pixels * 2] = color_pixel.z;
             alpha_map[pixel_idx] = 1.0f - transmittance;
-            tile_n_contributions[pixel_idx] = n_contributions;
+            if constexpr (!RENDER_ONLY)
+                tile_n_contributions[pixel_idx] = n_contributions;
         }
+        if constexpr (RENDER_ONLY)
+            return;
 
         // max reduce the number of contributions
-        typedef cub::BlockReduce<uint, config::tile_width, cub::BLOCK_REDUCE_WARP_REDUCTIONS, config::tile_height> BlockReduce;
+        typedef cub::BlockReduce<uint, Tile::width, cub::BLOCK_REDUCE_WARP_REDUCTIONS, Tile::height> BlockReduce;
         __shared__ typename BlockReduce::TempStorage temp_storage;
         n_contributions = BlockReduce(temp_storage).Reduce(n_contributions, thrust::maximum<uint>());
-        if (thread_rank == 0)
+        if (block.thread_rank() == 0)
             tile_max_n_contributions[tile_idx] = n_contributions;
     }
 
+    template <typename Tile, bool DEPTH, bool RENDER_ONLY>
+    __global__ void __launch_bounds__(Tile::n_pixels) blend_cu(
+        const uint2* tile_instance_ranges,
+        const uint* tile_bucket_offsets,
+        const uint* instance_primitive_indices,
+        const float2* primitive_mean2d,
+        const float4* primitive_conic_opacity,
+        const float3* primitive_color,
+        const float* primitive_depth,
+        float* image,
+        float* alpha_map,
+        float* depth_map,
+        uint* tile_max_n_contributions,
+        uint* tile_n_contributions,
+        uint* bucket_tile_index,
+        float4* bucket_color_transmittance,
+        const uint width,
+        const uint height,
+        const uint grid_width,
+        const bool skip_heavy_tiles) {
+        auto block = cg::this_thread_block();
+        const dim3 group_index = block.group_index();
+        const dim3 thread_index = block.thread_index();
+        const uint thread_rank = block.thread_rank();
+        const uint2 pixel_coords = make_uint2(group_index.x * Tile::width + thread_index.x, group_index.y * Tile::height + thread_index.y);
+        const bool inside = pixel_coords.x < width && pixel_coords.y < height;
+        const float2 pixel = make_float2(__uint2float_rn(pixel_coords.x), __uint2float_rn(pixel_coords.y)) + 0.5f;
+
+        const uint tile_idx = group_index.y * grid_width + group_index.x;
+        const uint2 tile_range = tile_instance_ranges[tile_idx];
+        const int n_points_total = tile_range.y - tile_range.x;
+        // heavy tiles are blended segment-wise by blend_segment_cu and blend_merge_cu
+        if (skip_heavy_tiles && n_points_total > config::blend_split_threshold)
+            return;
+
+        uint bucket_offset = 0;
+        if constexpr (!RENDER_ONLY) {
+            bucket_offset = tile_idx == 0 ? 0 : tile_bucket_offsets[tile_idx - 1];
+            const int n_buckets = div_round_up(n_points_total, 32); // re-computing is faster than reading from tile_n_buckets
+            for (int n_buckets_remaining = n_buckets, current_bucket_idx = thread_rank; n_buckets_remaining > 0; n_buckets_remaining -= Tile::n_pixels, current_bucket_idx += Tile::n_pixels) {
+                if (current_bucket_idx < n_buckets)
+                    bucket_tile_index[bucket_offset + current_bucket_idx] = tile_idx;
+            }
+        }
+
+        float3 color_pixel;
+        float transmittance;
+        uint n_contributions;
+        float depth_pixel;
+        float median_depth;
+        bool done = !inside;
+        // without a state buffer the backward replays the bucket states itself
+        blend_instance_range<Tile, DEPTH, RENDER_ONLY>(
+            block, tile_range.x, tile_range.y, bucket_offset, 0, bucket_color_transmittance != nullptr ? ~0u : 0u,
+            instance_primitive_indices, primitive_mean2d, primitive_conic_opacity, primitive_color, primitive_depth,
+            bucket_color_transmittance, pixel, done, color_pixel, transmittance, n_contributions, depth_pixel, median_depth);
+
+        if constexpr (DEPTH) {
+            if (inside) {
+                // [2, H, W]: expected depth, median depth, 0 where nothing contributes
+                const int pixel_idx = width * pixel_coords.y + pixel_coords.x;
+                const float accumulated_alpha = 1.0f - transmittance;
+                depth_map[pixel_idx] = accumulated_alpha > 0.0f ? depth_pixel / accumulated_alpha : 0.0f;
+                depth_map[pixel_idx + width * height] = median_depth;
+            }
+        }
+
+        store_tile_results<Tile, RENDER_ONLY>(
+            block, tile_idx, pixel_coords, inside, color_pixel, transmittance, n_contributions,
+            image, alpha_map, tile_max_n_contributions, tile_n_contributions, width, height);
+    }
+
+    // Load-balanced blending: a tile with more than blend_split_threshold instances would keep one block
+    // busy long after all others finished, so it is cut into segments of blend_segment_size instances
+    // that are blended by independent blocks and composited front-to-back afterwards.
+    __global__ void collect_heavy_tiles_cu(
+        const uint2* tile_instance_ranges,
+        uint2* heavy_tiles,
+        uint* n_heavy_tiles,
+        uint2* segments,
+        uint* n_segments,
+        const uint n_tiles,
+        const uint max_heavy_tiles,
+        const uint max_segments) {
+        const uint tile_idx = cg::this_grid().thread_rank();
+        if (tile_idx >= n_tiles)
+            return;
+        const uint2 tile_range = tile_instance_ranges[tile_idx];
+        const uint n_points_total = tile_range.y - tile_range.x;
+        if (n_points_total <= config::blend_split_threshold)
+            return;
+        const uint n_tile_segments = div_round_up(n_points_total, static_cast<uint>(config::blend_segment_size));
+        const uint heavy_idx = atomicAdd(n_heavy_tiles, 1);
+        const uint segment_offset = atomicAdd(n_segments, n_tile_segments);
+        // capacities are exact upper bounds, the check only guards against inconsistent ranges
+        if (heavy_idx >= max_heavy_tiles || segment_offset + n_tile_segments > max_segments)
+            return;
+        heavy_tiles[heavy_idx] = make_uint2(tile_idx, segment_offset);
+        for (uint segment_idx = 0; segment_idx < n_tile_segments; ++segment_idx)
+            segments[segment_offset + segment_idx] = make_uint2(tile_idx, segment_idx);
+    }
+
+    // One block per segment, results of the segment as if it was the whole tile
+    template <typename Tile>
+    __global__ void __launch_bounds__(Tile::n_pixels) blend_segment_cu(
+        const uint2* segments,
+        const uint* n_segments,
+        const uint2* tile_instance_ranges,
+        const uint* tile_bucket_offsets,
+        const uint* instance_primitive_indices,
+        const float2* primitive_mean2d,
+        const float4* primitive_conic_opacity,
+        const float3* primitive_color,
+        uint* bucket_tile_index,
+        float4* bucket_color_transmittance,
+        float4* segment_color_transmittance,
+        uint* segment_n_contributions,
+        const uint width,
+        const uint height,
+        const uint grid_width,
+        const uint max_segments) {
+        auto block = cg::this_thread_block();
+        const uint segment_slot = block.group_index().x;
+        if (segment_slot >= min(*n_segments, max_segments))
+            return;
+        const dim3 thread_index = block.thread_index();
+        const uint thread_rank = block.thread_rank();
+        const uint2 segment = segments[segment_slot];
+        const uint tile_idx = segment.x;
+        const uint2 pixel_coords = make_uint2((tile_idx % grid_width) * Tile::width + thread_index.x, (tile_idx / grid_width) * Tile::height + thread_index.y);
+        const bool inside = pixel_coords.x < width && pixel_coords.y < height;
+        const float2 pixel = make_float2(__uint2float_rn(pixel_coords.x), __uint2float_rn(pixel_coords.y)) + 0.5f;
+
+        const uint2 tile_range = tile_instance_ranges[tile_idx];
+        const uint segment_start = segment.y * config::blend_segment_size;
+        const uint range_start = tile_range.x + segment_start;
+        const uint range_end = min(range_start + config::blend_segment_size, tile_range.y);
+        // segments are bucket-aligned, so each segment owns a contiguous run of the tile's buckets
+        const uint bucket_offset = (tile_idx == 0 ? 0 : tile_bucket_offsets[tile_idx - 1]) + segment_start / 32;
+        const int n_buckets = div_round_up(range_end - range_start, 32u);
+        for (int current_bucket_idx = thread_rank; current_bucket_idx < n_buckets; current_bucket_idx += Tile::n_pixels)
+            bucket_tile_index[bucket_offset + current_bucket_idx] = tile_idx;
+
+        float3 color_pixel;
+        float transmittance;
+        uint n_contributions;
+        float depth_pixel;
+        float median_depth;
+        bool done = !inside;
+        blend_instance_range<Tile, false>(
+            block, range_start, range_end, bucket_offset, 0, bucket_color_transmittance != nullptr ? ~0u : 0u,
+            instance_primitive_indices, primitive_mean2d, primitive_conic_opacity, primitive_color, nullptr,
+            bucket_color_transmittance, pixel, done, color_pixel, transmittance, n_contributions, depth_pixel, median_depth);
+
+        // the high bit marks pixels that saturated inside this segment
+        const uint result_idx = segment_slot * Tile::n_pixels + thread_rank;
+        segment_color_transmittance[result_idx] = make_float4(color_pixel, transmittance);
+        segment_n_contributions[result_idx] = n_contributions | (done && inside ? 0x80000000u : 0u);
+    }
+
+    // One block per heavy tile: composites its segments front-to-back and rebases the bucket states of
+    // every segment onto the color and transmittance in front of it, so the backward sees whole-tile
+    // states. A pixel stops at the first segment it saturated in, keeping its contributions a prefix.
+    template <typename Tile>
+    __global__ void __launch_bounds__(Tile::n_pixels) blend_merge_cu(
+        const uint2* heavy_tiles,
+        const uint* n_heavy_tiles,
+        const uint2* tile_instance_ranges,
+        const uint* tile_bucket_offsets,
+        const float4* segment_color_transmittance,
+        const uint* segment_n_contributions,
+        float* image,
+        float* alpha_map,
+        uint* tile_max_n_contributions,
+        uint* tile_n_contributions,
+        float4* bucket_color_transmittance,
+        const uint width,
+        const uint height,
+        const uint grid_width,
+        const uint max_heavy_tiles) {
+        auto block = cg::this_thread_block();
+        if (block.group_index().x >= min(*n_heavy_tiles, max_heavy_tiles))
+            return;
+        const dim3 thread_index = block.thread_index();
+        const uint thread_rank = block.thread_rank();
+        const uint2 heavy_tile = heavy_tiles[block.group_index().x];
+        const uint tile_idx = heavy_tile.x;
+        const uint2 pixel_coords = make_uint2((tile_idx % grid_width) * Tile::width + thread_index.x, (tile_idx / grid_width) * Tile::height + thread_index.y);
+        const bool inside = pixel_coords.x < width && pixel_coords.y < height;
+
+        const uint2 tile_range = tile_instance_ranges[tile_idx];
+        const uint n_points_total = tile_range.y - tile_range.x;
+        const uint n_tile_segments = div_round_up(n_points_total, static_cast<uint>(config::blend_segment_size));
+        const uint tile_bucket_offset = tile_idx == 0 ? 0 : tile_bucket_offsets[tile_idx - 1];
+
+        float3 color_pixel = make_float3(0.0f);
+        float transmittance = 1.0f;
+        uint n_contributions = 0;
+        bool done = !inside;
+        for (uint segment_idx = 0; !done && segment_idx < n_tile_segments; ++segment_idx) {
+            const uint segment_start = segment_idx * config::blend_segment_size;
+            if (segment_idx > 0 && bucket_color_transmittance != nullptr) {
+                const uint n_segment_buckets = div_round_up(min(n_points_total - segment_start, static_cast<uint>(config::blend_segment_size)), 32u);
+                float4* segment_buckets = bucket_color_transmittance + (tile_bucket_offset + segment_start / 32) * Tile::n_pixels + thread_rank;
+                for (uint bucket_idx = 0; bucket_idx < n_segment_buckets; ++bucket_idx) {
+                    const float4 local = segment_buckets[bucket_idx * Tile::n_pixels];
+                    segment_buckets[bucket_idx * Tile::n_pixels] = make_float4(color_pixel + transmittance * make_float3(local), transmittance * local.w);
+                }
+            }
+            const uint result_idx = (heavy_tile.y + segment_idx) * Tile::n_pixels + thread_rank;
+            const float4 segment_result = segment_color_transmittance[result_idx];
+            const uint segment_contributions = segment_n_contributions[result_idx];
+            if ((segment_contributions & 0x7fffffffu) > 0)
+                n_contributions = segment_start + (segment_contributions & 0x7fffffffu);
+            color_pixel += transmittance * make_float3(segment_result);
+            transmittance *= segment_result.w;
+            done = (segment_contributions & 0x80000000u) != 0;
+        }
+
+        store_tile_results<Tile>(
+            block, tile_idx, pixel_coords, inside, color_pixel, transmittance, n_contributions,
+            image, alpha_map, tile_max_n_contributions, tile_n_contributions, width, height);
+    }
+
+    // Bucket states of the buckets [bucket_begin, bucket_end) for a backward whose forward kept none,
+    // bucket_begin is the first state of the buffer. Each tile overlapping the window blends again from
+    // its first instance up to the end of the window, so the states match a forward that stored them.
+    template <typename Tile>
+    __global__ void __launch_bounds__(Tile::n_pixels) replay_bucket_states_cu(
+        const uint2* tile_instance_ranges,
+        const uint* tile_bucket_offsets,
+        const uint* instance_primitive_indices,
+        const float2* primitive_mean2d,
+        const float4* primitive_conic_opacity,
+        const float3* primitive_color,
+        float4* bucket_color_transmittance,
+        const uint bucket_begin,
+        const uint bucket_end,
+        const uint width,
+        const uint height,
+        const uint grid_width) {
+        auto block = cg::this_thread_block();
+        const dim3 group_index = block.group_index();
+        const dim3 thread_index = block.thread_index();
+        const uint2 pixel_coords = make_uint2(group_index.x * Tile::width + thread_index.x, group_index.y * Tile::height + thread_index.y);
+        const bool inside = pixel_coords.x < width && pixel_coords.y < height;
+        const float2 pixel = make_float2(__uint2float_rn(pixel_coords.x), __uint2float_rn(pixel_coords.y)) + 0.5f;
+
+        const uint tile_idx = group_index.y * grid_width + group_index.x;
+        const uint2 tile_range = tile_instance_ranges[tile_idx];
+        const uint tile_bucket_offset = tile_idx == 0 ? 0 : tile_bucket_offsets[tile_idx - 1];
+        const uint n_tile_buckets = div_round_up(tile_range.y - tile_range.x, 32u);
+        if (tile_bucket_offset + n_tile_buckets <= bucket_begin || tile_bucket_offset >= bucket_end)
+            return;
+        // instances behind the window don't change any state in it
+        const uint range_end = min(tile_range.y, tile_range.x + (bucket_end - tile_bucket_offset) * 32);
+
+        float3 color_pixel;
+        float transmittance;
+        uint n_contributions;
+        float depth_pixel;
+        float median_depth;
+        bool done = !inside;
+        blend_instance_range<Tile, false>(
+            block, tile_range.x, range_end, tile_bucket_offset, bucket_begin, bucket_end,
+            instance_primitive_indices, primitive_mean2d, primitive_conic_opacity, primitive_color, nullptr,
+            bucket_color_transmittance, pixel, done, color_pixel, transmittance, n_contributions, depth_pixel, median_depth);
+    }
+
 } // namespace fast_gs::rasterization::kernels::forward
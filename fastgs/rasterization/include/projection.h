@@ -0,0 +1,35 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <stdexcept>
+#include <type_traits>
+
+namespace fast_gs::rasterization {
+
+    // Camera projections the preprocess compiles. Orthographic maps camera space x, y to pixels as
+    // fx * x + cx and fy * y + cy, like CameraModelType::ORTHO in gsplat, depth only orders.
+    enum class Projection : int {
+        Pinhole = 0,
+        Orthographic = 1
+    };
+
+    // Calls f with std::integral_constant<Projection, projection>, one instantiation of the
+    // preprocess kernels per projection
+    template <typename F>
+    void dispatch_projection(const Projection projection, F&& f) {
+        switch (projection) {
+        case Projection::Pinhole:
+            f(std::integral_constant<Projection, Projection::Pinhole>{});
+            break;
+        case Projection::Orthographic:
+            f(std::integral_constant<Projection, Projection::Orthographic>{});
+            break;
+        default:
+            throw std::runtime_error("unknown projection");
+        }
+    }
+
+} // namespace fast_gs::rasterization
@@ -4,11 +4,15 @@
 
 #pragma once
 
+#include "projection.h"
+#include "tile_config.h"
 #include <torch/torch.h>
 #include <tuple>
 
 namespace fast_gs::rasterization {
 
+    struct RasterizerContext;
+
     struct FastGSSettings {
         torch::Tensor cam_position;
         int active_sh_bases;
@@ -20,9 +24,17 @@ namespace fast_gs::rasterization {
         float center_y;
         float near_plane;
         float far_plane;
+        Projection projection = Projection::Pinhole;
+        RasterizerContext* context = nullptr; // nullptr: the calling thread's default context
+        torch::Tensor pixel_mask;             // [1, H, W] float, tiles without a nonzero pixel are skipped
     };
 
-    std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, int, int, int, int, int>
+    // image, alpha, depth ([2, H, W] with RasterizerContext::render_depth, else empty), the four
+    // buffer views for backward, n_visible_primitives, n_instances, n_buckets, the two selectors and
+    // the bucket replay chunk (0 unless the bucket states exceeded RasterizerContext::bucket_state_budget).
+    // Tiles a defined pixel_mask [1, H, W] has no nonzero pixel in are neither blended nor part of
+    // the backward, their image and alpha pixels are zero.
+    std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, int, int, int, int, int, int>
     forward_wrapper(
         const torch::Tensor& means,
         const torch::Tensor& scales_raw,
@@ -40,11 +52,55 @@ namespace fast_gs::rasterization {
         const float center_x,
         const float center_y,
         const float near_plane,
-        const float far_plane);
+        const float far_plane,
+        const Projection projection,
+        RasterizerContext* context = nullptr,
+        const torch::Tensor& pixel_mask = {});
+
+    // [n_primitives] bool, primitives the forward that filled per_primitive_buffers rendered into any tile
+    torch::Tensor visibility_mask(
+        const torch::Tensor& per_primitive_buffers,
+        const int n_primitives);
+
+    // Workload of the forward_wrapper call that returned per_tile_buffers, blended with tile_shape (the
+    // context's at that call): instances sorted into each tile and the largest contributor count of each
+    // tile, both [tiles_y, tiles_x], and per pixel the instances it walked up to its last contribution
+    // [H, W], all int32. The views are only valid until the next forward on the context, these are copies.
+    std::tuple<torch::Tensor, torch::Tensor, torch::Tensor> tile_workload(
+        const torch::Tensor& per_tile_buffers,
+        const int width,
+        const int height,
+        const TileShape tile_shape);
+
+    // Forward without any backward state: no contribution counts, no buckets. Returns image, alpha and
+    // depth like forward_wrapper. Reuses the context's buffers, so it must not run between a forward
+    // and its backward on the same context.
+    std::tuple<torch::Tensor, torch::Tensor, torch::Tensor>
+    render_wrapper(
+        const torch::Tensor& means,
+        const torch::Tensor& scales_raw,
+        const torch::Tensor& rotations_raw,
+        const torch::Tensor& opacities_raw,
+        const torch::Tensor& sh_coefficients_0,
+        const torch::Tensor& sh_coefficients_rest,
+        const torch::Tensor& w2c,
+        const torch::Tensor& cam_position,
+        const int active_sh_bases,
+        const int width,
+        const int height,
+        const float focal_x,
+        const float focal_y,
+        const float center_x,
+        const float center_y,
+        const float near_plane,
+        const float far_plane,
+        const Projection projection,
+        RasterizerContext* context = nullptr);
 
     std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>
     backward_wrapper(
-        torch::Tensor& densification_info,
+        torch::Tensor& densification_info, // [N, 2] half (visible count, gradient sum) or empty
+        torch::Tensor& max_contribution,   // [N] float largest blending weight, -1 until rasterized, or empty
         const torch::Tensor& grad_image,
         const torch::Tensor& grad_alpha,
         const torch::Tensor& image,
@@ -68,10 +124,13 @@ namespace fast_gs::rasterization {
         const float center_y,
         const float near_plane,
         const float far_plane,
+        const Projection projection,
         const int n_visible_primitives,
         const int n_instances,
         const int n_buckets,
         const int primitive_primitive_indices_selector,
-        const int instance_primitive_indices_selector);
+        const int instance_primitive_indices_selector,
+        const TileShape tile_shape,
+        const int bucket_replay_chunk = 0);
 
 } // namespace fast_gs::rasterization
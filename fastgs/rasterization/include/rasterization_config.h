@@ -23,10 +23,18 @@ namespace fast_gs::rasterization::config {
     DEF int block_size_create_instances = 256;
     DEF int block_size_extract_instance_ranges = 256;
     DEF int block_size_extract_bucket_counts = 256;
-    DEF int tile_width = 16;
-    DEF int tile_height = 16;
-    DEF int block_size_blend = tile_width * tile_height;
+    // blend block size is the tile size, see tile_config.h
     DEF int n_sequential_threshold = 4;
+    // load-balanced blending: tiles above the threshold are split into segments, a multiple of the bucket size
+    DEF int blend_split_threshold = 4096;
+    DEF int blend_segment_size = 2048;
+    static_assert(blend_segment_size % 32 == 0, "blend segments must start at a bucket boundary");
+    // spatial index: screen-space slack of the chunk frustum test, covers the 2d dilation
+    DEF float chunk_culling_padding = 2.0f;
+    // depth sort: keys are quantized to at most this many bits over [near, far], fewer radix passes
+    DEF int depth_key_bits = 24;
+    // upper-bound allocation: instance capacity relative to the previous forward's instance count
+    DEF float instance_capacity_headroom = 1.25f;
 } // namespace fast_gs::rasterization::config
 
 namespace config = fast_gs::rasterization::config;
@@ -0,0 +1,116 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "tile_config.h"
+#include <ATen/core/Tensor.h>
+#include <cstddef>
+#include <cuda_runtime.h>
+
+namespace fast_gs::rasterization {
+
+    // Primitives per chunk of the spatial index, one preprocess block each
+    inline constexpr int spatial_index_chunk_size = 128;
+
+    // Instance counts summed over the forwards of a context with collect_instance_stats
+    struct InstanceStats {
+        unsigned long long bounding_instances = 0; // tiles overlapped by the screen-space bounding rectangles
+        unsigned long long instances = 0;          // tiles passing the exact ellipse-tile test, i.e. actual instances
+        unsigned long long buckets = 0;            // 32-instance blend buckets the backward replays, 0 for render-only forwards
+        unsigned long long frames = 0;
+    };
+
+    // Grow-only device allocation handed out again on every call, so steady-state rendering
+    // causes no allocator traffic. The block comes from the caching allocator on the current
+    // stream: growing drops the arena's reference without a device sync, the old block is reused
+    // in stream order and stays alive as long as views of it saved for backward do.
+    struct BufferArena {
+        at::Tensor block;      // uint8
+        char* data = nullptr;  // start of block
+        size_t capacity = 0;   // bytes allocated
+        size_t high_water = 0; // largest request seen
+
+        char* reserve(size_t bytes);
+        void release();
+    };
+
+    // Execution state of one rasterizer user (training, evaluation, viewer). All work is queued on
+    // the stream passed to forward/backward, the context only owns the helpers around it, so
+    // independent contexts on independent streams never serialize through shared state.
+    struct RasterizerContext {
+        // Side stream clearing the tile instance ranges while preprocess and the sorts run.
+        // memset_ready orders it after the caller stream, memset_done orders the caller after it.
+        cudaStream_t memset_stream = nullptr;
+        cudaEvent_t memset_ready = nullptr;
+        cudaEvent_t memset_done = nullptr;
+
+        // Upper-bound allocation: counts of the last forward land in pinned memory without
+        // blocking the host, the next forward reads them to size its instance buffer. The exact
+        // instance count of the current forward follows preprocess into counts_host[3]; the host
+        // checks it while the depth sort runs and grows the capacity before any instance is written.
+        bool upper_bound_allocation = false;
+        unsigned int* counts_host = nullptr; // n_visible_primitives, n_instances, n_buckets, instances of the current forward
+        cudaEvent_t counts_ready = nullptr;
+        cudaEvent_t instances_ready = nullptr;
+        bool counts_pending = false;
+        int instance_capacity = 0;
+        int instance_overflows = 0; // forwards whose capacity from the previous counts was too small
+
+        // Blend tile shape of the next forward, chosen by the caller (e.g. the autotuner).
+        // Resolutions with too many tiles for it fall back to the default shape.
+        TileShape tile_shape = default_tile_shape;
+
+        // Optional spatial index of the next forward: all primitive indices in morton order, split into
+        // chunks of spatial_index_chunk_size with a world-space box (min, max) bounding each chunk's
+        // gaussians. Preprocess skips chunks outside the frustum. The caller owns the memory and has to
+        // rebuild it when the primitives change, an index over a different primitive count is ignored.
+        const unsigned int* chunk_primitive_indices = nullptr;
+        const float3* chunk_bounds = nullptr;
+        int n_indexed_primitives = 0;
+
+        // Blend tiles with many instances in segments on several blocks and composite them afterwards,
+        // so a few crowded tiles do not serialize the end of the blend pass
+        bool load_balanced_blend = false;
+
+        // Bytes of bucket states a forward may keep for its backward, 0: no limit. A forward needing more
+        // keeps none and its backward replays the blend in chunks of this size instead, trading a second
+        // blend pass for the largest buffer at extreme resolutions.
+        size_t bucket_state_budget = 0;
+
+        // Expected and median depth next to image and alpha, the blend only pays for them when set
+        bool render_depth = false;
+
+        // Instance statistics: each forward queues a copy of its counters, the next one adds them up
+        bool collect_instance_stats = false;
+        unsigned int* stats_host = nullptr; // n_instances, n_bounding_instances, n_buckets
+        cudaEvent_t stats_ready = nullptr;
+        bool stats_pending = false;
+        InstanceStats stats_totals;
+
+        // Backing memory of the per-call buffers. A forward's buffers stay valid until the next
+        // forward on the same context, so each forward must be followed by its backward first.
+        BufferArena per_primitive_buffers;
+        BufferArena per_tile_buffers;
+        BufferArena per_instance_buffers;
+        BufferArena per_bucket_buffers;
+        BufferArena per_segment_buffers; // forward only, load_balanced_blend
+
+        explicit RasterizerContext(bool upper_bound_allocation = false);
+        ~RasterizerContext();
+
+        RasterizerContext(const RasterizerContext&) = delete;
+        RasterizerContext& operator=(const RasterizerContext&) = delete;
+
+        size_t reserved_bytes() const;
+        // Sum of the largest request of each buffer, the VRAM the rasterizer actually needed
+        size_t high_water_bytes() const;
+        // Totals including the most recent forward, waits for it to finish
+        InstanceStats instance_stats();
+    };
+
+    // Fallback for callers without a context of their own, one per host thread
+    RasterizerContext& default_context();
+
+} // namespace fast_gs::rasterization
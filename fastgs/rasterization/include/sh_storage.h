@@ -0,0 +1,78 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "helper_math.h"
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
+#include <stdexcept>
+#include <type_traits>
+
+namespace fast_gs::rasterization {
+
+    // Storage type of the higher-order sh coefficients, evaluation is always fp32
+    enum class SHPrecision {
+        Float32,
+        Float16,
+        BFloat16
+    };
+
+    namespace kernels {
+
+        __device__ __forceinline__ float sh_to_float(const float value) { return value; }
+        __device__ __forceinline__ float sh_to_float(const __half value) { return __half2float(value); }
+        __device__ __forceinline__ float sh_to_float(const __nv_bfloat16 value) { return __bfloat162float(value); }
+
+        // [n_bases, 3] coefficients of one primitive, widened to float3 on load
+        template <typename T>
+        struct SHCoefficientsView {
+            const T* ptr;
+
+            __device__ __forceinline__ float3 operator[](const uint basis) const {
+                const T* coefficient = ptr + 3 * basis;
+                return make_float3(sh_to_float(coefficient[0]), sh_to_float(coefficient[1]), sh_to_float(coefficient[2]));
+            }
+        };
+
+    } // namespace kernels
+
+    // Calls f with sh_coefficients_rest cast to its storage type
+    template <typename F>
+    void dispatch_sh_precision(const SHPrecision precision, const void* sh_coefficients_rest, F&& f) {
+        switch (precision) {
+        case SHPrecision::Float16:
+            f(static_cast<const __half*>(sh_coefficients_rest));
+            break;
+        case SHPrecision::BFloat16:
+            f(static_cast<const __nv_bfloat16*>(sh_coefficients_rest));
+            break;
+        default:
+            f(static_cast<const float*>(sh_coefficients_rest));
+            break;
+        }
+    }
+
+    // Calls f with std::integral_constant<uint, active_sh_bases>, one instantiation per sh degree 0-3
+    template <typename F>
+    void dispatch_active_sh_bases(const int active_sh_bases, F&& f) {
+        switch (active_sh_bases) {
+        case 1:
+            f(std::integral_constant<uint, 1>{});
+            break;
+        case 4:
+            f(std::integral_constant<uint, 4>{});
+            break;
+        case 9:
+            f(std::integral_constant<uint, 9>{});
+            break;
+        case 16:
+            f(std::integral_constant<uint, 16>{});
+            break;
+        default:
+            throw std::runtime_error("active_sh_bases must be 1, 4, 9 or 16");
+        }
+    }
+
+} // namespace fast_gs::rasterization
@@ -0,0 +1,106 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <stdexcept>
+#include <string_view>
+
+namespace fast_gs::rasterization {
+
+    // Compiled blend tile shapes. The best shape depends on the GPU and the resolution, see the
+    // tile shape autotuner in the trainer. Tile keys are 16 bit, so a shape is only usable while
+    // the image has fewer than 0xffff tiles (the maximum key marks unused instance slots).
+    enum class TileShape : int {
+        Tile16x16 = 0,
+        Tile8x8 = 1,
+        Tile32x8 = 2
+    };
+
+    inline constexpr TileShape default_tile_shape = TileShape::Tile16x16;
+    inline constexpr TileShape all_tile_shapes[] = {TileShape::Tile16x16, TileShape::Tile8x8, TileShape::Tile32x8};
+
+    template <int WIDTH, int HEIGHT>
+    struct TileConfig {
+        static constexpr int width = WIDTH;
+        static constexpr int height = HEIGHT;
+        static constexpr int n_pixels = WIDTH * HEIGHT;
+        // blend_backward_cu walks a tile 32 pixels at a time
+        static_assert(n_pixels % 32 == 0, "tile must hold a multiple of 32 pixels");
+    };
+
+    constexpr int tile_width_of(const TileShape shape) {
+        switch (shape) {
+        case TileShape::Tile8x8:
+            return 8;
+        case TileShape::Tile32x8:
+            return 32;
+        default:
+            return 16;
+        }
+    }
+
+    constexpr int tile_height_of(const TileShape shape) {
+        switch (shape) {
+        case TileShape::Tile8x8:
+            return 8;
+        case TileShape::Tile32x8:
+            return 8;
+        default:
+            return 16;
+        }
+    }
+
+    constexpr const char* tile_shape_name(const TileShape shape) {
+        switch (shape) {
+        case TileShape::Tile8x8:
+            return "8x8";
+        case TileShape::Tile32x8:
+            return "32x8";
+        default:
+            return "16x16";
+        }
+    }
+
+    inline bool tile_shape_from_name(const std::string_view name, TileShape& shape) {
+        for (const TileShape candidate : all_tile_shapes) {
+            if (name == tile_shape_name(candidate)) {
+                shape = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    constexpr bool tile_shape_fits(const TileShape shape, const int width, const int height) {
+        const long long grid_width = (width + tile_width_of(shape) - 1) / tile_width_of(shape);
+        const long long grid_height = (height + tile_height_of(shape) - 1) / tile_height_of(shape);
+        return grid_width * grid_height < 0xffff;
+    }
+
+    // Shape forward and backward actually use: a shape with too many tiles for the resolution falls
+    // back to the default, so mixed-resolution datasets keep working with a tuned small tile
+    constexpr TileShape resolve_tile_shape(const TileShape shape, const int width, const int height) {
+        return tile_shape_fits(shape, width, height) ? shape : default_tile_shape;
+    }
+
+    // Calls f with the TileConfig of shape, one instantiation of the blend kernels per shape
+    template <typename F>
+    void dispatch_tile_shape(const TileShape shape, F&& f) {
+        switch (shape) {
+        case TileShape::Tile16x16:
+            f(TileConfig<16, 16>{});
+            break;
+        case TileShape::Tile8x8:
+            f(TileConfig<8, 8>{});
+            break;
+        case TileShape::Tile32x8:
+            f(TileConfig<32, 8>{});
+            break;
+        default:
+            throw std::runtime_error("unknown tile shape");
+        }
+    }
+
+} // namespace fast_gs::rasterization
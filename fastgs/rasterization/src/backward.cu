@@ -6,12 +6,16 @@
 #include "buffer_utils.h"
 #include "helper_math.h"
 #include "kernels_backward.cuh"
+#include "kernels_forward.cuh"
 #include "rasterization_config.h"
+#include "tile_config.h"
 #include "utils.h"
+#include <algorithm>
 #include <cub/cub.cuh>
 #include <functional>
 
 void fast_gs::rasterization::backward(
+    cudaStream_t stream,
     const float* grad_image,
     const float* grad_alpha,
     const float* image,
@@ -19,7 +23,8 @@ void fast_gs::rasterization::backward(
     const float3* means,
     const float3* scales_raw,
     const float4* rotations_raw,
-    const float3* sh_coefficients_rest,
+    const void* sh_coefficients_rest,
+    const SHPrecision sh_precision,
     const float4* w2c,
     const float3* cam_position,
     char* per_primitive_buffers_blob,
@@ -35,7 +40,8 @@ void fast_gs::rasterization::backward(
     float2* grad_mean2d_helper,
     float* grad_conic_helper,
     float4* grad_w2c,
-    float* densification_info,
+    __half2* densification_info,
+    float* max_contribution,
     const int n_primitives,
     const int n_visible_primitives,
     const int n_instances,
@@ -49,68 +55,115 @@ void fast_gs::rasterization::backward(
     const float fx,
     const float fy,
     const float cx,
-    const float cy) {
-    const dim3 grid(div_round_up(width, config::tile_width), div_round_up(height, config::tile_height), 1);
+    const float cy,
+    const Projection projection,
+    const TileShape forward_tile_shape,
+    const int bucket_replay_chunk,
+    float4* bucket_replay_states) {
+    // must match the forward that filled the buffers
+    const TileShape tile_shape = resolve_tile_shape(forward_tile_shape, width, height);
+    const int n_tile_pixels = tile_width_of(tile_shape) * tile_height_of(tile_shape);
+    const dim3 block(tile_width_of(tile_shape), tile_height_of(tile_shape), 1);
+    const dim3 grid(div_round_up(width, tile_width_of(tile_shape)), div_round_up(height, tile_height_of(tile_shape)), 1);
     const int n_tiles = grid.x * grid.y;
 
     PerPrimitiveBuffers per_primitive_buffers = PerPrimitiveBuffers::from_blob(per_primitive_buffers_blob, n_primitives);
-    PerTileBuffers per_tile_buffers = PerTileBuffers::from_blob(per_tile_buffers_blob, n_tiles);
+    PerTileBuffers per_tile_buffers = PerTileBuffers::from_blob(per_tile_buffers_blob, n_tiles, n_tile_pixels);
     PerInstanceBuffers per_instance_buffers = PerInstanceBuffers::from_blob(per_instance_buffers_blob, n_instances);
-    PerBucketBuffers per_bucket_buffers = PerBucketBuffers::from_blob(per_bucket_buffers_blob, n_buckets);
+    PerBucketBuffers per_bucket_buffers = PerBucketBuffers::from_blob(per_bucket_buffers_blob, n_buckets, bucket_replay_chunk > 0 ? 0 : n_tile_pixels);
     per_primitive_buffers.primitive_indices.selector = primitive_primitive_indices_selector;
     per_instance_buffers.primitive_indices.selector = instance_primitive_indices_selector;
 
-    kernels::backward::blend_backward_cu<<<n_buckets, 32>>>(
-        per_tile_buffers.instance_ranges,
-        per_tile_buffers.bucket_offsets,
-        per_instance_buffers.primitive_indices.Current(),
-        per_primitive_buffers.mean2d,
-        per_primitive_buffers.conic_opacity,
-        per_primitive_buffers.color,
-        grad_image,
-        grad_alpha,
-        image,
-        alpha,
-        per_tile_buffers.max_n_contributions,
-        per_tile_buffers.n_contributions,
-        per_bucket_buffers.tile_index,
-        per_bucket_buffers.color_transmittance,
-        grad_mean2d_helper,
-        grad_conic_helper,
-        grad_opacities_raw,
-        grad_sh_coefficients_0, // used to store intermediate gradients
-        n_buckets,
-        n_primitives,
-        width,
-        height,
-        grid.x);
-    CHECK_CUDA(config::debug, "blend_backward")
+    dispatch_tile_shape(tile_shape, [&](auto tile) {
+        using Tile = decltype(tile);
+        const auto blend_backward = [&](const int bucket_begin, const int bucket_end, const float4* bucket_color_transmittance) {
+            kernels::backward::blend_backward_cu<Tile><<<bucket_end - bucket_begin, 32, 0, stream>>>(
+                per_tile_buffers.instance_ranges,
+                per_tile_buffers.bucket_offsets,
+                per_instance_buffers.primitive_indices.Current(),
+                per_primitive_buffers.mean2d,
+                per_primitive_buffers.conic_opacity,
+                per_primitive_buffers.color,
+                grad_image,
+                grad_alpha,
+                image,
+                alpha,
+                per_tile_buffers.max_n_contributions,
+                per_tile_buffers.n_contributions,
+                per_bucket_buffers.tile_index,
+                bucket_color_transmittance,
+                per_primitive_buffers.n_touched_tiles,
+                grad_mean2d_helper,
+                grad_conic_helper,
+                grad_opacities_raw,
+                grad_sh_coefficients_0, // used to store intermediate gradients
+                max_contribution,
+                per_tile_buffers.bucket_offsets + n_tiles - 1,
+                bucket_begin,
+                bucket_end,
+                n_primitives,
+                width,
+                height,
+                grid.x);
+            CHECK_CUDA(config::debug, "blend_backward")
+        };
 
-    kernels::backward::preprocess_backward_cu<<<div_round_up(n_primitives, config::block_size_preprocess_backward), config::block_size_preprocess_backward>>>(
-        means,
-        scales_raw,
-        rotations_raw,
-        sh_coefficients_rest,
-        w2c,
-        cam_position,
-        per_primitive_buffers.n_touched_tiles,
-        grad_mean2d_helper,
-        grad_conic_helper,
-        grad_means,
-        grad_scales_raw,
-        grad_rotations_raw,
-        grad_sh_coefficients_0,
-        grad_sh_coefficients_rest,
-        grad_w2c,
-        densification_info,
-        n_primitives,
-        active_sh_bases,
-        total_bases_sh_rest,
-        static_cast<float>(width),
-        static_cast<float>(height),
-        fx,
-        fy,
-        cx,
-        cy);
+        if (bucket_replay_chunk == 0) {
+            if (n_buckets > 0)
+                blend_backward(0, n_buckets, per_bucket_buffers.color_transmittance);
+            return;
+        }
+        // the forward kept no states, each chunk of buckets gets them replayed right before its backward
+        for (int bucket_begin = 0; bucket_begin < n_buckets; bucket_begin += bucket_replay_chunk) {
+            const int bucket_end = std::min(bucket_begin + bucket_replay_chunk, n_buckets);
+            kernels::forward::replay_bucket_states_cu<Tile><<<grid, block, 0, stream>>>(
+                per_tile_buffers.instance_ranges,
+                per_tile_buffers.bucket_offsets,
+                per_instance_buffers.primitive_indices.Current(),
+                per_primitive_buffers.mean2d,
+                per_primitive_buffers.conic_opacity,
+                per_primitive_buffers.color,
+                bucket_replay_states,
+                bucket_begin,
+                bucket_end,
+                width,
+                height,
+                grid.x);
+            CHECK_CUDA(config::debug, "replay_bucket_states")
+            blend_backward(bucket_begin, bucket_end, bucket_replay_states);
+        }
+    });
+
+    dispatch_sh_precision(sh_precision, sh_coefficients_rest, [&](const auto* sh_rest) {
+        dispatch_active_sh_bases(active_sh_bases, [&](auto bases) {
+            dispatch_projection(projection, [&](auto projection_type) {
+                kernels::backward::preprocess_backward_cu<decltype(bases)::value, decltype(projection_type)::value><<<div_round_up(n_primitives, config::block_size_preprocess_backward), config::block_size_preprocess_backward, 0, stream>>>(
+                    means,
+                    scales_raw,
+                    rotations_raw,
+                    sh_rest,
+                    w2c,
+                    cam_position,
+                    per_primitive_buffers.n_touched_tiles,
+                    grad_mean2d_helper,
+                    grad_conic_helper,
+                    grad_means,
+                    grad_scales_raw,
+                    grad_rotations_raw,
+                    grad_sh_coefficients_0,
+                    grad_sh_coefficients_rest,
+                    grad_w2c,
+                    densification_info,
+                    n_primitives,
+                    total_bases_sh_rest,
+                    static_cast<float>(width),
+                    static_cast<float>(height),
+                    fx,
+                    fy,
+                    cx,
+                    cy);
+            });
+        });
+    });
     CHECK_CUDA(config::debug, "preprocess_backward")
 }
@@ -7,12 +7,41 @@
 #include "helper_math.h"
 #include "kernels_forward.cuh"
 #include "rasterization_config.h"
+#include "rasterizer_context.h"
+#include "tile_config.h"
 #include "utils.h"
+#include <algorithm>
+#include <bit>
 #include <cub/cub.cuh>
 #include <functional>
 
+static_assert(fast_gs::rasterization::spatial_index_chunk_size == config::block_size_preprocess,
+              "a spatial index chunk must map to one preprocess block");
+
+namespace {
+
+    int instance_capacity_for(const uint n_instances) {
+        return std::max(1, static_cast<int>(static_cast<float>(n_instances) * config::instance_capacity_headroom));
+    }
+
+    // Bit range [0, end_bit) the depth sort has to look at and the right shift quantizing the keys into it
+    std::pair<int, int> depth_key_layout(const float near_, const float far_) {
+        const int range_bits = std::bit_width(std::bit_cast<uint>(far_) - std::bit_cast<uint>(near_));
+        const int shift = std::max(0, range_bits - config::depth_key_bits);
+        return {range_bits - shift, shift};
+    }
+
+    // Bits of the largest tile key, unused instance slots (0xffff) still sort behind every tile
+    int tile_key_bits(const int n_tiles) {
+        return std::bit_width(static_cast<uint>(n_tiles));
+    }
+
+} // namespace
+
 // sorting is done separately for depth and tile as proposed in https://github.com/m-schuetz/Splatshop
-std::tuple<int, int, int, int, int> fast_gs::rasterization::forward(
+std::tuple<int, int, int, int, int, int> fast_gs::rasterization::forward(
+    RasterizerContext& context,
+    cudaStream_t stream,
     std::function<char*(size_t)> per_primitive_buffers_func,
     std::function<char*(size_t)> per_tile_buffers_func,
     std::function<char*(size_t)> per_instance_buffers_func,
@@ -22,11 +51,15 @@ std::tuple<int, int, int, int, int> fast_gs::rasterization::forward(
     const float4* rotations_raw,
     const float* opacities_raw,
     const float3* sh_coefficients_0,
-    const float3* sh_coefficients_rest,
+    const void* sh_coefficients_rest,
+    const SHPrecision sh_precision,
     const float4* w2c,
     const float3* cam_position,
     float* image,
     float* alpha,
+    float* depth,
+    const bool render_only,
+    const float* pixel_mask,
     const int n_primitives,
     const int active_sh_bases,
     const int total_bases_sh_rest,
@@ -37,81 +70,138 @@ std::tuple<int, int, int, int, int> fast_gs::rasterization::forward(
     const float cx,
     const float cy,
     const float near_, // near and far are macros in windowns
-    const float far_) {
-    const dim3 grid(div_round_up(width, config::tile_width), div_round_up(height, config::tile_height), 1);
-    const dim3 block(config::tile_width, config::tile_height, 1);
+    const float far_,
+    const Projection projection) {
+    const TileShape tile_shape = resolve_tile_shape(context.tile_shape, width, height);
+    const int tile_width = tile_width_of(tile_shape);
+    const int tile_height = tile_height_of(tile_shape);
+    const int n_tile_pixels = tile_width * tile_height;
+    const dim3 grid(div_round_up(width, tile_width), div_round_up(height, tile_height), 1);
+    const dim3 block(tile_width, tile_height, 1);
     const int n_tiles = grid.x * grid.y;
 
-    char* per_tile_buffers_blob = per_tile_buffers_func(required<PerTileBuffers>(n_tiles));
-    PerTileBuffers per_tile_buffers = PerTileBuffers::from_blob(per_tile_buffers_blob, n_tiles);
+    // render-only forwards keep no per-pixel contribution counts and no buckets for a backward
+    const int n_contribution_pixels = render_only ? 0 : n_tile_pixels;
+    char* per_tile_buffers_blob = per_tile_buffers_func(required<PerTileBuffers>(n_tiles, n_contribution_pixels));
+    PerTileBuffers per_tile_buffers = PerTileBuffers::from_blob(per_tile_buffers_blob, n_tiles, n_contribution_pixels);
 
-    static cudaStream_t memset_stream = 0;
     if constexpr (!config::debug) {
-        static bool memset_stream_initialized = false;
-        if (!memset_stream_initialized) {
-            cudaStreamCreate(&memset_stream);
-            memset_stream_initialized = true;
-        }
-        cudaMemsetAsync(per_tile_buffers.instance_ranges, 0, sizeof(uint2) * n_tiles, memset_stream);
+        // the blob was allocated in stream order, the side stream may only touch it after that point
+        cudaEventRecord(context.memset_ready, stream);
+        cudaStreamWaitEvent(context.memset_stream, context.memset_ready);
+        cudaMemsetAsync(per_tile_buffers.instance_ranges, 0, sizeof(uint2) * n_tiles, context.memset_stream);
+        cudaEventRecord(context.memset_done, context.memset_stream);
     } else
-        cudaMemset(per_tile_buffers.instance_ranges, 0, sizeof(uint2) * n_tiles);
+        cudaMemsetAsync(per_tile_buffers.instance_ranges, 0, sizeof(uint2) * n_tiles, stream);
 
     char* per_primitive_buffers_blob = per_primitive_buffers_func(required<PerPrimitiveBuffers>(n_primitives));
     PerPrimitiveBuffers per_primitive_buffers = PerPrimitiveBuffers::from_blob(per_primitive_buffers_blob, n_primitives);
 
-    cudaMemset(per_primitive_buffers.n_visible_primitives, 0, sizeof(uint));
-    cudaMemset(per_primitive_buffers.n_instances, 0, sizeof(uint));
-
-    kernels::forward::preprocess_cu<<<div_round_up(n_primitives, config::block_size_preprocess), config::block_size_preprocess>>>(
-        means,
-        scales_raw,
-        rotations_raw,
-        opacities_raw,
-        sh_coefficients_0,
-        sh_coefficients_rest,
-        w2c,
-        cam_position,
-        per_primitive_buffers.depth_keys.Current(),
-        per_primitive_buffers.primitive_indices.Current(),
-        per_primitive_buffers.n_touched_tiles,
-        per_primitive_buffers.screen_bounds,
-        per_primitive_buffers.mean2d,
-        per_primitive_buffers.conic_opacity,
-        per_primitive_buffers.color,
-        per_primitive_buffers.n_visible_primitives,
-        per_primitive_buffers.n_instances,
-        n_primitives,
-        grid.x,
-        grid.y,
-        active_sh_bases,
-        total_bases_sh_rest,
-        static_cast<float>(width),
-        static_cast<float>(height),
-        fx,
-        fy,
-        cx,
-        cy,
-        near_,
-        far_);
+    // Upper-bound mode keeps every count on the device: sorts and kernels run over capacities and
+    // bound-check against the device counters, so no host round-trip splits the forward.
+    // The first call has no previous counts and takes the exact path once.
+    if (context.upper_bound_allocation && context.counts_pending) {
+        cudaEventSynchronize(context.counts_ready);
+        context.instance_capacity = instance_capacity_for(context.counts_host[1]);
+        context.counts_pending = false;
+    }
+    const bool upper_bound = context.upper_bound_allocation && context.instance_capacity > 0;
+
+    if (context.collect_instance_stats) {
+        if (context.stats_host == nullptr) {
+            cudaMallocHost(&context.stats_host, 3 * sizeof(unsigned int));
+            cudaEventCreateWithFlags(&context.stats_ready, cudaEventDisableTiming);
+        }
+        // folds in the previous forward before its pinned counters are overwritten
+        context.instance_stats();
+        cudaMemsetAsync(per_primitive_buffers.n_bounding_instances, 0, sizeof(uint), stream);
+    }
+
+    cudaMemsetAsync(per_primitive_buffers.n_visible_primitives, 0, sizeof(uint), stream);
+    cudaMemsetAsync(per_primitive_buffers.n_instances, 0, sizeof(uint), stream);
+    if (upper_bound) {
+        // invisible primitives keep the maximum key and sort behind all visible ones
+        cudaMemsetAsync(per_primitive_buffers.depth_keys.Current(), 0xff, sizeof(uint) * n_primitives, stream);
+    }
+
+    const bool use_spatial_index = context.chunk_primitive_indices != nullptr && context.n_indexed_primitives == n_primitives;
+
+    const auto [depth_end_bit, depth_key_shift] = depth_key_layout(near_, far_);
+
+    dispatch_sh_precision(sh_precision, sh_coefficients_rest, [&](const auto* sh_rest) {
+        dispatch_active_sh_bases(active_sh_bases, [&](auto bases) {
+            dispatch_projection(projection, [&](auto projection_type) {
+                kernels::forward::preprocess_cu<decltype(bases)::value, decltype(projection_type)::value><<<div_round_up(n_primitives, config::block_size_preprocess), config::block_size_preprocess, 0, stream>>>(
+                    means,
+                    scales_raw,
+                    rotations_raw,
+                    opacities_raw,
+                    sh_coefficients_0,
+                    sh_rest,
+                    w2c,
+                    cam_position,
+                    per_primitive_buffers.depth_keys.Current(),
+                    per_primitive_buffers.primitive_indices.Current(),
+                    per_primitive_buffers.n_touched_tiles,
+                    per_primitive_buffers.screen_bounds,
+                    per_primitive_buffers.mean2d,
+                    per_primitive_buffers.conic_opacity,
+                    per_primitive_buffers.color,
+                    depth != nullptr ? per_primitive_buffers.depth : nullptr,
+                    per_primitive_buffers.n_visible_primitives,
+                    per_primitive_buffers.n_instances,
+                    context.collect_instance_stats ? per_primitive_buffers.n_bounding_instances : nullptr,
+                    use_spatial_index ? context.chunk_primitive_indices : nullptr,
+                    use_spatial_index ? context.chunk_bounds : nullptr,
+                    n_primitives,
+                    grid.x,
+                    grid.y,
+                    tile_width,
+                    tile_height,
+                    total_bases_sh_rest,
+                    depth_key_shift,
+                    static_cast<float>(width),
+                    static_cast<float>(height),
+                    fx,
+                    fy,
+                    cx,
+                    cy,
+                    near_,
+                    far_);
+            });
+        });
+    });
     CHECK_CUDA(config::debug, "preprocess")
 
-    int n_visible_primitives;
-    cudaMemcpy(&n_visible_primitives, per_primitive_buffers.n_visible_primitives, sizeof(uint), cudaMemcpyDeviceToHost);
-    int n_instances;
-    cudaMemcpy(&n_instances, per_primitive_buffers.n_instances, sizeof(uint), cudaMemcpyDeviceToHost);
+    // in upper-bound mode these are the number of items processed, not the counts
+    int n_visible_primitives = n_primitives;
+    int n_instances = upper_bound ? context.instance_capacity : 0;
+    if (upper_bound) {
+        // read while the depth sort below is already queued, so the GPU does not idle on it
+        cudaMemcpyAsync(context.counts_host + 3, per_primitive_buffers.n_instances, sizeof(uint), cudaMemcpyDeviceToHost, stream);
+        cudaEventRecord(context.instances_ready, stream);
+    } else {
+        cudaMemcpyAsync(&n_visible_primitives, per_primitive_buffers.n_visible_primitives, sizeof(uint), cudaMemcpyDeviceToHost, stream);
+        cudaMemcpyAsync(&n_instances, per_primitive_buffers.n_instances, sizeof(uint), cudaMemcpyDeviceToHost, stream);
+        cudaStreamSynchronize(stream);
+        if (context.upper_bound_allocation)
+            context.instance_capacity = instance_capacity_for(n_instances);
+    }
 
     cub::DeviceRadixSort::SortPairs(
         per_primitive_buffers.cub_workspace,
         per_primitive_buffers.cub_workspace_size,
         per_primitive_buffers.depth_keys,
         per_primitive_buffers.primitive_indices,
-        n_visible_primitives);
+        n_visible_primitives,
+        0, depth_end_bit, stream);
     CHECK_CUDA(config::debug, "cub::DeviceRadixSort::SortPairs (Depth)")
 
-    kernels::forward::apply_depth_ordering_cu<<<div_round_up(n_visible_primitives, config::block_size_apply_depth_ordering), config::block_size_apply_depth_ordering>>>(
+    kernels::forward::apply_depth_ordering_cu<<<div_round_up(n_visible_primitives, config::block_size_apply_depth_ordering), config::block_size_apply_depth_ordering, 0, stream>>>(
         per_primitive_buffers.primitive_indices.Current(),
         per_primitive_buffers.n_touched_tiles,
         per_primitive_buffers.offset,
+        per_primitive_buffers.n_visible_primitives,
         n_visible_primitives);
     CHECK_CUDA(config::debug, "apply_depth_ordering")
 
@@ -120,13 +210,28 @@ std::tuple<int, int, int, int, int> fast_gs::rasterization::forward(
         per_primitive_buffers.cub_workspace_size,
         per_primitive_buffers.offset,
         per_primitive_buffers.offset,
-        n_visible_primitives);
+        n_visible_primitives,
+        stream);
     CHECK_CUDA(config::debug, "cub::DeviceScan::ExclusiveSum (Primitive Offsets)")
 
+    if (upper_bound) {
+        // create_instances would drop everything past the capacity, grow it to the exact count first
+        cudaEventSynchronize(context.instances_ready);
+        if (const int exact = static_cast<int>(context.counts_host[3]); exact > n_instances) {
+            context.instance_capacity = instance_capacity_for(exact);
+            n_instances = context.instance_capacity;
+            context.instance_overflows++;
+        }
+    }
+
     char* per_instance_buffers_blob = per_instance_buffers_func(required<PerInstanceBuffers>(n_instances));
     PerInstanceBuffers per_instance_buffers = PerInstanceBuffers::from_blob(per_instance_buffers_blob, n_instances);
+    if (upper_bound) {
+        // unused slots keep the maximum tile key and sort behind all instances
+        cudaMemsetAsync(per_instance_buffers.keys.Current(), 0xff, sizeof(ushort) * n_instances, stream);
+    }
 
-    kernels::forward::create_instances_cu<<<div_round_up(n_visible_primitives, config::block_size_create_instances), config::block_size_create_instances>>>(
+    kernels::forward::create_instances_cu<<<div_round_up(n_visible_primitives, config::block_size_create_instances), config::block_size_create_instances, 0, stream>>>(
         per_primitive_buffers.primitive_indices.Current(),
         per_primitive_buffers.offset,
         per_primitive_buffers.screen_bounds,
@@ -135,7 +240,10 @@ std::tuple<int, int, int, int, int> fast_gs::rasterization::forward(
         per_instance_buffers.keys.Current(),
         per_instance_buffers.primitive_indices.Current(),
         grid.x,
-        n_visible_primitives);
+        tile_width,
+        tile_height,
+        per_primitive_buffers.n_visible_primitives,
+        n_instances);
     CHECK_CUDA(config::debug, "create_instances")
 
     cub::DeviceRadixSort::SortPairs(
@@ -143,57 +251,180 @@ std::tuple<int, int, int, int, int> fast_gs::rasterization::forward(
         per_instance_buffers.cub_workspace_size,
         per_instance_buffers.keys,
         per_instance_buffers.primitive_indices,
-        n_instances);
+        n_instances,
+        0, tile_key_bits(n_tiles), stream);
     CHECK_CUDA(config::debug, "cub::DeviceRadixSort::SortPairs (Tile)")
 
     if constexpr (!config::debug)
-        cudaStreamSynchronize(memset_stream);
+        cudaStreamWaitEvent(stream, context.memset_done);
 
     if (n_instances > 0) {
-        kernels::forward::extract_instance_ranges_cu<<<div_round_up(n_instances, config::block_size_extract_instance_ranges), config::block_size_extract_instance_ranges>>>(
+        kernels::forward::extract_instance_ranges_cu<<<div_round_up(n_instances, config::block_size_extract_instance_ranges), config::block_size_extract_instance_ranges, 0, stream>>>(
             per_instance_buffers.keys.Current(),
             per_tile_buffers.instance_ranges,
+            per_primitive_buffers.n_instances,
             n_instances);
         CHECK_CUDA(config::debug, "extract_instance_ranges")
+
+        // an empty range skips the tile in the blend, and without buckets in the backward as well
+        if (pixel_mask != nullptr) {
+            kernels::forward::mask_tiles_cu<<<grid, block, 0, stream>>>(
+                pixel_mask,
+                per_tile_buffers.instance_ranges,
+                width,
+                height,
+                grid.x);
+            CHECK_CUDA(config::debug, "mask_tiles")
+        }
     }
 
-    kernels::forward::extract_bucket_counts<<<div_round_up(n_tiles, config::block_size_extract_bucket_counts), config::block_size_extract_bucket_counts>>>(
-        per_tile_buffers.instance_ranges,
-        per_tile_buffers.n_buckets,
-        n_tiles);
-    CHECK_CUDA(config::debug, "extract_bucket_counts")
-
-    cub::DeviceScan::InclusiveSum(
-        per_tile_buffers.cub_workspace,
-        per_tile_buffers.cub_workspace_size,
-        per_tile_buffers.n_buckets,
-        per_tile_buffers.bucket_offsets,
-        n_tiles);
-    CHECK_CUDA(config::debug, "cub::DeviceScan::InclusiveSum (Bucket Counts)")
-
-    int n_buckets;
-    cudaMemcpy(&n_buckets, per_tile_buffers.bucket_offsets + n_tiles - 1, sizeof(uint), cudaMemcpyDeviceToHost);
-
-    char* per_bucket_buffers_blob = per_bucket_buffers_func(required<PerBucketBuffers>(n_buckets));
-    PerBucketBuffers per_bucket_buffers = PerBucketBuffers::from_blob(per_bucket_buffers_blob, n_buckets);
-
-    kernels::forward::blend_cu<<<grid, block>>>(
-        per_tile_buffers.instance_ranges,
-        per_tile_buffers.bucket_offsets,
-        per_instance_buffers.primitive_indices.Current(),
-        per_primitive_buffers.mean2d,
-        per_primitive_buffers.conic_opacity,
-        per_primitive_buffers.color,
-        image,
-        alpha,
-        per_tile_buffers.max_n_contributions,
-        per_tile_buffers.n_contributions,
-        per_bucket_buffers.tile_index,
-        per_bucket_buffers.color_transmittance,
-        width,
-        height,
-        grid.x);
-    CHECK_CUDA(config::debug, "blend")
-
-    return {n_visible_primitives, n_instances, n_buckets, per_primitive_buffers.primitive_indices.selector, per_instance_buffers.primitive_indices.selector};
+    int n_buckets = 0;
+    int bucket_replay_chunk = 0;
+    PerBucketBuffers per_bucket_buffers{};
+    if (!render_only) {
+        kernels::forward::extract_bucket_counts<<<div_round_up(n_tiles, config::block_size_extract_bucket_counts), config::block_size_extract_bucket_counts, 0, stream>>>(
+            per_tile_buffers.instance_ranges,
+            per_tile_buffers.n_buckets,
+            n_tiles);
+        CHECK_CUDA(config::debug, "extract_bucket_counts")
+
+        cub::DeviceScan::InclusiveSum(
+            per_tile_buffers.cub_workspace,
+            per_tile_buffers.cub_workspace_size,
+            per_tile_buffers.n_buckets,
+            per_tile_buffers.bucket_offsets,
+            n_tiles,
+            stream);
+        CHECK_CUDA(config::debug, "cub::DeviceScan::InclusiveSum (Bucket Counts)")
+
+        // at most one partially filled bucket per tile on top of the full ones
+        n_buckets = div_round_up(n_instances, 32) + n_tiles;
+        if (!upper_bound) {
+            cudaMemcpyAsync(&n_buckets, per_tile_buffers.bucket_offsets + n_tiles - 1, sizeof(uint), cudaMemcpyDeviceToHost, stream);
+            cudaStreamSynchronize(stream);
+        }
+
+        // over the budget the backward replays the states chunk by chunk, the blend only writes the tile indices
+        const size_t bucket_state_bytes = sizeof(float4) * n_tile_pixels;
+        if (context.bucket_state_budget > 0 && static_cast<size_t>(n_buckets) * bucket_state_bytes > context.bucket_state_budget)
+            bucket_replay_chunk = static_cast<int>(std::max<size_t>(1, context.bucket_state_budget / bucket_state_bytes));
+        const int n_state_pixels = bucket_replay_chunk > 0 ? 0 : n_tile_pixels;
+        char* per_bucket_buffers_blob = per_bucket_buffers_func(required<PerBucketBuffers>(n_buckets, n_state_pixels));
+        per_bucket_buffers = PerBucketBuffers::from_blob(per_bucket_buffers_blob, n_buckets, n_state_pixels);
+        if (bucket_replay_chunk > 0)
+            per_bucket_buffers.color_transmittance = nullptr;
+    }
+
+    // every heavy tile holds more than blend_split_threshold of the n_instances instances,
+    // the segment merge does not composite depth and renders bucket states, so depth and
+    // render-only forwards blend every tile in one block
+    const bool render_depth = depth != nullptr;
+    const int max_heavy_tiles = context.load_balanced_blend && !render_depth && !render_only ? n_instances / (config::blend_split_threshold + 1) : 0;
+    const int max_segments = div_round_up(n_instances, config::blend_segment_size) + max_heavy_tiles;
+    const bool split_heavy_tiles = max_heavy_tiles > 0;
+    PerSegmentBuffers per_segment_buffers;
+    if (split_heavy_tiles) {
+        char* per_segment_buffers_blob = context.per_segment_buffers.reserve(required<PerSegmentBuffers>(max_segments, max_heavy_tiles, n_tile_pixels));
+        per_segment_buffers = PerSegmentBuffers::from_blob(per_segment_buffers_blob, max_segments, max_heavy_tiles, n_tile_pixels);
+        cudaMemsetAsync(per_segment_buffers.n_heavy_tiles, 0, sizeof(uint), stream);
+        cudaMemsetAsync(per_segment_buffers.n_segments, 0, sizeof(uint), stream);
+        kernels::forward::collect_heavy_tiles_cu<<<div_round_up(n_tiles, config::block_size_extract_bucket_counts), config::block_size_extract_bucket_counts, 0, stream>>>(
+            per_tile_buffers.instance_ranges,
+            per_segment_buffers.heavy_tiles,
+            per_segment_buffers.n_heavy_tiles,
+            per_segment_buffers.segments,
+            per_segment_buffers.n_segments,
+            n_tiles,
+            max_heavy_tiles,
+            max_segments);
+        CHECK_CUDA(config::debug, "collect_heavy_tiles")
+    }
+
+    dispatch_tile_shape(tile_shape, [&](auto tile) {
+        using Tile = decltype(tile);
+        auto blend = render_only ? (render_depth ? kernels::forward::blend_cu<Tile, true, true> : kernels::forward::blend_cu<Tile, false, true>)
+                                 : (render_depth ? kernels::forward::blend_cu<Tile, true, false> : kernels::forward::blend_cu<Tile, false, false>);
+        blend<<<grid, block, 0, stream>>>(
+            per_tile_buffers.instance_ranges,
+            per_tile_buffers.bucket_offsets,
+            per_instance_buffers.primitive_indices.Current(),
+            per_primitive_buffers.mean2d,
+            per_primitive_buffers.conic_opacity,
+            per_primitive_buffers.color,
+            per_primitive_buffers.depth,
+            image,
+            alpha,
+            depth,
+            per_tile_buffers.max_n_contributions,
+            per_tile_buffers.n_contributions,
+            per_bucket_buffers.tile_index,
+            per_bucket_buffers.color_transmittance,
+            width,
+            height,
+            grid.x,
+            split_heavy_tiles);
+        CHECK_CUDA(config::debug, "blend")
+
+        if (!split_heavy_tiles)
+            return;
+        // the device counts are unknown here, surplus blocks of both launches exit immediately
+        kernels::forward::blend_segment_cu<decltype(tile)><<<max_segments, block, 0, stream>>>(
+            per_segment_buffers.segments,
+            per_segment_buffers.n_segments,
+            per_tile_buffers.instance_ranges,
+            per_tile_buffers.bucket_offsets,
+            per_instance_buffers.primitive_indices.Current(),
+            per_primitive_buffers.mean2d,
+            per_primitive_buffers.conic_opacity,
+            per_primitive_buffers.color,
+            per_bucket_buffers.tile_index,
+            per_bucket_buffers.color_transmittance,
+            per_segment_buffers.color_transmittance,
+            per_segment_buffers.n_contributions,
+            width,
+            height,
+            grid.x,
+            max_segments);
+        CHECK_CUDA(config::debug, "blend_segment")
+
+        kernels::forward::blend_merge_cu<decltype(tile)><<<max_heavy_tiles, block, 0, stream>>>(
+            per_segment_buffers.heavy_tiles,
+            per_segment_buffers.n_heavy_tiles,
+            per_tile_buffers.instance_ranges,
+            per_tile_buffers.bucket_offsets,
+            per_segment_buffers.color_transmittance,
+            per_segment_buffers.n_contributions,
+            image,
+            alpha,
+            per_tile_buffers.max_n_contributions,
+            per_tile_buffers.n_contributions,
+            per_bucket_buffers.color_transmittance,
+            width,
+            height,
+            grid.x,
+            max_heavy_tiles);
+        CHECK_CUDA(config::debug, "blend_merge")
+    });
+
+    if (upper_bound) {
+        cudaMemcpyAsync(context.counts_host + 0, per_primitive_buffers.n_visible_primitives, sizeof(uint), cudaMemcpyDeviceToHost, stream);
+        cudaMemcpyAsync(context.counts_host + 1, per_primitive_buffers.n_instances, sizeof(uint), cudaMemcpyDeviceToHost, stream);
+        if (!render_only)
+            cudaMemcpyAsync(context.counts_host + 2, per_tile_buffers.bucket_offsets + n_tiles - 1, sizeof(uint), cudaMemcpyDeviceToHost, stream);
+        cudaEventRecord(context.counts_ready, stream);
+        context.counts_pending = true;
+    }
+
+    if (context.collect_instance_stats) {
+        cudaMemcpyAsync(context.stats_host + 0, per_primitive_buffers.n_instances, sizeof(uint), cudaMemcpyDeviceToHost, stream);
+        cudaMemcpyAsync(context.stats_host + 1, per_primitive_buffers.n_bounding_instances, sizeof(uint), cudaMemcpyDeviceToHost, stream);
+        if (render_only)
+            context.stats_host[2] = 0;
+        else
+            cudaMemcpyAsync(context.stats_host + 2, per_tile_buffers.bucket_offsets + n_tiles - 1, sizeof(uint), cudaMemcpyDeviceToHost, stream);
+        cudaEventRecord(context.stats_ready, stream);
+        context.stats_pending = true;
+    }
+
+    return {n_visible_primitives, n_instances, n_buckets, per_primitive_buffers.primitive_indices.selector, per_instance_buffers.primitive_indices.selector, bucket_replay_chunk};
 }
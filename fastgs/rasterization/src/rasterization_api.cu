@@ -3,16 +3,46 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "backward.h"
+#include "buffer_utils.h"
 #include "forward.h"
 #include "helper_math.h"
 #include "rasterization_api.h"
 #include "rasterization_config.h"
+#include "rasterizer_context.h"
+#include "sh_storage.h"
 #include "torch_utils.h"
+#include <ATen/cuda/CUDAContext.h>
 #include <functional>
 #include <stdexcept>
 #include <tuple>
 
-std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, int, int, int, int, int>
+namespace {
+
+    // Hands out the arena's memory and exposes it as an uint8 view sharing the block, which is saved for backward
+    std::function<char*(size_t)> arena_function_wrapper(fast_gs::rasterization::BufferArena& arena, torch::Tensor& view) {
+        return [&arena, &view](const size_t N) {
+            char* data = arena.reserve(N);
+            view = arena.block.narrow(0, 0, static_cast<int64_t>(N));
+            return data;
+        };
+    }
+
+    fast_gs::rasterization::SHPrecision sh_precision_of(const torch::Tensor& sh_coefficients_rest) {
+        switch (sh_coefficients_rest.scalar_type()) {
+        case torch::kFloat32:
+            return fast_gs::rasterization::SHPrecision::Float32;
+        case torch::kFloat16:
+            return fast_gs::rasterization::SHPrecision::Float16;
+        case torch::kBFloat16:
+            return fast_gs::rasterization::SHPrecision::BFloat16;
+        default:
+            throw std::runtime_error("sh_coefficients_rest must be float32, float16 or bfloat16");
+        }
+    }
+
+} // namespace
+
+std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, int, int, int, int, int, int>
 fast_gs::rasterization::forward_wrapper(
     const torch::Tensor& means,
     const torch::Tensor& scales_raw,
@@ -30,8 +60,11 @@ fast_gs::rasterization::forward_wrapper(
     const float center_x,
     const float center_y,
     const float near_plane,
-    const float far_plane) {
-    // all optimizable tensors must be contiguous CUDA float tensors
+    const float far_plane,
+    const Projection projection,
+    RasterizerContext* context,
+    const torch::Tensor& pixel_mask) {
+    // all optimizable tensors must be contiguous CUDA float tensors, sh_coefficients_rest may also be half or bf16
     CHECK_INPUT(config::debug, means, "means");
     CHECK_INPUT(config::debug, scales_raw, "scales_raw");
     CHECK_INPUT(config::debug, rotations_raw, "rotations_raw");
@@ -42,19 +75,28 @@ fast_gs::rasterization::forward_wrapper(
     const int n_primitives = means.size(0);
     const int total_bases_sh_rest = sh_coefficients_rest.size(1);
     const torch::TensorOptions float_options = torch::TensorOptions().dtype(torch::kFloat).device(torch::kCUDA);
-    const torch::TensorOptions byte_options = torch::TensorOptions().dtype(torch::kByte).device(torch::kCUDA);
     torch::Tensor image = torch::empty({3, height, width}, float_options);
     torch::Tensor alpha = torch::empty({1, height, width}, float_options);
-    torch::Tensor per_primitive_buffers = torch::empty({0}, byte_options);
-    torch::Tensor per_tile_buffers = torch::empty({0}, byte_options);
-    torch::Tensor per_instance_buffers = torch::empty({0}, byte_options);
-    torch::Tensor per_bucket_buffers = torch::empty({0}, byte_options);
-    const std::function<char*(size_t)> per_primitive_buffers_func = resize_function_wrapper(per_primitive_buffers);
-    const std::function<char*(size_t)> per_tile_buffers_func = resize_function_wrapper(per_tile_buffers);
-    const std::function<char*(size_t)> per_instance_buffers_func = resize_function_wrapper(per_instance_buffers);
-    const std::function<char*(size_t)> per_bucket_buffers_func = resize_function_wrapper(per_bucket_buffers);
-
-    auto [n_visible_primitives, n_instances, n_buckets, primitive_primitive_indices_selector, instance_primitive_indices_selector] = forward(
+    torch::Tensor mask;
+    if (pixel_mask.defined()) {
+        if (!pixel_mask.is_cuda() || pixel_mask.numel() != static_cast<int64_t>(width) * height)
+            throw std::runtime_error("pixel_mask must be a CUDA [1, H, W] tensor matching the image size");
+        mask = pixel_mask.to(torch::kFloat).contiguous();
+    }
+    RasterizerContext& ctx = context ? *context : default_context();
+    torch::Tensor depth = ctx.render_depth ? torch::empty({2, height, width}, float_options) : torch::empty({0}, float_options);
+    torch::Tensor per_primitive_buffers;
+    torch::Tensor per_tile_buffers;
+    torch::Tensor per_instance_buffers;
+    torch::Tensor per_bucket_buffers;
+    const std::function<char*(size_t)> per_primitive_buffers_func = arena_function_wrapper(ctx.per_primitive_buffers, per_primitive_buffers);
+    const std::function<char*(size_t)> per_tile_buffers_func = arena_function_wrapper(ctx.per_tile_buffers, per_tile_buffers);
+    const std::function<char*(size_t)> per_instance_buffers_func = arena_function_wrapper(ctx.per_instance_buffers, per_instance_buffers);
+    const std::function<char*(size_t)> per_bucket_buffers_func = arena_function_wrapper(ctx.per_bucket_buffers, per_bucket_buffers);
+
+    auto [n_visible_primitives, n_instances, n_buckets, primitive_primitive_indices_selector, instance_primitive_indices_selector, bucket_replay_chunk] = forward(
+        ctx,
+        at::cuda::getCurrentCUDAStream(),
         per_primitive_buffers_func,
         per_tile_buffers_func,
         per_instance_buffers_func,
@@ -64,11 +106,15 @@ fast_gs::rasterization::forward_wrapper(
         reinterpret_cast<float4*>(rotations_raw.data_ptr<float>()),
         opacities_raw.data_ptr<float>(),
         reinterpret_cast<float3*>(sh_coefficients_0.data_ptr<float>()),
-        reinterpret_cast<float3*>(sh_coefficients_rest.data_ptr<float>()),
+        sh_coefficients_rest.data_ptr(),
+        sh_precision_of(sh_coefficients_rest),
         reinterpret_cast<float4*>(w2c.contiguous().data_ptr<float>()),
         reinterpret_cast<float3*>(cam_position.contiguous().data_ptr<float>()),
         image.data_ptr<float>(),
         alpha.data_ptr<float>(),
+        ctx.render_depth ? depth.data_ptr<float>() : nullptr,
+        false,
+        mask.defined() ? mask.data_ptr<float>() : nullptr,
         n_primitives,
         active_sh_bases,
         total_bases_sh_rest,
@@ -79,18 +125,134 @@ fast_gs::rasterization::forward_wrapper(
         center_x,
         center_y,
         near_plane,
-        far_plane);
+        far_plane,
+        projection);
 
     return {
-        image, alpha,
+        image, alpha, depth,
         per_primitive_buffers, per_tile_buffers, per_instance_buffers, per_bucket_buffers,
         n_visible_primitives, n_instances, n_buckets,
-        primitive_primitive_indices_selector, instance_primitive_indices_selector};
+        primitive_primitive_indices_selector, instance_primitive_indices_selector, bucket_replay_chunk};
+}
+
+torch::Tensor fast_gs::rasterization::visibility_mask(
+    const torch::Tensor& per_primitive_buffers,
+    const int n_primitives) {
+    char* blob = reinterpret_cast<char*>(per_primitive_buffers.data_ptr());
+    const PerPrimitiveBuffers buffers = PerPrimitiveBuffers::from_blob(blob, n_primitives);
+    // preprocess leaves 0 touched tiles for every culled primitive
+    const torch::Tensor n_touched_tiles = torch::from_blob(
+        buffers.n_touched_tiles, {n_primitives}, torch::TensorOptions().dtype(torch::kInt32).device(torch::kCUDA));
+    return n_touched_tiles.gt(0);
+}
+
+std::tuple<torch::Tensor, torch::Tensor, torch::Tensor>
+fast_gs::rasterization::tile_workload(
+    const torch::Tensor& per_tile_buffers,
+    const int width,
+    const int height,
+    const TileShape tile_shape) {
+    const TileShape resolved = resolve_tile_shape(tile_shape, width, height);
+    const int tile_width = tile_width_of(resolved);
+    const int tile_height = tile_height_of(resolved);
+    const int64_t grid_width = (width + tile_width - 1) / tile_width;
+    const int64_t grid_height = (height + tile_height - 1) / tile_height;
+    char* blob = reinterpret_cast<char*>(per_tile_buffers.data_ptr());
+    const PerTileBuffers buffers = PerTileBuffers::from_blob(blob, grid_width * grid_height, tile_width * tile_height);
+
+    // the counts are uint, far below the int32 range
+    const torch::TensorOptions int_options = torch::TensorOptions().dtype(torch::kInt32).device(torch::kCUDA);
+    const torch::Tensor ranges = torch::from_blob(buffers.instance_ranges, {grid_height, grid_width, 2}, int_options);
+    torch::Tensor tile_instances = ranges.select(2, 1) - ranges.select(2, 0);
+    torch::Tensor tile_max_contributions = torch::from_blob(buffers.max_n_contributions, {grid_height, grid_width}, int_options).clone();
+    torch::Tensor pixel_contributions = torch::from_blob(buffers.n_contributions, {height, width}, int_options).clone();
+    return {tile_instances, tile_max_contributions, pixel_contributions};
+}
+
+std::tuple<torch::Tensor, torch::Tensor, torch::Tensor>
+fast_gs::rasterization::render_wrapper(
+    const torch::Tensor& means,
+    const torch::Tensor& scales_raw,
+    const torch::Tensor& rotations_raw,
+    const torch::Tensor& opacities_raw,
+    const torch::Tensor& sh_coefficients_0,
+    const torch::Tensor& sh_coefficients_rest,
+    const torch::Tensor& w2c,
+    const torch::Tensor& cam_position,
+    const int active_sh_bases,
+    const int width,
+    const int height,
+    const float focal_x,
+    const float focal_y,
+    const float center_x,
+    const float center_y,
+    const float near_plane,
+    const float far_plane,
+    const Projection projection,
+    RasterizerContext* context) {
+    CHECK_INPUT(config::debug, means, "means");
+    CHECK_INPUT(config::debug, scales_raw, "scales_raw");
+    CHECK_INPUT(config::debug, rotations_raw, "rotations_raw");
+    CHECK_INPUT(config::debug, opacities_raw, "opacities_raw");
+    CHECK_INPUT(config::debug, sh_coefficients_0, "sh_coefficients_0");
+    CHECK_INPUT(config::debug, sh_coefficients_rest, "sh_coefficients_rest");
+
+    const int n_primitives = means.size(0);
+    const int total_bases_sh_rest = sh_coefficients_rest.size(1);
+    const torch::TensorOptions float_options = torch::TensorOptions().dtype(torch::kFloat).device(torch::kCUDA);
+    torch::Tensor image = torch::empty({3, height, width}, float_options);
+    torch::Tensor alpha = torch::empty({1, height, width}, float_options);
+    RasterizerContext& ctx = context ? *context : default_context();
+    torch::Tensor depth = ctx.render_depth ? torch::empty({2, height, width}, float_options) : torch::empty({0}, float_options);
+    // nothing is saved for a backward, the views only exist because the wrapper hands them out
+    torch::Tensor per_primitive_buffers;
+    torch::Tensor per_tile_buffers;
+    torch::Tensor per_instance_buffers;
+    const std::function<char*(size_t)> per_primitive_buffers_func = arena_function_wrapper(ctx.per_primitive_buffers, per_primitive_buffers);
+    const std::function<char*(size_t)> per_tile_buffers_func = arena_function_wrapper(ctx.per_tile_buffers, per_tile_buffers);
+    const std::function<char*(size_t)> per_instance_buffers_func = arena_function_wrapper(ctx.per_instance_buffers, per_instance_buffers);
+
+    forward(
+        ctx,
+        at::cuda::getCurrentCUDAStream(),
+        per_primitive_buffers_func,
+        per_tile_buffers_func,
+        per_instance_buffers_func,
+        nullptr,
+        reinterpret_cast<float3*>(means.data_ptr<float>()),
+        reinterpret_cast<float3*>(scales_raw.data_ptr<float>()),
+        reinterpret_cast<float4*>(rotations_raw.data_ptr<float>()),
+        opacities_raw.data_ptr<float>(),
+        reinterpret_cast<float3*>(sh_coefficients_0.data_ptr<float>()),
+        sh_coefficients_rest.data_ptr(),
+        sh_precision_of(sh_coefficients_rest),
+        reinterpret_cast<float4*>(w2c.contiguous().data_ptr<float>()),
+        reinterpret_cast<float3*>(cam_position.contiguous().data_ptr<float>()),
+        image.data_ptr<float>(),
+        alpha.data_ptr<float>(),
+        ctx.render_depth ? depth.data_ptr<float>() : nullptr,
+        true,
+        nullptr,
+        n_primitives,
+        active_sh_bases,
+        total_bases_sh_rest,
+        width,
+        height,
+        focal_x,
+        focal_y,
+        center_x,
+        center_y,
+        near_plane,
+        far_plane,
+        projection);
+
+    return {image, alpha, depth};
 }
 
 std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>
 fast_gs::rasterization::backward_wrapper(
     torch::Tensor& densification_info,
+    torch::Tensor& max_contribution,
     const torch::Tensor& grad_image,
     const torch::Tensor& grad_alpha,
     const torch::Tensor& image,
@@ -114,20 +276,25 @@ fast_gs::rasterization::backward_wrapper(
     const float center_y,
     const float near_plane,
     const float far_plane,
+    const Projection projection,
     const int n_visible_primitives,
     const int n_instances,
     const int n_buckets,
     const int primitive_primitive_indices_selector,
-    const int instance_primitive_indices_selector) {
+    const int instance_primitive_indices_selector,
+    const TileShape tile_shape,
+    const int bucket_replay_chunk) {
     const int n_primitives = means.size(0);
     const int total_bases_sh_rest = sh_coefficients_rest.size(1);
     const torch::TensorOptions float_options = torch::TensorOptions().dtype(torch::kFloat).device(torch::kCUDA);
-    torch::Tensor grad_means = torch::zeros({n_primitives, 3}, float_options);
-    torch::Tensor grad_scales_raw = torch::zeros({n_primitives, 3}, float_options);
-    torch::Tensor grad_rotations_raw = torch::zeros({n_primitives, 4}, float_options);
+    // preprocess_backward writes every entry of these, only the atomically accumulated ones need zeros
+    torch::Tensor grad_means = torch::empty({n_primitives, 3}, float_options);
+    torch::Tensor grad_scales_raw = torch::empty({n_primitives, 3}, float_options);
+    torch::Tensor grad_rotations_raw = torch::empty({n_primitives, 4}, float_options);
     torch::Tensor grad_opacities_raw = torch::zeros({n_primitives, 1}, float_options);
     torch::Tensor grad_sh_coefficients_0 = torch::zeros({n_primitives, 1, 3}, float_options);
-    torch::Tensor grad_sh_coefficients_rest = torch::zeros({n_primitives, total_bases_sh_rest, 3}, float_options);
+    // accumulated in fp32 whatever the storage precision, cast back on return
+    torch::Tensor grad_sh_coefficients_rest = torch::empty({n_primitives, total_bases_sh_rest, 3}, float_options);
     torch::Tensor grad_mean2d_helper = torch::zeros({n_primitives, 2}, float_options);
     torch::Tensor grad_conic_helper = torch::zeros({n_primitives, 3}, float_options);
     torch::Tensor grad_w2c = torch::Tensor();
@@ -136,8 +303,28 @@ fast_gs::rasterization::backward_wrapper(
     }
 
     const bool update_densification_info = densification_info.size(0) > 0;
+    if (update_densification_info &&
+        (densification_info.scalar_type() != torch::kHalf || densification_info.dim() != 2 ||
+         densification_info.size(0) != n_primitives || densification_info.size(1) != 2)) {
+        throw std::runtime_error("densification_info must be an [N, 2] half tensor");
+    }
+    const bool update_max_contribution = max_contribution.numel() > 0;
+    if (update_max_contribution &&
+        (max_contribution.scalar_type() != torch::kFloat || max_contribution.dim() != 1 ||
+         max_contribution.size(0) != n_primitives)) {
+        throw std::runtime_error("max_contribution must be an [N] float tensor");
+    }
+
+    // from the caching allocator, so the states of one chunk only occupy memory during the backward
+    torch::Tensor bucket_replay_states;
+    if (bucket_replay_chunk > 0) {
+        const TileShape resolved = resolve_tile_shape(tile_shape, width, height);
+        const int64_t n_tile_pixels = tile_width_of(resolved) * tile_height_of(resolved);
+        bucket_replay_states = torch::empty({bucket_replay_chunk * n_tile_pixels, 4}, float_options);
+    }
 
     backward(
+        at::cuda::getCurrentCUDAStream(),
         grad_image.data_ptr<float>(),
         grad_alpha.data_ptr<float>(),
         image.data_ptr<float>(),
@@ -145,7 +332,8 @@ fast_gs::rasterization::backward_wrapper(
         reinterpret_cast<float3*>(means.data_ptr<float>()),
         reinterpret_cast<float3*>(scales_raw.data_ptr<float>()),
         reinterpret_cast<float4*>(rotations_raw.data_ptr<float>()),
-        reinterpret_cast<float3*>(sh_coefficients_rest.data_ptr<float>()),
+        sh_coefficients_rest.data_ptr(),
+        sh_precision_of(sh_coefficients_rest),
         reinterpret_cast<float4*>(w2c.contiguous().data_ptr<float>()),
         reinterpret_cast<float3*>(cam_position.contiguous().data_ptr<float>()),
         reinterpret_cast<char*>(per_primitive_buffers.data_ptr()),
@@ -161,7 +349,8 @@ fast_gs::rasterization::backward_wrapper(
         reinterpret_cast<float2*>(grad_mean2d_helper.data_ptr<float>()),
         grad_conic_helper.data_ptr<float>(),
         w2c.requires_grad() ? reinterpret_cast<float4*>(grad_w2c.data_ptr<float>()) : nullptr,
-        update_densification_info ? densification_info.data_ptr<float>() : nullptr,
+        update_densification_info ? reinterpret_cast<__half2*>(densification_info.data_ptr<at::Half>()) : nullptr,
+        update_max_contribution ? max_contribution.data_ptr<float>() : nullptr,
         n_primitives,
         n_visible_primitives,
         n_instances,
@@ -175,7 +364,15 @@ fast_gs::rasterization::backward_wrapper(
         focal_x,
         focal_y,
         center_x,
-        center_y);
+        center_y,
+        projection,
+        tile_shape,
+        bucket_replay_chunk,
+        bucket_replay_chunk > 0 ? reinterpret_cast<float4*>(bucket_replay_states.data_ptr<float>()) : nullptr);
+
+    if (sh_coefficients_rest.scalar_type() != torch::kFloat32) {
+        grad_sh_coefficients_rest = grad_sh_coefficients_rest.to(sh_coefficients_rest.scalar_type());
+    }
 
     return {grad_means, grad_scales_raw, grad_rotations_raw, grad_opacities_raw, grad_sh_coefficients_0, grad_sh_coefficients_rest, grad_w2c};
 }
@@ -0,0 +1,90 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "rasterizer_context.h"
+#include <ATen/ops/empty.h>
+#include <algorithm>
+
+char* fast_gs::rasterization::BufferArena::reserve(const size_t bytes) {
+    high_water = std::max(high_water, bytes);
+    if (bytes <= capacity)
+        return data;
+    // half again on top, so a slowly growing model does not reallocate every few iterations
+    const size_t new_capacity = std::max(bytes, capacity + capacity / 2);
+    release();
+    block = at::empty({static_cast<int64_t>(new_capacity)}, at::TensorOptions().dtype(at::kByte).device(at::kCUDA));
+    data = reinterpret_cast<char*>(block.data_ptr());
+    capacity = new_capacity;
+    return data;
+}
+
+void fast_gs::rasterization::BufferArena::release() {
+    block.reset();
+    data = nullptr;
+    capacity = 0;
+}
+
+fast_gs::rasterization::RasterizerContext::RasterizerContext(const bool upper_bound_allocation)
+    : upper_bound_allocation(upper_bound_allocation) {
+    cudaStreamCreateWithFlags(&memset_stream, cudaStreamNonBlocking);
+    cudaEventCreateWithFlags(&memset_ready, cudaEventDisableTiming);
+    cudaEventCreateWithFlags(&memset_done, cudaEventDisableTiming);
+    if (upper_bound_allocation) {
+        cudaMallocHost(&counts_host, 4 * sizeof(unsigned int));
+        cudaEventCreateWithFlags(&counts_ready, cudaEventDisableTiming);
+        cudaEventCreateWithFlags(&instances_ready, cudaEventDisableTiming);
+    }
+}
+
+fast_gs::rasterization::RasterizerContext::~RasterizerContext() {
+    if (counts_ready) {
+        cudaEventSynchronize(counts_ready);
+        cudaEventDestroy(counts_ready);
+    }
+    if (instances_ready) {
+        cudaEventSynchronize(instances_ready);
+        cudaEventDestroy(instances_ready);
+    }
+    if (counts_host)
+        cudaFreeHost(counts_host);
+    if (stats_ready) {
+        cudaEventSynchronize(stats_ready);
+        cudaEventDestroy(stats_ready);
+    }
+    if (stats_host)
+        cudaFreeHost(stats_host);
+    per_primitive_buffers.release();
+    per_tile_buffers.release();
+    per_instance_buffers.release();
+    per_bucket_buffers.release();
+    per_segment_buffers.release();
+    cudaEventDestroy(memset_done);
+    cudaEventDestroy(memset_ready);
+    cudaStreamDestroy(memset_stream);
+}
+
+size_t fast_gs::rasterization::RasterizerContext::reserved_bytes() const {
+    return per_primitive_buffers.capacity + per_tile_buffers.capacity + per_instance_buffers.capacity + per_bucket_buffers.capacity + per_segment_buffers.capacity;
+}
+
+size_t fast_gs::rasterization::RasterizerContext::high_water_bytes() const {
+    return per_primitive_buffers.high_water + per_tile_buffers.high_water + per_instance_buffers.high_water + per_bucket_buffers.high_water + per_segment_buffers.high_water;
+}
+
+fast_gs::rasterization::InstanceStats fast_gs::rasterization::RasterizerContext::instance_stats() {
+    if (stats_pending) {
+        cudaEventSynchronize(stats_ready);
+        stats_totals.instances += stats_host[0];
+        stats_totals.bounding_instances += stats_host[1];
+        stats_totals.buckets += stats_host[2];
+        stats_totals.frames++;
+        stats_pending = false;
+    }
+    return stats_totals;
+}
+
+fast_gs::rasterization::RasterizerContext& fast_gs::rasterization::default_context() {
+    thread_local RasterizerContext context;
+    return context;
+}
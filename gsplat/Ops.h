@@ -23,6 +23,17 @@ namespace gsplat {
         const at::optional<at::Tensor> masks, // [...]
         const at::Tensor v_colors,            // [..., 3]
         bool compute_v_dirs);
+    // Backward of the SH colors projection_ut_3dgs_fused evaluates for one camera from separate
+    // sh0 and shN, returns fp32 v_sh0, v_shN and optionally v_means (v_campos is -sum(v_means))
+    std::tuple<at::Tensor, at::Tensor, at::Tensor> spherical_harmonics_split_bwd(
+        const uint32_t degrees_to_use,
+        const at::Tensor means,    // [N, 3]
+        const at::Tensor campos,   // [3]
+        const at::Tensor sh0,      // [N, 1, 3]
+        const at::Tensor shN,      // [N, K-1, 3], fp32, fp16 or bf16
+        const at::Tensor masks,    // [N]
+        const at::Tensor v_colors, // [N, 3]
+        bool compute_v_means);
 
     // GS Tile Intersection
     std::tuple<at::Tensor, at::Tensor, at::Tensor> intersect_tile(
@@ -56,6 +67,31 @@ namespace gsplat {
         at::Tensor binoms,    // [n_max, n_max]
         const int n_max);
 
+    // The data movement of an MCMC relocation in one launch: tensor[dst[i]] = tensor[src[i]] for
+    // every tensor in copied, and tensor[src[i]] = 0 for every tensor in zeroed (the optimizer
+    // moments). All tensors are contiguous CUDA tensors of the same N rows, dst rows are unique
+    // and disjoint from src rows.
+    void relocate_rows(
+        at::Tensor src_indices, // [M] int64
+        at::Tensor dst_indices, // [M] int64
+        const std::vector<at::Tensor>& copied,
+        const std::vector<at::Tensor>& zeroed);
+
+    // Stream compaction of pruning in place: tensor[i] = tensor[keep[i]] for every tensor, the
+    // kept rows end up in the first M rows of the same allocations. keep is ascending, the tensors
+    // are contiguous CUDA tensors of the same N rows.
+    void compact_rows(
+        at::Tensor keep_indices, // [M] int64
+        const std::vector<at::Tensor>& tensors);
+
+    // Opacity reset in place: raw opacities above max_raw_opacity are clamped to it and every row
+    // of the moments (the opacity's Adam state) is zeroed in the same launch, nothing is allocated.
+    // All tensors are contiguous CUDA tensors of the same N rows.
+    void reset_opacities(
+        at::Tensor raw_opacities, // [N] or [N, 1] float
+        const float max_raw_opacity,
+        const std::vector<at::Tensor>& moments);
+
     void add_noise(
         at::Tensor raw_opacities, // [N]
         at::Tensor raw_scales,    // [N, 3]
@@ -66,11 +102,14 @@ namespace gsplat {
 
     // Use uncented transform to project 3D gaussians to 2D. (none differentiable)
     // https://arxiv.org/abs/2412.12507
+    // With sh0, shN and campos the [C, N, 3] SH colors of the Gaussians that survive culling are
+    // evaluated in the same kernel (zeros elsewhere), see spherical_harmonics_split_bwd.
     std::tuple<
         at::Tensor,
         at::Tensor,
         at::Tensor,
         at::Tensor,
+        at::Tensor,
         at::Tensor>
     projection_ut_3dgs_fused(
         const at::Tensor means,                   // [N, 3]
@@ -94,8 +133,11 @@ namespace gsplat {
         ShutterType rs_type,
         const at::optional<at::Tensor> radial_coeffs,     // [C, 6] or [C, 4] optional
         const at::optional<at::Tensor> tangential_coeffs, // [C, 2] optional
-        const at::optional<at::Tensor> thin_prism_coeffs  // [C, 2] optional
-    );
+        const at::optional<at::Tensor> thin_prism_coeffs, // [C, 2] optional
+        const at::optional<at::Tensor> sh0 = at::nullopt,    // [N, 1, 3] optional
+        const at::optional<at::Tensor> shN = at::nullopt,    // [N, K-1, 3] optional, fp32, fp16 or bf16
+        const at::optional<at::Tensor> campos = at::nullopt, // [C, 3] optional
+        const uint32_t sh_degree = 0);
 
     std::tuple<at::Tensor, at::Tensor, at::Tensor>
     rasterize_to_pixels_from_world_3dgs_fwd(
@@ -125,7 +167,9 @@ namespace gsplat {
         const at::optional<at::Tensor> thin_prism_coeffs, // [C, 2] optional
         // intersections
         const at::Tensor tile_offsets, // [C, tile_height, tile_width]
-        const at::Tensor flatten_ids   // [n_isects]
+        const at::Tensor flatten_ids,  // [n_isects]
+        // packed: colors and opacities are [nnz, ...] and flatten_ids index into them
+        const at::optional<at::Tensor> gaussian_ids = at::nullopt // [nnz]
     );
 
     std::tuple<at::Tensor, at::Tensor, at::Tensor, at::Tensor, at::Tensor>
@@ -162,7 +206,9 @@ namespace gsplat {
         const at::Tensor last_ids,      // [C, image_height, image_width]
         // gradients of outputs
         const at::Tensor v_render_colors, // [C, image_height, image_width, 3]
-        const at::Tensor v_render_alphas  // [C, image_height, image_width, 1]
+        const at::Tensor v_render_alphas, // [C, image_height, image_width, 1]
+        // packed: colors and opacities are [nnz, ...] and flatten_ids index into them
+        const at::optional<at::Tensor> gaussian_ids = at::nullopt // [nnz]
     );
 
 } // namespace gsplat
@@ -18,6 +18,7 @@ namespace gsplat {
         at::Tensor,
         at::Tensor,
         at::Tensor,
+        at::Tensor,
         at::Tensor>
     projection_ut_3dgs_fused(
         const at::Tensor means,                   // [N, 3]
@@ -40,8 +41,11 @@ namespace gsplat {
         ShutterType rs_type,
         const at::optional<at::Tensor> radial_coeffs,     // [C, 6] or [C, 4] optional
         const at::optional<at::Tensor> tangential_coeffs, // [C, 2] optional
-        const at::optional<at::Tensor> thin_prism_coeffs  // [C, 2] optional
-    ) {
+        const at::optional<at::Tensor> thin_prism_coeffs, // [C, 2] optional
+        const at::optional<at::Tensor> sh0,               // [N, 1, 3] optional
+        const at::optional<at::Tensor> shN,               // [N, K-1, 3] optional
+        const at::optional<at::Tensor> campos,            // [C, 3] optional
+        const uint32_t sh_degree) {
         DEVICE_GUARD(means);
         CHECK_INPUT(means);
         CHECK_INPUT(quats);
@@ -63,6 +67,15 @@ namespace gsplat {
         if (thin_prism_coeffs.has_value()) {
             CHECK_INPUT(thin_prism_coeffs.value());
         }
+        const bool eval_sh = sh0.has_value();
+        if (eval_sh) {
+            TORCH_CHECK(shN.has_value() && campos.has_value(), "SH colors need sh0, shN and campos");
+            CHECK_INPUT(sh0.value());
+            CHECK_INPUT(shN.value());
+            CHECK_INPUT(campos.value());
+            TORCH_CHECK((sh_degree + 1) * (sh_degree + 1) <= shN.value().size(1) + 1,
+                        "not enough SH coefficients for degree ", sh_degree);
+        }
 
         uint32_t N = means.size(0); // number of gaussians
         uint32_t C = Ks.size(0);    // number of cameras
@@ -76,6 +89,11 @@ namespace gsplat {
             // we dont want NaN to appear in this tensor, so we zero intialize it
             compensations = at::zeros({C, N}, means.options());
         }
+        at::Tensor colors;
+        if (eval_sh) {
+            // culled Gaussians keep zeros
+            colors = at::zeros({C, N, 3}, means.options());
+        }
 
         launch_projection_ut_3dgs_fused_kernel(
             // inputs
@@ -105,8 +123,13 @@ namespace gsplat {
             depths,
             conics,
             calc_compensations ? at::optional<at::Tensor>(compensations)
-                               : at::nullopt);
-        return std::make_tuple(radii, means2d, depths, conics, compensations);
+                               : at::nullopt,
+            sh0,
+            shN,
+            campos,
+            sh_degree,
+            eval_sh ? at::optional<at::Tensor>(colors) : at::nullopt);
+        return std::make_tuple(radii, means2d, depths, conics, compensations, colors);
     }
 
 } // namespace gsplat
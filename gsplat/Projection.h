@@ -32,11 +32,17 @@ namespace gsplat {
         const at::optional<at::Tensor> tangential_coeffs, // [C, 2] optional
         const at::optional<at::Tensor> thin_prism_coeffs, // [C, 2] optional
         // outputs
-        at::Tensor radii,                      // [C, N, 2]
-        at::Tensor means2d,                    // [C, N, 2]
-        at::Tensor depths,                     // [C, N]
-        at::Tensor conics,                     // [C, N, 3]
-        at::optional<at::Tensor> compensations // [C, N] optional
+        at::Tensor radii,                       // [C, N, 2]
+        at::Tensor means2d,                     // [C, N, 2]
+        at::Tensor depths,                      // [C, N]
+        at::Tensor conics,                      // [C, N, 3]
+        at::optional<at::Tensor> compensations, // [C, N] optional
+        // SH colors of the surviving Gaussians
+        const at::optional<at::Tensor> sh0,    // [N, 1, 3] optional
+        const at::optional<at::Tensor> shN,    // [N, K-1, 3] optional
+        const at::optional<at::Tensor> campos, // [C, 3] optional
+        const uint32_t sh_degree,
+        at::optional<at::Tensor> colors // [C, N, 3] optional
     );
 
 } // namespace gsplat
@@ -3,17 +3,19 @@
 #include <ATen/cuda/Atomic.cuh>
 #include <c10/cuda/CUDAStream.h>
 #include <cooperative_groups.h>
+#include <type_traits>
 
 #include "Cameras.cuh"
 #include "Common.h"
 #include "Projection.h"
+#include "SphericalHarmonics.cuh"
 #include "Utils.cuh"
 
 namespace gsplat {
 
     namespace cg = cooperative_groups;
 
-    template <typename scalar_t>
+    template <typename scalar_t, typename sh_t>
     __global__ void projection_ut_3dgs_fused_kernel(
         const uint32_t C,
         const uint32_t N,
@@ -41,8 +43,15 @@ namespace gsplat {
         int32_t* __restrict__ radii,         // [C, N, 2]
         scalar_t* __restrict__ means2d,      // [C, N, 2]
         scalar_t* __restrict__ depths,       // [C, N]
-        scalar_t* __restrict__ conics,       // [C, N, 3]
-        scalar_t* __restrict__ compensations // [C, N] optional
+        scalar_t* __restrict__ conics,        // [C, N, 3]
+        scalar_t* __restrict__ compensations, // [C, N] optional
+        // SH colors, evaluated when colors is set
+        const float* __restrict__ sh0,    // [N, 1, 3]
+        const sh_t* __restrict__ shN,     // [N, K-1, 3]
+        const float* __restrict__ campos, // [C, 3]
+        const uint32_t K,
+        const uint32_t sh_degree,
+        scalar_t* __restrict__ colors // [C, N, 3] optional
     ) {
         // parallelize over C * N.
         uint32_t idx = cg::this_grid().thread_rank();
@@ -200,6 +209,15 @@ namespace gsplat {
         if (compensations != nullptr) {
             compensations[idx] = compensation;
         }
+        if (colors != nullptr) {
+            // only Gaussians that survived culling pay for the SH evaluation
+            const vec3 dir = mean - glm::make_vec3(campos + cid * 3);
+            const SplitSHCoefficients<sh_t> coeffs{sh0 + gid * 3, shN + gid * (K - 1) * 3};
+#pragma unroll
+            for (uint32_t c = 0; c < 3; ++c) {
+                sh_coeffs_to_color_fast(sh_degree, c, dir, coeffs, colors + idx * 3);
+            }
+        }
     }
 
     void launch_projection_ut_3dgs_fused_kernel(
@@ -225,11 +243,17 @@ namespace gsplat {
         const at::optional<at::Tensor> tangential_coeffs, // [C, 2] optional
         const at::optional<at::Tensor> thin_prism_coeffs, // [C, 2] optional
         // outputs
-        at::Tensor radii,                      // [C, N, 2]
-        at::Tensor means2d,                    // [C, N, 2]
-        at::Tensor depths,                     // [C, N]
-        at::Tensor conics,                     // [C, N, 3]
-        at::optional<at::Tensor> compensations // [C, N] optional
+        at::Tensor radii,                       // [C, N, 2]
+        at::Tensor means2d,                     // [C, N, 2]
+        at::Tensor depths,                      // [C, N]
+        at::Tensor conics,                      // [C, N, 3]
+        at::optional<at::Tensor> compensations, // [C, N] optional
+        // SH colors of the surviving Gaussians
+        const at::optional<at::Tensor> sh0,    // [N, 1, 3] optional
+        const at::optional<at::Tensor> shN,    // [N, K-1, 3] optional
+        const at::optional<at::Tensor> campos, // [C, 3] optional
+        const uint32_t sh_degree,
+        at::optional<at::Tensor> colors // [C, N, 3] optional
     ) {
         uint32_t N = means.size(0); // number of gaussians
         uint32_t C = Ks.size(0);    // number of cameras
@@ -244,46 +268,64 @@ namespace gsplat {
             return;
         }
 
-        projection_ut_3dgs_fused_kernel<float>
-            <<<grid,
-               threads,
-               shmem_size,
-               at::cuda::getCurrentCUDAStream()>>>(
-                C,
-                N,
-                means.data_ptr<float>(),
-                quats.data_ptr<float>(),
-                scales.data_ptr<float>(),
-                opacities.has_value() ? opacities.value().data_ptr<float>() : nullptr,
-                viewmats0.data_ptr<float>(),
-                viewmats1.has_value() ? viewmats1.value().data_ptr<float>() : nullptr,
-                Ks.data_ptr<float>(),
-                image_width,
-                image_height,
-                eps2d,
-                near_plane,
-                far_plane,
-                radius_clip,
-                camera_model,
-                // uncented transform
-                ut_params,
-                rs_type,
-                radial_coeffs.has_value()
-                    ? radial_coeffs.value().data_ptr<float>()
-                    : nullptr,
-                tangential_coeffs.has_value()
-                    ? tangential_coeffs.value().data_ptr<float>()
-                    : nullptr,
-                thin_prism_coeffs.has_value()
-                    ? thin_prism_coeffs.value().data_ptr<float>()
-                    : nullptr,
-                radii.data_ptr<int32_t>(),
-                means2d.data_ptr<float>(),
-                depths.data_ptr<float>(),
-                conics.data_ptr<float>(),
-                compensations.has_value()
-                    ? compensations.value().data_ptr<float>()
-                    : nullptr);
+        const uint32_t K = shN.has_value() ? shN.value().size(1) + 1 : 1;
+        auto launch = [&](const auto* shN_ptr) {
+            using sh_t = std::remove_cv_t<std::remove_pointer_t<decltype(shN_ptr)>>;
+            projection_ut_3dgs_fused_kernel<float, sh_t>
+                <<<grid,
+                   threads,
+                   shmem_size,
+                   at::cuda::getCurrentCUDAStream()>>>(
+                    C,
+                    N,
+                    means.data_ptr<float>(),
+                    quats.data_ptr<float>(),
+                    scales.data_ptr<float>(),
+                    opacities.has_value() ? opacities.value().data_ptr<float>() : nullptr,
+                    viewmats0.data_ptr<float>(),
+                    viewmats1.has_value() ? viewmats1.value().data_ptr<float>() : nullptr,
+                    Ks.data_ptr<float>(),
+                    image_width,
+                    image_height,
+                    eps2d,
+                    near_plane,
+                    far_plane,
+                    radius_clip,
+                    camera_model,
+                    // uncented transform
+                    ut_params,
+                    rs_type,
+                    radial_coeffs.has_value()
+                        ? radial_coeffs.value().data_ptr<float>()
+                        : nullptr,
+                    tangential_coeffs.has_value()
+                        ? tangential_coeffs.value().data_ptr<float>()
+                        : nullptr,
+                    thin_prism_coeffs.has_value()
+                        ? thin_prism_coeffs.value().data_ptr<float>()
+                        : nullptr,
+                    radii.data_ptr<int32_t>(),
+                    means2d.data_ptr<float>(),
+                    depths.data_ptr<float>(),
+                    conics.data_ptr<float>(),
+                    compensations.has_value()
+                        ? compensations.value().data_ptr<float>()
+                        : nullptr,
+                    sh0.has_value() ? sh0.value().data_ptr<float>() : nullptr,
+                    shN_ptr,
+                    campos.has_value() ? campos.value().data_ptr<float>() : nullptr,
+                    K,
+                    sh_degree,
+                    colors.has_value() ? colors.value().data_ptr<float>() : nullptr);
+        };
+        const auto sh_storage = shN.has_value() ? shN.value().scalar_type() : at::kFloat;
+        if (sh_storage == at::kHalf) {
+            launch(reinterpret_cast<const __half*>(shN.value().data_ptr()));
+        } else if (sh_storage == at::kBFloat16) {
+            launch(reinterpret_cast<const __nv_bfloat16*>(shN.value().data_ptr()));
+        } else {
+            launch(shN.has_value() ? shN.value().data_ptr<float>() : static_cast<const float*>(nullptr));
+        }
     }
 
 } // namespace gsplat
@@ -43,7 +43,8 @@ namespace gsplat {
         const at::optional<at::Tensor> thin_prism_coeffs, // [C, 2] optional
         // intersections
         const at::Tensor tile_offsets, // [C, tile_height, tile_width]
-        const at::Tensor flatten_ids   // [n_isects]
+        const at::Tensor flatten_ids,  // [n_isects]
+        const at::optional<at::Tensor> gaussian_ids // [nnz]
     ) {
         DEVICE_GUARD(means);
         CHECK_INPUT(means);
@@ -59,6 +60,10 @@ namespace gsplat {
         if (masks.has_value()) {
             CHECK_INPUT(masks.value());
         }
+        if (opacities.dim() == 1) {
+            TORCH_CHECK(gaussian_ids.has_value(), "When packed is set, gaussian_ids must be provided.");
+            CHECK_INPUT(gaussian_ids.value());
+        }
 
         uint32_t C = tile_offsets.size(0); // number of cameras
         uint32_t channels = colors.size(-1);
@@ -95,6 +100,7 @@ namespace gsplat {
             thin_prism_coeffs,                                    \
             tile_offsets,                                         \
             flatten_ids,                                          \
+            gaussian_ids,                                         \
             renders,                                              \
             alphas,                                               \
             last_ids);                                            \
@@ -164,7 +170,8 @@ namespace gsplat {
         const at::Tensor last_ids,      // [C, image_height, image_width]
         // gradients of outputs
         const at::Tensor v_render_colors, // [C, image_height, image_width, 3]
-        const at::Tensor v_render_alphas  // [C, image_height, image_width, 1]
+        const at::Tensor v_render_alphas, // [C, image_height, image_width, 1]
+        const at::optional<at::Tensor> gaussian_ids // [nnz]
     ) {
         DEVICE_GUARD(means);
         CHECK_INPUT(means);
@@ -184,6 +191,10 @@ namespace gsplat {
         if (masks.has_value()) {
             CHECK_INPUT(masks.value());
         }
+        if (opacities.dim() == 1) {
+            TORCH_CHECK(gaussian_ids.has_value(), "When packed is set, gaussian_ids must be provided.");
+            CHECK_INPUT(gaussian_ids.value());
+        }
 
         uint32_t channels = colors.size(-1);
 
@@ -217,6 +228,7 @@ namespace gsplat {
             thin_prism_coeffs,                                    \
             tile_offsets,                                         \
             flatten_ids,                                          \
+            gaussian_ids,                                         \
             render_alphas,                                        \
             last_ids,                                             \
             v_render_colors,                                      \
@@ -125,6 +125,7 @@ namespace gsplat {
         // intersections
         const at::Tensor tile_offsets, // [C, tile_height, tile_width]
         const at::Tensor flatten_ids,  // [n_isects]
+        const at::optional<at::Tensor> gaussian_ids, // [nnz] packed only
         // outputs
         at::Tensor renders, // [C, image_height, image_width, channels]
         at::Tensor alphas,  // [C, image_height, image_width]
@@ -159,6 +160,7 @@ namespace gsplat {
         // intersections
         const at::Tensor tile_offsets, // [C, tile_height, tile_width]
         const at::Tensor flatten_ids,  // [n_isects]
+        const at::optional<at::Tensor> gaussian_ids, // [nnz] packed only
         // forward outputs
         const at::Tensor render_alphas, // [C, image_height, image_width, 1]
         const at::Tensor last_ids,      // [C, image_height, image_width]
@@ -46,6 +46,7 @@ namespace gsplat {
         // intersections
         const int32_t* __restrict__ tile_offsets, // [C, tile_height, tile_width]
         const int32_t* __restrict__ flatten_ids,  // [n_isects]
+        const int64_t* __restrict__ gaussian_ids, // [nnz] packed only
         // fwd outputs
         const scalar_t* __restrict__ render_alphas, // [C, image_height, image_width, 1]
         const int32_t* __restrict__ last_ids,       // [C, image_height, image_width]
@@ -208,14 +209,14 @@ namespace gsplat {
             const int32_t batch_size = min(block_size, batch_end + 1 - range_start);
             const int32_t idx = batch_end - tr;
             if (idx >= range_start) {
-                // TODO: only support 1 camera for now so it is ok to abuse the index.
                 int32_t g = flatten_ids[idx]; // flatten index in [C * N] or [nnz]
                 id_batch[tr] = g;
-                const vec3 xyz = means[g];
+                const int64_t gid = packed ? gaussian_ids[g] : g % N; // gaussian id
+                const vec3 xyz = means[gid];
                 const float opac = opacities[g];
                 xyz_opacity_batch[tr] = {xyz.x, xyz.y, xyz.z, opac};
-                scale_batch[tr] = scales[g];
-                quat_batch[tr] = quats[g];
+                scale_batch[tr] = scales[gid];
+                quat_batch[tr] = quats[gid];
 #pragma unroll
                 for (uint32_t k = 0; k < CDIM; ++k) {
                     rgbs_batch[tr * CDIM + k] = colors[g * CDIM + k];
@@ -344,23 +345,24 @@ namespace gsplat {
                 warpSum(v_opacity_local, warp);
                 if (warp.thread_rank() == 0) {
                     int32_t g = id_batch[t]; // flatten index in [C * N] or [nnz]
+                    const int64_t gid = packed ? gaussian_ids[g] : g % N; // gaussian id
                     float* v_rgb_ptr = (float*)(v_colors) + CDIM * g;
 #pragma unroll
                     for (uint32_t k = 0; k < CDIM; ++k) {
                         gpuAtomicAdd(v_rgb_ptr + k, v_rgb_local[k]);
                     }
 
-                    float* v_mean_ptr = (float*)(v_means) + 3 * g;
+                    float* v_mean_ptr = (float*)(v_means) + 3 * gid;
                     gpuAtomicAdd(v_mean_ptr, v_mean_local.x);
                     gpuAtomicAdd(v_mean_ptr + 1, v_mean_local.y);
                     gpuAtomicAdd(v_mean_ptr + 2, v_mean_local.z);
 
-                    float* v_scale_ptr = (float*)(v_scales) + 3 * g;
+                    float* v_scale_ptr = (float*)(v_scales) + 3 * gid;
                     gpuAtomicAdd(v_scale_ptr, v_scale_local.x);
                     gpuAtomicAdd(v_scale_ptr + 1, v_scale_local.y);
                     gpuAtomicAdd(v_scale_ptr + 2, v_scale_local.z);
 
-                    float* v_quat_ptr = (float*)(v_quats) + 4 * g;
+                    float* v_quat_ptr = (float*)(v_quats) + 4 * gid;
                     gpuAtomicAdd(v_quat_ptr, v_quat_local.x);
                     gpuAtomicAdd(v_quat_ptr + 1, v_quat_local.y);
                     gpuAtomicAdd(v_quat_ptr + 2, v_quat_local.z);
@@ -400,6 +402,7 @@ namespace gsplat {
         // intersections
         const at::Tensor tile_offsets, // [C, tile_height, tile_width]
         const at::Tensor flatten_ids,  // [n_isects]
+        const at::optional<at::Tensor> gaussian_ids, // [nnz] packed only
         // forward outputs
         const at::Tensor render_alphas, // [C, image_height, image_width, 1]
         const at::Tensor last_ids,      // [C, image_height, image_width]
@@ -414,10 +417,9 @@ namespace gsplat {
         at::Tensor v_opacities // [C, N] or [nnz]
     ) {
         bool packed = opacities.dim() == 1;
-        assert(packed == false); // only support non-packed for now
 
-        uint32_t C = tile_offsets.size(0);       // number of cameras
-        uint32_t N = packed ? 0 : means.size(0); // number of gaussians
+        uint32_t C = tile_offsets.size(0); // number of cameras
+        uint32_t N = means.size(0);        // number of gaussians
         uint32_t tile_height = tile_offsets.size(1);
         uint32_t tile_width = tile_offsets.size(2);
         uint32_t n_isects = flatten_ids.size(0);
@@ -488,6 +490,7 @@ namespace gsplat {
                 // intersections
                 tile_offsets.data_ptr<int32_t>(),
                 flatten_ids.data_ptr<int32_t>(),
+                packed ? gaussian_ids.value().data_ptr<int64_t>() : nullptr,
                 render_alphas.data_ptr<float>(),
                 last_ids.data_ptr<int32_t>(),
                 v_render_colors.data_ptr<float>(),
@@ -526,6 +529,7 @@ namespace gsplat {
         const at::optional<at::Tensor> thin_prism_coeffs,                      \
         const at::Tensor tile_offsets,                                         \
         const at::Tensor flatten_ids,                                          \
+        const at::optional<at::Tensor> gaussian_ids,                           \
         const at::Tensor render_alphas,                                        \
         const at::Tensor last_ids,                                             \
         const at::Tensor v_render_colors,                                      \
@@ -48,6 +48,7 @@ namespace gsplat {
         // intersections
         const int32_t* __restrict__ tile_offsets, // [C, tile_height, tile_width]
         const int32_t* __restrict__ flatten_ids,  // [n_isects]
+        const int64_t* __restrict__ gaussian_ids, // [nnz] packed only
         scalar_t* __restrict__ render_colors,     // [C, image_height, image_width, CDIM]
         scalar_t* __restrict__ render_alphas,     // [C, image_height, image_width, 1]
         int32_t* __restrict__ last_ids            // [C, image_height, image_width]
@@ -194,15 +195,15 @@ namespace gsplat {
             uint32_t batch_start = range_start + block_size * b;
             uint32_t idx = batch_start + tr;
             if (idx < range_end) {
-                // TODO: only support 1 camera for now so it is ok to abuse the index.
                 int32_t g = flatten_ids[idx]; // flatten index in [C * N] or [nnz]
                 id_batch[tr] = g;
-                const vec3 xyz = means[g];
+                const int64_t gid = packed ? gaussian_ids[g] : g % N; // gaussian id
+                const vec3 xyz = means[gid];
                 const float opac = opacities[g];
                 xyz_opacity_batch[tr] = {xyz.x, xyz.y, xyz.z, opac};
 
-                const vec4 quat = quats[g];
-                vec3 scale = scales[g];
+                const vec4 quat = quats[gid];
+                vec3 scale = scales[gid];
 
                 mat3 R = quat_to_rotmat(quat);
                 mat3 S = mat3(
@@ -306,6 +307,7 @@ namespace gsplat {
         // intersections
         const at::Tensor tile_offsets, // [C, tile_height, tile_width]
         const at::Tensor flatten_ids,  // [n_isects]
+        const at::optional<at::Tensor> gaussian_ids, // [nnz] packed only
         // outputs
         at::Tensor renders, // [C, image_height, image_width, channels]
         at::Tensor alphas,  // [C, image_height, image_width]
@@ -314,10 +316,9 @@ namespace gsplat {
         // Note: quats need to be normalized before passing in.
 
         bool packed = opacities.dim() == 1;
-        assert(packed == false); // only support non-packed for now
 
-        uint32_t C = tile_offsets.size(0);       // number of cameras
-        uint32_t N = packed ? 0 : means.size(0); // number of gaussians
+        uint32_t C = tile_offsets.size(0); // number of cameras
+        uint32_t N = means.size(0);        // number of gaussians
         uint32_t tile_height = tile_offsets.size(1);
         uint32_t tile_width = tile_offsets.size(2);
         uint32_t n_isects = flatten_ids.size(0);
@@ -383,6 +384,7 @@ namespace gsplat {
                 // intersections
                 tile_offsets.data_ptr<int32_t>(),
                 flatten_ids.data_ptr<int32_t>(),
+                packed ? gaussian_ids.value().data_ptr<int64_t>() : nullptr,
                 renders.data_ptr<float>(),
                 alphas.data_ptr<float>(),
                 last_ids.data_ptr<int32_t>());
@@ -414,6 +416,7 @@ namespace gsplat {
         const at::optional<at::Tensor> thin_prism_coeffs,                      \
         const at::Tensor tile_offsets,                                         \
         const at::Tensor flatten_ids,                                          \
+        const at::optional<at::Tensor> gaussian_ids,                           \
         const at::Tensor renders,                                              \
         const at::Tensor alphas,                                               \
         const at::Tensor last_ids);
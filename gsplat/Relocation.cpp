@@ -31,6 +31,68 @@ namespace gsplat {
         return std::make_tuple(new_opacities, new_scales);
     }
 
+    namespace {
+        // The kernels write through raw pointers, the version counter tells caches keyed on it the values moved
+        void bump_versions(const std::vector<at::Tensor>& tensors) {
+            for (const auto& tensor : tensors) {
+                tensor.unsafeGetTensorImpl()->bump_version();
+            }
+        }
+    } // namespace
+
+    void relocate_rows(
+        at::Tensor src_indices, // [M] int64
+        at::Tensor dst_indices, // [M] int64
+        const std::vector<at::Tensor>& copied,
+        const std::vector<at::Tensor>& zeroed) {
+        DEVICE_GUARD(src_indices);
+        CHECK_INPUT(src_indices);
+        CHECK_INPUT(dst_indices);
+        TORCH_CHECK(src_indices.scalar_type() == at::kLong && dst_indices.scalar_type() == at::kLong,
+                    "relocate_rows indices must be int64");
+        TORCH_CHECK(src_indices.numel() == dst_indices.numel(), "relocate_rows needs as many src as dst indices");
+        for (const auto& tensors : {std::cref(copied), std::cref(zeroed)}) {
+            for (const auto& tensor : tensors.get()) {
+                CHECK_INPUT(tensor);
+            }
+        }
+
+        launch_relocate_rows_kernel(src_indices, dst_indices, copied, zeroed);
+        bump_versions(copied);
+        bump_versions(zeroed);
+    }
+
+    void compact_rows(
+        at::Tensor keep_indices, // [M] int64
+        const std::vector<at::Tensor>& tensors) {
+        DEVICE_GUARD(keep_indices);
+        CHECK_INPUT(keep_indices);
+        TORCH_CHECK(keep_indices.scalar_type() == at::kLong, "compact_rows indices must be int64");
+        for (const auto& tensor : tensors) {
+            CHECK_INPUT(tensor);
+        }
+
+        launch_compact_rows_kernel(keep_indices, tensors);
+        bump_versions(tensors);
+    }
+
+    void reset_opacities(
+        at::Tensor raw_opacities, // [N] or [N, 1] float
+        const float max_raw_opacity,
+        const std::vector<at::Tensor>& moments) {
+        DEVICE_GUARD(raw_opacities);
+        CHECK_INPUT(raw_opacities);
+        TORCH_CHECK(raw_opacities.scalar_type() == at::kFloat, "reset_opacities needs float opacities");
+        for (const auto& moment : moments) {
+            CHECK_INPUT(moment);
+            TORCH_CHECK(moment.size(0) == raw_opacities.size(0), "reset_opacities needs moments of the same rows");
+        }
+
+        launch_reset_opacities_kernel(raw_opacities, max_raw_opacity, moments);
+        bump_versions({raw_opacities});
+        bump_versions(moments);
+    }
+
     void add_noise(
         at::Tensor raw_opacities, // [N]
         at::Tensor raw_scales,    // [N, 3]
@@ -47,6 +109,7 @@ namespace gsplat {
 
         launch_add_noise_kernel(
             raw_opacities, raw_scales, raw_quats, noise, means, current_lr);
+        bump_versions({means});
     }
 
 } // namespace gsplat
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
 namespace at {
     class Tensor;
@@ -20,6 +21,21 @@ namespace gsplat {
         at::Tensor new_scales     // [N, 3]
     );
 
+    void launch_relocate_rows_kernel(
+        at::Tensor src_indices,            // [M] int64
+        at::Tensor dst_indices,            // [M] int64
+        std::vector<at::Tensor> copied,    // rows dst <- src, any dtype
+        std::vector<at::Tensor> zeroed);   // rows at src set to 0, any dtype
+
+    void launch_compact_rows_kernel(
+        at::Tensor keep_indices,           // [M] int64, ascending
+        std::vector<at::Tensor> tensors);  // [N, ...] each, any dtype
+
+    void launch_reset_opacities_kernel(
+        at::Tensor raw_opacities,          // [N] or [N, 1] float
+        const float max_raw_opacity,
+        std::vector<at::Tensor> moments);  // [N, ...] each, any dtype, set to 0
+
     void launch_add_noise_kernel(
         at::Tensor raw_opacities, // [N]
         at::Tensor raw_scales,    // [N, 3]
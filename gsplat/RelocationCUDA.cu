@@ -85,6 +85,232 @@ namespace gsplat {
             });
     }
 
+    // Row tensors of one relocate_rows or compact_rows launch, flattened to words of the largest size that
+    // divides every row
+    constexpr int MAX_RELOCATED_TENSORS = 24;
+    struct RelocatedTensors {
+        char* data[MAX_RELOCATED_TENSORS];
+        int64_t row_words[MAX_RELOCATED_TENSORS];
+        int64_t word_offsets[MAX_RELOCATED_TENSORS + 1]; // prefix sum of row_words
+        bool zero[MAX_RELOCATED_TENSORS];
+        int count;
+    };
+
+    // One thread per word of the concatenated rows of one relocation, consecutive threads walk
+    // a row so both the gathers and the scatters coalesce
+    template <typename word_t>
+    __global__ void relocate_rows_kernel(
+        const int64_t M,
+        const int64_t* __restrict__ src_indices,
+        const int64_t* __restrict__ dst_indices,
+        const RelocatedTensors tensors) {
+        const int64_t words = tensors.word_offsets[tensors.count];
+        const int64_t idx = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+        if (idx >= M * words)
+            return;
+
+        const int64_t i = idx / words;
+        const int64_t w = idx % words;
+        int t = 0;
+        while (w >= tensors.word_offsets[t + 1]) {
+            ++t;
+        }
+        const int64_t word = w - tensors.word_offsets[t];
+        const int64_t row_words = tensors.row_words[t];
+        word_t* data = reinterpret_cast<word_t*>(tensors.data[t]);
+
+        const int64_t src = src_indices[i];
+        if (tensors.zero[t]) {
+            data[src * row_words + word] = word_t(0);
+        } else {
+            data[dst_indices[i] * row_words + word] = data[src * row_words + word];
+        }
+    }
+
+    // Describes tensors for the row kernels, words are 4 bytes unless a row (e.g. an odd count of
+    // fp16 sh coefficients) needs 2. Empty tensors are left out.
+    RelocatedTensors pack_row_tensors(const std::vector<std::pair<at::Tensor, bool>>& all, bool& rows_fit_u32) {
+        TORCH_CHECK(all.size() <= MAX_RELOCATED_TENSORS,
+                    "row kernels handle at most ", MAX_RELOCATED_TENSORS, " tensors");
+        rows_fit_u32 = true;
+        for (const auto& [tensor, zero] : all) {
+            const int64_t row_bytes = tensor.size(0) > 0 ? tensor.nbytes() / tensor.size(0) : 0;
+            TORCH_CHECK(row_bytes % 2 == 0, "row kernels need rows of whole 16 bit words");
+            rows_fit_u32 &= row_bytes % 4 == 0;
+        }
+        const int64_t word_bytes = rows_fit_u32 ? 4 : 2;
+
+        RelocatedTensors tensors{};
+        tensors.count = 0;
+        tensors.word_offsets[0] = 0;
+        for (const auto& [tensor, zero] : all) {
+            if (tensor.numel() == 0) {
+                continue;
+            }
+            const int t = tensors.count++;
+            tensors.data[t] = static_cast<char*>(tensor.data_ptr());
+            tensors.row_words[t] = tensor.nbytes() / tensor.size(0) / word_bytes;
+            tensors.word_offsets[t + 1] = tensors.word_offsets[t] + tensors.row_words[t];
+            tensors.zero[t] = zero;
+        }
+        return tensors;
+    }
+
+    void launch_relocate_rows_kernel(
+        at::Tensor src_indices,         // [M] int64
+        at::Tensor dst_indices,         // [M] int64
+        std::vector<at::Tensor> copied, // rows dst <- src, any dtype
+        std::vector<at::Tensor> zeroed  // rows at src set to 0, any dtype
+    ) {
+        const int64_t M = src_indices.numel();
+        if (M == 0) {
+            return;
+        }
+
+        std::vector<std::pair<at::Tensor, bool>> all;
+        for (auto& tensor : copied) {
+            all.emplace_back(tensor, false);
+        }
+        for (auto& tensor : zeroed) {
+            all.emplace_back(tensor, true);
+        }
+        bool rows_fit_u32;
+        const RelocatedTensors tensors = pack_row_tensors(all, rows_fit_u32);
+        if (tensors.count == 0) {
+            return;
+        }
+
+        const int64_t n_elements = M * tensors.word_offsets[tensors.count];
+        dim3 threads(256);
+        dim3 grid((n_elements + threads.x - 1) / threads.x);
+        const auto stream = at::cuda::getCurrentCUDAStream();
+        if (rows_fit_u32) {
+            relocate_rows_kernel<uint32_t><<<grid, threads, 0, stream>>>(
+                M, src_indices.data_ptr<int64_t>(), dst_indices.data_ptr<int64_t>(), tensors);
+        } else {
+            relocate_rows_kernel<uint16_t><<<grid, threads, 0, stream>>>(
+                M, src_indices.data_ptr<int64_t>(), dst_indices.data_ptr<int64_t>(), tensors);
+        }
+    }
+
+    // Compaction moves rows towards the front and a kept row may be read after another thread
+    // overwrote it, so the kept rows of all tensors go through one packed scratch buffer: the
+    // gather pass (to_scratch) reads tensor[keep[i]], the second pass writes row i back
+    template <typename word_t, bool to_scratch>
+    __global__ void compact_rows_kernel(
+        const int64_t M,
+        const int64_t* __restrict__ keep_indices,
+        const RelocatedTensors tensors,
+        word_t* __restrict__ scratch) {
+        const int64_t words = tensors.word_offsets[tensors.count];
+        const int64_t idx = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+        if (idx >= M * words)
+            return;
+
+        const int64_t i = idx / words;
+        const int64_t w = idx % words;
+        int t = 0;
+        while (w >= tensors.word_offsets[t + 1]) {
+            ++t;
+        }
+        const int64_t word = w - tensors.word_offsets[t];
+        const int64_t row_words = tensors.row_words[t];
+        word_t* data = reinterpret_cast<word_t*>(tensors.data[t]);
+        word_t* packed = scratch + M * tensors.word_offsets[t] + i * row_words + word;
+
+        if constexpr (to_scratch) {
+            *packed = data[keep_indices[i] * row_words + word];
+        } else {
+            data[i * row_words + word] = *packed;
+        }
+    }
+
+    void launch_compact_rows_kernel(
+        at::Tensor keep_indices,         // [M] int64, ascending
+        std::vector<at::Tensor> tensors  // [N, ...] each, any dtype
+    ) {
+        const int64_t M = keep_indices.numel();
+        if (M == 0) {
+            return;
+        }
+
+        std::vector<std::pair<at::Tensor, bool>> all;
+        for (auto& tensor : tensors) {
+            all.emplace_back(tensor, false);
+        }
+        bool rows_fit_u32;
+        const RelocatedTensors packed = pack_row_tensors(all, rows_fit_u32);
+        if (packed.count == 0) {
+            return;
+        }
+
+        const int64_t n_elements = M * packed.word_offsets[packed.count];
+        // int32 words, two int16 words each when the rows only divide into 16 bit words
+        const auto scratch = at::empty({rows_fit_u32 ? n_elements : (n_elements + 1) / 2},
+                                       keep_indices.options().dtype(at::kInt));
+        dim3 threads(256);
+        dim3 grid((n_elements + threads.x - 1) / threads.x);
+        const auto stream = at::cuda::getCurrentCUDAStream();
+        const int64_t* keep = keep_indices.data_ptr<int64_t>();
+        if (rows_fit_u32) {
+            auto* words = reinterpret_cast<uint32_t*>(scratch.data_ptr<int32_t>());
+            compact_rows_kernel<uint32_t, true><<<grid, threads, 0, stream>>>(M, keep, packed, words);
+            compact_rows_kernel<uint32_t, false><<<grid, threads, 0, stream>>>(M, keep, packed, words);
+        } else {
+            auto* words = reinterpret_cast<uint16_t*>(scratch.data_ptr<int32_t>());
+            compact_rows_kernel<uint16_t, true><<<grid, threads, 0, stream>>>(M, keep, packed, words);
+            compact_rows_kernel<uint16_t, false><<<grid, threads, 0, stream>>>(M, keep, packed, words);
+        }
+    }
+
+    // One thread per Gaussian: clamps its raw opacity and zeros its row of every moment
+    template <typename word_t>
+    __global__ void reset_opacities_kernel(
+        const int64_t N,
+        float* __restrict__ raw_opacities,
+        const float max_raw_opacity,
+        const RelocatedTensors moments) {
+        const int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+        if (i >= N)
+            return;
+
+        raw_opacities[i] = fminf(raw_opacities[i], max_raw_opacity);
+        for (int t = 0; t < moments.count; ++t) {
+            word_t* data = reinterpret_cast<word_t*>(moments.data[t]) + i * moments.row_words[t];
+            for (int64_t word = 0; word < moments.row_words[t]; ++word) {
+                data[word] = word_t(0);
+            }
+        }
+    }
+
+    void launch_reset_opacities_kernel(
+        at::Tensor raw_opacities,        // [N] or [N, 1] float
+        const float max_raw_opacity,
+        std::vector<at::Tensor> moments  // [N, ...] each, any dtype, set to 0
+    ) {
+        const int64_t N = raw_opacities.size(0);
+        if (N == 0) {
+            return;
+        }
+
+        std::vector<std::pair<at::Tensor, bool>> all;
+        for (auto& moment : moments) {
+            all.emplace_back(moment, true);
+        }
+        bool rows_fit_u32;
+        const RelocatedTensors packed = pack_row_tensors(all, rows_fit_u32);
+
+        dim3 threads(256);
+        dim3 grid((N + threads.x - 1) / threads.x);
+        const auto stream = at::cuda::getCurrentCUDAStream();
+        float* opacities = raw_opacities.data_ptr<float>();
+        if (rows_fit_u32) {
+            reset_opacities_kernel<uint32_t><<<grid, threads, 0, stream>>>(N, opacities, max_raw_opacity, packed);
+        } else {
+            reset_opacities_kernel<uint16_t><<<grid, threads, 0, stream>>>(N, opacities, max_raw_opacity, packed);
+        }
+    }
+
     inline __device__ mat3 raw_quat_to_rotmat(const vec4 raw_quat) {
         float w = raw_quat[0], x = raw_quat[1], y = raw_quat[2], z = raw_quat[3];
         // normalize
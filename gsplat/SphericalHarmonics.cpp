@@ -74,4 +74,48 @@ namespace gsplat {
         return std::make_tuple(v_coeffs, v_dirs); // [..., K, 3], [..., 3]
     }
 
+    std::tuple<at::Tensor, at::Tensor, at::Tensor> spherical_harmonics_split_bwd(
+        const uint32_t degrees_to_use,
+        const at::Tensor means,    // [N, 3]
+        const at::Tensor campos,   // [3]
+        const at::Tensor sh0,      // [N, 1, 3]
+        const at::Tensor shN,      // [N, K-1, 3]
+        const at::Tensor masks,    // [N]
+        const at::Tensor v_colors, // [N, 3]
+        bool compute_v_means) {
+        DEVICE_GUARD(means);
+        CHECK_INPUT(means);
+        CHECK_INPUT(campos);
+        CHECK_INPUT(sh0);
+        CHECK_INPUT(shN);
+        CHECK_INPUT(masks);
+        CHECK_INPUT(v_colors);
+        const int64_t N = means.size(0);
+        TORCH_CHECK(campos.numel() == 3, "campos must hold one camera position");
+        TORCH_CHECK(sh0.size(0) == N && sh0.size(1) == 1 && sh0.size(2) == 3, "sh0 must be [N, 1, 3]");
+        TORCH_CHECK(shN.size(0) == N && shN.size(2) == 3, "shN must be [N, K-1, 3]");
+        TORCH_CHECK(masks.numel() == N && v_colors.numel() == N * 3, "masks and v_colors must hold one entry per Gaussian");
+
+        // masked Gaussians are skipped by the kernel
+        at::Tensor v_sh0 = at::zeros_like(sh0);
+        at::Tensor v_shN = at::zeros(shN.sizes(), sh0.options());
+        at::Tensor v_means;
+        if (compute_v_means) {
+            v_means = at::zeros_like(means);
+        }
+
+        launch_spherical_harmonics_split_bwd_kernel(
+            degrees_to_use,
+            means,
+            campos,
+            sh0,
+            shN,
+            masks,
+            v_colors,
+            v_sh0,
+            v_shN,
+            v_means.defined() ? at::optional<at::Tensor>(v_means) : c10::nullopt);
+        return std::make_tuple(v_sh0, v_shN, v_means); // [N, 1, 3], [N, K-1, 3] fp32, [N, 3]
+    }
+
 } // namespace gsplat
@@ -30,4 +30,21 @@ namespace gsplat {
         at::optional<at::Tensor> v_dirs // [..., 3]
     );
 
+    // Vjp of the colors sh_coeffs_to_color_fast evaluates from separate sh0 and shN for the
+    // directions means - campos of one camera, without concatenating the coefficients
+    void launch_spherical_harmonics_split_bwd_kernel(
+        // inputs
+        const uint32_t degrees_to_use,
+        const at::Tensor means,    // [N, 3]
+        const at::Tensor campos,   // [3]
+        const at::Tensor sh0,      // [N, 1, 3]
+        const at::Tensor shN,      // [N, K-1, 3]
+        const at::Tensor masks,    // [N]
+        const at::Tensor v_colors, // [N, 3]
+        // outputs
+        at::Tensor v_sh0,                // [N, 1, 3]
+        at::Tensor v_shN,                // [N, K-1, 3]
+        at::optional<at::Tensor> v_means // [N, 3]
+    );
+
 } // namespace gsplat
\ No newline at end of file
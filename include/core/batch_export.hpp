@@ -0,0 +1,30 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/parameters.hpp"
+#include <cstddef>
+#include <expected>
+#include <string>
+
+namespace gs {
+    namespace core {
+
+        struct BatchExportSummary {
+            size_t succeeded = 0;
+            size_t failed = 0;
+        };
+
+        // Converts one splat file, or every loadable splat file directly inside a directory,
+        // without the viewer: load, transform, crop, prune by opacity, then write each requested
+        // format to output_dir under the input's stem. Up to params.jobs files are in flight at
+        // once, each on its own CUDA stream. A file that fails is logged and counted, the others
+        // still run; only an unusable input or output location is an error.
+        std::expected<BatchExportSummary, std::string> run_batch_export(
+            const param::BatchExportParameters& params,
+            const param::OptimizationParameters& optimization);
+
+    } // namespace core
+} // namespace gs
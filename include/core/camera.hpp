@@ -8,8 +8,10 @@
 #include <c10/cuda/CUDAStream.h>
 #include <filesystem>
 #include <future>
+#include <memory>
 #include <string>
 #include <torch/torch.h>
+#include <vector>
 
 namespace gs {
 
@@ -42,9 +44,34 @@ namespace gs {
         // Load image from disk and return it
         torch::Tensor load_and_get_image(int resize_factor = -1, int max_width = 3840);
 
+        // Same without recording the image size, for loader threads sharing the camera
+        torch::Tensor load_image(int resize_factor = -1, int max_width = 3840) const;
+
         // Load image from disk just to populate _image_width/_image_height
         void load_image_size(int resize_factor = -1, int max_width = 3840);
 
+        // Set the loaded image size when the image was decoded outside of load_and_get_image
+        void update_image_dimensions(int width, int height) {
+            _image_width = width;
+            _image_height = height;
+        }
+
+        // Narrow the image to the window [x, x + width) x [y, y + height) of the current image size:
+        // the intrinsics are frozen at that size and the principal point shifts by (-x, -y)
+        void crop_image(int x, int y, int width, int height);
+
+        // Source image (width, height, channels), opened once on first use and cached.
+        // Not safe for concurrent first use, probe_source_image_info() first when sharing cameras.
+        std::tuple<int, int, int> source_image_info() const;
+
+        // Seed the cached source info (e.g. from the project file) so the image is never opened
+        void set_source_image_info(int width, int height, int channels) {
+            _source_width = width;
+            _source_height = height;
+            _source_channels = channels;
+        }
+        bool has_source_image_info() const noexcept { return _source_channels > 0; }
+
         // Get number of bytes in the image file
         size_t get_num_bytes_from_file(int resize_factor = -1, int max_width = 3840) const;
         size_t get_num_bytes_from_file() const;
@@ -75,6 +102,12 @@ namespace gs {
         gsplat::CameraModelType camera_model_type() const noexcept { return _camera_model_type; }
         const std::string& image_name() const noexcept { return _image_name; }
         const std::filesystem::path& image_path() const noexcept { return _image_path; }
+        // Single-channel image of the pixels that hold scene content, empty when every pixel does
+        const std::filesystem::path& valid_mask_path() const noexcept { return _valid_mask_path; }
+        void set_valid_mask_path(const std::filesystem::path& path) { _valid_mask_path = path; }
+        // Single-channel user mask, zero where the loss ignores the image (moving objects, sky), empty without one
+        const std::filesystem::path& mask_path() const noexcept { return _mask_path; }
+        void set_mask_path(const std::filesystem::path& path) { _mask_path = path; }
         int uid() const noexcept { return _uid; }
 
         float FoVx() const noexcept { return _FoVx; }
@@ -101,11 +134,18 @@ namespace gs {
         // Image info
         std::string _image_name;
         std::filesystem::path _image_path;
+        std::filesystem::path _valid_mask_path;
+        std::filesystem::path _mask_path;
         int _camera_width = 0;
         int _camera_height = 0;
         int _image_width = 0;
         int _image_height = 0;
 
+        // Cached source_image_info(), 0 until probed
+        mutable int _source_width = 0;
+        mutable int _source_height = 0;
+        mutable int _source_channels = 0;
+
         // GPU tensors (computed on demand)
         torch::Tensor _world_view_transform;
         torch::Tensor _cam_position;
@@ -113,6 +153,10 @@ namespace gs {
         // CUDA stream for async operations
         at::cuda::CUDAStream _stream = at::cuda::getStreamFromPool(false);
     };
+    // Fills source_image_info() for every camera that doesn't have it yet, opening at most
+    // max_threads images at a time. Failures are logged and left for the lazy path to report.
+    void probe_source_image_info(const std::vector<std::shared_ptr<Camera>>& cameras, int max_threads = 16);
+
     inline float focal2fov(float focal, int pixels) {
         return 2.0f * std::atan(pixels / (2.0f * focal));
     }
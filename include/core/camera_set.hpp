@@ -0,0 +1,70 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/camera.hpp"
+#include <memory>
+#include <span>
+#include <torch/torch.h>
+#include <vector>
+
+namespace gs {
+
+    /**
+     * @brief Intrinsics and extrinsics of many cameras as contiguous CUDA tensors
+     *
+     * Row i of every tensor belongs to cameras()[i]. The tensors are a snapshot of the cameras at
+     * construction: the intrinsics follow the image size the cameras had then, the poses are their
+     * world_view_transform(). A camera with fewer distortion coefficients than the widest one is
+     * zero padded, which the UT kernels read as no distortion.
+     */
+    class CameraSet {
+    public:
+        CameraSet() = default;
+
+        // Keeps the cameras for uid lookups, ordered by uid
+        explicit CameraSet(std::vector<std::shared_ptr<const Camera>> cameras);
+
+        // Tensors only, row i is cameras[i] and find() stays empty
+        static CameraSet snapshot(std::span<const Camera* const> cameras, int64_t radial_count = 0);
+
+        size_t size() const noexcept { return static_cast<size_t>(_num_cameras); }
+        bool empty() const noexcept { return _num_cameras == 0; }
+
+        // Camera of a uid, null when the set doesn't hold it
+        std::shared_ptr<const Camera> find(int uid) const;
+        // Row of a uid, -1 when the set doesn't hold it
+        int row(int uid) const noexcept;
+        // [B] int64 CUDA rows of the uids, for index_select on the tensors below
+        torch::Tensor rows(std::span<const int> uids) const;
+
+        const std::vector<std::shared_ptr<const Camera>>& cameras() const noexcept { return _cameras; }
+
+        const torch::Tensor& world_view_transforms() const noexcept { return _world_view_transforms; } // [N, 4, 4]
+        const torch::Tensor& cam_positions() const noexcept { return _cam_positions; }                 // [N, 3]
+        const torch::Tensor& Ks() const noexcept { return _Ks; }                                       // [N, 3, 3]
+        const torch::Tensor& radial_distortion() const noexcept { return _radial_distortion; }         // [N, R]
+        const torch::Tensor& tangential_distortion() const noexcept { return _tangential_distortion; } // [N, 2]
+        const torch::Tensor& uids() const noexcept { return _uids; }                                   // [N] int64
+        // Whether any camera brought distortion coefficients
+        bool distorted() const noexcept { return _distorted; }
+
+    private:
+        void build(std::span<const Camera* const> cameras, int64_t radial_count);
+
+        std::vector<std::shared_ptr<const Camera>> _cameras;
+        std::vector<int> _row_of_uid; // Indexed by uid, -1 for the uids not in the set
+        int64_t _num_cameras = 0;
+        bool _distorted = false;
+
+        torch::Tensor _world_view_transforms;
+        torch::Tensor _cam_positions;
+        torch::Tensor _Ks;
+        torch::Tensor _radial_distortion;
+        torch::Tensor _tangential_distortion;
+        torch::Tensor _uids;
+    };
+
+} // namespace gs
@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #pragma once
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <concepts>
@@ -13,6 +14,7 @@
 #include <print>
 #include <source_location>
 #include <sstream>
+#include <thread>
 #include <typeindex>
 #include <unordered_map>
 #include <vector>
@@ -38,17 +40,40 @@ namespace gs::event {
             virtual ~BaseChannel() = default;
             virtual std::string_view type_name() const = 0;
             virtual size_t handler_count() const = 0;
+            virtual size_t clear_handlers() = 0;
         };
 
+        // Handlers are an immutable list swapped copy-on-write: emit loads the current list and
+        // walks it without a lock or a copy, writers serialize on the mutex and publish a new list.
         template <Event E>
         struct Channel : BaseChannel {
-            std::vector<std::pair<HandlerId, Handler<E>>> handlers;
-            mutable std::mutex mutex;
+            struct Entry {
+                HandlerId id;
+                Handler<E> handler;
+                bool queued; // Delivered on the dispatch thread
+            };
+            using List = std::vector<Entry>;
+
+            std::atomic<std::shared_ptr<const List>> handlers{std::make_shared<const List>()};
+            std::mutex write_mutex;
 
             std::string_view type_name() const override { return typeid(E).name(); }
             size_t handler_count() const override {
-                std::lock_guard lock(mutex);
-                return handlers.size();
+                return handlers.load(std::memory_order_acquire)->size();
+            }
+            size_t clear_handlers() override {
+                std::lock_guard lock(write_mutex);
+                const size_t count = handlers.load(std::memory_order_relaxed)->size();
+                handlers.store(std::make_shared<const List>(), std::memory_order_release);
+                return count;
+            }
+
+            // Under write_mutex
+            template <typename Edit>
+            void update(Edit&& edit) {
+                auto list = std::make_shared<List>(*handlers.load(std::memory_order_relaxed));
+                edit(*list);
+                handlers.store(std::move(list), std::memory_order_release);
             }
         };
 
@@ -63,33 +88,42 @@ namespace gs::event {
             bool show_location = true;
         };
 
-        // Emit an event
+        // Emit an event. Direct handlers run on the emitting thread, queued handlers too when no
+        // dispatch thread is set or this is it, otherwise they wait for dispatch_queued.
         template <Event E>
         void emit(const E& event, std::source_location loc = std::source_location::current()) {
             if (debug_.enabled && debug_.log_emit) {
                 log_emit_event<E>(loc);
             }
 
-            if (auto it = channels_.find(typeid(E)); it != channels_.end()) {
-                auto& channel = static_cast<Channel<E>&>(*it->second);
-
-                // Copy only the handlers, not the IDs
-                std::vector<Handler<E>> handlers_copy;
-                {
-                    std::lock_guard lock(channel.mutex);
-                    handlers_copy.reserve(channel.handlers.size());
-                    for (auto& [id, handler] : channel.handlers) {
-                        handlers_copy.push_back(handler);
-                    }
-                }
+            if (auto* channel = find_channel<E>()) {
+                const auto handlers = channel->handlers.load(std::memory_order_acquire);
 
-                if (debug_.enabled && debug_.log_unhandled && handlers_copy.empty()) {
+                if (debug_.enabled && debug_.log_unhandled && handlers->empty()) {
                     std::println("[Event::Bus] WARNING: No handlers for event: {}",
                                  demangle(typeid(E).name()));
                 }
 
-                for (auto& handler : handlers_copy) {
-                    handler(event);
+                const auto dispatch = dispatch_thread_.load(std::memory_order_acquire);
+                const bool deliver_now = dispatch == std::thread::id{} || dispatch == std::this_thread::get_id();
+                bool queue = false;
+                for (const auto& entry : *handlers) {
+                    if (entry.queued && !deliver_now) {
+                        queue = true;
+                    } else {
+                        entry.handler(event);
+                    }
+                }
+                // The list is captured, so handlers removed meanwhile still get this event
+                if (queue) {
+                    std::lock_guard lock(queue_mutex_);
+                    queued_.emplace_back([handlers, event] {
+                        for (const auto& entry : *handlers) {
+                            if (entry.queued) {
+                                entry.handler(event);
+                            }
+                        }
+                    });
                 }
 
                 emit_count_++;
@@ -99,34 +133,54 @@ namespace gs::event {
             }
         }
 
-        // Subscribe to events
+        // Subscribe to events, the handler runs on the emitting thread
         template <Event E>
         HandlerId when(Handler<E> handler, std::source_location loc = std::source_location::current()) {
-            auto& channel = get_channel<E>();
-            std::lock_guard lock(channel.mutex);
+            return subscribe<E>(std::move(handler), false, loc);
+        }
 
-            HandlerId id = next_id_++;
-            channel.handlers.emplace_back(id, std::move(handler));
+        // Subscribe to events delivered on the dispatch thread (the GUI), so a handler never runs
+        // inside e.g. a training step. Events from other threads are queued until dispatch_queued.
+        template <Event E>
+        HandlerId when_queued(Handler<E> handler, std::source_location loc = std::source_location::current()) {
+            return subscribe<E>(std::move(handler), true, loc);
+        }
 
-            if (debug_.enabled && debug_.log_subscribe) {
-                log_subscribe_event<E>(id, loc);
+        // The calling thread delivers queued events from now on, until release_dispatch_thread
+        void set_dispatch_thread() {
+            dispatch_thread_.store(std::this_thread::get_id(), std::memory_order_release);
+        }
+
+        // Queued handlers run on the emitting thread again, events still waiting are delivered here
+        void release_dispatch_thread() {
+            dispatch_thread_.store(std::thread::id{}, std::memory_order_release);
+            dispatch_queued();
+        }
+
+        // Dispatch thread, e.g. once per frame: runs the queued events in emission order
+        size_t dispatch_queued() {
+            std::vector<std::function<void()>> pending;
+            {
+                std::lock_guard lock(queue_mutex_);
+                pending.swap(queued_);
             }
-            return id;
+            for (auto& deliver : pending) {
+                deliver();
+            }
+            return pending.size();
         }
 
         // Unsubscribe
         template <Event E>
         void remove(HandlerId id) {
-            if (auto it = channels_.find(typeid(E)); it != channels_.end()) {
-                auto& channel = static_cast<Channel<E>&>(*it->second);
-                std::lock_guard lock(channel.mutex);
-                auto before = channel.handlers.size();
-                channel.handlers.erase(
-                    std::remove_if(channel.handlers.begin(), channel.handlers.end(),
-                                   [id](const auto& pair) { return pair.first == id; }),
-                    channel.handlers.end());
-
-                if (debug_.enabled && before != channel.handlers.size()) {
+            if (auto* channel = find_channel<E>()) {
+                std::lock_guard lock(channel->write_mutex);
+                const auto before = channel->handlers.load(std::memory_order_relaxed)->size();
+                channel->update([id](auto& list) {
+                    std::erase_if(list, [id](const auto& entry) { return entry.id == id; });
+                });
+
+                if (debug_.enabled && before != channel->handler_count()) {
                     std::println("[Event::Bus] Unsubscribed handler {} from {}",
                                  id, demangle(typeid(E).name()));
                 }
@@ -136,11 +190,8 @@ namespace gs::event {
         // Clear all handlers for an event type
         template <Event E>
         void clear() {
-            if (auto it = channels_.find(typeid(E)); it != channels_.end()) {
-                auto& channel = static_cast<Channel<E>&>(*it->second);
-                std::lock_guard lock(channel.mutex);
-                auto count = channel.handlers.size();
-                channel.handlers.clear();
+            if (auto* channel = find_channel<E>()) {
+                const auto count = channel->clear_handlers();
 
                 if (debug_.enabled && count > 0) {
                     std::println("[Event::Bus] Cleared {} handlers for {}",
@@ -149,25 +200,24 @@ namespace gs::event {
             }
         }
 
-        // Clear all handlers
+        // Clear all handlers. Channels stay, emitters look them up without the lock.
         void clear_all() {
             std::lock_guard lock(mutex_);
+            size_t total = 0;
+            for (const auto& [type, channel] : channels_) {
+                total += channel->clear_handlers();
+            }
             if (debug_.enabled) {
-                size_t total = 0;
-                for (const auto& [type, channel] : channels_) {
-                    total += channel->handler_count();
-                }
-                std::println("[Event::Bus] Clearing {} handlers across {} event types",
+                std::println("[Event::Bus] Cleared {} handlers across {} event types",
                              total, channels_.size());
             }
-            channels_.clear();
         }
 
         // Get subscriber count
         template <Event E>
         size_t subscriber_count() const {
-            if (auto it = channels_.find(typeid(E)); it != channels_.end()) {
-                return it->second->handler_count();
+            if (const auto* channel = find_channel<E>()) {
+                return channel->handler_count();
             }
             return 0;
         }
@@ -198,15 +248,60 @@ namespace gs::event {
         }
 
     private:
+        // Event types get a slot of the lock-free channel table on first use
+        static constexpr size_t MAX_SLOTS = 256;
+
+        static size_t next_slot() {
+            static std::atomic<size_t> next{0};
+            return next.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        template <Event E>
+        static size_t slot() {
+            static const size_t index = next_slot();
+            return index;
+        }
+
+        template <Event E>
+        Channel<E>* find_channel() const {
+            if (const size_t index = slot<E>(); index < MAX_SLOTS) {
+                return static_cast<Channel<E>*>(slots_[index].load(std::memory_order_acquire));
+            }
+            std::lock_guard lock(mutex_);
+            const auto it = channels_.find(typeid(E));
+            return it != channels_.end() ? static_cast<Channel<E>*>(it->second.get()) : nullptr;
+        }
+
         template <Event E>
         Channel<E>& get_channel() {
             std::lock_guard lock(mutex_);
             auto [it, inserted] = channels_.try_emplace(
                 typeid(E),
                 std::make_unique<Channel<E>>());
+            if (inserted) {
+                if (const size_t index = slot<E>(); index < MAX_SLOTS) {
+                    slots_[index].store(it->second.get(), std::memory_order_release);
+                }
+            }
             return static_cast<Channel<E>&>(*it->second);
         }
 
+        template <Event E>
+        HandlerId subscribe(Handler<E> handler, bool queued, const std::source_location& loc) {
+            auto& channel = get_channel<E>();
+            std::lock_guard lock(channel.write_mutex);
+
+            HandlerId id = next_id_++;
+            channel.update([&](auto& list) {
+                list.push_back({id, std::move(handler), queued});
+            });
+
+            if (debug_.enabled && debug_.log_subscribe) {
+                log_subscribe_event<E>(id, loc);
+            }
+            return id;
+        }
+
         template <Event E>
         void log_emit_event(const std::source_location& loc) {
             std::string msg = std::format("[Event::Bus] EMIT: {}", demangle(typeid(E).name()));
@@ -256,9 +351,14 @@ namespace gs::event {
 #endif
         }
 
-        mutable std::mutex mutex_;
+        mutable std::mutex mutex_; // Guards channels_, which owns the channels for the bus lifetime
         std::unordered_map<std::type_index, std::unique_ptr<BaseChannel>> channels_;
+        std::array<std::atomic<BaseChannel*>, MAX_SLOTS> slots_{};
         std::atomic<HandlerId> next_id_{1};
+
+        std::atomic<std::thread::id> dispatch_thread_{};
+        std::mutex queue_mutex_;
+        std::vector<std::function<void()>> queued_;
         std::atomic<size_t> emit_count_{0};
         DebugConfig debug_;
     };
@@ -280,6 +380,11 @@ namespace gs::event {
         return bus().when<E>(std::forward<decltype(handler)>(handler));
     }
 
+    template <Event E>
+    auto when_queued(auto&& handler) {
+        return bus().when_queued<E>(std::forward<decltype(handler)>(handler));
+    }
+
     // Debug helper
     inline void enable_debug(bool emit = true, bool subscribe = true, bool unhandled = true) {
         auto& b = bus();
@@ -29,6 +29,11 @@ namespace gs {
         static auto when(auto&& handler) {                 \
             return ::gs::event::bus().when<Name>(          \
                 std::forward<decltype(handler)>(handler)); \
+        }                                                  \
+                                                           \
+        static auto when_queued(auto&& handler) {          \
+            return ::gs::event::bus().when_queued<Name>(   \
+                std::forward<decltype(handler)>(handler)); \
         }                                                  \
     }
 
@@ -46,6 +51,7 @@ namespace gs {
             EVENT(SaveProject, std::filesystem::path project_dir;);
             EVENT(LoadFile, std::filesystem::path path; bool is_dataset;);
             EVENT(LoadProject, std::filesystem::path path;);
+            EVENT(CancelSplatFilesLoad, );
             EVENT(ClearScene, );
             EVENT(ResetCamera, );
             EVENT(ShowWindow, std::string window_name; bool show;);
@@ -106,6 +112,8 @@ namespace gs {
                   std::optional<std::string> error;
                   size_t num_images;
                   size_t num_points;);
+            EVENT(SplatFilesLoadProgress, std::filesystem::path path; bool success; size_t done; size_t total;);
+            EVENT(SplatFilesLoadCompleted, size_t loaded; size_t failed; bool cancelled;);
 
             // Evaluation
             EVENT(EvaluationStarted, int iteration; size_t num_images;);
@@ -4,12 +4,17 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <cuda_runtime_api.h>
 #include <filesystem>
+#include <functional>
 #include <future>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
+#include <span>
 #include <thread>
 #include <torch/torch.h>
 #include <vector>
@@ -29,9 +34,63 @@ void save_image(const std::filesystem::path& path,
                 int separator_width = 2);
 void free_image(unsigned char* image);
 
-// Batch image saving functionality
+// load_image into page-locked memory: [H, W, C] uint8 whose non_blocking uploads are truly
+// asynchronous. OIIO reads straight into it unless a resize follows the read.
+torch::Tensor load_image_pinned(std::filesystem::path p, int res_div = -1, int max_width = 3840);
+// Same from the already read file contents of p, decoded in memory
+torch::Tensor load_image_pinned(std::filesystem::path p, std::span<const unsigned char> encoded, int res_div, int max_width);
+
+// [1, height, width] uint8 in page-locked memory, 1 where the first channel of the mask image at
+// path is above one half. Other sizes are resampled with nearest neighbours, so a mask lines up
+// with an image of height x width however either was downscaled.
+torch::Tensor load_binary_mask(const std::filesystem::path& path, int64_t height, int64_t width);
+
+// Decodes to a CUDA uint8 [3, H, W] tensor on the current stream, with the same res_div/max_width
+// rules as load_image. JPEGs are decoded and resized on the GPU when built with nvJPEG,
+// everything else goes through load_image and is uploaded.
+torch::Tensor load_image_cuda(std::filesystem::path p, int res_div = -1, int max_width = 3840);
+torch::Tensor load_image_cuda(std::filesystem::path p, std::span<const unsigned char> encoded, int res_div, int max_width);
+bool gpu_image_decode_available();
+
+// Size of OIIO's thread pool, the whole machine unless set
+void set_image_io_threads(int threads);
+
+// Encodes a CUDA uint8 [H, W, 3] tensor to a JPEG file with nvJPEG once ready has completed, on a
+// stream of its own. False without nvJPEG or when the encoder rejects the image.
+bool save_jpeg_cuda(const std::filesystem::path& path, const torch::Tensor& hwc, cudaEvent_t ready, int quality = 95);
+bool gpu_image_encode_available();
+
 namespace image_io {
 
+    // Where decoded pixels go. release is only called for a buffer the decode gives up on, on
+    // success the buffer belongs to the caller.
+    struct PixelAllocator {
+        std::function<unsigned char*(size_t)> allocate;
+        std::function<void(unsigned char*)> release;
+    };
+    // malloc and free_image, what load_image uses
+    const PixelAllocator& malloc_pixels();
+
+    // Raw decoded images as the disk cache stores them: a small header, then [H, W, C] uint8
+    struct RawImageLayout {
+        size_t offset = 0; // Of the pixels in the file
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+    };
+
+    // Entry of source decoded with res_div/max_width in directory, next to the source when empty.
+    // The name hashes the absolute path, size and mtime of the source, nullopt when it can't be stat'ed
+    std::optional<std::filesystem::path> raw_image_path(const std::filesystem::path& directory,
+                                                        const std::filesystem::path& source,
+                                                        int res_div, int max_width);
+    // Atomic with respect to other writers of the same entry, false when the write failed
+    bool write_raw_image(const std::filesystem::path& path, const unsigned char* data,
+                         int width, int height, int channels);
+    // nullopt unless file holds a complete entry
+    std::optional<RawImageLayout> parse_raw_image(std::span<const char> file);
+
+    // Batch image saving functionality
     class BatchImageSaver {
     public:
         // Singleton pattern to ensure cleanup on exit
@@ -46,7 +105,9 @@ namespace image_io {
         BatchImageSaver(BatchImageSaver&&) = delete;
         BatchImageSaver& operator=(BatchImageSaver&&) = delete;
 
-        // Queue image for asynchronous saving
+        // Queue image for asynchronous saving. CUDA images are quantized on their stream and copied
+        // to pinned memory on a staging stream, the caller never waits for the device. JPEGs are
+        // encoded on the GPU when nvJPEG is available.
         void queue_save(const std::filesystem::path& path, torch::Tensor image);
 
         // Queue multiple images for side-by-side saving
@@ -69,21 +130,37 @@ namespace image_io {
         bool is_enabled() const { return enabled_; }
 
     private:
+        // Pinned buffers kept for reuse beyond the ones in flight
+        static constexpr size_t MAX_FREE_BUFFERS = 8;
+
         BatchImageSaver(size_t num_workers = 4);
         ~BatchImageSaver();
 
+        struct StagedImage;
+
         struct SaveTask {
             std::filesystem::path path;
             torch::Tensor image;
             std::vector<torch::Tensor> images;
-            bool is_multi;
-            bool horizontal;
-            int separator_width;
+            bool is_multi = false;
+            bool horizontal = true;
+            int separator_width = 0;
+            std::shared_ptr<StagedImage> staged; // CUDA input, replaces image/images
         };
 
+        void enqueue(SaveTask&& task);
         void worker_thread();
         void process_task(const SaveTask& task);
 
+        // Starts the download of a [H, W, C] uint8 CUDA image, or with keep_on_device only fences it
+        std::shared_ptr<StagedImage> stage(torch::Tensor hwc, bool keep_on_device);
+        void save_staged(const std::filesystem::path& path, StagedImage& staged);
+
+        // Staging pools, staging_mutex_ held
+        cudaEvent_t acquire_event();
+        std::pair<unsigned char*, size_t> acquire_buffer(size_t bytes);
+        void release_staged(StagedImage& staged);
+
         std::vector<std::thread> workers_;
         std::queue<SaveTask> task_queue_;
         mutable std::mutex queue_mutex_;
@@ -93,6 +170,55 @@ namespace image_io {
         std::atomic<size_t> active_tasks_{0};
         std::atomic<bool> enabled_{true};
         size_t num_workers_;
+
+        std::mutex staging_mutex_;
+        cudaStream_t staging_stream_ = nullptr; // Device to host copies, created on the first CUDA save
+        std::vector<std::pair<unsigned char*, size_t>> free_buffers_; // Pinned, with their capacity
+        std::vector<cudaEvent_t> free_events_;
+    };
+
+    // Persistent cache of decoded (and resized) images stored as raw RGB files. Once enabled,
+    // load_image and get_image_info consult it transparently. Entries are keyed by source path,
+    // size and mtime plus the resize arguments, so a modified source simply misses.
+    class DiskImageCache {
+    public:
+        static DiskImageCache& instance() {
+            static DiskImageCache instance;
+            return instance;
+        }
+
+        DiskImageCache(const DiskImageCache&) = delete;
+        DiskImageCache& operator=(const DiskImageCache&) = delete;
+
+        // Call before any loading starts. An empty directory keeps entries in a
+        // .lfs_cache folder next to each source image.
+        void enable(const std::filesystem::path& directory = {});
+        void disable() { enabled_ = false; }
+        bool is_enabled() const { return enabled_; }
+
+        // Returns a buffer from allocator (free_image by default), nullopt on a miss
+        std::optional<std::tuple<unsigned char*, int, int, int>>
+        load(const std::filesystem::path& source, int res_div, int max_width,
+             const PixelAllocator& allocator = malloc_pixels()) const;
+        void store(const std::filesystem::path& source, int res_div, int max_width,
+                   const unsigned char* data, int width, int height, int channels) const;
+
+        std::optional<std::tuple<int, int, int>> load_info(const std::filesystem::path& source) const;
+        void store_info(const std::filesystem::path& source, int width, int height, int channels) const;
+
+    private:
+        DiskImageCache() = default;
+
+        // nullopt when the source can't be stat'ed
+        std::optional<std::filesystem::path> entry_path(const std::filesystem::path& source,
+                                                        const std::string& variant,
+                                                        const char* extension) const;
+        void write_entry(const std::filesystem::path& path, int width, int height, int channels,
+                         const unsigned char* data, size_t num_bytes) const;
+
+        std::filesystem::path directory_;
+        std::atomic<bool> enabled_{false};
+        mutable std::atomic<bool> write_failed_{false};
     };
 
     // Convenience functions that use the singleton
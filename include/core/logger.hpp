@@ -6,13 +6,24 @@
 #include <array>
 #include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <format>
+#include <iterator>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <source_location>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 #include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+
+#ifdef GS_PROFILING_ZONES
+#include <nvtx3/nvToolsExt.h>
+#endif
 
 namespace gs::core {
 
@@ -26,6 +37,12 @@ namespace gs::core {
         Off = 6
     };
 
+    // LOG_* calls below this level compile away, set through the LOG_MIN_LEVEL CMake cache variable
+#ifndef GS_LOG_MIN_LEVEL
+#define GS_LOG_MIN_LEVEL 0
+#endif
+    inline constexpr LogLevel COMPILED_LOG_LEVEL = static_cast<LogLevel>(GS_LOG_MIN_LEVEL);
+
     // Module detection from file path
     enum class LogModule : uint8_t {
         Core = 0,
@@ -41,6 +58,116 @@ namespace gs::core {
         Count = 10 // Total number of modules
     };
 
+    namespace detail {
+        // One message in the async queue, either formatted into the payload by the caller or holding
+        // the arguments for the logging thread to format
+        struct LogRecord {
+            static constexpr size_t PAYLOAD = 224;
+
+            std::atomic<size_t> sequence{0};
+            spdlog::log_clock::time_point time;
+            spdlog::source_loc loc;
+            spdlog::level::level_enum level = spdlog::level::info;
+            std::string_view fmt;                                      // Deferred records only
+            void (*format)(const LogRecord&, std::string&) = nullptr; // Null when the payload holds the text
+            std::string* spilled = nullptr;                            // Text too long for the payload
+            size_t length = 0;
+            alignas(std::max_align_t) std::byte payload[PAYLOAD];
+        };
+
+        // Writes formatted text into the payload and counts whatever does not fit
+        class PayloadWriter {
+        public:
+            using difference_type = std::ptrdiff_t;
+
+            explicit PayloadWriter(LogRecord& record) : record_(&record) {}
+
+            PayloadWriter& operator*() { return *this; }
+            PayloadWriter& operator++() { return *this; }
+            PayloadWriter operator++(int) { return *this; }
+            PayloadWriter& operator=(char c) {
+                if (record_->length < LogRecord::PAYLOAD) {
+                    record_->payload[record_->length] = static_cast<std::byte>(c);
+                }
+                ++record_->length;
+                return *this;
+            }
+
+        private:
+            LogRecord* record_;
+        };
+
+        // Arguments copied as they are and formatted on the logging thread. Anything that may point
+        // into the caller's memory (strings, views, pointers) is formatted before enqueueing.
+        template <typename T>
+        concept DeferredLogArg = std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T> &&
+                                 !std::is_pointer_v<T> && !std::is_array_v<T> &&
+                                 !std::is_same_v<T, std::string_view>;
+
+        template <typename Stored>
+        void format_deferred(const LogRecord& record, std::string& out) {
+            const auto& stored = *std::launder(reinterpret_cast<const Stored*>(record.payload));
+            out.clear();
+            std::apply([&](const auto&... values) {
+                std::vformat_to(std::back_inserter(out), record.fmt, std::make_format_args(values...));
+            },
+                       stored);
+        }
+
+        // Bounded multi-producer queue drained by one logging thread. Producers claim a slot with a
+        // CAS on the tail and never wait; a full queue drops the message and counts it.
+        class AsyncLogQueue {
+        public:
+            static constexpr size_t CAPACITY = 4096; // Power of two
+
+            explicit AsyncLogQueue(std::shared_ptr<spdlog::logger> logger);
+            ~AsyncLogQueue();
+
+            AsyncLogQueue(const AsyncLogQueue&) = delete;
+            AsyncLogQueue& operator=(const AsyncLogQueue&) = delete;
+
+            // Null when the queue is full, a claimed slot must be published
+            LogRecord* claim(size_t& position) {
+                position = tail_.load(std::memory_order_relaxed);
+                while (true) {
+                    LogRecord& record = slots_[position & (CAPACITY - 1)];
+                    const size_t sequence = record.sequence.load(std::memory_order_acquire);
+                    const auto diff = static_cast<std::ptrdiff_t>(sequence - position);
+                    if (diff == 0) {
+                        if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                            return &record;
+                        }
+                    } else if (diff < 0) {
+                        dropped_.fetch_add(1, std::memory_order_relaxed);
+                        return nullptr;
+                    } else {
+                        position = tail_.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            void publish(LogRecord& record, size_t position) {
+                record.sequence.store(position + 1, std::memory_order_release);
+            }
+
+            // Blocks until everything enqueued so far is written
+            void wait_drained() const;
+
+        private:
+            void run();
+            bool write_next(std::string& message);
+
+            std::shared_ptr<spdlog::logger> logger_;
+            std::unique_ptr<LogRecord[]> slots_;
+            alignas(64) std::atomic<size_t> tail_{0};
+            alignas(64) std::atomic<size_t> consumed_{0};
+            size_t head_ = 0; // Logging thread only
+            std::atomic<uint64_t> dropped_{0};
+            std::atomic<bool> running_{true};
+            std::thread worker_;
+        };
+    } // namespace detail
+
     class Logger {
     public:
         static Logger& get() {
@@ -48,10 +175,15 @@ namespace gs::core {
             return instance;
         }
 
-        // Initialize logger
+        ~Logger();
+
+        // Initialize logger. With async, messages are queued to a logging thread instead of being
+        // written by the caller; critical ones are still written immediately.
         void init(LogLevel console_level = LogLevel::Info,
-                  const std::string& log_file = "") {
+                  const std::string& log_file = "",
+                  bool async = false) {
             std::lock_guard lock(mutex_);
+            stop_async();
 
             std::vector<spdlog::sink_ptr> sinks;
 
@@ -81,6 +213,11 @@ namespace gs::core {
                 module_enabled_[i] = true;
                 module_level_[i] = static_cast<uint8_t>(LogLevel::Trace);
             }
+
+            if (async) {
+                async_queue_ = std::make_unique<detail::AsyncLogQueue>(logger_);
+                async_.store(async_queue_.get(), std::memory_order_release);
+            }
         }
 
         // Internal log implementation
@@ -101,6 +238,14 @@ namespace gs::core {
                 return;
             }
 
+            if (auto* queue = async_.load(std::memory_order_acquire); queue && level != LogLevel::Critical) {
+                enqueue(*queue, level, loc, fmt, std::forward<Args>(args)...);
+                return;
+            }
+            if (level == LogLevel::Critical) {
+                flush();
+            }
+
             // Format message
             auto msg = std::format(fmt, std::forward<Args>(args)...);
 
@@ -131,6 +276,9 @@ namespace gs::core {
 
         // Flush logs
         void flush() {
+            if (auto* queue = async_.load(std::memory_order_acquire)) {
+                queue->wait_drained();
+            }
             if (logger_)
                 logger_->flush();
         }
@@ -138,6 +286,41 @@ namespace gs::core {
     private:
         Logger() = default;
 
+        template <typename... Args>
+        static void enqueue(detail::AsyncLogQueue& queue, LogLevel level, const std::source_location& loc,
+                            std::format_string<Args...> fmt, Args&&... args) {
+            size_t position = 0;
+            detail::LogRecord* record = queue.claim(position);
+            if (!record) {
+                return;
+            }
+            record->time = spdlog::log_clock::now();
+            record->loc = spdlog::source_loc{loc.file_name(), static_cast<int>(loc.line()), loc.function_name()};
+            record->level = to_spdlog_level(level);
+
+            using Stored = std::tuple<std::decay_t<Args>...>;
+            if constexpr ((detail::DeferredLogArg<std::decay_t<Args>> && ...) &&
+                          sizeof(Stored) <= detail::LogRecord::PAYLOAD &&
+                          alignof(Stored) <= alignof(std::max_align_t)) {
+                ::new (static_cast<void*>(record->payload)) Stored(std::forward<Args>(args)...);
+                record->fmt = fmt.get();
+                record->format = &detail::format_deferred<Stored>;
+            } else {
+                const auto arguments = std::make_format_args(args...);
+                record->length = 0;
+                std::vformat_to(detail::PayloadWriter(*record), fmt.get(), arguments);
+                if (record->length > detail::LogRecord::PAYLOAD) {
+                    record->spilled = new std::string(std::vformat(fmt.get(), arguments));
+                }
+            }
+            queue.publish(*record, position);
+        }
+
+        void stop_async() {
+            async_.store(nullptr, std::memory_order_release);
+            async_queue_.reset();
+        }
+
         static LogModule detect_module(std::string_view path) {
             // Convert to lowercase for case-insensitive matching
             if (path.find("rendering") != std::string_view::npos ||
@@ -184,13 +367,16 @@ namespace gs::core {
         }
 
         std::shared_ptr<spdlog::logger> logger_;
+        std::unique_ptr<detail::AsyncLogQueue> async_queue_;
+        std::atomic<detail::AsyncLogQueue*> async_{nullptr};
         mutable std::mutex mutex_;
         std::atomic<uint8_t> global_level_{static_cast<uint8_t>(LogLevel::Info)};
         std::array<std::atomic<bool>, static_cast<size_t>(LogModule::Count)> module_enabled_{};
         std::array<std::atomic<uint8_t>, static_cast<size_t>(LogModule::Count)> module_level_{};
     };
 
-    // Scoped timer for performance measurement
+    // Scoped timer for performance measurement. Host wall time only, it also opens an NVTX range so
+    // the scope shows on the Nsight timeline; GPU time of async work needs a ProfileZone (profiler.hpp).
     class ScopedTimer {
         std::chrono::high_resolution_clock::time_point start_;
         std::string name_;
@@ -203,9 +389,19 @@ namespace gs::core {
             : start_(std::chrono::high_resolution_clock::now()),
               name_(std::move(name)),
               level_(level),
-              loc_(loc) {}
+              loc_(loc) {
+#ifdef GS_PROFILING_ZONES
+            nvtxRangePushA(name_.c_str());
+#endif
+        }
 
         ~ScopedTimer() {
+#ifdef GS_PROFILING_ZONES
+            nvtxRangePop();
+#endif
+            if (level_ < COMPILED_LOG_LEVEL) {
+                return;
+            }
             auto duration = std::chrono::high_resolution_clock::now() - start_;
             auto ms = std::chrono::duration<double, std::milli>(duration).count();
 
@@ -225,24 +421,21 @@ namespace gs::core {
 
 } // namespace gs::core
 
-// Global macros defined OUTSIDE namespace - accessible from anywhere
-#define LOG_TRACE(...) \
-    ::gs::core::Logger::get().log_internal(::gs::core::LogLevel::Trace, std::source_location::current(), __VA_ARGS__)
-
-#define LOG_DEBUG(...) \
-    ::gs::core::Logger::get().log_internal(::gs::core::LogLevel::Debug, std::source_location::current(), __VA_ARGS__)
-
-#define LOG_INFO(...) \
-    ::gs::core::Logger::get().log_internal(::gs::core::LogLevel::Info, std::source_location::current(), __VA_ARGS__)
-
-#define LOG_WARN(...) \
-    ::gs::core::Logger::get().log_internal(::gs::core::LogLevel::Warn, std::source_location::current(), __VA_ARGS__)
-
-#define LOG_ERROR(...) \
-    ::gs::core::Logger::get().log_internal(::gs::core::LogLevel::Error, std::source_location::current(), __VA_ARGS__)
-
-#define LOG_CRITICAL(...) \
-    ::gs::core::Logger::get().log_internal(::gs::core::LogLevel::Critical, std::source_location::current(), __VA_ARGS__)
+// Global macros defined OUTSIDE namespace - accessible from anywhere. Levels below
+// COMPILED_LOG_LEVEL are still type-checked but generate no code.
+#define GS_LOG_AT(level, ...)                                                                                     \
+    do {                                                                                                          \
+        if constexpr ((level) >= ::gs::core::COMPILED_LOG_LEVEL) {                                                \
+            ::gs::core::Logger::get().log_internal((level), std::source_location::current(), __VA_ARGS__);       \
+        }                                                                                                         \
+    } while (0)
+
+#define LOG_TRACE(...)    GS_LOG_AT(::gs::core::LogLevel::Trace, __VA_ARGS__)
+#define LOG_DEBUG(...)    GS_LOG_AT(::gs::core::LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...)     GS_LOG_AT(::gs::core::LogLevel::Info, __VA_ARGS__)
+#define LOG_WARN(...)     GS_LOG_AT(::gs::core::LogLevel::Warn, __VA_ARGS__)
+#define LOG_ERROR(...)    GS_LOG_AT(::gs::core::LogLevel::Error, __VA_ARGS__)
+#define LOG_CRITICAL(...) GS_LOG_AT(::gs::core::LogLevel::Critical, __VA_ARGS__)
 
 // Timer macros
 #define LOG_TIMER(name)       ::gs::core::ScopedTimer _timer##__LINE__(name)
@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <array>
 #include <expected>
 #include <filesystem>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -32,20 +34,83 @@ namespace gs {
             float scale_reg = 0.01f;
             float init_opacity = 0.5f;
             float init_scaling = 0.1f;
-            int num_workers = 16;
+            int num_workers = 16;                             // Dataloader workers, 0: autotuned at startup and adjusted to starvation
+            int cpu_threads = 0;                              // CPU budget of dataloader workers and OIIO's pool, 0: unbudgeted
+            bool pin_threads = false;                         // Pin host worker threads to the CPUs of the GPU's NUMA node
+            std::string dataloader = "efficient"; // Training dataloader backend: efficient, libtorch
             int max_cap = 1000000;
             std::vector<size_t> eval_steps = {7'000, 30'000}; // Steps to evaluate the model
             std::vector<size_t> save_steps = {7'000, 30'000}; // Steps to save the model
             bool skip_intermediate_saving = false;            // Skip saving intermediate results and only save final output
             bool bg_modulation = false;                       // Enable sinusoidal background modulation
             bool enable_eval = false;                         // Only evaluate when explicitly enabled
+            bool async_eval = false;                          // Evaluate a model snapshot on a worker thread while training continues
+            int eval_views = 0;                               // Validation views of the intermediate evaluations, a fixed random subset, 0: all
+            int eval_downscale = 1;                           // Intermediate evaluations compare at 1/N resolution, the final one at full
             bool rc = false;                                  // Workaround for reality captures - doesn't properly convert COLMAP camera model
             bool enable_save_eval_images = true;              // Save during evaluation images
             bool headless = false;                            // Disable visualization during training
+            std::string benchmark_output = "";                // --benchmark report path: fixed seeds, nothing saved, empty: off
+            int seed = -1;                                    // Seeds torch, the view order, crops and background jitter, -1: random
+            bool deterministic = false;                       // Deterministic torch algorithms, for comparable runs
             std::string render_mode = "RGB";                  // Render mode: RGB, D, ED, RGB_D, RGB_ED
-            std::string strategy = "mcmc";                    // Optimization strategy: mcmc, default.
+            std::string strategy = "mcmc";                    // Optimization strategy: mcmc, default, taming.
             bool preload_to_ram = false;                      // If true, the entire dataset will be loaded into RAM at startup
+            int preload_max_mb = 16384;                       // Host RAM budget for preload_to_ram, images beyond it are read from disk. 0 preloads none, -1 is unlimited
+            bool preload_to_vram = false;                     // Keep all ground-truth images resident in VRAM as uint8
+            std::string shared_image_cache = "";              // preload_to_ram into files there shared by concurrent runs, e.g. /dev/shm
+            bool gpu_decode = false;                          // Decode JPEG ground truth with nvJPEG and resize on the GPU
+            int read_ahead = 0;                               // Encoded images read ahead of the dataloader workers, 0: workers read
+            std::string read_ahead_mirror = "";               // Local copies of the images read ahead, for remote or mounted object storage
+            bool disk_image_cache = false;                    // Keep decoded/resized images as raw files for later runs
+            std::string disk_image_cache_dir = "";            // Empty: .lfs_cache next to the source images
+            int checkpoint_every = 0;                         // Extra resumable checkpoint every N iterations, 0: only at save steps
+            int early_stop_window = 0;                        // Iterations per train-loss plateau check after stop_refine, 0: train all iterations
+            float early_stop_threshold = 0.002f;              // Relative loss EMA gain over a window below which training ends (or sparsifies)
+            int fine_tune_iterations = 0;                     // Schedule length of a run warm-started from init_ply or init_checkpoint, 0: the full schedule
+            bool sync_free_step = false;                      // One backward over the summed losses, loss read back asynchronously
+            bool fused_loss = false;                          // L1 + D-SSIM and background compositing in one kernel per direction
+            bool upper_bound_allocation = false;              // Rasterizer buffers sized from the previous step, counts read back behind the depth sort
+            bool spatial_index = false;                       // Morton-chunk frustum culling before the rasterizer preprocess
+            bool instance_stats = false;                      // Report exact tile instances against bounding-rectangle tiles
+            bool load_balanced_blend = false;                 // Split tiles with many instances across several blend blocks
+            bool sparse_adam = false;                         // Adam updates only the Gaussians the step's views rendered
+            bool gut_packed = false;                          // GUT intersects and rasterizes only the projected Gaussians
+            bool densify_budget = false;                      // Default strategy grows only up to max_cap and densify_vram_mb
+            int densify_vram_mb = 0;                          // VRAM ceiling of densify_budget, 0: 90% of the device memory
+            int vram_budget_mb = 0;                           // Reserved VRAM before the CUDA cache is trimmed, 0: 90% of the device memory
+            int bucket_state_budget_mb = 0;                   // Blend states kept for the backward, above it they are replayed, 0: no limit
+            std::string cuda_allocator = "native";            // CUDA allocator backend: native (caching allocator), async (cudaMallocAsync)
+            int views_per_step = 1;                           // Cameras rendered per step, gradients accumulate before one optimizer update
+            int progressive_resolution = 0;                   // Coarse-to-fine: 1/4, then 1/2 resolution over the first N iterations, 0: off
+            int crop_size = 0;                                // Train on random crop_size x crop_size crops of each image, 0: full images
+            bool importance_sampling = false;                 // Draw training views in proportion to their recent loss
+            float importance_sampling_floor = 0.3f;           // Share of importance_sampling draws that stay uniform over all views
+            std::string sh_precision = "float32";             // Storage of shN and its Adam moments: float32, float16, bfloat16
+            int sh_codebook_iteration = 0;                    // From this iteration shN trains as a shared palette, 0: off (needs >= stop_refine)
+            int sh_codebook_size = 4096;                      // Palette entries of the SH codebook
+            int sh_basis_iteration = 0;                       // From this iteration shN trains as per-Gaussian weights of a shared basis, 0: off (needs >= stop_refine)
+            int sh_basis_rank = 8;                            // Basis vectors of the low-rank SH model
+            bool progressive_sh = false;                      // Store shN and its moments only up to the active SH degree
+            std::string tile_shape = "16x16";                 // Rasterizer blend tile: 16x16, 8x8, 32x8, auto (benchmarked once per GPU and resolution)
+            int viewer_snapshot_every = 10;                   // Iterations between the model copies the viewer renders, 0: the live model
+            bool prioritize_training = false;                 // Train on the highest CUDA stream priority, ahead of the viewer's lowest
             std::string pose_optimization = "none";           // Pose optimization type: none, direct, mlp
+            std::string telemetry_output = "";                // Per-iteration stats to a file or unix:<socket>, empty: off
+            std::string telemetry_format = "csv";             // Telemetry encoding: csv, binary
+            int profile_zones_every = 0;                      // Log per-zone GPU times averaged over this many iterations, 0: off
+            std::string trace_output = "";                    // Chrome trace JSON of the host and GPU spans, empty: off
+            int trace_capacity = 1 << 20;                     // Newest spans the trace keeps
+
+            // Optimizer update schedule: a parameter group steps every N iterations until update_every_until,
+            // gradients of the skipped iterations accumulate into its next update
+            size_t means_update_every = 1;
+            size_t sh0_update_every = 1;
+            size_t shN_update_every = 1;
+            size_t scaling_update_every = 1;
+            size_t rotation_update_every = 1;
+            size_t opacity_update_every = 1;
+            size_t update_every_until = 25'000;
 
             // Bilateral grid parameters
             bool use_bilateral_grid = false;
@@ -53,6 +118,7 @@ namespace gs {
             int bilateral_grid_Y = 16;
             int bilateral_grid_W = 8;
             float bilateral_grid_lr = 2e-3f;
+            std::string bilateral_grid_precision = "float32"; // Storage of the grids and their Adam moments: float32, float16, bfloat16
             float tv_loss_weight = 10.f;
 
             // Default strategy specific parameters
@@ -61,6 +127,7 @@ namespace gs {
             float grow_scale2d = 0.05f;
             float prune_scale3d = 0.1f;
             float prune_scale2d = 0.15f;
+            float prune_contribution = 0.0f; // Default and MCMC: blending weight a rasterized Gaussian must reach between refinements, 0: off
             size_t reset_every = 3'000;
             size_t pause_refine_after_reset = 0;
             bool revised_opacity = false;
@@ -76,6 +143,16 @@ namespace gs {
             // SOG format parameters
             bool save_sog = false;   // Save in SOG format alongside PLY
             int sog_iterations = 10; // K-means iterations for SOG compression
+            int sog_webp_level = 6;  // Lossless WebP effort of the SOG textures, 0 (fastest) to 9 (smallest)
+            int sog_qat_iteration = 0; // From this iteration the forward renders the attributes as SOG stores them, 0: off
+            bool save_lod = false;   // Save a chunked level-of-detail .lfslod file alongside PLY
+            bool save_delta = false; // Intermediate saves as .lfsdelta files against the previous save
+
+            // Keep the Gaussians Morton-sorted after every refinement and in saved PLY/SOG files
+            bool morton_order = false;
+
+            // Write PLY vertex data with O_DIRECT, around the page cache (Linux only)
+            bool ply_direct_io = false;
 
             // Sparsity optimization parameters
             bool enable_sparsity = false;
@@ -99,6 +176,65 @@ namespace gs {
             std::vector<std::string> timelapse_images = {};
             int timelapse_every = 50;
             int max_width = 3840;
+            bool undistort = false; // undistort pinhole OpenCV images once so they train on the fast rasterizer
+        };
+
+        // Headless conversion of splat files without the viewer, see core/batch_export.hpp
+        struct BatchExportParameters {
+            std::filesystem::path input;                    // A splat file or a directory of them
+            std::filesystem::path output_dir;
+            std::vector<std::string> formats = {"ply"};     // Any of ply, sog, lod
+            std::optional<std::array<float, 12>> transform; // Row-major 3x4 similarity, applied first
+            std::optional<std::array<float, 6>> crop_box;   // World-aligned min xyz, max xyz
+            float min_opacity = 0.f;                        // Prune Gaussians below this opacity, 0: keep all
+            int jobs = 2;                                   // Files in flight at once
+        };
+
+        // Headless fly-through video of a splat file, see training/render_path.hpp
+        struct RenderPathParameters {
+            std::filesystem::path model;             // Splat file to render
+            std::filesystem::path path;              // Keyframe JSON or a dataset directory whose cameras form the path
+            std::filesystem::path output;            // Video file, its extension picks the container
+            int width = 1920;
+            int height = 1080;
+            float fps = 30.f;
+            float keyframe_seconds = 1.f;            // Between keyframes that give no time of their own
+            int camera_stride = 1;                   // Every n-th camera of a dataset path
+            std::string codec = "h264_nvenc";        // FFmpeg video encoder
+            std::array<float, 3> background = {0.f, 0.f, 0.f};
+        };
+
+        struct RenderServerParameters {
+            std::filesystem::path model;             // Splat file every session renders
+            int port = 9090;                         // TCP port the server listens on
+            std::string bind_address = "127.0.0.1";  // IPv4 address it listens on, loopback unless remote use is asked for
+            int max_sessions = 4;                    // Clients served at once, further ones are turned away
+            std::string codec = "h264_nvenc";        // FFmpeg video encoder of the streams
+            std::array<float, 3> background = {0.f, 0.f, 0.f};
+        };
+
+        // Headless training of many datasets across the GPUs of a node, see training/job_queue.hpp
+        struct JobQueueParameters {
+            std::filesystem::path jobs_file;         // JSON array of the jobs, in queue order
+            std::vector<int> gpus;                   // Devices the jobs run on, empty: every visible one
+            int jobs_per_gpu = 1;                    // Jobs with a VRAM estimate packed onto one device
+        };
+
+        // Headless compaction of a trained splat file against its dataset, see training/compaction.hpp
+        struct CompactParameters {
+            std::filesystem::path model;                // Splat file to compact
+            std::vector<std::string> formats = {"ply"}; // Any of ply, sog, lod
+            float max_psnr_drop = 0.5f;                 // dB the pruning may lose on the scoring views
+            float sh_tolerance = 0.004f;                // RMS color of an SH band below which a Gaussian drops it
+            int fine_tune_iterations = 1000;            // FusedAdam steps after pruning, 0: none
+            int views = 32;                             // Cameras the PSNR is measured on, 0: all
+        };
+
+        // Standalone timing of the training dataloader, see training/dataloader_benchmark.hpp
+        struct DataLoaderBenchmarkParameters {
+            std::filesystem::path report; // JSON report
+            std::vector<int> workers;     // Worker counts to time, empty: powers of two up to the hardware threads
+            int images = 512;             // Timed images per worker count
         };
 
         struct TrainingParameters {
@@ -107,9 +243,45 @@ namespace gs {
 
             // Viewer mode specific
             std::filesystem::path ply_path = "";
+            // Cache of loaded splat files: recent ones stay in VRAM, those evicted from it in RAM
+            int model_cache_vram_mb = 2048;
+            int model_cache_ram_mb = 8192;
+            // GT images and previews as BC7 textures encoded on the GPU, a quarter of the VRAM of RGBA8
+            bool compress_textures = false;
 
             // Optional PLY splat file for initialization
             std::optional<std::string> init_ply = std::nullopt;
+
+            // Optional training checkpoint whose model and optimizer state warm-start a new run at iteration 1
+            std::optional<std::filesystem::path> init_checkpoint = std::nullopt;
+
+            // Optional training checkpoint directory to resume from
+            std::optional<std::filesystem::path> resume_checkpoint = std::nullopt;
+
+            // Delta directory to rebuild a PLY from instead of training, latest iteration when -1
+            std::optional<std::filesystem::path> materialize_delta = std::nullopt;
+            int materialize_iteration = -1;
+
+            // Convert splat files instead of training or viewing
+            std::optional<BatchExportParameters> batch_export = std::nullopt;
+
+            // Render a camera path into a video instead of training or viewing
+            std::optional<RenderPathParameters> render_path = std::nullopt;
+
+            // Serve --render-model to remote clients and exit when interrupted
+            std::optional<RenderServerParameters> render_server = std::nullopt;
+
+            // Train the jobs of a queue file, each in a headless process of its own
+            std::optional<JobQueueParameters> job_queue = std::nullopt;
+
+            // Shrink a trained splat file against --data-path instead of training
+            std::optional<CompactParameters> compact = std::nullopt;
+
+            // Time the dataloader on --data-path instead of training
+            std::optional<DataLoaderBenchmarkParameters> benchmark_dataloader = std::nullopt;
+
+            // Check --data-path with LoadOptions::validate_only instead of training
+            bool validate_dataset = false;
         };
 
         // Modern C++23 functions returning expected values
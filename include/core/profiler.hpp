@@ -0,0 +1,196 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/trace_recorder.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cuda_runtime_api.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef GS_PROFILING_ZONES
+#include <nvtx3/nvToolsExt.h>
+#endif
+
+namespace gs::core {
+
+    // GPU time of named profiling zones, averaged into a per-iteration breakdown. Zones always emit
+    // NVTX ranges for Nsight Systems. While timing is enabled, zones opened on the enabling thread
+    // also record a CUDA event pair on the current stream. end_iteration resolves the pairs of the
+    // iteration before, which have mostly completed by then, so timing adds no sync on the step
+    // being recorded.
+    //
+    // Building without ENABLE_PROFILING_ZONES compiles zones down to nothing.
+    class Profiler {
+    public:
+        // Mean GPU time and count of a zone per iteration
+        struct ZoneTime {
+            const char* name = nullptr;
+            int depth = 0; // Zones open around it
+            double ms = 0.0;
+            double calls = 0.0;
+        };
+
+        static Profiler& get();
+
+        // Starts timing zones of the calling thread and logs the breakdown every report_every
+        // iterations, or only keeps it for recent_times() without log. 0 logs what is left and stops.
+        void enable(int report_every, bool log = true);
+
+        bool timing() const {
+            return enabled_.load(std::memory_order_relaxed) &&
+                   owner_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+        }
+
+        // Timing thread only. Zones nest and close within the iteration they opened in, name must
+        // outlive the profiler (a string literal).
+        void begin_zone(const char* name);
+        void end_zone();
+        void end_iteration(int iteration);
+
+        // Means since timing was last enabled, unaffected by the periodic reports
+        std::vector<ZoneTime> session_times() const;
+
+        // Means of the latest report window, from any thread
+        std::vector<ZoneTime> recent_times() const;
+
+    private:
+        struct Record {
+            const char* name = nullptr;
+            int depth = 0;
+            cudaEvent_t begin = nullptr;
+            cudaEvent_t end = nullptr;
+            bool closed = false;
+        };
+
+        struct Total {
+            const char* name = nullptr;
+            int depth = 0;
+            double ms = 0.0;
+            int64_t calls = 0;
+        };
+
+        Profiler() = default;
+        ~Profiler();
+
+        cudaEvent_t acquire_event();
+        // Returns the frame's events to the pool, adding its times to the totals with accumulate
+        bool resolve(std::vector<Record>& frame, bool accumulate);
+        void report(int iteration);
+        static void add(std::vector<Total>& totals, const Record& record, float ms);
+
+        std::atomic<bool> enabled_{false};
+        std::atomic<std::thread::id> owner_{};
+        int report_every_ = 0;
+        bool log_reports_ = true;
+
+        std::array<std::vector<Record>, 2> frames_; // The current iteration and the one before
+        int current_ = 0;
+        std::vector<size_t> open_;        // Records of the current frame still open, innermost last
+        std::vector<cudaEvent_t> events_; // Free timing events
+
+        std::vector<Total> totals_; // In order of first appearance, since the last report
+        int iterations_ = 0;
+        std::vector<Total> session_totals_;
+        int session_iterations_ = 0;
+
+        mutable std::mutex recent_mutex_;
+        std::vector<ZoneTime> recent_;
+    };
+
+    // RAII NVTX range and, while the profiler is timing, GPU time of the enclosed work. While the
+    // trace recorder records, also a host and a GPU span of the trace. end() closes the zone early
+    // for phases that are not a lexical scope.
+    class ProfileZone {
+    public:
+        explicit ProfileZone(const char* name) {
+#ifdef GS_PROFILING_ZONES
+            nvtxRangePushA(name);
+            open_ = true;
+            auto& profiler = Profiler::get();
+            timed_ = profiler.timing();
+            if (timed_) {
+                profiler.begin_zone(name);
+            }
+            auto& trace = TraceRecorder::get();
+            if (trace.recording()) {
+                name_ = name;
+                trace_begin_ns_ = trace.now_ns();
+                trace_event_ = trace.begin_gpu_span();
+            }
+#else
+            (void)name;
+#endif
+        }
+
+        ~ProfileZone() { end(); }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+
+        void end() {
+#ifdef GS_PROFILING_ZONES
+            if (!open_) {
+                return;
+            }
+            open_ = false;
+            if (timed_) {
+                Profiler::get().end_zone();
+            }
+            if (trace_begin_ns_ >= 0) {
+                auto& trace = TraceRecorder::get();
+                trace.end_gpu_span(name_, trace_event_);
+                trace.add_host_span(name_, trace_begin_ns_, trace.now_ns());
+            }
+            nvtxRangePop();
+#endif
+        }
+
+    private:
+#ifdef GS_PROFILING_ZONES
+        bool open_ = false;
+        bool timed_ = false;
+        const char* name_ = nullptr;
+        int64_t trace_begin_ns_ = -1;
+        cudaEvent_t trace_event_ = nullptr;
+#endif
+    };
+
+    // Times zones on the constructing thread for its lifetime, report_every 0 leaves timing off
+    class ProfilingSession {
+    public:
+        explicit ProfilingSession(int report_every, bool log = true)
+            : active_(report_every > 0) {
+            if (active_) {
+                Profiler::get().enable(report_every, log);
+            }
+        }
+
+        ~ProfilingSession() {
+            if (active_) {
+                Profiler::get().enable(0);
+            }
+        }
+
+        ProfilingSession(const ProfilingSession&) = delete;
+        ProfilingSession& operator=(const ProfilingSession&) = delete;
+
+    private:
+        bool active_;
+    };
+
+} // namespace gs::core
+
+#define GS_PROFILE_CONCAT_IMPL(a, b) a##b
+#define GS_PROFILE_CONCAT(a, b)      GS_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef GS_PROFILING_ZONES
+#define PROFILE_ZONE(name) ::gs::core::ProfileZone GS_PROFILE_CONCAT(_profile_zone, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#endif
@@ -0,0 +1,82 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+// include/core/row_storage.hpp
+#pragma once
+#include <algorithm>
+#include <torch/torch.h>
+
+// Row storage with a reserve, like std::vector in VRAM: a tensor holds the leading rows of an
+// allocation that may have room for more, so growing writes in place until the reserve runs out.
+// The returned tensors share the allocation but not the autograd version counter, only use them
+// between steps (under NoGradGuard) and re-set requires_grad on the result.
+namespace gs {
+
+    // Rows the allocation behind tensor can hold, counted from its first row
+    inline int64_t row_capacity(const torch::Tensor& tensor) {
+        if (!tensor.defined() || tensor.dim() == 0) {
+            return 0;
+        }
+        int64_t row_elements = 1;
+        for (int64_t d = 1; d < tensor.dim(); ++d) {
+            row_elements *= tensor.size(d);
+        }
+        if (!tensor.is_contiguous() || row_elements == 0) {
+            return tensor.size(0);
+        }
+        const int64_t storage_elements =
+            static_cast<int64_t>(tensor.storage().nbytes() / tensor.element_size()) - tensor.storage_offset();
+        return storage_elements / row_elements;
+    }
+
+    // The first rows of tensor's allocation with tensor's row shape, rows <= row_capacity(tensor)
+    inline torch::Tensor rows_view(const torch::Tensor& tensor, const int64_t rows) {
+        auto sizes = tensor.sizes().vec();
+        sizes[0] = rows;
+        std::vector<int64_t> strides(sizes.size(), 1);
+        for (int64_t d = static_cast<int64_t>(sizes.size()) - 2; d >= 0; --d) {
+            strides[d] = strides[d + 1] * std::max<int64_t>(sizes[d + 1], 1);
+        }
+        auto view = torch::empty({0}, tensor.options());
+        view.set_(tensor.storage(), tensor.storage_offset(), sizes, strides);
+        return view;
+    }
+
+    // tensor's rows in an allocation with room for at least capacity rows
+    inline torch::Tensor reserve_rows(const torch::Tensor& tensor, const int64_t capacity) {
+        if (tensor.is_contiguous() && row_capacity(tensor) >= capacity) {
+            return tensor;
+        }
+        auto sizes = tensor.sizes().vec();
+        sizes[0] = std::max(capacity, tensor.size(0));
+        const auto storage = torch::empty(sizes, tensor.options());
+        storage.narrow(0, 0, tensor.size(0)).copy_(tensor);
+        return rows_view(storage, tensor.size(0));
+    }
+
+    // tensor followed by rows. Written in place while the reserve lasts, otherwise moved to an
+    // allocation with half again as many rows as needed
+    inline torch::Tensor append_rows(const torch::Tensor& tensor, const torch::Tensor& rows) {
+        const int64_t n = tensor.size(0);
+        const int64_t total = n + rows.size(0);
+        const auto grown = row_capacity(tensor) >= total && tensor.is_contiguous()
+                               ? tensor
+                               : reserve_rows(tensor, total + total / 2);
+        auto result = rows_view(grown, total);
+        result.narrow(0, n, rows.size(0)).copy_(rows);
+        return result;
+    }
+
+    // tensor's rows at indices, compacted to the front of the same allocation
+    inline torch::Tensor keep_rows(const torch::Tensor& tensor, const torch::Tensor& indices) {
+        const auto kept = tensor.index_select(0, indices);
+        if (!tensor.is_contiguous()) {
+            return kept;
+        }
+        auto result = rows_view(tensor, kept.size(0));
+        result.copy_(kept);
+        return result;
+    }
+
+} // namespace gs
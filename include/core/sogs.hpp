@@ -14,10 +14,15 @@ namespace gs {
 
         struct SogWriteOptions {
             int iterations = 10;
+            int webp_level = 6; // Lossless WebP preset, 0 (fastest) to 9 (smallest files)
             bool use_gpu = true;
             std::filesystem::path output_path;
         };
 
+        // Entries of the shN palette write_sog clusters for num_splats: min(64, 2^floor(log2(N / 1024)))
+        // thousand, at most one per splat
+        int sog_palette_size(int64_t num_splats);
+
         std::expected<void, std::string> write_sog(
             const SplatData& splat_data,
             const SogWriteOptions& options);
@@ -11,6 +11,7 @@
 #include <geometry/bounding_box.hpp>
 #include <glm/glm.hpp>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <torch/torch.h>
 #include <vector>
@@ -49,21 +50,32 @@ namespace gs {
             torch::Tensor scene_center,
             const PointCloud& point_cloud);
 
-        // Computed getters (implemented in cpp)
+        // Computed getters (implemented in cpp). Outside of autograd opacity, rotation and scaling are
+        // cached until the raw tensor is replaced or its version counter moves; don't modify them in place.
         torch::Tensor get_means() const;
         torch::Tensor get_opacity() const;
         torch::Tensor get_rotation() const;
         torch::Tensor get_scaling() const;
         torch::Tensor get_shs() const;
 
-        // that's really a stupid hack for now. This stuff must go into a CUDA kernel
+        // Applies a similarity transform in place on the device: means, rotations, log scales and
+        // the shN bands. Non-uniform scale is averaged, the Gaussians stay isotropic under it.
         SplatData& transform(const glm::mat4& transform_matrix);
 
         // Simple inline getters
         int get_active_sh_degree() const { return _active_sh_degree; }
+        int get_max_sh_degree() const { return _max_sh_degree; }
+        // Highest degree shN holds the bands of, below the max degree while SH storage grows progressively
+        int get_stored_sh_degree() const;
         float get_scene_scale() const { return _scene_scale; }
         int64_t size() const { return _means.size(0); }
 
+        // Gaussians the parameter allocations hold before growing reallocates, see row_storage.hpp
+        int64_t capacity() const;
+        // Moves the parameters to allocations with room for capacity Gaussians; call before the
+        // optimizer takes them, it tracks parameters by tensor
+        void reserve(int64_t capacity);
+
         // Raw tensor access for optimization (inline for performance)
         inline torch::Tensor& means() { return _means; }
         inline const torch::Tensor& means() const { return _means; }
@@ -78,23 +90,64 @@ namespace gs {
         inline torch::Tensor& shN() { return _shN; }
         inline const torch::Tensor& shN() const { return _shN; }
 
-        // Utility methods
+        // The active degree stays within the stored bands
         void increment_sh_degree();
         void set_active_sh_degree(int sh_degree);
 
         // Export methods - join_threads controls sync vs async
-        // if stem is not empty save splat as stem.ply
-        void save_ply(const std::filesystem::path& root, int iteration, bool join_threads = true, std::string stem = "") const;
-        std::filesystem::path save_sog(const std::filesystem::path& root, int iteration, int kmeans_iterations = 10, bool join_threads = true) const;
+        // CUDA models are snapshotted on the GPU first; an async save returns once the snapshot is
+        // queued, so training can keep updating the model right away. The vertex records go to disk
+        // in fixed-size chunks through double-buffered pinned memory, host memory stays bounded.
+        // if stem is not empty save splat as stem.ply; direct_io writes the vertex block with O_DIRECT
+        void save_ply(const std::filesystem::path& root, int iteration, bool join_threads = true, std::string stem = "",
+                      bool direct_io = false) const;
+        // An async SOG save of a CUDA model clusters a device copy on a low-priority stream, the
+        // WebP encodes run on CPU threads; the returned path is written once the save finished.
+        std::filesystem::path save_sog(const std::filesystem::path& root, int iteration, int kmeans_iterations = 10, bool join_threads = true, int webp_level = 6) const;
+        // Chunked level-of-detail file for streaming viewers, always synchronous
+        std::filesystem::path save_lod(const std::filesystem::path& root, int iteration) const;
 
         // Get attribute names for the PLY format
         std::vector<std::string> get_attribute_names() const;
 
         SplatData crop_by_cropbox(const gs::geometry::BoundingBox& bounding_box) const;
 
+        // Detached deep copy of the Gaussian parameters, unaffected by later optimizer updates
+        SplatData clone() const;
+
+        // Copy sharing the parameter storage, it sees in-place updates but keeps the tensors alive
+        // after this model replaces or drops them
+        SplatData share() const;
+
     public:
         // Holds the magnitude of the screen space gradient
         torch::Tensor _densification_info = torch::empty({0});
+        // Largest blending weight of each Gaussian in any pixel the fastgs backward walked since the
+        // strategy reset it, -1 for the ones not rasterized since; empty when nothing tracks it
+        torch::Tensor _max_contribution = torch::empty({0});
+
+        // SH codebook mode: the optimizer trains _sh_palette [K, C, 3] in place of shN and every
+        // Gaussian indexes one entry through _sh_labels [N]. _shN is then the gathered view.
+        torch::Tensor _sh_palette;
+        torch::Tensor _sh_labels;
+        bool has_sh_codebook() const { return _sh_palette.defined(); }
+        // Rebuilds _shN from the palette; call before each forward so its graph reaches the palette
+        void gather_sh_codebook();
+
+        // Low-rank SH mode: the optimizer trains per-Gaussian weights _sh_coeffs [N, R] and a shared
+        // basis _sh_basis [R, C, 3] in place of shN, and _shN is their product.
+        torch::Tensor _sh_coeffs;
+        torch::Tensor _sh_basis;
+        bool has_sh_basis() const { return _sh_basis.defined(); }
+        // Rebuilds _shN from the weights and basis; call before each forward like gather_sh_codebook
+        void expand_sh_basis();
+
+        // Persistent int64 [N] Gaussian ids for delta saves, undefined until enabled. The strategies
+        // keep them aligned with the rows, appended Gaussians draw fresh ids.
+        torch::Tensor _gaussian_ids;
+        int64_t _next_gaussian_id = 0;
+        void enable_gaussian_ids();
+        void append_gaussian_ids(int64_t count);
 
     private:
         int _active_sh_degree = 0;
@@ -108,6 +161,21 @@ namespace gs {
         torch::Tensor _rotation;
         torch::Tensor _opacity;
 
+        // Activated tensor of a getter and the raw tensor it came from. The weak reference keeps the
+        // source's address from being reused without keeping its storage alive.
+        struct ActivationCache {
+            std::optional<c10::weak_intrusive_ptr<c10::TensorImpl, c10::UndefinedTensorImpl>> source;
+            int64_t version = 0;
+            torch::Tensor value;
+        };
+        mutable std::mutex _activation_mutex;
+        mutable ActivationCache _opacity_cache;
+        mutable ActivationCache _rotation_cache;
+        mutable ActivationCache _scaling_cache;
+
+        template <typename Compute>
+        torch::Tensor cached_activation(ActivationCache& cache, const torch::Tensor& raw, Compute&& compute) const;
+
         // Async save management
         mutable std::mutex _save_mutex;
         mutable std::vector<std::future<void>> _save_futures;
@@ -0,0 +1,115 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/splat_data.hpp"
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <future>
+#include <string>
+
+namespace gs {
+    namespace core {
+
+        // Differential splat save (.lfsdelta). A file stores the model at one iteration relative to
+        // the file of base_iteration in the same directory, keyed by the persistent Gaussian ids:
+        // the ids removed since, the changed Gaussians as quantized deltas and the added ones in
+        // full. A keyframe (base_iteration -1) stores everything as added.
+        //
+        // After the header come, in order:
+        //   removed ids                     varint gaps, ascending
+        //   changed ids                     varint gaps, ascending
+        //   changed values                  zigzag varints, num_changed x values, in step units
+        //   added ids                       varint gaps, ascending
+        //   added values                    float32, num_added x values
+        // with values per Gaussian: means 3, sh0 3, shN 3 * shN_coeffs (channel-major as in PLY),
+        // opacity 1 (logit), scaling 3 (log) and rotation 4 (normalized).
+        //
+        // Deltas are taken against the state a reader reconstructs, not the exact previous model,
+        // so the quantization error does not accumulate along the chain.
+        inline constexpr char SPLAT_DELTA_MAGIC[8] = {'L', 'F', 'S', 'D', 'L', 'T', '0', '1'};
+        inline constexpr uint32_t SPLAT_DELTA_VERSION = 1;
+        inline constexpr const char* SPLAT_DELTA_EXTENSION = ".lfsdelta";
+
+        struct SplatDeltaHeader {
+            char magic[8];
+            uint32_t version;
+            int32_t iteration;
+            int32_t base_iteration; // -1: keyframe
+            uint32_t sh_degree;
+            uint32_t shN_coeffs;
+            float scene_scale;
+            float steps[6]; // Quantization step of means, sh0, shN, opacity, scaling, rotation
+            uint64_t num_gaussians;
+            uint64_t num_removed;
+            uint64_t num_changed;
+            uint64_t num_added;
+            uint64_t reserved;
+        };
+        static_assert(sizeof(SplatDeltaHeader) == 96, "SplatDeltaHeader layout is part of the file format");
+
+        constexpr int64_t splat_delta_values_per_gaussian(const uint32_t shN_coeffs) {
+            return 3 + 3 + 3 * static_cast<int64_t>(shN_coeffs) + 1 + 3 + 4;
+        }
+
+        // Path of the delta file of iteration inside directory
+        std::filesystem::path splat_delta_path(const std::filesystem::path& directory, int iteration);
+
+        // Writes one delta file per save against the previous one. The model is snapshotted to the
+        // host on the calling thread, diffing and writing run in the background, one save at a time.
+        class SplatDeltaWriter {
+        public:
+            struct Options {
+                std::filesystem::path directory;
+                int keyframe_interval = 10; // Every n-th save is a keyframe, bounding the chain a reader replays
+                // Quantization steps, means_step is relative to the scene scale
+                float means_step = 1e-5f;
+                float sh0_step = 1e-4f;
+                float shN_step = 1e-4f;
+                float opacity_step = 1e-3f;
+                float scaling_step = 1e-4f;
+                float rotation_step = 1e-5f;
+            };
+
+            explicit SplatDeltaWriter(Options options);
+            ~SplatDeltaWriter();
+
+            SplatDeltaWriter(const SplatDeltaWriter&) = delete;
+            SplatDeltaWriter& operator=(const SplatDeltaWriter&) = delete;
+
+            // splat_data must be on CUDA and have Gaussian ids enabled
+            std::filesystem::path save(const SplatData& splat_data, int iteration, bool join);
+
+            void wait();
+
+        private:
+            struct Snapshot {
+                torch::Tensor ids;    // int64 [N]
+                torch::Tensor values; // float32 [N, V]
+                int iteration;
+                uint32_t sh_degree;
+                uint32_t shN_coeffs;
+                float scene_scale;
+            };
+
+            std::expected<void, std::string> write(Snapshot snapshot);
+
+            Options options_;
+            std::future<void> pending_;
+            // The reconstructed state of the last file, sorted by id
+            torch::Tensor reference_ids_;
+            torch::Tensor reference_values_;
+            int reference_iteration_ = -1;
+            int saves_since_keyframe_ = 0;
+        };
+
+        // Replays the chain ending at the delta file of iteration in directory
+        std::expected<SplatData, std::string> materialize_splat_delta(
+            const std::filesystem::path& directory,
+            int iteration);
+
+    } // namespace core
+} // namespace gs
@@ -0,0 +1,69 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/splat_data.hpp"
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <string>
+
+namespace gs {
+    namespace core {
+
+        // Chunked level-of-detail splat file (.lfslod). The Gaussians are Morton-sorted and cut into
+        // spatial chunks, every chunk is stored at num_levels resolutions where level l merges groups
+        // of 4^l neighbours. The file is a header, a table with one SplatLodBlock per (chunk, level)
+        // and the page-aligned blocks, so a reader can map it and upload only the blocks it needs.
+        //
+        // A block holds float32 arrays one after the other: means [n, 3], sh0 [n, 3], shN [n, shN_coeffs, 3],
+        // scaling [n, 3] (log), rotation [n, 4] (normalized w, x, y, z) and opacity [n] (logit).
+        inline constexpr char SPLAT_LOD_MAGIC[8] = {'L', 'F', 'S', 'L', 'O', 'D', '0', '1'};
+        inline constexpr uint32_t SPLAT_LOD_VERSION = 1;
+        inline constexpr uint64_t SPLAT_LOD_ALIGNMENT = 4096;
+        inline constexpr const char* SPLAT_LOD_EXTENSION = ".lfslod";
+
+        struct SplatLodHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t sh_degree;
+            uint32_t shN_coeffs;
+            uint32_t num_chunks;
+            uint32_t num_levels;
+            float scene_scale;
+            uint64_t num_gaussians; // At level 0
+            uint64_t table_offset;
+            uint64_t reserved[2];
+        };
+        static_assert(sizeof(SplatLodHeader) == 64, "SplatLodHeader layout is part of the file format");
+
+        struct SplatLodBlock {
+            float bounds_min[3]; // Means padded by three standard deviations of the largest axis
+            float bounds_max[3];
+            uint32_t chunk;
+            uint32_t level;
+            uint64_t offset; // From the start of the file, a multiple of SPLAT_LOD_ALIGNMENT
+            uint64_t count;
+        };
+        static_assert(sizeof(SplatLodBlock) == 48, "SplatLodBlock layout is part of the file format");
+
+        // float32 values per Gaussian in a block
+        constexpr uint64_t splat_lod_floats_per_gaussian(const uint32_t shN_coeffs) {
+            return 3 + 3 + 3 * static_cast<uint64_t>(shN_coeffs) + 3 + 4 + 1;
+        }
+
+        struct SplatLodWriteOptions {
+            std::filesystem::path output_path;
+            int chunk_size = 65536; // Gaussians per chunk at level 0
+            int max_levels = 5;
+            int min_block_size = 256; // No further level once every chunk's coarsest block is this small
+        };
+
+        std::expected<void, std::string> write_splat_lod(
+            const SplatData& splat_data,
+            const SplatLodWriteOptions& options);
+
+    } // namespace core
+} // namespace gs
@@ -0,0 +1,46 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+namespace gs::core {
+
+    // CPU placement of the host worker threads: dataloader workers, file readers and image savers.
+    // Once configured to pin, each of them restricts itself to the CPUs of the training GPU's NUMA
+    // node on start, so the decode and pinned staging buffers they touch first are allocated on
+    // that node too. Unconfigured, off Linux or without a readable topology, threads float as before.
+    class ThreadPlacement {
+    public:
+        static ThreadPlacement& get();
+
+        // Reads the CPUs local to the device, limited to the ones this process may run on
+        void configure(int cuda_device, bool pin);
+
+        // Restricts the calling thread to cpus() when configured to pin
+        void pin_current_thread() const;
+
+        // GPU-local CPUs, or every CPU of the process when unconfigured or unknown
+        std::vector<int> cpus() const;
+
+    private:
+        ThreadPlacement() = default;
+
+        mutable std::mutex mutex_;
+        std::vector<int> cpus_;
+        bool pin_ = false;
+    };
+
+    // How a CPU thread budget is spent: decode workers first, OIIO's pool gets the rest
+    struct ThreadBudget {
+        int loader_workers = 1;
+        int image_io_threads = 1;
+    };
+
+    // Workers are cut to the budget, the OIIO pool never drops below one thread
+    ThreadBudget split_thread_budget(int budget, int requested_workers);
+
+} // namespace gs::core
@@ -0,0 +1,139 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cuda_runtime_api.h>
+#include <deque>
+#include <expected>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace gs::core {
+
+    // Timeline of host thread and GPU activity for chrome://tracing or ui.perfetto.dev, without
+    // Nsight on the machine. While recording, every ProfileZone adds a span on the track of its
+    // thread and a CUDA event pair on the current stream, which becomes a span on the track of
+    // that stream once the GPU got there; TraceSpan marks host-only work such as image decodes.
+    // Spans go to a ring buffer that keeps the newest ones, stop() writes it as Chrome trace JSON.
+    class TraceRecorder {
+    public:
+        static TraceRecorder& get();
+
+        // Keeps the newest capacity spans, stop() writes them to output
+        void start(std::filesystem::path output, size_t capacity);
+        // Waits for the GPU spans still pending and writes the trace
+        std::expected<void, std::string> stop();
+
+        bool recording() const { return recording_.load(std::memory_order_relaxed); }
+
+        // Track name of the calling thread, kept across recordings
+        void set_thread_name(std::string name);
+
+        // Nanoseconds of the trace clock
+        int64_t now_ns() const;
+
+        // name must outlive the recorder (a string literal)
+        void add_host_span(const char* name, int64_t begin_ns, int64_t end_ns);
+
+        // Event recorded on the current stream, null when the GPU side is not traced
+        cudaEvent_t begin_gpu_span();
+        // Closes a span begun with begin_gpu_span on the current stream, begin may be null
+        void end_gpu_span(const char* name, cudaEvent_t begin);
+
+    private:
+        struct Span {
+            const char* name = nullptr;
+            int64_t begin_ns = 0;
+            int64_t duration_ns = 0;
+            uint32_t track = 0;
+            bool gpu = false;
+        };
+
+        struct PendingGpuSpan {
+            const char* name = nullptr;
+            cudaEvent_t begin = nullptr;
+            cudaEvent_t end = nullptr;
+            uint32_t track = 0;
+        };
+
+        TraceRecorder() = default;
+        ~TraceRecorder();
+
+        uint32_t thread_track();
+        cudaEvent_t acquire_event();
+        void push(const Span& span);
+        // Moves completed GPU spans into the ring, all of them with wait
+        void drain(bool wait);
+        std::expected<void, std::string> write() const;
+
+        std::atomic<bool> recording_{false};
+        const std::chrono::steady_clock::time_point epoch_ = std::chrono::steady_clock::now();
+
+        mutable std::mutex mutex_;
+        std::filesystem::path output_;
+        std::vector<Span> ring_;
+        size_t next_ = 0;
+        bool wrapped_ = false;
+        size_t dropped_ = 0;
+
+        std::map<uint32_t, std::string> thread_names_;
+        std::map<cudaStream_t, uint32_t> stream_tracks_;
+        std::deque<PendingGpuSpan> pending_;
+        std::vector<cudaEvent_t> events_; // Free span events
+        cudaEvent_t reference_ = nullptr; // GPU time of reference_ns_
+        int64_t reference_ns_ = 0;
+    };
+
+    // RAII host span on the calling thread's track while the trace recorder is recording
+    class TraceSpan {
+    public:
+        explicit TraceSpan(const char* name)
+            : name_(name) {
+            auto& recorder = TraceRecorder::get();
+            if (recorder.recording()) {
+                begin_ns_ = recorder.now_ns();
+            }
+        }
+
+        ~TraceSpan() {
+            if (begin_ns_ >= 0) {
+                auto& recorder = TraceRecorder::get();
+                recorder.add_host_span(name_, begin_ns_, recorder.now_ns());
+            }
+        }
+
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan& operator=(const TraceSpan&) = delete;
+
+    private:
+        const char* name_;
+        int64_t begin_ns_ = -1;
+    };
+
+    // Records a trace for its lifetime and writes it at the end, an empty output records nothing
+    class TraceSession {
+    public:
+        TraceSession(const std::string& output, size_t capacity);
+        ~TraceSession();
+
+        TraceSession(const TraceSession&) = delete;
+        TraceSession& operator=(const TraceSession&) = delete;
+
+    private:
+        bool active_;
+    };
+
+} // namespace gs::core
+
+#define GS_TRACE_CONCAT_IMPL(a, b) a##b
+#define GS_TRACE_CONCAT(a, b)      GS_TRACE_CONCAT_IMPL(a, b)
+
+#define TRACE_SPAN(name) ::gs::core::TraceSpan GS_TRACE_CONCAT(_trace_span, __LINE__)(name)
@@ -0,0 +1,24 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <torch/torch.h>
+
+namespace gs {
+
+    /**
+     * @brief Encodes an 8-bit image into BC7 mode 6 blocks, one thread per 4x4 block
+     *
+     * The endpoints lie on the principal axis of the block colors, quantized to 7 bits plus the
+     * p-bit of least error, and every texel takes the nearest of the 16 interpolated colors. Missing
+     * channels are filled like an unsized GL upload: G and B with 0, A with 255.
+     *
+     * @param pixels [H, W, C] uint8 CUDA, C in 1..4, rows in upload order
+     * @return [ceil(H / 4) * ceil(W / 4) * 16] uint8 CUDA, blocks row by row, ready for
+     *         glCompressedTexImage2D with GL_COMPRESSED_RGBA_BPTC_UNORM
+     */
+    torch::Tensor encode_bc7(const torch::Tensor& pixels);
+
+} // namespace gs
@@ -50,22 +50,13 @@ namespace fs_internal {
             TORCH_CHECK(img1.sizes() == img2.sizes(),
                         "img1 and img2 must have the same shape");
 
-            auto out = fusedssim(kC1, kC2, img1, img2, train);
+            // 'valid' crops the 5 pixel border inside the kernel
+            auto out = fusedssim(kC1, kC2, img1, img2, train, padding == "valid");
             auto map = std::get<0>(out);
             auto dm1 = std::get<1>(out);
             auto ds1sq = std::get<2>(out);
             auto ds12 = std::get<3>(out);
 
-            if (padding == "valid") {
-                using torch::indexing::Slice;
-                // Convert negative indices to positive ones
-                int64_t h = map.size(2); // height
-                int64_t w = map.size(3); // width
-                if (h > 10 && w > 10) {  // Ensure we have enough pixels to crop
-                    map = map.index({Slice(), Slice(), Slice(5, h - 5), Slice(5, w - 5)});
-                }
-            }
-
             ctx->save_for_backward({img1.detach(), img2, dm1, ds1sq, ds12});
             ctx->saved_data["padding"] = padding;
             return map;
@@ -82,25 +73,81 @@ namespace fs_internal {
             std::string padding = ctx->saved_data["padding"].toStringRef();
 
             auto dL_dmap = grad_out[0];
-            if (padding == "valid") {
-                using torch::indexing::Slice;
-                auto full = torch::zeros_like(img1);
-                // Convert negative indices to positive ones
-                int64_t h = full.size(2); // height
-                int64_t w = full.size(3); // width
-                if (h > 10 && w > 10) {   // Ensure we have enough pixels to crop
-                    full.index_put_({Slice(), Slice(), Slice(5, h - 5), Slice(5, w - 5)},
-                                    dL_dmap);
-                }
-                dL_dmap = full;
-            }
-
             auto grad_img1 = fusedssim_backward(
-                kC1, kC2, img1, img2, dL_dmap, dm1, ds1sq, ds12);
+                kC1, kC2, img1, img2, dL_dmap, dm1, ds1sq, ds12, padding == "valid");
 
             return {grad_img1, torch::Tensor(), torch::Tensor(), torch::Tensor()};
         }
     };
+
+    /* ------- fused (1 - lambda) * L1 + lambda * (1 - SSIM) with compositing --- */
+    class _FusedPhotometricLoss : public torch::autograd::Function<_FusedPhotometricLoss> {
+    public:
+        static torch::Tensor forward(torch::autograd::AutogradContext* ctx,
+                                     torch::Tensor image,
+                                     torch::Tensor alpha,
+                                     torch::Tensor background,
+                                     torch::Tensor mask,
+                                     torch::Tensor bilateral_grid,
+                                     torch::Tensor gt,
+                                     double lambda_dssim) {
+            ctx->saved_data["image_sizes"] = image.sizes().vec();
+            image = image.contiguous();
+            gt = gt.contiguous();
+            if (image.dim() == 3) {
+                image = image.unsqueeze(0);
+            }
+            if (gt.dim() == 3) {
+                gt = gt.unsqueeze(0);
+            }
+            TORCH_CHECK(image.dim() == 4 && image.sizes() == gt.sizes(),
+                        "fused_photometric_loss: image ", image.sizes(), " and ground truth ", gt.sizes(),
+                        " must match as [N,C,H,W]");
+            const int64_t h = image.size(2);
+            const int64_t w = image.size(3);
+            const bool composite = alpha.defined() && alpha.numel() > 0;
+            if (composite) {
+                alpha = alpha.contiguous();
+                background = background.contiguous();
+                TORCH_CHECK(alpha.numel() == image.size(0) * h * w && background.numel() == image.size(1),
+                            "fused_photometric_loss: alpha must hold one value per pixel and background one per channel");
+            }
+            if (mask.defined() && mask.numel() > 0) {
+                mask = mask.contiguous();
+                TORCH_CHECK(mask.numel() == h * w, "fused_photometric_loss: mask must be [H, W]");
+            }
+            if (bilateral_grid.defined() && bilateral_grid.numel() > 0) {
+                bilateral_grid = bilateral_grid.contiguous();
+            }
+
+            auto [sums, dm1, ds1sq, ds12] = fused_l1_ssim(kC1, kC2, image, alpha, background, mask, bilateral_grid, gt,
+                                                          /*train=*/true);
+
+            // Same averages as torch::l1_loss and fused_ssim(..., "valid")
+            const double n_l1 = static_cast<double>(image.numel());
+            const double n_ssim = (h > 10 && w > 10) ? static_cast<double>(image.size(0) * image.size(1) * (h - 10) * (w - 10))
+                                                     : n_l1;
+            const double l1_weight = (1.0 - lambda_dssim) / n_l1;
+            const double ssim_weight = -lambda_dssim / n_ssim;
+
+            ctx->save_for_backward({image.detach(), alpha, background, mask, bilateral_grid, gt, dm1, ds1sq, ds12});
+            ctx->saved_data["l1_weight"] = l1_weight;
+            ctx->saved_data["ssim_weight"] = ssim_weight;
+            return (sums[0] * l1_weight + sums[1] * ssim_weight + lambda_dssim).squeeze();
+        }
+
+        static std::vector<torch::Tensor> backward(torch::autograd::AutogradContext* ctx,
+                                                   std::vector<torch::Tensor> grad_out) {
+            auto vars = ctx->get_saved_variables();
+            auto [grad_image, grad_alpha, grad_grid] = fused_l1_ssim_backward(
+                static_cast<float>(ctx->saved_data["l1_weight"].toDouble()),
+                static_cast<float>(ctx->saved_data["ssim_weight"].toDouble()),
+                vars[0], vars[1], vars[2], vars[3], vars[4], vars[5], grad_out[0], vars[6], vars[7], vars[8]);
+
+            grad_image = grad_image.view(ctx->saved_data["image_sizes"].toIntVector());
+            return {grad_image, grad_alpha, torch::Tensor(), torch::Tensor(), grad_grid, torch::Tensor(), torch::Tensor()};
+        }
+    };
 } // namespace fs_internal
 
 // ---------------------------------------------------------------------------
@@ -110,6 +157,17 @@ torch::Tensor fused_ssim(torch::Tensor img1, torch::Tensor img2,
                          const std::string& padding = "same",
                          bool train = true);
 
+// (1 - lambda_dssim) * L1 + lambda_dssim * (1 - SSIM 'valid') over
+// mask * (image + (1 - alpha) * background) against mask * gt in one kernel per
+// direction. Without alpha the image is used as rendered; gt may be float32 or uint8.
+// A [12, L, H, W] bilateral_grid is sliced over the clamped composite on load, as
+// BilateralGrid::apply would, and receives its gradient from the same backward.
+torch::Tensor fused_photometric_loss(torch::Tensor image, torch::Tensor gt, float lambda_dssim,
+                                     torch::Tensor alpha = {},
+                                     torch::Tensor background = {},
+                                     torch::Tensor mask = {},
+                                     torch::Tensor bilateral_grid = {});
+
 // ---------------------------------------------------------------------------
 // HOST-ONLY IMPLEMENTATION  ➜ excluded from device compilation
 // ---------------------------------------------------------------------------
@@ -120,4 +178,11 @@ inline torch::Tensor fused_ssim(torch::Tensor img1, torch::Tensor img2,
     img1 = img1.contiguous();
     return fs_internal::_FusedSSIM::apply(img1, img2, padding, train).mean();
 }
+
+inline torch::Tensor fused_photometric_loss(torch::Tensor image, torch::Tensor gt, float lambda_dssim,
+                                            torch::Tensor alpha, torch::Tensor background, torch::Tensor mask,
+                                            torch::Tensor bilateral_grid) {
+    return fs_internal::_FusedPhotometricLoss::apply(image, alpha, background, mask, bilateral_grid, gt,
+                                                     static_cast<double>(lambda_dssim));
+}
 #endif // !__CUDA_ARCH__
\ No newline at end of file
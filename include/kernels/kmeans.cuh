@@ -12,17 +12,23 @@ namespace gs {
         /**
          * @brief GPU-accelerated k-means clustering
          *
+         * Seeds with k-means++ on the device. Once N exceeds the batch size, every iteration is a
+         * mini-batch step; the distances are GEMMs on tensor cores (TF32) and the final labels
+         * come from one full assignment.
+         *
          * @param data Input data tensor [N, D] where N is number of points, D is dimensions
          * @param k Number of clusters
          * @param iterations Maximum number of iterations
          * @param tolerance Convergence tolerance (stop if centroids move less than this)
+         * @param batch_size Points per mini-batch step, 0: max(65536, 4 * k), full batches below N
          * @return Tuple of (centroids [k, D], labels [N])
          */
         std::tuple<torch::Tensor, torch::Tensor> kmeans(
             const torch::Tensor& data,
             int k,
             int iterations = 10,
-            float tolerance = 1e-4f);
+            float tolerance = 1e-4f,
+            int batch_size = 0);
 
         /**
          * @brief GPU-accelerated 1D k-means clustering with optimal initialization
@@ -0,0 +1,25 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <torch/torch.h>
+
+namespace gs {
+
+    /**
+     * @brief Mean distance of every point to its 3 nearest neighbors, on the GPU
+     *
+     * Points are bucketed into a uniform grid sized from the robust extent of the cloud, with the
+     * cells in Morton order, and each point searches growing shells of cells until no unvisited
+     * cell can hold a closer neighbor. Points still unresolved after a few shells (outliers in
+     * sparse regions) are searched again on a coarser grid. Coincident points don't count as
+     * neighbors, a point without any gets 0.01 like the nanoflann path.
+     *
+     * @param points [N, 3] float32 on CUDA
+     * @return [N] float32 on the device of points
+     */
+    torch::Tensor mean_neighbor_distances(const torch::Tensor& points);
+
+} // namespace gs
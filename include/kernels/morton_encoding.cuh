@@ -4,9 +4,24 @@
 
 #pragma once
 
+#include <cstdint>
 #include <torch/torch.h>
 
 namespace gs {
+
+#ifdef __CUDACC__
+    // Spreads the low 21 bits of a so two zero bits follow each one, the interleave step of a 63-bit code
+    __device__ __forceinline__ uint64_t splitBy3(uint32_t a) {
+        uint64_t x = a & 0x1fffff;
+        x = (x | x << 32) & 0x1f00000000ffff;
+        x = (x | x << 16) & 0x1f0000ff0000ff;
+        x = (x | x << 8) & 0x100f00f00f00f00f;
+        x = (x | x << 4) & 0x10c30c30c30c30c3;
+        x = (x | x << 2) & 0x1249249249249249;
+        return x;
+    }
+#endif
+
     /**
      * @brief Compute Morton codes for 3D positions
      *
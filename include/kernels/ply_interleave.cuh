@@ -0,0 +1,32 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <torch/torch.h>
+
+namespace gs {
+
+    /**
+     * @brief Interleaves the Gaussian parameters into binary PLY vertex records in one pass
+     *
+     * Record layout, all float32: x y z, nx ny nz (zero), f_dc_0..2, f_rest_* (channel-major as
+     * the 3DGS PLY stores them), opacity, scale_0..2, rot_0..3 (normalized).
+     *
+     * @param means [N, 3] float32
+     * @param sh0 [N, 1, 3] float32
+     * @param shN [N, K, 3] float32, float16 or bfloat16
+     * @param opacity [N, 1] float32
+     * @param scaling [N, 3] float32
+     * @param rotation [N, 4] float32 raw quaternions
+     * @return [N, 17 + 3K] float32 on the device of means
+     */
+    torch::Tensor interleave_ply_vertices(const torch::Tensor& means,
+                                          const torch::Tensor& sh0,
+                                          const torch::Tensor& shN,
+                                          const torch::Tensor& opacity,
+                                          const torch::Tensor& scaling,
+                                          const torch::Tensor& rotation);
+
+} // namespace gs
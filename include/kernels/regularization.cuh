@@ -0,0 +1,23 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+#include <torch/torch.h>
+
+namespace gs {
+    namespace regularization {
+
+        // scale_weight * mean(exp(scaling_raw)) + opacity_weight * mean(sigmoid(opacity_raw)) in a
+        // single pass over the Gaussians: the gradients are added into scaling_grad and opacity_grad
+        // in place, without an autograd graph, and the loss comes back as a 0-dim tensor
+        torch::Tensor scale_opacity_reg_cuda(
+            const torch::Tensor& scaling_raw, // [N, 3] float32
+            torch::Tensor& scaling_grad,      // same shape, accumulated into
+            float scale_weight,
+            const torch::Tensor& opacity_raw, // [N, 1] float32
+            torch::Tensor& opacity_grad,      // same shape, accumulated into
+            float opacity_weight);
+
+    } // namespace regularization
+} // namespace gs
@@ -0,0 +1,65 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <array>
+#include <torch/torch.h>
+
+namespace gs {
+
+    // Every function below writes pixel i of an RGBA8 texture from splat order[i] and returns the
+    // texture as a uint8 CUDA tensor [height, width, 4]. Pixels past the last splat keep the padding.
+
+    /**
+     * @brief Quantizes log-transformed means into the low and high bytes of 16-bit positions
+     *
+     * @param means [N, 3] float32
+     * @param order [N] int64 splat of every pixel
+     * @param mins Per-axis minimum of sign(x) * log(|x| + 1)
+     * @param maxs Per-axis maximum of the same
+     * @return {means_l, means_u}
+     */
+    std::pair<torch::Tensor, torch::Tensor> sog_pack_means(const torch::Tensor& means,
+                                                           const torch::Tensor& order,
+                                                           const std::array<float, 3>& mins,
+                                                           const std::array<float, 3>& maxs,
+                                                           int width,
+                                                           int height);
+
+    /**
+     * @brief Smallest-three quaternion packing: three 8-bit components and 252 + the index of the dropped one
+     *
+     * @param rotations [N, 4] float32 (w, x, y, z), normalized here, zero-length ones become identity
+     */
+    torch::Tensor sog_pack_quaternions(const torch::Tensor& rotations,
+                                       const torch::Tensor& order,
+                                       int width,
+                                       int height);
+
+    /**
+     * @brief Writes three 8-bit codebook labels per splat into RGB
+     *
+     * @param labels [3 * N] int32, channel-major as the 1D k-means clusters them
+     * @param alpha [N] float32 in [0, 1] quantized into A, undefined for 255
+     * @param padding Value of every channel of the unused pixels
+     */
+    torch::Tensor sog_pack_codes(const torch::Tensor& labels,
+                                 const torch::Tensor& order,
+                                 const torch::Tensor& alpha,
+                                 int width,
+                                 int height,
+                                 uint8_t padding);
+
+    /**
+     * @brief Writes 16-bit palette labels into R (low byte) and G (high byte)
+     *
+     * @param labels [N] int32
+     */
+    torch::Tensor sog_pack_palette_labels(const torch::Tensor& labels,
+                                          const torch::Tensor& order,
+                                          int width,
+                                          int height);
+
+} // namespace gs
@@ -0,0 +1,37 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+#include <torch/torch.h>
+
+namespace gs {
+    namespace sparsity {
+
+        // ADMM proximal step on the device, no host synchronization:
+        //   z = prune(sigmoid(opacities_raw) + u), u += sigmoid(opacities_raw) - z (if update_dual)
+        // where prune zeroes every value <= the n_prune-th smallest (found by radix select)
+        void admm_update_cuda(
+            const torch::Tensor& opacities_raw, // [N, ...] float32
+            torch::Tensor& z,                   // same shape, written
+            torch::Tensor& u,                   // same shape, read and updated
+            int64_t n_prune,
+            bool update_dual = true);
+
+        // 0.5 * rho * ||sigmoid(opacities_raw) - z + u||^2 as a 0-dim tensor
+        torch::Tensor admm_loss_forward_cuda(
+            const torch::Tensor& opacities_raw,
+            const torch::Tensor& z,
+            const torch::Tensor& u,
+            float rho);
+
+        torch::Tensor admm_loss_backward_cuda(
+            const torch::Tensor& opacities_raw,
+            const torch::Tensor& z,
+            const torch::Tensor& u,
+            float rho,
+            const torch::Tensor& grad_output // scalar, read on the device
+        );
+
+    } // namespace sparsity
+} // namespace gs
@@ -0,0 +1,52 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <array>
+#include <torch/torch.h>
+
+namespace gs {
+
+    // One similarity transform as transform_splats applies it
+    struct SplatTransform {
+        float affine[12];                // Row-major 3x4 applied to the means
+        float quaternion[4];             // Rotation part (w, x, y, z), left-multiplied onto every rotation
+        float log_scale;                 // Added to every log scale
+        float sh_rotation[9 + 25 + 49];  // Row-major band 1, 2 and 3 matrices for the shN coefficients
+    };
+
+    /**
+     * @brief Applies a transform to Gaussians in place with one kernel launch
+     *
+     * @param means [N, 3] float32
+     * @param rotation [N, 4] float32 raw quaternions
+     * @param scaling [N, 3] float32 log scales
+     * @param shN [N, K, 3] float32, float16 or bfloat16, K <= 15; only complete bands are rotated
+     * @param transform Transform to apply
+     */
+    void transform_splats(torch::Tensor& means,
+                          torch::Tensor& rotation,
+                          torch::Tensor& scaling,
+                          torch::Tensor& shN,
+                          const SplatTransform& transform);
+
+    /**
+     * @brief Indices of the means inside an oriented box
+     *
+     * Builds the inside flags in one pass and compacts them on the device, the only host
+     * readback is the number of kept points.
+     *
+     * @param means [N, 3] float32
+     * @param world_to_box Row-major 3x4 into the box frame
+     * @param box_min Box minimum in the box frame
+     * @param box_max Box maximum in the box frame
+     * @return int64 [M] indices in ascending order
+     */
+    torch::Tensor crop_box_indices(const torch::Tensor& means,
+                                   const std::array<float, 12>& world_to_box,
+                                   const std::array<float, 3>& box_min,
+                                   const std::array<float, 3>& box_max);
+
+} // namespace gs
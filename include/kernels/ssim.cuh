@@ -14,7 +14,8 @@ fusedssim(
     float C2,
     torch::Tensor& img1,
     torch::Tensor& img2,
-    bool train);
+    bool train,
+    bool valid);
 
 torch::Tensor
 fusedssim_backward(
@@ -25,4 +26,39 @@ fusedssim_backward(
     torch::Tensor& dL_dmap,
     torch::Tensor& dm_dmu1,
     torch::Tensor& dm_dsigma1_sq,
-    torch::Tensor& dm_dsigma12);
+    torch::Tensor& dm_dsigma12,
+    bool valid);
+
+// (1 - lambda) * L1 + lambda * (1 - SSIM) in one pass. The rendered side is composited on load,
+// mask * (image + (1 - alpha) * background), and with a [12, L, H, W] bilateral_grid sliced as
+// mask * slice(clamp(composite, 0, 1)). alpha, mask and bilateral_grid may be empty, gt is float32
+// or uint8. Returns (loss_sums [2]: L1 sum and 'valid' SSIM sum, dm_dmu1, dm_dsigma1_sq, dm_dsigma12).
+std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>
+fused_l1_ssim(
+    float C1,
+    float C2,
+    const torch::Tensor& image,
+    const torch::Tensor& alpha,
+    const torch::Tensor& background,
+    const torch::Tensor& mask,
+    const torch::Tensor& bilateral_grid,
+    const torch::Tensor& gt,
+    bool train);
+
+// Returns (dL/dimage, dL/dalpha, dL/dgrid) for L = l1_weight * L1 sum + ssim_weight * SSIM sum,
+// scaled by the one-element grad_loss; dL/dalpha and dL/dgrid are undefined without compositing
+// or bilateral grid
+std::tuple<torch::Tensor, torch::Tensor, torch::Tensor>
+fused_l1_ssim_backward(
+    float l1_weight,
+    float ssim_weight,
+    const torch::Tensor& image,
+    const torch::Tensor& alpha,
+    const torch::Tensor& background,
+    const torch::Tensor& mask,
+    const torch::Tensor& bilateral_grid,
+    const torch::Tensor& gt,
+    const torch::Tensor& grad_loss,
+    const torch::Tensor& dm_dmu1,
+    const torch::Tensor& dm_dsigma1_sq,
+    const torch::Tensor& dm_dsigma12);
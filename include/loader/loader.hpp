@@ -8,7 +8,9 @@
 #include <expected>
 #include <filesystem>
 #include <functional>
+#include <future>
 #include <memory>
+#include <stop_token>
 #include <string>
 #include <torch/torch.h>
 #include <variant>
@@ -41,8 +43,18 @@ namespace gs::loader {
         int resize_factor = -1;
         int max_width = 3840;
         std::string images_folder = "images";
+        // Datasets: check the structure, image files and header sizes, returns no cameras or points
         bool validate_only = false;
         ProgressCallback progress = nullptr;
+        // Resample distorted pinhole images to ideal pinhole ones (COLMAP only), cached in
+        // undistort_cache_dir, <dataset>/undistorted when empty
+        bool undistort = false;
+        std::filesystem::path undistort_cache_dir = {};
+        // Splat files only: keep a copy in the model cache so loading the unchanged file again
+        // skips parsing, see Loader::setCacheBudget
+        bool cache = false;
+        // loadAsync: a load still queued when stop is requested fails without reading the file
+        std::stop_token cancel = {};
     };
 
     struct LoadedScene {
@@ -95,6 +107,23 @@ namespace gs::loader {
             const std::filesystem::path& path,
             const LoadOptions& options = {}) = 0;
 
+        /**
+         * @brief Load on a pool of loader threads, several files load and upload concurrently
+         * @param path File or directory to load
+         * @param options Loading options, the progress callback runs on the loader thread
+         * @return Future of the LoadResult or error string
+         */
+        virtual std::future<std::expected<LoadResult, std::string>> loadAsync(
+            const std::filesystem::path& path,
+            const LoadOptions& options = {}) = 0;
+
+        /**
+         * @brief Budgets of the model cache for LoadOptions::cache, 0 disables a tier
+         * @param device_bytes VRAM held by the recently loaded splat files
+         * @param host_bytes Pinned RAM the ones evicted from VRAM move to, reloads upload them again
+         */
+        virtual void setCacheBudget(size_t device_bytes, size_t host_bytes) = 0;
+
         /**
          * @brief Check if a path can be loaded
          * @param path File or directory to check
@@ -4,11 +4,16 @@
 
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <condition_variable>
 #include <filesystem>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "core/parameters.hpp"
@@ -53,6 +58,8 @@ namespace gs::management {
 
     struct DataSetInfo : public param::DatasetConfig {
         std::string data_type;
+        // Source image (width, height, channels) by image name, so reopening a project skips probing
+        std::map<std::string, std::array<int, 3>> image_info;
         DataSetInfo() = default;
         explicit DataSetInfo(const DatasetConfig& data_config);
     };
@@ -116,8 +123,13 @@ namespace gs::management {
 
         explicit Project(bool update_file_on_change = false);
         explicit Project(const ProjectData& initialData, bool update_file_on_change = false);
+        // Writes a change still waiting for the debounce
+        ~Project();
 
-        void setProjectOutputFolder(const std::filesystem::path& path) { project_data_.data_set_info.output_path = path; }
+        void setProjectOutputFolder(const std::filesystem::path& path) {
+            std::lock_guard<std::mutex> lock(data_mutex_);
+            project_data_.data_set_info.output_path = path;
+        }
         std::filesystem::path getProjectOutputFolder() const { return project_data_.data_set_info.output_path; }
 
         // project file name
@@ -128,18 +140,27 @@ namespace gs::management {
         bool readFromFile(const std::filesystem::path& filepath);
         // if the user gave a path - use path else use the one that was given in setOutputFileName
         bool writeToFile(const std::filesystem::path& filepath = {});
+        // Writes a change-triggered update now instead of after the debounce
+        void flushWrites();
 
         // Data access methods
         const ProjectData& getProjectData() const { return project_data_; }
         ProjectData& getProjectData() { return project_data_; }
 
-        void setProjectData(const ProjectData& data) { project_data_ = data; }
-        void setOptimizationParams(const param::OptimizationParameters& opt) { project_data_.optimization = opt; }
+        void setProjectData(const ProjectData& data) {
+            std::lock_guard<std::mutex> lock(data_mutex_);
+            project_data_ = data;
+        }
+        void setOptimizationParams(const param::OptimizationParameters& opt) {
+            std::lock_guard<std::mutex> lock(data_mutex_);
+            project_data_.optimization = opt;
+        }
         [[nodiscard]] param::OptimizationParameters getOptimizationParams() const { return project_data_.optimization; }
 
         // Convenience methods
         void setProjectName(const std::string& name);
         void setDataInfo(const param::DatasetConfig& data_config);
+        void setImageInfo(std::map<std::string, std::array<int, 3>> image_info);
         bool addPly(const PlyData& ply);
         bool addPly(bool imported, const std::filesystem::path& path, int iter, const std::string& _ply_name);
         void removePly(size_t index);
@@ -173,11 +194,33 @@ namespace gs::management {
         [[nodiscard]] bool getUpdateFileOnChange() const { return update_file_on_change_; }
 
     private:
+        // With update_file_on_change_, a change schedules a write on the writer thread. Changes
+        // closer together than WRITE_DEBOUNCE coalesce into one write, at most MAX_WRITE_DELAY
+        // after the first of them.
+        static constexpr std::chrono::milliseconds WRITE_DEBOUNCE{500};
+        static constexpr std::chrono::milliseconds MAX_WRITE_DELAY{5000};
+
+        void requestWrite();
+        void writerLoop();
+        // Holding io_mutex_. skip_unchanged leaves the file alone when only the update time would change.
+        bool writeSnapshot(const std::filesystem::path& targetPath, bool skip_unchanged);
+
         std::filesystem::path output_file_name_;
         bool update_file_on_change_ = false; // if true update file on every change
         mutable std::mutex io_mutex_;
         mutable std::mutex data_mutex_;
         bool is_temp_project_ = false;
+
+        std::string last_written_; // Last content written, without the update time
+        std::filesystem::path last_written_path_;
+
+        std::mutex write_mutex_;
+        std::condition_variable write_cv_;
+        bool write_pending_ = false;
+        bool stop_writer_ = false;
+        std::chrono::steady_clock::time_point write_due_;      // Debounce ends
+        std::chrono::steady_clock::time_point write_deadline_; // MAX_WRITE_DELAY after the first pending change
+        std::thread writer_;                                   // Started by the first change-triggered write
     };
     // go over all lfs folders in temp directory and remove unlocked ones
     // preferably this should be called at the app startup
@@ -39,6 +39,45 @@ namespace gs::rendering {
         glm::mat4 transform{1.0f};
     };
 
+    // Full quality around a gaze point, falling off towards the periphery (fastgs RGB path)
+    struct Foveation {
+        glm::vec2 center{0.5f, 0.5f}; // In normalized image coordinates
+        float inner_radius = 0.15f;   // Full quality within, as a fraction of the image diagonal
+        float outer_radius = 0.45f;   // Lowest quality beyond
+    };
+
+    // Rows of the model drawn at a transform of their own (fastgs RGB path), e.g. one asset placed
+    // several times in the scene without copying its Gaussians
+    struct ModelInstance {
+        int64_t first_row = 0;
+        int64_t row_count = 0;
+        glm::mat4 transform{1.0f}; // World from model
+    };
+
+    // Debug overlay of where the fastgs blend spends its time (fastgs RGB path), from a training
+    // forward of the same view, ignoring the crop box and instances
+    enum class WorkloadHeatmap {
+        Off,
+        TileInstances,    // Instances sorted into each tile
+        PixelContributors // Instances each pixel walked up to its last contribution
+    };
+
+    struct WorkloadTile {
+        glm::ivec2 tile;   // Tile coordinates, row 0 at the top of the image
+        glm::ivec4 pixels; // x, y, width, height
+        int instances = 0;
+        int max_contributors = 0;
+    };
+
+    struct WorkloadReport {
+        glm::ivec2 tile_size{0, 0};
+        glm::ivec2 grid_size{0, 0};
+        int64_t total_instances = 0;
+        float mean_instances = 0.0f; // Per tile
+        int max_contributors = 0;     // Per pixel
+        std::vector<WorkloadTile> worst_tiles; // Most instances first
+    };
+
     struct RenderRequest {
         ViewportData viewport;
         float scaling_modifier = 1.0f;
@@ -49,11 +88,20 @@ namespace gs::rendering {
         float voxel_size = 0.01f;
         bool gut = false;
         int sh_degree = 0;
+        std::optional<Foveation> foveation;
+        std::optional<glm::ivec4> render_rect; // x, y, width, height: only this part is rasterized (fastgs RGB path)
+        float sh_lod_pixels = 0.0f;            // Gaussians with a smaller screen radius use SH degree 0, 0: off (fastgs RGB path)
+        bool occlusion_culling = false;        // Skip Gaussians behind what the last frame saw opaque (fastgs RGB path)
+        bool half_precision = false;           // Blend from FP16 per-Gaussian records, faster and slightly less exact (fastgs RGB path)
+        std::vector<ModelInstance> instances;  // Only these rows are drawn, at their transforms, empty: every row once
+        WorkloadHeatmap workload_heatmap = WorkloadHeatmap::Off;
     };
 
     struct RenderResult {
         std::shared_ptr<torch::Tensor> image;
         std::shared_ptr<torch::Tensor> depth;
+        unsigned int texture_id = 0; // Point cloud mode: the frame as a GL texture, image is then empty
+        std::shared_ptr<const WorkloadReport> workload; // With a workload heatmap
     };
 
     // Split view support
@@ -275,7 +323,8 @@ namespace gs::rendering {
             const glm::vec3& eval_color = glm::vec3(1.0f, 0.0f, 0.0f),
             int highlight_index = -1) = 0;
 
-        // Camera frustum picking
+        // Camera frustum picking. Asynchronous: queues a read under mouse_pos and returns the
+        // camera of the newest read that finished (-1 for none), keep picking to let it settle
         virtual Result<int> pickCameraFrustum(
             const std::vector<std::shared_ptr<const Camera>>& cameras,
             const glm::vec2& mouse_pos,
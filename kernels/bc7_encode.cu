@@ -0,0 +1,234 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "kernels/bc7_encode.cuh"
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <cuda_runtime.h>
+#include <string>
+
+namespace gs {
+
+    namespace {
+        constexpr int block_size = 256;
+        constexpr int power_iterations = 8;
+
+        __constant__ int c_weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        void check_launch(const char* what) {
+            cudaError_t err = cudaGetLastError();
+            if (err != cudaSuccess) {
+                throw std::runtime_error(std::string("CUDA error in ") + what + ": " + cudaGetErrorString(err));
+            }
+        }
+
+        // 7-bit endpoint and shared p-bit closest to e, the p-bit being the LSB of every channel
+        __device__ void quantize_endpoint(const float e[4], uint32_t q[4], uint32_t& pbit) {
+            float best = INFINITY;
+            for (uint32_t p = 0; p < 2; ++p) {
+                uint32_t candidate[4];
+                float err = 0.0f;
+                for (int c = 0; c < 4; ++c) {
+                    candidate[c] = static_cast<uint32_t>(fminf(fmaxf(rintf((e[c] - p) * 0.5f), 0.0f), 127.0f));
+                    const float d = static_cast<float>((candidate[c] << 1) | p) - e[c];
+                    err += d * d;
+                }
+                if (err < best) {
+                    best = err;
+                    pbit = p;
+                    for (int c = 0; c < 4; ++c)
+                        q[c] = candidate[c];
+                }
+            }
+        }
+
+        __device__ __forceinline__ void put_bits(uint64_t& lo, uint64_t& hi, int& pos, uint32_t value, int bits) {
+            if (pos < 64) {
+                lo |= static_cast<uint64_t>(value) << pos;
+                if (pos + bits > 64)
+                    hi |= static_cast<uint64_t>(value) >> (64 - pos);
+            } else {
+                hi |= static_cast<uint64_t>(value) << (pos - 64);
+            }
+            pos += bits;
+        }
+    } // namespace
+
+    __global__ void encode_bc7_mode6_cu(
+        const uint8_t* __restrict__ pixels,
+        const int height,
+        const int width,
+        const int channels,
+        const int blocks_x,
+        const int64_t blocks,
+        uint4* __restrict__ out) {
+
+        const int64_t idx = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+        if (idx >= blocks)
+            return;
+        const int bx = static_cast<int>(idx % blocks_x);
+        const int by = static_cast<int>(idx / blocks_x);
+
+        // Edge blocks repeat the last row and column
+        float texel[16][4];
+        float lo_color[4] = {255.0f, 255.0f, 255.0f, 255.0f};
+        float hi_color[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        float mean[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (int i = 0; i < 16; ++i) {
+            const int x = min(bx * 4 + (i & 3), width - 1);
+            const int y = min(by * 4 + (i >> 2), height - 1);
+            const uint8_t* p = pixels + (static_cast<int64_t>(y) * width + x) * channels;
+            texel[i][0] = p[0];
+            texel[i][1] = channels > 1 ? p[1] : 0.0f;
+            texel[i][2] = channels > 2 ? p[2] : 0.0f;
+            texel[i][3] = channels > 3 ? p[3] : 255.0f;
+            for (int c = 0; c < 4; ++c) {
+                lo_color[c] = fminf(lo_color[c], texel[i][c]);
+                hi_color[c] = fmaxf(hi_color[c], texel[i][c]);
+                mean[c] += texel[i][c] * (1.0f / 16.0f);
+            }
+        }
+
+        // Principal axis by power iteration from the bounding box diagonal
+        float cov[4][4] = {};
+        for (int i = 0; i < 16; ++i) {
+            for (int a = 0; a < 4; ++a) {
+                for (int b = a; b < 4; ++b) {
+                    cov[a][b] += (texel[i][a] - mean[a]) * (texel[i][b] - mean[b]);
+                }
+            }
+        }
+        for (int a = 0; a < 4; ++a) {
+            for (int b = 0; b < a; ++b) {
+                cov[a][b] = cov[b][a];
+            }
+        }
+        float axis[4];
+        for (int c = 0; c < 4; ++c)
+            axis[c] = hi_color[c] - lo_color[c];
+        for (int it = 0; it < power_iterations; ++it) {
+            float next[4];
+            float norm = 0.0f;
+            for (int a = 0; a < 4; ++a) {
+                next[a] = cov[a][0] * axis[0] + cov[a][1] * axis[1] + cov[a][2] * axis[2] + cov[a][3] * axis[3];
+                norm += next[a] * next[a];
+            }
+            if (norm < 1e-12f)
+                break;
+            const float inv = rsqrtf(norm);
+            for (int a = 0; a < 4; ++a)
+                axis[a] = next[a] * inv;
+        }
+        const float axis_norm = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] + axis[3] * axis[3];
+        if (axis_norm > 1e-12f) {
+            const float inv = rsqrtf(axis_norm);
+            for (int c = 0; c < 4; ++c)
+                axis[c] *= inv;
+        }
+
+        float t_min = 0.0f;
+        float t_max = 0.0f;
+        for (int i = 0; i < 16; ++i) {
+            float t = 0.0f;
+            for (int c = 0; c < 4; ++c)
+                t += (texel[i][c] - mean[c]) * axis[c];
+            t_min = fminf(t_min, t);
+            t_max = fmaxf(t_max, t);
+        }
+        float e0[4];
+        float e1[4];
+        for (int c = 0; c < 4; ++c) {
+            e0[c] = fminf(fmaxf(mean[c] + t_min * axis[c], 0.0f), 255.0f);
+            e1[c] = fminf(fmaxf(mean[c] + t_max * axis[c], 0.0f), 255.0f);
+        }
+
+        uint32_t q0[4];
+        uint32_t q1[4];
+        uint32_t p0 = 0;
+        uint32_t p1 = 0;
+        quantize_endpoint(e0, q0, p0);
+        quantize_endpoint(e1, q1, p1);
+
+        // The palette as the decoder rebuilds it
+        int palette[16][4];
+        for (int w = 0; w < 16; ++w) {
+            for (int c = 0; c < 4; ++c) {
+                const int a = static_cast<int>((q0[c] << 1) | p0);
+                const int b = static_cast<int>((q1[c] << 1) | p1);
+                palette[w][c] = ((64 - c_weights4[w]) * a + c_weights4[w] * b + 32) >> 6;
+            }
+        }
+        uint32_t indices[16];
+        for (int i = 0; i < 16; ++i) {
+            float best = INFINITY;
+            uint32_t best_index = 0;
+            for (int w = 0; w < 16; ++w) {
+                float err = 0.0f;
+                for (int c = 0; c < 4; ++c) {
+                    const float d = texel[i][c] - palette[w][c];
+                    err += d * d;
+                }
+                if (err < best) {
+                    best = err;
+                    best_index = w;
+                }
+            }
+            indices[i] = best_index;
+        }
+
+        // The anchor texel stores 3 bits, so its index must have the high bit clear
+        if (indices[0] & 8) {
+            for (int c = 0; c < 4; ++c) {
+                const uint32_t t = q0[c];
+                q0[c] = q1[c];
+                q1[c] = t;
+            }
+            const uint32_t t = p0;
+            p0 = p1;
+            p1 = t;
+            for (int i = 0; i < 16; ++i)
+                indices[i] = 15 - indices[i];
+        }
+
+        uint64_t lo = 0;
+        uint64_t hi = 0;
+        int pos = 0;
+        put_bits(lo, hi, pos, 1u << 6, 7);
+        for (int c = 0; c < 4; ++c) {
+            put_bits(lo, hi, pos, q0[c], 7);
+            put_bits(lo, hi, pos, q1[c], 7);
+        }
+        put_bits(lo, hi, pos, p0, 1);
+        put_bits(lo, hi, pos, p1, 1);
+        put_bits(lo, hi, pos, indices[0], 3);
+        for (int i = 1; i < 16; ++i)
+            put_bits(lo, hi, pos, indices[i], 4);
+
+        out[idx] = make_uint4(static_cast<uint32_t>(lo), static_cast<uint32_t>(lo >> 32),
+                              static_cast<uint32_t>(hi), static_cast<uint32_t>(hi >> 32));
+    }
+
+    torch::Tensor encode_bc7(const torch::Tensor& pixels) {
+        TORCH_CHECK(pixels.is_cuda() && pixels.scalar_type() == torch::kUInt8 && pixels.dim() == 3,
+                    "pixels must be a uint8 CUDA tensor [H, W, C]");
+        const int height = static_cast<int>(pixels.size(0));
+        const int width = static_cast<int>(pixels.size(1));
+        const int channels = static_cast<int>(pixels.size(2));
+        TORCH_CHECK(height > 0 && width > 0 && channels >= 1 && channels <= 4, "pixels must have 1 to 4 channels");
+
+        const at::cuda::CUDAGuard device_guard(pixels.device());
+        const auto input = pixels.contiguous();
+        const int blocks_x = (width + 3) / 4;
+        const int64_t blocks = static_cast<int64_t>(blocks_x) * ((height + 3) / 4);
+        auto out = torch::empty({blocks * 16}, input.options());
+
+        encode_bc7_mode6_cu<<<static_cast<int>((blocks + block_size - 1) / block_size), block_size, 0,
+                              at::cuda::getCurrentCUDAStream()>>>(
+            input.data_ptr<uint8_t>(), height, width, channels, blocks_x, blocks,
+            reinterpret_cast<uint4*>(out.data_ptr<uint8_t>()));
+        check_launch("encode_bc7");
+        return out;
+    }
+
+} // namespace gs
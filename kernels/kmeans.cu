@@ -3,6 +3,8 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "kernels/kmeans.cuh"
+#include <ATen/cuda/CUDAContext.h>
+#include <algorithm>
 #include <cuda_runtime.h>
 #include <thrust/device_vector.h>
 #include <thrust/execution_policy.h>
@@ -14,46 +16,6 @@ namespace gs {
 
         namespace {
 
-            // Kernel to compute distances and assign labels
-            template <int BLOCK_SIZE = 256>
-            __global__ void assign_clusters_kernel(
-                const float* __restrict__ data,
-                const float* __restrict__ centroids,
-                int* __restrict__ labels,
-                float* __restrict__ distances,
-                const int n_points,
-                const int n_clusters,
-                const int n_dims) {
-                const int tid = blockIdx.x * blockDim.x + threadIdx.x;
-
-                if (tid >= n_points)
-                    return;
-
-                float min_dist = INFINITY;
-                int min_idx = 0;
-
-                // For each centroid
-                for (int c = 0; c < n_clusters; ++c) {
-                    float dist = 0.0f;
-
-                    // Compute squared Euclidean distance
-                    for (int d = 0; d < n_dims; ++d) {
-                        float diff = data[tid * n_dims + d] - centroids[c * n_dims + d];
-                        dist += diff * diff;
-                    }
-
-                    if (dist < min_dist) {
-                        min_dist = dist;
-                        min_idx = c;
-                    }
-                }
-
-                labels[tid] = min_idx;
-                if (distances != nullptr) {
-                    distances[tid] = min_dist;
-                }
-            }
-
             // Optimized kernel for 1D clustering
             __global__ void assign_clusters_1d_kernel(
                 const float* __restrict__ data,
@@ -82,76 +44,71 @@ namespace gs {
                 labels[tid] = best;
             }
 
-            // Kernel to update centroids
-            __global__ void update_centroids_kernel(
-                const float* __restrict__ data,
-                const int* __restrict__ labels,
-                float* __restrict__ new_centroids,
-                int* __restrict__ counts,
-                const int n_points,
-                const int n_clusters,
-                const int n_dims) {
-                const int cluster_id = blockIdx.x;
-                const int dim = threadIdx.x;
-
-                if (cluster_id >= n_clusters || dim >= n_dims)
-                    return;
-
-                float sum = 0.0f;
-                int count = 0;
-
-                // Sum all points belonging to this cluster
-                for (int i = 0; i < n_points; ++i) {
-                    if (labels[i] == cluster_id) {
-                        sum += data[i * n_dims + dim];
-                        if (dim == 0)
-                            count++;
-                    }
-                }
-
-                // Store result
-                if (dim == 0) {
-                    counts[cluster_id] = count;
-                }
-
-                __syncthreads();
-
-                if (counts[cluster_id] > 0) {
-                    new_centroids[cluster_id * n_dims + dim] = sum / counts[cluster_id];
+            // Distance matrices of the assignment stay under this many floats per chunk
+            constexpr int64_t max_distance_elements = int64_t(1) << 26;
+            constexpr int64_t min_batch_size = 65536;
+
+            // Nearest centroid of every point from ||c||^2 - 2 x.c, chunked so the [chunk, k]
+            // distance matrix stays bounded. One GEMM per chunk replaces the per-point loop over k.
+            // The GEMM asks for TF32 tensor cores through its compute type, argmin tolerates the
+            // rounding; no global or handle math mode changes, so concurrent matmuls keep FP32.
+            torch::Tensor assign_nearest(const torch::Tensor& input,
+                                         const torch::Tensor& centroids,
+                                         const torch::Tensor& centroid_norms) {
+                const auto points = input.contiguous();
+                const int64_t n = points.size(0);
+                const int64_t k = centroids.size(0);
+                const int64_t d = points.size(1);
+                const int64_t chunk = std::max<int64_t>(1, max_distance_elements / k);
+                auto labels = torch::empty({n}, points.options().dtype(torch::kInt32));
+                const auto centroids_c = centroids.contiguous();
+                const auto norms = centroid_norms.contiguous().unsqueeze(0);
+                const float alpha = -2.0f;
+                const float beta = 1.0f;
+                cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+                for (int64_t begin = 0; begin < n; begin += chunk) {
+                    const int64_t size = std::min(chunk, n - begin);
+                    auto distances = norms.expand({size, k}).contiguous();
+                    // Row-major [size, k] = points [size, d] * centroids^T, column-major that is
+                    // centroids (as d x k, transposed) times points (as d x size)
+                    TORCH_CUDABLAS_CHECK(cublasGemmEx(
+                        handle, CUBLAS_OP_T, CUBLAS_OP_N,
+                        static_cast<int>(k), static_cast<int>(size), static_cast<int>(d),
+                        &alpha,
+                        centroids_c.data_ptr<float>(), CUDA_R_32F, static_cast<int>(d),
+                        points.data_ptr<float>() + begin * d, CUDA_R_32F, static_cast<int>(d),
+                        &beta,
+                        distances.data_ptr<float>(), CUDA_R_32F, static_cast<int>(k),
+                        CUBLAS_COMPUTE_32F_FAST_TF32, CUBLAS_GEMM_DEFAULT));
+                    labels.narrow(0, begin, size).copy_(distances.argmin(1));
                 }
+                return labels;
             }
 
-            // Initialize centroids using k-means++ algorithm
+            // k-means++ seeding on the device: the distance to the nearest chosen center is updated
+            // with the newest center only and the next one is drawn by torch::multinomial, so no step
+            // reads back to the host. Seeds come from a random subsample of at most 4 * k points.
             torch::Tensor initialize_centroids_plusplus(
                 const torch::Tensor& data,
                 int k) {
-                const int n = data.size(0);
-                const int d = data.size(1);
-
-                auto centroids = torch::zeros({k, d}, data.options());
-                auto distances = torch::full({n}, INFINITY, data.options());
-
-                // Choose first centroid randomly
-                int first_idx = torch::randint(n, {1}, torch::kInt32).item<int>();
-                centroids[0] = data[first_idx];
+                const int64_t n = data.size(0);
+                const int64_t sample_size = std::min<int64_t>(n, 4 * static_cast<int64_t>(k));
+                const auto candidates = sample_size < n
+                                            ? data.index_select(0, torch::randperm(n, data.options().dtype(torch::kInt64))
+                                                                       .narrow(0, 0, sample_size))
+                                            : data;
+
+                auto centroids = torch::empty({k, data.size(1)}, data.options());
+                auto index = torch::randint(sample_size, {1}, data.options().dtype(torch::kInt64));
+                centroids.narrow(0, 0, 1).copy_(candidates.index_select(0, index));
+                auto min_distances = (candidates - centroids.narrow(0, 0, 1)).pow(2).sum(1);
 
-                // Choose remaining centroids
                 for (int c = 1; c < k; ++c) {
-                    // Compute distances to nearest centroid
-                    auto centroid_view = centroids.slice(0, 0, c);
-                    auto dists = torch::cdist(data, centroid_view);
-                    distances = std::get<0>(torch::min(dists, 1));
-
-                    // Choose next centroid with probability proportional to squared distance
-                    auto probs = distances.pow(2);
-                    probs = probs / probs.sum();
-
-                    // Sample from distribution
-                    auto cumsum = probs.cumsum(0);
-                    float rand_val = torch::rand({1}).item<float>();
-                    int next_idx = (cumsum >= rand_val).nonzero()[0].item<int>();
-
-                    centroids[c] = data[next_idx];
+                    // Squared distances are the k-means++ weights, the epsilon keeps duplicates drawable
+                    index = torch::multinomial(min_distances + 1e-12f, 1);
+                    auto centroid = centroids.narrow(0, c, 1);
+                    centroid.copy_(candidates.index_select(0, index));
+                    torch::minimum_out(min_distances, min_distances, (candidates - centroid).pow(2).sum(1));
                 }
 
                 return centroids;
@@ -163,13 +120,14 @@ namespace gs {
             const torch::Tensor& data,
             int k,
             int iterations,
-            float tolerance) {
+            float tolerance,
+            int batch_size) {
             TORCH_CHECK(data.dim() == 2, "Data must be 2D tensor [N, D]");
             TORCH_CHECK(data.is_cuda(), "Data must be on CUDA");
             TORCH_CHECK(data.dtype() == torch::kFloat32, "Data must be float32");
 
-            const int n = data.size(0);
-            const int d = data.size(1);
+            const int64_t n = data.size(0);
+            const int64_t d = data.size(1);
 
             if (n <= k) {
                 // If fewer points than clusters, return points as centroids
@@ -178,48 +136,47 @@ namespace gs {
                 return {centroids, labels};
             }
 
-            // Initialize centroids using k-means++
-            auto centroids = initialize_centroids_plusplus(data, k);
-            auto labels = torch::zeros({n}, torch::kInt32).to(data.device());
-            auto old_centroids = torch::zeros_like(centroids);
+            const auto points = data.contiguous();
 
-            // Allocate workspace
-            auto counts = torch::zeros({k}, torch::kInt32).to(data.device());
+            // Initialize centroids using k-means++
+            auto centroids = initialize_centroids_plusplus(points, k);
+            auto counts = torch::zeros({k}, points.options());
 
-            const int block_size = 256;
-            const int grid_size_points = (n + block_size - 1) / block_size;
+            // Mini-batch k-means (Sculley 2010) once the data outgrows one batch: every step assigns
+            // a random batch and moves each centroid towards its batch mean at rate 1 / its total count
+            const int64_t batch = batch_size > 0 ? std::min<int64_t>(batch_size, n)
+                                                 : std::min<int64_t>(n, std::max<int64_t>(min_batch_size, 4 * int64_t(k)));
+            const bool mini_batch = batch < n;
 
             for (int iter = 0; iter < iterations; ++iter) {
-                old_centroids.copy_(centroids);
-
-                // Assign clusters
-                assign_clusters_kernel<block_size><<<grid_size_points, block_size>>>(
-                    data.data_ptr<float>(),
-                    centroids.data_ptr<float>(),
-                    labels.data_ptr<int>(),
-                    nullptr,
-                    n, k, d);
-
-                // Update centroids
-                counts.zero_();
-                dim3 block(d, 1);
-                dim3 grid(k, 1);
-                update_centroids_kernel<<<grid, block>>>(
-                    data.data_ptr<float>(),
-                    labels.data_ptr<int>(),
-                    centroids.data_ptr<float>(),
-                    counts.data_ptr<int>(),
-                    n, k, d);
-
-                cudaDeviceSynchronize();
+                const auto samples = mini_batch
+                                         ? points.index_select(0, torch::randint(n, {batch}, points.options().dtype(torch::kInt64)))
+                                         : points;
+                const auto labels = assign_nearest(samples, centroids, centroids.pow(2).sum(1)).to(torch::kInt64);
+
+                auto sums = torch::zeros({k, d}, points.options()).index_add_(0, labels, samples);
+                auto batch_counts = torch::zeros({k}, points.options())
+                                        .index_add_(0, labels, torch::ones({samples.size(0)}, points.options()));
+                const auto batch_means = sums / batch_counts.clamp_min(1.0f).unsqueeze(1);
+
+                torch::Tensor rate;
+                if (mini_batch) {
+                    counts += batch_counts;
+                    rate = batch_counts / counts.clamp_min(1.0f);
+                } else {
+                    // Lloyd step, empty clusters keep their centroid
+                    rate = (batch_counts > 0).to(torch::kFloat32);
+                }
+                const auto movement = rate.unsqueeze(1) * (batch_means - centroids);
+                centroids += movement;
 
                 // Check convergence
-                float max_movement = (centroids - old_centroids).abs().max().item<float>();
-                if (max_movement < tolerance) {
+                if (movement.abs().max().item<float>() < tolerance) {
                     break;
                 }
             }
 
+            auto labels = assign_nearest(points, centroids, centroids.pow(2).sum(1));
             return {centroids, labels};
         }
 
@@ -261,38 +218,33 @@ namespace gs {
                 auto [sorted_centroids, sort_idx] = centroids.squeeze(1).sort(0);
 
                 // Assign clusters using optimized 1D kernel
-                assign_clusters_1d_kernel<<<grid_size, block_size>>>(
+                assign_clusters_1d_kernel<<<grid_size, block_size, 0, at::cuda::getCurrentCUDAStream()>>>(
                     data_2d.data_ptr<float>(),
                     sorted_centroids.data_ptr<float>(),
                     labels.data_ptr<int>(),
                     n, k);
 
-                cudaDeviceSynchronize();
-
-                // Update centroids
-                for (int c = 0; c < k; ++c) {
-                    auto mask = labels == c;
-                    if (mask.any().item<bool>()) {
-                        auto cluster_points = data_2d.masked_select(mask.unsqueeze(1)).reshape({-1, 1});
-                        centroids[c] = cluster_points.mean(0);
-                    }
-                }
+                // Update centroids, empty clusters keep theirs. Labels index the sorted centroids.
+                const auto sorted_labels = labels.to(torch::kInt64);
+                auto sums = torch::zeros({k}, data_2d.options()).index_add_(0, sorted_labels, data_2d.squeeze(1));
+                auto counts = torch::zeros({k}, data_2d.options())
+                                  .index_add_(0, sorted_labels, torch::ones({n}, data_2d.options()));
+                auto updated = torch::where(counts > 0, sums / counts.clamp_min(1.0f), sorted_centroids);
+                centroids = updated.unsqueeze(1);
             }
 
-            // Final sort of centroids and remap labels
+            // The last update may have reordered the centroids, sort once more and remap the labels
             auto [final_sorted, final_idx] = centroids.squeeze(1).sort(0);
             centroids = final_sorted.unsqueeze(1);
 
             // Create inverse mapping for labels
-            auto inv_map = torch::zeros({k}, torch::kInt32).to(data.device());
-            for (int i = 0; i < k; ++i) {
-                inv_map[final_idx[i].item<int>()] = i;
-            }
+            auto inv_map = torch::empty({k}, torch::kInt32).to(data.device());
+            inv_map.scatter_(0, final_idx, torch::arange(k, inv_map.options()));
 
             // Remap labels
             auto remapped_labels = torch::zeros_like(labels);
             thrust::gather(
-                thrust::device,
+                thrust::cuda::par.on(at::cuda::getCurrentCUDAStream()),
                 labels.data_ptr<int>(),
                 labels.data_ptr<int>() + n,
                 inv_map.data_ptr<int>(),
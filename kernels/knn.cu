@@ -0,0 +1,274 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "kernels/knn.cuh"
+#include "kernels/morton_encoding.cuh"
+#include <ATen/cuda/CUDAContext.h>
+#include <algorithm>
+#include <array>
+#include <c10/cuda/CUDAGuard.h>
+#include <cmath>
+#include <cuda_runtime.h>
+#include <limits>
+#include <string>
+
+namespace gs {
+
+    namespace {
+        constexpr int block_size = 256;
+        constexpr int K = 4;                   // Nearest points searched, the query itself included
+        constexpr int MAX_RING = 2;            // Shells of cells searched before a level gives up
+        constexpr float LEVEL_SCALE = 4.0f;    // Cell growth between levels
+        constexpr int MAX_LEVELS = 8;          // 4^7 times the first cell covers any sane cloud
+        constexpr double POINTS_PER_CELL = 2.0;
+        constexpr int64_t SAMPLE_POINTS = 65536; // Points the cell size is estimated from
+        constexpr int CELL_BIAS = 1 << 20;     // Cell coordinates are clamped to 21 bits around the origin
+
+        struct Grid {
+            float3 origin;
+            float cell;
+        };
+
+        void check_launch(const char* what) {
+            cudaError_t err = cudaGetLastError();
+            if (err != cudaSuccess) {
+                throw std::runtime_error(std::string("CUDA error in ") + what + ": " + cudaGetErrorString(err));
+            }
+        }
+
+        __device__ __forceinline__ int clamp_cell(float v) {
+            return static_cast<int>(fminf(fmaxf(floorf(v), -float(CELL_BIAS)), float(CELL_BIAS - 1)));
+        }
+
+        __device__ __forceinline__ float3 grid_coords(const float3 p, const Grid grid) {
+            return make_float3((p.x - grid.origin.x) / grid.cell,
+                               (p.y - grid.origin.y) / grid.cell,
+                               (p.z - grid.origin.z) / grid.cell);
+        }
+
+        // Morton order of the cells keeps neighboring cells close in the sorted points
+        __device__ __forceinline__ int64_t cell_key(const int x, const int y, const int z) {
+            return static_cast<int64_t>(splitBy3(static_cast<uint32_t>(x + CELL_BIAS)) |
+                                        (splitBy3(static_cast<uint32_t>(y + CELL_BIAS)) << 1) |
+                                        (splitBy3(static_cast<uint32_t>(z + CELL_BIAS)) << 2));
+        }
+
+        // Smallest cell size giving about POINTS_PER_CELL points per occupied cell, with the axes
+        // thinner than a cell dropped so planar and linear clouds get 2D and 1D densities
+        double estimate_cell_size(std::array<double, 3> extent, double num_points) {
+            std::sort(extent.begin(), extent.end());
+            for (int dims = 3; dims >= 1; --dims) {
+                double volume = 1.0;
+                for (int axis = 3 - dims; axis < 3; ++axis) {
+                    volume *= extent[axis];
+                }
+                const double cell = std::pow(volume * POINTS_PER_CELL / num_points, 1.0 / dims);
+                if (dims == 1 || cell <= extent[3 - dims]) {
+                    return std::max(cell, 1e-7);
+                }
+            }
+            return 1e-7;
+        }
+    } // namespace
+
+    __global__ void cell_keys_cu(
+        const float3* __restrict__ points,
+        const int n,
+        const Grid grid,
+        int64_t* __restrict__ keys) {
+
+        const int idx = blockIdx.x * blockDim.x + threadIdx.x;
+        if (idx >= n)
+            return;
+
+        const float3 g = grid_coords(points[idx], grid);
+        keys[idx] = cell_key(clamp_cell(g.x), clamp_cell(g.y), clamp_cell(g.z));
+    }
+
+    __global__ void knn_query_cu(
+        const float3* __restrict__ points,
+        const float3* __restrict__ sorted_points,
+        const int64_t* __restrict__ cell_keys,
+        const int* __restrict__ cell_start,
+        const int* __restrict__ cell_count,
+        const int num_cells,
+        const int64_t* __restrict__ queries,
+        const int n_queries,
+        const int k,
+        const Grid grid,
+        float* __restrict__ mean_distances,
+        bool* __restrict__ resolved) {
+
+        const int query_idx = blockIdx.x * blockDim.x + threadIdx.x;
+        if (query_idx >= n_queries)
+            return;
+
+        const int64_t point_idx = queries[query_idx];
+        const float3 p = points[point_idx];
+        const float3 g = grid_coords(p, grid);
+        const int cx = clamp_cell(g.x);
+        const int cy = clamp_cell(g.y);
+        const int cz = clamp_cell(g.z);
+
+        // Distance to the nearest face of the own cell, unvisited cells are at least this plus the
+        // shells searched away
+        const float fx = g.x - cx;
+        const float fy = g.y - cy;
+        const float fz = g.z - cz;
+        const float margin = fmaxf(0.0f, fminf(fminf(fminf(fx, 1.0f - fx), fminf(fy, 1.0f - fy)),
+                                               fminf(fz, 1.0f - fz)));
+
+        float best[K];
+#pragma unroll
+        for (int t = 0; t < K; ++t) {
+            best[t] = INFINITY;
+        }
+        int found = 0;
+        bool done = false;
+
+        for (int r = 0; r <= MAX_RING && !done; ++r) {
+            for (int dz = -r; dz <= r; ++dz) {
+                for (int dy = -r; dy <= r; ++dy) {
+                    for (int dx = -r; dx <= r; ++dx) {
+                        if (max(abs(dx), max(abs(dy), abs(dz))) != r)
+                            continue;
+                        const int x = cx + dx;
+                        const int y = cy + dy;
+                        const int z = cz + dz;
+                        if (x < -CELL_BIAS || x >= CELL_BIAS || y < -CELL_BIAS || y >= CELL_BIAS ||
+                            z < -CELL_BIAS || z >= CELL_BIAS)
+                            continue;
+
+                        // Lower bound over the sorted occupied cells
+                        const int64_t key = cell_key(x, y, z);
+                        int lo = 0;
+                        int hi = num_cells;
+                        while (lo < hi) {
+                            const int mid = (lo + hi) >> 1;
+                            if (cell_keys[mid] < key)
+                                lo = mid + 1;
+                            else
+                                hi = mid;
+                        }
+                        if (lo == num_cells || cell_keys[lo] != key)
+                            continue;
+
+                        const int begin = cell_start[lo];
+                        const int end = begin + cell_count[lo];
+                        for (int j = begin; j < end; ++j) {
+                            const float3 q = sorted_points[j];
+                            const float ddx = q.x - p.x;
+                            const float ddy = q.y - p.y;
+                            const float ddz = q.z - p.z;
+                            const float d2 = ddx * ddx + ddy * ddy + ddz * ddz;
+                            if (d2 >= best[k - 1])
+                                continue;
+                            int t = k - 1;
+                            while (t > 0 && best[t - 1] > d2) {
+                                best[t] = best[t - 1];
+                                --t;
+                            }
+                            best[t] = d2;
+                            found = min(found + 1, k);
+                        }
+                    }
+                }
+            }
+
+            const float reach = (static_cast<float>(r) + margin) * grid.cell;
+            done = found == k && best[k - 1] <= reach * reach;
+        }
+
+        resolved[query_idx] = done;
+
+        // The coincident points, the query itself among them, don't count
+        float sum = 0.0f;
+        int valid = 0;
+        for (int t = 0; t < found && valid < 3; ++t) {
+            if (best[t] > 1e-8f) {
+                sum += sqrtf(best[t]);
+                ++valid;
+            }
+        }
+        mean_distances[point_idx] = valid > 0 ? sum / valid : 0.01f;
+    }
+
+    torch::Tensor mean_neighbor_distances(const torch::Tensor& points) {
+        TORCH_CHECK(points.dim() == 2 && points.size(1) == 3, "Input points must have shape [N, 3]");
+        TORCH_CHECK(points.is_cuda(), "Input points must be on CUDA");
+        TORCH_CHECK(points.dtype() == torch::kFloat32, "Input points must be float32");
+        TORCH_CHECK(points.size(0) < std::numeric_limits<int>::max(), "Too many points for the kNN grid");
+
+        const c10::cuda::CUDAGuard guard(points.device());
+        const auto pts = points.detach().contiguous();
+        const int n = static_cast<int>(pts.size(0));
+        if (n <= 1) {
+            return torch::full({n}, 0.01f, pts.options());
+        }
+
+        // Robust extent and center from a strided sample, outliers don't blow up the cells
+        const auto sample = n > SAMPLE_POINTS
+                                ? pts.index_select(0, torch::linspace(0, n - 1, SAMPLE_POINTS, pts.options())
+                                                          .to(torch::kInt64))
+                                : pts;
+        const auto bounds = torch::quantile(sample, torch::tensor({0.01f, 0.99f}, pts.options()), 0).cpu();
+        const auto b = bounds.accessor<float, 2>();
+        std::array<double, 3> extent{};
+        for (int axis = 0; axis < 3; ++axis) {
+            extent[axis] = std::max(static_cast<double>(b[1][axis]) - b[0][axis], 1e-7);
+        }
+        const float3 origin = make_float3(0.5f * (b[0][0] + b[1][0]), 0.5f * (b[0][1] + b[1][1]), 0.5f * (b[0][2] + b[1][2]));
+
+        // About 98% of the points fall inside the quantile box on each axis
+        float cell = static_cast<float>(estimate_cell_size(extent, 0.94 * n));
+
+        const int k = std::min(K, n);
+        const cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+        const auto* points_ptr = reinterpret_cast<const float3*>(pts.data_ptr<float>());
+        auto result = torch::empty({n}, pts.options());
+        auto keys = torch::empty({n}, pts.options().dtype(torch::kInt64));
+        auto pending = torch::arange(n, pts.options().dtype(torch::kInt64));
+
+        for (int level = 0; level < MAX_LEVELS; ++level) {
+            const Grid grid{origin, cell};
+
+            cell_keys_cu<<<(n + block_size - 1) / block_size, block_size, 0, stream>>>(
+                points_ptr, n, grid, keys.data_ptr<int64_t>());
+            check_launch("cell_keys_cu");
+
+            auto [sorted_keys, order] = keys.sort();
+            const auto sorted_points = pts.index_select(0, order);
+            auto [cells, inverse, counts] = torch::unique_consecutive(sorted_keys, false, true);
+            const auto starts = (counts.cumsum(0) - counts).to(torch::kInt32);
+            counts = counts.to(torch::kInt32);
+
+            const int n_queries = static_cast<int>(pending.numel());
+            auto resolved = torch::empty({n_queries}, pts.options().dtype(torch::kBool));
+            knn_query_cu<<<(n_queries + block_size - 1) / block_size, block_size, 0, stream>>>(
+                points_ptr,
+                reinterpret_cast<const float3*>(sorted_points.data_ptr<float>()),
+                cells.data_ptr<int64_t>(),
+                starts.data_ptr<int>(),
+                counts.data_ptr<int>(),
+                static_cast<int>(cells.numel()),
+                pending.data_ptr<int64_t>(),
+                n_queries,
+                k,
+                grid,
+                result.data_ptr<float>(),
+                resolved.data_ptr<bool>());
+            check_launch("knn_query_cu");
+
+            // The last level keeps whatever its shells found
+            pending = pending.masked_select(resolved.logical_not());
+            if (pending.numel() == 0) {
+                break;
+            }
+            cell *= LEVEL_SCALE;
+        }
+
+        return result;
+    }
+
+} // namespace gs
@@ -3,21 +3,12 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "kernels/morton_encoding.cuh"
+#include <ATen/cuda/CUDAContext.h>
 #include <cstdint>
 #include <cuda_runtime.h>
 
 namespace gs {
 
-    __device__ __forceinline__ uint64_t splitBy3(uint32_t a) {
-        uint64_t x = a & 0x1fffff;
-        x = (x | x << 32) & 0x1f00000000ffff;
-        x = (x | x << 16) & 0x1f0000ff0000ff;
-        x = (x | x << 8) & 0x100f00f00f00f00f;
-        x = (x | x << 4) & 0x10c30c30c30c30c3;
-        x = (x | x << 2) & 0x1249249249249249;
-        return x;
-    }
-
     __global__ void morton_encode_cu(
         const float3* __restrict__ positions,
         const float3* __restrict__ minimum_coordinates,
@@ -79,7 +70,7 @@ namespace gs {
         constexpr int block_size = 256;
         const int grid_size = (n_positions + block_size - 1) / block_size;
 
-        morton_encode_cu<<<grid_size, block_size>>>(
+        morton_encode_cu<<<grid_size, block_size, 0, at::cuda::getCurrentCUDAStream()>>>(
             reinterpret_cast<const float3*>(positions.contiguous().data_ptr<float>()),
             reinterpret_cast<const float3*>(min_vals.contiguous().data_ptr<float>()),
             cube_size.data_ptr<float>(),
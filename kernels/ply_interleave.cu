@@ -0,0 +1,122 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "kernels/ply_interleave.cuh"
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <cuda_runtime.h>
+#include <string>
+
+namespace gs {
+
+    namespace {
+        constexpr int block_size = 256;
+
+        void check_launch(const char* what) {
+            cudaError_t err = cudaGetLastError();
+            if (err != cudaSuccess) {
+                throw std::runtime_error(std::string("CUDA error in ") + what + ": " + cudaGetErrorString(err));
+            }
+        }
+    } // namespace
+
+    // One thread per output float, so the record stores are coalesced; the gathers from the
+    // per-attribute arrays hit the same few cache lines within a warp
+    template <typename sh_t>
+    __global__ void interleave_ply_vertices_cu(
+        const float* __restrict__ means,
+        const float* __restrict__ sh0,
+        const sh_t* __restrict__ shN,
+        const float* __restrict__ opacity,
+        const float* __restrict__ scaling,
+        const float* __restrict__ rotation,
+        float* __restrict__ out,
+        const int64_t n,
+        const int n_rest,
+        const int cols) {
+        const int64_t idx = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+        if (idx >= n * cols) {
+            return;
+        }
+        const int64_t row = idx / cols;
+        int col = static_cast<int>(idx - row * cols);
+
+        float value;
+        if (col < 3) {
+            value = means[row * 3 + col];
+        } else if (col < 6) {
+            value = 0.f;
+        } else if (col < 9) {
+            value = sh0[row * 3 + col - 6];
+        } else if ((col -= 9) < 3 * n_rest) {
+            // f_rest is channel-major, shN is coefficient-major
+            const int channel = col / n_rest;
+            const int coeff = col - channel * n_rest;
+            value = static_cast<float>(shN[(row * n_rest + coeff) * 3 + channel]);
+        } else if ((col -= 3 * n_rest) == 0) {
+            value = opacity[row];
+        } else if (col < 4) {
+            value = scaling[row * 3 + col - 1];
+        } else {
+            const float* q = rotation + row * 4;
+            const float norm = fmaxf(sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]), 1e-12f);
+            value = q[col - 4] / norm;
+        }
+        out[idx] = value;
+    }
+
+    torch::Tensor interleave_ply_vertices(const torch::Tensor& means,
+                                          const torch::Tensor& sh0,
+                                          const torch::Tensor& shN,
+                                          const torch::Tensor& opacity,
+                                          const torch::Tensor& scaling,
+                                          const torch::Tensor& rotation) {
+        TORCH_CHECK(means.is_cuda() && means.dim() == 2 && means.size(1) == 3,
+                    "means must be a CUDA [N, 3] tensor");
+        TORCH_CHECK(means.scalar_type() == torch::kFloat32 && sh0.scalar_type() == torch::kFloat32 &&
+                        opacity.scalar_type() == torch::kFloat32 && scaling.scalar_type() == torch::kFloat32 &&
+                        rotation.scalar_type() == torch::kFloat32,
+                    "means, sh0, opacity, scaling and rotation must be float32");
+        const int64_t n = means.size(0);
+        TORCH_CHECK(sh0.numel() == n * 3 && opacity.numel() == n && scaling.numel() == n * 3 &&
+                        rotation.numel() == n * 4,
+                    "attribute sizes do not match the number of Gaussians");
+        TORCH_CHECK(shN.dim() == 3 && shN.size(0) == n && shN.size(2) == 3, "shN must be a [N, K, 3] tensor");
+
+        const int n_rest = static_cast<int>(shN.size(1));
+        const int cols = 17 + 3 * n_rest;
+        auto out = torch::empty({n, cols}, means.options());
+        if (n == 0) {
+            return out;
+        }
+
+        const at::cuda::CUDAGuard device_guard(means.device());
+        const auto stream = at::cuda::getCurrentCUDAStream();
+        const auto means_c = means.contiguous();
+        const auto sh0_c = sh0.contiguous();
+        const auto shN_c = shN.contiguous();
+        const auto opacity_c = opacity.contiguous();
+        const auto scaling_c = scaling.contiguous();
+        const auto rotation_c = rotation.contiguous();
+
+        const int64_t total = n * cols;
+        const int grid_size = static_cast<int>((total + block_size - 1) / block_size);
+        AT_DISPATCH_FLOATING_TYPES_AND2(at::kHalf, at::kBFloat16, shN.scalar_type(), "interleave_ply_vertices", [&] {
+            interleave_ply_vertices_cu<scalar_t><<<grid_size, block_size, 0, stream>>>(
+                means_c.data_ptr<float>(),
+                sh0_c.data_ptr<float>(),
+                shN_c.data_ptr<scalar_t>(),
+                opacity_c.data_ptr<float>(),
+                scaling_c.data_ptr<float>(),
+                rotation_c.data_ptr<float>(),
+                out.data_ptr<float>(),
+                n,
+                n_rest,
+                cols);
+        });
+        check_launch("interleave_ply_vertices");
+        return out;
+    }
+
+} // namespace gs
@@ -0,0 +1,277 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "kernels/sog_packing.cuh"
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <cuda_runtime.h>
+#include <string>
+
+namespace gs {
+
+    namespace {
+        constexpr int block_size = 256;
+
+        struct AxisRange {
+            float min[3];
+            float inv_extent[3];
+        };
+
+        void check_launch(const char* what) {
+            cudaError_t err = cudaGetLastError();
+            if (err != cudaSuccess) {
+                throw std::runtime_error(std::string("CUDA error in ") + what + ": " + cudaGetErrorString(err));
+            }
+        }
+
+        void check_order(const torch::Tensor& order, int64_t n, int width, int height) {
+            TORCH_CHECK(order.is_cuda() && order.scalar_type() == torch::kInt64 && order.numel() == n,
+                        "order must be an int64 CUDA tensor with one index per splat");
+            TORCH_CHECK(width > 0 && height > 0 && n <= static_cast<int64_t>(width) * height,
+                        "texture too small for the splats");
+        }
+
+        int grid_for(int64_t pixels) {
+            return static_cast<int>((pixels + block_size - 1) / block_size);
+        }
+
+        __device__ __forceinline__ uint8_t unit_to_byte(float v) {
+            return static_cast<uint8_t>(fminf(fmaxf((v * 0.5f + 0.5f) * 255.0f, 0.0f), 255.0f));
+        }
+    } // namespace
+
+    __global__ void sog_pack_means_cu(
+        const float* __restrict__ means,
+        const int64_t* __restrict__ order,
+        const int64_t n,
+        const int64_t pixels,
+        const AxisRange range,
+        uchar4* __restrict__ lower,
+        uchar4* __restrict__ upper) {
+
+        const int64_t idx = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+        if (idx >= pixels)
+            return;
+        if (idx >= n) {
+            lower[idx] = make_uchar4(255, 255, 255, 255);
+            upper[idx] = make_uchar4(255, 255, 255, 255);
+            return;
+        }
+
+        const float* mean = means + order[idx] * 3;
+        uint16_t q[3];
+        for (int i = 0; i < 3; ++i) {
+            const float log_value = copysignf(logf(fabsf(mean[i]) + 1.0f), mean[i]);
+            const float t = (log_value - range.min[i]) * range.inv_extent[i];
+            q[i] = static_cast<uint16_t>(65535.0f * fminf(fmaxf(t, 0.0f), 1.0f));
+        }
+        lower[idx] = make_uchar4(q[0] & 0xff, q[1] & 0xff, q[2] & 0xff, 255);
+        upper[idx] = make_uchar4(q[0] >> 8, q[1] >> 8, q[2] >> 8, 255);
+    }
+
+    __global__ void sog_pack_quaternions_cu(
+        const float4* __restrict__ rotations,
+        const int64_t* __restrict__ order,
+        const int64_t n,
+        const int64_t pixels,
+        uchar4* __restrict__ packed) {
+
+        const int64_t idx = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+        if (idx >= pixels)
+            return;
+        if (idx >= n) {
+            packed[idx] = make_uchar4(255, 255, 255, 255);
+            return;
+        }
+
+        const float4 r = rotations[order[idx]];
+        float q[4] = {r.x, r.y, r.z, r.w}; // w, x, y, z
+        const float len = sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        if (len > 0.0f) {
+            for (int i = 0; i < 4; ++i) {
+                q[i] /= len;
+            }
+        } else {
+            q[0] = 1.0f;
+            q[1] = q[2] = q[3] = 0.0f;
+        }
+
+        int largest = 0;
+        for (int i = 1; i < 4; ++i) {
+            if (fabsf(q[i]) > fabsf(q[largest])) {
+                largest = i;
+            }
+        }
+
+        // The largest component is dropped and reconstructed as positive, the rest span [-1, 1] after sqrt(2)
+        const float scale = q[largest] < 0.0f ? -1.41421356237f : 1.41421356237f;
+        uint8_t kept[3];
+        for (int i = 0, k = 0; i < 4; ++i) {
+            if (i != largest) {
+                kept[k++] = unit_to_byte(q[i] * scale);
+            }
+        }
+        packed[idx] = make_uchar4(kept[0], kept[1], kept[2], static_cast<uint8_t>(252 + largest));
+    }
+
+    __global__ void sog_pack_codes_cu(
+        const int32_t* __restrict__ labels,
+        const int64_t* __restrict__ order,
+        const float* __restrict__ alpha,
+        const int64_t n,
+        const int64_t pixels,
+        const uint8_t padding,
+        uchar4* __restrict__ packed) {
+
+        const int64_t idx = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+        if (idx >= pixels)
+            return;
+        if (idx >= n) {
+            packed[idx] = make_uchar4(padding, padding, padding, padding);
+            return;
+        }
+
+        const int64_t splat = order[idx];
+        const uint8_t a = alpha ? static_cast<uint8_t>(255.0f * alpha[splat]) : 255;
+        packed[idx] = make_uchar4(static_cast<uint8_t>(labels[splat]),
+                                  static_cast<uint8_t>(labels[n + splat]),
+                                  static_cast<uint8_t>(labels[2 * n + splat]),
+                                  a);
+    }
+
+    __global__ void sog_pack_palette_labels_cu(
+        const int32_t* __restrict__ labels,
+        const int64_t* __restrict__ order,
+        const int64_t n,
+        const int64_t pixels,
+        uchar4* __restrict__ packed) {
+
+        const int64_t idx = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+        if (idx >= pixels)
+            return;
+        if (idx >= n) {
+            packed[idx] = make_uchar4(255, 255, 255, 255);
+            return;
+        }
+
+        const int32_t label = labels[order[idx]];
+        packed[idx] = make_uchar4(label & 0xff, (label >> 8) & 0xff, 0, 255);
+    }
+
+    std::pair<torch::Tensor, torch::Tensor> sog_pack_means(const torch::Tensor& means,
+                                                           const torch::Tensor& order,
+                                                           const std::array<float, 3>& mins,
+                                                           const std::array<float, 3>& maxs,
+                                                           int width,
+                                                           int height) {
+        TORCH_CHECK(means.is_cuda() && means.dim() == 2 && means.size(1) == 3 &&
+                        means.scalar_type() == torch::kFloat32,
+                    "means must be a float32 CUDA [N, 3] tensor");
+        const int64_t n = means.size(0);
+        check_order(order, n, width, height);
+
+        const at::cuda::CUDAGuard device_guard(means.device());
+        const auto contiguous_means = means.contiguous();
+        const auto contiguous_order = order.contiguous();
+        const int64_t pixels = static_cast<int64_t>(width) * height;
+        auto lower = torch::empty({height, width, 4}, means.options().dtype(torch::kUInt8));
+        auto upper = torch::empty_like(lower);
+
+        AxisRange range;
+        for (int i = 0; i < 3; ++i) {
+            range.min[i] = mins[i];
+            range.inv_extent[i] = 1.0f / (maxs[i] - mins[i] + 1e-10f);
+        }
+
+        sog_pack_means_cu<<<grid_for(pixels), block_size, 0, at::cuda::getCurrentCUDAStream()>>>(
+            contiguous_means.data_ptr<float>(),
+            contiguous_order.data_ptr<int64_t>(),
+            n, pixels, range,
+            reinterpret_cast<uchar4*>(lower.data_ptr<uint8_t>()),
+            reinterpret_cast<uchar4*>(upper.data_ptr<uint8_t>()));
+        check_launch("sog_pack_means");
+        return {lower, upper};
+    }
+
+    torch::Tensor sog_pack_quaternions(const torch::Tensor& rotations,
+                                       const torch::Tensor& order,
+                                       int width,
+                                       int height) {
+        TORCH_CHECK(rotations.is_cuda() && rotations.dim() == 2 && rotations.size(1) == 4 &&
+                        rotations.scalar_type() == torch::kFloat32,
+                    "rotations must be a float32 CUDA [N, 4] tensor");
+        const int64_t n = rotations.size(0);
+        check_order(order, n, width, height);
+
+        const at::cuda::CUDAGuard device_guard(rotations.device());
+        const auto contiguous_rotations = rotations.contiguous();
+        const auto contiguous_order = order.contiguous();
+        const int64_t pixels = static_cast<int64_t>(width) * height;
+        auto packed = torch::empty({height, width, 4}, rotations.options().dtype(torch::kUInt8));
+
+        sog_pack_quaternions_cu<<<grid_for(pixels), block_size, 0, at::cuda::getCurrentCUDAStream()>>>(
+            reinterpret_cast<const float4*>(contiguous_rotations.data_ptr<float>()),
+            contiguous_order.data_ptr<int64_t>(),
+            n, pixels,
+            reinterpret_cast<uchar4*>(packed.data_ptr<uint8_t>()));
+        check_launch("sog_pack_quaternions");
+        return packed;
+    }
+
+    torch::Tensor sog_pack_codes(const torch::Tensor& labels,
+                                 const torch::Tensor& order,
+                                 const torch::Tensor& alpha,
+                                 int width,
+                                 int height,
+                                 uint8_t padding) {
+        TORCH_CHECK(labels.is_cuda() && labels.scalar_type() == torch::kInt32 && labels.numel() % 3 == 0,
+                    "labels must be an int32 CUDA tensor of 3 * N entries");
+        const int64_t n = labels.numel() / 3;
+        check_order(order, n, width, height);
+        TORCH_CHECK(!alpha.defined() || (alpha.is_cuda() && alpha.scalar_type() == torch::kFloat32 &&
+                                         alpha.numel() == n),
+                    "alpha must be a float32 CUDA tensor with one value per splat");
+
+        const at::cuda::CUDAGuard device_guard(labels.device());
+        const auto contiguous_labels = labels.contiguous();
+        const auto contiguous_order = order.contiguous();
+        const auto contiguous_alpha = alpha.defined() ? alpha.contiguous() : alpha;
+        const int64_t pixels = static_cast<int64_t>(width) * height;
+        auto packed = torch::empty({height, width, 4}, labels.options().dtype(torch::kUInt8));
+
+        sog_pack_codes_cu<<<grid_for(pixels), block_size, 0, at::cuda::getCurrentCUDAStream()>>>(
+            contiguous_labels.data_ptr<int32_t>(),
+            contiguous_order.data_ptr<int64_t>(),
+            contiguous_alpha.defined() ? contiguous_alpha.data_ptr<float>() : nullptr,
+            n, pixels, padding,
+            reinterpret_cast<uchar4*>(packed.data_ptr<uint8_t>()));
+        check_launch("sog_pack_codes");
+        return packed;
+    }
+
+    torch::Tensor sog_pack_palette_labels(const torch::Tensor& labels,
+                                          const torch::Tensor& order,
+                                          int width,
+                                          int height) {
+        TORCH_CHECK(labels.is_cuda() && labels.scalar_type() == torch::kInt32,
+                    "labels must be an int32 CUDA tensor");
+        const int64_t n = labels.numel();
+        check_order(order, n, width, height);
+
+        const at::cuda::CUDAGuard device_guard(labels.device());
+        const auto contiguous_labels = labels.contiguous();
+        const auto contiguous_order = order.contiguous();
+        const int64_t pixels = static_cast<int64_t>(width) * height;
+        auto packed = torch::empty({height, width, 4}, labels.options().dtype(torch::kUInt8));
+
+        sog_pack_palette_labels_cu<<<grid_for(pixels), block_size, 0, at::cuda::getCurrentCUDAStream()>>>(
+            contiguous_labels.data_ptr<int32_t>(),
+            contiguous_order.data_ptr<int64_t>(),
+            n, pixels,
+            reinterpret_cast<uchar4*>(packed.data_ptr<uint8_t>()));
+        check_launch("sog_pack_palette_labels");
+        return packed;
+    }
+
+} // namespace gs
@@ -0,0 +1,195 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "kernels/splat_transform.cuh"
+#include <ATen/cuda/CUDAContext.h>
+#include <algorithm>
+#include <c10/cuda/CUDAGuard.h>
+#include <cub/cub.cuh>
+#include <cuda_runtime.h>
+#include <string>
+
+namespace gs {
+
+    namespace {
+        constexpr int block_size = 256;
+
+        struct CropBox {
+            float world_to_box[12];
+            float box_min[3];
+            float box_max[3];
+        };
+
+        void check_launch(const char* what) {
+            cudaError_t err = cudaGetLastError();
+            if (err != cudaSuccess) {
+                throw std::runtime_error(std::string("CUDA error in ") + what + ": " + cudaGetErrorString(err));
+            }
+        }
+    } // namespace
+
+    template <typename sh_t>
+    __global__ void transform_splats_cu(
+        float* __restrict__ means,
+        float* __restrict__ rotation,
+        float* __restrict__ scaling,
+        sh_t* __restrict__ shN,
+        const int64_t n,
+        const int n_rest,
+        const SplatTransform transform) {
+
+        const int64_t idx = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+        if (idx >= n)
+            return;
+
+        const float* m = transform.affine;
+        float* mean = means + idx * 3;
+        const float x = mean[0], y = mean[1], z = mean[2];
+        mean[0] = m[0] * x + m[1] * y + m[2] * z + m[3];
+        mean[1] = m[4] * x + m[5] * y + m[6] * z + m[7];
+        mean[2] = m[8] * x + m[9] * y + m[10] * z + m[11];
+
+        // q_new = q_transform * q
+        const float* qt = transform.quaternion;
+        float* q = rotation + idx * 4;
+        const float w2 = q[0], x2 = q[1], y2 = q[2], z2 = q[3];
+        q[0] = qt[0] * w2 - qt[1] * x2 - qt[2] * y2 - qt[3] * z2;
+        q[1] = qt[0] * x2 + qt[1] * w2 + qt[2] * z2 - qt[3] * y2;
+        q[2] = qt[0] * y2 - qt[1] * z2 + qt[2] * w2 + qt[3] * x2;
+        q[3] = qt[0] * z2 + qt[1] * y2 - qt[2] * x2 + qt[3] * w2;
+
+        float* s = scaling + idx * 3;
+        s[0] += transform.log_scale;
+        s[1] += transform.log_scale;
+        s[2] += transform.log_scale;
+
+        // Band l holds 2l + 1 coefficients per channel, starting after the lower bands
+        constexpr int band_first[3] = {0, 3, 8};
+        constexpr int matrix_first[3] = {0, 9, 34};
+        sh_t* coefficients = shN + idx * n_rest * 3;
+        for (int band = 0; band < 3; ++band) {
+            const int size = 2 * band + 3;
+            if (band_first[band] + size > n_rest)
+                break;
+            const float* rotation_matrix = transform.sh_rotation + matrix_first[band];
+            sh_t* band_coefficients = coefficients + band_first[band] * 3;
+            for (int c = 0; c < 3; ++c) {
+                float in[7];
+                for (int i = 0; i < size; ++i) {
+                    in[i] = static_cast<float>(band_coefficients[i * 3 + c]);
+                }
+                for (int j = 0; j < size; ++j) {
+                    float out = 0.f;
+                    for (int i = 0; i < size; ++i) {
+                        out += rotation_matrix[j * size + i] * in[i];
+                    }
+                    band_coefficients[j * 3 + c] = static_cast<sh_t>(out);
+                }
+            }
+        }
+    }
+
+    __global__ void crop_box_flags_cu(
+        const float* __restrict__ means,
+        const int64_t n,
+        const CropBox box,
+        uint8_t* __restrict__ inside) {
+
+        const int64_t idx = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+        if (idx >= n)
+            return;
+
+        const float* m = box.world_to_box;
+        const float x = means[idx * 3 + 0], y = means[idx * 3 + 1], z = means[idx * 3 + 2];
+        const float local[3] = {m[0] * x + m[1] * y + m[2] * z + m[3],
+                                m[4] * x + m[5] * y + m[6] * z + m[7],
+                                m[8] * x + m[9] * y + m[10] * z + m[11]};
+        bool is_inside = true;
+        for (int i = 0; i < 3; ++i) {
+            is_inside &= local[i] >= box.box_min[i] && local[i] <= box.box_max[i];
+        }
+        inside[idx] = is_inside;
+    }
+
+    void transform_splats(torch::Tensor& means,
+                          torch::Tensor& rotation,
+                          torch::Tensor& scaling,
+                          torch::Tensor& shN,
+                          const SplatTransform& transform) {
+        TORCH_CHECK(means.is_cuda() && means.dim() == 2 && means.size(1) == 3 && means.is_contiguous(),
+                    "means must be a contiguous CUDA [N, 3] tensor");
+        TORCH_CHECK(means.scalar_type() == torch::kFloat32 && rotation.scalar_type() == torch::kFloat32 &&
+                        scaling.scalar_type() == torch::kFloat32,
+                    "means, rotation and scaling must be float32");
+        const int64_t n = means.size(0);
+        TORCH_CHECK(rotation.size(0) == n && rotation.size(1) == 4 && rotation.is_contiguous(),
+                    "rotation must be a contiguous [N, 4] tensor");
+        TORCH_CHECK(scaling.size(0) == n && scaling.size(1) == 3 && scaling.is_contiguous(),
+                    "scaling must be a contiguous [N, 3] tensor");
+        TORCH_CHECK(shN.size(0) == n && shN.dim() == 3 && shN.size(1) <= 15 && shN.is_contiguous(),
+                    "shN must be a contiguous [N, K <= 15, 3] tensor");
+        if (n == 0) {
+            return;
+        }
+
+        const at::cuda::CUDAGuard device_guard(means.device());
+        const auto stream = at::cuda::getCurrentCUDAStream();
+        const int grid_size = static_cast<int>((n + block_size - 1) / block_size);
+        AT_DISPATCH_FLOATING_TYPES_AND2(at::kHalf, at::kBFloat16, shN.scalar_type(), "transform_splats", [&] {
+            transform_splats_cu<scalar_t><<<grid_size, block_size, 0, stream>>>(
+                means.data_ptr<float>(),
+                rotation.data_ptr<float>(),
+                scaling.data_ptr<float>(),
+                shN.data_ptr<scalar_t>(),
+                n,
+                static_cast<int>(shN.size(1)),
+                transform);
+        });
+        check_launch("transform_splats");
+    }
+
+    torch::Tensor crop_box_indices(const torch::Tensor& means,
+                                   const std::array<float, 12>& world_to_box,
+                                   const std::array<float, 3>& box_min,
+                                   const std::array<float, 3>& box_max) {
+        TORCH_CHECK(means.is_cuda() && means.dim() == 2 && means.size(1) == 3,
+                    "means must be a CUDA [N, 3] tensor");
+        TORCH_CHECK(means.scalar_type() == torch::kFloat32, "means must be float32");
+
+        const int64_t n = means.size(0);
+        const auto index_options = means.options().dtype(torch::kInt64);
+        if (n == 0) {
+            return torch::empty({0}, index_options);
+        }
+
+        const at::cuda::CUDAGuard device_guard(means.device());
+        const auto stream = at::cuda::getCurrentCUDAStream();
+        const auto contiguous_means = means.contiguous();
+
+        CropBox box;
+        std::copy(world_to_box.begin(), world_to_box.end(), box.world_to_box);
+        std::copy(box_min.begin(), box_min.end(), box.box_min);
+        std::copy(box_max.begin(), box_max.end(), box.box_max);
+
+        auto inside = torch::empty({n}, means.options().dtype(torch::kUInt8));
+        const int grid_size = static_cast<int>((n + block_size - 1) / block_size);
+        crop_box_flags_cu<<<grid_size, block_size, 0, stream>>>(
+            contiguous_means.data_ptr<float>(), n, box, inside.data_ptr<uint8_t>());
+        check_launch("crop_box_indices");
+
+        auto indices = torch::empty({n}, index_options);
+        auto n_selected = torch::empty({1}, index_options);
+        const cub::CountingInputIterator<int64_t> counting(0);
+        size_t temp_bytes = 0;
+        cub::DeviceSelect::Flagged(nullptr, temp_bytes, counting, inside.data_ptr<uint8_t>(),
+                                   indices.data_ptr<int64_t>(), n_selected.data_ptr<int64_t>(), n, stream);
+        auto temp = torch::empty({static_cast<int64_t>(temp_bytes)}, means.options().dtype(torch::kUInt8));
+        cub::DeviceSelect::Flagged(temp.data_ptr(), temp_bytes, counting, inside.data_ptr<uint8_t>(),
+                                   indices.data_ptr<int64_t>(), n_selected.data_ptr<int64_t>(), n, stream);
+        check_launch("crop_box_indices");
+
+        return indices.narrow(0, 0, n_selected.item<int64_t>());
+    }
+
+} // namespace gs
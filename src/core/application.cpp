@@ -4,10 +4,21 @@
 
 #include "core/application.hpp"
 #include "core/argument_parser.hpp"
+#include "core/batch_export.hpp"
+#include "core/image_io.hpp"
 #include "core/logger.hpp"
+#include "core/splat_delta.hpp"
+#include "core/trace_recorder.hpp"
+#include "loader/loader.hpp"
 #include "project/project.hpp"
+#include "training/compaction.hpp"
+#include "training/dataloader_benchmark.hpp"
+#include "training/render_path.hpp"
+#include "training/job_queue.hpp"
+#include "training/render_server.hpp"
 #include "training/training_setup.hpp"
 #include "visualizer/visualizer.hpp"
+#include <algorithm>
 #ifdef WIN32
 #include <windows.h>
 #endif
@@ -53,6 +64,110 @@ namespace gs {
         return 0;
     }
 
+    int run_materialize_delta(const param::TrainingParameters& params) {
+        const auto& directory = *params.materialize_delta;
+        int iteration = params.materialize_iteration;
+        if (iteration < 0) {
+            // splat_<iteration>.lfsdelta, the latest one
+            for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+                const auto stem = entry.path().stem().string();
+                if (entry.path().extension() == core::SPLAT_DELTA_EXTENSION && stem.starts_with("splat_")) {
+                    try {
+                        iteration = std::max(iteration, std::stoi(stem.substr(6)));
+                    } catch (const std::exception&) {
+                    }
+                }
+            }
+            if (iteration < 0) {
+                LOG_ERROR("No delta files in {}", directory.string());
+                return -1;
+            }
+        }
+
+        auto splat_data = core::materialize_splat_delta(directory, iteration);
+        if (!splat_data) {
+            LOG_ERROR("{}", splat_data.error());
+            return -1;
+        }
+        const auto output = params.dataset.output_path.empty() ? directory : params.dataset.output_path;
+        splat_data->save_ply(output, iteration, /*join_threads=*/true);
+        LOG_INFO("Wrote {}", (output / ("splat_" + std::to_string(iteration) + ".ply")).string());
+        return 0;
+    }
+
+    int run_batch_export(const param::TrainingParameters& params) {
+        auto summary = core::run_batch_export(*params.batch_export, params.optimization);
+        if (!summary) {
+            LOG_ERROR("{}", summary.error());
+            return -1;
+        }
+        return summary->failed == 0 ? 0 : -1;
+    }
+
+    int run_render_path(const param::TrainingParameters& params) {
+        if (auto rendered = training::render_camera_path(*params.render_path); !rendered) {
+            LOG_ERROR("{}", rendered.error());
+            return -1;
+        }
+        return 0;
+    }
+
+    int run_render_server(const param::TrainingParameters& params) {
+        if (auto served = training::run_render_server(*params.render_server); !served) {
+            LOG_ERROR("{}", served.error());
+            return -1;
+        }
+        return 0;
+    }
+
+    int run_job_queue(const param::TrainingParameters& params) {
+        auto summary = training::run_job_queue(*params.job_queue);
+        if (!summary) {
+            LOG_ERROR("{}", summary.error());
+            return -1;
+        }
+        return summary->failed == 0 ? 0 : -1;
+    }
+
+    int run_compaction(const param::TrainingParameters& params) {
+        if (auto compacted = training::compact_model(*params.compact, params.dataset, params.optimization); !compacted) {
+            LOG_ERROR("{}", compacted.error());
+            return -1;
+        }
+        return 0;
+    }
+
+    int run_dataloader_benchmark(const param::TrainingParameters& params) {
+        if (auto benchmarked = training::run_dataloader_benchmark(*params.benchmark_dataloader, params.dataset,
+                                                                  params.optimization);
+            !benchmarked) {
+            LOG_ERROR("{}", benchmarked.error());
+            return -1;
+        }
+        return 0;
+    }
+
+    int run_dataset_validation(const param::TrainingParameters& params) {
+        try {
+            auto result = loader::Loader::create()->load(params.dataset.data_path,
+                                                         {.images_folder = params.dataset.images,
+                                                          .validate_only = true});
+            if (!result) {
+                LOG_ERROR("{}", result.error());
+                return -1;
+            }
+            for (const auto& warning : result->warnings) {
+                LOG_WARN("{}", warning);
+            }
+            LOG_INFO("{} dataset {} is valid ({}ms)", result->loader_used, params.dataset.data_path.string(),
+                     result->load_time.count());
+            return 0;
+        } catch (const std::exception& e) {
+            LOG_ERROR("{}", e.what());
+            return -1;
+        }
+    }
+
     int run_gui_app(std::unique_ptr<param::TrainingParameters> params) {
         LOG_INFO("Starting viewer mode...");
 
@@ -138,6 +253,47 @@ namespace gs {
     }
 
     int Application::run(std::unique_ptr<param::TrainingParameters> params) {
+        // Must be configured before the first image is probed by a loader
+        if (params->optimization.disk_image_cache) {
+            image_io::DiskImageCache::instance().enable(params->optimization.disk_image_cache_dir);
+        }
+
+        if (params->materialize_delta) {
+            return run_materialize_delta(*params);
+        }
+
+        if (params->batch_export) {
+            return run_batch_export(*params);
+        }
+
+        if (params->render_path) {
+            return run_render_path(*params);
+        }
+
+        if (params->render_server) {
+            return run_render_server(*params);
+        }
+
+        if (params->job_queue) {
+            return run_job_queue(*params);
+        }
+
+        if (params->compact) {
+            return run_compaction(*params);
+        }
+
+        if (params->benchmark_dataloader) {
+            return run_dataloader_benchmark(*params);
+        }
+
+        if (params->validate_dataset) {
+            return run_dataset_validation(*params);
+        }
+
+        // Records until the training or the viewer ends
+        const core::TraceSession trace(params->optimization.trace_output,
+                                       static_cast<size_t>(std::max(params->optimization.trace_capacity, 1)));
+
         // no gui
         if (params->optimization.headless) {
             return run_headless_app(std::move(params));
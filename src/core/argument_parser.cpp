@@ -5,7 +5,10 @@
 #include "core/argument_parser.hpp"
 #include "core/logger.hpp"
 #include "core/parameters.hpp"
+#include <algorithm>
 #include <args.hxx>
+#include <array>
+#include <cmath>
 #include <expected>
 #include <filesystem>
 #include <format>
@@ -50,7 +53,41 @@ namespace {
 
     const std::set<std::string> VALID_RENDER_MODES = {"RGB", "D", "ED", "RGB_D", "RGB_ED"};
     const std::set<std::string> VALID_POSE_OPTS = {"none", "direct", "mlp"};
-    const std::set<std::string> VALID_STRATEGIES = {"mcmc", "default"};
+    const std::set<std::string> VALID_STRATEGIES = {"mcmc", "default", "taming"};
+    const std::set<std::string> VALID_DATALOADERS = {"efficient", "libtorch"};
+
+    const std::set<std::string> VALID_EXPORT_FORMATS = {"ply", "sog", "lod"};
+
+    // Splits a comma-separated list, e.g. "ply,sog"
+    std::vector<std::string> split_list(const std::string& value) {
+        std::vector<std::string> items;
+        size_t begin = 0;
+        while (begin <= value.size()) {
+            const size_t end = std::min(value.find(',', begin), value.size());
+            if (end > begin) {
+                items.push_back(value.substr(begin, end - begin));
+            }
+            begin = end + 1;
+        }
+        return items;
+    }
+
+    template <size_t N>
+    std::expected<std::array<float, N>, std::string> parse_float_list(const std::string& value, const char* flag) {
+        const auto items = split_list(value);
+        if (items.size() != N) {
+            return std::unexpected(std::format("ERROR: --{} expects {} comma-separated numbers, got {}", flag, N, items.size()));
+        }
+        std::array<float, N> numbers;
+        for (size_t i = 0; i < N; ++i) {
+            try {
+                numbers[i] = std::stof(items[i]);
+            } catch (const std::exception&) {
+                return std::unexpected(std::format("ERROR: --{}: '{}' is not a number", flag, items[i]));
+            }
+        }
+        return numbers;
+    }
 
     void scale_steps_vector(std::vector<size_t>& steps, size_t scaler) {
         std::set<size_t> unique_steps(steps.begin(), steps.end());
@@ -62,6 +99,15 @@ namespace {
         steps.assign(unique_steps.begin(), unique_steps.end());
     }
 
+    // Steps of a shortened schedule, distinct and within it
+    void shrink_steps_vector(std::vector<size_t>& steps, float scaler, size_t iterations) {
+        std::set<size_t> unique_steps;
+        for (const auto& step : steps) {
+            unique_steps.insert(std::clamp(static_cast<size_t>(std::lround(step * scaler)), size_t{1}, iterations));
+        }
+        steps.assign(unique_steps.begin(), unique_steps.end());
+    }
+
     // Parse log level from string
     gs::core::LogLevel parse_log_level(const std::string& level_str) {
         if (level_str == "trace")
@@ -90,7 +136,9 @@ namespace {
                 "LichtFeld Studio: High-performance CUDA implementation of 3D Gaussian Splatting algorithm. \n",
                 "Usage:\n"
                 "  Training: LichtFeld-Studio --data-path <path> --output-path <path> [options]\n"
-                "  Viewing:  LichtFeld-Studio --view <path_to_ply> [options]\n");
+                "  Viewing:  LichtFeld-Studio --view <path_to_ply> [options]\n"
+                "  Export:   LichtFeld-Studio --export <file_or_dir> --output-path <path> [--export-formats ply,sog,lod]\n"
+                "  Queue:    LichtFeld-Studio --job-queue <jobs.json> [--job-gpus 0,1] [--jobs-per-gpu 2]\n");
 
             // Define all arguments
             ::args::HelpFlag help(parser, "help", "Display help menu", {'h', "help"});
@@ -98,6 +146,9 @@ namespace {
 
             // PLY viewing mode
             ::args::ValueFlag<std::string> view_ply(parser, "ply_file", "View a PLY file", {'v', "view"});
+            ::args::ValueFlag<int> model_cache_vram_mb(parser, "mb", "VRAM in MB the viewer keeps recently loaded splat files in (default: 2048, 0 disables)", {"model-cache-vram-mb"});
+            ::args::ValueFlag<int> model_cache_ram_mb(parser, "mb", "Pinned RAM in MB for the splat files evicted from that VRAM (default: 8192, 0 disables)", {"model-cache-ram-mb"});
+            ::args::Flag compress_textures(parser, "compress_textures", "Keep GT images and image previews as BC7 textures encoded on the GPU", {"compress-textures"});
 
             // LichtFeldStudio project arguments
             ::args::ValueFlag<std::string> project_name(parser, "proj_path", "LichtFeldStudio project path. Path must end with .lfs", {"proj_path"});
@@ -111,7 +162,11 @@ namespace {
 
             // Optional value arguments
             ::args::ValueFlag<uint32_t> iterations(parser, "iterations", "Number of iterations", {'i', "iter"});
-            ::args::ValueFlag<int> num_workers(parser, "num_threads", "Number of workers", {"num-workers"});
+            ::args::ValueFlag<int> num_workers(parser, "num_threads", "Number of dataloader workers, 0 to autotune them at startup and adjust them to starvation (default: 16)", {"num-workers"});
+            ::args::ValueFlag<int> cpu_threads(parser, "threads", "CPU thread budget shared by dataloader workers and image decoding", {"cpu-threads"});
+            ::args::Flag pin_threads(parser, "pin_threads", "Pin worker threads to the CPUs of the training GPU's NUMA node", {"pin-threads"});
+            ::args::ValueFlag<std::string> dataloader(parser, "dataloader", "Training dataloader backend: efficient, libtorch", {"dataloader"});
+            ::args::ValueFlag<int> preload_max_mb(parser, "preload_max_mb", "RAM budget in MB for --preload-to-ram, 0 preloads nothing and -1 is unlimited (default: 16384)", {"preload-max-mb"});
             ::args::ValueFlag<int> max_cap(parser, "max_cap", "Max Gaussians for MCMC", {"max-cap"});
             ::args::ValueFlag<std::string> images_folder(parser, "images", "Images folder name", {"images"});
             ::args::ValueFlag<int> test_every(parser, "test_every", "Use every Nth image as test", {"test-every"});
@@ -119,14 +174,75 @@ namespace {
             ::args::ValueFlag<int> sh_degree_interval(parser, "sh_degree_interval", "SH degree interval", {"sh-degree-interval"});
             ::args::ValueFlag<int> sh_degree(parser, "sh_degree", "Max SH degree [1-3]", {"sh-degree"});
             ::args::ValueFlag<float> min_opacity(parser, "min_opacity", "Minimum opacity threshold", {"min-opacity"});
+            ::args::ValueFlag<float> prune_contribution(parser, "weight", "Prune (MCMC: relocate) Gaussians whose blending weight stayed below this in every pixel since the last refinement (default: 0, off)", {"prune-contribution"});
             ::args::ValueFlag<std::string> render_mode(parser, "render_mode", "Render mode: RGB, D, ED, RGB_D, RGB_ED", {"render-mode"});
             ::args::ValueFlag<std::string> pose_opt(parser, "pose_opt", "Enable pose optimization type: none, direct, mlp", {"pose-opt"});
-            ::args::ValueFlag<std::string> strategy(parser, "strategy", "Optimization strategy: mcmc, default", {"strategy"});
+            ::args::ValueFlag<std::string> strategy(parser, "strategy", "Optimization strategy: mcmc, default, taming", {"strategy"});
             ::args::ValueFlag<int> init_num_pts(parser, "init_num_pts", "Number of random initialization points", {"init-num-pts"});
             ::args::ValueFlag<float> init_extent(parser, "init_extent", "Extent of random initialization", {"init-extent"});
             ::args::ValueFlagList<std::string> timelapse_images(parser, "timelapse_images", "Image filenames to render timelapse images for", {"timelapse-images"});
             ::args::ValueFlag<int> timelapse_every(parser, "timelapse_every", "Render timelapse image every N iterations (default: 50)", {"timelapse-every"});
-            ::args::ValueFlag<std::string> init_ply(parser, "init_ply", "Optional PLY splat file for initialization", {"init-ply"});
+            ::args::ValueFlag<std::string> init_ply(parser, "init_ply", "Optional PLY or SOG splat file for initialization", {"init-ply"});
+            ::args::ValueFlag<std::string> materialize_delta(parser, "delta_dir", "Rebuild a PLY from the .lfsdelta files in this directory and exit", {"materialize-delta"});
+            ::args::ValueFlag<int> materialize_iteration(parser, "iteration", "Iteration --materialize-delta rebuilds (default: the latest)", {"materialize-iteration"});
+            ::args::ValueFlag<std::string> export_input(parser, "path", "Convert a splat file, or every splat file in a directory, into --output-path and exit", {"export"});
+            ::args::ValueFlag<std::string> export_formats(parser, "formats", "Comma-separated formats --export and --compact write: ply, sog, lod (default: ply)", {"export-formats"});
+            ::args::ValueFlag<std::string> export_transform(parser, "matrix", "Row-major 3x4 transform --export applies first, 12 comma-separated numbers", {"export-transform"});
+            ::args::ValueFlag<std::string> export_crop(parser, "box", "World-aligned box --export crops to: min_x,min_y,min_z,max_x,max_y,max_z", {"export-crop"});
+            ::args::ValueFlag<float> export_min_opacity(parser, "opacity", "--export drops Gaussians below this opacity (default: 0, keep all)", {"export-min-opacity"});
+            ::args::ValueFlag<int> export_jobs(parser, "jobs", "Files --export converts at once (default: 2)", {"export-jobs"});
+            ::args::ValueFlag<std::string> render_path(parser, "path", "Render a camera path (keyframe JSON or dataset directory) through --render-model into a video in --output-path and exit", {"render-path"});
+            ::args::ValueFlag<std::string> render_model(parser, "ply", "Splat file --render-path and --render-server render", {"render-model"});
+            ::args::ValueFlag<std::string> render_size(parser, "size", "Video size of --render-path: width,height (default: 1920,1080)", {"render-size"});
+            ::args::ValueFlag<float> render_fps(parser, "fps", "Frame rate of --render-path (default: 30)", {"render-fps"});
+            ::args::ValueFlag<float> render_keyframe_seconds(parser, "seconds", "Time between --render-path keyframes without a time of their own (default: 1)", {"render-keyframe-seconds"});
+            ::args::ValueFlag<int> render_stride(parser, "n", "Use every n-th camera of a dataset --render-path (default: 1)", {"render-stride"});
+            ::args::ValueFlag<std::string> render_codec(parser, "codec", "FFmpeg encoder of --render-path and --render-server (default: h264_nvenc)", {"render-codec"});
+            ::args::ValueFlag<int> render_server(parser, "port", "Serve --render-model on this TCP port: clients send camera poses and receive an encoded video stream", {"render-server"});
+            ::args::ValueFlag<std::string> render_bind(parser, "address", "IPv4 address --render-server listens on (default: 127.0.0.1). The stream is unauthenticated, only bind other interfaces on trusted networks", {"render-bind"});
+            ::args::ValueFlag<int> render_sessions(parser, "n", "Clients --render-server serves at once (default: 4)", {"render-sessions"});
+            ::args::ValueFlag<std::string> benchmark_dataloader(parser, "report", "Time the dataloader alone on --data-path for several worker counts, write a JSON report and exit", {"benchmark-dataloader"});
+            ::args::ValueFlag<std::string> benchmark_workers(parser, "counts", "Comma-separated worker counts --benchmark-dataloader times (default: powers of two up to the hardware threads)", {"benchmark-workers"});
+            ::args::ValueFlag<int> benchmark_images(parser, "n", "Images --benchmark-dataloader times per worker count (default: 512)", {"benchmark-images"});
+            ::args::Flag validate_dataset(parser, "validate_dataset", "Check the structure, image files and image header sizes of --data-path without loading it, list every problem and exit non-zero if there are any", {"validate-dataset"});
+            ::args::ValueFlag<std::string> job_queue(parser, "jobs", "Train every dataset of a JSON job queue, each in a headless process, across the GPUs and exit", {"job-queue"});
+            ::args::ValueFlag<std::string> job_gpus(parser, "gpus", "Comma-separated GPU indices --job-queue schedules on (default: all)", {"job-gpus"});
+            ::args::ValueFlag<int> jobs_per_gpu(parser, "n", "Jobs with a vram_mb estimate --job-queue packs onto one GPU (default: 1)", {"jobs-per-gpu"});
+            ::args::ValueFlag<std::string> compact(parser, "ply", "Prune a trained splat file to a PSNR budget on --data-path, drop its unneeded SH bands, fine-tune it and write it to --output-path, then exit", {"compact"});
+            ::args::ValueFlag<float> compact_psnr_drop(parser, "db", "PSNR --compact may lose to pruning on the scoring views (default: 0.5)", {"compact-psnr-drop"});
+            ::args::ValueFlag<float> compact_sh_tolerance(parser, "rms", "RMS color of an SH band below which --compact drops it from a Gaussian (default: 0.004)", {"compact-sh-tolerance"});
+            ::args::ValueFlag<int> compact_fine_tune(parser, "iterations", "Fine-tune steps of --compact after pruning (default: 1000, 0: none)", {"compact-fine-tune"});
+            ::args::ValueFlag<int> compact_views(parser, "views", "Cameras --compact measures the PSNR on (default: 32, 0: all)", {"compact-views"});
+            ::args::ValueFlag<std::string> init_checkpoint(parser, "checkpoint", "Warm-start from the model and optimizer state of a checkpoint directory (or an output directory containing one), training starts at iteration 1", {"init-checkpoint"});
+            ::args::ValueFlag<int> fine_tune_iterations(parser, "iterations", "Rescale the schedule of a run warm-started with --init-ply or --init-checkpoint to this many iterations (default: 0, full schedule)", {"fine-tune-iterations"});
+            ::args::ValueFlag<std::string> resume(parser, "checkpoint", "Resume training from a checkpoint directory (or an output directory containing one)", {"resume"});
+            ::args::ValueFlag<int> checkpoint_every(parser, "checkpoint_every", "Also write a resumable checkpoint every N iterations (default: 0, save steps only)", {"checkpoint-every"});
+            ::args::ValueFlag<int> eval_views(parser, "views", "Validation views of the intermediate evaluations, a fixed random subset (default: 0, all)", {"eval-views"});
+            ::args::ValueFlag<int> eval_downscale(parser, "divisor", "Intermediate evaluations compare at 1/N resolution, the final one at full (default: 1)", {"eval-downscale"});
+            ::args::ValueFlag<int> early_stop_window(parser, "iterations", "Once refinement stopped, end training when the train loss improved less than --early-stop-threshold over this many iterations; with sparsity, sparsify from there (default: 0, off)", {"early-stop-window"});
+            ::args::ValueFlag<float> early_stop_threshold(parser, "gain", "Relative train loss improvement per --early-stop-window that counts as progress (default: 0.002)", {"early-stop-threshold"});
+            ::args::ValueFlag<int> views_per_step(parser, "views_per_step", "Cameras rendered per step, gradients accumulate before one optimizer update (default: 1)", {"views-per-step"});
+            ::args::ValueFlag<int> progressive_resolution(parser, "iterations", "Train at 1/4, then 1/2 resolution during the first N iterations, full resolution afterwards (default: 0, off)", {"progressive-resolution"});
+            ::args::ValueFlag<int> crop_size(parser, "pixels", "Train on random square crops of this side of every image, for very high-resolution images (default: 0, full images)", {"crop-size"});
+            ::args::ValueFlag<std::string> bilateral_grid_precision(parser, "precision", "Storage precision of the bilateral grids and their optimizer moments: float32, float16, bfloat16 (default: float32)", {"bilateral-grid-precision"});
+            ::args::ValueFlag<std::string> sh_precision(parser, "sh_precision", "Storage precision of shN and its optimizer moments: float32, float16, bfloat16 (default: float32)", {"sh-precision"});
+            ::args::ValueFlag<int> sh_codebook_iteration(parser, "iteration", "Train shN as a k-means palette indexed per Gaussian from this iteration, at or after the last refinement (default: 0, off)", {"sh-codebook-iteration"});
+            ::args::ValueFlag<int> sh_codebook_size(parser, "entries", "Palette entries of --sh-codebook-iteration (default: 4096)", {"sh-codebook-size"});
+            ::args::ValueFlag<int> sh_basis_iteration(parser, "iteration", "Train shN as per-Gaussian weights of a shared low-rank basis from this iteration, at or after the last refinement (default: 0, off)", {"sh-basis-iteration"});
+            ::args::ValueFlag<int> sh_basis_rank(parser, "rank", "Basis vectors of --sh-basis-iteration (default: 8)", {"sh-basis-rank"});
+            ::args::Flag progressive_sh(parser, "progressive_sh", "Allocate each SH band of shN and its optimizer moments only when the band activates", {"progressive-sh"});
+            ::args::ValueFlag<float> importance_sampling_floor(parser, "floor", "Share of --importance-sampling draws that stay uniform over all views (default: 0.3)", {"importance-sampling-floor"});
+            ::args::ValueFlag<int> densify_vram_mb(parser, "densify_vram_mb", "VRAM ceiling in MB for --densify-budget (default: 0, 90% of the device memory)", {"densify-vram-mb"});
+            ::args::ValueFlag<std::string> cuda_allocator(parser, "backend", "CUDA allocator backend: native or async (cudaMallocAsync, less fragmentation without expandable segments)", {"cuda-allocator"});
+            ::args::ValueFlag<int> vram_budget_mb(parser, "vram_budget_mb", "Reserved VRAM in MB before cached CUDA memory is released (default: 0, 90% of the device memory)", {"vram-budget-mb"});
+            ::args::ValueFlag<int> bucket_state_budget_mb(parser, "bucket_state_budget_mb", "Blend states in MB a forward keeps for its backward, larger ones are recomputed there in chunks (default: 0, no limit)", {"bucket-state-budget-mb"});
+            ::args::ValueFlag<std::string> tile_shape(parser, "tile_shape", "Rasterizer tile shape: 16x16, 8x8, 32x8 or auto to benchmark once per GPU and resolution (default: 16x16)", {"tile-shape"});
+            ::args::ValueFlag<int> viewer_snapshot_every(parser, "iterations", "Iterations between the model copies the viewer renders while training, 0 renders the live model (default: 10)", {"viewer-snapshot-every"});
+            ::args::ValueFlag<std::string> telemetry(parser, "target", "Stream per-iteration loss, Gaussian count, phase times and VRAM to a file or unix:<socket path>", {"telemetry"});
+            ::args::ValueFlag<std::string> telemetry_format(parser, "format", "Telemetry encoding: csv, binary (default: csv)", {"telemetry-format"});
+            ::args::ValueFlag<std::string> trace(parser, "file", "Record host thread and GPU spans into a Chrome trace JSON file (chrome://tracing, ui.perfetto.dev)", {"trace"});
+            ::args::ValueFlag<int> trace_capacity(parser, "spans", "Newest spans --trace keeps (default: 1048576)", {"trace-capacity"});
+            ::args::ValueFlag<int> profile_zones(parser, "iterations", "Log the GPU time of each profiling zone, averaged over this many iterations", {"profile-zones"});
 
             // Sparsity optimization arguments
             ::args::ValueFlag<int> sparsify_steps(parser, "sparsify_steps", "Number of steps for sparsification (default: 15000)", {"sparsify-steps"});
@@ -135,15 +251,21 @@ namespace {
 
             // SOG format arguments
             ::args::ValueFlag<int> sog_iterations(parser, "sog_iterations", "K-means iterations for SOG compression (default: 10)", {"sog-iterations"});
+            ::args::ValueFlag<int> sog_webp_level(parser, "level", "Lossless WebP effort of the SOG textures, 0 (fastest) to 9 (smallest) (default: 6)", {"sog-webp-level"});
+            ::args::ValueFlag<int> sog_qat_iteration(parser, "iteration", "Render straight-through SOG-quantized attributes from this iteration so the SOG export matches training, best after the last refinement (default: 0, off)", {"sog-qat-iteration"});
 
             // Logging options
             ::args::ValueFlag<std::string> log_level(parser, "level", "Log level: trace, debug, info, warn, error, critical, off (default: info)", {"log-level"});
             ::args::ValueFlag<std::string> log_file(parser, "file", "Optional log file path", {"log-file"});
+            ::args::Flag log_async(parser, "log_async", "Write log messages from a background thread, dropping them while its queue is full", {"log-async"});
 
             // Optional flag arguments
             ::args::Flag use_bilateral_grid(parser, "bilateral_grid", "Enable bilateral grid filtering", {"bilateral-grid"});
             ::args::Flag enable_eval(parser, "eval", "Enable evaluation during training", {"eval"});
             ::args::Flag headless(parser, "headless", "Disable visualization during training", {"headless"});
+            ::args::ValueFlag<int> seed(parser, "seed", "Seed every random number generator of the run (torch, view order, crops, background)", {"seed"});
+            ::args::Flag deterministic(parser, "deterministic", "Deterministic torch algorithms for reproducible runs, slower", {"deterministic"});
+            ::args::ValueFlag<std::string> benchmark(parser, "report", "Benchmark training throughput with fixed seeds, headless and without saving, writing a JSON report", {"benchmark"});
             ::args::Flag antialiasing(parser, "antialiasing", "Enable antialiasing", {'a', "antialiasing"});
             ::args::Flag enable_save_eval_images(parser, "save_eval_images", "Save eval images and depth maps", {"save-eval-images"});
             ::args::Flag save_depth(parser, "save_depth", "Save depth maps during training", {"save-depth"});
@@ -153,6 +275,31 @@ namespace {
             ::args::Flag gut(parser, "gut", "Enable GUT mode", {"gut"});
             ::args::Flag enable_sparsity(parser, "enable_sparsity", "Enable sparsity optimization", {"enable-sparsity"});
             ::args::Flag save_sog(parser, "sog", "Save in SOG format alongside PLY", {"sog"});
+            ::args::Flag save_lod(parser, "save_lod", "Save a chunked level-of-detail .lfslod file alongside PLY", {"save-lod"});
+            ::args::Flag save_delta(parser, "save_delta", "Store intermediate saves as .lfsdelta files holding only the changes since the previous save", {"save-delta"});
+            ::args::Flag morton_order(parser, "morton_order", "Keep the Gaussians Morton-sorted after refinement and in saved PLY/SOG files", {"morton-order"});
+            ::args::Flag ply_direct_io(parser, "ply_direct_io", "Write PLY vertex data with O_DIRECT, bypassing the page cache (Linux only)", {"ply-direct-io"});
+            ::args::Flag preload_to_ram(parser, "preload_to_ram", "Decode all training images into RAM once at startup", {"preload-to-ram"});
+            ::args::Flag preload_to_vram(parser, "preload_to_vram", "Keep all training images resident in VRAM as uint8", {"preload-to-vram"});
+            ::args::Flag gpu_decode(parser, "gpu_decode", "Decode JPEG images on the GPU with nvJPEG", {"gpu-decode"});
+            ::args::ValueFlag<int> read_ahead(parser, "files", "Read the next N training images into memory ahead of the decode, for high latency storage", {"read-ahead"});
+            ::args::ValueFlag<std::string> read_ahead_mirror(parser, "dir", "Keep local copies of the images read ahead, e.g. from an object storage mount (implies --read-ahead 32)", {"read-ahead-mirror"});
+            ::args::Flag disk_image_cache(parser, "disk_image_cache", "Cache decoded and resized images on disk for later runs", {"disk-image-cache"});
+            ::args::Flag fused_loss(parser, "fused_loss", "Compute L1 + D-SSIM and composite the background in one fused kernel", {"fused-loss"});
+            ::args::Flag sync_free_step(parser, "sync_free_step", "Sum all losses for one backward and read the loss back asynchronously", {"sync-free-step"});
+            ::args::Flag async_eval(parser, "async_eval", "Evaluate a snapshot of the model in the background while training continues", {"async-eval"});
+            ::args::Flag upper_bound_allocation(parser, "upper_bound_allocation", "Size rasterizer buffers from the previous step instead of reading counts back", {"upper-bound-allocation"});
+            ::args::Flag spatial_index(parser, "spatial_index", "Skip Morton-ordered chunks of Gaussians outside the view frustum, rebuilt after refinement", {"spatial-index"});
+            ::args::Flag instance_stats(parser, "instance_stats", "Report exact tile instances against bounding-rectangle tiles at the end of training", {"instance-stats"});
+            ::args::Flag load_balanced_blend(parser, "load_balanced_blend", "Split tiles with many instances across several blend blocks and composite the segments", {"load-balanced-blend"});
+            ::args::Flag prioritize_training(parser, "prioritize_training", "Train on a high-priority CUDA stream, the viewer renders on a low-priority one", {"prioritize-training"});
+            ::args::Flag sparse_adam(parser, "sparse_adam", "Update only the Gaussians rendered this step in Adam, moments of the others stay untouched", {"sparse-adam"});
+            ::args::Flag gut_packed(parser, "gut_packed", "In GUT mode, intersect and rasterize only the Gaussians that survive projection", {"gut-packed"});
+            ::args::Flag importance_sampling(parser, "importance_sampling", "Draw training views in proportion to their recent loss, hard views are revisited more often", {"importance-sampling"});
+            ::args::Flag densify_budget(parser, "densify_budget", "Default strategy: densify only up to --max-cap Gaussians and the --densify-vram-mb budget, highest gradients first", {"densify-budget"});
+            ::args::Flag undistort(parser, "undistort", "Undistort distorted pinhole images once (cached next to the dataset) and train them as ideal pinhole cameras", {"undistort"});
+            ::args::ValueFlag<std::string> disk_image_cache_dir(parser, "dir", "Directory for the disk image cache (implies --disk-image-cache)", {"disk-image-cache-dir"});
+            ::args::ValueFlag<std::string> shared_image_cache(parser, "dir", "Preload images into files in dir shared by concurrent runs, e.g. /dev/shm/lfs (implies --preload-to-ram)", {"shared-image-cache"});
 
             ::args::MapFlag<std::string, int> resize_factor(parser, "resize_factor",
                                                             "resize resolution by this factor. Options: auto, 1, 2, 4, 8 (default: auto)",
@@ -194,13 +341,17 @@ namespace {
                 }
 
                 // Initialize the logger with the specified level and optional file
-                gs::core::Logger::get().init(level, log_file_path);
+                gs::core::Logger::get().init(level, log_file_path, log_async);
 
                 // Log that the logger was initialized (without gs:: prefix)
                 LOG_DEBUG("Logger initialized with level: {}", static_cast<int>(level));
                 if (!log_file_path.empty()) {
                     LOG_DEBUG("Logging to file: {}", log_file_path);
                 }
+                if (level < gs::core::COMPILED_LOG_LEVEL) {
+                    LOG_WARN("Log level {} requested, but this build compiles out messages below level {}",
+                             static_cast<int>(level), static_cast<int>(gs::core::COMPILED_LOG_LEVEL));
+                }
             }
 
             // Check if explicitly displaying help
@@ -208,6 +359,21 @@ namespace {
                 return std::make_tuple(ParseResult::Help, std::function<void()>{});
             }
 
+            // Viewer model cache, every mode that opens the viewer uses it
+            if (model_cache_vram_mb) {
+                if (::args::get(model_cache_vram_mb) < 0) {
+                    return std::unexpected("ERROR: --model-cache-vram-mb must not be negative");
+                }
+                params.model_cache_vram_mb = ::args::get(model_cache_vram_mb);
+            }
+            if (model_cache_ram_mb) {
+                if (::args::get(model_cache_ram_mb) < 0) {
+                    return std::unexpected("ERROR: --model-cache-ram-mb must not be negative");
+                }
+                params.model_cache_ram_mb = ::args::get(model_cache_ram_mb);
+            }
+            params.compress_textures = static_cast<bool>(compress_textures);
+
             // NO ARGUMENTS = VIEWER MODE (empty)
             if (args.size() == 1) {
                 return std::make_tuple(ParseResult::Success, std::function<void()>{});
@@ -228,6 +394,268 @@ namespace {
                 return std::make_tuple(ParseResult::Success, std::function<void()>{});
             }
 
+            if (materialize_delta) {
+                params.materialize_delta = ::args::get(materialize_delta);
+                if (!std::filesystem::is_directory(*params.materialize_delta)) {
+                    return std::unexpected(std::format("Delta directory does not exist: {}", params.materialize_delta->string()));
+                }
+                if (materialize_iteration) {
+                    params.materialize_iteration = ::args::get(materialize_iteration);
+                }
+                if (output_path) {
+                    params.dataset.output_path = ::args::get(output_path);
+                }
+                return std::make_tuple(ParseResult::Success, std::function<void()>{});
+            }
+
+            if (export_input) {
+                gs::param::BatchExportParameters batch;
+                batch.input = ::args::get(export_input);
+                if (!std::filesystem::exists(batch.input)) {
+                    return std::unexpected(std::format("Export input does not exist: {}", batch.input.string()));
+                }
+                if (!output_path) {
+                    return std::unexpected("ERROR: --export requires --output-path");
+                }
+                batch.output_dir = ::args::get(output_path);
+                if (export_formats) {
+                    batch.formats = split_list(::args::get(export_formats));
+                    if (batch.formats.empty()) {
+                        return std::unexpected("ERROR: --export-formats is empty");
+                    }
+                    for (const auto& format : batch.formats) {
+                        if (!VALID_EXPORT_FORMATS.contains(format)) {
+                            return std::unexpected(std::format("ERROR: Invalid export format '{}'. Valid formats are: ply, sog, lod", format));
+                        }
+                    }
+                }
+                if (export_transform) {
+                    auto transform = parse_float_list<12>(::args::get(export_transform), "export-transform");
+                    if (!transform) {
+                        return std::unexpected(transform.error());
+                    }
+                    batch.transform = *transform;
+                }
+                if (export_crop) {
+                    auto crop = parse_float_list<6>(::args::get(export_crop), "export-crop");
+                    if (!crop) {
+                        return std::unexpected(crop.error());
+                    }
+                    const auto& box = *crop;
+                    if (box[0] > box[3] || box[1] > box[4] || box[2] > box[5]) {
+                        return std::unexpected("ERROR: --export-crop minimum must not exceed its maximum");
+                    }
+                    batch.crop_box = box;
+                }
+                if (export_min_opacity) {
+                    batch.min_opacity = ::args::get(export_min_opacity);
+                    if (batch.min_opacity < 0.f || batch.min_opacity > 1.f) {
+                        return std::unexpected("ERROR: --export-min-opacity must be in [0, 1]");
+                    }
+                }
+                if (export_jobs) {
+                    batch.jobs = ::args::get(export_jobs);
+                    if (batch.jobs < 1) {
+                        return std::unexpected("ERROR: --export-jobs must be at least 1");
+                    }
+                }
+                params.batch_export = std::move(batch);
+                return std::make_tuple(ParseResult::Success, std::function<void()>{});
+            }
+
+            if (render_path) {
+                gs::param::RenderPathParameters render;
+                render.path = ::args::get(render_path);
+                if (!std::filesystem::exists(render.path)) {
+                    return std::unexpected(std::format("Camera path does not exist: {}", render.path.string()));
+                }
+                if (!render_model) {
+                    return std::unexpected("ERROR: --render-path requires --render-model");
+                }
+                render.model = ::args::get(render_model);
+                if (!std::filesystem::is_regular_file(render.model)) {
+                    return std::unexpected(std::format("Render model does not exist: {}", render.model.string()));
+                }
+                if (!output_path) {
+                    return std::unexpected("ERROR: --render-path requires --output-path");
+                }
+                render.output = std::filesystem::path(::args::get(output_path)) /
+                                (render.path.stem().string() + ".mp4");
+                if (render_size) {
+                    auto size = parse_float_list<2>(::args::get(render_size), "render-size");
+                    if (!size) {
+                        return std::unexpected(size.error());
+                    }
+                    render.width = static_cast<int>((*size)[0]);
+                    render.height = static_cast<int>((*size)[1]);
+                    // 4:2:0 chroma needs even dimensions
+                    if (render.width < 2 || render.height < 2 || render.width % 2 != 0 || render.height % 2 != 0) {
+                        return std::unexpected("ERROR: --render-size must be even and positive");
+                    }
+                }
+                if (render_fps) {
+                    render.fps = ::args::get(render_fps);
+                    if (render.fps <= 0.f) {
+                        return std::unexpected("ERROR: --render-fps must be positive");
+                    }
+                }
+                if (render_keyframe_seconds) {
+                    render.keyframe_seconds = ::args::get(render_keyframe_seconds);
+                    if (render.keyframe_seconds <= 0.f) {
+                        return std::unexpected("ERROR: --render-keyframe-seconds must be positive");
+                    }
+                }
+                if (render_stride) {
+                    render.camera_stride = ::args::get(render_stride);
+                    if (render.camera_stride < 1) {
+                        return std::unexpected("ERROR: --render-stride must be at least 1");
+                    }
+                }
+                if (render_codec) {
+                    render.codec = ::args::get(render_codec);
+                }
+                params.render_path = std::move(render);
+                return std::make_tuple(ParseResult::Success, std::function<void()>{});
+            }
+
+            if (render_server) {
+                gs::param::RenderServerParameters server;
+                server.port = ::args::get(render_server);
+                if (server.port < 1 || server.port > 65535) {
+                    return std::unexpected("ERROR: --render-server needs a port between 1 and 65535");
+                }
+                if (!render_model) {
+                    return std::unexpected("ERROR: --render-server requires --render-model");
+                }
+                server.model = ::args::get(render_model);
+                if (!std::filesystem::is_regular_file(server.model)) {
+                    return std::unexpected(std::format("Render model does not exist: {}", server.model.string()));
+                }
+                if (render_sessions) {
+                    server.max_sessions = ::args::get(render_sessions);
+                    if (server.max_sessions < 1) {
+                        return std::unexpected("ERROR: --render-sessions must be at least 1");
+                    }
+                }
+                if (render_codec) {
+                    server.codec = ::args::get(render_codec);
+                }
+                if (render_bind) {
+                    server.bind_address = ::args::get(render_bind);
+                }
+                params.render_server = std::move(server);
+                return std::make_tuple(ParseResult::Success, std::function<void()>{});
+            }
+
+            if (job_queue) {
+                gs::param::JobQueueParameters queue;
+                queue.jobs_file = ::args::get(job_queue);
+                if (!std::filesystem::is_regular_file(queue.jobs_file)) {
+                    return std::unexpected(std::format("Job queue file does not exist: {}", queue.jobs_file.string()));
+                }
+                if (job_gpus) {
+                    for (const auto& item : split_list(::args::get(job_gpus))) {
+                        try {
+                            queue.gpus.push_back(std::stoi(item));
+                        } catch (const std::exception&) {
+                            return std::unexpected(std::format("ERROR: --job-gpus expects GPU indices, got '{}'", item));
+                        }
+                    }
+                    if (queue.gpus.empty()) {
+                        return std::unexpected("ERROR: --job-gpus is empty");
+                    }
+                }
+                if (jobs_per_gpu) {
+                    queue.jobs_per_gpu = ::args::get(jobs_per_gpu);
+                    if (queue.jobs_per_gpu < 1) {
+                        return std::unexpected("ERROR: --jobs-per-gpu must be at least 1");
+                    }
+                }
+                params.job_queue = std::move(queue);
+                return std::make_tuple(ParseResult::Success, std::function<void()>{});
+            }
+
+            if (compact) {
+                gs::param::CompactParameters compaction;
+                compaction.model = ::args::get(compact);
+                if (!std::filesystem::is_regular_file(compaction.model)) {
+                    return std::unexpected(std::format("Compaction model does not exist: {}", compaction.model.string()));
+                }
+                if (!data_path) {
+                    return std::unexpected("ERROR: --compact requires --data-path");
+                }
+                if (!output_path) {
+                    return std::unexpected("ERROR: --compact requires --output-path");
+                }
+                if (export_formats) {
+                    compaction.formats = split_list(::args::get(export_formats));
+                    if (compaction.formats.empty()) {
+                        return std::unexpected("ERROR: --export-formats is empty");
+                    }
+                    for (const auto& format : compaction.formats) {
+                        if (!VALID_EXPORT_FORMATS.contains(format)) {
+                            return std::unexpected(std::format("ERROR: Invalid export format '{}'. Valid formats are: ply, sog, lod", format));
+                        }
+                    }
+                }
+                if (compact_psnr_drop) {
+                    compaction.max_psnr_drop = ::args::get(compact_psnr_drop);
+                    if (compaction.max_psnr_drop < 0.f) {
+                        return std::unexpected("ERROR: --compact-psnr-drop must be non-negative");
+                    }
+                }
+                if (compact_sh_tolerance) {
+                    compaction.sh_tolerance = ::args::get(compact_sh_tolerance);
+                    if (compaction.sh_tolerance < 0.f) {
+                        return std::unexpected("ERROR: --compact-sh-tolerance must be non-negative");
+                    }
+                }
+                if (compact_fine_tune) {
+                    compaction.fine_tune_iterations = ::args::get(compact_fine_tune);
+                    if (compaction.fine_tune_iterations < 0) {
+                        return std::unexpected("ERROR: --compact-fine-tune must be non-negative");
+                    }
+                }
+                if (compact_views) {
+                    compaction.views = ::args::get(compact_views);
+                    if (compaction.views < 0) {
+                        return std::unexpected("ERROR: --compact-views must be non-negative");
+                    }
+                }
+                params.compact = std::move(compaction);
+            }
+
+            // Dataset flags are parsed below, like for --compact
+            if (benchmark_dataloader) {
+                gs::param::DataLoaderBenchmarkParameters benchmark;
+                benchmark.report = ::args::get(benchmark_dataloader);
+                if (!data_path) {
+                    return std::unexpected("ERROR: --benchmark-dataloader requires --data-path");
+                }
+                if (benchmark_workers) {
+                    for (const auto& item : split_list(::args::get(benchmark_workers))) {
+                        try {
+                            benchmark.workers.push_back(std::stoi(item));
+                        } catch (const std::exception&) {
+                            return std::unexpected(std::format("ERROR: --benchmark-workers expects worker counts, got '{}'", item));
+                        }
+                        if (benchmark.workers.back() < 1) {
+                            return std::unexpected("ERROR: --benchmark-workers counts must be at least 1");
+                        }
+                    }
+                    if (benchmark.workers.empty()) {
+                        return std::unexpected("ERROR: --benchmark-workers is empty");
+                    }
+                }
+                if (benchmark_images) {
+                    benchmark.images = ::args::get(benchmark_images);
+                    if (benchmark.images < 1) {
+                        return std::unexpected("ERROR: --benchmark-images must be at least 1");
+                    }
+                }
+                params.benchmark_dataloader = std::move(benchmark);
+            }
+
             if (init_ply) {
                 const auto ply_path = ::args::get(init_ply);
                 params.init_ply = ply_path;
@@ -238,6 +666,40 @@ namespace {
                 }
             }
 
+            // Accept the training output directory as well as the checkpoint itself
+            const auto find_checkpoint = [](std::filesystem::path checkpoint_path) -> std::expected<std::filesystem::path, std::string> {
+                if (!std::filesystem::exists(checkpoint_path / "manifest.json") &&
+                    std::filesystem::exists(checkpoint_path / "training_checkpoint" / "manifest.json")) {
+                    checkpoint_path /= "training_checkpoint";
+                }
+                if (!std::filesystem::exists(checkpoint_path / "manifest.json")) {
+                    return std::unexpected(std::format("No training checkpoint found at: {}", checkpoint_path.string()));
+                }
+                return checkpoint_path;
+            };
+
+            if (resume) {
+                auto checkpoint_path = find_checkpoint(::args::get(resume));
+                if (!checkpoint_path) {
+                    return std::unexpected(checkpoint_path.error());
+                }
+                params.resume_checkpoint = *checkpoint_path;
+            }
+
+            if (init_checkpoint) {
+                if (resume) {
+                    return std::unexpected("ERROR: --init-checkpoint cannot be combined with --resume");
+                }
+                if (init_ply) {
+                    return std::unexpected("ERROR: --init-checkpoint brings its own model and cannot be combined with --init-ply");
+                }
+                auto checkpoint_path = find_checkpoint(::args::get(init_checkpoint));
+                if (!checkpoint_path) {
+                    return std::unexpected(checkpoint_path.error());
+                }
+                params.init_checkpoint = *checkpoint_path;
+            }
+
             // Training mode
             bool has_data_path = data_path && !::args::get(data_path).empty();
             bool has_output_path = output_path && !::args::get(output_path).empty();
@@ -249,6 +711,17 @@ namespace {
                     parser.Help()));
             }
 
+            if (benchmark && (!has_data_path || !has_output_path)) {
+                return std::unexpected("ERROR: --benchmark requires --data-path and --output-path");
+            }
+
+            if (validate_dataset) {
+                if (!has_data_path) {
+                    return std::unexpected("ERROR: --validate-dataset requires --data-path");
+                }
+                params.validate_dataset = true;
+            }
+
             // If both paths provided, it's training mode
             if (has_data_path && has_output_path) {
                 params.dataset.data_path = ::args::get(data_path);
@@ -262,6 +735,9 @@ namespace {
                         "Failed to create output directory '{}': {}",
                         params.dataset.output_path.string(), ec.message()));
                 }
+            } else if (validate_dataset) {
+                // Validation only reads the dataset
+                params.dataset.data_path = ::args::get(data_path);
             } else if (has_data_path != has_output_path) {
                 return std::unexpected(std::format(
                     "ERROR: Training mode requires both --data-path and --output-path\n\n{}",
@@ -282,7 +758,7 @@ namespace {
                 const auto strat = ::args::get(strategy);
                 if (VALID_STRATEGIES.find(strat) == VALID_STRATEGIES.end()) {
                     return std::unexpected(std::format(
-                        "ERROR: Invalid optimization strategy '{}'. Valid strategies are: mcmc, default",
+                        "ERROR: Invalid optimization strategy '{}'. Valid strategies are: mcmc, default, taming",
                         strat));
                 }
 
@@ -308,6 +784,15 @@ namespace {
                 }
             }
 
+            if (dataloader) {
+                const auto backend = ::args::get(dataloader);
+                if (VALID_DATALOADERS.find(backend) == VALID_DATALOADERS.end()) {
+                    return std::unexpected(std::format(
+                        "ERROR: Invalid dataloader '{}'. Valid options are: efficient, libtorch",
+                        backend));
+                }
+            }
+
             if (max_width) {
                 int width = ::args::get(max_width);
                 if (width <= 0) {
@@ -318,6 +803,156 @@ namespace {
                 }
             }
 
+            if (progressive_resolution && ::args::get(progressive_resolution) < 0) {
+                return std::unexpected("ERROR: --progressive-resolution must not be negative");
+            }
+
+            if (crop_size && ::args::get(crop_size) < 0) {
+                return std::unexpected("ERROR: --crop-size must not be negative");
+            }
+
+            if (prune_contribution) {
+                const float weight = ::args::get(prune_contribution);
+                if (weight < 0.f || weight > 1.f) {
+                    return std::unexpected("ERROR: --prune-contribution must be in [0, 1]");
+                }
+            }
+
+            if (importance_sampling_floor) {
+                const float floor = ::args::get(importance_sampling_floor);
+                if (floor <= 0.f || floor > 1.f) {
+                    return std::unexpected("ERROR: --importance-sampling-floor must be in (0, 1]");
+                }
+            }
+
+            if (preload_max_mb && ::args::get(preload_max_mb) < -1) {
+                return std::unexpected("ERROR: --preload-max-mb must be -1 (unlimited) or a budget of at least 0");
+            }
+
+            if (densify_vram_mb && ::args::get(densify_vram_mb) < 0) {
+                return std::unexpected("ERROR: --densify-vram-mb must not be negative");
+            }
+
+            if (vram_budget_mb && ::args::get(vram_budget_mb) < 0) {
+                return std::unexpected("ERROR: --vram-budget-mb must not be negative");
+            }
+
+            if (bucket_state_budget_mb && ::args::get(bucket_state_budget_mb) < 0) {
+                return std::unexpected("ERROR: --bucket-state-budget-mb must not be negative");
+            }
+
+            if (cuda_allocator) {
+                const auto backend = ::args::get(cuda_allocator);
+                if (backend != "native" && backend != "async") {
+                    return std::unexpected(std::format(
+                        "ERROR: Invalid CUDA allocator '{}'. Valid values are: native, async", backend));
+                }
+            }
+
+            if (eval_views && ::args::get(eval_views) < 0) {
+                return std::unexpected("ERROR: --eval-views must be non-negative");
+            }
+
+            if (eval_downscale && ::args::get(eval_downscale) < 1) {
+                return std::unexpected("ERROR: --eval-downscale must be at least 1");
+            }
+
+            if (early_stop_window && ::args::get(early_stop_window) < 0) {
+                return std::unexpected("ERROR: --early-stop-window must be non-negative");
+            }
+
+            if (early_stop_threshold && ::args::get(early_stop_threshold) < 0.f) {
+                return std::unexpected("ERROR: --early-stop-threshold must not be negative");
+            }
+
+            if (fine_tune_iterations && ::args::get(fine_tune_iterations) < 0) {
+                return std::unexpected("ERROR: --fine-tune-iterations must be non-negative");
+            }
+
+            if (fine_tune_iterations && ::args::get(fine_tune_iterations) > 0 && !init_ply && !init_checkpoint) {
+                return std::unexpected("ERROR: --fine-tune-iterations requires --init-ply or --init-checkpoint");
+            }
+
+            if (views_per_step && ::args::get(views_per_step) < 1) {
+                return std::unexpected("ERROR: --views-per-step must be at least 1");
+            }
+
+            if (bilateral_grid_precision) {
+                const auto precision = ::args::get(bilateral_grid_precision);
+                if (precision != "float32" && precision != "float16" && precision != "bfloat16") {
+                    return std::unexpected(std::format(
+                        "ERROR: Invalid bilateral grid precision '{}'. Valid values are: float32, float16, bfloat16", precision));
+                }
+            }
+
+            if (sh_precision) {
+                const auto precision = ::args::get(sh_precision);
+                if (precision != "float32" && precision != "float16" && precision != "bfloat16") {
+                    return std::unexpected(std::format(
+                        "ERROR: Invalid SH precision '{}'. Valid values are: float32, float16, bfloat16", precision));
+                }
+            }
+
+            if (sh_codebook_iteration && ::args::get(sh_codebook_iteration) < 0) {
+                return std::unexpected("ERROR: --sh-codebook-iteration must be non-negative");
+            }
+
+            if (sh_codebook_size && (::args::get(sh_codebook_size) < 1 || ::args::get(sh_codebook_size) > 65536)) {
+                return std::unexpected("ERROR: --sh-codebook-size must be between 1 and 65536");
+            }
+
+            if (sh_basis_iteration && ::args::get(sh_basis_iteration) < 0) {
+                return std::unexpected("ERROR: --sh-basis-iteration must be non-negative");
+            }
+
+            if (sh_basis_rank && (::args::get(sh_basis_rank) < 1 || ::args::get(sh_basis_rank) > 45)) {
+                return std::unexpected("ERROR: --sh-basis-rank must be between 1 and 45");
+            }
+
+            if (tile_shape) {
+                const auto shape = ::args::get(tile_shape);
+                if (shape != "16x16" && shape != "8x8" && shape != "32x8" && shape != "auto") {
+                    return std::unexpected(std::format(
+                        "ERROR: Invalid tile shape '{}'. Valid values are: 16x16, 8x8, 32x8, auto", shape));
+                }
+            }
+
+            if (viewer_snapshot_every && ::args::get(viewer_snapshot_every) < 0) {
+                return std::unexpected("ERROR: --viewer-snapshot-every must be non-negative");
+            }
+
+            if (sog_webp_level && (::args::get(sog_webp_level) < 0 || ::args::get(sog_webp_level) > 9)) {
+                return std::unexpected("ERROR: --sog-webp-level must be between 0 and 9");
+            }
+
+            if (sog_qat_iteration && ::args::get(sog_qat_iteration) < 0) {
+                return std::unexpected("ERROR: --sog-qat-iteration must be non-negative");
+            }
+
+            if (telemetry_format) {
+                const auto format = ::args::get(telemetry_format);
+                if (format != "csv" && format != "binary") {
+                    return std::unexpected(std::format(
+                        "ERROR: Invalid telemetry format '{}'. Valid values are: csv, binary", format));
+                }
+            }
+
+            if (seed && ::args::get(seed) < 0) {
+                return std::unexpected("ERROR: --seed must be non-negative");
+            }
+            if (cpu_threads && ::args::get(cpu_threads) < 0) {
+                return std::unexpected("ERROR: --cpu-threads must be non-negative");
+            }
+            if (read_ahead && ::args::get(read_ahead) < 0) {
+                return std::unexpected("ERROR: --read-ahead must be non-negative");
+            }
+            if (profile_zones && ::args::get(profile_zones) < 0) {
+                return std::unexpected("ERROR: --profile-zones must be non-negative");
+            }
+            if (trace_capacity && ::args::get(trace_capacity) < 1) {
+                return std::unexpected("ERROR: --trace-capacity must be at least 1");
+            }
+
             // Create lambda to apply command line overrides after JSON loading
             auto apply_cmd_overrides = [&params,
                                         // Capture values, not references
@@ -325,6 +960,42 @@ namespace {
                                         resize_factor_val = resize_factor ? std::optional<int>(::args::get(resize_factor)) : std::optional<int>(1), // default 1
                                         max_width_val = max_width ? std::optional<int>(::args::get(max_width)) : std::optional<int>(3840),          // default 3840
                                         num_workers_val = num_workers ? std::optional<int>(::args::get(num_workers)) : std::optional<int>(),
+                                        cpu_threads_val = cpu_threads ? std::optional<int>(::args::get(cpu_threads)) : std::optional<int>(),
+                                        dataloader_val = dataloader ? std::optional<std::string>(::args::get(dataloader)) : std::optional<std::string>(),
+                                        disk_image_cache_dir_val = disk_image_cache_dir ? std::optional<std::string>(::args::get(disk_image_cache_dir)) : std::optional<std::string>(),
+                                        shared_image_cache_val = shared_image_cache ? std::optional<std::string>(::args::get(shared_image_cache)) : std::optional<std::string>(),
+                                        preload_max_mb_val = preload_max_mb ? std::optional<int>(::args::get(preload_max_mb)) : std::optional<int>(),
+                                        checkpoint_every_val = checkpoint_every ? std::optional<int>(::args::get(checkpoint_every)) : std::optional<int>(),
+                                        eval_views_val = eval_views ? std::optional<int>(::args::get(eval_views)) : std::optional<int>(),
+                                        eval_downscale_val = eval_downscale ? std::optional<int>(::args::get(eval_downscale)) : std::optional<int>(),
+                                        early_stop_window_val = early_stop_window ? std::optional<int>(::args::get(early_stop_window)) : std::optional<int>(),
+                                        early_stop_threshold_val = early_stop_threshold ? std::optional<float>(::args::get(early_stop_threshold)) : std::optional<float>(),
+                                        fine_tune_iterations_val = fine_tune_iterations ? std::optional<int>(::args::get(fine_tune_iterations)) : std::optional<int>(),
+                                        views_per_step_val = views_per_step ? std::optional<int>(::args::get(views_per_step)) : std::optional<int>(),
+                                        progressive_resolution_val = progressive_resolution ? std::optional<int>(::args::get(progressive_resolution)) : std::optional<int>(),
+                                        crop_size_val = crop_size ? std::optional<int>(::args::get(crop_size)) : std::optional<int>(),
+                                        sh_precision_val = sh_precision ? std::optional<std::string>(::args::get(sh_precision)) : std::optional<std::string>(),
+                                        bilateral_grid_precision_val = bilateral_grid_precision ? std::optional<std::string>(::args::get(bilateral_grid_precision)) : std::optional<std::string>(),
+                                        sh_codebook_iteration_val = sh_codebook_iteration ? std::optional<int>(::args::get(sh_codebook_iteration)) : std::optional<int>(),
+                                        sh_codebook_size_val = sh_codebook_size ? std::optional<int>(::args::get(sh_codebook_size)) : std::optional<int>(),
+                                        sh_basis_iteration_val = sh_basis_iteration ? std::optional<int>(::args::get(sh_basis_iteration)) : std::optional<int>(),
+                                        sh_basis_rank_val = sh_basis_rank ? std::optional<int>(::args::get(sh_basis_rank)) : std::optional<int>(),
+                                        importance_sampling_floor_val = importance_sampling_floor ? std::optional<float>(::args::get(importance_sampling_floor)) : std::optional<float>(),
+                                        densify_vram_mb_val = densify_vram_mb ? std::optional<int>(::args::get(densify_vram_mb)) : std::optional<int>(),
+                                        vram_budget_mb_val = vram_budget_mb ? std::optional<int>(::args::get(vram_budget_mb)) : std::optional<int>(),
+                                        bucket_state_budget_mb_val = bucket_state_budget_mb ? std::optional<int>(::args::get(bucket_state_budget_mb)) : std::optional<int>(),
+                                        cuda_allocator_val = cuda_allocator ? std::optional<std::string>(::args::get(cuda_allocator)) : std::optional<std::string>(),
+                                        tile_shape_val = tile_shape ? std::optional<std::string>(::args::get(tile_shape)) : std::optional<std::string>(),
+                                        viewer_snapshot_every_val = viewer_snapshot_every ? std::optional<int>(::args::get(viewer_snapshot_every)) : std::optional<int>(),
+                                        telemetry_val = telemetry ? std::optional<std::string>(::args::get(telemetry)) : std::optional<std::string>(),
+                                        telemetry_format_val = telemetry_format ? std::optional<std::string>(::args::get(telemetry_format)) : std::optional<std::string>(),
+                                        profile_zones_val = profile_zones ? std::optional<int>(::args::get(profile_zones)) : std::optional<int>(),
+                                        trace_val = trace ? std::optional<std::string>(::args::get(trace)) : std::optional<std::string>(),
+                                        trace_capacity_val = trace_capacity ? std::optional<int>(::args::get(trace_capacity)) : std::optional<int>(),
+                                        seed_val = seed ? std::optional<int>(::args::get(seed)) : std::optional<int>(),
+                                        read_ahead_val = read_ahead ? std::optional<int>(::args::get(read_ahead)) : std::optional<int>(),
+                                        read_ahead_mirror_val = read_ahead_mirror ? std::optional<std::string>(::args::get(read_ahead_mirror)) : std::optional<std::string>(),
+                                        benchmark_val = benchmark ? std::optional<std::string>(::args::get(benchmark)) : std::optional<std::string>(),
                                         max_cap_val = max_cap ? std::optional<int>(::args::get(max_cap)) : std::optional<int>(),
                                         project_name_val = project_name ? std::optional<std::string>(::args::get(project_name)) : std::optional<std::string>(),
                                         config_file_val = config_file ? std::optional<std::string>(::args::get(config_file)) : std::optional<std::string>(),
@@ -334,6 +1005,7 @@ namespace {
                                         sh_degree_interval_val = sh_degree_interval ? std::optional<int>(::args::get(sh_degree_interval)) : std::optional<int>(),
                                         sh_degree_val = sh_degree ? std::optional<int>(::args::get(sh_degree)) : std::optional<int>(),
                                         min_opacity_val = min_opacity ? std::optional<float>(::args::get(min_opacity)) : std::optional<float>(),
+                                        prune_contribution_val = prune_contribution ? std::optional<float>(::args::get(prune_contribution)) : std::optional<float>(),
                                         render_mode_val = render_mode ? std::optional<std::string>(::args::get(render_mode)) : std::optional<std::string>(),
                                         init_num_pts_val = init_num_pts ? std::optional<int>(::args::get(init_num_pts)) : std::optional<int>(),
                                         init_extent_val = init_extent ? std::optional<float>(::args::get(init_extent)) : std::optional<float>(),
@@ -342,6 +1014,8 @@ namespace {
                                         timelapse_images_val = timelapse_images ? std::optional<std::vector<std::string>>(::args::get(timelapse_images)) : std::optional<std::vector<std::string>>(),
                                         timelapse_every_val = timelapse_every ? std::optional<int>(::args::get(timelapse_every)) : std::optional<int>(),
                                         sog_iterations_val = sog_iterations ? std::optional<int>(::args::get(sog_iterations)) : std::optional<int>(),
+                                        sog_webp_level_val = sog_webp_level ? std::optional<int>(::args::get(sog_webp_level)) : std::optional<int>(),
+                                        sog_qat_iteration_val = sog_qat_iteration ? std::optional<int>(::args::get(sog_qat_iteration)) : std::optional<int>(),
                                         // Sparsity parameters
                                         sparsify_steps_val = sparsify_steps ? std::optional<int>(::args::get(sparsify_steps)) : std::optional<int>(),
                                         init_rho_val = init_rho ? std::optional<float>(::args::get(init_rho)) : std::optional<float>(),
@@ -357,6 +1031,30 @@ namespace {
                                         random_flag = bool(random),
                                         gut_flag = bool(gut),
                                         save_sog_flag = bool(save_sog),
+                                        save_lod_flag = bool(save_lod),
+                                        save_delta_flag = bool(save_delta),
+                                        morton_order_flag = bool(morton_order),
+                                        ply_direct_io_flag = bool(ply_direct_io),
+                                        preload_to_ram_flag = bool(preload_to_ram),
+                                        preload_to_vram_flag = bool(preload_to_vram),
+                                        gpu_decode_flag = bool(gpu_decode),
+                                        pin_threads_flag = bool(pin_threads),
+                                        sync_free_step_flag = bool(sync_free_step),
+                                        deterministic_flag = bool(deterministic),
+                                        fused_loss_flag = bool(fused_loss),
+                                        progressive_sh_flag = bool(progressive_sh),
+                                        async_eval_flag = bool(async_eval),
+                                        upper_bound_allocation_flag = bool(upper_bound_allocation),
+                                        spatial_index_flag = bool(spatial_index),
+                                        instance_stats_flag = bool(instance_stats),
+                                        load_balanced_blend_flag = bool(load_balanced_blend),
+                                        prioritize_training_flag = bool(prioritize_training),
+                                        sparse_adam_flag = bool(sparse_adam),
+                                        gut_packed_flag = bool(gut_packed),
+                                        importance_sampling_flag = bool(importance_sampling),
+                                        densify_budget_flag = bool(densify_budget),
+                                        undistort_flag = bool(undistort),
+                                        disk_image_cache_flag = bool(disk_image_cache) || bool(disk_image_cache_dir),
                                         enable_sparsity_flag = bool(enable_sparsity)]() {
                 auto& opt = params.optimization;
                 auto& ds = params.dataset;
@@ -377,6 +1075,44 @@ namespace {
                 setVal(resize_factor_val, ds.resize_factor);
                 setVal(max_width_val, ds.max_width);
                 setVal(num_workers_val, opt.num_workers);
+                setVal(cpu_threads_val, opt.cpu_threads);
+                setVal(dataloader_val, opt.dataloader);
+                setVal(disk_image_cache_dir_val, opt.disk_image_cache_dir);
+                setVal(shared_image_cache_val, opt.shared_image_cache);
+                setVal(preload_max_mb_val, opt.preload_max_mb);
+                setVal(checkpoint_every_val, opt.checkpoint_every);
+                setVal(eval_views_val, opt.eval_views);
+                setVal(eval_downscale_val, opt.eval_downscale);
+                setVal(early_stop_window_val, opt.early_stop_window);
+                setVal(early_stop_threshold_val, opt.early_stop_threshold);
+                setVal(fine_tune_iterations_val, opt.fine_tune_iterations);
+                setVal(views_per_step_val, opt.views_per_step);
+                setVal(progressive_resolution_val, opt.progressive_resolution);
+                setVal(crop_size_val, opt.crop_size);
+                setVal(sh_precision_val, opt.sh_precision);
+                setVal(bilateral_grid_precision_val, opt.bilateral_grid_precision);
+                setVal(sh_codebook_iteration_val, opt.sh_codebook_iteration);
+                setVal(sh_codebook_size_val, opt.sh_codebook_size);
+                setVal(sh_basis_iteration_val, opt.sh_basis_iteration);
+                setVal(sh_basis_rank_val, opt.sh_basis_rank);
+                setVal(importance_sampling_floor_val, opt.importance_sampling_floor);
+                setVal(densify_vram_mb_val, opt.densify_vram_mb);
+                setVal(vram_budget_mb_val, opt.vram_budget_mb);
+                setVal(bucket_state_budget_mb_val, opt.bucket_state_budget_mb);
+                setVal(cuda_allocator_val, opt.cuda_allocator);
+                setVal(tile_shape_val, opt.tile_shape);
+                setVal(viewer_snapshot_every_val, opt.viewer_snapshot_every);
+                setVal(telemetry_val, opt.telemetry_output);
+                setVal(telemetry_format_val, opt.telemetry_format);
+                setVal(profile_zones_val, opt.profile_zones_every);
+                setVal(trace_val, opt.trace_output);
+                setVal(trace_capacity_val, opt.trace_capacity);
+                setVal(seed_val, opt.seed);
+                setVal(read_ahead_val, opt.read_ahead);
+                setVal(read_ahead_mirror_val, opt.read_ahead_mirror);
+                if (read_ahead_mirror_val && !read_ahead_val && opt.read_ahead == 0) {
+                    opt.read_ahead = 32;
+                }
                 setVal(max_cap_val, opt.max_cap);
                 setVal(project_name_val, ds.project_path);
                 setVal(images_folder_val, ds.images);
@@ -385,6 +1121,7 @@ namespace {
                 setVal(sh_degree_interval_val, opt.sh_degree_interval);
                 setVal(sh_degree_val, opt.sh_degree);
                 setVal(min_opacity_val, opt.min_opacity);
+                setVal(prune_contribution_val, opt.prune_contribution);
                 setVal(render_mode_val, opt.render_mode);
                 setVal(init_num_pts_val, opt.init_num_pts);
                 setVal(init_extent_val, opt.init_extent);
@@ -393,6 +1130,8 @@ namespace {
                 setVal(timelapse_images_val, ds.timelapse_images);
                 setVal(timelapse_every_val, ds.timelapse_every);
                 setVal(sog_iterations_val, opt.sog_iterations);
+                setVal(sog_webp_level_val, opt.sog_webp_level);
+                setVal(sog_qat_iteration_val, opt.sog_qat_iteration);
 
                 // Sparsity parameters
                 setVal(sparsify_steps_val, opt.sparsify_steps);
@@ -409,7 +1148,42 @@ namespace {
                 setFlag(random_flag, opt.random);
                 setFlag(gut_flag, opt.gut);
                 setFlag(save_sog_flag, opt.save_sog);
+                setFlag(save_lod_flag, opt.save_lod);
+                setFlag(save_delta_flag, opt.save_delta);
+                setFlag(morton_order_flag, opt.morton_order);
+                setFlag(ply_direct_io_flag, opt.ply_direct_io);
+                setFlag(preload_to_ram_flag, opt.preload_to_ram);
+                setFlag(preload_to_vram_flag, opt.preload_to_vram);
+                setFlag(gpu_decode_flag, opt.gpu_decode);
+                setFlag(pin_threads_flag, opt.pin_threads);
+                setFlag(sync_free_step_flag, opt.sync_free_step);
+                setFlag(deterministic_flag, opt.deterministic);
+                setFlag(fused_loss_flag, opt.fused_loss);
+                setFlag(progressive_sh_flag, opt.progressive_sh);
+                setFlag(async_eval_flag, opt.async_eval);
+                setFlag(upper_bound_allocation_flag, opt.upper_bound_allocation);
+                setFlag(spatial_index_flag, opt.spatial_index);
+                setFlag(instance_stats_flag, opt.instance_stats);
+                setFlag(load_balanced_blend_flag, opt.load_balanced_blend);
+                setFlag(prioritize_training_flag, opt.prioritize_training);
+                setFlag(sparse_adam_flag, opt.sparse_adam);
+                setFlag(gut_packed_flag, opt.gut_packed);
+                setFlag(importance_sampling_flag, opt.importance_sampling);
+                setFlag(densify_budget_flag, opt.densify_budget);
+                setFlag(undistort_flag, ds.undistort);
+                setFlag(disk_image_cache_flag, opt.disk_image_cache);
                 setFlag(enable_sparsity_flag, opt.enable_sparsity);
+
+                // Throughput only: no viewer, evaluation, saves or timelapse in the measured run
+                if (benchmark_val) {
+                    opt.benchmark_output = *benchmark_val;
+                    opt.headless = true;
+                    opt.enable_eval = false;
+                    opt.skip_intermediate_saving = true;
+                    opt.checkpoint_every = 0;
+                    opt.early_stop_window = 0;
+                    ds.timelapse_images.clear();
+                }
             };
 
             return std::make_tuple(ParseResult::Success, apply_cmd_overrides);
@@ -432,12 +1206,39 @@ namespace {
             opt.stop_refine *= scaler;
             opt.refine_every *= scaler;
             opt.sh_degree_interval *= scaler;
+            opt.early_stop_window *= scaler;
 
             scale_steps_vector(opt.eval_steps, scaler);
             scale_steps_vector(opt.save_steps, scaler);
         }
     }
 
+    // Shortens the schedule of a warm-started run, the refinement window keeps its share of the
+    // iterations and the opacity reset is dropped since it would wipe the prior model
+    void apply_fine_tune_schedule(gs::param::TrainingParameters& params) {
+        auto& opt = params.optimization;
+        if (opt.fine_tune_iterations <= 0) {
+            return;
+        }
+        if (!params.init_ply && !params.init_checkpoint) {
+            LOG_WARN("fine_tune_iterations is set but the run starts from scratch, training the full schedule");
+            return;
+        }
+
+        const float scaler = static_cast<float>(opt.fine_tune_iterations) / static_cast<float>(opt.iterations);
+        LOG_INFO("Fine-tuning for {} iterations, schedule scaled by {:.3f}", opt.fine_tune_iterations, scaler);
+
+        opt.iterations = opt.fine_tune_iterations;
+        opt.start_refine *= scaler;
+        opt.stop_refine *= scaler;
+        opt.refine_every = std::max(1, static_cast<int>(opt.refine_every * scaler));
+        opt.reset_every = opt.iterations + 1;
+        opt.early_stop_window *= scaler;
+
+        shrink_steps_vector(opt.eval_steps, scaler, opt.iterations);
+        shrink_steps_vector(opt.save_steps, scaler, opt.iterations);
+    }
+
     std::vector<std::string> convert_args(int argc, const char* const argv[]) {
         return std::vector<std::string>(argv, argv + argc);
     }
@@ -487,6 +1288,7 @@ gs::args::parse_args_and_params(int argc, const char* const argv[]) {
 
     // Apply step scaling
     apply_step_scaling(*params);
+    apply_fine_tune_schedule(*params);
 
     return params;
 }
@@ -0,0 +1,210 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/batch_export.hpp"
+#include "core/logger.hpp"
+#include "core/sogs.hpp"
+#include "core/splat_data.hpp"
+#include "core/splat_lod.hpp"
+#include "geometry/bounding_box.hpp"
+#include "loader/loader.hpp"
+#include <algorithm>
+#include <atomic>
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <chrono>
+#include <format>
+#include <future>
+#include <vector>
+
+namespace gs {
+    namespace core {
+
+        namespace {
+
+            std::expected<std::vector<std::filesystem::path>, std::string> collect_inputs(
+                const std::filesystem::path& input,
+                const loader::Loader& loader) {
+
+                std::error_code ec;
+                if (!std::filesystem::is_directory(input, ec)) {
+                    if (!std::filesystem::is_regular_file(input, ec)) {
+                        return std::unexpected(std::format("Export input does not exist: {}", input.string()));
+                    }
+                    return std::vector<std::filesystem::path>{input};
+                }
+
+                std::vector<std::filesystem::path> inputs;
+                for (const auto& entry : std::filesystem::directory_iterator(input, ec)) {
+                    if (entry.is_regular_file() && loader.canLoad(entry.path()) &&
+                        !loader::Loader::isDatasetPath(entry.path())) {
+                        inputs.push_back(entry.path());
+                    }
+                }
+                if (ec) {
+                    return std::unexpected(std::format("Failed to list {}: {}", input.string(), ec.message()));
+                }
+                if (inputs.empty()) {
+                    return std::unexpected(std::format("No splat files in {}", input.string()));
+                }
+                std::sort(inputs.begin(), inputs.end());
+                return inputs;
+            }
+
+            glm::mat4 to_mat4(const std::array<float, 12>& rows) {
+                glm::mat4 m(1.f);
+                for (int r = 0; r < 3; ++r) {
+                    for (int c = 0; c < 4; ++c) {
+                        m[c][r] = rows[r * 4 + c]; // glm is column-major
+                    }
+                }
+                return m;
+            }
+
+            SplatData select_gaussians(const SplatData& splat, const torch::Tensor& indices) {
+                SplatData selected(splat.get_max_sh_degree(),
+                                   splat.means().index_select(0, indices),
+                                   splat.sh0().index_select(0, indices),
+                                   splat.shN().index_select(0, indices),
+                                   splat.scaling_raw().index_select(0, indices),
+                                   splat.rotation_raw().index_select(0, indices),
+                                   splat.opacity_raw().index_select(0, indices),
+                                   splat.get_scene_scale());
+                selected.set_active_sh_degree(splat.get_active_sh_degree());
+                return selected;
+            }
+
+            std::expected<void, std::string> export_file(loader::Loader& loader,
+                                                         const std::filesystem::path& path,
+                                                         const param::BatchExportParameters& params,
+                                                         const param::OptimizationParameters& optimization) {
+                auto result = loader.load(path);
+                if (!result) {
+                    return std::unexpected(result.error());
+                }
+                auto* loaded = std::get_if<std::shared_ptr<SplatData>>(&result->data);
+                if (!loaded || !*loaded) {
+                    return std::unexpected("Not a splat file");
+                }
+                SplatData& splat = **loaded;
+                torch::NoGradGuard no_grad;
+                const auto loaded_count = splat.size();
+
+                if (params.transform) {
+                    splat.transform(to_mat4(*params.transform));
+                }
+                if (params.crop_box) {
+                    const auto& box = *params.crop_box;
+                    geometry::BoundingBox bounds;
+                    bounds.setBounds({box[0], box[1], box[2]}, {box[3], box[4], box[5]});
+                    splat = splat.crop_by_cropbox(bounds);
+                    if (splat.size() == 0) {
+                        return std::unexpected("No Gaussians inside the crop box");
+                    }
+                }
+                if (params.min_opacity > 0.f) {
+                    const auto keep = (splat.get_opacity().reshape({-1}) >= params.min_opacity).nonzero().squeeze(-1);
+                    if (keep.size(0) == 0) {
+                        return std::unexpected(std::format("No Gaussians reach opacity {}", params.min_opacity));
+                    }
+                    if (keep.size(0) < splat.size()) {
+                        splat = select_gaussians(splat, keep);
+                    }
+                }
+
+                const auto stem = path.stem().string();
+                for (const auto& format : params.formats) {
+                    std::filesystem::path output;
+                    if (format == "ply") {
+                        output = params.output_dir / (stem + ".ply");
+                    } else if (format == "sog") {
+                        output = params.output_dir / (stem + ".sog");
+                    } else {
+                        output = params.output_dir / (stem + SPLAT_LOD_EXTENSION);
+                    }
+                    std::error_code ec;
+                    if (std::filesystem::equivalent(output, path, ec)) {
+                        return std::unexpected(std::format("Refusing to overwrite the input with {}", output.string()));
+                    }
+
+                    if (format == "ply") {
+                        splat.save_ply(params.output_dir, 0, /*join_threads=*/true, stem);
+                    } else if (format == "sog") {
+                        if (auto written = write_sog(splat, {.iterations = optimization.sog_iterations,
+                                                             .webp_level = optimization.sog_webp_level,
+                                                             .output_path = output});
+                            !written) {
+                            return std::unexpected(written.error());
+                        }
+                    } else if (auto written = write_splat_lod(splat, {.output_path = output}); !written) {
+                        return std::unexpected(written.error());
+                    }
+                }
+
+                LOG_INFO("Exported {} ({} -> {} gaussians)", path.filename().string(), loaded_count, splat.size());
+                return {};
+            }
+
+        } // namespace
+
+        std::expected<BatchExportSummary, std::string> run_batch_export(
+            const param::BatchExportParameters& params,
+            const param::OptimizationParameters& optimization) {
+
+            auto inputs = collect_inputs(params.input, *loader::Loader::create());
+            if (!inputs) {
+                return std::unexpected(inputs.error());
+            }
+            std::error_code ec;
+            std::filesystem::create_directories(params.output_dir, ec);
+            if (ec) {
+                return std::unexpected(std::format("Failed to create {}: {}", params.output_dir.string(), ec.message()));
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            const auto jobs = std::min<size_t>(static_cast<size_t>(std::max(params.jobs, 1)), inputs->size());
+            LOG_INFO("Exporting {} file(s) to {} with {} job(s)", inputs->size(), params.output_dir.string(), jobs);
+
+            // Workers pull the next file until none are left, each on its own stream so one file's
+            // transfers and kernels overlap another's
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> succeeded{0};
+            std::atomic<size_t> failed{0};
+            const auto worker = [&] {
+                c10::cuda::CUDAStreamGuard stream_guard(at::cuda::getStreamFromPool(false));
+                const auto loader = loader::Loader::create();
+                for (size_t i; (i = next.fetch_add(1)) < inputs->size();) {
+                    const auto& path = (*inputs)[i];
+                    std::expected<void, std::string> exported;
+                    try {
+                        exported = export_file(*loader, path, params, optimization);
+                    } catch (const std::exception& e) {
+                        exported = std::unexpected(std::string(e.what()));
+                    }
+                    if (exported) {
+                        ++succeeded;
+                    } else {
+                        LOG_ERROR("Export of {} failed: {}", path.string(), exported.error());
+                        ++failed;
+                    }
+                }
+                at::cuda::getCurrentCUDAStream().synchronize();
+            };
+
+            std::vector<std::future<void>> workers;
+            workers.reserve(jobs);
+            for (size_t j = 0; j < jobs; ++j) {
+                workers.push_back(std::async(std::launch::async, worker));
+            }
+            for (auto& w : workers) {
+                w.get();
+            }
+
+            const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            LOG_INFO("Batch export finished in {:.1f}s: {} succeeded, {} failed", elapsed, succeeded.load(), failed.load());
+            return BatchExportSummary{.succeeded = succeeded.load(), .failed = failed.load()};
+        }
+
+    } // namespace core
+} // namespace gs
@@ -5,7 +5,10 @@
 #include "core/camera.hpp"
 #include "core/image_io.hpp"
 #include "core/logger.hpp"
+#include <atomic>
 #include <c10/cuda/CUDAGuard.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
 #include <torch/torch.h>
 
 using torch::indexing::None;
@@ -68,6 +71,8 @@ namespace gs {
           _camera_model_type(other._camera_model_type),
           _image_name(other._image_name),
           _image_path(other._image_path),
+          _valid_mask_path(other._valid_mask_path),
+          _mask_path(other._mask_path),
           _camera_width(other._camera_width),
           _camera_height(other._camera_height),
           _image_width(other._image_width),
@@ -88,6 +93,18 @@ namespace gs {
         return K;
     }
 
+    void Camera::crop_image(int x, int y, int width, int height) {
+        auto [fx, fy, cx, cy] = get_intrinsics();
+        _focal_x = fx;
+        _focal_y = fy;
+        _center_x = cx - static_cast<float>(x);
+        _center_y = cy - static_cast<float>(y);
+        _camera_width = _image_width = width;
+        _camera_height = _image_height = height;
+        _FoVx = focal2fov(_focal_x, _camera_width);
+        _FoVy = focal2fov(_focal_y, _camera_height);
+    }
+
     std::tuple<float, float, float, float> Camera::get_intrinsics() const {
         float x_scale_factor = float(_image_width) / float(_camera_width);
         float y_scale_factor = float(_image_height) / float(_camera_height);
@@ -99,28 +116,14 @@ namespace gs {
     }
 
     torch::Tensor Camera::load_and_get_image(int resize_factor, int max_width) {
-        // Use pinned memory for faster GPU transfer
-        auto pinned_options = torch::TensorOptions().dtype(torch::kUInt8).pinned_memory(true);
-
-        unsigned char* data;
-        int w, h, c;
-
-        // Load image synchronously
-        auto result = load_image(_image_path, resize_factor, max_width);
-        data = std::get<0>(result);
-        w = std::get<1>(result);
-        h = std::get<2>(result);
-        c = std::get<3>(result);
-
-        _image_width = w;
-        _image_height = h;
+        torch::Tensor image = load_image(resize_factor, max_width);
+        update_image_dimensions(static_cast<int>(image.size(2)), static_cast<int>(image.size(1)));
+        return image;
+    }
 
-        // Create tensor from pinned memory and transfer asynchronously
-        torch::Tensor image = torch::from_blob(
-            data,
-            {h, w, c},
-            {w * c, c, 1},
-            pinned_options);
+    torch::Tensor Camera::load_image(int resize_factor, int max_width) const {
+        // Decoded into pinned memory so the transfer below is truly asynchronous
+        torch::Tensor image = load_image_pinned(_image_path, resize_factor, max_width);
 
         // Use the CUDA stream for async transfer
         at::cuda::CUDAStreamGuard guard(_stream);
@@ -130,17 +133,24 @@ namespace gs {
                     .to(torch::kFloat32) /
                 255.0f;
 
-        // Free the original data
-        free_image(data);
-
         // Ensure the transfer is complete before returning
         _stream.synchronize();
 
         return image;
     }
 
+    std::tuple<int, int, int> Camera::source_image_info() const {
+        if (!has_source_image_info()) {
+            const auto [w, h, c] = get_image_info(_image_path);
+            _source_width = w;
+            _source_height = h;
+            _source_channels = c;
+        }
+        return {_source_width, _source_height, _source_channels};
+    }
+
     void Camera::load_image_size(int resize_factor, int max_width) {
-        auto result = get_image_info(_image_path);
+        auto result = source_image_info();
 
         int w = std::get<0>(result);
         int h = std::get<1>(result);
@@ -168,7 +178,7 @@ namespace gs {
     }
 
     size_t Camera::get_num_bytes_from_file(int resize_factor, int max_width) const {
-        auto result = get_image_info(_image_path);
+        auto result = source_image_info();
 
         int w = std::get<0>(result);
         int h = std::get<1>(result);
@@ -194,8 +204,38 @@ namespace gs {
     }
 
     size_t Camera::get_num_bytes_from_file() const {
-        auto [w, h, c] = get_image_info(_image_path);
+        auto [w, h, c] = source_image_info();
         size_t num_bytes = w * h * c * sizeof(float);
         return num_bytes;
     }
+
+    void probe_source_image_info(const std::vector<std::shared_ptr<Camera>>& cameras, int max_threads) {
+        std::vector<Camera*> pending;
+        for (const auto& cam : cameras) {
+            if (!cam->has_source_image_info()) {
+                pending.push_back(cam.get());
+            }
+        }
+        if (pending.empty()) {
+            return;
+        }
+
+        // Bounded arena: unbounded parallel opens saturate network shares instead of speeding up
+        std::atomic<size_t> failed{0};
+        tbb::task_arena arena(std::max(1, max_threads));
+        arena.execute([&] {
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, pending.size(), 1),
+                              [&](const tbb::blocked_range<size_t>& range) {
+                                  for (size_t i = range.begin(); i != range.end(); ++i) {
+                                      try {
+                                          pending[i]->source_image_info();
+                                      } catch (const std::exception& e) {
+                                          LOG_WARN("Failed to probe {}: {}", pending[i]->image_path().string(), e.what());
+                                          ++failed;
+                                      }
+                                  }
+                              });
+        });
+        LOG_DEBUG("Probed {} image headers ({} failed)", pending.size(), failed.load());
+    }
 } // namespace gs
\ No newline at end of file
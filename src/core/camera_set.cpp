@@ -0,0 +1,139 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/camera_set.hpp"
+#include <algorithm>
+
+using torch::indexing::None;
+using torch::indexing::Slice;
+
+namespace gs {
+
+    namespace {
+        // Coefficients as host floats, empty without distortion
+        torch::Tensor host_coefficients(const torch::Tensor& coefficients) {
+            if (!coefficients.defined() || coefficients.numel() == 0) {
+                return {};
+            }
+            return coefficients.to(torch::kCPU, torch::kFloat32).contiguous().view({-1});
+        }
+    } // namespace
+
+    CameraSet::CameraSet(std::vector<std::shared_ptr<const Camera>> cameras)
+        : _cameras(std::move(cameras)) {
+        std::erase(_cameras, nullptr);
+        std::stable_sort(_cameras.begin(), _cameras.end(),
+                         [](const auto& a, const auto& b) { return a->uid() < b->uid(); });
+
+        std::vector<const Camera*> raw;
+        raw.reserve(_cameras.size());
+        for (const auto& cam : _cameras) {
+            raw.push_back(cam.get());
+        }
+        build(raw, 0);
+
+        const int max_uid = _cameras.empty() ? -1 : _cameras.back()->uid();
+        _row_of_uid.assign(static_cast<size_t>(std::max(max_uid + 1, 0)), -1);
+        for (size_t i = 0; i < _cameras.size(); ++i) {
+            if (const int uid = _cameras[i]->uid(); uid >= 0) {
+                _row_of_uid[uid] = static_cast<int>(i);
+            }
+        }
+    }
+
+    CameraSet CameraSet::snapshot(std::span<const Camera* const> cameras, int64_t radial_count) {
+        CameraSet set;
+        set.build(cameras, radial_count);
+        return set;
+    }
+
+    void CameraSet::build(std::span<const Camera* const> cameras, int64_t radial_count) {
+        _num_cameras = static_cast<int64_t>(cameras.size());
+        _distorted = false;
+        const auto device_options = torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA);
+        if (cameras.empty()) {
+            _world_view_transforms = torch::empty({0, 4, 4}, device_options);
+            _cam_positions = torch::empty({0, 3}, device_options);
+            _Ks = torch::empty({0, 3, 3}, device_options);
+            _radial_distortion = torch::empty({0, radial_count}, device_options);
+            _tangential_distortion = torch::empty({0, 2}, device_options);
+            _uids = torch::empty({0}, device_options.dtype(torch::kInt64));
+            return;
+        }
+
+        std::vector<torch::Tensor> radials, tangentials;
+        radials.reserve(cameras.size());
+        tangentials.reserve(cameras.size());
+        for (const Camera* cam : cameras) {
+            radials.push_back(host_coefficients(cam->radial_distortion()));
+            tangentials.push_back(host_coefficients(cam->tangential_distortion()));
+            radial_count = std::max(radial_count, radials.back().defined() ? radials.back().numel() : 0);
+            TORCH_CHECK(!tangentials.back().defined() || tangentials.back().numel() <= 2,
+                        "expected at most 2 tangential coefficients, got ", tangentials.back().numel());
+            _distorted |= radials.back().defined() || tangentials.back().defined();
+        }
+
+        // Intrinsics and distortion go up packed in one host row per camera: K, radial, tangential
+        const int64_t stride = 9 + radial_count + 2;
+        auto packed = torch::zeros({_num_cameras, stride}, torch::kFloat32);
+        auto uids = torch::empty({_num_cameras}, torch::kInt64);
+        float* rows = packed.data_ptr<float>();
+        int64_t* uid_data = uids.data_ptr<int64_t>();
+        for (int64_t i = 0; i < _num_cameras; ++i) {
+            const Camera& cam = *cameras[i];
+            float* row = rows + i * stride;
+            const auto [fx, fy, cx, cy] = cam.get_intrinsics();
+            row[0] = fx;
+            row[2] = cx;
+            row[4] = fy;
+            row[5] = cy;
+            row[8] = 1.0f;
+            if (radials[i].defined()) {
+                std::copy_n(radials[i].data_ptr<float>(), radials[i].numel(), row + 9);
+            }
+            if (tangentials[i].defined()) {
+                std::copy_n(tangentials[i].data_ptr<float>(), tangentials[i].numel(), row + 9 + radial_count);
+            }
+            uid_data[i] = cam.uid();
+        }
+        const auto device_packed = packed.to(torch::kCUDA);
+        _Ks = device_packed.index({Slice(), Slice(None, 9)}).reshape({_num_cameras, 3, 3}).contiguous();
+        _radial_distortion = device_packed.index({Slice(), Slice(9, 9 + radial_count)}).contiguous();
+        _tangential_distortion = device_packed.index({Slice(), Slice(9 + radial_count, None)}).contiguous();
+        _uids = uids.to(torch::kCUDA);
+
+        std::vector<torch::Tensor> viewmats;
+        viewmats.reserve(cameras.size());
+        for (const Camera* cam : cameras) {
+            viewmats.push_back(cam->world_view_transform().view({-1, 4, 4}));
+        }
+        _world_view_transforms = torch::cat(viewmats, 0).to(device_options).contiguous();
+        // From the pose itself, a pose optimized copy carries the position of its source camera
+        _cam_positions = torch::inverse(_world_view_transforms).index({Slice(), Slice(None, 3), 3}).contiguous();
+    }
+
+    std::shared_ptr<const Camera> CameraSet::find(int uid) const {
+        const int r = row(uid);
+        return r < 0 || _cameras.empty() ? nullptr : _cameras[r];
+    }
+
+    int CameraSet::row(int uid) const noexcept {
+        if (uid < 0 || static_cast<size_t>(uid) >= _row_of_uid.size()) {
+            return -1;
+        }
+        return _row_of_uid[uid];
+    }
+
+    torch::Tensor CameraSet::rows(std::span<const int> uids) const {
+        std::vector<int64_t> indices;
+        indices.reserve(uids.size());
+        for (const int uid : uids) {
+            const int r = row(uid);
+            TORCH_CHECK(r >= 0, "camera uid ", uid, " is not in the set");
+            indices.push_back(r);
+        }
+        return torch::tensor(indices, torch::kInt64).to(torch::kCUDA);
+    }
+
+} // namespace gs
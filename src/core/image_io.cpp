@@ -2,21 +2,34 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "core/image_io.hpp"
+#include "core/thread_placement.hpp"
+#include "core/trace_recorder.hpp"
 
+#include <OpenImageIO/filesystem.h>
 #include <OpenImageIO/imagebuf.h>
 #include <OpenImageIO/imagebufalgo.h>
 #include <OpenImageIO/imageio.h>
 
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAStream.h>
+
 #include <algorithm>
 #include <condition_variable>
 #include <core/logger.hpp>
+#include <cstring>
 #include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <random>
+#include <span>
 #include <stdexcept>
 #include <thread>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -30,16 +43,11 @@ namespace {
         });
     }
 
-    // Downscale (resample) to (nw, nh). Returns newly malloc’ed RGB buffer.
-    static inline unsigned char* downscale_resample_direct(const unsigned char* src_rgb,
-                                                           int w, int h, int nw, int nh,
-                                                           int nthreads /* 0=auto, 1=single */) {
-        // Allocate destination first
-        size_t outbytes = (size_t)nw * nh * 3;
-        auto* out = static_cast<unsigned char*>(std::malloc(outbytes));
-        if (!out)
-            throw std::bad_alloc();
-
+    // Downscale (resample) to (nw, nh) into the RGB buffer out
+    static inline void downscale_resample_direct(const unsigned char* src_rgb,
+                                                 int w, int h, int nw, int nh,
+                                                 unsigned char* out,
+                                                 int nthreads /* 0=auto, 1=single */) {
         // Wrap src & dst without extra allocations/copies
         OIIO::ImageBuf srcbuf(OIIO::ImageSpec(w, h, 3, OIIO::TypeDesc::UINT8),
                               const_cast<unsigned char*>(src_rgb));
@@ -48,15 +56,37 @@ namespace {
         OIIO::ROI roi(0, nw, 0, nh, 0, 1, 0, 3);
         if (!OIIO::ImageBufAlgo::resample(dstbuf, srcbuf, /*interpolate=*/true, roi, nthreads)) {
             std::string err = dstbuf.geterror();
-            std::free(out);
             throw std::runtime_error(std::string("Resample failed: ") + (err.empty() ? "unknown" : err));
         }
-        return out; // already filled
     }
 
+    // Scratch buffer of a decode, freed on every path out
+    using ScratchBuffer = std::unique_ptr<unsigned char, decltype(&std::free)>;
+    ScratchBuffer malloc_scratch(size_t bytes) {
+        auto* data = static_cast<unsigned char*>(std::malloc(bytes));
+        if (!data)
+            throw std::bad_alloc();
+        return {data, &std::free};
+    }
+
+    // Output buffer from an allocator, handed to the caller only once the decode succeeded
+    struct OutputBuffer {
+        const image_io::PixelAllocator& allocator;
+        unsigned char* data = nullptr;
+
+        OutputBuffer(const image_io::PixelAllocator& a, size_t bytes)
+            : allocator(a),
+              data(a.allocate(bytes)) {}
+        ~OutputBuffer() {
+            if (data)
+                allocator.release(data);
+        }
+        unsigned char* take() { return std::exchange(data, nullptr); }
+    };
+
 } // namespace
 
-std::tuple<int, int, int> get_image_info(std::filesystem::path p) {
+static std::tuple<int, int, int> probe_image_info(const std::filesystem::path& p) {
     init_oiio();
 
     auto in = OIIO::ImageInput::open(p.string());
@@ -110,212 +140,287 @@ load_image_with_alpha(std::filesystem::path p) {
     }
 }
 
-std::tuple<unsigned char*, int, int, int>
-load_image(std::filesystem::path p, int res_div, int max_width) {
+static std::tuple<unsigned char*, int, int, int>
+decode_image(const std::filesystem::path& p, std::span<const unsigned char> encoded, int res_div, int max_width,
+             const image_io::PixelAllocator& allocator) {
     init_oiio();
 
-    std::unique_ptr<OIIO::ImageInput> in(OIIO::ImageInput::open(p.string()));
+    // Bytes read ahead are decoded from memory, the path still picks the format. Plugins without
+    // IOProxy support read the file again.
+    std::optional<OIIO::Filesystem::IOMemReader> memory;
+    std::unique_ptr<OIIO::ImageInput> in;
+    if (!encoded.empty()) {
+        memory.emplace(encoded.data(), encoded.size());
+        in = OIIO::ImageInput::open(p.string(), nullptr, &*memory);
+    }
+    if (!in)
+        in = OIIO::ImageInput::open(p.string());
     if (!in)
         throw std::runtime_error("Load failed: " + p.string() + " : " + OIIO::geterror());
 
     const OIIO::ImageSpec& spec = in->spec();
-    int w = spec.width, h = spec.height, file_c = spec.nchannels;
-
-    auto finish = [&](unsigned char* data, int W, int H, int C) {
-        in->close();
-        return std::make_tuple(data, W, H, C);
-    };
+    const int w = spec.width, h = spec.height, file_c = spec.nchannels;
 
     // Decide threading for the resample (see notes below)
     const int nthreads = 0; // set to 1 if you call this from multiple worker threads
 
-    // Fast path: read 3 channels directly (drop alpha if present)
-    if (file_c >= 3) {
-        if (res_div <= 1) {
-            // allocate and read directly into final RGB buffer
-            auto* out = static_cast<unsigned char*>(std::malloc((size_t)w * h * 3));
-            if (!out) {
-                in->close();
-                throw std::bad_alloc();
-            }
+    // max_width only applies to RGB(A) sources, 1–2 channel ones are only divided
+    const bool rgb = file_c >= 3;
+    if (rgb && res_div > 1 && res_div != 2 && res_div != 4 && res_div != 8) {
+        LOG_ERROR("load_image: unsupported resize factor {}", res_div);
+    }
+    const bool divided = res_div == 2 || res_div == 4 || res_div == 8;
+    int out_w = divided ? std::max(1, w / res_div) : w;
+    int out_h = divided ? std::max(1, h / res_div) : h;
+    if (rgb && max_width > 0 && (out_w > max_width || out_h > max_width)) {
+        if (out_w > out_h) {
+            out_h = std::max(1, max_width * out_h / out_w);
+            out_w = std::max(1, max_width);
+        } else {
+            out_w = std::max(1, max_width * out_w / out_h);
+            out_h = std::max(1, max_width);
+        }
+    }
+    const bool resized = out_w != w || out_h != h;
+
+    auto read_failed = [&]() {
+        std::string e = in->geterror();
+        in->close();
+        return std::runtime_error("Read failed: " + p.string() + (e.empty() ? "" : (" : " + e)));
+    };
 
+    // Fast path: read 3 channels directly (drop alpha if present), straight into the output when
+    // no resize follows
+    if (rgb) {
+        if (!resized) {
+            OutputBuffer out(allocator, (size_t)w * h * 3);
             if (!in->read_image(/*subimage*/ 0, /*miplevel*/ 0,
                                 /*chbegin*/ 0, /*chend*/ 3,
-                                OIIO::TypeDesc::UINT8, out)) {
-                std::string e = in->geterror();
-                std::free(out);
-                in->close();
-                throw std::runtime_error("Read failed: " + p.string() + (e.empty() ? "" : (" : " + e)));
+                                OIIO::TypeDesc::UINT8, out.data)) {
+                throw read_failed();
             }
             in->close();
+            return {out.take(), w, h, 3};
+        }
 
-            if (max_width > 0 && (w > max_width || h > max_width)) {
-                int scale_w;
-                int scale_h;
-                if (w > h) {
-                    scale_h = std::max(1, max_width * h / w);
-                    scale_w = std::max(1, max_width);
-                } else {
-                    scale_w = std::max(1, max_width * w / h);
-                    scale_h = std::max(1, max_width);
-                }
-                unsigned char* ret = nullptr;
-                try {
-                    ret = downscale_resample_direct(out, w, h, scale_w, scale_h, nthreads);
-                } catch (...) {
-                    std::free(out);
-                    throw;
-                }
-                std::free(out);
-                return {ret, scale_w, scale_h, 3};
-            } else {
-                return {out, w, h, 3};
-            }
-
-        } else if (res_div == 2 || res_div == 4 || res_div == 8) {
-            // read full, then downscale in-place into a new buffer without extra copy
-            auto* full = static_cast<unsigned char*>(std::malloc((size_t)w * h * 3));
-            if (!full) {
-                in->close();
-                throw std::bad_alloc();
-            }
-
-            if (!in->read_image(0, 0, 0, 3, OIIO::TypeDesc::UINT8, full)) {
-                std::string e = in->geterror();
-                std::free(full);
-                in->close();
-                throw std::runtime_error("Read failed: " + p.string() + (e.empty() ? "" : (" : " + e)));
-            }
-            in->close();
-
-            const int nw = std::max(1, w / res_div);
-            const int nh = std::max(1, h / res_div);
-            int scale_w = nw;
-            int scale_h = nh;
-            if (max_width > 0 && (nw > max_width || nh > max_width)) {
-                if (nw > nh) {
-                    scale_h = std::max(1, max_width * nh / nw);
-                    scale_w = std::max(1, max_width);
-                } else {
-                    scale_w = std::max(1, max_width * nw / nh);
-                    scale_h = std::max(1, max_width);
-                }
-            }
-
-            unsigned char* out = nullptr;
-            try {
-                out = downscale_resample_direct(full, w, h, scale_w, scale_h, nthreads);
-            } catch (...) {
-                std::free(full);
-                throw;
-            }
-            std::free(full);
-            return {out, scale_w, scale_h, 3};
-        } else {
-            LOG_ERROR("load_image: unsupported resize factor {}", res_div);
-            // fall through
+        // read full, then downscale into the output without extra copy
+        auto full = malloc_scratch((size_t)w * h * 3);
+        if (!in->read_image(0, 0, 0, 3, OIIO::TypeDesc::UINT8, full.get())) {
+            throw read_failed();
         }
+        in->close();
+
+        OutputBuffer out(allocator, (size_t)out_w * out_h * 3);
+        downscale_resample_direct(full.get(), w, h, out_w, out_h, out.data, nthreads);
+        return {out.take(), out_w, out_h, 3};
     }
 
     // 1–2 channel inputs -> read native, then expand to RGB
-    {
-        const int in_c = std::min(2, std::max(1, file_c));
-        std::vector<unsigned char> tmp((size_t)w * h * in_c);
-        if (!in->read_image(0, 0, 0, in_c, OIIO::TypeDesc::UINT8, tmp.data())) {
-            auto e = in->geterror();
-            in->close();
-            throw std::runtime_error("Read failed: " + p.string() + (e.empty() ? "" : (" : " + e)));
-        }
-        in->close();
+    const int in_c = std::max(1, file_c);
+    std::vector<unsigned char> tmp((size_t)w * h * in_c);
+    if (!in->read_image(0, 0, 0, in_c, OIIO::TypeDesc::UINT8, tmp.data())) {
+        throw read_failed();
+    }
+    in->close();
 
-        auto* base = static_cast<unsigned char*>(std::malloc((size_t)w * h * 3));
-        if (!base)
-            throw std::bad_alloc();
+    OutputBuffer out(allocator, (size_t)out_w * out_h * 3);
+    ScratchBuffer expanded(nullptr, &std::free);
+    unsigned char* base = out.data;
+    if (resized) {
+        expanded = malloc_scratch((size_t)w * h * 3);
+        base = expanded.get();
+    }
 
-        if (in_c == 1) {
-            const unsigned char* g = tmp.data();
-            for (size_t i = 0, N = (size_t)w * h; i < N; ++i) {
-                unsigned char v = g[i];
-                base[3 * i + 0] = v;
-                base[3 * i + 1] = v;
-                base[3 * i + 2] = v;
-            }
-        } else { // 2 channels -> (R,G,avg)
-            const unsigned char* src = tmp.data();
-            for (size_t i = 0, N = (size_t)w * h; i < N; ++i) {
-                unsigned char r = src[2 * i + 0];
-                unsigned char g = src[2 * i + 1];
-                base[3 * i + 0] = r;
-                base[3 * i + 1] = g;
-                base[3 * i + 2] = (unsigned char)(((int)r + (int)g) / 2);
-            }
+    if (in_c == 1) {
+        const unsigned char* g = tmp.data();
+        for (size_t i = 0, N = (size_t)w * h; i < N; ++i) {
+            unsigned char v = g[i];
+            base[3 * i + 0] = v;
+            base[3 * i + 1] = v;
+            base[3 * i + 2] = v;
         }
-
-        if (res_div == 2 || res_div == 4 || res_div == 8) {
-            const int nw = std::max(1, w / res_div);
-            const int nh = std::max(1, h / res_div);
-            unsigned char* out = nullptr;
-            try {
-                out = downscale_resample_direct(base, w, h, nw, nh, nthreads);
-            } catch (...) {
-                std::free(base);
-                throw;
-            }
-            std::free(base);
-            return {out, nw, nh, 3};
+    } else { // 2 channels -> (R,G,avg)
+        const unsigned char* src = tmp.data();
+        for (size_t i = 0, N = (size_t)w * h; i < N; ++i) {
+            unsigned char r = src[2 * i + 0];
+            unsigned char g = src[2 * i + 1];
+            base[3 * i + 0] = r;
+            base[3 * i + 1] = g;
+            base[3 * i + 2] = (unsigned char)(((int)r + (int)g) / 2);
         }
+    }
 
-        return {base, w, h, 3};
+    if (resized) {
+        downscale_resample_direct(base, w, h, out_w, out_h, out.data, nthreads);
     }
+    return {out.take(), out_w, out_h, 3};
 }
 
-void save_image(const std::filesystem::path& path, torch::Tensor image) {
+void set_image_io_threads(int threads) {
     init_oiio();
+    OIIO::attribute("threads", std::max(1, threads));
+}
+
+std::tuple<int, int, int> get_image_info(std::filesystem::path p) {
+    auto& disk_cache = image_io::DiskImageCache::instance();
+    if (!disk_cache.is_enabled()) {
+        return probe_image_info(p);
+    }
+    if (auto info = disk_cache.load_info(p)) {
+        return *info;
+    }
+    auto info = probe_image_info(p);
+    const auto [w, h, c] = info;
+    disk_cache.store_info(p, w, h, c);
+    return info;
+}
+
+static std::tuple<unsigned char*, int, int, int>
+load_image(const std::filesystem::path& p, std::span<const unsigned char> encoded, int res_div, int max_width,
+           const image_io::PixelAllocator& allocator) {
+    auto& disk_cache = image_io::DiskImageCache::instance();
+    if (!disk_cache.is_enabled()) {
+        return decode_image(p, encoded, res_div, max_width, allocator);
+    }
+    if (auto cached = disk_cache.load(p, res_div, max_width, allocator)) {
+        return *cached;
+    }
+    auto decoded = decode_image(p, encoded, res_div, max_width, allocator);
+    const auto [data, w, h, c] = decoded;
+    disk_cache.store(p, res_div, max_width, data, w, h, c);
+    return decoded;
+}
+
+std::tuple<unsigned char*, int, int, int>
+load_image(std::filesystem::path p, int res_div, int max_width) {
+    return load_image(p, {}, res_div, max_width, image_io::malloc_pixels());
+}
 
-    // Normalize to HxWxC, uint8 on CPU
-    image = image.clone().to(torch::kCPU).to(torch::kFloat32);
-    if (image.dim() == 4)
-        image = image.squeeze(0); // [B,C,H,W] -> [C,H,W]
-    if (image.dim() == 3 && image.size(0) <= 4)
-        image = image.permute({1, 2, 0}); // [C,H,W]->[H,W,C]
-    image = image.contiguous();
+torch::Tensor load_binary_mask(const std::filesystem::path& path, const int64_t height, const int64_t width) {
+    auto [data, w, h, c] = load_image(path, 1, 0);
+    auto mask = torch::from_blob(data, {h, w, c}, torch::kUInt8)
+                    .index({torch::indexing::Slice(), torch::indexing::Slice(), 0})
+                    .gt(127)
+                    .to(torch::kUInt8)
+                    .unsqueeze(0);
+    if (h != height || w != width) {
+        mask = torch::nn::functional::interpolate(
+                   mask.unsqueeze(0).to(torch::kFloat32),
+                   torch::nn::functional::InterpolateFuncOptions()
+                       .size(std::vector<int64_t>{height, width})
+                       .mode(torch::kNearest))
+                   .squeeze(0)
+                   .to(torch::kUInt8);
+    }
+    auto pinned = mask.pin_memory();
+    free_image(data);
+    return pinned;
+}
 
-    const int height = (int)image.size(0);
-    const int width = (int)image.size(1);
-    int channels = (int)image.size(2);
-    if (channels < 1 || channels > 4)
-        throw std::runtime_error("save_image: channels must be in [1..4]");
+torch::Tensor load_image_pinned(std::filesystem::path p, int res_div, int max_width) {
+    return load_image_pinned(std::move(p), {}, res_div, max_width);
+}
 
-    LOG_INFO("Saving image: {} shape: [{}, {}, {}]", path.string(), height, width, channels);
+torch::Tensor load_image_pinned(std::filesystem::path p, std::span<const unsigned char> encoded, int res_div, int max_width) {
+    // Blocks come from torch's caching host allocator, which keeps a freed block away from new
+    // requests until the copies that read it have completed
+    torch::Tensor pixels;
+    const image_io::PixelAllocator pinned{
+        .allocate = [&pixels](size_t bytes) {
+            pixels = torch::empty({static_cast<int64_t>(bytes)},
+                                  torch::TensorOptions().dtype(torch::kUInt8).pinned_memory(true));
+            return pixels.data_ptr<unsigned char>();
+        },
+        .release = [&pixels](unsigned char*) { pixels = torch::Tensor(); }};
+    const auto [data, w, h, c] = load_image(p, encoded, res_div, max_width, pinned);
+    return pixels.view({h, w, c});
+}
 
-    auto img_uint8 = (image.clamp(0, 1) * 255.0f).to(torch::kUInt8).contiguous();
+namespace {
 
-    // Prepare OIIO output
-    const std::string fname = path.string();
-    auto out = OIIO::ImageOutput::create(fname);
-    if (!out) {
-        throw std::runtime_error("ImageOutput::create failed for " + fname + " : " + OIIO::geterror());
+    // [1, C, H, W], [C, H, W] or [H, W, C] in [0, 1] to contiguous [H, W, C] uint8, on the image's device
+    torch::Tensor to_hwc_uint8(torch::Tensor image) {
+        if (image.dim() == 4)
+            image = image.squeeze(0); // [B,C,H,W] -> [C,H,W]
+        if (image.dim() == 3 && image.size(0) <= 4)
+            image = image.permute({1, 2, 0}); // [C,H,W]->[H,W,C]
+        if (image.dim() != 3 || image.size(2) < 1 || image.size(2) > 4)
+            throw std::runtime_error("save_image: channels must be in [1..4]");
+        return (image.to(torch::kFloat32).clamp(0, 1) * 255.0f).to(torch::kUInt8).contiguous();
     }
 
-    OIIO::ImageSpec spec(width, height, channels, OIIO::TypeDesc::UINT8);
+    // Concatenates at uint8 on the device of the first CUDA image, so only the combo crosses to the host
+    torch::Tensor compose_hwc_uint8(const std::vector<torch::Tensor>& images, bool horizontal, int separator_width) {
+        torch::Device device(torch::kCPU);
+        for (const auto& img : images) {
+            if (img.is_cuda()) {
+                device = img.device();
+                break;
+            }
+        }
 
-    // Set JPEG quality if needed
-    auto ext = path.extension().string();
-    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
-    if (ext == ".jpg" || ext == ".jpeg")
-        spec.attribute("CompressionQuality", 95);
+        std::vector<torch::Tensor> parts;
+        parts.reserve(images.size() * 2);
+        for (size_t i = 0; i < images.size(); ++i) {
+            // Separator (white)
+            if (i > 0 && separator_width > 0) {
+                const auto& ref = parts[0];
+                parts.push_back(horizontal
+                                    ? torch::full({ref.size(0), separator_width, ref.size(2)}, 255, ref.options())
+                                    : torch::full({separator_width, ref.size(1), ref.size(2)}, 255, ref.options()));
+            }
+            parts.push_back(to_hwc_uint8(images[i]).to(device));
+        }
+        return torch::cat(parts, horizontal ? 1 : 0).contiguous();
+    }
 
-    if (!out->open(fname, spec)) {
-        auto e = out->geterror();
-        throw std::runtime_error("open('" + fname + "') failed: " + (e.empty() ? OIIO::geterror() : e));
+    bool has_jpeg_extension(const std::filesystem::path& path) {
+        auto ext = path.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+        return ext == ".jpg" || ext == ".jpeg";
     }
 
-    if (!out->write_image(OIIO::TypeDesc::UINT8, img_uint8.data_ptr<uint8_t>())) {
-        auto e = out->geterror();
+    void write_image_uint8(const std::filesystem::path& path, const uint8_t* data, int width, int height, int channels) {
+        init_oiio();
+
+        LOG_INFO("Saving image: {} shape: [{}, {}, {}]", path.string(), height, width, channels);
+
+        // Prepare OIIO output
+        const std::string fname = path.string();
+        auto out = OIIO::ImageOutput::create(fname);
+        if (!out) {
+            throw std::runtime_error("ImageOutput::create failed for " + fname + " : " + OIIO::geterror());
+        }
+
+        OIIO::ImageSpec spec(width, height, channels, OIIO::TypeDesc::UINT8);
+
+        // Set JPEG quality if needed
+        if (has_jpeg_extension(path))
+            spec.attribute("CompressionQuality", 95);
+
+        if (!out->open(fname, spec)) {
+            auto e = out->geterror();
+            throw std::runtime_error("open('" + fname + "') failed: " + (e.empty() ? OIIO::geterror() : e));
+        }
+
+        if (!out->write_image(OIIO::TypeDesc::UINT8, data)) {
+            auto e = out->geterror();
+            out->close();
+            throw std::runtime_error("write_image failed: " + (e.empty() ? OIIO::geterror() : e));
+        }
         out->close();
-        throw std::runtime_error("write_image failed: " + (e.empty() ? OIIO::geterror() : e));
     }
-    out->close();
+
+    void write_image_uint8(const std::filesystem::path& path, const torch::Tensor& hwc) {
+        const auto host = hwc.cpu().contiguous();
+        write_image_uint8(path, host.data_ptr<uint8_t>(), (int)host.size(1), (int)host.size(0), (int)host.size(2));
+    }
+
+} // namespace
+
+void save_image(const std::filesystem::path& path, torch::Tensor image) {
+    // Quantized before the download, a quarter of the float transfer
+    write_image_uint8(path, to_hwc_uint8(std::move(image)));
 }
 
 void save_image(const std::filesystem::path& path,
@@ -328,44 +433,37 @@ void save_image(const std::filesystem::path& path,
         save_image(path, images[0]);
         return;
     }
-
-    // Prepare all to HWC float on CPU
-    std::vector<torch::Tensor> xs;
-    xs.reserve(images.size());
-    for (auto img : images) {
-        img = img.clone().to(torch::kCPU).to(torch::kFloat32);
-        if (img.dim() == 4)
-            img = img.squeeze(0);
-        if (img.dim() == 3 && img.size(0) <= 4)
-            img = img.permute({1, 2, 0});
-        xs.push_back(img.contiguous());
-    }
-
-    // Separator (white)
-    torch::Tensor sep;
-    if (separator_width > 0) {
-        const auto ref = xs[0];
-        sep = horizontal
-                  ? torch::ones({ref.size(0), separator_width, ref.size(2)}, ref.options())
-                  : torch::ones({separator_width, ref.size(1), ref.size(2)}, ref.options());
-    }
-
-    // Concatenate
-    torch::Tensor combo = xs[0];
-    for (size_t i = 1; i < xs.size(); ++i) {
-        combo = (separator_width > 0)
-                    ? torch::cat({combo, sep, xs[i]}, horizontal ? 1 : 0)
-                    : torch::cat({combo, xs[i]}, horizontal ? 1 : 0);
-    }
-
-    // Save
-    save_image(path, combo);
+    write_image_uint8(path, compose_hwc_uint8(images, horizontal, separator_width));
 }
 
 void free_image(unsigned char* img) { std::free(img); }
 
 namespace image_io {
 
+    const PixelAllocator& malloc_pixels() {
+        static const PixelAllocator allocator{
+            .allocate = [](size_t bytes) {
+                auto* data = static_cast<unsigned char*>(std::malloc(bytes));
+                if (!data)
+                    throw std::bad_alloc();
+                return data;
+            },
+            .release = [](unsigned char* data) { std::free(data); }};
+        return allocator;
+    }
+
+    // A CUDA image in flight. Either copied into a pinned host buffer on the staging stream, or kept
+    // on the device for an nvJPEG encode. ready completes once the copy (or the image) is done.
+    struct BatchImageSaver::StagedImage {
+        torch::Tensor image; // [H, W, C] uint8 when not staged, a CPU copy if no event could be had
+        unsigned char* host = nullptr;
+        size_t host_bytes = 0;
+        cudaEvent_t ready = nullptr;
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+    };
+
     BatchImageSaver::BatchImageSaver(size_t num_workers)
         : num_workers_(std::min(num_workers, std::min(size_t(8), size_t(std::thread::hardware_concurrency())))) {
 
@@ -375,6 +473,7 @@ namespace image_io {
         }
     }
 
+    // The CUDA context may be gone at exit, the staging stream, events and buffers die with it
     BatchImageSaver::~BatchImageSaver() { shutdown(); }
 
     void BatchImageSaver::shutdown() {
@@ -405,18 +504,15 @@ namespace image_io {
         }
         SaveTask t;
         t.path = path;
-        t.image = image.clone();
         t.is_multi = false;
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            if (stop_) {
-                save_image(path, image);
-                return;
-            }
-            task_queue_.push(std::move(t));
-            active_tasks_++;
+        if (image.is_cuda()) {
+            auto hwc = to_hwc_uint8(std::move(image));
+            const bool gpu_jpeg = has_jpeg_extension(path) && hwc.size(2) == 3 && gpu_image_encode_available();
+            t.staged = stage(std::move(hwc), gpu_jpeg);
+        } else {
+            t.image = image.clone();
         }
-        cv_.notify_one();
+        enqueue(std::move(t));
     }
 
     void BatchImageSaver::queue_save_multiple(const std::filesystem::path& path,
@@ -429,23 +525,124 @@ namespace image_io {
         }
         SaveTask t;
         t.path = path;
-        t.images.reserve(images.size());
-        for (const auto& img : images)
-            t.images.push_back(img.clone());
-        t.is_multi = true;
         t.horizontal = horizontal;
         t.separator_width = separator_width;
+        const bool any_cuda = std::any_of(images.begin(), images.end(), [](const auto& img) { return img.is_cuda(); });
+        if (any_cuda && !images.empty()) {
+            // Composed on the device, the combo is staged like a single image
+            t.is_multi = false;
+            t.staged = stage(compose_hwc_uint8(images, horizontal, separator_width), false);
+        } else {
+            t.images.reserve(images.size());
+            for (const auto& img : images)
+                t.images.push_back(img.clone());
+            t.is_multi = true;
+        }
+        enqueue(std::move(t));
+    }
 
+    void BatchImageSaver::enqueue(SaveTask&& t) {
         {
             std::unique_lock<std::mutex> lock(queue_mutex_);
-            if (stop_) {
-                save_image(path, images, horizontal, separator_width);
+            if (!stop_) {
+                task_queue_.push(std::move(t));
+                active_tasks_++;
+                cv_.notify_one();
                 return;
             }
-            task_queue_.push(std::move(t));
-            active_tasks_++;
         }
-        cv_.notify_one();
+        process_task(t);
+    }
+
+    std::shared_ptr<BatchImageSaver::StagedImage> BatchImageSaver::stage(torch::Tensor hwc, bool keep_on_device) {
+        auto staged = std::make_shared<StagedImage>();
+        staged->height = static_cast<int>(hwc.size(0));
+        staged->width = static_cast<int>(hwc.size(1));
+        staged->channels = static_cast<int>(hwc.size(2));
+
+        const auto device_index = hwc.device().index();
+        const cudaStream_t producer = at::cuda::getCurrentCUDAStream(device_index);
+        const size_t bytes = static_cast<size_t>(hwc.numel());
+
+        std::lock_guard<std::mutex> lock(staging_mutex_);
+        staged->ready = acquire_event();
+        if (!staged->ready) {
+            // Without an event to fence on, download it here
+            staged->image = hwc.cpu();
+            return staged;
+        }
+        if (!keep_on_device) {
+            if (!staging_stream_ && cudaStreamCreateWithFlags(&staging_stream_, cudaStreamNonBlocking) != cudaSuccess) {
+                staging_stream_ = nullptr;
+            }
+            if (staging_stream_) {
+                std::tie(staged->host, staged->host_bytes) = acquire_buffer(bytes);
+            }
+        }
+        if (!staged->host) {
+            // For nvJPEG, or out of pinned memory and the worker downloads it the slow way
+            cudaEventRecord(staged->ready, producer);
+            staged->image = std::move(hwc);
+            return staged;
+        }
+
+        // The copy waits for the image on the producer stream, which carries on without a sync
+        cudaEventRecord(staged->ready, producer);
+        cudaStreamWaitEvent(staging_stream_, staged->ready, 0);
+        cudaMemcpyAsync(staged->host, hwc.data_ptr(), bytes, cudaMemcpyDeviceToHost, staging_stream_);
+        hwc.record_stream(c10::cuda::getStreamFromExternal(staging_stream_, device_index));
+        cudaEventRecord(staged->ready, staging_stream_);
+        return staged;
+    }
+
+    cudaEvent_t BatchImageSaver::acquire_event() {
+        if (!free_events_.empty()) {
+            cudaEvent_t event = free_events_.back();
+            free_events_.pop_back();
+            return event;
+        }
+        cudaEvent_t event = nullptr;
+        if (cudaEventCreateWithFlags(&event, cudaEventDisableTiming) != cudaSuccess) {
+            return nullptr;
+        }
+        return event;
+    }
+
+    std::pair<unsigned char*, size_t> BatchImageSaver::acquire_buffer(size_t bytes) {
+        // Smallest free buffer that fits, eval and timelapse images mostly repeat the same few sizes
+        auto best = free_buffers_.end();
+        for (auto it = free_buffers_.begin(); it != free_buffers_.end(); ++it) {
+            if (it->second >= bytes && (best == free_buffers_.end() || it->second < best->second)) {
+                best = it;
+            }
+        }
+        if (best != free_buffers_.end()) {
+            const auto buffer = *best;
+            free_buffers_.erase(best);
+            return buffer;
+        }
+        void* data = nullptr;
+        if (cudaHostAlloc(&data, bytes, cudaHostAllocDefault) != cudaSuccess) {
+            cudaGetLastError(); // Not sticky, keep it from surfacing in a later check
+            return {nullptr, 0};
+        }
+        return {static_cast<unsigned char*>(data), bytes};
+    }
+
+    void BatchImageSaver::release_staged(StagedImage& staged) {
+        if (staged.host) {
+            if (free_buffers_.size() < MAX_FREE_BUFFERS) {
+                free_buffers_.emplace_back(staged.host, staged.host_bytes);
+            } else {
+                cudaFreeHost(staged.host);
+            }
+            staged.host = nullptr;
+            staged.host_bytes = 0;
+        }
+        if (staged.ready) {
+            free_events_.push_back(staged.ready);
+            staged.ready = nullptr;
+        }
     }
 
     void BatchImageSaver::wait_all() {
@@ -459,6 +656,8 @@ namespace image_io {
     }
 
     void BatchImageSaver::worker_thread() {
+        gs::core::ThreadPlacement::get().pin_current_thread();
+        gs::core::TraceRecorder::get().set_thread_name("image saver");
         while (true) {
             SaveTask t;
             {
@@ -481,8 +680,11 @@ namespace image_io {
     }
 
     void BatchImageSaver::process_task(const SaveTask& t) {
+        TRACE_SPAN("save image");
         try {
-            if (t.is_multi) {
+            if (t.staged) {
+                save_staged(t.path, *t.staged);
+            } else if (t.is_multi) {
                 save_image(t.path, t.images, t.horizontal, t.separator_width);
             } else {
                 save_image(t.path, t.image);
@@ -490,6 +692,194 @@ namespace image_io {
         } catch (const std::exception& e) {
             LOG_ERROR("[BatchImageSaver] Error saving {}: {}", t.path.string(), e.what());
         }
+        if (t.staged) {
+            t.staged->image = torch::Tensor();
+            std::lock_guard<std::mutex> lock(staging_mutex_);
+            release_staged(*t.staged);
+        }
+    }
+
+    void BatchImageSaver::save_staged(const std::filesystem::path& path, StagedImage& staged) {
+        if (staged.image.defined()) {
+            if (staged.image.is_cuda()) {
+                if (has_jpeg_extension(path) && save_jpeg_cuda(path, staged.image, staged.ready)) {
+                    return;
+                }
+                if (cudaEventSynchronize(staged.ready) != cudaSuccess) {
+                    throw std::runtime_error("waiting for the image failed");
+                }
+            }
+            write_image_uint8(path, staged.image);
+            return;
+        }
+
+        if (cudaEventSynchronize(staged.ready) != cudaSuccess) {
+            throw std::runtime_error("device to host copy failed");
+        }
+        write_image_uint8(path, staged.host, staged.width, staged.height, staged.channels);
+    }
+
+    namespace {
+        constexpr char kDiskCacheMagic[8] = {'L', 'F', 'S', 'I', 'M', 'G', '1', '\0'};
+
+        struct DiskCacheHeader {
+            char magic[8];
+            uint32_t width;
+            uint32_t height;
+            uint32_t channels;
+            uint32_t reserved;
+        };
+
+        // Entry of source in directory, or next to it when directory is empty. nullopt when the
+        // source can't be stat'ed.
+        std::optional<std::filesystem::path> raw_entry_path(const std::filesystem::path& directory,
+                                                            const std::filesystem::path& source,
+                                                            const std::string& variant,
+                                                            const char* extension) {
+            std::error_code ec;
+            const auto size = std::filesystem::file_size(source, ec);
+            if (ec)
+                return std::nullopt;
+            const auto mtime = std::filesystem::last_write_time(source, ec);
+            if (ec)
+                return std::nullopt;
+
+            const std::string key = std::format("{}|{}|{}|{}",
+                                                std::filesystem::absolute(source).lexically_normal().string(),
+                                                size, mtime.time_since_epoch().count(), variant);
+            const auto dir = directory.empty() ? source.parent_path() / ".lfs_cache" : directory;
+            return dir / std::format("{:016x}{}", std::hash<std::string>{}(key), extension);
+        }
+
+        // Writes to a unique temp file and renames, concurrent loaders may store the same entry
+        bool write_raw_entry(const std::filesystem::path& path, int width, int height, int channels,
+                             const unsigned char* data, size_t num_bytes) {
+            std::error_code ec;
+            std::filesystem::create_directories(path.parent_path(), ec);
+            const auto tmp = path.string() + std::format(".{:08x}.tmp", std::random_device{}());
+            {
+                std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+                DiskCacheHeader header{};
+                std::memcpy(header.magic, kDiskCacheMagic, sizeof(kDiskCacheMagic));
+                header.width = static_cast<uint32_t>(width);
+                header.height = static_cast<uint32_t>(height);
+                header.channels = static_cast<uint32_t>(channels);
+                out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                if (num_bytes > 0)
+                    out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(num_bytes));
+                if (!out) {
+                    out.close();
+                    std::filesystem::remove(tmp, ec);
+                    return false;
+                }
+            }
+            std::filesystem::rename(tmp, path, ec);
+            if (ec)
+                std::filesystem::remove(tmp, ec);
+            return true;
+        }
+    } // namespace
+
+    std::optional<std::filesystem::path> raw_image_path(const std::filesystem::path& directory,
+                                                        const std::filesystem::path& source,
+                                                        int res_div, int max_width) {
+        return raw_entry_path(directory, source, std::format("{}|{}", res_div, max_width), ".rgb");
+    }
+
+    bool write_raw_image(const std::filesystem::path& path, const unsigned char* data,
+                         int width, int height, int channels) {
+        return write_raw_entry(path, width, height, channels, data, static_cast<size_t>(width) * height * channels);
+    }
+
+    std::optional<RawImageLayout> parse_raw_image(std::span<const char> file) {
+        DiskCacheHeader header{};
+        if (file.size() < sizeof(header))
+            return std::nullopt;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, kDiskCacheMagic, sizeof(kDiskCacheMagic)) != 0 ||
+            header.width == 0 || header.height == 0 || header.channels == 0)
+            return std::nullopt;
+        const size_t num_bytes = static_cast<size_t>(header.width) * header.height * header.channels;
+        if (file.size() < sizeof(header) + num_bytes)
+            return std::nullopt;
+        return RawImageLayout{.offset = sizeof(header),
+                              .width = static_cast<int>(header.width),
+                              .height = static_cast<int>(header.height),
+                              .channels = static_cast<int>(header.channels)};
+    }
+
+    void DiskImageCache::enable(const std::filesystem::path& directory) {
+        directory_ = directory;
+        enabled_ = true;
+        LOG_INFO("Disk image cache enabled ({})",
+                 directory_.empty() ? std::string(".lfs_cache next to each image") : directory_.string());
+    }
+
+    std::optional<std::filesystem::path> DiskImageCache::entry_path(const std::filesystem::path& source,
+                                                                    const std::string& variant,
+                                                                    const char* extension) const {
+        return raw_entry_path(directory_, source, variant, extension);
+    }
+
+    void DiskImageCache::write_entry(const std::filesystem::path& path, int width, int height, int channels,
+                                     const unsigned char* data, size_t num_bytes) const {
+        if (!write_raw_entry(path, width, height, channels, data, num_bytes) && !write_failed_.exchange(true))
+            LOG_WARN("Disk image cache not writable at {}, continuing without storing", path.parent_path().string());
+    }
+
+    std::optional<std::tuple<unsigned char*, int, int, int>>
+    DiskImageCache::load(const std::filesystem::path& source, int res_div, int max_width,
+                         const PixelAllocator& allocator) const {
+        const auto path = raw_image_path(directory_, source, res_div, max_width);
+        if (!path)
+            return std::nullopt;
+
+        std::ifstream in(*path, std::ios::binary);
+        if (!in)
+            return std::nullopt;
+
+        DiskCacheHeader header{};
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            std::memcmp(header.magic, kDiskCacheMagic, sizeof(kDiskCacheMagic)) != 0 ||
+            header.width == 0 || header.height == 0 || header.channels == 0)
+            return std::nullopt;
+
+        const size_t num_bytes = static_cast<size_t>(header.width) * header.height * header.channels;
+        auto* data = allocator.allocate(num_bytes);
+        if (!in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(num_bytes))) {
+            // Truncated entry, decode again and overwrite it
+            allocator.release(data);
+            return std::nullopt;
+        }
+        return std::make_tuple(data, static_cast<int>(header.width), static_cast<int>(header.height),
+                               static_cast<int>(header.channels));
+    }
+
+    void DiskImageCache::store(const std::filesystem::path& source, int res_div, int max_width,
+                               const unsigned char* data, int width, int height, int channels) const {
+        if (const auto path = raw_image_path(directory_, source, res_div, max_width)) {
+            write_entry(*path, width, height, channels, data, static_cast<size_t>(width) * height * channels);
+        }
+    }
+
+    std::optional<std::tuple<int, int, int>> DiskImageCache::load_info(const std::filesystem::path& source) const {
+        const auto path = entry_path(source, "info", ".info");
+        if (!path)
+            return std::nullopt;
+
+        std::ifstream in(*path, std::ios::binary);
+        DiskCacheHeader header{};
+        if (!in || !in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            std::memcmp(header.magic, kDiskCacheMagic, sizeof(kDiskCacheMagic)) != 0)
+            return std::nullopt;
+        return std::make_tuple(static_cast<int>(header.width), static_cast<int>(header.height),
+                               static_cast<int>(header.channels));
+    }
+
+    void DiskImageCache::store_info(const std::filesystem::path& source, int width, int height, int channels) const {
+        if (const auto path = entry_path(source, "info", ".info")) {
+            write_entry(*path, width, height, channels, nullptr, 0);
+        }
     }
 
 } // namespace image_io
@@ -0,0 +1,316 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/image_io.hpp"
+#include "core/logger.hpp"
+
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef GS_HAS_NVJPEG
+#include <nvjpeg.h>
+#endif
+
+namespace {
+
+    bool is_jpeg(const std::filesystem::path& p) {
+        std::string ext = p.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char ch) { return std::tolower(ch); });
+        return ext == ".jpg" || ext == ".jpeg";
+    }
+
+    // Same output size rules as load_image: res_div of 2/4/8 first, then clamp the long side to max_width
+    std::pair<int, int> target_size(int w, int h, int res_div, int max_width) {
+        if (res_div == 2 || res_div == 4 || res_div == 8) {
+            w = std::max(1, w / res_div);
+            h = std::max(1, h / res_div);
+        }
+        if (max_width > 0 && (w > max_width || h > max_width)) {
+            if (w > h) {
+                h = std::max(1, max_width * h / w);
+                w = max_width;
+            } else {
+                w = std::max(1, max_width * w / h);
+                h = max_width;
+            }
+        }
+        return {w, h};
+    }
+
+    // Blocking upload of a load_image-style buffer to [3, H, W], takes ownership of data
+    torch::Tensor upload_to_cuda(const std::tuple<unsigned char*, int, int, int>& image) {
+        const auto [data, w, h, c] = image;
+        std::unique_ptr<unsigned char, void (*)(unsigned char*)> guard(data, free_image);
+        return torch::from_blob(data, {h, w, c}, torch::TensorOptions().dtype(torch::kUInt8))
+            .to(torch::kCUDA)
+            .permute({2, 0, 1})
+            .contiguous();
+    }
+
+#ifdef GS_HAS_NVJPEG
+
+    void check_nvjpeg(nvjpegStatus_t status, const char* what, const std::filesystem::path& p) {
+        if (status != NVJPEG_STATUS_SUCCESS) {
+            throw std::runtime_error(std::string(what) + " failed (" + std::to_string(static_cast<int>(status)) +
+                                     "): " + p.string());
+        }
+    }
+
+    // nvJPEG decode state is not thread-safe, every decoding thread gets its own
+    struct NvjpegContext {
+        nvjpegHandle_t handle = nullptr;
+        nvjpegJpegState_t state = nullptr;
+
+        NvjpegContext() {
+            if (nvjpegCreateSimple(&handle) != NVJPEG_STATUS_SUCCESS) {
+                handle = nullptr;
+                return;
+            }
+            if (nvjpegJpegStateCreate(handle, &state) != NVJPEG_STATUS_SUCCESS) {
+                nvjpegDestroy(handle);
+                handle = nullptr;
+                state = nullptr;
+            }
+        }
+
+        ~NvjpegContext() {
+            if (state) {
+                nvjpegJpegStateDestroy(state);
+            }
+            if (handle) {
+                nvjpegDestroy(handle);
+            }
+        }
+
+        NvjpegContext(const NvjpegContext&) = delete;
+        NvjpegContext& operator=(const NvjpegContext&) = delete;
+
+        bool valid() const { return handle != nullptr; }
+    };
+
+    NvjpegContext& nvjpeg_context() {
+        thread_local NvjpegContext ctx;
+        return ctx;
+    }
+
+    // Reads p itself unless its contents were read ahead
+    torch::Tensor decode_jpeg_cuda(const std::filesystem::path& p, std::span<const unsigned char> encoded,
+                                   int res_div, int max_width) {
+        std::vector<unsigned char> file_bytes;
+        if (encoded.empty()) {
+            std::ifstream file(p, std::ios::binary | std::ios::ate);
+            if (!file) {
+                throw std::runtime_error("Load failed: " + p.string());
+            }
+            file_bytes.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            if (!file.read(reinterpret_cast<char*>(file_bytes.data()), static_cast<std::streamsize>(file_bytes.size()))) {
+                throw std::runtime_error("Read failed: " + p.string());
+            }
+            encoded = file_bytes;
+        }
+
+        auto& ctx = nvjpeg_context();
+
+        int num_components = 0;
+        nvjpegChromaSubsampling_t subsampling;
+        int widths[NVJPEG_MAX_COMPONENT] = {};
+        int heights[NVJPEG_MAX_COMPONENT] = {};
+        check_nvjpeg(nvjpegGetImageInfo(ctx.handle, encoded.data(), encoded.size(),
+                                        &num_components, &subsampling, widths, heights),
+                     "nvjpegGetImageInfo", p);
+        const int w = widths[0];
+        const int h = heights[0];
+
+        // Planar RGB output lands directly in the [3, H, W] training layout
+        auto decoded = torch::empty({3, h, w}, torch::TensorOptions().dtype(torch::kUInt8).device(torch::kCUDA));
+        nvjpegImage_t planes{};
+        for (int ch = 0; ch < 3; ++ch) {
+            planes.channel[ch] = decoded[ch].data_ptr<unsigned char>();
+            planes.pitch[ch] = static_cast<size_t>(w);
+        }
+
+        const cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+        check_nvjpeg(nvjpegDecode(ctx.handle, ctx.state, encoded.data(), encoded.size(),
+                                  NVJPEG_OUTPUT_RGB, &planes, stream),
+                     "nvjpegDecode", p);
+
+        const auto [tw, th] = target_size(w, h, res_div, max_width);
+        if (tw == w && th == h) {
+            return decoded;
+        }
+
+        // Antialiased bilinear stands in for OIIO's resample on the CPU path
+        auto resized = torch::nn::functional::interpolate(
+            decoded.unsqueeze(0).to(torch::kFloat32),
+            torch::nn::functional::InterpolateFuncOptions()
+                .size(std::vector<int64_t>{th, tw})
+                .mode(torch::kBilinear)
+                .align_corners(false)
+                .antialias(true));
+        return resized.squeeze(0).round_().clamp_(0, 255).to(torch::kUInt8);
+    }
+
+    // Encoder state is per thread like the decoder's, the saver's workers each get one
+    struct NvjpegEncoder {
+        nvjpegHandle_t handle = nullptr;
+        nvjpegEncoderState_t state = nullptr;
+        nvjpegEncoderParams_t params = nullptr;
+        int quality = -1;
+
+        NvjpegEncoder() {
+            if (nvjpegCreateSimple(&handle) != NVJPEG_STATUS_SUCCESS) {
+                handle = nullptr;
+                return;
+            }
+            if (nvjpegEncoderStateCreate(handle, &state, nullptr) != NVJPEG_STATUS_SUCCESS ||
+                nvjpegEncoderParamsCreate(handle, &params, nullptr) != NVJPEG_STATUS_SUCCESS ||
+                nvjpegEncoderParamsSetSamplingFactors(params, NVJPEG_CSS_420, nullptr) != NVJPEG_STATUS_SUCCESS) {
+                release();
+            }
+        }
+
+        ~NvjpegEncoder() { release(); }
+
+        NvjpegEncoder(const NvjpegEncoder&) = delete;
+        NvjpegEncoder& operator=(const NvjpegEncoder&) = delete;
+
+        bool valid() const { return handle != nullptr; }
+
+    private:
+        void release() {
+            if (params) {
+                nvjpegEncoderParamsDestroy(params);
+            }
+            if (state) {
+                nvjpegEncoderStateDestroy(state);
+            }
+            if (handle) {
+                nvjpegDestroy(handle);
+            }
+            handle = nullptr;
+            state = nullptr;
+            params = nullptr;
+        }
+    };
+
+    NvjpegEncoder& nvjpeg_encoder() {
+        thread_local NvjpegEncoder encoder;
+        return encoder;
+    }
+
+    // Interleaved RGB in, 4:2:0 like the OIIO path. The bitstream retrieval waits for the stream.
+    std::vector<unsigned char> encode_jpeg_cuda(const torch::Tensor& hwc, cudaStream_t stream, int quality,
+                                                const std::filesystem::path& p) {
+        auto& enc = nvjpeg_encoder();
+        if (enc.quality != quality) {
+            check_nvjpeg(nvjpegEncoderParamsSetQuality(enc.params, quality, stream), "nvjpegEncoderParamsSetQuality", p);
+            enc.quality = quality;
+        }
+
+        nvjpegImage_t source{};
+        source.channel[0] = hwc.data_ptr<unsigned char>();
+        source.pitch[0] = static_cast<size_t>(hwc.size(1)) * 3;
+        check_nvjpeg(nvjpegEncodeImage(enc.handle, enc.state, enc.params, &source, NVJPEG_INPUT_RGBI,
+                                       static_cast<int>(hwc.size(1)), static_cast<int>(hwc.size(0)), stream),
+                     "nvjpegEncodeImage", p);
+
+        size_t length = 0;
+        check_nvjpeg(nvjpegEncodeRetrieveBitstream(enc.handle, enc.state, nullptr, &length, stream),
+                     "nvjpegEncodeRetrieveBitstream", p);
+        std::vector<unsigned char> bytes(length);
+        check_nvjpeg(nvjpegEncodeRetrieveBitstream(enc.handle, enc.state, bytes.data(), &length, stream),
+                     "nvjpegEncodeRetrieveBitstream", p);
+        bytes.resize(length);
+        return bytes;
+    }
+
+#endif
+
+} // namespace
+
+bool gpu_image_decode_available() {
+#ifdef GS_HAS_NVJPEG
+    return nvjpeg_context().valid();
+#else
+    return false;
+#endif
+}
+
+bool gpu_image_encode_available() {
+#ifdef GS_HAS_NVJPEG
+    return nvjpeg_encoder().valid();
+#else
+    return false;
+#endif
+}
+
+bool save_jpeg_cuda(const std::filesystem::path& path, const torch::Tensor& hwc, cudaEvent_t ready, int quality) {
+#ifdef GS_HAS_NVJPEG
+    if (!hwc.is_cuda() || hwc.dim() != 3 || hwc.size(2) != 3 || hwc.scalar_type() != torch::kUInt8 ||
+        !hwc.is_contiguous() || !nvjpeg_encoder().valid()) {
+        return false;
+    }
+
+    std::vector<unsigned char> bytes;
+    try {
+        const c10::cuda::CUDAGuard guard(hwc.device());
+        const cudaStream_t stream = c10::cuda::getStreamFromPool(false, hwc.device().index());
+        if (ready) {
+            cudaStreamWaitEvent(stream, ready, 0);
+        }
+        bytes = encode_jpeg_cuda(hwc, stream, quality, path);
+    } catch (const std::exception& e) {
+        LOG_DEBUG("GPU encode fell back to CPU: {}", e.what());
+        return false;
+    }
+
+    LOG_INFO("Saving image: {} shape: [{}, {}, 3] (nvJPEG)", path.string(), hwc.size(0), hwc.size(1));
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+        throw std::runtime_error("Write failed: " + path.string());
+    }
+    return true;
+#else
+    (void)path;
+    (void)hwc;
+    (void)ready;
+    (void)quality;
+    return false;
+#endif
+}
+
+torch::Tensor load_image_cuda(std::filesystem::path p, int res_div, int max_width) {
+    return load_image_cuda(std::move(p), {}, res_div, max_width);
+}
+
+torch::Tensor load_image_cuda(std::filesystem::path p, std::span<const unsigned char> encoded, int res_div, int max_width) {
+    const auto& disk_cache = image_io::DiskImageCache::instance();
+    if (disk_cache.is_enabled()) {
+        // A raw cached entry beats any decode
+        if (auto cached = disk_cache.load(p, res_div, max_width)) {
+            return upload_to_cuda(*cached);
+        }
+    }
+
+#ifdef GS_HAS_NVJPEG
+    if (is_jpeg(p) && nvjpeg_context().valid()) {
+        try {
+            return decode_jpeg_cuda(p, encoded, res_div, max_width);
+        } catch (const std::exception& e) {
+            // Unsupported encodings (e.g. some CMYK or lossless JPEGs) still decode on the CPU
+            LOG_DEBUG("GPU decode fell back to CPU: {}", e.what());
+        }
+    }
+#endif
+    return load_image_pinned(p, encoded, res_div, max_width).to(torch::kCUDA).permute({2, 0, 1}).contiguous();
+}
@@ -0,0 +1,97 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/logger.hpp"
+
+namespace gs::core {
+
+    namespace detail {
+
+        AsyncLogQueue::AsyncLogQueue(std::shared_ptr<spdlog::logger> logger)
+            : logger_(std::move(logger)),
+              slots_(std::make_unique<LogRecord[]>(CAPACITY)) {
+            for (size_t i = 0; i < CAPACITY; ++i) {
+                slots_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            worker_ = std::thread([this] { run(); });
+        }
+
+        AsyncLogQueue::~AsyncLogQueue() {
+            running_.store(false, std::memory_order_release);
+            if (worker_.joinable()) {
+                worker_.join();
+            }
+            // Records claimed after the worker stopped are never written
+            for (size_t i = 0; i < CAPACITY; ++i) {
+                delete slots_[i].spilled;
+            }
+        }
+
+        bool AsyncLogQueue::write_next(std::string& message) {
+            LogRecord& record = slots_[head_ & (CAPACITY - 1)];
+            if (record.sequence.load(std::memory_order_acquire) != head_ + 1) {
+                return false;
+            }
+
+            std::string_view text;
+            if (record.format) {
+                record.format(record, message);
+                text = message;
+            } else if (record.spilled) {
+                text = *record.spilled;
+            } else {
+                text = {reinterpret_cast<const char*>(record.payload), record.length};
+            }
+            logger_->log(record.time, record.loc, record.level, spdlog::string_view_t(text.data(), text.size()));
+
+            delete record.spilled;
+            record.spilled = nullptr;
+            record.format = nullptr;
+            record.sequence.store(head_ + CAPACITY, std::memory_order_release);
+            ++head_;
+            consumed_.store(head_, std::memory_order_release);
+            return true;
+        }
+
+        void AsyncLogQueue::run() {
+            std::string message;
+            uint64_t reported_drops = 0;
+            while (true) {
+                // Read before draining, so whatever was enqueued before the stop is written
+                const bool stopping = !running_.load(std::memory_order_acquire);
+                size_t written = 0;
+                while (write_next(message)) {
+                    ++written;
+                }
+
+                if (const uint64_t dropped = dropped_.load(std::memory_order_relaxed); dropped != reported_drops) {
+                    logger_->log(spdlog::level::warn, "{} log messages dropped, the async log queue was full",
+                                 dropped - reported_drops);
+                    reported_drops = dropped;
+                }
+
+                if (written == 0) {
+                    if (stopping) {
+                        break;
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+            logger_->flush();
+        }
+
+        void AsyncLogQueue::wait_drained() const {
+            const size_t target = tail_.load(std::memory_order_acquire);
+            while (consumed_.load(std::memory_order_acquire) < target) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+
+    } // namespace detail
+
+    Logger::~Logger() {
+        stop_async();
+    }
+
+} // namespace gs::core
@@ -96,10 +96,70 @@ namespace gs {
                     {"init_opacity", defaults.init_opacity, "Initial opacity value for new Gaussians"},
                     {"init_scaling", defaults.init_scaling, "Initial scaling value for new Gaussians"},
                     {"sh_degree", defaults.sh_degree, "Spherical harmonics degree"},
-                    {"num_workers", defaults.num_workers, "Number of image loader threads"},
-                    {"max_cap", defaults.max_cap, "Maximum number of Gaussians for MCMC strategy"},
+                    {"num_workers", defaults.num_workers, "Number of image loader threads (0 = autotuned)"},
+                    {"cpu_threads", defaults.cpu_threads, "CPU thread budget shared by loader workers and image decoding (0 = unbudgeted)"},
+                    {"pin_threads", defaults.pin_threads, "Pin worker threads to the CPUs of the training GPU's NUMA node"},
+                    {"dataloader", defaults.dataloader, "Training dataloader backend: efficient, libtorch"},
+                    {"preload_to_ram", defaults.preload_to_ram, "Decode all training images into RAM at startup"},
+                    {"preload_max_mb", defaults.preload_max_mb, "RAM budget in MB for preloaded images (0 = none preloaded, -1 = unlimited)"},
+                    {"preload_to_vram", defaults.preload_to_vram, "Keep all ground-truth images resident in VRAM"},
+                    {"shared_image_cache", defaults.shared_image_cache, "Directory of preloaded images shared by concurrent runs"},
+                    {"gpu_decode", defaults.gpu_decode, "Decode JPEG images on the GPU with nvJPEG"},
+                    {"read_ahead", defaults.read_ahead, "Encoded images read into memory ahead of the decode (0 = off)"},
+                    {"read_ahead_mirror", defaults.read_ahead_mirror, "Local directory keeping copies of the images read ahead"},
+                    {"disk_image_cache", defaults.disk_image_cache, "Cache decoded and resized images on disk"},
+                    {"disk_image_cache_dir", defaults.disk_image_cache_dir, "Directory for the disk image cache"},
+                    {"checkpoint_every", defaults.checkpoint_every, "Write a resumable checkpoint every N iterations (0 = save steps only)"},
+                    {"early_stop_window", defaults.early_stop_window, "Iterations between train loss plateau checks once refinement stopped (0 = train all iterations)"},
+                    {"early_stop_threshold", defaults.early_stop_threshold, "Relative gain of the train loss average over a window below which training ends early"},
+                    {"fine_tune_iterations", defaults.fine_tune_iterations, "Iterations of a run warm-started from an existing model, the schedule is rescaled to them (0 = full schedule)"},
+                    {"sync_free_step", defaults.sync_free_step, "Single backward per step and asynchronous loss readback"},
+                    {"seed", defaults.seed, "Seed of every random number generator of the run (-1 = random)"},
+                    {"deterministic", defaults.deterministic, "Use deterministic torch algorithms"},
+                    {"fused_loss", defaults.fused_loss, "Fused L1 + D-SSIM photometric loss kernel that also composites the background"},
+                    {"async_eval", defaults.async_eval, "Evaluate a snapshot of the model in the background while training continues"},
+                    {"eval_views", defaults.eval_views, "Validation views compared by intermediate evaluations, a fixed random subset (0 = all)"},
+                    {"eval_downscale", defaults.eval_downscale, "Resolution divisor of intermediate evaluations, the final evaluation is at full resolution"},
+                    {"upper_bound_allocation", defaults.upper_bound_allocation, "Size rasterizer buffers from the previous step instead of reading counts back"},
+                    {"spatial_index", defaults.spatial_index, "Skip Morton-ordered chunks of Gaussians outside the view frustum"},
+                    {"instance_stats", defaults.instance_stats, "Report how many tile instances the exact ellipse-tile test saves"},
+                    {"load_balanced_blend", defaults.load_balanced_blend, "Blend tiles with many instances in segments on several blocks"},
+                    {"sparse_adam", defaults.sparse_adam, "Update only the Gaussians rendered this step in Adam"},
+                    {"gut_packed", defaults.gut_packed, "Packed GUT rasterization over the projected Gaussians only"},
+                    {"densify_budget", defaults.densify_budget, "Limit default strategy densification to max_cap and densify_vram_mb"},
+                    {"densify_vram_mb", defaults.densify_vram_mb, "VRAM ceiling in MB for densify_budget (0 = 90% of the device memory)"},
+                    {"vram_budget_mb", defaults.vram_budget_mb, "Reserved VRAM in MB before the CUDA cache is trimmed (0 = 90% of the device memory)"},
+                    {"bucket_state_budget_mb", defaults.bucket_state_budget_mb, "Blend states in MB a forward keeps for the backward, larger ones are recomputed (0 = no limit)"},
+                    {"cuda_allocator", defaults.cuda_allocator, "CUDA allocator backend: native, async (cudaMallocAsync)"},
+                    {"means_update_every", defaults.means_update_every, "Iterations between means updates"},
+                    {"sh0_update_every", defaults.sh0_update_every, "Iterations between sh0 updates"},
+                    {"shN_update_every", defaults.shN_update_every, "Iterations between shN updates"},
+                    {"scaling_update_every", defaults.scaling_update_every, "Iterations between scaling updates"},
+                    {"rotation_update_every", defaults.rotation_update_every, "Iterations between rotation updates"},
+                    {"opacity_update_every", defaults.opacity_update_every, "Iterations between opacity updates"},
+                    {"update_every_until", defaults.update_every_until, "Last iteration of the *_update_every schedule, every group updates afterwards"},
+                    {"views_per_step", defaults.views_per_step, "Cameras rendered per training step before one optimizer update"},
+                    {"progressive_resolution", defaults.progressive_resolution, "Train at 1/4, then 1/2 resolution during the first N iterations (0 = off)"},
+                    {"crop_size", defaults.crop_size, "Side of the random square crop every training view is rendered at (0 = full image)"},
+                    {"importance_sampling", defaults.importance_sampling, "Draw training views in proportion to their recent photometric loss"},
+                    {"importance_sampling_floor", defaults.importance_sampling_floor, "Share of importance-sampled draws that stay uniform, so every view is still visited"},
+                    {"sh_precision", defaults.sh_precision, "Storage precision of higher-order SH coefficients: float32, float16, bfloat16"},
+                    {"sh_codebook_iteration", defaults.sh_codebook_iteration, "Iteration from which shN is trained as a k-means palette indexed per Gaussian (0 = off)"},
+                    {"sh_codebook_size", defaults.sh_codebook_size, "Number of palette entries of the SH codebook"},
+                    {"sh_basis_iteration", defaults.sh_basis_iteration, "Iteration from which shN is trained as per-Gaussian weights of a shared low-rank basis (0 = off)"},
+                    {"sh_basis_rank", defaults.sh_basis_rank, "Number of basis vectors of the low-rank SH model"},
+                    {"progressive_sh", defaults.progressive_sh, "Allocate each SH band of shN and its optimizer moments only when the band activates"},
+                    {"tile_shape", defaults.tile_shape, "Rasterizer tile shape: 16x16, 8x8, 32x8, auto"},
+                    {"viewer_snapshot_every", defaults.viewer_snapshot_every, "Iterations between the model copies the viewer renders (0 = render the live model)"},
+                    {"prioritize_training", defaults.prioritize_training, "Run training on a high-priority CUDA stream so viewer rendering only takes idle SMs"},
+                    {"telemetry_output", defaults.telemetry_output, "File or unix:<socket> the per-iteration training stats stream to (empty = off)"},
+                    {"telemetry_format", defaults.telemetry_format, "Telemetry stream encoding: csv, binary"},
+                    {"profile_zones_every", defaults.profile_zones_every, "Iterations the logged GPU time breakdown of the profiling zones averages over (0 = off)"},
+                    {"trace_output", defaults.trace_output, "Chrome trace JSON file of the host thread and GPU spans (empty = off)"},
+                    {"trace_capacity", defaults.trace_capacity, "Newest spans the trace ring buffer keeps"},
+                    {"max_cap", defaults.max_cap, "Maximum number of Gaussians for the MCMC and taming strategies (and the default strategy with densify_budget)"},
                     {"render_mode", defaults.render_mode, "Render mode: RGB, D, ED, RGB_D, RGB_ED"},
-                    {"strategy", defaults.strategy, "Optimization strategy: mcmc, default"},
+                    {"strategy", defaults.strategy, "Optimization strategy: mcmc, default, taming"},
                     {"pose_optimization", defaults.pose_optimization, "Pose optimization type: none, direct, mlp"},
                     {"enable_eval", defaults.enable_eval, "Enable evaluation during training"},
                     {"enable_save_eval_images", defaults.enable_save_eval_images, "Save images during evaluation"},
@@ -109,12 +169,14 @@ namespace gs {
                     {"bilateral_grid_Y", defaults.bilateral_grid_Y, "Bilateral grid Y dimension"},
                     {"bilateral_grid_W", defaults.bilateral_grid_W, "Bilateral grid W dimension"},
                     {"bilateral_grid_lr", defaults.bilateral_grid_lr, "Learning rate for bilateral grid"},
+                    {"bilateral_grid_precision", defaults.bilateral_grid_precision, "Storage precision of the per-image bilateral grids: float32, float16, bfloat16"},
                     {"tv_loss_weight", defaults.tv_loss_weight, "Weight for total variation loss"},
                     {"prune_opacity", defaults.prune_opacity, "Opacity pruning threshold"},
                     {"grow_scale3d", defaults.grow_scale3d, "3D scale threshold for duplication"},
                     {"grow_scale2d", defaults.grow_scale2d, "2D scale threshold for splitting"},
                     {"prune_scale3d", defaults.prune_scale3d, "3D scale threshold for pruning"},
                     {"prune_scale2d", defaults.prune_scale2d, "2D scale threshold for pruning"},
+                    {"prune_contribution", defaults.prune_contribution, "Prune (MCMC: relocate) Gaussians whose blending weight stayed below this in every pixel since the last refinement (0 = off)"},
                     {"reset_every", defaults.reset_every, "Reset opacity every this many iterations"},
                     {"pause_refine_after_reset", defaults.pause_refine_after_reset, "Pause refinement after reset for N iterations"},
                     {"revised_opacity", defaults.revised_opacity, "Use revised opacity heuristic"},
@@ -130,7 +192,13 @@ namespace gs {
                     {"prune_ratio", defaults.prune_ratio, "Final pruning ratio for sparsity"},
                     {"init_extent", defaults.init_extent, "Extent of random initialization"},
                     {"save_sog", defaults.save_sog, "Save in SOG format alongside PLY"},
-                    {"sog_iterations", defaults.sog_iterations, "K-means iterations for SOG compression"}};
+                    {"sog_iterations", defaults.sog_iterations, "K-means iterations for SOG compression"},
+                    {"sog_webp_level", defaults.sog_webp_level, "Lossless WebP effort of the SOG textures, 0 (fastest) to 9 (smallest)"},
+                    {"sog_qat_iteration", defaults.sog_qat_iteration, "Iteration from which the forward renders straight-through SOG-quantized attributes (0 = off)"},
+                    {"save_lod", defaults.save_lod, "Save a chunked level-of-detail .lfslod file alongside PLY"},
+                    {"save_delta", defaults.save_delta, "Store intermediate saves as .lfsdelta files holding only the changes since the previous save"},
+                    {"morton_order", defaults.morton_order, "Keep the Gaussians Morton-sorted after refinement and in saved PLY/SOG files"},
+                    {"ply_direct_io", defaults.ply_direct_io, "Write PLY vertex data with O_DIRECT, bypassing the page cache (Linux only)"}};
 
                 // Check all expected parameters
                 for (const auto& param : expected_params) {
@@ -251,6 +319,66 @@ namespace gs {
             opt_json["init_opacity"] = init_opacity;
             opt_json["init_scaling"] = init_scaling;
             opt_json["num_workers"] = num_workers;
+            opt_json["cpu_threads"] = cpu_threads;
+            opt_json["pin_threads"] = pin_threads;
+            opt_json["dataloader"] = dataloader;
+            opt_json["preload_to_ram"] = preload_to_ram;
+            opt_json["preload_max_mb"] = preload_max_mb;
+            opt_json["preload_to_vram"] = preload_to_vram;
+            opt_json["shared_image_cache"] = shared_image_cache;
+            opt_json["gpu_decode"] = gpu_decode;
+            opt_json["read_ahead"] = read_ahead;
+            opt_json["read_ahead_mirror"] = read_ahead_mirror;
+            opt_json["disk_image_cache"] = disk_image_cache;
+            opt_json["disk_image_cache_dir"] = disk_image_cache_dir;
+            opt_json["checkpoint_every"] = checkpoint_every;
+            opt_json["early_stop_window"] = early_stop_window;
+            opt_json["early_stop_threshold"] = early_stop_threshold;
+            opt_json["fine_tune_iterations"] = fine_tune_iterations;
+            opt_json["sync_free_step"] = sync_free_step;
+            opt_json["seed"] = seed;
+            opt_json["deterministic"] = deterministic;
+            opt_json["fused_loss"] = fused_loss;
+            opt_json["async_eval"] = async_eval;
+            opt_json["eval_views"] = eval_views;
+            opt_json["eval_downscale"] = eval_downscale;
+            opt_json["upper_bound_allocation"] = upper_bound_allocation;
+            opt_json["spatial_index"] = spatial_index;
+            opt_json["instance_stats"] = instance_stats;
+            opt_json["load_balanced_blend"] = load_balanced_blend;
+            opt_json["sparse_adam"] = sparse_adam;
+            opt_json["gut_packed"] = gut_packed;
+            opt_json["densify_budget"] = densify_budget;
+            opt_json["densify_vram_mb"] = densify_vram_mb;
+            opt_json["vram_budget_mb"] = vram_budget_mb;
+            opt_json["bucket_state_budget_mb"] = bucket_state_budget_mb;
+            opt_json["cuda_allocator"] = cuda_allocator;
+            opt_json["means_update_every"] = means_update_every;
+            opt_json["sh0_update_every"] = sh0_update_every;
+            opt_json["shN_update_every"] = shN_update_every;
+            opt_json["scaling_update_every"] = scaling_update_every;
+            opt_json["rotation_update_every"] = rotation_update_every;
+            opt_json["opacity_update_every"] = opacity_update_every;
+            opt_json["update_every_until"] = update_every_until;
+            opt_json["views_per_step"] = views_per_step;
+            opt_json["progressive_resolution"] = progressive_resolution;
+            opt_json["crop_size"] = crop_size;
+            opt_json["importance_sampling"] = importance_sampling;
+            opt_json["importance_sampling_floor"] = importance_sampling_floor;
+            opt_json["sh_precision"] = sh_precision;
+            opt_json["sh_codebook_iteration"] = sh_codebook_iteration;
+            opt_json["sh_codebook_size"] = sh_codebook_size;
+            opt_json["sh_basis_iteration"] = sh_basis_iteration;
+            opt_json["sh_basis_rank"] = sh_basis_rank;
+            opt_json["progressive_sh"] = progressive_sh;
+            opt_json["tile_shape"] = tile_shape;
+            opt_json["viewer_snapshot_every"] = viewer_snapshot_every;
+            opt_json["prioritize_training"] = prioritize_training;
+            opt_json["telemetry_output"] = telemetry_output;
+            opt_json["telemetry_format"] = telemetry_format;
+            opt_json["profile_zones_every"] = profile_zones_every;
+            opt_json["trace_output"] = trace_output;
+            opt_json["trace_capacity"] = trace_capacity;
             opt_json["max_cap"] = max_cap;
             opt_json["render_mode"] = render_mode;
             opt_json["pose_optimization"] = pose_optimization;
@@ -265,12 +393,14 @@ namespace gs {
             opt_json["bilateral_grid_Y"] = bilateral_grid_Y;
             opt_json["bilateral_grid_W"] = bilateral_grid_W;
             opt_json["bilateral_grid_lr"] = bilateral_grid_lr;
+            opt_json["bilateral_grid_precision"] = bilateral_grid_precision;
             opt_json["tv_loss_weight"] = tv_loss_weight;
             opt_json["prune_opacity"] = prune_opacity;
             opt_json["grow_scale3d"] = grow_scale3d;
             opt_json["grow_scale2d"] = grow_scale2d;
             opt_json["prune_scale3d"] = prune_scale3d;
             opt_json["prune_scale2d"] = prune_scale2d;
+            opt_json["prune_contribution"] = prune_contribution;
             opt_json["reset_every"] = reset_every;
             opt_json["pause_refine_after_reset"] = pause_refine_after_reset;
             opt_json["revised_opacity"] = revised_opacity;
@@ -282,6 +412,12 @@ namespace gs {
             opt_json["init_extent"] = init_extent;
             opt_json["save_sog"] = save_sog;
             opt_json["sog_iterations"] = sog_iterations;
+            opt_json["sog_webp_level"] = sog_webp_level;
+            opt_json["sog_qat_iteration"] = sog_qat_iteration;
+            opt_json["save_lod"] = save_lod;
+            opt_json["save_delta"] = save_delta;
+            opt_json["morton_order"] = morton_order;
+            opt_json["ply_direct_io"] = ply_direct_io;
             opt_json["enable_sparsity"] = enable_sparsity;
             opt_json["sparsify_steps"] = sparsify_steps;
             opt_json["init_rho"] = init_rho;
@@ -322,10 +458,216 @@ namespace gs {
             if (json.contains("num_workers")) {
                 params.num_workers = json["num_workers"];
             }
+            if (json.contains("cpu_threads")) {
+                params.cpu_threads = json["cpu_threads"];
+            }
+            if (json.contains("pin_threads")) {
+                params.pin_threads = json["pin_threads"];
+            }
             if (json.contains("max_cap")) {
                 params.max_cap = json["max_cap"];
             }
 
+            if (json.contains("dataloader")) {
+                std::string dataloader = json["dataloader"];
+                if (dataloader == "efficient" || dataloader == "libtorch") {
+                    params.dataloader = dataloader;
+                } else {
+                    std::println(stderr, "Warning: Invalid dataloader '{}' in JSON. Using default 'efficient'", dataloader);
+                }
+            }
+            if (json.contains("preload_to_ram")) {
+                params.preload_to_ram = json["preload_to_ram"];
+            }
+            if (json.contains("preload_max_mb")) {
+                const int preload_max_mb = json["preload_max_mb"];
+                if (preload_max_mb >= -1) {
+                    params.preload_max_mb = preload_max_mb;
+                } else {
+                    std::println(stderr, "Warning: Invalid preload_max_mb {} in JSON. Using default {}", preload_max_mb, params.preload_max_mb);
+                }
+            }
+            if (json.contains("preload_to_vram")) {
+                params.preload_to_vram = json["preload_to_vram"];
+            }
+            if (json.contains("shared_image_cache")) {
+                params.shared_image_cache = json["shared_image_cache"];
+            }
+            if (json.contains("gpu_decode")) {
+                params.gpu_decode = json["gpu_decode"];
+            }
+            if (json.contains("read_ahead")) {
+                params.read_ahead = json["read_ahead"];
+            }
+            if (json.contains("read_ahead_mirror")) {
+                params.read_ahead_mirror = json["read_ahead_mirror"];
+            }
+            if (json.contains("disk_image_cache")) {
+                params.disk_image_cache = json["disk_image_cache"];
+            }
+            if (json.contains("disk_image_cache_dir")) {
+                params.disk_image_cache_dir = json["disk_image_cache_dir"];
+            }
+            if (json.contains("checkpoint_every")) {
+                params.checkpoint_every = json["checkpoint_every"];
+            }
+            if (json.contains("early_stop_window")) {
+                params.early_stop_window = json["early_stop_window"];
+            }
+            if (json.contains("early_stop_threshold")) {
+                params.early_stop_threshold = json["early_stop_threshold"];
+            }
+            if (json.contains("fine_tune_iterations")) {
+                params.fine_tune_iterations = json["fine_tune_iterations"];
+            }
+            if (json.contains("sync_free_step")) {
+                params.sync_free_step = json["sync_free_step"];
+            }
+            if (json.contains("seed")) {
+                params.seed = json["seed"];
+            }
+            if (json.contains("deterministic")) {
+                params.deterministic = json["deterministic"];
+            }
+            if (json.contains("fused_loss")) {
+                params.fused_loss = json["fused_loss"];
+            }
+            if (json.contains("async_eval")) {
+                params.async_eval = json["async_eval"];
+            }
+            if (json.contains("eval_views")) {
+                params.eval_views = json["eval_views"];
+            }
+            if (json.contains("eval_downscale")) {
+                params.eval_downscale = json["eval_downscale"];
+            }
+            if (json.contains("upper_bound_allocation")) {
+                params.upper_bound_allocation = json["upper_bound_allocation"];
+            }
+            if (json.contains("spatial_index")) {
+                params.spatial_index = json["spatial_index"];
+            }
+            if (json.contains("instance_stats")) {
+                params.instance_stats = json["instance_stats"];
+            }
+            if (json.contains("load_balanced_blend")) {
+                params.load_balanced_blend = json["load_balanced_blend"];
+            }
+            if (json.contains("sparse_adam")) {
+                params.sparse_adam = json["sparse_adam"];
+            }
+            if (json.contains("gut_packed")) {
+                params.gut_packed = json["gut_packed"];
+            }
+            if (json.contains("densify_budget")) {
+                params.densify_budget = json["densify_budget"];
+            }
+            if (json.contains("densify_vram_mb")) {
+                params.densify_vram_mb = json["densify_vram_mb"];
+            }
+            if (json.contains("vram_budget_mb")) {
+                params.vram_budget_mb = json["vram_budget_mb"];
+            }
+            if (json.contains("bucket_state_budget_mb")) {
+                params.bucket_state_budget_mb = json["bucket_state_budget_mb"];
+            }
+            if (json.contains("cuda_allocator")) {
+                params.cuda_allocator = json["cuda_allocator"];
+            }
+            if (json.contains("means_update_every")) {
+                params.means_update_every = json["means_update_every"];
+            }
+            if (json.contains("sh0_update_every")) {
+                params.sh0_update_every = json["sh0_update_every"];
+            }
+            if (json.contains("shN_update_every")) {
+                params.shN_update_every = json["shN_update_every"];
+            }
+            if (json.contains("scaling_update_every")) {
+                params.scaling_update_every = json["scaling_update_every"];
+            }
+            if (json.contains("rotation_update_every")) {
+                params.rotation_update_every = json["rotation_update_every"];
+            }
+            if (json.contains("opacity_update_every")) {
+                params.opacity_update_every = json["opacity_update_every"];
+            }
+            if (json.contains("update_every_until")) {
+                params.update_every_until = json["update_every_until"];
+            }
+            if (json.contains("views_per_step")) {
+                params.views_per_step = json["views_per_step"];
+            }
+            if (json.contains("progressive_resolution")) {
+                params.progressive_resolution = json["progressive_resolution"];
+            }
+            if (json.contains("crop_size")) {
+                params.crop_size = json["crop_size"];
+            }
+            if (json.contains("importance_sampling")) {
+                params.importance_sampling = json["importance_sampling"];
+            }
+            if (json.contains("importance_sampling_floor")) {
+                params.importance_sampling_floor = json["importance_sampling_floor"];
+            }
+            if (json.contains("sh_precision")) {
+                std::string precision = json["sh_precision"];
+                if (precision == "float32" || precision == "float16" || precision == "bfloat16") {
+                    params.sh_precision = precision;
+                } else {
+                    std::println(stderr, "Warning: Invalid SH precision '{}' in JSON. Using default 'float32'", precision);
+                }
+            }
+            if (json.contains("sh_codebook_iteration")) {
+                params.sh_codebook_iteration = json["sh_codebook_iteration"];
+            }
+            if (json.contains("sh_codebook_size")) {
+                params.sh_codebook_size = json["sh_codebook_size"];
+            }
+            if (json.contains("sh_basis_iteration")) {
+                params.sh_basis_iteration = json["sh_basis_iteration"];
+            }
+            if (json.contains("sh_basis_rank")) {
+                params.sh_basis_rank = json["sh_basis_rank"];
+            }
+            if (json.contains("progressive_sh")) {
+                params.progressive_sh = json["progressive_sh"];
+            }
+            if (json.contains("tile_shape")) {
+                std::string shape = json["tile_shape"];
+                if (shape == "16x16" || shape == "8x8" || shape == "32x8" || shape == "auto") {
+                    params.tile_shape = shape;
+                } else {
+                    std::println(stderr, "Warning: Invalid tile shape '{}' in JSON. Using default '16x16'", shape);
+                }
+            }
+            if (json.contains("viewer_snapshot_every")) {
+                params.viewer_snapshot_every = json["viewer_snapshot_every"];
+            }
+            if (json.contains("prioritize_training")) {
+                params.prioritize_training = json["prioritize_training"];
+            }
+            if (json.contains("telemetry_output")) {
+                params.telemetry_output = json["telemetry_output"];
+            }
+            if (json.contains("telemetry_format")) {
+                std::string format = json["telemetry_format"];
+                if (format == "csv" || format == "binary") {
+                    params.telemetry_format = format;
+                } else {
+                    std::println(stderr, "Warning: Invalid telemetry format '{}' in JSON. Using default 'csv'", format);
+                }
+            }
+            if (json.contains("profile_zones_every")) {
+                params.profile_zones_every = json["profile_zones_every"];
+            }
+            if (json.contains("trace_output")) {
+                params.trace_output = json["trace_output"];
+            }
+            if (json.contains("trace_capacity")) {
+                params.trace_capacity = json["trace_capacity"];
+            }
+
             // Handle render mode
             if (json.contains("render_mode")) {
                 std::string mode = json["render_mode"];
@@ -349,7 +691,7 @@ namespace gs {
 
             if (json.contains("strategy")) {
                 std::string strategy = json["strategy"];
-                if (strategy == "mcmc" || strategy == "default") {
+                if (strategy == "mcmc" || strategy == "default" || strategy == "taming") {
                     params.strategy = strategy;
                 } else {
                     std::println(stderr, "Warning: Invalid optimization strategy '{}' in JSON. Using default 'default'", strategy);
@@ -394,6 +736,14 @@ namespace gs {
             if (json.contains("bilateral_grid_lr")) {
                 params.bilateral_grid_lr = json["bilateral_grid_lr"];
             }
+            if (json.contains("bilateral_grid_precision")) {
+                std::string precision = json["bilateral_grid_precision"];
+                if (precision == "float32" || precision == "float16" || precision == "bfloat16") {
+                    params.bilateral_grid_precision = precision;
+                } else {
+                    std::println(stderr, "Warning: Invalid bilateral grid precision '{}' in JSON. Using default 'float32'", precision);
+                }
+            }
             if (json.contains("tv_loss_weight")) {
                 params.tv_loss_weight = json["tv_loss_weight"];
             }
@@ -412,6 +762,9 @@ namespace gs {
             if (json.contains("prune_scale2d")) {
                 params.prune_scale2d = json["prune_scale2d"];
             }
+            if (json.contains("prune_contribution")) {
+                params.prune_contribution = json["prune_contribution"];
+            }
             if (json.contains("reset_every")) {
                 params.reset_every = json["reset_every"];
             }
@@ -445,6 +798,24 @@ namespace gs {
             if (json.contains("sog_iterations")) {
                 params.sog_iterations = json["sog_iterations"];
             }
+            if (json.contains("save_lod")) {
+                params.save_lod = json["save_lod"];
+            }
+            if (json.contains("save_delta")) {
+                params.save_delta = json["save_delta"];
+            }
+            if (json.contains("morton_order")) {
+                params.morton_order = json["morton_order"];
+            }
+            if (json.contains("ply_direct_io")) {
+                params.ply_direct_io = json["ply_direct_io"];
+            }
+            if (json.contains("sog_webp_level")) {
+                params.sog_webp_level = json["sog_webp_level"];
+            }
+            if (json.contains("sog_qat_iteration")) {
+                params.sog_qat_iteration = json["sog_qat_iteration"];
+            }
             if (json.contains("enable_sparsity")) {
                 params.enable_sparsity = json["enable_sparsity"];
             }
@@ -511,6 +882,7 @@ namespace gs {
                 json["dataset"]["resize_factor"] = params.dataset.resize_factor;
                 json["dataset"]["test_every"] = params.dataset.test_every;
                 json["dataset"]["max_width"] = params.dataset.max_width;
+                json["dataset"]["undistort"] = params.dataset.undistort;
 
                 // Optimization configuration
                 nlohmann::json opt_json = params.optimization.to_json();
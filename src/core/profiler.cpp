@@ -0,0 +1,213 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/profiler.hpp"
+#include "core/logger.hpp"
+#include <algorithm>
+#include <c10/cuda/CUDAStream.h>
+#include <cstring>
+#include <string>
+
+namespace gs::core {
+
+    Profiler& Profiler::get() {
+        static Profiler instance;
+        return instance;
+    }
+
+    Profiler::~Profiler() {
+        // The CUDA context may be gone at exit, the events die with it
+        if (enabled_.load()) {
+            return;
+        }
+        for (cudaEvent_t event : events_) {
+            cudaEventDestroy(event);
+        }
+    }
+
+    void Profiler::enable(int report_every, bool log) {
+        if (report_every > 0) {
+            if (enabled_.load()) {
+                report_every_ = report_every;
+                log_reports_ = log;
+                return;
+            }
+            report_every_ = report_every;
+            log_reports_ = log;
+            totals_.clear();
+            iterations_ = 0;
+            session_totals_.clear();
+            session_iterations_ = 0;
+            {
+                std::lock_guard lock(recent_mutex_);
+                recent_.clear();
+            }
+            owner_.store(std::this_thread::get_id());
+            enabled_.store(true);
+            if (log) {
+                LOG_INFO("Profiling zone GPU times, reported every {} iterations", report_every);
+            }
+            return;
+        }
+
+        if (!enabled_.load()) {
+            return;
+        }
+        // The last complete iteration counts, the one in progress is dropped
+        if (resolve(frames_[1 - current_], true)) {
+            ++iterations_;
+            ++session_iterations_;
+        }
+        resolve(frames_[current_], false);
+        open_.clear();
+        if (iterations_ > 0) {
+            report(-1);
+        }
+        enabled_.store(false);
+        owner_.store({});
+    }
+
+    cudaEvent_t Profiler::acquire_event() {
+        if (!events_.empty()) {
+            cudaEvent_t event = events_.back();
+            events_.pop_back();
+            return event;
+        }
+        cudaEvent_t event = nullptr;
+        if (cudaEventCreateWithFlags(&event, cudaEventDefault) != cudaSuccess) {
+            return nullptr;
+        }
+        return event;
+    }
+
+    void Profiler::begin_zone(const char* name) {
+        auto& frame = frames_[current_];
+        Record record{.name = name, .depth = static_cast<int>(open_.size())};
+        record.begin = acquire_event();
+        record.end = acquire_event();
+        if (record.begin) {
+            cudaEventRecord(record.begin, at::cuda::getCurrentCUDAStream());
+        }
+        open_.push_back(frame.size());
+        frame.push_back(record);
+    }
+
+    void Profiler::end_zone() {
+        if (open_.empty()) {
+            return;
+        }
+        Record& record = frames_[current_][open_.back()];
+        open_.pop_back();
+        if (record.end) {
+            cudaEventRecord(record.end, at::cuda::getCurrentCUDAStream());
+        }
+        record.closed = true;
+    }
+
+    bool Profiler::resolve(std::vector<Record>& frame, bool accumulate) {
+        const bool recorded = !frame.empty();
+        for (Record& record : frame) {
+            float ms = 0.f;
+            const bool timed = accumulate && record.closed && record.begin && record.end &&
+                               cudaEventSynchronize(record.end) == cudaSuccess &&
+                               cudaEventElapsedTime(&ms, record.begin, record.end) == cudaSuccess;
+            if (timed) {
+                add(totals_, record, ms);
+                add(session_totals_, record, ms);
+            }
+            for (cudaEvent_t event : {record.begin, record.end}) {
+                if (event) {
+                    events_.push_back(event);
+                }
+            }
+        }
+        frame.clear();
+        return recorded;
+    }
+
+    void Profiler::add(std::vector<Total>& totals, const Record& record, float ms) {
+        auto total = std::find_if(totals.begin(), totals.end(), [&](const Total& t) {
+            return t.depth == record.depth && std::strcmp(t.name, record.name) == 0;
+        });
+        if (total == totals.end()) {
+            totals.push_back({.name = record.name, .depth = record.depth});
+            total = std::prev(totals.end());
+        }
+        total->ms += ms;
+        ++total->calls;
+    }
+
+    void Profiler::end_iteration(int iteration) {
+        if (!timing()) {
+            return;
+        }
+        // A zone left open spans iterations and is dropped rather than resolved half recorded
+        if (!open_.empty()) {
+            LOG_DEBUG("{} profiling zones still open at the end of iteration {}", open_.size(), iteration);
+            open_.clear();
+        }
+        current_ = 1 - current_;
+        if (!resolve(frames_[current_], true)) {
+            return;
+        }
+        ++session_iterations_;
+        if (++iterations_ >= report_every_) {
+            report(iteration);
+        }
+    }
+
+    std::vector<Profiler::ZoneTime> Profiler::session_times() const {
+        std::vector<ZoneTime> times;
+        if (session_iterations_ == 0) {
+            return times;
+        }
+        times.reserve(session_totals_.size());
+        for (const Total& total : session_totals_) {
+            times.push_back({.name = total.name,
+                             .depth = total.depth,
+                             .ms = total.ms / session_iterations_,
+                             .calls = static_cast<double>(total.calls) / session_iterations_});
+        }
+        return times;
+    }
+
+    std::vector<Profiler::ZoneTime> Profiler::recent_times() const {
+        std::lock_guard lock(recent_mutex_);
+        return recent_;
+    }
+
+    void Profiler::report(int iteration) {
+        std::vector<ZoneTime> recent;
+        recent.reserve(totals_.size());
+        for (const Total& total : totals_) {
+            recent.push_back({.name = total.name,
+                              .depth = total.depth,
+                              .ms = total.ms / iterations_,
+                              .calls = static_cast<double>(total.calls) / iterations_});
+        }
+        {
+            std::lock_guard lock(recent_mutex_);
+            recent_ = std::move(recent);
+        }
+        if (!log_reports_) {
+            totals_.clear();
+            iterations_ = 0;
+            return;
+        }
+
+        if (iteration >= 0) {
+            LOG_INFO("GPU time per iteration, mean over the {} iterations to {}:", iterations_, iteration - 1);
+        } else {
+            LOG_INFO("GPU time per iteration, mean over the last {} iterations:", iterations_);
+        }
+        for (const Total& total : totals_) {
+            const double calls = static_cast<double>(total.calls) / iterations_;
+            LOG_INFO("  {}{:<{}} {:8.3f} ms  ({:.1f} calls)", std::string(2 * total.depth, ' '), total.name,
+                     24 - 2 * total.depth, total.ms / iterations_, calls);
+        }
+        totals_.clear();
+        iterations_ = 0;
+    }
+
+} // namespace gs::core
@@ -10,6 +10,7 @@
 #include "core/logger.hpp"
 #include "kernels/kmeans.cuh"
 #include "kernels/morton_encoding.cuh"
+#include "kernels/sog_packing.cuh"
 #include <algorithm>
 #include <archive.h>
 #include <archive_entry.h>
@@ -17,8 +18,8 @@
 #include <chrono>
 #include <cmath>
 #include <cstddef>
-#include <cstring>
 #include <fstream>
+#include <future>
 #include <iomanip>
 #include <nlohmann/json.hpp>
 #include <print>
@@ -39,179 +40,75 @@ namespace gs::core {
             torch::Tensor labels;
         };
 
+        // Centroids come back to the host for meta.json, the labels stay on the device for packing
         KMeansResult cluster_1d(const torch::Tensor& data, int k, int iterations) {
             auto data_gpu = data.to(torch::kCUDA);
             auto [centroids, labels] = gs::cuda::kmeans_1d(data_gpu, k, iterations);
-            return {centroids.cpu(), labels.cpu()};
+            return {centroids.cpu(), labels};
         }
 
         KMeansResult cluster_nd(const torch::Tensor& data, int k, int iterations) {
             auto data_gpu = data.to(torch::kCUDA);
             auto [centroids, labels] = gs::cuda::kmeans(data_gpu, k, iterations);
-            return {centroids.cpu(), labels.cpu()};
+            return {centroids.cpu(), labels};
         }
 
-        // Apply log transform for better quantization
-        float log_transform(float value) {
-            return std::copysign(std::log(std::abs(value) + 1.0f), value);
+        // Lossless WebP of an RGBA8 image at libwebp's lossless preset level (0 fastest, 9 smallest)
+        std::expected<std::vector<uint8_t>, std::string> encode_webp(const uint8_t* rgba,
+                                                                     int width,
+                                                                     int height,
+                                                                     int level) {
+            if (!rgba || width <= 0 || height <= 0) {
+                return std::unexpected(std::format("Invalid WebP input: {}x{}", width, height));
+            }
+
+            WebPConfig config;
+            if (!WebPConfigInit(&config) || !WebPConfigLosslessPreset(&config, std::clamp(level, 0, 9))) {
+                return std::unexpected("WebP config initialization failed");
+            }
+            // Keep the exact RGB of fully transparent pixels, they carry data
+            config.exact = 1;
+
+            WebPPicture picture;
+            if (!WebPPictureInit(&picture)) {
+                return std::unexpected("WebP picture initialization failed");
+            }
+            picture.use_argb = 1;
+            picture.width = width;
+            picture.height = height;
+            if (!WebPPictureImportRGBA(&picture, rgba, width * 4)) {
+                WebPPictureFree(&picture);
+                return std::unexpected("WebP picture import failed");
+            }
+
+            WebPMemoryWriter writer;
+            WebPMemoryWriterInit(&writer);
+            picture.writer = WebPMemoryWrite;
+            picture.custom_ptr = &writer;
+            const bool ok = WebPEncode(&config, &picture);
+            const int error_code = picture.error_code;
+            WebPPictureFree(&picture);
+            if (!ok) {
+                WebPMemoryWriterClear(&writer);
+                return std::unexpected(std::format("WebP encoding failed (error {})", error_code));
+            }
+
+            std::vector<uint8_t> encoded(writer.mem, writer.mem + writer.size);
+            WebPMemoryWriterClear(&writer);
+            return encoded;
         }
 
-        // Pack quaternion into 8-bit values
-        std::array<uint8_t, 4> pack_quaternion(float w, float x, float y, float z) {
-            // Normalize
-            float len = std::sqrt(w * w + x * x + y * y + z * z);
-            if (len > 0) {
-                w /= len;
-                x /= len;
-                y /= len;
-                z /= len;
-            } else {
-                // Handle zero-length quaternion: set to identity quaternion
-                w = 1.0f;
-                x = 0.0f;
-                y = 0.0f;
-                z = 0.0f;
-                LOG_WARN("pack_quaternion: Zero-length quaternion encountered, replaced with identity quaternion.");
-            }
-
-            // Find largest component (in absolute value)
-            float max_val = std::abs(w);
-            int max_idx = 0; // 0 = w, 1 = x, 2 = y, 3 = z
-
-            if (std::abs(x) > max_val) {
-                max_val = std::abs(x);
-                max_idx = 1;
-            }
-            if (std::abs(y) > max_val) {
-                max_val = std::abs(y);
-                max_idx = 2;
-            }
-            if (std::abs(z) > max_val) {
-                max_val = std::abs(z);
-                max_idx = 3;
-            }
-
-            // Ensure largest component is positive
-            if ((max_idx == 0 && w < 0) ||
-                (max_idx == 1 && x < 0) ||
-                (max_idx == 2 && y < 0) ||
-                (max_idx == 3 && z < 0)) {
-                w = -w;
-                x = -x;
-                y = -y;
-                z = -z;
-            }
-
-            // Scale the quaternion components by sqrt(2)
-            constexpr float sqrt2 = 1.41421356237f;
-            w *= sqrt2;
-            x *= sqrt2;
-            y *= sqrt2;
-            z *= sqrt2;
-
-            // Pack the other 3 components based on which is largest
-            std::array<uint8_t, 4> result;
-
-            if (max_idx == 0) {
-                // w is largest, store x, y, z
-                result[0] = static_cast<uint8_t>(std::clamp((x * 0.5f + 0.5f) * 255.0f, 0.0f, 255.0f));
-                result[1] = static_cast<uint8_t>(std::clamp((y * 0.5f + 0.5f) * 255.0f, 0.0f, 255.0f));
-                result[2] = static_cast<uint8_t>(std::clamp((z * 0.5f + 0.5f) * 255.0f, 0.0f, 255.0f));
-            } else if (max_idx == 1) {
-                // x is largest, store w, y, z
-                result[0] = static_cast<uint8_t>(std::clamp((w * 0.5f + 0.5f) * 255.0f, 0.0f, 255.0f));
-                result[1] = static_cast<uint8_t>(std::clamp((y * 0.5f + 0.5f) * 255.0f, 0.0f, 255.0f));
-                result[2] = static_cast<uint8_t>(std::clamp((z * 0.5f + 0.5f) * 255.0f, 0.0f, 255.0f));
-            } else if (max_idx == 2) {
-                // y is largest, store w, x, z
-                result[0] = static_cast<uint8_t>(std::clamp((w * 0.5f + 0.5f) * 255.0f, 0.0f, 255.0f));
-                result[1] = static_cast<uint8_t>(std::clamp((x * 0.5f + 0.5f) * 255.0f, 0.0f, 255.0f));
-                result[2] = static_cast<uint8_t>(std::clamp((z * 0.5f + 0.5f) * 255.0f, 0.0f, 255.0f));
-            } else {
-                // z is largest, store w, x, y
-                result[0] = static_cast<uint8_t>(std::clamp((w * 0.5f + 0.5f) * 255.0f, 0.0f, 255.0f));
-                result[1] = static_cast<uint8_t>(std::clamp((x * 0.5f + 0.5f) * 255.0f, 0.0f, 255.0f));
-                result[2] = static_cast<uint8_t>(std::clamp((y * 0.5f + 0.5f) * 255.0f, 0.0f, 255.0f));
-            }
-
-            // Store which component was largest
-            result[3] = 252 + max_idx;
-
-            return result;
-        }
-
-        // Write WebP image
-        bool write_webp_image(const std::filesystem::path& path,
-                              const uint8_t* data,
-                              int width,
-                              int height,
-                              int channels = 4) {
-
-            if (!data || width <= 0 || height <= 0) {
-                LOG_ERROR("Invalid input to write_webp_image: data={}, width={}, height={}",
-                          (void*)data, width, height);
-                return false;
-            }
-
-            uint8_t* output = nullptr;
-            size_t output_size = 0;
-
-            std::vector<uint8_t> rgba_buffer;
-
-            if (channels == 4) {
-                rgba_buffer.resize(width * height * 4);
-                std::memcpy(rgba_buffer.data(), data, width * height * 4);
-
-                output_size = WebPEncodeLosslessRGBA(
-                    rgba_buffer.data(),
-                    width,
-                    height,
-                    width * 4,
-                    &output);
-            } else if (channels == 3) {
-                rgba_buffer.resize(width * height * 4);
-                for (int i = 0; i < width * height; ++i) {
-                    rgba_buffer[i * 4 + 0] = data[i * 3 + 0];
-                    rgba_buffer[i * 4 + 1] = data[i * 3 + 1];
-                    rgba_buffer[i * 4 + 2] = data[i * 3 + 2];
-                    rgba_buffer[i * 4 + 3] = 255;
-                }
-
-                output_size = WebPEncodeLosslessRGBA(
-                    rgba_buffer.data(),
-                    width,
-                    height,
-                    width * 4,
-                    &output);
-            } else {
-                LOG_ERROR("Unsupported number of channels: {}", channels);
-                return false;
-            }
-
-            if (output_size == 0 || output == nullptr) {
-                LOG_ERROR("WebP encoding failed for {} (size={})", path.string(), output_size);
-                if (output)
-                    WebPFree(output);
-                return false;
-            }
-
+        bool write_file(const std::filesystem::path& path, const std::vector<uint8_t>& data) {
             std::ofstream file(path, std::ios::binary);
             if (!file) {
-                WebPFree(output);
                 LOG_ERROR("Failed to open file: {}", path.string());
                 return false;
             }
-
-            file.write(reinterpret_cast<const char*>(output), output_size);
-            WebPFree(output);
-
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
             if (!file.good()) {
                 LOG_ERROR("Failed to write file: {}", path.string());
                 return false;
             }
-
-            LOG_DEBUG("Successfully wrote WebP: {} ({}x{}, {} bytes)",
-                      path.string(), width, height, output_size);
             return true;
         }
 
@@ -262,76 +159,18 @@ namespace gs::core {
                 return true;
             }
 
-            bool add_webp(const std::string& filename, const uint8_t* data,
-                          int width, int height, int channels = 4) {
-
-                if (!data || width <= 0 || height <= 0) {
-                    LOG_ERROR("Invalid input to add_webp: data={}, width={}, height={}",
-                              (void*)data, width, height);
-                    return false;
-                }
-
-                uint8_t* output = nullptr;
-                size_t output_size = 0;
-
-                std::vector<uint8_t> rgba_buffer;
-
-                if (channels == 4) {
-                    rgba_buffer.resize(width * height * 4);
-                    std::memcpy(rgba_buffer.data(), data, width * height * 4);
-
-                    output_size = WebPEncodeLosslessRGBA(
-                        rgba_buffer.data(),
-                        width,
-                        height,
-                        width * 4,
-                        &output);
-                } else if (channels == 3) {
-                    rgba_buffer.resize(width * height * 4);
-                    for (int i = 0; i < width * height; ++i) {
-                        rgba_buffer[i * 4 + 0] = data[i * 3 + 0];
-                        rgba_buffer[i * 4 + 1] = data[i * 3 + 1];
-                        rgba_buffer[i * 4 + 2] = data[i * 3 + 2];
-                        rgba_buffer[i * 4 + 3] = 255;
-                    }
-
-                    output_size = WebPEncodeLosslessRGBA(
-                        rgba_buffer.data(),
-                        width,
-                        height,
-                        width * 4,
-                        &output);
-                } else {
-                    LOG_ERROR("Unsupported number of channels: {}", channels);
-                    return false;
-                }
-
-                if (output_size == 0 || output == nullptr) {
-                    LOG_ERROR("WebP encoding failed for {} in archive", filename);
-                    if (output)
-                        WebPFree(output);
-                    return false;
-                }
-
-                bool result = add_file(filename, output, output_size);
-                WebPFree(output);
-
-                if (result) {
-                    LOG_DEBUG("Added {} to archive ({}x{}, {} bytes)",
-                              filename, width, height, output_size);
-                }
-
-                return result;
-            }
         };
 
-        // Identity layout function - matches TypeScript
-        int identity_layout(int index, int width) {
-            return index;
-        }
-
     } // anonymous namespace
 
+    int sog_palette_size(int64_t num_splats) {
+        // Matches the TypeScript logic, up to 64k entries
+        const int palette_size = std::min(64,
+                                          std::max(1, static_cast<int>(std::pow(2, std::floor(std::log2(num_splats / 1024.0)))))) *
+                                 1024;
+        return static_cast<int>(std::min<int64_t>(palette_size, num_splats));
+    }
+
     std::expected<void, std::string> write_sog(
         const SplatData& splat_data,
         const SogWriteOptions& options) {
@@ -351,13 +190,13 @@ namespace gs::core {
 
             LOG_DEBUG("SOG texture dimensions: {}x{} for {} splats", width, height, num_splats);
 
-            // Get data tensors on CPU
-            auto means = splat_data.get_means().cpu().contiguous();
-            auto scales = splat_data.scaling_raw().cpu().contiguous();
-            auto rotations = splat_data.get_rotation().cpu().contiguous();
-            auto opacities = splat_data.get_opacity().cpu().contiguous();
-            auto sh0 = splat_data.sh0().cpu().contiguous();
-            auto shN = splat_data.shN().cpu().contiguous();
+            // Attributes stay on the device, every texture is packed there and copied back once
+            auto means = splat_data.get_means().to(torch::kCUDA).contiguous();
+            auto scales = splat_data.scaling_raw().to(torch::kCUDA).contiguous();
+            auto rotations = splat_data.get_rotation().to(torch::kCUDA).contiguous();
+            auto opacities = splat_data.get_opacity().to(torch::kCUDA).to(torch::kFloat32).contiguous();
+            auto sh0 = splat_data.sh0().to(torch::kCUDA).to(torch::kFloat32).contiguous();
+            auto shN = splat_data.shN().to(torch::kCUDA).to(torch::kFloat32).contiguous();
 
             // Determine SH degree from shN shape
             int sh_degree = 0;
@@ -374,9 +213,8 @@ namespace gs::core {
             }
             LOG_DEBUG("Detected SH degree: {}", sh_degree);
 
-            auto means_gpu = means.to(torch::kCUDA);
-            auto morton_codes = morton_encode(means_gpu);
-            auto indices = morton_sort_indices(morton_codes).cpu();
+            auto morton_codes = morton_encode(means);
+            auto indices = morton_sort_indices(morton_codes);
 
             // Check if output is .sog bundle or individual files
             bool is_bundle = options.output_path.extension() == ".sog";
@@ -391,193 +229,62 @@ namespace gs::core {
                 std::filesystem::create_directories(base_path);
             }
 
-            // Helper lambda to write images
-            auto write_image = [&](const std::string& filename,
-                                   const uint8_t* data,
-                                   int w = -1, int h = -1) -> bool {
-                if (w == -1)
-                    w = width;
-                if (h == -1)
-                    h = height;
-
-                if (!data) {
-                    LOG_ERROR("Null data pointer for {}", filename);
-                    return false;
-                }
-
-                if (archive) {
-                    LOG_DEBUG("Adding {} to archive ({}x{})", filename, w, h);
-                    return archive->add_webp(filename, data, w, h, channels);
-                } else {
-                    auto file_path = base_path / filename;
-                    auto webp_path = file_path;
-                    if (webp_path.extension() != ".webp") {
-                        webp_path.replace_extension(".webp");
-                    }
-                    LOG_DEBUG("Writing {} ({}x{})", webp_path.string(), w, h);
-                    return write_webp_image(webp_path, data, w, h, channels);
-                }
+            // Textures are [height, width, 4] uint8. Each one encodes on its own thread while the next
+            // is clustered and packed, and enters the bundle in submission order
+            using EncodedImage = std::expected<std::vector<uint8_t>, std::string>;
+            std::vector<std::pair<std::string, std::future<EncodedImage>>> encodes;
+            auto queue_texture = [&](const std::string& filename, const torch::Tensor& texture) {
+                LOG_DEBUG("Encoding {} ({}x{})", filename, texture.size(1), texture.size(0));
+                encodes.emplace_back(filename, std::async(std::launch::async, [host = texture.cpu().contiguous(),
+                                                                               level = options.webp_level] {
+                                         return encode_webp(host.data_ptr<uint8_t>(), static_cast<int>(host.size(1)),
+                                                            static_cast<int>(host.size(0)), level);
+                                     }));
             };
 
             LOG_DEBUG("Processing positions with log transform");
 
-            // 1. Process positions with log transform
-            std::vector<uint8_t> means_l(width * height * channels, 255); // Initialize alpha to 255
-            std::vector<uint8_t> means_u(width * height * channels, 255);
-
-            // Apply log transform and find min/max
-            torch::Tensor means_log = torch::zeros_like(means);
-            auto means_data = means.accessor<float, 2>();
-            auto means_log_data = means_log.accessor<float, 2>();
-
-            for (int64_t i = 0; i < num_splats; ++i) {
-                for (int j = 0; j < 3; ++j) {
-                    means_log_data[i][j] = log_transform(means_data[i][j]);
-                }
-            }
-
-            // Fix for Windows because it sucks: avoid  bindings with min/max
-            auto means_min_tuple = means_log.min(0);
-            auto means_min = std::get<0>(means_min_tuple);
-            auto means_max_tuple = means_log.max(0);
-            auto means_max = std::get<0>(means_max_tuple);
-
+            // 1. Positions: log transform, then 16 bits split over two textures
+            const auto means_log = torch::sign(means) * torch::log(torch::abs(means) + 1.0f);
+            const auto means_min = std::get<0>(means_log.min(0)).cpu();
+            const auto means_max = std::get<0>(means_log.max(0)).cpu();
             auto means_min_acc = means_min.accessor<float, 1>();
             auto means_max_acc = means_max.accessor<float, 1>();
-            auto indices_acc = indices.accessor<int64_t, 1>();
-
-            for (int64_t i = 0; i < num_splats; ++i) {
-                int64_t idx = indices_acc[i];
-                int ti = identity_layout(i, width);
-
-                float x = (means_log_data[idx][0] - means_min_acc[0]) /
-                          (means_max_acc[0] - means_min_acc[0] + 1e-10f);
-                float y = (means_log_data[idx][1] - means_min_acc[1]) /
-                          (means_max_acc[1] - means_min_acc[1] + 1e-10f);
-                float z = (means_log_data[idx][2] - means_min_acc[2]) /
-                          (means_max_acc[2] - means_min_acc[2] + 1e-10f);
-
-                uint16_t x16 = static_cast<uint16_t>(65535 * std::clamp(x, 0.0f, 1.0f));
-                uint16_t y16 = static_cast<uint16_t>(65535 * std::clamp(y, 0.0f, 1.0f));
-                uint16_t z16 = static_cast<uint16_t>(65535 * std::clamp(z, 0.0f, 1.0f));
-
-                means_l[ti * 4 + 0] = x16 & 0xff;
-                means_l[ti * 4 + 1] = y16 & 0xff;
-                means_l[ti * 4 + 2] = z16 & 0xff;
-                // Alpha already set to 255
-
-                means_u[ti * 4 + 0] = (x16 >> 8) & 0xff;
-                means_u[ti * 4 + 1] = (y16 >> 8) & 0xff;
-                means_u[ti * 4 + 2] = (z16 >> 8) & 0xff;
-                // Alpha already set to 255
-            }
 
-            if (!write_image("means_l.webp", means_l.data())) {
-                return std::unexpected("Failed to write means_l.webp");
-            }
-            if (!write_image("means_u.webp", means_u.data())) {
-                return std::unexpected("Failed to write means_u.webp");
-            }
+            auto [means_l, means_u] = sog_pack_means(
+                means, indices,
+                {means_min_acc[0], means_min_acc[1], means_min_acc[2]},
+                {means_max_acc[0], means_max_acc[1], means_max_acc[2]},
+                width, height);
+
+            queue_texture("means_l.webp", means_l);
+            queue_texture("means_u.webp", means_u);
 
             LOG_DEBUG("Processing quaternions");
 
             // 2. Process quaternions
-            std::vector<uint8_t> quats(width * height * channels, 255);
-            auto rot_acc = rotations.accessor<float, 2>();
-
-            for (int64_t i = 0; i < num_splats; ++i) {
-                int64_t idx = indices_acc[i];
-                int ti = identity_layout(i, width);
-
-                // Rotations are stored as [w, x, y, z] in SplatData
-                auto quat = pack_quaternion(
-                    rot_acc[idx][0], // w
-                    rot_acc[idx][1], // x
-                    rot_acc[idx][2], // y
-                    rot_acc[idx][3]  // z
-                );
-
-                quats[ti * 4 + 0] = quat[0];
-                quats[ti * 4 + 1] = quat[1];
-                quats[ti * 4 + 2] = quat[2];
-                quats[ti * 4 + 3] = quat[3];
-            }
-
-            if (!write_image("quats.webp", quats.data())) {
-                return std::unexpected("Failed to write quats.webp");
+            if (const int64_t degenerate = (rotations.norm(2, 1) == 0).sum().item<int64_t>(); degenerate > 0) {
+                LOG_WARN("{} zero-length quaternions replaced with the identity", degenerate);
             }
+            queue_texture("quats.webp", sog_pack_quaternions(rotations, indices, width, height));
 
             // 3. Cluster scales using k-means
             LOG_DEBUG("Clustering scales with k=256, iterations={}", options.iterations);
 
             // Flatten scales in column-major order to match TypeScript
-            auto scales_flat = torch::zeros({num_splats * 3}, torch::kFloat32);
-            auto scales_acc = scales.accessor<float, 2>();
-            auto scales_flat_ptr = scales_flat.data_ptr<float>();
-
-            for (int64_t i = 0; i < num_splats; ++i) {
-                scales_flat_ptr[i] = scales_acc[i][0];
-                scales_flat_ptr[num_splats + i] = scales_acc[i][1];
-                scales_flat_ptr[2 * num_splats + i] = scales_acc[i][2];
-            }
+            auto scales_result = cluster_1d(scales.t().reshape({-1}), 256, options.iterations);
 
-            auto scales_result = cluster_1d(scales_flat, 256, options.iterations);
-
-            std::vector<uint8_t> scales_data(width * height * channels, 255);
-            auto scales_labels_acc = scales_result.labels.accessor<int32_t, 1>();
-
-            for (int64_t i = 0; i < num_splats; ++i) {
-                int64_t idx = indices_acc[i];
-                int ti = identity_layout(i, width);
-
-                scales_data[ti * 4 + 0] = static_cast<uint8_t>(scales_labels_acc[idx]);
-                scales_data[ti * 4 + 1] = static_cast<uint8_t>(scales_labels_acc[num_splats + idx]);
-                scales_data[ti * 4 + 2] = static_cast<uint8_t>(scales_labels_acc[2 * num_splats + idx]);
-                // Alpha already set to 255
-            }
-
-            if (!write_image("scales.webp", scales_data.data())) {
-                return std::unexpected("Failed to write scales.webp");
-            }
+            queue_texture("scales.webp", sog_pack_codes(scales_result.labels, indices, {}, width, height, 255));
 
             // 4. Cluster colors using k-means
             LOG_DEBUG("Clustering colors with k=256, iterations={}", options.iterations);
 
-            auto sh0_reshaped = sh0.reshape({num_splats, 3});
-
-            // Create concatenated 1D tensor in column-major order to match TypeScript
-            torch::Tensor colors_1d = torch::zeros({num_splats * 3}, torch::kFloat32);
-            auto sh0_acc = sh0_reshaped.accessor<float, 2>();
-            auto colors_1d_ptr = colors_1d.data_ptr<float>();
-
-            for (int64_t i = 0; i < num_splats; ++i) {
-                colors_1d_ptr[i] = sh0_acc[i][0];                  // R values
-                colors_1d_ptr[num_splats + i] = sh0_acc[i][1];     // G values
-                colors_1d_ptr[2 * num_splats + i] = sh0_acc[i][2]; // B values
-            }
-
-            auto colors_result = cluster_1d(colors_1d, 256, options.iterations);
-
-            std::vector<uint8_t> sh0_data(width * height * channels, 0);
-            auto colors_labels_acc = colors_result.labels.accessor<int32_t, 1>();
-            auto opacity_acc = opacities.accessor<float, 1>();
-
-            for (int64_t i = 0; i < num_splats; ++i) {
-                int64_t idx = indices_acc[i];
-                int ti = identity_layout(i, width);
-
-                sh0_data[ti * 4 + 0] = static_cast<uint8_t>(colors_labels_acc[idx]);
-                sh0_data[ti * 4 + 1] = static_cast<uint8_t>(colors_labels_acc[num_splats + idx]);
-                sh0_data[ti * 4 + 2] = static_cast<uint8_t>(colors_labels_acc[2 * num_splats + idx]);
-
-                // Decode opacity (already sigmoid applied in get_opacity())
-                float opacity = opacity_acc[idx];
-                sh0_data[ti * 4 + 3] = static_cast<uint8_t>(255 * opacity);
-            }
+            // Concatenated R, G then B values to match TypeScript
+            auto colors_result = cluster_1d(sh0.reshape({num_splats, 3}).t().reshape({-1}), 256, options.iterations);
 
-            if (!write_image("sh0.webp", sh0_data.data())) {
-                return std::unexpected("Failed to write sh0.webp");
-            }
+            // Opacity goes into alpha, it is already sigmoid-activated by get_opacity()
+            queue_texture("sh0.webp",
+                          sog_pack_codes(colors_result.labels, indices, opacities.reshape({-1}), width, height, 0));
 
             // Create meta.json
             nlohmann::json meta;
@@ -626,10 +333,7 @@ namespace gs::core {
                 // Flatten SH coefficients for clustering
                 auto shN_reshaped = shN.reshape({num_splats, sh_coeffs * 3});
 
-                // Calculate palette size - matches TypeScript logic
-                int palette_size = std::min(64,
-                                            std::max(1, static_cast<int>(std::pow(2, std::floor(std::log2(num_splats / 1024.0)))) * 1024));
-                palette_size = std::min(palette_size, static_cast<int>(num_splats));
+                const int palette_size = sog_palette_size(num_splats);
 
                 LOG_DEBUG("Clustering SH with palette_size={}, sh_coeffs={}", palette_size, sh_coeffs);
 
@@ -653,8 +357,10 @@ namespace gs::core {
                               centroids_width, centroids_height);
 
                     // Write centroids with proper band-major ordering
-                    std::vector<uint8_t> centroids_buf(centroids_width * centroids_height * channels, 255);
-                    auto codebook_labels_acc = codebook_result.labels.accessor<int32_t, 1>();
+                    auto centroids_texture = torch::full({centroids_height, centroids_width, channels}, 255, torch::kUInt8);
+                    uint8_t* centroids_buf = centroids_texture.data_ptr<uint8_t>();
+                    const auto codebook_labels = codebook_result.labels.cpu();
+                    auto codebook_labels_acc = codebook_labels.accessor<int32_t, 1>();
 
                     for (int i = 0; i < actual_palette_size; ++i) {
                         for (int j = 0; j < sh_coeffs; ++j) {
@@ -676,30 +382,10 @@ namespace gs::core {
                         }
                     }
 
-                    if (!write_image("shN_centroids.webp", centroids_buf.data(), centroids_width, centroids_height)) {
-                        return std::unexpected("Failed to write shN_centroids.webp");
-                    }
-
-                    LOG_DEBUG("Writing SH labels");
-
-                    // Write labels
-                    std::vector<uint8_t> labels_buf(width * height * channels, 255);
-                    auto sh_labels_acc = sh_result.labels.accessor<int32_t, 1>();
-
-                    for (int64_t i = 0; i < num_splats; ++i) {
-                        int64_t idx = indices_acc[i];
-                        int32_t label = sh_labels_acc[idx];
-                        int ti = identity_layout(i, width);
-
-                        labels_buf[ti * 4 + 0] = label & 0xff;
-                        labels_buf[ti * 4 + 1] = (label >> 8) & 0xff;
-                        labels_buf[ti * 4 + 2] = 0;
-                        // Alpha already set to 255
-                    }
+                    queue_texture("shN_centroids.webp", centroids_texture);
 
-                    if (!write_image("shN_labels.webp", labels_buf.data())) {
-                        return std::unexpected("Failed to write shN_labels.webp");
-                    }
+                    LOG_DEBUG("Packing SH labels");
+                    queue_texture("shN_labels.webp", sog_pack_palette_labels(sh_result.labels, indices, width, height));
 
                     // Add to meta.json with all required fields
                     std::vector<float> sh_codebook;
@@ -720,6 +406,19 @@ namespace gs::core {
                 }
             }
 
+            for (auto& [filename, encode] : encodes) {
+                auto encoded = encode.get();
+                if (!encoded) {
+                    return std::unexpected(std::format("Failed to encode {}: {}", filename, encoded.error()));
+                }
+                const bool written = archive ? archive->add_file(filename, encoded->data(), encoded->size())
+                                             : write_file(base_path / filename, *encoded);
+                if (!written) {
+                    return std::unexpected(std::format("Failed to write {}", filename));
+                }
+                LOG_DEBUG("Wrote {} ({} bytes)", filename, encoded->size());
+            }
+
             // Write meta.json
             std::string meta_json = meta.dump(2);
 
@@ -6,25 +6,49 @@
 #include "core/logger.hpp"
 #include "core/parameters.hpp"
 #include "core/point_cloud.hpp"
+#include "core/row_storage.hpp"
 #include "core/sogs.hpp"
+#include "core/splat_lod.hpp"
 
 #include "external/nanoflann.hpp"
-#include "external/tinyply.hpp"
+#include "kernels/knn.cuh"
+#include "kernels/ply_interleave.cuh"
+#include "kernels/splat_transform.cuh"
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
 #include <algorithm>
+#include <array>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAGuard.h>
 #include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <expected>
 #include <filesystem>
 #include <format>
 #include <fstream>
+#include <functional>
 #include <future>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <memory>
+#include <numbers>
 #include <print>
+#include <span>
 #include <string>
 #include <thread>
 #include <torch/torch.h>
 #include <vector>
 
+#ifdef __linux__
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace {
     std::string tensor_sizes_to_string(const c10::ArrayRef<int64_t>& sizes) {
         std::ostringstream oss;
@@ -59,8 +83,12 @@ namespace {
     // Fixed: KDTree typedef on single line
     using KDTree = nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<float, PointCloudAdaptor>, PointCloudAdaptor, 3>;
 
-    // Compute mean distance to 3 nearest neighbors for each point
+    // Compute mean distance to 3 nearest neighbors for each point, on the GPU for CUDA points
     torch::Tensor compute_mean_neighbor_distances(const torch::Tensor& points) {
+        if (points.is_cuda()) {
+            return gs::mean_neighbor_distances(points);
+        }
+
         auto cpu_points = points.to(torch::kCPU).contiguous();
         const int num_points = cpu_points.size(0);
 
@@ -110,11 +138,152 @@ namespace {
         return result.to(points.device());
     }
 
+    constexpr size_t kPlyChunkBytes = size_t(16) << 20;
+    constexpr size_t kPlyStreamChunkBytes = size_t(64) << 20;
+    constexpr size_t kDirectIoAlignment = 4096;
+
+    // Hands out the vertex records of a PLY in order, whole rows per chunk, and an empty span once
+    // all of them were handed out. A chunk stays valid until the next call.
+    using PlyChunkSource = std::function<std::span<const float>()>;
+
+    // Rows per streamed chunk: close to kPlyStreamChunkBytes and a multiple of 1024 rows, so every
+    // chunk but the last is a whole number of O_DIRECT pages for any record width
+    int64_t ply_chunk_rows(int64_t cols) {
+        const auto rows = static_cast<int64_t>(kPlyStreamChunkBytes / (static_cast<size_t>(cols) * sizeof(float)));
+        return std::max<int64_t>(rows / 1024 * 1024, 1024);
+    }
+
+    // pad_to > 0 grows the header with a comment line to a multiple of pad_to bytes
+    std::string ply_header(const std::vector<std::string>& attribute_names, int64_t rows, size_t pad_to) {
+        std::string header = std::format("ply\nformat binary_little_endian 1.0\nelement vertex {}\n", rows);
+        for (const auto& name : attribute_names) {
+            header += "property float " + name + "\n";
+        }
+        const std::string end = "end_header\n";
+        if (pad_to > 0) {
+            const size_t unpadded = header.size() + std::strlen("comment \n") + end.size();
+            const size_t padded = (unpadded + pad_to - 1) / pad_to * pad_to;
+            header += "comment " + std::string(padded - unpadded, ' ') + "\n";
+        }
+        return header + end;
+    }
+
+#ifdef __linux__
+    bool write_fully(int fd, const char* bytes, size_t count) {
+        while (count > 0) {
+            const ssize_t written = ::write(fd, bytes, std::min(count, kPlyChunkBytes));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            bytes += written;
+            count -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+#endif
+
+    // Writes a binary little-endian PLY of rows x cols float32 vertex records pulled chunk by chunk
+    // from next_chunk, to a temp file renamed into place so readers never see a partial PLY. With
+    // direct_io (Linux) the header is padded to a page so the records start page-aligned in the
+    // file and go around the page cache with O_DIRECT; an unaligned chunk or a filesystem without
+    // O_DIRECT falls back to regular writes for the rest of the file.
+    void write_ply_vertices(const std::filesystem::path& file_path,
+                            const std::vector<std::string>& attribute_names,
+                            int64_t rows, int64_t cols, const PlyChunkSource& next_chunk, bool direct_io) {
+        namespace fs = std::filesystem;
+        const fs::path tmp_path = fs::path(file_path.string() + ".tmp");
+        const size_t total = static_cast<size_t>(rows * cols) * sizeof(float);
+        size_t written = 0;
+
+#ifdef __linux__
+        bool direct = direct_io;
+        int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | (direct ? O_DIRECT : 0), 0644);
+        if (fd < 0 && direct) {
+            direct = false;
+            fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        }
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open " + tmp_path.string() + " for writing");
+        }
+        if (direct_io && !direct) {
+            LOG_DEBUG("O_DIRECT unavailable for {}, writing through the page cache", file_path.string());
+        }
+
+        const std::string header = ply_header(attribute_names, rows, direct ? kDirectIoAlignment : 0);
+        bool ok;
+        if (direct) {
+            // O_DIRECT needs aligned buffers, offsets and lengths, the header goes from an aligned copy
+            void* aligned_header = std::aligned_alloc(kDirectIoAlignment, header.size());
+            ok = aligned_header != nullptr;
+            if (ok) {
+                std::memcpy(aligned_header, header.data(), header.size());
+                ok = write_fully(fd, static_cast<const char*>(aligned_header), header.size());
+                std::free(aligned_header);
+            }
+        } else {
+            ok = write_fully(fd, header.data(), header.size());
+        }
+        while (ok) {
+            const auto chunk = next_chunk();
+            if (chunk.empty()) {
+                break;
+            }
+            const auto* bytes = reinterpret_cast<const char*>(chunk.data());
+            const size_t count = chunk.size_bytes();
+            // Only the last chunk ends off a page: its tail, like an unaligned chunk, goes without O_DIRECT
+            size_t aligned = count;
+            if (direct) {
+                aligned = reinterpret_cast<uintptr_t>(bytes) % kDirectIoAlignment == 0
+                              ? count / kDirectIoAlignment * kDirectIoAlignment
+                              : 0;
+            }
+            ok = write_fully(fd, bytes, aligned);
+            if (ok && aligned < count) {
+                ok = ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) & ~O_DIRECT) == 0 &&
+                     write_fully(fd, bytes + aligned, count - aligned);
+                direct = false;
+            }
+            written += count;
+        }
+        ok = (::close(fd) == 0) && ok;
+#else
+        (void)direct_io;
+        const std::string header = ply_header(attribute_names, rows, 0);
+        std::FILE* file = std::fopen(tmp_path.string().c_str(), "wb");
+        if (!file) {
+            throw std::runtime_error("Failed to open " + tmp_path.string() + " for writing");
+        }
+        std::setvbuf(file, nullptr, _IONBF, 0);
+
+        bool ok = std::fwrite(header.data(), 1, header.size(), file) == header.size();
+        while (ok) {
+            const auto chunk = next_chunk();
+            if (chunk.empty()) {
+                break;
+            }
+            ok = std::fwrite(chunk.data(), 1, chunk.size_bytes(), file) == chunk.size_bytes();
+            written += chunk.size_bytes();
+        }
+        ok = (std::fclose(file) == 0) && ok;
+#endif
+        if (!ok || written != total) {
+            fs::remove(tmp_path);
+            throw std::runtime_error("Failed to write " + file_path.string());
+        }
+        fs::rename(tmp_path, file_path);
+    }
+
+    std::filesystem::path ply_output_path(const std::filesystem::path& root, int iteration, const std::string& stem) {
+        return root / (stem.empty() ? "splat_" + std::to_string(iteration) + ".ply" : stem + ".ply");
+    }
+
     void write_ply_impl(const gs::PointCloud& pc,
                         const std::filesystem::path& root,
-                        int iteration, const std::string& stem) {
-        namespace fs = std::filesystem;
-        fs::create_directories(root);
+                        int iteration, const std::string& stem, bool direct_io) {
+        std::filesystem::create_directories(root);
 
         std::vector<torch::Tensor> tensors;
         tensors.push_back(pc.means);
@@ -131,48 +300,213 @@ namespace {
             tensors.push_back(pc.scaling);
         if (pc.rotation.defined())
             tensors.push_back(pc.rotation);
+        int64_t cols = 0;
+        for (auto& tensor : tensors) {
+            tensor = tensor.to(torch::kFloat32).reshape({tensor.size(0), -1});
+            cols += tensor.size(1);
+        }
+        if (static_cast<size_t>(cols) != pc.attribute_names.size()) {
+            throw std::runtime_error(std::format("PLY export has {} attribute names for {} columns",
+                                                 pc.attribute_names.size(), cols));
+        }
+
+        // Interleaved chunk by chunk into one page-aligned buffer, the layout is exactly the
+        // attribute name list; host memory beyond the point cloud stays at a chunk
+        const int64_t rows = pc.means.size(0);
+        const int64_t chunk_rows = ply_chunk_rows(cols);
+        const std::unique_ptr<float, decltype(&std::free)> buffer(
+            static_cast<float*>(std::aligned_alloc(kDirectIoAlignment, static_cast<size_t>(chunk_rows * cols) * sizeof(float))),
+            &std::free);
+        if (!buffer) {
+            throw std::runtime_error("Failed to allocate the PLY export buffer");
+        }
+
+        int64_t first = 0;
+        write_ply_vertices(ply_output_path(root, iteration, stem), pc.attribute_names, rows, cols, [&]() -> std::span<const float> {
+            const int64_t n = std::min(chunk_rows, rows - first);
+            if (n <= 0) {
+                return {};
+            }
+            std::vector<torch::Tensor> slices;
+            slices.reserve(tensors.size());
+            for (const auto& tensor : tensors) {
+                slices.push_back(tensor.narrow(0, first, n));
+            }
+            auto out = torch::from_blob(buffer.get(), {n, cols}, torch::kFloat32);
+            torch::cat_out(out, slices, 1);
+            first += n;
+            return {buffer.get(), static_cast<size_t>(n * cols)};
+        },
+                           direct_io);
+    }
+
+    // Pinned chunk buffers shared by all snapshot saves, two per slot so the copy of one chunk
+    // overlaps the write of the other. Host staging stays at four chunks whatever the model size;
+    // further saves wait for a slot to come back.
+    class SnapshotStagingPool {
+    public:
+        struct Slot {
+            std::array<torch::Tensor, 2> host;        // Pinned float32 chunk buffers, grown on demand
+            std::array<at::cuda::CUDAEvent, 2> ready; // Copy into host[i] has landed
+        };
+
+        static SnapshotStagingPool& instance() {
+            static SnapshotStagingPool pool;
+            return pool;
+        }
 
-        auto write_output_ply =
-            [](const fs::path& file_path,
-               const std::vector<torch::Tensor>& data,
-               const std::vector<std::string>& attr_names) {
-                tinyply::PlyFile ply;
-                size_t attr_off = 0;
-
-                for (const auto& tensor : data) {
-                    const size_t cols = tensor.size(1);
-                    std::vector<std::string> attrs(attr_names.begin() + attr_off,
-                                                   attr_names.begin() + attr_off + cols);
-
-                    ply.add_properties_to_element(
-                        "vertex",
-                        attrs,
-                        tinyply::Type::FLOAT32,
-                        tensor.size(0),
-                        reinterpret_cast<uint8_t*>(tensor.data_ptr<float>()),
-                        tinyply::Type::INVALID, 0);
-
-                    attr_off += cols;
+        Slot* acquire(int64_t chunk_numel) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (free_.empty()) {
+                LOG_WARN("PLY snapshot writer is behind, waiting for a staging buffer");
+                cv_.wait(lock, [this] { return !free_.empty(); });
+            }
+            Slot* slot = free_.back();
+            free_.pop_back();
+            lock.unlock();
+
+            for (auto& host : slot->host) {
+                if (!host.defined() || host.numel() < chunk_numel) {
+                    host = torch::empty({chunk_numel}, torch::TensorOptions().dtype(torch::kFloat32).pinned_memory(true));
                 }
+            }
+            return slot;
+        }
 
-                std::filebuf fb;
-                fb.open(file_path, std::ios::out | std::ios::binary);
-                std::ostream out_stream(&fb);
-                ply.write(out_stream, /*binary=*/true);
-            };
+        void release(Slot* slot) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                free_.push_back(slot);
+            }
+            cv_.notify_one();
+        }
 
-        if (stem.empty()) {
-            write_output_ply(root / ("splat_" + std::to_string(iteration) + ".ply"), tensors, pc.attribute_names);
-        } else {
-            write_output_ply(root / std::string(stem + ".ply"), tensors, pc.attribute_names);
+    private:
+        static constexpr int kNumSlots = 2;
+
+        SnapshotStagingPool() {
+            for (auto& slot : slots_) {
+                free_.push_back(&slot);
+            }
+        }
+
+        Slot slots_[kNumSlots];
+        std::vector<Slot*> free_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+    };
+
+    // Model interleaved in PLY vertex order on the GPU, streamed to disk through a staging slot
+    struct PlySnapshot {
+        torch::Tensor device; // [N, A] source of the chunk copies, dropped once the last one is queued
+        at::cuda::CUDAEvent produced;
+        SnapshotStagingPool::Slot* slot = nullptr;
+        int64_t rows = 0;
+        int64_t cols = 0;
+        std::vector<std::string> attribute_names;
+
+        PlySnapshot() = default;
+        PlySnapshot(const PlySnapshot&) = delete;
+        PlySnapshot& operator=(const PlySnapshot&) = delete;
+        PlySnapshot(PlySnapshot&& other) noexcept { *this = std::move(other); }
+        PlySnapshot& operator=(PlySnapshot&& other) noexcept {
+            std::swap(device, other.device);
+            std::swap(produced, other.produced);
+            std::swap(slot, other.slot);
+            std::swap(rows, other.rows);
+            std::swap(cols, other.cols);
+            std::swap(attribute_names, other.attribute_names);
+            return *this;
+        }
+        ~PlySnapshot() {
+            if (slot) {
+                // Never hand the buffers back while a copy into them may still be in flight
+                for (auto& ready : slot->ready) {
+                    ready.synchronize();
+                }
+                SnapshotStagingPool::instance().release(slot);
+            }
+        }
+    };
+
+    // Interleaves the attributes on the current stream; this is the only work ordered before later
+    // in-place optimizer updates. The D2H copies run chunk by chunk on a side stream while writing.
+    PlySnapshot capture_ply_snapshot(const torch::Tensor& means,
+                                     const torch::Tensor& sh0,
+                                     const torch::Tensor& shN,
+                                     const torch::Tensor& opacity,
+                                     const torch::Tensor& scaling,
+                                     const torch::Tensor& rotation,
+                                     std::vector<std::string> attribute_names) {
+        torch::NoGradGuard no_grad;
+
+        PlySnapshot snapshot;
+        snapshot.device = gs::interleave_ply_vertices(means, sh0, shN, opacity, scaling, rotation);
+        snapshot.produced.record(at::cuda::getCurrentCUDAStream());
+        snapshot.rows = snapshot.device.size(0);
+        snapshot.cols = snapshot.device.size(1);
+        snapshot.attribute_names = std::move(attribute_names);
+        snapshot.slot = SnapshotStagingPool::instance().acquire(ply_chunk_rows(snapshot.cols) * snapshot.cols);
+        return snapshot;
+    }
+
+    // Streams a snapshot to disk with the chunk buffers in turn: the copy of the next chunk into
+    // one overlaps the write of the current chunk from the other
+    void write_ply_snapshot(PlySnapshot& snapshot, const std::filesystem::path& root,
+                            int iteration, const std::string& stem, bool direct_io) {
+        std::filesystem::create_directories(root);
+
+        auto& slot = *snapshot.slot;
+        const int64_t chunk_rows = ply_chunk_rows(snapshot.cols);
+        const int64_t num_chunks = (snapshot.rows + chunk_rows - 1) / chunk_rows;
+        const auto rows_of = [&](int64_t chunk) { return std::min(chunk_rows, snapshot.rows - chunk * chunk_rows); };
+
+        at::cuda::CUDAStream copy_stream = at::cuda::getStreamFromPool(false);
+        snapshot.produced.block(copy_stream);
+        const auto issue_copy = [&](int64_t chunk) {
+            const int64_t n = rows_of(chunk);
+            {
+                c10::cuda::CUDAStreamGuard guard(copy_stream);
+                slot.host[chunk % 2].narrow(0, 0, n * snapshot.cols).view({n, snapshot.cols})
+                    .copy_(snapshot.device.narrow(0, chunk * chunk_rows, n), /*non_blocking=*/true);
+            }
+            slot.ready[chunk % 2].record(copy_stream);
+            // The allocator holds the block until the queued copies are done, so the snapshot does
+            // not pin its VRAM for the rest of the disk write
+            if (chunk + 1 == num_chunks) {
+                c10::cuda::CUDACachingAllocator::recordStream(snapshot.device.storage().data_ptr(), copy_stream);
+                snapshot.device.reset();
+            }
+        };
+
+        int64_t current = 0;
+        if (num_chunks > 0) {
+            issue_copy(0);
         }
+        write_ply_vertices(ply_output_path(root, iteration, stem), snapshot.attribute_names,
+                           snapshot.rows, snapshot.cols, [&]() -> std::span<const float> {
+                               if (current == num_chunks) {
+                                   return {};
+                               }
+                               // The writer is done with the previous chunk, its buffer takes the next one
+                               if (current + 1 < num_chunks) {
+                                   issue_copy(current + 1);
+                               }
+                               slot.ready[current % 2].synchronize();
+                               const std::span<const float> chunk(slot.host[current % 2].data_ptr<float>(),
+                                                                  static_cast<size_t>(rows_of(current) * snapshot.cols));
+                               ++current;
+                               return chunk;
+                           },
+                           direct_io);
     }
 
     // returns the output path
     std::filesystem::path write_sog_impl(const gs::SplatData& splat_data,
                                          const std::filesystem::path& root,
                                          int iteration,
-                                         int kmeans_iterations) {
+                                         int kmeans_iterations,
+                                         int webp_level) {
         namespace fs = std::filesystem;
 
         // Create SOG subdirectory
@@ -183,6 +517,7 @@ namespace {
         std::filesystem::path sog_out_path = sog_dir / ("splat_" + std::to_string(iteration) + "_sog.sog");
         gs::core::SogWriteOptions options{
             .iterations = kmeans_iterations,
+            .webp_level = webp_level,
             .output_path = sog_out_path};
 
         // Write SOG format
@@ -195,6 +530,96 @@ namespace {
 
         return sog_out_path;
     }
+
+    // Real SH bases 1-15 at a direction, in the order and sign convention the rasterizers evaluate
+    std::array<double, 15> sh_rest_basis(const glm::dvec3& direction) {
+        const glm::dvec3 d = glm::normalize(direction);
+        const double x = d.x, y = d.y, z = d.z, z2 = z * z;
+        const double c1 = x * x - y * y, s1 = 2. * x * y;
+        const double c2 = x * c1 - y * s1, s2 = x * s1 + y * c1;
+        const double band2_zx = -1.092548430592079 * z;
+        const double band3_xy = -2.285228997322329 * z2 + 0.4570457994644658;
+        const double band3_z = 1.445305721320277 * z;
+        return {-0.48860251190292 * y, 0.48860251190292 * z, -0.48860251190292 * x,
+                0.5462742152960395 * s1, band2_zx * y, 0.9461746957575601 * z2 - 0.3153915652525201,
+                band2_zx * x, 0.5462742152960395 * c1,
+                -0.5900435899266435 * s2, band3_z * s1, band3_xy * y,
+                z * (1.865881662950577 * z2 - 1.119528997770346), band3_xy * x, band3_z * c1,
+                -0.5900435899266435 * c2};
+    }
+
+    // Row-major matrices D of SH bands 1-3 with f'(d) = f(R^T d) for c' = D c, fitted by least
+    // squares on a Fibonacci sphere. Exact, a band spans a rotation-invariant space.
+    void sh_band_rotations(const glm::mat3& rotation, float* out) {
+        constexpr int N_DIRECTIONS = 64;
+        const double golden_angle = std::numbers::pi * (3. - std::sqrt(5.));
+        const glm::dmat3 inverse = glm::transpose(glm::dmat3(rotation));
+
+        std::vector<std::array<double, 15>> bases(N_DIRECTIONS), rotated(N_DIRECTIONS);
+        for (int k = 0; k < N_DIRECTIONS; ++k) {
+            const double z = 1. - 2. * (k + 0.5) / N_DIRECTIONS;
+            const double r = std::sqrt(1. - z * z);
+            const glm::dvec3 d(r * std::cos(golden_angle * k), r * std::sin(golden_angle * k), z);
+            bases[k] = sh_rest_basis(d);
+            rotated[k] = sh_rest_basis(inverse * d);
+        }
+
+        int first = 0;
+        for (int band = 1; band <= 3; ++band) {
+            const int size = 2 * band + 1;
+            // Normal equations [A^T A | A^T B], A: bases, B: rotated bases; Gauss-Jordan leaves D on the right
+            std::vector<double> system(size * 2 * size, 0.);
+            for (int k = 0; k < N_DIRECTIONS; ++k) {
+                for (int i = 0; i < size; ++i) {
+                    for (int j = 0; j < size; ++j) {
+                        system[i * 2 * size + j] += bases[k][first + i] * bases[k][first + j];
+                        system[i * 2 * size + size + j] += bases[k][first + i] * rotated[k][first + j];
+                    }
+                }
+            }
+            for (int col = 0; col < size; ++col) {
+                int pivot = col;
+                for (int row = col + 1; row < size; ++row) {
+                    if (std::abs(system[row * 2 * size + col]) > std::abs(system[pivot * 2 * size + col])) {
+                        pivot = row;
+                    }
+                }
+                for (int j = 0; j < 2 * size; ++j) {
+                    std::swap(system[col * 2 * size + j], system[pivot * 2 * size + j]);
+                }
+                const double inv_pivot = 1. / system[col * 2 * size + col];
+                for (int j = 0; j < 2 * size; ++j) {
+                    system[col * 2 * size + j] *= inv_pivot;
+                }
+                for (int row = 0; row < size; ++row) {
+                    const double factor = system[row * 2 * size + col];
+                    if (row == col || factor == 0.) {
+                        continue;
+                    }
+                    for (int j = 0; j < 2 * size; ++j) {
+                        system[row * 2 * size + j] -= factor * system[col * 2 * size + j];
+                    }
+                }
+            }
+            for (int i = 0; i < size; ++i) {
+                for (int j = 0; j < size; ++j) {
+                    *out++ = static_cast<float>(system[i * 2 * size + size + j]);
+                }
+            }
+            first += size;
+        }
+    }
+
+    // Row-major top 3x4 of a column-major glm matrix
+    std::array<float, 12> affine_rows(const glm::mat4& matrix) {
+        std::array<float, 12> rows;
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 4; ++c) {
+                rows[r * 4 + c] = matrix[c][r];
+            }
+        }
+        return rows;
+    }
 } // namespace
 
 namespace gs {
@@ -228,7 +653,14 @@ namespace gs {
           _scaling(std::move(other._scaling)),
           _rotation(std::move(other._rotation)),
           _opacity(std::move(other._opacity)),
-          _densification_info(std::move(other._densification_info))
+          _densification_info(std::move(other._densification_info)),
+          _max_contribution(std::move(other._max_contribution)),
+          _sh_palette(std::move(other._sh_palette)),
+          _sh_labels(std::move(other._sh_labels)),
+          _sh_coeffs(std::move(other._sh_coeffs)),
+          _sh_basis(std::move(other._sh_basis)),
+          _gaussian_ids(std::move(other._gaussian_ids)),
+          _next_gaussian_id(other._next_gaussian_id)
     // Note: _save_mutex and _save_futures are default constructed
     {
         // Don't move the mutex or futures - each instance should have its own
@@ -253,6 +685,13 @@ namespace gs {
             _rotation = std::move(other._rotation);
             _opacity = std::move(other._opacity);
             _densification_info = std::move(other._densification_info);
+            _max_contribution = std::move(other._max_contribution);
+            _sh_palette = std::move(other._sh_palette);
+            _sh_labels = std::move(other._sh_labels);
+            _sh_coeffs = std::move(other._sh_coeffs);
+            _sh_basis = std::move(other._sh_basis);
+            _gaussian_ids = std::move(other._gaussian_ids);
+            _next_gaussian_id = other._next_gaussian_id;
 
             // Don't move the mutex or futures
         }
@@ -268,21 +707,47 @@ namespace gs {
         return _means;
     }
 
+    template <typename Compute>
+    torch::Tensor SplatData::cached_activation(ActivationCache& cache, const torch::Tensor& raw, Compute&& compute) const {
+        // Under autograd every call needs its own graph back to the raw tensor
+        if (!raw.defined() || (torch::GradMode::is_enabled() && raw.requires_grad())) {
+            return compute();
+        }
+
+        std::lock_guard lock(_activation_mutex);
+        if (cache.value.defined() && cache.source && !cache.source->expired() &&
+            cache.source->_unsafe_get_target() == raw.unsafeGetTensorImpl() && cache.version == raw._version()) {
+            return cache.value;
+        }
+        cache.value = compute();
+        cache.source.emplace(raw.getIntrusivePtr());
+        cache.version = raw._version();
+        return cache.value;
+    }
+
     torch::Tensor SplatData::get_opacity() const {
-        return torch::sigmoid(_opacity).squeeze(-1);
+        return cached_activation(_opacity_cache, _opacity, [&] {
+            return torch::sigmoid(_opacity).squeeze(-1);
+        });
     }
 
     torch::Tensor SplatData::get_rotation() const {
-        return torch::nn::functional::normalize(_rotation,
-                                                torch::nn::functional::NormalizeFuncOptions().dim(-1));
+        return cached_activation(_rotation_cache, _rotation, [&] {
+            return torch::nn::functional::normalize(_rotation,
+                                                    torch::nn::functional::NormalizeFuncOptions().dim(-1));
+        });
     }
 
     torch::Tensor SplatData::get_scaling() const {
-        return torch::exp(_scaling);
+        return cached_activation(_scaling_cache, _scaling, [&] {
+            return torch::exp(_scaling);
+        });
     }
 
     torch::Tensor SplatData::get_shs() const {
-        return torch::cat({_sh0, _shN}, 1);
+        // shN may be stored in reduced precision. Not cached, a second [N, K, 3] copy would double
+        // the largest parameter in VRAM
+        return torch::cat({_sh0, _shN.to(_sh0.scalar_type())}, 1);
     }
 
     SplatData& SplatData::transform(const glm::mat4& transform_matrix) {
@@ -292,34 +757,8 @@ namespace gs {
             return *this; // Nothing to transform
         }
 
-        const int num_points = _means.size(0);
-
-        // Keep everything on GPU for efficiency
-        auto device = _means.device();
-
-        // 1. Transform positions (means)
-        // Convert transform matrix to tensor
-        auto transform_tensor = torch::tensor({transform_matrix[0][0], transform_matrix[0][1], transform_matrix[0][2], transform_matrix[0][3],
-                                               transform_matrix[1][0], transform_matrix[1][1], transform_matrix[1][2], transform_matrix[1][3],
-                                               transform_matrix[2][0], transform_matrix[2][1], transform_matrix[2][2], transform_matrix[2][3],
-                                               transform_matrix[3][0], transform_matrix[3][1], transform_matrix[3][2], transform_matrix[3][3]},
-                                              torch::TensorOptions().dtype(torch::kFloat32).device(device))
-                                    .reshape({4, 4});
-
-        // Add homogeneous coordinate
-        auto means_homo = torch::cat({_means, torch::ones({num_points, 1}, _means.options())}, 1);
-
-        // Apply transform: (4x4) @ (Nx4)^T = (4xN), then transpose back
-        auto transformed_means = torch::matmul(transform_tensor, means_homo.t()).t();
-
-        // Extract xyz and update in-place
-        _means.index_put_({torch::indexing::Slice(), torch::indexing::Slice(0, 3)},
-                          transformed_means.index({torch::indexing::Slice(), torch::indexing::Slice(0, 3)}));
-
-        // 2. Extract rotation from transform matrix (simple method without decompose)
+        // Split off the scale by normalizing the columns, what remains is the rotation
         glm::mat3 rot_mat(transform_matrix);
-
-        // Normalize columns to remove scale
         glm::vec3 scale;
         for (int i = 0; i < 3; ++i) {
             scale[i] = glm::length(rot_mat[i]);
@@ -327,75 +766,74 @@ namespace gs {
                 rot_mat[i] /= scale[i];
             }
         }
+        const glm::quat rotation = glm::quat_cast(rot_mat);
+        // Gaussians stay isotropic under the transform, non-uniform scale is averaged
+        const float avg_scale = (scale.x + scale.y + scale.z) / 3.0f;
+
+        SplatTransform params;
+        const auto affine = affine_rows(transform_matrix);
+        std::copy(affine.begin(), affine.end(), params.affine);
+        params.quaternion[0] = rotation.w;
+        params.quaternion[1] = rotation.x;
+        params.quaternion[2] = rotation.y;
+        params.quaternion[3] = rotation.z;
+        params.log_scale = avg_scale > 0.0f ? std::log(avg_scale) : 0.0f;
+        sh_band_rotations(rot_mat, params.sh_rotation);
+
+        torch::NoGradGuard no_grad;
+        transform_splats(_means, _rotation, _scaling, _shN, params);
+
+        // Distances scale with the transform, no need to re-measure the scene
+        _scene_scale *= avg_scale;
+
+        LOG_DEBUG("Transformed {} gaussians", _means.size(0));
+        return *this;
+    }
 
-        // Convert rotation matrix to quaternion
-        glm::quat rotation = glm::quat_cast(rot_mat);
-
-        // 3. Transform rotations (quaternions) if there's rotation
-        if (std::abs(rotation.w - 1.0f) > 1e-6f) {
-            auto rot_tensor = torch::tensor({rotation.w, rotation.x, rotation.y, rotation.z},
-                                            torch::TensorOptions().dtype(torch::kFloat32).device(device));
-
-            // Quaternion multiplication: q_new = q_transform * q_original
-            auto q = _rotation; // Shape: [N, 4] in [w, x, y, z] format
-
-            // Expand rotation quaternion to match batch size
-            auto q_rot = rot_tensor.unsqueeze(0).expand({num_points, 4});
-
-            // Quaternion multiplication formula
-            auto w1 = q_rot.index({torch::indexing::Slice(), 0});
-            auto x1 = q_rot.index({torch::indexing::Slice(), 1});
-            auto y1 = q_rot.index({torch::indexing::Slice(), 2});
-            auto z1 = q_rot.index({torch::indexing::Slice(), 3});
-
-            auto w2 = q.index({torch::indexing::Slice(), 0});
-            auto x2 = q.index({torch::indexing::Slice(), 1});
-            auto y2 = q.index({torch::indexing::Slice(), 2});
-            auto z2 = q.index({torch::indexing::Slice(), 3});
-
-            _rotation.index_put_({torch::indexing::Slice(), 0}, w1 * w2 - x1 * x2 - y1 * y2 - z1 * z2);
-            _rotation.index_put_({torch::indexing::Slice(), 1}, w1 * x2 + x1 * w2 + y1 * z2 - z1 * y2);
-            _rotation.index_put_({torch::indexing::Slice(), 2}, w1 * y2 - x1 * z2 + y1 * w2 + z1 * x2);
-            _rotation.index_put_({torch::indexing::Slice(), 3}, w1 * z2 + x1 * y2 - y1 * x2 + z1 * w2);
-        }
-
-        // 4. Transform scaling (if non-uniform scale is present)
-        if (std::abs(scale.x - 1.0f) > 1e-6f ||
-            std::abs(scale.y - 1.0f) > 1e-6f ||
-            std::abs(scale.z - 1.0f) > 1e-6f) {
-
-            // Average scale factor (for isotropic gaussian scaling)
-            float avg_scale = (scale.x + scale.y + scale.z) / 3.0f;
-
-            // Since _scaling is log(scale), we add log of the scale factor
-            _scaling = _scaling + std::log(avg_scale);
+    int SplatData::get_stored_sh_degree() const {
+        if (!_shN.defined() || _shN.dim() != 3) {
+            return _max_sh_degree;
         }
-
-        // 5. Update scene scale if significant change
-        torch::Tensor scene_center = _means.mean(0);
-        torch::Tensor dists = torch::norm(_means - scene_center, 2, 1);
-        float new_scene_scale = dists.median().item<float>();
-        if (std::abs(new_scene_scale - _scene_scale) > _scene_scale * 0.1f) {
-            _scene_scale = new_scene_scale;
+        // shN holds (degree + 1)^2 - 1 bases, a partial band doesn't count
+        const auto bases = static_cast<int>(_shN.size(1)) + 1;
+        int degree = 0;
+        while ((degree + 2) * (degree + 2) <= bases) {
+            ++degree;
         }
-
-        LOG_DEBUG("Transformed {} gaussians", num_points);
-        return *this;
+        return std::min(degree, _max_sh_degree);
     }
 
     // Utility method
     void SplatData::increment_sh_degree() {
-        if (_active_sh_degree < _max_sh_degree) {
+        if (_active_sh_degree < get_stored_sh_degree()) {
             _active_sh_degree++;
         }
     }
 
     void SplatData::set_active_sh_degree(int sh_degree = 0) {
-        if (sh_degree <= _max_sh_degree) {
-            _active_sh_degree = sh_degree;
-        } else {
-            _active_sh_degree = _max_sh_degree;
+        _active_sh_degree = std::clamp(sh_degree, 0, get_stored_sh_degree());
+    }
+
+    void SplatData::gather_sh_codebook() {
+        _shN = _sh_palette.index_select(0, _sh_labels);
+    }
+
+    void SplatData::expand_sh_basis() {
+        _shN = torch::matmul(_sh_coeffs, _sh_basis.flatten(1)).view({_sh_coeffs.size(0), _sh_basis.size(1), _sh_basis.size(2)});
+    }
+
+    void SplatData::enable_gaussian_ids() {
+        _gaussian_ids = torch::arange(size(), _means.options().dtype(torch::kInt64));
+        _next_gaussian_id = size();
+    }
+
+    void SplatData::append_gaussian_ids(const int64_t count) {
+        if (!_gaussian_ids.defined() || count == 0) {
+            return;
         }
+        _gaussian_ids = append_rows(_gaussian_ids,
+                                    torch::arange(_next_gaussian_id, _next_gaussian_id + count, _gaussian_ids.options()));
+        _next_gaussian_id += count;
     }
 
     // Get attribute names for PLY format
@@ -452,21 +890,44 @@ namespace gs {
     }
 
     // Export to PLY
-    void SplatData::save_ply(const std::filesystem::path& root, int iteration, bool join_threads, std::string stem) const {
+    void SplatData::save_ply(const std::filesystem::path& root, int iteration, bool join_threads, std::string stem, bool direct_io) const {
+        if (_means.is_cuda()) {
+            auto snapshot = capture_ply_snapshot(_means, _sh0, _shN, _opacity, _scaling, _rotation, get_attribute_names());
+            if (join_threads) {
+                write_ply_snapshot(snapshot, root, iteration, stem, direct_io);
+                return;
+            }
+
+            cleanup_finished_saves();
+
+            std::lock_guard<std::mutex> lock(_save_mutex);
+            _save_futures.emplace_back(
+                std::async(std::launch::async, [snapshot = std::move(snapshot), root, iteration, stem, direct_io]() mutable {
+                    try {
+                        write_ply_snapshot(snapshot, root, iteration, stem, direct_io);
+                        LOG_INFO("Saved PLY for iteration {} to {}", iteration, ply_output_path(root, iteration, stem).string());
+                    } catch (const std::exception& e) {
+                        LOG_ERROR("Failed to save PLY for iteration {}: {}", iteration, e.what());
+                    }
+                }));
+            return;
+        }
+
         auto pc = to_point_cloud();
 
         if (join_threads) {
             // Synchronous save - wait for completion
-            write_ply_impl(pc, root, iteration, stem);
+            write_ply_impl(pc, root, iteration, stem, direct_io);
         } else {
             // Asynchronous save
             cleanup_finished_saves();
 
             std::lock_guard<std::mutex> lock(_save_mutex);
             _save_futures.emplace_back(
-                std::async(std::launch::async, [pc = std::move(pc), root, iteration, stem]() {
+                std::async(std::launch::async, [pc = std::move(pc), root, iteration, stem, direct_io]() {
                     try {
-                        write_ply_impl(pc, root, iteration, stem);
+                        write_ply_impl(pc, root, iteration, stem, direct_io);
+                        LOG_INFO("Saved PLY for iteration {} to {}", iteration, ply_output_path(root, iteration, stem).string());
                     } catch (const std::exception& e) {
                         LOG_ERROR("Failed to save PLY for iteration {}: {}", iteration, e.what());
                     }
@@ -475,10 +936,51 @@ namespace gs {
     }
 
     // Export to SOG
-    std::filesystem::path SplatData::save_sog(const std::filesystem::path& root, int iteration, int kmeans_iterations, bool join_threads) const {
-        // SOG must always be synchronous - k-means clustering is too heavy for async
-        // and the shared data access patterns don't work well with async execution
-        return write_sog_impl(*this, root, iteration, kmeans_iterations);
+    std::filesystem::path SplatData::save_sog(const std::filesystem::path& root, int iteration, int kmeans_iterations, bool join_threads, int webp_level) const {
+        if (join_threads || !_means.is_cuda()) {
+            return write_sog_impl(*this, root, iteration, kmeans_iterations, webp_level);
+        }
+
+        // Device copies on the current stream, the clustering and packing then run on a pool stream
+        // at the lowest priority so they only fill the gaps the training kernels leave
+        SplatData snapshot(_max_sh_degree,
+                           _means.detach().clone(),
+                           _sh0.detach().clone(),
+                           _shN.detach().clone(),
+                           _scaling.detach().clone(),
+                           _rotation.detach().clone(),
+                           _opacity.detach().clone(),
+                           _scene_scale);
+        at::cuda::CUDAEvent captured;
+        captured.record(at::cuda::getCurrentCUDAStream());
+
+        const auto sog_path = root / "sog" / ("splat_" + std::to_string(iteration) + "_sog.sog");
+        cleanup_finished_saves();
+
+        std::lock_guard<std::mutex> lock(_save_mutex);
+        _save_futures.emplace_back(
+            std::async(std::launch::async, [snapshot = std::move(snapshot), captured = std::move(captured),
+                                            root, iteration, kmeans_iterations, webp_level]() mutable {
+                try {
+                    at::cuda::CUDAStream stream = at::cuda::getStreamFromPool(false, snapshot.get_means().device().index());
+                    captured.block(stream);
+                    c10::cuda::CUDAStreamGuard guard(stream);
+                    write_sog_impl(snapshot, root, iteration, kmeans_iterations, webp_level);
+                    // The copies came from the training stream's pool, they are freed once this one is done
+                    stream.synchronize();
+                } catch (const std::exception& e) {
+                    LOG_ERROR("Failed to save SOG for iteration {}: {}", iteration, e.what());
+                }
+            }));
+        return sog_path;
+    }
+
+    std::filesystem::path SplatData::save_lod(const std::filesystem::path& root, int iteration) const {
+        const auto lod_path = root / "lod" / ("splat_" + std::to_string(iteration) + gs::core::SPLAT_LOD_EXTENSION);
+        if (auto result = gs::core::write_splat_lod(*this, {.output_path = lod_path}); !result) {
+            LOG_ERROR("Failed to write LOD splat file: {}", result.error());
+        }
+        return lod_path;
     }
 
     PointCloud SplatData::to_point_cloud() const {
@@ -490,7 +992,7 @@ namespace gs {
 
         // Gaussian attributes
         pc.sh0 = _sh0.transpose(1, 2).flatten(1).cpu();
-        pc.shN = _shN.transpose(1, 2).flatten(1).cpu();
+        pc.shN = _shN.transpose(1, 2).flatten(1).to(torch::kFloat32).cpu();
         pc.opacity = _opacity.cpu();
         pc.scaling = _scaling.cpu();
 
@@ -630,43 +1132,10 @@ namespace gs {
         LOG_DEBUG("Cropping {} points with bounding box: min({}, {}, {}), max({}, {}, {})",
                   num_points, bbox_min.x, bbox_min.y, bbox_min.z, bbox_max.x, bbox_max.y, bbox_max.z);
 
-        // Get transformation matrix from the EuclideanTransform
-        glm::mat4 world_to_bbox_matrix = world2bbox_transform.toMat4();
-
-        // Convert transformation matrix to tensor and move to same device as means
-        // we transpose the matrix since gl is colmn major and torch is row major
-        auto transform_tensor = torch::tensor({world_to_bbox_matrix[0][0], world_to_bbox_matrix[1][0], world_to_bbox_matrix[2][0], world_to_bbox_matrix[3][0],
-                                               world_to_bbox_matrix[0][1], world_to_bbox_matrix[1][1], world_to_bbox_matrix[2][1], world_to_bbox_matrix[3][1],
-                                               world_to_bbox_matrix[0][2], world_to_bbox_matrix[1][2], world_to_bbox_matrix[2][2], world_to_bbox_matrix[3][2],
-                                               world_to_bbox_matrix[0][3], world_to_bbox_matrix[1][3], world_to_bbox_matrix[2][3], world_to_bbox_matrix[3][3]},
-                                              torch::TensorOptions().dtype(torch::kFloat32))
-                                    .reshape({4, 4})
-                                    .to(_means.device());
-
-        // Convert means to homogeneous coordinates [N, 4]
-        auto means_homo = torch::cat({_means, torch::ones({num_points, 1}, _means.options())}, 1);
-
-        // Transform all points: (4x4) @ (Nx4)^T = (4xN), then transpose back to (Nx4)
-        auto transformed_points = torch::matmul(transform_tensor, means_homo.t()).t();
-
-        // Extract xyz coordinates (drop homogeneous coordinate)
-        auto local_points = transformed_points.index({torch::indexing::Slice(), torch::indexing::Slice(0, 3)});
-
-        // Create bounding box bounds tensors
-        auto bbox_min_tensor = torch::tensor({bbox_min.x, bbox_min.y, bbox_min.z},
-                                             torch::TensorOptions().dtype(torch::kFloat32).device(_means.device()));
-        auto bbox_max_tensor = torch::tensor({bbox_max.x, bbox_max.y, bbox_max.z},
-                                             torch::TensorOptions().dtype(torch::kFloat32).device(_means.device()));
-
-        // Check which points are inside the bounding box using tensor operations
-        auto inside_min = torch::ge(local_points, bbox_min_tensor.unsqueeze(0)); // [N, 3]
-        auto inside_max = torch::le(local_points, bbox_max_tensor.unsqueeze(0)); // [N, 3]
-
-        // Point is inside if all 3 coordinates satisfy both min and max constraints
-        auto inside_mask = torch::all(inside_min & inside_max, 1); // [N]
-
-        // Count points inside
-        int points_inside = inside_mask.sum().item<int>();
+        const auto indices = crop_box_indices(_means, affine_rows(world2bbox_transform.toMat4()),
+                                              {bbox_min.x, bbox_min.y, bbox_min.z},
+                                              {bbox_max.x, bbox_max.y, bbox_max.z});
+        const int points_inside = static_cast<int>(indices.size(0));
 
         LOG_DEBUG("Found {} points inside bounding box ({:.1f}%)",
                   points_inside, (float)points_inside / num_points * 100.0f);
@@ -676,16 +1145,13 @@ namespace gs {
             return SplatData();
         }
 
-        // Get indices of points inside the bounding box
-        auto indices = torch::nonzero(inside_mask).squeeze(1); // Get 1D tensor of indices
-
-        // Index all tensors using the mask
-        auto cropped_means = _means.index({indices}).contiguous();
-        auto cropped_sh0 = _sh0.index({indices}).contiguous();
-        auto cropped_shN = _shN.index({indices}).contiguous();
-        auto cropped_scaling = _scaling.index({indices}).contiguous();
-        auto cropped_rotation = _rotation.index({indices}).contiguous();
-        auto cropped_opacity = _opacity.index({indices}).contiguous();
+        // One gather per tensor straight into the cropped allocations
+        auto cropped_means = _means.index_select(0, indices);
+        auto cropped_sh0 = _sh0.index_select(0, indices);
+        auto cropped_shN = _shN.index_select(0, indices);
+        auto cropped_scaling = _scaling.index_select(0, indices);
+        auto cropped_rotation = _rotation.index_select(0, indices);
+        auto cropped_opacity = _opacity.index_select(0, indices);
 
         // Recalculate scene scale for the cropped data
         torch::Tensor scene_center = cropped_means.mean(0);
@@ -708,7 +1174,7 @@ namespace gs {
 
         // If densification info exists and has the right size, crop it too
         if (_densification_info.defined() && _densification_info.size(0) == num_points) {
-            cropped_splat._densification_info = _densification_info.index({indices}).contiguous();
+            cropped_splat._densification_info = _densification_info.index_select(0, indices);
         }
 
         LOG_DEBUG("Successfully cropped SplatData: {} -> {} points (scale: {:.4f} -> {:.4f})",
@@ -717,4 +1183,46 @@ namespace gs {
         return cropped_splat;
     }
 
+    SplatData SplatData::clone() const {
+        torch::NoGradGuard no_grad;
+        SplatData copy(
+            _max_sh_degree,
+            _means.detach().clone(),
+            _sh0.detach().clone(),
+            _shN.detach().clone(),
+            _scaling.detach().clone(),
+            _rotation.detach().clone(),
+            _opacity.detach().clone(),
+            _scene_scale);
+        copy._active_sh_degree = _active_sh_degree;
+        return copy;
+    }
+
+    SplatData SplatData::share() const {
+        SplatData copy(
+            _max_sh_degree,
+            _means.detach(),
+            _sh0.detach(),
+            _shN.detach(),
+            _scaling.detach(),
+            _rotation.detach(),
+            _opacity.detach(),
+            _scene_scale);
+        copy._active_sh_degree = _active_sh_degree;
+        return copy;
+    }
+
+    int64_t SplatData::capacity() const {
+        return std::min({row_capacity(_means), row_capacity(_sh0), row_capacity(_shN),
+                         row_capacity(_scaling), row_capacity(_rotation), row_capacity(_opacity)});
+    }
+
+    void SplatData::reserve(const int64_t capacity) {
+        torch::NoGradGuard no_grad;
+        for (torch::Tensor* param : {&_means, &_sh0, &_shN, &_scaling, &_rotation, &_opacity}) {
+            const bool requires_grad = param->requires_grad();
+            *param = reserve_rows(param->detach(), capacity).set_requires_grad(requires_grad);
+        }
+    }
+
 } // namespace gs
\ No newline at end of file
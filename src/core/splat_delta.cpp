@@ -0,0 +1,447 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/splat_delta.hpp"
+#include "core/logger.hpp"
+#include "kernels/ply_interleave.cuh"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <vector>
+
+namespace gs::core {
+
+    namespace {
+        // Larger deltas are stored as a full replacement, keeps every value within 3 varint bytes
+        constexpr int64_t MAX_DELTA_STEPS = (int64_t{1} << 20) - 1;
+        // A reader never replays more files than this, guards against cycles in corrupt chains
+        constexpr int MAX_CHAIN_LENGTH = 100000;
+
+        void put_varint(std::vector<uint8_t>& out, uint64_t value) {
+            while (value >= 0x80) {
+                out.push_back(static_cast<uint8_t>(value) | 0x80);
+                value >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(value));
+        }
+
+        uint64_t zigzag(const int64_t value) {
+            return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        }
+
+        int64_t unzigzag(const uint64_t value) {
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+        // ids: ascending int64 on the CPU
+        void put_ids(std::vector<uint8_t>& out, const torch::Tensor& ids) {
+            const auto* data = ids.data_ptr<int64_t>();
+            int64_t previous = 0;
+            for (int64_t i = 0; i < ids.numel(); ++i) {
+                put_varint(out, static_cast<uint64_t>(data[i] - previous));
+                previous = data[i];
+            }
+        }
+
+        class ByteReader {
+        public:
+            ByteReader(const uint8_t* data, size_t size) : data_(data),
+                                                           end_(data + size) {}
+
+            bool varint(uint64_t& value) {
+                value = 0;
+                for (int shift = 0; shift < 64 && data_ < end_; shift += 7) {
+                    const uint8_t byte = *data_++;
+                    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                    if ((byte & 0x80) == 0) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            bool bytes(void* destination, const size_t count) {
+                if (static_cast<size_t>(end_ - data_) < count) {
+                    return false;
+                }
+                std::memcpy(destination, data_, count);
+                data_ += count;
+                return true;
+            }
+
+            bool ids(const uint64_t count, torch::Tensor& ids) {
+                if (count > remaining()) { // Every id takes at least a byte
+                    return false;
+                }
+                ids = torch::empty({static_cast<int64_t>(count)}, torch::kInt64);
+                auto* data = ids.data_ptr<int64_t>();
+                uint64_t previous = 0;
+                for (uint64_t i = 0; i < count; ++i) {
+                    uint64_t gap;
+                    if (!varint(gap) || (i > 0 && gap == 0)) {
+                        return false;
+                    }
+                    previous += gap;
+                    data[i] = static_cast<int64_t>(previous);
+                }
+                return true;
+            }
+
+            size_t remaining() const { return static_cast<size_t>(end_ - data_); }
+
+        private:
+            const uint8_t* data_;
+            const uint8_t* end_;
+        };
+
+        // float32 [V] step of every value column
+        torch::Tensor column_steps(const float (&steps)[6], const uint32_t shN_coeffs) {
+            const std::array<int64_t, 6> widths = {3, 3, 3 * static_cast<int64_t>(shN_coeffs), 1, 3, 4};
+            std::vector<float> columns;
+            for (size_t a = 0; a < widths.size(); ++a) {
+                columns.insert(columns.end(), static_cast<size_t>(widths[a]), steps[a]);
+            }
+            return torch::tensor(columns, torch::kFloat32);
+        }
+
+        // Position of every needle in the ascending haystack, and whether it is there
+        std::pair<torch::Tensor, torch::Tensor> find_sorted(const torch::Tensor& haystack, const torch::Tensor& needles) {
+            if (haystack.numel() == 0) {
+                return {torch::zeros_like(needles), torch::zeros(needles.sizes(), torch::kBool)};
+            }
+            const auto positions = torch::searchsorted(haystack, needles).clamp_max(haystack.numel() - 1);
+            return {positions, haystack.index_select(0, positions).eq(needles)};
+        }
+
+        struct DeltaFile {
+            SplatDeltaHeader header;
+            std::vector<uint8_t> body;
+        };
+
+        std::expected<DeltaFile, std::string> read_delta_file(const std::filesystem::path& path) {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file) {
+                return std::unexpected(std::format("Cannot open delta file {}", path.string()));
+            }
+            const auto size = static_cast<size_t>(file.tellg());
+            DeltaFile delta;
+            if (size < sizeof(SplatDeltaHeader)) {
+                return std::unexpected(std::format("{} is too small for a delta header", path.string()));
+            }
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(&delta.header), sizeof(SplatDeltaHeader));
+            delta.body.resize(size - sizeof(SplatDeltaHeader));
+            file.read(reinterpret_cast<char*>(delta.body.data()), static_cast<std::streamsize>(delta.body.size()));
+            if (!file) {
+                return std::unexpected(std::format("Failed to read {}", path.string()));
+            }
+            if (std::memcmp(delta.header.magic, SPLAT_DELTA_MAGIC, sizeof(delta.header.magic)) != 0) {
+                return std::unexpected(std::format("{} is not a delta splat file", path.string()));
+            }
+            if (delta.header.version != SPLAT_DELTA_VERSION || delta.header.shN_coeffs > 15) {
+                return std::unexpected(std::format("{} has an unsupported version or layout", path.string()));
+            }
+            return delta;
+        }
+
+        // Applies one file to the state (ids ascending, values [M, V]) in place
+        std::expected<void, std::string> apply_delta(const DeltaFile& delta, torch::Tensor& ids, torch::Tensor& values) {
+            const auto& header = delta.header;
+            const int64_t width = splat_delta_values_per_gaussian(header.shN_coeffs);
+            if (values.size(1) != width) {
+                return std::unexpected("Delta chain changes the SH layout");
+            }
+            ByteReader reader(delta.body.data(), delta.body.size());
+            const auto corrupt = [&](const char* section) {
+                return std::unexpected(std::format("Delta file of iteration {} is corrupt in its {}", header.iteration, section));
+            };
+
+            torch::Tensor removed;
+            if (!reader.ids(header.num_removed, removed)) {
+                return corrupt("removed ids");
+            }
+            if (removed.numel() > 0) {
+                const auto [positions, found] = find_sorted(removed, ids);
+                const auto keep = found.logical_not().nonzero().squeeze(-1);
+                ids = ids.index_select(0, keep);
+                values = values.index_select(0, keep);
+            }
+
+            torch::Tensor changed;
+            if (!reader.ids(header.num_changed, changed)) {
+                return corrupt("changed ids");
+            }
+            if (changed.numel() > 0) {
+                if (header.num_changed * static_cast<uint64_t>(width) > reader.remaining()) {
+                    return corrupt("changed values");
+                }
+                auto steps = torch::empty({static_cast<int64_t>(header.num_changed), width}, torch::kInt32);
+                auto* data = steps.data_ptr<int32_t>();
+                for (int64_t i = 0; i < steps.numel(); ++i) {
+                    uint64_t value;
+                    if (!reader.varint(value)) {
+                        return corrupt("changed values");
+                    }
+                    data[i] = static_cast<int32_t>(unzigzag(value));
+                }
+                const auto [positions, found] = find_sorted(ids, changed);
+                if (!found.all().item<bool>()) {
+                    return corrupt("changed ids");
+                }
+                // Same expression as the writer's reconstruction, so both agree to the bit
+                const auto updated = values.index_select(0, positions) + steps.to(torch::kFloat32) * column_steps(header.steps, header.shN_coeffs);
+                values.index_copy_(0, positions, updated);
+            }
+
+            torch::Tensor added;
+            if (!reader.ids(header.num_added, added)) {
+                return corrupt("added ids");
+            }
+            if (added.numel() > 0) {
+                auto added_values = torch::empty({added.numel(), width}, torch::kFloat32);
+                if (!reader.bytes(added_values.data_ptr<float>(), added_values.numel() * sizeof(float))) {
+                    return corrupt("added values");
+                }
+                // Ids already present were replaced because their delta did not fit
+                const auto [positions, found] = find_sorted(ids, added);
+                const auto replaced = found.nonzero().squeeze(-1);
+                values.index_copy_(0, positions.index_select(0, replaced), added_values.index_select(0, replaced));
+                const auto fresh = found.logical_not().nonzero().squeeze(-1);
+                if (fresh.numel() > 0) {
+                    ids = torch::cat({ids, added.index_select(0, fresh)});
+                    values = torch::cat({values, added_values.index_select(0, fresh)});
+                    const auto order = std::get<1>(ids.sort());
+                    ids = ids.index_select(0, order);
+                    values = values.index_select(0, order);
+                }
+            }
+
+            if (reader.remaining() != 0 || static_cast<uint64_t>(ids.numel()) != header.num_gaussians) {
+                return corrupt("Gaussian count");
+            }
+            return {};
+        }
+    } // namespace
+
+    std::filesystem::path splat_delta_path(const std::filesystem::path& directory, const int iteration) {
+        return directory / ("splat_" + std::to_string(iteration) + SPLAT_DELTA_EXTENSION);
+    }
+
+    SplatDeltaWriter::SplatDeltaWriter(Options options) : options_(std::move(options)) {}
+
+    SplatDeltaWriter::~SplatDeltaWriter() {
+        wait();
+    }
+
+    void SplatDeltaWriter::wait() {
+        if (pending_.valid()) {
+            pending_.wait();
+        }
+    }
+
+    std::filesystem::path SplatDeltaWriter::save(const SplatData& splat_data, const int iteration, const bool join) {
+        torch::NoGradGuard no_grad;
+        TORCH_CHECK(splat_data._gaussian_ids.defined() && splat_data._gaussian_ids.numel() == splat_data.size(),
+                    "delta saves need the Gaussian ids enabled");
+
+        // Each file is diffed against the one before it
+        wait();
+
+        // PLY records without the normals, on the host before training moves on
+        const auto records = gs::interleave_ply_vertices(splat_data.means(), splat_data.sh0(), splat_data.shN(),
+                                                         splat_data.opacity_raw(), splat_data.scaling_raw(),
+                                                         splat_data.rotation_raw());
+        Snapshot snapshot{
+            .ids = splat_data._gaussian_ids.cpu(),
+            .values = torch::cat({records.narrow(1, 0, 3), records.narrow(1, 6, records.size(1) - 6)}, 1).cpu(),
+            .iteration = iteration,
+            .sh_degree = static_cast<uint32_t>(splat_data.get_max_sh_degree()),
+            .shN_coeffs = static_cast<uint32_t>(splat_data.shN().size(1)),
+            .scene_scale = splat_data.get_scene_scale()};
+
+        const auto path = splat_delta_path(options_.directory, iteration);
+        auto task = [this, snapshot = std::move(snapshot)]() mutable {
+            try {
+                if (auto result = write(std::move(snapshot)); !result) {
+                    LOG_ERROR("Failed to write delta splat file: {}", result.error());
+                }
+            } catch (const std::exception& e) {
+                LOG_ERROR("Failed to write delta splat file: {}", e.what());
+            }
+        };
+        if (join) {
+            task();
+        } else {
+            pending_ = std::async(std::launch::async, std::move(task));
+        }
+        return path;
+    }
+
+    std::expected<void, std::string> SplatDeltaWriter::write(Snapshot snapshot) {
+        torch::NoGradGuard no_grad;
+        namespace fs = std::filesystem;
+
+        const auto order = std::get<1>(snapshot.ids.sort());
+        const auto ids = snapshot.ids.index_select(0, order);
+        const auto values = snapshot.values.index_select(0, order).contiguous();
+        const int64_t width = values.size(1);
+        if (width != splat_delta_values_per_gaussian(snapshot.shN_coeffs)) {
+            return std::unexpected("Unexpected value layout for a delta save");
+        }
+
+        SplatDeltaHeader header{};
+        std::memcpy(header.magic, SPLAT_DELTA_MAGIC, sizeof(header.magic));
+        header.version = SPLAT_DELTA_VERSION;
+        header.iteration = snapshot.iteration;
+        header.sh_degree = snapshot.sh_degree;
+        header.shN_coeffs = snapshot.shN_coeffs;
+        header.scene_scale = snapshot.scene_scale;
+        const float steps[6] = {options_.means_step * std::max(snapshot.scene_scale, 1e-6f),
+                                options_.sh0_step,
+                                options_.shN_step,
+                                options_.opacity_step,
+                                options_.scaling_step,
+                                options_.rotation_step};
+        std::copy(std::begin(steps), std::end(steps), header.steps);
+        header.num_gaussians = static_cast<uint64_t>(ids.numel());
+
+        const bool keyframe = !reference_ids_.defined() || reference_ids_.numel() == 0 ||
+                              reference_values_.size(1) != width ||
+                              saves_since_keyframe_ + 1 >= options_.keyframe_interval;
+        header.base_iteration = keyframe ? -1 : reference_iteration_;
+
+        std::vector<uint8_t> body;
+        torch::Tensor reconstructed;
+        torch::Tensor added_values;
+        if (keyframe) {
+            header.num_added = header.num_gaussians;
+            put_ids(body, ids);
+            added_values = values;
+            reconstructed = values;
+        } else {
+            const auto [reference_rows, matched] = find_sorted(reference_ids_, ids);
+            const auto [unused, kept] = find_sorted(ids, reference_ids_);
+            const auto removed = reference_ids_.index_select(0, kept.logical_not().nonzero().squeeze(-1));
+
+            const auto column_step = column_steps(header.steps, header.shN_coeffs);
+            const auto reference = reference_values_.index_select(0, reference_rows);
+            const auto quantized = torch::round((values - reference) / column_step);
+            const auto fits = matched.logical_and(quantized.abs().le(static_cast<double>(MAX_DELTA_STEPS)).all(1));
+            const auto moved = quantized.ne(0).any(1);
+
+            const auto changed_rows = fits.logical_and(moved).nonzero().squeeze(-1);
+            const auto added_rows = fits.logical_not().nonzero().squeeze(-1);
+            const auto changed_steps = quantized.index_select(0, changed_rows).to(torch::kInt32).contiguous();
+
+            header.num_removed = static_cast<uint64_t>(removed.numel());
+            header.num_changed = static_cast<uint64_t>(changed_rows.numel());
+            header.num_added = static_cast<uint64_t>(added_rows.numel());
+
+            put_ids(body, removed);
+            put_ids(body, ids.index_select(0, changed_rows));
+            const auto* step_data = changed_steps.data_ptr<int32_t>();
+            for (int64_t i = 0; i < changed_steps.numel(); ++i) {
+                put_varint(body, zigzag(step_data[i]));
+            }
+            put_ids(body, ids.index_select(0, added_rows));
+            added_values = values.index_select(0, added_rows).contiguous();
+
+            // What a reader rebuilds: unchanged rows keep the reference, changed ones add the steps
+            reconstructed = values.clone();
+            const auto updated = reference.index_select(0, changed_rows) +
+                                 changed_steps.to(torch::kFloat32) * column_step;
+            reconstructed.index_copy_(0, changed_rows, updated);
+            const auto still_rows = fits.logical_and(moved.logical_not()).nonzero().squeeze(-1);
+            reconstructed.index_copy_(0, still_rows, reference.index_select(0, still_rows));
+        }
+        const auto* added_bytes = reinterpret_cast<const uint8_t*>(added_values.data_ptr<float>());
+        body.insert(body.end(), added_bytes, added_bytes + added_values.numel() * sizeof(float));
+
+        fs::create_directories(options_.directory);
+        const auto path = splat_delta_path(options_.directory, snapshot.iteration);
+        const auto tmp_path = fs::path(path.string() + ".tmp");
+        {
+            std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(body.data()), static_cast<std::streamsize>(body.size()));
+            if (!file) {
+                fs::remove(tmp_path);
+                return std::unexpected(std::format("Failed to write {}", path.string()));
+            }
+        }
+        fs::rename(tmp_path, path);
+
+        // Only a file on disk moves the reference, a failed save leaves the chain intact
+        reference_ids_ = ids;
+        reference_values_ = reconstructed;
+        reference_iteration_ = snapshot.iteration;
+        saves_since_keyframe_ = keyframe ? 0 : saves_since_keyframe_ + 1;
+
+        LOG_INFO("Delta save of iteration {}: {} removed, {} changed, {} added ({:.1f} MB)",
+                 snapshot.iteration, header.num_removed, header.num_changed, header.num_added,
+                 static_cast<double>(sizeof(header) + body.size()) / (1024.0 * 1024.0));
+        return {};
+    }
+
+    std::expected<SplatData, std::string> materialize_splat_delta(const std::filesystem::path& directory,
+                                                                  const int iteration) {
+        try {
+            torch::NoGradGuard no_grad;
+
+            // Walk back to the keyframe, then replay forward
+            std::vector<DeltaFile> chain;
+            for (int current = iteration;;) {
+                auto delta = read_delta_file(splat_delta_path(directory, current));
+                if (!delta) {
+                    return std::unexpected(delta.error());
+                }
+                const int base = delta->header.base_iteration;
+                chain.push_back(std::move(*delta));
+                if (base < 0) {
+                    break;
+                }
+                if (base >= current || static_cast<int>(chain.size()) >= MAX_CHAIN_LENGTH) {
+                    return std::unexpected(std::format("Delta chain of iteration {} does not lead to a keyframe", iteration));
+                }
+                current = base;
+            }
+
+            const auto& last = chain.front().header;
+            const int64_t width = splat_delta_values_per_gaussian(last.shN_coeffs);
+            auto ids = torch::empty({0}, torch::kInt64);
+            auto values = torch::empty({0, width}, torch::kFloat32);
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+                if (auto result = apply_delta(*it, ids, values); !result) {
+                    return std::unexpected(result.error());
+                }
+            }
+
+            const int64_t n = values.size(0);
+            const int64_t coeffs = last.shN_coeffs;
+            int64_t column = 0;
+            const auto take = [&](const int64_t count) {
+                auto slice = values.narrow(1, column, count).contiguous();
+                column += count;
+                return slice;
+            };
+            auto means = take(3);
+            auto sh0 = take(3).view({n, 1, 3});
+            auto shN = take(3 * coeffs).view({n, 3, coeffs}).transpose(1, 2).contiguous();
+            auto opacity = take(1);
+            auto scaling = take(3);
+            auto rotation = take(4);
+
+            SplatData splat_data(static_cast<int>(last.sh_degree), means, sh0, shN, scaling, rotation, opacity,
+                                 last.scene_scale);
+            splat_data.set_active_sh_degree(static_cast<int>(last.sh_degree));
+            LOG_INFO("Materialized iteration {} from {} delta files: {} gaussians", iteration, chain.size(), n);
+            return splat_data;
+        } catch (const std::exception& e) {
+            return std::unexpected(std::format("Failed to materialize delta splat files: {}", e.what()));
+        }
+    }
+
+} // namespace gs::core
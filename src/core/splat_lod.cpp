@@ -0,0 +1,268 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/splat_lod.hpp"
+#include "core/logger.hpp"
+#include "kernels/morton_encoding.cuh"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <torch/torch.h>
+#include <vector>
+
+namespace gs::core {
+
+    namespace {
+        // Chunks merged per pass, bounds the [n, 3, 3] covariances on the device
+        constexpr int64_t CHUNKS_PER_PASS = 64;
+
+        // Level 0 attributes in Morton order, all float32 on the device
+        struct SortedSplats {
+            torch::Tensor means;     // [N, 3]
+            torch::Tensor sh0;       // [N, 3]
+            torch::Tensor shN;       // [N, shN_coeffs * 3]
+            torch::Tensor log_scale; // [N, 3]
+            torch::Tensor rotation;  // [N, 4] normalized
+            torch::Tensor opacity;   // [N] logit
+
+            SortedSplats slice(const int64_t begin, const int64_t end) const {
+                return {means.slice(0, begin, end), sh0.slice(0, begin, end), shN.slice(0, begin, end),
+                        log_scale.slice(0, begin, end), rotation.slice(0, begin, end), opacity.slice(0, begin, end)};
+            }
+        };
+
+        torch::Tensor quaternion_to_matrix(const torch::Tensor& q) {
+            const auto w = q.select(1, 0), x = q.select(1, 1), y = q.select(1, 2), z = q.select(1, 3);
+            return torch::stack({1 - 2 * (y * y + z * z), 2 * (x * y - w * z), 2 * (x * z + w * y),
+                                 2 * (x * y + w * z), 1 - 2 * (x * x + z * z), 2 * (y * z - w * x),
+                                 2 * (x * z - w * y), 2 * (y * z + w * x), 1 - 2 * (x * x + y * y)},
+                                1)
+                .view({-1, 3, 3});
+        }
+
+        torch::Tensor matrix_to_quaternion(const torch::Tensor& m) {
+            const auto m00 = m.select(1, 0).select(1, 0), m11 = m.select(1, 1).select(1, 1), m22 = m.select(1, 2).select(1, 2);
+            const auto w = 0.5 * torch::sqrt(torch::clamp_min(1 + m00 + m11 + m22, 0));
+            const auto x = 0.5 * torch::sqrt(torch::clamp_min(1 + m00 - m11 - m22, 0));
+            const auto y = 0.5 * torch::sqrt(torch::clamp_min(1 - m00 + m11 - m22, 0));
+            const auto z = 0.5 * torch::sqrt(torch::clamp_min(1 - m00 - m11 + m22, 0));
+            const auto at = [&](int r, int c) { return m.select(1, r).select(1, c); };
+            const auto q = torch::stack({w,
+                                         torch::copysign(x, at(2, 1) - at(1, 2)),
+                                         torch::copysign(y, at(0, 2) - at(2, 0)),
+                                         torch::copysign(z, at(1, 0) - at(0, 1))},
+                                        1);
+            return torch::nn::functional::normalize(q, torch::nn::functional::NormalizeFuncOptions().dim(1));
+        }
+
+        // Moment-matches every group of Gaussians with one: weights are opacity times volume, the
+        // merged covariance holds the members' covariances and the spread of their means. The
+        // opacity keeps the members' opacity-weighted footprint (two largest axes), capped at 0.99.
+        SortedSplats merge_groups(const SortedSplats& s, const torch::Tensor& group, const int64_t num_groups) {
+            const auto scale = torch::exp(s.log_scale).to(torch::kFloat64);
+            const auto alpha = torch::sigmoid(s.opacity).to(torch::kFloat64);
+            const auto volume = scale.prod(1);
+            const auto footprint = volume / std::get<0>(scale.min(1));
+            const auto weight = alpha * volume + 1e-30;
+
+            auto sum_rows = [&](const torch::Tensor& values) {
+                auto out = torch::zeros({num_groups, values.size(1)}, values.options());
+                return out.index_add_(0, group, values);
+            };
+            const auto weight_sum = sum_rows(weight.unsqueeze(1));
+            const auto average = [&](const torch::Tensor& values) {
+                return sum_rows(values.to(torch::kFloat64) * weight.unsqueeze(1)) / weight_sum;
+            };
+
+            const auto means = s.means.to(torch::kFloat64);
+            const auto merged_means = average(means);
+
+            const auto rotation = quaternion_to_matrix(s.rotation.to(torch::kFloat64));
+            const auto offset = means - merged_means.index_select(0, group);
+            const auto covariance = torch::matmul(rotation * (scale * scale).unsqueeze(1), rotation.transpose(1, 2)) +
+                                    offset.unsqueeze(2) * offset.unsqueeze(1);
+            const auto merged_covariance = average(covariance.view({-1, 9})).view({-1, 3, 3});
+
+            // Ascending eigenvalues, the eigenvectors form the rotation once it is proper
+            auto [eigenvalues, eigenvectors] = torch::linalg_eigh(merged_covariance);
+            const auto flip = 1.0 - 2.0 * (torch::linalg_det(eigenvectors) < 0).to(torch::kFloat64);
+            eigenvectors.select(2, 0).mul_(flip.unsqueeze(1));
+            const auto merged_scale = torch::sqrt(torch::clamp_min(eigenvalues, 1e-20));
+            const auto merged_footprint = merged_scale.select(1, 1) * merged_scale.select(1, 2);
+
+            const auto covered = sum_rows((alpha * footprint).unsqueeze(1)).squeeze(1);
+            const auto merged_alpha = torch::clamp(covered / merged_footprint, 1e-6, 0.99);
+
+            return {merged_means.to(torch::kFloat32),
+                    average(s.sh0).to(torch::kFloat32),
+                    s.shN.size(1) > 0 ? average(s.shN).to(torch::kFloat32) : s.shN.new_empty({num_groups, 0}),
+                    torch::log(merged_scale).to(torch::kFloat32),
+                    matrix_to_quaternion(eigenvectors).to(torch::kFloat32),
+                    torch::logit(merged_alpha).to(torch::kFloat32)};
+        }
+
+        void write_padding(std::ofstream& file, uint64_t& position) {
+            static const std::vector<char> zeros(SPLAT_LOD_ALIGNMENT, 0);
+            const uint64_t padding = (SPLAT_LOD_ALIGNMENT - position % SPLAT_LOD_ALIGNMENT) % SPLAT_LOD_ALIGNMENT;
+            file.write(zeros.data(), static_cast<std::streamsize>(padding));
+            position += padding;
+        }
+
+        void write_rows(std::ofstream& file, uint64_t& position, const torch::Tensor& host, const int64_t begin, const int64_t count) {
+            if (host.size(1) == 0 || count == 0) {
+                return;
+            }
+            const auto bytes = static_cast<uint64_t>(count * host.size(1)) * sizeof(float);
+            file.write(reinterpret_cast<const char*>(host.data_ptr<float>() + begin * host.size(1)),
+                       static_cast<std::streamsize>(bytes));
+            position += bytes;
+        }
+    } // namespace
+
+    std::expected<void, std::string> write_splat_lod(
+        const SplatData& splat_data,
+        const SplatLodWriteOptions& options) {
+
+        try {
+            torch::NoGradGuard no_grad;
+            LOG_INFO("Writing LOD splat file to: {}", options.output_path.string());
+
+            const int64_t n = splat_data.size();
+            if (n == 0) {
+                return std::unexpected("No splats to write");
+            }
+            if (options.chunk_size <= 0 || options.max_levels <= 0) {
+                return std::unexpected("LOD chunk size and level count must be positive");
+            }
+
+            const auto device = torch::kCUDA;
+            const auto means = splat_data.means().to(device, torch::kFloat32).contiguous();
+            const auto order = morton_sort_indices(morton_encode(means));
+            const auto sorted = [&](const torch::Tensor& t) {
+                return t.to(device, torch::kFloat32).index_select(0, order).contiguous();
+            };
+            const auto shN = splat_data.shN().defined() ? splat_data.shN() : torch::empty({n, 0, 3});
+            const uint32_t shN_coeffs = static_cast<uint32_t>(shN.dim() >= 2 ? shN.size(1) : 0);
+            const SortedSplats splats{
+                means.index_select(0, order),
+                sorted(splat_data.sh0().reshape({n, 3})),
+                sorted(shN.reshape({n, static_cast<int64_t>(shN_coeffs) * 3})),
+                sorted(splat_data.scaling_raw()),
+                sorted(torch::nn::functional::normalize(splat_data.rotation_raw(),
+                                                        torch::nn::functional::NormalizeFuncOptions().dim(-1))),
+                sorted(splat_data.opacity_raw().reshape({n}))};
+
+            const int64_t chunk_size = options.chunk_size;
+            const int64_t num_chunks = (n + chunk_size - 1) / chunk_size;
+            int64_t num_levels = 1;
+            for (int64_t group = 4; num_levels < options.max_levels; group *= 4, ++num_levels) {
+                if ((std::min(chunk_size, n) + group - 1) / group < options.min_block_size) {
+                    break;
+                }
+            }
+
+            std::filesystem::create_directories(options.output_path.parent_path());
+            std::ofstream file(options.output_path, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                return std::unexpected(std::format("Failed to open {} for writing", options.output_path.string()));
+            }
+
+            SplatLodHeader header{};
+            std::memcpy(header.magic, SPLAT_LOD_MAGIC, sizeof(header.magic));
+            header.version = SPLAT_LOD_VERSION;
+            header.sh_degree = shN_coeffs >= 15 ? 3 : shN_coeffs >= 8 ? 2 : shN_coeffs >= 3 ? 1 : 0;
+            header.shN_coeffs = shN_coeffs;
+            header.num_chunks = static_cast<uint32_t>(num_chunks);
+            header.num_levels = static_cast<uint32_t>(num_levels);
+            header.scene_scale = splat_data.get_scene_scale();
+            header.num_gaussians = static_cast<uint64_t>(n);
+            header.table_offset = sizeof(SplatLodHeader);
+
+            // Chunk-major table, filled in while the levels are written and rewritten at the end
+            std::vector<SplatLodBlock> table(static_cast<size_t>(num_chunks * num_levels));
+            uint64_t position = header.table_offset + table.size() * sizeof(SplatLodBlock);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(SplatLodBlock)));
+
+            for (int64_t level = 0; level < num_levels; ++level) {
+                const int64_t group_size = int64_t(1) << (2 * level);
+                const int64_t groups_per_chunk = (chunk_size + group_size - 1) / group_size;
+
+                for (int64_t first_chunk = 0; first_chunk < num_chunks; first_chunk += CHUNKS_PER_PASS) {
+                    const int64_t last_chunk = std::min(num_chunks, first_chunk + CHUNKS_PER_PASS);
+                    const int64_t begin = first_chunk * chunk_size;
+                    const int64_t end = std::min(n, last_chunk * chunk_size);
+                    SortedSplats pass = splats.slice(begin, end);
+
+                    // Every chunk but the last is full, so the group ids of a pass are dense
+                    if (level > 0) {
+                        const auto local = torch::arange(end - begin, means.options().dtype(torch::kInt64));
+                        const auto group = local.div(chunk_size, "floor") * groups_per_chunk +
+                                           local.remainder(chunk_size).div(group_size, "floor");
+                        const int64_t num_groups = (last_chunk - first_chunk - 1) * groups_per_chunk +
+                                                   (end - (last_chunk - 1) * chunk_size + group_size - 1) / group_size;
+                        pass = merge_groups(pass, group, num_groups);
+                    }
+
+                    // Bounds of every block: means padded by 3 sigma of the largest axis
+                    const int64_t rows = pass.means.size(0);
+                    const auto block = torch::arange(rows, means.options().dtype(torch::kInt64)).div(groups_per_chunk, "floor");
+                    const auto pad = 3.0f * torch::exp(std::get<0>(pass.log_scale.max(1))).unsqueeze(1);
+                    const auto block_index = block.unsqueeze(1).expand({rows, 3});
+                    const auto blocks_in_pass = last_chunk - first_chunk;
+                    const auto lo = torch::zeros({blocks_in_pass, 3}, means.options())
+                                        .scatter_reduce(0, block_index, pass.means - pad, "amin", /*include_self=*/false)
+                                        .cpu();
+                    const auto hi = torch::zeros({blocks_in_pass, 3}, means.options())
+                                        .scatter_reduce(0, block_index, pass.means + pad, "amax", /*include_self=*/false)
+                                        .cpu();
+                    const auto lo_bounds = lo.accessor<float, 2>();
+                    const auto hi_bounds = hi.accessor<float, 2>();
+
+                    const std::array<torch::Tensor, 6> host = {
+                        pass.means.cpu().contiguous(), pass.sh0.cpu().contiguous(), pass.shN.cpu().contiguous(),
+                        pass.log_scale.cpu().contiguous(), pass.rotation.cpu().contiguous(),
+                        pass.opacity.reshape({rows, 1}).cpu().contiguous()};
+
+                    for (int64_t c = 0; c < blocks_in_pass; ++c) {
+                        const int64_t row_begin = c * groups_per_chunk;
+                        const int64_t count = std::min(rows, row_begin + groups_per_chunk) - row_begin;
+                        write_padding(file, position);
+
+                        SplatLodBlock& entry = table[static_cast<size_t>((first_chunk + c) * num_levels + level)];
+                        entry.chunk = static_cast<uint32_t>(first_chunk + c);
+                        entry.level = static_cast<uint32_t>(level);
+                        entry.offset = position;
+                        entry.count = static_cast<uint64_t>(count);
+                        for (int i = 0; i < 3; ++i) {
+                            entry.bounds_min[i] = lo_bounds[c][i];
+                            entry.bounds_max[i] = hi_bounds[c][i];
+                        }
+                        for (const auto& attribute : host) {
+                            write_rows(file, position, attribute, row_begin, count);
+                        }
+                    }
+                }
+                LOG_DEBUG("LOD level {} written, groups of {}", level, group_size);
+            }
+
+            file.seekp(static_cast<std::streamoff>(header.table_offset));
+            file.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(SplatLodBlock)));
+            file.close();
+            if (!file) {
+                return std::unexpected(std::format("Failed to write {}", options.output_path.string()));
+            }
+
+            LOG_INFO("Wrote {} splats as {} chunks x {} levels to {}", n, num_chunks, num_levels,
+                     options.output_path.string());
+            return {};
+
+        } catch (const std::exception& e) {
+            LOG_ERROR("Exception in write_splat_lod: {}", e.what());
+            return std::unexpected(std::format("Failed to write LOD splat file: {}", e.what()));
+        }
+    }
+} // namespace gs::core
@@ -0,0 +1,148 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/thread_placement.hpp"
+#include "core/logger.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cuda_runtime_api.h>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace gs::core {
+
+    namespace {
+        // "0-15,32-47" to the listed CPUs
+        std::vector<int> parse_cpu_list(const std::string& list) {
+            std::vector<int> cpus;
+            std::stringstream ranges(list);
+            std::string range;
+            while (std::getline(ranges, range, ',')) {
+                const auto dash = range.find('-');
+                try {
+                    const int first = std::stoi(range.substr(0, dash));
+                    const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                    for (int cpu = first; cpu <= last; ++cpu) {
+                        cpus.push_back(cpu);
+                    }
+                } catch (const std::exception&) {
+                    return {};
+                }
+            }
+            return cpus;
+        }
+
+        std::vector<int> process_cpus() {
+            std::vector<int> cpus;
+#ifdef __linux__
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+                for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                    if (CPU_ISSET(cpu, &set)) {
+                        cpus.push_back(cpu);
+                    }
+                }
+            }
+#endif
+            if (cpus.empty()) {
+                const int count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+                for (int cpu = 0; cpu < count; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            }
+            return cpus;
+        }
+
+        // CPUs sysfs lists for the device's PCI function, empty when unknown
+        std::vector<int> device_local_cpus(int cuda_device) {
+#ifdef __linux__
+            char bus_id[32] = {};
+            if (cudaDeviceGetPCIBusId(bus_id, sizeof(bus_id), cuda_device) != cudaSuccess) {
+                return {};
+            }
+            std::string id(bus_id);
+            std::transform(id.begin(), id.end(), id.begin(), [](unsigned char ch) { return std::tolower(ch); });
+            std::ifstream file("/sys/bus/pci/devices/" + id + "/local_cpulist");
+            std::string list;
+            if (file && std::getline(file, list)) {
+                return parse_cpu_list(list);
+            }
+#else
+            (void)cuda_device;
+#endif
+            return {};
+        }
+    } // namespace
+
+    ThreadPlacement& ThreadPlacement::get() {
+        static ThreadPlacement instance;
+        return instance;
+    }
+
+    void ThreadPlacement::configure(int cuda_device, bool pin) {
+        auto cpus = process_cpus();
+        const auto local = device_local_cpus(cuda_device);
+        std::vector<int> placed;
+        std::set_intersection(cpus.begin(), cpus.end(), local.begin(), local.end(), std::back_inserter(placed));
+        if (!placed.empty()) {
+            cpus = std::move(placed);
+        } else if (pin) {
+            LOG_WARN("CPUs local to CUDA device {} are unknown, worker threads are not pinned", cuda_device);
+            pin = false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        cpus_ = std::move(cpus);
+        pin_ = pin;
+        if (pin_) {
+            LOG_INFO("Worker threads pinned to the {} CPUs local to CUDA device {}", cpus_.size(), cuda_device);
+        }
+    }
+
+    void ThreadPlacement::pin_current_thread() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!pin_) {
+            return;
+        }
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (const int cpu : cpus_) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &set);
+            }
+        }
+        if (const int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set); err != 0) {
+            LOG_DEBUG("pthread_setaffinity_np failed: {}", err);
+        }
+#endif
+    }
+
+    std::vector<int> ThreadPlacement::cpus() const {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!cpus_.empty()) {
+                return cpus_;
+            }
+        }
+        return process_cpus();
+    }
+
+    ThreadBudget split_thread_budget(int budget, int requested_workers) {
+        ThreadBudget split;
+        split.loader_workers = std::clamp(requested_workers, 1, std::max(1, budget));
+        split.image_io_threads = std::max(1, budget - split.loader_workers);
+        return split;
+    }
+
+} // namespace gs::core
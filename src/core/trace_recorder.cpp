@@ -0,0 +1,269 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/trace_recorder.hpp"
+#include "core/logger.hpp"
+#include <algorithm>
+#include <c10/cuda/CUDAStream.h>
+#include <format>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+namespace gs::core {
+
+    namespace {
+        constexpr size_t MAX_PENDING_GPU_SPANS = 8192; // Beyond that the GPU side stops being traced
+        constexpr float REANCHOR_MS = 10000.f;         // Float milliseconds stay at microsecond precision below this
+
+        std::atomic<uint32_t> next_track{1};
+
+        std::string quoted(const std::string& value) {
+            return nlohmann::json(value).dump();
+        }
+    } // namespace
+
+    TraceRecorder& TraceRecorder::get() {
+        static TraceRecorder instance;
+        return instance;
+    }
+
+    TraceRecorder::~TraceRecorder() {
+        // The CUDA context may be gone at exit, the events die with it
+        if (recording_.load()) {
+            return;
+        }
+        for (cudaEvent_t event : events_) {
+            cudaEventDestroy(event);
+        }
+        if (reference_) {
+            cudaEventDestroy(reference_);
+        }
+    }
+
+    void TraceRecorder::start(std::filesystem::path output, size_t capacity) {
+        std::lock_guard lock(mutex_);
+        if (recording_.load()) {
+            LOG_WARN("Trace already recording to {}, ignoring {}", output_.string(), output.string());
+            return;
+        }
+        output_ = std::move(output);
+        ring_.assign(std::max<size_t>(capacity, 1), Span{});
+        next_ = 0;
+        wrapped_ = false;
+        dropped_ = 0;
+        recording_.store(true);
+        LOG_INFO("Recording a trace of the newest {} spans to {}", ring_.size(), output_.string());
+    }
+
+    std::expected<void, std::string> TraceRecorder::stop() {
+        std::lock_guard lock(mutex_);
+        if (!recording_.exchange(false)) {
+            return {};
+        }
+        drain(true);
+        auto written = write();
+        if (written) {
+            const size_t spans = wrapped_ ? ring_.size() : next_;
+            LOG_INFO("Trace of {} spans written to {}", spans, output_.string());
+            if (dropped_ > 0) {
+                LOG_INFO("{} older spans were overwritten in the trace ring buffer", dropped_);
+            }
+        }
+        ring_.clear();
+        ring_.shrink_to_fit();
+        return written;
+    }
+
+    uint32_t TraceRecorder::thread_track() {
+        thread_local const uint32_t track = next_track.fetch_add(1);
+        return track;
+    }
+
+    void TraceRecorder::set_thread_name(std::string name) {
+        const uint32_t track = thread_track();
+        std::lock_guard lock(mutex_);
+        thread_names_[track] = std::move(name);
+    }
+
+    int64_t TraceRecorder::now_ns() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch_).count();
+    }
+
+    void TraceRecorder::add_host_span(const char* name, int64_t begin_ns, int64_t end_ns) {
+        const uint32_t track = thread_track();
+        std::lock_guard lock(mutex_);
+        if (!recording_.load()) {
+            return;
+        }
+        push({.name = name, .begin_ns = begin_ns, .duration_ns = end_ns - begin_ns, .track = track});
+    }
+
+    cudaEvent_t TraceRecorder::acquire_event() {
+        if (!events_.empty()) {
+            cudaEvent_t event = events_.back();
+            events_.pop_back();
+            return event;
+        }
+        cudaEvent_t event = nullptr;
+        if (cudaEventCreateWithFlags(&event, cudaEventDefault) != cudaSuccess) {
+            return nullptr;
+        }
+        return event;
+    }
+
+    cudaEvent_t TraceRecorder::begin_gpu_span() {
+        if (!recording()) {
+            return nullptr;
+        }
+        std::lock_guard lock(mutex_);
+        if (pending_.size() >= MAX_PENDING_GPU_SPANS) {
+            drain(false);
+            if (pending_.size() >= MAX_PENDING_GPU_SPANS) {
+                return nullptr;
+            }
+        }
+        const cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+        if (!reference_) {
+            // The one sync of a recording, it ties GPU time to the host clock
+            reference_ = acquire_event();
+            if (!reference_ || cudaEventRecord(reference_, stream) != cudaSuccess ||
+                cudaEventSynchronize(reference_) != cudaSuccess) {
+                if (reference_) {
+                    events_.push_back(reference_);
+                    reference_ = nullptr;
+                }
+                return nullptr;
+            }
+            reference_ns_ = now_ns();
+        }
+        cudaEvent_t begin = acquire_event();
+        if (begin && cudaEventRecord(begin, stream) != cudaSuccess) {
+            events_.push_back(begin);
+            return nullptr;
+        }
+        return begin;
+    }
+
+    void TraceRecorder::end_gpu_span(const char* name, cudaEvent_t begin) {
+        if (!begin) {
+            return;
+        }
+        std::lock_guard lock(mutex_);
+        cudaEvent_t end = recording_.load() ? acquire_event() : nullptr;
+        const cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+        if (!end || cudaEventRecord(end, stream) != cudaSuccess) {
+            events_.push_back(begin);
+            if (end) {
+                events_.push_back(end);
+            }
+            return;
+        }
+        const auto [track, inserted] = stream_tracks_.try_emplace(stream, static_cast<uint32_t>(stream_tracks_.size() + 1));
+        pending_.push_back({.name = name, .begin = begin, .end = end, .track = track->second});
+        drain(false);
+    }
+
+    void TraceRecorder::drain(bool wait) {
+        while (!pending_.empty()) {
+            const PendingGpuSpan span = pending_.front();
+            const cudaError_t state = wait ? cudaEventSynchronize(span.end) : cudaEventQuery(span.end);
+            if (state == cudaErrorNotReady) {
+                break;
+            }
+            pending_.pop_front();
+
+            float begin_ms = 0.f;
+            float duration_ms = 0.f;
+            if (state == cudaSuccess &&
+                cudaEventElapsedTime(&begin_ms, reference_, span.begin) == cudaSuccess &&
+                cudaEventElapsedTime(&duration_ms, span.begin, span.end) == cudaSuccess) {
+                push({.name = span.name,
+                      .begin_ns = reference_ns_ + static_cast<int64_t>(static_cast<double>(begin_ms) * 1e6),
+                      .duration_ns = static_cast<int64_t>(static_cast<double>(duration_ms) * 1e6),
+                      .track = span.track,
+                      .gpu = true});
+                // Later spans measure from this one, the reference stays recent
+                if (begin_ms > REANCHOR_MS) {
+                    events_.push_back(reference_);
+                    reference_ = span.begin;
+                    reference_ns_ += static_cast<int64_t>(static_cast<double>(begin_ms) * 1e6);
+                    events_.push_back(span.end);
+                    continue;
+                }
+            }
+            events_.push_back(span.begin);
+            events_.push_back(span.end);
+        }
+    }
+
+    void TraceRecorder::push(const Span& span) {
+        if (ring_.empty()) {
+            return;
+        }
+        if (wrapped_) {
+            ++dropped_;
+        }
+        ring_[next_] = span;
+        if (++next_ == ring_.size()) {
+            next_ = 0;
+            wrapped_ = true;
+        }
+    }
+
+    std::expected<void, std::string> TraceRecorder::write() const {
+        if (output_.has_parent_path()) {
+            std::error_code ec;
+            std::filesystem::create_directories(output_.parent_path(), ec);
+        }
+        std::ofstream out(output_);
+        if (!out) {
+            return std::unexpected(std::format("Cannot write the trace to {}", output_.string()));
+        }
+
+        // Chrome trace event format: pid 1 holds the host threads, pid 2 the CUDA streams
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        out << R"({"name":"process_name","ph":"M","pid":1,"args":{"name":"host"}},)" << '\n';
+        out << R"({"name":"process_name","ph":"M","pid":2,"args":{"name":"GPU"}})";
+        for (const auto& [track, name] : thread_names_) {
+            out << std::format(",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":{}}}}}",
+                               track, quoted(name));
+        }
+        for (const auto& [stream, track] : stream_tracks_) {
+            out << std::format(",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":{},\"args\":{{\"name\":\"stream {}\"}}}}",
+                               track, track);
+        }
+
+        const auto write_span = [&out](const Span& span) {
+            out << std::format(",\n{{\"name\":{},\"cat\":\"{}\",\"ph\":\"X\",\"pid\":{},\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                               quoted(span.name), span.gpu ? "gpu" : "host", span.gpu ? 2 : 1, span.track,
+                               static_cast<double>(span.begin_ns) * 1e-3, static_cast<double>(span.duration_ns) * 1e-3);
+        };
+        if (wrapped_) {
+            std::for_each(ring_.begin() + static_cast<std::ptrdiff_t>(next_), ring_.end(), write_span);
+        }
+        std::for_each(ring_.begin(), ring_.begin() + static_cast<std::ptrdiff_t>(next_), write_span);
+        out << "\n]}\n";
+
+        if (!out) {
+            return std::unexpected(std::format("Failed writing the trace to {}", output_.string()));
+        }
+        return {};
+    }
+
+    TraceSession::TraceSession(const std::string& output, size_t capacity)
+        : active_(!output.empty()) {
+        if (active_) {
+            TraceRecorder::get().start(output, capacity);
+        }
+    }
+
+    TraceSession::~TraceSession() {
+        if (active_) {
+            if (auto stopped = TraceRecorder::get().stop(); !stopped) {
+                LOG_ERROR("{}", stopped.error());
+            }
+        }
+    }
+
+} // namespace gs::core
@@ -8,13 +8,20 @@
 #include "core/point_cloud.hpp"
 #include "core/torch_shapes.hpp"
 #include "loader/filesystem_utils.hpp"
+#include "mmapped_file.hpp"
 #include <algorithm>
+#include <charconv>
+#include <cmath>
 #include <cstring>
 #include <exception>
 #include <filesystem>
+#include <format>
 #include <fstream>
 #include <memory>
+#include <optional>
 #include <stdexcept>
+#include <string_view>
+#include <tbb/parallel_for.h>
 #include <torch/torch.h>
 #include <unordered_map>
 #include <vector>
@@ -166,6 +173,35 @@ namespace gs::loader {
         return buf;
     }
 
+    // Maps a whole binary file, failing the same way as read_binary
+    static std::unique_ptr<MMappedFile> map_binary(const std::filesystem::path& p) {
+        LOG_TRACE("Mapping binary file: {}", p.string());
+        auto file = std::make_unique<MMappedFile>();
+        if (!file->map(p)) {
+            throw std::runtime_error("Failed to open " + p.string());
+        }
+        return file;
+    }
+
+    // Throws unless `count` more bytes are available at `offset`
+    static inline void require_bytes(size_t offset, uint64_t count, size_t size, const char* what) {
+        if (offset > size || count > size - offset) {
+            LOG_ERROR("{} is truncated", what);
+            throw std::runtime_error(std::string(what) + ": truncated");
+        }
+    }
+
+    // count records of record_bytes each, checked by division so a corrupt count cannot wrap the product
+    static inline void require_records(size_t offset, uint64_t count, size_t record_bytes, size_t size, const char* what) {
+        if (offset > size || count > (size - offset) / record_bytes) {
+            LOG_ERROR("{} is truncated", what);
+            throw std::runtime_error(std::string(what) + ": truncated");
+        }
+    }
+
+    // Records per parallel task when decoding variable-length COLMAP records
+    constexpr size_t COLMAP_CHUNK_RECORDS = 16384;
+
     // -----------------------------------------------------------------------------
     //  Helper to scale camera intrinsics based on model
     // -----------------------------------------------------------------------------
@@ -304,42 +340,72 @@ namespace gs::loader {
     // -----------------------------------------------------------------------------
     std::vector<Image> read_images_binary(const std::filesystem::path& file_path) {
         LOG_TIMER_TRACE("Read images.bin");
-        auto buf_owner = read_binary(file_path);
-        const char* cur = buf_owner->data();
-        const char* end = cur + buf_owner->size();
-
-        uint64_t n_images = read_u64(cur);
+        auto file = map_binary(file_path);
+        const char* const base = file->as_span().data();
+        const size_t size = file->size;
+
+        size_t offset = 0;
+        require_bytes(offset, sizeof(uint64_t), size, "images.bin");
+        const char* cur = base;
+        const uint64_t n_images = read_u64(cur);
+        offset += sizeof(uint64_t);
         LOG_DEBUG("Reading {} images from binary file", n_images);
-        std::vector<Image> images;
-        images.reserve(n_images);
-
-        for (uint64_t i = 0; i < n_images; ++i) {
-            uint32_t id = read_u32(cur);
-            auto& img = images.emplace_back(id);
-
-            torch::Tensor q = torch::empty({4}, torch::kFloat32);
-            for (int k = 0; k < 4; ++k)
-                q[k] = static_cast<float>(read_f64(cur));
-
-            img._qvec = q;
-
-            torch::Tensor t = torch::empty({3}, torch::kFloat32);
-            for (int k = 0; k < 3; ++k)
-                t[k] = static_cast<float>(read_f64(cur));
-            img._tvec = t;
 
-            img._camera_id = read_u32(cur);
+        // Record: id u32, qvec 4*f64, tvec 3*f64, camera id u32, name '\0', n_points u64,
+        // points (x f64, y f64, point3D id u64) * n_points
+        constexpr size_t fixed_bytes = sizeof(uint32_t) + 7 * sizeof(double) + sizeof(uint32_t);
+        constexpr size_t point2d_bytes = sizeof(double) * 2 + sizeof(uint64_t);
 
-            img._name.assign(cur);
-            cur += img._name.size() + 1; // skip '\0'
-
-            uint64_t npts = read_u64(cur); // skip 2-D points
-            cur += npts * (sizeof(double) * 2 + sizeof(uint64_t));
+        // Pass 1: locate records, hopping over names and 2-D point lists without touching them
+        require_records(offset, n_images, fixed_bytes, size, "images.bin");
+        std::vector<size_t> record_offsets(n_images);
+        for (uint64_t i = 0; i < n_images; ++i) {
+            record_offsets[i] = offset;
+            require_bytes(offset, fixed_bytes, size, "images.bin");
+            offset += fixed_bytes;
+
+            const void* name_end = std::memchr(base + offset, '\0', size - offset);
+            if (!name_end) {
+                LOG_ERROR("images.bin is truncated");
+                throw std::runtime_error("images.bin: truncated");
+            }
+            offset = static_cast<size_t>(static_cast<const char*>(name_end) - base) + 1;
+
+            require_bytes(offset, sizeof(uint64_t), size, "images.bin");
+            cur = base + offset;
+            const uint64_t npts = read_u64(cur);
+            offset += sizeof(uint64_t);
+            require_records(offset, npts, point2d_bytes, size, "images.bin");
+            offset += static_cast<size_t>(npts) * point2d_bytes;
         }
-        if (cur != end) {
+        if (offset != size) {
             LOG_ERROR("images.bin has trailing bytes");
             throw std::runtime_error("images.bin: trailing bytes");
         }
+
+        // Pass 2: decode records in parallel
+        std::vector<Image> images(n_images);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, n_images),
+                          [&](const tbb::blocked_range<size_t>& range) {
+                              for (size_t i = range.begin(); i != range.end(); ++i) {
+                                  const char* p = base + record_offsets[i];
+                                  Image img(read_u32(p));
+
+                                  float q[4];
+                                  for (float& v : q)
+                                      v = static_cast<float>(read_f64(p));
+                                  img._qvec = torch::from_blob(q, {4}, torch::kFloat32).clone();
+
+                                  float t[3];
+                                  for (float& v : t)
+                                      v = static_cast<float>(read_f64(p));
+                                  img._tvec = torch::from_blob(t, {3}, torch::kFloat32).clone();
+
+                                  img._camera_id = read_u32(p);
+                                  img._name.assign(p);
+                                  images[i] = std::move(img);
+                              }
+                          });
         return images;
     }
 
@@ -413,13 +479,44 @@ namespace gs::loader {
     // -----------------------------------------------------------------------------
     PointCloud read_point3D_binary(const std::filesystem::path& file_path) {
         LOG_TIMER_TRACE("Read points3D.bin");
-        auto buf_owner = read_binary(file_path);
-        const char* cur = buf_owner->data();
-        const char* end = cur + buf_owner->size();
-
-        uint64_t N = read_u64(cur);
+        auto file = map_binary(file_path);
+        const char* const base = file->as_span().data();
+        const size_t size = file->size;
+
+        size_t offset = 0;
+        require_bytes(offset, sizeof(uint64_t), size, "points3D.bin");
+        const char* cur = base;
+        const uint64_t N = read_u64(cur);
+        offset += sizeof(uint64_t);
         LOG_DEBUG("Reading {} 3D points from binary file", N);
 
+        // Record: id u64, xyz 3*f64, rgb 3*u8, error f64, track length u64,
+        // track (image id u32, point2D idx u32) * length
+        constexpr size_t fixed_bytes = sizeof(uint64_t) + 3 * sizeof(double) + 3 + sizeof(double);
+        constexpr size_t track_entry_bytes = sizeof(uint32_t) * 2;
+
+        // Pass 1: hop over tracks to find where each chunk of records starts
+        require_records(offset, N, fixed_bytes + sizeof(uint64_t), size, "points3D.bin");
+        const size_t num_chunks = (N + COLMAP_CHUNK_RECORDS - 1) / COLMAP_CHUNK_RECORDS;
+        std::vector<size_t> chunk_offsets(num_chunks);
+        for (uint64_t i = 0; i < N; ++i) {
+            if (i % COLMAP_CHUNK_RECORDS == 0) {
+                chunk_offsets[i / COLMAP_CHUNK_RECORDS] = offset;
+            }
+            require_bytes(offset, fixed_bytes + sizeof(uint64_t), size, "points3D.bin");
+            offset += fixed_bytes;
+            cur = base + offset;
+            const uint64_t track_length = read_u64(cur);
+            offset += sizeof(uint64_t);
+            require_records(offset, track_length, track_entry_bytes, size, "points3D.bin");
+            offset += static_cast<size_t>(track_length) * track_entry_bytes;
+        }
+
+        if (offset != size) {
+            LOG_ERROR("points3D.bin has trailing bytes");
+            throw std::runtime_error("points3D.bin: trailing bytes");
+        }
+
         // Pre-allocate tensors directly
         torch::Tensor positions = torch::empty({static_cast<int64_t>(N), 3}, torch::kFloat32);
         torch::Tensor colors = torch::empty({static_cast<int64_t>(N), 3}, torch::kUInt8);
@@ -428,27 +525,29 @@ namespace gs::loader {
         float* pos_data = positions.data_ptr<float>();
         uint8_t* col_data = colors.data_ptr<uint8_t>();
 
-        for (uint64_t i = 0; i < N; ++i) {
-            cur += 8; // skip point ID
-
-            // Read position directly into tensor
-            pos_data[i * 3 + 0] = static_cast<float>(read_f64(cur));
-            pos_data[i * 3 + 1] = static_cast<float>(read_f64(cur));
-            pos_data[i * 3 + 2] = static_cast<float>(read_f64(cur));
-
-            // Read color directly into tensor
-            col_data[i * 3 + 0] = *cur++;
-            col_data[i * 3 + 1] = *cur++;
-            col_data[i * 3 + 2] = *cur++;
-
-            cur += 8;                                    // skip reprojection error
-            cur += read_u64(cur) * sizeof(uint32_t) * 2; // skip track
-        }
-
-        if (cur != end) {
-            LOG_ERROR("points3D.bin has trailing bytes");
-            throw std::runtime_error("points3D.bin: trailing bytes");
-        }
+        // Pass 2: decode chunks in parallel
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_chunks),
+                          [&](const tbb::blocked_range<size_t>& range) {
+                              for (size_t chunk = range.begin(); chunk != range.end(); ++chunk) {
+                                  const char* p = base + chunk_offsets[chunk];
+                                  const uint64_t first = chunk * COLMAP_CHUNK_RECORDS;
+                                  const uint64_t last = std::min<uint64_t>(N, first + COLMAP_CHUNK_RECORDS);
+                                  for (uint64_t i = first; i < last; ++i) {
+                                      p += 8; // skip point ID
+
+                                      pos_data[i * 3 + 0] = static_cast<float>(read_f64(p));
+                                      pos_data[i * 3 + 1] = static_cast<float>(read_f64(p));
+                                      pos_data[i * 3 + 2] = static_cast<float>(read_f64(p));
+
+                                      col_data[i * 3 + 0] = *p++;
+                                      col_data[i * 3 + 1] = *p++;
+                                      col_data[i * 3 + 2] = *p++;
+
+                                      p += 8;                               // skip reprojection error
+                                      p += read_u64(p) * track_entry_bytes; // skip track
+                                  }
+                              }
+                          });
 
         return PointCloud(positions, colors);
     }
@@ -503,6 +602,31 @@ namespace gs::loader {
         return tokens;
     }
 
+    // Allocation-free split on single spaces, returns the number of tokens stored
+    static size_t tokenize(std::string_view line, std::string_view* tokens, size_t max_tokens) {
+        size_t count = 0;
+        size_t start = 0;
+        while (count < max_tokens) {
+            const size_t end = line.find(' ', start);
+            tokens[count++] = line.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+            if (end == std::string_view::npos)
+                break;
+            start = end + 1;
+        }
+        return count;
+    }
+
+    template <typename T>
+    static T parse_number(std::string_view token, const std::string& line, const char* what) {
+        T value{};
+        const auto [ptr, ec] = std::from_chars(token.data(), token.data() + token.size(), value);
+        if (ec != std::errc{}) {
+            LOG_ERROR("Invalid number '{}' in {}: {}", token, what, line);
+            throw std::runtime_error(std::string("Invalid format in ") + what + ": " + line);
+        }
+        return value;
+    }
+
     // -----------------------------------------------------------------------------
     //  images.txt
     //  Image list with two lines of data per image:
@@ -520,27 +644,35 @@ namespace gs::loader {
         uint64_t n_images = lines.size() / 2;
         LOG_DEBUG("Reading {} images from text file", n_images);
 
-        for (uint64_t i = 0; i < n_images; ++i) {
-            const auto& line = lines[i * 2];
-
-            const auto tokens = split_string(line, ' ');
-            if (tokens.size() != 10) {
-                LOG_ERROR("Invalid format in images.txt line {}", i * 2 + 1);
-                throw std::runtime_error("Invalid format in images.txt line " + std::to_string(i * 2 + 1));
-            }
-
-            auto& img = images.emplace_back(std::stoul(tokens[0]));
-            img._qvec = torch::tensor({std::stof(tokens[1]), std::stof(tokens[2]),
-                                       std::stof(tokens[3]), std::stof(tokens[4])},
-                                      torch::kFloat32);
-
-            img._tvec = torch::tensor({std::stof(tokens[5]), std::stof(tokens[6]),
-                                       std::stof(tokens[7])},
-                                      torch::kFloat32);
-
-            img._camera_id = std::stoul(tokens[8]);
-            img._name = tokens[9];
-        }
+        // Only every other line is parsed, the POINTS2D lines are skipped untouched
+        images.resize(n_images);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, n_images),
+                          [&](const tbb::blocked_range<size_t>& range) {
+                              for (size_t i = range.begin(); i != range.end(); ++i) {
+                                  const auto& line = lines[i * 2];
+
+                                  std::string_view tokens[11];
+                                  if (tokenize(line, tokens, 11) != 10) {
+                                      LOG_ERROR("Invalid format in images.txt line {}", i * 2 + 1);
+                                      throw std::runtime_error("Invalid format in images.txt line " + std::to_string(i * 2 + 1));
+                                  }
+
+                                  Image img(parse_number<uint32_t>(tokens[0], line, "images.txt"));
+                                  float q[4];
+                                  for (int k = 0; k < 4; ++k)
+                                      q[k] = parse_number<float>(tokens[1 + k], line, "images.txt");
+                                  img._qvec = torch::from_blob(q, {4}, torch::kFloat32).clone();
+
+                                  float t[3];
+                                  for (int k = 0; k < 3; ++k)
+                                      t[k] = parse_number<float>(tokens[5 + k], line, "images.txt");
+                                  img._tvec = torch::from_blob(t, {3}, torch::kFloat32).clone();
+
+                                  img._camera_id = parse_number<uint32_t>(tokens[8], line, "images.txt");
+                                  img._name = tokens[9];
+                                  images[i] = std::move(img);
+                              }
+                          });
         return images;
     }
 
@@ -618,23 +750,27 @@ namespace gs::loader {
         float* pos_data = positions.data_ptr<float>();
         uint8_t* col_data = colors.data_ptr<uint8_t>();
 
-        for (uint64_t i = 0; i < N; ++i) {
-            const auto& line = lines[i];
-            const auto tokens = split_string(line, ' ');
-
-            if (tokens.size() < 8) {
-                LOG_ERROR("Invalid format in points3D.txt: {}", line);
-                throw std::runtime_error("Invalid format in point3D.txt: " + line);
-            }
-
-            pos_data[i * 3 + 0] = std::stof(tokens[1]);
-            pos_data[i * 3 + 1] = std::stof(tokens[2]);
-            pos_data[i * 3 + 2] = std::stof(tokens[3]);
-
-            col_data[i * 3 + 0] = std::stoi(tokens[4]);
-            col_data[i * 3 + 1] = std::stoi(tokens[5]);
-            col_data[i * 3 + 2] = std::stoi(tokens[6]);
-        }
+        // Lines are independent, tokenize them in parallel; the track columns are never split
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, N, COLMAP_CHUNK_RECORDS / 16),
+                          [&](const tbb::blocked_range<size_t>& range) {
+                              for (size_t i = range.begin(); i != range.end(); ++i) {
+                                  const auto& line = lines[i];
+
+                                  std::string_view tokens[8];
+                                  if (tokenize(line, tokens, 8) < 8) {
+                                      LOG_ERROR("Invalid format in points3D.txt: {}", line);
+                                      throw std::runtime_error("Invalid format in point3D.txt: " + line);
+                                  }
+
+                                  pos_data[i * 3 + 0] = parse_number<float>(tokens[1], line, "points3D.txt");
+                                  pos_data[i * 3 + 1] = parse_number<float>(tokens[2], line, "points3D.txt");
+                                  pos_data[i * 3 + 2] = parse_number<float>(tokens[3], line, "points3D.txt");
+
+                                  col_data[i * 3 + 0] = static_cast<uint8_t>(parse_number<int>(tokens[4], line, "points3D.txt"));
+                                  col_data[i * 3 + 1] = static_cast<uint8_t>(parse_number<int>(tokens[5], line, "points3D.txt"));
+                                  col_data[i * 3 + 2] = static_cast<uint8_t>(parse_number<int>(tokens[6], line, "points3D.txt"));
+                              }
+                          });
         return PointCloud(positions, colors);
     }
 
@@ -650,6 +786,9 @@ namespace gs::loader {
         std::vector<CameraData> out(images.size());
 
         std::filesystem::path images_path = base_path / images_folder;
+        const std::filesystem::path masks_path = base_path / "masks";
+        const bool has_masks = safe_is_directory(masks_path);
+        size_t n_masks = 0;
 
         // Prepare tensor to store all camera locations [N, 3]
         torch::Tensor camera_locations = torch::zeros({static_cast<int64_t>(images.size()), 3}, torch::kFloat32);
@@ -671,6 +810,16 @@ namespace gs::loader {
             out[i] = it->second;
             out[i]._image_path = images_path / img._name;
             out[i]._image_name = img._name;
+            if (has_masks) {
+                const fs::path mask = masks_path / img._name;
+                for (const fs::path& candidate : {mask, fs::path(mask).concat(".png"), fs::path(mask).replace_extension(".png")}) {
+                    if (safe_exists(candidate)) {
+                        out[i]._mask_path = candidate;
+                        ++n_masks;
+                        break;
+                    }
+                }
+            }
 
             out[i]._R = qvec2rotmat(img._qvec);
             out[i]._T = img._tvec.clone();
@@ -877,6 +1026,9 @@ namespace gs::loader {
         }
 
         LOG_INFO("Training with {} images", out.size());
+        if (n_masks > 0) {
+            LOG_INFO("Found masks for {} of {} images in {}", n_masks, out.size(), masks_path.string());
+        }
         return {std::move(out), camera_locations.mean(0)};
     }
 
@@ -956,4 +1108,125 @@ namespace gs::loader {
         return read_colmap_cameras(base, cams, images, images_folder);
     }
 
+    std::vector<ImageHeader> read_image_headers(const std::vector<std::filesystem::path>& paths) {
+        LOG_TIMER_TRACE("Read image headers");
+        std::vector<ImageHeader> headers(paths.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, paths.size()),
+                          [&](const tbb::blocked_range<size_t>& range) {
+                              for (size_t i = range.begin(); i != range.end(); ++i) {
+                                  auto& header = headers[i];
+                                  if (!safe_exists(paths[i])) {
+                                      header.error = std::format("{} not found", paths[i].string());
+                                      continue;
+                                  }
+                                  try {
+                                      const auto [w, h, c] = get_image_info(paths[i]);
+                                      header.width = w;
+                                      header.height = h;
+                                      if (w <= 0 || h <= 0) {
+                                          header.error = std::format("{} has no pixels", paths[i].string());
+                                      }
+                                  } catch (const std::exception& e) {
+                                      header.error = e.what();
+                                  }
+                              }
+                          });
+        return headers;
+    }
+
+    std::vector<std::string> validate_colmap_dataset(
+        const std::filesystem::path& base,
+        const std::string& images_folder,
+        const bool text) {
+
+        LOG_TIMER("Validate COLMAP dataset");
+        std::vector<std::string> problems;
+
+        std::unordered_map<uint32_t, CameraData> cams;
+        std::vector<Image> images;
+        try {
+            const float scale_factor = extract_scale_from_folder(images_folder);
+            if (text) {
+                cams = read_cameras_text(get_sparse_file_path(base, "cameras.txt"), scale_factor);
+                images = read_images_text(get_sparse_file_path(base, "images.txt"));
+            } else {
+                cams = read_cameras_binary(get_sparse_file_path(base, "cameras.bin"), scale_factor);
+                images = read_images_binary(get_sparse_file_path(base, "images.bin"));
+            }
+        } catch (const std::exception& e) {
+            problems.emplace_back(e.what());
+            return problems;
+        }
+        if (images.empty()) {
+            problems.emplace_back("No images are registered");
+            return problems;
+        }
+
+        for (const auto& [id, cam] : cams) {
+            if (cam._camera_model == CAMERA_MODEL::THIN_PRISM_FISHEYE || cam._camera_model == CAMERA_MODEL::FOV ||
+                cam._camera_model == CAMERA_MODEL::UNDEFINED) {
+                problems.push_back(std::format("Camera {} uses an unsupported camera model", id));
+            } else if (cam._width <= 0 || cam._height <= 0) {
+                problems.push_back(std::format("Camera {} has no size", id));
+            }
+        }
+
+        const std::filesystem::path images_path = base / images_folder;
+        std::vector<std::filesystem::path> paths(images.size());
+        std::vector<const CameraData*> image_cams(images.size(), nullptr);
+        for (size_t i = 0; i < images.size(); ++i) {
+            paths[i] = images_path / images[i]._name;
+            const auto it = cams.find(images[i]._camera_id);
+            if (it == cams.end()) {
+                problems.push_back(std::format("Image '{}' refers to missing camera {}", images[i]._name, images[i]._camera_id));
+            } else if (it->second._width > 0 && it->second._height > 0) {
+                image_cams[i] = &it->second;
+            }
+        }
+
+        // The loader rescales every camera by the factor between the first image and its camera
+        const auto headers = read_image_headers(paths);
+        std::optional<std::pair<float, float>> scale;
+        for (size_t i = 0; i < images.size(); ++i) {
+            const auto& header = headers[i];
+            if (!header.error.empty()) {
+                problems.push_back(std::format("Image '{}': {}", images[i]._name, header.error));
+                continue;
+            }
+            const CameraData* cam = image_cams[i];
+            if (!cam) {
+                continue;
+            }
+            const float scale_x = static_cast<float>(header.width) / static_cast<float>(cam->_width);
+            const float scale_y = static_cast<float>(header.height) / static_cast<float>(cam->_height);
+            if (!scale) {
+                scale.emplace(scale_x, scale_y);
+                continue;
+            }
+            if (std::abs(scale_x - scale->first) > 1e-3f * scale->first ||
+                std::abs(scale_y - scale->second) > 1e-3f * scale->second) {
+                problems.push_back(std::format("Image '{}' is {}x{}, camera {} expects {}x{} at the scale of the dataset",
+                                               images[i]._name, header.width, header.height, cam->_camera_ID,
+                                               std::lround(cam->_width * scale->first),
+                                               std::lround(cam->_height * scale->second)));
+            }
+        }
+
+        LOG_INFO("Validated {} cameras and {} images, {} problems", cams.size(), images.size(), problems.size());
+        return problems;
+    }
+
+    std::string describe_validation_problems(const std::string& dataset, const std::vector<std::string>& problems) {
+        constexpr size_t max_listed = 20;
+        std::string message = std::format("{} dataset has {} problem{}:", dataset, problems.size(),
+                                          problems.size() == 1 ? "" : "s");
+        for (size_t i = 0; i < std::min(problems.size(), max_listed); ++i) {
+            message += "\n  - " + problems[i];
+        }
+        if (problems.size() > max_listed) {
+            message += std::format("\n  ... and {} more", problems.size() - max_listed);
+        }
+        return message;
+    }
+
 } // namespace gs::loader
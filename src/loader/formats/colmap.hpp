@@ -43,6 +43,10 @@ namespace gs::loader {
         torch::Tensor _params;
         torch::Tensor _radial_distortion = torch::empty({0}, torch::kFloat32);
         torch::Tensor _tangential_distortion = torch::empty({0}, torch::kFloat32);
+        // Set by undistortion, see undistort.hpp
+        std::filesystem::path _valid_mask_path;
+        // masks/<image name>, with or without an added or replaced .png extension, empty if absent
+        std::filesystem::path _mask_path;
 
         int _img_w = 0;
         int _img_h = 0;
@@ -66,4 +70,24 @@ namespace gs::loader {
     // Read COLMAP point cloud from a text file
     PointCloud read_colmap_point_cloud_text(const std::filesystem::path& filepath);
 
+    // Width and height from the header of every image, probed in parallel without decoding pixels.
+    // A missing or unreadable file stays 0x0 and says why in error.
+    struct ImageHeader {
+        int width = 0;
+        int height = 0;
+        std::string error;
+    };
+    std::vector<ImageHeader> read_image_headers(const std::vector<std::filesystem::path>& paths);
+
+    // Checks a COLMAP dataset without building cameras or reading points or pixels: cameras and
+    // images parse, every image refers to a camera of a supported model, and every image file
+    // exists with header dimensions at the scale the first image sets. One message per problem.
+    std::vector<std::string> validate_colmap_dataset(
+        const std::filesystem::path& base,
+        const std::string& images_folder = "images",
+        bool text = false);
+
+    // Error listing the first problems of a validation, for the loaders to throw
+    std::string describe_validation_problems(const std::string& dataset, const std::vector<std::string>& problems);
+
 } // namespace gs::loader
\ No newline at end of file
@@ -0,0 +1,120 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/logger.hpp"
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+// Platform-specific includes
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gs::loader {
+
+    // Read-only memory map of a whole file, shared by the binary format readers
+    struct MMappedFile {
+        // Files larger than this get a sequential read-ahead hint
+        static constexpr size_t SEQUENTIAL_HINT_THRESHOLD = size_t(50) * 1024 * 1024;
+
+        void* data = nullptr;
+        size_t size = 0;
+
+#ifdef _WIN32
+        HANDLE file_handle = INVALID_HANDLE_VALUE;
+        HANDLE mapping_handle = INVALID_HANDLE_VALUE;
+
+        ~MMappedFile() {
+            if (data)
+                UnmapViewOfFile(data);
+            if (mapping_handle != INVALID_HANDLE_VALUE)
+                CloseHandle(mapping_handle);
+            if (file_handle != INVALID_HANDLE_VALUE)
+                CloseHandle(file_handle);
+        }
+
+        [[nodiscard]] bool map(const std::filesystem::path& filepath) {
+            auto wide_path = filepath.wstring();
+            file_handle = CreateFileW(wide_path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                      nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file_handle == INVALID_HANDLE_VALUE) {
+                LOG_ERROR("Failed to open file for mapping: {}", filepath.string());
+                return false;
+            }
+
+            LARGE_INTEGER file_size_li;
+            if (!GetFileSizeEx(file_handle, &file_size_li)) {
+                LOG_ERROR("Failed to get file size: {}", filepath.string());
+                return false;
+            }
+            size = static_cast<size_t>(file_size_li.QuadPart);
+
+            mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping_handle) {
+                LOG_ERROR("Failed to create file mapping: {}", filepath.string());
+                return false;
+            }
+
+            data = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+            if (!data) {
+                LOG_ERROR("Failed to map view of file: {}", filepath.string());
+            }
+            return data != nullptr;
+        }
+#else
+        int fd = -1;
+
+        ~MMappedFile() {
+            if (data && data != MAP_FAILED)
+                munmap(data, size);
+            if (fd >= 0)
+                close(fd);
+        }
+
+        [[nodiscard]] bool map(const std::filesystem::path& filepath) {
+            fd = open(filepath.c_str(), O_RDONLY);
+            if (fd < 0) {
+                LOG_ERROR("Failed to open file for mapping: {}", filepath.string());
+                return false;
+            }
+
+            struct stat st {};
+            if (fstat(fd, &st) < 0) {
+                LOG_ERROR("Failed to stat file: {}", filepath.string());
+                return false;
+            }
+            size = st.st_size;
+
+            data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                LOG_ERROR("Failed to mmap file: {}", filepath.string());
+                return false;
+            }
+
+            // Prefetching based on file size
+            if (size > SEQUENTIAL_HINT_THRESHOLD) {
+                if (madvise(data, size, MADV_SEQUENTIAL) == 0) {
+                    LOG_DEBUG("Applied sequential access optimization for large file");
+                }
+            }
+
+            return true;
+        }
+#endif
+
+        [[nodiscard]] std::span<const char> as_span() const {
+            return std::span{static_cast<const char*>(data), size};
+        }
+    };
+
+} // namespace gs::loader
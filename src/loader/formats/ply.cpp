@@ -4,13 +4,18 @@
 
 #include "ply.hpp"
 #include "core/logger.hpp"
+#include "mmapped_file.hpp"
+#include <ATen/cuda/CUDAEvent.h>
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <charconv>
 #include <chrono>
 #include <cstring>
 #include <format>
 #include <fstream>
 #include <mutex>
+#include <optional>
 #include <ranges>
 #include <span>
 #include <string_view>
@@ -19,17 +24,6 @@
 // TBB includes
 #include <tbb/parallel_for.h>
 
-// Platform-specific includes
-#ifdef _WIN32
-#include <io.h>
-#include <windows.h>
-#else
-#include <fcntl.h>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <unistd.h>
-#endif
-
 // SIMD includes (with fallback)
 #if defined(__AVX2__)
 #include <immintrin.h>
@@ -49,12 +43,16 @@ namespace gs::loader {
         constexpr float SCENE_SCALE_FACTOR = 0.5f;
         constexpr int SH_DEGREE_3_REST_COEFFS = 15;
         constexpr int SH_DEGREE_OFFSET = 1;
+        constexpr float SH_C0 = 0.28209479177387814f;
 
         // Block sizes for parallel processing
         constexpr size_t BLOCK_SIZE_SMALL = 1024;
         constexpr size_t BLOCK_SIZE_LARGE = 2048;
         constexpr size_t PLY_MIN_SIZE = 10;
-        constexpr size_t FILE_SIZE_THRESHOLD_MB = 50;
+
+        // Vertex records are staged to the GPU in pieces of this size
+        constexpr size_t UPLOAD_CHUNK_BYTES = size_t(64) * 1024 * 1024;
+        constexpr size_t STAGING_COPY_GRAIN = size_t(1) << 20;
 
         // SIMD constants
         constexpr int SIMD_WIDTH = 8;
@@ -72,9 +70,33 @@ namespace gs::loader {
         constexpr auto ROT_PREFIX = "rot_"sv;
     } // namespace ply_constants
 
+    enum class PlyType : uint8_t {
+        Int8,
+        UInt8,
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Float32,
+        Float64
+    };
+
+    // A vertex property as stored in the file, converted to float as value * scale + bias
+    struct PlyProperty {
+        PlyType type;
+        size_t offset; // Into the file's vertex record
+        float scale = 1.0f;
+        float bias = 0.0f;
+    };
+
     struct FastPropertyLayout {
         size_t vertex_count;
-        size_t vertex_stride;
+        size_t vertex_stride; // Of the float rows, one 4-byte column per property
+
+        size_t source_stride = 0; // Of the records in the file
+        bool big_endian = false;
+        std::vector<PlyProperty> properties; // In file order, property i is column i of the float rows
+        size_t color_offsets[3] = {SIZE_MAX, SIZE_MAX, SIZE_MAX}; // red, green, blue columns
 
         // Pre-computed offsets for zero-copy access
         size_t pos_x_offset = SIZE_MAX, pos_y_offset = SIZE_MAX, pos_z_offset = SIZE_MAX;
@@ -84,6 +106,7 @@ namespace gs::loader {
         size_t dc_start_offset = SIZE_MAX;
         size_t rest_start_offset = SIZE_MAX;
         int dc_count = 0, rest_count = 0;
+        bool float_only = true; // The file's records already are the float rows, no conversion pass needed
 
         [[nodiscard]] bool has_positions() const { return pos_x_offset != SIZE_MAX; }
         [[nodiscard]] bool has_opacity() const { return opacity_offset != SIZE_MAX; }
@@ -91,96 +114,25 @@ namespace gs::loader {
         [[nodiscard]] bool has_rotation() const { return rot_offsets[0] != SIZE_MAX; }
     };
 
-    struct MMappedFile {
-        void* data = nullptr;
-        size_t size = 0;
-
-#ifdef _WIN32
-        HANDLE file_handle = INVALID_HANDLE_VALUE;
-        HANDLE mapping_handle = INVALID_HANDLE_VALUE;
-
-        ~MMappedFile() {
-            if (data)
-                UnmapViewOfFile(data);
-            if (mapping_handle != INVALID_HANDLE_VALUE)
-                CloseHandle(mapping_handle);
-            if (file_handle != INVALID_HANDLE_VALUE)
-                CloseHandle(file_handle);
-        }
-
-        [[nodiscard]] bool map(const std::filesystem::path& filepath) {
-            auto wide_path = filepath.wstring();
-            file_handle = CreateFileW(wide_path.c_str(), GENERIC_READ, FILE_SHARE_READ,
-                                      nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
-            if (file_handle == INVALID_HANDLE_VALUE) {
-                LOG_ERROR("Failed to open file for mapping: {}", filepath.string());
-                return false;
-            }
-
-            LARGE_INTEGER file_size_li;
-            if (!GetFileSizeEx(file_handle, &file_size_li)) {
-                LOG_ERROR("Failed to get file size: {}", filepath.string());
-                return false;
-            }
-            size = static_cast<size_t>(file_size_li.QuadPart);
-
-            mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
-            if (!mapping_handle) {
-                LOG_ERROR("Failed to create file mapping: {}", filepath.string());
-                return false;
-            }
-
-            data = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
-            if (!data) {
-                LOG_ERROR("Failed to map view of file: {}", filepath.string());
-            }
-            return data != nullptr;
-        }
-#else
-        int fd = -1;
-
-        ~MMappedFile() {
-            if (data && data != MAP_FAILED)
-                munmap(data, size);
-            if (fd >= 0)
-                close(fd);
-        }
-
-        [[nodiscard]] bool map(const std::filesystem::path& filepath) {
-            fd = open(filepath.c_str(), O_RDONLY);
-            if (fd < 0) {
-                LOG_ERROR("Failed to open file for mapping: {}", filepath.string());
-                return false;
-            }
-
-            struct stat st {};
-            if (fstat(fd, &st) < 0) {
-                LOG_ERROR("Failed to stat file: {}", filepath.string());
-                return false;
-            }
-            size = st.st_size;
-
-            data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
-            if (data == MAP_FAILED) {
-                LOG_ERROR("Failed to mmap file: {}", filepath.string());
-                return false;
-            }
-
-            // Prefetching based on file size
-            if (size > ply_constants::FILE_SIZE_THRESHOLD_MB * 1024 * 1024) { // Only for files > 50MB
-                if (madvise(data, size, MADV_SEQUENTIAL) == 0) {
-                    LOG_DEBUG("Applied sequential access optimization for large file");
-                }
-            }
-
-            return true;
-        }
-#endif
-
-        [[nodiscard]] std::span<const char> as_span() const {
-            return std::span{static_cast<const char*>(data), size};
-        }
-    };
+    [[nodiscard]] std::optional<std::pair<PlyType, size_t>> parse_property_type(std::string_view name) {
+        if (name == "char" || name == "int8")
+            return std::pair{PlyType::Int8, size_t{1}};
+        if (name == "uchar" || name == "uint8")
+            return std::pair{PlyType::UInt8, size_t{1}};
+        if (name == "short" || name == "int16")
+            return std::pair{PlyType::Int16, size_t{2}};
+        if (name == "ushort" || name == "uint16")
+            return std::pair{PlyType::UInt16, size_t{2}};
+        if (name == "int" || name == "int32")
+            return std::pair{PlyType::Int32, size_t{4}};
+        if (name == "uint" || name == "uint32")
+            return std::pair{PlyType::UInt32, size_t{4}};
+        if (name == "float" || name == "float32")
+            return std::pair{PlyType::Float32, size_t{4}};
+        if (name == "double" || name == "float64")
+            return std::pair{PlyType::Float64, size_t{8}};
+        return std::nullopt;
+    }
 
     [[nodiscard]] std::expected<std::pair<size_t, FastPropertyLayout>, std::string>
     parse_header(const char* data, size_t file_size) {
@@ -206,6 +158,7 @@ namespace gs::loader {
         FastPropertyLayout layout = {};
         bool is_binary = false;
         bool found_vertex = false;
+        bool in_vertex = false;
         size_t lines_parsed = 0;
         constexpr size_t MAX_HEADER_LINES = 10000; // Prevent infinite loops
 
@@ -246,13 +199,34 @@ namespace gs::loader {
             // Ultra-fast line parsing with minimal allocations
             if (line_len >= 27 && std::strncmp(line_start, "format binary_little_endian", 27) == 0) {
                 is_binary = true;
+            } else if (line_len >= 24 && std::strncmp(line_start, "format binary_big_endian", 24) == 0) {
+                is_binary = true;
+                layout.big_endian = true;
             } else if (line_len >= 15 && std::strncmp(line_start, "element vertex ", 15) == 0) {
                 layout.vertex_count = std::strtoull(line_start + 15, nullptr, 10);
                 layout.vertex_stride = 0;
                 found_vertex = true;
-            } else if (line_len >= 15 && std::strncmp(line_start, "property float ", 15) == 0 && found_vertex) {
-                const char* prop_name = line_start + 15;
-                size_t name_len = line_len - 15;
+                in_vertex = true;
+            } else if (line_len >= 8 && std::strncmp(line_start, "element ", 8) == 0) {
+                // Faces and other elements follow the vertices and are not read
+                if (!found_vertex) {
+                    LOG_ERROR("PLY vertex element must come first");
+                    throw std::runtime_error("PLY vertex element must come first");
+                }
+                in_vertex = false;
+            } else if (line_len >= 9 && std::strncmp(line_start, "property ", 9) == 0 && in_vertex) {
+                const std::string_view declaration(line_start + 9, line_len - 9);
+                const size_t space = declaration.find(' ');
+                const auto type_name = declaration.substr(0, space);
+                const auto type = parse_property_type(type_name);
+                if (!type || space == std::string_view::npos) {
+                    std::string error_msg = std::format("Unsupported vertex property: {}", declaration);
+                    LOG_ERROR("{}", error_msg);
+                    throw std::runtime_error(error_msg);
+                }
+
+                const char* prop_name = declaration.data() + space + 1;
+                size_t name_len = declaration.size() - space - 1;
 
                 // Remove trailing whitespace/CR
                 while (name_len > 0 && (prop_name[name_len - 1] == ' ' ||
@@ -293,16 +267,45 @@ namespace gs::loader {
                     int idx = prop_name[4] - '0';
                     if (idx >= 0 && idx < 4)
                         layout.rot_offsets[idx] = layout.vertex_stride;
+                } else if (name_len == 3 && std::strncmp(prop_name, "red", 3) == 0) {
+                    layout.color_offsets[0] = layout.vertex_stride;
+                } else if (name_len == 5 && std::strncmp(prop_name, "green", 5) == 0) {
+                    layout.color_offsets[1] = layout.vertex_stride;
+                } else if (name_len == 4 && std::strncmp(prop_name, "blue", 4) == 0) {
+                    layout.color_offsets[2] = layout.vertex_stride;
                 }
 
-                layout.vertex_stride += 4; // All properties are float32
+                layout.properties.push_back({type->first, layout.source_stride});
+                layout.source_stride += type->second;
+                layout.vertex_stride += 4; // Every property is a float column once converted
+                if (type->first != PlyType::Float32)
+                    layout.float_only = false;
             } else if (line_len >= 10 && std::strncmp(line_start, "end_header", 10) == 0) {
                 if (!is_binary || !found_vertex) {
                     LOG_ERROR("Only binary PLY with position supported");
                     throw std::runtime_error("Only binary PLY with position supported");
                 }
-                LOG_DEBUG("Header parsed - {} lines, stride: {} bytes, dc: {}, rest: {}",
-                          lines_parsed, layout.vertex_stride, layout.dc_count, layout.rest_count);
+
+                // Point clouds from other tools carry colors instead of SH, they become the DC band
+                if (layout.dc_count == 0 && layout.color_offsets[0] != SIZE_MAX &&
+                    layout.color_offsets[1] == layout.color_offsets[0] + 4 &&
+                    layout.color_offsets[2] == layout.color_offsets[0] + 8) {
+                    layout.dc_start_offset = layout.color_offsets[0];
+                    layout.dc_count = ply_constants::COLOR_CHANNELS;
+                    for (const size_t offset : layout.color_offsets) {
+                        auto& property = layout.properties[offset / 4];
+                        const float range = property.type == PlyType::UInt8    ? 255.0f
+                                            : property.type == PlyType::UInt16 ? 65535.0f
+                                                                               : 1.0f;
+                        property.scale = 1.0f / (range * ply_constants::SH_C0);
+                        property.bias = -0.5f / ply_constants::SH_C0;
+                    }
+                    layout.float_only = false;
+                }
+                if (layout.big_endian)
+                    layout.float_only = false;
+                LOG_DEBUG("Header parsed - {} lines, stride: {} bytes ({} in the file), dc: {}, rest: {}",
+                          lines_parsed, layout.vertex_stride, layout.source_stride, layout.dc_count, layout.rest_count);
                 return std::make_pair(ptr - data, layout);
             }
         }
@@ -317,19 +320,9 @@ namespace gs::loader {
         throw std::runtime_error("No end_header found in PLY file");
     }
 
-    // SIMD position extraction
-    void extract_positions(const char* vertex_data, const FastPropertyLayout& layout, const torch::Tensor& means) {
-        const size_t count = layout.vertex_count;
-        const size_t stride = layout.vertex_stride;
-        float* output = means.data_ptr<float>();
-
-        if (!layout.has_positions())
-            return;
-
-        LOG_DEBUG("Position extraction using TBB + SIMD for {} Gaussians", count);
-
 #ifdef HAS_AVX2_SUPPORT
-        // Thread-safe AVX2 detection using std::once_flag
+    // Thread-safe AVX2 detection, the binary may run on CPUs without it
+    [[nodiscard]] bool cpu_has_avx2() {
         static std::once_flag avx2_flag;
         static bool has_avx2 = false;
 
@@ -345,8 +338,23 @@ namespace gs::loader {
             has_avx2 = false; // Fallback for other compilers
 #endif
         });
+        return has_avx2;
+    }
+#endif
 
-        if (has_avx2) {
+    // SIMD position extraction
+    void extract_positions(const char* vertex_data, const FastPropertyLayout& layout, const torch::Tensor& means) {
+        const size_t count = layout.vertex_count;
+        const size_t stride = layout.vertex_stride;
+        float* output = means.data_ptr<float>();
+
+        if (!layout.has_positions())
+            return;
+
+        LOG_DEBUG("Position extraction using TBB + SIMD for {} Gaussians", count);
+
+#ifdef HAS_AVX2_SUPPORT
+        if (cpu_has_avx2()) {
             LOG_TRACE("Using AVX2 SIMD acceleration");
 
             // TBB parallel SIMD processing with larger blocks to reduce overhead
@@ -493,6 +501,391 @@ namespace gs::loader {
                           });
     }
 
+    template <typename F>
+    void dispatch_ply_type(const PlyType type, F&& f) {
+        switch (type) {
+        case PlyType::Int8: f(int8_t{}); break;
+        case PlyType::UInt8: f(uint8_t{}); break;
+        case PlyType::Int16: f(int16_t{}); break;
+        case PlyType::UInt16: f(uint16_t{}); break;
+        case PlyType::Int32: f(int32_t{}); break;
+        case PlyType::UInt32: f(uint32_t{}); break;
+        case PlyType::Float32: f(float{}); break;
+        case PlyType::Float64: f(double{}); break;
+        }
+    }
+
+    // Rows [first, last) of one column, src pointing at the property in row 0
+    template <typename T, bool SWAP>
+    void convert_column_scalar(const char* src, size_t stride, size_t first, size_t last,
+                               float* dst, size_t dst_stride, float scale, float bias) {
+        using Bits = std::conditional_t<sizeof(T) == 1, uint8_t,
+                                        std::conditional_t<sizeof(T) == 2, uint16_t,
+                                                           std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+        for (size_t i = first; i < last; ++i) {
+            Bits bits;
+            std::memcpy(&bits, src + i * stride, sizeof(Bits));
+            if constexpr (SWAP)
+                bits = std::byteswap(bits);
+            dst[i * dst_stride] = static_cast<float>(std::bit_cast<T>(bits)) * scale + bias;
+        }
+    }
+
+#ifdef HAS_AVX2_SUPPORT
+    // Eight rows of one column per step: one gather, a byte shuffle for big-endian files and the
+    // widening to float all stay in registers. Every gather lane reads 4 or 8 bytes, so the caller
+    // leaves the last row of the file to the scalar path. Returns the first row not converted.
+    size_t convert_column_avx2(const char* src, size_t stride, PlyType type, bool swap, size_t first, size_t last,
+                               float* dst, size_t dst_stride, float scale, float bias) {
+        const __m256i rows = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                                _mm256_set1_epi32(static_cast<int>(stride)));
+        const __m128i rows_lo = _mm256_castsi256_si128(rows);
+        const __m128i rows_hi = _mm256_extracti128_si256(rows, 1);
+        const __m256i swap32 = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        const __m256i swap64 = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                                7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+        const __m256 scale_v = _mm256_set1_ps(scale);
+        const __m256 bias_v = _mm256_set1_ps(bias);
+
+        size_t i = first;
+        for (; i + ply_constants::SIMD_WIDTH <= last; i += ply_constants::SIMD_WIDTH) {
+            const char* base = src + i * stride;
+            __m256 values;
+            if (type == PlyType::Float64) {
+                __m256i lo = _mm256_castpd_si256(_mm256_i32gather_pd(reinterpret_cast<const double*>(base), rows_lo, 1));
+                __m256i hi = _mm256_castpd_si256(_mm256_i32gather_pd(reinterpret_cast<const double*>(base), rows_hi, 1));
+                if (swap) {
+                    lo = _mm256_shuffle_epi8(lo, swap64);
+                    hi = _mm256_shuffle_epi8(hi, swap64);
+                }
+                values = _mm256_set_m128(_mm256_cvtpd_ps(_mm256_castsi256_pd(hi)),
+                                         _mm256_cvtpd_ps(_mm256_castsi256_pd(lo)));
+            } else {
+                __m256i words = _mm256_i32gather_epi32(reinterpret_cast<const int*>(base), rows, 1);
+                // A swapped 16-bit value ends up in the upper half of its lane
+                if (swap && type != PlyType::Int8 && type != PlyType::UInt8)
+                    words = _mm256_shuffle_epi8(words, swap32);
+                switch (type) {
+                case PlyType::Int8:
+                    values = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(words, 24), 24));
+                    break;
+                case PlyType::UInt8:
+                    values = _mm256_cvtepi32_ps(_mm256_and_si256(words, _mm256_set1_epi32(0xff)));
+                    break;
+                case PlyType::Int16:
+                    values = _mm256_cvtepi32_ps(swap ? _mm256_srai_epi32(words, 16)
+                                                     : _mm256_srai_epi32(_mm256_slli_epi32(words, 16), 16));
+                    break;
+                case PlyType::UInt16:
+                    values = _mm256_cvtepi32_ps(swap ? _mm256_srli_epi32(words, 16)
+                                                     : _mm256_and_si256(words, _mm256_set1_epi32(0xffff)));
+                    break;
+                case PlyType::Int32:
+                    values = _mm256_cvtepi32_ps(words);
+                    break;
+                case PlyType::UInt32:
+                    // No unsigned conversion in AVX2, the halves are converted separately
+                    values = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(words, 16)), _mm256_set1_ps(65536.0f),
+                                             _mm256_cvtepi32_ps(_mm256_and_si256(words, _mm256_set1_epi32(0xffff))));
+                    break;
+                default:
+                    values = _mm256_castsi256_ps(words);
+                    break;
+                }
+            }
+            values = _mm256_fmadd_ps(values, scale_v, bias_v);
+
+            alignas(32) float lanes[ply_constants::SIMD_WIDTH];
+            _mm256_store_ps(lanes, values);
+            for (int j = 0; j < ply_constants::SIMD_WIDTH; ++j) {
+                dst[(i + j) * dst_stride] = lanes[j];
+            }
+        }
+        return i;
+    }
+#endif
+
+    // Converts the file's vertex records of any property types and byte order into float rows,
+    // the layout the GPU and CPU paths read. Row chunks are converted in parallel, column by column.
+    torch::Tensor convert_vertex_records(const char* vertex_data, const FastPropertyLayout& layout) {
+        LOG_TIMER_TRACE("PLY vertex record conversion");
+
+        const size_t count = layout.vertex_count;
+        const size_t columns = layout.properties.size();
+        auto rows = torch::empty({static_cast<int64_t>(count), static_cast<int64_t>(columns)},
+                                 torch::TensorOptions().dtype(torch::kFloat32));
+        float* output = rows.data_ptr<float>();
+        if (count == 0)
+            return rows;
+
+#ifdef HAS_AVX2_SUPPORT
+        // The gathers read 4 bytes for narrower types; leaving out the last record keeps them in the
+        // buffer only while a record holds 4 bytes, shorter records take the scalar loop
+        const bool use_avx2 = cpu_has_avx2() && layout.source_stride >= 4;
+#else
+        constexpr bool use_avx2 = false;
+#endif
+        LOG_DEBUG("Converting {} vertex records of {} properties ({}{})", count, columns,
+                  layout.big_endian ? "big-endian" : "little-endian", use_avx2 ? ", AVX2" : "");
+
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, count, ply_constants::BLOCK_SIZE_LARGE),
+                          [&](const tbb::blocked_range<size_t>& range) {
+                              for (size_t c = 0; c < columns; ++c) {
+                                  const auto& property = layout.properties[c];
+                                  const char* src = vertex_data + property.offset;
+                                  size_t first = range.begin();
+#ifdef HAS_AVX2_SUPPORT
+                                  if (use_avx2) {
+                                      first = convert_column_avx2(src, layout.source_stride, property.type,
+                                                                  layout.big_endian, first,
+                                                                  std::min(range.end(), count - 1), output + c,
+                                                                  columns, property.scale, property.bias);
+                                  }
+#endif
+                                  dispatch_ply_type(property.type, [&]<typename T>(T) {
+                                      if (layout.big_endian) {
+                                          convert_column_scalar<T, true>(src, layout.source_stride, first, range.end(),
+                                                                         output + c, columns, property.scale, property.bias);
+                                      } else {
+                                          convert_column_scalar<T, false>(src, layout.source_stride, first, range.end(),
+                                                                          output + c, columns, property.scale, property.bias);
+                                      }
+                                  });
+                              }
+                          });
+        return rows;
+    }
+
+    struct GaussianTensors {
+        torch::Tensor means, sh0, shN, scaling, rotation, opacity;
+    };
+
+    // The GPU path needs records that are plain rows of float32
+    [[nodiscard]] bool supports_gpu_deinterleave(const FastPropertyLayout& layout) {
+        return layout.float_only && layout.has_positions() &&
+               layout.vertex_stride > 0 && layout.vertex_stride % sizeof(float) == 0 &&
+               torch::cuda::is_available();
+    }
+
+    // Streams the packed vertex records to the GPU through two pinned staging buffers and
+    // de-interleaves each chunk into the SoA tensors there. Copying the next chunk out of the
+    // mapping overlaps with the upload and column gathers of the previous one, and no
+    // per-attribute CPU tensors are built.
+    GaussianTensors load_vertices_cuda(const char* vertex_data, const FastPropertyLayout& layout) {
+        const auto count = static_cast<int64_t>(layout.vertex_count);
+        const size_t stride = layout.vertex_stride;
+        const auto row_floats = static_cast<int64_t>(stride / sizeof(float));
+        const auto column = [](size_t offset) { return static_cast<int64_t>(offset / sizeof(float)); };
+
+        const auto cuda = torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA);
+        const auto index_options = torch::TensorOptions().dtype(torch::kInt64).device(torch::kCUDA);
+
+        const int dc_basis = (layout.dc_count > 0 && layout.dc_count % ply_constants::COLOR_CHANNELS == 0)
+                                 ? layout.dc_count / ply_constants::COLOR_CHANNELS
+                                 : 0;
+        const int rest_basis = (layout.rest_count > 0 && layout.rest_count % ply_constants::COLOR_CHANNELS == 0)
+                                   ? layout.rest_count / ply_constants::COLOR_CHANNELS
+                                   : 0;
+
+        // Same defaults as the CPU path for missing attributes
+        GaussianTensors out;
+        out.means = torch::empty({count, 3}, cuda);
+        out.sh0 = dc_basis > 0 ? torch::empty({count, dc_basis, ply_constants::COLOR_CHANNELS}, cuda)
+                               : torch::zeros({count, 1, ply_constants::COLOR_CHANNELS}, cuda);
+        out.shN = rest_basis > 0 ? torch::empty({count, rest_basis, ply_constants::COLOR_CHANNELS}, cuda)
+                                 : torch::zeros({count, ply_constants::SH_DEGREE_3_REST_COEFFS, ply_constants::COLOR_CHANNELS}, cuda);
+        out.opacity = layout.has_opacity() ? torch::empty({count, 1}, cuda) : torch::zeros({count, 1}, cuda);
+        out.scaling = layout.has_scaling() ? torch::empty({count, 3}, cuda)
+                                           : torch::full({count, 3}, ply_constants::DEFAULT_LOG_SCALE, cuda);
+        if (layout.has_rotation()) {
+            out.rotation = torch::empty({count, 4}, cuda);
+        } else {
+            out.rotation = torch::zeros({count, 4}, cuda);
+            out.rotation.select(1, 0).fill_(ply_constants::IDENTITY_QUATERNION_W);
+        }
+
+        const auto position_columns = torch::tensor(
+            {column(layout.pos_x_offset), column(layout.pos_y_offset), column(layout.pos_z_offset)}, index_options);
+        torch::Tensor scale_columns, rotation_columns;
+        if (layout.has_scaling()) {
+            scale_columns = torch::tensor({column(layout.scale_offsets[0]), column(layout.scale_offsets[1]),
+                                           column(layout.scale_offsets[2])},
+                                          index_options);
+        }
+        if (layout.has_rotation()) {
+            rotation_columns = torch::tensor({column(layout.rot_offsets[0]), column(layout.rot_offsets[1]),
+                                              column(layout.rot_offsets[2]), column(layout.rot_offsets[3])},
+                                             index_options);
+        }
+
+        struct StagingSlot {
+            torch::Tensor host;
+            torch::Tensor device;
+            at::cuda::CUDAEvent consumed;
+        };
+        const size_t rows_per_chunk = std::max<size_t>(1, ply_constants::UPLOAD_CHUNK_BYTES / stride);
+        const size_t chunk_bytes = rows_per_chunk * stride;
+        std::array<StagingSlot, 2> slots;
+        for (auto& slot : slots) {
+            slot.host = torch::empty({static_cast<int64_t>(chunk_bytes)},
+                                     torch::TensorOptions().dtype(torch::kUInt8).pinned_memory(true));
+            slot.device = torch::empty({static_cast<int64_t>(chunk_bytes)},
+                                       torch::TensorOptions().dtype(torch::kUInt8).device(torch::kCUDA));
+        }
+
+        size_t chunk_index = 0;
+        for (size_t first = 0; first < layout.vertex_count; first += rows_per_chunk, ++chunk_index) {
+            auto& slot = slots[chunk_index % slots.size()];
+            // The slot's previous upload and gathers must be done before its pinned buffer is reused
+            slot.consumed.synchronize();
+
+            const size_t rows = std::min(rows_per_chunk, layout.vertex_count - first);
+            const size_t bytes = rows * stride;
+            const char* src = vertex_data + first * stride;
+            auto* dst = slot.host.data_ptr<uint8_t>();
+
+            // Page faults on the mapping dominate, a parallel copy keeps several in flight
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, bytes, ply_constants::STAGING_COPY_GRAIN),
+                              [&](const tbb::blocked_range<size_t>& range) {
+                                  std::memcpy(dst + range.begin(), src + range.begin(), range.size());
+                              });
+
+            const auto length = static_cast<int64_t>(bytes);
+            auto device_bytes = slot.device.narrow(0, 0, length);
+            device_bytes.copy_(slot.host.narrow(0, 0, length), /*non_blocking=*/true);
+            const auto records = device_bytes.view(torch::kFloat32).view({static_cast<int64_t>(rows), row_floats});
+
+            const auto first_row = static_cast<int64_t>(first);
+            const auto num_rows = static_cast<int64_t>(rows);
+            out.means.narrow(0, first_row, num_rows).copy_(records.index_select(1, position_columns));
+            if (dc_basis > 0) {
+                // f_dc_j holds channel j / B, basis j % B, stored as [N, B, 3]
+                out.sh0.narrow(0, first_row, num_rows)
+                    .copy_(records.narrow(1, column(layout.dc_start_offset), layout.dc_count)
+                               .view({num_rows, ply_constants::COLOR_CHANNELS, dc_basis})
+                               .transpose(1, 2));
+            }
+            if (rest_basis > 0) {
+                out.shN.narrow(0, first_row, num_rows)
+                    .copy_(records.narrow(1, column(layout.rest_start_offset), layout.rest_count)
+                               .view({num_rows, ply_constants::COLOR_CHANNELS, rest_basis})
+                               .transpose(1, 2));
+            }
+            if (layout.has_opacity()) {
+                out.opacity.narrow(0, first_row, num_rows).copy_(records.narrow(1, column(layout.opacity_offset), 1));
+            }
+            if (layout.has_scaling()) {
+                out.scaling.narrow(0, first_row, num_rows).copy_(records.index_select(1, scale_columns));
+            }
+            if (layout.has_rotation()) {
+                out.rotation.narrow(0, first_row, num_rows).copy_(records.index_select(1, rotation_columns));
+            }
+
+            slot.consumed.record();
+        }
+
+        for (auto& slot : slots) {
+            slot.consumed.synchronize();
+        }
+        return out;
+    }
+
+    // Builds the SoA tensors on the CPU from the mapped records, then uploads them
+    GaussianTensors load_vertices_cpu(const char* vertex_data, const FastPropertyLayout& layout) {
+        auto options = torch::TensorOptions().dtype(torch::kFloat32);
+
+        // Position extraction
+        auto means = torch::zeros({static_cast<int64_t>(layout.vertex_count), 3}, options);
+        extract_positions(vertex_data, layout, means);
+
+        // SH coefficient extraction
+        torch::Tensor sh0, shN;
+
+        if (layout.dc_count > 0 && layout.dc_count % ply_constants::COLOR_CHANNELS == 0) {
+            int B0 = layout.dc_count / ply_constants::COLOR_CHANNELS;
+            sh0 = torch::zeros({static_cast<int64_t>(layout.vertex_count), B0, ply_constants::COLOR_CHANNELS}, options);
+            extract_sh_coefficients(vertex_data, layout, layout.dc_start_offset,
+                                    layout.dc_count, ply_constants::COLOR_CHANNELS, sh0);
+        } else {
+            sh0 = torch::zeros({static_cast<int64_t>(layout.vertex_count), 1, ply_constants::COLOR_CHANNELS}, options);
+        }
+
+        if (layout.rest_count > 0 && layout.rest_count % ply_constants::COLOR_CHANNELS == 0) {
+            int Bn = layout.rest_count / ply_constants::COLOR_CHANNELS;
+            shN = torch::zeros({static_cast<int64_t>(layout.vertex_count), Bn, ply_constants::COLOR_CHANNELS}, options);
+            extract_sh_coefficients(vertex_data, layout, layout.rest_start_offset,
+                                    layout.rest_count, ply_constants::COLOR_CHANNELS, shN);
+        } else {
+            shN = torch::zeros({static_cast<int64_t>(layout.vertex_count), ply_constants::SH_DEGREE_3_REST_COEFFS, ply_constants::COLOR_CHANNELS}, options);
+        }
+
+        // property extraction
+        auto opacity_tensor = torch::zeros({static_cast<int64_t>(layout.vertex_count), 1}, options);
+        if (layout.has_opacity()) {
+            extract_property(vertex_data, layout, layout.opacity_offset, opacity_tensor.data_ptr<float>());
+        }
+
+        auto scaling = torch::zeros({static_cast<int64_t>(layout.vertex_count), 3}, options);
+        if (layout.has_scaling()) {
+            // Extract scale components individually then stack
+            std::vector<float> s0(layout.vertex_count), s1(layout.vertex_count), s2(layout.vertex_count);
+
+            extract_property(vertex_data, layout, layout.scale_offsets[0], s0.data());
+            extract_property(vertex_data, layout, layout.scale_offsets[1], s1.data());
+            extract_property(vertex_data, layout, layout.scale_offsets[2], s2.data());
+
+            // Stack into final tensor
+            auto scaling_ptr = scaling.data_ptr<float>();
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, layout.vertex_count, ply_constants::BLOCK_SIZE_SMALL),
+                              [&](const tbb::blocked_range<size_t>& range) {
+                                  for (size_t i = range.begin(); i < range.end(); ++i) {
+                                      scaling_ptr[i * 3 + 0] = s0[i];
+                                      scaling_ptr[i * 3 + 1] = s1[i];
+                                      scaling_ptr[i * 3 + 2] = s2[i];
+                                  }
+                              });
+        } else {
+            scaling.fill_(ply_constants::DEFAULT_LOG_SCALE);
+        }
+
+        auto rotation = torch::zeros({static_cast<int64_t>(layout.vertex_count), 4}, options);
+        if (layout.has_rotation()) {
+            // Extract rotation components individually then stack
+            std::vector<float> r0(layout.vertex_count), r1(layout.vertex_count), r2(layout.vertex_count), r3(layout.vertex_count);
+
+            extract_property(vertex_data, layout, layout.rot_offsets[0], r0.data());
+            extract_property(vertex_data, layout, layout.rot_offsets[1], r1.data());
+            extract_property(vertex_data, layout, layout.rot_offsets[2], r2.data());
+            extract_property(vertex_data, layout, layout.rot_offsets[3], r3.data());
+
+            // Stack into final tensor
+            auto rotation_ptr = rotation.data_ptr<float>();
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, layout.vertex_count, ply_constants::BLOCK_SIZE_SMALL),
+                              [&](const tbb::blocked_range<size_t>& range) {
+                                  for (size_t i = range.begin(); i < range.end(); ++i) {
+                                      rotation_ptr[i * 4 + 0] = r0[i];
+                                      rotation_ptr[i * 4 + 1] = r1[i];
+                                      rotation_ptr[i * 4 + 2] = r2[i];
+                                      rotation_ptr[i * 4 + 3] = r3[i];
+                                  }
+                              });
+        } else {
+            rotation.select(1, 0).fill_(ply_constants::IDENTITY_QUATERNION_W);
+        }
+
+        LOG_DEBUG("Transferring tensors to CUDA");
+        // Batch CUDA transfer for maximum speed
+        means = means.to(torch::kCUDA);
+        sh0 = sh0.to(torch::kCUDA);
+        shN = shN.to(torch::kCUDA);
+        scaling = scaling.to(torch::kCUDA);
+        rotation = rotation.to(torch::kCUDA);
+        opacity_tensor = opacity_tensor.to(torch::kCUDA);
+
+        return GaussianTensors{means, sh0, shN, scaling, rotation, opacity_tensor};
+    }
+
     // Main function
     [[nodiscard]] std::expected<SplatData, std::string> load_ply(const std::filesystem::path& filepath) {
         try {
@@ -527,95 +920,24 @@ namespace gs::loader {
 
             LOG_INFO("Extracting {} Gaussians from PLY", layout.vertex_count);
 
-            auto options = torch::TensorOptions().dtype(torch::kFloat32);
-
-            // Position extraction
-            auto means = torch::zeros({static_cast<int64_t>(layout.vertex_count), 3}, options);
-            extract_positions(vertex_data, layout, means);
-
-            // SH coefficient extraction
-            torch::Tensor sh0, shN;
-
-            if (layout.dc_count > 0 && layout.dc_count % ply_constants::COLOR_CHANNELS == 0) {
-                int B0 = layout.dc_count / ply_constants::COLOR_CHANNELS;
-                sh0 = torch::zeros({static_cast<int64_t>(layout.vertex_count), B0, ply_constants::COLOR_CHANNELS}, options);
-                extract_sh_coefficients(vertex_data, layout, layout.dc_start_offset,
-                                        layout.dc_count, ply_constants::COLOR_CHANNELS, sh0);
-            } else {
-                sh0 = torch::zeros({static_cast<int64_t>(layout.vertex_count), 1, ply_constants::COLOR_CHANNELS}, options);
-            }
-
-            if (layout.rest_count > 0 && layout.rest_count % ply_constants::COLOR_CHANNELS == 0) {
-                int Bn = layout.rest_count / ply_constants::COLOR_CHANNELS;
-                shN = torch::zeros({static_cast<int64_t>(layout.vertex_count), Bn, ply_constants::COLOR_CHANNELS}, options);
-                extract_sh_coefficients(vertex_data, layout, layout.rest_start_offset,
-                                        layout.rest_count, ply_constants::COLOR_CHANNELS, shN);
-            } else {
-                shN = torch::zeros({static_cast<int64_t>(layout.vertex_count), ply_constants::SH_DEGREE_3_REST_COEFFS, ply_constants::COLOR_CHANNELS}, options);
-            }
-
-            // property extraction
-            auto opacity_tensor = torch::zeros({static_cast<int64_t>(layout.vertex_count), 1}, options);
-            if (layout.has_opacity()) {
-                extract_property(vertex_data, layout, layout.opacity_offset, opacity_tensor.data_ptr<float>());
-            }
-
-            auto scaling = torch::zeros({static_cast<int64_t>(layout.vertex_count), 3}, options);
-            if (layout.has_scaling()) {
-                // Extract scale components individually then stack
-                std::vector<float> s0(layout.vertex_count), s1(layout.vertex_count), s2(layout.vertex_count);
-
-                extract_property(vertex_data, layout, layout.scale_offsets[0], s0.data());
-                extract_property(vertex_data, layout, layout.scale_offsets[1], s1.data());
-                extract_property(vertex_data, layout, layout.scale_offsets[2], s2.data());
-
-                // Stack into final tensor
-                auto scaling_ptr = scaling.data_ptr<float>();
-                tbb::parallel_for(tbb::blocked_range<size_t>(0, layout.vertex_count, ply_constants::BLOCK_SIZE_SMALL),
-                                  [&](const tbb::blocked_range<size_t>& range) {
-                                      for (size_t i = range.begin(); i < range.end(); ++i) {
-                                          scaling_ptr[i * 3 + 0] = s0[i];
-                                          scaling_ptr[i * 3 + 1] = s1[i];
-                                          scaling_ptr[i * 3 + 2] = s2[i];
-                                      }
-                                  });
-            } else {
-                scaling.fill_(ply_constants::DEFAULT_LOG_SCALE);
+            const size_t vertex_bytes = layout.vertex_count * layout.source_stride;
+            if (data_offset + vertex_bytes > file_size) {
+                throw std::runtime_error(std::format("PLY vertex data is truncated: {} of {} bytes present",
+                                                     file_size - data_offset, vertex_bytes));
             }
 
-            auto rotation = torch::zeros({static_cast<int64_t>(layout.vertex_count), 4}, options);
-            if (layout.has_rotation()) {
-                // Extract rotation components individually then stack
-                std::vector<float> r0(layout.vertex_count), r1(layout.vertex_count), r2(layout.vertex_count), r3(layout.vertex_count);
-
-                extract_property(vertex_data, layout, layout.rot_offsets[0], r0.data());
-                extract_property(vertex_data, layout, layout.rot_offsets[1], r1.data());
-                extract_property(vertex_data, layout, layout.rot_offsets[2], r2.data());
-                extract_property(vertex_data, layout, layout.rot_offsets[3], r3.data());
-
-                // Stack into final tensor
-                auto rotation_ptr = rotation.data_ptr<float>();
-                tbb::parallel_for(tbb::blocked_range<size_t>(0, layout.vertex_count, ply_constants::BLOCK_SIZE_SMALL),
-                                  [&](const tbb::blocked_range<size_t>& range) {
-                                      for (size_t i = range.begin(); i < range.end(); ++i) {
-                                          rotation_ptr[i * 4 + 0] = r0[i];
-                                          rotation_ptr[i * 4 + 1] = r1[i];
-                                          rotation_ptr[i * 4 + 2] = r2[i];
-                                          rotation_ptr[i * 4 + 3] = r3[i];
-                                      }
-                                  });
-            } else {
-                rotation.select(1, 0).fill_(ply_constants::IDENTITY_QUATERNION_W);
+            // Other property types or byte orders are converted to float rows once, up front
+            torch::Tensor converted_records;
+            if (!layout.float_only) {
+                converted_records = convert_vertex_records(vertex_data, layout);
+                vertex_data = reinterpret_cast<const char*>(converted_records.data_ptr<float>());
+                layout.float_only = true;
             }
 
-            LOG_DEBUG("Transferring tensors to CUDA");
-            // Batch CUDA transfer for maximum speed
-            means = means.to(torch::kCUDA);
-            sh0 = sh0.to(torch::kCUDA);
-            shN = shN.to(torch::kCUDA);
-            scaling = scaling.to(torch::kCUDA);
-            rotation = rotation.to(torch::kCUDA);
-            opacity_tensor = opacity_tensor.to(torch::kCUDA);
+            const bool gpu_path = supports_gpu_deinterleave(layout);
+            LOG_DEBUG("De-interleaving vertex records on the {}", gpu_path ? "GPU" : "CPU");
+            auto [means, sh0, shN, scaling, rotation, opacity_tensor] =
+                gpu_path ? load_vertices_cuda(vertex_data, layout) : load_vertices_cpu(vertex_data, layout);
 
             int sh_degree = static_cast<int>(std::sqrt(shN.size(1) + ply_constants::SH_DEGREE_OFFSET)) - ply_constants::SH_DEGREE_OFFSET;
 
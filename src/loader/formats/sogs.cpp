@@ -13,7 +13,9 @@
 #include <cmath>
 #include <cstddef>
 #include <fstream>
+#include <future>
 #include <nlohmann/json.hpp>
+#include <optional>
 #include <sstream>
 #include <torch/torch.h>
 #include <unordered_map>
@@ -27,103 +29,47 @@ namespace gs::loader {
         using ssize_t = std::ptrdiff_t;
 #endif
 
-        // Identity layout matching the exporter
-        int identity_layout(int index, [[maybe_unused]] int width) {
-            return index;
-        }
-
         // SH coefficient counts per degree
         constexpr int SH_COEFFS[] = {0, 3, 8, 15};
 
-        float inverse_log_transform(float value) {
-            float sign = value >= 0 ? 1.0f : -1.0f;
-            return sign * (std::exp(std::abs(value)) - 1.0f);
-        }
-
-        std::array<float, 4> unpack_quaternion(
-            uint8_t a, uint8_t b, uint8_t c, uint8_t type) {
-
-            // Determine which component was largest during packing
-            int largest = type - 252; // 0=w, 1=x, 2=y, 3=z
-            if (largest < 0 || largest > 3) {
-                LOG_WARN("Invalid quaternion type: {}, defaulting to w", type);
-                largest = 0;
-            }
-
-            // Unpack the three stored components with sqrt(2) scaling
-            constexpr float sqrt2 = 1.41421356237f;
-            float v0 = (a / 255.0f - 0.5f) * sqrt2;
-            float v1 = (b / 255.0f - 0.5f) * sqrt2;
-            float v2 = (c / 255.0f - 0.5f) * sqrt2;
-
-            // Reconstruct the largest component
-            float largest_val = std::sqrt(std::clamp(1.0f - (v0 * v0 + v1 * v1 + v2 * v2), 0.0f, 1.0f));
-
-            // Build the quaternion [x, y, z, w] based on what was packed
-            std::array<float, 4> quat; // [x, y, z, w]
-
-            if (largest == 0) {
-                // w was largest, stored [x, y, z]
-                quat[0] = v0;          // x
-                quat[1] = v1;          // y
-                quat[2] = v2;          // z
-                quat[3] = largest_val; // w
-            } else if (largest == 1) {
-                // x was largest, stored [w, y, z]
-                quat[0] = largest_val; // x
-                quat[1] = v1;          // y
-                quat[2] = v2;          // z
-                quat[3] = v0;          // w
-            } else if (largest == 2) {
-                // y was largest, stored [w, x, z]
-                quat[0] = v1;          // x
-                quat[1] = largest_val; // y
-                quat[2] = v2;          // z
-                quat[3] = v0;          // w
-            } else {                   // largest == 3
-                // z was largest, stored [w, x, y]
-                quat[0] = v1;          // x
-                quat[1] = v2;          // y
-                quat[2] = largest_val; // z
-                quat[3] = v0;          // w
+        // Decodes into a host uint8 [height, width, 4] tensor without an intermediate copy
+        std::expected<torch::Tensor, std::string> decode_webp(const std::vector<uint8_t>& data) {
+            int width = 0, height = 0;
+            if (data.empty() || !WebPGetInfo(data.data(), data.size(), &width, &height)) {
+                return std::unexpected("Failed to get WebP info");
             }
 
-            // Normalize quaternion
-            float len = std::sqrt(quat[0] * quat[0] + quat[1] * quat[1] +
-                                  quat[2] * quat[2] + quat[3] * quat[3]);
-            if (len > 0) {
-                for (auto& v : quat)
-                    v /= len;
+            auto rgba = torch::empty({height, width, 4}, torch::kUInt8);
+            if (!WebPDecodeRGBAInto(data.data(), data.size(), rgba.data_ptr<uint8_t>(),
+                                    static_cast<size_t>(rgba.numel()), width * 4)) {
+                return std::unexpected("Failed to decode WebP image");
             }
-
-            return quat; // Returns [x, y, z, w]
+            return rgba;
         }
 
-        std::expected<std::vector<uint8_t>, std::string> decode_webp(
-            const uint8_t* data, size_t size, int& width, int& height) {
+        using SogImages = std::unordered_map<std::string, torch::Tensor>;
 
-            if (!data || size == 0) {
-                return std::unexpected("Invalid WebP data");
-            }
+        // The planes are independent, so every one decodes on its own thread
+        std::expected<SogImages, std::string> decode_images(
+            std::vector<std::pair<std::string, std::vector<uint8_t>>> files) {
 
-            // Get image info
-            if (!WebPGetInfo(data, size, &width, &height)) {
-                return std::unexpected("Failed to get WebP info");
+            std::vector<std::pair<std::string, std::future<std::expected<torch::Tensor, std::string>>>> decodes;
+            decodes.reserve(files.size());
+            for (auto& [filename, data] : files) {
+                decodes.emplace_back(filename, std::async(std::launch::async, [data = std::move(data)] {
+                                         return decode_webp(data);
+                                     }));
             }
 
-            // Decode RGBA
-            std::vector<uint8_t> rgba(width * height * 4);
-            uint8_t* result = WebPDecodeRGBA(data, size, &width, &height);
-
-            if (!result) {
-                return std::unexpected("Failed to decode WebP image");
+            SogImages images;
+            for (auto& [filename, decode] : decodes) {
+                auto decoded = decode.get();
+                if (!decoded) {
+                    return std::unexpected(std::format("Failed to decode {}: {}", filename, decoded.error()));
+                }
+                images[filename] = std::move(*decoded);
             }
-
-            // Copy to vector
-            std::memcpy(rgba.data(), result, width * height * 4);
-            WebPFree(result);
-
-            return rgba;
+            return images;
         }
 
         struct SogMetadata {
@@ -228,7 +174,7 @@ namespace gs::loader {
 
         std::expected<SplatData, std::string> reconstruct_splat_data(
             const SogMetadata& meta,
-            const std::unordered_map<std::string, std::vector<uint8_t>>& images) {
+            const SogImages& images) {
 
             const int num_splats = meta.count;
 
@@ -242,238 +188,150 @@ namespace gs::loader {
 
             LOG_DEBUG("Reconstructing {} splats from {}x{} textures", num_splats, width, height);
 
-            // Create output tensors
-            torch::Tensor means = torch::zeros({num_splats, 3}, torch::kFloat32);
-            torch::Tensor scales = torch::zeros({num_splats, 3}, torch::kFloat32);
-            torch::Tensor rotations = torch::zeros({num_splats, 4}, torch::kFloat32);
-            torch::Tensor sh0 = torch::zeros({num_splats, 1, 3}, torch::kFloat32);
-            torch::Tensor opacity = torch::zeros({num_splats, 1}, torch::kFloat32);
-
-            // Accessors for fast CPU access
-            auto means_acc = means.accessor<float, 2>();
-            auto scales_acc = scales.accessor<float, 2>();
-            auto rot_acc = rotations.accessor<float, 2>();
-            auto sh0_acc = sh0.accessor<float, 3>();
-            auto opacity_acc = opacity.accessor<float, 2>();
-
-            // 1. Decode positions from means_l and means_u
-            {
-                auto it_l = images.find("means_l.webp");
-                auto it_u = images.find("means_u.webp");
-
-                if (it_l == images.end() || it_u == images.end()) {
-                    return std::unexpected("Missing position textures");
-                }
-
-                const auto& means_l = it_l->second;
-                const auto& means_u = it_u->second;
-
-                for (int i = 0; i < num_splats; ++i) {
-                    int ti = identity_layout(i, width) * 4;
-
-                    // Reconstruct 16-bit values
-                    uint16_t x16 = means_l[ti + 0] | (means_u[ti + 0] << 8);
-                    uint16_t y16 = means_l[ti + 1] | (means_u[ti + 1] << 8);
-                    uint16_t z16 = means_l[ti + 2] | (means_u[ti + 2] << 8);
-
-                    // Normalize and inverse transform
-                    float x_norm = x16 / 65535.0f;
-                    float y_norm = y16 / 65535.0f;
-                    float z_norm = z16 / 65535.0f;
-
-                    float x_log = x_norm * (meta.means_maxs[0] - meta.means_mins[0]) + meta.means_mins[0];
-                    float y_log = y_norm * (meta.means_maxs[1] - meta.means_mins[1]) + meta.means_mins[1];
-                    float z_log = z_norm * (meta.means_maxs[2] - meta.means_mins[2]) + meta.means_mins[2];
-
-                    means_acc[i][0] = inverse_log_transform(x_log);
-                    means_acc[i][1] = inverse_log_transform(y_log);
-                    means_acc[i][2] = inverse_log_transform(z_log);
-                }
-            }
-
-            // 2. Decode quaternions
-            {
-                auto it = images.find("quats.webp");
+            // Texels of the first num_splats pixels on the device as int32 [num_splats, 4]
+            auto splat_texels = [&](const std::string& filename) -> std::expected<torch::Tensor, std::string> {
+                auto it = images.find(filename);
                 if (it == images.end()) {
-                    return std::unexpected("Missing quaternion texture");
+                    return std::unexpected(std::format("Missing texture {}", filename));
                 }
-
-                const auto& quats = it->second;
-
-                for (int i = 0; i < num_splats; ++i) {
-                    int ti = identity_layout(i, width) * 4;
-
-                    auto quat = unpack_quaternion(
-                        quats[ti + 0],
-                        quats[ti + 1],
-                        quats[ti + 2],
-                        quats[ti + 3]);
-
-                    // unpack_quaternion returns [x, y, z, w]
-                    // Store as [w, x, y, z] for SplatData format
-                    rot_acc[i][0] = quat[3]; // w
-                    rot_acc[i][1] = quat[0]; // x
-                    rot_acc[i][2] = quat[1]; // y
-                    rot_acc[i][3] = quat[2]; // z
+                const auto pixels = it->second.reshape({-1, 4});
+                if (pixels.size(0) < num_splats) {
+                    return std::unexpected(std::format("{} holds {} pixels for {} splats",
+                                                       filename, pixels.size(0), num_splats));
                 }
-            }
+                return pixels.narrow(0, 0, num_splats).to(torch::kCUDA).to(torch::kInt32);
+            };
 
-            // 3. Decode scales
-            {
-                auto it = images.find("scales.webp");
-                if (it == images.end()) {
-                    return std::unexpected("Missing scales texture");
+            // Codebook lookup, labels are [..., C] int32 indices
+            auto lookup = [](const std::vector<float>& codebook, const torch::Tensor& labels,
+                             const char* what) -> std::expected<torch::Tensor, std::string> {
+                if (codebook.empty()) {
+                    return std::unexpected(std::format("Empty {} codebook", what));
                 }
-
-                const auto& scales_img = it->second;
-
-                for (int i = 0; i < num_splats; ++i) {
-                    int ti = identity_layout(i, width) * 4;
-
-                    // Get indices and validate
-                    uint8_t idx0 = scales_img[ti + 0];
-                    uint8_t idx1 = scales_img[ti + 1];
-                    uint8_t idx2 = scales_img[ti + 2];
-
-                    // Ensure indices are within codebook bounds
-                    if (idx0 >= meta.scales_codebook.size() ||
-                        idx1 >= meta.scales_codebook.size() ||
-                        idx2 >= meta.scales_codebook.size()) {
-                        LOG_ERROR("Scale codebook index out of bounds: {}, {}, {} (codebook size: {})",
-                                  idx0, idx1, idx2, meta.scales_codebook.size());
-                        return std::unexpected("Invalid scale codebook index");
+                if (labels.numel() > 0) {
+                    if (const int max_label = labels.max().item<int>(); max_label >= static_cast<int>(codebook.size())) {
+                        LOG_ERROR("{} codebook index out of bounds: {} (codebook size: {})", what, max_label, codebook.size());
+                        return std::unexpected(std::format("Invalid {} codebook index", what));
                     }
-
-                    // Look up from codebook (already in log space)
-                    scales_acc[i][0] = meta.scales_codebook[idx0];
-                    scales_acc[i][1] = meta.scales_codebook[idx1];
-                    scales_acc[i][2] = meta.scales_codebook[idx2];
                 }
-            }
+                const auto table = torch::tensor(codebook, torch::kFloat32).to(labels.device());
+                return table.index_select(0, labels.reshape({-1}).to(torch::kInt64)).reshape(labels.sizes());
+            };
 
-            // 4. Decode colors and opacity
+            // 1. Decode positions from means_l and means_u
+            auto means_l = splat_texels("means_l.webp");
+            auto means_u = splat_texels("means_u.webp");
+            if (!means_l || !means_u) {
+                return std::unexpected("Missing position textures");
+            }
+            const auto float_options = torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA);
+            const auto mins = torch::tensor(meta.means_mins, torch::kFloat32).to(torch::kCUDA);
+            const auto maxs = torch::tensor(meta.means_maxs, torch::kFloat32).to(torch::kCUDA);
+            const auto means_norm = (means_l->narrow(1, 0, 3) + means_u->narrow(1, 0, 3) * 256).to(torch::kFloat32) / 65535.0f;
+            const auto means_log = means_norm * (maxs - mins) + mins;
+            torch::Tensor means = torch::sign(means_log) * (torch::exp(torch::abs(means_log)) - 1.0f);
+
+            // 2. Decode quaternions: three stored components and 252 + the index (w, x, y, z) of the dropped one
+            auto quats = splat_texels("quats.webp");
+            if (!quats) {
+                return std::unexpected("Missing quaternion texture");
+            }
+            torch::Tensor rotations;
             {
-                auto it = images.find("sh0.webp");
-                if (it == images.end()) {
-                    return std::unexpected("Missing color texture");
+                auto largest = quats->select(1, 3) - 252;
+                const auto invalid = (largest < 0) | (largest > 3);
+                if (const int64_t n_invalid = invalid.sum().item<int64_t>(); n_invalid > 0) {
+                    LOG_WARN("{} invalid quaternion types, defaulting to w", n_invalid);
+                    largest = largest.masked_fill(invalid, 0);
                 }
 
-                const auto& sh0_img = it->second;
-
-                for (int i = 0; i < num_splats; ++i) {
-                    int ti = identity_layout(i, width) * 4;
-
-                    // Get indices and validate
-                    uint8_t idx0 = sh0_img[ti + 0];
-                    uint8_t idx1 = sh0_img[ti + 1];
-                    uint8_t idx2 = sh0_img[ti + 2];
-
-                    // Ensure indices are within codebook bounds
-                    if (idx0 >= meta.sh0_codebook.size() ||
-                        idx1 >= meta.sh0_codebook.size() ||
-                        idx2 >= meta.sh0_codebook.size()) {
-                        LOG_ERROR("Color codebook index out of bounds: {}, {}, {} (codebook size: {})",
-                                  idx0, idx1, idx2, meta.sh0_codebook.size());
-                        return std::unexpected("Invalid color codebook index");
-                    }
+                constexpr float sqrt2 = 1.41421356237f;
+                const auto stored = (quats->narrow(1, 0, 3).to(torch::kFloat32) / 255.0f - 0.5f) * sqrt2;
+                const auto dropped = torch::sqrt(torch::clamp(1.0f - stored.pow(2).sum(1, true), 0.0f, 1.0f));
+
+                // Column of [stored0, stored1, stored2, dropped] every output w, x, y, z takes
+                const auto sources = torch::tensor({3, 0, 1, 2,
+                                                    0, 3, 1, 2,
+                                                    0, 1, 3, 2,
+                                                    0, 1, 2, 3},
+                                                   torch::kInt64)
+                                         .reshape({4, 4})
+                                         .to(torch::kCUDA);
+                rotations = torch::cat({stored, dropped}, 1).gather(1, sources.index_select(0, largest.to(torch::kInt64)));
+                rotations = rotations / rotations.norm(2, 1, true).clamp_min(1e-12f);
+            }
 
-                    // Look up colors from codebook
-                    sh0_acc[i][0][0] = meta.sh0_codebook[idx0];
-                    sh0_acc[i][0][1] = meta.sh0_codebook[idx1];
-                    sh0_acc[i][0][2] = meta.sh0_codebook[idx2];
+            // 3. Decode scales (codebook already in log space)
+            auto scales_img = splat_texels("scales.webp");
+            if (!scales_img) {
+                return std::unexpected("Missing scales texture");
+            }
+            auto scales = lookup(meta.scales_codebook, scales_img->narrow(1, 0, 3).contiguous(), "Scale");
+            if (!scales) {
+                return std::unexpected(scales.error());
+            }
 
-                    // Decode opacity (inverse sigmoid)
-                    float opacity_norm = sh0_img[ti + 3] / 255.0f;
-                    // Clamp with a safer epsilon to prevent infinity
-                    opacity_norm = std::clamp(opacity_norm, 1e-5f, 1.0f - 1e-5f);
-                    opacity_acc[i][0] = std::log(opacity_norm / (1.0f - opacity_norm));
-                }
+            // 4. Decode colors and opacity (inverse sigmoid)
+            auto sh0_img = splat_texels("sh0.webp");
+            if (!sh0_img) {
+                return std::unexpected("Missing color texture");
             }
+            auto colors = lookup(meta.sh0_codebook, sh0_img->narrow(1, 0, 3).contiguous(), "Color");
+            if (!colors) {
+                return std::unexpected(colors.error());
+            }
+            torch::Tensor sh0 = colors->reshape({num_splats, 1, 3});
+            // Clamp with a safer epsilon to prevent infinity
+            const auto opacity_norm = torch::clamp(sh0_img->narrow(1, 3, 1).to(torch::kFloat32) / 255.0f, 1e-5f, 1.0f - 1e-5f);
+            torch::Tensor opacity = torch::log(opacity_norm / (1.0f - opacity_norm));
 
             // 5. Decode spherical harmonics if present
             torch::Tensor shN;
-            if (meta.shN.has_value()) {
+            if (meta.shN.has_value() && images.contains("shN_centroids.webp") && images.contains("shN_labels.webp")) {
                 const auto& sh_meta = meta.shN.value();
 
-                auto it_centroids = images.find("shN_centroids.webp");
-                auto it_labels = images.find("shN_labels.webp");
-
-                if (it_centroids != images.end() && it_labels != images.end()) {
-                    const auto& centroids_img = it_centroids->second;
-                    const auto& labels_img = it_labels->second;
-
-                    // Determine SH configuration
-                    int sh_degree = sh_meta.bands > 0 ? sh_meta.bands : (sh_meta.coeffs == 3 ? 1 : sh_meta.coeffs == 8 ? 2
-                                                                                               : sh_meta.coeffs == 15  ? 3
-                                                                                                                       : 0);
-
-                    int num_coeffs = SH_COEFFS[sh_degree];
-                    int palette_size = sh_meta.palette_size > 0 ? sh_meta.palette_size : centroids_img.size() / (64 * num_coeffs * 4);
-
-                    LOG_DEBUG("Decoding SH: degree={}, coeffs={}, palette_size={}",
-                              sh_degree, num_coeffs, palette_size);
-
-                    // Create SH tensor
-                    shN = torch::zeros({num_splats, num_coeffs, 3}, torch::kFloat32);
-                    auto shN_acc = shN.accessor<float, 3>();
-
-                    // Decode centroids from texture
-                    std::vector<std::vector<float>> centroids(palette_size);
-                    for (int i = 0; i < palette_size; ++i) {
-                        centroids[i].resize(num_coeffs * 3);
-
-                        for (int j = 0; j < num_coeffs; ++j) {
-                            int pixel_idx = i * num_coeffs + j;
-
-                            // Decode from codebook
-                            for (int c = 0; c < 3; ++c) {
-                                uint8_t idx = centroids_img[pixel_idx * 4 + c];
-
-                                // Validate index
-                                if (idx >= sh_meta.codebook.size()) {
-                                    LOG_ERROR("SH codebook index out of bounds: {} (codebook size: {})",
-                                              idx, sh_meta.codebook.size());
-                                    return std::unexpected("Invalid SH codebook index");
-                                }
+                // Determine SH configuration
+                int sh_degree = sh_meta.bands > 0 ? sh_meta.bands : (sh_meta.coeffs == 3 ? 1 : sh_meta.coeffs == 8 ? 2
+                                                                                           : sh_meta.coeffs == 15  ? 3
+                                                                                                                   : 0);
+
+                const int num_coeffs = SH_COEFFS[sh_degree];
+                const auto centroid_pixels = images.at("shN_centroids.webp").reshape({-1, 4});
+                int palette_size = sh_meta.palette_size > 0 ? sh_meta.palette_size
+                                                            : static_cast<int>(centroid_pixels.size(0) / (64 * num_coeffs));
+                if (num_coeffs > 0 && static_cast<int64_t>(palette_size) * num_coeffs > centroid_pixels.size(0)) {
+                    return std::unexpected("SH centroid texture is smaller than the palette");
+                }
 
-                                // Band-major ordering
-                                int coeff_idx = j + c * num_coeffs;
-                                centroids[i][coeff_idx] = sh_meta.codebook[idx];
-                            }
-                        }
+                LOG_DEBUG("Decoding SH: degree={}, coeffs={}, palette_size={}",
+                          sh_degree, num_coeffs, palette_size);
+
+                if (num_coeffs > 0 && palette_size > 0) {
+                    // Pixel i * coeffs + j holds coefficient j of palette entry i in RGB
+                    const auto centroid_labels = centroid_pixels.narrow(0, 0, static_cast<int64_t>(palette_size) * num_coeffs)
+                                                     .narrow(1, 0, 3)
+                                                     .to(torch::kCUDA)
+                                                     .to(torch::kInt32)
+                                                     .contiguous();
+                    auto palette = lookup(sh_meta.codebook, centroid_labels, "SH");
+                    if (!palette) {
+                        return std::unexpected(palette.error());
                     }
+                    // Trailing zero entry for labels past the palette
+                    const auto palette_padded = torch::cat({palette->reshape({palette_size, num_coeffs, 3}),
+                                                            torch::zeros({1, num_coeffs, 3}, float_options)});
 
-                    // Apply labels
-                    for (int i = 0; i < num_splats; ++i) {
-                        int ti = identity_layout(i, width) * 4;
-
-                        // Reconstruct label from 16-bit value
-                        int label = labels_img[ti + 0] | (labels_img[ti + 1] << 8);
-
-                        if (label < palette_size) {
-                            const auto& centroid = centroids[label];
-
-                            // Unpack in band-major order
-                            for (int c = 0; c < 3; ++c) {
-                                for (int j = 0; j < num_coeffs; ++j) {
-                                    shN_acc[i][j][c] = centroid[j + c * num_coeffs];
-                                }
-                            }
-                        }
+                    auto labels_img = splat_texels("shN_labels.webp");
+                    if (!labels_img) {
+                        return std::unexpected(labels_img.error());
                     }
+                    const auto labels = (labels_img->select(1, 0) + labels_img->select(1, 1) * 256).to(torch::kInt64);
+                    shN = palette_padded.index_select(0, labels.clamp_max(palette_size));
                 }
             }
 
-            // Move tensors to CUDA
-            means = means.to(torch::kCUDA);
-            scales = scales.to(torch::kCUDA);
-            rotations = rotations.to(torch::kCUDA);
-            sh0 = sh0.to(torch::kCUDA);
-            opacity = opacity.to(torch::kCUDA);
-            if (shN.defined()) {
-                shN = shN.to(torch::kCUDA);
-            } else {
-                shN = torch::zeros({num_splats, 0, 3}, torch::kFloat32).to(torch::kCUDA);
+            if (!shN.defined()) {
+                shN = torch::zeros({num_splats, 0, 3}, float_options);
             }
 
             // Create SplatData
@@ -484,7 +342,7 @@ namespace gs::loader {
                 means,
                 sh0,
                 shN,
-                scales,
+                *scales,
                 rotations,
                 opacity,
                 1.0f // scene_scale
@@ -508,7 +366,7 @@ namespace gs::loader {
 
             struct archive_entry* entry;
             std::string metadata_json;
-            std::unordered_map<std::string, std::vector<uint8_t>> images;
+            std::vector<std::pair<std::string, std::vector<uint8_t>>> webp_files;
 
             // Read all files from archive
             while (archive_read_next_header(a, &entry) == ARCHIVE_OK) {
@@ -528,14 +386,7 @@ namespace gs::loader {
                 if (filename == "meta.json") {
                     metadata_json = std::string(data.begin(), data.end());
                 } else if (filename.ends_with(".webp")) {
-                    // Decode WebP
-                    int width, height;
-                    auto decoded = decode_webp(data.data(), data.size(), width, height);
-                    if (!decoded) {
-                        archive_read_free(a);
-                        return std::unexpected(decoded.error());
-                    }
-                    images[filename] = std::move(decoded.value());
+                    webp_files.emplace_back(filename, std::move(data));
                 }
             }
 
@@ -551,8 +402,13 @@ namespace gs::loader {
                 return std::unexpected(meta_result.error());
             }
 
+            auto images = decode_images(std::move(webp_files));
+            if (!images) {
+                return std::unexpected(images.error());
+            }
+
             // Reconstruct SplatData
-            return reconstruct_splat_data(meta_result.value(), images);
+            return reconstruct_splat_data(meta_result.value(), *images);
         }
 
         std::expected<SplatData, std::string> read_sog_directory(
@@ -580,10 +436,9 @@ namespace gs::loader {
             }
 
             auto& meta = meta_result.value();
-            std::unordered_map<std::string, std::vector<uint8_t>> images;
 
-            // Helper to read and decode WebP files
-            auto read_webp = [&](const std::string& filename) -> bool {
+            // Helper to read WebP files, decoding happens afterwards for all of them at once
+            auto read_file = [&](const std::string& filename) -> std::optional<std::vector<uint8_t>> {
                 auto file_path = path / filename;
 
                 // Also check with .webp extension if not present
@@ -593,14 +448,13 @@ namespace gs::loader {
 
                 if (!std::filesystem::exists(file_path)) {
                     LOG_ERROR("Missing file: {}", file_path.string());
-                    return false;
+                    return std::nullopt;
                 }
 
-                // Read file
                 std::ifstream file(file_path, std::ios::binary);
                 if (!file) {
                     LOG_ERROR("Failed to open: {}", file_path.string());
-                    return false;
+                    return std::nullopt;
                 }
 
                 file.seekg(0, std::ios::end);
@@ -609,50 +463,48 @@ namespace gs::loader {
 
                 std::vector<uint8_t> data(size);
                 file.read(reinterpret_cast<char*>(data.data()), size);
-
-                // Decode WebP
-                int width, height;
-                auto decoded = decode_webp(data.data(), data.size(), width, height);
-                if (!decoded) {
-                    LOG_ERROR("Failed to decode {}: {}", filename, decoded.error());
-                    return false;
-                }
-
-                images[filename] = std::move(decoded.value());
-                return true;
+                return data;
             };
 
             // Read all required files
-            for (const auto& file : meta.means_files) {
-                if (!read_webp(file))
-                    return std::unexpected("Failed to read " + file);
-            }
-            for (const auto& file : meta.scales_files) {
-                if (!read_webp(file))
-                    return std::unexpected("Failed to read " + file);
-            }
-            for (const auto& file : meta.quats_files) {
-                if (!read_webp(file))
-                    return std::unexpected("Failed to read " + file);
+            std::vector<std::pair<std::string, std::vector<uint8_t>>> webp_files;
+            for (const auto* files : {&meta.means_files, &meta.scales_files, &meta.quats_files, &meta.sh0_files}) {
+                for (const auto& file : *files) {
+                    auto data = read_file(file);
+                    if (!data)
+                        return std::unexpected("Failed to read " + file);
+                    webp_files.emplace_back(file, std::move(*data));
+                }
             }
-            for (const auto& file : meta.sh0_files) {
-                if (!read_webp(file))
-                    return std::unexpected("Failed to read " + file);
+
+            auto images = decode_images(std::move(webp_files));
+            if (!images) {
+                return std::unexpected(images.error());
             }
 
             // Read optional SH files
             if (meta.shN.has_value()) {
+                std::vector<std::pair<std::string, std::vector<uint8_t>>> sh_files;
                 for (const auto& file : meta.shN->files) {
-                    if (!read_webp(file)) {
-                        LOG_WARN("Failed to read SH file {}, continuing without SH", file);
-                        meta.shN.reset();
+                    auto data = read_file(file);
+                    if (!data) {
                         break;
                     }
+                    sh_files.emplace_back(file, std::move(*data));
+                }
+                auto sh_images = sh_files.size() == meta.shN->files.size()
+                                     ? decode_images(std::move(sh_files))
+                                     : std::expected<SogImages, std::string>(std::unexpected("missing file"));
+                if (sh_images) {
+                    images->merge(*sh_images);
+                } else {
+                    LOG_WARN("Failed to read SH files ({}), continuing without SH", sh_images.error());
+                    meta.shN.reset();
                 }
             }
 
             // Reconstruct SplatData
-            return reconstruct_splat_data(meta, images);
+            return reconstruct_splat_data(meta, *images);
         }
 
     } // anonymous namespace
@@ -0,0 +1,138 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "splat_lod.hpp"
+#include "core/logger.hpp"
+#include <array>
+#include <cstring>
+#include <format>
+#include <vector>
+
+namespace gs::loader {
+
+    namespace {
+        // Widths in floats of the block arrays, in file order: means, sh0, shN, scaling, rotation, opacity
+        std::array<int64_t, 6> attribute_widths(const uint32_t shN_coeffs) {
+            return {3, 3, 3 * static_cast<int64_t>(shN_coeffs), 3, 4, 1};
+        }
+    } // namespace
+
+    std::expected<std::unique_ptr<SplatLodFile>, std::string> SplatLodFile::open(const std::filesystem::path& path) {
+        auto lod = std::unique_ptr<SplatLodFile>(new SplatLodFile());
+        if (!lod->file_.map(path)) {
+            return std::unexpected(std::format("Failed to map LOD splat file: {}", path.string()));
+        }
+#ifndef _WIN32
+        // Blocks are read in camera order, not front to back
+        madvise(lod->file_.data, lod->file_.size, MADV_RANDOM);
+#endif
+
+        const auto bytes = lod->file_.as_span();
+        if (bytes.size() < sizeof(core::SplatLodHeader)) {
+            return std::unexpected("LOD splat file is too small for its header");
+        }
+        lod->header_ = reinterpret_cast<const core::SplatLodHeader*>(bytes.data());
+        const auto& header = *lod->header_;
+        if (std::memcmp(header.magic, core::SPLAT_LOD_MAGIC, sizeof(header.magic)) != 0) {
+            return std::unexpected("Not a LOD splat file");
+        }
+        if (header.version != core::SPLAT_LOD_VERSION) {
+            return std::unexpected(std::format("Unsupported LOD splat file version {}", header.version));
+        }
+        if (header.num_chunks == 0 || header.num_levels == 0 || header.shN_coeffs > 15) {
+            return std::unexpected("LOD splat file header is corrupt");
+        }
+
+        const uint64_t table_entries = static_cast<uint64_t>(header.num_chunks) * header.num_levels;
+        if (header.table_offset > bytes.size() ||
+            table_entries > (bytes.size() - header.table_offset) / sizeof(core::SplatLodBlock)) {
+            return std::unexpected("LOD splat file is truncated in its block table");
+        }
+        lod->table_ = {reinterpret_cast<const core::SplatLodBlock*>(bytes.data() + header.table_offset),
+                       static_cast<size_t>(table_entries)};
+
+        const uint64_t block_stride = core::splat_lod_floats_per_gaussian(header.shN_coeffs) * sizeof(float);
+        for (const auto& block : lod->table_) {
+            if (block.offset > bytes.size() || block.count > (bytes.size() - block.offset) / block_stride) {
+                return std::unexpected(std::format("LOD block of chunk {} level {} lies outside the file",
+                                                   block.chunk, block.level));
+            }
+        }
+
+        LOG_DEBUG("Opened LOD splat file {}: {} gaussians, {} chunks x {} levels", path.string(),
+                  header.num_gaussians, header.num_chunks, header.num_levels);
+        return lod;
+    }
+
+    void SplatLodFile::prefetch(const std::span<const BlockRef> blocks) const {
+#ifndef _WIN32
+        const uint64_t block_stride = core::splat_lod_floats_per_gaussian(header_->shN_coeffs) * sizeof(float);
+        for (const auto& [chunk, level] : blocks) {
+            const auto& entry = block(chunk, level);
+            // offset is page-aligned, as madvise requires
+            madvise(static_cast<char*>(file_.data) + entry.offset, entry.count * block_stride, MADV_WILLNEED);
+        }
+#else
+        (void)blocks;
+#endif
+    }
+
+    SplatData SplatLodFile::load(const std::span<const BlockRef> blocks, const torch::Device& device) const {
+        const auto widths = attribute_widths(header_->shN_coeffs);
+        int64_t total = 0;
+        for (const auto& [chunk, level] : blocks) {
+            total += static_cast<int64_t>(block(chunk, level).count);
+        }
+
+        // Gathered into pinned staging memory, then one copy per attribute
+        const auto pinned = torch::TensorOptions().dtype(torch::kFloat32).pinned_memory(device.is_cuda());
+        std::array<torch::Tensor, 6> staging;
+        for (size_t a = 0; a < widths.size(); ++a) {
+            staging[a] = torch::empty({total, widths[a]}, pinned);
+        }
+
+        int64_t row = 0;
+        for (const auto& [chunk, level] : blocks) {
+            const auto& entry = block(chunk, level);
+            const auto count = static_cast<int64_t>(entry.count);
+            const char* source = static_cast<const char*>(file_.data) + entry.offset;
+            for (size_t a = 0; a < widths.size(); ++a) {
+                const size_t bytes = static_cast<size_t>(count * widths[a]) * sizeof(float);
+                if (bytes > 0) {
+                    std::memcpy(staging[a].data_ptr<float>() + row * widths[a], source, bytes);
+                }
+                source += bytes;
+            }
+            row += count;
+        }
+
+        const auto upload = [&](const size_t a) { return staging[a].to(device, /*non_blocking=*/true); };
+        return SplatData(static_cast<int>(header_->sh_degree),
+                         upload(0),
+                         upload(1).view({total, 1, 3}),
+                         upload(2).view({total, static_cast<int64_t>(header_->shN_coeffs), 3}),
+                         upload(3),
+                         upload(4),
+                         upload(5),
+                         header_->scene_scale);
+    }
+
+    std::expected<SplatData, std::string> load_splat_lod(const std::filesystem::path& filepath) {
+        try {
+            auto lod = SplatLodFile::open(filepath);
+            if (!lod) {
+                return std::unexpected(lod.error());
+            }
+            std::vector<SplatLodFile::BlockRef> blocks;
+            blocks.reserve((*lod)->num_chunks());
+            for (uint32_t chunk = 0; chunk < (*lod)->num_chunks(); ++chunk) {
+                blocks.push_back({chunk, 0});
+            }
+            return (*lod)->load(blocks, torch::kCUDA);
+        } catch (const std::exception& e) {
+            return std::unexpected(std::format("Failed to load LOD splat file: {}", e.what()));
+        }
+    }
+
+} // namespace gs::loader
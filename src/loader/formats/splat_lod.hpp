@@ -0,0 +1,54 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/splat_data.hpp"
+#include "core/splat_lod.hpp"
+#include "mmapped_file.hpp"
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace gs::loader {
+
+    // A mapped .lfslod file. Opening only validates the header and block table, block data is
+    // paged in when a block is loaded, so a viewer can keep a file far larger than RAM open.
+    class SplatLodFile {
+    public:
+        struct BlockRef {
+            uint32_t chunk;
+            uint32_t level;
+        };
+
+        static std::expected<std::unique_ptr<SplatLodFile>, std::string> open(const std::filesystem::path& path);
+
+        const core::SplatLodHeader& header() const { return *header_; }
+        uint32_t num_chunks() const { return header_->num_chunks; }
+        uint32_t num_levels() const { return header_->num_levels; }
+        const core::SplatLodBlock& block(uint32_t chunk, uint32_t level) const {
+            return table_[static_cast<size_t>(chunk) * header_->num_levels + level];
+        }
+
+        // Hints the OS to read the blocks ahead of the load that needs them
+        void prefetch(std::span<const BlockRef> blocks) const;
+
+        // Concatenates the blocks, in the given order, into one model on device
+        SplatData load(std::span<const BlockRef> blocks, const torch::Device& device) const;
+
+    private:
+        SplatLodFile() = default;
+
+        MMappedFile file_;
+        const core::SplatLodHeader* header_ = nullptr;
+        std::span<const core::SplatLodBlock> table_;
+    };
+
+    // Every chunk at level 0, the full-resolution model
+    std::expected<SplatData, std::string> load_splat_lod(const std::filesystem::path& filepath);
+
+} // namespace gs::loader
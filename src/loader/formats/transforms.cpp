@@ -12,7 +12,13 @@
 #include <fstream>
 #include <nlohmann/json.hpp>
 #include <numbers>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <tbb/parallel_for.h>
 #include <torch/torch.h>
+#include <unordered_map>
+#include <vector>
 
 namespace gs::loader {
 
@@ -57,8 +63,8 @@ namespace gs::loader {
         return rotMat;
     }
 
-    std::filesystem::path GetTransformImagePath(const std::filesystem::path& dir_path, const nlohmann::json& frame) {
-        auto image_path = dir_path / frame["file_path"];
+    std::filesystem::path GetTransformImagePath(const std::filesystem::path& dir_path, const std::string& file_path) {
+        auto image_path = dir_path / file_path;
         auto image_path_png = std::filesystem::path(image_path.string() + ".png");
         if (std::filesystem::exists(image_path_png)) {
             // blender data set has not extension, must assumes png
@@ -68,6 +74,147 @@ namespace gs::loader {
         return image_path;
     }
 
+    namespace {
+
+        // SAX pass over a transforms file. Top-level numbers are kept by key, every frame appends
+        // its file path and 16 matrix values to flat arrays, anything else is skipped unparsed.
+        class TransformsSax : public nlohmann::json_sax<nlohmann::json> {
+        public:
+            struct Frame {
+                std::string file_path;
+                bool has_file_path = false;
+                bool has_matrix = false;
+                bool matrix_ok = false;
+            };
+
+            std::unordered_map<std::string, double> numbers;
+            std::vector<Frame> frames;
+            std::vector<float> poses; // Row-major 4x4 per frame, zeros for a bad matrix
+
+            std::optional<double> number(const std::string& key) const {
+                const auto it = numbers.find(key);
+                return it != numbers.end() ? std::optional(it->second) : std::nullopt;
+            }
+
+            bool null() override { return value(); }
+            bool boolean(bool) override { return value(); }
+            bool number_integer(number_integer_t v) override { return value(static_cast<double>(v)); }
+            bool number_unsigned(number_unsigned_t v) override { return value(static_cast<double>(v)); }
+            bool number_float(number_float_t v, const string_t&) override { return value(static_cast<double>(v)); }
+            bool binary(binary_t&) override { return value(); }
+
+            bool string(string_t& v) override {
+                if (in_frame_ && depth_ == 3 && frame_key_ == "file_path") {
+                    frames.back().file_path = std::move(v);
+                    frames.back().has_file_path = true;
+                    return true;
+                }
+                return value();
+            }
+
+            bool key(string_t& k) override {
+                if (depth_ == 1) {
+                    top_key_ = std::move(k);
+                } else if (in_frame_ && depth_ == 3) {
+                    frame_key_ = std::move(k);
+                }
+                return true;
+            }
+
+            bool start_object(std::size_t) override {
+                ++depth_;
+                if (in_frames_ && depth_ == 3) {
+                    in_frame_ = true;
+                    frame_key_.clear();
+                    frames.emplace_back();
+                } else if (in_matrix_) {
+                    matrix_bad_ = true;
+                }
+                return true;
+            }
+
+            bool end_object() override {
+                if (in_frame_ && depth_ == 3) {
+                    in_frame_ = false;
+                    if (!frames.back().has_matrix) {
+                        poses.resize(poses.size() + 16, 0.0f);
+                    }
+                }
+                --depth_;
+                return true;
+            }
+
+            bool start_array(std::size_t) override {
+                ++depth_;
+                if (depth_ == 2 && top_key_ == "frames") {
+                    in_frames_ = true;
+                } else if (in_frame_ && depth_ == 4 && frame_key_ == "transform_matrix") {
+                    in_matrix_ = true;
+                    matrix_bad_ = false;
+                    matrix_rows_ = 0;
+                    matrix_.clear();
+                } else if (in_matrix_ && depth_ == 5) {
+                    row_cols_ = 0;
+                } else if (in_matrix_) {
+                    matrix_bad_ = true;
+                }
+                return true;
+            }
+
+            bool end_array() override {
+                if (in_matrix_ && depth_ == 5) {
+                    matrix_bad_ |= row_cols_ != 4;
+                    ++matrix_rows_;
+                } else if (in_matrix_ && depth_ == 4) {
+                    in_matrix_ = false;
+                    auto& frame = frames.back();
+                    frame.has_matrix = true;
+                    frame.matrix_ok = !matrix_bad_ && matrix_rows_ == 4 && matrix_.size() == 16;
+                    if (frame.matrix_ok) {
+                        poses.insert(poses.end(), matrix_.begin(), matrix_.end());
+                    } else {
+                        poses.resize(poses.size() + 16, 0.0f);
+                    }
+                } else if (in_frames_ && depth_ == 2) {
+                    in_frames_ = false;
+                }
+                --depth_;
+                return true;
+            }
+
+            bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& ex) override {
+                throw std::runtime_error(ex.what());
+            }
+
+        private:
+            bool value(std::optional<double> v = std::nullopt) {
+                if (in_matrix_) {
+                    if (depth_ == 5 && v && matrix_.size() < 16) {
+                        matrix_.push_back(static_cast<float>(*v));
+                        ++row_cols_;
+                    } else {
+                        matrix_bad_ = true;
+                    }
+                } else if (depth_ == 1 && v) {
+                    numbers[top_key_] = *v;
+                }
+                return true;
+            }
+
+            int depth_ = 0;
+            std::string top_key_;
+            std::string frame_key_;
+            bool in_frames_ = false;
+            bool in_frame_ = false;
+            bool in_matrix_ = false;
+            bool matrix_bad_ = false;
+            int matrix_rows_ = 0;
+            int row_cols_ = 0;
+            std::vector<float> matrix_; // Values of the matrix being parsed
+        };
+
+    } // namespace
+
     std::tuple<std::vector<CameraData>, torch::Tensor> read_transforms_cameras_and_images(
         const std::filesystem::path& transPath) {
 
@@ -91,19 +238,57 @@ namespace gs::loader {
         }
 
         LOG_DEBUG("Reading transforms from: {}", transformsFile.string());
-        std::ifstream trans_file{transformsFile.string()};
+        std::string contents;
+        {
+            std::ifstream trans_file(transformsFile, std::ios::binary);
+            std::ostringstream buffer;
+            buffer << trans_file.rdbuf();
+            contents = std::move(buffer).str();
+        }
 
         std::filesystem::path dir_path = transformsFile.parent_path();
 
-        // should throw if parse fails
-        nlohmann::json transforms = nlohmann::json::parse(trans_file, nullptr, true, true);
+        // should throw if parse fails, comments are allowed
+        TransformsSax transforms;
+        nlohmann::json::sax_parse(contents, &transforms, nlohmann::json::input_format_t::json, true, true);
+        contents = {};
+
+        const auto& frames = transforms.frames;
+        for (size_t frameInd = 0; frameInd < frames.size(); ++frameInd) {
+            if (!frames[frameInd].has_matrix) {
+                LOG_ERROR("Frame {} missing transform_matrix", frameInd);
+                throw std::runtime_error("expected all frames to contain transform_matrix");
+            }
+            if (!frames[frameInd].matrix_ok) {
+                LOG_ERROR("Frame {} has invalid transform_matrix dimensions", frameInd);
+                throw std::runtime_error("transform_matrix has the wrong dimensions");
+            }
+            if (!frames[frameInd].has_file_path) {
+                LOG_ERROR("Frame {} missing file_path", frameInd);
+                throw std::runtime_error("expected all frames to contain file_path");
+            }
+        }
+
+        // The PNG fallback stats every frame, resolved in parallel
+        std::vector<std::filesystem::path> image_paths(frames.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, frames.size()),
+                          [&](const tbb::blocked_range<size_t>& range) {
+                              for (size_t i = range.begin(); i != range.end(); ++i) {
+                                  image_paths[i] = GetTransformImagePath(dir_path, frames[i].file_path);
+                              }
+                          });
+
         int w = -1, h = -1;
-        if (!transforms.contains("w") or !transforms.contains("h")) {
+        const auto json_w = transforms.number("w");
+        const auto json_h = transforms.number("h");
+        if (!json_w || !json_h) {
 
             try {
                 LOG_DEBUG("Width/height not in transforms.json, reading from first image");
-                auto first_frame_img_path = GetTransformImagePath(dir_path, transforms["frames"][0]);
-                auto result = get_image_info(first_frame_img_path);
+                if (image_paths.empty()) {
+                    throw std::runtime_error("no frames to read the dimensions from");
+                }
+                auto result = get_image_info(image_paths[0]);
 
                 w = std::get<0>(result);
                 h = std::get<1>(result);
@@ -119,21 +304,21 @@ namespace gs::loader {
                 throw std::runtime_error(error_msg);
             }
         } else {
-            w = int(transforms["w"]);
-            h = int(transforms["h"]);
+            w = static_cast<int>(*json_w);
+            h = static_cast<int>(*json_h);
         }
 
         float fl_x = -1, fl_y = -1;
-        if (transforms.contains("fl_x")) {
-            fl_x = float(transforms["fl_x"]);
-        } else if (transforms.contains("camera_angle_x")) {
-            fl_x = fov_rad_to_focal_length(w, float(transforms["camera_angle_x"]));
+        if (const auto v = transforms.number("fl_x")) {
+            fl_x = static_cast<float>(*v);
+        } else if (const auto angle = transforms.number("camera_angle_x")) {
+            fl_x = fov_rad_to_focal_length(w, static_cast<float>(*angle));
         }
 
-        if (transforms.contains("fl_y")) {
-            fl_y = float(transforms["fl_y"]);
-        } else if (transforms.contains("camera_angle_y")) {
-            fl_y = fov_rad_to_focal_length(h, float(transforms["camera_angle_y"]));
+        if (const auto v = transforms.number("fl_y")) {
+            fl_y = static_cast<float>(*v);
+        } else if (const auto angle = transforms.number("camera_angle_y")) {
+            fl_y = fov_rad_to_focal_length(h, static_cast<float>(*angle));
         } else { // we should be  here in this scope only for blender - if w!=h then we must throw exception
             if (w != h) {
                 LOG_ERROR("No camera_angle_y but w!=h: {}!={}", w, h);
@@ -142,95 +327,58 @@ namespace gs::loader {
             fl_y = fl_x;
         }
 
-        float cx = -1, cy = -1;
-        if (transforms.contains("cx")) {
-            cx = float(transforms["cx"]);
-        } else {
-            cx = 0.5 * w;
-        }
-
-        if (transforms.contains("cy")) {
-            cy = float(transforms["cy"]);
-        } else {
-            cy = 0.5 * h;
-        }
+        const float cx = static_cast<float>(transforms.number("cx").value_or(0.5 * w));
+        const float cy = static_cast<float>(transforms.number("cy").value_or(0.5 * h));
 
-        float k1 = 0;
-        float k2 = 0;
-        float p1 = 0;
-        float p2 = 0;
-        if (transforms.contains("k1")) {
-            k1 = float(transforms["k1"]);
-        }
-        if (transforms.contains("k2")) {
-            k2 = float(transforms["k2"]);
-        }
-        if (transforms.contains("p1")) {
-            p1 = float(transforms["p1"]);
-        }
-        if (transforms.contains("p2")) {
-            p2 = float(transforms["p2"]);
-        }
+        const float k1 = static_cast<float>(transforms.number("k1").value_or(0.0));
+        const float k2 = static_cast<float>(transforms.number("k2").value_or(0.0));
+        const float p1 = static_cast<float>(transforms.number("p1").value_or(0.0));
+        const float p2 = static_cast<float>(transforms.number("p2").value_or(0.0));
         if (k1 > 0 || k2 > 0 || p1 > 0 || p2 > 0) {
             LOG_ERROR("Distortion parameters not supported: k1={}, k2={}, p1={}, p2={}", k1, k2, p1, p2);
             throw std::runtime_error(std::format("GS don't support distortion for now: k1={}, k2={}, p1={}, p2={}", k1, k2, p1, p2));
         }
 
         std::vector<CameraData> camerasdata;
-        if (transforms.contains("frames") && transforms["frames"].is_array()) {
-            uint64_t counter = 0;
-            LOG_DEBUG("Processing {} frames", transforms["frames"].size());
+        if (!frames.empty()) {
+            const int64_t num_frames = static_cast<int64_t>(frames.size());
+            LOG_DEBUG("Processing {} frames", num_frames);
 
-            for (size_t frameInd = 0; frameInd < transforms["frames"].size(); ++frameInd) {
-                CameraData camdata;
-                auto& frame = transforms["frames"][frameInd];
-                if (!frame.contains("transform_matrix")) {
-                    LOG_ERROR("Frame {} missing transform_matrix", frameInd);
-                    throw std::runtime_error("expected all frames to contain transform_matrix");
-                }
-                if (!(frame["transform_matrix"].is_array() and frame["transform_matrix"].size() == 4)) {
-                    LOG_ERROR("Frame {} has invalid transform_matrix dimensions", frameInd);
-                    throw std::runtime_error("transform_matrix has the wrong dimensions");
-                }
+            // Create camera-to-world transform matrices, all frames in one batch
+            torch::Tensor c2w = torch::from_blob(transforms.poses.data(), {num_frames, 4, 4}, torch::kFloat32).clone();
 
-                // Create camera-to-world transform matrix
-                torch::Tensor c2w = torch::empty({4, 4}, torch::kFloat32);
+            // Change from OpenGL/Blender camera axes (Y up, Z back) to COLMAP (Y down, Z forward)
+            // c2w[:, :3, 1:3] *= -1
+            c2w.slice(1, 0, 3).slice(2, 1, 3) *= -1;
 
-                // Fill the c2w matrix from the JSON data
-                for (int i = 0; i < 4; ++i) {
-                    for (int j = 0; j < 4; ++j) {
-                        c2w[i][j] = float(frame["transform_matrix"][i][j]);
-                    }
-                }
-
-                // Change from OpenGL/Blender camera axes (Y up, Z back) to COLMAP (Y down, Z forward)
-                // c2w[:3, 1:3] *= -1
-                c2w.slice(0, 0, 3).slice(1, 1, 3) *= -1;
+            // Get the world-to-camera transform by computing inverse of c2w
+            torch::Tensor w2c = torch::inverse(c2w);
 
-                // Get the world-to-camera transform by computing inverse of c2w
-                torch::Tensor w2c = torch::inverse(c2w);
+            // fix so that the z direction will be the same (currently it is faceing downward)
+            torch::Tensor fixMat = createYRotationMatrix(M_PI);
+            w2c = torch::matmul(w2c, fixMat);
 
-                // fix so that the z direction will be the same (currently it is faceing downward)
-                torch::Tensor fixMat = createYRotationMatrix(M_PI);
-                w2c = torch::mm(w2c, fixMat);
+            // Extract rotation matrices R (transposed due to 'glm' in CUDA code)
+            // R = np.transpose(w2c[:, :3, :3])
+            const torch::Tensor R = w2c.slice(1, 0, 3).slice(2, 0, 3);
 
-                // Extract rotation matrix R (transposed due to 'glm' in CUDA code)
-                // R = np.transpose(w2c[:3,:3])
-                torch::Tensor R = w2c.slice(0, 0, 3).slice(1, 0, 3);
+            // Extract translation vectors T
+            // T = w2c[:, :3, 3]
+            const torch::Tensor T = w2c.slice(1, 0, 3).select(2, 3);
 
-                // Extract translation vector T
-                // T = w2c[:3, 3]
-                torch::Tensor T = w2c.slice(0, 0, 3).slice(1, 3, 4).squeeze(1);
+            camerasdata.reserve(frames.size());
+            for (int64_t frameInd = 0; frameInd < num_frames; ++frameInd) {
+                CameraData camdata;
 
-                camdata._image_path = GetTransformImagePath(dir_path, frame);
+                camdata._image_path = image_paths[frameInd];
 
                 camdata._image_name = std::filesystem::path(camdata._image_path).filename().string();
 
                 camdata._width = w;
                 camdata._height = h;
 
-                camdata._T = T;
-                camdata._R = R;
+                camdata._T = T[frameInd];
+                camdata._R = R[frameInd];
 
                 camdata._focal_x = fl_x;
                 camdata._focal_y = fl_y;
@@ -239,20 +387,18 @@ namespace gs::loader {
                 camdata._center_y = cy;
 
                 camdata._camera_model_type = gsplat::CameraModelType::PINHOLE;
-                camdata._camera_ID = counter++;
+                camdata._camera_ID = static_cast<uint64_t>(frameInd);
 
-                camerasdata.push_back(camdata);
-                LOG_TRACE("Processed frame {}: {}", frameInd, camdata._image_name);
+                camerasdata.push_back(std::move(camdata));
+                LOG_TRACE("Processed frame {}: {}", frameInd, camerasdata.back()._image_name);
             }
         }
 
         auto center = torch::zeros({3}, torch::kFloat32);
 
         // Check for aabb_scale (used in some NeRF datasets for scene scaling)
-        float aabb_scale = 1.0f;
-        if (transforms.contains("aabb_scale")) {
-            aabb_scale = float(transforms["aabb_scale"]);
-            LOG_DEBUG("Found aabb_scale: {}", aabb_scale);
+        if (const auto aabb_scale = transforms.number("aabb_scale")) {
+            LOG_DEBUG("Found aabb_scale: {}", *aabb_scale);
         }
 
         LOG_INFO("Loaded {} cameras from transforms file", camerasdata.size());
@@ -260,6 +406,102 @@ namespace gs::loader {
         return {camerasdata, center};
     }
 
+    std::vector<std::string> validate_transforms_dataset(const std::filesystem::path& transforms_file) {
+        LOG_TIMER("Validate transforms file");
+        std::vector<std::string> problems;
+
+        std::string contents;
+        {
+            std::ifstream trans_file(transforms_file, std::ios::binary);
+            if (!trans_file) {
+                problems.push_back(std::format("Cannot open {}", transforms_file.string()));
+                return problems;
+            }
+            std::ostringstream buffer;
+            buffer << trans_file.rdbuf();
+            contents = std::move(buffer).str();
+        }
+
+        TransformsSax transforms;
+        try {
+            nlohmann::json::sax_parse(contents, &transforms, nlohmann::json::input_format_t::json, true, true);
+        } catch (const std::exception& e) {
+            problems.push_back(std::format("{} is not valid JSON: {}", transforms_file.string(), e.what()));
+            return problems;
+        }
+        contents = {};
+
+        const auto& frames = transforms.frames;
+        if (frames.empty()) {
+            problems.emplace_back("No frames");
+            return problems;
+        }
+
+        const std::filesystem::path dir_path = transforms_file.parent_path();
+        std::vector<size_t> image_frames;
+        image_frames.reserve(frames.size());
+        for (size_t i = 0; i < frames.size(); ++i) {
+            if (!frames[i].has_matrix) {
+                problems.push_back(std::format("Frame {} has no transform_matrix", i));
+            } else if (!frames[i].matrix_ok) {
+                problems.push_back(std::format("Frame {} has a transform_matrix that is not 4x4", i));
+            }
+            if (!frames[i].has_file_path) {
+                problems.push_back(std::format("Frame {} has no file_path", i));
+            } else {
+                image_frames.push_back(i);
+            }
+        }
+
+        // The PNG fallback stats every frame, resolved in parallel like the headers
+        std::vector<std::filesystem::path> image_paths(image_frames.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, image_frames.size()),
+                          [&](const tbb::blocked_range<size_t>& range) {
+                              for (size_t i = range.begin(); i != range.end(); ++i) {
+                                  image_paths[i] = GetTransformImagePath(dir_path, frames[image_frames[i]].file_path);
+                              }
+                          });
+        const auto headers = read_image_headers(image_paths);
+
+        // Every camera gets w and h, or the size of the first image without them
+        const auto json_w = transforms.number("w");
+        const auto json_h = transforms.number("h");
+        std::optional<std::pair<int, int>> size;
+        if (json_w && json_h) {
+            size.emplace(static_cast<int>(*json_w), static_cast<int>(*json_h));
+        }
+        for (size_t i = 0; i < headers.size(); ++i) {
+            const auto& header = headers[i];
+            if (!header.error.empty()) {
+                problems.push_back(std::format("Frame {}: {}", image_frames[i], header.error));
+                continue;
+            }
+            if (!size) {
+                size.emplace(header.width, header.height);
+            } else if (header.width != size->first || header.height != size->second) {
+                problems.push_back(std::format("Frame {}: {} is {}x{}, the cameras are {}x{}", image_frames[i],
+                                               image_paths[i].filename().string(), header.width, header.height,
+                                               size->first, size->second));
+            }
+        }
+
+        if (!transforms.number("fl_x") && !transforms.number("camera_angle_x")) {
+            problems.emplace_back("Neither fl_x nor camera_angle_x is given");
+        }
+        if (!transforms.number("fl_y") && !transforms.number("camera_angle_y") && size && size->first != size->second) {
+            problems.push_back(std::format("Neither fl_y nor camera_angle_y is given for non-square {}x{} images",
+                                           size->first, size->second));
+        }
+        for (const char* key : {"k1", "k2", "p1", "p2"}) {
+            if (transforms.number(key).value_or(0.0) > 0.0) {
+                problems.push_back(std::format("Distortion {} is not supported", key));
+            }
+        }
+
+        LOG_INFO("Validated {} frames, {} problems", frames.size(), problems.size());
+        return problems;
+    }
+
     PointCloud generate_random_point_cloud() {
         LOG_DEBUG("Generating random point cloud with {} points", DEFAULT_NUM_INIT_GAUSSIAN);
 
@@ -15,6 +15,11 @@ namespace gs::loader {
     std::tuple<std::vector<CameraData>, torch::Tensor> read_transforms_cameras_and_images(
         const std::filesystem::path& transPath);
 
+    // Checks a transforms file without building cameras or reading pixels: the JSON parses, every
+    // frame has a 4x4 transform_matrix and a file_path whose image exists, the intrinsics are
+    // usable, and every image header matches the one size all cameras get. One message per problem.
+    std::vector<std::string> validate_transforms_dataset(const std::filesystem::path& transforms_file);
+
     PointCloud generate_random_point_cloud();
 
     PointCloud load_simple_ply_point_cloud(const std::filesystem::path& filepath);
@@ -0,0 +1,175 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "formats/undistort.hpp"
+#include "core/image_io.hpp"
+#include "core/logger.hpp"
+#include <format>
+#include <functional>
+#include <torch/torch.h>
+#include <unordered_map>
+
+namespace gs::loader {
+
+    namespace {
+        namespace fs = std::filesystem;
+        namespace F = torch::nn::functional;
+
+        std::vector<float> coefficients(const torch::Tensor& tensor, size_t count) {
+            std::vector<float> values(count, 0.f);
+            if (tensor.defined() && tensor.numel() > 0) {
+                const auto host = tensor.to(torch::kCPU, torch::kFloat32).contiguous();
+                const auto n = std::min(count, static_cast<size_t>(host.numel()));
+                std::copy_n(host.data_ptr<float>(), n, values.begin());
+            }
+            return values;
+        }
+
+        bool needs_undistortion(const CameraData& cam) {
+            if (cam._camera_model_type != gsplat::CameraModelType::PINHOLE) {
+                return false;
+            }
+            auto any_nonzero = [](const torch::Tensor& t) {
+                return t.defined() && t.numel() > 0 && t.abs().max().item<float>() > 0.f;
+            };
+            return any_nonzero(cam._radial_distortion) || any_nonzero(cam._tangential_distortion);
+        }
+
+        // Cache folder of one calibration, a recalibrated camera never picks up stale images
+        std::string calibration_dir_name(const CameraData& cam) {
+            std::string key = std::format("{} {} {} {} {} {}", cam._width, cam._height,
+                                          cam._focal_x, cam._focal_y, cam._center_x, cam._center_y);
+            for (const float k : coefficients(cam._radial_distortion, 6)) {
+                key += std::format(" {}", k);
+            }
+            for (const float p : coefficients(cam._tangential_distortion, 2)) {
+                key += std::format(" {}", p);
+            }
+            return std::format("camera_{}_{:016x}", cam._camera_ID, std::hash<std::string>{}(key));
+        }
+
+        bool is_fresh(const fs::path& cached, const fs::path& source) {
+            std::error_code ec;
+            const auto cached_time = fs::last_write_time(cached, ec);
+            if (ec) {
+                return false;
+            }
+            const auto source_time = fs::last_write_time(source, ec);
+            return !ec && cached_time >= source_time;
+        }
+
+        // grid_sample coordinates of the distorted source pixel behind every ideal pixel center,
+        // [1, H, W, 2], and the mask of those that land inside the source image, [H, W]
+        std::pair<torch::Tensor, torch::Tensor> distortion_grid(const CameraData& cam, int width, int height) {
+            // Images decoded at a different size than the calibration keep the normalized model
+            const float fx = cam._focal_x * width / cam._width;
+            const float fy = cam._focal_y * height / cam._height;
+            const float cx = cam._center_x * width / cam._width;
+            const float cy = cam._center_y * height / cam._height;
+            const auto k = coefficients(cam._radial_distortion, 6);
+            const auto p = coefficients(cam._tangential_distortion, 2);
+
+            const auto options = torch::TensorOptions().dtype(torch::kFloat32);
+            const auto pixels = torch::meshgrid({torch::arange(height, options).add_(0.5f),
+                                                 torch::arange(width, options).add_(0.5f)},
+                                                "ij");
+            const auto x = (pixels[1] - cx) / fx;
+            const auto y = (pixels[0] - cy) / fy;
+
+            // OpenCV model, k4-k6 are the rational denominator of FULL_OPENCV
+            const auto r2 = x * x + y * y;
+            const auto radial = (1.f + r2 * (k[0] + r2 * (k[1] + r2 * k[2]))) /
+                                (1.f + r2 * (k[3] + r2 * (k[4] + r2 * k[5])));
+            const auto xy = x * y;
+            const auto xd = x * radial + 2.f * p[0] * xy + p[1] * (r2 + 2.f * x * x);
+            const auto yd = y * radial + p[0] * (r2 + 2.f * y * y) + 2.f * p[1] * xy;
+
+            // Pixel coordinates to [-1, 1], align_corners=false
+            const auto gx = (xd * fx + cx) * (2.f / width) - 1.f;
+            const auto gy = (yd * fy + cy) * (2.f / height) - 1.f;
+            // radial <= 0 is where the polynomial folds back, those pixels mirror the scene
+            const auto valid = (gx.abs() <= 1.f) & (gy.abs() <= 1.f) & (radial > 0.f);
+            return {torch::stack({gx, gy}, -1).unsqueeze(0), valid};
+        }
+
+        void undistort_image(const fs::path& source, const fs::path& target, const torch::Tensor& grid) {
+            auto [data, width, height, channels] = load_image(source, 1, 0);
+            const auto image = torch::from_blob(data, {height, width, channels}, torch::kUInt8)
+                                   .permute({2, 0, 1})
+                                   .unsqueeze(0)
+                                   .to(torch::kFloat32)
+                                   .div_(255.f);
+            free_image(data);
+
+            const auto resampled = F::grid_sample(
+                image, grid,
+                F::GridSampleFuncOptions().mode(torch::kBilinear).padding_mode(torch::kBorder).align_corners(false));
+
+            fs::create_directories(target.parent_path());
+            // save_image truncates to uint8, the half step rounds instead
+            save_image(target, resampled.squeeze(0).add_(0.5f / 255.f));
+        }
+    } // namespace
+
+    void undistort_pinhole_cameras(std::vector<CameraData>& cameras, const std::filesystem::path& cache_dir) {
+        torch::NoGradGuard no_grad;
+
+        // Grids by calibration and decoded size, shared by every image of a COLMAP camera
+        std::unordered_map<std::string, torch::Tensor> grids;
+        size_t undistorted = 0;
+        size_t reused = 0;
+
+        for (auto& cam : cameras) {
+            if (!needs_undistortion(cam)) {
+                continue;
+            }
+
+            const auto [width, height, channels] = get_image_info(cam._image_path);
+            const fs::path dir = cache_dir / calibration_dir_name(cam);
+            const fs::path mask_path = dir / std::format("valid_mask_{}x{}.png", width, height);
+            const fs::path image_path = (dir / "images" / cam._image_name).replace_extension(".png");
+
+            const std::string key = mask_path.string();
+            auto it = grids.find(key);
+            if (it == grids.end()) {
+                auto [grid, valid] = distortion_grid(cam, width, height);
+                if (!fs::exists(mask_path)) {
+                    fs::create_directories(dir);
+                    save_image(mask_path, valid.to(torch::kFloat32).unsqueeze(0));
+                }
+                LOG_DEBUG("Camera {} at {}x{}: {:.2f}% of the undistorted pixels have no source pixel",
+                          cam._camera_ID, width, height, 100.f * (1.f - valid.to(torch::kFloat32).mean().item<float>()));
+                it = grids.emplace(key, std::move(grid)).first;
+            }
+
+            if (is_fresh(image_path, cam._image_path)) {
+                ++reused;
+            } else {
+                undistort_image(cam._image_path, image_path, it->second);
+                ++undistorted;
+            }
+
+            // user masks are resampled like their image, loading thresholds them again
+            if (!cam._mask_path.empty()) {
+                const fs::path user_mask_path = (dir / "masks" / cam._image_name).replace_extension(".png");
+                if (!is_fresh(user_mask_path, cam._mask_path)) {
+                    undistort_image(cam._mask_path, user_mask_path, it->second);
+                }
+                cam._mask_path = user_mask_path;
+            }
+
+            cam._image_path = image_path;
+            cam._valid_mask_path = mask_path;
+            cam._camera_model = CAMERA_MODEL::PINHOLE;
+            cam._radial_distortion = torch::empty({0}, torch::kFloat32);
+            cam._tangential_distortion = torch::empty({0}, torch::kFloat32);
+        }
+
+        if (undistorted + reused > 0) {
+            LOG_INFO("Undistorted {} images into {} ({} reused from cache)", undistorted + reused,
+                     cache_dir.string(), reused);
+        }
+    }
+
+} // namespace gs::loader
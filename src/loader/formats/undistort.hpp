@@ -0,0 +1,21 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "formats/colmap.hpp"
+#include <filesystem>
+#include <vector>
+
+namespace gs::loader {
+
+    // Resamples the images of every distorted pinhole camera (SIMPLE_RADIAL, RADIAL, OPENCV,
+    // FULL_OPENCV) to an ideal pinhole camera with the same intrinsics and size, so they train on
+    // the fast rasterizer instead of GUT. Results go to cache_dir and are reused while they are
+    // newer than their source. Each camera's _image_path is redirected to the undistorted image,
+    // its distortion is cleared and _valid_mask_path names a mask of the pixels that have a source
+    // pixel. A user mask (_mask_path) is resampled alongside its image. Fisheye cameras are left untouched.
+    void undistort_pinhole_cameras(std::vector<CameraData>& cameras, const std::filesystem::path& cache_dir);
+
+} // namespace gs::loader
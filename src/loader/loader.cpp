@@ -31,6 +31,18 @@ namespace gs::loader {
                 return service_->load(path, options);
             }
 
+            std::future<std::expected<LoadResult, std::string>> loadAsync(
+                const std::filesystem::path& path,
+                const LoadOptions& options) override {
+
+                LOG_DEBUG("Queueing load from path: {}", path.string());
+                return service_->loadAsync(path, options);
+            }
+
+            void setCacheBudget(size_t device_bytes, size_t host_bytes) override {
+                service_->setCacheBudget(device_bytes, host_bytes);
+            }
+
             bool canLoad(const std::filesystem::path& path) const override {
                 // Check if any registered loader can handle this path
                 if (!safe_exists(path)) {
@@ -0,0 +1,96 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "loader/loader_queue.hpp"
+#include "core/logger.hpp"
+#include <algorithm>
+
+namespace gs::loader {
+
+    LoadingQueue::LoadingQueue(size_t num_workers) {
+        num_workers = std::max<size_t>(1, num_workers);
+        workers_.reserve(num_workers);
+        for (size_t i = 0; i < num_workers; ++i) {
+            workers_.emplace_back([this] { workerThread(); });
+        }
+        LOG_DEBUG("LoadingQueue started with {} workers", num_workers);
+    }
+
+    LoadingQueue::~LoadingQueue() {
+        cancelAll();
+        stop_ = true;
+        cv_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    std::future<void> LoadingQueue::enqueue(const std::filesystem::path& path,
+                                            std::function<void()> work) {
+        auto task = std::make_unique<Task>();
+        task->path = path;
+        task->work = std::move(work);
+        auto future = task->completion.get_future();
+        {
+            std::lock_guard lock(mutex_);
+            tasks_.push(std::move(task));
+        }
+        cv_.notify_one();
+        return future;
+    }
+
+    void LoadingQueue::cancelAll() {
+        std::queue<std::unique_ptr<Task>> cancelled;
+        {
+            std::lock_guard lock(mutex_);
+            std::swap(cancelled, tasks_);
+        }
+        if (!cancelled.empty()) {
+            LOG_DEBUG("Cancelled {} pending loads", cancelled.size());
+        }
+        while (!cancelled.empty()) {
+            cancelled.front()->completion.set_value();
+            cancelled.pop();
+        }
+        idle_cv_.notify_all();
+    }
+
+    void LoadingQueue::waitAll() {
+        std::unique_lock lock(mutex_);
+        idle_cv_.wait(lock, [this] { return tasks_.empty() && active_tasks_ == 0; });
+    }
+
+    void LoadingQueue::workerThread() {
+        while (true) {
+            std::unique_ptr<Task> task;
+            {
+                std::unique_lock lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+                if (stop_ && tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop();
+                ++active_tasks_;
+            }
+
+            try {
+                task->work();
+                task->completion.set_value();
+            } catch (...) {
+                LOG_ERROR("Loading task for {} failed", task->path.string());
+                task->completion.set_exception(std::current_exception());
+            }
+
+            {
+                std::lock_guard lock(mutex_);
+                --active_tasks_;
+            }
+            idle_cv_.notify_all();
+        }
+    }
+
+} // namespace gs::loader
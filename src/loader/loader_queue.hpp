@@ -10,9 +10,14 @@
 #include <functional>
 #include <future>
 #include <list>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
+#include <system_error>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace gs::loader {
 
@@ -44,7 +49,7 @@ namespace gs::loader {
                                   std::function<void()> work);
 
         /**
-         * @brief Cancel all pending tasks
+         * @brief Cancel all pending tasks, their futures complete without the work running
          */
         void cancelAll();
 
@@ -75,6 +80,7 @@ namespace gs::loader {
     private:
         mutable std::mutex mutex_;
         std::condition_variable cv_;
+        std::condition_variable idle_cv_;
         std::queue<std::unique_ptr<Task>> tasks_;
         std::vector<std::thread> workers_;
         std::atomic<bool> stop_{false};
@@ -82,57 +88,96 @@ namespace gs::loader {
     };
 
     // ============================================================================
-    // Loading Cache (optional, for future use)
+    // Loading Cache
     // ============================================================================
 
     /**
      * @brief Simple LRU cache for loaded data
+     *
+     * Entries are keyed on the path and its modification time, a file rewritten since it was
+     * cached misses. With max_bytes, entries are also evicted to keep their total cost within it.
+     * put and setMaxBytes return the evicted entries, a lower cache tier can take them in.
      */
     template <typename T>
     class LoadingCache {
     public:
-        explicit LoadingCache(size_t max_size = 10) : max_size_(max_size) {}
+        struct Item {
+            std::filesystem::path key;
+            std::shared_ptr<T> value;
+            std::filesystem::file_time_type mtime;
+            size_t bytes = 0;
+        };
+
+        explicit LoadingCache(size_t max_size = 10, size_t max_bytes = 0)
+            : max_size_(max_size),
+              max_bytes_(max_bytes) {}
+
+        std::vector<Item> put(const std::filesystem::path& key, std::shared_ptr<T> value, size_t bytes = 0) {
+            std::error_code ec;
+            const auto mtime = std::filesystem::last_write_time(key, ec);
+            if (ec) {
+                return {};
+            }
+            return put({key, std::move(value), mtime, bytes});
+        }
+
+        // Keeps the modification time of item, the file may have changed since it was read
+        std::vector<Item> put(Item item) {
+            if (max_bytes_ > 0 && item.bytes > max_bytes_) {
+                return {};
+            }
 
-        void put(const std::filesystem::path& key, std::shared_ptr<T> value) {
             std::lock_guard lock(mutex_);
 
             // Remove if already exists
-            auto it = cache_map_.find(key);
+            auto it = cache_map_.find(item.key);
             if (it != cache_map_.end()) {
-                cache_list_.erase(it->second);
-                cache_map_.erase(it);
+                erase(it);
             }
 
             // Add to front
-            cache_list_.push_front({key, value});
-            cache_map_[key] = cache_list_.begin();
-
-            // Evict if necessary
-            while (cache_list_.size() > max_size_) {
-                auto last = cache_list_.end();
-                --last;
-                cache_map_.erase(last->first);
-                cache_list_.pop_back();
-            }
+            total_bytes_ += item.bytes;
+            auto key = item.key;
+            cache_list_.push_front(std::move(item));
+            cache_map_[std::move(key)] = cache_list_.begin();
+            return evict();
         }
 
         std::shared_ptr<T> get(const std::filesystem::path& key) {
             std::lock_guard lock(mutex_);
-
-            auto it = cache_map_.find(key);
+            auto it = find_current(key);
             if (it == cache_map_.end()) {
                 return nullptr;
             }
 
             // Move to front
             cache_list_.splice(cache_list_.begin(), cache_list_, it->second);
-            return it->second->second;
+            return it->second->value;
+        }
+
+        // Removes the entry of key and hands it out, empty on a miss
+        std::optional<Item> take(const std::filesystem::path& key) {
+            std::lock_guard lock(mutex_);
+            auto it = find_current(key);
+            if (it == cache_map_.end()) {
+                return std::nullopt;
+            }
+            Item item = std::move(*it->second);
+            erase(it);
+            return item;
+        }
+
+        std::vector<Item> setMaxBytes(size_t max_bytes) {
+            std::lock_guard lock(mutex_);
+            max_bytes_ = max_bytes;
+            return evict();
         }
 
         void clear() {
             std::lock_guard lock(mutex_);
             cache_list_.clear();
             cache_map_.clear();
+            total_bytes_ = 0;
         }
 
         size_t size() const {
@@ -141,14 +186,46 @@ namespace gs::loader {
         }
 
     private:
-        using CacheItem = std::pair<std::filesystem::path, std::shared_ptr<T>>;
-        using CacheList = std::list<CacheItem>;
+        using CacheList = std::list<Item>;
         using CacheMap = std::unordered_map<std::filesystem::path, typename CacheList::iterator>;
 
+        // Entry of key, dropped and missing when the file changed since it was cached
+        typename CacheMap::iterator find_current(const std::filesystem::path& key) {
+            auto it = cache_map_.find(key);
+            if (it == cache_map_.end()) {
+                return it;
+            }
+            std::error_code ec;
+            const auto mtime = std::filesystem::last_write_time(key, ec);
+            if (ec || it->second->mtime != mtime) {
+                erase(it);
+                return cache_map_.end();
+            }
+            return it;
+        }
+
+        std::vector<Item> evict() {
+            std::vector<Item> evicted;
+            while (!cache_list_.empty() && (cache_list_.size() > max_size_ || (max_bytes_ > 0 && total_bytes_ > max_bytes_))) {
+                auto it = cache_map_.find(cache_list_.back().key);
+                evicted.push_back(std::move(*it->second));
+                erase(it);
+            }
+            return evicted;
+        }
+
+        void erase(typename CacheMap::iterator it) {
+            total_bytes_ -= it->second->bytes;
+            cache_list_.erase(it->second);
+            cache_map_.erase(it);
+        }
+
         mutable std::mutex mutex_;
         CacheList cache_list_;
         CacheMap cache_map_;
         size_t max_size_;
+        size_t max_bytes_;
+        size_t total_bytes_ = 0;
     };
 
 } // namespace gs::loader
\ No newline at end of file
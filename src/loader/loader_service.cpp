@@ -4,10 +4,14 @@
 
 #include "loader/loader_service.hpp"
 #include "core/logger.hpp"
+#include "core/splat_data.hpp"
 #include "loader/loaders/blender_loader.hpp"
 #include "loader/loaders/colmap_loader.hpp"
 #include "loader/loaders/ply_loader.hpp"
 #include "loader/loaders/sogs_loader.hpp"
+#include "loader/loaders/splat_lod_loader.hpp"
+#include <algorithm>
+#include <chrono>
 #include <format>
 
 namespace gs::loader {
@@ -18,16 +22,78 @@ namespace gs::loader {
         // Register default loaders
         registry_->registerLoader(std::make_unique<PLYLoader>());
         registry_->registerLoader(std::make_unique<SogLoader>());
+        registry_->registerLoader(std::make_unique<SplatLodLoader>());
         registry_->registerLoader(std::make_unique<ColmapLoader>());
         registry_->registerLoader(std::make_unique<BlenderLoader>());
 
         LOG_DEBUG("LoaderService initialized with {} loaders", registry_->size());
     }
 
+    namespace {
+        // The scene edits its models in place, the cache hands out device copies
+        LoadResult copy_splat_result(const LoadResult& cached) {
+            LoadResult result = cached;
+            const auto& splat = std::get<std::shared_ptr<SplatData>>(cached.data);
+            result.data = std::make_shared<SplatData>(splat->clone());
+            return result;
+        }
+
+        // Copy of splat with its attributes on device, host copies go to pinned memory so they
+        // upload again at full bandwidth
+        std::shared_ptr<SplatData> splat_on(const SplatData& splat, torch::Device device) {
+            torch::NoGradGuard no_grad;
+            const auto to_device = [&](const torch::Tensor& tensor) {
+                if (device.is_cuda()) {
+                    return tensor.to(device);
+                }
+                return torch::empty(tensor.sizes(), tensor.options().device(device).pinned_memory(true)).copy_(tensor);
+            };
+            auto copy = std::make_shared<SplatData>(splat.get_max_sh_degree(),
+                                                    to_device(splat.means()),
+                                                    to_device(splat.sh0()),
+                                                    to_device(splat.shN()),
+                                                    to_device(splat.scaling_raw()),
+                                                    to_device(splat.rotation_raw()),
+                                                    to_device(splat.opacity_raw()),
+                                                    splat.get_scene_scale());
+            copy->set_active_sh_degree(splat.get_active_sh_degree());
+            return copy;
+        }
+
+        size_t splat_bytes(const SplatData& splat) {
+            return splat.means().nbytes() + splat.sh0().nbytes() + splat.shN().nbytes() +
+                   splat.scaling_raw().nbytes() + splat.rotation_raw().nbytes() + splat.opacity_raw().nbytes();
+        }
+    } // namespace
+
     std::expected<LoadResult, std::string> LoaderService::load(
         const std::filesystem::path& path,
         const LoadOptions& options) {
 
+        const bool cacheable = options.cache && !options.validate_only;
+        if (cacheable) {
+            const auto start = std::chrono::steady_clock::now();
+            auto cached = splat_cache_.get(path);
+            const char* tier = "VRAM";
+            if (!cached) {
+                // Promoted back to the device tier, the host copy is dropped
+                if (auto host = host_splat_cache_.take(path)) {
+                    auto device_copy = std::make_shared<LoadResult>(*host->value);
+                    device_copy->data = splat_on(*std::get<std::shared_ptr<SplatData>>(host->value->data), torch::kCUDA);
+                    host->value = device_copy;
+                    cacheOnDevice(std::move(*host));
+                    cached = std::move(device_copy);
+                    tier = "RAM";
+                }
+            }
+            if (cached) {
+                auto result = copy_splat_result(*cached);
+                result.load_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+                LOG_INFO("Loaded {} from the {} model cache in {}ms", path.string(), tier, result.load_time.count());
+                return result;
+            }
+        }
+
         // Find appropriate loader
         auto* loader = registry_->findLoader(path);
         if (!loader) {
@@ -67,7 +133,16 @@ namespace gs::loader {
 
         // Perform the load
         try {
-            return loader->load(path, options);
+            auto result = loader->load(path, options);
+            const auto* splat = result ? std::get_if<std::shared_ptr<SplatData>>(&result->data) : nullptr;
+            if (cacheable && splat && *splat && (device_cache_bytes_ > 0 || host_cache_bytes_ > 0)) {
+                std::error_code ec;
+                const auto mtime = std::filesystem::last_write_time(path, ec);
+                if (!ec) {
+                    cacheOnDevice({path, std::make_shared<LoadResult>(copy_splat_result(*result)), mtime, splat_bytes(**splat)});
+                }
+            }
+            return result;
         } catch (const std::exception& e) {
             std::string error_msg = std::format(
                 "{} loader failed: {}", loader->name(), e.what());
@@ -76,6 +151,58 @@ namespace gs::loader {
         }
     }
 
+    std::future<std::expected<LoadResult, std::string>> LoaderService::loadAsync(
+        const std::filesystem::path& path,
+        const LoadOptions& options) {
+
+        auto promise = std::make_shared<std::promise<std::expected<LoadResult, std::string>>>();
+        auto future = promise->get_future();
+
+        // Every loader thread uploads on the legacy default stream, so the tensors are ordered
+        // before any later use on the thread that takes the result
+        queue_.enqueue(path, [this, path, options, promise] {
+            if (options.cancel.stop_requested()) {
+                promise->set_value(std::unexpected(std::format("Loading {} cancelled", path.string())));
+                return;
+            }
+            try {
+                promise->set_value(load(path, options));
+            } catch (const std::exception& e) {
+                promise->set_value(std::unexpected(std::string(e.what())));
+            }
+        });
+        return future;
+    }
+
+    void LoaderService::setCacheBudget(size_t device_bytes, size_t host_bytes) {
+        device_cache_bytes_ = device_bytes;
+        host_cache_bytes_ = host_bytes;
+        // LoadingCache reads 0 as unlimited, a budget of 1 byte evicts every entry instead
+        host_splat_cache_.setMaxBytes(std::max<size_t>(host_bytes, 1));
+        demoteToHost(splat_cache_.setMaxBytes(std::max<size_t>(device_bytes, 1)));
+        LOG_DEBUG("Model cache budget: {} MB VRAM, {} MB RAM", device_bytes >> 20, host_bytes >> 20);
+    }
+
+    void LoaderService::cacheOnDevice(SplatCache::Item item) {
+        if (device_cache_bytes_ == 0 || item.bytes > device_cache_bytes_) {
+            demoteToHost({std::move(item)});
+            return;
+        }
+        demoteToHost(splat_cache_.put(std::move(item)));
+    }
+
+    void LoaderService::demoteToHost(std::vector<SplatCache::Item> evicted) {
+        for (auto& item : evicted) {
+            if (host_cache_bytes_ == 0 || item.bytes > host_cache_bytes_) {
+                continue;
+            }
+            auto host_copy = std::make_shared<LoadResult>(*item.value);
+            host_copy->data = splat_on(*std::get<std::shared_ptr<SplatData>>(item.value->data), torch::kCPU);
+            item.value = std::move(host_copy);
+            host_splat_cache_.put(std::move(item));
+        }
+    }
+
     std::vector<std::string> LoaderService::getAvailableLoaders() const {
         std::vector<std::string> names;
         for (const auto& info : registry_->getLoaderInfo()) {
@@ -5,8 +5,11 @@
 #pragma once
 
 #include "loader/loader_interface.hpp"
+#include "loader/loader_queue.hpp"
 #include "loader/loader_registry.hpp"
+#include <atomic>
 #include <expected>
+#include <future>
 #include <memory>
 #include <vector>
 
@@ -36,6 +39,22 @@ namespace gs::loader {
             const std::filesystem::path& path,
             const LoadOptions& options = {});
 
+        /**
+         * @brief Load on the service's loading queue
+         * @return Future of the LoadResult, errors (including cancellation) as strings
+         */
+        std::future<std::expected<LoadResult, std::string>> loadAsync(
+            const std::filesystem::path& path,
+            const LoadOptions& options = {});
+
+        /**
+         * @brief Budgets of the two model cache tiers, 0 disables a tier
+         *
+         * Cached splat files are kept on the device within device_bytes; the least recently
+         * loaded ones move to pinned host memory within host_bytes and back on their next load.
+         */
+        void setCacheBudget(size_t device_bytes, size_t host_bytes);
+
         /**
          * @brief Get information about available loaders
          */
@@ -47,7 +66,23 @@ namespace gs::loader {
         std::vector<std::string> getSupportedExtensions() const;
 
     private:
+        // Concurrent loads, each parser is already multithreaded
+        static constexpr size_t LOAD_WORKERS = 4;
+        static constexpr size_t SPLAT_CACHE_BYTES = size_t{2} << 30;
+        static constexpr size_t HOST_SPLAT_CACHE_BYTES = size_t{8} << 30;
+
+        using SplatCache = LoadingCache<LoadResult>;
+
+        // Evicted entries move on to the host tier
+        void cacheOnDevice(SplatCache::Item item);
+        void demoteToHost(std::vector<SplatCache::Item> evicted);
+
         std::unique_ptr<DataLoaderRegistry> registry_;
+        std::atomic<size_t> device_cache_bytes_{SPLAT_CACHE_BYTES};
+        std::atomic<size_t> host_cache_bytes_{HOST_SPLAT_CACHE_BYTES};
+        SplatCache splat_cache_{16, SPLAT_CACHE_BYTES};
+        SplatCache host_splat_cache_{64, HOST_SPLAT_CACHE_BYTES};
+        LoadingQueue queue_{LOAD_WORKERS}; // Last, its workers stop before the rest is destroyed
     };
 
 } // namespace gs::loader
\ No newline at end of file
@@ -11,8 +11,6 @@
 #include <chrono>
 #include <filesystem>
 #include <format>
-#include <fstream>
-#include <nlohmann/json.hpp>
 
 namespace gs::loader {
 
@@ -63,24 +61,10 @@ namespace gs::loader {
         // Validation only mode
         if (options.validate_only) {
             LOG_DEBUG("Validation only mode for Blender/NeRF: {}", transforms_file.string());
-            // Check if the transforms file is valid JSON
-            std::ifstream file(transforms_file);
-            if (!file) {
-                LOG_ERROR("Cannot open transforms file: {}", transforms_file.string());
-                throw std::runtime_error("Cannot open transforms file");
-            }
-
-            // Try to parse as JSON (basic validation)
-            try {
-                nlohmann::json j;
-                file >> j;
-
-                if (!j.contains("frames") || !j["frames"].is_array()) {
-                    LOG_ERROR("Invalid transforms file: missing 'frames' array");
-                    throw std::runtime_error("Invalid transforms file: missing 'frames' array");
-                }
-            } catch (const std::exception& e) {
-                std::string error_msg = std::format("Invalid JSON: {}", e.what());
+            // Frames, intrinsics and image headers, no cameras or point cloud
+            const auto problems = validate_transforms_dataset(transforms_file);
+            if (!problems.empty()) {
+                const auto error_msg = describe_validation_problems("Blender/NeRF", problems);
                 LOG_ERROR("{}", error_msg);
                 throw std::runtime_error(error_msg);
             }
@@ -7,6 +7,7 @@
 #include "core/logger.hpp"
 #include "core/point_cloud.hpp"
 #include "formats/colmap.hpp"
+#include "formats/undistort.hpp"
 #include "loader/filesystem_utils.hpp"
 #include "training/dataset.hpp"
 #include <algorithm>
@@ -129,8 +130,17 @@ namespace gs::loader {
             }
         }
 
-        // Validation only mode
+        // Validation only mode: structure and image headers, no cameras or point cloud
         if (options.validate_only) {
+            if (options.progress) {
+                options.progress(20.0f, "Validating COLMAP dataset...");
+            }
+            const auto problems = validate_colmap_dataset(path, actual_images_folder, trying_text);
+            if (!problems.empty()) {
+                const auto error_msg = describe_validation_problems("COLMAP", problems);
+                LOG_ERROR("{}", error_msg);
+                throw std::runtime_error(error_msg);
+            }
             if (options.progress) {
                 options.progress(100.0f, "COLMAP validation complete");
             }
@@ -169,6 +179,15 @@ namespace gs::loader {
                 throw std::runtime_error("No valid COLMAP camera and image data found");
             }
 
+            if (options.undistort) {
+                if (options.progress) {
+                    options.progress(30.0f, "Undistorting images...");
+                }
+                undistort_pinhole_cameras(camera_infos, options.undistort_cache_dir.empty()
+                                                            ? path / "undistorted"
+                                                            : options.undistort_cache_dir);
+            }
+
             if (options.progress) {
                 options.progress(40.0f, std::format("Creating {} cameras...", camera_infos.size()));
             }
@@ -197,6 +216,8 @@ namespace gs::loader {
                     info._width,
                     info._height,
                     static_cast<int>(i));
+                cam->set_valid_mask_path(info._valid_mask_path);
+                cam->set_mask_path(info._mask_path);
 
                 cameras.push_back(std::move(cam));
             }
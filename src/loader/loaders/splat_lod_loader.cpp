@@ -0,0 +1,97 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "splat_lod_loader.hpp"
+#include "core/logger.hpp"
+#include "core/splat_data.hpp"
+#include "formats/splat_lod.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+
+namespace gs::loader {
+
+    std::expected<LoadResult, std::string> SplatLodLoader::load(
+        const std::filesystem::path& path,
+        const LoadOptions& options) {
+
+        LOG_TIMER("LOD Loading");
+        auto start_time = std::chrono::high_resolution_clock::now();
+
+        if (options.progress) {
+            options.progress(0.0f, "Loading LOD splat file...");
+        }
+
+        if (!std::filesystem::is_regular_file(path)) {
+            std::string error_msg = std::format("LOD splat file does not exist: {}", path.string());
+            LOG_ERROR("{}", error_msg);
+            throw std::runtime_error(error_msg);
+        }
+
+        // Validation only mode: the header and block table are checked, no block is read
+        if (options.validate_only) {
+            if (auto lod = SplatLodFile::open(path); !lod) {
+                LOG_ERROR("Invalid LOD splat file: {}", lod.error());
+                throw std::runtime_error(lod.error());
+            }
+
+            LoadResult result;
+            result.data = std::shared_ptr<SplatData>{};
+            result.scene_center = torch::zeros({3});
+            result.loader_used = name();
+            result.load_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::high_resolution_clock::now() - start_time);
+            return result;
+        }
+
+        LOG_INFO("Loading LOD splat file at full resolution: {}", path.string());
+        auto splat_result = load_splat_lod(path);
+        if (!splat_result) {
+            LOG_ERROR("Failed to load LOD splat file: {}", splat_result.error());
+            throw std::runtime_error(splat_result.error());
+        }
+
+        if (options.progress) {
+            options.progress(100.0f, "LOD loading complete");
+        }
+
+        auto load_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - start_time);
+
+        LoadResult result{
+            .data = std::make_shared<SplatData>(std::move(*splat_result)),
+            .scene_center = torch::zeros({3}),
+            .loader_used = name(),
+            .load_time = load_time,
+            .warnings = {}};
+
+        LOG_INFO("LOD splat file loaded successfully in {}ms", load_time.count());
+
+        return result;
+    }
+
+    bool SplatLodLoader::canLoad(const std::filesystem::path& path) const {
+        if (!std::filesystem::is_regular_file(path)) {
+            return false;
+        }
+
+        auto ext = path.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        return ext == core::SPLAT_LOD_EXTENSION;
+    }
+
+    std::string SplatLodLoader::name() const {
+        return "LOD";
+    }
+
+    std::vector<std::string> SplatLodLoader::supportedExtensions() const {
+        return {core::SPLAT_LOD_EXTENSION};
+    }
+
+    int SplatLodLoader::priority() const {
+        return 15;
+    }
+
+} // namespace gs::loader
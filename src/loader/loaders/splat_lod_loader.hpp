@@ -0,0 +1,31 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "loader/loader_interface.hpp"
+
+namespace gs::loader {
+
+    /**
+     * @brief Loader for chunked level-of-detail splat files, returns the full-resolution model
+     *
+     * The viewer streams these files chunk by chunk instead, see SplatLodFile.
+     */
+    class SplatLodLoader : public IDataLoader {
+    public:
+        SplatLodLoader() = default;
+        ~SplatLodLoader() override = default;
+
+        std::expected<LoadResult, std::string> load(
+            const std::filesystem::path& path,
+            const LoadOptions& options = {}) override;
+
+        bool canLoad(const std::filesystem::path& path) const override;
+        std::string name() const override;
+        std::vector<std::string> supportedExtensions() const override;
+        int priority() const override;
+    };
+
+} // namespace gs::loader
@@ -7,8 +7,68 @@
 #include "core/logger.hpp"
 
 #include <c10/cuda/CUDAAllocatorConfig.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <cstdlib>
 #include <iostream>
+#include <optional>
 #include <print>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+    constexpr const char* ASYNC_BACKEND = "backend:cudaMallocAsync";
+
+    bool async_allocator_loaded() {
+        return c10::cuda::CUDACachingAllocator::get()->name() == "cudaMallocAsync";
+    }
+
+    // libtorch picks its allocator backend from PYTORCH_CUDA_ALLOC_CONF while it loads, before
+    // main. --cuda-allocator async therefore restarts the process with the variable set. Returns
+    // the exit code of the restarted process, or nothing when the restart failed.
+    std::optional<int> relaunch_with_async_allocator(char* argv[]) {
+        const char* current = std::getenv("PYTORCH_CUDA_ALLOC_CONF");
+        if (current && std::string(current).find(ASYNC_BACKEND) != std::string::npos) {
+            return std::nullopt; // Already asked for, this libtorch ignored it
+        }
+        const std::string conf = current && *current ? std::string(current) + "," + ASYNC_BACKEND : ASYNC_BACKEND;
+#ifdef _WIN32
+        if (_putenv_s("PYTORCH_CUDA_ALLOC_CONF", conf.c_str()) != 0) {
+            return std::nullopt;
+        }
+        wchar_t exe[MAX_PATH];
+        if (GetModuleFileNameW(nullptr, exe, MAX_PATH) == 0) {
+            return std::nullopt;
+        }
+        STARTUPINFOW startup{};
+        startup.cb = sizeof(startup);
+        PROCESS_INFORMATION process{};
+        std::wstring command_line = GetCommandLineW();
+        if (!CreateProcessW(exe, command_line.data(), nullptr, nullptr, TRUE, 0, nullptr, nullptr, &startup, &process)) {
+            return std::nullopt;
+        }
+        WaitForSingleObject(process.hProcess, INFINITE);
+        DWORD exit_code = 1;
+        GetExitCodeProcess(process.hProcess, &exit_code);
+        CloseHandle(process.hThread);
+        CloseHandle(process.hProcess);
+        return static_cast<int>(exit_code);
+#else
+        if (setenv("PYTORCH_CUDA_ALLOC_CONF", conf.c_str(), 1) != 0) {
+            return std::nullopt;
+        }
+        execv("/proc/self/exe", argv);
+        execvp(argv[0], argv);
+        return std::nullopt;
+#endif
+    }
+
+} // namespace
 
 int main(int argc, char* argv[]) {
 //----------------------------------------------------------------------
@@ -19,12 +79,16 @@ int main(int argc, char* argv[]) {
 // also works on Windows. Setting the environment variable using
 // setenv("PYTORCH_CUDA_ALLOC_CONF", "expandable_segments:True", 1);
 // would work on Linux but not on Windows, so we use the C++ API.
-// Should this break in the future, we can always revert to the old
-// approach of calling emptyCache() after each densification step.
+// Without expandable segments (Windows), training::VramManager trims
+// the cache once the reserved pool exceeds --vram-budget-mb, or
+// --cuda-allocator async switches to cudaMallocAsync pools.
 //----------------------------------------------------------------------
+    const bool async_allocator = async_allocator_loaded();
 #ifndef _WIN32
     // Windows doesn't support CUDACachingAllocator expandable_segments
-    c10::cuda::CUDACachingAllocator::setAllocatorSettings("expandable_segments:True");
+    if (!async_allocator) {
+        c10::cuda::CUDACachingAllocator::setAllocatorSettings("expandable_segments:True");
+    }
 #endif
 
     // Parse arguments (this automatically initializes the logger based on --log-level flag)
@@ -36,6 +100,14 @@ int main(int argc, char* argv[]) {
         return -1;
     }
 
+    if ((*params_result)->optimization.cuda_allocator == "async" && !async_allocator) {
+        LOG_INFO("Restarting with the cudaMallocAsync allocator backend");
+        if (const auto exit_code = relaunch_with_async_allocator(argv)) {
+            return *exit_code;
+        }
+        LOG_WARN("cudaMallocAsync backend unavailable, keeping the native caching allocator");
+    }
+
     // Logger is now ready to use
     LOG_INFO("========================================");
     LOG_INFO("LichtFeld Studio");
@@ -126,13 +126,10 @@ namespace gs::management {
         project_data_.version = CURRENT_VERSION;
         project_data_.project_creation_time = generateCurrentTimeStamp();
         initializeMigrators();
-
-        if (update_file_on_change_ && !output_file_name_.empty()) {
-            writeToFile();
-        }
     }
 
     void Project::setProjectFileName(const std::filesystem::path& path) {
+        std::lock_guard<std::mutex> lock(io_mutex_);
         if (std::filesystem::is_directory(path)) {
             std::string project_file_name = project_data_.project_name.empty() ? "project" : project_data_.project_name;
             project_file_name += EXTENSION;
@@ -182,7 +179,10 @@ namespace gs::management {
                 processedDoc = migrator_registry_.migrateToVersion(doc, fileVersion, CURRENT_VERSION);
             }
 
-            project_data_ = parseProjectData(processedDoc);
+            {
+                std::lock_guard<std::mutex> data_lock(data_mutex_);
+                project_data_ = parseProjectData(processedDoc);
+            }
             output_file_name_ = filepath;
 
             return true;
@@ -195,8 +195,10 @@ namespace gs::management {
 
     bool Project::writeToFile(const std::filesystem::path& filepath) {
         std::lock_guard<std::mutex> lock(io_mutex_);
+        return writeSnapshot(filepath.empty() ? output_file_name_ : filepath, false);
+    }
 
-        std::filesystem::path targetPath = filepath.empty() ? output_file_name_ : filepath;
+    bool Project::writeSnapshot(const std::filesystem::path& targetPath, bool skip_unchanged) {
         if (targetPath.empty()) {
             LOG_ERROR("LichtFeldProjectFile::writeToFile - no output file was set");
             return false;
@@ -217,19 +219,49 @@ namespace gs::management {
             return false;
         }
 
-        project_data_.project_last_update_time = generateCurrentTimeStamp();
-
         try {
-            std::ofstream file(targetPath);
-            if (!file.is_open()) {
-                LOG_ERROR("Cannot open file for writing: {}", targetPath.string());
-                return false;
+            ProjectData data;
+            {
+                std::lock_guard<std::mutex> lock(data_mutex_);
+                data = project_data_;
             }
 
-            // Serialize and write JSON
-            nlohmann::ordered_json doc = serializeProjectData(project_data_);
-            file << doc.dump(4) << std::endl; // Pretty print with 4-space indentation
+            // Compared without the update time, a write that would only touch it is skipped
+            data.project_last_update_time.clear();
+            std::string content = serializeProjectData(data).dump(4);
+            if (skip_unchanged && targetPath == last_written_path_ && content == last_written_) {
+                LOG_TRACE("Project file {} is up to date", targetPath.string());
+                return true;
+            }
 
+            data.project_last_update_time = generateCurrentTimeStamp();
+            {
+                std::lock_guard<std::mutex> lock(data_mutex_);
+                project_data_.project_last_update_time = data.project_last_update_time;
+            }
+
+            // Written aside and renamed over the old file, a crash mid-write leaves the old one
+            std::filesystem::path temp_path = targetPath;
+            temp_path += ".tmp";
+            {
+                std::ofstream file(temp_path, std::ios::trunc);
+                if (!file.is_open()) {
+                    LOG_ERROR("Cannot open file for writing: {}", temp_path.string());
+                    return false;
+                }
+
+                // Serialize and write JSON
+                nlohmann::ordered_json doc = serializeProjectData(data);
+                file << doc.dump(4) << std::endl; // Pretty print with 4-space indentation
+                if (!file) {
+                    LOG_ERROR("Error writing project file: {}", temp_path.string());
+                    return false;
+                }
+            }
+            std::filesystem::rename(temp_path, targetPath);
+
+            last_written_ = std::move(content);
+            last_written_path_ = targetPath;
             return true;
 
         } catch (const std::exception& e) {
@@ -238,6 +270,79 @@ namespace gs::management {
         }
     }
 
+    void Project::requestWrite() {
+        if (!update_file_on_change_ || output_file_name_.empty()) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        const auto now = std::chrono::steady_clock::now();
+        if (!write_pending_) {
+            write_deadline_ = now + MAX_WRITE_DELAY;
+        }
+        write_pending_ = true;
+        write_due_ = now + WRITE_DEBOUNCE;
+        if (!writer_.joinable()) {
+            writer_ = std::thread([this] { writerLoop(); });
+        }
+        write_cv_.notify_one();
+    }
+
+    void Project::writerLoop() {
+        std::unique_lock<std::mutex> lock(write_mutex_);
+        while (true) {
+            write_cv_.wait(lock, [this] { return write_pending_ || stop_writer_; });
+            if (!write_pending_) {
+                return;
+            }
+
+            // Changes within the debounce window join this write, a steady stream of them still
+            // writes every MAX_WRITE_DELAY. Stopping writes what is pending right away.
+            while (!stop_writer_) {
+                const auto due = std::min(write_due_, write_deadline_);
+                if (std::chrono::steady_clock::now() >= due) {
+                    break;
+                }
+                write_cv_.wait_until(lock, due);
+            }
+            write_pending_ = false;
+
+            lock.unlock();
+            {
+                std::lock_guard<std::mutex> io_lock(io_mutex_);
+                if (!output_file_name_.empty()) {
+                    writeSnapshot(output_file_name_, true);
+                }
+            }
+            lock.lock();
+        }
+    }
+
+    void Project::flushWrites() {
+        {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            if (!write_pending_) {
+                return;
+            }
+            write_pending_ = false;
+        }
+        std::lock_guard<std::mutex> io_lock(io_mutex_);
+        if (!output_file_name_.empty()) {
+            writeSnapshot(output_file_name_, true);
+        }
+    }
+
+    Project::~Project() {
+        {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            stop_writer_ = true;
+        }
+        write_cv_.notify_one();
+        if (writer_.joinable()) {
+            writer_.join();
+        }
+    }
+
     bool Project::validateJsonStructure(const nlohmann::json& json) const {
         // Basic validation - check required fields
         bool contains_basics = json.contains("project_info") &&
@@ -280,6 +385,9 @@ namespace gs::management {
         data.data_set_info.max_width = dataJson["max_width"].get<int>();
         data.data_set_info.test_every = dataJson["test_every"].get<int>();
         data.data_set_info.data_type = dataJson["data_type"].get<std::string>();
+        if (dataJson.contains("image_info")) {
+            data.data_set_info.image_info = dataJson["image_info"].get<std::map<std::string, std::array<int, 3>>>();
+        }
 
         if (json.contains("training") && json["training"].contains("optimization")) {
             data.optimization = param::OptimizationParameters::from_json(json["training"]["optimization"]);
@@ -330,6 +438,9 @@ namespace gs::management {
         json["data"]["max_width"] = data.data_set_info.max_width;
         json["data"]["test_every"] = data.data_set_info.test_every;
         json["data"]["images"] = data.data_set_info.images;
+        if (!data.data_set_info.image_info.empty()) {
+            json["data"]["image_info"] = data.data_set_info.image_info;
+        }
 
         // training optimization
         json["training"]["optimization"] = data.optimization.to_json();
@@ -364,18 +475,25 @@ namespace gs::management {
 
     // Convenience methods
     void Project::setProjectName(const std::string& name) {
+        std::lock_guard<std::mutex> lock(data_mutex_);
         project_data_.project_name = name;
     }
 
     void Project::setDataInfo(const param::DatasetConfig& data_config) {
+        std::lock_guard<std::mutex> lock(data_mutex_);
         project_data_.data_set_info = DataSetInfo(data_config);
         std::string datatype = IsColmapData(project_data_.data_set_info.data_path) ? "Colmap" : "Blender";
 
         project_data_.data_set_info.data_type = datatype;
 
-        if (update_file_on_change_ && !output_file_name_.empty()) {
-            writeToFile();
-        }
+        requestWrite();
+    }
+
+    void Project::setImageInfo(std::map<std::string, std::array<int, 3>> image_info) {
+        std::lock_guard<std::mutex> lock(data_mutex_);
+        project_data_.data_set_info.image_info = std::move(image_info);
+
+        requestWrite();
     }
 
     bool Project::addPly(const PlyData& ply_to_be_added) {
@@ -390,11 +508,7 @@ namespace gs::management {
 
         project_data_.outputs.plys.push_back(ply_to_be_added);
 
-        if (update_file_on_change_ && !output_file_name_.empty()) {
-            if (!writeToFile()) {
-                return false;
-            }
-        }
+        requestWrite();
         return true;
     }
 
@@ -404,6 +518,7 @@ namespace gs::management {
     }
 
     std::vector<PlyData> Project::getPlys() const {
+        std::lock_guard<std::mutex> lock(data_mutex_);
         return project_data_.outputs.plys;
     }
 
@@ -414,9 +529,7 @@ namespace gs::management {
             project_data_.outputs.plys.erase(project_data_.outputs.plys.begin() + index);
         }
 
-        if (update_file_on_change_ && !output_file_name_.empty()) {
-            writeToFile();
-        }
+        requestWrite();
     }
 
     void Project::removePly(const std::string& name) {
@@ -432,9 +545,7 @@ namespace gs::management {
             LOG_DEBUG("Project: Removed ply '{}'", name);
         }
 
-        if (update_file_on_change_ && !output_file_name_.empty()) {
-            writeToFile();
-        }
+        requestWrite();
     }
 
     void Project::renamePly(const std::string& old_name, const std::string& new_name) {
@@ -452,9 +563,7 @@ namespace gs::management {
         if (!found_ply) {
             LOG_WARN("could not find ply with name {}", old_name);
         }
-        if (update_file_on_change_ && !output_file_name_.empty()) {
-            writeToFile();
-        }
+        requestWrite();
     }
 
     static bool change_ply_path(const std::filesystem::path& old_path, const std::filesystem::path& new_path) {
@@ -498,11 +607,7 @@ namespace gs::management {
             return false;
         }
 
-        if (update_file_on_change_ && !output_file_name_.empty()) {
-            if (!writeToFile()) {
-                return false;
-            }
-        }
+        requestWrite();
         return true;
     }
 
@@ -510,9 +615,7 @@ namespace gs::management {
         std::lock_guard<std::mutex> lock(data_mutex_);
 
         project_data_.outputs.plys.clear();
-        if (update_file_on_change_ && !output_file_name_.empty()) {
-            writeToFile();
-        }
+        requestWrite();
     }
 
     bool Project::isCompatible(const Version& fileVersion) const {
@@ -580,6 +683,7 @@ namespace gs::management {
         setProjectFileName(dst_project_file_path);
 
         // Copy all ply files into new directory
+        std::unique_lock<std::mutex> data_lock(data_mutex_);
         for (auto& ply : project_data_.outputs.plys) {
             try {
                 if (!fs::exists(ply.ply_path)) {
@@ -603,6 +707,8 @@ namespace gs::management {
             }
         }
 
+        data_lock.unlock();
+
         fs::path lock_file = src_project_dir / Project::PROJECT_LOCK_FILE;
         if (std::filesystem::exists(lock_file)) {
             if (!fs::remove(lock_file)) {
@@ -5,10 +5,20 @@
 #include "camera_frustum_renderer.hpp"
 #include "core/logger.hpp"
 #include "gl_state_guard.hpp"
+#include <algorithm>
+#include <cstring>
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace gs::rendering {
 
+    CameraFrustumRenderer::~CameraFrustumRenderer() {
+        for (auto& readback : pick_readbacks_) {
+            if (readback.fence) {
+                glDeleteSync(readback.fence);
+            }
+        }
+    }
+
     Result<void> CameraFrustumRenderer::init() {
         LOG_DEBUG("Initializing camera frustum renderer");
 
@@ -25,12 +35,12 @@ namespace gs::rendering {
             return result;
         }
 
-        // Create instance buffer
-        auto instance_vbo_result = create_vbo();
-        if (!instance_vbo_result) {
-            return std::unexpected(instance_vbo_result.error());
+        // Create the camera pose buffer
+        auto pose_ssbo_result = create_vbo();
+        if (!pose_ssbo_result) {
+            return std::unexpected(pose_ssbo_result.error());
         }
-        instance_vbo_ = std::move(*instance_vbo_result);
+        pose_ssbo_ = std::move(*pose_ssbo_result);
 
         // Create picking FBO
         if (auto result = createPickingFBO(); !result) {
@@ -173,157 +183,96 @@ namespace gs::rendering {
         }
 
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        // Pixel buffers for the asynchronous readback of the picked pixel
+        for (auto& readback : pick_readbacks_) {
+            auto pbo_result = create_vbo();
+            if (!pbo_result) {
+                return std::unexpected(pbo_result.error());
+            }
+            readback.pbo = std::move(*pbo_result);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+            glBufferData(GL_PIXEL_PACK_BUFFER, 3 * sizeof(float), nullptr, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
         LOG_DEBUG("Picking FBO created successfully");
         return {};
     }
 
-    void CameraFrustumRenderer::prepareInstances(const std::vector<std::shared_ptr<const Camera>>& cameras,
-                                                 float scale,
-                                                 const glm::vec3& train_color,
-                                                 const glm::vec3& eval_color,
-                                                 bool for_picking,
-                                                 const glm::vec3& view_position) {
-
-        // Track if we need to regenerate
-        bool needs_regeneration = false;
-
-        // Check if we need to regenerate instances
-        if (cached_instances_.size() != cameras.size()) {
-            needs_regeneration = true;
-            LOG_TRACE("Instance count changed: {} -> {}", cached_instances_.size(), cameras.size());
-        } else if (last_scale_ != scale || last_train_color_ != train_color || last_eval_color_ != eval_color) {
-            needs_regeneration = true;
-            LOG_TRACE("Instance parameters changed");
+    void CameraFrustumRenderer::uploadPoses(const std::vector<std::shared_ptr<const Camera>>& cameras) {
+        // The list is a fresh copy every frame, compare the cameras it holds
+        bool changed = uploaded_cameras_.size() != cameras.size();
+        for (size_t i = 0; i < cameras.size() && !changed; ++i) {
+            changed = uploaded_cameras_[i] != cameras[i].get();
         }
-
-        // Only regenerate if necessary
-        if (!needs_regeneration && !cached_instances_.empty()) {
-            // Update visibility based on distance even when using cache
-            updateInstanceVisibility(view_position);
-            LOG_TRACE("Using {} cached instances for {}, updating visibility",
-                      cached_instances_.size(), for_picking ? "picking" : "rendering");
+        if (!changed) {
             return;
         }
 
-        LOG_DEBUG("Regenerating {} instances for {} (scale: {}, train_color: [{}, {}, {}])",
-                  cameras.size(), for_picking ? "picking" : "rendering", scale,
-                  train_color.r, train_color.g, train_color.b);
+        LOG_TIMER_TRACE("CameraFrustumRenderer::uploadPoses");
 
-        cached_instances_.clear();
-        cached_instances_.reserve(cameras.size());
+        uploaded_cameras_.clear();
         camera_ids_.clear();
-        camera_ids_.reserve(cameras.size());
-        camera_positions_.clear();
-        camera_positions_.reserve(cameras.size());
-
-        // Transform from OpenGL to COLMAP coordinates
-        const glm::mat4 GL_TO_COLMAP = glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, -1.0f, -1.0f));
-
+        std::vector<torch::Tensor> rotations, translations;
+        std::vector<float> is_eval;
         for (const auto& cam : cameras) {
-            // Get camera world-to-camera transform
-            auto R_tensor = cam->R();
-            auto T_tensor = cam->T();
-
-            if (!R_tensor.defined() || !T_tensor.defined()) {
+            uploaded_cameras_.push_back(cam.get());
+            if (!cam->R().defined() || !cam->T().defined()) {
                 continue;
             }
+            camera_ids_.push_back(cam->uid());
+            rotations.push_back(cam->R());
+            translations.push_back(cam->T());
+            is_eval.push_back(cam->image_name().find("test") != std::string::npos ? 1.0f : 0.0f);
+        }
 
-            // Convert to CPU
-            R_tensor = R_tensor.to(torch::kCPU);
-            T_tensor = T_tensor.to(torch::kCPU);
-
-            // Build world-to-camera matrix
-            glm::mat4 w2c(1.0f);
-            auto R_acc = R_tensor.accessor<float, 2>();
-            auto T_acc = T_tensor.accessor<float, 1>();
-
-            for (int i = 0; i < 3; ++i) {
-                for (int j = 0; j < 3; ++j) {
-                    w2c[j][i] = R_acc[i][j]; // Column-major
-                }
-                w2c[3][i] = T_acc[i];
-            }
-
-            // Camera-to-world transform
-            glm::mat4 c2w = glm::inverse(w2c);
-
-            // Extract camera position
-            glm::vec3 cam_pos = glm::vec3(c2w[3]);
-            camera_positions_.push_back(cam_pos);
-
-            // Apply coordinate system conversion and scale
-            glm::mat4 model = c2w * GL_TO_COLMAP * glm::scale(glm::mat4(1.0f), glm::vec3(scale));
-
-            // Determine color based on camera type
-            bool is_test = cam->image_name().find("test") != std::string::npos;
-            glm::vec3 color = is_test ? eval_color : train_color;
-
-            // Calculate alpha based on distance to view position
-            float distance = glm::length(cam_pos - view_position);
-            float alpha = 1.0f;
-
-            if (for_picking) {
-                // For picking, keep everything at full alpha so it's pickable
-                // The picking shader will handle the actual visibility
-                alpha = 1.0f;
-            } else {
-                // For rendering, use aggressive fading
-                const float FADE_START_DISTANCE = 5.0f * scale;
-                const float FADE_END_DISTANCE = 0.2f * scale;
-                const float MINIMUM_VISIBLE_DISTANCE = 0.1f * scale;
-
-                if (distance < MINIMUM_VISIBLE_DISTANCE) {
-                    alpha = 0.0f; // Completely invisible when very close
-                } else if (distance < FADE_END_DISTANCE) {
-                    alpha = 0.05f; // Very faint
-                } else if (distance < FADE_START_DISTANCE) {
-                    float t = (distance - FADE_END_DISTANCE) / (FADE_START_DISTANCE - FADE_END_DISTANCE);
-                    alpha = 0.05f + 0.95f * (t * t * (3.0f - 2.0f * t));
+        std::vector<CameraPose> poses(camera_ids_.size());
+        if (!poses.empty()) {
+            // One transfer for all cameras instead of one per tensor
+            const auto R = torch::stack(rotations).to(torch::kCPU, torch::kFloat32).contiguous();
+            const auto T = torch::stack(translations).to(torch::kCPU, torch::kFloat32).contiguous();
+            const auto R_acc = R.accessor<float, 3>();
+            const auto T_acc = T.accessor<float, 2>();
+            for (size_t c = 0; c < poses.size(); ++c) {
+                glm::mat4 w2c(1.0f);
+                for (int i = 0; i < 3; ++i) {
+                    for (int j = 0; j < 3; ++j) {
+                        w2c[j][i] = R_acc[c][i][j]; // Column-major
+                    }
+                    w2c[3][i] = T_acc[c][i];
                 }
+                poses[c] = {.cam_to_world = glm::inverse(w2c), .info = glm::vec4(is_eval[c], 0.0f, 0.0f, 0.0f)};
             }
-
-            cached_instances_.push_back({model, color, alpha});
-            camera_ids_.push_back(cam->uid());
         }
 
-        // Update cache parameters
-        last_scale_ = scale;
-        last_train_color_ = train_color;
-        last_eval_color_ = eval_color;
-        last_view_position_ = view_position;
+        BufferBinder<GL_SHADER_STORAGE_BUFFER> pose_bind(pose_ssbo_);
+        upload_buffer(GL_SHADER_STORAGE_BUFFER, std::span(poses), GL_STATIC_DRAW);
+        num_poses_ = poses.size();
 
-        LOG_DEBUG("Prepared {} instances", cached_instances_.size());
+        LOG_DEBUG("Uploaded {} camera poses", num_poses_);
     }
 
-    void CameraFrustumRenderer::updateInstanceVisibility(const glm::vec3& view_position) {
-        if (camera_positions_.size() != cached_instances_.size()) {
-            LOG_WARN("Cannot update visibility: position count {} != instance count {}",
-                     camera_positions_.size(), cached_instances_.size());
-            return;
-        }
-
-        for (size_t i = 0; i < camera_positions_.size(); ++i) {
-            float distance = glm::length(camera_positions_[i] - view_position);
-            float alpha = 1.0f;
-
-            // For rendering, use aggressive fading
-            const float FADE_START_DISTANCE = 5.0f * last_scale_;
-            const float FADE_END_DISTANCE = 0.2f * last_scale_;
-            const float MINIMUM_VISIBLE_DISTANCE = 0.1f * last_scale_;
-
-            if (distance < MINIMUM_VISIBLE_DISTANCE) {
-                alpha = 0.0f;
-            } else if (distance < FADE_END_DISTANCE) {
-                alpha = 0.05f; // Very faint but still slightly visible
-            } else if (distance < FADE_START_DISTANCE) {
-                float t = (distance - FADE_END_DISTANCE) / (FADE_START_DISTANCE - FADE_END_DISTANCE);
-                alpha = 0.05f + 0.95f * (t * t * (3.0f - 2.0f * t));
-            }
+    void CameraFrustumRenderer::setCommonUniforms(ManagedShader& shader,
+                                                  const glm::mat4& view,
+                                                  const glm::mat4& projection,
+                                                  float scale,
+                                                  bool picking) {
+        const glm::vec3 view_position = glm::vec3(glm::inverse(view)[3]);
 
-            cached_instances_[i].alpha = alpha;
+        if (auto result = shader.set("viewProj", projection * view); !result) {
+            LOG_ERROR("Failed to set viewProj uniform: {}", result.error());
         }
-
-        last_view_position_ = view_position;
+        if (auto result = shader.set("viewPos", view_position); !result) {
+            LOG_ERROR("Failed to set viewPos uniform: {}", result.error());
+        }
+        if (auto result = shader.set("frustumScale", scale); !result) {
+            LOG_ERROR("Failed to set frustumScale uniform: {}", result.error());
+        }
+        if (auto result = shader.set("pickingMode", picking); !result) {
+            LOG_TRACE("pickingMode uniform not found");
+        }
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, pose_ssbo_);
     }
 
     Result<void> CameraFrustumRenderer::render(
@@ -340,36 +289,11 @@ namespace gs::rendering {
 
         LOG_TRACE("Rendering {} camera frustums", cameras.size());
 
-        // Extract view position from inverse of view matrix
-        glm::vec3 view_position = glm::vec3(glm::inverse(view)[3]);
-
-        // Prepare instance data for rendering (not picking)
-        prepareInstances(cameras, scale, train_color, eval_color, false, view_position);
-
-        if (cached_instances_.empty()) {
-            return {};
-        }
-
-        // Filter out instances with alpha = 0 for rendering
-        std::vector<InstanceData> visible_instances;
-        std::vector<int> visible_indices;
-        visible_instances.reserve(cached_instances_.size());
-        visible_indices.reserve(cached_instances_.size());
-
-        for (size_t i = 0; i < cached_instances_.size(); ++i) {
-            if (cached_instances_[i].alpha > 0.01f) { // Skip nearly invisible frustums
-                visible_instances.push_back(cached_instances_[i]);
-                visible_indices.push_back(static_cast<int>(i));
-            }
-        }
-
-        if (visible_instances.empty()) {
-            LOG_TRACE("No visible camera frustums to render");
+        uploadPoses(cameras);
+        if (num_poses_ == 0) {
             return {};
         }
 
-        LOG_TRACE("Rendering {} visible frustums out of {} total", visible_instances.size(), cached_instances_.size());
-
         // Use comprehensive state guard for entire render operation
         GLStateGuard state_guard;
 
@@ -385,36 +309,19 @@ namespace gs::rendering {
                 return std::unexpected("Failed to bind camera frustum shader");
             }
 
-            // Set uniforms while shader is bound
-            glm::mat4 view_proj = projection * view;
-
-            // Set required uniforms
-            if (auto result = shader->set("viewProj", view_proj); !result) {
-                LOG_ERROR("Failed to set viewProj uniform: {}", result.error());
-            }
-
-            if (auto result = shader->set("viewPos", view_position); !result) {
-                LOG_ERROR("Failed to set viewPos uniform: {}", result.error());
-            }
+            // Poses stay on the GPU, only these change between frames
+            setCommonUniforms(*shader, view, projection, scale, false);
 
-            // Set picking mode to false for normal rendering
-            if (auto result = shader->set("pickingMode", false); !result) {
-                LOG_TRACE("pickingMode uniform not found");
+            if (auto result = shader->set("trainColor", train_color); !result) {
+                LOG_ERROR("Failed to set trainColor uniform: {}", result.error());
             }
 
-            // Find the actual highlighted index in the visible instances
-            int visible_highlight_index = -1;
-            if (highlighted_camera_ >= 0 && highlighted_camera_ < static_cast<int>(visible_indices.size())) {
-                for (size_t i = 0; i < visible_indices.size(); ++i) {
-                    if (visible_indices[i] == highlighted_camera_) {
-                        visible_highlight_index = static_cast<int>(i);
-                        break;
-                    }
-                }
+            if (auto result = shader->set("evalColor", eval_color); !result) {
+                LOG_ERROR("Failed to set evalColor uniform: {}", result.error());
             }
 
             // Set highlight index
-            if (auto result = shader->set("highlightIndex", visible_highlight_index); !result) {
+            if (auto result = shader->set("highlightIndex", highlighted_camera_); !result) {
                 LOG_TRACE("highlightIndex uniform not found");
             }
 
@@ -426,27 +333,6 @@ namespace gs::rendering {
             {
                 VAOBinder vao_bind(vao_);
 
-                // Upload visible instance data using RAII buffer binding
-                {
-                    BufferBinder<GL_ARRAY_BUFFER> instance_bind(instance_vbo_);
-                    upload_buffer(GL_ARRAY_BUFFER, std::span(visible_instances), GL_DYNAMIC_DRAW);
-
-                    // Setup instance attributes while buffer is bound
-                    // Instance transform matrix (locations 1-4)
-                    for (int i = 0; i < 4; ++i) {
-                        glEnableVertexAttribArray(1 + i);
-                        glVertexAttribPointer(1 + i, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
-                                              reinterpret_cast<void*>(sizeof(glm::vec4) * i));
-                        glVertexAttribDivisor(1 + i, 1);
-                    }
-
-                    // Instance color and alpha (location 5) - now vec4
-                    glEnableVertexAttribArray(5);
-                    glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
-                                          reinterpret_cast<void*>(offsetof(InstanceData, color)));
-                    glVertexAttribDivisor(5, 1);
-                }
-
                 // Setup render state
                 glEnable(GL_DEPTH_TEST);
                 glDepthFunc(GL_LESS);
@@ -461,7 +347,7 @@ namespace gs::rendering {
 
                 {
                     BufferBinder<GL_ELEMENT_ARRAY_BUFFER> face_bind(face_ebo_);
-                    glDrawElementsInstanced(GL_TRIANGLES, num_face_indices_, GL_UNSIGNED_INT, 0, visible_instances.size());
+                    glDrawElementsInstanced(GL_TRIANGLES, num_face_indices_, GL_UNSIGNED_INT, 0, num_poses_);
                 }
 
                 // Check for errors after first draw
@@ -478,7 +364,7 @@ namespace gs::rendering {
 
                 {
                     BufferBinder<GL_ELEMENT_ARRAY_BUFFER> edge_bind(edge_ebo_);
-                    glDrawElementsInstanced(GL_LINES, num_edge_indices_, GL_UNSIGNED_INT, 0, visible_instances.size());
+                    glDrawElementsInstanced(GL_LINES, num_edge_indices_, GL_UNSIGNED_INT, 0, num_poses_);
                 }
 
                 // Check for errors after second draw
@@ -486,18 +372,11 @@ namespace gs::rendering {
                 if (err != GL_NO_ERROR) {
                     LOG_ERROR("OpenGL error after drawing edges: 0x{:x}", err);
                 }
-
-                // Cleanup instance attributes before VAO unbinds
-                for (int i = 1; i <= 5; ++i) {
-                    glDisableVertexAttribArray(i);
-                    if (i >= 1 && i <= 5) {
-                        glVertexAttribDivisor(i, 0);
-                    }
-                }
             } // VAOBinder automatically unbinds here
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
         } // ShaderScope automatically unbinds here
 
-        LOG_TRACE("Rendered {} camera frustums", visible_instances.size());
+        LOG_TRACE("Rendered {} camera frustums", num_poses_);
         return {};
     }
 
@@ -512,23 +391,9 @@ namespace gs::rendering {
             return -1;
         }
 
-        // Use cached instances if available, don't regenerate!
-        if (cached_instances_.empty() || camera_ids_.size() != cameras.size()) {
-            // Only regenerate if we really have to (first pick or camera count changed)
-            LOG_WARN("No cached instances for picking, regenerating");
-
-            // Extract view position for visibility calculation
-            glm::vec3 view_position = glm::vec3(glm::inverse(view)[3]);
-
-            // Use the same colors as last render to avoid visual changes
-            prepareInstances(cameras, scale, last_train_color_, last_eval_color_, false, view_position);
-
-            if (cached_instances_.empty()) {
-                LOG_ERROR("Failed to prepare instances for picking");
-                return -1;
-            }
-        } else {
-            LOG_TRACE("Using {} cached instances for picking", cached_instances_.size());
+        uploadPoses(cameras);
+        if (num_poses_ == 0) {
+            return -1;
         }
 
         // Resize picking FBO if needed
@@ -574,12 +439,7 @@ namespace gs::rendering {
                 return std::unexpected("Failed to bind picking shader");
             }
 
-            glm::mat4 view_proj = projection * view;
-            glm::vec3 view_pos = glm::vec3(glm::inverse(view)[3]);
-
-            shader->set("viewProj", view_proj);
-            shader->set("viewPos", view_pos);
-            shader->set("pickingMode", true);   // Enable picking mode
+            setCommonUniforms(*shader, view, projection, scale, true);
             shader->set("enableShading", true); // Render solid faces only
 
             // Set minimum pick distance based on scale - don't pick frustums too close
@@ -588,26 +448,6 @@ namespace gs::rendering {
 
             VAOBinder vao_bind(vao_);
 
-            // Upload instance data - USE CACHED INSTANCES
-            {
-                BufferBinder<GL_ARRAY_BUFFER> instance_bind(instance_vbo_);
-                upload_buffer(GL_ARRAY_BUFFER, std::span(cached_instances_), GL_DYNAMIC_DRAW);
-
-                // Setup instance attributes
-                for (int i = 0; i < 4; ++i) {
-                    glEnableVertexAttribArray(1 + i);
-                    glVertexAttribPointer(1 + i, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
-                                          reinterpret_cast<void*>(sizeof(glm::vec4) * i));
-                    glVertexAttribDivisor(1 + i, 1);
-                }
-
-                // Instance color and alpha (location 5) - now vec4
-                glEnableVertexAttribArray(5);
-                glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
-                                      reinterpret_cast<void*>(offsetof(InstanceData, color)));
-                glVertexAttribDivisor(5, 1);
-            }
-
             // Enable depth testing
             glEnable(GL_DEPTH_TEST);
             glDepthFunc(GL_LESS);
@@ -617,7 +457,7 @@ namespace gs::rendering {
             // Draw solid faces only for picking
             {
                 BufferBinder<GL_ELEMENT_ARRAY_BUFFER> face_bind(face_ebo_);
-                glDrawElementsInstanced(GL_TRIANGLES, num_face_indices_, GL_UNSIGNED_INT, 0, cached_instances_.size());
+                glDrawElementsInstanced(GL_TRIANGLES, num_face_indices_, GL_UNSIGNED_INT, 0, num_poses_);
             }
 
             // Check for errors
@@ -625,72 +465,65 @@ namespace gs::rendering {
             if (err != GL_NO_ERROR) {
                 LOG_ERROR("OpenGL error during picking render: 0x{:x}", err);
             }
-
-            // Cleanup attributes
-            for (int i = 1; i <= 5; ++i) {
-                glDisableVertexAttribArray(i);
-                if (i >= 1 && i <= 5) {
-                    glVertexAttribDivisor(i, 0);
-                }
-            }
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
         }
 
-        // Ensure rendering is complete before reading pixels
-        glFinish();
-
-        // Read pixel under mouse
-        // Convert mouse position relative to viewport
+        // Read the pixel under the mouse into the next free pixel buffer, resolved on a later pick
         int pixel_x = static_cast<int>(mouse_pos.x - viewport_pos.x);
         int pixel_y = static_cast<int>(viewport_size.y - (mouse_pos.y - viewport_pos.y)); // Flip Y
-
-        // Clamp to viewport bounds
         pixel_x = std::clamp(pixel_x, 0, picking_fbo_width_ - 1);
         pixel_y = std::clamp(pixel_y, 0, picking_fbo_height_ - 1);
 
-        // Read a small area around the mouse position for debugging
-        const int sample_size = 3;
-        std::vector<float> pixels(sample_size * sample_size * 3);
-        int read_x = std::max(0, pixel_x - 1);
-        int read_y = std::max(0, pixel_y - 1);
-        int read_width = std::min(sample_size, picking_fbo_width_ - read_x);
-        int read_height = std::min(sample_size, picking_fbo_height_ - read_y);
-
-        glReadPixels(read_x, read_y, read_width, read_height, GL_RGB, GL_FLOAT, pixels.data());
-
-        // Get the center pixel (or first pixel if we're at the edge)
-        int center_idx = 0;
-        if (read_width == 3 && read_height == 3) {
-            center_idx = 4 * 3; // Center of 3x3 is index 4
-        } else if (read_width >= 2 && read_height >= 2) {
-            // Try to get a center-ish pixel
-            center_idx = ((read_height / 2) * read_width + (read_width / 2)) * 3;
+        collectPickReadbacks();
+        if (auto& readback = pick_readbacks_[next_pick_slot_]; !readback.fence) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+            glReadPixels(pixel_x, pixel_y, 1, 1, GL_RGB, GL_FLOAT, nullptr);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            next_pick_slot_ = (next_pick_slot_ + 1) % PICK_READBACK_SLOTS;
+        } else {
+            LOG_TRACE("All pick readbacks in flight, skipping pick at ({}, {})", pixel_x, pixel_y);
         }
 
-        float r = pixels[center_idx];
-        float g = pixels[center_idx + 1];
-        float b = pixels[center_idx + 2];
+        // Restore previous FBO and viewport
+        glBindFramebuffer(GL_FRAMEBUFFER, current_fbo);
+        glViewport(current_viewport[0], current_viewport[1], current_viewport[2], current_viewport[3]);
 
-        // Decode ID from color
-        int id = static_cast<int>(r * 255.0f + 0.5f) << 16 |
-                 static_cast<int>(g * 255.0f + 0.5f) << 8 |
-                 static_cast<int>(b * 255.0f + 0.5f);
+        return last_picked_id_;
+    }
 
-        id -= 1; // We added 1 in the shader to avoid 0
+    void CameraFrustumRenderer::collectPickReadbacks() {
+        // Reads finish in the order they were queued, starting from the oldest one
+        for (int i = 0; i < PICK_READBACK_SLOTS; ++i) {
+            auto& readback = pick_readbacks_[(next_pick_slot_ + i) % PICK_READBACK_SLOTS];
+            if (!readback.fence) {
+                continue;
+            }
+            if (glClientWaitSync(readback.fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+                break;
+            }
+            glDeleteSync(readback.fence);
+            readback.fence = nullptr;
+
+            float rgb[3] = {0.0f, 0.0f, 0.0f};
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+            if (const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizeof(rgb), GL_MAP_READ_BIT)) {
+                std::memcpy(rgb, mapped, sizeof(rgb));
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 
-        LOG_TRACE("Picked pixel at ({}, {}): RGB({:.3f}, {:.3f}, {:.3f}) -> ID {}",
-                  pixel_x, pixel_y, r, g, b, id);
+            // Decode ID from color
+            int id = static_cast<int>(rgb[0] * 255.0f + 0.5f) << 16 |
+                     static_cast<int>(rgb[1] * 255.0f + 0.5f) << 8 |
+                     static_cast<int>(rgb[2] * 255.0f + 0.5f);
 
-        // Restore previous FBO and viewport
-        glBindFramebuffer(GL_FRAMEBUFFER, current_fbo);
-        glViewport(current_viewport[0], current_viewport[1], current_viewport[2], current_viewport[3]);
+            id -= 1; // We added 1 in the shader to avoid 0
 
-        // Return camera ID if valid
-        if (id >= 0 && id < static_cast<int>(camera_ids_.size())) {
-            LOG_TRACE("Picked camera at index {} with ID {}", id, camera_ids_[id]);
-            return camera_ids_[id];
+            last_picked_id_ = id >= 0 && id < static_cast<int>(camera_ids_.size()) ? camera_ids_[id] : -1;
+            LOG_TRACE("Pick readback: RGB({:.3f}, {:.3f}, {:.3f}) -> camera ID {}",
+                      rgb[0], rgb[1], rgb[2], last_picked_id_);
         }
-
-        return -1;
     }
 
 } // namespace gs::rendering
\ No newline at end of file
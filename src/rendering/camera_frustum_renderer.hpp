@@ -7,6 +7,7 @@
 #include "core/camera.hpp"
 #include "gl_resources.hpp"
 #include "shader_manager.hpp"
+#include <array>
 #include <glm/glm.hpp>
 #include <memory>
 #include <vector>
@@ -16,7 +17,7 @@ namespace gs::rendering {
     class CameraFrustumRenderer {
     public:
         CameraFrustumRenderer() = default;
-        ~CameraFrustumRenderer() = default;
+        ~CameraFrustumRenderer();
 
         Result<void> init();
         Result<void> render(const std::vector<std::shared_ptr<const Camera>>& cameras,
@@ -26,6 +27,8 @@ namespace gs::rendering {
                             const glm::vec3& train_color = glm::vec3(0.0f, 1.0f, 0.0f),
                             const glm::vec3& eval_color = glm::vec3(1.0f, 0.0f, 0.0f));
 
+        // Queues a read of the camera under the cursor and returns the newest one that finished,
+        // so the result lags the cursor by a frame or two but the GL pipeline never stalls
         Result<int> pickCamera(const std::vector<std::shared_ptr<const Camera>>& cameras,
                                const glm::vec2& mouse_pos,
                                const glm::vec2& viewport_pos,
@@ -42,21 +45,18 @@ namespace gs::rendering {
     private:
         Result<void> createGeometry();
         Result<void> createPickingFBO();
-        void prepareInstances(const std::vector<std::shared_ptr<const Camera>>& cameras,
-                              float scale,
-                              const glm::vec3& train_color,
-                              const glm::vec3& eval_color,
-                              bool for_picking = false,
-                              const glm::vec3& view_position = glm::vec3(0, 0, 0));
-
-        void updateInstanceVisibility(const glm::vec3& view_position);
+        void collectPickReadbacks();
+        // Uploads the cameras' poses once, until the list changes
+        void uploadPoses(const std::vector<std::shared_ptr<const Camera>>& cameras);
+        void setCommonUniforms(ManagedShader& shader, const glm::mat4& view, const glm::mat4& projection,
+                               float scale, bool picking);
 
         ManagedShader shader_;
         VAO vao_;
         VBO vbo_;
         EBO face_ebo_;
         EBO edge_ebo_;
-        VBO instance_vbo_;
+        VBO pose_ssbo_; // CameraPose per camera, the shader builds the instance transforms and fading
 
         // Picking support
         FBO picking_fbo_;
@@ -65,29 +65,31 @@ namespace gs::rendering {
         int picking_fbo_width_ = 0;
         int picking_fbo_height_ = 0;
 
+        // Pixel buffers the picked pixel is read into, each behind a fence, used round-robin
+        struct PickReadback {
+            VBO pbo;
+            GLsync fence = nullptr;
+        };
+        static constexpr int PICK_READBACK_SLOTS = 3;
+        std::array<PickReadback, PICK_READBACK_SLOTS> pick_readbacks_;
+        int next_pick_slot_ = 0;  // Also the oldest read still in flight, if any
+        int last_picked_id_ = -1; // Camera of the newest finished read
+
         // Camera tracking
-        std::vector<int> camera_ids_;
-        std::vector<glm::vec3> camera_positions_;
+        std::vector<const Camera*> uploaded_cameras_;
+        std::vector<int> camera_ids_; // Per uploaded pose
+        size_t num_poses_ = 0;
         int highlighted_camera_ = -1;
 
         size_t num_face_indices_ = 0;
         size_t num_edge_indices_ = 0;
         bool initialized_ = false;
 
-        struct InstanceData {
-            glm::mat4 transform;
-            glm::vec3 color;
-            float alpha; // Changed from padding to alpha
+        // std430 layout of the pose buffer
+        struct CameraPose {
+            glm::mat4 cam_to_world;
+            glm::vec4 info; // x: 1 for eval cameras
         };
-
-        // Cached instances to avoid regeneration during picking
-        std::vector<InstanceData> cached_instances_;
-
-        // Track when cache needs update
-        float last_scale_ = -1.0f;
-        glm::vec3 last_train_color_{-1, -1, -1};
-        glm::vec3 last_eval_color_{-1, -1, -1};
-        glm::vec3 last_view_position_{0, 0, 0};
     };
 
 } // namespace gs::rendering
\ No newline at end of file
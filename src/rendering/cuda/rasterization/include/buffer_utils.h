@@ -8,6 +8,7 @@
 #include "rasterization_config.h"
 #include <cstdint>
 #include <cub/cub.cuh>
+#include <cuda_fp16.h>
 
 namespace gs::rendering {
 
@@ -21,6 +22,13 @@ namespace gs::rendering {
         float m11, m12, m13, m22, m23, m33;
     };
 
+    // Four halves, the per-primitive record of the half precision blend: conic and opacity as
+    // (conic.x, conic.y), (conic.z, opacity), colors as (r, g), (b, 0)
+    struct __align__(8) packed_half4 {
+        __half2 xy;
+        __half2 zw;
+    };
+
     template <typename T>
     static void obtain(char*& blob, T*& ptr, std::size_t count, std::size_t alignment) {
         std::size_t offset = reinterpret_cast<std::uintptr_t>(blob) + alignment - 1 & ~(alignment - 1);
@@ -44,12 +52,15 @@ namespace gs::rendering {
         uint* offset;
         ushort4* screen_bounds;
         float2* mean2d;
-        float4* conic_opacity;
-        float3* color;
+        float4* conic_opacity = nullptr;
+        float3* color = nullptr;
+        // in place of conic_opacity and color with half_precision
+        packed_half4* conic_opacity_half = nullptr;
+        packed_half4* color_half = nullptr;
         uint* n_visible_primitives;
         uint* n_instances;
 
-        static PerPrimitiveBuffers from_blob(char*& blob, size_t n_primitives) {
+        static PerPrimitiveBuffers from_blob(char*& blob, size_t n_primitives, bool half_precision = false) {
             PerPrimitiveBuffers buffers;
             uint* depth_keys_current;
             obtain(blob, depth_keys_current, n_primitives, 128);
@@ -65,8 +76,13 @@ namespace gs::rendering {
             obtain(blob, buffers.offset, n_primitives, 128);
             obtain(blob, buffers.screen_bounds, n_primitives, 128);
             obtain(blob, buffers.mean2d, n_primitives, 128);
-            obtain(blob, buffers.conic_opacity, n_primitives, 128);
-            obtain(blob, buffers.color, n_primitives, 128);
+            if (half_precision) {
+                obtain(blob, buffers.conic_opacity_half, n_primitives, 128);
+                obtain(blob, buffers.color_half, n_primitives, 128);
+            } else {
+                obtain(blob, buffers.conic_opacity, n_primitives, 128);
+                obtain(blob, buffers.color, n_primitives, 128);
+            }
             cub::DeviceScan::ExclusiveSum(
                 nullptr, buffers.cub_workspace_size,
                 buffers.offset, buffers.offset,
@@ -84,6 +100,76 @@ namespace gs::rendering {
         }
     };
 
+    // Depth key of a primitive the forward did not find visible
+    inline constexpr uint unmarked_depth_key = 0xffffffffu;
+
+    // Primitives whose depth key is (marked) or is not (!marked) set in keys_of
+    struct DepthKeyMarked {
+        const uint* keys_of;
+        bool marked;
+
+        __host__ __device__ bool operator()(const uint primitive_idx) const {
+            return (keys_of[primitive_idx] != unmarked_depth_key) == marked;
+        }
+    };
+
+    // Depth order one forward leaves for the next, the block outlives the per-call buffers
+    struct DepthOrderBuffers {
+        size_t cub_workspace_size;
+        char* cub_workspace;
+        uint* order;      // visible primitives of the last forward, front to back
+        uint* keys_of[2]; // per primitive of the last and the current forward, alternating
+        uint* new_keys;
+        uint* new_indices;
+        uint* counts; // still visible, newly visible, order broken after the window passes
+
+        static DepthOrderBuffers from_blob(char*& blob, size_t n_primitives) {
+            DepthOrderBuffers buffers;
+            obtain(blob, buffers.order, n_primitives, 128);
+            obtain(blob, buffers.keys_of[0], n_primitives, 128);
+            obtain(blob, buffers.keys_of[1], n_primitives, 128);
+            obtain(blob, buffers.new_keys, n_primitives, 128);
+            obtain(blob, buffers.new_indices, n_primitives, 128);
+            obtain(blob, buffers.counts, 3, 128);
+            cub::DeviceSelect::If(
+                nullptr, buffers.cub_workspace_size,
+                buffers.order, buffers.new_indices, buffers.counts,
+                n_primitives, DepthKeyMarked{});
+            obtain(blob, buffers.cub_workspace, buffers.cub_workspace_size, 128);
+            return buffers;
+        }
+    };
+
+    // Max pyramid over the tile grid of the depth keys at which the tiles of a forward turned opaque,
+    // the tile level first and every further level halving it down to a single texel
+    struct OcclusionPyramid {
+        static constexpr int max_levels = 20;
+        const uint* depth_keys = nullptr; // nullptr: nothing is culled
+        uint2 sizes[max_levels];
+        uint offsets[max_levels];
+        int n_levels = 0;
+        uint n_texels = 0;
+    };
+
+    // Occlusion culling state, the pyramid comes first so it keeps its place when the primitive count changes
+    struct OcclusionBuffers {
+        uint* pyramid;
+        uint* primitive_depth_keys; // per primitive, for the blend to look up the key it turned opaque at
+        ushort4* culled_bounds;
+        uint* culled_depth_keys;
+        uint* counts; // culled primitives, culled primitives the new pyramid does not hide
+
+        static OcclusionBuffers from_blob(char*& blob, size_t n_primitives, size_t n_pyramid_texels) {
+            OcclusionBuffers buffers;
+            obtain(blob, buffers.pyramid, n_pyramid_texels, 128);
+            obtain(blob, buffers.primitive_depth_keys, n_primitives, 128);
+            obtain(blob, buffers.culled_bounds, n_primitives, 128);
+            obtain(blob, buffers.culled_depth_keys, n_primitives, 128);
+            obtain(blob, buffers.counts, 2, 128);
+            return buffers;
+        }
+    };
+
     struct PerInstanceBuffers {
         size_t cub_workspace_size;
         char* cub_workspace;
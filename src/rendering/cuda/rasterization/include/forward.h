@@ -5,11 +5,13 @@
 #pragma once
 
 #include "helper_math.h"
+#include "rasterization_api.h"
 #include <functional>
 
 namespace gs::rendering {
 
     void forward(
+        cudaStream_t stream,
         std::function<char*(size_t)> per_primitive_buffers_func,
         std::function<char*(size_t)> per_tile_buffers_func,
         std::function<char*(size_t)> per_instance_buffers_func,
@@ -32,6 +34,13 @@ namespace gs::rendering {
         const float cx,
         const float cy,
         const float near,
-        const float far);
+        const float far,
+        const CropBox* crop_box,
+        const RenderRect* render_rect,
+        const TileQuality* tile_quality,
+        const float sh_lod_pixels,
+        const bool occlusion_culling,
+        const ModelPlacements* placements,
+        const bool half_precision);
 
 }
\ No newline at end of file
@@ -7,14 +7,137 @@
 #include "buffer_utils.h"
 #include "helper_math.h"
 #include "kernel_utils.cuh"
+#include "rasterization_api.h"
 #include "rasterization_config.h"
 #include "utils.h"
 #include <cooperative_groups.h>
+#include <type_traits>
 
 namespace cg = cooperative_groups;
 
 namespace gs::rendering::kernels::forward {
 
+    // Per-primitive records of the blend in fp32 (float4 conic and opacity, float3 color) or as
+    // packed halves. Colors are clamped to non-negative on the way in or out of either.
+    __device__ inline void store_conic_opacity(float4* records, const uint idx, const float3 conic, const float opacity) {
+        records[idx] = make_float4(conic, opacity);
+    }
+
+    __device__ inline void store_conic_opacity(packed_half4* records, const uint idx, const float3 conic, const float opacity) {
+        records[idx] = packed_half4{__floats2half2_rn(conic.x, conic.y), __floats2half2_rn(conic.z, opacity)};
+    }
+
+    __device__ inline float4 load_conic_opacity(const float4* records, const uint idx) {
+        return records[idx];
+    }
+
+    __device__ inline float4 load_conic_opacity(const packed_half4* records, const uint idx) {
+        const packed_half4 record = records[idx];
+        const float2 xy = __half22float2(record.xy);
+        const float2 zw = __half22float2(record.zw);
+        return make_float4(xy.x, xy.y, zw.x, zw.y);
+    }
+
+    __device__ inline void store_color(float3* records, const uint idx, const float3 color) {
+        records[idx] = color;
+    }
+
+    __device__ inline void store_color(packed_half4* records, const uint idx, const float3 color) {
+        const float3 clamped = fmaxf(color, 0.0f);
+        records[idx] = packed_half4{__floats2half2_rn(clamped.x, clamped.y), __floats2half2_rn(clamped.z, 0.0f)};
+    }
+
+    __device__ inline float3 load_blend_color(const float3* records, const uint idx) {
+        return fmaxf(records[idx], 0.0f);
+    }
+
+    __device__ inline packed_half4 load_blend_color(const packed_half4* records, const uint idx) {
+        return records[idx];
+    }
+
+    __device__ inline float3 unpack_color(const packed_half4 color) {
+        const float2 rg = __half22float2(color.xy);
+        return make_float3(rg.x, rg.y, __low2float(color.zw));
+    }
+
+    // Exponent of the Gaussian at delta from its center, halved: 0.5 * delta^T conic delta
+    __device__ inline float gaussian_sigma_over_2(const packed_half4 conic_opacity, const float2 delta) {
+        const float2 conic_xy = __half22float2(conic_opacity.xy);
+        const float conic_z = __low2float(conic_opacity.zw);
+        return 0.5f * (conic_xy.x * delta.x * delta.x + conic_z * delta.y * delta.y) + conic_xy.y * delta.x * delta.y;
+    }
+
+    // Whether every tile of the screen bounds turned opaque in front of depth_key. A primitive behind
+    // that depth sorts after the fragment each pixel of the tile stopped at and adds nothing.
+    __device__ inline bool occluded(
+        const OcclusionPyramid& pyramid,
+        const uint4 screen_bounds,
+        const uint depth_key) {
+        uint x_min = screen_bounds.x, x_max = screen_bounds.y - 1;
+        uint y_min = screen_bounds.z, y_max = screen_bounds.w - 1;
+        // the coarsest level needed for the bounds to span at most 2x2 texels
+        int level = 0;
+        while (level + 1 < pyramid.n_levels && (x_max - x_min > 1 || y_max - y_min > 1)) {
+            x_min >>= 1;
+            x_max >>= 1;
+            y_min >>= 1;
+            y_max >>= 1;
+            ++level;
+        }
+        const uint* keys = pyramid.depth_keys + pyramid.offsets[level];
+        const uint row = pyramid.sizes[level].x;
+        const uint opaque_key = max(max(keys[y_min * row + x_min], keys[y_min * row + x_max]),
+                                    max(keys[y_max * row + x_min], keys[y_max * row + x_max]));
+        return depth_key > opaque_key;
+    }
+
+    // Drawn primitive to its placement, the last one starting at or before it. Returns the model row
+    // and points transform at the placement's world from model then model from world matrices.
+    __device__ inline uint placed_row(
+        const ModelPlacements& placements,
+        const uint drawn_idx,
+        const float*& transform) {
+        int lo = 0, hi = placements.n_placements - 1;
+        while (lo < hi) {
+            const int mid = (lo + hi + 1) >> 1;
+            if (placements.ranges[3 * mid + 2] <= drawn_idx)
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+        transform = placements.transforms + 24 * lo;
+        return placements.ranges[3 * lo] + drawn_idx - placements.ranges[3 * lo + 2];
+    }
+
+    __device__ inline float3 transform_point(const float* m, const float3& p) {
+        return make_float3(
+            m[0] * p.x + m[1] * p.y + m[2] * p.z + m[3],
+            m[4] * p.x + m[5] * p.y + m[6] * p.z + m[7],
+            m[8] * p.x + m[9] * p.y + m[10] * p.z + m[11]);
+    }
+
+    // A cov A^T with A the linear part of the row-major 3x4 m
+    __device__ inline mat3x3_triu transform_covariance(const float* m, const mat3x3_triu& cov) {
+        // rows of A cov
+        const float3 r1 = make_float3(
+            m[0] * cov.m11 + m[1] * cov.m12 + m[2] * cov.m13,
+            m[0] * cov.m12 + m[1] * cov.m22 + m[2] * cov.m23,
+            m[0] * cov.m13 + m[1] * cov.m23 + m[2] * cov.m33);
+        const float3 r2 = make_float3(
+            m[4] * cov.m11 + m[5] * cov.m12 + m[6] * cov.m13,
+            m[4] * cov.m12 + m[5] * cov.m22 + m[6] * cov.m23,
+            m[4] * cov.m13 + m[5] * cov.m23 + m[6] * cov.m33);
+        const float3 r3 = make_float3(
+            m[8] * cov.m11 + m[9] * cov.m12 + m[10] * cov.m13,
+            m[8] * cov.m12 + m[9] * cov.m22 + m[10] * cov.m23,
+            m[8] * cov.m13 + m[9] * cov.m23 + m[10] * cov.m33);
+        const float3 a1 = make_float3(m[0], m[1], m[2]);
+        const float3 a2 = make_float3(m[4], m[5], m[6]);
+        const float3 a3 = make_float3(m[8], m[9], m[10]);
+        return mat3x3_triu{dot(r1, a1), dot(r1, a2), dot(r1, a3), dot(r2, a2), dot(r2, a3), dot(r3, a3)};
+    }
+
+    template <typename ConicOpacity, typename Color>
     __global__ void preprocess_cu(
         const float3* means,
         const float3* raw_scales,
@@ -29,10 +152,15 @@ namespace gs::rendering::kernels::forward {
         uint* primitive_n_touched_tiles,
         ushort4* primitive_screen_bounds,
         float2* primitive_mean2d,
-        float4* primitive_conic_opacity,
-        float3* primitive_color,
+        ConicOpacity* primitive_conic_opacity,
+        Color* primitive_color,
         uint* n_visible_primitives,
         uint* n_instances,
+        uint* primitive_depth_key,
+        const OcclusionPyramid occlusion,
+        ushort4* culled_bounds,
+        uint* culled_depth_keys,
+        uint* n_culled,
         const uint n_primitives,
         const uint grid_width,
         const uint grid_height,
@@ -45,7 +173,13 @@ namespace gs::rendering::kernels::forward {
         const float cx,
         const float cy,
         const float near_, // near and far are macros in windowns
-        const float far_) {
+        const float far_,
+        const CropBox crop_box,
+        const bool use_crop_box,
+        const uint4 tile_rect,
+        const float* tile_quality,
+        const float sh_lod_pixels,
+        const ModelPlacements placements) {
         auto primitive_idx = cg::this_grid().thread_rank();
         bool active = true;
         if (primitive_idx >= n_primitives) {
@@ -56,8 +190,15 @@ namespace gs::rendering::kernels::forward {
         if (active)
             primitive_n_touched_tiles[primitive_idx] = 0;
 
+        // a placed primitive reads its model row and is moved to the placement's pose
+        uint source_idx = primitive_idx;
+        const float* placement = nullptr;
+        if (placements.n_placements > 0)
+            source_idx = placed_row(placements, primitive_idx, placement);
+
         // load 3d mean
-        const float3 mean3d = means[primitive_idx];
+        const float3 model_mean3d = means[source_idx];
+        const float3 mean3d = placement != nullptr ? transform_point(placement, model_mean3d) : model_mean3d;
 
         // z culling
         const float4 w2c_r3 = w2c[2];
@@ -65,20 +206,32 @@ namespace gs::rendering::kernels::forward {
         if (depth < near_ || depth > far_)
             active = false;
 
+        // crop box culling, in place of rendering a cropped copy of the model
+        if (use_crop_box) {
+            const float* m = crop_box.world_to_box;
+            const float local[3] = {m[0] * mean3d.x + m[1] * mean3d.y + m[2] * mean3d.z + m[3],
+                                    m[4] * mean3d.x + m[5] * mean3d.y + m[6] * mean3d.z + m[7],
+                                    m[8] * mean3d.x + m[9] * mean3d.y + m[10] * mean3d.z + m[11]};
+            for (int i = 0; i < 3; ++i) {
+                if (local[i] < crop_box.box_min[i] || local[i] > crop_box.box_max[i])
+                    active = false;
+            }
+        }
+
         // early exit if whole warp is inactive
         if (__ballot_sync(0xffffffffu, active) == 0)
             return;
 
         // load opacity
-        const float raw_opacity = raw_opacities[primitive_idx];
+        const float raw_opacity = raw_opacities[source_idx];
         const float opacity = 1.0f / (1.0f + expf(-raw_opacity));
         if (opacity < config::min_alpha_threshold)
             active = false;
 
         // compute 3d covariance from raw scale and rotation
-        const float3 raw_scale = raw_scales[primitive_idx];
+        const float3 raw_scale = raw_scales[source_idx];
         const float3 variance = make_float3(expf(2.0f * raw_scale.x), expf(2.0f * raw_scale.y), expf(2.0f * raw_scale.z));
-        auto [qr, qx, qy, qz] = raw_rotations[primitive_idx];
+        auto [qr, qx, qy, qz] = raw_rotations[source_idx];
         const float qrr_raw = qr * qr, qxx_raw = qx * qx, qyy_raw = qy * qy, qzz_raw = qz * qz;
         const float q_norm_sq = qrr_raw + qxx_raw + qyy_raw + qzz_raw;
         if (q_norm_sq < 1e-8f)
@@ -94,7 +247,7 @@ namespace gs::rendering::kernels::forward {
             rotation.m11 * variance.x, rotation.m12 * variance.y, rotation.m13 * variance.z,
             rotation.m21 * variance.x, rotation.m22 * variance.y, rotation.m23 * variance.z,
             rotation.m31 * variance.x, rotation.m32 * variance.y, rotation.m33 * variance.z};
-        const mat3x3_triu cov3d{
+        mat3x3_triu cov3d{
             rotation_scaled.m11 * rotation.m11 + rotation_scaled.m12 * rotation.m12 + rotation_scaled.m13 * rotation.m13,
             rotation_scaled.m11 * rotation.m21 + rotation_scaled.m12 * rotation.m22 + rotation_scaled.m13 * rotation.m23,
             rotation_scaled.m11 * rotation.m31 + rotation_scaled.m12 * rotation.m32 + rotation_scaled.m13 * rotation.m33,
@@ -102,6 +255,8 @@ namespace gs::rendering::kernels::forward {
             rotation_scaled.m21 * rotation.m31 + rotation_scaled.m22 * rotation.m32 + rotation_scaled.m23 * rotation.m33,
             rotation_scaled.m31 * rotation.m31 + rotation_scaled.m32 * rotation.m32 + rotation_scaled.m33 * rotation.m33,
         };
+        if (placement != nullptr)
+            cov3d = transform_covariance(placement, cov3d);
 
         // compute 2d mean in normalized image coordinates
         const float4 w2c_r1 = w2c[0];
@@ -160,16 +315,31 @@ namespace gs::rendering::kernels::forward {
         const float power_threshold_factor = sqrtf(2.0f * power_threshold);
         float extent_x = fmaxf(power_threshold_factor * sqrtf(cov2d.x) - 0.5f, 0.0f);
         float extent_y = fmaxf(power_threshold_factor * sqrtf(cov2d.z) - 0.5f, 0.0f);
+        // clamped to the tiles of the render rect, the full grid unless one was requested
         const uint4 screen_bounds = make_uint4(
-            min(grid_width, static_cast<uint>(max(0, __float2int_rd((mean2d.x - extent_x) / static_cast<float>(config::tile_width))))),   // x_min
-            min(grid_width, static_cast<uint>(max(0, __float2int_ru((mean2d.x + extent_x) / static_cast<float>(config::tile_width))))),   // x_max
-            min(grid_height, static_cast<uint>(max(0, __float2int_rd((mean2d.y - extent_y) / static_cast<float>(config::tile_height))))), // y_min
-            min(grid_height, static_cast<uint>(max(0, __float2int_ru((mean2d.y + extent_y) / static_cast<float>(config::tile_height)))))  // y_max
+            min(tile_rect.y, static_cast<uint>(max(static_cast<int>(tile_rect.x), __float2int_rd((mean2d.x - extent_x) / static_cast<float>(config::tile_width))))),  // x_min
+            min(tile_rect.y, static_cast<uint>(max(static_cast<int>(tile_rect.x), __float2int_ru((mean2d.x + extent_x) / static_cast<float>(config::tile_width))))),  // x_max
+            min(tile_rect.w, static_cast<uint>(max(static_cast<int>(tile_rect.z), __float2int_rd((mean2d.y - extent_y) / static_cast<float>(config::tile_height))))), // y_min
+            min(tile_rect.w, static_cast<uint>(max(static_cast<int>(tile_rect.z), __float2int_ru((mean2d.y + extent_y) / static_cast<float>(config::tile_height)))))  // y_max
         );
         const uint n_touched_tiles_max = (screen_bounds.y - screen_bounds.x) * (screen_bounds.w - screen_bounds.z);
         if (n_touched_tiles_max == 0)
             active = false;
 
+        // occlusion culling against the last forward, the culled primitives are checked against this
+        // forward's own pyramid once it is built
+        const uint depth_key = __float_as_uint(depth);
+        if (active && occlusion.depth_keys != nullptr && occluded(occlusion, screen_bounds, depth_key)) {
+            active = false;
+            const uint culled_idx = atomicAdd(n_culled, 1);
+            culled_bounds[culled_idx] = make_ushort4(
+                static_cast<ushort>(screen_bounds.x),
+                static_cast<ushort>(screen_bounds.y),
+                static_cast<ushort>(screen_bounds.z),
+                static_cast<ushort>(screen_bounds.w));
+            culled_depth_keys[culled_idx] = depth_key;
+        }
+
         // early exit if whole warp is inactive
         if (__ballot_sync(0xffffffffu, active) == 0)
             return;
@@ -191,15 +361,39 @@ namespace gs::rendering::kernels::forward {
             static_cast<ushort>(screen_bounds.z),
             static_cast<ushort>(screen_bounds.w));
         primitive_mean2d[primitive_idx] = mean2d;
-        primitive_conic_opacity[primitive_idx] = make_float4(conic, opacity);
-        primitive_color[primitive_idx] = convert_sh_to_color(
-            sh_coefficients_0, sh_coefficients_rest,
-            mean3d, cam_position[0],
-            primitive_idx, active_sh_bases, total_bases_sh_rest);
+        store_conic_opacity(primitive_conic_opacity, primitive_idx, conic, opacity);
+
+        // lower quality tiles evaluate fewer sh bands for the primitives centered in them
+        uint sh_bases = active_sh_bases;
+        if (tile_quality != nullptr && active_sh_bases > 1) {
+            const uint tile_x = min(static_cast<uint>(max(__float2int_rd(mean2d.x / static_cast<float>(config::tile_width)), 0)), grid_width - 1);
+            const uint tile_y = min(static_cast<uint>(max(__float2int_rd(mean2d.y / static_cast<float>(config::tile_height)), 0)), grid_height - 1);
+            const float quality = tile_quality[tile_y * grid_width + tile_x];
+            const int sh_degree = __float2int_rn(quality * (sqrtf(static_cast<float>(active_sh_bases)) - 1.0f));
+            sh_bases = static_cast<uint>((sh_degree + 1) * (sh_degree + 1));
+        }
+        // view-dependent color is invisible on small splats, every doubling of the screen radius
+        // past sh_lod_pixels allows one more band
+        if (sh_lod_pixels > 0.0f && sh_bases > 1) {
+            const float radius = fmaxf(extent_x, extent_y) + 0.5f;
+            const int lod_degree = radius < sh_lod_pixels ? 0 : radius < 2.0f * sh_lod_pixels ? 1
+                                                            : radius < 4.0f * sh_lod_pixels ? 2
+                                                                                            : 3;
+            const int sh_degree = min(__float2int_rn(sqrtf(static_cast<float>(sh_bases))) - 1, lod_degree);
+            sh_bases = static_cast<uint>((sh_degree + 1) * (sh_degree + 1));
+        }
+        // view directions of a placed primitive are taken in model space, where its coefficients live
+        const float3 sh_cam_position = placement != nullptr ? transform_point(placement + 12, cam_position[0]) : cam_position[0];
+        store_color(primitive_color, primitive_idx,
+                    convert_sh_to_color(
+                        sh_coefficients_0, sh_coefficients_rest,
+                        model_mean3d, sh_cam_position,
+                        source_idx, sh_bases, total_bases_sh_rest));
 
         const uint offset = atomicAdd(n_visible_primitives, 1);
-        const uint depth_key = __float_as_uint(depth);
         primitive_depth_keys[offset] = depth_key;
+        if (primitive_depth_key != nullptr)
+            primitive_depth_key[primitive_idx] = depth_key;
         primitive_indices[offset] = primitive_idx;
         atomicAdd(n_instances, n_touched_tiles);
     }
@@ -216,13 +410,111 @@ namespace gs::rendering::kernels::forward {
         primitive_offset[idx] = primitive_n_touched_tiles[primitive_idx];
     }
 
+    __global__ void scatter_depth_keys_cu(
+        const uint* primitive_depth_keys,
+        const uint* primitive_indices,
+        uint* keys_of,
+        const uint n_visible_primitives) {
+        auto idx = cg::this_grid().thread_rank();
+        if (idx >= n_visible_primitives)
+            return;
+        keys_of[primitive_indices[idx]] = primitive_depth_keys[idx];
+    }
+
+    __global__ void gather_depth_keys_cu(
+        const uint* primitive_indices,
+        const uint* keys_of,
+        uint* primitive_depth_keys,
+        const uint* n_items_ptr,
+        const uint n_max_items) {
+        auto idx = cg::this_grid().thread_rank();
+        if (idx >= min(*n_items_ptr, n_max_items))
+            return;
+        primitive_depth_keys[idx] = keys_of[primitive_indices[idx]];
+    }
+
+    // One block sorts the window of depth_window_size keys starting at window_offset + its index times the size
+    __global__ void __launch_bounds__(config::block_size_depth_window) sort_depth_window_cu(
+        uint* primitive_depth_keys,
+        uint* primitive_indices,
+        const uint* n_items_ptr,
+        const uint window_offset) {
+        using BlockSort = cub::BlockRadixSort<uint, config::block_size_depth_window, config::depth_window_items, uint>;
+        __shared__ typename BlockSort::TempStorage sort_storage;
+        const uint n_items = *n_items_ptr;
+        const uint window_start = window_offset + blockIdx.x * config::depth_window_size;
+        if (window_start >= n_items)
+            return;
+
+        // the window is sorted as a whole, so the keys can come in striped and unmarked ones sort last
+        uint keys[config::depth_window_items];
+        uint indices[config::depth_window_items];
+#pragma unroll
+        for (int i = 0; i < config::depth_window_items; ++i) {
+            const uint idx = window_start + i * config::block_size_depth_window + threadIdx.x;
+            keys[i] = idx < n_items ? primitive_depth_keys[idx] : unmarked_depth_key;
+            indices[i] = idx < n_items ? primitive_indices[idx] : 0;
+        }
+        BlockSort(sort_storage).SortBlockedToStriped(keys, indices);
+#pragma unroll
+        for (int i = 0; i < config::depth_window_items; ++i) {
+            const uint idx = window_start + i * config::block_size_depth_window + threadIdx.x;
+            if (idx < n_items) {
+                primitive_depth_keys[idx] = keys[i];
+                primitive_indices[idx] = indices[i];
+            }
+        }
+    }
+
+    __global__ void detect_depth_order_break_cu(
+        const uint* primitive_depth_keys,
+        const uint* n_items_ptr,
+        const uint n_max_items,
+        uint* order_broken) {
+        auto idx = cg::this_grid().thread_rank();
+        if (idx + 1 >= min(*n_items_ptr, n_max_items))
+            return;
+        if (primitive_depth_keys[idx] > primitive_depth_keys[idx + 1])
+            *order_broken = 1;
+    }
+
+    // Both inputs sorted, ties put a before b
+    __global__ void merge_depth_orders_cu(
+        const uint* keys_a,
+        const uint* indices_a,
+        const uint n_a,
+        const uint* keys_b,
+        const uint* indices_b,
+        const uint n_b,
+        uint* primitive_indices_merged) {
+        auto idx = cg::this_grid().thread_rank();
+        if (idx >= n_a + n_b)
+            return;
+        const bool from_a = idx < n_a;
+        const uint own = from_a ? idx : idx - n_a;
+        const uint key = from_a ? keys_a[own] : keys_b[own];
+        const uint* other_keys = from_a ? keys_b : keys_a;
+        // entries of the other input in front of this one: lower bound in b, upper bound in a
+        uint lo = 0;
+        uint hi = from_a ? n_b : n_a;
+        while (lo < hi) {
+            const uint mid = (lo + hi) >> 1;
+            if (from_a ? other_keys[mid] < key : other_keys[mid] <= key)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        primitive_indices_merged[own + lo] = from_a ? indices_a[own] : indices_b[own];
+    }
+
     // based on https://github.com/r4dl/StopThePop-Rasterization/blob/d8cad09919ff49b11be3d693d1e71fa792f559bb/cuda_rasterizer/stopthepop/stopthepop_common.cuh#L325
+    template <typename ConicOpacity>
     __global__ void create_instances_cu(
         const uint* primitive_indices_sorted,
         const uint* primitive_offsets,
         const ushort4* primitive_screen_bounds,
         const float2* primitive_mean2d,
-        const float4* primitive_conic_opacity,
+        const ConicOpacity* primitive_conic_opacity,
         ushort* instance_keys,
         uint* instance_primitive_indices,
         const uint grid_width,
@@ -251,7 +543,7 @@ namespace gs::rendering::kernels::forward {
         __shared__ float4 collected_conic_opacity[config::block_size_create_instances];
         collected_screen_bounds[block.thread_rank()] = screen_bounds;
         collected_mean2d_shifted[block.thread_rank()] = primitive_mean2d[primitive_idx] - 0.5f;
-        collected_conic_opacity[block.thread_rank()] = primitive_conic_opacity[primitive_idx];
+        collected_conic_opacity[block.thread_rank()] = load_conic_opacity(primitive_conic_opacity, primitive_idx);
 
         uint current_write_offset = primitive_offsets[idx];
 
@@ -353,37 +645,80 @@ namespace gs::rendering::kernels::forward {
         tile_n_buckets[tile_idx] = n_buckets;
     }
 
+    // With packed_half4 records the tile's shared memory batch is two thirds the size and two
+    // fragments are evaluated per step, their exponentials and alphas in one half2 op each.
+    // Transmittance and color still accumulate in fp32 and in depth order.
+    template <typename ConicOpacity, typename Color>
     __global__ void __launch_bounds__(config::block_size_blend) blend_cu(
         const uint2* tile_instance_ranges,
         const uint* instance_primitive_indices,
         const float2* primitive_mean2d,
-        const float4* primitive_conic_opacity,
-        const float3* primitive_color,
+        const ConicOpacity* primitive_conic_opacity,
+        const Color* primitive_color,
         float* image,
         float* alpha_map,
         const uint width,
         const uint height,
-        const uint grid_width) {
+        const uint grid_width,
+        const TileQuality tile_quality,
+        const uint* primitive_depth_key,
+        uint* tile_opaque_depth_keys) {
         auto block = cg::this_thread_block();
         const dim3 group_index = block.group_index();
         const dim3 thread_index = block.thread_index();
         const uint thread_rank = block.thread_rank();
-        const uint2 pixel_coords = make_uint2(group_index.x * config::tile_width + thread_index.x, group_index.y * config::tile_height + thread_index.y);
-        const bool inside = pixel_coords.x < width && pixel_coords.y < height;
-        const float2 pixel = make_float2(__uint2float_rn(pixel_coords.x), __uint2float_rn(pixel_coords.y)) + 0.5f;
-
         const uint tile_idx = group_index.y * grid_width + group_index.x;
+
+        // the fragment threshold rises towards lower quality, coarse tiles shade the centers of
+        // their 2x2 quads on the first quarter of the threads
+        const float quality = tile_quality.quality != nullptr ? tile_quality.quality[tile_idx] : 1.0f;
+        const float min_alpha = config::min_alpha_threshold + (1.0f - quality) * (tile_quality.min_alpha - config::min_alpha_threshold);
+        const bool coarse = quality < tile_quality.coarse_below;
+        uint2 pixel_coords;
+        float2 pixel;
+        bool inside;
+        if (coarse) {
+            constexpr uint quads_per_row = config::tile_width / 2;
+            pixel_coords = make_uint2(group_index.x * config::tile_width + 2 * (thread_rank % quads_per_row), group_index.y * config::tile_height + 2 * (thread_rank / quads_per_row));
+            pixel = make_float2(__uint2float_rn(pixel_coords.x), __uint2float_rn(pixel_coords.y)) + 1.0f;
+            inside = thread_rank < config::block_size_blend / 4 && pixel_coords.x < width && pixel_coords.y < height;
+        } else {
+            pixel_coords = make_uint2(group_index.x * config::tile_width + thread_index.x, group_index.y * config::tile_height + thread_index.y);
+            pixel = make_float2(__uint2float_rn(pixel_coords.x), __uint2float_rn(pixel_coords.y)) + 0.5f;
+            inside = pixel_coords.x < width && pixel_coords.y < height;
+        }
+
         const uint2 tile_range = tile_instance_ranges[tile_idx];
         const int n_points_total = tile_range.y - tile_range.x;
 
         // setup shared memory
         __shared__ float2 collected_mean2d[config::block_size_blend];
-        __shared__ float4 collected_conic_opacity[config::block_size_blend];
-        __shared__ float3 collected_color[config::block_size_blend];
+        __shared__ ConicOpacity collected_conic_opacity[config::block_size_blend];
+        __shared__ Color collected_color[config::block_size_blend];
         // initialize local storage
         float3 color_pixel = make_float3(0.0f);
         float transmittance = 1.0f;
         bool done = !inside;
+        // depth key of the fragment the pixel turned opaque at, everything behind it could still show otherwise
+        uint opaque_depth_key = inside ? unmarked_depth_key : 0;
+        // fragment j of the current batch, sorted front to back
+        int batch_start = 0;
+        const auto composite = [&](const int j, const float sigma_over_2, const float fragment_alpha, const float3 color) {
+            if (sigma_over_2 < 0.0f)
+                return;
+            const float alpha = fminf(fragment_alpha, config::max_fragment_alpha);
+            if (alpha < min_alpha)
+                return;
+            const float next_transmittance = transmittance * (1.0f - alpha);
+            if (next_transmittance < config::transmittance_threshold) {
+                done = true;
+                if (tile_opaque_depth_keys != nullptr)
+                    opaque_depth_key = primitive_depth_key[instance_primitive_indices[batch_start + j]];
+                return;
+            }
+            color_pixel += transmittance * alpha * color;
+            transmittance = next_transmittance;
+        };
         // collaborative loading and processing
         for (int n_points_remaining = n_points_total, current_fetch_idx = tile_range.x + thread_rank; n_points_remaining > 0; n_points_remaining -= config::block_size_blend, current_fetch_idx += config::block_size_blend) {
             if (__syncthreads_count(done) == config::block_size_blend)
@@ -392,41 +727,94 @@ namespace gs::rendering::kernels::forward {
                 const uint primitive_idx = instance_primitive_indices[current_fetch_idx];
                 collected_mean2d[thread_rank] = primitive_mean2d[primitive_idx];
                 collected_conic_opacity[thread_rank] = primitive_conic_opacity[primitive_idx];
-                const float3 color = fmaxf(primitive_color[primitive_idx], 0.0f);
-                collected_color[thread_rank] = color;
+                collected_color[thread_rank] = load_blend_color(primitive_color, primitive_idx);
             }
             block.sync();
+            batch_start = current_fetch_idx - thread_rank;
             const int current_batch_size = min(config::block_size_blend, n_points_remaining);
-            for (int j = 0; !done && j < current_batch_size; ++j) {
-                const float4 conic_opacity = collected_conic_opacity[j];
-                const float3 conic = make_float3(conic_opacity);
-                const float2 delta = collected_mean2d[j] - pixel;
-                const float opacity = conic_opacity.w;
-                const float sigma_over_2 = 0.5f * (conic.x * delta.x * delta.x + conic.z * delta.y * delta.y) + conic.y * delta.x * delta.y;
-                if (sigma_over_2 < 0.0f)
-                    continue;
-                const float gaussian = expf(-sigma_over_2);
-                const float alpha = fminf(opacity * gaussian, config::max_fragment_alpha);
-                if (alpha < config::min_alpha_threshold)
-                    continue;
-                const float next_transmittance = transmittance * (1.0f - alpha);
-                if (next_transmittance < config::transmittance_threshold) {
-                    done = true;
-                    continue;
+            if constexpr (std::is_same_v<ConicOpacity, packed_half4>) {
+                for (int j = 0; !done && j < current_batch_size; j += 2) {
+                    // an odd batch pairs its last fragment with itself and drops the copy
+                    const int k = min(j + 1, current_batch_size - 1);
+                    const packed_half4 conic_opacity_j = collected_conic_opacity[j];
+                    const packed_half4 conic_opacity_k = collected_conic_opacity[k];
+                    const float sigma_over_2_j = gaussian_sigma_over_2(conic_opacity_j, collected_mean2d[j] - pixel);
+                    const float sigma_over_2_k = gaussian_sigma_over_2(conic_opacity_k, collected_mean2d[k] - pixel);
+                    const __half2 gaussians = h2exp(__floats2half2_rn(-sigma_over_2_j, -sigma_over_2_k));
+                    const float2 alphas = __half22float2(__hmul2(__highs2half2(conic_opacity_j.zw, conic_opacity_k.zw), gaussians));
+                    composite(j, sigma_over_2_j, alphas.x, unpack_color(collected_color[j]));
+                    if (k != j && !done)
+                        composite(k, sigma_over_2_k, alphas.y, unpack_color(collected_color[k]));
+                }
+            } else {
+                for (int j = 0; !done && j < current_batch_size; ++j) {
+                    const float4 conic_opacity = collected_conic_opacity[j];
+                    const float3 conic = make_float3(conic_opacity);
+                    const float2 delta = collected_mean2d[j] - pixel;
+                    const float opacity = conic_opacity.w;
+                    const float sigma_over_2 = 0.5f * (conic.x * delta.x * delta.x + conic.z * delta.y * delta.y) + conic.y * delta.x * delta.y;
+                    composite(j, sigma_over_2, opacity * expf(-sigma_over_2), collected_color[j]);
                 }
-                color_pixel += transmittance * alpha * collected_color[j];
-                transmittance = next_transmittance;
             }
         }
         if (inside) {
-            const int pixel_idx = width * pixel_coords.y + pixel_coords.x;
             const int n_pixels = width * height;
-            // store results
-            image[pixel_idx] = color_pixel.x;
-            image[pixel_idx + n_pixels] = color_pixel.y;
-            image[pixel_idx + n_pixels * 2] = color_pixel.z;
-            alpha_map[pixel_idx] = 1.0f - transmittance;
+            const uint span = coarse ? 2 : 1;
+            // store results, a coarse thread fills its whole quad
+            for (uint dy = 0; dy < span; ++dy) {
+                for (uint dx = 0; dx < span; ++dx) {
+                    const uint x = pixel_coords.x + dx;
+                    const uint y = pixel_coords.y + dy;
+                    if (x >= width || y >= height)
+                        continue;
+                    const int pixel_idx = width * y + x;
+                    image[pixel_idx] = color_pixel.x;
+                    image[pixel_idx + n_pixels] = color_pixel.y;
+                    image[pixel_idx + n_pixels * 2] = color_pixel.z;
+                    alpha_map[pixel_idx] = 1.0f - transmittance;
+                }
+            }
         }
+        if (tile_opaque_depth_keys != nullptr) {
+            __shared__ uint tile_opaque_depth_key;
+            if (thread_rank == 0)
+                tile_opaque_depth_key = 0;
+            block.sync();
+            atomicMax(&tile_opaque_depth_key, opaque_depth_key);
+            block.sync();
+            if (thread_rank == 0)
+                tile_opaque_depth_keys[tile_idx] = tile_opaque_depth_key;
+        }
+    }
+
+    __global__ void build_occlusion_level_cu(
+        const uint* finer_keys,
+        const uint2 finer_size,
+        uint* coarser_keys,
+        const uint2 coarser_size) {
+        auto idx = cg::this_grid().thread_rank();
+        if (idx >= coarser_size.x * coarser_size.y)
+            return;
+        const uint x = 2 * (idx % coarser_size.x);
+        const uint y = 2 * (idx / coarser_size.x);
+        const uint x_next = min(x + 1, finer_size.x - 1);
+        const uint y_next = min(y + 1, finer_size.y - 1);
+        coarser_keys[idx] = max(max(finer_keys[y * finer_size.x + x], finer_keys[y * finer_size.x + x_next]),
+                                max(finer_keys[y_next * finer_size.x + x], finer_keys[y_next * finer_size.x + x_next]));
+    }
+
+    __global__ void detect_disocclusion_cu(
+        const ushort4* culled_bounds,
+        const uint* culled_depth_keys,
+        const uint n_culled,
+        const OcclusionPyramid pyramid,
+        uint* n_disoccluded) {
+        auto idx = cg::this_grid().thread_rank();
+        if (idx >= n_culled)
+            return;
+        const ushort4 bounds = culled_bounds[idx];
+        if (!occluded(pyramid, make_uint4(bounds.x, bounds.y, bounds.z, bounds.w), culled_depth_keys[idx]))
+            atomicAdd(n_disoccluded, 1);
     }
 
 } // namespace gs::rendering::kernels::forward
\ No newline at end of file
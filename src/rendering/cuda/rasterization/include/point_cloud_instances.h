@@ -0,0 +1,23 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <cuda_runtime.h>
+#include <torch/torch.h>
+
+namespace gs::rendering {
+
+    // Writes the point cloud instance records, position xyz then the SH DC color rgb clamped to
+    // [0, 1], for means [N, 3], sh0 [N, 1, 3] and opacity [N, 1] (logits) into instances
+    // (N * 6 floats, device memory). Gaussians the splat rasterizer would cull for their opacity
+    // get a NaN position, which drops them from the draw.
+    void fill_point_cloud_instances(
+        const torch::Tensor& means,
+        const torch::Tensor& sh0,
+        const torch::Tensor& opacity,
+        float* instances,
+        cudaStream_t stream);
+
+} // namespace gs::rendering
@@ -9,6 +9,52 @@
 
 namespace gs::rendering {
 
+    // Oriented box the preprocess culls against, Gaussians whose mean lies outside are skipped
+    struct CropBox {
+        float world_to_box[12]; // Row-major 3x4
+        float box_min[3];
+        float box_max[3];
+    };
+
+    // Pixel rectangle of the image to rasterize, the tiles outside it are left empty
+    struct RenderRect {
+        int x, y;
+        int width, height;
+    };
+
+    // Size of the tiles a TileQuality map has one value for
+    inline constexpr int quality_tile_size = 16;
+
+    // Per-tile quality, e.g. for foveated displays: one value in [0, 1] per tile, row-major over
+    // the tile grid in CUDA memory. Below 1, Gaussians centered in a tile evaluate fewer SH bands
+    // and the tile skips fragments fainter than its threshold, which falls from the default at
+    // quality 1 to min_alpha at 0. Tiles below coarse_below shade one pixel per 2x2 quad.
+    struct TileQuality {
+        const float* quality = nullptr;
+        float min_alpha = 1.0f / 32.0f;
+        float coarse_below = 0.5f;
+    };
+
+    // Copies of model rows drawn at poses of their own, e.g. one asset placed many times, without
+    // copying its Gaussians. Placement k draws rows [first_row, first_row + row_count) of the model at
+    // drawn indices from first_drawn on, the placements ordered by first_drawn. Only the placed rows
+    // are drawn.
+    struct ModelPlacements {
+        const float* transforms = nullptr; // [K, 24] CUDA: world from model then model from world, row-major 3x4
+        const uint32_t* ranges = nullptr;  // [K, 3] CUDA: first_row, row_count, first_drawn
+        int n_placements = 0;
+        int n_drawn = 0; // Rows drawn over all placements
+    };
+
+    // sh_lod_pixels > 0 picks the SH degree per Gaussian from its screen radius: degree 0 below
+    // sh_lod_pixels, then one more band per doubling up to the active degree. 0 evaluates the
+    // active degree everywhere.
+    // occlusion_culling skips the Gaussians behind the tiles the last such forward on this thread saw
+    // turn opaque. A frame it culled wrongly for, e.g. after the camera moved, is rendered again
+    // without culling, so the image never differs from an unculled one.
+    // placements draws the model rows at their poses in place of every row once.
+    // half_precision keeps the conic, opacity and color of each primitive in fp16 and blends two
+    // fragments per step with half2 math. Inference only, the colors differ in the last bits.
     std::tuple<torch::Tensor, torch::Tensor>
     forward_wrapper(
         const torch::Tensor& means,
@@ -27,5 +73,12 @@ namespace gs::rendering {
         const float center_x,
         const float center_y,
         const float near_plane,
-        const float far_plane);
+        const float far_plane,
+        const CropBox* crop_box = nullptr,
+        const RenderRect* render_rect = nullptr,
+        const TileQuality* tile_quality = nullptr,
+        const float sh_lod_pixels = 0.0f,
+        const bool occlusion_culling = false,
+        const ModelPlacements* placements = nullptr,
+        const bool half_precision = false);
 } // namespace gs::rendering
@@ -27,6 +27,16 @@ namespace gs::rendering::config {
     DEF int tile_height = 16;
     DEF int block_size_blend = tile_width * tile_height;
     DEF int n_sequential_threshold = 4;
+    // depth sort: a forward starts from the order the previous one on the same thread left and sorts it
+    // in windows, every other pass shifted by half a window. Only an order still broken after the passes
+    // takes the full radix sort. 0 passes: full radix sort every forward.
+    DEF int depth_window_passes = 3;
+    DEF int block_size_depth_window = 256;
+    DEF int depth_window_items = 8;
+    DEF int depth_window_size = block_size_depth_window * depth_window_items;
+    // occlusion culling: forwards that cull nothing after one whose culling proved wrong and that rendered again
+    DEF int occlusion_culling_backoff = 8;
+    DEF int block_size_occlusion = 256;
 } // namespace gs::rendering::config
 
 namespace config = gs::rendering::config;
@@ -0,0 +1,25 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <cuda_runtime.h>
+#include <torch/torch.h>
+
+namespace gs::rendering {
+
+    struct DisplayTransform {
+        bool tonemap = false; // Reinhard, x / (1 + x), for values above 1
+        bool srgb = false;    // Encode linear values with the sRGB transfer function
+    };
+
+    // Writes image [H, W, C] (C = 3 or 4, float32 in [0, 1] or uint8, any strides, so a permuted
+    // CHW view works as is) into an RGBA8 surface; alpha is 255 for 3 channels
+    void write_rgba8_surface(
+        const torch::Tensor& image,
+        cudaSurfaceObject_t surface,
+        const DisplayTransform& transform,
+        cudaStream_t stream);
+
+} // namespace gs::rendering
@@ -8,11 +8,209 @@
 #include "kernels_forward.cuh"
 #include "rasterization_config.h"
 #include "utils.h"
+#include <algorithm>
 #include <cub/cub.cuh>
 #include <functional>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+    // Device memory one forward leaves for the next on the same thread
+    struct KeptBlob {
+        char* data = nullptr;
+        size_t capacity = 0;
+
+        ~KeptBlob() {
+            if (data)
+                cudaFree(data);
+        }
+
+        // true when the block had to grow and the kept contents are gone
+        bool reserve(const size_t bytes, const char* what) {
+            if (bytes <= capacity)
+                return false;
+            if (data)
+                cudaFree(data);
+            if (const cudaError_t ret = cudaMalloc(&data, bytes); ret != cudaSuccess) {
+                data = nullptr;
+                capacity = 0;
+                throw std::runtime_error("Failed to allocate " + std::to_string(bytes) + " bytes for the " + what + ": " + cudaGetErrorString(ret));
+            }
+            capacity = bytes;
+            return true;
+        }
+    };
+
+    // Depth order the last forward on this thread left behind. The viewer renders from its render
+    // thread and now and then from the GUI thread, each keeps its own.
+    struct PreviousDepthOrder {
+        KeptBlob blob;
+        int n_primitives = -1; // the order belongs to no model yet
+        int n_visible = 0;
+        int current = 0; // keys_of slot of the last forward
+
+        gs::rendering::DepthOrderBuffers buffers(const int n) {
+            if (blob.reserve(gs::rendering::required<gs::rendering::DepthOrderBuffers>(n), "depth order"))
+                n_primitives = -1;
+            char* data = blob.data;
+            return gs::rendering::DepthOrderBuffers::from_blob(data, n);
+        }
+    };
+
+    thread_local PreviousDepthOrder previous_depth_order;
+
+    // Opaque depth pyramid of the last forward with occlusion culling on this thread
+    struct OcclusionState {
+        KeptBlob blob;
+        uint2 grid = make_uint2(0, 0); // tile grid the pyramid belongs to, none yet
+        int skip_culling = 0;          // forwards left that cull nothing
+
+        gs::rendering::OcclusionBuffers buffers(const int n_primitives, const gs::rendering::OcclusionPyramid& layout) {
+            if (blob.reserve(gs::rendering::required<gs::rendering::OcclusionBuffers>(n_primitives, layout.n_texels), "occlusion pyramid"))
+                grid = make_uint2(0, 0);
+            char* data = blob.data;
+            return gs::rendering::OcclusionBuffers::from_blob(data, n_primitives, layout.n_texels);
+        }
+    };
+
+    thread_local OcclusionState occlusion_state;
+
+    gs::rendering::OcclusionPyramid occlusion_pyramid_layout(const uint grid_width, const uint grid_height) {
+        gs::rendering::OcclusionPyramid pyramid;
+        uint2 size = make_uint2(grid_width, grid_height);
+        while (pyramid.n_levels < gs::rendering::OcclusionPyramid::max_levels) {
+            pyramid.sizes[pyramid.n_levels] = size;
+            pyramid.offsets[pyramid.n_levels] = pyramid.n_texels;
+            pyramid.n_texels += size.x * size.y;
+            ++pyramid.n_levels;
+            if (size.x == 1 && size.y == 1)
+                break;
+            size = make_uint2(div_round_up(size.x, 2u), div_round_up(size.y, 2u));
+        }
+        return pyramid;
+    }
+
+    // Front to back order of the visible primitives. Those visible in the last forward too keep their
+    // order and a few window passes fix what the camera motion swapped. The newly visible ones are
+    // radix sorted on their own and merged in. An order the window passes could not fix makes the
+    // whole visible set take the radix sort instead.
+    const uint* sort_by_depth(
+        cudaStream_t stream,
+        gs::rendering::PerPrimitiveBuffers& per_primitive_buffers,
+        const int n_primitives,
+        const int n_visible_primitives) {
+        using namespace gs::rendering;
+        PreviousDepthOrder& previous = previous_depth_order;
+        DepthOrderBuffers order_buffers = previous.buffers(n_primitives);
+        if (previous.n_primitives != n_primitives) {
+            previous.n_visible = 0;
+            cudaMemsetAsync(order_buffers.keys_of[previous.current], 0xff, sizeof(uint) * n_primitives, stream);
+        }
+        const int current = previous.current ^ 1;
+        uint* keys_of = order_buffers.keys_of[current];
+        uint* kept_keys = per_primitive_buffers.depth_keys.Alternate();
+        uint* kept_indices = per_primitive_buffers.primitive_indices.Alternate();
+
+        cudaMemsetAsync(keys_of, 0xff, sizeof(uint) * n_primitives, stream);
+        cudaMemsetAsync(order_buffers.counts, 0, sizeof(uint) * 3, stream);
+        if (n_visible_primitives > 0) {
+            kernels::forward::scatter_depth_keys_cu<<<div_round_up(n_visible_primitives, config::block_size_apply_depth_ordering), config::block_size_apply_depth_ordering, 0, stream>>>(
+                per_primitive_buffers.depth_keys.Current(),
+                per_primitive_buffers.primitive_indices.Current(),
+                keys_of,
+                n_visible_primitives);
+            CHECK_CUDA(config::debug, "scatter_depth_keys")
+        }
+        // empty inputs keep the zero counts
+        if (previous.n_visible > 0) {
+            cub::DeviceSelect::If(
+                order_buffers.cub_workspace, order_buffers.cub_workspace_size,
+                order_buffers.order, kept_indices, order_buffers.counts + 0,
+                previous.n_visible, DepthKeyMarked{keys_of, true}, stream);
+            CHECK_CUDA(config::debug, "cub::DeviceSelect::If (Kept Primitives)")
+        }
+        if (n_visible_primitives > 0) {
+            cub::DeviceSelect::If(
+                order_buffers.cub_workspace, order_buffers.cub_workspace_size,
+                per_primitive_buffers.primitive_indices.Current(), order_buffers.new_indices, order_buffers.counts + 1,
+                n_visible_primitives, DepthKeyMarked{order_buffers.keys_of[previous.current], false}, stream);
+            CHECK_CUDA(config::debug, "cub::DeviceSelect::If (New Primitives)")
+        }
+
+        // the kept count is only known on the device, the previous visible count bounds it
+        const int max_kept = std::min(previous.n_visible, n_visible_primitives);
+        if (max_kept > 0) {
+            kernels::forward::gather_depth_keys_cu<<<div_round_up(max_kept, config::block_size_apply_depth_ordering), config::block_size_apply_depth_ordering, 0, stream>>>(
+                kept_indices, keys_of, kept_keys, order_buffers.counts + 0, max_kept);
+            CHECK_CUDA(config::debug, "gather_depth_keys (Kept Primitives)")
+            for (int pass = 0; pass < config::depth_window_passes; ++pass) {
+                const int window_offset = pass % 2 == 0 ? 0 : config::depth_window_size / 2;
+                if (max_kept <= window_offset)
+                    break;
+                kernels::forward::sort_depth_window_cu<<<div_round_up(max_kept - window_offset, config::depth_window_size), config::block_size_depth_window, 0, stream>>>(
+                    kept_keys, kept_indices, order_buffers.counts + 0, window_offset);
+                CHECK_CUDA(config::debug, "sort_depth_window")
+            }
+            kernels::forward::detect_depth_order_break_cu<<<div_round_up(max_kept, config::block_size_apply_depth_ordering), config::block_size_apply_depth_ordering, 0, stream>>>(
+                kept_keys, order_buffers.counts + 0, max_kept, order_buffers.counts + 2);
+            CHECK_CUDA(config::debug, "detect_depth_order_break")
+        }
+        if (n_visible_primitives > 0) {
+            kernels::forward::gather_depth_keys_cu<<<div_round_up(n_visible_primitives, config::block_size_apply_depth_ordering), config::block_size_apply_depth_ordering, 0, stream>>>(
+                order_buffers.new_indices, keys_of, order_buffers.new_keys, order_buffers.counts + 1, n_visible_primitives);
+            CHECK_CUDA(config::debug, "gather_depth_keys (New Primitives)")
+        }
+
+        uint counts[3];
+        cudaMemcpyAsync(counts, order_buffers.counts, sizeof(uint) * 3, cudaMemcpyDeviceToHost, stream);
+        cudaStreamSynchronize(stream);
+        const int n_kept = static_cast<int>(counts[0]);
+        const int n_new = static_cast<int>(counts[1]);
+
+        previous.n_primitives = n_primitives;
+        previous.n_visible = n_visible_primitives;
+        previous.current = current;
+
+        if (counts[2] != 0) {
+            cub::DeviceRadixSort::SortPairs(
+                per_primitive_buffers.cub_workspace,
+                per_primitive_buffers.cub_workspace_size,
+                per_primitive_buffers.depth_keys,
+                per_primitive_buffers.primitive_indices,
+                n_visible_primitives,
+                0, sizeof(uint) * 8, stream);
+            CHECK_CUDA(config::debug, "cub::DeviceRadixSort::SortPairs (Depth)")
+            cudaMemcpyAsync(order_buffers.order, per_primitive_buffers.primitive_indices.Current(), sizeof(uint) * n_visible_primitives, cudaMemcpyDeviceToDevice, stream);
+            return order_buffers.order;
+        }
+
+        // the compacted preprocess output is no longer needed and serves as the alternate buffers
+        cub::DoubleBuffer<uint> new_keys(order_buffers.new_keys, per_primitive_buffers.depth_keys.Current());
+        cub::DoubleBuffer<uint> new_indices(order_buffers.new_indices, per_primitive_buffers.primitive_indices.Current());
+        cub::DeviceRadixSort::SortPairs(
+            per_primitive_buffers.cub_workspace,
+            per_primitive_buffers.cub_workspace_size,
+            new_keys,
+            new_indices,
+            n_new,
+            0, sizeof(uint) * 8, stream);
+        CHECK_CUDA(config::debug, "cub::DeviceRadixSort::SortPairs (New Primitives)")
+        if (n_visible_primitives > 0) {
+            kernels::forward::merge_depth_orders_cu<<<div_round_up(n_visible_primitives, config::block_size_apply_depth_ordering), config::block_size_apply_depth_ordering, 0, stream>>>(
+                kept_keys, kept_indices, n_kept,
+                new_keys.Current(), new_indices.Current(), n_new,
+                order_buffers.order);
+            CHECK_CUDA(config::debug, "merge_depth_orders")
+        }
+        return order_buffers.order;
+    }
+
+} // namespace
 
 // sorting is done separately for depth and tile as proposed in https://github.com/m-schuetz/Splatshop
 void gs::rendering::forward(
+    cudaStream_t stream,
     std::function<char*(size_t)> per_primitive_buffers_func,
     std::function<char*(size_t)> per_tile_buffers_func,
     std::function<char*(size_t)> per_instance_buffers_func,
@@ -36,79 +234,152 @@ void gs::rendering::forward(
     const float cx,
     const float cy,
     const float near_, // near and far are macros in windowns
-    const float far_) {
+    const float far_,
+    const CropBox* crop_box,
+    const RenderRect* render_rect,
+    const TileQuality* tile_quality,
+    const float sh_lod_pixels,
+    const bool occlusion_culling,
+    const ModelPlacements* placements,
+    const bool half_precision) {
+    static_assert(config::tile_width == quality_tile_size && config::tile_height == quality_tile_size);
     const dim3 grid(div_round_up(width, config::tile_width), div_round_up(height, config::tile_height), 1);
     const dim3 block(config::tile_width, config::tile_height, 1);
     const int n_tiles = grid.x * grid.y;
 
+    // tiles covering the render rect as x_min, x_max, y_min, y_max like the screen bounds
+    uint4 tile_rect = make_uint4(0, grid.x, 0, grid.y);
+    if (render_rect) {
+        const int x_end = render_rect->x + render_rect->width;
+        const int y_end = render_rect->y + render_rect->height;
+        tile_rect = make_uint4(
+            static_cast<uint>(std::clamp(render_rect->x / config::tile_width, 0, static_cast<int>(grid.x))),
+            static_cast<uint>(std::clamp(div_round_up(x_end, config::tile_width), 0, static_cast<int>(grid.x))),
+            static_cast<uint>(std::clamp(render_rect->y / config::tile_height, 0, static_cast<int>(grid.y))),
+            static_cast<uint>(std::clamp(div_round_up(y_end, config::tile_height), 0, static_cast<int>(grid.y))));
+    }
+
     char* per_tile_buffers_blob = per_tile_buffers_func(required<PerTileBuffers>(n_tiles));
     PerTileBuffers per_tile_buffers = PerTileBuffers::from_blob(per_tile_buffers_blob, n_tiles);
 
     static cudaStream_t memset_stream = 0;
+    static cudaEvent_t memset_ready = nullptr;
     if constexpr (!config::debug) {
         static bool memset_stream_initialized = false;
         if (!memset_stream_initialized) {
             cudaStreamCreate(&memset_stream);
+            cudaEventCreateWithFlags(&memset_ready, cudaEventDisableTiming);
             memset_stream_initialized = true;
         }
+        // the blob was allocated in stream order, the side stream may only touch it after that point
+        cudaEventRecord(memset_ready, stream);
+        cudaStreamWaitEvent(memset_stream, memset_ready);
         cudaMemsetAsync(per_tile_buffers.instance_ranges, 0, sizeof(uint2) * n_tiles, memset_stream);
     } else
-        cudaMemset(per_tile_buffers.instance_ranges, 0, sizeof(uint2) * n_tiles);
-
-    char* per_primitive_buffers_blob = per_primitive_buffers_func(required<PerPrimitiveBuffers>(n_primitives));
-    PerPrimitiveBuffers per_primitive_buffers = PerPrimitiveBuffers::from_blob(per_primitive_buffers_blob, n_primitives);
-
-    cudaMemset(per_primitive_buffers.n_visible_primitives, 0, sizeof(uint));
-    cudaMemset(per_primitive_buffers.n_instances, 0, sizeof(uint));
-
-    kernels::forward::preprocess_cu<<<div_round_up(n_primitives, config::block_size_preprocess), config::block_size_preprocess>>>(
-        means,
-        scales_raw,
-        rotations_raw,
-        opacities_raw,
-        sh_coefficients_0,
-        sh_coefficients_rest,
-        w2c,
-        cam_position,
-        per_primitive_buffers.depth_keys.Current(),
-        per_primitive_buffers.primitive_indices.Current(),
-        per_primitive_buffers.n_touched_tiles,
-        per_primitive_buffers.screen_bounds,
-        per_primitive_buffers.mean2d,
-        per_primitive_buffers.conic_opacity,
-        per_primitive_buffers.color,
-        per_primitive_buffers.n_visible_primitives,
-        per_primitive_buffers.n_instances,
-        n_primitives,
-        grid.x,
-        grid.y,
-        active_sh_bases,
-        total_bases_sh_rest,
-        static_cast<float>(width),
-        static_cast<float>(height),
-        fx,
-        fy,
-        cx,
-        cy,
-        near_,
-        far_);
+        cudaMemsetAsync(per_tile_buffers.instance_ranges, 0, sizeof(uint2) * n_tiles, stream);
+
+    char* per_primitive_buffers_blob = per_primitive_buffers_func(required<PerPrimitiveBuffers>(n_primitives, half_precision));
+    PerPrimitiveBuffers per_primitive_buffers = PerPrimitiveBuffers::from_blob(per_primitive_buffers_blob, n_primitives, half_precision);
+
+    // the kernels reading the conic, opacity and color records are instantiated per record type
+    const auto with_primitive_records = [&](auto&& launch) {
+        if (half_precision)
+            launch(per_primitive_buffers.conic_opacity_half, per_primitive_buffers.color_half);
+        else
+            launch(per_primitive_buffers.conic_opacity, per_primitive_buffers.color);
+    };
+
+    cudaMemsetAsync(per_primitive_buffers.n_visible_primitives, 0, sizeof(uint), stream);
+    cudaMemsetAsync(per_primitive_buffers.n_instances, 0, sizeof(uint), stream);
+
+    // the pyramid of the last forward is only a guess for this one, a primitive it wrongly culled
+    // shows up against the pyramid this forward builds and the frame is rendered again without culling
+    OcclusionPyramid pyramid{};
+    OcclusionPyramid culling_pyramid{};
+    OcclusionBuffers occlusion_buffers{};
+    if (occlusion_culling) {
+        pyramid = occlusion_pyramid_layout(grid.x, grid.y);
+        occlusion_buffers = occlusion_state.buffers(n_primitives, pyramid);
+        pyramid.depth_keys = occlusion_buffers.pyramid;
+        const bool same_grid = occlusion_state.grid.x == grid.x && occlusion_state.grid.y == grid.y;
+        if (same_grid && occlusion_state.skip_culling == 0)
+            culling_pyramid = pyramid;
+        occlusion_state.skip_culling = std::max(occlusion_state.skip_culling - 1, 0);
+        cudaMemsetAsync(occlusion_buffers.counts, 0, sizeof(uint) * 2, stream);
+    }
+
+    with_primitive_records([&](auto* conic_opacity, auto* color) {
+        kernels::forward::preprocess_cu<<<div_round_up(n_primitives, config::block_size_preprocess), config::block_size_preprocess, 0, stream>>>(
+            means,
+            scales_raw,
+            rotations_raw,
+            opacities_raw,
+            sh_coefficients_0,
+            sh_coefficients_rest,
+            w2c,
+            cam_position,
+            per_primitive_buffers.depth_keys.Current(),
+            per_primitive_buffers.primitive_indices.Current(),
+            per_primitive_buffers.n_touched_tiles,
+            per_primitive_buffers.screen_bounds,
+            per_primitive_buffers.mean2d,
+            conic_opacity,
+            color,
+            per_primitive_buffers.n_visible_primitives,
+            per_primitive_buffers.n_instances,
+            occlusion_culling ? occlusion_buffers.primitive_depth_keys : nullptr,
+            culling_pyramid,
+            occlusion_buffers.culled_bounds,
+            occlusion_buffers.culled_depth_keys,
+            occlusion_buffers.counts,
+            n_primitives,
+            grid.x,
+            grid.y,
+            active_sh_bases,
+            total_bases_sh_rest,
+            static_cast<float>(width),
+            static_cast<float>(height),
+            fx,
+            fy,
+            cx,
+            cy,
+            near_,
+            far_,
+            crop_box ? *crop_box : CropBox{},
+            crop_box != nullptr,
+            tile_rect,
+            tile_quality ? tile_quality->quality : nullptr,
+            sh_lod_pixels,
+            placements ? *placements : ModelPlacements{});
+    });
     CHECK_CUDA(config::debug, "preprocess")
 
     int n_visible_primitives;
-    cudaMemcpy(&n_visible_primitives, per_primitive_buffers.n_visible_primitives, sizeof(uint), cudaMemcpyDeviceToHost);
+    cudaMemcpyAsync(&n_visible_primitives, per_primitive_buffers.n_visible_primitives, sizeof(uint), cudaMemcpyDeviceToHost, stream);
     int n_instances;
-    cudaMemcpy(&n_instances, per_primitive_buffers.n_instances, sizeof(uint), cudaMemcpyDeviceToHost);
+    cudaMemcpyAsync(&n_instances, per_primitive_buffers.n_instances, sizeof(uint), cudaMemcpyDeviceToHost, stream);
+    int n_culled = 0;
+    if (culling_pyramid.depth_keys != nullptr)
+        cudaMemcpyAsync(&n_culled, occlusion_buffers.counts, sizeof(uint), cudaMemcpyDeviceToHost, stream);
+    cudaStreamSynchronize(stream);
 
-    cub::DeviceRadixSort::SortPairs(
-        per_primitive_buffers.cub_workspace,
-        per_primitive_buffers.cub_workspace_size,
-        per_primitive_buffers.depth_keys,
-        per_primitive_buffers.primitive_indices,
-        n_visible_primitives);
-    CHECK_CUDA(config::debug, "cub::DeviceRadixSort::SortPairs (Depth)")
+    const uint* primitive_indices_sorted;
+    if constexpr (config::depth_window_passes > 0) {
+        primitive_indices_sorted = sort_by_depth(stream, per_primitive_buffers, n_primitives, n_visible_primitives);
+    } else {
+        cub::DeviceRadixSort::SortPairs(
+            per_primitive_buffers.cub_workspace,
+            per_primitive_buffers.cub_workspace_size,
+            per_primitive_buffers.depth_keys,
+            per_primitive_buffers.primitive_indices,
+            n_visible_primitives,
+            0, sizeof(uint) * 8, stream);
+        CHECK_CUDA(config::debug, "cub::DeviceRadixSort::SortPairs (Depth)")
+        primitive_indices_sorted = per_primitive_buffers.primitive_indices.Current();
+    }
 
-    kernels::forward::apply_depth_ordering_cu<<<div_round_up(n_visible_primitives, config::block_size_apply_depth_ordering), config::block_size_apply_depth_ordering>>>(
-        per_primitive_buffers.primitive_indices.Current(),
+    kernels::forward::apply_depth_ordering_cu<<<div_round_up(n_visible_primitives, config::block_size_apply_depth_ordering), config::block_size_apply_depth_ordering, 0, stream>>>(
+        primitive_indices_sorted,
         per_primitive_buffers.n_touched_tiles,
         per_primitive_buffers.offset,
         n_visible_primitives);
@@ -119,22 +390,25 @@ void gs::rendering::forward(
         per_primitive_buffers.cub_workspace_size,
         per_primitive_buffers.offset,
         per_primitive_buffers.offset,
-        n_visible_primitives);
+        n_visible_primitives,
+        stream);
     CHECK_CUDA(config::debug, "cub::DeviceScan::ExclusiveSum (Primitive Offsets)")
 
     char* per_instance_buffers_blob = per_instance_buffers_func(required<PerInstanceBuffers>(n_instances));
     PerInstanceBuffers per_instance_buffers = PerInstanceBuffers::from_blob(per_instance_buffers_blob, n_instances);
 
-    kernels::forward::create_instances_cu<<<div_round_up(n_visible_primitives, config::block_size_create_instances), config::block_size_create_instances>>>(
-        per_primitive_buffers.primitive_indices.Current(),
-        per_primitive_buffers.offset,
-        per_primitive_buffers.screen_bounds,
-        per_primitive_buffers.mean2d,
-        per_primitive_buffers.conic_opacity,
-        per_instance_buffers.keys.Current(),
-        per_instance_buffers.primitive_indices.Current(),
-        grid.x,
-        n_visible_primitives);
+    with_primitive_records([&](auto* conic_opacity, auto*) {
+        kernels::forward::create_instances_cu<<<div_round_up(n_visible_primitives, config::block_size_create_instances), config::block_size_create_instances, 0, stream>>>(
+            primitive_indices_sorted,
+            per_primitive_buffers.offset,
+            per_primitive_buffers.screen_bounds,
+            per_primitive_buffers.mean2d,
+            conic_opacity,
+            per_instance_buffers.keys.Current(),
+            per_instance_buffers.primitive_indices.Current(),
+            grid.x,
+            n_visible_primitives);
+    });
     CHECK_CUDA(config::debug, "create_instances")
 
     cub::DeviceRadixSort::SortPairs(
@@ -142,30 +416,73 @@ void gs::rendering::forward(
         per_instance_buffers.cub_workspace_size,
         per_instance_buffers.keys,
         per_instance_buffers.primitive_indices,
-        n_instances);
+        n_instances,
+        0, sizeof(ushort) * 8, stream);
     CHECK_CUDA(config::debug, "cub::DeviceRadixSort::SortPairs (Tile)")
 
     if constexpr (!config::debug)
         cudaStreamSynchronize(memset_stream);
 
     if (n_instances > 0) {
-        kernels::forward::extract_instance_ranges_cu<<<div_round_up(n_instances, config::block_size_extract_instance_ranges), config::block_size_extract_instance_ranges>>>(
+        kernels::forward::extract_instance_ranges_cu<<<div_round_up(n_instances, config::block_size_extract_instance_ranges), config::block_size_extract_instance_ranges, 0, stream>>>(
             per_instance_buffers.keys.Current(),
             per_tile_buffers.instance_ranges,
             n_instances);
         CHECK_CUDA(config::debug, "extract_instance_ranges")
     }
 
-    kernels::forward::blend_cu<<<grid, block>>>(
-        per_tile_buffers.instance_ranges,
-        per_instance_buffers.primitive_indices.Current(),
-        per_primitive_buffers.mean2d,
-        per_primitive_buffers.conic_opacity,
-        per_primitive_buffers.color,
-        image,
-        alpha,
-        width,
-        height,
-        grid.x);
+    with_primitive_records([&](auto* conic_opacity, auto* color) {
+        kernels::forward::blend_cu<<<grid, block, 0, stream>>>(
+            per_tile_buffers.instance_ranges,
+            per_instance_buffers.primitive_indices.Current(),
+            per_primitive_buffers.mean2d,
+            conic_opacity,
+            color,
+            image,
+            alpha,
+            width,
+            height,
+            grid.x,
+            tile_quality ? *tile_quality : TileQuality{},
+            occlusion_buffers.primitive_depth_keys,
+            pyramid.depth_keys);
+    });
     CHECK_CUDA(config::debug, "blend")
+
+    if (!occlusion_culling)
+        return;
+    for (int level = 1; level < pyramid.n_levels; ++level) {
+        const uint2 size = pyramid.sizes[level];
+        kernels::forward::build_occlusion_level_cu<<<div_round_up(size.x * size.y, static_cast<uint>(config::block_size_occlusion)), config::block_size_occlusion, 0, stream>>>(
+            pyramid.depth_keys + pyramid.offsets[level - 1],
+            pyramid.sizes[level - 1],
+            occlusion_buffers.pyramid + pyramid.offsets[level],
+            size);
+        CHECK_CUDA(config::debug, "build_occlusion_level")
+    }
+    occlusion_state.grid = make_uint2(grid.x, grid.y);
+    if (n_culled == 0)
+        return;
+
+    kernels::forward::detect_disocclusion_cu<<<div_round_up(n_culled, config::block_size_occlusion), config::block_size_occlusion, 0, stream>>>(
+        occlusion_buffers.culled_bounds,
+        occlusion_buffers.culled_depth_keys,
+        n_culled,
+        pyramid,
+        occlusion_buffers.counts + 1);
+    CHECK_CUDA(config::debug, "detect_disocclusion")
+    uint n_disoccluded;
+    cudaMemcpyAsync(&n_disoccluded, occlusion_buffers.counts + 1, sizeof(uint), cudaMemcpyDeviceToHost, stream);
+    cudaStreamSynchronize(stream);
+    if (n_disoccluded == 0)
+        return;
+
+    // the skipped forwards rebuild the pyramid, the camera presumably keeps moving for a while
+    occlusion_state.skip_culling = config::occlusion_culling_backoff;
+    forward(stream, per_primitive_buffers_func, per_tile_buffers_func, per_instance_buffers_func,
+            means, scales_raw, rotations_raw, opacities_raw, sh_coefficients_0, sh_coefficients_rest,
+            w2c, cam_position, image, alpha,
+            n_primitives, active_sh_bases, total_bases_sh_rest, width, height,
+            fx, fy, cx, cy, near_, far_,
+            crop_box, render_rect, tile_quality, sh_lod_pixels, occlusion_culling, placements, half_precision);
 }
\ No newline at end of file
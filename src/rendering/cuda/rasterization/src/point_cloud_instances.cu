@@ -0,0 +1,69 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "point_cloud_instances.h"
+#include "rasterization_config.h"
+#include <c10/cuda/CUDAException.h>
+
+namespace gs::rendering {
+
+    namespace {
+        constexpr float SH_C0 = 0.28209479177387814f;
+        constexpr int block_size = 256;
+
+        __global__ void fill_point_cloud_instances_kernel(
+            const float3* __restrict__ means,
+            const float3* __restrict__ sh0,
+            const float* __restrict__ opacity,
+            float* __restrict__ instances,
+            const int n) {
+            const int idx = blockIdx.x * blockDim.x + threadIdx.x;
+            if (idx >= n) {
+                return;
+            }
+            const float3 dc = sh0[idx];
+            float* out = instances + 6 * idx;
+            const float alpha = 1.0f / (1.0f + expf(-opacity[idx]));
+            if (alpha < config::min_alpha_threshold) {
+                out[0] = out[1] = out[2] = __int_as_float(0x7fc00000);
+            } else {
+                const float3 position = means[idx];
+                out[0] = position.x;
+                out[1] = position.y;
+                out[2] = position.z;
+            }
+            out[3] = fminf(fmaxf(dc.x * SH_C0 + 0.5f, 0.0f), 1.0f);
+            out[4] = fminf(fmaxf(dc.y * SH_C0 + 0.5f, 0.0f), 1.0f);
+            out[5] = fminf(fmaxf(dc.z * SH_C0 + 0.5f, 0.0f), 1.0f);
+        }
+    } // namespace
+
+    void fill_point_cloud_instances(
+        const torch::Tensor& means,
+        const torch::Tensor& sh0,
+        const torch::Tensor& opacity,
+        float* instances,
+        cudaStream_t stream) {
+        TORCH_CHECK(means.is_cuda() && sh0.is_cuda() && opacity.is_cuda(), "point cloud instances need CUDA tensors");
+        TORCH_CHECK(means.size(0) == sh0.size(0) && means.size(0) == opacity.size(0),
+                    "means, sh0 and opacity disagree on the point count");
+
+        const auto positions = means.to(torch::kFloat32).contiguous();
+        const auto colors = sh0.to(torch::kFloat32).contiguous();
+        const auto logits = opacity.to(torch::kFloat32).contiguous();
+        const int n = static_cast<int>(positions.size(0));
+        if (n == 0) {
+            return;
+        }
+
+        fill_point_cloud_instances_kernel<<<(n + block_size - 1) / block_size, block_size, 0, stream>>>(
+            reinterpret_cast<const float3*>(positions.data_ptr<float>()),
+            reinterpret_cast<const float3*>(colors.data_ptr<float>()),
+            logits.data_ptr<float>(),
+            instances,
+            n);
+        C10_CUDA_KERNEL_LAUNCH_CHECK();
+    }
+
+} // namespace gs::rendering
@@ -6,6 +6,7 @@
 #include "rasterization_api.h"
 #include "rasterization_config.h"
 #include "torch_utils.h"
+#include <ATen/cuda/CUDAContext.h>
 #include <functional>
 #include <stdexcept>
 #include <tuple>
@@ -29,7 +30,14 @@ namespace gs::rendering {
         const float center_x,
         const float center_y,
         const float near_plane,
-        const float far_plane) {
+        const float far_plane,
+        const CropBox* crop_box,
+        const RenderRect* render_rect,
+        const TileQuality* tile_quality,
+        const float sh_lod_pixels,
+        const bool occlusion_culling,
+        const ModelPlacements* placements,
+        const bool half_precision) {
         // all optimizable tensors must be contiguous CUDA float tensors
         CHECK_INPUT(config::debug, means, "means");
         CHECK_INPUT(config::debug, scales_raw, "scales_raw");
@@ -38,7 +46,9 @@ namespace gs::rendering {
         CHECK_INPUT(config::debug, sh_coefficients_0, "sh_coefficients_0");
         CHECK_INPUT(config::debug, sh_coefficients_rest, "sh_coefficients_rest");
 
-        const int n_primitives = means.size(0);
+        if (placements != nullptr && placements->n_placements == 0)
+            placements = nullptr;
+        const int n_primitives = placements != nullptr ? placements->n_drawn : means.size(0);
         const int total_bases_sh_rest = sh_coefficients_rest.size(1);
         const torch::TensorOptions float_options = torch::TensorOptions().dtype(torch::kFloat).device(torch::kCUDA);
         const torch::TensorOptions byte_options = torch::TensorOptions().dtype(torch::kByte).device(torch::kCUDA);
@@ -53,6 +63,7 @@ namespace gs::rendering {
         const std::function<char*(size_t)> per_instance_buffers_func = resize_function_wrapper(per_instance_buffers);
 
         forward(
+            at::cuda::getCurrentCUDAStream(),
             per_primitive_buffers_func,
             per_tile_buffers_func,
             per_instance_buffers_func,
@@ -76,7 +87,14 @@ namespace gs::rendering {
             center_x,
             center_y,
             near_plane,
-            far_plane);
+            far_plane,
+            crop_box,
+            render_rect,
+            tile_quality,
+            sh_lod_pixels,
+            occlusion_culling,
+            placements,
+            half_precision);
 
         return {image, alpha};
     }
@@ -0,0 +1,89 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "rgba8_surface.h"
+#include <c10/cuda/CUDAException.h>
+
+namespace gs::rendering {
+
+    namespace {
+        constexpr int block_dim = 16;
+
+        __device__ __forceinline__ float load_channel(const float* image, const int64_t offset) {
+            return image[offset];
+        }
+
+        __device__ __forceinline__ float load_channel(const uint8_t* image, const int64_t offset) {
+            return image[offset] * (1.0f / 255.0f);
+        }
+
+        __device__ __forceinline__ unsigned char encode(float v, const DisplayTransform transform) {
+            if (transform.tonemap) {
+                v = fmaxf(v, 0.0f);
+                v = v / (1.0f + v);
+            }
+            if (transform.srgb) {
+                v = fmaxf(v, 0.0f);
+                v = v <= 0.0031308f ? 12.92f * v : 1.055f * powf(v, 1.0f / 2.4f) - 0.055f;
+            }
+            return static_cast<unsigned char>(__float2uint_rn(fminf(fmaxf(v, 0.0f), 1.0f) * 255.0f));
+        }
+
+        template <typename T>
+        __global__ void write_rgba8_surface_kernel(
+            const T* __restrict__ image,
+            const int64_t stride_y,
+            const int64_t stride_x,
+            const int64_t stride_c,
+            const int channels,
+            const int width,
+            const int height,
+            cudaSurfaceObject_t surface,
+            const DisplayTransform transform) {
+            const int x = blockIdx.x * blockDim.x + threadIdx.x;
+            const int y = blockIdx.y * blockDim.y + threadIdx.y;
+            if (x >= width || y >= height) {
+                return;
+            }
+            const int64_t pixel = y * stride_y + x * stride_x;
+            uchar4 rgba;
+            rgba.x = encode(load_channel(image, pixel), transform);
+            rgba.y = encode(load_channel(image, pixel + stride_c), transform);
+            rgba.z = encode(load_channel(image, pixel + 2 * stride_c), transform);
+            // Alpha is coverage, never tonemapped or gamma encoded
+            rgba.w = channels == 4 ? encode(load_channel(image, pixel + 3 * stride_c), {}) : 255;
+            surf2Dwrite(rgba, surface, x * static_cast<int>(sizeof(uchar4)), y);
+        }
+    } // namespace
+
+    void write_rgba8_surface(
+        const torch::Tensor& image,
+        cudaSurfaceObject_t surface,
+        const DisplayTransform& transform,
+        cudaStream_t stream) {
+        TORCH_CHECK(image.is_cuda() && image.dim() == 3, "write_rgba8_surface expects a CUDA [H, W, C] image");
+        TORCH_CHECK(image.size(2) == 3 || image.size(2) == 4, "write_rgba8_surface expects 3 or 4 channels");
+
+        const auto source = image.scalar_type() == torch::kUInt8 || image.scalar_type() == torch::kFloat32
+                                ? image
+                                : image.to(torch::kFloat32);
+        const int height = static_cast<int>(source.size(0));
+        const int width = static_cast<int>(source.size(1));
+        const int channels = static_cast<int>(source.size(2));
+        const dim3 block(block_dim, block_dim);
+        const dim3 grid((width + block_dim - 1) / block_dim, (height + block_dim - 1) / block_dim);
+
+        if (source.scalar_type() == torch::kUInt8) {
+            write_rgba8_surface_kernel<<<grid, block, 0, stream>>>(
+                source.data_ptr<uint8_t>(), source.stride(0), source.stride(1), source.stride(2),
+                channels, width, height, surface, transform);
+        } else {
+            write_rgba8_surface_kernel<<<grid, block, 0, stream>>>(
+                source.data_ptr<float>(), source.stride(0), source.stride(1), source.stride(2),
+                channels, width, height, surface, transform);
+        }
+        C10_CUDA_KERNEL_LAUNCH_CHECK();
+    }
+
+} // namespace gs::rendering
@@ -16,6 +16,7 @@
 
 #ifdef CUDA_GL_INTEROP_ENABLED
 // Only include CUDA GL interop when enabled
+#include <c10/cuda/CUDAStream.h>
 #include <cuda_gl_interop.h>
 #endif
 
@@ -85,7 +86,8 @@ namespace gs::rendering {
         return {};
     }
 
-    Result<void> CudaGLInteropTextureImpl<false>::updateFromTensor(const torch::Tensor& image) {
+    Result<void> CudaGLInteropTextureImpl<false>::updateFromTensor(const torch::Tensor& image,
+                                                                   const DisplayTransform& transform) {
         // CPU fallback - this should not be called for non-interop version
         LOG_ERROR("CUDA-GL interop not available - use regular framebuffer upload");
         return std::unexpected("CUDA-GL interop not available - use regular framebuffer upload");
@@ -156,7 +158,7 @@ namespace gs::rendering {
         cudaGraphicsResource_t raw_resource;
         cudaError_t err = cudaGraphicsGLRegisterImage(
             &raw_resource, texture_id_, GL_TEXTURE_2D,
-            cudaGraphicsRegisterFlagsWriteDiscard);
+            cudaGraphicsRegisterFlagsSurfaceLoadStore);
 
         if (err != cudaSuccess) {
             cleanup();
@@ -181,7 +183,8 @@ namespace gs::rendering {
         return {};
     }
 
-    Result<void> CudaGLInteropTextureImpl<true>::updateFromTensor(const torch::Tensor& image) {
+    Result<void> CudaGLInteropTextureImpl<true>::updateFromTensor(const torch::Tensor& image,
+                                                                  const DisplayTransform& transform) {
         LOG_TIMER_TRACE("CudaGLInteropTextureImpl<true>::updateFromTensor");
 
         if (!is_registered_) {
@@ -214,9 +217,10 @@ namespace gs::rendering {
             return result;
         }
 
-        // Map CUDA resource
+        // Map CUDA resource on the stream that produced the image, unmapping orders GL after the write
+        const cudaStream_t stream = c10::cuda::getCurrentCUDAStream();
         auto raw_resource = static_cast<cudaGraphicsResource_t>(cuda_resource_.get());
-        cudaError_t err = cudaGraphicsMapResources(1, &raw_resource, 0);
+        cudaError_t err = cudaGraphicsMapResources(1, &raw_resource, stream);
         if (err != cudaSuccess) {
             LOG_ERROR("Failed to map CUDA resource: {}", cudaGetErrorString(err));
             return std::unexpected(std::format("Failed to map CUDA resource: {}",
@@ -226,13 +230,14 @@ namespace gs::rendering {
         // RAII unmap guard
         struct UnmapGuard {
             cudaGraphicsResource_t* resource;
+            cudaStream_t stream;
             ~UnmapGuard() {
                 if (resource) {
-                    cudaGraphicsUnmapResources(1, resource, 0);
+                    cudaGraphicsUnmapResources(1, resource, stream);
                     LOG_TRACE("Unmapped CUDA resource");
                 }
             }
-        } unmap_guard{&raw_resource};
+        } unmap_guard{&raw_resource, stream};
 
         // Get CUDA array from mapped resource
         cudaArray_t cuda_array;
@@ -243,52 +248,49 @@ namespace gs::rendering {
                                                cudaGetErrorString(err)));
         }
 
-        // Convert to RGBA uint8 if needed
-        torch::Tensor rgba_image;
-        if (c == 3) {
-            // Add alpha channel
-            rgba_image = torch::cat({image,
-                                     torch::ones({h, w, 1}, image.options())},
-                                    2);
-            LOG_TRACE("Added alpha channel to image");
-        } else {
-            rgba_image = image;
+        // The surface is kept while the texture maps to the same array; destroying it right after
+        // the launch could race the asynchronous write
+        if (!surface_ || surface_array_ != cuda_array) {
+            destroySurface();
+            cudaResourceDesc resource_desc = {};
+            resource_desc.resType = cudaResourceTypeArray;
+            resource_desc.res.array.array = cuda_array;
+            cudaSurfaceObject_t surface = 0;
+            err = cudaCreateSurfaceObject(&surface, &resource_desc);
+            if (err != cudaSuccess) {
+                LOG_ERROR("Failed to create surface object: {}", cudaGetErrorString(err));
+                return std::unexpected(std::format("Failed to create surface object: {}",
+                                                   cudaGetErrorString(err)));
+            }
+            surface_ = surface;
+            surface_array_ = cuda_array;
         }
 
-        // Ensure proper format (uint8)
-        if (rgba_image.dtype() != torch::kUInt8) {
-            rgba_image = (rgba_image.clamp(0.0f, 1.0f) * 255.0f).to(torch::kUInt8);
-            LOG_TRACE("Converted image to uint8");
+        // One fused pass: channel gather, alpha fill, display transform and quantization
+        try {
+            write_rgba8_surface(image, surface_, transform, stream);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to write texture: {}", e.what());
+            return std::unexpected(std::format("Failed to write texture: {}", e.what()));
         }
 
-        // Make contiguous
-        rgba_image = rgba_image.contiguous();
-
-        // Copy to CUDA array
-        err = cudaMemcpy2DToArray(
-            cuda_array,
-            0, 0, // offset
-            rgba_image.data_ptr<uint8_t>(),
-            w * 4, // pitch (RGBA = 4 bytes per pixel)
-            w * 4, // width in bytes
-            h,     // height
-            cudaMemcpyDeviceToDevice);
-
-        if (err != cudaSuccess) {
-            LOG_ERROR("Failed to copy to CUDA array: {}", cudaGetErrorString(err));
-            return std::unexpected(std::format("Failed to copy to CUDA array: {}",
-                                               cudaGetErrorString(err)));
-        }
-
-        // Synchronize to ensure copy is complete
-        cudaDeviceSynchronize();
-
         LOG_TRACE("Successfully updated texture from CUDA tensor");
         return {};
     }
 
+    void CudaGLInteropTextureImpl<true>::destroySurface() {
+        if (surface_) {
+            // The last write may still be queued
+            cudaDeviceSynchronize();
+            cudaDestroySurfaceObject(surface_);
+            surface_ = 0;
+            surface_array_ = nullptr;
+        }
+    }
+
     void CudaGLInteropTextureImpl<true>::cleanup() {
         LOG_TRACE("Cleaning up CUDA-GL interop texture");
+        destroySurface();
         cuda_resource_.reset();
         is_registered_ = false;
 
@@ -375,7 +377,7 @@ namespace gs::rendering {
 
         // Direct CUDA update
         LOG_TRACE("Using direct CUDA-GL interop update");
-        auto result = interop_texture_->updateFromTensor(cuda_image);
+        auto result = interop_texture_->updateFromTensor(cuda_image, display_transform_);
         if (!result) {
             LOG_WARN("CUDA-GL interop update failed: {}", result.error());
             LOG_INFO("Falling back to CPU copy");
@@ -14,6 +14,7 @@ typedef unsigned int GLuint;
 
 // Include framebuffer after forward declarations
 #include "framebuffer.hpp"
+#include "rgba8_surface.h"
 
 namespace gs::rendering {
 
@@ -41,7 +42,7 @@ namespace gs::rendering {
 
         Result<void> init(int width, int height);
         Result<void> resize(int new_width, int new_height);
-        Result<void> updateFromTensor(const torch::Tensor& image);
+        Result<void> updateFromTensor(const torch::Tensor& image, const DisplayTransform& transform = {});
         GLuint getTextureID() const { return texture_id_; }
 
     private:
@@ -53,6 +54,8 @@ namespace gs::rendering {
     class CudaGLInteropTextureImpl<true> {
         GLuint texture_id_ = 0;
         CudaGraphicsResourcePtr cuda_resource_;
+        cudaSurfaceObject_t surface_ = 0;
+        cudaArray_t surface_array_ = nullptr; // The mapped array surface_ was created for
         int width_ = 0;
         int height_ = 0;
         bool is_registered_ = false;
@@ -63,10 +66,12 @@ namespace gs::rendering {
 
         Result<void> init(int width, int height);
         Result<void> resize(int new_width, int new_height);
-        Result<void> updateFromTensor(const torch::Tensor& image);
+        // image [H, W, C], any strides; written straight into the texture as RGBA8
+        Result<void> updateFromTensor(const torch::Tensor& image, const DisplayTransform& transform = {});
         GLuint getTextureID() const { return texture_id_; }
 
     private:
+        void destroySurface();
         void cleanup();
     };
 
@@ -81,12 +86,16 @@ namespace gs::rendering {
     class InteropFrameBuffer : public FrameBuffer {
         std::optional<CudaGLInteropTexture> interop_texture_;
         bool use_interop_;
+        DisplayTransform display_transform_;
 
     public:
         explicit InteropFrameBuffer(bool use_interop = true);
 
         Result<void> uploadFromCUDA(const torch::Tensor& cuda_image);
 
+        // Applied by the interop upload only, the CPU fallback shows values as they are
+        void setDisplayTransform(const DisplayTransform& transform) { display_transform_ = transform; }
+
         GLuint getInteropTexture() const {
             return use_interop_ && interop_texture_ ? interop_texture_->getTextureID() : getFrameTexture();
         }
@@ -135,6 +135,8 @@ namespace gs::rendering {
                 return GL_PIXEL_UNPACK_BUFFER_BINDING;
             if (Target == GL_TRANSFORM_FEEDBACK_BUFFER)
                 return GL_TRANSFORM_FEEDBACK_BUFFER_BINDING;
+            if (Target == GL_SHADER_STORAGE_BUFFER)
+                return GL_SHADER_STORAGE_BUFFER_BINDING;
             return 0;
         }();
 
@@ -19,6 +19,13 @@ namespace gs::rendering {
         float center_y;
         float near_plane;
         float far_plane;
+        const CropBox* crop_box;
+        const RenderRect* render_rect;
+        const TileQuality* tile_quality;
+        float sh_lod_pixels;
+        bool occlusion_culling;
+        const ModelPlacements* placements;
+        bool half_precision;
     };
 
     static std::tuple<torch::Tensor, torch::Tensor> forward(
@@ -47,7 +54,14 @@ namespace gs::rendering {
             settings.center_x,
             settings.center_y,
             settings.near_plane,
-            settings.far_plane);
+            settings.far_plane,
+            settings.crop_box,
+            settings.render_rect,
+            settings.tile_quality,
+            settings.sh_lod_pixels,
+            settings.occlusion_culling,
+            settings.placements,
+            settings.half_precision);
     }
 
     using torch::indexing::None;
@@ -56,7 +70,14 @@ namespace gs::rendering {
     torch::Tensor rasterize(
         Camera& viewpoint_camera,
         SplatData& gaussian_model,
-        torch::Tensor& bg_color) {
+        torch::Tensor& bg_color,
+        const CropBox* crop_box,
+        const RenderRect* render_rect,
+        const TileQuality* tile_quality,
+        const float sh_lod_pixels,
+        const bool occlusion_culling,
+        const ModelPlacements* placements,
+        const bool half_precision) {
 
         // Get camera parameters
         auto [fx, fy, cx, cy] = viewpoint_camera.get_intrinsics();
@@ -78,14 +99,21 @@ namespace gs::rendering {
             .center_x = cx,
             .center_y = cy,
             .near_plane = near_plane,
-            .far_plane = far_plane};
+            .far_plane = far_plane,
+            .crop_box = crop_box,
+            .render_rect = render_rect,
+            .tile_quality = tile_quality,
+            .sh_lod_pixels = sh_lod_pixels,
+            .occlusion_culling = occlusion_culling,
+            .placements = placements,
+            .half_precision = half_precision};
         auto [image, alpha] = forward(
             gaussian_model.means(),
             gaussian_model.scaling_raw(),
             gaussian_model.rotation_raw(),
             gaussian_model.opacity_raw(),
             gaussian_model.sh0(),
-            gaussian_model.shN(),
+            gaussian_model.shN().to(torch::kFloat32), // the viewer rasterizer reads fp32 only
             settings);
 
         // Manually blend the background since the forward pass does not support it
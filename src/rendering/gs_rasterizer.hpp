@@ -6,6 +6,7 @@
 
 #include "core/camera.hpp"
 #include "core/splat_data.hpp"
+#include "rasterization_api.h"
 #include <tuple>
 
 namespace gs::rendering {
@@ -13,6 +14,13 @@ namespace gs::rendering {
     torch::Tensor rasterize(
         Camera& viewpoint_camera,
         SplatData& gaussian_model,
-        torch::Tensor& bg_color);
+        torch::Tensor& bg_color,
+        const CropBox* crop_box = nullptr,
+        const RenderRect* render_rect = nullptr,
+        const TileQuality* tile_quality = nullptr,
+        float sh_lod_pixels = 0.0f,
+        bool occlusion_culling = false,
+        const ModelPlacements* placements = nullptr,
+        bool half_precision = false);
 
 } // namespace gs::rendering
\ No newline at end of file
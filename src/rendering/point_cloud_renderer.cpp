@@ -6,8 +6,17 @@
 #include "core/logger.hpp"
 #include "gl_state_guard.hpp"
 #include "shader_paths.hpp"
+#include <cmath>
+#include <format>
 #include <vector>
 
+#ifdef CUDA_GL_INTEROP_ENABLED
+#include "point_cloud_instances.h"
+#include <c10/cuda/CUDAException.h>
+#include <c10/cuda/CUDAStream.h>
+#include <cuda_gl_interop.h>
+#endif
+
 namespace gs::rendering {
 
     Result<void> PointCloudRenderer::initialize() {
@@ -123,6 +132,34 @@ namespace gs::rendering {
         return colors.clamp(0.0f, 1.0f);
     }
 
+    torch::Tensor PointCloudRenderer::voxelInstances(const SplatData& splat_data, float voxel_size) {
+        constexpr int64_t AXIS_BITS = 21; // Three axes fit one int64 key
+        constexpr int64_t AXIS_CELLS = int64_t{1} << AXIS_BITS;
+
+        torch::NoGradGuard no_grad;
+        auto positions = splat_data.means().to(torch::kFloat32);
+        auto colors = extractRGBFromSH(splat_data.sh0()).to(torch::kFloat32);
+        const auto visible = (torch::sigmoid(splat_data.opacity_raw().to(torch::kFloat32)).reshape({-1}) >= 1.0f / 255.0f) &
+                             torch::isfinite(positions).all(1);
+        positions = positions.index({visible});
+        colors = colors.index({visible});
+        if (positions.size(0) == 0) {
+            return torch::empty({0, 6}, positions.options());
+        }
+
+        // Cells count from the lowest corner, a model wider than 2^21 voxels clamps into the border cells
+        const auto origin = std::get<0>(positions.min(0));
+        const auto cells = ((positions - origin) / voxel_size).floor().to(torch::kInt64).clamp(0, AXIS_CELLS - 1);
+        const auto keys = cells.select(1, 0) | (cells.select(1, 1) << AXIS_BITS) | (cells.select(1, 2) << (2 * AXIS_BITS));
+
+        const auto [sorted_keys, order] = keys.sort();
+        const auto [voxel_keys, voxel_of, counts] = torch::unique_consecutive(sorted_keys, /*return_inverse=*/true,
+                                                                              /*return_counts=*/true);
+        auto sums = torch::zeros({voxel_keys.size(0), 6}, positions.options());
+        sums.index_add_(0, voxel_of, torch::cat({positions, colors}, 1).index_select(0, order));
+        return (sums / counts.unsqueeze(1).to(torch::kFloat32)).contiguous();
+    }
+
     Result<void> PointCloudRenderer::uploadPointData(std::span<const float> positions, std::span<const float> colors) {
         LOG_TIMER_TRACE("PointCloudRenderer::uploadPointData");
 
@@ -160,36 +197,54 @@ namespace gs::rendering {
         return {};
     }
 
-    Result<void> PointCloudRenderer::render(const SplatData& splat_data,
-                                            const glm::mat4& view,
-                                            const glm::mat4& projection,
-                                            float voxel_size,
-                                            const glm::vec3& background_color) {
-        if (!initialized_) {
-            LOG_ERROR("Renderer not initialized");
-            return std::unexpected("Renderer not initialized");
+    Result<void> PointCloudRenderer::updateInstances(const SplatData& splat_data, float voxel_size) {
+        LOG_TIMER_TRACE("PointCloudRenderer::updateInstances");
+
+        torch::Tensor voxels;
+        if (voxel_size > 0.0f) {
+            try {
+                voxels = voxelInstances(splat_data, voxel_size);
+            } catch (const std::exception& e) {
+                return std::unexpected(std::format("Failed to downsample the point cloud: {}", e.what()));
+            }
+            LOG_TRACE("Downsampled {} points to {} voxels", splat_data.size(), voxels.size(0));
         }
 
-        if (splat_data.size() == 0) {
-            LOG_TRACE("No splat data to render");
-            return {}; // Nothing to render
+#ifdef CUDA_GL_INTEROP_ENABLED
+        if (use_interop_ && splat_data.means().is_cuda()) {
+            auto result = fillInstancesFromCUDA(splat_data, voxels);
+            if (result) {
+                return {};
+            }
+            LOG_WARN("CUDA-GL interop point upload failed: {}", result.error());
+            LOG_INFO("Falling back to CPU copies for the point cloud");
+            (void)cudaGetLastError();
+            instance_resource_.reset();
+            instance_capacity_ = 0;
+            use_interop_ = false;
+        }
+#endif
+
+        if (voxels.defined()) {
+            const auto voxels_cpu = voxels.cpu();
+            BufferBinder<GL_ARRAY_BUFFER> bind(instance_vbo_);
+            upload_buffer(GL_ARRAY_BUFFER, std::span(voxels_cpu.data_ptr<float>(), static_cast<size_t>(voxels_cpu.numel())),
+                          GL_DYNAMIC_DRAW);
+            current_point_count_ = static_cast<size_t>(voxels_cpu.size(0));
+            return {};
         }
 
-        LOG_TIMER_TRACE("PointCloudRenderer::render");
-
-        // Use comprehensive state guard to isolate our state changes
-        GLStateGuard state_guard;
-
-        // Get positions and SH coefficients
-        torch::Tensor positions = splat_data.get_means();
-        torch::Tensor shs = splat_data.get_shs();
+        // Only the DC band is needed for the colors
+        torch::Tensor colors = extractRGBFromSH(splat_data.sh0());
 
-        // Extract RGB colors from SH coefficients
-        torch::Tensor colors = extractRGBFromSH(shs);
+        // Points the splat rasterizer would cull for their opacity (below 1/255) get a NaN
+        // position, as in the CUDA fill
+        const auto culled = torch::sigmoid(splat_data.opacity_raw().to(torch::kFloat32)).reshape({-1, 1}) < 1.0f / 255.0f;
+        const auto positions = splat_data.means().to(torch::kFloat32).masked_fill(culled, std::nanf(""));
 
         // Ensure tensors are on CPU and contiguous
-        auto pos_cpu = positions.cpu().contiguous();
-        auto col_cpu = colors.cpu().contiguous();
+        auto pos_cpu = positions.to(torch::kCPU).contiguous();
+        auto col_cpu = colors.to(torch::kCPU, torch::kFloat32).contiguous();
 
         // Validate tensor dimensions
         if (pos_cpu.numel() == 0 || col_cpu.numel() == 0) {
@@ -207,18 +262,121 @@ namespace gs::rendering {
             return std::unexpected("Invalid color tensor dimensions");
         }
 
-        // Create spans for the data
-        if (!pos_cpu.data_ptr<float>() || !col_cpu.data_ptr<float>()) {
-            LOG_ERROR("Null tensor data pointer");
-            return std::unexpected("Null tensor data pointer");
-        }
-
         std::span<const float> pos_span(pos_cpu.data_ptr<float>(), pos_cpu.numel());
         std::span<const float> col_span(col_cpu.data_ptr<float>(), col_cpu.numel());
 
-        // Upload data to GPU
-        if (auto result = uploadPointData(pos_span, col_span); !result) {
-            return result;
+        return uploadPointData(pos_span, col_span);
+    }
+
+#ifdef CUDA_GL_INTEROP_ENABLED
+    Result<void> PointCloudRenderer::fillInstancesFromCUDA(const SplatData& splat_data, const torch::Tensor& voxels) {
+        const auto num_points = static_cast<size_t>(voxels.defined() ? voxels.size(0) : splat_data.size());
+        if (num_points == 0) {
+            current_point_count_ = 0;
+            return {};
+        }
+
+        // Grow with headroom so a densifying model does not re-register the buffer every frame
+        if (!instance_resource_ || instance_capacity_ < num_points) {
+            instance_resource_.reset(); // Unregister before the storage is replaced
+            const size_t capacity = num_points + num_points / 4;
+            {
+                BufferBinder<GL_ARRAY_BUFFER> bind(instance_vbo_);
+                glBufferData(GL_ARRAY_BUFFER, capacity * 6 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+            }
+            if (GLenum gl_err = glGetError(); gl_err != GL_NO_ERROR) {
+                return std::unexpected(std::format("OpenGL error allocating the instance buffer: 0x{:x}", gl_err));
+            }
+
+            cudaGraphicsResource_t raw_resource;
+            cudaError_t err = cudaGraphicsGLRegisterBuffer(&raw_resource, instance_vbo_.get(),
+                                                           cudaGraphicsRegisterFlagsWriteDiscard);
+            if (err != cudaSuccess) {
+                return std::unexpected(std::format("Failed to register the instance buffer with CUDA: {}",
+                                                   cudaGetErrorString(err)));
+            }
+            instance_resource_.reset(raw_resource);
+            instance_capacity_ = capacity;
+            LOG_DEBUG("Registered point cloud instance buffer for {} points", capacity);
+        }
+
+        // Mapping on the tensors' stream orders the fill after their producers and the draw after the fill
+        const cudaStream_t stream = c10::cuda::getCurrentCUDAStream();
+        auto raw_resource = static_cast<cudaGraphicsResource_t>(instance_resource_.get());
+        cudaError_t err = cudaGraphicsMapResources(1, &raw_resource, stream);
+        if (err != cudaSuccess) {
+            return std::unexpected(std::format("Failed to map the instance buffer: {}", cudaGetErrorString(err)));
+        }
+
+        void* instances = nullptr;
+        size_t mapped_bytes = 0;
+        std::string error;
+        if (err = cudaGraphicsResourceGetMappedPointer(&instances, &mapped_bytes, raw_resource); err != cudaSuccess) {
+            error = std::format("Failed to get the instance buffer pointer: {}", cudaGetErrorString(err));
+        } else if (mapped_bytes < num_points * 6 * sizeof(float)) {
+            error = "Mapped instance buffer is smaller than the point count";
+        } else {
+            try {
+                if (voxels.defined()) {
+                    C10_CUDA_CHECK(cudaMemcpyAsync(instances, voxels.data_ptr<float>(), num_points * 6 * sizeof(float),
+                                                   cudaMemcpyDeviceToDevice, stream));
+                } else {
+                    fill_point_cloud_instances(splat_data.means(), splat_data.sh0(), splat_data.opacity_raw(),
+                                               static_cast<float*>(instances), stream);
+                }
+            } catch (const std::exception& e) {
+                error = std::format("Failed to fill the instance buffer: {}", e.what());
+            }
+        }
+
+        err = cudaGraphicsUnmapResources(1, &raw_resource, stream);
+        if (!error.empty()) {
+            return std::unexpected(error);
+        }
+        if (err != cudaSuccess) {
+            return std::unexpected(std::format("Failed to unmap the instance buffer: {}", cudaGetErrorString(err)));
+        }
+
+        current_point_count_ = num_points;
+        return {};
+    }
+#endif
+
+    Result<void> PointCloudRenderer::render(const SplatData& splat_data,
+                                            const glm::mat4& view,
+                                            const glm::mat4& projection,
+                                            float voxel_size,
+                                            const glm::vec3& background_color) {
+        if (!initialized_) {
+            LOG_ERROR("Renderer not initialized");
+            return std::unexpected("Renderer not initialized");
+        }
+
+        if (splat_data.size() == 0) {
+            LOG_TRACE("No splat data to render");
+            return {}; // Nothing to render
+        }
+
+        LOG_TIMER_TRACE("PointCloudRenderer::render");
+
+        // Use comprehensive state guard to isolate our state changes
+        GLStateGuard state_guard;
+
+        // Refill the instances only when the model changed since the last frame
+        const ModelVersion version{.means = splat_data.means().data_ptr(),
+                                   .sh0 = splat_data.sh0().data_ptr(),
+                                   .opacity = splat_data.opacity_raw().data_ptr(),
+                                   .means_version = splat_data.means()._version(),
+                                   .sh0_version = splat_data.sh0()._version(),
+                                   .opacity_version = splat_data.opacity_raw()._version(),
+                                   .count = splat_data.size(),
+                                   .voxel_size = voxel_size};
+        if (version != uploaded_version_) {
+            if (auto result = updateInstances(splat_data, voxel_size); !result) {
+                uploaded_version_ = {};
+                return result;
+            }
+            uploaded_version_ = version;
         }
 
         // Validate instance count
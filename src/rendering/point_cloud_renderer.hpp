@@ -11,6 +11,10 @@
 #include <span>
 #include <torch/torch.h>
 
+#ifdef CUDA_GL_INTEROP_ENABLED
+#include "cuda_gl_interop.hpp"
+#endif
+
 namespace gs::rendering {
 
     class PointCloudRenderer {
@@ -20,7 +24,8 @@ namespace gs::rendering {
 
         Result<void> initialize();
 
-        // Render point cloud - now returns Result
+        // Render point cloud - now returns Result. One cube per occupied voxel of voxel_size, at
+        // the centroid and mean color of the points inside it.
         Result<void> render(const SplatData& splat_data,
                             const glm::mat4& view,
                             const glm::mat4& projection,
@@ -33,7 +38,17 @@ namespace gs::rendering {
     private:
         Result<void> createCubeGeometry();
         Result<void> uploadPointData(std::span<const float> positions, std::span<const float> colors);
+        // Fills the instance buffer from the model, through CUDA-GL interop when available
+        Result<void> updateInstances(const SplatData& splat_data, float voxel_size);
+#ifdef CUDA_GL_INTEROP_ENABLED
+        // voxels [M, 6] when downsampled, otherwise one instance per Gaussian
+        Result<void> fillInstancesFromCUDA(const SplatData& splat_data, const torch::Tensor& voxels);
+#endif
         static torch::Tensor extractRGBFromSH(const torch::Tensor& shs);
+        // Instance records (centroid xyz, mean color rgb) [M, 6] of the occupied voxels, on the
+        // model's device. The points are binned by sorting a key packed from their quantized
+        // positions and reduced per voxel; Gaussians the splat rasterizer would cull are left out.
+        static torch::Tensor voxelInstances(const SplatData& splat_data, float voxel_size);
 
         // OpenGL resources using RAII
         VAO cube_vao_;
@@ -41,6 +56,28 @@ namespace gs::rendering {
         EBO cube_ebo_;
         VBO instance_vbo_; // For positions and colors
 
+#ifdef CUDA_GL_INTEROP_ENABLED
+        // instance_vbo_ registered with CUDA, sized for instance_capacity_ points
+        CudaGraphicsResourcePtr instance_resource_;
+        size_t instance_capacity_ = 0;
+        bool use_interop_ = true;
+#endif
+
+        // The tensors, in-place version counters and voxel size the instance buffer was filled
+        // from, so an unchanged model is drawn without touching the buffer
+        struct ModelVersion {
+            const void* means = nullptr;
+            const void* sh0 = nullptr;
+            const void* opacity = nullptr;
+            uint32_t means_version = 0;
+            uint32_t sh0_version = 0;
+            uint32_t opacity_version = 0;
+            int64_t count = 0;
+            float voxel_size = 0.0f;
+            bool operator==(const ModelVersion&) const = default;
+        };
+        ModelVersion uploaded_version_;
+
         // Framebuffer resources using RAII
         FBO fbo_;
         Texture color_texture_;
@@ -6,6 +6,7 @@
 #include "core/logger.hpp"
 #include "framebuffer_factory.hpp"
 #include "geometry/bounding_box.hpp"
+#include <c10/cuda/CUDAGuard.h>
 
 namespace gs::rendering {
 
@@ -28,17 +29,25 @@ namespace gs::rendering {
 
         LOG_INFO("Initializing rendering engine...");
 
+        if (!stream_) {
+            int least_priority = 0;
+            int greatest_priority = 0;
+            cudaDeviceGetStreamPriorityRange(&least_priority, &greatest_priority);
+            if (const cudaError_t err = cudaStreamCreateWithPriority(&stream_, cudaStreamDefault, least_priority);
+                err != cudaSuccess) {
+                LOG_WARN("Failed to create the viewer CUDA stream, rendering on the current one: {}", cudaGetErrorString(err));
+                stream_ = nullptr;
+            } else {
+                LOG_DEBUG("Viewer CUDA stream at priority {}, the highest is {}", least_priority, greatest_priority);
+            }
+        }
+
         // Create screen renderer with preferred mode
         screen_renderer_ = std::make_shared<ScreenQuadRenderer>(getPreferredFrameBufferMode());
 
-        // Initialize split view renderer
+        // The split view and camera frustum programs compile on first use, most sessions never
+        // need them
         split_view_renderer_ = std::make_unique<SplitViewRenderer>();
-        if (auto result = split_view_renderer_->initialize(); !result) {
-            LOG_ERROR("Failed to initialize split view renderer: {}", result.error());
-            shutdown();
-            return std::unexpected(result.error());
-        }
-        LOG_DEBUG("Split view renderer initialized");
 
         if (auto result = grid_renderer_.init(); !result) {
             LOG_ERROR("Failed to initialize grid renderer: {}", result.error());
@@ -76,14 +85,6 @@ namespace gs::rendering {
         }
         LOG_DEBUG("Translation gizmo initialized");
 
-        // Initialize camera frustum renderer
-        if (auto result = camera_frustum_renderer_.init(); !result) {
-            LOG_ERROR("Failed to initialize camera frustum renderer: {}", result.error());
-            // Non-critical, continue without it
-        } else {
-            LOG_DEBUG("Camera frustum renderer initialized");
-        }
-
         // Create gizmo interaction adapter
         gizmo_interaction_ = std::make_shared<GizmoInteractionAdapter>(&translation_gizmo_);
 
@@ -110,11 +111,27 @@ namespace gs::rendering {
         // Other components clean up in their destructors
     }
 
+    c10::cuda::CUDAStream RenderingEngineImpl::viewerStream() const {
+        return stream_ ? c10::cuda::getStreamFromExternal(stream_, c10::cuda::current_device())
+                       : c10::cuda::getCurrentCUDAStream();
+    }
+
     bool RenderingEngineImpl::isInitialized() const {
         // Check if key components exist
         return quad_shader_.valid() && screen_renderer_;
     }
 
+    bool RenderingEngineImpl::ensureCameraFrustumRenderer() {
+        if (!camera_frustum_renderer_.isInitialized() && !camera_frustum_failed_) {
+            if (auto result = camera_frustum_renderer_.init(); !result) {
+                LOG_ERROR("Failed to initialize camera frustum renderer: {}", result.error());
+                // Non-critical, continue without it
+                camera_frustum_failed_ = true;
+            }
+        }
+        return camera_frustum_renderer_.isInitialized();
+    }
+
     Result<void> RenderingEngineImpl::initializeShaders() {
         LOG_TIMER_TRACE("RenderingEngineImpl::initializeShaders");
 
@@ -160,7 +177,21 @@ namespace gs::rendering {
             .point_cloud_mode = request.point_cloud_mode,
             .voxel_size = request.voxel_size,
             .gut = request.gut,
-            .sh_degree = request.sh_degree};
+            .sh_degree = request.sh_degree,
+            .present_direct = true,
+            .foveation = request.foveation,
+            .sh_lod_pixels = request.sh_lod_pixels,
+            .occlusion_culling = request.occlusion_culling,
+            .half_precision = request.half_precision,
+            .instances = request.instances,
+            .workload_heatmap = request.workload_heatmap};
+        if (request.render_rect) {
+            pipeline_req.render_rect = RenderRect{
+                .x = request.render_rect->x,
+                .y = request.render_rect->y,
+                .width = request.render_rect->z,
+                .height = request.render_rect->w};
+        }
 
         // Convert crop box if present
         std::unique_ptr<gs::geometry::BoundingBox> temp_crop_box;
@@ -175,6 +206,7 @@ namespace gs::rendering {
             pipeline_req.crop_box = temp_crop_box.get();
         }
 
+        c10::cuda::CUDAStreamGuard stream_guard(viewerStream());
         auto pipeline_result = pipeline_.render(splat_data, pipeline_req);
 
         if (!pipeline_result) {
@@ -185,7 +217,9 @@ namespace gs::rendering {
         // Convert result
         RenderResult result{
             .image = std::make_shared<torch::Tensor>(pipeline_result->image),
-            .depth = std::make_shared<torch::Tensor>(pipeline_result->depth)};
+            .depth = std::make_shared<torch::Tensor>(pipeline_result->depth),
+            .texture_id = pipeline_result->texture,
+            .workload = pipeline_result->workload};
 
         return result;
     }
@@ -205,6 +239,7 @@ namespace gs::rendering {
 
         LOG_TRACE("Rendering split view with {} panels", request.panels.size());
 
+        c10::cuda::CUDAStreamGuard stream_guard(viewerStream());
         return split_view_renderer_->render(request, pipeline_, *screen_renderer_, quad_shader_);
     }
 
@@ -230,9 +265,11 @@ namespace gs::rendering {
         RenderingPipeline::RenderResult internal_result;
         internal_result.image = *result.image;
         internal_result.depth = result.depth ? *result.depth : torch::Tensor();
+        internal_result.texture = result.texture_id;
         internal_result.valid = true;
 
-        if (auto upload_result = RenderingPipeline::uploadToScreen(internal_result, *screen_renderer_, viewport_size);
+        c10::cuda::CUDAStreamGuard stream_guard(viewerStream());
+        if (auto upload_result = RenderingPipeline::uploadToScreen(internal_result, *screen_renderer_);
             !upload_result) {
             LOG_ERROR("Failed to upload to screen: {}", upload_result.error());
             return upload_result;
@@ -346,7 +383,7 @@ namespace gs::rendering {
         const glm::vec3& train_color,
         const glm::vec3& eval_color) {
 
-        if (!camera_frustum_renderer_.isInitialized()) {
+        if (!ensureCameraFrustumRenderer()) {
             return {}; // Silent fail if not initialized
         }
 
@@ -364,7 +401,7 @@ namespace gs::rendering {
         const glm::vec3& eval_color,
         int highlight_index) {
 
-        if (!camera_frustum_renderer_.isInitialized()) {
+        if (!ensureCameraFrustumRenderer()) {
             return {}; // Silent fail if not initialized
         }
 
@@ -385,7 +422,7 @@ namespace gs::rendering {
         const ViewportData& viewport,
         float scale) {
 
-        if (!camera_frustum_renderer_.isInitialized()) {
+        if (!ensureCameraFrustumRenderer()) {
             return -1;
         }
 
@@ -422,6 +459,7 @@ namespace gs::rendering {
             .gut = request.gut,
             .sh_degree = request.sh_degree};
 
+        c10::cuda::CUDAStreamGuard stream_guard(viewerStream());
         auto result = pipeline_.render(model, internal_request);
 
         // Convert back to public types
@@ -15,6 +15,7 @@
 #include "split_view_renderer.hpp"
 #include "translation_gizmo.hpp"
 #include "viewport_gizmo.hpp"
+#include <c10/cuda/CUDAStream.h>
 
 namespace gs::rendering {
 
@@ -138,8 +139,11 @@ namespace gs::rendering {
 
     private:
         Result<void> initializeShaders();
+        // Initializes the camera frustum renderer on first use, once
+        bool ensureCameraFrustumRenderer();
         glm::mat4 createProjectionMatrix(const ViewportData& viewport) const;
         glm::mat4 createViewMatrix(const ViewportData& viewport) const;
+        c10::cuda::CUDAStream viewerStream() const;
 
         // Core components
         RenderingPipeline pipeline_;
@@ -155,12 +159,19 @@ namespace gs::rendering {
         ViewportGizmo viewport_gizmo_;
         TranslationGizmo translation_gizmo_;
         CameraFrustumRenderer camera_frustum_renderer_;
+        bool camera_frustum_failed_ = false;
 
         // Gizmo interaction adapter
         std::shared_ptr<GizmoInteractionAdapter> gizmo_interaction_;
 
         // Shaders
         ManagedShader quad_shader_;
+
+        // CUDA work of the viewer at the lowest stream priority, so a training run on a
+        // high-priority stream gets the SMs first. Blocking, which keeps it ordered with the
+        // legacy-stream work that loads and edits the scene. Never destroyed: tensors kept
+        // across frames return to the caching allocator under this stream.
+        cudaStream_t stream_ = nullptr;
     };
 
 } // namespace gs::rendering
\ No newline at end of file
@@ -6,10 +6,139 @@
 #include "gs_rasterizer.hpp"
 #include "training/rasterization/rasterizer.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <optional>
 #include <print>
 
 namespace gs::rendering {
 
+    namespace {
+        CropBox makeCropBox(const geometry::BoundingBox& box) {
+            CropBox crop{};
+            const glm::mat4 world_to_box = box.getworld2BBox().toMat4();
+            for (int r = 0; r < 3; ++r) {
+                for (int c = 0; c < 4; ++c) {
+                    crop.world_to_box[r * 4 + c] = world_to_box[c][r]; // glm is column-major
+                }
+            }
+            const glm::vec3 box_min = box.getMinBounds();
+            const glm::vec3 box_max = box.getMaxBounds();
+            for (int i = 0; i < 3; ++i) {
+                crop.box_min[i] = box_min[i];
+                crop.box_max[i] = box_max[i];
+            }
+            return crop;
+        }
+
+        // Quality of each rasterizer tile, 1 inside the inner radius falling linearly to 0 at the outer
+        torch::Tensor makeTileQuality(const Foveation& foveation, int width, int height) {
+            const int tiles_x = (width + quality_tile_size - 1) / quality_tile_size;
+            const int tiles_y = (height + quality_tile_size - 1) / quality_tile_size;
+            const auto options = torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA);
+            const auto x = (torch::arange(tiles_x, options) + 0.5f) * quality_tile_size - foveation.center.x * width;
+            const auto y = (torch::arange(tiles_y, options) + 0.5f) * quality_tile_size - foveation.center.y * height;
+            const float diagonal = std::hypot(static_cast<float>(width), static_cast<float>(height));
+            const auto distance = torch::sqrt(x.square().unsqueeze(0) + y.square().unsqueeze(1)) / diagonal;
+            const float falloff = std::max(foveation.outer_radius - foveation.inner_radius, 1e-6f);
+            return (1.0f - (distance - foveation.inner_radius) / falloff).clamp(0.0f, 1.0f).contiguous();
+        }
+
+        constexpr size_t worst_tile_count = 8;
+        constexpr float heatmap_opacity = 0.65f;
+
+        // Blue over green and yellow to red, t in [0, 1]
+        torch::Tensor heatColors(const torch::Tensor& t) {
+            const auto channel = [&t](float center) { return (1.5f - (4.0f * t - center).abs()).clamp(0.0f, 1.0f); };
+            return torch::stack({channel(3.0f), channel(2.0f), channel(1.0f)});
+        }
+
+        // Blends the workload of a training forward of the view over image and reports its heaviest tiles
+        std::shared_ptr<const WorkloadReport> overlayWorkload(torch::Tensor& image, Camera& cam,
+                                                              const SplatData& model, WorkloadHeatmap mode) {
+            const auto workload = training::fast_rasterize_workload(cam, model);
+            const int height = static_cast<int>(image.size(1));
+            const int width = static_cast<int>(image.size(2));
+
+            torch::Tensor counts;
+            if (mode == WorkloadHeatmap::TileInstances) {
+                counts = workload.tile_instances.repeat_interleave(workload.tile_height, 0)
+                             .repeat_interleave(workload.tile_width, 1)
+                             .narrow(0, 0, height)
+                             .narrow(1, 0, width);
+            } else {
+                counts = workload.pixel_contributors;
+            }
+            // Logarithmic, a few crowded tiles would flatten the rest of a linear scale
+            const auto level = torch::log1p(counts.to(torch::kFloat32));
+            const auto t = level / level.max().clamp_min(1e-6f);
+            image = image * (1.0f - heatmap_opacity) + heatColors(t) * heatmap_opacity;
+
+            auto report = std::make_shared<WorkloadReport>();
+            report->tile_size = {workload.tile_width, workload.tile_height};
+            report->grid_size = {static_cast<int>(workload.tile_instances.size(1)),
+                                 static_cast<int>(workload.tile_instances.size(0))};
+            const auto instances = workload.tile_instances.flatten().cpu();
+            const auto max_contributors = workload.tile_max_contributors.flatten().cpu();
+            report->total_instances = instances.sum(torch::kInt64).item<int64_t>();
+            report->mean_instances = static_cast<float>(report->total_instances) / std::max<int64_t>(instances.numel(), 1);
+            report->max_contributors = max_contributors.max().item<int>();
+
+            const auto [top, top_index] = instances.topk(std::min<int64_t>(worst_tile_count, instances.numel()));
+            for (int64_t i = 0; i < top.numel(); ++i) {
+                const int index = static_cast<int>(top_index[i].item<int64_t>());
+                const glm::ivec2 tile{index % report->grid_size.x, index / report->grid_size.x};
+                const glm::ivec2 origin = tile * report->tile_size;
+                report->worst_tiles.push_back({.tile = tile,
+                                               .pixels = {origin.x, origin.y,
+                                                          std::min(report->tile_size.x, width - origin.x),
+                                                          std::min(report->tile_size.y, height - origin.y)},
+                                               .instances = top[i].item<int>(),
+                                               .max_contributors = max_contributors[index].item<int>()});
+            }
+            return report;
+        }
+
+        // Instances packed as ModelPlacements reads them, the tensors keep the tables alive
+        struct PlacementTables {
+            torch::Tensor transforms;
+            torch::Tensor ranges;
+            ModelPlacements placements;
+        };
+
+        PlacementTables makePlacements(const std::vector<ModelInstance>& instances) {
+            const auto count = static_cast<int64_t>(instances.size());
+            auto transforms = torch::empty({count, 24}, torch::kFloat32);
+            auto ranges = torch::empty({count, 3}, torch::kInt32);
+            float* t = transforms.data_ptr<float>();
+            int32_t* r = ranges.data_ptr<int32_t>();
+            int64_t first_drawn = 0;
+            for (const auto& instance : instances) {
+                const glm::mat4 model_from_world = glm::inverse(instance.transform);
+                for (int row = 0; row < 3; ++row) {
+                    for (int col = 0; col < 4; ++col) {
+                        t[row * 4 + col] = instance.transform[col][row]; // glm is column-major
+                        t[12 + row * 4 + col] = model_from_world[col][row];
+                    }
+                }
+                r[0] = static_cast<int32_t>(instance.first_row);
+                r[1] = static_cast<int32_t>(instance.row_count);
+                r[2] = static_cast<int32_t>(first_drawn);
+                first_drawn += instance.row_count;
+                t += 24;
+                r += 3;
+            }
+            PlacementTables tables{.transforms = transforms.to(torch::kCUDA), .ranges = ranges.to(torch::kCUDA)};
+            tables.placements = ModelPlacements{
+                .transforms = tables.transforms.data_ptr<float>(),
+                .ranges = reinterpret_cast<const uint32_t*>(tables.ranges.data_ptr<int32_t>()),
+                .n_placements = static_cast<int>(count),
+                .n_drawn = static_cast<int>(first_drawn)};
+            return tables;
+        }
+    } // namespace
+
     RenderingPipeline::RenderingPipeline()
         : background_(torch::zeros({3}, torch::kFloat32).to(torch::kCUDA)) {
         point_cloud_renderer_ = std::make_unique<PointCloudRenderer>();
@@ -50,40 +179,60 @@ namespace gs::rendering {
         }
         Camera cam = std::move(*cam_result);
 
-        // Handle crop box conversion
-        const geometry::BoundingBox* geom_bbox = nullptr;
-        std::unique_ptr<geometry::BoundingBox> temp_bbox;
-
-        if (request.crop_box) {
-            // Create a temporary geometry::BoundingBox with the full transform
-            temp_bbox = std::make_unique<geometry::BoundingBox>();
-            temp_bbox->setBounds(request.crop_box->getMinBounds(), request.crop_box->getMaxBounds());
-            temp_bbox->setworld2BBox(request.crop_box->getworld2BBox());
-            geom_bbox = temp_bbox.get();
-            LOG_TRACE("Using crop box for rendering");
-        }
-
         try {
-            // Perform rendering with fast_rasterize
+            const auto mode = static_cast<training::RenderMode>(request.render_mode);
+            // The fastgs RGB path culls against the crop box in its preprocess, the others render a
+            // cropped copy
+            const bool use_cropped = request.crop_box && (request.gut || training::renderModeHasDepth(mode));
 
             SplatData cropped_model;
-            if (request.crop_box) {
+            if (use_cropped) {
                 cropped_model = model.crop_by_cropbox(*request.crop_box);
             }
 
-            SplatData& mutable_model = request.crop_box ? const_cast<SplatData&>(cropped_model) : const_cast<SplatData&>(model);
+            SplatData& mutable_model = use_cropped ? cropped_model : const_cast<SplatData&>(model);
 
             mutable_model.set_active_sh_degree(request.sh_degree);
 
             RenderResult result;
             if (request.gut) {
                 auto render_result = gs::training::rasterize(
-                    cam, mutable_model, background_, request.scaling_modifier, false, request.antialiasing, static_cast<training::RenderMode>(request.render_mode), nullptr);
+                    cam, mutable_model, background_, request.scaling_modifier, false, request.antialiasing, mode, nullptr);
                 result.image = render_result.image;
                 result.depth = render_result.depth;
+            } else if (training::renderModeHasDepth(mode)) {
+                auto render_result = gs::training::fast_rasterize_depth(cam, mutable_model, background_);
+                result.image = training::renderModeHasRGB(mode) ? torch::clamp(render_result.image, 0.0f, 1.0f) : torch::Tensor();
+                // fastgs yields expected depth, the accumulated modes weight it by alpha like gsplat does
+                const bool accumulated = mode == training::RenderMode::D || mode == training::RenderMode::RGB_D;
+                result.depth = accumulated ? render_result.depth * render_result.alpha : render_result.depth;
             } else {
-                result.image = rasterize(cam, mutable_model, background_);
-                result.depth = torch::empty({0}, torch::kFloat32); // No depth support in fast_rasterize; set empty
+                std::optional<CropBox> crop;
+                if (request.crop_box) {
+                    crop = makeCropBox(*request.crop_box);
+                    LOG_TRACE("Culling against the crop box in the rasterizer");
+                }
+                torch::Tensor quality_map;
+                std::optional<TileQuality> tile_quality;
+                if (request.foveation) {
+                    quality_map = makeTileQuality(*request.foveation, request.viewport_size.x, request.viewport_size.y);
+                    tile_quality = TileQuality{.quality = quality_map.data_ptr<float>()};
+                }
+                std::optional<PlacementTables> placements;
+                if (!request.instances.empty()) {
+                    placements = makePlacements(request.instances);
+                }
+                result.image = rasterize(cam, mutable_model, background_, crop ? &*crop : nullptr,
+                                         request.render_rect ? &*request.render_rect : nullptr,
+                                         tile_quality ? &*tile_quality : nullptr,
+                                         request.sh_lod_pixels,
+                                         request.occlusion_culling,
+                                         placements ? &placements->placements : nullptr,
+                                         request.half_precision);
+                result.depth = torch::empty({0}, torch::kFloat32);
+                if (request.workload_heatmap != WorkloadHeatmap::Off) {
+                    result.workload = overlayWorkload(result.image, cam, mutable_model, request.workload_heatmap);
+                }
             }
             result.valid = true;
 
@@ -161,60 +310,14 @@ namespace gs::rendering {
         float fov_rad = glm::radians(request.fov);
         glm::mat4 projection = glm::perspective(fov_rad, aspect, 0.1f, 1000.0f);
 
-        // Create framebuffer for offscreen rendering using RAII
-        auto fbo_result = create_vao(); // Using create_vao as proxy for FBO creation
-        if (!fbo_result) {
-            LOG_ERROR("Failed to create framebuffer");
-            return std::unexpected("Failed to create framebuffer");
-        }
+        // Render rows top to bottom, the layout of uploaded images, so the screen quad shows
+        // the texture as is
+        projection = glm::scale(glm::mat4(1.0f), glm::vec3(1.0f, -1.0f, 1.0f)) * projection;
 
-        GLuint fbo, color_texture, depth_texture;
-        glGenFramebuffers(1, &fbo);
-        if (fbo == 0) {
-            LOG_ERROR("Failed to create framebuffer - glGenFramebuffers returned 0");
-            return std::unexpected("Failed to create framebuffer");
-        }
-
-        // RAII cleanup for OpenGL resources
-        struct FBOGuard {
-            GLuint fbo, color_tex, depth_tex;
-            ~FBOGuard() {
-                if (fbo)
-                    glDeleteFramebuffers(1, &fbo);
-                if (color_tex)
-                    glDeleteTextures(1, &color_tex);
-                if (depth_tex)
-                    glDeleteTextures(1, &depth_tex);
-            }
-        } fbo_guard{fbo, 0, 0};
-
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-
-        // Color texture
-        glGenTextures(1, &color_texture);
-        fbo_guard.color_tex = color_texture;
-        glBindTexture(GL_TEXTURE_2D, color_texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, request.viewport_size.x, request.viewport_size.y,
-                     0, GL_RGB, GL_FLOAT, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color_texture, 0);
-
-        // Depth texture
-        glGenTextures(1, &depth_texture);
-        fbo_guard.depth_tex = depth_texture;
-        glBindTexture(GL_TEXTURE_2D, depth_texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, request.viewport_size.x, request.viewport_size.y,
-                     0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth_texture, 0);
-
-        GLenum fb_status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-        if (fb_status != GL_FRAMEBUFFER_COMPLETE) {
-            LOG_ERROR("Framebuffer not complete: 0x{:x}", fb_status);
-            return std::unexpected(std::format("Framebuffer not complete: 0x{:x}", fb_status));
+        if (auto target = ensurePointCloudTarget(request.viewport_size); !target) {
+            return std::unexpected(target.error());
         }
+        glBindFramebuffer(GL_FRAMEBUFFER, point_cloud_fbo_.get());
 
         // Set viewport to match the request size
         glViewport(0, 0, request.viewport_size.x, request.viewport_size.y);
@@ -227,33 +330,85 @@ namespace gs::rendering {
             return std::unexpected(std::format("Point cloud rendering failed: {}", result.error()));
         }
 
+        RenderResult result;
+        result.valid = true;
+        if (request.present_direct) {
+            // The screen quad samples the texture, nothing leaves the GPU
+            result.texture = point_cloud_color_.get();
+            LOG_TRACE("Point cloud rendering completed");
+            return result;
+        }
+
         // Read back the rendered image
-        std::vector<float> pixels(request.viewport_size.x * request.viewport_size.y * 3);
-        glReadPixels(0, 0, request.viewport_size.x, request.viewport_size.y, GL_RGB, GL_FLOAT, pixels.data());
+        std::vector<unsigned char> pixels(static_cast<size_t>(request.viewport_size.x) * request.viewport_size.y * 3);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, request.viewport_size.x, request.viewport_size.y, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
 
-        // Convert to torch tensor
-        auto options = torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCPU);
+        // Convert to CHW float format and move to CUDA
         torch::Tensor image_cpu = torch::from_blob(pixels.data(),
                                                    {request.viewport_size.y, request.viewport_size.x, 3},
-                                                   options)
-                                      .clone();
-
-        // Flip vertically (OpenGL has origin at bottom-left)
-        image_cpu = torch::flip(image_cpu, {0});
-
-        // Convert to CHW format and move to CUDA
-        RenderResult result;
-        result.image = image_cpu.permute({2, 0, 1}).to(torch::kCUDA);
-        result.valid = true;
+                                                   torch::kUInt8);
+        result.image = image_cpu.to(torch::kCUDA).permute({2, 0, 1}).to(torch::kFloat32) / 255.0f;
 
         LOG_TRACE("Point cloud rendering completed");
         return result;
     }
 
+    Result<void> RenderingPipeline::ensurePointCloudTarget(const glm::ivec2& size) {
+        if (point_cloud_fbo_ && point_cloud_size_ == size) {
+            return {};
+        }
+        LOG_DEBUG("Creating point cloud render target {}x{}", size.x, size.y);
+
+        GLuint ids[3] = {0, 0, 0};
+        glGenFramebuffers(1, &ids[0]);
+        glGenTextures(2, &ids[1]);
+        FBO fbo(ids[0]);
+        Texture color(ids[1]);
+        Texture depth(ids[2]);
+        if (!fbo || !color || !depth) {
+            LOG_ERROR("Failed to create point cloud render target");
+            return std::unexpected("Failed to create point cloud render target");
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo.get());
+
+        glBindTexture(GL_TEXTURE_2D, color.get());
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, color.get(), 0);
+
+        glBindTexture(GL_TEXTURE_2D, depth.get());
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, size.x, size.y, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth.get(), 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        GLenum fb_status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        if (fb_status != GL_FRAMEBUFFER_COMPLETE) {
+            LOG_ERROR("Framebuffer not complete: 0x{:x}", fb_status);
+            return std::unexpected(std::format("Framebuffer not complete: 0x{:x}", fb_status));
+        }
+
+        point_cloud_fbo_ = std::move(fbo);
+        point_cloud_color_ = std::move(color);
+        point_cloud_depth_ = std::move(depth);
+        point_cloud_size_ = size;
+        return {};
+    }
+
     Result<void> RenderingPipeline::uploadToScreen(
         const RenderResult& result,
-        ScreenQuadRenderer& renderer,
-        const glm::ivec2& viewport_size) {
+        ScreenQuadRenderer& renderer) {
+
+        if (result.valid && result.texture != 0) {
+            renderer.setExternalTexture(result.texture);
+            return {};
+        }
 
         if (!result.valid || !result.image.defined()) {
             LOG_ERROR("Invalid render result for upload");
@@ -263,12 +418,10 @@ namespace gs::rendering {
         // Try direct CUDA upload if available
         if (renderer.isInteropEnabled() && result.image.is_cuda()) {
             LOG_TRACE("Using CUDA interop for screen upload");
-            // Keep data on GPU - convert [C, H, W] to [H, W, C] format
-            auto image_hwc = result.image.permute({1, 2, 0}).contiguous();
-
-            if (image_hwc.size(0) == viewport_size.y && image_hwc.size(1) == viewport_size.x) {
-                return renderer.uploadFromCUDA(image_hwc, viewport_size.x, viewport_size.y);
-            }
+            // Keep data on GPU - an [H, W, C] view of [C, H, W], the upload kernel reads any strides
+            auto image_hwc = result.image.permute({1, 2, 0});
+            return renderer.uploadFromCUDA(image_hwc, static_cast<int>(image_hwc.size(1)),
+                                           static_cast<int>(image_hwc.size(0)));
         }
 
         // Fallback to CPU copy
@@ -279,15 +432,13 @@ namespace gs::rendering {
                          .permute({1, 2, 0})
                          .contiguous();
 
-        if (image.size(0) != viewport_size.y ||
-            image.size(1) != viewport_size.x ||
-            !image.data_ptr<unsigned char>()) {
-            LOG_ERROR("Image dimensions mismatch or invalid data");
-            return std::unexpected("Image dimensions mismatch or invalid data");
+        if (image.size(2) != 3 || !image.data_ptr<unsigned char>()) {
+            LOG_ERROR("Image channels mismatch or invalid data");
+            return std::unexpected("Image channels mismatch or invalid data");
         }
 
         return renderer.uploadData(image.data_ptr<unsigned char>(),
-                                   viewport_size.x, viewport_size.y);
+                                   static_cast<int>(image.size(1)), static_cast<int>(image.size(0)));
     }
 
     Result<Camera> RenderingPipeline::createCamera(const RenderRequest& request) {
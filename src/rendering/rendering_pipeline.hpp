@@ -8,10 +8,13 @@
 #include "core/splat_data.hpp"
 #include "geometry/bounding_box.hpp"
 #include "point_cloud_renderer.hpp"
+#include "rasterization_api.h"
 #include "rendering/rendering.hpp"
 #include "screen_renderer.hpp"
 #include <glm/glm.hpp>
+#include <optional>
 #include <torch/torch.h>
+#include <vector>
 
 namespace gs::rendering {
 
@@ -31,11 +34,21 @@ namespace gs::rendering {
             float voxel_size = 0.01f;
             bool gut = false;
             int sh_degree = 0;
+            bool present_direct = false; // Point cloud mode: leave the frame in a GL texture instead of reading it back
+            std::optional<RenderRect> render_rect; // Only this part is rasterized (fastgs RGB path), the rest is background
+            std::optional<Foveation> foveation;
+            float sh_lod_pixels = 0.0f; // Screen radius below which Gaussians drop to SH degree 0 (fastgs RGB path), 0: off
+            bool occlusion_culling = false; // Cull against the opaque depth of the last frame (fastgs RGB path)
+            bool half_precision = false;    // FP16 conics, opacities and colors in the blend (fastgs RGB path)
+            std::vector<ModelInstance> instances; // Model rows drawn at their poses (fastgs RGB path), empty: every row once
+            WorkloadHeatmap workload_heatmap = WorkloadHeatmap::Off; // Overlay of the blend workload (fastgs RGB path)
         };
 
         struct RenderResult {
             torch::Tensor image;
             torch::Tensor depth;
+            GLuint texture = 0; // Set instead of image by present_direct, valid until the next point cloud render
+            std::shared_ptr<const WorkloadReport> workload;
             bool valid = false;
         };
 
@@ -44,18 +57,24 @@ namespace gs::rendering {
         // Main render function - now returns Result
         Result<RenderResult> render(const SplatData& model, const RenderRequest& request);
 
-        // Static upload function - now returns Result
+        // Uploads the image at its own size, the screen quad stretches it over the GL viewport
         static Result<void> uploadToScreen(const RenderResult& result,
-                                           ScreenQuadRenderer& renderer,
-                                           const glm::ivec2& viewport_size);
+                                           ScreenQuadRenderer& renderer);
 
     private:
         Result<Camera> createCamera(const RenderRequest& request);
         glm::vec2 computeFov(float fov_degrees, int width, int height);
         Result<RenderResult> renderPointCloud(const SplatData& model, const RenderRequest& request);
+        Result<void> ensurePointCloudTarget(const glm::ivec2& size);
 
         torch::Tensor background_;
         std::unique_ptr<PointCloudRenderer> point_cloud_renderer_;
+
+        // Point cloud render target, kept across frames
+        FBO point_cloud_fbo_;
+        Texture point_cloud_color_;
+        Texture point_cloud_depth_;
+        glm::ivec2 point_cloud_size_{0, 0};
     };
 
 } // namespace gs::rendering
\ No newline at end of file
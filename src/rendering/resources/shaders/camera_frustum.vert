@@ -3,13 +3,21 @@
 // Vertex attributes
 layout(location = 0) in vec3 aPos;
 
-// Instance attributes
-layout(location = 1) in mat4 aInstanceMatrix;
-layout(location = 5) in vec4 aInstanceColorAlpha;  // Changed to vec4 to include alpha
+// One pose per camera, uploaded once; the instance transform and fading are derived here
+struct CameraPose {
+    mat4 camToWorld;
+    vec4 info; // x: 1 for eval cameras
+};
+layout(std430, binding = 0) readonly buffer CameraPoses {
+    CameraPose poses[];
+};
 
 // Uniforms
 uniform mat4 viewProj;
 uniform vec3 viewPos;
+uniform float frustumScale = 0.1;
+uniform vec3 trainColor = vec3(0.0, 1.0, 0.0);
+uniform vec3 evalColor = vec3(1.0, 0.0, 0.0);
 uniform bool pickingMode = false;
 
 // Outputs to fragment shader
@@ -18,32 +26,58 @@ out vec3 Normal;
 out vec4 vertexColor;
 flat out int instanceID;
 
+// Frustums fade out as the view gets close to them
+float fadeAlpha(float distance) {
+    float fadeStart = 5.0 * frustumScale;
+    float fadeEnd = 0.2 * frustumScale;
+    float minimumVisible = 0.1 * frustumScale;
+    if (distance < minimumVisible) {
+        return 0.0; // Completely invisible when very close
+    }
+    if (distance < fadeEnd) {
+        return 0.05; // Very faint
+    }
+    if (distance < fadeStart) {
+        float t = (distance - fadeEnd) / (fadeStart - fadeEnd);
+        return 0.05 + 0.95 * (t * t * (3.0 - 2.0 * t));
+    }
+    return 1.0;
+}
+
 void main() {
     // Pass instance ID (gl_InstanceID is the actual instance index)
     instanceID = gl_InstanceID;
-    
-    // Apply instance transformation
-    vec4 worldPos = aInstanceMatrix * vec4(aPos, 1.0);
-    
+
+    CameraPose pose = poses[gl_InstanceID];
+
+    // OpenGL to COLMAP camera axes, then the frustum size
+    vec3 localPos = aPos * vec3(1.0, -1.0, -1.0);
+    vec4 worldPos = pose.camToWorld * vec4(localPos * frustumScale, 1.0);
+
     // Simple normal calculation (assuming frustum faces outward)
-    Normal = normalize(mat3(aInstanceMatrix) * aPos);
-    
-    // Pass color with alpha
-    vertexColor = aInstanceColorAlpha;
-    
+    Normal = normalize(mat3(pose.camToWorld) * localPos);
+
     // World position for lighting
     FragPos = vec3(worldPos);
-    
+
     // Final position
     gl_Position = viewProj * worldPos;
-    
-    // In picking mode, encode instance ID as color
+
     if (pickingMode) {
-        // Encode instance ID + 1 (to avoid 0) as RGB
+        // Encode instance ID + 1 (to avoid 0) as RGB, every frustum stays pickable
         int id = gl_InstanceID + 1;
         float r = float((id >> 16) & 0xFF) / 255.0;
         float g = float((id >> 8) & 0xFF) / 255.0;
         float b = float(id & 0xFF) / 255.0;
         vertexColor = vec4(r, g, b, 1.0);
+        return;
+    }
+
+    float alpha = fadeAlpha(length(vec3(pose.camToWorld[3]) - viewPos));
+    vertexColor = vec4(pose.info.x > 0.5 ? evalColor : trainColor, alpha);
+
+    // Skip nearly invisible frustums: every vertex lands on the same point outside the clip volume
+    if (alpha <= 0.01) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
     }
 }
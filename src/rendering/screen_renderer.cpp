@@ -117,11 +117,13 @@ namespace gs::rendering {
         }
 
         LOG_TRACE("Uploading image data: {}x{}", width_, height_);
+        external_texture_ = 0;
         framebuffer->uploadImage(image, width_, height_);
         return {};
     }
 
     Result<void> ScreenQuadRenderer::uploadFromCUDA(const torch::Tensor& cuda_image, int width, int height) {
+        external_texture_ = 0;
 #ifdef CUDA_GL_INTEROP_ENABLED
         if (auto interop_fb = std::dynamic_pointer_cast<InteropFrameBuffer>(framebuffer)) {
             LOG_TRACE("Using CUDA interop for upload");
@@ -147,6 +149,9 @@ namespace gs::rendering {
     }
 
     GLuint ScreenQuadRenderer::getTextureID() const {
+        if (external_texture_ != 0) {
+            return external_texture_;
+        }
 #ifdef CUDA_GL_INTEROP_ENABLED
         if (auto interop_fb = std::dynamic_pointer_cast<InteropFrameBuffer>(framebuffer)) {
             return interop_fb->getInteropTexture();
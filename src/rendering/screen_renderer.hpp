@@ -32,7 +32,13 @@ namespace gs::rendering {
 
         bool isInteropEnabled() const;
 
+        // Draws this GL texture instead of the framebuffer's until the next upload, 0 to stop
+        void setExternalTexture(GLuint texture) { external_texture_ = texture; }
+
     protected:
         virtual GLuint getTextureID() const;
+
+    private:
+        GLuint external_texture_ = 0;
     };
 } // namespace gs::rendering
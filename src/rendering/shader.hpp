@@ -11,6 +11,7 @@
 // clang-format on
 
 #include "core/logger.hpp"
+#include "shader_cache.hpp"
 #include <filesystem>
 #include <format>
 #include <fstream>
@@ -138,8 +139,6 @@ namespace gs::rendering {
             // Clear any existing GL errors before we start
             while (glGetError() != GL_NO_ERROR) {}
 
-            GLint status;
-
             std::string vshader_source = readShaderSourceFromFile(vshader_path);
             std::string fshader_source = readShaderSourceFromFile(fshader_path);
 
@@ -152,104 +151,33 @@ namespace gs::rendering {
                 throw std::runtime_error(std::format("ERROR: Fragment shader source is empty for file: {}", fshader_path));
             }
 
-            constexpr GLsizei MAX_INFO_LOG_LENGTH = 2000;
-            GLsizei info_log_length;
-            GLchar info_log[MAX_INFO_LOG_LENGTH];
-            GLint compilation_status;
-            auto check_comp_status = [&](GLuint shader, const char* shader_type, const char* shader_file) {
-                glGetShaderiv(shader, GL_COMPILE_STATUS, &compilation_status);
-                if (compilation_status == GL_TRUE) {
-                    LOG_TRACE("{} shader compiled successfully: {}", shader_type, shader_file);
-                    return;
-                }
-                glGetShaderInfoLog(shader, MAX_INFO_LOG_LENGTH, &info_log_length, info_log);
-
-                // Extract line numbers from error messages if possible
-                std::string error_details(info_log);
-                LOG_ERROR("{} shader compilation error in file: {}", shader_type, shader_file);
-                LOG_ERROR("Compilation error details:\n{}", error_details);
-
-                // Try to show the problematic lines from source
-                std::istringstream source_stream(shader_type == std::string("Vertex") ? vshader_source : fshader_source);
-                std::string line;
-                int line_num = 1;
-                LOG_ERROR("Shader source preview:");
-                while (std::getline(source_stream, line) && line_num <= 10) {
-                    LOG_ERROR("  {:3}: {}", line_num++, line);
-                }
-
-                throw std::runtime_error(std::format("{} shader compilation error in {}: {}",
-                                                     shader_type, shader_file, info_log));
-            };
-
-            // Create and compile vertex shader
-            vshader = glCreateShader(GL_VERTEX_SHADER);
-            if (vshader == 0) {
-                GLenum err = glGetError();
-                LOG_ERROR("Failed to create vertex shader object: {}", getGLErrorString(err));
-                throw std::runtime_error(std::format("Failed to create vertex shader object: {}", getGLErrorString(err)));
-            }
-
-            const char* vshader_code = vshader_source.c_str();
-            glShaderSource(vshader, 1, &vshader_code, nullptr);
-            CHECK_GL_ERROR("glShaderSource (vertex)");
-
-            glCompileShader(vshader);
-            CHECK_GL_ERROR("glCompileShader (vertex)");
-            check_comp_status(vshader, "Vertex", vshader_path);
-
-            // Create and compile fragment shader
-            fshader = glCreateShader(GL_FRAGMENT_SHADER);
-            if (fshader == 0) {
-                GLenum err = glGetError();
-                LOG_ERROR("Failed to create fragment shader object: {}", getGLErrorString(err));
-                glDeleteShader(vshader); // Clean up vertex shader
-                throw std::runtime_error(std::format("Failed to create fragment shader object: {}", getGLErrorString(err)));
-            }
-
-            const char* fshader_code = fshader_source.c_str();
-            glShaderSource(fshader, 1, &fshader_code, nullptr);
-            CHECK_GL_ERROR("glShaderSource (fragment)");
-
-            glCompileShader(fshader);
-            CHECK_GL_ERROR("glCompileShader (fragment)");
-            check_comp_status(fshader, "Fragment", fshader_path);
-
-            // Create and link program
+            // Create the program, from the binary cache when the same sources were linked before
             program = glCreateProgram();
             if (program == 0) {
                 GLenum err = glGetError();
                 LOG_ERROR("Failed to create shader program object: {}", getGLErrorString(err));
-                glDeleteShader(vshader);
-                glDeleteShader(fshader);
                 throw std::runtime_error(std::format("Failed to create shader program object: {}", getGLErrorString(err)));
             }
 
-            glAttachShader(program, vshader);
-            CHECK_GL_ERROR("glAttachShader (vertex)");
-
-            glAttachShader(program, fshader);
-            CHECK_GL_ERROR("glAttachShader (fragment)");
-
-            glLinkProgram(program);
-            CHECK_GL_ERROR("glLinkProgram");
-
-            glGetProgramiv(program, GL_LINK_STATUS, &status);
-            if (status != GL_TRUE) {
-                glGetProgramInfoLog(program, MAX_INFO_LOG_LENGTH, nullptr, info_log);
-                LOG_ERROR("Shader link error for program using:");
-                LOG_ERROR("  Vertex shader: {}", vshader_path);
-                LOG_ERROR("  Fragment shader: {}", fshader_path);
-                LOG_ERROR("Link error details:\n{}", info_log);
-
-                // Clean up
-                glDeleteShader(vshader);
-                glDeleteShader(fshader);
-                glDeleteProgram(program);
-
-                throw std::runtime_error(std::format("Shader link error:\n{}", info_log));
+            auto& cache = ShaderCache::get();
+            const uint64_t cache_key = ShaderCache::hash_sources(vshader_source, fshader_source);
+            if (cache.load(program, cache_key)) {
+                LOG_DEBUG("Shader program {} loaded from the shader cache", program);
+            } else {
+                try {
+                    compileAndLink(vshader_source, fshader_source, cache.enabled());
+                } catch (...) {
+                    glDeleteProgram(program);
+                    program = 0;
+                    throw;
+                }
+                cache.store(program, cache_key);
             }
 
+            constexpr GLsizei MAX_INFO_LOG_LENGTH = 2000;
+            GLchar info_log[MAX_INFO_LOG_LENGTH];
+            GLint status;
+
             // Validate program
             glValidateProgram(program);
             glGetProgramiv(program, GL_VALIDATE_STATUS, &status);
@@ -293,8 +221,13 @@ namespace gs::rendering {
                 LOG_TRACE("Deleted index buffer {}", index_buffer);
             }
 
-            glDetachShader(program, fshader);
-            glDetachShader(program, vshader);
+            // A program linked from the shader cache has no shader objects
+            if (fshader != 0) {
+                glDetachShader(program, fshader);
+            }
+            if (vshader != 0) {
+                glDetachShader(program, vshader);
+            }
             glDeleteProgram(program);
             glDeleteShader(fshader);
             glDeleteShader(vshader);
@@ -455,6 +388,102 @@ namespace gs::rendering {
         }
 
     private:
+        // Compiles both stages from source and links them into program, retrievable asks the
+        // driver to keep the binary for the shader cache
+        void compileAndLink(const std::string& vshader_source, const std::string& fshader_source, bool retrievable) {
+            constexpr GLsizei MAX_INFO_LOG_LENGTH = 2000;
+            GLint status;
+            GLsizei info_log_length;
+            GLchar info_log[MAX_INFO_LOG_LENGTH];
+            GLint compilation_status;
+            auto check_comp_status = [&](GLuint shader, const char* shader_type, const char* shader_file) {
+                glGetShaderiv(shader, GL_COMPILE_STATUS, &compilation_status);
+                if (compilation_status == GL_TRUE) {
+                    LOG_TRACE("{} shader compiled successfully: {}", shader_type, shader_file);
+                    return;
+                }
+                glGetShaderInfoLog(shader, MAX_INFO_LOG_LENGTH, &info_log_length, info_log);
+
+                // Extract line numbers from error messages if possible
+                std::string error_details(info_log);
+                LOG_ERROR("{} shader compilation error in file: {}", shader_type, shader_file);
+                LOG_ERROR("Compilation error details:\n{}", error_details);
+
+                // Try to show the problematic lines from source
+                std::istringstream source_stream(shader_type == std::string("Vertex") ? vshader_source : fshader_source);
+                std::string line;
+                int line_num = 1;
+                LOG_ERROR("Shader source preview:");
+                while (std::getline(source_stream, line) && line_num <= 10) {
+                    LOG_ERROR("  {:3}: {}", line_num++, line);
+                }
+
+                throw std::runtime_error(std::format("{} shader compilation error in {}: {}",
+                                                     shader_type, shader_file, info_log));
+            };
+
+            // Create and compile vertex shader
+            vshader = glCreateShader(GL_VERTEX_SHADER);
+            if (vshader == 0) {
+                GLenum err = glGetError();
+                LOG_ERROR("Failed to create vertex shader object: {}", getGLErrorString(err));
+                throw std::runtime_error(std::format("Failed to create vertex shader object: {}", getGLErrorString(err)));
+            }
+
+            const char* vshader_code = vshader_source.c_str();
+            glShaderSource(vshader, 1, &vshader_code, nullptr);
+            CHECK_GL_ERROR("glShaderSource (vertex)");
+
+            glCompileShader(vshader);
+            CHECK_GL_ERROR("glCompileShader (vertex)");
+            check_comp_status(vshader, "Vertex", vshader_path_.c_str());
+
+            // Create and compile fragment shader
+            fshader = glCreateShader(GL_FRAGMENT_SHADER);
+            if (fshader == 0) {
+                GLenum err = glGetError();
+                LOG_ERROR("Failed to create fragment shader object: {}", getGLErrorString(err));
+                glDeleteShader(vshader); // Clean up vertex shader
+                throw std::runtime_error(std::format("Failed to create fragment shader object: {}", getGLErrorString(err)));
+            }
+
+            const char* fshader_code = fshader_source.c_str();
+            glShaderSource(fshader, 1, &fshader_code, nullptr);
+            CHECK_GL_ERROR("glShaderSource (fragment)");
+
+            glCompileShader(fshader);
+            CHECK_GL_ERROR("glCompileShader (fragment)");
+            check_comp_status(fshader, "Fragment", fshader_path_.c_str());
+
+            // Link into the program created by the constructor
+            glAttachShader(program, vshader);
+            CHECK_GL_ERROR("glAttachShader (vertex)");
+
+            glAttachShader(program, fshader);
+            CHECK_GL_ERROR("glAttachShader (fragment)");
+
+            if (retrievable) {
+                glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            }
+            glLinkProgram(program);
+            CHECK_GL_ERROR("glLinkProgram");
+
+            glGetProgramiv(program, GL_LINK_STATUS, &status);
+            if (status != GL_TRUE) {
+                glGetProgramInfoLog(program, MAX_INFO_LOG_LENGTH, nullptr, info_log);
+                LOG_ERROR("Shader link error for program using:");
+                LOG_ERROR("  Vertex shader: {}", vshader_path_);
+                LOG_ERROR("  Fragment shader: {}", fshader_path_);
+                LOG_ERROR("Link error details:\n{}", info_log);
+
+                // Clean up, the constructor deletes the program
+                glDeleteShader(vshader);
+                glDeleteShader(fshader);
+
+                throw std::runtime_error(std::format("Shader link error:\n{}", info_log));
+            }
+        }
+
         std::string readShaderSourceFromFile(const std::string& filePath) {
             LOG_TIMER_TRACE("Shader::readShaderSourceFromFile");
             LOG_TRACE("Reading shader source from: {}", filePath);
@@ -578,9 +607,9 @@ namespace gs::rendering {
             }
         }
 
-        GLuint program;
-        GLuint vshader;
-        GLuint fshader;
+        GLuint program = 0;
+        GLuint vshader = 0;
+        GLuint fshader = 0;
         std::string vshader_path_;
         std::string fshader_path_;
         std::map<std::string, GLint> uniforms;
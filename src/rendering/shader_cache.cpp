@@ -0,0 +1,188 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "shader_cache.hpp"
+#include "core/logger.hpp"
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <random>
+#include <system_error>
+#include <vector>
+
+namespace gs::rendering {
+
+    namespace {
+        constexpr uint32_t CACHE_MAGIC = 0x4253464c; // "LFSB"
+        constexpr uint32_t CACHE_VERSION = 1;
+
+        struct EntryHeader {
+            uint32_t magic = CACHE_MAGIC;
+            uint32_t version = CACHE_VERSION;
+            uint64_t driver = 0;
+            uint64_t key = 0;
+            uint32_t format = 0;
+            uint32_t length = 0;
+        };
+
+        // FNV-1a, stable across runs and platforms unlike std::hash
+        constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+        constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+
+        uint64_t fnv1a(std::string_view data, uint64_t hash = FNV_OFFSET) {
+            for (const char c : data) {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= FNV_PRIME;
+            }
+            return hash;
+        }
+
+        std::string_view gl_string(GLenum name) {
+            const auto* value = reinterpret_cast<const char*>(glGetString(name));
+            return value ? std::string_view(value) : std::string_view();
+        }
+    } // namespace
+
+    ShaderCache& ShaderCache::get() {
+        static ShaderCache instance;
+        return instance;
+    }
+
+    ShaderCache::ShaderCache() {
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        if (formats <= 0) {
+            LOG_DEBUG("The driver has no program binary formats, shaders compile from source");
+            return;
+        }
+
+        // A separator keeps "ab" + "c" apart from "a" + "bc"
+        driver_ = FNV_OFFSET;
+        for (const GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+            driver_ = fnv1a(gl_string(name), driver_);
+            driver_ = fnv1a(std::string_view("\n", 1), driver_);
+        }
+
+        const char* home = std::getenv("HOME");
+        dir_ = std::filesystem::path(home ? home : "") / ".cache" / "LichtFeld-Studio" / "shaders";
+        std::error_code ec;
+        std::filesystem::create_directories(dir_, ec);
+        if (ec) {
+            LOG_WARN("Shader cache disabled, cannot create {}: {}", dir_.string(), ec.message());
+            return;
+        }
+        enabled_ = true;
+        LOG_DEBUG("Shader cache in {} for {} / {}", dir_.string(), gl_string(GL_RENDERER), gl_string(GL_VERSION));
+    }
+
+    uint64_t ShaderCache::hash_sources(std::string_view vert_source, std::string_view frag_source) {
+        uint64_t hash = fnv1a(vert_source);
+        hash = fnv1a(std::string_view("\0", 1), hash);
+        return fnv1a(frag_source, hash);
+    }
+
+    std::filesystem::path ShaderCache::entry_path(uint64_t key) const {
+        return dir_ / std::format("{:016x}.bin", key);
+    }
+
+    bool ShaderCache::load(GLuint program, uint64_t key) {
+        if (!enabled_) {
+            return false;
+        }
+
+        const auto path = entry_path(key);
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+
+        EntryHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file || header.magic != CACHE_MAGIC || header.version != CACHE_VERSION ||
+            header.key != key || header.length == 0) {
+            LOG_DEBUG("Ignoring malformed shader cache entry {}", path.string());
+            return false;
+        }
+        if (header.driver != driver_) {
+            LOG_DEBUG("Shader cache entry {} is from another driver", path.string());
+            return false;
+        }
+
+        std::vector<char> binary(header.length);
+        file.read(binary.data(), static_cast<std::streamsize>(binary.size()));
+        if (!file) {
+            LOG_DEBUG("Shader cache entry {} is truncated", path.string());
+            return false;
+        }
+
+        glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+        GLint status = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        if (status != GL_TRUE) {
+            // Drivers may reject their own binaries after an update that kept the version string
+            while (glGetError() != GL_NO_ERROR) {}
+            LOG_DEBUG("Driver rejected shader cache entry {}, recompiling", path.string());
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+            return false;
+        }
+
+        LOG_TRACE("Program {} linked from shader cache entry {}", program, path.string());
+        return true;
+    }
+
+    void ShaderCache::store(GLuint program, uint64_t key) {
+        if (!enabled_) {
+            return;
+        }
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) {
+            LOG_DEBUG("Program {} has no retrievable binary", program);
+            return;
+        }
+
+        std::vector<char> binary(static_cast<size_t>(length));
+        GLsizei written = 0;
+        GLenum format = 0;
+        glGetProgramBinary(program, length, &written, &format, binary.data());
+        if (written <= 0) {
+            while (glGetError() != GL_NO_ERROR) {}
+            LOG_DEBUG("Failed to retrieve the binary of program {}", program);
+            return;
+        }
+
+        const EntryHeader header{.driver = driver_,
+                                 .key = key,
+                                 .format = format,
+                                 .length = static_cast<uint32_t>(written)};
+
+        // Written aside and renamed, another instance never reads a partial entry
+        const auto path = entry_path(key);
+        auto temp_path = path;
+        temp_path += std::format(".{:08x}.tmp", std::random_device{}());
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(binary.data(), written);
+            if (!file) {
+                LOG_DEBUG("Failed to write shader cache entry {}", temp_path.string());
+                file.close();
+                std::error_code ec;
+                std::filesystem::remove(temp_path, ec);
+                return;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(temp_path, path, ec);
+        if (ec) {
+            LOG_DEBUG("Failed to publish shader cache entry {}: {}", path.string(), ec.message());
+            std::filesystem::remove(temp_path, ec);
+            return;
+        }
+        LOG_TRACE("Stored program {} as shader cache entry {} ({} bytes)", program, path.string(), written);
+    }
+
+} // namespace gs::rendering
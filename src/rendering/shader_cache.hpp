@@ -0,0 +1,44 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace gs::rendering {
+
+    // Linked program binaries on disk, so a restart skips GLSL compilation. Entries are keyed by a
+    // hash of the program sources, the header records the driver (vendor, renderer and version
+    // strings) that produced them, so editing a shader or updating the driver recompiles it.
+    // GL thread only, the first get() needs a current context.
+    class ShaderCache {
+    public:
+        static ShaderCache& get();
+
+        static uint64_t hash_sources(std::string_view vert_source, std::string_view frag_source);
+
+        // Links program from the cached binary. False on a miss or a binary the driver rejects,
+        // program is still empty then and can be compiled from source.
+        bool load(GLuint program, uint64_t key);
+
+        // Saves a program linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT, failures are only logged
+        void store(GLuint program, uint64_t key);
+
+        bool enabled() const { return enabled_; }
+
+    private:
+        ShaderCache();
+
+        std::filesystem::path entry_path(uint64_t key) const;
+
+        std::filesystem::path dir_;
+        uint64_t driver_ = 0;  // Hash of the driver strings
+        bool enabled_ = false; // Off without a binary format or a writable directory
+    };
+
+} // namespace gs::rendering
@@ -6,6 +6,8 @@
 #include "core/logger.hpp"
 #include "core/splat_data.hpp"
 #include "gl_state_guard.hpp"
+#include <algorithm>
+#include <cmath>
 #include <glad/glad.h>
 
 namespace gs::rendering {
@@ -193,7 +195,15 @@ namespace gs::rendering {
                 .point_cloud_mode = request.point_cloud_mode,
                 .voxel_size = request.voxel_size,
                 .gut = request.gut,
-                .sh_degree = request.sh_degree};
+                .sh_degree = request.sh_degree,
+                .present_direct = true};
+
+            // The composite only shows the panel between its split positions, the rest is not
+            // rasterized. A pixel of margin on each side covers the rounding of the split.
+            const int width = request.viewport.size.x;
+            const int x_begin = std::max(static_cast<int>(std::floor(panel.start_position * width)) - 1, 0);
+            const int x_end = std::min(static_cast<int>(std::ceil(panel.end_position * width)) + 1, width);
+            base_req.render_rect = RenderRect{.x = x_begin, .y = 0, .width = x_end - x_begin, .height = request.viewport.size.y};
 
             // Handle crop box if present
             std::unique_ptr<geometry::BoundingBox> temp_crop_box;
@@ -213,7 +223,7 @@ namespace gs::rendering {
             }
 
             // Present to framebuffer
-            if (auto upload_result = RenderingPipeline::uploadToScreen(*render_result, screen_renderer, request.viewport.size);
+            if (auto upload_result = RenderingPipeline::uploadToScreen(*render_result, screen_renderer);
                 !upload_result) {
                 LOG_ERROR("Failed to upload model: {}", upload_result.error());
             } else {
@@ -0,0 +1,158 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "benchmark.hpp"
+#include "config.h"
+#include "core/logger.hpp"
+#include "core/profiler.hpp"
+#include <algorithm>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAFunctions.h>
+#include <cuda_runtime.h>
+#include <format>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+namespace gs::training {
+
+    namespace {
+        constexpr double MB = 1024.0 * 1024.0;
+        constexpr int CURVE_POINTS = 200;
+
+        double per_frame(unsigned long long total, unsigned long long frames) {
+            return frames > 0 ? static_cast<double>(total) / static_cast<double>(frames) : 0.0;
+        }
+    } // namespace
+
+    BenchmarkRecorder::BenchmarkRecorder(int iterations)
+        : curve_every_(std::max(1, iterations / CURVE_POINTS)) {}
+
+    void BenchmarkRecorder::start() {
+        cudaDeviceSynchronize();
+        start_ = std::chrono::steady_clock::now();
+        steps_ = 0;
+        curve_.clear();
+    }
+
+    void BenchmarkRecorder::record(int iteration, int64_t num_gaussians) {
+        if (steps_++ == 0) {
+            first_iteration_ = iteration;
+        }
+        last_iteration_ = iteration;
+
+        const auto stats = c10::cuda::CUDACachingAllocator::getDeviceStats(c10::cuda::current_device());
+        const auto aggregate = static_cast<size_t>(c10::CachingAllocator::StatType::AGGREGATE);
+        peak_allocated_bytes_ = std::max(peak_allocated_bytes_, stats.allocated_bytes[aggregate].peak);
+        peak_reserved_bytes_ = std::max(peak_reserved_bytes_, stats.reserved_bytes[aggregate].peak);
+        peak_inactive_split_bytes_ = std::max(peak_inactive_split_bytes_, stats.inactive_split_bytes[aggregate].peak);
+        alloc_retries_ = static_cast<int64_t>(stats.num_alloc_retries);
+
+        last_ = {iteration, num_gaussians};
+        if ((iteration - first_iteration_) % curve_every_ == 0) {
+            curve_.push_back(last_);
+            size_t free_bytes = 0;
+            size_t total_bytes = 0;
+            if (cudaMemGetInfo(&free_bytes, &total_bytes) == cudaSuccess) {
+                peak_device_used_bytes_ = std::max(peak_device_used_bytes_, total_bytes - free_bytes);
+            }
+        }
+    }
+
+    std::expected<void, std::string> BenchmarkRecorder::write(const std::filesystem::path& path, const RunStats& stats) {
+        cudaDeviceSynchronize();
+        const double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+        if (steps_ == 0) {
+            return std::unexpected("Benchmark recorded no training steps");
+        }
+
+        nlohmann::json report;
+        report["version"] = GIT_TAGGED_VERSION;
+        report["commit"] = GIT_COMMIT_HASH_SHORT;
+        report["seed"] = stats.seed;
+        report["deterministic"] = stats.deterministic;
+        report["strategy"] = stats.strategy;
+
+        cudaDeviceProp prop{};
+        if (cudaGetDeviceProperties(&prop, c10::cuda::current_device()) == cudaSuccess) {
+            report["gpu"] = {
+                {"name", prop.name},
+                {"compute_capability", std::format("{}.{}", prop.major, prop.minor)},
+                {"memory_mb", static_cast<double>(prop.totalGlobalMem) / MB}};
+        }
+
+        report["iterations"] = steps_;
+        report["first_iteration"] = first_iteration_;
+        report["last_iteration"] = last_iteration_;
+        report["wall_time_s"] = wall_s;
+        report["iterations_per_second"] = steps_ / wall_s;
+
+        // GPU time of the zones, iterations/s is the rate the phase alone would allow
+        auto phases = nlohmann::json::array();
+        for (const auto& zone : core::Profiler::get().session_times()) {
+            phases.push_back({{"zone", zone.name},
+                              {"depth", zone.depth},
+                              {"ms_per_iteration", zone.ms},
+                              {"iterations_per_second", zone.ms > 0.0 ? 1000.0 / zone.ms : 0.0},
+                              {"calls_per_iteration", zone.calls}});
+        }
+        report["phases"] = std::move(phases);
+
+        report["vram"] = {
+            {"peak_allocated_mb", static_cast<double>(peak_allocated_bytes_) / MB},
+            {"peak_reserved_mb", static_cast<double>(peak_reserved_bytes_) / MB},
+            {"peak_device_used_mb", static_cast<double>(peak_device_used_bytes_) / MB},
+            {"peak_inactive_split_mb", static_cast<double>(peak_inactive_split_bytes_) / MB},
+            {"alloc_retries", alloc_retries_},
+            {"allocator", c10::cuda::CUDACachingAllocator::get()->name()},
+            {"rasterizer_high_water_mb", static_cast<double>(stats.raster_high_water_bytes) / MB},
+            {"rasterizer_reserved_mb", static_cast<double>(stats.raster_reserved_bytes) / MB}};
+
+        // The last step closes the curve
+        auto curve = nlohmann::json::array();
+        for (const auto& point : curve_) {
+            curve.push_back({point.iteration, point.num_gaussians});
+        }
+        if (curve_.back().iteration != last_.iteration) {
+            curve.push_back({last_.iteration, last_.num_gaussians});
+        }
+        report["gaussians"] = {
+            {"final", last_.num_gaussians},
+            {"curve", std::move(curve)}};
+
+        report["dataloader"] = {
+            {"backend", stats.dataloader},
+            {"images_served", stats.loader.images_served},
+            {"stalls", stats.loader.stalls},
+            {"stall_ms_total", stats.loader.stall_ms_total},
+            {"stall_ms_per_iteration", stats.loader.stall_ms_total / steps_},
+            {"queue_depth_avg", stats.loader.queue_depth_avg},
+            {"queue_depth_max", stats.loader.queue_depth_max},
+            {"buffer_allocations", stats.loader.buffer_allocations}};
+
+        const auto& instances = stats.instances;
+        report["rasterizer"] = {
+            {"frames", instances.frames},
+            {"instances_per_frame", per_frame(instances.instances, instances.frames)},
+            {"bounding_instances_per_frame", per_frame(instances.bounding_instances, instances.frames)},
+            {"buckets_per_frame", per_frame(instances.buckets, instances.frames)}};
+
+        std::error_code ec;
+        if (path.has_parent_path()) {
+            std::filesystem::create_directories(path.parent_path(), ec);
+        }
+        std::ofstream file(path);
+        if (!file) {
+            return std::unexpected(std::format("Failed to open benchmark report '{}'", path.string()));
+        }
+        file << report.dump(2) << '\n';
+        if (!file) {
+            return std::unexpected(std::format("Failed to write benchmark report '{}'", path.string()));
+        }
+
+        LOG_INFO("Benchmark: {} iterations in {:.1f}s ({:.2f} it/s), peak {:.0f} MB allocated, report written to {}",
+                 steps_, wall_s, steps_ / wall_s, static_cast<double>(peak_allocated_bytes_) / MB, path.string());
+        return {};
+    }
+
+} // namespace gs::training
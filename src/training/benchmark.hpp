@@ -0,0 +1,67 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "dataloader.hpp"
+#include "rasterizer_context.h"
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace gs::training {
+
+    // Seed of torch, the view order and the crop windows in a --benchmark run
+    inline constexpr uint32_t BENCHMARK_SEED = 42;
+
+    // Throughput report of a --benchmark run. The trainer samples every step, phase times come from
+    // the profiling zones and the run-wide counters are handed over once training ends.
+    class BenchmarkRecorder {
+    public:
+        struct RunStats {
+            std::string strategy;
+            uint32_t seed = BENCHMARK_SEED;
+            bool deterministic = false;
+            std::string dataloader;
+            DataLoaderStats loader;
+            fast_gs::rasterization::InstanceStats instances;
+            size_t raster_high_water_bytes = 0; // Largest rasterizer buffers actually requested
+            size_t raster_reserved_bytes = 0;
+        };
+
+        explicit BenchmarkRecorder(int iterations);
+
+        // Starts the clock once setup is done
+        void start();
+
+        // After each completed step, samples the allocator peak and the Gaussian count curve
+        void record(int iteration, int64_t num_gaussians);
+
+        // Waits for the device, the wall time ends here
+        std::expected<void, std::string> write(const std::filesystem::path& path, const RunStats& stats);
+
+    private:
+        struct CurvePoint {
+            int iteration = 0;
+            int64_t num_gaussians = 0;
+        };
+
+        int curve_every_;
+        std::chrono::steady_clock::time_point start_;
+        int first_iteration_ = 0;
+        int last_iteration_ = 0;
+        int steps_ = 0;
+        int64_t peak_allocated_bytes_ = 0; // Sampled every step, refinement resets the allocator peak
+        int64_t peak_reserved_bytes_ = 0;
+        int64_t peak_inactive_split_bytes_ = 0; // Fragmentation, free bytes inside split blocks
+        int64_t alloc_retries_ = 0;
+        size_t peak_device_used_bytes_ = 0; // cudaMemGetInfo on the curve samples, other processes included
+        std::vector<CurvePoint> curve_; // Every curve_every_ steps from the first
+        CurvePoint last_;
+    };
+
+} // namespace gs::training
@@ -0,0 +1,259 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "checkpoint.hpp"
+#include "core/logger.hpp"
+#include "loader/formats/mmapped_file.hpp"
+#include <format>
+#include <fstream>
+#include <random>
+
+namespace gs::training {
+
+    namespace {
+        constexpr const char* MANIFEST_NAME = "manifest.json";
+        constexpr const char* BLOB_NAME = "tensors.bin";
+        constexpr const char* FORMAT_TAG = "lichtfeld-checkpoint";
+
+        // Stable on-disk names, independent of c10's printable type names
+        constexpr std::pair<torch::ScalarType, const char*> DTYPE_NAMES[] = {
+            {torch::kFloat32, "float32"},
+            {torch::kFloat16, "float16"},
+            {torch::kBFloat16, "bfloat16"},
+            {torch::kFloat64, "float64"},
+            {torch::kInt32, "int32"},
+            {torch::kInt64, "int64"},
+            {torch::kUInt8, "uint8"},
+            {torch::kBool, "bool"},
+        };
+
+        const char* dtype_name(torch::ScalarType dtype) {
+            for (const auto& [type, name] : DTYPE_NAMES) {
+                if (type == dtype) {
+                    return name;
+                }
+            }
+            return nullptr;
+        }
+
+        std::optional<torch::ScalarType> dtype_from_name(const std::string& name) {
+            for (const auto& [type, type_name] : DTYPE_NAMES) {
+                if (name == type_name) {
+                    return type;
+                }
+            }
+            return std::nullopt;
+        }
+
+        // Where write() parks the previous checkpoint while the new one moves into place
+        std::filesystem::path previous_dir(const std::filesystem::path& dir) {
+            return dir.string() + ".old";
+        }
+
+        // Removes the temporary directory of a write that did not complete, on every exit path
+        struct TemporaryDir {
+            std::filesystem::path path;
+            ~TemporaryDir() {
+                if (!path.empty()) {
+                    std::error_code ec;
+                    std::filesystem::remove_all(path, ec);
+                }
+            }
+        };
+
+        size_t align_up(size_t value) {
+            return (value + TrainingCheckpoint::BLOB_ALIGNMENT - 1) / TrainingCheckpoint::BLOB_ALIGNMENT *
+                   TrainingCheckpoint::BLOB_ALIGNMENT;
+        }
+    } // namespace
+
+    TrainingCheckpoint::TrainingCheckpoint() = default;
+    TrainingCheckpoint::~TrainingCheckpoint() = default;
+    TrainingCheckpoint::TrainingCheckpoint(TrainingCheckpoint&&) noexcept = default;
+    TrainingCheckpoint& TrainingCheckpoint::operator=(TrainingCheckpoint&&) noexcept = default;
+
+    void TrainingCheckpoint::put(const std::string& name, const torch::Tensor& tensor) {
+        blobs_.erase(name);
+        tensors_[name] = tensor.detach();
+    }
+
+    bool TrainingCheckpoint::contains(const std::string& name) const {
+        return tensors_.contains(name) || blobs_.contains(name);
+    }
+
+    torch::Tensor TrainingCheckpoint::get(const std::string& name, const torch::Device& device) const {
+        if (const auto it = tensors_.find(name); it != tensors_.end()) {
+            return it->second.to(device, /*non_blocking=*/false, /*copy=*/true);
+        }
+
+        const auto it = blobs_.find(name);
+        if (it == blobs_.end()) {
+            return {};
+        }
+        const Blob& blob = it->second;
+        auto* data = static_cast<char*>(mapping_->data) + blob.offset;
+        // The mapping is read-only, from_blob never writes and to(copy=true) detaches from it
+        return torch::from_blob(data, blob.shape, torch::TensorOptions().dtype(blob.dtype))
+            .to(device, /*non_blocking=*/false, /*copy=*/true);
+    }
+
+    std::expected<void, std::string> TrainingCheckpoint::write(const std::filesystem::path& dir) const {
+        namespace fs = std::filesystem;
+        TemporaryDir tmp;
+        try {
+            const fs::path tmp_dir = dir.string() + std::format(".tmp{:08x}", std::random_device{}());
+            tmp.path = tmp_dir;
+            fs::create_directories(tmp_dir);
+
+            nlohmann::json manifest;
+            manifest["format"] = FORMAT_TAG;
+            manifest["version"] = FORMAT_VERSION;
+            manifest["meta"] = meta_;
+            auto& entries = manifest["tensors"];
+            entries = nlohmann::json::object();
+
+            std::ofstream blob_file(tmp_dir / BLOB_NAME, std::ios::binary);
+            if (!blob_file) {
+                return std::unexpected(std::format("Cannot create {}", (tmp_dir / BLOB_NAME).string()));
+            }
+
+            static const char zeros[BLOB_ALIGNMENT] = {};
+            size_t offset = 0;
+            auto write_tensor = [&](const std::string& name, const torch::Tensor& tensor) -> std::expected<void, std::string> {
+                const char* type = dtype_name(tensor.scalar_type());
+                if (!type) {
+                    return std::unexpected(std::format("Unsupported dtype for checkpoint tensor '{}'", name));
+                }
+                const auto host = tensor.to(torch::kCPU).contiguous();
+                const size_t nbytes = host.nbytes();
+
+                const size_t aligned = align_up(offset);
+                blob_file.write(zeros, static_cast<std::streamsize>(aligned - offset));
+                blob_file.write(static_cast<const char*>(host.data_ptr()), static_cast<std::streamsize>(nbytes));
+                offset = aligned + nbytes;
+
+                entries[name] = {{"dtype", type},
+                                 {"shape", host.sizes().vec()},
+                                 {"offset", aligned},
+                                 {"nbytes", nbytes}};
+                return {};
+            };
+
+            for (const auto& [name, tensor] : tensors_) {
+                if (auto result = write_tensor(name, tensor); !result) {
+                    return result;
+                }
+            }
+            for (const auto& [name, blob] : blobs_) {
+                if (tensors_.contains(name)) {
+                    continue;
+                }
+                if (auto result = write_tensor(name, get(name, torch::kCPU)); !result) {
+                    return result;
+                }
+            }
+
+            blob_file.close();
+            if (!blob_file) {
+                return std::unexpected(std::format("Failed writing {}", (tmp_dir / BLOB_NAME).string()));
+            }
+
+            std::ofstream manifest_file(tmp_dir / MANIFEST_NAME);
+            manifest_file << manifest.dump(2);
+            manifest_file.close();
+            if (!manifest_file) {
+                return std::unexpected(std::format("Failed writing {}", (tmp_dir / MANIFEST_NAME).string()));
+            }
+
+            // rename() cannot replace a non-empty directory. The old checkpoint moves aside first
+            // and is only deleted once the new one is in place, read() falls back to it if a crash
+            // lands between the two renames.
+            const fs::path old_dir = previous_dir(dir);
+            fs::remove_all(old_dir);
+            if (fs::exists(dir)) {
+                fs::rename(dir, old_dir);
+            }
+            try {
+                fs::rename(tmp_dir, dir);
+            } catch (...) {
+                std::error_code ec;
+                if (fs::exists(old_dir, ec)) {
+                    fs::rename(old_dir, dir, ec);
+                }
+                throw;
+            }
+            tmp.path.clear();
+            std::error_code ec;
+            fs::remove_all(old_dir, ec);
+
+            LOG_DEBUG("Wrote checkpoint {} ({} tensors, {:.1f} MB)", dir.string(), entries.size(),
+                      offset / (1024.0 * 1024.0));
+            return {};
+        } catch (const std::exception& e) {
+            return std::unexpected(std::format("Failed to write checkpoint {}: {}", dir.string(), e.what()));
+        }
+    }
+
+    std::expected<TrainingCheckpoint, std::string> TrainingCheckpoint::read(const std::filesystem::path& path) {
+        // A write interrupted between its renames leaves only the previous checkpoint
+        std::filesystem::path dir = path;
+        if (std::error_code ec; !std::filesystem::exists(dir / MANIFEST_NAME, ec) &&
+                                std::filesystem::exists(previous_dir(dir) / MANIFEST_NAME, ec)) {
+            LOG_WARN("Checkpoint {} is incomplete, reading the previous one", path.string());
+            dir = previous_dir(path);
+        }
+        try {
+            std::ifstream manifest_file(dir / MANIFEST_NAME);
+            if (!manifest_file) {
+                return std::unexpected(std::format("No {} in {}", MANIFEST_NAME, dir.string()));
+            }
+            const auto manifest = nlohmann::json::parse(manifest_file);
+
+            if (manifest.value("format", "") != FORMAT_TAG) {
+                return std::unexpected(std::format("{} is not a training checkpoint", dir.string()));
+            }
+            if (const int version = manifest.value("version", 0); version != FORMAT_VERSION) {
+                return std::unexpected(std::format("Unsupported checkpoint version {} (expected {})",
+                                                   version, FORMAT_VERSION));
+            }
+
+            auto mapping = std::make_shared<loader::MMappedFile>();
+            if (!mapping->map(dir / BLOB_NAME)) {
+                return std::unexpected(std::format("Failed to map {}", (dir / BLOB_NAME).string()));
+            }
+
+            TrainingCheckpoint checkpoint;
+            checkpoint.meta_ = manifest.value("meta", nlohmann::json::object());
+
+            for (const auto& [name, entry] : manifest.at("tensors").items()) {
+                const auto dtype = dtype_from_name(entry.at("dtype").get<std::string>());
+                if (!dtype) {
+                    return std::unexpected(std::format("Unknown dtype for checkpoint tensor '{}'", name));
+                }
+
+                Blob blob{
+                    .dtype = *dtype,
+                    .shape = entry.at("shape").get<std::vector<int64_t>>(),
+                    .offset = entry.at("offset").get<size_t>(),
+                    .nbytes = entry.at("nbytes").get<size_t>()};
+
+                int64_t numel = 1;
+                for (const int64_t dim : blob.shape) {
+                    numel *= dim;
+                }
+                if (blob.nbytes != static_cast<size_t>(numel) * c10::elementSize(blob.dtype) ||
+                    blob.offset + blob.nbytes > mapping->size) {
+                    return std::unexpected(std::format("Checkpoint tensor '{}' is truncated or corrupt", name));
+                }
+                checkpoint.blobs_.emplace(name, std::move(blob));
+            }
+
+            checkpoint.mapping_ = std::move(mapping);
+            return checkpoint;
+        } catch (const std::exception& e) {
+            return std::unexpected(std::format("Failed to read checkpoint {}: {}", dir.string(), e.what()));
+        }
+    }
+
+} // namespace gs::training
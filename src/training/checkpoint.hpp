@@ -0,0 +1,75 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <expected>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <torch/torch.h>
+#include <vector>
+
+namespace gs::loader {
+    struct MMappedFile;
+}
+
+namespace gs::training {
+
+    // Resumable training state: named tensors plus free-form JSON metadata.
+    // On disk a checkpoint is a directory holding manifest.json and tensors.bin. Every tensor is
+    // a raw contiguous blob at a page-aligned offset, so a reader maps the file and uploads each
+    // tensor straight from the mapping without parsing or an intermediate host copy.
+    class TrainingCheckpoint {
+    public:
+        static constexpr int FORMAT_VERSION = 1;
+        static constexpr size_t BLOB_ALIGNMENT = 4096;
+
+        TrainingCheckpoint();
+        ~TrainingCheckpoint();
+
+        TrainingCheckpoint(TrainingCheckpoint&&) noexcept;
+        TrainingCheckpoint& operator=(TrainingCheckpoint&&) noexcept;
+
+        TrainingCheckpoint(const TrainingCheckpoint&) = delete;
+        TrainingCheckpoint& operator=(const TrainingCheckpoint&) = delete;
+
+        // Stores a tensor for writing, replacing any previous tensor of that name
+        void put(const std::string& name, const torch::Tensor& tensor);
+
+        bool contains(const std::string& name) const;
+
+        // Fresh copy of a stored tensor on device, undefined tensor if the name is missing
+        torch::Tensor get(const std::string& name, const torch::Device& device = torch::kCUDA) const;
+
+        nlohmann::json& meta() { return meta_; }
+        const nlohmann::json& meta() const { return meta_; }
+
+        int iteration() const { return meta_.value("iteration", 0); }
+        void set_iteration(int iteration) { meta_["iteration"] = iteration; }
+
+        // Writes into a sibling temporary directory and renames it over dir, so a reader
+        // never sees a half-written checkpoint after a crash or preemption. The previous
+        // checkpoint is kept as dir.old until the new one is in place.
+        std::expected<void, std::string> write(const std::filesystem::path& dir) const;
+
+        static std::expected<TrainingCheckpoint, std::string> read(const std::filesystem::path& dir);
+
+    private:
+        struct Blob {
+            torch::ScalarType dtype;
+            std::vector<int64_t> shape;
+            size_t offset = 0;
+            size_t nbytes = 0;
+        };
+
+        std::map<std::string, torch::Tensor> tensors_;    // Tensors added with put()
+        std::map<std::string, Blob> blobs_;               // Tensors backed by mapping_
+        std::shared_ptr<const loader::MMappedFile> mapping_;
+        nlohmann::json meta_ = nlohmann::json::object();
+    };
+
+} // namespace gs::training
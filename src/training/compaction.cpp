@@ -0,0 +1,312 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "compaction.hpp"
+#include "core/camera.hpp"
+#include "core/logger.hpp"
+#include "core/sogs.hpp"
+#include "core/splat_lod.hpp"
+#include "kernels/fused_ssim.cuh"
+#include "loader/loader.hpp"
+#include "metrics/metrics.hpp"
+#include "optimizers/fused_adam.hpp"
+#include "rasterization/fast_rasterizer.hpp"
+#include "strategies/strategy_utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <numbers>
+#include <torch/torch.h>
+
+namespace gs::training {
+
+    namespace {
+        constexpr float SH_C0 = 0.28209479177387814f;
+        constexpr int PRUNE_SEARCH_STEPS = 7;
+        constexpr float MAX_PRUNE_FRACTION = 0.95f;
+
+        struct ScoringView {
+            Camera* camera = nullptr;
+            torch::Tensor image; // [3, H, W] uint8 on the device, a quarter of the float copy
+        };
+
+        SplatData select_gaussians(const SplatData& splat, const torch::Tensor& indices) {
+            SplatData selected(splat.get_max_sh_degree(),
+                               splat.means().index_select(0, indices),
+                               splat.sh0().index_select(0, indices),
+                               splat.shN().index_select(0, indices),
+                               splat.scaling_raw().index_select(0, indices),
+                               splat.rotation_raw().index_select(0, indices),
+                               splat.opacity_raw().index_select(0, indices),
+                               splat.get_scene_scale());
+            selected.set_active_sh_degree(splat.get_active_sh_degree());
+            return selected;
+        }
+
+        float mean_psnr(const SplatData& model, const std::vector<ScoringView>& views, const torch::Tensor& bg,
+                        fast_gs::rasterization::RasterizerContext& context) {
+            const PSNR psnr;
+            torch::Tensor total = torch::zeros({}, bg.options());
+            for (const auto& view : views) {
+                const auto rendered = fast_render(*view.camera, model, bg, &context).image.clamp(0.f, 1.f);
+                total += psnr.compute_tensor(rendered.unsqueeze(0), (view.image.to(torch::kFloat32) / 255.f).unsqueeze(0));
+            }
+            return total.item<float>() / static_cast<float>(views.size());
+        }
+
+        // Zeroes each Gaussian's bands above the last one reaching tolerance and narrows shN to the
+        // highest band kept anywhere. Returns the [N, C, 1] mask of the kept coefficients.
+        torch::Tensor reduce_sh_degrees(SplatData& model, float tolerance) {
+            const int stored = model.get_stored_sh_degree();
+            if (stored == 0) {
+                return {};
+            }
+            torch::NoGradGuard no_grad;
+            const auto& shN = model.shN();
+            auto degree = torch::zeros({model.size()}, shN.options().dtype(torch::kInt32));
+            for (int band = 1; band <= stored; ++band) {
+                const auto coefficients = shN.slice(1, band * band - 1, (band + 1) * (band + 1) - 1).to(torch::kFloat32);
+                // Orthonormal bases: the squared coefficients integrate the squared color over the sphere
+                const auto rms = (coefficients.square().sum(1) / (4.f * std::numbers::pi_v<float>)).sqrt().amax(1);
+                degree = torch::where(rms >= tolerance, band, degree);
+            }
+
+            const auto histogram = torch::bincount(degree, {}, stored + 1).cpu();
+            const auto counts = histogram.accessor<int64_t, 1>();
+            std::string summary;
+            for (int d = 0; d <= stored; ++d) {
+                summary += std::format("{}degree {}: {}", d > 0 ? ", " : "", d, counts[d]);
+            }
+            LOG_INFO("Gaussians by needed SH degree, {}", summary);
+
+            int kept = 0;
+            for (int d = stored; d > 0; --d) {
+                if (counts[d] > 0) {
+                    kept = d;
+                    break;
+                }
+            }
+            const int bases = (kept + 1) * (kept + 1) - 1;
+            std::vector<int32_t> coefficient_bands;
+            for (int band = 1; band <= kept; ++band) {
+                coefficient_bands.insert(coefficient_bands.end(), 2 * band + 1, band);
+            }
+            const auto bands = torch::tensor(coefficient_bands, degree.options());
+            const auto mask = (bands.unsqueeze(0) <= degree.unsqueeze(1)).unsqueeze(2).to(shN.scalar_type());
+
+            model.shN() = (shN.slice(1, 0, bases) * mask).contiguous();
+            model.set_active_sh_degree(kept);
+            return mask;
+        }
+
+        // Accumulated blending weight of every Gaussian over the cameras: with zero sh0 all colors are
+        // 0.5 and unclamped, so the gradient of the image sum reaching sh0 is C0 times that weight
+        torch::Tensor contribution_scores(const SplatData& model, const std::vector<std::shared_ptr<Camera>>& cameras,
+                                          torch::Tensor& bg, fast_gs::rasterization::RasterizerContext& context) {
+            const auto probe = torch::zeros(model.sh0().sizes(), model.means().options()).set_requires_grad(true);
+            SplatData scoring(model.get_max_sh_degree(),
+                              model.means().detach(),
+                              probe,
+                              model.shN().detach(),
+                              model.scaling_raw().detach(),
+                              model.rotation_raw().detach(),
+                              model.opacity_raw().detach(),
+                              model.get_scene_scale());
+            scoring._densification_info = torch::empty({0}, model.means().options());
+            scoring._max_contribution = torch::empty({0}, model.means().options());
+            for (const auto& camera : cameras) {
+                fast_rasterize(*camera, scoring, bg, &context).image.sum().backward();
+            }
+            return probe.grad().sum({1, 2}) / (3.f * SH_C0);
+        }
+
+        void fine_tune(SplatData& model, const std::vector<std::shared_ptr<Camera>>& cameras, const torch::Tensor& sh_mask,
+                       int iterations, const param::DatasetConfig& dataset,
+                       const param::OptimizationParameters& optimization, torch::Tensor& bg,
+                       fast_gs::rasterization::RasterizerContext& context) {
+            // Every band trains from the first step, the positions at the end of the training schedule
+            auto params = optimization;
+            params.sh_degree_interval = 0;
+            params.means_lr *= 0.01f;
+
+            for (auto* param : {&model.means(), &model.sh0(), &model.shN(), &model.scaling_raw(),
+                                &model.rotation_raw(), &model.opacity_raw()}) {
+                param->set_requires_grad(true);
+            }
+            model._densification_info = torch::empty({0}, model.means().options());
+            model._max_contribution = torch::empty({0}, model.means().options());
+            auto optimizer = create_optimizer(model, params);
+            auto& adam = static_cast<FusedAdam&>(*optimizer);
+
+            const auto order = torch::randperm(static_cast<int64_t>(cameras.size()), torch::kInt64);
+            const auto order_acc = order.accessor<int64_t, 1>();
+            for (int iter = 1; iter <= iterations; ++iter) {
+                Camera& camera = *cameras[order_acc[(iter - 1) % order.size(0)]];
+                const auto gt = camera.load_and_get_image(dataset.resize_factor, dataset.max_width).slice(0, 0, 3).unsqueeze(0);
+                const auto rendered = fast_rasterize(camera, model, bg, &context).image.unsqueeze(0);
+                const auto loss = (1.f - params.lambda_dssim) * torch::l1_loss(rendered, gt) +
+                                  params.lambda_dssim * (1.f - fused_ssim(rendered, gt, "valid", /*train=*/true));
+                loss.backward();
+                adam.step(iter);
+                adam.zero_grad(true, iter);
+                if (sh_mask.defined()) {
+                    torch::NoGradGuard no_grad;
+                    model.shN().mul_(sh_mask);
+                }
+                if (iter % 100 == 0 || iter == iterations) {
+                    LOG_INFO("Fine-tune {}/{}, loss {:.4f}", iter, iterations, loss.item<float>());
+                }
+            }
+
+            for (auto* param : {&model.means(), &model.sh0(), &model.shN(), &model.scaling_raw(),
+                                &model.rotation_raw(), &model.opacity_raw()}) {
+                *param = param->detach();
+            }
+        }
+
+        std::expected<void, std::string> write_outputs(const SplatData& model, const param::CompactParameters& params,
+                                                       const std::filesystem::path& output_dir,
+                                                       const param::OptimizationParameters& optimization) {
+            const auto stem = params.model.stem().string() + "_compact";
+            for (const auto& format : params.formats) {
+                if (format == "ply") {
+                    model.save_ply(output_dir, 0, /*join_threads=*/true, stem);
+                } else if (format == "sog") {
+                    if (auto written = core::write_sog(model, {.iterations = optimization.sog_iterations,
+                                                               .webp_level = optimization.sog_webp_level,
+                                                               .output_path = output_dir / (stem + ".sog")});
+                        !written) {
+                        return std::unexpected(written.error());
+                    }
+                } else if (auto written = core::write_splat_lod(model, {.output_path = output_dir / (stem + core::SPLAT_LOD_EXTENSION)});
+                           !written) {
+                    return std::unexpected(written.error());
+                }
+            }
+            return {};
+        }
+    } // namespace
+
+    std::expected<CompactionReport, std::string> compact_model(const param::CompactParameters& params,
+                                                               const param::DatasetConfig& dataset,
+                                                               const param::OptimizationParameters& optimization) {
+        try {
+            auto loader = loader::Loader::create();
+            auto loaded_model = loader->load(params.model);
+            if (!loaded_model) {
+                return std::unexpected(loaded_model.error());
+            }
+            auto* splat = std::get_if<std::shared_ptr<SplatData>>(&loaded_model->data);
+            if (!splat || !*splat) {
+                return std::unexpected(std::format("{} is not a splat file", params.model.string()));
+            }
+            SplatData model = std::move(**splat);
+            model.set_active_sh_degree(model.get_max_sh_degree());
+
+            auto loaded_scene = loader->load(dataset.data_path, {.resize_factor = dataset.resize_factor,
+                                                                 .max_width = dataset.max_width,
+                                                                 .images_folder = dataset.images,
+                                                                 .undistort = dataset.undistort});
+            if (!loaded_scene) {
+                return std::unexpected(std::format("Failed to load dataset: {}", loaded_scene.error()));
+            }
+            const auto* scene = std::get_if<loader::LoadedScene>(&loaded_scene->data);
+            if (!scene || !scene->cameras) {
+                return std::unexpected(std::format("{} is not a dataset", dataset.data_path.string()));
+            }
+            auto cameras = scene->cameras->get_cameras();
+            if (cameras.empty()) {
+                return std::unexpected("The dataset has no cameras");
+            }
+            for (const auto& camera : cameras) {
+                if (camera->camera_model_type() != gsplat::CameraModelType::PINHOLE ||
+                    camera->radial_distortion().numel() != 0 || camera->tangential_distortion().numel() != 0) {
+                    return std::unexpected("Compaction renders with fastgs and needs undistorted pinhole cameras, try --undistort");
+                }
+                camera->load_image_size(dataset.resize_factor, dataset.max_width);
+            }
+            std::sort(cameras.begin(), cameras.end(), [](const auto& a, const auto& b) {
+                return a->image_name() < b->image_name();
+            });
+
+            // An even spread of the cameras, their images stay on the device for the bisection
+            const size_t view_count = params.views > 0 ? std::min<size_t>(params.views, cameras.size()) : cameras.size();
+            std::vector<ScoringView> views;
+            for (size_t i = 0; i < view_count; ++i) {
+                Camera* camera = cameras[i * cameras.size() / view_count].get();
+                const auto image = camera->load_and_get_image(dataset.resize_factor, dataset.max_width).slice(0, 0, 3);
+                views.push_back({camera, (image * 255.f).round().to(torch::kUInt8)});
+            }
+
+            torch::Tensor bg = torch::zeros({3}, model.means().options());
+            fast_gs::rasterization::RasterizerContext context;
+
+            CompactionReport report{.input_gaussians = model.size()};
+            report.input_psnr = mean_psnr(model, views, bg, context);
+            LOG_INFO("Compacting {} Gaussians, {:.2f} dB PSNR on {} views", model.size(), report.input_psnr, views.size());
+
+            const auto sh_mask = reduce_sh_degrees(model, params.sh_tolerance);
+            const float sh_psnr = mean_psnr(model, views, bg, context);
+            LOG_INFO("SH degree {} kept, {:.2f} dB", model.get_stored_sh_degree(), sh_psnr);
+
+            const auto scores = contribution_scores(model, cameras, bg, context);
+            const auto order = std::get<1>(scores.sort(/*stable=*/true, 0, /*descending=*/true));
+
+            // Bisection over the lowest scored share, keeping the shares that meet the budget
+            const float floor_psnr = report.input_psnr - params.max_psnr_drop;
+            const int64_t n = model.size();
+            const auto kept_after = [&order, n](float fraction) {
+                return order.slice(0, 0, std::max<int64_t>(1, std::llround(static_cast<double>(n) * (1.0 - fraction))));
+            };
+            float feasible = 0.f;
+            float infeasible = MAX_PRUNE_FRACTION;
+            if (sh_psnr >= floor_psnr) {
+                if (mean_psnr(select_gaussians(model, kept_after(infeasible)), views, bg, context) >= floor_psnr) {
+                    feasible = infeasible;
+                } else {
+                    for (int step = 0; step < PRUNE_SEARCH_STEPS; ++step) {
+                        const float fraction = 0.5f * (feasible + infeasible);
+                        const float psnr = mean_psnr(select_gaussians(model, kept_after(fraction)), views, bg, context);
+                        LOG_DEBUG("Pruning {:.1f}% of the Gaussians: {:.2f} dB", 100.f * fraction, psnr);
+                        if (psnr >= floor_psnr) {
+                            feasible = fraction;
+                        } else {
+                            infeasible = fraction;
+                        }
+                    }
+                }
+            } else {
+                LOG_WARN("The SH reduction alone exceeds the PSNR budget, no Gaussians are pruned");
+            }
+
+            const auto keep = kept_after(feasible);
+            SplatData compacted = select_gaussians(model, keep);
+            const torch::Tensor compacted_mask = sh_mask.defined() ? sh_mask.index_select(0, keep) : torch::Tensor();
+            LOG_INFO("Pruned {:.1f}% of the Gaussians, {} left", 100.f * feasible, compacted.size());
+
+            if (params.fine_tune_iterations > 0) {
+                fine_tune(compacted, cameras, compacted_mask, params.fine_tune_iterations, dataset, optimization, bg, context);
+            }
+            report.output_gaussians = compacted.size();
+            report.sh_degree = compacted.get_stored_sh_degree();
+            report.output_psnr = mean_psnr(compacted, views, bg, context);
+
+            std::error_code ec;
+            std::filesystem::create_directories(dataset.output_path, ec);
+            if (ec) {
+                return std::unexpected(std::format("Failed to create {}: {}", dataset.output_path.string(), ec.message()));
+            }
+            if (auto written = write_outputs(compacted, params, dataset.output_path, optimization); !written) {
+                return std::unexpected(written.error());
+            }
+
+            LOG_INFO("Compacted {} -> {} Gaussians at SH degree {}, {:.2f} -> {:.2f} dB PSNR",
+                     report.input_gaussians, report.output_gaussians, report.sh_degree, report.input_psnr, report.output_psnr);
+            return report;
+        } catch (const std::exception& e) {
+            return std::unexpected(std::format("Compaction failed: {}", e.what()));
+        }
+    }
+
+} // namespace gs::training
@@ -0,0 +1,34 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/parameters.hpp"
+#include <cstdint>
+#include <expected>
+#include <string>
+
+namespace gs::training {
+
+    struct CompactionReport {
+        int64_t input_gaussians = 0;
+        int64_t output_gaussians = 0;
+        int sh_degree = 0;       // Stored degree of the output
+        float input_psnr = 0.f;  // On the scoring views
+        float output_psnr = 0.f; // On the scoring views, after the fine-tune
+    };
+
+    // Shrinks a trained splat file for delivery against the dataset it was trained on, headless on
+    // the GPU. The SH bands of each Gaussian above the last one whose RMS color over the sphere
+    // reaches params.sh_tolerance are zeroed, and shN narrows to the highest band any Gaussian still
+    // uses. Every Gaussian is scored by its accumulated blending weight over the training views,
+    // and a bisection finds the largest share of the lowest scored ones whose removal keeps the mean
+    // PSNR on the scoring views within params.max_psnr_drop of the input model. A brief FusedAdam
+    // fine-tune over the training views follows, with the zeroed bands held at zero. The result is
+    // written under the model's stem in each of params.formats to output_dir.
+    std::expected<CompactionReport, std::string> compact_model(const param::CompactParameters& params,
+                                                               const param::DatasetConfig& dataset,
+                                                               const param::OptimizationParameters& optimization);
+
+} // namespace gs::training
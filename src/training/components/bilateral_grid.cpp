@@ -75,7 +75,7 @@ namespace gs::training {
     };
 
     // BilateralGrid implementation
-    BilateralGrid::BilateralGrid(int num_images, int grid_W, int grid_H, int grid_L)
+    BilateralGrid::BilateralGrid(int num_images, int grid_W, int grid_H, int grid_L, const std::string& precision)
         : num_images_(num_images),
           grid_width_(grid_W),
           grid_height_(grid_H),
@@ -87,14 +87,15 @@ namespace gs::training {
         grid = grid.reshape({1, grid_L, grid_H, grid_W, 12});
         grid = grid.permute({0, 4, 1, 2, 3});
 
-        grids_ = grid.repeat({num_images, 1, 1, 1, 1}).to(torch::kCUDA);
+        // FusedAdam keeps bfloat16 moments for reduced-precision grids, half of the FP32 state
+        const auto dtype = precision == "float16"    ? torch::kFloat16
+                           : precision == "bfloat16" ? torch::kBFloat16
+                                                     : torch::kFloat32;
+        grids_ = grid.repeat({num_images, 1, 1, 1, 1}).to(torch::kCUDA, dtype);
         grids_.set_requires_grad(true);
     }
 
     torch::Tensor BilateralGrid::apply(const torch::Tensor& rgb, int image_idx) {
-        TORCH_CHECK(image_idx >= 0 && image_idx < num_images_,
-                    "Invalid image index: ", image_idx);
-
         // Handle different input formats
         torch::Tensor rgb_processed;
         if (rgb.dim() == 4 && rgb.size(0) == 1) {
@@ -112,8 +113,7 @@ namespace gs::training {
         auto rgb_hwc = rgb_processed.permute({1, 2, 0}).contiguous();
 
         // Apply bilateral grid
-        auto grid = grids_[image_idx];
-        auto output = BilateralGridSliceFunction::apply(grid, rgb_hwc)[0];
+        auto output = BilateralGridSliceFunction::apply(grid(image_idx), rgb_hwc)[0];
 
         // Convert back to [C, H, W]
         auto result = output.permute({2, 0, 1}).contiguous();
@@ -126,8 +126,16 @@ namespace gs::training {
         return result;
     }
 
-    torch::Tensor BilateralGrid::tv_loss() const {
-        return BilateralGridTVLossFunction::apply(grids_);
+    torch::Tensor BilateralGrid::grid(int image_idx) const {
+        TORCH_CHECK(image_idx >= 0 && image_idx < num_images_,
+                    "Invalid image index: ", image_idx);
+        // One image's grid is small, its float32 copy costs nothing next to the storage of all of them
+        const auto grid = grids_[image_idx];
+        return grid.scalar_type() == torch::kFloat32 ? grid : grid.to(torch::kFloat32);
+    }
+
+    torch::Tensor BilateralGrid::tv_loss(int image_idx) const {
+        return BilateralGridTVLossFunction::apply(grid(image_idx).unsqueeze(0));
     }
 
 } // namespace gs::training
\ No newline at end of file
@@ -3,19 +3,27 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #pragma once
+#include <string>
 #include <torch/torch.h>
 
 namespace gs::training {
 
     class BilateralGrid {
     public:
-        BilateralGrid(int num_images, int grid_W = 16, int grid_H = 16, int grid_L = 8);
+        // precision is the storage of the grids (float32, float16 or bfloat16), the math stays FP32
+        BilateralGrid(int num_images, int grid_W = 16, int grid_H = 16, int grid_L = 8,
+                      const std::string& precision = "float32");
 
         // Apply bilateral grid to rendered image
         torch::Tensor apply(const torch::Tensor& rgb, int image_idx);
 
-        // Compute total variation loss
-        torch::Tensor tv_loss() const;
+        // [12, L, H, W] float32 grid of one image, for slicing inside fused_photometric_loss.
+        // Reduced-precision storage is widened here, the gradient narrows back through autograd.
+        torch::Tensor grid(int image_idx) const;
+
+        // Total variation loss of one image's grid. Evaluated every iteration on the image being
+        // trained, its expected gradient matches the loss over all grids.
+        torch::Tensor tv_loss(int image_idx) const;
 
         // Get parameters for optimizer
         torch::Tensor parameters() { return grids_; }
@@ -27,7 +35,7 @@ namespace gs::training {
         int grid_guidance() const { return grid_guidance_; }
 
     private:
-        torch::Tensor grids_; // [N, 12, L, H, W]
+        torch::Tensor grids_; // [N, 12, L, H, W] in the storage precision
         int num_images_;
         int grid_width_;
         int grid_height_;
@@ -0,0 +1,131 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "sog_quantizer.hpp"
+#include "core/logger.hpp"
+#include "core/sogs.hpp"
+#include "kernels/kmeans.cuh"
+#include <numbers>
+
+namespace gs::training {
+
+    namespace {
+        constexpr int CODEBOOK_SIZE = 256;
+        constexpr float OPACITY_EPS = 1e-6f; // Keeps the logit of a zero alpha finite
+
+        // Forwards as quantized, differentiates as raw
+        torch::Tensor straight_through(const torch::Tensor& raw, const torch::Tensor& quantized) {
+            return raw + (quantized.to(raw.scalar_type()) - raw).detach();
+        }
+
+        // Sorted entries of the 1D codebook write_sog fits to values
+        torch::Tensor fit_codebook(const torch::Tensor& values, int iterations) {
+            auto [centroids, labels] = gs::cuda::kmeans_1d(values.reshape({-1}).to(torch::kFloat32).contiguous(),
+                                                           CODEBOOK_SIZE, iterations);
+            return centroids.reshape({-1});
+        }
+
+        // Nearest entry of a sorted codebook, the split points are the midpoints between entries
+        torch::Tensor snap_to_codebook(const torch::Tensor& values, const torch::Tensor& codebook) {
+            const auto midpoints = (codebook.slice(0, 1) + codebook.slice(0, 0, -1)) * 0.5f;
+            const auto entries = torch::searchsorted(midpoints, values.reshape({-1}).to(torch::kFloat32).contiguous());
+            return codebook.index_select(0, entries).view(values.sizes());
+        }
+
+        // sign(x) log(|x| + 1) per axis over [min, max] at 16 bits, as sog_pack_means truncates
+        torch::Tensor quantize_means(const torch::Tensor& means) {
+            const auto log_means = torch::sign(means) * torch::log1p(torch::abs(means));
+            const auto lo = std::get<0>(log_means.min(0));
+            const auto extent = std::get<0>(log_means.max(0)) - lo;
+            const auto codes = torch::floor(((log_means - lo) / (extent + 1e-10f)).clamp(0.f, 1.f) * 65535.f);
+            const auto decoded = lo + codes / 65535.f * extent;
+            return torch::sign(decoded) * torch::expm1(torch::abs(decoded));
+        }
+
+        // Smallest three of the unit quaternion at 8 bits, the largest component rebuilt positive.
+        // Scaled back to the raw norm, the rasterizers normalize it away.
+        torch::Tensor quantize_rotations(const torch::Tensor& rotations) {
+            const auto norm = rotations.norm(2, 1, true);
+            const auto identity = torch::tensor({1.f, 0.f, 0.f, 0.f}, rotations.options()).expand_as(rotations);
+            const auto unit = torch::where(norm > 0, rotations / norm.clamp_min(1e-20f), identity);
+
+            const auto largest = unit.abs().argmax(1, true);
+            const auto sign = torch::where(unit.gather(1, largest) < 0, -1.f, 1.f);
+            const auto mask = torch::zeros_like(unit).scatter_(1, largest, 1.f);
+            const auto bytes = torch::floor(((unit * sign * std::numbers::sqrt2_v<float> * 0.5f + 0.5f) * 255.f).clamp(0.f, 255.f));
+            const auto kept = (bytes / 255.f * 2.f - 1.f) / std::numbers::sqrt2_v<float> * (1.f - mask);
+            const auto rebuilt = torch::sqrt((1.f - kept.square().sum(1, true)).clamp_min(0.f));
+            return (kept + mask * rebuilt) * torch::where(norm > 0, norm, torch::ones_like(norm));
+        }
+
+        // Alpha byte of the sh0 texture, truncated from the activated opacity
+        torch::Tensor quantize_opacities(const torch::Tensor& opacities) {
+            const auto alpha = torch::floor(torch::sigmoid(opacities.to(torch::kFloat32)) * 255.f) / 255.f;
+            return torch::logit(alpha.clamp(OPACITY_EPS, 1.f - OPACITY_EPS));
+        }
+    } // namespace
+
+    SogQuantizer::SogQuantizer(int kmeans_iterations)
+        : kmeans_iterations_(kmeans_iterations) {
+    }
+
+    void SogQuantizer::update(int iter, const SplatData& model) {
+        const int64_t n = model.size();
+        if (n == fitted_size_ && iter - fitted_iteration_ < REFIT_EVERY) {
+            return;
+        }
+
+        torch::NoGradGuard no_grad;
+        scale_codebook_ = fit_codebook(model.scaling_raw(), kmeans_iterations_);
+        color_codebook_ = fit_codebook(model.sh0(), kmeans_iterations_);
+
+        // write_sog only stores the bands of degrees 1 to 3
+        shN_palette_ = torch::Tensor();
+        shN_labels_ = torch::Tensor();
+        const auto& shN = model.shN();
+        const int64_t coeffs = shN.defined() && shN.dim() == 3 ? shN.size(1) : 0;
+        if (n > 0 && (coeffs == 3 || coeffs == 8 || coeffs == 15)) {
+            auto [palette, labels] = gs::cuda::kmeans(shN.reshape({n, coeffs * 3}).to(torch::kFloat32),
+                                                      core::sog_palette_size(n), kmeans_iterations_);
+            if (palette.size(0) > 0) {
+                auto [codebook, codes] = gs::cuda::kmeans_1d(palette.flatten(), CODEBOOK_SIZE, kmeans_iterations_);
+                shN_palette_ = codebook.reshape({-1}).index_select(0, codes.to(torch::kInt64)).view(palette.sizes());
+                shN_labels_ = labels.to(torch::kInt64);
+            }
+        }
+
+        fitted_iteration_ = iter;
+        fitted_size_ = n;
+        LOG_DEBUG("SOG quantizer refitted at iteration {} for {} Gaussians", iter, n);
+    }
+
+    SplatData SogQuantizer::quantize(SplatData& model) const {
+        torch::Tensor means, sh0, shN, scaling, rotation, opacity;
+        {
+            torch::NoGradGuard no_grad;
+            means = quantize_means(model.means().detach());
+            sh0 = snap_to_codebook(model.sh0().detach(), color_codebook_);
+            shN = shN_palette_.defined() ? shN_palette_.index_select(0, shN_labels_).view(model.shN().sizes())
+                                         : model.shN().detach();
+            scaling = snap_to_codebook(model.scaling_raw().detach(), scale_codebook_);
+            rotation = quantize_rotations(model.rotation_raw().detach());
+            opacity = quantize_opacities(model.opacity_raw().detach());
+        }
+
+        SplatData quantized(model.get_max_sh_degree(),
+                            straight_through(model.means(), means),
+                            straight_through(model.sh0(), sh0),
+                            straight_through(model.shN(), shN),
+                            straight_through(model.scaling_raw(), scaling),
+                            straight_through(model.rotation_raw(), rotation),
+                            straight_through(model.opacity_raw(), opacity),
+                            model.get_scene_scale());
+        quantized.set_active_sh_degree(model.get_active_sh_degree());
+        // The rasterizer accumulates into these in place, the strategy reads them from model
+        quantized._densification_info = model._densification_info;
+        quantized._max_contribution = model._max_contribution;
+        return quantized;
+    }
+
+} // namespace gs::training
@@ -0,0 +1,41 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/splat_data.hpp"
+#include <cstdint>
+#include <torch/torch.h>
+
+namespace gs::training {
+
+    // Quantization-aware training against gs::core::write_sog. The forward renders every attribute
+    // as the SOG bundle decodes it and the gradients pass straight through to the raw parameters:
+    // 16 bit log-space means, smallest-three 8 bit quaternions, 8 bit opacities, the 256 entry
+    // k-means codebooks of the scales and colors and the shN palette with its 256 entry codebook.
+    // The codebooks are refitted every REFIT_EVERY steps and whenever the Gaussian count changes;
+    // between refits the scales and colors snap to the nearest entry, shN keeps its palette labels.
+    class SogQuantizer {
+    public:
+        static constexpr int REFIT_EVERY = 200;
+
+        explicit SogQuantizer(int kmeans_iterations);
+
+        // Refits the codebooks to model when due
+        void update(int iter, const SplatData& model);
+
+        // Model whose attributes forward quantized, sharing the densification buffers of model
+        SplatData quantize(SplatData& model) const;
+
+    private:
+        int kmeans_iterations_;
+        int fitted_iteration_ = -1;
+        int64_t fitted_size_ = -1;
+        torch::Tensor scale_codebook_; // [256] sorted
+        torch::Tensor color_codebook_; // [256] sorted
+        torch::Tensor shN_palette_;    // [P, C * 3] through the codebook, undefined without SH bands
+        torch::Tensor shN_labels_;     // [N] palette entry of each Gaussian
+    };
+
+} // namespace gs::training
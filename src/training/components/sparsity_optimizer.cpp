@@ -4,11 +4,40 @@
 
 #include "sparsity_optimizer.hpp"
 #include "core/logger.hpp"
+#include "kernels/sparsity.cuh"
 #include <format>
 #include <print>
 
 namespace gs::training {
 
+    // Autograd function for the ADMM penalty 0.5 * rho * ||sigmoid(opacities) - z + u||^2
+    class ADMMSparsityLossFunction : public torch::autograd::Function<ADMMSparsityLossFunction> {
+    public:
+        static torch::Tensor forward(
+            torch::autograd::AutogradContext* ctx,
+            torch::Tensor opacities,
+            torch::Tensor z,
+            torch::Tensor u,
+            double rho) {
+            opacities = opacities.contiguous();
+            ctx->save_for_backward({opacities, z, u});
+            ctx->saved_data["rho"] = rho;
+            return sparsity::admm_loss_forward_cuda(opacities, z, u, static_cast<float>(rho));
+        }
+
+        static torch::autograd::tensor_list backward(
+            torch::autograd::AutogradContext* ctx,
+            torch::autograd::tensor_list grad_outputs) {
+            auto saved = ctx->get_saved_variables();
+            const float rho = static_cast<float>(ctx->saved_data["rho"].toDouble());
+
+            auto grad_opacities = sparsity::admm_loss_backward_cuda(
+                saved[0], saved[1], saved[2], rho, grad_outputs[0]);
+
+            return {grad_opacities, torch::Tensor(), torch::Tensor(), torch::Tensor()};
+        }
+    };
+
     ADMMSparsityOptimizer::ADMMSparsityOptimizer(const Config& config)
         : config_(config) {
         LOG_DEBUG("Initializing ADMM sparsity optimizer with rho={}, prune_ratio={}, steps={}, start_iteration={}",
@@ -24,9 +53,10 @@ namespace gs::training {
             }
 
             // Initialize ADMM variables
-            auto opa = torch::sigmoid(opacities).detach().contiguous();
+            const auto opa = opacities.detach().contiguous();
             u_ = torch::zeros_like(opa);
-            z_ = prune_z(opa + u_);
+            z_ = torch::empty_like(opa);
+            sparsity::admm_update_cuda(opa, z_, u_, get_num_to_prune(opa), /*update_dual=*/false);
             initialized_ = true;
 
             LOG_INFO("=== ADMM Sparsity Optimizer Initialized ===");
@@ -53,13 +83,8 @@ namespace gs::training {
                 return std::unexpected("Invalid opacity tensor for loss computation");
             }
 
-            // Compute ADMM sparsity loss
-            auto opa = torch::sigmoid(opacities);
-            auto diff = opa - z_.detach() + u_.detach();
-            auto loss = 0.5f * config_.init_rho * torch::pow(torch::norm(diff, 2), 2);
-
-            LOG_TRACE("ADMM sparsity loss: {}", loss.item<float>());
-            return loss;
+            // Fused ADMM sparsity loss, the value stays on the device
+            return ADMMSparsityLossFunction::apply(opacities, z_, u_, config_.init_rho);
         } catch (const std::exception& e) {
             LOG_ERROR("Failed to compute ADMM sparsity loss: {}", e.what());
             return std::unexpected(std::format("Failed to compute sparsity loss: {}", e.what()));
@@ -79,21 +104,12 @@ namespace gs::training {
                 return std::unexpected("Invalid opacity tensor for state update");
             }
 
-            // ADMM update step
-            auto opa = torch::sigmoid(opacities).detach().contiguous();
-            auto z_temp = opa + u_;
-            z_ = prune_z(z_temp);
-            u_ += opa - z_;
-
-            // Calculate sparsity statistics
-            int num_zeros = (z_ == 0).sum().item<int>();
-            float sparsity_ratio = static_cast<float>(num_zeros) / z_.numel();
-
-            LOG_TRACE("ADMM state updated - ||u||={:.4f}, ||z||={:.4f}, current sparsity={:.2f}%",
-                      torch::norm(u_).item<float>(),
-                      torch::norm(z_).item<float>(),
-                      sparsity_ratio * 100);
+            // ADMM update step: z = prune(sigmoid(opacities) + u), u += sigmoid(opacities) - z,
+            // fused with the threshold selection so the host never waits on the device
+            const auto opa = opacities.detach().contiguous();
+            sparsity::admm_update_cuda(opa, z_, u_, get_num_to_prune(opa));
 
+            LOG_TRACE("ADMM state updated");
             return {};
         } catch (const std::exception& e) {
             LOG_ERROR("Failed to update ADMM state: {}", e.what());
@@ -149,24 +165,6 @@ namespace gs::training {
         return static_cast<int>(config_.prune_ratio * opacities.flatten().size(0));
     }
 
-    torch::Tensor ADMMSparsityOptimizer::prune_z(const torch::Tensor& z) const {
-        if (z.numel() == 0) {
-            return torch::zeros_like(z);
-        }
-
-        int index = static_cast<int>(config_.prune_ratio * z.size(0));
-        if (index == 0) {
-            return torch::zeros_like(z);
-        }
-
-        // Sort to find threshold
-        auto [z_sorted, _] = torch::sort(z.flatten(), 0);
-        auto z_threshold = z_sorted[index - 1];
-
-        // Apply soft thresholding
-        return (z > z_threshold) * z;
-    }
-
     // Factory implementation
     std::unique_ptr<ISparsityOptimizer> SparsityOptimizerFactory::create(
         const std::string& method,
@@ -121,13 +121,6 @@ namespace gs::training {
         bool is_initialized() const override { return initialized_; }
 
     private:
-        /**
-         * @brief Apply soft thresholding to enforce sparsity
-         * @param z Input tensor
-         * @return Thresholded tensor
-         */
-        torch::Tensor prune_z(const torch::Tensor& z) const;
-
         Config config_;
         torch::Tensor u_; // Dual variable (Lagrange multiplier)
         torch::Tensor z_; // Auxiliary variable for sparsity
@@ -0,0 +1,40 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "convergence_monitor.hpp"
+#include "core/logger.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace gs::training {
+
+    ConvergenceMonitor::ConvergenceMonitor(const int window, const float threshold, const int start_iteration)
+        : window_(std::max(window, 1)),
+          threshold_(threshold),
+          start_iteration_(start_iteration),
+          decay_(std::min(10.0 / window_, 1.0)) {
+    }
+
+    bool ConvergenceMonitor::update(const int iteration, const float loss) {
+        // The sync-free step reports 0 until its first readback lands
+        if (!std::isfinite(loss) || loss <= 0.0f) {
+            return false;
+        }
+        average_ = average_ ? *average_ + decay_ * (loss - *average_) : loss;
+
+        if (iteration < start_iteration_ || (iteration - start_iteration_) % window_ != 0) {
+            return false;
+        }
+        const auto previous = window_start_average_;
+        window_start_average_ = average_;
+        if (!previous) {
+            return false;
+        }
+
+        const double gain = (*previous - *average_) / *previous;
+        LOG_DEBUG("Loss average {:.5f} at iteration {}, {:.3f}% below the last window", *average_, iteration, 100.0 * gain);
+        return gain < threshold_;
+    }
+
+} // namespace gs::training
@@ -0,0 +1,31 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <optional>
+
+namespace gs::training {
+
+    // Plateau test on the training loss. The per-step loss is noisy from view to view, so it is
+    // smoothed by an exponential moving average over a tenth of a window. From start_iteration on,
+    // the loss has converged once the average improved by less than threshold (relative) over
+    // one window.
+    class ConvergenceMonitor {
+    public:
+        ConvergenceMonitor(int window, float threshold, int start_iteration);
+
+        // Feeds the loss of a step, true at the window end the loss was found converged
+        bool update(int iteration, float loss);
+
+    private:
+        int window_;
+        float threshold_;
+        int start_iteration_;
+        double decay_;
+        std::optional<double> average_;
+        std::optional<double> window_start_average_; // At the last window end
+    };
+
+} // namespace gs::training
@@ -6,81 +6,174 @@
 #include "core/camera.hpp"
 #include "core/image_io.hpp"
 #include "core/logger.hpp"
+#include "core/thread_placement.hpp"
+#include "core/trace_recorder.hpp"
 #include <algorithm>
 #include <c10/cuda/CUDAGuard.h>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <numeric>
+#include <span>
 
 namespace gs::training {
 
+    namespace {
+        // Upper bound on decoded images waiting in VRAM. At 4K float32 one slot is ~100 MB,
+        // so the pool must not scale with num_workers.
+        constexpr int kMaxPrefetch = 8;
+
+        // Reads in flight at most, more queued views wait for a reader
+        constexpr int kMaxReadAheadThreads = 8;
+
+        double elapsed_ms(std::chrono::steady_clock::time_point start) {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+    } // namespace
+
+    std::string DataLoaderStats::to_string() const {
+        const double avg_stall = stalls > 0 ? stall_ms_total / static_cast<double>(stalls) : 0.;
+        if (queue_capacity == 0) {
+            return std::format("served {} images, waited {:.1f} ms total ({:.3f} ms/image)",
+                               images_served, stall_ms_total,
+                               images_served > 0 ? stall_ms_total / static_cast<double>(images_served) : 0.);
+        }
+        return std::format("served {} images, {} stalls ({:.1f}%, avg {:.2f} ms), queue depth avg {:.2f} / max {} of {}, "
+                           "{} buffer allocations",
+                           images_served, stalls, stall_ratio() * 100., avg_stall,
+                           queue_depth_avg, queue_depth_max, queue_capacity, buffer_allocations);
+    }
+
+    // =============================================================================
+    // Loss-weighted view sampling
+    // =============================================================================
+
+    ViewImportanceSampler::ViewImportanceSampler(const CameraDataset& dataset, float uniform_floor)
+        : uniform_floor_(std::clamp(uniform_floor, 0.f, 1.f)) {
+        const size_t dataset_size = dataset.size().value();
+        if (dataset_size == 0) {
+            throw std::runtime_error("ViewImportanceSampler: dataset is empty");
+        }
+        for (size_t i = 0; i < dataset_size; ++i) {
+            index_of_uid_.emplace(dataset.get_camera(i)->uid(), i);
+        }
+        loss_ema_.assign(dataset_size, -1.f);
+        rebuild_distribution();
+    }
+
+    void ViewImportanceSampler::record(int camera_uid, float loss) {
+        if (!std::isfinite(loss)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = index_of_uid_.find(camera_uid);
+        if (it == index_of_uid_.end()) {
+            return;
+        }
+        float& ema = loss_ema_[it->second];
+        ema = ema < 0.f ? loss : LOSS_EMA_DECAY * ema + (1.f - LOSS_EMA_DECAY) * loss;
+    }
+
+    size_t ViewImportanceSampler::draw(std::mt19937& rng) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (draws_until_rebuild_ == 0) {
+            rebuild_distribution();
+        }
+        --draws_until_rebuild_;
+        return distribution_(rng);
+    }
+
+    void ViewImportanceSampler::rebuild_distribution() {
+        const size_t n = loss_ema_.size();
+        const float hardest = *std::max_element(loss_ema_.begin(), loss_ema_.end());
+
+        std::vector<double> losses(n);
+        double total = 0.;
+        for (size_t i = 0; i < n; ++i) {
+            losses[i] = loss_ema_[i] < 0.f ? (hardest > 0.f ? hardest : 1.f) : loss_ema_[i];
+            total += losses[i];
+        }
+
+        std::vector<double> weights(n, uniform_floor_ / static_cast<double>(n));
+        if (total > 0.) {
+            for (size_t i = 0; i < n; ++i) {
+                weights[i] += (1. - uniform_floor_) * losses[i] / total;
+            }
+        }
+        distribution_ = std::discrete_distribution<size_t>(weights.begin(), weights.end());
+        draws_until_rebuild_ = n;
+    }
+
     // =============================================================================
     // Efficient Training DataLoader Implementation
     // =============================================================================
 
     EfficientDataLoader::EfficientDataLoader(
         std::shared_ptr<CameraDataset> dataset,
-        int num_workers)
-        : dataset_(dataset),
-          num_workers_(num_workers) {
+        int num_workers,
+        bool gpu_decode,
+        std::shared_ptr<ViewImportanceSampler> sampler,
+        std::optional<uint32_t> seed,
+        ReadAheadOptions read_ahead)
+        : dataset_(std::move(dataset)),
+          num_workers_(std::max(1, num_workers)),
+          gpu_decode_(gpu_decode && gpu_image_decode_available()),
+          sampler_(std::move(sampler)) {
 
         // Get the actual dataset size (respects train/val split)
-        size_t dataset_size = dataset_->size();
+        const size_t dataset_size = dataset_->size().value();
+        if (dataset_size == 0) {
+            throw std::runtime_error("EfficientDataLoader: dataset is empty");
+        }
+
+        if (seed) {
+            rng_.seed(*seed);
+        }
 
         // Initialize indices for the dataset (not all cameras!)
         indices_.resize(dataset_size);
         std::iota(indices_.begin(), indices_.end(), 0);
         std::shuffle(indices_.begin(), indices_.end(), rng_);
 
-        // Pre-allocate GPU buffers - this is THE key optimization
-        // We allocate num_workers * 2 buffers for double buffering
-        const size_t buffer_count = num_workers * 2;
+        // One slot per prefetched example plus the one currently held by the trainer.
+        // Buffers are allocated by the workers on first use, at the decoded image size.
+        const int prefetch = std::clamp(num_workers_, 2, kMaxPrefetch);
+        const size_t buffer_count = static_cast<size_t>(prefetch) + 1;
         buffer_pool_.reserve(buffer_count);
-
-        LOG_INFO("Pre-allocating {} GPU buffers for efficient dataloader", buffer_count);
-        LOG_INFO("Dataset size: {} images", dataset_size);
-
-        // Estimate size from first image
-        if (dataset_size > 0) {
-            // Get first camera through the dataset to respect the split
-            auto first_example = dataset_->get(0);
-            Camera* first_camera = first_example.camera;
-
-            auto [w, h, c] = get_image_info(first_camera->image_path());
-            int resize = dataset_->get_resize_factor();
-            if (resize > 1) {
-                w /= resize;
-                h /= resize;
-            }
-
-            // Pre-allocate GPU tensors
-            for (size_t i = 0; i < buffer_count; ++i) {
-                auto slot = std::make_unique<BufferSlot>();
-                // Allocate GPU memory once
-                slot->gpu_buffer = torch::empty(
-                    {c, h, w}, // CHW format
-                    torch::TensorOptions()
-                        .dtype(torch::kFloat32)
-                        .device(torch::kCUDA));
-                slot->last_width = w;
-                slot->last_height = h;
-                buffer_pool_.push_back(std::move(slot));
+        free_slots_.reserve(buffer_count);
+        for (size_t i = 0; i < buffer_count; ++i) {
+            buffer_pool_.push_back(std::make_unique<BufferSlot>());
+            free_slots_.push_back(buffer_pool_.back().get());
+        }
+        stats_.queue_capacity = buffer_count;
+
+        if (read_ahead.depth > 0) {
+            if (image_io::DiskImageCache::instance().is_enabled()) {
+                // Cached entries are read instead of the source files
+                LOG_INFO("Disk image cache enabled, not reading source images ahead");
+            } else {
+                read_ahead_depth_ = read_ahead.depth;
+                read_ahead_ = std::make_unique<FileReadAhead>(
+                    static_cast<int>(std::min<size_t>(read_ahead.depth, kMaxReadAheadThreads)),
+                    std::move(read_ahead.mirror_dir));
             }
-
-            size_t total_vram = buffer_count * w * h * c * sizeof(float);
-            LOG_INFO("Total VRAM pre-allocated for dataloader: {:.2f} MB",
-                     total_vram / (1024.0 * 1024.0));
         }
 
-        // Start worker threads
-        for (int i = 0; i < num_workers_; ++i) {
-            workers_.emplace_back(&EfficientDataLoader::worker_thread, this, i);
-        }
+        LOG_INFO("Efficient dataloader: {} images, {} workers, {} GPU buffer slots, {} files read ahead",
+                 dataset_size, num_workers_, buffer_count, read_ahead_depth_);
 
+        set_worker_count(num_workers_);
         LOG_DEBUG("Started {} dataloader worker threads", num_workers_);
     }
 
     EfficientDataLoader::~EfficientDataLoader() {
-        should_stop_ = true;
+        {
+            std::lock_guard<std::mutex> lock(workers_mutex_);
+            should_stop_ = true;
+        }
+        workers_cv_.notify_all();
+        pool_cv_.notify_all();
         queue_cv_.notify_all();
-        space_cv_.notify_all();
 
         for (auto& worker : workers_) {
             if (worker.joinable()) {
@@ -91,123 +184,204 @@ namespace gs::training {
         LOG_DEBUG("Stopped all dataloader worker threads");
     }
 
-    EfficientDataLoader::BufferSlot* EfficientDataLoader::acquire_buffer() {
-        // Find an unused buffer
-        while (!should_stop_) {
-            for (auto& slot : buffer_pool_) {
-                bool expected = false;
-                if (slot->in_use.compare_exchange_strong(expected, true)) {
-                    return slot.get();
+    void EfficientDataLoader::set_worker_count(int count) {
+        count = std::max(1, count);
+        {
+            std::lock_guard<std::mutex> lock(workers_mutex_);
+            for (int id = static_cast<int>(workers_.size()); id < count; ++id) {
+                workers_.emplace_back(&EfficientDataLoader::worker_thread, this, id);
+            }
+            active_workers_ = count;
+        }
+        workers_cv_.notify_all();
+    }
+
+    EfficientDataLoader::BufferSlot* EfficientDataLoader::acquire_buffer(int width, int height) {
+        std::unique_lock<std::mutex> lock(pool_mutex_);
+        pool_cv_.wait(lock, [this] { return !free_slots_.empty() || should_stop_; });
+        if (should_stop_) {
+            return nullptr;
+        }
+
+        // A free slot of this size, else an unallocated one, else one of the size with the most
+        // free slots. Oldest releases first, their consumed events are the likeliest to be done.
+        const auto same_size = [](const BufferSlot* a, int w, int h) {
+            return a->last_width == w && a->last_height == h;
+        };
+        auto it = std::find_if(free_slots_.begin(), free_slots_.end(),
+                               [&](const BufferSlot* s) { return same_size(s, width, height); });
+        if (it == free_slots_.end()) {
+            it = std::find_if(free_slots_.begin(), free_slots_.end(),
+                              [](const BufferSlot* s) { return !s->gpu_buffer.defined(); });
+        }
+        if (it == free_slots_.end()) {
+            std::ptrdiff_t most_free = 0;
+            for (auto candidate = free_slots_.begin(); candidate != free_slots_.end(); ++candidate) {
+                const auto count = std::count_if(free_slots_.begin(), free_slots_.end(), [&](const BufferSlot* s) {
+                    return same_size(s, (*candidate)->last_width, (*candidate)->last_height);
+                });
+                if (count > most_free) {
+                    most_free = count;
+                    it = candidate;
                 }
             }
-            // If no buffer available, wait a bit
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
         }
-        return nullptr;
+        BufferSlot* slot = *it;
+        free_slots_.erase(it);
+        return slot;
     }
 
-    void EfficientDataLoader::release_buffer(BufferSlot* buffer) {
-        if (buffer) {
-            buffer->in_use = false;
+    void EfficientDataLoader::release_buffer(BufferSlot* slot) {
+        // Kernels reading this buffer may still be queued on the trainer stream;
+        // the worker that reuses the slot waits on this event before overwriting it.
+        slot->consumed_event.record(at::cuda::getCurrentCUDAStream());
+        slot->ever_consumed = true;
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex_);
+            free_slots_.push_back(slot);
         }
+        pool_cv_.notify_one();
+    }
+
+    EfficientDataLoader::UpcomingView EfficientDataLoader::next_view() {
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        if (!read_ahead_) {
+            return {draw_dataset_index(), {}};
+        }
+
+        // Keeps read_ahead_depth_ views queued behind this one, their reads issued in draw order
+        const auto& cache = dataset_->get_image_cache();
+        while (upcoming_.size() <= read_ahead_depth_) {
+            UpcomingView view{draw_dataset_index(), {}};
+            const Camera* camera = dataset_->get_camera(view.index);
+            if (!(cache && !cache->on_device() && cache->find(camera->uid()))) {
+                view.encoded = read_ahead_->read(camera->image_path());
+            }
+            upcoming_.push_back(std::move(view));
+        }
+        UpcomingView view = std::move(upcoming_.front());
+        upcoming_.pop_front();
+        return view;
+    }
+
+    size_t EfficientDataLoader::draw_dataset_index() {
+        if (sampler_) {
+            return sampler_->draw(rng_);
+        }
+        if (next_index_ >= indices_.size()) {
+            // Reshuffle for new epoch
+            std::shuffle(indices_.begin(), indices_.end(), rng_);
+            next_index_ = 0;
+            LOG_TRACE("Dataloader reshuffled dataset for new epoch");
+        }
+        return indices_[next_index_++];
     }
 
     void EfficientDataLoader::worker_thread(int worker_id) {
         const int resize_factor = dataset_->get_resize_factor();
+        const int max_width = dataset_->get_max_width();
+
+        core::ThreadPlacement::get().pin_current_thread();
+        core::TraceRecorder::get().set_thread_name(std::format("dataloader worker {}", worker_id));
 
         // Create a dedicated CUDA stream for this worker
         at::cuda::CUDAStream stream = at::cuda::getStreamFromPool(false);
 
         while (!should_stop_) {
-            // Check if queue has space
-            {
-                std::unique_lock<std::mutex> lock(queue_mutex_);
-                space_cv_.wait(lock, [this] {
-                    return ready_queue_.size() < static_cast<size_t>(num_workers_ * 2) || should_stop_;
-                });
-
-                if (should_stop_)
-                    break;
+            if (worker_id >= active_workers_.load()) {
+                std::unique_lock<std::mutex> lock(workers_mutex_);
+                workers_cv_.wait(lock, [&] { return worker_id < active_workers_.load() || should_stop_; });
+                continue;
             }
 
-            // Get next index
-            size_t dataset_idx;
-            {
-                std::lock_guard<std::mutex> lock(index_mutex_);
-                if (next_index_ >= indices_.size()) {
-                    // Reshuffle for new epoch
-                    std::shuffle(indices_.begin(), indices_.end(), rng_);
-                    next_index_ = 0;
-                    LOG_TRACE("Worker {} reshuffled dataset for new epoch", worker_id);
+            // Only cameras of this dataset's split are returned here
+            const UpcomingView view = next_view();
+            Camera* camera = dataset_->get_camera(view.index);
+
+            // Decode before taking a slot so slow decodes don't pin VRAM
+            int w = 0, h = 0, c = 0;
+            torch::Tensor host;
+            torch::Tensor decoded; // [C, H, W] uint8 on the worker stream when gpu_decode_ is set
+            const auto& cache = dataset_->get_image_cache();
+            if (const auto* cached = cache && !cache->on_device() ? cache->find(camera->uid()) : nullptr) {
+                host = cached->pixels;
+                w = cached->width;
+                h = cached->height;
+                c = static_cast<int>(host.size(2));
+            } else {
+                TRACE_SPAN("decode image");
+                try {
+                    std::span<const unsigned char> encoded;
+                    if (view.encoded.valid()) {
+                        encoded = view.encoded.get();
+                    }
+                    if (gpu_decode_) {
+                        c10::cuda::CUDAStreamGuard guard(stream);
+                        decoded = load_image_cuda(camera->image_path(), encoded, resize_factor, max_width);
+                        c = static_cast<int>(decoded.size(0));
+                        h = static_cast<int>(decoded.size(1));
+                        w = static_cast<int>(decoded.size(2));
+                    } else {
+                        host = load_image_pinned(camera->image_path(), encoded, resize_factor, max_width);
+                        h = static_cast<int>(host.size(0));
+                        w = static_cast<int>(host.size(1));
+                        c = static_cast<int>(host.size(2));
+                    }
+                } catch (...) {
+                    {
+                        std::lock_guard<std::mutex> lock(queue_mutex_);
+                        if (!worker_error_) {
+                            worker_error_ = std::current_exception();
+                        }
+                    }
+                    queue_cv_.notify_all();
+                    LOG_ERROR("Dataloader worker {} failed to load {}", worker_id, camera->image_path().string());
+                    break;
                 }
-                dataset_idx = indices_[next_index_++];
             }
 
-            // This ensures we only get images that belong to this dataset's split
-            auto dataset_example = dataset_->get(dataset_idx);
-            Camera* camera = dataset_example.camera;
-
-            // Acquire a buffer slot
-            BufferSlot* slot = acquire_buffer();
-            if (!slot)
-                continue;
-
-            // Load image data using image_io's standard function
-            auto [data, w, h, c] = load_image(camera->image_path(), resize_factor);
-
-            // Update camera dimensions
-            camera->update_image_dimensions(w, h);
-
-            // Check if buffer needs resize
-            if (slot->last_width != w || slot->last_height != h) {
-                LOG_DEBUG("Resizing buffer from {}x{} to {}x{}",
-                          slot->last_width, slot->last_height, w, h);
-                slot->gpu_buffer = torch::empty(
-                    {c, h, w},
-                    torch::TensorOptions()
-                        .dtype(torch::kFloat32)
-                        .device(torch::kCUDA));
-                slot->last_width = w;
-                slot->last_height = h;
+            BufferSlot* slot = acquire_buffer(w, h);
+            if (!slot) {
+                break;
             }
 
-            // Use stream for this worker
-            c10::cuda::CUDAStreamGuard guard(stream);
-
-            // Transfer to GPU with minimal allocations
-            // Create pinned tensor WITHOUT copying - just wrapping the existing data
-            auto pinned = torch::from_blob(
-                data,
-                {h, w, c},
-                torch::TensorOptions()
-                    .dtype(torch::kUInt8)
-                    .pinned_memory(true));
-
-            // Direct conversion and copy into pre-allocated buffer
-            // This is the KEY - we reuse slot->gpu_buffer!
-            slot->gpu_buffer.copy_(
-                pinned.to(torch::kCUDA, /*non_blocking=*/true)
-                    .permute({2, 0, 1}) // HWC -> CHW
-                    .to(torch::kFloat32)
-                    .div_(255.0f),
-                /*non_blocking=*/true);
+            bool allocated = false;
+            {
+                TRACE_SPAN("upload image");
+                c10::cuda::CUDAStreamGuard guard(stream);
 
-            // Synchronize this stream
-            stream.synchronize();
+                if (slot->ever_consumed) {
+                    slot->consumed_event.block(stream);
+                }
 
-            // Free CPU memory using image_io's function
-            free_image(data);
+                if (slot->last_width != w || slot->last_height != h) {
+                    LOG_DEBUG("Allocating dataloader buffer {}x{} (was {}x{})",
+                              w, h, slot->last_width, slot->last_height);
+                    slot->gpu_buffer = torch::empty(
+                        {c, h, w},
+                        torch::TensorOptions()
+                            .dtype(torch::kFloat32)
+                            .device(torch::kCUDA));
+                    slot->last_width = w;
+                    slot->last_height = h;
+                    allocated = true;
+                }
 
-            // Create the example - clone() here is cheap as it just increments ref count
-            CameraWithImage example{camera, slot->gpu_buffer.clone()};
+                // Upload as uint8 and convert straight into the pooled buffer
+                const auto source = decoded.defined()
+                                        ? decoded
+                                        : host.to(torch::kCUDA, /*non_blocking=*/true).permute({2, 0, 1});
+                slot->gpu_buffer.copy_(source, /*non_blocking=*/true);
+                slot->gpu_buffer.div_(255.0f);
 
-            // Release buffer back to pool
-            release_buffer(slot);
+                // The trainer consumes on another stream
+                stream.synchronize();
+            }
 
-            // Add to ready queue
             {
                 std::lock_guard<std::mutex> lock(queue_mutex_);
-                ready_queue_.push_back(std::move(example));
+                ready_queue_.push_back({camera, slot});
+                stats_.buffer_allocations += allocated ? 1 : 0;
             }
             queue_cv_.notify_one();
         }
@@ -215,36 +389,217 @@ namespace gs::training {
         LOG_TRACE("Worker {} thread exiting", worker_id);
     }
 
-    CameraWithImage EfficientDataLoader::get_next() {
+    CameraWithImage EfficientDataLoader::next() {
+        const auto start = std::chrono::steady_clock::now();
+
+        // The previously returned image is no longer referenced by the trainer
+        if (in_use_slot_) {
+            release_buffer(in_use_slot_);
+            in_use_slot_ = nullptr;
+        }
+
+        TRACE_SPAN("wait for image");
         std::unique_lock<std::mutex> lock(queue_mutex_);
+        const size_t depth = ready_queue_.size();
+        queue_depth_sum_ += static_cast<double>(depth);
+        stats_.queue_depth_max = std::max(stats_.queue_depth_max, depth);
+
         queue_cv_.wait(lock, [this] {
-            return !ready_queue_.empty() || should_stop_;
+            return !ready_queue_.empty() || should_stop_ || worker_error_;
         });
 
-        if (should_stop_ && ready_queue_.empty()) {
+        if (worker_error_) {
+            std::rethrow_exception(worker_error_);
+        }
+        if (ready_queue_.empty()) {
             throw std::runtime_error("DataLoader stopped");
         }
 
-        CameraWithImage example = std::move(ready_queue_.front());
+        ReadyExample example = ready_queue_.front();
         ready_queue_.pop_front();
 
-        // Signal that there's space in queue
-        space_cv_.notify_one();
+        ++stats_.images_served;
+        if (depth == 0) {
+            ++stats_.stalls;
+            stats_.stall_ms_total += elapsed_ms(start);
+        }
+        lock.unlock();
+
+        in_use_slot_ = example.slot;
+        // On the trainer thread, workers never write the shared cameras
+        CameraWithImage result{example.camera, example.slot->gpu_buffer};
+        result.apply_image_size();
+        return result;
+    }
+
+    DataLoaderStats EfficientDataLoader::stats() const {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        DataLoaderStats result = stats_;
+        result.queue_depth_avg = stats_.images_served > 0
+                                     ? queue_depth_sum_ / static_cast<double>(stats_.images_served)
+                                     : 0.;
+        return result;
+    }
+
+    WorkerCountTuner::WorkerCountTuner(int min_workers, int max_workers)
+        : min_workers_(std::max(1, min_workers)),
+          max_workers_(std::max(min_workers_, max_workers)) {}
+
+    void WorkerCountTuner::update(IDataLoader& loader) {
+        const int workers = loader.worker_count();
+        if (workers == 0) {
+            return;
+        }
+        const DataLoaderStats stats = loader.stats();
+        const size_t images = stats.images_served - window_start_.images_served;
+        if (images < WINDOW) {
+            return;
+        }
+
+        const double stall_ratio = static_cast<double>(stats.stalls - window_start_.stalls) / static_cast<double>(images);
+        const double depth_avg = (stats.queue_depth_avg * static_cast<double>(stats.images_served) -
+                                  window_start_.queue_depth_avg * static_cast<double>(window_start_.images_served)) /
+                                 static_cast<double>(images);
+        window_start_ = stats;
+
+        // The trainer holds one slot, a full queue has the rest ready
+        const bool queue_full = stats.queue_capacity > 1 && depth_avg >= static_cast<double>(stats.queue_capacity - 1) - 0.5;
+        int target = workers;
+        if (stall_ratio > STARVED) {
+            target = std::min(max_workers_, workers + std::max(1, workers / 2));
+        } else if (stall_ratio == 0. && queue_full) {
+            target = std::max(min_workers_, workers - 1);
+        }
+        if (target != workers) {
+            LOG_INFO("Dataloader {} workers: {:.1f}% of the last {} images stalled, queue depth avg {:.2f} of {}, now {} workers",
+                     workers, stall_ratio * 100., images, depth_avg, stats.queue_capacity, target);
+            loader.set_worker_count(target);
+        }
+    }
+
+    // =============================================================================
+    // libtorch DataLoader adapter
+    // =============================================================================
+
+    struct TorchDataLoader::Impl {
+        using Loader = decltype(create_infinite_dataloader_from_dataset(std::shared_ptr<CameraDataset>{}, 0));
+        using Iterator = decltype(std::declval<Loader&>()->begin());
+
+        Impl(std::shared_ptr<CameraDataset> dataset, int num_workers)
+            : loader(create_infinite_dataloader_from_dataset(std::move(dataset), num_workers)),
+              it(loader->begin()) {}
 
+        Loader loader;
+        Iterator it;
+        bool started = false;
+    };
+
+    TorchDataLoader::TorchDataLoader(std::shared_ptr<CameraDataset> dataset, int num_workers)
+        : impl_(std::make_unique<Impl>(std::move(dataset), num_workers)) {
+        LOG_INFO("libtorch dataloader: {} workers", num_workers);
+    }
+
+    TorchDataLoader::~TorchDataLoader() = default;
+
+    CameraWithImage TorchDataLoader::next() {
+        const auto start = std::chrono::steady_clock::now();
+
+        if (impl_->started) {
+            ++impl_->it;
+        }
+        impl_->started = true;
+
+        auto& batch = *impl_->it;
+        CameraWithImage example = batch[0].data;
+
+        // No queue introspection here: every wait counts towards stall time
+        ++stats_.images_served;
+        stats_.stall_ms_total += elapsed_ms(start);
+
+        example.image = std::move(example.image).to(torch::kCUDA, /*non_blocking=*/true);
+        example.apply_image_size();
         return example;
     }
 
-    InfiniteDataLoaderWrapper::InfiniteDataLoaderWrapper(
-        std::unique_ptr<EfficientDataLoader> loader)
-        : loader_(std::move(loader)) {}
+    // =============================================================================
+    // VRAM-resident DataLoader Implementation
+    // =============================================================================
 
-    std::unique_ptr<InfiniteDataLoaderWrapper>
-    create_efficient_infinite_dataloader(
-        std::shared_ptr<CameraDataset> dataset,
-        int num_workers) {
+    ResidentDataLoader::ResidentDataLoader(std::shared_ptr<CameraDataset> dataset,
+                                           std::shared_ptr<ViewImportanceSampler> sampler,
+                                           std::optional<uint32_t> seed)
+        : dataset_(std::move(dataset)),
+          cache_(dataset_->get_image_cache()),
+          sampler_(std::move(sampler)) {
+        if (!cache_ || !cache_->on_device()) {
+            throw std::runtime_error("ResidentDataLoader requires a VRAM image cache");
+        }
+        if (seed) {
+            rng_.seed(*seed);
+        }
+
+        indices_.resize(dataset_->size().value());
+        std::iota(indices_.begin(), indices_.end(), 0);
+        std::shuffle(indices_.begin(), indices_.end(), rng_);
 
-        auto loader = std::make_unique<EfficientDataLoader>(dataset, num_workers);
-        return std::make_unique<InfiniteDataLoaderWrapper>(std::move(loader));
+        LOG_INFO("Resident dataloader: serving {} images from VRAM", indices_.size());
+    }
+
+    CameraWithImage ResidentDataLoader::next() {
+        if (!sampler_ && next_index_ >= indices_.size()) {
+            std::shuffle(indices_.begin(), indices_.end(), rng_);
+            next_index_ = 0;
+        }
+        const size_t index = sampler_ ? sampler_->draw(rng_) : indices_[next_index_++];
+        ++stats_.images_served;
+
+        Camera* camera = dataset_->get_camera(index);
+        if (const auto* entry = cache_->find(camera->uid())) {
+            // Everything stays on the trainer stream, so the previous image is no
+            // longer read by the time the buffer is overwritten
+            ImageCache::to_cuda_float(*entry, image_buffer_);
+            return {camera, image_buffer_};
+        }
+
+        // Did not fit into the VRAM budget
+        const auto start = std::chrono::steady_clock::now();
+        auto example = dataset_->get(index).data;
+        example.apply_image_size();
+        ++stats_.stalls;
+        stats_.stall_ms_total += elapsed_ms(start);
+        return example;
+    }
+
+    std::expected<std::unique_ptr<IDataLoader>, std::string> create_train_dataloader(
+        std::shared_ptr<CameraDataset> dataset,
+        const std::string& backend,
+        int num_workers,
+        bool gpu_decode,
+        std::shared_ptr<ViewImportanceSampler> sampler,
+        std::optional<uint32_t> seed,
+        ReadAheadOptions read_ahead) {
+        try {
+            // A VRAM cache makes worker threads pointless, whatever backend was requested
+            if (const auto& cache = dataset->get_image_cache(); cache && cache->on_device()) {
+                return std::make_unique<ResidentDataLoader>(std::move(dataset), std::move(sampler), seed);
+            }
+            if (backend == "efficient") {
+                return std::make_unique<EfficientDataLoader>(std::move(dataset), num_workers, gpu_decode, std::move(sampler), seed,
+                                                             std::move(read_ahead));
+            }
+            if (backend == "libtorch") {
+                if (sampler) {
+                    LOG_WARN("The libtorch dataloader shuffles uniformly, importance sampling is ignored");
+                }
+                if (read_ahead.depth > 0) {
+                    LOG_WARN("The libtorch dataloader reads images in its workers, read_ahead is ignored");
+                }
+                return std::make_unique<TorchDataLoader>(std::move(dataset), num_workers);
+            }
+            return std::unexpected(std::format("Unknown dataloader backend '{}'. Valid options are: efficient, libtorch", backend));
+        } catch (const std::exception& e) {
+            return std::unexpected(std::format("Failed to create {} dataloader: {}", backend, e.what()));
+        }
     }
 
     // =============================================================================
@@ -253,13 +608,15 @@ namespace gs::training {
 
     EvalDataLoader::EvalDataLoader(std::shared_ptr<CameraDataset> dataset)
         : dataset_(dataset),
-          dataset_size_(dataset->size()) {
+          dataset_size_(dataset->size().value()) {
         LOG_DEBUG("Created evaluation dataloader with {} images", dataset_size_);
     }
 
     CameraWithImage EvalDataLoader::Iterator::operator*() const {
-        // Simply get the example from the dataset (uses Camera::load_and_get_image)
-        return parent->dataset_->get(index);
+        // Simply get the example from the dataset (uses Camera::load_image)
+        const CameraWithImage example = parent->dataset_->get(index).data;
+        example.apply_image_size();
+        return example;
     }
 
     EvalDataLoader::Iterator& EvalDataLoader::Iterator::operator++() {
@@ -284,4 +641,4 @@ namespace gs::training {
         return std::make_unique<EvalDataLoader>(dataset);
     }
 
-} // namespace gs::training
\ No newline at end of file
+} // namespace gs::training
@@ -0,0 +1,277 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "dataset.hpp"
+#include "file_read_ahead.hpp"
+#include <ATen/cuda/CUDAEvent.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <expected>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <torch/torch.h>
+#include <unordered_map>
+#include <vector>
+
+namespace gs::training {
+
+    // Snapshot of loader health, used to spot input-bound training runs
+    struct DataLoaderStats {
+        size_t images_served = 0;   // Examples handed to the trainer
+        size_t stalls = 0;          // next() calls that found no ready example
+        double stall_ms_total = 0.; // Total time spent waiting in next()
+        double queue_depth_avg = 0.;
+        size_t queue_depth_max = 0;
+        size_t queue_capacity = 0; // 0 when the backend has no visible queue
+        size_t buffer_allocations = 0; // Pooled device buffers allocated for a new image size
+
+        double stall_ratio() const {
+            return images_served > 0 ? static_cast<double>(stalls) / static_cast<double>(images_served) : 0.;
+        }
+
+        std::string to_string() const;
+    };
+
+    // Draws training views in proportion to an exponential moving average of their photometric
+    // loss. uniform_floor of the probability mass is spread evenly over all views, so easy views
+    // keep being visited. Views without a recorded loss weigh as much as the hardest one seen.
+    // record() comes from the trainer thread and draw() from loader workers.
+    class ViewImportanceSampler {
+    public:
+        ViewImportanceSampler(const CameraDataset& dataset, float uniform_floor);
+
+        // Losses of cameras outside the dataset are ignored
+        void record(int camera_uid, float loss);
+
+        // Dataset index of the next view
+        size_t draw(std::mt19937& rng);
+
+    private:
+        void rebuild_distribution();
+
+        static constexpr float LOSS_EMA_DECAY = 0.5f;
+
+        const float uniform_floor_;
+        std::unordered_map<int, size_t> index_of_uid_;
+        std::vector<float> loss_ema_; // Negative until the view's first loss arrives
+        std::discrete_distribution<size_t> distribution_;
+        size_t draws_until_rebuild_ = 0; // The weights refresh once per dataset-sized round of draws
+        std::mutex mutex_;
+    };
+
+    // Infinite training data source. Images are returned as CUDA float32 CHW tensors.
+    class IDataLoader {
+    public:
+        virtual ~IDataLoader() = default;
+
+        // Blocks until the next example is available
+        virtual CameraWithImage next() = 0;
+
+        virtual DataLoaderStats stats() const = 0;
+
+        virtual std::string_view name() const = 0;
+
+        // Decode threads at work, 0 for a backend whose count is fixed at construction
+        virtual int worker_count() const { return 0; }
+        virtual void set_worker_count(int /*count*/) {}
+    };
+
+    // Loader with a fixed pool of device buffers, per-worker CUDA streams and a ready queue.
+    // Each returned image aliases a pooled buffer and stays valid until the next call to next().
+    // With a read_ahead depth, the files of that many upcoming views are read into memory in draw
+    // order and the workers decode from there. The worker count can change while it runs, workers
+    // above it park; the buffer pool keeps the size num_workers gave it.
+    class EfficientDataLoader final : public IDataLoader {
+    public:
+        EfficientDataLoader(std::shared_ptr<CameraDataset> dataset, int num_workers, bool gpu_decode = false,
+                            std::shared_ptr<ViewImportanceSampler> sampler = nullptr,
+                            std::optional<uint32_t> seed = std::nullopt,
+                            ReadAheadOptions read_ahead = {});
+        ~EfficientDataLoader() override;
+
+        EfficientDataLoader(const EfficientDataLoader&) = delete;
+        EfficientDataLoader& operator=(const EfficientDataLoader&) = delete;
+
+        CameraWithImage next() override;
+        DataLoaderStats stats() const override;
+        std::string_view name() const override { return "efficient"; }
+        int worker_count() const override { return active_workers_.load(); }
+        // Trainer thread only
+        void set_worker_count(int count) override;
+
+    private:
+        struct BufferSlot {
+            torch::Tensor gpu_buffer;
+            at::cuda::CUDAEvent consumed_event; // Recorded by the trainer when the slot is handed back
+            bool ever_consumed = false;
+            int last_width = 0;
+            int last_height = 0;
+        };
+
+        struct ReadyExample {
+            Camera* camera;
+            BufferSlot* slot;
+        };
+
+        struct UpcomingView {
+            size_t index;
+            std::shared_future<std::vector<unsigned char>> encoded; // Invalid when not read ahead
+        };
+
+        void worker_thread(int worker_id);
+        BufferSlot* acquire_buffer(int width, int height);
+        void release_buffer(BufferSlot* slot);
+        UpcomingView next_view();
+        size_t draw_dataset_index(); // index_mutex_ held
+
+        std::shared_ptr<CameraDataset> dataset_;
+        const int num_workers_; // At construction, sizes the buffer pool
+        const bool gpu_decode_; // Decode with load_image_cuda instead of load_image
+
+        // Buffer pool - tensors are allocated lazily at the decoded image size and slots are
+        // picked by size, so mixed-resolution datasets settle into one bucket of slots per size
+        std::vector<std::unique_ptr<BufferSlot>> buffer_pool_;
+        std::vector<BufferSlot*> free_slots_;
+        std::mutex pool_mutex_;
+        std::condition_variable pool_cv_;
+
+        // Ready queue
+        std::deque<ReadyExample> ready_queue_;
+        mutable std::mutex queue_mutex_;
+        std::condition_variable queue_cv_;
+
+        // Slot currently held by the trainer
+        BufferSlot* in_use_slot_ = nullptr;
+
+        // Shuffled epoch order, unused with an importance sampler
+        std::vector<size_t> indices_;
+        size_t next_index_ = 0;
+        std::mutex index_mutex_;
+        std::mt19937 rng_{std::random_device{}()};
+        std::shared_ptr<ViewImportanceSampler> sampler_;
+
+        // Views drawn ahead of the workers with their file reads in flight (guarded by index_mutex_)
+        std::unique_ptr<FileReadAhead> read_ahead_;
+        size_t read_ahead_depth_ = 0;
+        std::deque<UpcomingView> upcoming_;
+
+        // First worker failure, rethrown on the trainer thread
+        std::exception_ptr worker_error_;
+
+        // Stats (guarded by queue_mutex_)
+        DataLoaderStats stats_;
+        double queue_depth_sum_ = 0.;
+
+        std::vector<std::thread> workers_; // Ids at or above active_workers_ are parked
+        std::atomic<int> active_workers_{0};
+        std::mutex workers_mutex_;
+        std::condition_variable workers_cv_;
+        std::atomic<bool> should_stop_{false};
+    };
+
+    // Adjusts the worker count of a loader from the starvation it shows over windows of WINDOW
+    // images: more workers while the trainer finds no ready image on more than STARVED of its
+    // next() calls, one fewer once the ready queue stays full without a single stall
+    class WorkerCountTuner {
+    public:
+        WorkerCountTuner(int min_workers, int max_workers);
+
+        // After next(), a no-op for loaders without a worker count
+        void update(IDataLoader& loader);
+
+    private:
+        static constexpr size_t WINDOW = 200;
+        static constexpr double STARVED = 0.02;
+
+        const int min_workers_;
+        const int max_workers_;
+        DataLoaderStats window_start_;
+    };
+
+    // Adapter around the libtorch DataLoader (CameraDataset::get per example)
+    class TorchDataLoader final : public IDataLoader {
+    public:
+        TorchDataLoader(std::shared_ptr<CameraDataset> dataset, int num_workers);
+        ~TorchDataLoader() override;
+
+        CameraWithImage next() override;
+        DataLoaderStats stats() const override { return stats_; }
+        std::string_view name() const override { return "libtorch"; }
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl_;
+        DataLoaderStats stats_;
+    };
+
+    // Serves ground truth straight from a VRAM ImageCache (preload_to_vram): no threads,
+    // no decode, no H2D copy. The returned image stays valid until the next call to next().
+    class ResidentDataLoader final : public IDataLoader {
+    public:
+        explicit ResidentDataLoader(std::shared_ptr<CameraDataset> dataset,
+                                    std::shared_ptr<ViewImportanceSampler> sampler = nullptr,
+                                    std::optional<uint32_t> seed = std::nullopt);
+
+        CameraWithImage next() override;
+        DataLoaderStats stats() const override { return stats_; }
+        std::string_view name() const override { return "resident"; }
+
+    private:
+        std::shared_ptr<CameraDataset> dataset_;
+        std::shared_ptr<const ImageCache> cache_;
+        torch::Tensor image_buffer_;
+        std::vector<size_t> indices_;
+        size_t next_index_ = 0;
+        std::mt19937 rng_{std::random_device{}()};
+        std::shared_ptr<ViewImportanceSampler> sampler_;
+        DataLoaderStats stats_;
+    };
+
+    // Creates the training loader selected by OptimizationParameters::dataloader. A sampler
+    // replaces the uniform shuffle of the efficient and resident loaders, a seed fixes their view
+    // order (libtorch shuffles with the torch generator). Only the efficient loader reads ahead.
+    std::expected<std::unique_ptr<IDataLoader>, std::string> create_train_dataloader(
+        std::shared_ptr<CameraDataset> dataset,
+        const std::string& backend,
+        int num_workers,
+        bool gpu_decode = false,
+        std::shared_ptr<ViewImportanceSampler> sampler = nullptr,
+        std::optional<uint32_t> seed = std::nullopt,
+        ReadAheadOptions read_ahead = {});
+
+    // Sequential, single-pass loader for evaluation
+    class EvalDataLoader {
+    public:
+        explicit EvalDataLoader(std::shared_ptr<CameraDataset> dataset);
+
+        struct Iterator {
+            EvalDataLoader* parent;
+            size_t index;
+
+            CameraWithImage operator*() const;
+            Iterator& operator++();
+            bool operator!=(const Iterator& other) const;
+        };
+
+        Iterator begin();
+        Iterator end();
+
+    private:
+        std::shared_ptr<CameraDataset> dataset_;
+        size_t dataset_size_;
+    };
+
+    std::unique_ptr<EvalDataLoader> create_eval_dataloader(std::shared_ptr<CameraDataset> dataset);
+
+} // namespace gs::training
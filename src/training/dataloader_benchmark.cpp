@@ -0,0 +1,206 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "dataloader_benchmark.hpp"
+#include "config.h"
+#include "core/image_io.hpp"
+#include "core/logger.hpp"
+#include "loader/loader.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cuda_runtime.h>
+#include <format>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <thread>
+
+namespace gs::training {
+
+    namespace {
+        constexpr size_t AUTOTUNE_IMAGES = 48; // Per worker count, keeps the startup probe to seconds
+        constexpr double NEAR_BEST = 0.95;
+
+        double percentile(const std::vector<double>& sorted, double p) {
+            if (sorted.empty()) {
+                return 0.;
+            }
+            const auto index = std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())));
+            return sorted[index];
+        }
+
+        std::vector<int> powers_of_two_up_to(int max_workers) {
+            std::vector<int> counts;
+            for (int workers = 1; workers < max_workers; workers *= 2) {
+                counts.push_back(workers);
+            }
+            counts.push_back(std::max(1, max_workers));
+            return counts;
+        }
+
+        std::expected<void, std::string> write_report(const std::filesystem::path& path,
+                                                      const std::vector<DataLoaderBenchmarkResult>& results,
+                                                      const param::DatasetConfig& dataset, bool gpu_decode) {
+            nlohmann::json report;
+            report["version"] = GIT_TAGGED_VERSION;
+            report["commit"] = GIT_COMMIT_HASH_SHORT;
+            report["dataset"] = dataset.data_path.string();
+            report["resize_factor"] = dataset.resize_factor;
+            report["max_width"] = dataset.max_width;
+            report["gpu_decode"] = gpu_decode;
+            report["hardware_threads"] = std::thread::hardware_concurrency();
+            report["best_workers"] = best_worker_count(results);
+
+            auto configs = nlohmann::json::array();
+            for (const auto& result : results) {
+                configs.push_back({{"workers", result.workers},
+                                   {"images", result.images},
+                                   {"images_per_second", result.images_per_second},
+                                   {"wait_ms", {{"p50", result.wait_p50_ms}, {"p90", result.wait_p90_ms}, {"p99", result.wait_p99_ms}}},
+                                   {"stalls", result.stats.stalls},
+                                   {"queue_depth_avg", result.stats.queue_depth_avg},
+                                   {"queue_capacity", result.stats.queue_capacity},
+                                   {"buffer_allocations", result.stats.buffer_allocations}});
+            }
+            report["configurations"] = std::move(configs);
+
+            std::error_code ec;
+            if (path.has_parent_path()) {
+                std::filesystem::create_directories(path.parent_path(), ec);
+            }
+            std::ofstream out(path);
+            if (!out) {
+                return std::unexpected(std::format("Cannot write the dataloader benchmark report to {}", path.string()));
+            }
+            out << report.dump(2) << '\n';
+            if (!out) {
+                return std::unexpected(std::format("Failed writing the dataloader benchmark report to {}", path.string()));
+            }
+            return {};
+        }
+    } // namespace
+
+    std::expected<std::vector<DataLoaderBenchmarkResult>, std::string> benchmark_dataloader(
+        const std::shared_ptr<CameraDataset>& dataset, const std::vector<int>& worker_counts,
+        size_t images, bool gpu_decode, const ReadAheadOptions& read_ahead) {
+        std::vector<DataLoaderBenchmarkResult> results;
+        try {
+            for (const int workers : worker_counts) {
+                EfficientDataLoader loader(dataset, workers, gpu_decode, nullptr, std::nullopt, read_ahead);
+
+                // Each worker count starts from a full pipeline
+                const size_t warmup = loader.stats().queue_capacity;
+                for (size_t i = 0; i < warmup; ++i) {
+                    loader.next();
+                }
+                cudaDeviceSynchronize();
+                const DataLoaderStats before = loader.stats();
+
+                std::vector<double> waits;
+                waits.reserve(images);
+                const auto start = std::chrono::steady_clock::now();
+                for (size_t i = 0; i < images; ++i) {
+                    const auto requested = std::chrono::steady_clock::now();
+                    loader.next();
+                    waits.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - requested).count());
+                }
+                cudaDeviceSynchronize();
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                DataLoaderBenchmarkResult result;
+                result.workers = workers;
+                result.images = images;
+                result.images_per_second = seconds > 0. ? static_cast<double>(images) / seconds : 0.;
+                std::sort(waits.begin(), waits.end());
+                result.wait_p50_ms = percentile(waits, 0.50);
+                result.wait_p90_ms = percentile(waits, 0.90);
+                result.wait_p99_ms = percentile(waits, 0.99);
+                result.stats = loader.stats();
+                result.stats.stalls -= before.stalls;
+                result.stats.stall_ms_total -= before.stall_ms_total;
+                results.push_back(result);
+                LOG_DEBUG("Dataloader with {} workers: {:.1f} images/s", workers, result.images_per_second);
+            }
+        } catch (const std::exception& e) {
+            return std::unexpected(std::format("Dataloader benchmark failed: {}", e.what()));
+        }
+        return results;
+    }
+
+    int best_worker_count(const std::vector<DataLoaderBenchmarkResult>& results) {
+        double best = 0.;
+        for (const auto& result : results) {
+            best = std::max(best, result.images_per_second);
+        }
+        int workers = 0;
+        for (const auto& result : results) {
+            if (result.images_per_second >= NEAR_BEST * best && (workers == 0 || result.workers < workers)) {
+                workers = result.workers;
+            }
+        }
+        return workers;
+    }
+
+    int autotune_worker_count(const std::shared_ptr<CameraDataset>& dataset, int max_workers,
+                              bool gpu_decode, const ReadAheadOptions& read_ahead) {
+        const auto start = std::chrono::steady_clock::now();
+        auto results = benchmark_dataloader(dataset, powers_of_two_up_to(max_workers), AUTOTUNE_IMAGES, gpu_decode, read_ahead);
+        if (!results || results->empty()) {
+            const int fallback = std::max(1, max_workers / 2);
+            LOG_WARN("Dataloader worker autotune failed ({}), starting with {} workers",
+                     results ? "no results" : results.error(), fallback);
+            return fallback;
+        }
+        const int workers = best_worker_count(*results);
+        LOG_INFO("Dataloader autotune picked {} workers in {:.1f} s", workers,
+                 std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        return workers;
+    }
+
+    std::expected<std::vector<DataLoaderBenchmarkResult>, std::string> run_dataloader_benchmark(
+        const param::DataLoaderBenchmarkParameters& params,
+        const param::DatasetConfig& dataset,
+        const param::OptimizationParameters& optimization) {
+        auto loader = loader::Loader::create();
+        auto loaded = loader->load(dataset.data_path, {.resize_factor = dataset.resize_factor,
+                                                       .max_width = dataset.max_width,
+                                                       .images_folder = dataset.images,
+                                                       .undistort = dataset.undistort});
+        if (!loaded) {
+            return std::unexpected(std::format("Failed to load dataset: {}", loaded.error()));
+        }
+        const auto* scene = std::get_if<loader::LoadedScene>(&loaded->data);
+        if (!scene || !scene->cameras || scene->cameras->size().value() == 0) {
+            return std::unexpected(std::format("{} is not a dataset with cameras", dataset.data_path.string()));
+        }
+
+        const bool gpu_decode = optimization.gpu_decode && gpu_image_decode_available();
+        const auto worker_counts = params.workers.empty()
+                                       ? powers_of_two_up_to(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+                                       : params.workers;
+        const ReadAheadOptions read_ahead{.depth = static_cast<size_t>(optimization.read_ahead),
+                                          .mirror_dir = optimization.read_ahead_mirror};
+        LOG_INFO("Benchmarking the dataloader on {} images: {} per worker count, {} decode",
+                 scene->cameras->size().value(), params.images, gpu_decode ? "GPU" : "CPU");
+
+        auto results = benchmark_dataloader(scene->cameras, worker_counts, static_cast<size_t>(params.images),
+                                            gpu_decode, read_ahead);
+        if (!results) {
+            return results;
+        }
+
+        LOG_INFO("{:>8} {:>10} {:>10} {:>10} {:>10} {:>8}", "workers", "images/s", "p50 ms", "p90 ms", "p99 ms", "stalls");
+        for (const auto& result : *results) {
+            LOG_INFO("{:>8} {:>10.1f} {:>10.2f} {:>10.2f} {:>10.2f} {:>8}", result.workers, result.images_per_second,
+                     result.wait_p50_ms, result.wait_p90_ms, result.wait_p99_ms, result.stats.stalls);
+        }
+        LOG_INFO("Fewest workers within 5% of the best throughput: {}", best_worker_count(*results));
+
+        if (auto written = write_report(params.report, *results, dataset, gpu_decode); !written) {
+            return std::unexpected(written.error());
+        }
+        LOG_INFO("Dataloader benchmark report written to {}", params.report.string());
+        return results;
+    }
+
+} // namespace gs::training
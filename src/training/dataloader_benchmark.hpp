@@ -0,0 +1,49 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/parameters.hpp"
+#include "dataloader.hpp"
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gs::training {
+
+    struct DataLoaderBenchmarkResult {
+        int workers = 0;
+        size_t images = 0; // Timed, after the pipeline filled
+        double images_per_second = 0.;
+        double wait_p50_ms = 0.; // Time next() blocks, as the trainer sees it
+        double wait_p90_ms = 0.;
+        double wait_p99_ms = 0.;
+        DataLoaderStats stats;
+    };
+
+    // Times the efficient loader alone on dataset: decode, resize, pinned staging and the H2D
+    // upload, taken by a consumer that does nothing else. Every worker count gets a fresh loader
+    // whose first buffer pool of images fills the pipeline untimed.
+    std::expected<std::vector<DataLoaderBenchmarkResult>, std::string> benchmark_dataloader(
+        const std::shared_ptr<CameraDataset>& dataset, const std::vector<int>& worker_counts,
+        size_t images, bool gpu_decode, const ReadAheadOptions& read_ahead);
+
+    // Fewest workers within 5% of the highest throughput
+    int best_worker_count(const std::vector<DataLoaderBenchmarkResult>& results);
+
+    // Starting point of num_workers = 0: a short benchmark over powers of two up to max_workers
+    int autotune_worker_count(const std::shared_ptr<CameraDataset>& dataset, int max_workers,
+                              bool gpu_decode, const ReadAheadOptions& read_ahead);
+
+    // --benchmark-dataloader: loads the dataset, benchmarks each worker count of params, logs a
+    // table and writes the JSON report
+    std::expected<std::vector<DataLoaderBenchmarkResult>, std::string> run_dataloader_benchmark(
+        const param::DataLoaderBenchmarkParameters& params,
+        const param::DatasetConfig& dataset,
+        const param::OptimizationParameters& optimization);
+
+} // namespace gs::training
@@ -6,6 +6,7 @@
 
 #include "core/camera.hpp"
 #include "core/parameters.hpp"
+#include "image_cache.hpp"
 #include "loader/loader.hpp"
 #include <expected>
 #include <format>
@@ -18,6 +19,11 @@ namespace gs::training {
     struct CameraWithImage {
         Camera* camera;
         torch::Tensor image;
+
+        // Loader threads leave the shared camera alone, the consumer records the size of its image
+        void apply_image_size() const {
+            camera->update_image_dimensions(static_cast<int>(image.size(-1)), static_cast<int>(image.size(-2)));
+        }
     };
 
     using CameraExample = torch::data::Example<CameraWithImage, torch::Tensor>;
@@ -69,7 +75,14 @@ namespace gs::training {
             size_t camera_idx = _indices[index];
             auto& cam = _cameras[camera_idx];
 
-            torch::Tensor image = cam->load_and_get_image(_datasetConfig.resize_factor, _datasetConfig.max_width);
+            if (_image_cache) {
+                if (const auto* entry = _image_cache->find(cam->uid())) {
+                    return {{cam.get(), ImageCache::to_cuda_float(*entry)}, torch::empty({})};
+                }
+            }
+
+            // May run on loader workers, CameraWithImage::apply_image_size() updates the camera
+            torch::Tensor image = cam->load_image(_datasetConfig.resize_factor, _datasetConfig.max_width);
             return {{cam.get(), std::move(image)}, torch::empty({})};
         }
 
@@ -77,6 +90,14 @@ namespace gs::training {
             return _indices.size();
         }
 
+        // Camera for a split-relative index, without touching the image on disk
+        Camera* get_camera(size_t index) const {
+            if (index >= _indices.size()) {
+                throw std::out_of_range("Dataset index out of range");
+            }
+            return _cameras[_indices[index]].get();
+        }
+
         const std::vector<std::shared_ptr<Camera>>& get_cameras() const {
             return _cameras;
         }
@@ -104,12 +125,19 @@ namespace gs::training {
         }
         void set_resize_factor(int resize_factor) { _datasetConfig.resize_factor = resize_factor; }
         void set_max_width(int max_width) { _datasetConfig.max_width = max_width; }
+        int get_resize_factor() const { return _datasetConfig.resize_factor; }
+        int get_max_width() const { return _datasetConfig.max_width; }
+
+        // Decoded images served by get() instead of reading from disk (preload_to_ram)
+        void set_image_cache(std::shared_ptr<const ImageCache> cache) { _image_cache = std::move(cache); }
+        const std::shared_ptr<const ImageCache>& get_image_cache() const { return _image_cache; }
 
     private:
         std::vector<std::shared_ptr<Camera>> _cameras;
         gs::param::DatasetConfig _datasetConfig;
         Split _split;
         std::vector<size_t> _indices;
+        std::shared_ptr<const ImageCache> _image_cache;
     };
 
     // Infinite random sampler for continuous data flow
@@ -150,7 +178,8 @@ namespace gs::training {
                 .resize_factor = datasetConfig.resize_factor,
                 .max_width = datasetConfig.max_width,
                 .images_folder = datasetConfig.images,
-                .validate_only = false};
+                .validate_only = false,
+                .undistort = datasetConfig.undistort};
 
             // Load the data
             auto result = loader->load(datasetConfig.data_path, options);
@@ -198,7 +227,8 @@ namespace gs::training {
                 .resize_factor = datasetConfig.resize_factor,
                 .max_width = datasetConfig.max_width,
                 .images_folder = datasetConfig.images,
-                .validate_only = false};
+                .validate_only = false,
+                .undistort = datasetConfig.undistort};
 
             // Load the data
             auto result = loader->load(datasetConfig.data_path, options);
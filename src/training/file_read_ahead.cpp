@@ -0,0 +1,152 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "file_read_ahead.hpp"
+#include "core/logger.hpp"
+#include "core/thread_placement.hpp"
+#include "core/trace_recorder.hpp"
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace gs::training {
+
+    namespace {
+        std::vector<unsigned char> read_file(const std::filesystem::path& path) {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (!file) {
+                throw std::runtime_error("Load failed: " + path.string());
+            }
+            std::vector<unsigned char> bytes(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            if (!file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+                throw std::runtime_error("Read failed: " + path.string());
+            }
+            return bytes;
+        }
+
+        // Unique temp file and rename, a concurrent run may be copying the same file
+        bool write_file(const std::filesystem::path& path, const std::vector<unsigned char>& bytes) {
+            std::error_code ec;
+            std::filesystem::create_directories(path.parent_path(), ec);
+            const auto tmp = path.string() + std::format(".{:08x}.tmp", std::random_device{}());
+            {
+                std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+                out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+                if (!out) {
+                    out.close();
+                    std::filesystem::remove(tmp, ec);
+                    return false;
+                }
+            }
+            std::filesystem::rename(tmp, path, ec);
+            if (ec) {
+                std::filesystem::remove(tmp, ec);
+            }
+            return true;
+        }
+    } // namespace
+
+    FileReadAhead::FileReadAhead(int num_threads, std::filesystem::path mirror_dir)
+        : mirror_dir_(std::move(mirror_dir)) {
+        const int count = std::max(1, num_threads);
+        threads_.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            threads_.emplace_back(&FileReadAhead::reader_thread, this);
+        }
+    }
+
+    FileReadAhead::~FileReadAhead() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+        // Requests never started leave broken promises behind
+    }
+
+    std::shared_future<std::vector<unsigned char>> FileReadAhead::read(std::filesystem::path path) {
+        std::shared_future<std::vector<unsigned char>> contents;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& request = requests_.emplace_back(Request{std::move(path), {}});
+            contents = request.contents.get_future().share();
+        }
+        cv_.notify_one();
+        return contents;
+    }
+
+    void FileReadAhead::reader_thread() {
+        core::ThreadPlacement::get().pin_current_thread();
+        core::TraceRecorder::get().set_thread_name("read ahead");
+        while (true) {
+            Request request;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !requests_.empty(); });
+                if (stop_) {
+                    return;
+                }
+                request = std::move(requests_.front());
+                requests_.pop_front();
+            }
+            TRACE_SPAN("read file");
+            try {
+                request.contents.set_value(read_through_mirror(request.path));
+            } catch (...) {
+                request.contents.set_exception(std::current_exception());
+            }
+        }
+    }
+
+    std::optional<FileReadAhead::MirrorEntry> FileReadAhead::mirror_entry(const std::filesystem::path& source) const {
+        if (mirror_dir_.empty()) {
+            return std::nullopt;
+        }
+        // A changed source gets a new entry, the extension keeps the decoder's format guess
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(source, ec);
+        if (ec) {
+            return std::nullopt;
+        }
+        const auto mtime = std::filesystem::last_write_time(source, ec);
+        if (ec) {
+            return std::nullopt;
+        }
+        const std::string key = std::format("{}|{}|{}", std::filesystem::absolute(source).lexically_normal().string(),
+                                            size, mtime.time_since_epoch().count());
+        return MirrorEntry{mirror_dir_ / std::format("{:016x}{}", std::hash<std::string>{}(key), source.extension().string()),
+                           static_cast<size_t>(size)};
+    }
+
+    std::vector<unsigned char> FileReadAhead::read_through_mirror(const std::filesystem::path& source) const {
+        const auto entry = mirror_entry(source);
+        if (!entry) {
+            return read_file(source);
+        }
+
+        std::error_code ec;
+        if (std::filesystem::file_size(entry->path, ec) == entry->size && !ec) {
+            try {
+                return read_file(entry->path);
+            } catch (const std::exception&) {
+                // Removed in the meantime, the source is still there
+            }
+        }
+
+        auto bytes = read_file(source);
+        if (!write_file(entry->path, bytes) && !mirror_write_failed_.exchange(true)) {
+            LOG_WARN("Read-ahead mirror {} not writable, continuing without local copies", mirror_dir_.string());
+        }
+        return bytes;
+    }
+
+} // namespace gs::training
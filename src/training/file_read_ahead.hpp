@@ -0,0 +1,64 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace gs::training {
+
+    struct ReadAheadOptions {
+        size_t depth = 0;                 // Files read ahead, 0: off
+        std::filesystem::path mirror_dir; // Local copies of the files read, empty: none
+    };
+
+    // Reads whole files into memory on threads of its own, in the order they were requested.
+    // Several reads stay in flight at once, so on network filesystems, object storage mounts and
+    // spinning disks the storage latency is paid ahead of the decode instead of inside it. With a
+    // mirror directory every file read is also copied there, and later reads of it stay local.
+    class FileReadAhead {
+    public:
+        explicit FileReadAhead(int num_threads, std::filesystem::path mirror_dir = {});
+        ~FileReadAhead();
+
+        FileReadAhead(const FileReadAhead&) = delete;
+        FileReadAhead& operator=(const FileReadAhead&) = delete;
+
+        // Contents of path once read, the future rethrows the error of a failed read
+        std::shared_future<std::vector<unsigned char>> read(std::filesystem::path path);
+
+    private:
+        struct Request {
+            std::filesystem::path path;
+            std::promise<std::vector<unsigned char>> contents;
+        };
+
+        void reader_thread();
+
+        struct MirrorEntry {
+            std::filesystem::path path;
+            size_t size; // Of the source
+        };
+        // nullopt without a mirror or when the source can't be stat'ed
+        std::optional<MirrorEntry> mirror_entry(const std::filesystem::path& source) const;
+        std::vector<unsigned char> read_through_mirror(const std::filesystem::path& source) const;
+
+        const std::filesystem::path mirror_dir_;
+        mutable std::atomic<bool> mirror_write_failed_{false};
+        std::deque<Request> requests_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool stop_ = false;
+        std::vector<std::thread> threads_;
+    };
+
+} // namespace gs::training
@@ -0,0 +1,154 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "image_cache.hpp"
+#include "core/camera.hpp"
+#include "core/image_io.hpp"
+#include "core/logger.hpp"
+#include "shared_image_store.hpp"
+#include <atomic>
+#include <c10/cuda/CUDAGuard.h>
+#include <chrono>
+#include <format>
+#include <tbb/parallel_for.h>
+
+namespace gs::training {
+
+    std::expected<std::shared_ptr<ImageCache>, std::string> ImageCache::build(
+        const std::vector<Camera*>& cameras,
+        const Options& options) {
+        try {
+            const auto start = std::chrono::steady_clock::now();
+
+            // Plan against the header-only size estimate so images that don't fit are never decoded.
+            // get_num_bytes_from_file reports float32 bytes, the cache stores uint8.
+            std::vector<Camera*> selected;
+            selected.reserve(cameras.size());
+            size_t planned_bytes = 0;
+            for (Camera* cam : cameras) {
+                const size_t bytes = cam->get_num_bytes_from_file(options.resize_factor, options.max_width) / sizeof(float);
+                if (options.max_bytes > 0 && planned_bytes + bytes > options.max_bytes) {
+                    continue;
+                }
+                planned_bytes += bytes;
+                selected.push_back(cam);
+            }
+
+            if (selected.size() < cameras.size()) {
+                LOG_WARN("Preload budget of {:.1f} MB fits {} of {} images, the rest are read from disk",
+                         options.max_bytes / (1024.0 * 1024.0), selected.size(), cameras.size());
+            }
+
+            // Held until every image is in, concurrent runs attach to what this one decodes
+            std::unique_ptr<SharedImageStore> shared;
+            if (!options.device && !options.shared_dir.empty()) {
+                auto store = SharedImageStore::open(options.shared_dir);
+                if (!store) {
+                    return std::unexpected(store.error());
+                }
+                shared = std::move(*store);
+            }
+            std::atomic<size_t> attached{0};
+
+            std::vector<Entry> decoded(selected.size());
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, selected.size()),
+                              [&](const tbb::blocked_range<size_t>& range) {
+                                  for (size_t i = range.begin(); i != range.end(); ++i) {
+                                      Camera* cam = selected[i];
+                                      if (options.device && options.gpu_decode) {
+                                          auto pixels = load_image_cuda(cam->image_path(), options.resize_factor, options.max_width);
+                                          const int w = static_cast<int>(pixels.size(2));
+                                          const int h = static_cast<int>(pixels.size(1));
+                                          cam->update_image_dimensions(w, h);
+                                          decoded[i] = Entry{std::move(pixels), w, h};
+                                          continue;
+                                      }
+
+                                      torch::Tensor pixels;
+                                      if (shared) {
+                                          pixels = shared->attach(cam->image_path(), options.resize_factor, options.max_width);
+                                          attached += pixels.defined() ? 1 : 0;
+                                      }
+                                      if (!pixels.defined()) {
+                                          // Pinned either way, the RAM cache keeps it and the VRAM one uploads it
+                                          pixels = load_image_pinned(cam->image_path(), options.resize_factor, options.max_width);
+                                          if (shared) {
+                                              pixels = shared->publish(cam->image_path(), options.resize_factor, options.max_width, pixels);
+                                          }
+                                      }
+                                      const int w = static_cast<int>(pixels.size(1));
+                                      const int h = static_cast<int>(pixels.size(0));
+                                      if (options.device) {
+                                          pixels = pixels.to(torch::kCUDA).permute({2, 0, 1}).contiguous();
+                                      }
+
+                                      cam->update_image_dimensions(w, h);
+                                      decoded[i] = Entry{std::move(pixels), w, h};
+                                  }
+                              });
+
+            if (options.device) {
+                // GPU decodes are queued on the decoding threads' current streams
+                torch::cuda::synchronize();
+            }
+
+            auto cache = std::make_shared<ImageCache>();
+            cache->on_device_ = options.device;
+            cache->entries_.reserve(selected.size());
+            for (size_t i = 0; i < selected.size(); ++i) {
+                cache->num_bytes_ += decoded[i].pixels.nbytes();
+                cache->entries_.emplace(selected[i]->uid(), std::move(decoded[i]));
+            }
+
+            if (shared) {
+                LOG_INFO("Shared image cache {}: {} of {} images attached, the rest decoded and stored",
+                         options.shared_dir.string(), attached.load(), selected.size());
+            }
+
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            LOG_INFO("Preloaded {} images into {} ({:.1f} MB) in {:.2f}s",
+                     cache->size(), options.device ? "VRAM" : "RAM",
+                     cache->num_bytes() / (1024.0 * 1024.0), seconds);
+            return cache;
+        } catch (const std::exception& e) {
+            return std::unexpected(std::format("Failed to preload images: {}", e.what()));
+        }
+    }
+
+    const ImageCache::Entry* ImageCache::find(int uid) const {
+        const auto it = entries_.find(uid);
+        return it != entries_.end() ? &it->second : nullptr;
+    }
+
+    torch::Tensor ImageCache::to_cuda_float(const Entry& entry) {
+        if (entry.pixels.is_cuda()) {
+            return entry.pixels.to(torch::kFloat32).div_(255.0f);
+        }
+
+        // Called from loader worker threads, keep the upload off the trainer stream
+        at::cuda::CUDAStream stream = at::cuda::getStreamFromPool(false);
+        c10::cuda::CUDAStreamGuard guard(stream);
+
+        auto image = entry.pixels.to(torch::kCUDA, /*non_blocking=*/true)
+                         .permute({2, 0, 1})
+                         .to(torch::kFloat32)
+                         .div_(255.0f);
+
+        stream.synchronize();
+        return image;
+    }
+
+    void ImageCache::to_cuda_float(const Entry& entry, torch::Tensor& out) {
+        const auto source = entry.pixels.is_cuda()
+                                ? entry.pixels
+                                : entry.pixels.to(torch::kCUDA, /*non_blocking=*/true).permute({2, 0, 1});
+        if (!out.defined() || out.sizes() != source.sizes()) {
+            out = torch::empty(source.sizes(), torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA));
+        }
+        // copy_ does the uint8 -> float cast in the same kernel
+        out.copy_(source);
+        out.mul_(1.0f / 255.0f);
+    }
+
+} // namespace gs::training
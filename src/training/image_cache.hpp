@@ -0,0 +1,66 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <torch/torch.h>
+#include <unordered_map>
+#include <vector>
+
+namespace gs {
+    class Camera;
+}
+
+namespace gs::training {
+
+    // Decoded ground-truth images kept as uint8 in host RAM or in VRAM, so every training
+    // step skips the file read, JPEG decode and resample. Built once, read-only afterwards.
+    class ImageCache {
+    public:
+        struct Entry {
+            torch::Tensor pixels; // Host: [H, W, C] uint8 pinned or shared. Device: [C, H, W] uint8 CUDA
+            int width = 0;
+            int height = 0;
+        };
+
+        struct Options {
+            int resize_factor = -1;
+            int max_width = 3840;
+            size_t max_bytes = 0; // Images beyond this budget stay on disk
+            bool device = false;  // Keep images resident in VRAM instead of pinned host memory
+            bool gpu_decode = false; // With device, decode through load_image_cuda
+            std::filesystem::path shared_dir; // Host images are attached from a SharedImageStore there
+
+            bool operator==(const Options&) const = default;
+        };
+
+        // Decodes the given cameras in parallel, in order, until the byte budget is used up
+        static std::expected<std::shared_ptr<ImageCache>, std::string> build(
+            const std::vector<Camera*>& cameras,
+            const Options& options);
+
+        // nullptr if the camera was not cached
+        const Entry* find(int uid) const;
+
+        // Converts a cached image to the float32 [C, H, W] CUDA layout used for training
+        static torch::Tensor to_cuda_float(const Entry& entry);
+
+        // Same as to_cuda_float, writing into a reusable buffer on the current stream
+        static void to_cuda_float(const Entry& entry, torch::Tensor& out);
+
+        size_t size() const { return entries_.size(); }
+        size_t num_bytes() const { return num_bytes_; }
+        bool on_device() const { return on_device_; }
+
+    private:
+        std::unordered_map<int, Entry> entries_;
+        size_t num_bytes_ = 0;
+        bool on_device_ = false;
+    };
+
+} // namespace gs::training
@@ -0,0 +1,376 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "job_queue.hpp"
+#include "core/logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <format>
+#include <fstream>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <cuda_runtime.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace gs::training {
+
+#ifndef _WIN32
+    namespace {
+
+        constexpr double USABLE_MEMORY = 0.9;                 // Of a device, the rest for the driver and fragmentation
+        constexpr size_t CONTEXT_BYTES = size_t{512} << 20;   // CUDA context and libtorch workspace of each job
+        constexpr size_t PREFETCH_CHUNK = size_t{1} << 20;
+
+        struct Job {
+            size_t index = 0;
+            std::filesystem::path data_path;
+            std::filesystem::path output_path;
+            std::filesystem::path config;
+            std::vector<std::string> args;
+            size_t vram_bytes = 0; // 0: a device of its own
+        };
+
+        struct Device {
+            int index = 0;
+            std::string visible_id; // CUDA_VISIBLE_DEVICES entry of the jobs placed here
+            size_t capacity = 0;    // Bytes the estimates of its jobs may add up to
+            size_t committed = 0;
+            int running = 0;
+            bool exclusive = false;
+        };
+
+        struct RunningJob {
+            size_t job;
+            size_t device;
+            std::chrono::steady_clock::time_point start;
+        };
+
+        std::expected<std::vector<Job>, std::string> read_jobs(const std::filesystem::path& path) {
+            std::ifstream file(path);
+            if (!file) {
+                return std::unexpected(std::format("Cannot open job queue {}", path.string()));
+            }
+            nlohmann::json queue;
+            try {
+                queue = nlohmann::json::parse(file);
+            } catch (const nlohmann::json::exception& e) {
+                return std::unexpected(std::format("Job queue {} is not valid JSON: {}", path.string(), e.what()));
+            }
+            if (!queue.is_array() || queue.empty()) {
+                return std::unexpected(std::format("Job queue {} must be a non-empty array of jobs", path.string()));
+            }
+
+            const auto base = path.parent_path();
+            const auto resolve = [&base](const std::string& value) {
+                const std::filesystem::path p(value);
+                return p.is_absolute() ? p : base / p;
+            };
+
+            std::vector<Job> jobs;
+            for (size_t i = 0; i < queue.size(); ++i) {
+                const auto& entry = queue[i];
+                try {
+                    Job job{.index = i};
+                    job.data_path = resolve(entry.at("data_path").get<std::string>());
+                    job.output_path = resolve(entry.at("output_path").get<std::string>());
+                    if (entry.contains("config")) {
+                        job.config = resolve(entry["config"].get<std::string>());
+                    }
+                    if (entry.contains("args")) {
+                        job.args = entry["args"].get<std::vector<std::string>>();
+                    }
+                    if (entry.contains("vram_mb")) {
+                        const double vram_mb = entry["vram_mb"].get<double>();
+                        if (vram_mb <= 0.0) {
+                            return std::unexpected(std::format("Job {} of {}: vram_mb must be positive", i, path.string()));
+                        }
+                        job.vram_bytes = static_cast<size_t>(vram_mb * (1 << 20)) + CONTEXT_BYTES;
+                    }
+                    if (!std::filesystem::exists(job.data_path)) {
+                        return std::unexpected(std::format("Job {} of {}: dataset {} does not exist",
+                                                           i, path.string(), job.data_path.string()));
+                    }
+                    if (!job.config.empty() && !std::filesystem::exists(job.config)) {
+                        return std::unexpected(std::format("Job {} of {}: config {} does not exist",
+                                                           i, path.string(), job.config.string()));
+                    }
+                    jobs.push_back(std::move(job));
+                } catch (const nlohmann::json::exception& e) {
+                    return std::unexpected(std::format("Job {} of {}: {}", i, path.string(), e.what()));
+                }
+            }
+            return jobs;
+        }
+
+        // Devices as this process sees them, the jobs get the matching entry of our own
+        // CUDA_VISIBLE_DEVICES so a restricted parent stays restricted
+        std::expected<std::vector<Device>, std::string> find_devices(const std::vector<int>& requested) {
+            int count = 0;
+            if (const cudaError_t err = cudaGetDeviceCount(&count); err != cudaSuccess || count == 0) {
+                return std::unexpected(std::format("No CUDA device for the job queue: {}",
+                                                   err != cudaSuccess ? cudaGetErrorString(err) : "none visible"));
+            }
+
+            std::vector<std::string> visible;
+            if (const char* env = std::getenv("CUDA_VISIBLE_DEVICES"); env && *env) {
+                std::string list(env);
+                size_t begin = 0;
+                while (begin <= list.size()) {
+                    const size_t end = std::min(list.find(',', begin), list.size());
+                    visible.push_back(list.substr(begin, end - begin));
+                    begin = end + 1;
+                }
+            }
+
+            std::vector<int> indices = requested;
+            if (indices.empty()) {
+                for (int i = 0; i < count; ++i) {
+                    indices.push_back(i);
+                }
+            }
+
+            std::vector<Device> devices;
+            for (const int index : indices) {
+                if (index < 0 || index >= count) {
+                    return std::unexpected(std::format("GPU {} is not visible, {} device(s) found", index, count));
+                }
+                cudaDeviceProp prop{};
+                if (const cudaError_t err = cudaGetDeviceProperties(&prop, index); err != cudaSuccess) {
+                    return std::unexpected(std::format("Cannot query GPU {}: {}", index, cudaGetErrorString(err)));
+                }
+                devices.push_back({.index = index,
+                                   .visible_id = static_cast<size_t>(index) < visible.size() ? visible[index] : std::to_string(index),
+                                   .capacity = static_cast<size_t>(static_cast<double>(prop.totalGlobalMem) * USABLE_MEMORY)});
+                LOG_INFO("Job queue GPU {}: {} with {} MiB", index, prop.name, prop.totalGlobalMem >> 20);
+            }
+            return devices;
+        }
+
+        // Device the job can start on now, the one with the most room left among the fitting ones
+        std::optional<size_t> place(const Job& job, const std::vector<Device>& devices, const int jobs_per_gpu) {
+            std::optional<size_t> best;
+            for (size_t d = 0; d < devices.size(); ++d) {
+                const Device& device = devices[d];
+                if (device.exclusive) {
+                    continue;
+                }
+                // An estimate beyond the device is no estimate, such a job also runs alone
+                const bool alone = job.vram_bytes == 0 || job.vram_bytes > device.capacity;
+                if (alone ? device.running > 0
+                          : device.running >= jobs_per_gpu || device.committed + job.vram_bytes > device.capacity) {
+                    continue;
+                }
+                if (!best || device.capacity - device.committed > devices[*best].capacity - devices[*best].committed) {
+                    best = d;
+                }
+            }
+            return best;
+        }
+
+        std::expected<pid_t, std::string> spawn_job(const Job& job, const Device& device) {
+            std::error_code ec;
+            std::filesystem::create_directories(job.output_path, ec);
+            if (ec) {
+                return std::unexpected(std::format("Cannot create {}: {}", job.output_path.string(), ec.message()));
+            }
+
+            std::vector<std::string> args = {"/proc/self/exe", "--headless",
+                                             "--data-path", job.data_path.string(),
+                                             "--output-path", job.output_path.string()};
+            if (!job.config.empty()) {
+                args.insert(args.end(), {"--config", job.config.string()});
+            }
+            args.insert(args.end(), job.args.begin(), job.args.end());
+
+            // Our environment with the device of the job
+            const std::string visible = "CUDA_VISIBLE_DEVICES=" + device.visible_id;
+            std::vector<char*> env;
+            for (char** var = environ; *var; ++var) {
+                if (!std::string_view(*var).starts_with("CUDA_VISIBLE_DEVICES=")) {
+                    env.push_back(*var);
+                }
+            }
+            env.push_back(const_cast<char*>(visible.c_str()));
+            env.push_back(nullptr);
+
+            std::vector<char*> argv;
+            for (auto& arg : args) {
+                argv.push_back(arg.data());
+            }
+            argv.push_back(nullptr);
+
+            const auto log_path = (job.output_path / "job.log").string();
+            posix_spawn_file_actions_t actions;
+            posix_spawn_file_actions_init(&actions);
+            posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, log_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+            pid_t pid = -1;
+            const int error = posix_spawn(&pid, argv[0], &actions, nullptr, argv.data(), env.data());
+            posix_spawn_file_actions_destroy(&actions);
+            if (error != 0) {
+                return std::unexpected(std::format("Failed to start the job process: {}", std::strerror(error)));
+            }
+            return pid;
+        }
+
+        // Reads the files of one dataset on a thread of its own and drops the contents, the
+        // loading of its job then reads them from the page cache
+        class DatasetPrefetch {
+        public:
+            void prefetch(const Job& job) {
+                if (current_ == job.index) {
+                    return;
+                }
+                current_ = job.index;
+                thread_ = std::jthread([path = job.data_path](std::stop_token stop) {
+                    std::vector<char> buffer(PREFETCH_CHUNK);
+                    size_t bytes = 0;
+                    std::error_code ec;
+                    for (auto it = std::filesystem::recursive_directory_iterator(path, ec);
+                         !ec && it != std::filesystem::recursive_directory_iterator() && !stop.stop_requested();
+                         it.increment(ec)) {
+                        if (!it->is_regular_file(ec)) {
+                            continue;
+                        }
+                        std::ifstream file(it->path(), std::ios::binary);
+                        while (file && !stop.stop_requested()) {
+                            file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                            bytes += static_cast<size_t>(file.gcount());
+                        }
+                    }
+                    LOG_DEBUG("Prefetched {} MiB of {}", bytes >> 20, path.string());
+                });
+            }
+
+        private:
+            std::optional<size_t> current_;
+            std::jthread thread_; // Assigning a new one stops and joins the previous prefetch
+        };
+
+    } // namespace
+#endif
+
+    std::expected<JobQueueSummary, std::string> run_job_queue(const param::JobQueueParameters& params) {
+#ifdef _WIN32
+        (void)params;
+        return std::unexpected("The job queue needs POSIX process control and is not available on Windows");
+#else
+        auto jobs = read_jobs(params.jobs_file);
+        if (!jobs) {
+            return std::unexpected(jobs.error());
+        }
+        auto devices = find_devices(params.gpus);
+        if (!devices) {
+            return std::unexpected(devices.error());
+        }
+        LOG_INFO("Job queue: {} job(s) on {} GPU(s), up to {} packed per GPU",
+                 jobs->size(), devices->size(), params.jobs_per_gpu);
+
+        std::deque<size_t> pending;
+        for (size_t i = 0; i < jobs->size(); ++i) {
+            pending.push_back(i);
+        }
+        std::map<pid_t, RunningJob> running;
+        DatasetPrefetch prefetch;
+        JobQueueSummary summary;
+
+        const auto release = [&](const RunningJob& run) {
+            Device& device = (*devices)[run.device];
+            const Job& job = (*jobs)[run.job];
+            --device.running;
+            if (device.exclusive) {
+                device.exclusive = false;
+            } else {
+                device.committed -= job.vram_bytes;
+            }
+        };
+
+        while (!pending.empty() || !running.empty()) {
+            // Queue order, a later job fills a device the head doesn't fit on
+            for (auto it = pending.begin(); it != pending.end();) {
+                const Job& job = (*jobs)[*it];
+                const auto d = place(job, *devices, params.jobs_per_gpu);
+                if (!d) {
+                    ++it;
+                    continue;
+                }
+                Device& device = (*devices)[*d];
+                auto pid = spawn_job(job, device);
+                if (!pid) {
+                    LOG_ERROR("Job {} ({}): {}", job.index, job.data_path.string(), pid.error());
+                    ++summary.failed;
+                    it = pending.erase(it);
+                    continue;
+                }
+                ++device.running;
+                if (job.vram_bytes == 0 || job.vram_bytes > device.capacity) {
+                    device.exclusive = true;
+                } else {
+                    device.committed += job.vram_bytes;
+                }
+                running.emplace(*pid, RunningJob{.job = job.index, .device = *d, .start = std::chrono::steady_clock::now()});
+                LOG_INFO("Job {} ({}) started on GPU {}, log in {}",
+                         job.index, job.data_path.string(), device.index, (job.output_path / "job.log").string());
+                it = pending.erase(it);
+            }
+
+            if (!pending.empty()) {
+                prefetch.prefetch((*jobs)[pending.front()]);
+            }
+            if (running.empty()) {
+                continue;
+            }
+
+            int status = 0;
+            const pid_t pid = waitpid(-1, &status, 0);
+            if (pid < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return std::unexpected(std::format("Waiting for the jobs failed: {}", std::strerror(errno)));
+            }
+            const auto found = running.find(pid);
+            if (found == running.end()) {
+                continue;
+            }
+            const RunningJob run = found->second;
+            running.erase(found);
+            release(run);
+
+            const Job& job = (*jobs)[run.job];
+            const double minutes = std::chrono::duration<double>(std::chrono::steady_clock::now() - run.start).count() / 60.0;
+            if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+                ++summary.succeeded;
+                LOG_INFO("Job {} ({}) finished in {:.1f} min", job.index, job.data_path.string(), minutes);
+            } else {
+                ++summary.failed;
+                LOG_ERROR("Job {} ({}) failed after {:.1f} min with {}, see {}",
+                          job.index, job.data_path.string(), minutes,
+                          WIFSIGNALED(status) ? std::format("signal {}", WTERMSIG(status))
+                                              : std::format("exit code {}", WEXITSTATUS(status)),
+                          (job.output_path / "job.log").string());
+            }
+        }
+
+        LOG_INFO("Job queue done: {} succeeded, {} failed", summary.succeeded, summary.failed);
+        return summary;
+#endif
+    }
+
+} // namespace gs::training
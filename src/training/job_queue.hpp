@@ -0,0 +1,37 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/parameters.hpp"
+#include <cstddef>
+#include <expected>
+#include <string>
+
+namespace gs::training {
+
+    struct JobQueueSummary {
+        size_t succeeded = 0;
+        size_t failed = 0;
+    };
+
+    // Trains every job of a queue file, each in a headless process of this executable pinned to
+    // one GPU through CUDA_VISIBLE_DEVICES. The file is a JSON array of
+    //
+    //   {"data_path": "garden", "output_path": "out/garden", "config": "mcmc.json",
+    //    "args": ["--iter", "7000"], "vram_mb": 6000}
+    //
+    // where only data_path and output_path are required and relative paths are taken from the
+    // file's directory. A job with a vram_mb estimate shares its device with up to jobs_per_gpu
+    // estimated jobs as long as the estimates fit the device memory, a job without one gets a
+    // device of its own. Jobs start in queue order, a later job only goes first when the head of
+    // the queue doesn't fit anywhere yet. While jobs train, the files of the next queued dataset
+    // are read ahead so its loading finds them in the page cache.
+    //
+    // Each job logs to job.log in its output path. A job that fails is logged and counted, the
+    // others still run; only an unreadable queue file or no usable GPU is an error.
+    // POSIX only.
+    std::expected<JobQueueSummary, std::string> run_job_queue(const param::JobQueueParameters& params);
+
+} // namespace gs::training
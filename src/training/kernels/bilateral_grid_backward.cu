@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "kernels/bilateral_grid.cuh"
+#include <ATen/cuda/CUDAContext.h>
 #include <cuda_runtime.h>
 
 namespace gs {
@@ -171,7 +172,7 @@ namespace gs {
             const int total = h * w;
             const int blocks = min((total + threads - 1) / threads, 65535);
 
-            slice_backward_kernel<<<blocks, threads>>>(
+            slice_backward_kernel<<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(
                 grid.data_ptr<float>(),
                 rgb.data_ptr<float>(),
                 grad_output.data_ptr<float>(),
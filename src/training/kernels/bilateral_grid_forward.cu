@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "kernels/bilateral_grid.cuh"
+#include <ATen/cuda/CUDAContext.h>
 #include <cuda_runtime.h>
 
 namespace gs {
@@ -107,7 +108,7 @@ namespace gs {
             const int threads = 256;
             const int blocks = (h * w + threads - 1) / threads;
 
-            slice_forward_kernel<<<blocks, threads>>>(
+            slice_forward_kernel<<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(
                 grid.data_ptr<float>(),
                 rgb.data_ptr<float>(),
                 output.data_ptr<float>(),
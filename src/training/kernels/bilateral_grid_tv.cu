@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "kernels/bilateral_grid.cuh"
+#include <ATen/cuda/CUDAContext.h>
 #include <cub/cub.cuh>
 #include <cuda_runtime.h>
 
@@ -80,15 +81,15 @@ namespace gs {
         // Backward pass - compute gradients of TV loss
         __global__ void tv_loss_backward_kernel(
             const float* __restrict__ grids, // [N, 12, L, H, W]
-            const float grad_output,         // scalar gradient
-            float* __restrict__ grad_grids,  // [N, 12, L, H, W]
+            const float* __restrict__ grad_output, // scalar gradient, read on the device
+            float* __restrict__ grad_grids,        // [N, 12, L, H, W]
             int N, int L, int H, int W) {
             const size_t total = (size_t)N * 12 * L * H * W;
             size_t tid = blockIdx.x * blockDim.x + threadIdx.x;
             const size_t stride = gridDim.x * blockDim.x;
 
             // Scaling factors
-            const float s = grad_output / (6 * N);
+            const float s = *grad_output / (6 * N);
             const float sx = s / (float)(L * H * (W - 1));
             const float sy = s / (float)(L * (H - 1) * W);
             const float sz = s / (float)((L - 1) * H * W);
@@ -156,7 +157,7 @@ namespace gs {
             const int total = N * L * H * W;
             const int blocks = min((total + threads - 1) / threads, 2048);
 
-            tv_loss_forward_kernel<<<blocks, threads>>>(
+            tv_loss_forward_kernel<<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(
                 grids.data_ptr<float>(),
                 tv_loss.data_ptr<float>(),
                 N, L, H, W);
@@ -172,15 +173,16 @@ namespace gs {
             const int H = grids.size(3);
             const int W = grids.size(4);
 
-            auto grad_grids = torch::zeros_like(grids);
+            auto grad_grids = torch::empty_like(grids);
+            const auto grad = grad_output.to(torch::kFloat32).contiguous();
 
             const size_t total = (size_t)N * 12 * L * H * W;
             const int threads = 256;
             const int blocks = min((int)((total + threads - 1) / threads), 2048);
 
-            tv_loss_backward_kernel<<<blocks, threads>>>(
+            tv_loss_backward_kernel<<<blocks, threads, 0, at::cuda::getCurrentCUDAStream()>>>(
                 grids.data_ptr<float>(),
-                grad_output.item<float>(),
+                grad.data_ptr<float>(),
                 grad_grids.data_ptr<float>(),
                 N, L, H, W);
 
@@ -0,0 +1,102 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "kernels/regularization.cuh"
+#include <ATen/cuda/CUDAContext.h>
+#include <algorithm>
+#include <cub/cub.cuh>
+#include <cuda_runtime.h>
+
+namespace gs {
+    namespace regularization {
+
+        constexpr int THREADS = 256;
+        constexpr int MAX_BLOCKS = 2048;
+
+        __global__ void scale_opacity_reg_kernel(
+            const float* __restrict__ scaling_raw,
+            float* __restrict__ scaling_grad,
+            int64_t n_scaling,
+            float scale_coeff, // weight / n_scaling
+            const float* __restrict__ opacity_raw,
+            float* __restrict__ opacity_grad,
+            int64_t n_opacity,
+            float opacity_coeff, // weight / n_opacity
+            float* __restrict__ loss) {
+            typedef cub::BlockReduce<float, THREADS> BlockReduce;
+            __shared__ typename BlockReduce::TempStorage temp_storage;
+
+            float local_sum = 0.0f;
+            const int64_t n = max(n_scaling, n_opacity);
+            const int64_t stride = static_cast<int64_t>(gridDim.x) * blockDim.x;
+            for (int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x; i < n; i += stride) {
+                if (i < n_scaling) {
+                    const float scale = expf(scaling_raw[i]);
+                    scaling_grad[i] += scale_coeff * scale;
+                    local_sum += scale_coeff * scale;
+                }
+                if (i < n_opacity) {
+                    const float opa = 1.0f / (1.0f + expf(-opacity_raw[i]));
+                    opacity_grad[i] += opacity_coeff * opa * (1.0f - opa);
+                    local_sum += opacity_coeff * opa;
+                }
+            }
+
+            local_sum = BlockReduce(temp_storage).Sum(local_sum);
+            if (threadIdx.x == 0) {
+                atomicAdd(loss, local_sum);
+            }
+        }
+
+        namespace {
+            void check_pair(const torch::Tensor& raw, const torch::Tensor& grad, const char* name) {
+                TORCH_CHECK(raw.is_cuda() && raw.scalar_type() == torch::kFloat32 && raw.is_contiguous(),
+                            name, " must be a contiguous float32 CUDA tensor");
+                TORCH_CHECK(grad.defined() && grad.sizes() == raw.sizes() && grad.scalar_type() == torch::kFloat32 &&
+                                grad.is_contiguous(),
+                            name, " gradient must be a contiguous float32 tensor of the same shape");
+            }
+        } // namespace
+
+        torch::Tensor scale_opacity_reg_cuda(
+            const torch::Tensor& scaling_raw,
+            torch::Tensor& scaling_grad,
+            float scale_weight,
+            const torch::Tensor& opacity_raw,
+            torch::Tensor& opacity_grad,
+            float opacity_weight) {
+            const bool with_scale = scale_weight > 0.0f && scaling_raw.numel() > 0;
+            const bool with_opacity = opacity_weight > 0.0f && opacity_raw.numel() > 0;
+            if (with_scale) {
+                check_pair(scaling_raw, scaling_grad, "scaling");
+            }
+            if (with_opacity) {
+                check_pair(opacity_raw, opacity_grad, "opacity");
+            }
+
+            auto loss = torch::zeros({}, torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA));
+            const int64_t n_scaling = with_scale ? scaling_raw.numel() : 0;
+            const int64_t n_opacity = with_opacity ? opacity_raw.numel() : 0;
+            const int64_t n = std::max(n_scaling, n_opacity);
+            if (n == 0) {
+                return loss;
+            }
+
+            const int blocks = static_cast<int>(std::min<int64_t>((n + THREADS - 1) / THREADS, MAX_BLOCKS));
+            scale_opacity_reg_kernel<<<blocks, THREADS, 0, at::cuda::getCurrentCUDAStream()>>>(
+                with_scale ? scaling_raw.data_ptr<float>() : nullptr,
+                with_scale ? scaling_grad.data_ptr<float>() : nullptr,
+                n_scaling,
+                with_scale ? scale_weight / static_cast<float>(n_scaling) : 0.0f,
+                with_opacity ? opacity_raw.data_ptr<float>() : nullptr,
+                with_opacity ? opacity_grad.data_ptr<float>() : nullptr,
+                n_opacity,
+                with_opacity ? opacity_weight / static_cast<float>(n_opacity) : 0.0f,
+                loss.data_ptr<float>());
+            C10_CUDA_KERNEL_LAUNCH_CHECK();
+            return loss;
+        }
+
+    } // namespace regularization
+} // namespace gs
@@ -0,0 +1,288 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "kernels/sparsity.cuh"
+#include <ATen/cuda/CUDAContext.h>
+#include <algorithm>
+#include <cub/cub.cuh>
+#include <cuda_runtime.h>
+#include <limits>
+
+namespace gs {
+    namespace sparsity {
+
+        constexpr int THREADS = 256;
+        constexpr int MAX_BLOCKS = 2048;
+        constexpr int RADIX_BITS = 8;
+        constexpr int RADIX_BINS = 1 << RADIX_BITS;
+        constexpr int RADIX_PASSES = 32 / RADIX_BITS;
+
+        // Order-preserving map of a float onto an unsigned key
+        __device__ __forceinline__ uint32_t float_to_key(float value) {
+            const uint32_t bits = __float_as_uint(value);
+            return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+        }
+
+        __device__ __forceinline__ float key_to_float(uint32_t key) {
+            return __uint_as_float((key & 0x80000000u) ? key & 0x7fffffffu : ~key);
+        }
+
+        __device__ __forceinline__ float sigmoid(float x) {
+            return 1.0f / (1.0f + expf(-x));
+        }
+
+        // Counts the keys that match the prefix selected so far into the bins of the current digit.
+        // With COMPUTE, the first pass also forms z = sigmoid(opacities_raw) + u and stores it
+        template <bool COMPUTE>
+        __global__ void radix_histogram_kernel(
+            float* __restrict__ values,               // [n] selected from, written with COMPUTE
+            const float* __restrict__ opacities_raw, // [n] only read with COMPUTE
+            const float* __restrict__ u,             // [n] only read with COMPUTE
+            const uint32_t* __restrict__ state,      // {prefix, k}, unused in the first pass
+            uint32_t* __restrict__ histogram,        // [RADIX_BINS]
+            int64_t n,
+            int shift) {
+            __shared__ uint32_t local[RADIX_BINS];
+            for (int b = threadIdx.x; b < RADIX_BINS; b += blockDim.x) {
+                local[b] = 0;
+            }
+            __syncthreads();
+
+            const bool first_pass = shift == 32 - RADIX_BITS;
+            const uint32_t high_mask = first_pass ? 0u : ~0u << (shift + RADIX_BITS);
+            const uint32_t prefix = first_pass ? 0u : state[0] & high_mask;
+
+            const int64_t stride = static_cast<int64_t>(gridDim.x) * blockDim.x;
+            for (int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x; i < n; i += stride) {
+                float value;
+                if constexpr (COMPUTE) {
+                    value = sigmoid(opacities_raw[i]) + u[i];
+                    values[i] = value;
+                } else {
+                    value = values[i];
+                }
+                const uint32_t key = float_to_key(value);
+                if ((key & high_mask) == prefix) {
+                    atomicAdd(&local[(key >> shift) & (RADIX_BINS - 1)], 1u);
+                }
+            }
+            __syncthreads();
+
+            for (int b = threadIdx.x; b < RADIX_BINS; b += blockDim.x) {
+                if (local[b] > 0) {
+                    atomicAdd(&histogram[b], local[b]);
+                }
+            }
+        }
+
+        // Single block: picks the bin holding the k-th key and narrows {prefix, k} to it
+        __global__ void radix_select_kernel(
+            uint32_t* __restrict__ state,
+            const uint32_t* __restrict__ histogram,
+            uint32_t k_init,
+            int shift) {
+            typedef cub::BlockScan<uint32_t, RADIX_BINS> BlockScan;
+            __shared__ typename BlockScan::TempStorage temp_storage;
+
+            const bool first_pass = shift == 32 - RADIX_BITS;
+            const uint32_t prefix = first_pass ? 0u : state[0];
+            const uint32_t k = first_pass ? k_init : state[1];
+
+            const uint32_t count = histogram[threadIdx.x];
+            uint32_t before;
+            BlockScan(temp_storage).ExclusiveSum(count, before);
+            __syncthreads();
+
+            if (before < k && k <= before + count) {
+                state[0] = prefix | (static_cast<uint32_t>(threadIdx.x) << shift);
+                state[1] = k - before;
+            }
+        }
+
+        __global__ void admm_finalize_kernel(
+            const float* __restrict__ opacities_raw,
+            float* __restrict__ z,
+            float* __restrict__ u,
+            const uint32_t* __restrict__ state,
+            int64_t n,
+            bool prune_all,
+            bool update_dual) {
+            const float threshold = key_to_float(state[0]);
+            const int64_t stride = static_cast<int64_t>(gridDim.x) * blockDim.x;
+            for (int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x; i < n; i += stride) {
+                const float value = z[i];
+                const float pruned = (!prune_all && value > threshold) ? value : 0.0f;
+                z[i] = pruned;
+                if (update_dual) {
+                    u[i] += sigmoid(opacities_raw[i]) - pruned;
+                }
+            }
+        }
+
+        __global__ void admm_loss_forward_kernel(
+            const float* __restrict__ opacities_raw,
+            const float* __restrict__ z,
+            const float* __restrict__ u,
+            float* __restrict__ loss, // scalar output
+            int64_t n,
+            float half_rho) {
+            typedef cub::BlockReduce<float, THREADS> BlockReduce;
+            __shared__ typename BlockReduce::TempStorage temp_storage;
+
+            float local_sum = 0.0f;
+            const int64_t stride = static_cast<int64_t>(gridDim.x) * blockDim.x;
+            for (int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x; i < n; i += stride) {
+                const float diff = sigmoid(opacities_raw[i]) - z[i] + u[i];
+                local_sum += diff * diff;
+            }
+
+            local_sum = BlockReduce(temp_storage).Sum(local_sum);
+            if (threadIdx.x == 0) {
+                atomicAdd(loss, half_rho * local_sum);
+            }
+        }
+
+        __global__ void admm_loss_backward_kernel(
+            const float* __restrict__ opacities_raw,
+            const float* __restrict__ z,
+            const float* __restrict__ u,
+            const float* __restrict__ grad_output, // scalar gradient, read on the device
+            float* __restrict__ grad_opacities,
+            int64_t n,
+            float rho) {
+            const float scale = *grad_output * rho;
+            const int64_t stride = static_cast<int64_t>(gridDim.x) * blockDim.x;
+            for (int64_t i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x; i < n; i += stride) {
+                const float opa = sigmoid(opacities_raw[i]);
+                grad_opacities[i] = scale * (opa - z[i] + u[i]) * opa * (1.0f - opa);
+            }
+        }
+
+        namespace {
+            int blocks_for(int64_t n) {
+                return static_cast<int>(std::min<int64_t>((n + THREADS - 1) / THREADS, MAX_BLOCKS));
+            }
+
+            void check_inputs(const torch::Tensor& opacities_raw, const torch::Tensor& z, const torch::Tensor& u) {
+                TORCH_CHECK(opacities_raw.is_cuda() && opacities_raw.scalar_type() == torch::kFloat32 &&
+                                opacities_raw.is_contiguous(),
+                            "opacities must be a contiguous float32 CUDA tensor");
+                TORCH_CHECK(z.numel() == opacities_raw.numel() && u.numel() == opacities_raw.numel(),
+                            "z and u must match the opacities");
+                TORCH_CHECK(z.is_contiguous() && u.is_contiguous(), "z and u must be contiguous");
+            }
+
+            // Radix select of the k-th smallest of sigmoid(opacities_raw) + u over four 8-bit digits.
+            // The selected key and the remaining rank stay in a device {prefix, k} pair, so nothing
+            // is read back. The first histogram pass also writes the values it selects from.
+            torch::Tensor radix_select(float* values,
+                                       const float* opacities_raw,
+                                       const float* u,
+                                       int64_t n,
+                                       int64_t k,
+                                       const torch::TensorOptions& options,
+                                       cudaStream_t stream) {
+                TORCH_CHECK(k >= 1 && k <= n, "k must be in [1, n]");
+                TORCH_CHECK(n <= std::numeric_limits<uint32_t>::max(), "radix select supports up to 2^32 values");
+
+                auto state = torch::empty({2}, options.dtype(torch::kInt32));
+                auto histograms = torch::zeros({RADIX_PASSES, RADIX_BINS}, options.dtype(torch::kInt32));
+                auto* state_ptr = reinterpret_cast<uint32_t*>(state.data_ptr<int32_t>());
+                auto* histogram_ptr = reinterpret_cast<uint32_t*>(histograms.data_ptr<int32_t>());
+                const int blocks = blocks_for(n);
+
+                for (int pass = 0; pass < RADIX_PASSES; ++pass) {
+                    const int shift = 32 - RADIX_BITS * (pass + 1);
+                    uint32_t* histogram = histogram_ptr + pass * RADIX_BINS;
+                    if (pass == 0) {
+                        radix_histogram_kernel<true><<<blocks, THREADS, 0, stream>>>(
+                            values, opacities_raw, u, state_ptr, histogram, n, shift);
+                    } else {
+                        radix_histogram_kernel<false><<<blocks, THREADS, 0, stream>>>(
+                            values, nullptr, nullptr, state_ptr, histogram, n, shift);
+                    }
+                    radix_select_kernel<<<1, RADIX_BINS, 0, stream>>>(
+                        state_ptr, histogram, static_cast<uint32_t>(k), shift);
+                }
+                C10_CUDA_KERNEL_LAUNCH_CHECK();
+                return state;
+            }
+        } // namespace
+
+        void admm_update_cuda(
+            const torch::Tensor& opacities_raw,
+            torch::Tensor& z,
+            torch::Tensor& u,
+            int64_t n_prune,
+            bool update_dual) {
+            check_inputs(opacities_raw, z, u);
+            const int64_t n = opacities_raw.numel();
+            if (n == 0) {
+                return;
+            }
+
+            const auto stream = at::cuda::getCurrentCUDAStream();
+            const bool prune_all = n_prune <= 0;
+            auto state = radix_select(
+                z.data_ptr<float>(), opacities_raw.data_ptr<float>(), u.data_ptr<float>(),
+                n, prune_all ? 1 : std::min(n_prune, n), opacities_raw.options(), stream);
+
+            admm_finalize_kernel<<<blocks_for(n), THREADS, 0, stream>>>(
+                opacities_raw.data_ptr<float>(),
+                z.data_ptr<float>(),
+                u.data_ptr<float>(),
+                reinterpret_cast<const uint32_t*>(state.data_ptr<int32_t>()),
+                n, prune_all, update_dual);
+            C10_CUDA_KERNEL_LAUNCH_CHECK();
+        }
+
+        torch::Tensor admm_loss_forward_cuda(
+            const torch::Tensor& opacities_raw,
+            const torch::Tensor& z,
+            const torch::Tensor& u,
+            float rho) {
+            check_inputs(opacities_raw, z, u);
+            const int64_t n = opacities_raw.numel();
+            auto loss = torch::zeros({}, opacities_raw.options());
+            if (n == 0) {
+                return loss;
+            }
+
+            admm_loss_forward_kernel<<<blocks_for(n), THREADS, 0, at::cuda::getCurrentCUDAStream()>>>(
+                opacities_raw.data_ptr<float>(),
+                z.data_ptr<float>(),
+                u.data_ptr<float>(),
+                loss.data_ptr<float>(),
+                n, 0.5f * rho);
+            C10_CUDA_KERNEL_LAUNCH_CHECK();
+            return loss;
+        }
+
+        torch::Tensor admm_loss_backward_cuda(
+            const torch::Tensor& opacities_raw,
+            const torch::Tensor& z,
+            const torch::Tensor& u,
+            float rho,
+            const torch::Tensor& grad_output) {
+            check_inputs(opacities_raw, z, u);
+            const int64_t n = opacities_raw.numel();
+            auto grad_opacities = torch::empty_like(opacities_raw);
+            if (n == 0) {
+                return grad_opacities;
+            }
+            const auto grad = grad_output.to(torch::kFloat32).contiguous();
+
+            admm_loss_backward_kernel<<<blocks_for(n), THREADS, 0, at::cuda::getCurrentCUDAStream()>>>(
+                opacities_raw.data_ptr<float>(),
+                z.data_ptr<float>(),
+                u.data_ptr<float>(),
+                grad.data_ptr<float>(),
+                grad_opacities.data_ptr<float>(),
+                n, rho);
+            C10_CUDA_KERNEL_LAUNCH_CHECK();
+            return grad_opacities;
+        }
+
+    } // namespace sparsity
+} // namespace gs
@@ -2,6 +2,7 @@
  *
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
+#include <ATen/cuda/CUDAContext.h>
 #include <algorithm>
 #include <c10/cuda/CUDAGuard.h>
 #include <cooperative_groups.h>
@@ -53,11 +54,42 @@ __device__ __forceinline__ float get_pix_value(
     return img[b * CH * H * W + c * H * W + y * W + x];
 }
 
+// ------------------------------------------
+// 'valid' padding: the SSIM map only covers
+// pixels HALO inside the border and is stored
+// compactly as [B, CH, H - 2 * HALO, W - 2 * HALO]
+// ------------------------------------------
+__device__ __forceinline__ int map_index(
+    int b, int c, int y, int x,
+    int CH, int H, int W, bool crop) {
+    if (crop) {
+        y -= HALO;
+        x -= HALO;
+        H -= 2 * HALO;
+        W -= 2 * HALO;
+    }
+    return b * CH * H * W + c * H * W + y * W + x;
+}
+
+__device__ __forceinline__ float get_map_value(
+    const float* map,
+    int b, int c, int y, int x,
+    int CH, int H, int W, bool crop) {
+    if (x < 0 || x >= W || y < 0 || y >= H) {
+        return 0.0f;
+    }
+    if (crop && (y < HALO || y >= H - HALO || x < HALO || x >= W - HALO)) {
+        return 0.0f;
+    }
+    return map[map_index(b, c, y, x, CH, H, W, crop)];
+}
+
 // ------------------------------------------
 // Forward Kernel: Fused SSIM
 //  - Two-pass convolution to get mu1, mu2,
 //    sigma1_sq, sigma2_sq, sigma12, etc.
-//  - Writes final SSIM map to ssim_map
+//  - Writes final SSIM map to ssim_map, only
+//    the 'valid' region when crop is set
 //  - Optionally writes partial derivatives
 //    to dm_dmu1, dm_dsigma1_sq, dm_dsigma12
 // ------------------------------------------
@@ -67,6 +99,7 @@ __global__ void fusedssimCUDA(
     int CH,
     float C1,
     float C2,
+    bool crop,
     const float* __restrict__ img1,
     const float* __restrict__ img2,
     float* __restrict__ ssim_map,
@@ -258,7 +291,9 @@ __global__ void fusedssimCUDA(
                 float val = (C_ * D_) / (A * B);
 
                 int global_idx = bIdx * CH * num_pix + c * num_pix + pix_id;
-                ssim_map[global_idx] = val;
+                if (!crop || (pix_y >= HALO && pix_y < H - HALO && pix_x >= HALO && pix_x < W - HALO)) {
+                    ssim_map[map_index(bIdx, c, pix_y, pix_x, CH, H, W, crop)] = val;
+                }
 
                 if (dm_dmu1) {
                     // partial derivatives
@@ -279,7 +314,8 @@ __global__ void fusedssimCUDA(
 // Backward Kernel: Apply chain rule to get
 //    dL/d(img1) from partial derivatives
 //    (dm_dmu1, dm_dsigma1_sq, dm_dsigma12)
-//    and dL/dmap (the gradient from above).
+//    and dL/dmap (the gradient from above),
+//    laid out like the forward's ssim_map.
 // ------------------------------------------
 __global__ void fusedssim_backwardCUDA(
     int H,
@@ -287,6 +323,7 @@ __global__ void fusedssim_backwardCUDA(
     int CH,
     float C1,
     float C2,
+    bool crop,
     const float* __restrict__ img1,
     const float* __restrict__ img2,
     const float* __restrict__ dL_dmap,
@@ -330,7 +367,7 @@ __global__ void fusedssim_backwardCUDA(
                 for (int col = lane_id; col < SHARED_X; col += 32) {
                     int gx = start_x + col - HALO;
 
-                    float chain = get_pix_value(dL_dmap, bIdx, c, gy, gx, CH, H, W);
+                    float chain = get_map_value(dL_dmap, bIdx, c, gy, gx, CH, H, W, crop);
                     float vmu = get_pix_value(dm_dmu1, bIdx, c, gy, gx, CH, H, W);
                     float vs1 = get_pix_value(dm_dsigma1_sq, bIdx, c, gy, gx, CH, H, W);
                     float vs12 = get_pix_value(dm_dsigma12, bIdx, c, gy, gx, CH, H, W);
@@ -427,6 +464,7 @@ __global__ void fusedssim_backwardCUDA(
 // PyTorch Interface (Forward)
 //   Returns (ssim_map, dm_dmu1, dm_dsigma1_sq, dm_dsigma12).
 //   If train=false, derivative Tensors are empty.
+//   With valid=true the map is already cropped.
 // ------------------------------------------
 std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>
 fusedssim(
@@ -434,7 +472,8 @@ fusedssim(
     float C2,
     torch::Tensor& img1,
     torch::Tensor& img2,
-    bool train) {
+    bool train,
+    bool valid) {
     const at::cuda::OptionalCUDAGuard device_guard(device_of(img1));
     int B = img1.size(0);
     int CH = img1.size(1);
@@ -447,16 +486,19 @@ fusedssim(
               B);
     dim3 block(BLOCK_X, BLOCK_Y);
 
-    // Output SSIM map
-    auto ssim_map = torch::zeros_like(img1, img1.options()).contiguous();
+    // Every output element is written by the kernel, so nothing needs clearing.
+    // Images of at most 2 * HALO pixels keep the full map, as before.
+    const bool crop = valid && H > 2 * HALO && W > 2 * HALO;
+    auto ssim_map = crop ? torch::empty({B, CH, H - 2 * HALO, W - 2 * HALO}, img1.options())
+                         : torch::empty({B, CH, H, W}, img1.options());
 
     // Optionally allocate derivative Tensors
-    auto dm_dmu1 = train ? torch::zeros_like(img1) : torch::empty({0}, img1.options());
-    auto dm_dsigma1_sq = train ? torch::zeros_like(img1) : torch::empty({0}, img1.options());
-    auto dm_dsigma12 = train ? torch::zeros_like(img1) : torch::empty({0}, img1.options());
+    auto dm_dmu1 = train ? torch::empty({B, CH, H, W}, img1.options()) : torch::empty({0}, img1.options());
+    auto dm_dsigma1_sq = train ? torch::empty({B, CH, H, W}, img1.options()) : torch::empty({0}, img1.options());
+    auto dm_dsigma12 = train ? torch::empty({B, CH, H, W}, img1.options()) : torch::empty({0}, img1.options());
 
-    fusedssimCUDA<<<grid, block>>>(
-        H, W, CH, C1, C2,
+    fusedssimCUDA<<<grid, block, 0, at::cuda::getCurrentCUDAStream()>>>(
+        H, W, CH, C1, C2, crop,
         img1.contiguous().data_ptr<float>(),
         img2.contiguous().data_ptr<float>(),
         ssim_map.data_ptr<float>(),
@@ -471,7 +513,8 @@ fusedssim(
 // PyTorch Interface (Backward)
 //   Takes the gradient wrt the SSIM map and
 //   the partial derivatives from forward;
-//   returns dL/d(img1).
+//   returns dL/d(img1). dL_dmap has the shape
+//   of the forward's map for the same valid.
 // ------------------------------------------
 torch::Tensor
 fusedssim_backward(
@@ -482,22 +525,26 @@ fusedssim_backward(
     torch::Tensor& dL_dmap,
     torch::Tensor& dm_dmu1,
     torch::Tensor& dm_dsigma1_sq,
-    torch::Tensor& dm_dsigma12) {
+    torch::Tensor& dm_dsigma12,
+    bool valid) {
     const at::cuda::OptionalCUDAGuard device_guard(device_of(img1));
     int B = img1.size(0);
     int CH = img1.size(1);
     int H = img1.size(2);
     int W = img1.size(3);
 
-    auto dL_dimg1 = torch::zeros_like(img1);
+    const bool crop = valid && H > 2 * HALO && W > 2 * HALO;
+    TORCH_CHECK(dL_dmap.numel() == (crop ? B * CH * (H - 2 * HALO) * (W - 2 * HALO) : img1.numel()),
+                "fusedssim_backward: dL_dmap does not match the forward's SSIM map");
+    auto dL_dimg1 = torch::empty_like(img1);
 
     dim3 grid((W + BLOCK_X - 1) / BLOCK_X,
               (H + BLOCK_Y - 1) / BLOCK_Y,
               B);
     dim3 block(BLOCK_X, BLOCK_Y);
 
-    fusedssim_backwardCUDA<<<grid, block>>>(
-        H, W, CH, C1, C2,
+    fusedssim_backwardCUDA<<<grid, block, 0, at::cuda::getCurrentCUDAStream()>>>(
+        H, W, CH, C1, C2, crop,
         img1.contiguous().data_ptr<float>(),
         img2.contiguous().data_ptr<float>(),
         dL_dmap.contiguous().data_ptr<float>(),
@@ -508,3 +555,624 @@ fusedssim_backward(
 
     return dL_dimg1;
 }
+
+// ------------------------------------------
+// Fused photometric loss:
+//   (1 - lambda) * L1 + lambda * (1 - SSIM)
+//  - The rendered side is composited on load:
+//    x = mask * (image + (1 - alpha) * bg),
+//    optionally sliced through a bilateral grid:
+//    x = mask * slice(clamp(composite, 0, 1))
+//  - L1 averages every pixel, SSIM the 'valid'
+//    region 5 pixels inside the border
+//  - Per-block sums go to loss_sums[2] with
+//    one atomic each
+// ------------------------------------------
+struct PhotometricInputs {
+    const float* image;      // [B, CH, H, W]
+    const float* alpha;      // [B, 1, H, W], nullptr: image is already composited
+    const float* background; // [CH]
+    const float* mask;       // [H, W] or nullptr
+    const float* bilateral_grid; // [12, L, GH, GW] or nullptr, needs CH == 3
+    int grid_L;
+    int grid_H;
+    int grid_W;
+};
+
+__constant__ float cRGB2Gray[3] = {0.299f, 0.587f, 0.114f};
+
+// Trilinear cell of a pixel in the bilateral grid, same uniform coordinates as slice_forward_cuda
+struct BilateralCell {
+    int x0, x1, y0, y1, z0, z1;
+    float fx, fy, fz;
+    bool z_interior; // the guidance gradient is masked at cell boundaries, as in slice_backward_cuda
+};
+
+__device__ __forceinline__ BilateralCell bilateral_cell(
+    const PhotometricInputs& in, const float rgb[3],
+    int y, int x, int H, int W) {
+    const float gx = (float)x / (float)(W - 1);
+    const float gy = (float)y / (float)(H - 1);
+    const float gz = cRGB2Gray[0] * rgb[0] + cRGB2Gray[1] * rgb[1] + cRGB2Gray[2] * rgb[2];
+    const float fx_grid = gx * (in.grid_W - 1);
+    const float fy_grid = gy * (in.grid_H - 1);
+    const float fz_grid = gz * (in.grid_L - 1);
+
+    BilateralCell cell;
+    cell.x0 = floorf(fx_grid);
+    cell.y0 = floorf(fy_grid);
+    cell.z0 = floorf(fz_grid);
+    cell.x1 = min(cell.x0 + 1, in.grid_W - 1);
+    cell.y1 = min(cell.y0 + 1, in.grid_H - 1);
+    cell.z1 = min(max(cell.z0 + 1, 0), in.grid_L - 1);
+    cell.z0 = max(cell.z0, 0);
+    cell.fx = fx_grid - cell.x0;
+    cell.fy = fy_grid - cell.y0;
+    cell.fz = fz_grid - cell.z0;
+    cell.z_interior = cell.z0 != fz_grid && cell.z1 != fz_grid;
+    return cell;
+}
+
+// Calls f(grid offset, weight, d weight / d z) for the 8 corners of the cell within coefficient ci
+template <typename F>
+__device__ __forceinline__ void for_each_corner(
+    const PhotometricInputs& in, const BilateralCell& cell, int ci, F&& f) {
+    const int base = ci * in.grid_L * in.grid_H * in.grid_W;
+#pragma unroll
+    for (int corner = 0; corner < 8; ++corner) {
+        const bool cx = corner & 1, cy = corner & 2, cz = corner & 4;
+        const float wx = cx ? cell.fx : 1.f - cell.fx;
+        const float wy = cy ? cell.fy : 1.f - cell.fy;
+        const float wz = cz ? cell.fz : 1.f - cell.fz;
+        const int offset = base + ((cz ? cell.z1 : cell.z0) * in.grid_H + (cy ? cell.y1 : cell.y0)) * in.grid_W +
+                           (cx ? cell.x1 : cell.x0);
+        f(offset, wx * wy * wz, (cz ? 1.f : -1.f) * wx * wy);
+    }
+}
+
+__device__ __forceinline__ float composited_value(
+    const PhotometricInputs& in,
+    int b, int c, int pix,
+    int CH, int H, int W) {
+    float v = in.image[b * CH * H * W + c * H * W + pix];
+    if (in.alpha) {
+        v += (1.f - in.alpha[b * H * W + pix]) * in.background[c];
+    }
+    return v;
+}
+
+// Output channel c of the affine colour transform the grid holds at the pixel
+__device__ __forceinline__ float bilateral_slice(
+    const PhotometricInputs& in, const float rgb[3],
+    int c, int y, int x, int H, int W) {
+    const BilateralCell cell = bilateral_cell(in, rgb, y, x, H, W);
+    float out = 0.f;
+#pragma unroll
+    for (int si = 0; si < 4; ++si) {
+        float coefficient = 0.f;
+        for_each_corner(in, cell, c * 4 + si, [&](int offset, float weight, float) {
+            coefficient += in.bilateral_grid[offset] * weight;
+        });
+        out += coefficient * (si < 3 ? rgb[si] : 1.f);
+    }
+    return out;
+}
+
+__device__ __forceinline__ float to_unit(const float v) { return v; }
+__device__ __forceinline__ float to_unit(const uint8_t v) { return v * (1.f / 255.f); }
+
+__device__ __forceinline__ float rendered_pix_value(
+    const PhotometricInputs& in,
+    int b, int c, int y, int x,
+    int CH, int H, int W) {
+    if (x < 0 || x >= W || y < 0 || y >= H) {
+        return 0.0f;
+    }
+    const int pix = y * W + x;
+    float v;
+    if (in.bilateral_grid) {
+        float rgb[3];
+#pragma unroll
+        for (int k = 0; k < 3; ++k) {
+            rgb[k] = fminf(fmaxf(composited_value(in, b, k, pix, CH, H, W), 0.f), 1.f);
+        }
+        v = bilateral_slice(in, rgb, c, y, x, H, W);
+    } else {
+        v = composited_value(in, b, c, pix, CH, H, W);
+    }
+    return in.mask ? v * in.mask[pix] : v;
+}
+
+template <typename gt_t>
+__device__ __forceinline__ float gt_pix_value(
+    const gt_t* gt, const float* mask,
+    int b, int c, int y, int x,
+    int CH, int H, int W) {
+    if (x < 0 || x >= W || y < 0 || y >= H) {
+        return 0.0f;
+    }
+    const int pix = y * W + x;
+    const float v = to_unit(gt[b * CH * H * W + c * H * W + pix]);
+    return mask ? v * mask[pix] : v;
+}
+
+// Pixels the 'valid' SSIM mean covers, the whole image when it is too small to crop
+__device__ __forceinline__ bool in_ssim_region(int y, int x, int H, int W) {
+    if (x < 0 || x >= W || y < 0 || y >= H) {
+        return false;
+    }
+    if (H <= 2 * HALO || W <= 2 * HALO) {
+        return true;
+    }
+    return y >= HALO && y < H - HALO && x >= HALO && x < W - HALO;
+}
+
+template <typename gt_t>
+__global__ void fused_l1_ssimCUDA(
+    int H,
+    int W,
+    int CH,
+    float C1,
+    float C2,
+    const PhotometricInputs in,
+    const gt_t* __restrict__ gt,
+    float* __restrict__ loss_sums,
+    float* __restrict__ dm_dmu1,
+    float* __restrict__ dm_dsigma1_sq,
+    float* __restrict__ dm_dsigma12) {
+    auto block = cg::this_thread_block();
+    const int bIdx = block.group_index().z;
+    const int pix_y = block.group_index().y * BLOCK_Y + block.thread_index().y;
+    const int pix_x = block.group_index().x * BLOCK_X + block.thread_index().x;
+    const int pix_id = pix_y * W + pix_x;
+    const int num_pix = H * W;
+    const bool in_ssim = in_ssim_region(pix_y, pix_x, H, W);
+
+    __shared__ float sTile[SHARED_Y][SHARED_X][2];
+    __shared__ float xconv[CONV_Y][CONV_X][5];
+    __shared__ float sReduce[BLOCK_X * BLOCK_Y / 32][2];
+
+    float l1_sum = 0.f;
+    float ssim_sum = 0.f;
+
+    for (int c = 0; c < CH; ++c) {
+        // 1) Composite + load the tile with halo
+        {
+            const int tileSize = SHARED_Y * SHARED_X;
+            const int threads = BLOCK_X * BLOCK_Y;
+            const int steps = (tileSize + threads - 1) / threads;
+
+            const int tileStartY = block.group_index().y * BLOCK_Y;
+            const int tileStartX = block.group_index().x * BLOCK_X;
+
+            for (int s = 0; s < steps; ++s) {
+                int tid = s * threads + block.thread_rank();
+                if (tid < tileSize) {
+                    int local_y = tid / SHARED_X;
+                    int local_x = tid % SHARED_X;
+                    int gy = tileStartY + local_y - HALO;
+                    int gx = tileStartX + local_x - HALO;
+
+                    sTile[local_y][local_x][0] = rendered_pix_value(in, bIdx, c, gy, gx, CH, H, W);
+                    sTile[local_y][local_x][1] = gt_pix_value(gt, in.mask, bIdx, c, gy, gx, CH, H, W);
+                }
+            }
+        }
+        block.sync();
+
+        // 2) Horizontal convolution, two rows per thread
+        {
+            int lx = threadIdx.x + HALO;
+            for (int pass = 0; pass < 2; ++pass) {
+                int yy = threadIdx.y + pass * BLOCK_Y;
+                if (yy < CONV_Y) {
+                    float sumX = 0.f, sumX2 = 0.f, sumY = 0.f, sumY2 = 0.f, sumXY = 0.f;
+#pragma unroll
+                    for (int d = -HALO; d <= HALO; ++d) {
+                        float w = cGauss[HALO + d];
+                        float X = sTile[yy][lx + d][0];
+                        float Y = sTile[yy][lx + d][1];
+                        sumX += X * w;
+                        sumX2 += X * X * w;
+                        sumY += Y * w;
+                        sumY2 += Y * Y * w;
+                        sumXY += X * Y * w;
+                    }
+                    xconv[yy][threadIdx.x][0] = sumX;
+                    xconv[yy][threadIdx.x][1] = sumX2;
+                    xconv[yy][threadIdx.x][2] = sumY;
+                    xconv[yy][threadIdx.x][3] = sumY2;
+                    xconv[yy][threadIdx.x][4] = sumXY;
+                }
+            }
+        }
+        block.sync();
+
+        // 3) Vertical convolution, SSIM and L1 at the pixel
+        {
+            int ly = threadIdx.y + HALO;
+            int lx = threadIdx.x;
+
+            float out[5] = {0.f, 0.f, 0.f, 0.f, 0.f};
+#pragma unroll
+            for (int d = -HALO; d <= HALO; ++d) {
+                float w = cGauss[HALO + d];
+#pragma unroll
+                for (int k = 0; k < 5; ++k) {
+                    out[k] += xconv[ly + d][lx][k] * w;
+                }
+            }
+
+            if (pix_x < W && pix_y < H) {
+                float mu1 = out[0];
+                float mu2 = out[2];
+                float mu1_sq = mu1 * mu1;
+                float mu2_sq = mu2 * mu2;
+
+                float sigma1_sq = out[1] - mu1_sq;
+                float sigma2_sq = out[3] - mu2_sq;
+                float sigma12 = out[4] - mu1 * mu2;
+
+                float A = mu1_sq + mu2_sq + C1;
+                float B = sigma1_sq + sigma2_sq + C2;
+                float C_ = 2.f * mu1 * mu2 + C1;
+                float D_ = 2.f * sigma12 + C2;
+
+                if (in_ssim) {
+                    ssim_sum += (C_ * D_) / (A * B);
+                }
+                l1_sum += fabsf(sTile[ly][lx + HALO][0] - sTile[ly][lx + HALO][1]);
+
+                if (dm_dmu1) {
+                    int global_idx = bIdx * CH * num_pix + c * num_pix + pix_id;
+                    dm_dmu1[global_idx] = ((mu2 * 2.f * D_) / (A * B) - (mu2 * 2.f * C_) / (A * B) - (mu1 * 2.f * C_ * D_) / (A * A * B) + (mu1 * 2.f * C_ * D_) / (A * B * B));
+                    dm_dsigma1_sq[global_idx] = (-C_ * D_) / (A * B * B);
+                    dm_dsigma12[global_idx] = (2.f * C_) / (A * B);
+                }
+            }
+        }
+        block.sync();
+    }
+
+    // 4) Block reduction of the two sums
+    auto warp = cg::tiled_partition<32>(block);
+    for (int offset = 16; offset > 0; offset /= 2) {
+        l1_sum += warp.shfl_down(l1_sum, offset);
+        ssim_sum += warp.shfl_down(ssim_sum, offset);
+    }
+    const int warp_id = block.thread_rank() / 32;
+    if (warp.thread_rank() == 0) {
+        sReduce[warp_id][0] = l1_sum;
+        sReduce[warp_id][1] = ssim_sum;
+    }
+    block.sync();
+    if (block.thread_rank() == 0) {
+        float block_l1 = 0.f, block_ssim = 0.f;
+        for (int i = 0; i < BLOCK_X * BLOCK_Y / 32; ++i) {
+            block_l1 += sReduce[i][0];
+            block_ssim += sReduce[i][1];
+        }
+        atomicAdd(&loss_sums[0], block_l1);
+        atomicAdd(&loss_sums[1], block_ssim);
+    }
+}
+
+// ------------------------------------------
+// Backward of the fused photometric loss:
+//   dL/dmap is the constant -lambda * g / n_ssim
+//   inside the 'valid' region and zero outside,
+//   so it is generated in-kernel instead of read
+//  - With a bilateral grid the per-channel
+//    gradients are chained through the slice
+//    once all channels are done
+// ------------------------------------------
+template <typename gt_t>
+__global__ void fused_l1_ssim_backwardCUDA(
+    int H,
+    int W,
+    int CH,
+    float l1_weight,   // (1 - lambda) / n_l1
+    float ssim_weight, // -lambda / n_ssim
+    const PhotometricInputs in,
+    const gt_t* __restrict__ gt,
+    const float* __restrict__ grad_loss,
+    const float* __restrict__ dm_dmu1,
+    const float* __restrict__ dm_dsigma1_sq,
+    const float* __restrict__ dm_dsigma12,
+    float* __restrict__ dL_dimage,
+    float* __restrict__ dL_dalpha,
+    float* __restrict__ dL_dgrid) {
+    auto block = cg::this_thread_block();
+
+    const int pix_y = block.group_index().y * BLOCK_Y + block.thread_index().y;
+    const int pix_x = block.group_index().x * BLOCK_X + block.thread_index().x;
+    const int pix_id = pix_y * W + pix_x;
+    const int num_pix = H * W;
+    const int bIdx = block.group_index().z;
+    const bool inside = pix_x < W && pix_y < H;
+
+    const float g = *grad_loss;
+    const float chain_ssim = ssim_weight * g;
+    const float chain_l1 = l1_weight * g;
+    const float mask = (inside && in.mask) ? in.mask[pix_id] : 1.f;
+
+    __shared__ float sData[3][SHARED_Y][SHARED_X];
+    __shared__ float sScratch[CONV_Y][CONV_X][3];
+
+    float grad_alpha = 0.f;
+    float dL_dsliced[3] = {0.f, 0.f, 0.f};
+    for (int c = 0; c < CH; ++c) {
+        float p1 = 0.f, p2 = 0.f;
+        if (inside) {
+            p1 = rendered_pix_value(in, bIdx, c, pix_y, pix_x, CH, H, W);
+            p2 = gt_pix_value(gt, in.mask, bIdx, c, pix_y, pix_x, CH, H, W);
+        }
+
+        // (1) Load the partials times the generated dL/dmap
+        {
+            const int start_y = block.group_index().y * BLOCK_Y;
+            const int start_x = block.group_index().x * BLOCK_X;
+
+            int tid = threadIdx.y * blockDim.x + threadIdx.x;
+            int warp_id = tid / 32;
+            int lane_id = tid % 32;
+            int num_warps = (BLOCK_X * BLOCK_Y + 31) / 32;
+
+            for (int row = warp_id; row < SHARED_Y; row += num_warps) {
+                int gy = start_y + row - HALO;
+                for (int col = lane_id; col < SHARED_X; col += 32) {
+                    int gx = start_x + col - HALO;
+                    const bool covered = in_ssim_region(gy, gx, H, W);
+                    const int idx = bIdx * CH * num_pix + c * num_pix + gy * W + gx;
+                    sData[0][row][col] = covered ? dm_dmu1[idx] * chain_ssim : 0.f;
+                    sData[1][row][col] = covered ? dm_dsigma1_sq[idx] * chain_ssim : 0.f;
+                    sData[2][row][col] = covered ? dm_dsigma12[idx] * chain_ssim : 0.f;
+                }
+            }
+        }
+        block.sync();
+
+        // (2) Horizontal pass
+        {
+            int lx = threadIdx.x + HALO;
+            for (int pass = 0; pass < 2; ++pass) {
+                int yy = threadIdx.y + pass * BLOCK_Y;
+                if (yy < CONV_Y) {
+                    float accum0 = 0.f, accum1 = 0.f, accum2 = 0.f;
+#pragma unroll
+                    for (int d = -HALO; d <= HALO; ++d) {
+                        float w = cGauss[HALO + d];
+                        accum0 += sData[0][yy][lx + d] * w;
+                        accum1 += sData[1][yy][lx + d] * w;
+                        accum2 += sData[2][yy][lx + d] * w;
+                    }
+                    sScratch[yy][threadIdx.x][0] = accum0;
+                    sScratch[yy][threadIdx.x][1] = accum1;
+                    sScratch[yy][threadIdx.x][2] = accum2;
+                }
+            }
+        }
+        block.sync();
+
+        // (3) Vertical pass, add the L1 term and chain through mask and compositing
+        if (inside) {
+            int ly = threadIdx.y + HALO;
+            int lx = threadIdx.x;
+
+            float sum0 = 0.f, sum1 = 0.f, sum2 = 0.f;
+#pragma unroll
+            for (int d = -HALO; d <= HALO; ++d) {
+                float w = cGauss[HALO + d];
+                sum0 += sScratch[ly + d][lx][0] * w;
+                sum1 += sScratch[ly + d][lx][1] * w;
+                sum2 += sScratch[ly + d][lx][2] * w;
+            }
+
+            const float diff = p1 - p2;
+            const float sign = diff > 0.f ? 1.f : (diff < 0.f ? -1.f : 0.f);
+            const float dL_dx = sum0 + (2.f * p1) * sum1 + p2 * sum2 + chain_l1 * sign;
+
+            const float dL_dpix = dL_dx * mask;
+            if (in.bilateral_grid) {
+                dL_dsliced[c] = dL_dpix;
+            } else {
+                dL_dimage[bIdx * CH * num_pix + c * num_pix + pix_id] = dL_dpix;
+                if (in.alpha) {
+                    grad_alpha -= dL_dpix * in.background[c];
+                }
+            }
+        }
+        block.sync();
+    }
+
+    // (4) Chain through the slice: out_d = sum_s A[d][s] * rgb_s + A[d][3], A trilinear in the grid
+    if (inside && in.bilateral_grid) {
+        float raw[3], rgb[3];
+#pragma unroll
+        for (int k = 0; k < 3; ++k) {
+            raw[k] = composited_value(in, bIdx, k, pix_id, CH, H, W);
+            rgb[k] = fminf(fmaxf(raw[k], 0.f), 1.f);
+        }
+        const BilateralCell cell = bilateral_cell(in, rgb, pix_y, pix_x, H, W);
+
+        float dL_drgb[3] = {0.f, 0.f, 0.f};
+        float dL_dgray = 0.f;
+#pragma unroll
+        for (int di = 0; di < 3; ++di) {
+            const float gout = dL_dsliced[di];
+#pragma unroll
+            for (int si = 0; si < 4; ++si) {
+                const float source = si < 3 ? rgb[si] : 1.f;
+                float coefficient = 0.f, dcoefficient_dz = 0.f;
+                for_each_corner(in, cell, di * 4 + si, [&](int offset, float weight, float dweight_dz) {
+                    atomicAdd(dL_dgrid + offset, weight * source * gout);
+                    const float v = in.bilateral_grid[offset];
+                    coefficient += v * weight;
+                    dcoefficient_dz += v * dweight_dz;
+                });
+                if (si < 3) {
+                    dL_drgb[si] += coefficient * gout;
+                }
+                dL_dgray += dcoefficient_dz * (in.grid_L - 1) * source * gout;
+            }
+        }
+        if (!cell.z_interior) {
+            dL_dgray = 0.f;
+        }
+
+#pragma unroll
+        for (int k = 0; k < 3; ++k) {
+            // clamp passes the gradient on [0, 1] inclusive, like torch::clamp
+            const bool passes = raw[k] >= 0.f && raw[k] <= 1.f;
+            const float dL_dpix = passes ? dL_drgb[k] + cRGB2Gray[k] * dL_dgray : 0.f;
+            dL_dimage[bIdx * CH * num_pix + k * num_pix + pix_id] = dL_dpix;
+            if (in.alpha) {
+                grad_alpha -= dL_dpix * in.background[k];
+            }
+        }
+    }
+
+    if (inside && dL_dalpha) {
+        dL_dalpha[bIdx * num_pix + pix_id] = grad_alpha;
+    }
+}
+
+namespace {
+    PhotometricInputs photometric_inputs(const torch::Tensor& image,
+                                         const torch::Tensor& alpha,
+                                         const torch::Tensor& background,
+                                         const torch::Tensor& mask,
+                                         const torch::Tensor& bilateral_grid) {
+        const bool composite = alpha.defined() && alpha.numel() > 0;
+        const bool slice = bilateral_grid.defined() && bilateral_grid.numel() > 0;
+        if (slice) {
+            TORCH_CHECK(image.size(0) == 1 && image.size(1) == 3, "the bilateral grid needs a single RGB image");
+            TORCH_CHECK(bilateral_grid.dim() == 4 && bilateral_grid.size(0) == 12 && bilateral_grid.is_contiguous(),
+                        "bilateral grid must be a contiguous [12, L, H, W] tensor");
+        }
+        return PhotometricInputs{
+            image.data_ptr<float>(),
+            composite ? alpha.data_ptr<float>() : nullptr,
+            composite ? background.data_ptr<float>() : nullptr,
+            (mask.defined() && mask.numel() > 0) ? mask.data_ptr<float>() : nullptr,
+            slice ? bilateral_grid.data_ptr<float>() : nullptr,
+            slice ? static_cast<int>(bilateral_grid.size(1)) : 0,
+            slice ? static_cast<int>(bilateral_grid.size(2)) : 0,
+            slice ? static_cast<int>(bilateral_grid.size(3)) : 0};
+    }
+
+    template <typename F>
+    void dispatch_gt(const torch::Tensor& gt, F&& f) {
+        if (gt.scalar_type() == torch::kUInt8) {
+            f(gt.data_ptr<uint8_t>());
+        } else {
+            TORCH_CHECK(gt.scalar_type() == torch::kFloat32, "ground truth must be float32 or uint8");
+            f(gt.data_ptr<float>());
+        }
+    }
+} // namespace
+
+// ------------------------------------------
+// PyTorch Interface (Forward)
+//   Returns (loss_sums [2]: L1 sum and 'valid'
+//   SSIM sum, dm_dmu1, dm_dsigma1_sq,
+//   dm_dsigma12). Tensors must be contiguous.
+// ------------------------------------------
+std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>
+fused_l1_ssim(
+    float C1,
+    float C2,
+    const torch::Tensor& image,
+    const torch::Tensor& alpha,
+    const torch::Tensor& background,
+    const torch::Tensor& mask,
+    const torch::Tensor& bilateral_grid,
+    const torch::Tensor& gt,
+    bool train) {
+    const at::cuda::OptionalCUDAGuard device_guard(device_of(image));
+    int B = image.size(0);
+    int CH = image.size(1);
+    int H = image.size(2);
+    int W = image.size(3);
+
+    dim3 grid((W + BLOCK_X - 1) / BLOCK_X,
+              (H + BLOCK_Y - 1) / BLOCK_Y,
+              B);
+    dim3 block(BLOCK_X, BLOCK_Y);
+
+    auto loss_sums = torch::zeros({2}, image.options());
+    auto dm_dmu1 = train ? torch::empty_like(image) : torch::empty({0}, image.options());
+    auto dm_dsigma1_sq = train ? torch::empty_like(image) : torch::empty({0}, image.options());
+    auto dm_dsigma12 = train ? torch::empty_like(image) : torch::empty({0}, image.options());
+
+    const auto stream = at::cuda::getCurrentCUDAStream();
+    const PhotometricInputs inputs = photometric_inputs(image, alpha, background, mask, bilateral_grid);
+    dispatch_gt(gt, [&](const auto* gt_ptr) {
+        fused_l1_ssimCUDA<<<grid, block, 0, stream>>>(
+            H, W, CH, C1, C2, inputs, gt_ptr,
+            loss_sums.data_ptr<float>(),
+            train ? dm_dmu1.data_ptr<float>() : nullptr,
+            train ? dm_dsigma1_sq.data_ptr<float>() : nullptr,
+            train ? dm_dsigma12.data_ptr<float>() : nullptr);
+    });
+
+    return std::make_tuple(loss_sums, dm_dmu1, dm_dsigma1_sq, dm_dsigma12);
+}
+
+// ------------------------------------------
+// PyTorch Interface (Backward)
+//   grad_loss is the one-element upstream
+//   gradient, read on the device. Returns
+//   (dL/dimage, dL/dalpha, dL/dgrid), the
+//   latter two empty without compositing or
+//   bilateral grid.
+// ------------------------------------------
+std::tuple<torch::Tensor, torch::Tensor, torch::Tensor>
+fused_l1_ssim_backward(
+    float l1_weight,
+    float ssim_weight,
+    const torch::Tensor& image,
+    const torch::Tensor& alpha,
+    const torch::Tensor& background,
+    const torch::Tensor& mask,
+    const torch::Tensor& bilateral_grid,
+    const torch::Tensor& gt,
+    const torch::Tensor& grad_loss,
+    const torch::Tensor& dm_dmu1,
+    const torch::Tensor& dm_dsigma1_sq,
+    const torch::Tensor& dm_dsigma12) {
+    const at::cuda::OptionalCUDAGuard device_guard(device_of(image));
+    int B = image.size(0);
+    int CH = image.size(1);
+    int H = image.size(2);
+    int W = image.size(3);
+
+    const bool composite = alpha.defined() && alpha.numel() > 0;
+    auto dL_dimage = torch::empty_like(image);
+    auto dL_dalpha = composite ? torch::empty_like(alpha) : torch::Tensor();
+    // Accumulated with atomics, the grid is tiny next to the image
+    auto dL_dgrid = (bilateral_grid.defined() && bilateral_grid.numel() > 0) ? torch::zeros_like(bilateral_grid)
+                                                                             : torch::Tensor();
+    const auto grad = grad_loss.to(torch::kFloat32).contiguous();
+
+    dim3 grid((W + BLOCK_X - 1) / BLOCK_X,
+              (H + BLOCK_Y - 1) / BLOCK_Y,
+              B);
+    dim3 block(BLOCK_X, BLOCK_Y);
+
+    const auto stream = at::cuda::getCurrentCUDAStream();
+    const PhotometricInputs inputs = photometric_inputs(image, alpha, background, mask, bilateral_grid);
+    dispatch_gt(gt, [&](const auto* gt_ptr) {
+        fused_l1_ssim_backwardCUDA<<<grid, block, 0, stream>>>(
+            H, W, CH, l1_weight, ssim_weight, inputs, gt_ptr,
+            grad.data_ptr<float>(),
+            dm_dmu1.data_ptr<float>(),
+            dm_dsigma1_sq.data_ptr<float>(),
+            dm_dsigma12.data_ptr<float>(),
+            dL_dimage.data_ptr<float>(),
+            composite ? dL_dalpha.data_ptr<float>() : nullptr,
+            dL_dgrid.defined() ? dL_dgrid.data_ptr<float>() : nullptr);
+    });
+
+    return std::make_tuple(dL_dimage, dL_dalpha, dL_dgrid);
+}
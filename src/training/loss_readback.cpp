@@ -0,0 +1,74 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "loss_readback.hpp"
+#include <algorithm>
+
+namespace gs::training {
+
+    LossReadbackRing::LossReadbackRing(size_t capacity)
+        : slots_(std::max<size_t>(capacity, 1)) {
+    }
+
+    void LossReadbackRing::push(int iteration, const torch::Tensor& loss) {
+        if (!host_.defined()) {
+            host_ = torch::empty({static_cast<int64_t>(slots_.size())},
+                                 torch::TensorOptions().dtype(torch::kFloat32).pinned_memory(true));
+        }
+
+        if (pending_ == slots_.size()) {
+            // Ring full: the oldest value is discarded once its copy is done so the slot can be reused
+            slots_[tail_].ready.synchronize();
+            tail_ = (tail_ + 1) % slots_.size();
+            --pending_;
+        }
+
+        Slot& slot = slots_[head_];
+        host_.narrow(0, static_cast<int64_t>(head_), 1)
+            .copy_(loss.detach().reshape({1}).to(torch::kFloat32), /*non_blocking=*/true);
+        slot.iteration = iteration;
+        slot.ready.record();
+
+        head_ = (head_ + 1) % slots_.size();
+        ++pending_;
+    }
+
+    std::optional<LossReadbackRing::Sample> LossReadbackRing::poll() {
+        std::optional<Sample> latest;
+        while (pending_ > 0 && slots_[tail_].ready.query()) {
+            latest = Sample{slots_[tail_].iteration, host_.data_ptr<float>()[tail_]};
+            tail_ = (tail_ + 1) % slots_.size();
+            --pending_;
+        }
+        return latest;
+    }
+
+    std::vector<LossReadbackRing::Sample> LossReadbackRing::poll_all() {
+        std::vector<Sample> samples;
+        while (pending_ > 0 && slots_[tail_].ready.query()) {
+            samples.push_back({slots_[tail_].iteration, host_.data_ptr<float>()[tail_]});
+            tail_ = (tail_ + 1) % slots_.size();
+            --pending_;
+        }
+        return samples;
+    }
+
+    std::optional<LossReadbackRing::Sample> LossReadbackRing::drain() {
+        std::optional<Sample> latest;
+        while (pending_ > 0) {
+            slots_[tail_].ready.synchronize();
+            latest = Sample{slots_[tail_].iteration, host_.data_ptr<float>()[tail_]};
+            tail_ = (tail_ + 1) % slots_.size();
+            --pending_;
+        }
+        return latest;
+    }
+
+    void LossReadbackRing::reset() {
+        drain();
+        head_ = 0;
+        tail_ = 0;
+    }
+
+} // namespace gs::training
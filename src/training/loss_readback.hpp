@@ -0,0 +1,55 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <ATen/cuda/CUDAEvent.h>
+#include <optional>
+#include <torch/torch.h>
+#include <vector>
+
+namespace gs::training {
+
+    // Per-iteration loss scalars copied device to host without blocking the training thread.
+    // Values land in a pinned ring and are picked up a few iterations later, once their copy
+    // has completed on the stream.
+    class LossReadbackRing {
+    public:
+        struct Sample {
+            int iteration;
+            float loss;
+        };
+
+        explicit LossReadbackRing(size_t capacity = 8);
+
+        // Queues a copy of a one-element CUDA tensor on the current stream. Only blocks when
+        // every slot is still in flight.
+        void push(int iteration, const torch::Tensor& loss);
+
+        // Newest sample whose copy has completed since the last call, never blocks
+        std::optional<Sample> poll();
+
+        // Every sample whose copy has completed since the last call, oldest first, never blocks
+        std::vector<Sample> poll_all();
+
+        // Waits for all queued copies and returns the newest sample
+        std::optional<Sample> drain();
+
+        // Waits for the queued copies and forgets them, the next push starts at the first slot
+        void reset();
+
+    private:
+        struct Slot {
+            int iteration = 0;
+            at::cuda::CUDAEvent ready;
+        };
+
+        torch::Tensor host_; // Pinned float32 [capacity]
+        std::vector<Slot> slots_;
+        size_t head_ = 0; // Next slot to write
+        size_t tail_ = 0; // Oldest pending slot
+        size_t pending_ = 0;
+    };
+
+} // namespace gs::training
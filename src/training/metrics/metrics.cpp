@@ -6,13 +6,66 @@
 #include "core/image_io.hpp"
 #include "core/splat_data.hpp"
 #include "rasterization/fast_rasterizer.hpp"
+#include "core/logger.hpp"
 #include "rasterization/rasterizer.hpp"
+#include <ATen/autocast_mode.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <deque>
 #include <iostream>
 #include <numeric>
+#include <random>
+#include <torch/version.h>
 
 namespace gs::training {
+    namespace {
+        // Validation views held on the device for one rasterize_batch call under 3DGUT
+        constexpr size_t EVAL_BATCH_VIEWS = 16;
+
+        // Scoped CUDA FP16 autocast, restores the previous thread-local state
+        class CudaHalfAutocast {
+        public:
+            CudaHalfAutocast() {
+#if TORCH_VERSION_MAJOR > 2 || (TORCH_VERSION_MAJOR == 2 && TORCH_VERSION_MINOR >= 4)
+                prev_enabled_ = at::autocast::is_autocast_enabled(at::kCUDA);
+                prev_dtype_ = at::autocast::get_autocast_dtype(at::kCUDA);
+                at::autocast::set_autocast_enabled(at::kCUDA, true);
+                at::autocast::set_autocast_dtype(at::kCUDA, at::kHalf);
+#else
+                prev_enabled_ = at::autocast::is_enabled();
+                prev_dtype_ = at::autocast::get_autocast_gpu_dtype();
+                at::autocast::set_enabled(true);
+                at::autocast::set_autocast_gpu_dtype(at::kHalf);
+#endif
+                at::autocast::increment_nesting();
+            }
+
+            ~CudaHalfAutocast() {
+                if (at::autocast::decrement_nesting() == 0) {
+                    at::autocast::clear_cache();
+                }
+#if TORCH_VERSION_MAJOR > 2 || (TORCH_VERSION_MAJOR == 2 && TORCH_VERSION_MINOR >= 4)
+                at::autocast::set_autocast_enabled(at::kCUDA, prev_enabled_);
+                at::autocast::set_autocast_dtype(at::kCUDA, prev_dtype_);
+#else
+                at::autocast::set_enabled(prev_enabled_);
+                at::autocast::set_autocast_gpu_dtype(prev_dtype_);
+#endif
+            }
+
+            CudaHalfAutocast(const CudaHalfAutocast&) = delete;
+            CudaHalfAutocast& operator=(const CudaHalfAutocast&) = delete;
+
+        private:
+            bool prev_enabled_;
+            at::ScalarType prev_dtype_;
+        };
+    } // namespace
+
     // 1D Gaussian kernel
     torch::Tensor gaussian(const int window_size, const float sigma) {
         TORCH_CHECK(window_size % 2 == 1, "Window size must be odd.");
@@ -38,6 +91,10 @@ namespace gs::training {
 
     // PSNR Implementation
     float PSNR::compute(const torch::Tensor& pred, const torch::Tensor& target) const {
+        return compute_tensor(pred, target).item<float>();
+    }
+
+    torch::Tensor PSNR::compute_tensor(const torch::Tensor& pred, const torch::Tensor& target) const {
         TORCH_CHECK(pred.sizes() == target.sizes(),
                     "Prediction and target must have the same shape");
 
@@ -55,7 +112,7 @@ namespace gs::training {
         mse_val = torch::clamp_min(mse_val, 1e-10);
 
         // PSNR = 20 * log10(data_range / sqrt(MSE))
-        return (20.f * torch::log10(data_range_ / mse_val.sqrt())).mean().item<float>();
+        return (20.f * torch::log10(data_range_ / mse_val.sqrt())).mean();
     }
 
     // SSIM Implementation
@@ -66,6 +123,10 @@ namespace gs::training {
     }
 
     float SSIM::compute(const torch::Tensor& pred, const torch::Tensor& target) {
+        return compute_tensor(pred, target).item<float>();
+    }
+
+    torch::Tensor SSIM::compute_tensor(const torch::Tensor& pred, const torch::Tensor& target) {
         TORCH_CHECK(pred.dim() == 4, "Expected 4D tensor [B, C, H, W]");
         TORCH_CHECK(pred.sizes() == target.sizes(),
                     "Prediction and target must have the same shape");
@@ -112,7 +173,7 @@ namespace gs::training {
         const auto ssim_map = ((2.f * mu1_mu2 + C1) * (2.f * sigma12 + C2)) /
                               ((mu1_sq + mu2_sq + C1) * (sigma1_sq + sigma2_sq + C2));
 
-        return ssim_map.mean().item<float>();
+        return ssim_map.mean();
     }
 
     // LPIPS Implementation
@@ -147,40 +208,84 @@ namespace gs::training {
             model_ = torch::jit::load(model_path);
             model_.eval();
             model_.to(torch::kCUDA);
+            // Channels-last conv weights match the channels-last inputs and select the tensor core kernels
+            for (auto parameter : model_.parameters()) {
+                if (parameter.dim() == 4) {
+                    parameter.set_data(parameter.contiguous(at::MemoryFormat::ChannelsLast));
+                }
+            }
             model_loaded_ = true;
             std::cout << "LPIPS model loaded from: " << model_path << std::endl;
         } catch (const c10::Error& e) {
             throw std::runtime_error(
                 "Failed to load LPIPS model from " + model_path + ": " + e.what());
         }
-    }
 
-    float LPIPS::compute(const torch::Tensor& pred, const torch::Tensor& target) {
-        TORCH_CHECK(pred.dim() == 4, "Expected 4D tensor [B, C, H, W]");
-        TORCH_CHECK(pred.sizes() == target.sizes(),
-                    "Prediction and target must have the same shape");
-        TORCH_CHECK(model_loaded_, "LPIPS model not loaded!");
+        // Freezing folds the weights into the graph once, instead of per call
+        try {
+            model_ = torch::jit::optimize_for_inference(model_);
+        } catch (const c10::Error& e) {
+            LOG_WARN("LPIPS runs unoptimized, optimize_for_inference failed: {}", e.what());
+        }
+    }
 
+    torch::Tensor LPIPS::forward(const torch::Tensor& pred, const torch::Tensor& target) {
         const torch::NoGradGuard no_grad;
+        const CudaHalfAutocast autocast;
 
         // LPIPS expects inputs in range [-1, 1], but our inputs are in [0, 1]
         // Convert from [0, 1] to [-1, 1]
-        auto pred_normalized = 2.0f * pred - 1.0f;
-        auto target_normalized = 2.0f * target - 1.0f;
-
-        // Ensure inputs are on CUDA and contiguous
-        pred_normalized = pred_normalized.to(torch::kCUDA).contiguous();
-        target_normalized = target_normalized.to(torch::kCUDA).contiguous();
+        const auto pred_normalized = (2.0f * pred.to(torch::kCUDA) - 1.0f).contiguous(at::MemoryFormat::ChannelsLast);
+        const auto target_normalized = (2.0f * target.to(torch::kCUDA) - 1.0f).contiguous(at::MemoryFormat::ChannelsLast);
 
-        // Forward pass through LPIPS model
         std::vector<torch::jit::IValue> inputs;
         inputs.push_back(pred_normalized);
         inputs.push_back(target_normalized);
 
+        // LPIPS returns a single value per batch item
         const auto output = model_.forward(inputs).toTensor();
+        return output.reshape({pred.size(0), -1}).to(torch::kFloat32).mean(1);
+    }
 
-        // LPIPS returns a single value per batch item
-        return output.mean().item<float>();
+    float LPIPS::compute(const torch::Tensor& pred, const torch::Tensor& target) {
+        TORCH_CHECK(pred.dim() == 4, "Expected 4D tensor [B, C, H, W]");
+        TORCH_CHECK(pred.sizes() == target.sizes(),
+                    "Prediction and target must have the same shape");
+        TORCH_CHECK(model_loaded_, "LPIPS model not loaded!");
+
+        return forward(pred, target).mean().item<float>();
+    }
+
+    torch::Tensor LPIPS::compute_batch(const std::vector<torch::Tensor>& preds,
+                                       const std::vector<torch::Tensor>& targets) {
+        TORCH_CHECK(preds.size() == targets.size(), "Need one target per prediction");
+        TORCH_CHECK(model_loaded_, "LPIPS model not loaded!");
+        if (preds.empty()) {
+            return torch::empty({0}, torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA));
+        }
+
+        std::vector<torch::Tensor> distances;
+        size_t first = 0;
+        while (first < preds.size()) {
+            TORCH_CHECK(preds[first].dim() == 4 && preds[first].size(0) == 1 &&
+                            preds[first].sizes() == targets[first].sizes(),
+                        "Expected matching [1, C, H, W] prediction and target");
+            const int64_t view_pixels = preds[first].size(2) * preds[first].size(3);
+            size_t last = first + 1;
+            while (last < preds.size() && last - first < BATCH_VIEWS &&
+                   static_cast<int64_t>(last - first + 1) * view_pixels <= BATCH_PIXELS &&
+                   preds[last].sizes() == preds[first].sizes() && targets[last].sizes() == preds[first].sizes()) {
+                ++last;
+            }
+            const auto offset = static_cast<std::ptrdiff_t>(first);
+            const auto count = static_cast<std::ptrdiff_t>(last - first);
+            distances.push_back(forward(
+                torch::cat(std::vector<torch::Tensor>(preds.begin() + offset, preds.begin() + offset + count)),
+                torch::cat(std::vector<torch::Tensor>(targets.begin() + offset, targets.begin() + offset + count))));
+            first = last;
+        }
+
+        return torch::cat(distances);
     }
 
     // MetricsReporter Implementation
@@ -309,6 +414,10 @@ namespace gs::training {
         _reporter = std::make_unique<MetricsReporter>(params.dataset.output_path);
     }
 
+    MetricsEvaluator::~MetricsEvaluator() {
+        wait_for_async();
+    }
+
     bool MetricsEvaluator::should_evaluate(const int iteration) const {
         if (!_params.optimization.enable_eval)
             return false;
@@ -389,18 +498,37 @@ namespace gs::training {
     EvalMetrics MetricsEvaluator::evaluate(const int iteration,
                                            const SplatData& splatData,
                                            std::shared_ptr<CameraDataset> val_dataset,
-                                           torch::Tensor& background) {
+                                           torch::Tensor& background,
+                                           const bool full) {
         if (!_params.optimization.enable_eval) {
             throw std::runtime_error("Evaluation is not enabled");
         }
 
+        // Fast evaluations compare the same random subset of the views every time, downscaled
+        const int downscale = full ? 1 : std::max(_params.optimization.eval_downscale, 1);
+        const size_t val_dataset_size = val_dataset->size().value();
+        const bool subset = !full && _params.optimization.eval_views > 0 &&
+                            static_cast<size_t>(_params.optimization.eval_views) < val_dataset_size;
+        if (subset && _fast_views.empty()) {
+            _fast_views.resize(val_dataset_size);
+            std::iota(_fast_views.begin(), _fast_views.end(), size_t{0});
+            std::mt19937 rng(_params.optimization.seed >= 0 ? static_cast<uint32_t>(_params.optimization.seed) : 0u);
+            std::shuffle(_fast_views.begin(), _fast_views.end(), rng);
+            _fast_views.resize(static_cast<size_t>(_params.optimization.eval_views));
+            std::sort(_fast_views.begin(), _fast_views.end());
+        }
+
         EvalMetrics result;
         result.num_gaussians = static_cast<int>(splatData.size());
         result.iteration = iteration;
-
-        const auto val_dataloader = make_dataloader(val_dataset);
-
-        std::vector<float> psnr_values, ssim_values, lpips_values;
+        result.downscale = downscale;
+
+        // Per-view sums stay on the device and are read back once at the end
+        const auto sum_options = torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA);
+        auto psnr_sum = torch::zeros({}, sum_options);
+        auto ssim_sum = torch::zeros({}, sum_options);
+        auto lpips_sum = torch::zeros({}, sum_options);
+        int64_t n_rgb_views = 0;
         const auto start_time = std::chrono::steady_clock::now();
 
         // Create directory for evaluation images
@@ -418,17 +546,18 @@ namespace gs::training {
         }
 
         int image_idx = 0;
-        const size_t val_dataset_size = val_dataset->size().value();
-
-        for (auto& batch : *val_dataloader) {
-            auto camera_with_image = batch[0].data;
-            Camera* cam = camera_with_image.camera; // rasterize needs non-const Camera&
-            torch::Tensor gt_image = std::move(camera_with_image.image).to(torch::kCUDA);
 
-            // TODO: const_cast is certainly not the correct solution here!
-            auto& splatData_mutable = const_cast<SplatData&>(splatData);
-            RenderOutput r_output = fast_rasterize(*cam, splatData_mutable, background);
+        std::vector<torch::Tensor> lpips_preds, lpips_targets;
+        const auto flush_lpips = [&] {
+            if (lpips_preds.empty()) {
+                return;
+            }
+            lpips_sum += _lpips_metric->compute_batch(lpips_preds, lpips_targets).sum();
+            lpips_preds.clear();
+            lpips_targets.clear();
+        };
 
+        const auto report_view = [&](torch::Tensor gt_image, RenderOutput r_output) {
             // Only compute metrics if we have RGB output
             if (has_rgb()) {
                 // Ensure correct dimensions
@@ -440,14 +569,15 @@ namespace gs::training {
                 // Clamp rendered image to [0, 1]
                 r_output.image = torch::clamp(r_output.image, 0.0, 1.0);
 
-                // Compute metrics
-                const float psnr = _psnr_metric->compute(r_output.image, gt_image);
-                const float ssim = _ssim_metric->compute(r_output.image, gt_image);
-                const float lpips = _lpips_metric->compute(r_output.image, gt_image);
-
-                psnr_values.push_back(psnr);
-                ssim_values.push_back(ssim);
-                lpips_values.push_back(lpips);
+                // Compute metrics, LPIPS is batched over several views
+                psnr_sum += _psnr_metric->compute_tensor(r_output.image, gt_image);
+                ssim_sum += _ssim_metric->compute_tensor(r_output.image, gt_image);
+                ++n_rgb_views;
+                lpips_preds.push_back(r_output.image);
+                lpips_targets.push_back(gt_image);
+                if (lpips_preds.size() == LPIPS::BATCH_VIEWS) {
+                    flush_lpips();
+                }
 
                 // Save side-by-side RGB images asynchronously
                 if (_params.optimization.enable_save_eval_images) {
@@ -495,7 +625,63 @@ namespace gs::training {
             }
 
             image_idx++;
+        };
+
+        // 3DGUT renders the views in [C, N] batches, fastgs has no camera batching
+        const bool batched = _params.optimization.gut && !has_depth();
+        std::vector<Camera*> pending_cameras;
+        std::vector<torch::Tensor> pending_images;
+        std::deque<Camera> scaled_cameras; // Downscaled copies of the pending cameras
+        const auto flush_pending = [&] {
+            auto outputs = rasterize_batch(pending_cameras, splatData, background);
+            for (size_t i = 0; i < outputs.size(); ++i) {
+                report_view(std::move(pending_images[i]), std::move(outputs[i]));
+            }
+            pending_cameras.clear();
+            pending_images.clear();
+            scaled_cameras.clear();
+        };
+
+        // rasterize needs non-const Camera&
+        const auto add_view = [&](Camera* cam, torch::Tensor gt_image) {
+            if (downscale > 1) {
+                // The intrinsics follow the image size, the ground truth is box filtered to match
+                Camera& scaled = scaled_cameras.emplace_back(*cam, cam->world_view_transform());
+                scaled.update_image_dimensions(cam->image_width() / downscale, cam->image_height() / downscale);
+                cam = &scaled;
+                gt_image = torch::nn::functional::avg_pool2d(
+                    gt_image, torch::nn::functional::AvgPool2dFuncOptions(downscale).stride(downscale));
+            }
+            if (batched) {
+                pending_cameras.push_back(cam);
+                pending_images.push_back(std::move(gt_image));
+                if (pending_cameras.size() == EVAL_BATCH_VIEWS) {
+                    flush_pending();
+                }
+            } else {
+                report_view(std::move(gt_image), fast_render(*cam, splatData, background));
+                scaled_cameras.clear();
+            }
+        };
+
+        if (subset) {
+            for (const size_t index : _fast_views) {
+                auto example = val_dataset->get(index);
+                example.data.apply_image_size();
+                add_view(example.data.camera, std::move(example.data.image).to(torch::kCUDA));
+            }
+        } else {
+            const auto val_dataloader = make_dataloader(val_dataset);
+            for (auto& batch : *val_dataloader) {
+                auto camera_with_image = batch[0].data;
+                camera_with_image.apply_image_size();
+                add_view(camera_with_image.camera, std::move(camera_with_image.image).to(torch::kCUDA));
+            }
+        }
+        if (!pending_cameras.empty()) {
+            flush_pending();
         }
+        flush_lpips();
 
         // Wait for all images to be saved before computing final timing
         if (_params.optimization.enable_save_eval_images) {
@@ -505,21 +691,23 @@ namespace gs::training {
             }
         }
 
-        const auto end_time = std::chrono::steady_clock::now();
-        const auto elapsed = std::chrono::duration<float>(end_time - start_time).count();
-
-        // Compute averages only if we have RGB metrics
-        if (has_rgb() && !psnr_values.empty()) {
-            result.psnr = std::accumulate(psnr_values.begin(), psnr_values.end(), 0.0f) / psnr_values.size();
-            result.ssim = std::accumulate(ssim_values.begin(), ssim_values.end(), 0.0f) / ssim_values.size();
-            result.lpips = std::accumulate(lpips_values.begin(), lpips_values.end(), 0.0f) / lpips_values.size();
+        // Compute averages only if we have RGB metrics, the only host sync of the metrics
+        if (has_rgb() && n_rgb_views > 0) {
+            const auto means = (torch::stack({psnr_sum, ssim_sum, lpips_sum}) / static_cast<float>(n_rgb_views)).cpu();
+            const float* mean_values = means.data_ptr<float>();
+            result.psnr = mean_values[0];
+            result.ssim = mean_values[1];
+            result.lpips = mean_values[2];
         } else {
             // Set default values for depth-only modes
             result.psnr = 0.0f;
             result.ssim = 0.0f;
             result.lpips = 0.0f;
         }
-        result.elapsed_time = elapsed / val_dataset_size;
+        const auto end_time = std::chrono::steady_clock::now();
+        const auto elapsed = std::chrono::duration<float>(end_time - start_time).count();
+        result.num_views = image_idx;
+        result.elapsed_time = elapsed / std::max(image_idx, 1);
 
         // Add metrics to reporter
         _reporter->add_metrics(result);
@@ -533,4 +721,50 @@ namespace gs::training {
 
         return result;
     }
+
+    void MetricsEvaluator::evaluate_async(const int iteration,
+                                          const SplatData& splatData,
+                                          std::shared_ptr<CameraDataset> val_dataset,
+                                          const torch::Tensor& background,
+                                          const bool full) {
+        if (!_params.optimization.enable_eval) {
+            throw std::runtime_error("Evaluation is not enabled");
+        }
+        // The metric modules and the reporter are not shared between evaluations
+        wait_for_async();
+
+        // Device-side copies queued on the training stream, the worker waits for them on its own stream
+        auto snapshot = std::make_shared<SplatData>(splatData.clone());
+        auto background_copy = background.detach().clone();
+        auto snapshot_ready = std::make_shared<at::cuda::CUDAEvent>();
+        snapshot_ready->record(at::cuda::getCurrentCUDAStream());
+
+        const int device = at::cuda::current_device();
+        _async_eval = std::async(std::launch::async, [this, iteration, full, snapshot, background_copy,
+                                                      snapshot_ready, device, val_dataset = std::move(val_dataset)]() mutable {
+            try {
+                c10::cuda::CUDAGuard device_guard(device);
+                // Pool streams have the default (lowest) priority, so eval never preempts training work
+                const at::cuda::CUDAStream stream = at::cuda::getStreamFromPool(false);
+                c10::cuda::CUDAStreamGuard stream_guard(stream);
+                torch::NoGradGuard no_grad;
+                snapshot_ready->block(stream);
+
+                const auto metrics = evaluate(iteration, *snapshot, val_dataset, background_copy, full);
+                // The snapshot was allocated on the training stream, drain before it is freed there
+                stream.synchronize();
+
+                print_evaluation_header(iteration);
+                LOG_INFO("{}", metrics.to_string());
+            } catch (const std::exception& e) {
+                LOG_ERROR("Asynchronous evaluation at step {} failed: {}", iteration, e.what());
+            }
+        });
+    }
+
+    void MetricsEvaluator::wait_for_async() {
+        if (_async_eval.valid()) {
+            _async_eval.get();
+        }
+    }
 } // namespace gs::training
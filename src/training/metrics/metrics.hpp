@@ -9,6 +9,7 @@
 #include "core/splat_data.hpp"
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iomanip>
 #include <memory>
 #include <sstream>
@@ -32,6 +33,9 @@ namespace gs::training {
 
         float compute(const torch::Tensor& pred, const torch::Tensor& target) const;
 
+        // Batch-mean PSNR as a 0-dim tensor on pred's device, no host sync
+        torch::Tensor compute_tensor(const torch::Tensor& pred, const torch::Tensor& target) const;
+
     private:
         const float data_range_;
     };
@@ -43,6 +47,9 @@ namespace gs::training {
 
         float compute(const torch::Tensor& pred, const torch::Tensor& target);
 
+        // Mean SSIM as a 0-dim tensor on pred's device, no host sync
+        torch::Tensor compute_tensor(const torch::Tensor& pred, const torch::Tensor& target);
+
     private:
         const int window_size_;
         const int channel_;
@@ -51,12 +58,22 @@ namespace gs::training {
         static constexpr float C2 = 0.03f * 0.03f;
     };
 
+    // VGG LPIPS, run under FP16 autocast on channels-last inputs with a frozen inference module
     class LPIPS {
     public:
+        // compute_batch stacks at most this many views, and no more pixels than one 4K frame
+        static constexpr size_t BATCH_VIEWS = 8;
+        static constexpr int64_t BATCH_PIXELS = 3840 * 2160;
+
         explicit LPIPS(const std::string& model_path = "");
 
         float compute(const torch::Tensor& pred, const torch::Tensor& target);
 
+        // [N] float32 device tensor, one value per view for [1, C, H, W] pairs; consecutive views
+        // of equal size share a forward. No host sync.
+        torch::Tensor compute_batch(const std::vector<torch::Tensor>& preds,
+                                    const std::vector<torch::Tensor>& targets);
+
         bool is_loaded() const { return model_loaded_; }
 
     private:
@@ -64,6 +81,9 @@ namespace gs::training {
         bool model_loaded_ = false;
 
         void load_model(const std::string& model_path);
+
+        // [B] float32 distances, stays on the device
+        torch::Tensor forward(const torch::Tensor& pred, const torch::Tensor& target);
     };
 
     // Evaluation result structure
@@ -74,6 +94,8 @@ namespace gs::training {
         float elapsed_time;
         int num_gaussians;
         int iteration;
+        int num_views = 0;
+        int downscale = 1; // Fast evaluations compare at 1/downscale of the resolution
 
         [[nodiscard]] std::string to_string() const {
             std::stringstream ss;
@@ -82,12 +104,15 @@ namespace gs::training {
                << ", SSIM: " << ssim
                << ", LPIPS: " << lpips
                << ", Time: " << elapsed_time << "s/image"
-               << ", #GS: " << num_gaussians;
+               << ", #GS: " << num_gaussians
+               << ", Views: " << num_views;
+            if (downscale > 1)
+                ss << " at 1/" << downscale << " resolution";
             return ss.str();
         }
 
         static std::string to_csv_header() {
-            return "iteration,psnr,ssim,lpips,time_per_image,num_gaussians";
+            return "iteration,psnr,ssim,lpips,time_per_image,num_gaussians,num_views,downscale";
         }
 
         [[nodiscard]] std::string to_csv_row() const {
@@ -98,7 +123,9 @@ namespace gs::training {
                << ssim << ","
                << lpips << ","
                << elapsed_time << ","
-               << num_gaussians;
+               << num_gaussians << ","
+               << num_views << ","
+               << downscale;
             return ss.str();
         }
     };
@@ -123,6 +150,7 @@ namespace gs::training {
     class MetricsEvaluator {
     public:
         explicit MetricsEvaluator(const param::TrainingParameters& params);
+        ~MetricsEvaluator();
 
         // Check if evaluation is enabled
         bool is_enabled() const { return _params.optimization.enable_eval; }
@@ -130,14 +158,30 @@ namespace gs::training {
         // Check if we should evaluate at this iteration
         bool should_evaluate(const int iteration) const;
 
-        // Main evaluation method
+        // Main evaluation method. Unless full, only eval_views validation views (a fixed random
+        // subset) are compared, at 1/eval_downscale of their resolution.
         EvalMetrics evaluate(const int iteration,
                              const SplatData& splatData,
                              std::shared_ptr<CameraDataset> val_dataset,
-                             torch::Tensor& background);
-
-        // Save final report
-        void save_report() const {
+                             torch::Tensor& background,
+                             const bool full = true);
+
+        // Snapshots the model on the current stream and evaluates the snapshot on a worker thread
+        // with its own pooled CUDA stream and rasterizer context, so training continues meanwhile.
+        // Results are logged and appended to the CSV once ready. Only one evaluation is in flight,
+        // a new request first waits for the previous one.
+        void evaluate_async(const int iteration,
+                            const SplatData& splatData,
+                            std::shared_ptr<CameraDataset> val_dataset,
+                            const torch::Tensor& background,
+                            const bool full = true);
+
+        // Blocks until the in-flight asynchronous evaluation, if any, has been reported
+        void wait_for_async();
+
+        // Save final report, after any in-flight evaluation
+        void save_report() {
+            wait_for_async();
             if (_reporter)
                 _reporter->save_report();
         }
@@ -157,6 +201,8 @@ namespace gs::training {
         std::unique_ptr<SSIM> _ssim_metric;
         std::unique_ptr<LPIPS> _lpips_metric;
         std::unique_ptr<MetricsReporter> _reporter;
+        std::future<void> _async_eval;
+        std::vector<size_t> _fast_views; // Validation indices of the fast evaluations, drawn once
 
         // Helper functions
         torch::Tensor apply_depth_colormap(const torch::Tensor& depth_normalized) const;
@@ -0,0 +1,130 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "model_snapshot.hpp"
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAGuard.h>
+
+namespace gs::training {
+
+    ModelSnapshot::Lease::Lease(Lease&& other) noexcept
+        : owner_(std::move(other.owner_)),
+          slot_(other.slot_) {
+        other.slot_ = -1;
+    }
+
+    ModelSnapshot::Lease& ModelSnapshot::Lease::operator=(Lease&& other) noexcept {
+        if (this != &other) {
+            release();
+            owner_ = std::move(other.owner_);
+            slot_ = other.slot_;
+            other.slot_ = -1;
+        }
+        return *this;
+    }
+
+    const SplatData* ModelSnapshot::Lease::get() const {
+        return owner_ ? owner_->slots_[slot_].model.get() : nullptr;
+    }
+
+    uint64_t ModelSnapshot::Lease::version() const {
+        return owner_ ? owner_->slots_[slot_].version : 0;
+    }
+
+    int ModelSnapshot::Lease::iteration() const {
+        return owner_ ? owner_->slots_[slot_].iteration : 0;
+    }
+
+    void ModelSnapshot::Lease::release() {
+        if (!owner_) {
+            return;
+        }
+        Slot& slot = owner_->slots_[slot_];
+        slot.released.record(at::cuda::getCurrentCUDAStream());
+        --slot.readers;
+        owner_.reset();
+        slot_ = -1;
+    }
+
+    bool ModelSnapshot::publish(const SplatData& model, int iteration) {
+        torch::NoGradGuard no_grad;
+        const int back = front_.load() == 0 ? 1 : 0;
+        Slot& slot = slots_[back];
+        if (slot.readers.load() > 0) {
+            return false;
+        }
+
+        source_ready_.record(at::cuda::getCurrentCUDAStream());
+        source_ready_.block(stream_);
+        slot.released.block(stream_);
+        {
+            c10::cuda::CUDAStreamGuard guard(stream_);
+            const std::array<const torch::Tensor*, 6> sources = {
+                &model.means(), &model.sh0(), &model.shN(),
+                &model.scaling_raw(), &model.rotation_raw(), &model.opacity_raw()};
+            for (const auto* source : sources) {
+                // The producer may replace and free the tensor before the copy has run
+                if (source->numel() > 0) {
+                    c10::cuda::CUDACachingAllocator::recordStream(source->storage().data_ptr(), stream_);
+                }
+            }
+
+            bool reuse = slot.model != nullptr;
+            if (reuse) {
+                const std::array<const torch::Tensor*, 6> targets = {
+                    &slot.model->means(), &slot.model->sh0(), &slot.model->shN(),
+                    &slot.model->scaling_raw(), &slot.model->rotation_raw(), &slot.model->opacity_raw()};
+                for (size_t i = 0; i < sources.size() && reuse; ++i) {
+                    reuse = targets[i]->sizes() == sources[i]->sizes() && targets[i]->dtype() == sources[i]->dtype();
+                }
+            }
+            if (reuse) {
+                slot.model->means().copy_(model.means(), /*non_blocking=*/true);
+                slot.model->sh0().copy_(model.sh0(), /*non_blocking=*/true);
+                slot.model->shN().copy_(model.shN(), /*non_blocking=*/true);
+                slot.model->scaling_raw().copy_(model.scaling_raw(), /*non_blocking=*/true);
+                slot.model->rotation_raw().copy_(model.rotation_raw(), /*non_blocking=*/true);
+                slot.model->opacity_raw().copy_(model.opacity_raw(), /*non_blocking=*/true);
+                slot.model->set_active_sh_degree(model.get_active_sh_degree());
+            } else {
+                // Densification changed the size, the old tensors return to this stream's pool
+                slot.model = std::make_unique<SplatData>(model.clone());
+            }
+            slot.ready.record(stream_);
+        }
+
+        slot.iteration = iteration;
+        slot.version = version_.load() + 1;
+        copy_pending_ = true;
+        front_.store(back);
+        version_.store(slot.version);
+        return true;
+    }
+
+    void ModelSnapshot::fence() {
+        if (!copy_pending_) {
+            return;
+        }
+        slots_[front_.load()].ready.block(at::cuda::getCurrentCUDAStream());
+        copy_pending_ = false;
+    }
+
+    ModelSnapshot::Lease ModelSnapshot::acquire() {
+        for (;;) {
+            const int front = front_.load();
+            if (front < 0) {
+                return {};
+            }
+            Slot& slot = slots_[front];
+            ++slot.readers;
+            // The trainer may have flipped in between and be writing this slot as its back
+            if (front_.load() == front) {
+                slot.ready.block(at::cuda::getCurrentCUDAStream());
+                return Lease(shared_from_this(), front);
+            }
+            --slot.readers;
+        }
+    }
+
+} // namespace gs::training
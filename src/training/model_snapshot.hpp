@@ -0,0 +1,84 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/splat_data.hpp"
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace gs::training {
+
+    // Double-buffered device copy of the training model for the viewer. The trainer copies into
+    // the slot no reader holds on a side stream and then makes it the front; readers lease the
+    // front without a lock, so neither side ever waits for the other on the host. Readers are
+    // expected to queue their work on one stream (the viewer's render thread).
+    class ModelSnapshot : public std::enable_shared_from_this<ModelSnapshot> {
+    public:
+        // Keeps its slot from being overwritten until released or destroyed
+        class Lease {
+        public:
+            Lease() = default;
+            Lease(Lease&& other) noexcept;
+            Lease& operator=(Lease&& other) noexcept;
+            ~Lease() { release(); }
+
+            Lease(const Lease&) = delete;
+            Lease& operator=(const Lease&) = delete;
+
+            const SplatData* get() const;
+            uint64_t version() const;
+            int iteration() const;
+            explicit operator bool() const { return owner_ != nullptr; }
+
+            // Work queued on the current stream before this call still reads the slot
+            void release();
+
+        private:
+            friend class ModelSnapshot;
+            Lease(std::shared_ptr<ModelSnapshot> owner, int slot)
+                : owner_(std::move(owner)),
+                  slot_(slot) {}
+
+            std::shared_ptr<ModelSnapshot> owner_;
+            int slot_ = -1;
+        };
+
+        // Queues a copy of model into the back slot, ordered after the work on the current stream,
+        // and makes it the front. Skipped (false) while a reader still holds the back slot.
+        bool publish(const SplatData& model, int iteration);
+
+        // Orders the current stream after the last publish's copy. Call before the model is next
+        // updated in place, the copy reads it concurrently with the work queued in between.
+        void fence();
+
+        // The newest snapshot, empty before the first publish. Work the caller queues on its
+        // current stream afterwards sees the completed copy.
+        Lease acquire();
+
+        uint64_t version() const { return version_.load(); }
+
+    private:
+        struct Slot {
+            std::unique_ptr<SplatData> model;
+            uint64_t version = 0;
+            int iteration = 0;
+            at::cuda::CUDAEvent ready;    // The copy into the slot
+            at::cuda::CUDAEvent released; // The last reader's work on the slot
+            std::atomic<int> readers{0};
+        };
+
+        std::array<Slot, 2> slots_;
+        std::atomic<int> front_{-1};
+        std::atomic<uint64_t> version_{0};
+        at::cuda::CUDAStream stream_ = at::cuda::getStreamFromPool(false);
+        at::cuda::CUDAEvent source_ready_; // The producer's work up to the publish
+        bool copy_pending_ = false;        // A copy the next fence() has to wait for
+    };
+
+} // namespace gs::training
@@ -4,14 +4,9 @@
 
 #include "fused_adam.hpp"
 #include "adam_api.h"
-
-// TODO: This is just a gimmick for the bounty. I don't think it should be integrated into the main codebase.
-// TODO: Removing the SH step skipping also means that the custom zero_grad() method is no longer needed.
-// TODO: All skipping conditions assume that iteration count starts at 1 (which is it currently does).
-// Between iteration 1000 and 25000, we can skip every second step for higher degree SH coefficients.
-// This does push the bounty benchmark below 20 minutes, but I don't really like the practical implications.
-// It also causes a *very* small drop in quality metrics and robustness. Thus, I disable it by default.
-#define SKIP_SH_STEPS false
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 
 namespace gs::training {
     torch::Tensor FusedAdam::step(LossClosure closure) {
@@ -22,26 +17,23 @@ namespace gs::training {
     void FusedAdam::step(int iteration) {
         torch::NoGradGuard no_grad;
 
-        // Get global options
-        const auto& global_options = options();
+        // all updated tensors go into one multi-tensor launch per storage dtype
+        std::vector<torch::Tensor> params;
+        std::vector<torch::Tensor> exp_avgs;
+        std::vector<torch::Tensor> exp_avg_sqs;
+        std::vector<torch::Tensor> grads;
+        std::vector<fast_gs::optimizer::AdamHyperparameters> hyperparameters;
+        std::vector<bool> dense; // per param, the group ignores the visibility mask
 
-        int i = 0; // HACK: counter to track what Gaussian parameter we are on
+        int i = 0; // group index, seeds the stochastic rounding of reduced-precision params
         for (auto& group : param_groups()) {
             ++i;
 
-            // For each group, check if it has specific options
-            double lr = global_options.lr();
-            double eps = global_options.eps();
-            auto [beta1, beta2] = global_options.betas();
-
             // If the group has its own options, use those
-            if (group.has_options()) {
-                if (auto* group_opts = dynamic_cast<const Options*>(&group.options())) {
-                    lr = group_opts->lr();
-                    eps = group_opts->eps();
-                    std::tie(beta1, beta2) = group_opts->betas();
-                }
-            }
+            const Options& group_options = group_options_of(group);
+            const double lr = group_options.lr();
+            const double eps = group_options.eps();
+            const auto [beta1, beta2] = group_options.betas();
 
             for (auto& param : group.params()) {
                 if (!param.grad().defined()) {
@@ -53,8 +45,10 @@ namespace gs::training {
                 if (state_ptr == state_.end()) {
                     auto new_state = std::make_unique<AdamParamState>();
                     new_state->step_count = 0;
-                    new_state->exp_avg = torch::zeros_like(param, torch::MemoryFormat::Preserve);
-                    new_state->exp_avg_sq = torch::zeros_like(param, torch::MemoryFormat::Preserve);
+                    // Reduced-precision params keep reduced-precision moments too
+                    const auto moment_options = param.options().dtype(fast_gs::optimizer::moment_dtype(param.scalar_type()));
+                    new_state->exp_avg = torch::zeros_like(param, moment_options, torch::MemoryFormat::Preserve);
+                    new_state->exp_avg_sq = torch::zeros_like(param, moment_options, torch::MemoryFormat::Preserve);
 
                     state_[param.unsafeGetTensorImpl()] = std::move(new_state);
                     state_ptr = state_.find(param.unsafeGetTensorImpl());
@@ -65,55 +59,114 @@ namespace gs::training {
                 // Increment step
                 state.step_count++;
 
-                // Higher degree SH coefficients are not used in the first 1000 iterations so this is a free speed up
-                if (i == 3 && iteration <= 1000)
+                if (group_options.skips(iteration))
                     continue;
 
-                if constexpr (SKIP_SH_STEPS) {
-                    // Skip every second step during training except for the last 5000 iterations
-                    if (i == 3 && (iteration % 2 != 0 && iteration <= 25000))
-                        continue;
+                // bias corrections are derived from step on the device
+                params.push_back(param);
+                exp_avgs.push_back(state.exp_avg);
+                exp_avg_sqs.push_back(state.exp_avg_sq);
+                grads.push_back(param.grad());
+                dense.push_back(group_options.dense());
+                hyperparameters.push_back({.lr = static_cast<float>(lr),
+                                           .beta1 = static_cast<float>(beta1),
+                                           .beta2 = static_cast<float>(beta2),
+                                           .eps = static_cast<float>(eps),
+                                           .log_beta1 = static_cast<float>(std::log(beta1)),
+                                           .log_beta2 = static_cast<float>(std::log(beta2)),
+                                           .step = static_cast<unsigned int>(state.step_count),
+                                           .seed = static_cast<unsigned int>(state.step_count * 8 + i)});
+            }
+        }
+
+        const torch::Tensor visibility = std::move(visibility_);
+        visibility_ = torch::Tensor();
+        stepped_visibility_ = visibility;
+        if (params.empty()) {
+            return;
+        }
+
+        // With a mask, dense groups go last and step in a launch of their own without it
+        size_t n_masked = params.size();
+        if (visibility.defined() && std::find(dense.begin(), dense.end(), true) != dense.end()) {
+            std::vector<size_t> order(params.size());
+            std::iota(order.begin(), order.end(), size_t{0});
+            std::stable_partition(order.begin(), order.end(), [&](size_t p) { return !dense[p]; });
+            const auto permute = [&](auto& values) {
+                auto permuted = values;
+                for (size_t p = 0; p < order.size(); ++p) {
+                    permuted[p] = values[order[p]];
                 }
+                values = std::move(permuted);
+            };
+            permute(params);
+            permute(exp_avgs);
+            permute(exp_avg_sqs);
+            permute(grads);
+            permute(hyperparameters);
+            n_masked = static_cast<size_t>(std::count(dense.begin(), dense.end(), false));
+        }
+
+        // The kernels write through raw pointers, the version counter tells caches the values moved
+        for (auto& param : params) {
+            param.unsafeGetTensorImpl()->bump_version();
+        }
 
-                auto bias_correction1_rcp = 1.0 / (1.0 - std::pow(beta1, state.step_count));
-                auto bias_correction2_sqrt_rcp = 1.0 / std::sqrt(1.0 - std::pow(beta2, state.step_count));
-
-                // Call the fused CUDA kernel from fastgs
-                fast_gs::optimizer::adam_step_wrapper(
-                    param,
-                    state.exp_avg,
-                    state.exp_avg_sq,
-                    param.grad(),
-                    static_cast<float>(lr),
-                    static_cast<float>(beta1),
-                    static_cast<float>(beta2),
-                    static_cast<float>(eps),
-                    static_cast<float>(bias_correction1_rcp),
-                    static_cast<float>(bias_correction2_sqrt_rcp));
+        if (n_masked == params.size()) {
+            fast_gs::optimizer::adam_step_multi_tensor_wrapper(params, exp_avgs, exp_avg_sqs, grads, hyperparameters, visibility);
+            return;
+        }
+        const auto launch = [&](size_t first, size_t last, const torch::Tensor& mask) {
+            if (first == last) {
+                return;
+            }
+            const auto begin = static_cast<std::ptrdiff_t>(first);
+            const auto end = static_cast<std::ptrdiff_t>(last);
+            std::vector<torch::Tensor> part_params(params.begin() + begin, params.begin() + end);
+            std::vector<torch::Tensor> part_exp_avgs(exp_avgs.begin() + begin, exp_avgs.begin() + end);
+            std::vector<torch::Tensor> part_exp_avg_sqs(exp_avg_sqs.begin() + begin, exp_avg_sqs.begin() + end);
+            const std::vector<torch::Tensor> part_grads(grads.begin() + begin, grads.begin() + end);
+            const std::vector<fast_gs::optimizer::AdamHyperparameters> part_hyperparameters(
+                hyperparameters.begin() + begin, hyperparameters.begin() + end);
+            fast_gs::optimizer::adam_step_multi_tensor_wrapper(
+                part_params, part_exp_avgs, part_exp_avg_sqs, part_grads, part_hyperparameters, mask);
+        };
+        launch(0, n_masked, visibility);
+        launch(n_masked, params.size(), torch::Tensor());
+    }
+
+    const FusedAdam::Options& FusedAdam::group_options_of(const torch::optim::OptimizerParamGroup& group) const {
+        if (group.has_options()) {
+            if (auto* group_options = dynamic_cast<const Options*>(&group.options())) {
+                return *group_options;
             }
         }
+        return options();
     }
 
     // Based on https://github.com/pytorch/pytorch/blob/ee343ce60ceb449da09d229db25fa9d425d85a4b/torch/csrc/api/src/optim/optimizer.cpp#L122
     void FusedAdam::zero_grad(bool set_to_none, int iteration) {
-        if constexpr (SKIP_SH_STEPS) {
-            int i = 0; // HACK: counter to track what Gaussian parameter we are on
-            for (auto& group : param_groups()) {
-                ++i;
-                for (auto& p : group.params()) {
-                    // We want to keep accumulating if the optimizer step was skipped
-                    if (i == 3 && (iteration % 2 != 0 && iteration <= 25000))
-                        continue;
-                    if (p.mutable_grad().defined()) {
-                        p.mutable_grad().detach_();
-                        if (set_to_none)
-                            p.mutable_grad().reset();
-                        else
-                            p.mutable_grad().zero_();
-                    }
+        const torch::Tensor visibility = std::move(stepped_visibility_);
+        stepped_visibility_ = torch::Tensor();
+        for (auto& group : param_groups()) {
+            const Options& group_options = group_options_of(group);
+            // We want to keep accumulating if the optimizer step was skipped
+            if (group_options.accumulates(iteration))
+                continue;
+            for (auto& p : group.params()) {
+                if (p.mutable_grad().defined()) {
+                    p.mutable_grad().detach_();
+                    // Rows the masked step left alone keep their gradient for their next visible step
+                    if (visibility.defined() && !group_options.dense() && p.dim() > 0 && p.size(0) == visibility.numel()) {
+                        std::vector<int64_t> shape(p.dim(), 1);
+                        shape[0] = visibility.numel();
+                        p.mutable_grad().masked_fill_(visibility.view(shape), 0);
+                    } else if (set_to_none)
+                        p.mutable_grad().reset();
+                    else
+                        p.mutable_grad().zero_();
                 }
             }
-        } else
-            Optimizer::zero_grad(set_to_none);
+        }
     }
 } // namespace gs::training
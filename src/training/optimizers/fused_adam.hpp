@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <torch/torch.h>
 #include <vector>
@@ -40,16 +41,54 @@ namespace gs::training {
                 return *this;
             }
 
+            // The group steps every update_every iterations up to update_every_until, then every iteration
+            Options& update_every(int64_t update_every, int64_t update_every_until) {
+                update_every_ = std::max<int64_t>(update_every, 1);
+                update_every_until_ = update_every_until;
+                return *this;
+            }
+
+            // The group is frozen up to and including this iteration, its gradients are dropped
+            Options& update_after(int64_t update_after) {
+                update_after_ = update_after;
+                return *this;
+            }
+
+            // The group ignores set_visibility and always steps every row, for params whose first
+            // dimension only matches the mask by coincidence
+            Options& dense(bool dense) {
+                dense_ = dense;
+                return *this;
+            }
+
             double lr() const { return lr_; }
             const std::tuple<double, double>& betas() const { return betas_; }
             double eps() const { return eps_; }
             double weight_decay() const { return weight_decay_; }
+            int64_t update_every() const { return update_every_; }
+            int64_t update_every_until() const { return update_every_until_; }
+            int64_t update_after() const { return update_after_; }
+            bool dense() const { return dense_; }
+
+            // Iterations start at 1. Skipped iterations accumulate gradients into the next update,
+            // the step count still advances so bias correction follows the iteration.
+            bool skips(int64_t iteration) const {
+                return iteration <= update_after_ ||
+                       (iteration <= update_every_until_ && iteration % update_every_ != 0);
+            }
+            bool accumulates(int64_t iteration) const {
+                return iteration > update_after_ && skips(iteration);
+            }
 
         private:
             double lr_ = 1e-3;
             std::tuple<double, double> betas_ = std::make_tuple(0.9, 0.999);
             double eps_ = 1e-8;
             double weight_decay_ = 0;
+            int64_t update_every_ = 1;
+            int64_t update_every_until_ = 0;
+            int64_t update_after_ = 0;
+            bool dense_ = false;
         };
 
         struct AdamParamState : public torch::optim::OptimizerParamState {
@@ -87,11 +126,28 @@ namespace gs::training {
          */
         void step(int iteration);
 
+        // Keeps the gradients of groups whose step skipped this iteration, they accumulate. After a
+        // masked step only the visible rows are cleared, the others carry over to their next step.
         void zero_grad(bool set_to_none, int iteration);
 
+        /**
+         * @brief Restrict the next step to the visible Gaussians (sparse Adam)
+         *
+         * Params with one row per Gaussian only update the rows set in the bool mask, their moments
+         * elsewhere stay as they are. Step counts and bias corrections advance for every param,
+         * as in gsplat's SelectiveAdam. A mask whose size no longer matches the model falls back to
+         * a dense step, as do groups with Options::dense. Applies to one step only.
+         */
+        void set_visibility(torch::Tensor visibility) { visibility_ = std::move(visibility); }
+
     private:
         const Options& options() const {
             return static_cast<const Options&>(defaults());
         }
+
+        const Options& group_options_of(const torch::optim::OptimizerParamGroup& group) const;
+
+        torch::Tensor visibility_;
+        torch::Tensor stepped_visibility_; // mask of the last step, until zero_grad
     };
 } // namespace gs::training
@@ -24,6 +24,17 @@ namespace gs::training {
         }
     }
 
+    double WarmupExponentialLR::lr_of(const torch::optim::OptimizerParamGroup& group) {
+        if (auto* fused_options = dynamic_cast<const FusedAdam::Options*>(&group.options())) {
+            return fused_options->lr();
+        }
+        if (auto* adam_options = dynamic_cast<const torch::optim::AdamOptions*>(&group.options())) {
+            return adam_options->lr();
+        }
+        TORCH_CHECK(false, "WarmupExponentialLR needs FusedAdam or Adam param groups");
+        return 0.0;
+    }
+
     void WarmupExponentialLR::step() {
         current_step_++;
 
@@ -40,14 +40,21 @@ namespace gs::training {
               current_step_(0) {
             // Store initial learning rates for all param groups
             for (const auto& group : optimizer.param_groups()) {
-                auto* options = static_cast<torch::optim::AdamOptions*>(&const_cast<torch::optim::OptimizerParamGroup&>(group).options());
-                initial_lrs_.push_back(options->lr());
+                initial_lrs_.push_back(lr_of(group));
             }
         }
 
         void step();
 
+        // Resuming from a checkpoint restores the step count, the group learning rates are
+        // recomputed from it on the next step()
+        int current_step() const { return current_step_; }
+        void set_current_step(int step) { current_step_ = step; }
+
     private:
+        // Learning rate of a FusedAdam or torch Adam group
+        static double lr_of(const torch::optim::OptimizerParamGroup& group);
+
         torch::optim::Optimizer& optimizer_;
         double gamma_;
         int warmup_steps_;
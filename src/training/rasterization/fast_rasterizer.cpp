@@ -12,7 +12,10 @@ namespace gs::training {
     RenderOutput fast_rasterize(
         Camera& viewpoint_camera,
         SplatData& gaussian_model,
-        torch::Tensor& bg_color) {
+        torch::Tensor& bg_color,
+        fast_gs::rasterization::RasterizerContext* context,
+        bool composite_background,
+        const torch::Tensor& pixel_mask) {
         // Get camera parameters
         const int width = static_cast<int>(viewpoint_camera.image_width());
         const int height = static_cast<int>(viewpoint_camera.image_height());
@@ -44,6 +47,9 @@ namespace gs::training {
         settings.center_y = cy;
         settings.near_plane = near_plane;
         settings.far_plane = far_plane;
+        settings.projection = fast_projection(viewpoint_camera);
+        settings.context = context;
+        settings.pixel_mask = pixel_mask;
 
         auto raster_outputs = FastGSRasterize::apply(
             means,
@@ -54,14 +60,128 @@ namespace gs::training {
             shN,
             w2c,
             gaussian_model._densification_info,
+            gaussian_model._max_contribution,
             settings);
 
         RenderOutput output;
         output.image = raster_outputs[0];
         output.alpha = raster_outputs[1];
+        if (raster_outputs[2].numel() > 0) {
+            output.depth = raster_outputs[2].index({Slice(0, 1)});
+            output.median_depth = raster_outputs[2].index({Slice(1, 2)});
+        }
+        output.visibility = raster_outputs[3];
+
+        if (composite_background) {
+            output.image = output.image + (1.0f - output.alpha) * bg_color.unsqueeze(-1).unsqueeze(-1);
+        } else {
+            output.background = bg_color;
+        }
+
+        return output;
+    }
+
+    RenderOutput fast_render(
+        Camera& viewpoint_camera,
+        const SplatData& gaussian_model,
+        const torch::Tensor& bg_color,
+        fast_gs::rasterization::RasterizerContext* context) {
+        const int width = static_cast<int>(viewpoint_camera.image_width());
+        const int height = static_cast<int>(viewpoint_camera.image_height());
+        auto [fx, fy, cx, cy] = viewpoint_camera.get_intrinsics();
 
-        output.image = output.image + (1.0f - output.alpha) * bg_color.unsqueeze(-1).unsqueeze(-1);
+        const int sh_degree = gaussian_model.get_active_sh_degree();
+        const int active_sh_bases = (sh_degree + 1) * (sh_degree + 1);
 
+        constexpr float near_plane = 0.01f;
+        constexpr float far_plane = 1e10f;
+
+        torch::NoGradGuard no_grad;
+        auto [image, alpha, depth] = fast_gs::rasterization::render_wrapper(
+            gaussian_model.means().detach(),
+            gaussian_model.scaling_raw().detach(),
+            gaussian_model.rotation_raw().detach(),
+            gaussian_model.opacity_raw().detach(),
+            gaussian_model.sh0().detach(),
+            gaussian_model.shN().detach(),
+            viewpoint_camera.world_view_transform(),
+            viewpoint_camera.cam_position(),
+            active_sh_bases,
+            width,
+            height,
+            fx,
+            fy,
+            cx,
+            cy,
+            near_plane,
+            far_plane,
+            fast_projection(viewpoint_camera),
+            context);
+
+        RenderOutput output;
+        output.image = image + (1.0f - alpha) * bg_color.unsqueeze(-1).unsqueeze(-1);
+        output.alpha = alpha;
+        if (depth.numel() > 0) {
+            output.depth = depth.index({Slice(0, 1)});
+            output.median_depth = depth.index({Slice(1, 2)});
+        }
+        output.width = width;
+        output.height = height;
         return output;
     }
+
+    RenderOutput fast_rasterize_depth(
+        Camera& viewpoint_camera,
+        SplatData& gaussian_model,
+        torch::Tensor& bg_color) {
+        thread_local fast_gs::rasterization::RasterizerContext context;
+        context.render_depth = true;
+        return fast_render(viewpoint_camera, gaussian_model, bg_color, &context);
+    }
+
+    TileWorkload fast_rasterize_workload(
+        Camera& viewpoint_camera,
+        const SplatData& gaussian_model) {
+        thread_local fast_gs::rasterization::RasterizerContext context;
+        const int width = static_cast<int>(viewpoint_camera.image_width());
+        const int height = static_cast<int>(viewpoint_camera.image_height());
+        auto [fx, fy, cx, cy] = viewpoint_camera.get_intrinsics();
+
+        const int sh_degree = gaussian_model.get_active_sh_degree();
+        const int active_sh_bases = (sh_degree + 1) * (sh_degree + 1);
+
+        constexpr float near_plane = 0.01f;
+        constexpr float far_plane = 1e10f;
+
+        torch::NoGradGuard no_grad;
+        const auto outputs = fast_gs::rasterization::forward_wrapper(
+            gaussian_model.means().detach(),
+            gaussian_model.scaling_raw().detach(),
+            gaussian_model.rotation_raw().detach(),
+            gaussian_model.opacity_raw().detach(),
+            gaussian_model.sh0().detach(),
+            gaussian_model.shN().detach(),
+            viewpoint_camera.world_view_transform(),
+            viewpoint_camera.cam_position(),
+            active_sh_bases,
+            width,
+            height,
+            fx,
+            fy,
+            cx,
+            cy,
+            near_plane,
+            far_plane,
+            fast_projection(viewpoint_camera),
+            &context);
+
+        const auto shape = fast_gs::rasterization::resolve_tile_shape(context.tile_shape, width, height);
+        auto [tile_instances, tile_max_contributors, pixel_contributors] =
+            fast_gs::rasterization::tile_workload(std::get<4>(outputs), width, height, shape);
+        return {.tile_instances = tile_instances,
+                .tile_max_contributors = tile_max_contributors,
+                .pixel_contributors = pixel_contributors,
+                .tile_width = fast_gs::rasterization::tile_width_of(shape),
+                .tile_height = fast_gs::rasterization::tile_height_of(shape)};
+    }
 } // namespace gs::training
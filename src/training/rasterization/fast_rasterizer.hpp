@@ -7,12 +7,33 @@
 #include "core/camera.hpp"
 #include "core/splat_data.hpp"
 #include "rasterization_api.h"
+#include "rasterizer_context.h"
 #include "rasterizer.hpp"
 
 namespace gs::training {
-    // Wrapper function to use fastgs backend for rendering
+    // Projection fastgs renders the camera with, fisheye cameras are rejected before they get here
+    inline fast_gs::rasterization::Projection fast_projection(const Camera& camera) {
+        return camera.camera_model_type() == gsplat::CameraModelType::ORTHO
+                   ? fast_gs::rasterization::Projection::Orthographic
+                   : fast_gs::rasterization::Projection::Pinhole;
+    }
+
+    // Wrapper function to use fastgs backend for rendering. Without composite_background the image
+    // stays premultiplied and RenderOutput::background carries bg_color for the loss to composite.
+    // A defined pixel_mask [1, H, W] skips blending and backward of the tiles it fully zeroes.
     RenderOutput fast_rasterize(
         Camera& viewpoint_camera,
         SplatData& gaussian_model,
-        torch::Tensor& bg_color);
+        torch::Tensor& bg_color,
+        fast_gs::rasterization::RasterizerContext* context = nullptr,
+        bool composite_background = true,
+        const torch::Tensor& pixel_mask = {});
+
+    // Inference-only fastgs render: no autograd and no backward buffers, for evaluation and the viewer.
+    // The context must not hold a forward whose backward is still pending.
+    RenderOutput fast_render(
+        Camera& viewpoint_camera,
+        const SplatData& gaussian_model,
+        const torch::Tensor& bg_color,
+        fast_gs::rasterization::RasterizerContext* context = nullptr);
 } // namespace gs::training
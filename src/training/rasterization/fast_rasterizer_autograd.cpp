@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "fast_rasterizer_autograd.hpp"
+#include "rasterizer_context.h"
 
 namespace gs::training {
     // FastGSRasterize implementation
@@ -15,7 +16,8 @@ namespace gs::training {
         const torch::Tensor& sh_coefficients_0,    // [N, 1, 3]
         const torch::Tensor& sh_coefficients_rest, // [C, B-1, 3]
         const torch::Tensor& w2c,                  // [C, 4, 4]
-        torch::Tensor& densification_info,         // [2, N] or empty tensor
+        torch::Tensor& densification_info,         // [N, 2] half or empty tensor
+        torch::Tensor& max_contribution,           // [N] float or empty tensor
         const fast_gs::rasterization::FastGSSettings& settings) {
         // rasterizer settings
 
@@ -36,26 +38,36 @@ namespace gs::training {
             settings.center_x,
             settings.center_y,
             settings.near_plane,
-            settings.far_plane);
+            settings.far_plane,
+            settings.projection,
+            settings.context,
+            settings.pixel_mask);
 
         auto image = std::get<0>(outputs);
         auto alpha = std::get<1>(outputs);
-        auto per_primitive_buffers = std::get<2>(outputs);
-        auto per_tile_buffers = std::get<3>(outputs);
-        auto per_instance_buffers = std::get<4>(outputs);
-        auto per_bucket_buffers = std::get<5>(outputs);
-        int n_visible_primitives = std::get<6>(outputs);
-        int n_instances = std::get<7>(outputs);
-        int n_buckets = std::get<8>(outputs);
-        int primitive_primitive_indices_selector = std::get<9>(outputs);
-        int instance_primitive_indices_selector = std::get<10>(outputs);
+        auto depth = std::get<2>(outputs);
+        auto per_primitive_buffers = std::get<3>(outputs);
+        auto per_tile_buffers = std::get<4>(outputs);
+        auto per_instance_buffers = std::get<5>(outputs);
+        auto per_bucket_buffers = std::get<6>(outputs);
+        int n_visible_primitives = std::get<7>(outputs);
+        int n_instances = std::get<8>(outputs);
+        int n_buckets = std::get<9>(outputs);
+        int primitive_primitive_indices_selector = std::get<10>(outputs);
+        int instance_primitive_indices_selector = std::get<11>(outputs);
+        int bucket_replay_chunk = std::get<12>(outputs);
+        // read before a later forward on the same context reuses the per-primitive arena
+        auto visibility = fast_gs::rasterization::visibility_mask(per_primitive_buffers, static_cast<int>(means.size(0)));
 
         // Mark non-differentiable tensors
-        ctx->mark_non_differentiable({per_primitive_buffers,
+        ctx->mark_non_differentiable({depth,
+                                      visibility,
+                                      per_primitive_buffers,
                                       per_tile_buffers,
                                       per_instance_buffers,
                                       per_bucket_buffers,
-                                      densification_info});
+                                      densification_info,
+                                      max_contribution});
 
         // Save for backward
         ctx->save_for_backward({image,
@@ -69,7 +81,8 @@ namespace gs::training {
                                 per_instance_buffers,
                                 per_bucket_buffers,
                                 w2c,
-                                densification_info});
+                                densification_info,
+                                max_contribution});
 
         ctx->saved_data["cam_position"] = settings.cam_position;
         ctx->saved_data["active_sh_bases"] = settings.active_sh_bases;
@@ -81,13 +94,18 @@ namespace gs::training {
         ctx->saved_data["center_y"] = settings.center_y;
         ctx->saved_data["near_plane"] = settings.near_plane;
         ctx->saved_data["far_plane"] = settings.far_plane;
+        ctx->saved_data["projection"] = static_cast<int64_t>(settings.projection);
         ctx->saved_data["n_visible_primitives"] = n_visible_primitives;
         ctx->saved_data["n_instances"] = n_instances;
         ctx->saved_data["n_buckets"] = n_buckets;
         ctx->saved_data["primitive_primitive_indices_selector"] = primitive_primitive_indices_selector;
         ctx->saved_data["instance_primitive_indices_selector"] = instance_primitive_indices_selector;
+        ctx->saved_data["bucket_replay_chunk"] = bucket_replay_chunk;
+        // backward has to walk the tiles with the shape this forward used
+        const auto& raster_context = settings.context ? *settings.context : fast_gs::rasterization::default_context();
+        ctx->saved_data["tile_shape"] = static_cast<int64_t>(raster_context.tile_shape);
 
-        return {image, alpha};
+        return {image, alpha, depth, visibility};
     }
 
     torch::autograd::tensor_list FastGSRasterize::backward(
@@ -109,9 +127,11 @@ namespace gs::training {
         const torch::Tensor& per_bucket_buffers = saved[9];
         const torch::Tensor& w2c = saved[10];
         torch::Tensor& densification_info = saved[11];
+        torch::Tensor& max_contribution = saved[12];
 
         auto outputs = fast_gs::rasterization::backward_wrapper(
             densification_info,
+            max_contribution,
             grad_image,
             grad_alpha,
             image,
@@ -135,11 +155,14 @@ namespace gs::training {
             static_cast<float>(ctx->saved_data["center_y"].toDouble()),
             static_cast<float>(ctx->saved_data["near_plane"].toDouble()),
             static_cast<float>(ctx->saved_data["far_plane"].toDouble()),
+            static_cast<fast_gs::rasterization::Projection>(ctx->saved_data["projection"].toInt()),
             ctx->saved_data["n_visible_primitives"].toInt(),
             ctx->saved_data["n_instances"].toInt(),
             ctx->saved_data["n_buckets"].toInt(),
             ctx->saved_data["primitive_primitive_indices_selector"].toInt(),
-            ctx->saved_data["instance_primitive_indices_selector"].toInt());
+            ctx->saved_data["instance_primitive_indices_selector"].toInt(),
+            static_cast<fast_gs::rasterization::TileShape>(ctx->saved_data["tile_shape"].toInt()),
+            ctx->saved_data["bucket_replay_chunk"].toInt());
 
         auto grad_means = std::get<0>(outputs);
         auto grad_scales_raw = std::get<1>(outputs);
@@ -158,6 +181,7 @@ namespace gs::training {
             grad_sh_coefficients_rest,
             grad_w2c,
             torch::Tensor(), // densification_info (no gradient)
+            torch::Tensor(), // max_contribution (no gradient)
             torch::Tensor(), // settings (no gradient)
         };
     }
@@ -20,7 +20,8 @@ namespace gs::training {
             const torch::Tensor& sh_coefficients_0,                  // [N, 1, 3]
             const torch::Tensor& sh_coefficients_rest,               // [C, B-1, 3]
             const torch::Tensor& w2c,                                // [C, 4, 4]
-            torch::Tensor& densification_info,                       // [2, N] or empty tensor
+            torch::Tensor& densification_info,                       // [N, 2] half or empty tensor
+            torch::Tensor& max_contribution,                         // [N] float or empty tensor
             const fast_gs::rasterization::FastGSSettings& settings); // rasterizer settings
 
         static torch::autograd::tensor_list backward(
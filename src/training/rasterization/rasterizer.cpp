@@ -4,43 +4,126 @@
 
 #include "rasterizer.hpp"
 #include "Ops.h"
+#include "core/camera_set.hpp"
 #include "rasterizer_autograd.hpp"
+#include <algorithm>
+#include <map>
 #include <torch/torch.h>
 
 namespace gs::training {
     using torch::indexing::None;
     using torch::indexing::Slice;
 
-    inline torch::Tensor spherical_harmonics(
-        int sh_degree,
-        const torch::Tensor& dirs,
-        const torch::Tensor& coeffs,
-        const torch::Tensor& masks = {}) {
-        // Validate inputs
-        TORCH_CHECK((sh_degree + 1) * (sh_degree + 1) <= coeffs.size(-2),
-                    "coeffs K dimension must be at least ", (sh_degree + 1) * (sh_degree + 1),
-                    ", got ", coeffs.size(-2));
-        TORCH_CHECK(dirs.sizes().slice(0, dirs.dim() - 1) == coeffs.sizes().slice(0, coeffs.dim() - 2),
-                    "dirs and coeffs batch dimensions must match");
-        TORCH_CHECK(dirs.size(-1) == 3, "dirs last dimension must be 3, got ", dirs.size(-1));
-        TORCH_CHECK(coeffs.size(-1) == 3, "coeffs last dimension must be 3, got ", coeffs.size(-1));
-
-        if (masks.defined()) {
-            TORCH_CHECK(masks.sizes() == dirs.sizes().slice(0, dirs.dim() - 1),
-                        "masks shape must match dirs shape without last dimension");
+    namespace {
+        constexpr float EPS2D = 0.3f;
+        constexpr float NEAR_PLANE = 0.01f;
+        constexpr float FAR_PLANE = 10000.0f;
+        constexpr int TILE_SIZE = 16;
+
+        // The UT kernels read 6 radial coefficients per pinhole camera and 4 per fisheye camera
+        int64_t radial_coefficient_count(const gsplat::CameraModelType camera_model) {
+            return camera_model == gsplat::CameraModelType::FISHEYE ? 4 : 6;
         }
 
-        // Create sh_degree tensor
-        auto sh_degree_tensor = torch::tensor({sh_degree},
-                                              torch::TensorOptions().dtype(torch::kInt32).device(dirs.device()));
+        // [count] CUDA coefficients zero padded, nullopt without distortion
+        std::optional<torch::Tensor> padded_coefficients(const torch::Tensor& coefficients, const int64_t count) {
+            if (!coefficients.defined() || coefficients.numel() == 0) {
+                return std::nullopt;
+            }
+            auto padded = coefficients.to(torch::kCUDA, torch::kFloat32);
+            TORCH_CHECK(padded.dim() == 1 && padded.size(0) <= count,
+                        "expected at most ", count, " distortion coefficients, got ", padded.sizes());
+            if (padded.size(0) < count) {
+                padded = torch::nn::functional::pad(
+                    padded, torch::nn::functional::PadFuncOptions({0, count - padded.size(0)}).mode(torch::kConstant).value(0));
+            }
+            return padded.contiguous();
+        }
 
-        // Call the autograd function
-        return SphericalHarmonicsFunction::apply(
-            sh_degree_tensor,
-            dirs.contiguous(),
-            coeffs.contiguous(),
-            masks.defined() ? masks.contiguous() : masks)[0];
-    }
+        // Rough device bytes of one camera in rasterize_batch: projection outputs and colors per
+        // Gaussian, a few tile intersections per Gaussian and the output planes per pixel
+        size_t batch_bytes_per_camera(const int64_t n_gaussians, const int width, const int height) {
+            constexpr size_t per_gaussian = 8 + 8 + 4 + 12 + 4 + 12 + 4; // radii, means2d, depths, conics, compensations, colors, opacities
+            constexpr size_t per_intersection = 8 + 4;                   // isect_ids, flatten_ids
+            constexpr size_t intersections_per_gaussian = 4;
+            constexpr size_t per_pixel = 3 * 4 + 4 + 4; // colors, alpha, last_ids
+            return static_cast<size_t>(n_gaussians) * (per_gaussian + intersections_per_gaussian * per_intersection) +
+                   static_cast<size_t>(width) * height * per_pixel;
+        }
+
+        // Renders cameras of one resolution and camera model as a single [C, N] batch
+        void rasterize_chunk(const std::vector<Camera*>& cameras,
+                             const SplatData& gaussian_model,
+                             const torch::Tensor& bg_color,
+                             std::vector<RenderOutput>& outputs,
+                             const std::vector<size_t>& output_indices) {
+            const auto C = static_cast<int64_t>(cameras.size());
+            const Camera& first = *cameras.front();
+            const int width = first.image_width();
+            const int height = first.image_height();
+            const auto camera_model = first.camera_model_type();
+            const int64_t radial_count = radial_coefficient_count(camera_model);
+
+            // One upload for the intrinsics and distortion of the whole chunk
+            const CameraSet batch = CameraSet::snapshot(cameras, radial_count);
+            TORCH_CHECK(batch.radial_distortion().size(1) == radial_count,
+                        "expected at most ", radial_count, " radial coefficients, got ", batch.radial_distortion().size(1));
+            const auto& viewmat = batch.world_view_transforms(); // [C, 4, 4]
+            const auto& K = batch.Ks();                          // [C, 3, 3]
+            // All-zero coefficients of the undistorted cameras in a mixed batch are the identity
+            const auto radial_coeffs = batch.distorted() ? std::optional(batch.radial_distortion()) : std::nullopt;
+            const auto tangential_coeffs = batch.distorted() ? std::optional(batch.tangential_distortion()) : std::nullopt;
+
+            const auto means3D = gaussian_model.get_means();
+            const auto opacities = gaussian_model.get_opacity().reshape({-1});
+            const auto scales = gaussian_model.get_scaling();
+            const auto rotations = gaussian_model.get_rotation();
+            const auto N = means3D.size(0);
+            const auto& campos = batch.cam_positions(); // [C, 3]
+
+            const auto proj_outputs = fully_fused_projection_with_ut(
+                means3D, rotations, scales, opacities, viewmat, K,
+                radial_coeffs, tangential_coeffs, std::nullopt,
+                GUTProjectionSettings{width, height, EPS2D, NEAR_PLANE, FAR_PLANE, 0.0f, 1.0f, camera_model},
+                UnscentedTransformParameters(),
+                gaussian_model.sh0(), gaussian_model.shN(), campos, gaussian_model.get_active_sh_degree());
+            const auto& radii = proj_outputs[0];
+            const auto& means2d = proj_outputs[1];
+            const auto& depths = proj_outputs[2];
+            const auto colors = torch::clamp_min(proj_outputs[5] + 0.5f, 0.0f); // [C, N, 3]
+
+            const int tile_width = (width + TILE_SIZE - 1) / TILE_SIZE;
+            const int tile_height = (height + TILE_SIZE - 1) / TILE_SIZE;
+            const auto [tiles_per_gauss, isect_ids, flatten_ids] = gsplat::intersect_tile(
+                means2d, radii, depths, std::nullopt, std::nullopt,
+                static_cast<uint32_t>(C), TILE_SIZE, tile_width, tile_height, true);
+            const auto isect_offsets = gsplat::intersect_offset(isect_ids, static_cast<uint32_t>(C), tile_width, tile_height)
+                                           .reshape({C, tile_height, tile_width});
+
+            const auto backgrounds = bg_color.defined() && bg_color.numel() > 0
+                                         ? bg_color.view({1, -1}).to(torch::kCUDA).expand({C, 3}).contiguous()
+                                         : at::empty({0}, colors.options());
+
+            const auto raster_outputs = GUTRasterizationFunction::apply(
+                means3D, rotations, scales, colors,
+                opacities.unsqueeze(0).expand({C, N}).contiguous(),
+                backgrounds,
+                std::nullopt,
+                viewmat, K,
+                radial_coeffs, tangential_coeffs, std::nullopt,
+                isect_offsets, flatten_ids, std::nullopt,
+                GUTRasterizationSettings{width, height, TILE_SIZE, 1.0f, camera_model},
+                UnscentedTransformParameters{});
+
+            for (int64_t i = 0; i < C; ++i) {
+                RenderOutput& output = outputs[output_indices[i]];
+                output.image = torch::clamp(raster_outputs[0][i].permute({2, 0, 1}), 0.0f, 1.0f);
+                output.alpha = raster_outputs[1][i].permute({2, 0, 1});
+                output.width = width;
+                output.height = height;
+            }
+        }
+    } // namespace
 
     // Main render function
     RenderOutput rasterize(
@@ -52,9 +135,6 @@ namespace gs::training {
         bool antialiased,
         RenderMode render_mode,
         const gs::geometry::BoundingBox* bounding_box) {
-        // Ensure we don't use packed mode (not supported in this implementation)
-        TORCH_CHECK(!packed, "Packed mode is not supported in this implementation");
-
         // Get camera parameters
         const int image_height = static_cast<int>(viewpoint_camera.image_height());
         const int image_width = static_cast<int>(viewpoint_camera.image_width());
@@ -77,7 +157,9 @@ namespace gs::training {
         }
         auto scales = gaussian_model.get_scaling();
         auto rotations = gaussian_model.get_rotation();
-        auto sh_coeffs = gaussian_model.get_shs();
+        // sh0 and shN stay separate, the chunked SH evaluation concatenates one chunk at a time
+        auto sh0 = gaussian_model.sh0();
+        auto shN = gaussian_model.shN();
         const int sh_degree = gaussian_model.get_active_sh_degree();
 
         // Apply bounding box filtering if provided
@@ -132,7 +214,8 @@ namespace gs::training {
             opacities = opacities.index({inside_indices});
             scales = scales.index({inside_indices});
             rotations = rotations.index({inside_indices});
-            sh_coeffs = sh_coeffs.index({inside_indices});
+            sh0 = sh0.index({inside_indices});
+            shN = shN.index({inside_indices});
         }
 
         // Validate Gaussian parameters
@@ -145,21 +228,23 @@ namespace gs::training {
                     "scales must be [N, 3], got ", scales.sizes());
         TORCH_CHECK(rotations.dim() == 2 && rotations.size(0) == N && rotations.size(1) == 4,
                     "rotations must be [N, 4], got ", rotations.sizes());
-        TORCH_CHECK(sh_coeffs.dim() == 3 && sh_coeffs.size(0) == N && sh_coeffs.size(2) == 3,
-                    "sh_coeffs must be [N, K, 3], got ", sh_coeffs.sizes());
+        TORCH_CHECK(sh0.dim() == 3 && sh0.size(0) == N && sh0.size(1) == 1 && sh0.size(2) == 3,
+                    "sh0 must be [N, 1, 3], got ", sh0.sizes());
+        TORCH_CHECK(shN.dim() == 3 && shN.size(0) == N && shN.size(2) == 3,
+                    "shN must be [N, K-1, 3], got ", shN.sizes());
 
         // Check if we have enough SH coefficients for the requested degree
         const int required_sh_coeffs = (sh_degree + 1) * (sh_degree + 1);
-        TORCH_CHECK(sh_coeffs.size(1) >= required_sh_coeffs,
+        TORCH_CHECK(sh0.size(1) + shN.size(1) >= required_sh_coeffs,
                     "Not enough SH coefficients. Expected at least ", required_sh_coeffs,
-                    " but got ", sh_coeffs.size(1));
+                    " but got ", sh0.size(1) + shN.size(1));
 
         // Device checks for Gaussian parameters
         TORCH_CHECK(means3D.is_cuda(), "means3D must be on CUDA");
         TORCH_CHECK(opacities.is_cuda(), "opacities must be on CUDA");
         TORCH_CHECK(scales.is_cuda(), "scales must be on CUDA");
         TORCH_CHECK(rotations.is_cuda(), "rotations must be on CUDA");
-        TORCH_CHECK(sh_coeffs.is_cuda(), "sh_coeffs must be on CUDA");
+        TORCH_CHECK(sh0.is_cuda() && shN.is_cuda(), "sh0 and shN must be on CUDA");
 
         // Handle background color - can be undefined
         torch::Tensor prepared_bg_color;
@@ -173,37 +258,16 @@ namespace gs::training {
             TORCH_CHECK(prepared_bg_color.is_cuda(), "bg_color must be on CUDA");
         }
 
-        const float eps2d = 0.3f;
-        const float near_plane = 0.01f;
-        const float far_plane = 10000.0f;
+        const float eps2d = EPS2D;
+        const float near_plane = NEAR_PLANE;
+        const float far_plane = FAR_PLANE;
         const float radius_clip = 0.0f;
-        const int tile_size = 16;
+        const int tile_size = TILE_SIZE;
         const bool calc_compensations = antialiased;
 
-        std::optional<torch::Tensor> radial_distortion;
-        if (viewpoint_camera.radial_distortion().numel() > 0) {
-            auto radial_distortion_val = viewpoint_camera.radial_distortion().to(torch::kCUDA);
-            TORCH_CHECK(radial_distortion_val.dim() == 1, "radial_distortion must be 1D, got ", radial_distortion_val.sizes());
-            if (radial_distortion_val.size(-1) < 4) {
-                // Pad to 4 coefficients if less are provided
-                radial_distortion_val = torch::nn::functional::pad(
-                    radial_distortion_val,
-                    torch::nn::functional::PadFuncOptions({0, 4 - radial_distortion_val.size(-1)}).mode(torch::kConstant).value(0));
-            }
-            radial_distortion = radial_distortion_val;
-        }
-        std::optional<torch::Tensor> tangential_distortion;
-        if (viewpoint_camera.tangential_distortion().numel() > 0) {
-            auto tangential_distortion_val = viewpoint_camera.tangential_distortion().to(torch::kCUDA);
-            TORCH_CHECK(tangential_distortion_val.dim() == 1, "tangential_distortion must be 1D, got ", tangential_distortion_val.sizes());
-            if (tangential_distortion_val.size(-1) < 2) {
-                // Pad to 2 coefficients if less are provided
-                tangential_distortion_val = torch::nn::functional::pad(
-                    tangential_distortion_val,
-                    torch::nn::functional::PadFuncOptions({0, 2 - tangential_distortion_val.size(-1)}).mode(torch::kConstant).value(0));
-            }
-            tangential_distortion = tangential_distortion_val;
-        }
+        const auto radial_distortion = padded_coefficients(
+            viewpoint_camera.radial_distortion(), radial_coefficient_count(viewpoint_camera.camera_model_type()));
+        const auto tangential_distortion = padded_coefficients(viewpoint_camera.tangential_distortion(), 2);
 
         // Step 1: Projection
         torch::Tensor radii;
@@ -221,18 +285,29 @@ namespace gs::training {
             radius_clip,
             scaling_modifier,
             viewpoint_camera.camera_model_type()};
-        auto proj_outputs = fully_fused_projection_with_ut(
+
+        // The camera position from the inverse viewmat, the projection evaluates SH colors against it
+        auto viewmat_inv = torch::inverse(viewmat);
+        auto campos = viewmat_inv.index({Slice(), Slice(None, 3), 3}); // [C, 3]
+
+        // Step 2: Colors from SH are evaluated in the projection kernel, for surviving Gaussians only
+        auto proj_outputs = ProjectionUTSHFunction::apply(
             means3D,
             rotations,
             scales,
             opacities,
             viewmat,
             K,
-            radial_distortion,
-            tangential_distortion,
-            std::nullopt,
-            proj_settings,
-            UnscentedTransformParameters());
+            sh0,
+            shN,
+            campos,
+            GUTProjectionSHSettings{
+                proj_settings,
+                UnscentedTransformParameters(),
+                radial_distortion,
+                tangential_distortion,
+                std::nullopt,
+                sh_degree});
 
         radii = proj_outputs[0];
         means2d = proj_outputs[1];
@@ -245,22 +320,7 @@ namespace gs::training {
         means2d_with_grad.set_requires_grad(true);
         means2d_with_grad.retain_grad();
 
-        // Step 2: Compute colors from SH
-        // First, compute camera position from inverse viewmat
-        auto viewmat_inv = torch::inverse(viewmat);
-        auto campos = viewmat_inv.index({Slice(), Slice(None, 3), 3}); // [C, 3]
-
-        // Compute directions from camera to each Gaussian
-        auto dirs = means3D.unsqueeze(0) - campos.unsqueeze(1); // [C, N, 3]
-
-        // Create masks based on radii
-        auto masks = (radii > 0).all(-1); // [C, N]
-
-        // The Python code broadcasts colors from [N, K, 3] to [C, N, K, 3] if needed
-        auto shs = sh_coeffs.unsqueeze(0); // [1, N, K, 3]
-
-        // Now call spherical harmonics with proper directions
-        auto colors = spherical_harmonics(sh_degree, dirs, shs, masks); // [C, N, 3]
+        auto colors = proj_outputs[5]; // [C, N, 3]
 
         // Apply the SH offset and clamping for rendering (shift from [-0.5, 0.5] to [0, 1])
         colors = torch::clamp_min(colors + 0.5f, 0.0f);
@@ -311,12 +371,29 @@ namespace gs::training {
         }
         TORCH_CHECK(final_opacities.is_cuda(), "final_opacities must be on CUDA");
 
+        // Packed mode: compact to the [nnz] Gaussians that survived projection
+        torch::Tensor isect_means2d = means2d_with_grad;
+        torch::Tensor isect_radii = radii;
+        torch::Tensor isect_depths = depths;
+        std::optional<torch::Tensor> camera_ids;
+        std::optional<torch::Tensor> gaussian_ids;
+        if (packed) {
+            const auto visible_ids = (radii > 0).all(-1).nonzero(); // [nnz, 2]
+            camera_ids = visible_ids.select(1, 0).contiguous();
+            gaussian_ids = visible_ids.select(1, 1).contiguous();
+            isect_means2d = means2d.index({*camera_ids, *gaussian_ids}).contiguous();             // [nnz, 2]
+            isect_radii = radii.index({*camera_ids, *gaussian_ids}).contiguous();                 // [nnz, 2]
+            isect_depths = depths.index({*camera_ids, *gaussian_ids}).contiguous();               // [nnz]
+            render_colors = render_colors.index({*camera_ids, *gaussian_ids}).contiguous();       // [nnz, channels]
+            final_opacities = final_opacities.index({*camera_ids, *gaussian_ids}).contiguous();   // [nnz]
+        }
+
         // Step 5: Tile intersection
         const int tile_width = (image_width + tile_size - 1) / tile_size;
         const int tile_height = (image_height + tile_size - 1) / tile_size;
 
         const auto isect_results = gsplat::intersect_tile(
-            means2d_with_grad, radii, depths, {}, {},
+            isect_means2d, isect_radii, isect_depths, camera_ids, gaussian_ids,
             1, tile_size, tile_width, tile_height,
             true);
 
@@ -356,6 +433,7 @@ namespace gs::training {
             std::nullopt, // thin_prism_coeffs
             isect_offsets,
             flatten_ids,
+            gaussian_ids,
             raster_settings,
             ut_params);
         auto rendered_image = raster_outputs[0];
@@ -435,4 +513,38 @@ namespace gs::training {
 
         return result;
     }
+
+    std::vector<RenderOutput> rasterize_batch(
+        std::span<Camera* const> cameras,
+        const SplatData& gaussian_model,
+        const torch::Tensor& bg_color,
+        const size_t memory_budget_mb) {
+        torch::NoGradGuard no_grad;
+        std::vector<RenderOutput> outputs(cameras.size());
+
+        // A batch shares resolution and camera model, mixed datasets render one group at a time
+        std::map<std::tuple<int, int, int>, std::vector<size_t>> groups;
+        for (size_t i = 0; i < cameras.size(); ++i) {
+            const Camera& cam = *cameras[i];
+            groups[{cam.image_width(), cam.image_height(), static_cast<int>(cam.camera_model_type())}].push_back(i);
+        }
+
+        const size_t budget_bytes = memory_budget_mb << 20;
+        for (const auto& [key, indices] : groups) {
+            const auto [width, height, camera_model] = key;
+            const size_t per_camera = batch_bytes_per_camera(gaussian_model.size(), width, height);
+            const size_t chunk_size = std::max<size_t>(1, budget_bytes / per_camera);
+
+            for (size_t begin = 0; begin < indices.size(); begin += chunk_size) {
+                const size_t end = std::min(indices.size(), begin + chunk_size);
+                std::vector<Camera*> chunk;
+                std::vector<size_t> chunk_indices(indices.begin() + begin, indices.begin() + end);
+                for (const size_t index : chunk_indices) {
+                    chunk.push_back(cameras[index]);
+                }
+                rasterize_chunk(chunk, gaussian_model, bg_color, outputs, chunk_indices);
+            }
+        }
+        return outputs;
+    }
 } // namespace gs::training
@@ -7,17 +7,22 @@
 #include "core/camera.hpp"
 #include "core/splat_data.hpp"
 #include "geometry/bounding_box.hpp"
+#include <span>
 #include <torch/torch.h>
+#include <vector>
 
 namespace gs::training {
     struct RenderOutput {
-        torch::Tensor image;      // [..., channels, H, W]
-        torch::Tensor alpha;      // [..., C, H, W, 1]
-        torch::Tensor depth;      // [..., C, H, W, 1] - accumulated or expected depth
-        torch::Tensor means2d;    // [..., C, N, 2]
-        torch::Tensor depths;     // [..., N] - per-gaussian depths
-        torch::Tensor radii;      // [..., N]
-        torch::Tensor visibility; // [..., N]
+        torch::Tensor image;          // [..., channels, H, W]
+        torch::Tensor alpha;          // [..., C, H, W, 1]
+        torch::Tensor depth;          // [..., C, H, W, 1] - accumulated or expected depth
+        torch::Tensor median_depth;   // [1, H, W] - fastgs with render_depth only
+        torch::Tensor means2d;        // [..., C, N, 2]
+        torch::Tensor depths;         // [..., N] - per-gaussian depths
+        torch::Tensor radii;          // [..., N]
+        torch::Tensor visibility;     // [..., N]
+        torch::Tensor background;     // [channels], set when image was left without the background (fused_loss)
+        torch::Tensor bilateral_grid; // [12, L, H, W], set when image was left without the bilateral grid (fused_loss)
         int width;
         int height;
     };
@@ -58,7 +63,8 @@ namespace gs::training {
             throw std::runtime_error("Invalid render mode: " + mode);
     }
 
-    // Wrapper function to use gsplat backend for rendering
+    // Wrapper function to use gsplat backend for rendering. packed intersects and rasterizes only
+    // the Gaussians that survive projection, the per-Gaussian outputs stay dense [N]
     RenderOutput rasterize(
         Camera& viewpoint_camera,
         const SplatData& gaussian_model,
@@ -68,4 +74,36 @@ namespace gs::training {
         bool antialiased = false,
         RenderMode render_mode = RenderMode::RGB,
         const gs::geometry::BoundingBox* = nullptr);
+
+    // Forward-only gsplat 3DGUT render of many cameras, for evaluation and timelapse. Cameras are
+    // grouped by resolution and camera model, each group goes through projection, intersection and
+    // rasterization as [C, N] batches sized to memory_budget_mb. Returns one RGB output per camera
+    // in input order with image [3, H, W] and alpha [1, H, W], the per-Gaussian fields stay empty.
+    std::vector<RenderOutput> rasterize_batch(
+        std::span<Camera* const> cameras,
+        const SplatData& gaussian_model,
+        const torch::Tensor& bg_color,
+        size_t memory_budget_mb = 2048);
+
+    // fastgs forward with expected depth ([1, H, W] in depth) and median depth, without autograd.
+    // Runs on a context of its own per host thread, so training contexts are untouched.
+    RenderOutput fast_rasterize_depth(
+        Camera& viewpoint_camera,
+        SplatData& gaussian_model,
+        torch::Tensor& bg_color);
+
+    // Where the fastgs blend spends its time for one view, as a training forward sees it
+    struct TileWorkload {
+        torch::Tensor tile_instances;        // [tiles_y, tiles_x] int32, instances sorted into each tile
+        torch::Tensor tile_max_contributors; // [tiles_y, tiles_x] int32, largest pixel count of the tile
+        torch::Tensor pixel_contributors;    // [H, W] int32, instances walked up to the last one blended
+        int tile_width = 0;
+        int tile_height = 0;
+    };
+
+    // fastgs forward with the backward state a training step keeps, only to read its workload.
+    // Runs on a context of its own per host thread, so training contexts are untouched.
+    TileWorkload fast_rasterize_workload(
+        Camera& viewpoint_camera,
+        const SplatData& gaussian_model);
 } // namespace gs::training
@@ -143,7 +143,11 @@ namespace gs::training {
         std::optional<torch::Tensor> tangential_coeffs, // [..., C, 2]
         std::optional<torch::Tensor> thin_prism_coeffs, // [..., C, 4]
         GUTProjectionSettings settings,
-        UnscentedTransformParameters ut_params) {
+        UnscentedTransformParameters ut_params,
+        torch::Tensor sh0,
+        torch::Tensor shN,
+        torch::Tensor campos,
+        int sh_degree) {
         // Input validation
         const int N = static_cast<int>(means3D.size(0));
         const int C = static_cast<int>(viewmat.size(0));
@@ -210,6 +214,17 @@ namespace gs::training {
         viewmat = viewmat.contiguous();
         K = K.contiguous();
 
+        const bool eval_sh = sh0.defined();
+        if (eval_sh) {
+            TORCH_CHECK(shN.defined() && campos.defined(), "SH colors need sh0, shN and campos");
+            TORCH_CHECK(sh0.size(0) == N && shN.size(0) == N, "sh0 and shN must hold one row per Gaussian");
+            TORCH_CHECK(campos.dim() == 2 && campos.size(0) == C && campos.size(1) == 3,
+                        "campos must be [C, 3], got ", campos.sizes());
+            sh0 = sh0.contiguous();
+            shN = shN.contiguous();
+            campos = campos.contiguous();
+        }
+
         // Apply scaling modifier
         auto scaled_scales = scales * settings.scaling_modifier;
 
@@ -234,12 +249,17 @@ namespace gs::training {
             ShutterType::GLOBAL,
             radial_coeffs,
             tangential_coeffs,
-            thin_prism_coeffs);
+            thin_prism_coeffs,
+            eval_sh ? std::optional<torch::Tensor>(sh0) : std::nullopt,
+            eval_sh ? std::optional<torch::Tensor>(shN) : std::nullopt,
+            eval_sh ? std::optional<torch::Tensor>(campos) : std::nullopt,
+            static_cast<uint32_t>(sh_degree));
         auto radii = std::get<0>(proj_results).contiguous();
         auto means2d = std::get<1>(proj_results).contiguous();
         auto depths = std::get<2>(proj_results).contiguous();
         auto conics = std::get<3>(proj_results).contiguous();
         auto compensations = std::get<4>(proj_results);
+        auto colors = std::get<5>(proj_results);
 
         if (!compensations.defined()) {
             compensations = at::empty({0});
@@ -261,7 +281,84 @@ namespace gs::training {
         TORCH_CHECK(depths.is_cuda(), "depths must be on CUDA");
         TORCH_CHECK(conics.is_cuda(), "conics must be on CUDA");
 
-        return {radii, means2d, depths, conics, compensations};
+        return {radii, means2d, depths, conics, compensations, colors};
+    }
+
+    // ProjectionUTSHFunction implementation
+    torch::autograd::tensor_list ProjectionUTSHFunction::forward(
+        torch::autograd::AutogradContext* ctx,
+        torch::Tensor means3D,
+        torch::Tensor quats,
+        torch::Tensor scales,
+        torch::Tensor opacities,
+        torch::Tensor viewmat,
+        torch::Tensor K,
+        torch::Tensor sh0,
+        torch::Tensor shN,
+        torch::Tensor campos,
+        GUTProjectionSHSettings settings) {
+        TORCH_CHECK(viewmat.size(0) == 1, "ProjectionUTSHFunction renders one camera, got ", viewmat.size(0));
+
+        auto outputs = fully_fused_projection_with_ut(
+            means3D, quats, scales, opacities, viewmat, K,
+            settings.radial_coeffs, settings.tangential_coeffs, settings.thin_prism_coeffs,
+            settings.projection, settings.ut_params,
+            sh0, shN, campos, settings.sh_degree);
+
+        // the SH vjp only runs for Gaussians whose colors were evaluated
+        const auto masks = (outputs[0] > 0).all(-1); // [1, N]
+
+        ctx->mark_non_differentiable({outputs[0], outputs[1], outputs[2], outputs[3], outputs[4]});
+        ctx->save_for_backward({means3D, sh0, shN, campos, masks});
+        ctx->saved_data["sh_degree"] = static_cast<int64_t>(settings.sh_degree);
+        return outputs;
+    }
+
+    torch::autograd::tensor_list ProjectionUTSHFunction::backward(
+        torch::autograd::AutogradContext* ctx,
+        torch::autograd::tensor_list grad_outputs) {
+        auto v_colors = grad_outputs[5];
+
+        auto saved = ctx->get_saved_variables();
+        const auto& means3D = saved[0];
+        const auto& sh0 = saved[1];
+        const auto& shN = saved[2];
+        const auto& campos = saved[3];
+        const auto& masks = saved[4];
+
+        torch::Tensor v_means, v_sh0, v_shN, v_campos;
+        if (v_colors.defined()) {
+            const bool compute_v_means = ctx->needs_input_grad(0) || ctx->needs_input_grad(8);
+            auto [v_sh0_fp32, v_shN_fp32, v_means_sh] = gsplat::spherical_harmonics_split_bwd(
+                static_cast<uint32_t>(ctx->saved_data["sh_degree"].toInt()),
+                means3D,
+                campos.reshape({3}).contiguous(),
+                sh0,
+                shN,
+                masks.reshape({-1}).contiguous(),
+                v_colors.reshape({-1, 3}).contiguous(),
+                compute_v_means);
+            v_sh0 = v_sh0_fp32;
+            v_shN = v_shN_fp32.to(shN.scalar_type());
+            if (compute_v_means) {
+                // dirs = means - campos
+                v_means = v_means_sh;
+                v_campos = -v_means_sh.sum(0, /*keepdim=*/true);
+            }
+        }
+
+        return {
+            ctx->needs_input_grad(0) ? v_means : torch::Tensor(),
+            torch::Tensor(), // quats
+            torch::Tensor(), // scales
+            torch::Tensor(), // opacities
+            torch::Tensor(), // viewmat
+            torch::Tensor(), // K
+            ctx->needs_input_grad(6) ? v_sh0 : torch::Tensor(),
+            ctx->needs_input_grad(7) ? v_shN : torch::Tensor(),
+            ctx->needs_input_grad(8) ? v_campos : torch::Tensor(),
+            torch::Tensor(), // settings
+        };
     }
 
     torch::autograd::tensor_list GUTRasterizationFunction::forward(
@@ -279,7 +376,8 @@ namespace gs::training {
         std::optional<torch::Tensor> tangential_coeffs, // [..., C, 2]
         std::optional<torch::Tensor> thin_prism_coeffs, // [..., C, 4]
         torch::Tensor isect_offsets,                    // [C, tile_height, tile_width]
-        torch::Tensor flatten_ids,                      // [nnz]
+        torch::Tensor flatten_ids,                      // [n_isects]
+        std::optional<torch::Tensor> gaussian_ids,      // [nnz], packed colors and opacities
         GUTRasterizationSettings settings,
         UnscentedTransformParameters ut_params) {
         TORCH_CHECK(colors.size(-1) == 3, "Only 3 colors are supported currently.");
@@ -310,7 +408,8 @@ namespace gs::training {
             tangential_coeffs,
             thin_prism_coeffs,
             isect_offsets.contiguous(),
-            flatten_ids.contiguous());
+            flatten_ids.contiguous(),
+            gaussian_ids.has_value() ? std::optional(gaussian_ids->contiguous()) : std::nullopt);
 
         auto render_colors = std::get<0>(results).contiguous();
         auto render_alpha = std::get<1>(results).contiguous();
@@ -321,7 +420,8 @@ namespace gs::training {
                                 radial_coeffs.has_value() ? *radial_coeffs : torch::Tensor(),
                                 tangential_coeffs.has_value() ? *tangential_coeffs : torch::Tensor(),
                                 thin_prism_coeffs.has_value() ? *thin_prism_coeffs : torch::Tensor(),
-                                isect_offsets, flatten_ids, render_alpha, last_ids});
+                                isect_offsets, flatten_ids, render_alpha, last_ids,
+                                gaussian_ids.has_value() ? *gaussian_ids : torch::Tensor()});
 
         return {render_colors, render_alpha};
     }
@@ -354,6 +454,8 @@ namespace gs::training {
         const auto& flatten_ids = saved[13];
         const auto& render_alpha = saved[14];
         const auto& last_ids = saved[15];
+        // an empty packed render still has its (empty) gaussian_ids
+        const std::optional<torch::Tensor> gaussian_ids = saved[16].defined() ? std::optional(saved[16]) : std::nullopt;
 
         // Extract settings
         const int width = ctx->saved_data["width"].toInt();
@@ -369,7 +471,7 @@ namespace gs::training {
             viewmat, std::nullopt, K, camera_model, ut_params, ShutterType::GLOBAL,
             radial_coeffs, tangential_coeffs, thin_prism_coeffs,
             isect_offsets, flatten_ids, render_alpha, last_ids,
-            v_render_colors, v_render_alpha);
+            v_render_colors, v_render_alpha, gaussian_ids);
 
         // Extract gradients
         auto v_means3D = std::get<0>(raster_grads);
@@ -387,6 +489,6 @@ namespace gs::training {
             v_means3D, v_quats, v_scales, v_colors, v_opacities,
             v_bg_color, torch::Tensor(), torch::Tensor(), torch::Tensor(),
             torch::Tensor(), torch::Tensor(), torch::Tensor(),
-            torch::Tensor(), torch::Tensor(), torch::Tensor(), torch::Tensor()};
+            torch::Tensor(), torch::Tensor(), torch::Tensor(), torch::Tensor(), torch::Tensor()};
     }
 } // namespace gs::training
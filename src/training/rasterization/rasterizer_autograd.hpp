@@ -50,7 +50,44 @@ namespace gs::training {
         std::optional<torch::Tensor> tangential_coeffs, // [..., C, 2]
         std::optional<torch::Tensor> thin_prism_coeffs, // [..., C, 4]
         GUTProjectionSettings settings,
-        UnscentedTransformParameters ut_params);
+        UnscentedTransformParameters ut_params,
+        torch::Tensor sh0 = {},    // [N, 1, 3], with shN and campos the outputs gain [C, N, 3] colors
+        torch::Tensor shN = {},    // [N, K-1, 3]
+        torch::Tensor campos = {}, // [C, 3]
+        int sh_degree = 0);
+
+    struct GUTProjectionSHSettings {
+        GUTProjectionSettings projection;
+        UnscentedTransformParameters ut_params;
+        std::optional<torch::Tensor> radial_coeffs;
+        std::optional<torch::Tensor> tangential_coeffs;
+        std::optional<torch::Tensor> thin_prism_coeffs;
+        int sh_degree;
+    };
+
+    // GUT projection that evaluates the SH colors of the Gaussians surviving culling in the same
+    // kernel. The UT projection is not differentiable, only the colors carry gradients: backward
+    // runs the SH vjp straight from sh0 and shN for the projected Gaussians of the one camera.
+    class ProjectionUTSHFunction : public torch::autograd::Function<ProjectionUTSHFunction> {
+    public:
+        // returns radii, means2d, depths, conics, compensations, colors
+        static torch::autograd::tensor_list forward(
+            torch::autograd::AutogradContext* ctx,
+            torch::Tensor means3D,   // [N, 3]
+            torch::Tensor quats,     // [N, 4]
+            torch::Tensor scales,    // [N, 3]
+            torch::Tensor opacities, // [N]
+            torch::Tensor viewmat,   // [1, 4, 4]
+            torch::Tensor K,         // [1, 3, 3]
+            torch::Tensor sh0,       // [N, 1, 3]
+            torch::Tensor shN,       // [N, K-1, 3], any floating point storage
+            torch::Tensor campos,    // [1, 3]
+            GUTProjectionSHSettings settings);
+
+        static torch::autograd::tensor_list backward(
+            torch::autograd::AutogradContext* ctx,
+            torch::autograd::tensor_list grad_outputs);
+    };
 
     struct GUTRasterizationSettings {
         int width;
@@ -78,7 +115,8 @@ namespace gs::training {
             std::optional<torch::Tensor> tangential_coeffs, // [..., C, 2]
             std::optional<torch::Tensor> thin_prism_coeffs, // [..., C, 4]
             torch::Tensor isect_offsets,                    // [C, tile_height, tile_width]
-            torch::Tensor flatten_ids,                      // [nnz]
+            torch::Tensor flatten_ids,                      // [n_isects]
+            std::optional<torch::Tensor> gaussian_ids,      // [nnz], packed colors and opacities
             GUTRasterizationSettings settings,
             UnscentedTransformParameters ut_params);
 
@@ -0,0 +1,75 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "rasterizer_backend.hpp"
+#include "fast_rasterizer.hpp"
+#include <format>
+
+namespace gs::training {
+
+    RasterizerCapabilities FastGSBackend::capabilities() const {
+        return {.orthographic = true, .camera_gradients = true, .tile_skipping = true};
+    }
+
+    RenderOutput FastGSBackend::render(Camera& camera, SplatData& model, torch::Tensor& bg_color, RenderMode,
+                                       const torch::Tensor& pixel_mask) {
+        return fast_rasterize(camera, model, bg_color, context_, !defer_background_, pixel_mask);
+    }
+
+    RasterizerCapabilities GUTBackend::capabilities() const {
+        return {.distortion = true, .fisheye = true, .depth_output = true};
+    }
+
+    RenderOutput GUTBackend::render(Camera& camera, SplatData& model, torch::Tensor& bg_color, RenderMode render_mode,
+                                    const torch::Tensor&) {
+        return rasterize(camera, model, bg_color, 1.0f, packed_, false, render_mode, nullptr);
+    }
+
+    std::vector<std::string> rasterizer_backend_names() {
+        return {"fastgs", "gut"};
+    }
+
+    std::expected<std::unique_ptr<IRasterizerBackend>, std::string> create_rasterizer_backend(
+        std::string_view name,
+        const param::OptimizationParameters& params,
+        fast_gs::rasterization::RasterizerContext* context) {
+        if (name == "fastgs") {
+            // The fused loss composites before slicing the bilateral grid, so it always takes the background
+            return std::make_unique<FastGSBackend>(context, params.fused_loss);
+        }
+        if (name == "gut") {
+            return std::make_unique<GUTBackend>(params.gut_packed);
+        }
+        return std::unexpected(std::format("Unknown rasterizer backend '{}'", name));
+    }
+
+    std::expected<void, std::string> check_camera_supported(const IRasterizerBackend& backend, const Camera& camera) {
+        const RasterizerCapabilities caps = backend.capabilities();
+        const bool distorted = camera.radial_distortion().numel() != 0 || camera.tangential_distortion().numel() != 0;
+        if (distorted && !caps.distortion) {
+            return std::unexpected(std::format(
+                "Distorted images detected, the {} rasterizer can't render them. You can use --gut option to train on cameras with distortion.",
+                backend.name()));
+        }
+        switch (camera.camera_model_type()) {
+        case gsplat::CameraModelType::PINHOLE:
+            return {};
+        case gsplat::CameraModelType::FISHEYE:
+            if (caps.fisheye) {
+                return {};
+            }
+            return std::unexpected(std::format(
+                "The {} rasterizer can't render fisheye cameras. You must use --gut option to train on cameras with non-pinhole model.",
+                backend.name()));
+        case gsplat::CameraModelType::ORTHO:
+            if (caps.orthographic) {
+                return {};
+            }
+            return std::unexpected(std::format(
+                "The {} rasterizer can't render orthographic cameras, train them without --gut.", backend.name()));
+        }
+        return std::unexpected(std::format("Unknown camera model for the {} rasterizer", backend.name()));
+    }
+
+} // namespace gs::training
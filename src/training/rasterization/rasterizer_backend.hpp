@@ -0,0 +1,97 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/camera.hpp"
+#include "core/splat_data.hpp"
+#include "rasterizer.hpp"
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fast_gs::rasterization {
+    struct RasterizerContext;
+}
+
+namespace gs::training {
+
+    // What a backend renders, the trainer checks cameras and options against it
+    struct RasterizerCapabilities {
+        bool distortion = false;       // radial and tangential distortion coefficients
+        bool fisheye = false;          // CameraModelType::FISHEYE
+        bool orthographic = false;     // CameraModelType::ORTHO
+        bool depth_output = false;     // the depth render modes
+        bool camera_gradients = false; // gradients w.r.t. the world-to-camera transform (pose optimization)
+        bool batched_views = false;    // several cameras in one render call
+        bool tile_skipping = false;    // skips the tiles a pixel mask fully excludes
+    };
+
+    // Differentiable rasterizer used by the training renders
+    class IRasterizerBackend {
+    public:
+        virtual ~IRasterizerBackend() = default;
+
+        virtual const char* name() const = 0;
+        virtual RasterizerCapabilities capabilities() const = 0;
+
+        // render_mode is only honoured with depth_output, other backends render RGB. With
+        // tile_skipping, pixels in tiles without a nonzero pixel_mask value are left undefined.
+        virtual RenderOutput render(
+            Camera& camera,
+            SplatData& model,
+            torch::Tensor& bg_color,
+            RenderMode render_mode = RenderMode::RGB,
+            const torch::Tensor& pixel_mask = {}) = 0;
+    };
+
+    // fastgs: pinhole and orthographic cameras without distortion, the fastest to train. With defer_background the
+    // loss composites the background (RenderOutput::background) instead of the render.
+    class FastGSBackend : public IRasterizerBackend {
+    public:
+        explicit FastGSBackend(fast_gs::rasterization::RasterizerContext* context = nullptr,
+                               bool defer_background = false)
+            : context_(context),
+              defer_background_(defer_background) {}
+
+        const char* name() const override { return "fastgs"; }
+        RasterizerCapabilities capabilities() const override;
+        RenderOutput render(Camera& camera, SplatData& model, torch::Tensor& bg_color, RenderMode render_mode,
+                            const torch::Tensor& pixel_mask) override;
+
+    private:
+        fast_gs::rasterization::RasterizerContext* context_;
+        bool defer_background_;
+    };
+
+    // gsplat 3DGUT: distorted pinhole and fisheye cameras through the unscented transform
+    class GUTBackend : public IRasterizerBackend {
+    public:
+        explicit GUTBackend(bool packed = false)
+            : packed_(packed) {}
+
+        const char* name() const override { return "gut"; }
+        RasterizerCapabilities capabilities() const override;
+        RenderOutput render(Camera& camera, SplatData& model, torch::Tensor& bg_color, RenderMode render_mode,
+                            const torch::Tensor& pixel_mask) override;
+
+    private:
+        bool packed_;
+    };
+
+    // Names create_rasterizer_backend accepts
+    std::vector<std::string> rasterizer_backend_names();
+
+    // context is only used by fastgs and must outlive the backend
+    std::expected<std::unique_ptr<IRasterizerBackend>, std::string> create_rasterizer_backend(
+        std::string_view name,
+        const param::OptimizationParameters& params,
+        fast_gs::rasterization::RasterizerContext* context = nullptr);
+
+    // Whether the backend can render the camera, the error names what is missing
+    std::expected<void, std::string> check_camera_supported(const IRasterizerBackend& backend, const Camera& camera);
+
+} // namespace gs::training
@@ -0,0 +1,60 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "spatial_index.hpp"
+#include "kernels/morton_encoding.cuh"
+#include <cmath>
+
+namespace gs::training {
+
+    void SpatialIndex::update(const SplatData& model, const int iter, const bool refined,
+                              fast_gs::rasterization::RasterizerContext& context) {
+        if (refined || model.size() != size() || iter - built_at_ >= REFRESH_EVERY) {
+            rebuild(model);
+            built_at_ = iter;
+        }
+        if (size() == 0) {
+            context.chunk_primitive_indices = nullptr;
+            context.chunk_bounds = nullptr;
+            context.n_indexed_primitives = 0;
+            return;
+        }
+        context.chunk_primitive_indices = reinterpret_cast<const unsigned int*>(primitive_indices_.data_ptr<int32_t>());
+        context.chunk_bounds = reinterpret_cast<const float3*>(chunk_bounds_.data_ptr<float>());
+        context.n_indexed_primitives = static_cast<int>(size());
+    }
+
+    void SpatialIndex::rebuild(const SplatData& model) {
+        torch::NoGradGuard no_grad;
+        constexpr int64_t chunk_size = fast_gs::rasterization::spatial_index_chunk_size;
+        // largest radius preprocess keeps is sqrt(2 ln(255 * opacity)) sigma, taken at opacity 1
+        const float extent_sigmas = std::sqrt(2.0f * std::log(255.0f));
+
+        const auto means = model.means().detach();
+        const int64_t n = means.size(0);
+        if (n == 0) {
+            primitive_indices_ = torch::empty({0}, means.options().dtype(torch::kInt32));
+            chunk_bounds_ = torch::empty({0, 2, 3}, means.options());
+            return;
+        }
+        primitive_indices_ = morton_sort_indices(morton_encode(means.contiguous())).to(torch::kInt32);
+
+        const auto sorted_means = means.index_select(0, primitive_indices_);
+        const auto max_scale = torch::exp(model.scaling_raw().detach().index_select(0, primitive_indices_).amax(1, true));
+        auto box_min = sorted_means - extent_sigmas * max_scale;
+        auto box_max = sorted_means + extent_sigmas * max_scale;
+
+        // the partial last chunk is padded with its last gaussian, which leaves its box unchanged
+        const int64_t n_chunks = (n + chunk_size - 1) / chunk_size;
+        if (const int64_t padding = n_chunks * chunk_size - n; padding > 0) {
+            box_min = torch::cat({box_min, box_min.slice(0, n - 1).expand({padding, 3})});
+            box_max = torch::cat({box_max, box_max.slice(0, n - 1).expand({padding, 3})});
+        }
+        chunk_bounds_ = torch::stack({box_min.view({n_chunks, chunk_size, 3}).amin(1),
+                                      box_max.view({n_chunks, chunk_size, 3}).amax(1)},
+                                     1)
+                            .contiguous();
+    }
+
+} // namespace gs::training
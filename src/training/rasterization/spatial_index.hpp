@@ -0,0 +1,35 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/splat_data.hpp"
+#include "rasterizer_context.h"
+#include <torch/torch.h>
+
+namespace gs::training {
+
+    // Morton-ordered chunks of the model's gaussians with one world-space box per chunk, which lets
+    // the fastgs preprocess skip chunks outside the view frustum. Each box covers the chunk's means
+    // padded by the largest extent preprocess keeps, so culling never drops a visible gaussian while
+    // the index is fresh. Means and scales drift between rebuilds, hence the periodic refresh.
+    class SpatialIndex {
+    public:
+        static constexpr int REFRESH_EVERY = 100;
+
+        // Rebuilds after the strategy refined (densified, pruned or relocated) the gaussians, when the
+        // count changed and every REFRESH_EVERY iterations, then points the context at the index
+        void update(const SplatData& model, int iter, bool refined, fast_gs::rasterization::RasterizerContext& context);
+
+        void rebuild(const SplatData& model);
+
+        int64_t size() const { return primitive_indices_.defined() ? primitive_indices_.size(0) : 0; }
+
+    private:
+        torch::Tensor primitive_indices_; // [N] int32, morton order
+        torch::Tensor chunk_bounds_;      // [n_chunks, 2, 3] box min and max
+        int built_at_ = 0;
+    };
+
+} // namespace gs::training
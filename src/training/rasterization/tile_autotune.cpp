@@ -0,0 +1,175 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "tile_autotune.hpp"
+#include "core/logger.hpp"
+#include "fast_rasterizer.hpp"
+#include "rasterization_api.h"
+#include "rasterizer_context.h"
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
+#include <bit>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <unordered_map>
+
+namespace gs::training {
+
+    namespace {
+        constexpr int WARMUP_RUNS = 2;
+        constexpr int TIMED_RUNS = 5;
+
+        nlohmann::json read_cache(const std::filesystem::path& cache_file) {
+            std::ifstream file(cache_file);
+            if (!file) {
+                return nlohmann::json::object();
+            }
+            try {
+                auto cache = nlohmann::json::parse(file);
+                return cache.is_object() ? cache : nlohmann::json::object();
+            } catch (const std::exception& e) {
+                LOG_WARN("Ignoring unreadable tile shape cache {}: {}", cache_file.string(), e.what());
+                return nlohmann::json::object();
+            }
+        }
+
+        // Average milliseconds of one training-style forward + backward with the given shape
+        float time_tile_shape(Camera& camera, SplatData& model, const fast_gs::rasterization::TileShape shape) {
+            const int width = static_cast<int>(camera.image_width());
+            const int height = static_cast<int>(camera.image_height());
+            auto [fx, fy, cx, cy] = camera.get_intrinsics();
+            constexpr float near_plane = 0.01f;
+            constexpr float far_plane = 1e10f;
+            const int sh_degree = model.get_active_sh_degree();
+            const int active_sh_bases = (sh_degree + 1) * (sh_degree + 1);
+
+            const auto means = model.means().detach();
+            const auto scales_raw = model.scaling_raw().detach();
+            const auto rotations_raw = model.rotation_raw().detach();
+            const auto opacities_raw = model.opacity_raw().detach();
+            const auto sh0 = model.sh0().detach();
+            const auto shN = model.shN().detach();
+            const auto w2c = camera.world_view_transform().detach();
+            const auto cam_position = camera.cam_position();
+            const auto projection = fast_projection(camera);
+
+            // a context of its own keeps the training context's upper-bound state and arenas untouched
+            fast_gs::rasterization::RasterizerContext context;
+            context.tile_shape = shape;
+            torch::Tensor no_densification_info = torch::empty({0}, means.options());
+            torch::Tensor no_max_contribution = torch::empty({0}, means.options());
+
+            auto run = [&] {
+                auto [image, alpha, depth, per_primitive, per_tile, per_instance, per_bucket,
+                      n_visible_primitives, n_instances, n_buckets, primitive_selector, instance_selector, replay_chunk] =
+                    fast_gs::rasterization::forward_wrapper(
+                        means, scales_raw, rotations_raw, opacities_raw, sh0, shN, w2c, cam_position,
+                        active_sh_bases, width, height, fx, fy, cx, cy, near_plane, far_plane, projection, &context);
+                fast_gs::rasterization::backward_wrapper(
+                    no_densification_info, no_max_contribution, torch::ones_like(image), torch::zeros_like(alpha), image, alpha,
+                    means, scales_raw, rotations_raw, shN,
+                    per_primitive, per_tile, per_instance, per_bucket, w2c, cam_position,
+                    active_sh_bases, width, height, fx, fy, cx, cy, near_plane, far_plane, projection,
+                    n_visible_primitives, n_instances, n_buckets, primitive_selector, instance_selector, shape, replay_chunk);
+            };
+
+            for (int i = 0; i < WARMUP_RUNS; ++i) {
+                run();
+            }
+            at::cuda::CUDAEvent start(cudaEventDefault);
+            at::cuda::CUDAEvent end(cudaEventDefault);
+            const auto stream = at::cuda::getCurrentCUDAStream();
+            start.record(stream);
+            for (int i = 0; i < TIMED_RUNS; ++i) {
+                run();
+            }
+            end.record(stream);
+            end.synchronize();
+            return start.elapsed_time(end) / TIMED_RUNS;
+        }
+    } // namespace
+
+    std::string tile_shape_bucket(const Camera& camera, const SplatData& model) {
+        const auto gaussians = static_cast<uint64_t>(std::max<int64_t>(model.size(), 1));
+        return std::format("{}x{}/2^{}", camera.image_width(), camera.image_height(), std::bit_width(gaussians) - 1);
+    }
+
+    std::filesystem::path default_tile_shape_cache() {
+        const char* home = std::getenv("HOME");
+        return std::filesystem::path(home ? home : "") / ".cache" / "LichtFeld-Studio" / "tile_shapes.json";
+    }
+
+    fast_gs::rasterization::TileShape autotune_tile_shape(
+        Camera& camera,
+        SplatData& model,
+        const std::filesystem::path& cache_file) {
+        using fast_gs::rasterization::TileShape;
+        const int width = static_cast<int>(camera.image_width());
+        const int height = static_cast<int>(camera.image_height());
+
+        cudaDeviceProp properties;
+        cudaGetDeviceProperties(&properties, at::cuda::current_device());
+        const std::string key = std::format("{}/{}", properties.name, tile_shape_bucket(camera, model));
+
+        // Mixed-resolution datasets switch buckets all the time, only the first visit reads the file
+        static std::mutex memo_mutex;
+        static std::unordered_map<std::string, TileShape> memo;
+        {
+            std::lock_guard lock(memo_mutex);
+            if (const auto it = memo.find(key); it != memo.end()) {
+                return it->second;
+            }
+        }
+
+        nlohmann::json cache = read_cache(cache_file);
+        if (cache.contains(key) && cache[key].is_string()) {
+            TileShape cached;
+            if (fast_gs::rasterization::tile_shape_from_name(cache[key].get<std::string>(), cached)) {
+                LOG_INFO("Tile shape {} for {} (cached)", fast_gs::rasterization::tile_shape_name(cached), key);
+                std::lock_guard lock(memo_mutex);
+                memo[key] = cached;
+                return cached;
+            }
+        }
+
+        torch::NoGradGuard no_grad;
+        TileShape best = fast_gs::rasterization::default_tile_shape;
+        float best_ms = std::numeric_limits<float>::infinity();
+        for (const TileShape shape : fast_gs::rasterization::all_tile_shapes) {
+            if (!fast_gs::rasterization::tile_shape_fits(shape, width, height)) {
+                continue;
+            }
+            const float ms = time_tile_shape(camera, model, shape);
+            LOG_DEBUG("Tile shape {}: {:.3f} ms per forward + backward", fast_gs::rasterization::tile_shape_name(shape), ms);
+            if (ms < best_ms) {
+                best_ms = ms;
+                best = shape;
+            }
+        }
+        LOG_INFO("Tile shape {} for {} ({:.3f} ms per forward + backward)",
+                 fast_gs::rasterization::tile_shape_name(best), key, best_ms);
+        {
+            std::lock_guard lock(memo_mutex);
+            memo[key] = best;
+        }
+
+        try {
+            std::filesystem::create_directories(cache_file.parent_path());
+            cache[key] = fast_gs::rasterization::tile_shape_name(best);
+            std::ofstream file(cache_file);
+            file << cache.dump(2);
+            if (!file) {
+                LOG_WARN("Failed to write tile shape cache {}", cache_file.string());
+            }
+        } catch (const std::exception& e) {
+            LOG_WARN("Failed to write tile shape cache {}: {}", cache_file.string(), e.what());
+        }
+        return best;
+    }
+
+} // namespace gs::training
@@ -0,0 +1,30 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/camera.hpp"
+#include "core/splat_data.hpp"
+#include "tile_config.h"
+#include <filesystem>
+#include <string>
+
+namespace gs::training {
+
+    // $HOME/.cache/LichtFeld-Studio/tile_shapes.json
+    std::filesystem::path default_tile_shape_cache();
+
+    // Resolution and power-of-two Gaussian count a tuned shape stays valid for, e.g. "1920x1080/2^20"
+    std::string tile_shape_bucket(const Camera& camera, const SplatData& model);
+
+    // Times forward + backward of every compiled tile shape that fits the camera's resolution and
+    // returns the fastest. The choice is cached per GPU name and tile_shape_bucket() in cache_file and
+    // in memory, so each device benchmarks a bucket once. Runs the raw rasterizer, the model's
+    // gradients are untouched.
+    fast_gs::rasterization::TileShape autotune_tile_shape(
+        Camera& camera,
+        SplatData& model,
+        const std::filesystem::path& cache_file = default_tile_shape_cache());
+
+} // namespace gs::training
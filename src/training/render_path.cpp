@@ -0,0 +1,369 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "render_path.hpp"
+#include "core/camera.hpp"
+#include "core/logger.hpp"
+#include "core/splat_data.hpp"
+#include "dataset.hpp"
+#include "loader/loader.hpp"
+#include "rasterization/fast_rasterizer.hpp"
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
+#include <algorithm>
+#include <array>
+#include <c10/cuda/CUDAGuard.h>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <format>
+#include <fstream>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <csignal>
+#endif
+
+namespace gs::training {
+
+    namespace {
+
+        constexpr float DEFAULT_FOV = 50.f;
+
+        struct Keyframe {
+            glm::vec3 position;
+            glm::quat rotation; // Camera-to-world, x right, y down, z forward
+            float fov;          // Vertical, degrees
+            float time;         // Seconds
+        };
+
+        glm::vec3 read_vec3(const nlohmann::json& j) {
+            return {j.at(0).get<float>(), j.at(1).get<float>(), j.at(2).get<float>()};
+        }
+
+        std::expected<std::vector<Keyframe>, std::string> read_keyframe_file(const std::filesystem::path& path,
+                                                                             float keyframe_seconds) {
+            std::ifstream file(path);
+            if (!file) {
+                return std::unexpected(std::format("Failed to open {}", path.string()));
+            }
+            std::vector<Keyframe> keyframes;
+            try {
+                const auto j = nlohmann::json::parse(file);
+                for (const auto& key : j.at("keyframes")) {
+                    Keyframe keyframe;
+                    keyframe.position = read_vec3(key.at("position"));
+                    if (key.contains("look_at")) {
+                        const glm::vec3 up = key.contains("up") ? read_vec3(key["up"]) : glm::vec3(0.f, -1.f, 0.f);
+                        keyframe.rotation = look_rotation(keyframe.position, read_vec3(key["look_at"]), up);
+                    } else {
+                        const auto& q = key.at("rotation");
+                        keyframe.rotation = glm::normalize(glm::quat(q.at(0).get<float>(), q.at(1).get<float>(),
+                                                                     q.at(2).get<float>(), q.at(3).get<float>()));
+                    }
+                    keyframe.fov = key.value("fov", DEFAULT_FOV);
+                    keyframe.time = key.value("time", keyframes.empty() ? 0.f : keyframes.back().time + keyframe_seconds);
+                    keyframes.push_back(keyframe);
+                }
+            } catch (const std::exception& e) {
+                return std::unexpected(std::format("Invalid camera path {}: {}", path.string(), e.what()));
+            }
+            for (size_t i = 1; i < keyframes.size(); ++i) {
+                if (keyframes[i].time <= keyframes[i - 1].time) {
+                    return std::unexpected(std::format("Keyframe {} of {} is not later than the one before", i, path.string()));
+                }
+            }
+            return keyframes;
+        }
+
+        std::expected<std::vector<Keyframe>, std::string> read_dataset_keyframes(const std::filesystem::path& path,
+                                                                                 int stride,
+                                                                                 float keyframe_seconds) {
+            auto result = loader::Loader::create()->load(path);
+            if (!result) {
+                return std::unexpected(result.error());
+            }
+            const auto* scene = std::get_if<loader::LoadedScene>(&result->data);
+            if (!scene || !scene->cameras) {
+                return std::unexpected(std::format("{} is not a dataset", path.string()));
+            }
+
+            auto cameras = scene->cameras->get_cameras();
+            std::sort(cameras.begin(), cameras.end(), [](const auto& a, const auto& b) {
+                return a->image_name() < b->image_name();
+            });
+
+            std::vector<Keyframe> keyframes;
+            for (size_t i = 0; i < cameras.size(); i += stride) {
+                const auto& cam = *cameras[i];
+                const auto R_cpu = cam.R().cpu();
+                const auto T_cpu = cam.T().cpu();
+                const auto R = R_cpu.accessor<float, 2>();
+                const auto T = T_cpu.accessor<float, 1>();
+                glm::mat3 cam_to_world;
+                for (int r = 0; r < 3; ++r) {
+                    for (int c = 0; c < 3; ++c) {
+                        cam_to_world[r][c] = R[r][c]; // Transposed, glm is column-major
+                    }
+                }
+                keyframes.push_back({.position = -cam_to_world * glm::vec3(T[0], T[1], T[2]),
+                                     .rotation = glm::normalize(glm::quat_cast(cam_to_world)),
+                                     .fov = glm::degrees(2.f * std::atan(cam.camera_height() / (2.f * cam.focal_y()))),
+                                     .time = static_cast<float>(keyframes.size()) * keyframe_seconds});
+            }
+            return keyframes;
+        }
+
+        Keyframe sample_path(const std::vector<Keyframe>& keyframes, float time) {
+            const auto next = std::upper_bound(keyframes.begin(), keyframes.end(), time,
+                                               [](float t, const Keyframe& key) { return t < key.time; });
+            const size_t i1 = std::clamp<size_t>(next - keyframes.begin(), 1, keyframes.size() - 1);
+            const size_t i0 = i1 - 1;
+            const Keyframe& a = keyframes[i0];
+            const Keyframe& b = keyframes[i1];
+            const float t = std::clamp((time - a.time) / (b.time - a.time), 0.f, 1.f);
+
+            // Uniform Catmull-Rom, the end segments mirror their missing neighbour
+            const glm::vec3 p0 = i0 > 0 ? keyframes[i0 - 1].position : 2.f * a.position - b.position;
+            const glm::vec3 p3 = i1 + 1 < keyframes.size() ? keyframes[i1 + 1].position : 2.f * b.position - a.position;
+            const glm::vec3 position = 0.5f * (2.f * a.position + (b.position - p0) * t +
+                                               (2.f * p0 - 5.f * a.position + 4.f * b.position - p3) * t * t +
+                                               (3.f * a.position - p0 - 3.f * b.position + p3) * t * t * t);
+            return {.position = position,
+                    .rotation = glm::slerp(a.rotation, b.rotation, t),
+                    .fov = a.fov + (b.fov - a.fov) * t,
+                    .time = time};
+        }
+
+        // Feeds rendered frames to the encoder process from a thread of its own. Each frame is
+        // copied into a free pinned buffer on the render stream; the thread waits for the copy
+        // and writes it while the next frame renders.
+        class FrameWriter {
+        public:
+            FrameWriter(std::FILE* pipe, int width, int height)
+                : pipe_(pipe) {
+                for (auto& slot : slots_) {
+                    slot.host = torch::empty({height, width, 3}, torch::TensorOptions().dtype(torch::kUInt8).pinned_memory(true));
+                }
+                thread_ = std::thread([this] { run(); });
+            }
+
+            ~FrameWriter() { (void)finish(); }
+
+            FrameWriter(const FrameWriter&) = delete;
+            FrameWriter& operator=(const FrameWriter&) = delete;
+
+            // rgb: [H, W, 3] uint8 CUDA. Blocks only while both buffers are still being written.
+            bool submit(const torch::Tensor& rgb) {
+                Slot& slot = slots_[next_];
+                {
+                    std::unique_lock lock(mutex_);
+                    cv_.wait(lock, [&] { return !slot.busy || failed_; });
+                    if (failed_) {
+                        return false;
+                    }
+                }
+                slot.host.copy_(rgb, /*non_blocking=*/true);
+                slot.copied.record(at::cuda::getCurrentCUDAStream());
+                {
+                    std::lock_guard lock(mutex_);
+                    slot.busy = true;
+                    queue_.push_back(next_);
+                }
+                cv_.notify_all();
+                next_ = (next_ + 1) % static_cast<int>(slots_.size());
+                return true;
+            }
+
+            // Writes the queued frames and waits for the encoder to exit
+            std::expected<void, std::string> finish() {
+                if (!pipe_) {
+                    return {};
+                }
+                {
+                    std::lock_guard lock(mutex_);
+                    closing_ = true;
+                }
+                cv_.notify_all();
+                thread_.join();
+#ifdef _WIN32
+                const int status = _pclose(pipe_);
+#else
+                const int status = pclose(pipe_);
+#endif
+                pipe_ = nullptr;
+                if (failed_) {
+                    return std::unexpected("The encoder stopped accepting frames");
+                }
+                if (status != 0) {
+                    return std::unexpected(std::format("The encoder exited with status {}", status));
+                }
+                return {};
+            }
+
+        private:
+            struct Slot {
+                torch::Tensor host;
+                at::cuda::CUDAEvent copied;
+                bool busy = false; // Queued or being written
+            };
+
+            void run() {
+                for (;;) {
+                    int index;
+                    {
+                        std::unique_lock lock(mutex_);
+                        cv_.wait(lock, [&] { return !queue_.empty() || closing_; });
+                        if (queue_.empty()) {
+                            return;
+                        }
+                        index = queue_.front();
+                        queue_.pop_front();
+                    }
+                    Slot& slot = slots_[index];
+                    slot.copied.synchronize();
+                    const size_t bytes = static_cast<size_t>(slot.host.numel());
+                    const bool written = std::fwrite(slot.host.data_ptr(), 1, bytes, pipe_) == bytes;
+                    {
+                        std::lock_guard lock(mutex_);
+                        slot.busy = false;
+                        failed_ = failed_ || !written;
+                    }
+                    cv_.notify_all();
+                    if (!written) {
+                        return;
+                    }
+                }
+            }
+
+            std::FILE* pipe_;
+            std::array<Slot, 2> slots_;
+            int next_ = 0;
+            std::deque<int> queue_;
+            std::mutex mutex_;
+            std::condition_variable cv_;
+            bool closing_ = false;
+            bool failed_ = false;
+            std::thread thread_;
+        };
+
+    } // namespace
+
+    glm::quat look_rotation(const glm::vec3& position, const glm::vec3& target, const glm::vec3& up) {
+        const glm::vec3 forward = glm::normalize(target - position);
+        const glm::vec3 right = glm::normalize(glm::cross(-up, forward));
+        return glm::quat_cast(glm::mat3(right, glm::cross(forward, right), forward));
+    }
+
+    Camera make_pose_camera(const glm::vec3& position, const glm::quat& rotation, float fov,
+                            int width, int height, int uid) {
+        const glm::mat3 cam_to_world = glm::mat3_cast(rotation);
+        const glm::vec3 t = -glm::transpose(cam_to_world) * position;
+        auto R = torch::empty({3, 3}, torch::kFloat32);
+        auto T = torch::empty({3}, torch::kFloat32);
+        auto R_acc = R.accessor<float, 2>();
+        auto T_acc = T.accessor<float, 1>();
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                R_acc[r][c] = cam_to_world[r][c]; // World-to-camera is the transpose
+            }
+            T_acc[r] = t[r];
+        }
+        const float focal = height / (2.f * std::tan(glm::radians(fov) * 0.5f));
+        return Camera(R, T, focal, focal, width / 2.f, height / 2.f,
+                      torch::empty({0}, torch::kFloat32), torch::empty({0}, torch::kFloat32),
+                      gsplat::CameraModelType::PINHOLE, std::format("frame_{:06d}", uid), "none",
+                      width, height, uid);
+    }
+
+    std::expected<void, std::string> render_camera_path(const param::RenderPathParameters& params) {
+        auto keyframes = std::filesystem::is_directory(params.path)
+                             ? read_dataset_keyframes(params.path, params.camera_stride, params.keyframe_seconds)
+                             : read_keyframe_file(params.path, params.keyframe_seconds);
+        if (!keyframes) {
+            return std::unexpected(keyframes.error());
+        }
+        if (keyframes->size() < 2) {
+            return std::unexpected(std::format("{} has fewer than two keyframes", params.path.string()));
+        }
+
+        auto loaded = loader::Loader::create()->load(params.model);
+        if (!loaded) {
+            return std::unexpected(loaded.error());
+        }
+        auto* splat = std::get_if<std::shared_ptr<SplatData>>(&loaded->data);
+        if (!splat || !*splat) {
+            return std::unexpected(std::format("{} is not a splat file", params.model.string()));
+        }
+        SplatData& model = **splat;
+        model.set_active_sh_degree(model.get_max_sh_degree());
+
+        std::error_code ec;
+        std::filesystem::create_directories(params.output.parent_path(), ec);
+        if (ec) {
+            return std::unexpected(std::format("Failed to create {}: {}", params.output.parent_path().string(), ec.message()));
+        }
+
+        const float duration = keyframes->back().time - keyframes->front().time;
+        const int num_frames = static_cast<int>(std::floor(duration * params.fps)) + 1;
+        const auto command = std::format(
+            "ffmpeg -y -loglevel error -f rawvideo -pix_fmt rgb24 -s {}x{} -r {} -i - -c:v {} -pix_fmt yuv420p \"{}\"",
+            params.width, params.height, params.fps, params.codec, params.output.string());
+#ifdef _WIN32
+        std::FILE* pipe = _popen(command.c_str(), "wb");
+#else
+        // A failing encoder shows up as a short write instead of killing the process
+        std::signal(SIGPIPE, SIG_IGN);
+        std::FILE* pipe = popen(command.c_str(), "w");
+#endif
+        if (!pipe) {
+            return std::unexpected(std::format("Failed to start the encoder: {}", command));
+        }
+
+        LOG_INFO("Rendering {} frames at {}x{} to {}", num_frames, params.width, params.height, params.output.string());
+        const auto start = std::chrono::steady_clock::now();
+
+        c10::cuda::CUDAStreamGuard stream_guard(at::cuda::getStreamFromPool(false));
+        torch::NoGradGuard no_grad;
+        fast_gs::rasterization::RasterizerContext context(/*upper_bound_allocation=*/true);
+        context.load_balanced_blend = true;
+        const auto background = torch::tensor({params.background[0], params.background[1], params.background[2]},
+                                               torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA));
+
+        FrameWriter writer(pipe, params.width, params.height);
+        for (int frame = 0; frame < num_frames; ++frame) {
+            torch::Tensor rgb;
+            try {
+                const float time = keyframes->front().time + static_cast<float>(frame) / params.fps;
+                const Keyframe pose = sample_path(*keyframes, time);
+                auto camera = make_pose_camera(pose.position, pose.rotation, pose.fov, params.width, params.height, frame);
+                const auto output = fast_render(camera, model, background, &context);
+                rgb = output.image.clamp(0.f, 1.f).mul(255.f).add_(0.5f).to(torch::kUInt8).permute({1, 2, 0}).contiguous();
+            } catch (const std::exception& e) {
+                (void)writer.finish();
+                return std::unexpected(std::format("Rendering frame {} failed: {}", frame, e.what()));
+            }
+            if (!writer.submit(rgb)) {
+                break;
+            }
+            if ((frame + 1) % 100 == 0) {
+                LOG_DEBUG("Rendered {}/{} frames", frame + 1, num_frames);
+            }
+        }
+        if (auto finished = writer.finish(); !finished) {
+            return std::unexpected(finished.error());
+        }
+
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        LOG_INFO("Wrote {} in {:.1f}s ({:.1f} fps)", params.output.string(), elapsed, num_frames / elapsed);
+        return {};
+    }
+
+} // namespace gs::training
@@ -0,0 +1,39 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/camera.hpp"
+#include "core/parameters.hpp"
+#include <expected>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <string>
+
+namespace gs::training {
+
+    // Renders a fly-through of a splat file into a video without the viewer. The path is either a
+    // keyframe JSON or a dataset directory whose cameras, sorted by image name, are the keyframes:
+    //
+    //   {"keyframes": [{"position": [x, y, z],
+    //                   "look_at": [x, y, z], "up": [x, y, z]    or "rotation": [w, x, y, z],
+    //                   "fov": 50, "time": 0.0}, ...]}
+    //
+    // rotation is camera-to-world with x right, y down and z forward, up defaults to -y and fov
+    // is vertical in degrees (default 50). Positions follow a Catmull-Rom spline through the
+    // keyframes, rotations are slerped.
+    //
+    // Frames are rendered with the inference fastgs forward on their own stream and copied into
+    // two pinned buffers that an FFmpeg process (NVENC by default) is fed from on another thread,
+    // so rendering the next frame overlaps encoding the previous one.
+    std::expected<void, std::string> render_camera_path(const param::RenderPathParameters& params);
+
+    // Camera-to-world rotation of a camera at position looking at target, in the convention above
+    glm::quat look_rotation(const glm::vec3& position, const glm::vec3& target, const glm::vec3& up);
+
+    // Pinhole camera with the principal point at the center and a vertical fov in degrees
+    Camera make_pose_camera(const glm::vec3& position, const glm::quat& rotation, float fov,
+                            int width, int height, int uid);
+
+} // namespace gs::training
@@ -0,0 +1,448 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "render_server.hpp"
+#include "core/logger.hpp"
+#include "core/splat_data.hpp"
+#include "loader/loader.hpp"
+#include "rasterization/fast_rasterizer.hpp"
+#include "render_path.hpp"
+#include <ATen/cuda/CUDAContext.h>
+#include <algorithm>
+#include <atomic>
+#include <c10/cuda/CUDAGuard.h>
+#include <chrono>
+#include <condition_variable>
+#include <format>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace gs::training {
+
+#ifndef _WIN32
+    namespace {
+
+        constexpr float DEFAULT_FOV = 50.f;
+        constexpr int MAX_FRAME_SIZE = 4096;
+        constexpr size_t MAX_LINE_BYTES = 64 * 1024;
+
+        std::atomic<bool> stop_requested{false};
+
+        struct Pose {
+            glm::vec3 position;
+            glm::quat rotation; // Camera-to-world, x right, y down, z forward
+            float fov;          // Vertical, degrees
+        };
+
+        glm::vec3 read_vec3(const nlohmann::json& j) {
+            return {j.at(0).get<float>(), j.at(1).get<float>(), j.at(2).get<float>()};
+        }
+
+        // Throws on malformed input
+        Pose parse_pose(const std::string& line) {
+            const auto j = nlohmann::json::parse(line);
+            Pose pose;
+            pose.position = read_vec3(j.at("position"));
+            if (j.contains("look_at")) {
+                const glm::vec3 up = j.contains("up") ? read_vec3(j["up"]) : glm::vec3(0.f, -1.f, 0.f);
+                pose.rotation = look_rotation(pose.position, read_vec3(j["look_at"]), up);
+            } else {
+                const auto& q = j.at("rotation");
+                pose.rotation = glm::normalize(glm::quat(q.at(0).get<float>(), q.at(1).get<float>(),
+                                                         q.at(2).get<float>(), q.at(3).get<float>()));
+            }
+            pose.fov = j.value("fov", DEFAULT_FOV);
+            return pose;
+        }
+
+        bool write_all(int fd, const void* data, size_t size, bool is_socket) {
+            const auto* bytes = static_cast<const char*>(data);
+            while (size > 0) {
+                // MSG_NOSIGNAL: a client that went away fails the send instead of raising SIGPIPE
+                const ssize_t written = is_socket ? send(fd, bytes, size, MSG_NOSIGNAL) : write(fd, bytes, size);
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return false;
+                }
+                bytes += written;
+                size -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+
+        // Newline-delimited messages of a socket
+        class LineReader {
+        public:
+            explicit LineReader(int fd)
+                : fd_(fd) {}
+
+            // False once the peer closed the connection or sent an overlong line
+            bool next(std::string& line) {
+                for (;;) {
+                    if (const auto end = buffer_.find('\n'); end != std::string::npos) {
+                        line = buffer_.substr(0, end);
+                        buffer_.erase(0, end + 1);
+                        return true;
+                    }
+                    if (buffer_.size() > MAX_LINE_BYTES) {
+                        return false;
+                    }
+                    char chunk[4096];
+                    const ssize_t received = recv(fd_, chunk, sizeof(chunk), 0);
+                    if (received < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    if (received <= 0) {
+                        return false;
+                    }
+                    buffer_.append(chunk, static_cast<size_t>(received));
+                }
+            }
+
+        private:
+            int fd_;
+            std::string buffer_;
+        };
+
+        // FFmpeg child reading raw RGB frames on input and writing the encoded stream to output
+        struct Encoder {
+            pid_t pid = -1;
+            int input = -1;
+            int output = -1;
+        };
+
+        std::expected<Encoder, std::string> start_encoder(const std::string& codec, int width, int height, float fps) {
+            std::vector<std::string> args = {"ffmpeg", "-loglevel", "error",
+                                             "-f", "rawvideo", "-pix_fmt", "rgb24",
+                                             "-s", std::format("{}x{}", width, height), "-r", std::format("{}", fps),
+                                             "-i", "-", "-c:v", codec};
+            // Every frame leaves the encoder as soon as it is encoded: no lookahead, no B-frames
+            if (codec.ends_with("_nvenc")) {
+                args.insert(args.end(), {"-preset", "p1", "-tune", "ull", "-zerolatency", "1", "-delay", "0"});
+            } else if (codec == "libx264" || codec == "libx265") {
+                args.insert(args.end(), {"-preset", "ultrafast", "-tune", "zerolatency"});
+            }
+            const bool hevc = codec.starts_with("hevc") || codec == "libx265";
+            args.insert(args.end(), {"-bf", "0", "-g", std::format("{}", std::max(1, static_cast<int>(fps * 2.f))),
+                                     "-pix_fmt", "yuv420p", "-flush_packets", "1",
+                                     "-f", hevc ? "hevc" : "h264", "-"});
+
+            // Close-on-exec, so the encoders of other sessions do not hold these pipes open
+            int input[2];
+            int output[2];
+            if (pipe2(input, O_CLOEXEC) != 0) {
+                return std::unexpected(std::format("Failed to create the encoder pipe: {}", std::strerror(errno)));
+            }
+            if (pipe2(output, O_CLOEXEC) != 0) {
+                const int error = errno;
+                close(input[0]);
+                close(input[1]);
+                return std::unexpected(std::format("Failed to create the encoder pipe: {}", std::strerror(error)));
+            }
+
+            posix_spawn_file_actions_t actions;
+            posix_spawn_file_actions_init(&actions);
+            posix_spawn_file_actions_adddup2(&actions, input[0], STDIN_FILENO);
+            posix_spawn_file_actions_adddup2(&actions, output[1], STDOUT_FILENO);
+            std::vector<char*> argv;
+            for (auto& arg : args) {
+                argv.push_back(arg.data());
+            }
+            argv.push_back(nullptr);
+            pid_t pid = -1;
+            const int error = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+            posix_spawn_file_actions_destroy(&actions);
+            close(input[0]);
+            close(output[1]);
+            if (error != 0) {
+                close(input[1]);
+                close(output[0]);
+                return std::unexpected(std::format("Failed to start ffmpeg: {}", std::strerror(error)));
+            }
+            return Encoder{.pid = pid, .input = input[1], .output = output[0]};
+        }
+
+        // One client: a thread reading its poses, this session's render loop feeding the encoder
+        // and a thread forwarding the encoded stream back
+        class Session {
+        public:
+            Session(int socket, std::string peer, const SplatData& model, const param::RenderServerParameters& params)
+                : socket_(socket),
+                  peer_(std::move(peer)),
+                  model_(model),
+                  params_(params),
+                  thread_([this] { run(); }) {}
+
+            ~Session() {
+                // Wakes the pose reader, the render loop then sees the disconnect
+                shutdown(socket_, SHUT_RDWR);
+                thread_.join();
+                close(socket_);
+            }
+
+            Session(const Session&) = delete;
+            Session& operator=(const Session&) = delete;
+
+            bool finished() const { return finished_.load(); }
+
+        private:
+            void run() {
+                if (auto served = serve(); !served) {
+                    LOG_WARN("Render session {} ended: {}", peer_, served.error());
+                } else {
+                    LOG_INFO("Render session {} closed", peer_);
+                }
+                finished_ = true;
+            }
+
+            std::expected<void, std::string> serve() {
+                LineReader reader(socket_);
+                std::string line;
+                if (!reader.next(line)) {
+                    return std::unexpected("Disconnected before the session header");
+                }
+                int width = 0;
+                int height = 0;
+                float fps = 30.f;
+                try {
+                    const auto header = nlohmann::json::parse(line);
+                    width = header.at("width").get<int>();
+                    height = header.at("height").get<int>();
+                    fps = header.value("fps", fps);
+                } catch (const std::exception& e) {
+                    return std::unexpected(std::format("Invalid session header: {}", e.what()));
+                }
+                // 4:2:0 chroma needs even dimensions
+                if (width < 2 || height < 2 || width > MAX_FRAME_SIZE || height > MAX_FRAME_SIZE ||
+                    width % 2 != 0 || height % 2 != 0 || fps <= 0.f) {
+                    return std::unexpected(std::format("Unsupported stream {}x{} at {} fps", width, height, fps));
+                }
+
+                auto encoder = start_encoder(params_.codec, width, height, fps);
+                if (!encoder) {
+                    return std::unexpected(encoder.error());
+                }
+                LOG_INFO("Render session {}: {}x{} with {}", peer_, width, height, params_.codec);
+
+                std::thread forwarder([&] {
+                    char chunk[64 * 1024];
+                    for (;;) {
+                        const ssize_t n = read(encoder->output, chunk, sizeof(chunk));
+                        if (n < 0 && errno == EINTR) {
+                            continue;
+                        }
+                        if (n <= 0 || !write_all(socket_, chunk, static_cast<size_t>(n), /*is_socket=*/true)) {
+                            break;
+                        }
+                    }
+                    // Encoder gone or client gone, either way the pose reader can stop
+                    shutdown(socket_, SHUT_RDWR);
+                });
+
+                std::mutex mutex;
+                std::condition_variable cv;
+                std::optional<Pose> pending;
+                bool disconnected = false;
+                std::thread poses([&] {
+                    std::string pose_line;
+                    while (reader.next(pose_line)) {
+                        if (pose_line.empty()) {
+                            continue;
+                        }
+                        Pose pose;
+                        try {
+                            pose = parse_pose(pose_line);
+                        } catch (const std::exception& e) {
+                            LOG_WARN("Render session {}: ignoring an invalid pose: {}", peer_, e.what());
+                            continue;
+                        }
+                        {
+                            std::lock_guard lock(mutex);
+                            pending = pose; // Replaces a pose that was not rendered yet
+                        }
+                        cv.notify_one();
+                    }
+                    {
+                        std::lock_guard lock(mutex);
+                        disconnected = true;
+                    }
+                    cv.notify_one();
+                });
+
+                std::expected<void, std::string> result;
+                {
+                    c10::cuda::CUDAStreamGuard stream_guard(at::cuda::getStreamFromPool(false));
+                    torch::NoGradGuard no_grad;
+                    fast_gs::rasterization::RasterizerContext context(/*upper_bound_allocation=*/true);
+                    context.load_balanced_blend = true;
+                    const auto background = torch::tensor({params_.background[0], params_.background[1], params_.background[2]},
+                                                           torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA));
+                    auto host = torch::empty({height, width, 3}, torch::TensorOptions().dtype(torch::kUInt8).pinned_memory(true));
+
+                    for (int frame = 0;; ++frame) {
+                        Pose pose;
+                        {
+                            std::unique_lock lock(mutex);
+                            // Polled, the interrupt handler cannot notify
+                            while (!pending && !disconnected && !stop_requested.load()) {
+                                cv.wait_for(lock, std::chrono::milliseconds(200));
+                            }
+                            if (!pending || stop_requested.load()) {
+                                break;
+                            }
+                            pose = *pending;
+                            pending.reset();
+                        }
+                        try {
+                            auto camera = make_pose_camera(pose.position, pose.rotation, pose.fov, width, height, frame);
+                            const auto output = fast_render(camera, model_, background, &context);
+                            host.copy_(output.image.clamp(0.f, 1.f).mul(255.f).add_(0.5f).to(torch::kUInt8).permute({1, 2, 0}),
+                                       /*non_blocking=*/true);
+                            at::cuda::getCurrentCUDAStream().synchronize();
+                        } catch (const std::exception& e) {
+                            result = std::unexpected(std::format("Rendering frame {} failed: {}", frame, e.what()));
+                            break;
+                        }
+                        if (!write_all(encoder->input, host.data_ptr(), static_cast<size_t>(host.numel()), /*is_socket=*/false)) {
+                            result = std::unexpected("The encoder stopped accepting frames");
+                            break;
+                        }
+                    }
+                }
+
+                // The encoder flushes and exits on the end of its input, which ends the forwarder
+                close(encoder->input);
+                forwarder.join();
+                poses.join();
+                close(encoder->output);
+                int status = 0;
+                waitpid(encoder->pid, &status, 0);
+                return result;
+            }
+
+            int socket_;
+            std::string peer_;
+            const SplatData& model_;
+            const param::RenderServerParameters& params_;
+            std::atomic<bool> finished_{false};
+            std::thread thread_;
+        };
+
+    } // namespace
+#endif
+
+    std::expected<void, std::string> run_render_server(const param::RenderServerParameters& params) {
+#ifdef _WIN32
+        (void)params;
+        return std::unexpected("The render server needs POSIX sockets and is not available on Windows");
+#else
+        auto loaded = loader::Loader::create()->load(params.model);
+        if (!loaded) {
+            return std::unexpected(loaded.error());
+        }
+        auto* splat = std::get_if<std::shared_ptr<SplatData>>(&loaded->data);
+        if (!splat || !*splat) {
+            return std::unexpected(std::format("{} is not a splat file", params.model.string()));
+        }
+        SplatData& model = **splat;
+        model.set_active_sh_degree(model.get_max_sh_degree());
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(params.port));
+        if (inet_pton(AF_INET, params.bind_address.c_str(), &address.sin_addr) != 1) {
+            return std::unexpected(std::format("Invalid render server bind address '{}'", params.bind_address));
+        }
+        // Anyone who reaches the port can render the model and drive the sessions
+        if ((ntohl(address.sin_addr.s_addr) >> 24) != 127) {
+            LOG_WARN("The render server listens on {}, reachable beyond this machine without authentication",
+                     params.bind_address);
+        }
+
+        const int listener = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listener < 0) {
+            return std::unexpected(std::format("Failed to create the server socket: {}", std::strerror(errno)));
+        }
+        const int reuse = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listener, SOMAXCONN) != 0) {
+            const int error = errno;
+            close(listener);
+            return std::unexpected(std::format("Failed to listen on {}:{}: {}", params.bind_address, params.port, std::strerror(error)));
+        }
+
+        // Encoder pipes of clients that disconnect must not kill the server
+        std::signal(SIGPIPE, SIG_IGN);
+        stop_requested = false;
+        const auto request_stop = [](int) { stop_requested = true; };
+        std::signal(SIGINT, request_stop);
+        std::signal(SIGTERM, request_stop);
+
+        LOG_INFO("Serving {} ({} gaussians) on {}:{}, up to {} session(s)",
+                 params.model.filename().string(), model.size(), params.bind_address, params.port, params.max_sessions);
+
+        std::list<std::unique_ptr<Session>> sessions;
+        while (!stop_requested.load()) {
+            pollfd listening{.fd = listener, .events = POLLIN, .revents = 0};
+            const int ready = poll(&listening, 1, 250);
+            sessions.remove_if([](const auto& session) { return session->finished(); });
+            if (ready <= 0) {
+                continue;
+            }
+
+            sockaddr_in peer{};
+            socklen_t peer_size = sizeof(peer);
+            const int client = accept4(listener, reinterpret_cast<sockaddr*>(&peer), &peer_size, SOCK_CLOEXEC);
+            if (client < 0) {
+                continue;
+            }
+            char ip[INET_ADDRSTRLEN] = {};
+            inet_ntop(AF_INET, &peer.sin_addr, ip, sizeof(ip));
+            auto name = std::format("{}:{}", ip, ntohs(peer.sin_port));
+            if (sessions.size() >= static_cast<size_t>(params.max_sessions)) {
+                LOG_WARN("Turning away {}, {} session(s) are running", name, sessions.size());
+                close(client);
+                continue;
+            }
+            // Poses are small messages that should not wait for more to coalesce
+            const int no_delay = 1;
+            setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+            LOG_INFO("Render session {} connected", name);
+            sessions.push_back(std::make_unique<Session>(client, std::move(name), model, params));
+        }
+
+        LOG_INFO("Stopping the render server");
+        close(listener);
+        sessions.clear();
+        std::signal(SIGINT, SIG_DFL);
+        std::signal(SIGTERM, SIG_DFL);
+        return {};
+#endif
+    }
+
+} // namespace gs::training
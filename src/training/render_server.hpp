@@ -0,0 +1,30 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/parameters.hpp"
+#include <expected>
+#include <string>
+
+namespace gs::training {
+
+    // Serves one splat file to remote clients over TCP until interrupted. A client opens a
+    // session with a line of JSON and then sends one line per camera pose:
+    //
+    //   {"width": 1280, "height": 720, "fps": 30}
+    //   {"position": [x, y, z], "look_at": [x, y, z], "up": [x, y, z]    or "rotation": [w, x, y, z],
+    //    "fov": 50}
+    //
+    // with the pose conventions of render_camera_path. The server answers with a raw Annex B
+    // stream, H.264 or HEVC by the codec, one frame per pose (fps is only a rate control hint). Poses
+    // that arrive while a frame renders are dropped for the newest one, so a client sending
+    // faster than the GPU keeps its latency instead of building up a queue.
+    //
+    // All sessions share the loaded model. Each renders with the inference fastgs forward on
+    // its own stream and feeds a low-latency FFmpeg encoder (NVENC by default).
+    // POSIX only.
+    std::expected<void, std::string> run_render_server(const param::RenderServerParameters& params);
+
+} // namespace gs::training
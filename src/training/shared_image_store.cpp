@@ -0,0 +1,116 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "shared_image_store.hpp"
+#include "core/image_io.hpp"
+#include "core/logger.hpp"
+#include "loader/formats/mmapped_file.hpp"
+#include <cuda_runtime.h>
+#include <format>
+
+#ifndef _WIN32
+#include <sys/file.h>
+#endif
+
+namespace gs::training {
+
+    SharedImageStore::SharedImageStore(std::filesystem::path directory)
+        : directory_(std::move(directory)) {
+    }
+
+    std::expected<std::unique_ptr<SharedImageStore>, std::string> SharedImageStore::open(
+        const std::filesystem::path& directory) {
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        if (ec) {
+            return std::unexpected(std::format("Failed to create shared image cache {}: {}", directory.string(), ec.message()));
+        }
+
+        std::unique_ptr<SharedImageStore> store(new SharedImageStore(directory));
+        const auto lock_path = directory / ".lock";
+#ifdef _WIN32
+        HANDLE handle = CreateFileW(lock_path.wstring().c_str(), GENERIC_READ | GENERIC_WRITE,
+                                    FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            return std::unexpected(std::format("Failed to open {}", lock_path.string()));
+        }
+        store->lock_handle_ = handle;
+        OVERLAPPED overlapped{};
+        if (!LockFileEx(handle, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped)) {
+            return std::unexpected(std::format("Failed to lock {}", lock_path.string()));
+        }
+#else
+        store->lock_fd_ = ::open(lock_path.c_str(), O_RDWR | O_CREAT, 0666);
+        if (store->lock_fd_ < 0) {
+            return std::unexpected(std::format("Failed to open {}", lock_path.string()));
+        }
+        if (flock(store->lock_fd_, LOCK_EX | LOCK_NB) != 0) {
+            LOG_INFO("Waiting for another process filling the shared image cache {}", directory.string());
+            if (flock(store->lock_fd_, LOCK_EX) != 0) {
+                return std::unexpected(std::format("Failed to lock {}", lock_path.string()));
+            }
+        }
+#endif
+        return store;
+    }
+
+    SharedImageStore::~SharedImageStore() {
+#ifdef _WIN32
+        if (lock_handle_) {
+            CloseHandle(static_cast<HANDLE>(lock_handle_));
+        }
+#else
+        if (lock_fd_ >= 0) {
+            close(lock_fd_);
+        }
+#endif
+    }
+
+    torch::Tensor SharedImageStore::attach(const std::filesystem::path& source, int res_div, int max_width) const {
+        const auto path = image_io::raw_image_path(directory_, source, res_div, max_width);
+        std::error_code ec;
+        if (!path || !std::filesystem::exists(*path, ec)) {
+            return {};
+        }
+
+        auto mapping = std::make_shared<loader::MMappedFile>();
+        if (!mapping->map(*path)) {
+            return {};
+        }
+        const auto layout = image_io::parse_raw_image(mapping->as_span());
+        if (!layout) {
+            return {};
+        }
+
+        // Pinned in place where the driver takes read-only registrations, uploads from it are then
+        // asynchronous like the ones from a private cache
+        const bool registered = cudaHostRegister(mapping->data, mapping->size, cudaHostRegisterReadOnly) == cudaSuccess;
+        if (!registered) {
+            cudaGetLastError();
+        }
+
+        auto* pixels = static_cast<unsigned char*>(mapping->data) + layout->offset;
+        return torch::from_blob(
+            pixels, {layout->height, layout->width, layout->channels},
+            [mapping, registered](void*) {
+                if (registered) {
+                    cudaHostUnregister(mapping->data);
+                }
+            },
+            torch::TensorOptions().dtype(torch::kUInt8));
+    }
+
+    torch::Tensor SharedImageStore::publish(const std::filesystem::path& source, int res_div, int max_width,
+                                            const torch::Tensor& pixels) const {
+        const auto path = image_io::raw_image_path(directory_, source, res_div, max_width);
+        const auto hwc = pixels.contiguous();
+        if (!path || !image_io::write_raw_image(*path, hwc.data_ptr<uint8_t>(), static_cast<int>(hwc.size(1)),
+                                                static_cast<int>(hwc.size(0)), static_cast<int>(hwc.size(2)))) {
+            return pixels;
+        }
+        auto attached = attach(source, res_div, max_width);
+        return attached.defined() ? attached : pixels;
+    }
+
+} // namespace gs::training
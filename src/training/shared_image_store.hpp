@@ -0,0 +1,49 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <torch/torch.h>
+
+namespace gs::training {
+
+    // Decoded images shared by every training process that preloads the same scene. Each image is
+    // a raw file in one directory (on tmpfs such as /dev/shm it stays in RAM), mapped read-only so
+    // all processes read the same pages: a sweep of N runs holds and decodes every image once.
+    // Entries are disk image cache files, keyed by the source path, size, mtime and decode size,
+    // so stale entries are never attached.
+    class SharedImageStore {
+    public:
+        // Creates the directory and takes its lock. Blocks while another process holds it, so
+        // concurrent runs wait for the first one's decodes instead of repeating them.
+        static std::expected<std::unique_ptr<SharedImageStore>, std::string> open(const std::filesystem::path& directory);
+        ~SharedImageStore(); // Releases the lock, attached images stay valid
+
+        SharedImageStore(const SharedImageStore&) = delete;
+        SharedImageStore& operator=(const SharedImageStore&) = delete;
+
+        // [H, W, C] uint8 view of the stored image, undefined when it isn't stored
+        torch::Tensor attach(const std::filesystem::path& source, int res_div, int max_width) const;
+
+        // Stores a decoded [H, W, C] uint8 image and returns it attached, pixels itself when the
+        // store isn't writable
+        torch::Tensor publish(const std::filesystem::path& source, int res_div, int max_width,
+                              const torch::Tensor& pixels) const;
+
+    private:
+        explicit SharedImageStore(std::filesystem::path directory);
+
+        std::filesystem::path directory_;
+#ifdef _WIN32
+        void* lock_handle_ = nullptr;
+#else
+        int lock_fd_ = -1;
+#endif
+    };
+
+} // namespace gs::training
@@ -3,13 +3,15 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "default_strategy.hpp"
-#include "Ops.h"
+#include "checkpoint.hpp"
 #include "core/logger.hpp"
 #include "core/parameters.hpp"
 #include "optimizers/fused_adam.hpp"
 #include "rasterization/rasterizer.hpp"
 #include "strategy_utils.hpp"
-#include <c10/cuda/CUDACachingAllocator.h>
+#include "vram_manager.hpp"
+#include <cuda_runtime.h>
+#include <format>
 
 namespace gs::training {
     DefaultStrategy::DefaultStrategy(gs::SplatData&& splat_data)
@@ -19,7 +21,13 @@ namespace gs::training {
     void DefaultStrategy::initialize(const gs::param::OptimizationParameters& optimParams) {
         _params = std::make_unique<const gs::param::OptimizationParameters>(optimParams);
 
-        initialize_gaussians(_splat_data);
+        initialize_gaussians(_splat_data, sh_storage_dtype(_params->sh_precision));
+        if (_params->progressive_sh) {
+            drop_inactive_sh_bands(_splat_data);
+        }
+        if (_params->prune_contribution > 0.0f) {
+            _splat_data._max_contribution = reset_max_contribution(_splat_data.size(), _splat_data.means().device());
+        }
 
         // Initialize optimizer
         _optimizer = create_optimizer(_splat_data, *_params);
@@ -46,129 +54,58 @@ namespace gs::training {
         remove(mask);
     }
 
-    void DefaultStrategy::duplicate(const torch::Tensor& is_duplicated) {
-        torch::NoGradGuard no_grad;
-
-        const torch::Tensor sampled_idxs = is_duplicated.nonzero().squeeze(-1);
-
-        const auto param_fn = [&sampled_idxs](const int i, const torch::Tensor& param) {
-            const torch::Tensor new_param = param.index_select(0, sampled_idxs);
-            return torch::cat({param, new_param}).set_requires_grad(param.requires_grad());
-        };
-
-        const auto optimizer_fn = [&sampled_idxs](torch::optim::OptimizerParamState& state,
-                                                  const torch::Tensor& full_param)
-            -> std::unique_ptr<torch::optim::OptimizerParamState> {
-            auto new_shape = full_param.sizes().vec();
-            new_shape[0] = sampled_idxs.size(0);
-            if (auto* fused_adam_state = dynamic_cast<FusedAdam::AdamParamState*>(&state)) {
-                // FusedAdam state
-                auto zeros_to_add = torch::zeros(new_shape, fused_adam_state->exp_avg.options());
-                auto new_exp_avg = torch::cat({fused_adam_state->exp_avg, zeros_to_add}, 0);
-                auto new_exp_avg_sq = torch::cat({fused_adam_state->exp_avg_sq, zeros_to_add}, 0);
-
-                // Create new state
-                auto new_state = std::make_unique<FusedAdam::AdamParamState>();
-                new_state->step_count = fused_adam_state->step_count;
-                new_state->exp_avg = new_exp_avg;
-                new_state->exp_avg_sq = new_exp_avg_sq;
-                if (fused_adam_state->max_exp_avg_sq.defined()) {
-                    auto new_max_exp_avg_sq = torch::cat({fused_adam_state->max_exp_avg_sq, zeros_to_add}, 0);
-                    new_state->max_exp_avg_sq = new_max_exp_avg_sq;
-                }
-                return new_state;
-            }
-            return nullptr;
-        };
-
-        update_param_with_optimizer(param_fn, optimizer_fn, _optimizer, _splat_data);
+    void DefaultStrategy::reorder_gaussians(const torch::Tensor& order) {
+        permute_gaussians(order, _optimizer, _splat_data);
     }
 
-    void DefaultStrategy::split(const torch::Tensor& is_split) {
-        torch::NoGradGuard no_grad;
-
-        const c10::Device device = is_split.device();
-        const torch::Tensor sampled_idxs = is_split.nonzero().squeeze(-1);
-        const torch::Tensor rest_idxs = is_split.logical_not().nonzero().squeeze(-1);
-
-        const torch::Tensor sampled_scales = _splat_data.get_scaling().index_select(0, sampled_idxs);
-        const torch::Tensor sampled_quats = _splat_data.get_rotation().index_select(0, sampled_idxs);
-        const torch::Tensor rotmats = gsplat::quats_to_rotmats(sampled_quats); // [N, 3, 3]
-
-        const auto num_split_gaussians = sampled_idxs.size(0);
-        constexpr auto split_size = 2;
-        const torch::Tensor samples = torch::einsum( // [split_size, N, 3]
-            "nij,nj,bnj->bni",
-            {rotmats,
-             sampled_scales,
-             torch::randn({split_size, num_split_gaussians, 3}, sampled_quats.options().device(device))});
-
-        const auto param_fn = [this, &sampled_idxs, &rest_idxs, &samples, &sampled_scales](
-                                  const int i, const torch::Tensor& param) {
-            std::vector<int64_t> repeats(param.dim(), 1);
-            repeats[0] = split_size;
-
-            const torch::Tensor sampled_param = param.index_select(0, sampled_idxs);
-            torch::Tensor split_param;
-            if (i == 0) {
-                // means
-                split_param = (sampled_param.unsqueeze(0) + samples).reshape({-1, 3}); // [split_size * N, 3]
-            } else if (i == 3) {
-                // scaling
-                split_param = torch::log(sampled_scales / 1.6).repeat({split_size, 1}); // [split_size * N, 3]
-            } else if (i == 5 && _params->revised_opacity) {
-                // opacity
-                const torch::Tensor new_opacities = 1.0 - torch::sqrt(1.0 - torch::sigmoid(sampled_param));
-                split_param = torch::logit(new_opacities).repeat(repeats); // [split_size * N]
-            } else {
-                split_param = sampled_param.repeat(repeats);
-            }
+    void DefaultStrategy::quantize_sh(const int codebook_size) {
+        quantize_sh_codebook(codebook_size, _optimizer, _splat_data);
+    }
 
-            const torch::Tensor rest_param = param.index_select(0, rest_idxs);
-            return torch::cat({rest_param, split_param}, 0).set_requires_grad(param.requires_grad());
-        };
-
-        const auto optimizer_fn = [&sampled_idxs, &rest_idxs](
-                                      torch::optim::OptimizerParamState& state,
-                                      const torch::Tensor& full_param)
-            -> std::unique_ptr<torch::optim::OptimizerParamState> {
-            auto zero_shape = full_param.sizes().vec();
-            zero_shape[0] = sampled_idxs.size(0) * split_size;
-            if (auto* fused_adam_state = dynamic_cast<FusedAdam::AdamParamState*>(&state)) {
-                // FusedAdam state
-                auto rest_exp_avg = fused_adam_state->exp_avg.index_select(0, rest_idxs);
-                auto rest_exp_avg_sq = fused_adam_state->exp_avg_sq.index_select(0, rest_idxs);
-
-                auto zeros_to_add = torch::zeros(zero_shape, fused_adam_state->exp_avg.options());
-                auto new_exp_avg = torch::cat({rest_exp_avg, zeros_to_add}, 0);
-                auto new_exp_avg_sq = torch::cat({rest_exp_avg_sq, zeros_to_add}, 0);
-
-                // Create new state
-                auto new_state = std::make_unique<FusedAdam::AdamParamState>();
-                new_state->step_count = fused_adam_state->step_count;
-                new_state->exp_avg = new_exp_avg;
-                new_state->exp_avg_sq = new_exp_avg_sq;
-                if (fused_adam_state->max_exp_avg_sq.defined()) {
-                    auto rest_max_exp_avg_sq = fused_adam_state->max_exp_avg_sq.index_select(0, rest_idxs);
-                    auto new_max_exp_avg_sq = torch::cat({rest_max_exp_avg_sq, zeros_to_add}, 0);
-                    new_state->max_exp_avg_sq = new_max_exp_avg_sq;
-                }
-                return new_state;
-            }
-            return nullptr;
-        };
+    void DefaultStrategy::factor_sh(const int rank) {
+        factor_sh_basis(rank, _optimizer, _splat_data);
+    }
 
-        update_param_with_optimizer(param_fn, optimizer_fn, _optimizer, _splat_data);
+    int64_t DefaultStrategy::growth_budget() const {
+        const int64_t n = _splat_data.size();
+        int64_t budget = static_cast<int64_t>(_params->max_cap) - n;
+
+        size_t free_bytes = 0;
+        size_t total_bytes = 0;
+        cudaMemGetInfo(&free_bytes, &total_bytes);
+        const double ceiling = _params->densify_vram_mb > 0 ? _params->densify_vram_mb * 1024.0 * 1024.0
+                                                            : 0.9 * static_cast<double>(total_bytes);
+
+        // The allocation peak per Gaussian since the last refinement extrapolates linearly to the
+        // count that fits the ceiling (the parts that do not scale make this conservative)
+        const double bytes_per_gaussian = VramManager::get().bytes_per_gaussian();
+        if (bytes_per_gaussian > 0.0) {
+            const auto fits = static_cast<int64_t>(ceiling / bytes_per_gaussian);
+            budget = std::min(budget, fits - n);
+        }
+        return std::max<int64_t>(budget, 0);
     }
 
     void DefaultStrategy::grow_gs(int iter) {
         torch::NoGradGuard no_grad;
 
-        const torch::Tensor grads = _splat_data._densification_info[1] / torch::clamp_min(
-                                                                             _splat_data._densification_info[0], 1.0f);
+        const torch::Tensor info = _splat_data._densification_info.to(torch::kFloat);
+        const torch::Tensor grads = info.select(1, 1) / torch::clamp_min(info.select(1, 0), 1.0f);
         const c10::Device device = grads.device();
 
-        const torch::Tensor is_grad_high = grads > _params->grad_threshold;
+        torch::Tensor is_grad_high = grads > _params->grad_threshold;
+        if (_params->densify_budget) {
+            // Duplicating and splitting add one Gaussian each, past the budget only the highest
+            // gradients grow, which raises the effective threshold
+            const int64_t budget = growth_budget();
+            const auto num_candidates = is_grad_high.sum().item<int64_t>();
+            if (num_candidates > budget) {
+                const auto [top_grads, top_idxs] = torch::where(is_grad_high, grads, -1.0f).topk(budget);
+                is_grad_high = torch::zeros_like(is_grad_high).index_fill_(0, top_idxs, true);
+                LOG_DEBUG("Densification budget {} of {} candidates, gradient threshold {:.2e}",
+                          budget, num_candidates, budget > 0 ? top_grads[-1].item<float>() : 0.0f);
+            }
+        }
         const auto max_values = std::get<0>(torch::max(_splat_data.get_scaling(), -1));
         const torch::Tensor is_small = max_values <= _params->grow_scale3d * _splat_data.get_scene_scale();
         const torch::Tensor is_duplicated = is_grad_high & is_small;
@@ -177,53 +114,23 @@ namespace gs::training {
         const torch::Tensor is_large = ~is_small;
         torch::Tensor is_split = is_grad_high & is_large;
         const auto num_split = is_split.sum().item<int64_t>();
+        VramManager::get().reserve_growth(num_duplicates + num_split);
 
         // First duplicate
         if (num_duplicates > 0) {
-            duplicate(is_duplicated);
+            duplicate_gaussians(is_duplicated, _optimizer, _splat_data);
         }
 
         // New Gaussians added by duplication will not be split
         is_split = torch::cat({is_split,
                                torch::zeros(num_duplicates, c10::TensorOptions().dtype(torch::kBool).device(device))});
         if (num_split > 0) {
-            split(is_split);
+            split_gaussians(is_split, _optimizer, _splat_data, _params->revised_opacity);
         }
     }
 
     void DefaultStrategy::remove(const torch::Tensor& is_prune) {
-        torch::NoGradGuard no_grad;
-
-        const torch::Tensor sampled_idxs = is_prune.logical_not().nonzero().squeeze(-1);
-
-        const auto param_fn = [&sampled_idxs](const int i, const torch::Tensor& param) {
-            return param.index_select(0, sampled_idxs).set_requires_grad(param.requires_grad());
-        };
-
-        const auto optimizer_fn = [&sampled_idxs](
-                                      torch::optim::OptimizerParamState& state,
-                                      const torch::Tensor& new_param)
-            -> std::unique_ptr<torch::optim::OptimizerParamState> {
-            if (auto* fused_adam_state = dynamic_cast<FusedAdam::AdamParamState*>(&state)) {
-                // FusedAdam state
-                auto new_exp_avg = fused_adam_state->exp_avg.index_select(0, sampled_idxs);
-                auto new_exp_avg_sq = fused_adam_state->exp_avg_sq.index_select(0, sampled_idxs);
-
-                // Create new state
-                auto new_state = std::make_unique<FusedAdam::AdamParamState>();
-                new_state->step_count = fused_adam_state->step_count;
-                new_state->exp_avg = new_exp_avg;
-                new_state->exp_avg_sq = new_exp_avg_sq;
-                if (fused_adam_state->max_exp_avg_sq.defined()) {
-                    auto new_max_exp_avg_sq = fused_adam_state->max_exp_avg_sq.index_select(0, sampled_idxs);
-                    new_state->max_exp_avg_sq = new_max_exp_avg_sq;
-                }
-                return new_state;
-            }
-            return nullptr;
-        };
-
-        update_param_with_optimizer(param_fn, optimizer_fn, _optimizer, _splat_data);
+        compact_gaussians(is_prune.logical_not(), _optimizer, _splat_data);
     }
 
     void DefaultStrategy::prune_gs(int iter) {
@@ -248,57 +155,34 @@ namespace gs::training {
         }
     }
 
-    void DefaultStrategy::reset_opacity() {
+    void DefaultStrategy::prune_low_contribution() {
         torch::NoGradGuard no_grad;
 
-        const auto threshold = 2.0f * _params->prune_opacity;
-
-        const auto param_fn = [&threshold](const int i, const torch::Tensor& param) {
-            if (i == 5) {
-                const torch::Tensor new_opacities = torch::clamp_max(
-                    param,
-                    torch::logit(torch::tensor(threshold)).item());
-                return new_opacities.set_requires_grad(param.requires_grad());
-            }
-            throw std::runtime_error("Invalid parameter index for reset_opacity: " + std::to_string(i));
-        };
-
-        const auto optimizer_fn = [](torch::optim::OptimizerParamState& state,
-                                     const torch::Tensor& new_param)
-            -> std::unique_ptr<torch::optim::OptimizerParamState> {
-            if (auto* fused_adam_state = dynamic_cast<FusedAdam::AdamParamState*>(&state)) {
-                // FusedAdam state
-                auto new_exp_avg = torch::zeros_like(fused_adam_state->exp_avg);
-                auto new_exp_avg_sq = torch::zeros_like(fused_adam_state->exp_avg_sq);
-
-                // Create new state
-                auto new_state = std::make_unique<FusedAdam::AdamParamState>();
-                new_state->step_count = fused_adam_state->step_count;
-                new_state->exp_avg = new_exp_avg;
-                new_state->exp_avg_sq = new_exp_avg_sq;
-                if (fused_adam_state->max_exp_avg_sq.defined()) {
-                    auto new_max_exp_avg_sq = torch::zeros_like(fused_adam_state->max_exp_avg_sq);
-                    new_state->max_exp_avg_sq = new_max_exp_avg_sq;
-                }
-                return new_state;
-            }
-
-            return nullptr;
-        };
+        // Before growing, while the tracker and the densification info still match the Gaussians
+        const torch::Tensor is_prune = is_low_contribution(_splat_data, _params->prune_contribution);
+        const auto num_prunes = is_prune.sum().item<int64_t>();
+        if (num_prunes > 0) {
+            LOG_DEBUG("Pruning {} Gaussians that contributed below {} since the last refinement",
+                      num_prunes, _params->prune_contribution);
+            remove(is_prune);
+        }
+    }
 
-        update_param_with_optimizer(param_fn, optimizer_fn, _optimizer, _splat_data, {5});
+    void DefaultStrategy::reset_opacity() {
+        reset_opacities(_optimizer, _splat_data, 2.0f * _params->prune_opacity);
     }
 
     void DefaultStrategy::post_backward(int iter, RenderOutput& render_output) {
         // Increment SH degree every 1000 iterations
         torch::NoGradGuard no_grad;
         if (iter % _params->sh_degree_interval == 0) {
-            _splat_data.increment_sh_degree();
+            grow_sh_degree(_optimizer, _splat_data);
         }
 
         if (iter == _params->stop_refine) {
             // Reset densification info at the end of refinement.Saves memory and processing time.
             _splat_data._densification_info = torch::empty({0});
+            _splat_data._max_contribution = torch::empty({0});
         }
 
         if (iter >= _params->stop_refine) {
@@ -306,23 +190,23 @@ namespace gs::training {
         }
 
         if (is_refining(iter)) {
+            VramManager::get().begin_refinement(_splat_data.size());
+            if (_params->prune_contribution > 0.0f) {
+                prune_low_contribution();
+            }
             grow_gs(iter);
             prune_gs(iter);
 
-            _splat_data._densification_info = torch::zeros({2, _splat_data.means().size(0)},
-                                                           _splat_data.means().options())
-                                                  .set_requires_grad(false);
+            _splat_data._densification_info = zero_densification_info(_splat_data.means().size(0),
+                                                                      _splat_data.means().device());
+            if (_params->prune_contribution > 0.0f) {
+                _splat_data._max_contribution = reset_max_contribution(_splat_data.size(), _splat_data.means().device());
+            }
         }
 
         if (iter % _params->reset_every == 0 && iter > 0) {
             reset_opacity();
         }
-
-#ifdef _WIN32
-        // Windows doesn't support CUDACachingAllocator expandable_segments
-        if (iter % 10 == 0)
-            c10::cuda::CUDACachingAllocator::emptyCache();
-#endif
     }
 
     void DefaultStrategy::step(int iter) {
@@ -333,4 +217,20 @@ namespace gs::training {
             _scheduler->step();
         }
     }
+
+    void DefaultStrategy::set_optimizer_visibility(const torch::Tensor& visibility) {
+        dynamic_cast<FusedAdam*>(_optimizer.get())->set_visibility(visibility);
+    }
+
+    void DefaultStrategy::save_checkpoint(TrainingCheckpoint& checkpoint) const {
+        save_strategy_checkpoint(*_optimizer, _splat_data, checkpoint);
+        checkpoint.meta()["strategy"] = "default";
+    }
+
+    std::expected<void, std::string> DefaultStrategy::load_checkpoint(const TrainingCheckpoint& checkpoint) {
+        if (const auto strategy = checkpoint.meta().value("strategy", ""); strategy != "default") {
+            return std::unexpected(std::format("Checkpoint was written by the '{}' strategy, not 'default'", strategy));
+        }
+        return load_strategy_checkpoint(*_optimizer, _splat_data, checkpoint);
+    }
 } // namespace gs::training
\ No newline at end of file
@@ -35,6 +35,8 @@ namespace gs::training {
 
         void step(int iter) override;
 
+        void set_optimizer_visibility(const torch::Tensor& visibility) override;
+
         bool is_refining(int iter) const override;
 
         gs::SplatData& get_model() override { return _splat_data; }
@@ -42,18 +44,30 @@ namespace gs::training {
 
         void remove_gaussians(const torch::Tensor& mask) override;
 
-    private:
-        // Helper functions
-        void duplicate(const torch::Tensor& is_duplicated);
+        void reorder_gaussians(const torch::Tensor& order) override;
+
+        void quantize_sh(int codebook_size) override;
+
+        void factor_sh(int rank) override;
 
-        void split(const torch::Tensor& is_split);
+        void save_checkpoint(TrainingCheckpoint& checkpoint) const override;
 
+        std::expected<void, std::string> load_checkpoint(const TrainingCheckpoint& checkpoint) override;
+
+    private:
+        // Helper functions
         void grow_gs(int iter);
 
+        // Gaussians grow_gs may still add under densify_budget, from max_cap and the VRAM ceiling
+        int64_t growth_budget() const;
+
         void remove(const torch::Tensor& is_prune);
 
         void prune_gs(int iter);
 
+        // Prunes the Gaussians that stayed below prune_contribution since the last refinement
+        void prune_low_contribution();
+
         void reset_opacity();
 
         // Member variables
@@ -6,9 +6,12 @@
 
 #include "core/parameters.hpp"
 #include "core/splat_data.hpp"
+#include <expected>
+#include <string>
 
 namespace gs::training {
     struct RenderOutput;
+    class TrainingCheckpoint;
 
     class IStrategy {
     public:
@@ -20,6 +23,9 @@ namespace gs::training {
 
         virtual void step(int iter) = 0;
 
+        // Restricts the next step() to the Gaussians set in the bool [N] mask (sparse_adam)
+        virtual void set_optimizer_visibility(const torch::Tensor& visibility) = 0;
+
         virtual bool is_refining(int iter) const = 0;
 
         // Get the underlying Gaussian model for rendering
@@ -29,5 +35,20 @@ namespace gs::training {
 
         // Remove Gaussians based on mask
         virtual void remove_gaussians(const torch::Tensor& mask) = 0;
+
+        // Reorder Gaussians to the permutation order [N], optimizer state included
+        virtual void reorder_gaussians(const torch::Tensor& order) = 0;
+
+        // Switch shN to a trained palette of codebook_size entries (SH codebook mode)
+        virtual void quantize_sh(int codebook_size) = 0;
+
+        // Switch shN to per-Gaussian weights over rank shared basis vectors (low-rank SH)
+        virtual void factor_sh(int rank) = 0;
+
+        // Model tensors, optimizer moments and learning rates for resuming training
+        virtual void save_checkpoint(TrainingCheckpoint& checkpoint) const = 0;
+
+        // Call after initialize(); replaces the model and optimizer state with the checkpoint's
+        virtual std::expected<void, std::string> load_checkpoint(const TrainingCheckpoint& checkpoint) = 0;
     };
 } // namespace gs::training
@@ -4,17 +4,15 @@
 
 #include "mcmc.hpp"
 #include "Ops.h"
+#include "checkpoint.hpp"
 #include "core/logger.hpp"
 #include "core/parameters.hpp"
+#include "core/row_storage.hpp"
 #include "optimizers/fused_adam.hpp"
 #include "rasterization/rasterizer.hpp"
 #include "strategy_utils.hpp"
+#include <format>
 #include <iostream>
-#include <random>
-
-#ifdef _WIN32
-#include <c10/cuda/CUDACachingAllocator.h> //required for emptyCache
-#endif
 
 namespace gs::training {
     void MCMC::ExponentialLR::step() {
@@ -46,67 +44,33 @@ namespace gs::training {
         if (num_elements <= (1 << 24)) {
             return torch::multinomial(weights, n, replacement);
         }
-        // For larger arrays, we need to implement sampling manually
-        auto weights_normalized = weights / weights.sum();
-        auto weights_cpu = weights_normalized.cpu();
-
-        std::vector<int64_t> sampled_indices;
-        sampled_indices.reserve(n);
-
-        // Create cumulative distribution
-        auto cumsum = weights_cpu.cumsum(0);
-        auto cumsum_data = cumsum.accessor<float, 1>();
-
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<float> dis(0.0, 1.0);
-
-        for (int i = 0; i < n; ++i) {
-            float u = dis(gen);
-            // Binary search for the index
-            int64_t idx = 0;
-            int64_t left = 0, right = num_elements - 1;
-            while (left <= right) {
-                int64_t mid = (left + right) / 2;
-                if (cumsum_data[mid] < u) {
-                    left = mid + 1;
-                } else {
-                    idx = mid;
-                    right = mid - 1;
-                }
-            }
-            sampled_indices.push_back(idx);
-        }
-
-        auto result = torch::tensor(sampled_indices, torch::kLong);
-        return result.to(weights.device());
+        // Beyond that, inverse CDF sampling on the device. The scan runs in double precision so
+        // the CDF still resolves single small weights at tens of millions of entries.
+        TORCH_CHECK(replacement, "multinomial_sample without replacement supports at most 2^24 weights");
+        const auto cdf = weights.to(torch::kFloat64).cumsum(0);
+        const auto u = torch::rand({n}, cdf.options()) * cdf[-1];
+        // right=true never lands on a zero weight, whose CDF entry equals its predecessor's
+        return torch::searchsorted(cdf, u, /*out_int32=*/false, /*right=*/true).clamp_max_(num_elements - 1);
     }
 
-    void MCMC::update_optimizer_for_relocate(torch::optim::Optimizer* optimizer,
-                                             const torch::Tensor& sampled_indices,
-                                             const torch::Tensor& dead_indices,
-                                             int param_position) {
-        // Get the parameter
-        auto& param = optimizer->param_groups()[param_position].params()[0];
-        void* param_key = param.unsafeGetTensorImpl();
-
-        // Check if optimizer state exists
-        auto state_it = optimizer->state().find(param_key);
-        if (state_it == optimizer->state().end()) {
-            // No state exists yet - this can happen if optimizer.step() hasn't been called
-            // In this case, there's nothing to reset, so we can safely return
-            return;
-        }
-
-        // Get the optimizer state - handle both Adam types
-        auto& param_state = *state_it->second;
-        auto* fused_adam_state = static_cast<FusedAdam::AdamParamState*>(&param_state);
-        fused_adam_state->exp_avg.index_put_({sampled_indices}, 0);
-        fused_adam_state->exp_avg_sq.index_put_({sampled_indices}, 0);
-
-        if (fused_adam_state->max_exp_avg_sq.defined()) {
-            fused_adam_state->max_exp_avg_sq.index_put_({sampled_indices}, 0);
+    std::vector<torch::Tensor> MCMC::optimizer_moments() const {
+        std::vector<torch::Tensor> moments;
+        for (auto& group : _optimizer->param_groups()) {
+            for (auto& param : group.params()) {
+                // No state before the first optimizer step, nothing to reset then
+                auto state_it = _optimizer->state().find(param.unsafeGetTensorImpl());
+                if (state_it == _optimizer->state().end()) {
+                    continue;
+                }
+                auto* fused_adam_state = static_cast<FusedAdam::AdamParamState*>(state_it->second.get());
+                moments.push_back(fused_adam_state->exp_avg);
+                moments.push_back(fused_adam_state->exp_avg_sq);
+                if (fused_adam_state->max_exp_avg_sq.defined()) {
+                    moments.push_back(fused_adam_state->max_exp_avg_sq);
+                }
+            }
         }
+        return moments;
     }
 
     int MCMC::relocate_gs() {
@@ -119,6 +83,10 @@ namespace gs::training {
 
         auto rotation_raw = _splat_data.rotation_raw();
         auto dead_mask = opacities <= _params->min_opacity | (rotation_raw * rotation_raw).sum(-1) < 1e-8f;
+        if (_params->prune_contribution > 0.0f) {
+            // Rasterized since the last refinement without ever contributing, as good as transparent
+            dead_mask |= is_low_contribution(_splat_data, _params->prune_contribution);
+        }
         auto dead_indices = dead_mask.nonzero().squeeze(-1);
         int n_dead = dead_indices.numel();
 
@@ -173,18 +141,14 @@ namespace gs::training {
         }
         _splat_data.scaling_raw().index_put_({sampled_idxs}, torch::log(new_scales));
 
-        // Copy from sampled to dead indices
-        _splat_data.means().index_put_({dead_indices}, _splat_data.means().index_select(0, sampled_idxs));
-        _splat_data.sh0().index_put_({dead_indices}, _splat_data.sh0().index_select(0, sampled_idxs));
-        _splat_data.shN().index_put_({dead_indices}, _splat_data.shN().index_select(0, sampled_idxs));
-        _splat_data.scaling_raw().index_put_({dead_indices}, _splat_data.scaling_raw().index_select(0, sampled_idxs));
-        _splat_data.rotation_raw().index_put_({dead_indices}, _splat_data.rotation_raw().index_select(0, sampled_idxs));
-        _splat_data.opacity_raw().index_put_({dead_indices}, _splat_data.opacity_raw().index_select(0, sampled_idxs));
-
-        // Update optimizer states for sampled indices
-        for (int i = 0; i < 6; ++i) {
-            update_optimizer_for_relocate(_optimizer.get(), sampled_idxs, dead_indices, i);
-        }
+        // Copy from sampled to dead indices and reset the optimizer moments of the sampled
+        // Gaussians, one launch over all attributes instead of a gather and scatter per tensor
+        gsplat::relocate_rows(
+            sampled_idxs,
+            dead_indices,
+            {_splat_data.means(), _splat_data.sh0(), _splat_data.shN(),
+             _splat_data.scaling_raw(), _splat_data.rotation_raw(), _splat_data.opacity_raw()},
+            optimizer_moments());
 
         return n_dead;
     }
@@ -258,13 +222,13 @@ namespace gs::training {
         auto new_rotation = _splat_data.rotation_raw().index_select(0, sampled_idxs);
         auto new_opacity = _splat_data.opacity_raw().index_select(0, sampled_idxs);
 
-        // Step 1: Concatenate all parameters
-        auto concat_means = torch::cat({_splat_data.means(), new_means}, 0).set_requires_grad(true);
-        auto concat_sh0 = torch::cat({_splat_data.sh0(), new_sh0}, 0).set_requires_grad(true);
-        auto concat_shN = torch::cat({_splat_data.shN(), new_shN}, 0).set_requires_grad(true);
-        auto concat_scaling = torch::cat({_splat_data.scaling_raw(), new_scaling}, 0).set_requires_grad(true);
-        auto concat_rotation = torch::cat({_splat_data.rotation_raw(), new_rotation}, 0).set_requires_grad(true);
-        auto concat_opacity = torch::cat({_splat_data.opacity_raw(), new_opacity}, 0).set_requires_grad(true);
+        // Step 1: Append to the parameters, in place within the max_cap reserve
+        auto concat_means = append_rows(_splat_data.means(), new_means).set_requires_grad(true);
+        auto concat_sh0 = append_rows(_splat_data.sh0(), new_sh0).set_requires_grad(true);
+        auto concat_shN = append_rows(_splat_data.shN(), new_shN).set_requires_grad(true);
+        auto concat_scaling = append_rows(_splat_data.scaling_raw(), new_scaling).set_requires_grad(true);
+        auto concat_rotation = append_rows(_splat_data.rotation_raw(), new_rotation).set_requires_grad(true);
+        auto concat_opacity = append_rows(_splat_data.opacity_raw(), new_opacity).set_requires_grad(true);
 
         // Step 2: SAFER optimizer state update
         // Store the new parameters in a temporary array first
@@ -304,8 +268,9 @@ namespace gs::training {
                 new_shape = new_opacity.sizes();
 
             auto zeros_to_add = torch::zeros(new_shape, fused_adam_state->exp_avg.options());
-            auto new_exp_avg = torch::cat({fused_adam_state->exp_avg, zeros_to_add}, 0);
-            auto new_exp_avg_sq = torch::cat({fused_adam_state->exp_avg_sq, zeros_to_add}, 0);
+            // The moments start out exactly sized, the first growth moves them to a max_cap reserve too
+            auto new_exp_avg = append_rows(reserve_rows(fused_adam_state->exp_avg, _params->max_cap), zeros_to_add);
+            auto new_exp_avg_sq = append_rows(reserve_rows(fused_adam_state->exp_avg_sq, _params->max_cap), zeros_to_add);
 
             // Create new state
             auto new_state = std::make_unique<FusedAdam::AdamParamState>();
@@ -313,7 +278,7 @@ namespace gs::training {
             new_state->exp_avg = new_exp_avg;
             new_state->exp_avg_sq = new_exp_avg_sq;
             if (fused_adam_state->max_exp_avg_sq.defined()) {
-                auto new_max_exp_avg_sq = torch::cat({fused_adam_state->max_exp_avg_sq, zeros_to_add}, 0);
+                auto new_max_exp_avg_sq = append_rows(reserve_rows(fused_adam_state->max_exp_avg_sq, _params->max_cap), zeros_to_add);
                 new_state->max_exp_avg_sq = new_max_exp_avg_sq;
             }
 
@@ -342,6 +307,7 @@ namespace gs::training {
         _splat_data.scaling_raw() = concat_scaling;
         _splat_data.rotation_raw() = concat_rotation;
         _splat_data.opacity_raw() = concat_opacity;
+        _splat_data.append_gaussian_ids(new_means.size(0));
 
         return n_new;
     }
@@ -370,7 +336,11 @@ namespace gs::training {
         // Increment SH degree every 1000 iterations
         torch::NoGradGuard no_grad;
         if (iter % _params->sh_degree_interval == 0) {
-            _splat_data.increment_sh_degree();
+            grow_sh_degree(_optimizer, _splat_data);
+        }
+
+        if (iter == _params->stop_refine) {
+            _splat_data._max_contribution = torch::empty({0});
         }
 
         // Refine Gaussians
@@ -380,16 +350,14 @@ namespace gs::training {
 
             // Add new Gaussians
             add_new_gs();
+
+            if (_params->prune_contribution > 0.0f) {
+                _splat_data._max_contribution = reset_max_contribution(_splat_data.size(), _splat_data.means().device());
+            }
         }
 
         // Inject noise to positions
         inject_noise();
-
-#ifdef _WIN32
-        // Windows doesn't support CUDACachingAllocator expandable_segments
-        if (iter % 10 == 0)
-            c10::cuda::CUDACachingAllocator::emptyCache();
-#endif
     }
 
     void MCMC::step(int iter) {
@@ -401,6 +369,10 @@ namespace gs::training {
         }
     }
 
+    void MCMC::set_optimizer_visibility(const torch::Tensor& visibility) {
+        dynamic_cast<FusedAdam*>(_optimizer.get())->set_visibility(visibility);
+    }
+
     void MCMC::remove_gaussians(const torch::Tensor& mask) {
         torch::NoGradGuard no_grad;
 
@@ -410,37 +382,19 @@ namespace gs::training {
         }
 
         LOG_DEBUG("MCMC: Removing {} Gaussians", mask.sum().item<int>());
+        compact_gaussians(mask.logical_not(), _optimizer, _splat_data);
+    }
 
-        const torch::Tensor sampled_idxs = mask.logical_not().nonzero().squeeze(-1);
-
-        const auto param_fn = [&sampled_idxs](const int i, const torch::Tensor& param) {
-            return param.index_select(0, sampled_idxs).set_requires_grad(param.requires_grad());
-        };
+    void MCMC::reorder_gaussians(const torch::Tensor& order) {
+        permute_gaussians(order, _optimizer, _splat_data);
+    }
 
-        const auto optimizer_fn = [&sampled_idxs](
-                                      torch::optim::OptimizerParamState& state,
-                                      const torch::Tensor& new_param)
-            -> std::unique_ptr<torch::optim::OptimizerParamState> {
-            if (auto* fused_adam_state = dynamic_cast<FusedAdam::AdamParamState*>(&state)) {
-                // FusedAdam state
-                auto new_exp_avg = fused_adam_state->exp_avg.index_select(0, sampled_idxs);
-                auto new_exp_avg_sq = fused_adam_state->exp_avg_sq.index_select(0, sampled_idxs);
-
-                // Create new state
-                auto new_state = std::make_unique<FusedAdam::AdamParamState>();
-                new_state->step_count = fused_adam_state->step_count;
-                new_state->exp_avg = new_exp_avg;
-                new_state->exp_avg_sq = new_exp_avg_sq;
-                if (fused_adam_state->max_exp_avg_sq.defined()) {
-                    auto new_max_exp_avg_sq = fused_adam_state->max_exp_avg_sq.index_select(0, sampled_idxs);
-                    new_state->max_exp_avg_sq = new_max_exp_avg_sq;
-                }
-                return new_state;
-            }
-            return nullptr;
-        };
+    void MCMC::quantize_sh(const int codebook_size) {
+        quantize_sh_codebook(codebook_size, _optimizer, _splat_data);
+    }
 
-        update_param_with_optimizer(param_fn, optimizer_fn, _optimizer, _splat_data);
+    void MCMC::factor_sh(const int rank) {
+        factor_sh_basis(rank, _optimizer, _splat_data);
     }
 
     void MCMC::initialize(const gs::param::OptimizationParameters& optimParams) {
@@ -452,8 +406,16 @@ namespace gs::training {
         _splat_data.rotation_raw() = _splat_data.rotation_raw().to(dev).set_requires_grad(true);
         _splat_data.opacity_raw() = _splat_data.opacity_raw().to(dev).set_requires_grad(true);
         _splat_data.sh0() = _splat_data.sh0().to(dev).set_requires_grad(true);
-        _splat_data.shN() = _splat_data.shN().to(dev).set_requires_grad(true);
+        _splat_data.shN() = _splat_data.shN().to(dev, sh_storage_dtype(_params->sh_precision)).set_requires_grad(true);
+        if (_params->progressive_sh) {
+            drop_inactive_sh_bands(_splat_data);
+        }
         _splat_data._densification_info = torch::empty({0});
+        if (_params->prune_contribution > 0.0f) {
+            _splat_data._max_contribution = reset_max_contribution(_splat_data.size(), dev);
+        }
+        // MCMC never exceeds max_cap, so add_new_gs only ever writes into this allocation
+        _splat_data.reserve(_params->max_cap);
 
         // Initialize binomial coefficients
         const int n_max = 51;
@@ -476,20 +438,23 @@ namespace gs::training {
         std::vector<torch::optim::OptimizerParamGroup> groups;
 
         // Create groups with proper unique_ptr<Options>
-        auto add_param_group = [&groups](const torch::Tensor& param, double lr) {
+        auto add_param_group = [this, &groups](const torch::Tensor& param, double lr, size_t update_every, size_t update_after = 0) {
             auto options = std::make_unique<Options>(lr);
             options->eps(1e-15).betas(std::make_tuple(0.9, 0.999));
+            options->update_every(static_cast<int64_t>(update_every), static_cast<int64_t>(_params->update_every_until))
+                .update_after(static_cast<int64_t>(update_after));
             groups.emplace_back(
                 std::vector<torch::Tensor>{param},
                 std::unique_ptr<torch::optim::OptimizerOptions>(std::move(options)));
         };
 
-        add_param_group(_splat_data.means(), _params->means_lr * _splat_data.get_scene_scale());
-        add_param_group(_splat_data.sh0(), _params->shs_lr);
-        add_param_group(_splat_data.shN(), _params->shs_lr / 20.f);
-        add_param_group(_splat_data.scaling_raw(), _params->scaling_lr);
-        add_param_group(_splat_data.rotation_raw(), _params->rotation_lr);
-        add_param_group(_splat_data.opacity_raw(), _params->opacity_lr);
+        add_param_group(_splat_data.means(), _params->means_lr * _splat_data.get_scene_scale(), _params->means_update_every);
+        add_param_group(_splat_data.sh0(), _params->shs_lr, _params->sh0_update_every);
+        // Higher degree SH coefficients are unused until the first degree increase
+        add_param_group(_splat_data.shN(), _params->shs_lr / 20.f, _params->shN_update_every, _params->sh_degree_interval);
+        add_param_group(_splat_data.scaling_raw(), _params->scaling_lr, _params->scaling_update_every);
+        add_param_group(_splat_data.rotation_raw(), _params->rotation_lr, _params->rotation_update_every);
+        add_param_group(_splat_data.opacity_raw(), _params->opacity_lr, _params->opacity_update_every);
 
         auto global_options = std::make_unique<Options>(0.f);
         global_options->eps(1e-15);
@@ -503,4 +468,16 @@ namespace gs::training {
                 iter > _params->start_refine &&
                 iter % _params->refine_every == 0);
     }
+
+    void MCMC::save_checkpoint(TrainingCheckpoint& checkpoint) const {
+        save_strategy_checkpoint(*_optimizer, _splat_data, checkpoint);
+        checkpoint.meta()["strategy"] = "mcmc";
+    }
+
+    std::expected<void, std::string> MCMC::load_checkpoint(const TrainingCheckpoint& checkpoint) {
+        if (const auto strategy = checkpoint.meta().value("strategy", ""); strategy != "mcmc") {
+            return std::unexpected(std::format("Checkpoint was written by the '{}' strategy, not 'mcmc'", strategy));
+        }
+        return load_strategy_checkpoint(*_optimizer, _splat_data, checkpoint);
+    }
 } // namespace gs::training
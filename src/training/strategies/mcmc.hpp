@@ -32,11 +32,23 @@ namespace gs::training {
 
         void step(int iter) override;
 
+        void set_optimizer_visibility(const torch::Tensor& visibility) override;
+
         gs::SplatData& get_model() override { return _splat_data; }
         const gs::SplatData& get_model() const override { return _splat_data; }
 
         void remove_gaussians(const torch::Tensor& mask) override;
 
+        void reorder_gaussians(const torch::Tensor& order) override;
+
+        void quantize_sh(int codebook_size) override;
+
+        void factor_sh(int rank) override;
+
+        void save_checkpoint(TrainingCheckpoint& checkpoint) const override;
+
+        std::expected<void, std::string> load_checkpoint(const TrainingCheckpoint& checkpoint) override;
+
     private:
         // Simple ExponentialLR implementation since C++ API is different
         class ExponentialLR {
@@ -64,10 +76,8 @@ namespace gs::training {
 
         void inject_noise();
 
-        void update_optimizer_for_relocate(torch::optim::Optimizer* optimizer,
-                                           const torch::Tensor& sampled_indices,
-                                           const torch::Tensor& dead_indices,
-                                           int param_position);
+        // exp_avg, exp_avg_sq (and max_exp_avg_sq) of every parameter that has optimizer state
+        std::vector<torch::Tensor> optimizer_moments() const;
 
         // Member variables
         std::unique_ptr<torch::optim::Optimizer> _optimizer;
@@ -3,18 +3,106 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "strategy_utils.hpp"
+#include "Ops.h"
+#include "checkpoint.hpp"
+#include "adam_api.h"
+#include "core/logger.hpp"
+#include "core/row_storage.hpp"
+#include "kernels/kmeans.cuh"
 #include "optimizers/fused_adam.hpp"
+#include <algorithm>
+#include <cmath>
+#include <format>
 
 namespace gs::training {
-    void initialize_gaussians(gs::SplatData& splat_data) {
+    torch::ScalarType sh_storage_dtype(const std::string& sh_precision) {
+        if (sh_precision == "float16") {
+            return torch::kFloat16;
+        }
+        if (sh_precision == "bfloat16") {
+            return torch::kBFloat16;
+        }
+        return torch::kFloat32;
+    }
+
+    torch::Tensor zero_densification_info(int64_t n, const torch::Device& device) {
+        return torch::zeros({n, 2}, torch::TensorOptions().dtype(torch::kHalf).device(device));
+    }
+
+    torch::Tensor reset_max_contribution(int64_t n, const torch::Device& device) {
+        return torch::full({n}, -1.0f, torch::TensorOptions().dtype(torch::kFloat32).device(device));
+    }
+
+    torch::Tensor is_low_contribution(const gs::SplatData& splat_data, float threshold) {
+        const auto& tracked = splat_data._max_contribution;
+        if (!tracked.defined() || tracked.size(0) != splat_data.size()) {
+            return torch::zeros({splat_data.size()}, splat_data.means().options().dtype(torch::kBool));
+        }
+        return tracked.ge(0.0f) & tracked.lt(threshold);
+    }
+
+    void initialize_gaussians(gs::SplatData& splat_data, torch::ScalarType sh_dtype) {
         const auto dev = torch::kCUDA;
         splat_data.means() = splat_data.means().to(dev).set_requires_grad(true);
         splat_data.scaling_raw() = splat_data.scaling_raw().to(dev).set_requires_grad(true);
         splat_data.rotation_raw() = splat_data.rotation_raw().to(dev).set_requires_grad(true);
         splat_data.opacity_raw() = splat_data.opacity_raw().to(dev).set_requires_grad(true);
         splat_data.sh0() = splat_data.sh0().to(dev).set_requires_grad(true);
-        splat_data.shN() = splat_data.shN().to(dev).set_requires_grad(true);
-        splat_data._densification_info = torch::zeros({2, splat_data.means().size(0)}, splat_data.means().options()).set_requires_grad(false);
+        splat_data.shN() = splat_data.shN().to(dev, sh_dtype).set_requires_grad(true);
+        splat_data._densification_info = zero_densification_info(splat_data.means().size(0), dev);
+    }
+
+    void drop_inactive_sh_bands(gs::SplatData& splat_data) {
+        torch::NoGradGuard no_grad;
+        auto& shN = splat_data.shN();
+        const int degree = splat_data.get_active_sh_degree();
+        const int64_t bases = (degree + 1) * (degree + 1) - 1;
+        if (!shN.defined() || shN.dim() != 3 || shN.size(1) <= bases) {
+            return;
+        }
+        shN = shN.narrow(1, 0, bases).contiguous().set_requires_grad(shN.requires_grad());
+    }
+
+    void grow_sh_degree(
+        std::unique_ptr<torch::optim::Optimizer>& optimizer,
+        gs::SplatData& splat_data) {
+        torch::NoGradGuard no_grad;
+        const int degree = splat_data.get_active_sh_degree() + 1;
+        if (degree > splat_data.get_max_sh_degree() || degree <= splat_data.get_stored_sh_degree()) {
+            splat_data.increment_sh_degree();
+            return;
+        }
+
+        // Widened rows keep the reserve of the other parameters, shN without bands has none of its own
+        const int64_t n = splat_data.size();
+        const int64_t capacity = std::max(row_capacity(splat_data.means()), n);
+        const int64_t bases = (degree + 1) * (degree + 1) - 1;
+        const auto widen = [n, capacity, bases](const torch::Tensor& tensor) {
+            const auto storage = torch::zeros({capacity, bases, tensor.size(2)}, tensor.options());
+            storage.narrow(0, 0, n).narrow(1, 0, tensor.size(1)).copy_(tensor);
+            return rows_view(storage, n);
+        };
+
+        const auto param_fn = [&widen](const int, const torch::Tensor& param) {
+            return widen(param).set_requires_grad(param.requires_grad());
+        };
+        const auto optimizer_fn = [&widen](torch::optim::OptimizerParamState& state, const torch::Tensor&)
+            -> std::unique_ptr<torch::optim::OptimizerParamState> {
+            if (auto* fused_adam_state = dynamic_cast<FusedAdam::AdamParamState*>(&state)) {
+                auto new_state = std::make_unique<FusedAdam::AdamParamState>();
+                new_state->step_count = fused_adam_state->step_count;
+                new_state->exp_avg = widen(fused_adam_state->exp_avg);
+                new_state->exp_avg_sq = widen(fused_adam_state->exp_avg_sq);
+                if (fused_adam_state->max_exp_avg_sq.defined()) {
+                    new_state->max_exp_avg_sq = widen(fused_adam_state->max_exp_avg_sq);
+                }
+                return new_state;
+            }
+            return nullptr;
+        };
+        update_param_with_optimizer(param_fn, optimizer_fn, optimizer, splat_data, {2});
+        splat_data.increment_sh_degree();
+        LOG_DEBUG("SH degree {}: shN grew to {} bases", degree, bases);
     }
 
     std::unique_ptr<torch::optim::Optimizer> create_optimizer(
@@ -24,20 +112,23 @@ namespace gs::training {
         std::vector<torch::optim::OptimizerParamGroup> groups;
 
         // Create groups with proper unique_ptr<Options>
-        auto add_param_group = [&groups](const torch::Tensor& param, double lr) {
+        auto add_param_group = [&groups, &params](const torch::Tensor& param, double lr, size_t update_every, size_t update_after = 0) {
             auto options = std::make_unique<Options>(lr);
             options->eps(1e-15).betas(std::make_tuple(0.9, 0.999));
+            options->update_every(static_cast<int64_t>(update_every), static_cast<int64_t>(params.update_every_until))
+                .update_after(static_cast<int64_t>(update_after));
             groups.emplace_back(
                 std::vector<torch::Tensor>{param},
                 std::unique_ptr<torch::optim::OptimizerOptions>(std::move(options)));
         };
 
-        add_param_group(splat_data.means(), params.means_lr * splat_data.get_scene_scale());
-        add_param_group(splat_data.sh0(), params.shs_lr);
-        add_param_group(splat_data.shN(), params.shs_lr / 20.f);
-        add_param_group(splat_data.scaling_raw(), params.scaling_lr);
-        add_param_group(splat_data.rotation_raw(), params.rotation_lr);
-        add_param_group(splat_data.opacity_raw(), params.opacity_lr);
+        add_param_group(splat_data.means(), params.means_lr * splat_data.get_scene_scale(), params.means_update_every);
+        add_param_group(splat_data.sh0(), params.shs_lr, params.sh0_update_every);
+        // Higher degree SH coefficients are unused until the first degree increase
+        add_param_group(splat_data.shN(), params.shs_lr / 20.f, params.shN_update_every, params.sh_degree_interval);
+        add_param_group(splat_data.scaling_raw(), params.scaling_lr, params.scaling_update_every);
+        add_param_group(splat_data.rotation_raw(), params.rotation_lr, params.rotation_update_every);
+        add_param_group(splat_data.opacity_raw(), params.opacity_lr, params.opacity_update_every);
 
         auto global_options = std::make_unique<Options>(0.f);
         global_options->eps(1e-15);
@@ -126,4 +217,550 @@ namespace gs::training {
             }
         }
     }
+
+    void duplicate_gaussians(
+        const torch::Tensor& is_duplicated,
+        std::unique_ptr<torch::optim::Optimizer>& optimizer,
+        gs::SplatData& splat_data) {
+        torch::NoGradGuard no_grad;
+
+        const torch::Tensor sampled_idxs = is_duplicated.nonzero().squeeze(-1);
+
+        const auto param_fn = [&sampled_idxs](const int i, const torch::Tensor& param) {
+            const torch::Tensor new_param = param.index_select(0, sampled_idxs);
+            return append_rows(param, new_param).set_requires_grad(param.requires_grad());
+        };
+
+        const auto optimizer_fn = [&sampled_idxs](torch::optim::OptimizerParamState& state,
+                                                  const torch::Tensor& full_param)
+            -> std::unique_ptr<torch::optim::OptimizerParamState> {
+            auto new_shape = full_param.sizes().vec();
+            new_shape[0] = sampled_idxs.size(0);
+            if (auto* fused_adam_state = dynamic_cast<FusedAdam::AdamParamState*>(&state)) {
+                // FusedAdam state
+                auto zeros_to_add = torch::zeros(new_shape, fused_adam_state->exp_avg.options());
+                auto new_exp_avg = append_rows(fused_adam_state->exp_avg, zeros_to_add);
+                auto new_exp_avg_sq = append_rows(fused_adam_state->exp_avg_sq, zeros_to_add);
+
+                // Create new state
+                auto new_state = std::make_unique<FusedAdam::AdamParamState>();
+                new_state->step_count = fused_adam_state->step_count;
+                new_state->exp_avg = new_exp_avg;
+                new_state->exp_avg_sq = new_exp_avg_sq;
+                if (fused_adam_state->max_exp_avg_sq.defined()) {
+                    auto new_max_exp_avg_sq = append_rows(fused_adam_state->max_exp_avg_sq, zeros_to_add);
+                    new_state->max_exp_avg_sq = new_max_exp_avg_sq;
+                }
+                return new_state;
+            }
+            return nullptr;
+        };
+
+        update_param_with_optimizer(param_fn, optimizer_fn, optimizer, splat_data);
+        splat_data.append_gaussian_ids(sampled_idxs.size(0));
+    }
+
+    void split_gaussians(
+        const torch::Tensor& is_split,
+        std::unique_ptr<torch::optim::Optimizer>& optimizer,
+        gs::SplatData& splat_data,
+        bool revised_opacity) {
+        torch::NoGradGuard no_grad;
+
+        const c10::Device device = is_split.device();
+        const torch::Tensor sampled_idxs = is_split.nonzero().squeeze(-1);
+        const torch::Tensor rest_idxs = is_split.logical_not().nonzero().squeeze(-1);
+
+        const torch::Tensor sampled_scales = splat_data.get_scaling().index_select(0, sampled_idxs);
+        const torch::Tensor sampled_quats = splat_data.get_rotation().index_select(0, sampled_idxs);
+        const torch::Tensor rotmats = gsplat::quats_to_rotmats(sampled_quats); // [N, 3, 3]
+
+        const auto num_split_gaussians = sampled_idxs.size(0);
+        constexpr auto split_size = 2;
+        const torch::Tensor samples = torch::einsum( // [split_size, N, 3]
+            "nij,nj,bnj->bni",
+            {rotmats,
+             sampled_scales,
+             torch::randn({split_size, num_split_gaussians, 3}, sampled_quats.options().device(device))});
+
+        const auto param_fn = [revised_opacity, &sampled_idxs, &rest_idxs, &samples, &sampled_scales](
+                                  const int i, const torch::Tensor& param) {
+            std::vector<int64_t> repeats(param.dim(), 1);
+            repeats[0] = split_size;
+
+            const torch::Tensor sampled_param = param.index_select(0, sampled_idxs);
+            torch::Tensor split_param;
+            if (i == 0) {
+                // means
+                split_param = (sampled_param.unsqueeze(0) + samples).reshape({-1, 3}); // [split_size * N, 3]
+            } else if (i == 3) {
+                // scaling
+                split_param = torch::log(sampled_scales / 1.6).repeat({split_size, 1}); // [split_size * N, 3]
+            } else if (i == 5 && revised_opacity) {
+                // opacity
+                const torch::Tensor new_opacities = 1.0 - torch::sqrt(1.0 - torch::sigmoid(sampled_param));
+                split_param = torch::logit(new_opacities).repeat(repeats); // [split_size * N]
+            } else {
+                split_param = sampled_param.repeat(repeats);
+            }
+
+            // split_param is gathered already, compacting the survivors in place is safe
+            return append_rows(keep_rows(param, rest_idxs), split_param).set_requires_grad(param.requires_grad());
+        };
+
+        const auto optimizer_fn = [&sampled_idxs, &rest_idxs](
+                                      torch::optim::OptimizerParamState& state,
+                                      const torch::Tensor& full_param)
+            -> std::unique_ptr<torch::optim::OptimizerParamState> {
+            auto zero_shape = full_param.sizes().vec();
+            zero_shape[0] = sampled_idxs.size(0) * split_size;
+            if (auto* fused_adam_state = dynamic_cast<FusedAdam::AdamParamState*>(&state)) {
+                // FusedAdam state
+                auto rest_exp_avg = keep_rows(fused_adam_state->exp_avg, rest_idxs);
+                auto rest_exp_avg_sq = keep_rows(fused_adam_state->exp_avg_sq, rest_idxs);
+
+                auto zeros_to_add = torch::zeros(zero_shape, fused_adam_state->exp_avg.options());
+                auto new_exp_avg = append_rows(rest_exp_avg, zeros_to_add);
+                auto new_exp_avg_sq = append_rows(rest_exp_avg_sq, zeros_to_add);
+
+                // Create new state
+                auto new_state = std::make_unique<FusedAdam::AdamParamState>();
+                new_state->step_count = fused_adam_state->step_count;
+                new_state->exp_avg = new_exp_avg;
+                new_state->exp_avg_sq = new_exp_avg_sq;
+                if (fused_adam_state->max_exp_avg_sq.defined()) {
+                    auto rest_max_exp_avg_sq = keep_rows(fused_adam_state->max_exp_avg_sq, rest_idxs);
+                    auto new_max_exp_avg_sq = append_rows(rest_max_exp_avg_sq, zeros_to_add);
+                    new_state->max_exp_avg_sq = new_max_exp_avg_sq;
+                }
+                return new_state;
+            }
+            return nullptr;
+        };
+
+        update_param_with_optimizer(param_fn, optimizer_fn, optimizer, splat_data);
+        // Both halves of a split are new Gaussians
+        if (splat_data._gaussian_ids.defined()) {
+            splat_data._gaussian_ids = keep_rows(splat_data._gaussian_ids, rest_idxs);
+            splat_data.append_gaussian_ids(num_split_gaussians * split_size);
+        }
+    }
+
+    void reset_opacities(
+        std::unique_ptr<torch::optim::Optimizer>& optimizer,
+        gs::SplatData& splat_data,
+        float threshold) {
+        torch::NoGradGuard no_grad;
+
+        // In place, the opacity and its moments keep their allocations and the optimizer its keys
+        std::vector<torch::Tensor> moments;
+        const auto state_it = optimizer->state().find(optimizer->param_groups()[5].params()[0].unsafeGetTensorImpl());
+        if (state_it != optimizer->state().end()) {
+            if (const auto* fused_adam_state = dynamic_cast<FusedAdam::AdamParamState*>(state_it->second.get())) {
+                moments.push_back(fused_adam_state->exp_avg);
+                moments.push_back(fused_adam_state->exp_avg_sq);
+                if (fused_adam_state->max_exp_avg_sq.defined()) {
+                    moments.push_back(fused_adam_state->max_exp_avg_sq);
+                }
+            }
+        }
+        const float max_raw_opacity = std::log(threshold / (1.0f - threshold));
+        gsplat::reset_opacities(splat_data.opacity_raw(), max_raw_opacity, moments);
+    }
+
+    int64_t compact_gaussians(
+        const torch::Tensor& keep_mask,
+        std::unique_ptr<torch::optim::Optimizer>& optimizer,
+        gs::SplatData& splat_data) {
+        torch::NoGradGuard no_grad;
+
+        const torch::Tensor keep_idxs = keep_mask.nonzero().squeeze(-1);
+        const int64_t n_kept = keep_idxs.numel();
+
+        std::vector<torch::Tensor> rows = {
+            splat_data.means(),
+            splat_data.sh0(),
+            splat_data.shN(),
+            splat_data.scaling_raw(),
+            splat_data.rotation_raw(),
+            splat_data.opacity_raw()};
+        for (size_t i = 0; i < 6; ++i) {
+            const auto state_it = optimizer->state().find(optimizer->param_groups()[i].params()[0].unsafeGetTensorImpl());
+            if (state_it == optimizer->state().end()) {
+                continue;
+            }
+            const auto* fused_adam_state = static_cast<FusedAdam::AdamParamState*>(state_it->second.get());
+            rows.push_back(fused_adam_state->exp_avg);
+            rows.push_back(fused_adam_state->exp_avg_sq);
+            if (fused_adam_state->max_exp_avg_sq.defined()) {
+                rows.push_back(fused_adam_state->max_exp_avg_sq);
+            }
+        }
+        gsplat::compact_rows(keep_idxs, rows);
+
+        // The kept rows are already in place, only the tensors shrink to them
+        const auto param_fn = [n_kept](const int i, const torch::Tensor& param) {
+            return rows_view(param, n_kept).set_requires_grad(param.requires_grad());
+        };
+
+        const auto optimizer_fn = [n_kept](
+                                      torch::optim::OptimizerParamState& state,
+                                      const torch::Tensor& new_param)
+            -> std::unique_ptr<torch::optim::OptimizerParamState> {
+            if (auto* fused_adam_state = dynamic_cast<FusedAdam::AdamParamState*>(&state)) {
+                auto new_state = std::make_unique<FusedAdam::AdamParamState>();
+                new_state->step_count = fused_adam_state->step_count;
+                new_state->exp_avg = rows_view(fused_adam_state->exp_avg, n_kept);
+                new_state->exp_avg_sq = rows_view(fused_adam_state->exp_avg_sq, n_kept);
+                if (fused_adam_state->max_exp_avg_sq.defined()) {
+                    new_state->max_exp_avg_sq = rows_view(fused_adam_state->max_exp_avg_sq, n_kept);
+                }
+                return new_state;
+            }
+            return nullptr;
+        };
+
+        update_param_with_optimizer(param_fn, optimizer_fn, optimizer, splat_data);
+        if (splat_data._gaussian_ids.defined()) {
+            splat_data._gaussian_ids = keep_rows(splat_data._gaussian_ids, keep_idxs);
+        }
+        // Statistics still matching the Gaussians stay aligned, stale ones are reset by the strategy
+        for (auto* statistics : {&splat_data._densification_info, &splat_data._max_contribution}) {
+            if (statistics->defined() && statistics->size(0) == keep_mask.size(0)) {
+                *statistics = keep_rows(*statistics, keep_idxs);
+            }
+        }
+        return n_kept;
+    }
+
+    void permute_gaussians(
+        const torch::Tensor& order,
+        std::unique_ptr<torch::optim::Optimizer>& optimizer,
+        gs::SplatData& splat_data) {
+        torch::NoGradGuard no_grad;
+        TORCH_CHECK(order.numel() == splat_data.size(), "permutation must have one index per Gaussian");
+
+        // With an SH codebook the palette rows are shared, only the labels follow the Gaussians.
+        // Low-rank SH moves the weights, the optimizer state of the shN group is theirs.
+        const bool codebook = splat_data.has_sh_codebook();
+        const bool basis = splat_data.has_sh_basis();
+        std::vector<torch::Tensor> rows = {
+            splat_data.means(),
+            splat_data.sh0(),
+            codebook ? splat_data._sh_labels : basis ? splat_data._sh_coeffs : splat_data.shN(),
+            splat_data.scaling_raw(),
+            splat_data.rotation_raw(),
+            splat_data.opacity_raw()};
+        for (size_t i = 0; i < 6; ++i) {
+            if (codebook && i == 2) {
+                continue;
+            }
+            const auto state_it = optimizer->state().find(optimizer->param_groups()[i].params()[0].unsafeGetTensorImpl());
+            if (state_it == optimizer->state().end()) {
+                continue;
+            }
+            const auto* fused_adam_state = static_cast<FusedAdam::AdamParamState*>(state_it->second.get());
+            rows.push_back(fused_adam_state->exp_avg);
+            rows.push_back(fused_adam_state->exp_avg_sq);
+            if (fused_adam_state->max_exp_avg_sq.defined()) {
+                rows.push_back(fused_adam_state->max_exp_avg_sq);
+            }
+        }
+        if (splat_data._densification_info.defined() && splat_data._densification_info.size(0) == splat_data.size()) {
+            rows.push_back(splat_data._densification_info);
+        }
+        if (splat_data._max_contribution.defined() && splat_data._max_contribution.size(0) == splat_data.size()) {
+            rows.push_back(splat_data._max_contribution);
+        }
+        if (splat_data._gaussian_ids.defined()) {
+            rows.push_back(splat_data._gaussian_ids);
+        }
+
+        for (auto& row : rows) {
+            row.copy_(row.index_select(0, order));
+        }
+        if (codebook) {
+            splat_data.gather_sh_codebook();
+        } else if (basis) {
+            splat_data.expand_sh_basis();
+        }
+    }
+
+    void quantize_sh_codebook(
+        const int codebook_size,
+        std::unique_ptr<torch::optim::Optimizer>& optimizer,
+        gs::SplatData& splat_data) {
+        torch::NoGradGuard no_grad;
+
+        const auto& shN = splat_data.shN();
+        const int64_t n = splat_data.size();
+        if (splat_data.has_sh_codebook() || splat_data.has_sh_basis() || shN.numel() == 0) {
+            return;
+        }
+        const int k = static_cast<int>(std::min<int64_t>(codebook_size, n));
+
+        auto [centroids, labels] = gs::cuda::kmeans(shN.reshape({n, -1}).to(torch::kFloat32), k);
+        auto palette = centroids.view({k, shN.size(1), 3}).to(shN.scalar_type());
+        // Bands progressive SH storage hasn't allocated yet get their palette columns now, still zero
+        const int max_degree = splat_data.get_max_sh_degree();
+        if (const int64_t bases = (max_degree + 1) * (max_degree + 1) - 1; palette.size(1) < bases) {
+            palette = torch::cat({palette, torch::zeros({k, bases - palette.size(1), 3}, palette.options())}, 1);
+        }
+        palette = palette.contiguous().set_requires_grad(true);
+
+        // The palette starts with fresh moments, and its rows are not Gaussians, so no visibility mask
+        auto& group = optimizer->param_groups()[2];
+        optimizer->state().erase(group.params()[0].unsafeGetTensorImpl());
+        group.params()[0] = palette;
+        static_cast<FusedAdam::Options&>(group.options()).dense(true);
+
+        splat_data._sh_palette = palette;
+        splat_data._sh_labels = labels.to(torch::kInt32);
+        splat_data.gather_sh_codebook();
+
+        LOG_INFO("SH codebook: {} Gaussians share {} shN entries", n, k);
+    }
+
+    void factor_sh_basis(
+        const int rank,
+        std::unique_ptr<torch::optim::Optimizer>& optimizer,
+        gs::SplatData& splat_data) {
+        torch::NoGradGuard no_grad;
+
+        const auto& shN = splat_data.shN();
+        const int64_t n = splat_data.size();
+        if (splat_data.has_sh_basis() || splat_data.has_sh_codebook() || shN.numel() == 0) {
+            return;
+        }
+
+        // Bands progressive SH storage hasn't allocated yet join the basis as zero columns
+        auto coefficients = shN.to(torch::kFloat32);
+        const int max_degree = splat_data.get_max_sh_degree();
+        if (const int64_t bases = (max_degree + 1) * (max_degree + 1) - 1; coefficients.size(1) < bases) {
+            coefficients = torch::cat({coefficients, torch::zeros({n, bases - coefficients.size(1), 3}, coefficients.options())}, 1);
+        }
+        const auto rows = coefficients.reshape({n, -1});
+        const int64_t r = std::min<int64_t>(rank, rows.size(1));
+
+        // The eigenvectors of the small Gram matrix are the right singular vectors of the rows, so
+        // the [N, C * 3] matrix itself is never decomposed. eigh sorts ascending.
+        const auto [eigenvalues, eigenvectors] = torch::linalg_eigh(torch::matmul(rows.t(), rows));
+        const auto vectors = eigenvectors.narrow(1, eigenvectors.size(1) - r, r).flip({1});
+        const float kept = (eigenvalues.narrow(0, eigenvalues.size(0) - r, r).sum() /
+                            eigenvalues.sum().clamp_min(1e-12f))
+                               .item<float>();
+
+        const auto weights = torch::matmul(rows, vectors).to(shN.scalar_type()).contiguous().set_requires_grad(true);
+        const auto basis = vectors.t().reshape({r, coefficients.size(1), 3}).to(shN.scalar_type()).contiguous().set_requires_grad(true);
+
+        // Both start with fresh moments. The weights step sparsely with the visible Gaussians, the
+        // basis has R rows and so always steps densely.
+        auto& group = optimizer->param_groups()[2];
+        optimizer->state().erase(group.params()[0].unsafeGetTensorImpl());
+        group.params() = {weights, basis};
+
+        splat_data._sh_coeffs = weights;
+        splat_data._sh_basis = basis;
+        splat_data.expand_sh_basis();
+
+        LOG_INFO("Low-rank SH: {} Gaussians weight {} shared basis vectors, {:.1f}% of the shN energy kept",
+                 n, r, 100.0f * kept);
+    }
+
+    namespace {
+        // Param group order used by every strategy's optimizer
+        constexpr std::array<const char*, 6> PARAM_NAMES = {"means", "sh0", "shN", "scaling", "rotation", "opacity"};
+    } // namespace
+
+    void save_strategy_checkpoint(
+        const torch::optim::Optimizer& optimizer,
+        const gs::SplatData& splat_data,
+        TrainingCheckpoint& checkpoint) {
+        const auto& groups = optimizer.param_groups();
+
+        nlohmann::json groups_meta = nlohmann::json::array();
+        for (size_t i = 0; i < PARAM_NAMES.size(); ++i) {
+            const std::string name = PARAM_NAMES[i];
+            const auto& param = groups[i].params()[0];
+            if (i == 2 && splat_data.has_sh_codebook()) {
+                // Dense shN keeps the checkpoint loadable as a plain model, the moments are palette rows
+                checkpoint.put("model.shN", splat_data.shN().detach());
+                checkpoint.put("model.sh_palette", param);
+                checkpoint.put("model.sh_labels", splat_data._sh_labels);
+            } else if (i == 2 && splat_data.has_sh_basis()) {
+                // Likewise, the moments are those of the weights and the basis keeps its own
+                checkpoint.put("model.shN", splat_data.shN().detach());
+                checkpoint.put("model.sh_coeffs", param);
+                checkpoint.put("model.sh_basis", splat_data._sh_basis);
+            } else {
+                checkpoint.put("model." + name, param);
+            }
+
+            nlohmann::json group_meta = {
+                {"name", name},
+                {"lr", static_cast<const FusedAdam::Options&>(groups[i].options()).lr()}};
+
+            const auto state_it = optimizer.state().find(param.unsafeGetTensorImpl());
+            if (state_it != optimizer.state().end()) {
+                const auto& state = static_cast<const FusedAdam::AdamParamState&>(*state_it->second);
+                checkpoint.put("optimizer." + name + ".exp_avg", state.exp_avg);
+                checkpoint.put("optimizer." + name + ".exp_avg_sq", state.exp_avg_sq);
+                group_meta["step"] = state.step_count;
+            }
+            if (i == 2 && splat_data.has_sh_basis()) {
+                const auto basis_it = optimizer.state().find(splat_data._sh_basis.unsafeGetTensorImpl());
+                if (basis_it != optimizer.state().end()) {
+                    const auto& state = static_cast<const FusedAdam::AdamParamState&>(*basis_it->second);
+                    checkpoint.put("optimizer.sh_basis.exp_avg", state.exp_avg);
+                    checkpoint.put("optimizer.sh_basis.exp_avg_sq", state.exp_avg_sq);
+                    group_meta["basis_step"] = state.step_count;
+                }
+            }
+            groups_meta.push_back(std::move(group_meta));
+        }
+
+        if (splat_data._densification_info.defined() && splat_data._densification_info.numel() > 0) {
+            checkpoint.put("model.densification_info", splat_data._densification_info);
+        }
+
+        checkpoint.meta()["model"] = {
+            {"num_gaussians", splat_data.size()},
+            {"active_sh_degree", splat_data.get_active_sh_degree()}};
+        checkpoint.meta()["optimizer"] = std::move(groups_meta);
+    }
+
+    std::expected<void, std::string> load_strategy_checkpoint(
+        torch::optim::Optimizer& optimizer,
+        gs::SplatData& splat_data,
+        const TrainingCheckpoint& checkpoint) {
+        torch::NoGradGuard no_grad;
+
+        const auto& groups_meta = checkpoint.meta().value("optimizer", nlohmann::json::array());
+        if (groups_meta.size() != PARAM_NAMES.size() || optimizer.param_groups().size() < PARAM_NAMES.size()) {
+            return std::unexpected("Checkpoint optimizer state does not match the strategy");
+        }
+
+        std::array<torch::Tensor*, 6> model_params = {
+            &splat_data.means(),
+            &splat_data.sh0(),
+            &splat_data.shN(),
+            &splat_data.scaling_raw(),
+            &splat_data.rotation_raw(),
+            &splat_data.opacity_raw()};
+
+        // Validate everything before touching the optimizer, a failed resume leaves it untouched
+        std::array<torch::Tensor, 6> params;
+        for (size_t i = 0; i < PARAM_NAMES.size(); ++i) {
+            const std::string name = PARAM_NAMES[i];
+            params[i] = checkpoint.get("model." + name);
+            if (!params[i].defined()) {
+                return std::unexpected(std::format("Checkpoint is missing model.{}", name));
+            }
+            const auto& current = optimizer.param_groups()[i].params()[0];
+            // A run may resume with a different sh_precision, the current storage dtype wins
+            params[i] = params[i].to(current.scalar_type());
+            // With progressive SH storage, either side may hold fewer bands than the max degree
+            const int max_degree = splat_data.get_max_sh_degree();
+            const bool sh_bands_differ = i == 2 && params[i].dim() == 3 && current.dim() == 3 &&
+                                         params[i].size(2) == current.size(2) &&
+                                         params[i].size(1) <= (max_degree + 1) * (max_degree + 1) - 1;
+            if (!sh_bands_differ &&
+                (params[i].dim() != current.dim() || params[i].sizes().slice(1) != current.sizes().slice(1))) {
+                return std::unexpected(std::format(
+                    "Checkpoint model.{} has shape {} but the model expects {} (different SH degree?)",
+                    name, c10::str(params[i].sizes()), c10::str(current.sizes())));
+            }
+        }
+
+        auto sh_palette = checkpoint.get("model.sh_palette");
+        auto sh_labels = checkpoint.get("model.sh_labels");
+        if (sh_palette.defined() != sh_labels.defined() ||
+            (sh_labels.defined() && (sh_labels.numel() != params[0].size(0) ||
+                                     sh_palette.sizes().slice(1) != params[2].sizes().slice(1)))) {
+            return std::unexpected("Checkpoint SH codebook is incomplete");
+        }
+        auto sh_coeffs = checkpoint.get("model.sh_coeffs");
+        auto sh_basis = checkpoint.get("model.sh_basis");
+        if (sh_coeffs.defined() != sh_basis.defined() ||
+            (sh_basis.defined() && (sh_coeffs.dim() != 2 || sh_coeffs.size(0) != params[0].size(0) ||
+                                    sh_basis.dim() != 3 || sh_basis.size(0) != sh_coeffs.size(1) ||
+                                    sh_basis.sizes().slice(1) != params[2].sizes().slice(1)))) {
+            return std::unexpected("Checkpoint low-rank SH is incomplete");
+        }
+        splat_data._sh_palette = torch::Tensor();
+        splat_data._sh_labels = torch::Tensor();
+        splat_data._sh_coeffs = torch::Tensor();
+        splat_data._sh_basis = torch::Tensor();
+
+        for (size_t i = 0; i < PARAM_NAMES.size(); ++i) {
+            const std::string name = PARAM_NAMES[i];
+            auto& group = optimizer.param_groups()[i];
+
+            for (const auto& param : group.params()) {
+                optimizer.state().erase(param.unsafeGetTensorImpl());
+            }
+            *model_params[i] = params[i];
+            if (i == 2 && sh_palette.defined()) {
+                // The optimizer trains the palette, shN is gathered from it
+                params[i] = sh_palette.to(params[i].scalar_type());
+                splat_data._sh_palette = params[i];
+                splat_data._sh_labels = sh_labels.to(torch::kInt32);
+                static_cast<FusedAdam::Options&>(group.options()).dense(true);
+            }
+            params[i].set_requires_grad(true);
+            group.params() = {params[i]};
+            if (i == 2 && sh_basis.defined()) {
+                // The optimizer trains the weights and the basis, shN is expanded from them
+                params[i] = sh_coeffs.to(params[i].scalar_type()).contiguous().set_requires_grad(true);
+                auto basis = sh_basis.to(params[i].scalar_type()).contiguous().set_requires_grad(true);
+                splat_data._sh_coeffs = params[i];
+                splat_data._sh_basis = basis;
+                group.params() = {params[i], basis};
+                if (checkpoint.contains("optimizer.sh_basis.exp_avg")) {
+                    auto state = std::make_unique<FusedAdam::AdamParamState>();
+                    const auto moment_dtype = fast_gs::optimizer::moment_dtype(basis.scalar_type());
+                    state->exp_avg = checkpoint.get("optimizer.sh_basis.exp_avg").to(moment_dtype);
+                    state->exp_avg_sq = checkpoint.get("optimizer.sh_basis.exp_avg_sq").to(moment_dtype);
+                    state->step_count = groups_meta[i].value("basis_step", int64_t{0});
+                    optimizer.state()[basis.unsafeGetTensorImpl()] = std::move(state);
+                }
+            }
+
+            static_cast<FusedAdam::Options&>(group.options()).lr(groups_meta[i].at("lr").get<double>());
+
+            if (checkpoint.contains("optimizer." + name + ".exp_avg")) {
+                auto state = std::make_unique<FusedAdam::AdamParamState>();
+                const auto moment_dtype = fast_gs::optimizer::moment_dtype(params[i].scalar_type());
+                state->exp_avg = checkpoint.get("optimizer." + name + ".exp_avg").to(moment_dtype);
+                state->exp_avg_sq = checkpoint.get("optimizer." + name + ".exp_avg_sq").to(moment_dtype);
+                state->step_count = groups_meta[i].value("step", int64_t{0});
+                optimizer.state()[params[i].unsafeGetTensorImpl()] = std::move(state);
+            }
+        }
+
+        // Checkpoints from before the [N, 2] half layout restart the statistics
+        auto densification_info = checkpoint.get("model.densification_info");
+        if (densification_info.defined() && densification_info.dim() == 2 &&
+            densification_info.size(0) == splat_data.size() && densification_info.size(1) == 2) {
+            splat_data._densification_info = densification_info.to(torch::kHalf);
+        } else if (splat_data._densification_info.numel() > 0) {
+            splat_data._densification_info = zero_densification_info(splat_data.size(), splat_data.means().device());
+        }
+        if (splat_data._max_contribution.numel() > 0) {
+            splat_data._max_contribution = reset_max_contribution(splat_data.size(), splat_data.means().device());
+        }
+
+        const auto& model_meta = checkpoint.meta().value("model", nlohmann::json::object());
+        splat_data.set_active_sh_degree(model_meta.value("active_sh_degree", 0));
+        if (splat_data.has_sh_codebook()) {
+            splat_data.gather_sh_codebook();
+        } else if (splat_data.has_sh_basis()) {
+            splat_data.expand_sh_basis();
+        }
+        // Ids are not checkpointed, the next delta save after a resume is a keyframe
+        if (splat_data._gaussian_ids.defined()) {
+            splat_data.enable_gaussian_ids();
+        }
+        return {};
+    }
 } // namespace gs::training
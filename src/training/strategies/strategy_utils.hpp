@@ -6,11 +6,39 @@
 
 #include "istrategy.hpp"
 #include "optimizers/scheduler.hpp"
+#include <expected>
 #include <memory>
+#include <string>
 #include <torch/torch.h>
 
 namespace gs::training {
-    void initialize_gaussians(gs::SplatData& splat_data);
+    class TrainingCheckpoint;
+
+    // Storage dtype of shN for the sh_precision option
+    torch::ScalarType sh_storage_dtype(const std::string& sh_precision);
+
+    // Zeroed [n, 2] half (visible count, mean2d gradient norm sum) statistics the fastgs backward
+    // accumulates for densification
+    torch::Tensor zero_densification_info(int64_t n, const torch::Device& device);
+
+    // [n] float of -1, the restarted max_contribution tracker the fastgs backward raises per Gaussian
+    torch::Tensor reset_max_contribution(int64_t n, const torch::Device& device);
+
+    // [N] bool, the Gaussians rasterized since the tracker restarted whose largest blending weight
+    // stayed below threshold. All false without a tracker matching the Gaussians.
+    torch::Tensor is_low_contribution(const gs::SplatData& splat_data, float threshold);
+
+    void initialize_gaussians(gs::SplatData& splat_data, torch::ScalarType sh_dtype = torch::kFloat32);
+
+    // Progressive SH storage: keeps only the shN bands up to the active degree, call before the
+    // optimizer takes shN. grow_sh_degree allocates the others as they activate.
+    void drop_inactive_sh_bands(gs::SplatData& splat_data);
+
+    // Raises the active SH degree by one. Without its band in shN yet, shN and its moments widen
+    // by it first; the new coefficients and moments start at zero, what an unread band held before.
+    void grow_sh_degree(
+        std::unique_ptr<torch::optim::Optimizer>& optimizer,
+        gs::SplatData& splat_data);
 
     std::unique_ptr<torch::optim::Optimizer> create_optimizer(
         gs::SplatData& splat_data,
@@ -32,4 +60,73 @@ namespace gs::training {
         std::unique_ptr<torch::optim::Optimizer>& optimizer,
         gs::SplatData& splat_data,
         std::vector<size_t> param_idxs = {0, 1, 2, 3, 4, 5});
+
+    // Appends a copy of every Gaussian set in is_duplicated [N], the copies start with zero moments
+    void duplicate_gaussians(
+        const torch::Tensor& is_duplicated,
+        std::unique_ptr<torch::optim::Optimizer>& optimizer,
+        gs::SplatData& splat_data);
+
+    // Replaces every Gaussian set in is_split [N] by two samples from it with 1.6x smaller scales
+    // (and the revised opacity of "Revising Densification in Gaussian Splatting" if requested)
+    void split_gaussians(
+        const torch::Tensor& is_split,
+        std::unique_ptr<torch::optim::Optimizer>& optimizer,
+        gs::SplatData& splat_data,
+        bool revised_opacity);
+
+    // Clamps every opacity to at most threshold and restarts the opacity moments, in place in one
+    // kernel so neither the reset nor the next step allocates
+    void reset_opacities(
+        std::unique_ptr<torch::optim::Optimizer>& optimizer,
+        gs::SplatData& splat_data,
+        float threshold);
+
+    // Prunes every Gaussian outside keep_mask [N] from the six parameters and their optimizer
+    // moments together, compacting in place so the allocations keep their reserve. Returns the
+    // new count, reading it back is the only host sync.
+    int64_t compact_gaussians(
+        const torch::Tensor& keep_mask,
+        std::unique_ptr<torch::optim::Optimizer>& optimizer,
+        gs::SplatData& splat_data);
+
+    // Reorders the Gaussians to order [N] (a permutation) in place: the six parameters, their
+    // optimizer moments and the densification statistics move together, the tensors keep their
+    // identity so the optimizer state stays keyed to them
+    void permute_gaussians(
+        const torch::Tensor& order,
+        std::unique_ptr<torch::optim::Optimizer>& optimizer,
+        gs::SplatData& splat_data);
+
+    // Clusters shN into codebook_size entries and hands the optimizer the palette in place of shN:
+    // the shN group then holds K rows of parameter, gradient and moments instead of N and steps
+    // densely. The Gaussian count must not change afterwards.
+    void quantize_sh_codebook(
+        int codebook_size,
+        std::unique_ptr<torch::optim::Optimizer>& optimizer,
+        gs::SplatData& splat_data);
+
+    // Factors shN into per-Gaussian weights [N, R] over R shared basis vectors, the leading right
+    // singular vectors of the [N, C * 3] coefficients, and hands the optimizer both in place of
+    // shN. The shN group then holds R columns of parameter, gradient and moments per Gaussian
+    // instead of C * 3. The Gaussian count must not change afterwards.
+    void factor_sh_basis(
+        int rank,
+        std::unique_ptr<torch::optim::Optimizer>& optimizer,
+        gs::SplatData& splat_data);
+
+    // Checkpoint layout shared by the strategies: the six Gaussian parameters with their FusedAdam
+    // moments and step counts, each group's current learning rate, the active SH degree and
+    // the densification statistics. With an SH codebook or low-rank SH, model.shN is the gathered
+    // or expanded shN and the palette and labels, or the weights and basis, are stored next to it.
+    void save_strategy_checkpoint(
+        const torch::optim::Optimizer& optimizer,
+        const gs::SplatData& splat_data,
+        TrainingCheckpoint& checkpoint);
+
+    // Swaps the checkpointed tensors into splat_data and the optimizer's param groups
+    std::expected<void, std::string> load_strategy_checkpoint(
+        torch::optim::Optimizer& optimizer,
+        gs::SplatData& splat_data,
+        const TrainingCheckpoint& checkpoint);
 } // namespace gs::training
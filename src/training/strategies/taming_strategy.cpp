@@ -0,0 +1,190 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "taming_strategy.hpp"
+#include "checkpoint.hpp"
+#include "core/logger.hpp"
+#include "core/parameters.hpp"
+#include "optimizers/fused_adam.hpp"
+#include "rasterization/rasterizer.hpp"
+#include "strategy_utils.hpp"
+#include "vram_manager.hpp"
+#include <algorithm>
+#include <format>
+
+namespace gs::training {
+    TamingStrategy::TamingStrategy(gs::SplatData&& splat_data)
+        : _splat_data(std::move(splat_data)) {
+    }
+
+    void TamingStrategy::initialize(const gs::param::OptimizationParameters& optimParams) {
+        _params = std::make_unique<const gs::param::OptimizationParameters>(optimParams);
+
+        initialize_gaussians(_splat_data, sh_storage_dtype(_params->sh_precision));
+        if (_params->progressive_sh) {
+            drop_inactive_sh_bands(_splat_data);
+        }
+        _initial_count = _splat_data.size();
+        // The schedule ends at max_cap, growth only ever writes into this allocation
+        _splat_data.reserve(std::max<int64_t>(_params->max_cap, _initial_count));
+
+        _optimizer = create_optimizer(_splat_data, *_params);
+        _scheduler = create_scheduler(*_params, _optimizer.get(), 0);
+    }
+
+    bool TamingStrategy::is_refining(int iter) const {
+        return (iter < _params->stop_refine &&
+                iter > _params->start_refine &&
+                iter % _params->refine_every == 0);
+    }
+
+    int64_t TamingStrategy::target_count(int iter) const {
+        const int64_t budget = std::max<int64_t>(_params->max_cap, _initial_count);
+        const double span = std::max<double>(1.0, static_cast<double>(_params->stop_refine) - _params->start_refine);
+        const double t = std::clamp((iter - static_cast<double>(_params->start_refine)) / span, 0.0, 1.0);
+        // Front-loaded: most Gaussians arrive early, while the learning rates are still high
+        const double progress = 1.0 - (1.0 - t) * (1.0 - t);
+        return _initial_count + static_cast<int64_t>(progress * static_cast<double>(budget - _initial_count));
+    }
+
+    torch::Tensor TamingStrategy::importance_scores() const {
+        // The screen-space positional gradient says where the reconstruction is still wrong,
+        // weighting it by opacity favors Gaussians that actually contribute to the views
+        const torch::Tensor info = _splat_data._densification_info.to(torch::kFloat);
+        const torch::Tensor mean_grads = info.select(1, 1) / torch::clamp_min(info.select(1, 0), 1.0f);
+        return mean_grads * _splat_data.get_opacity().reshape({-1});
+    }
+
+    void TamingStrategy::grow_gs(int iter) {
+        torch::NoGradGuard no_grad;
+
+        const int64_t n = _splat_data.size();
+        // Duplicating and splitting add one Gaussian each, and each Gaussian grows once per refinement
+        const int64_t num_new = std::min(target_count(iter) - n, n);
+        if (num_new <= 0) {
+            return;
+        }
+
+        const torch::Tensor scores = importance_scores();
+        auto [top_scores, top_idxs] = scores.topk(num_new);
+        top_idxs = top_idxs.index({top_scores > 0.0f});
+        const torch::Tensor is_grown = torch::zeros({n}, scores.options().dtype(torch::kBool)).index_fill_(0, top_idxs, true);
+
+        const auto max_values = std::get<0>(torch::max(_splat_data.get_scaling(), -1));
+        const torch::Tensor is_small = max_values <= _params->grow_scale3d * _splat_data.get_scene_scale();
+        const torch::Tensor is_duplicated = is_grown & is_small;
+        const auto num_duplicates = is_duplicated.sum().item<int64_t>();
+        torch::Tensor is_split = is_grown & ~is_small;
+        const auto num_split = is_split.sum().item<int64_t>();
+        VramManager::get().reserve_growth(num_duplicates + num_split);
+
+        if (num_duplicates > 0) {
+            duplicate_gaussians(is_duplicated, _optimizer, _splat_data);
+        }
+
+        // New Gaussians added by duplication will not be split
+        is_split = torch::cat({is_split,
+                               torch::zeros(num_duplicates, is_split.options())});
+        if (num_split > 0) {
+            split_gaussians(is_split, _optimizer, _splat_data, _params->revised_opacity);
+        }
+        LOG_DEBUG("Taming: grew {} -> {} Gaussians (target {})", n, _splat_data.size(), target_count(iter));
+    }
+
+    void TamingStrategy::prune_gs() {
+        torch::NoGradGuard no_grad;
+
+        torch::Tensor is_prune = _splat_data.get_opacity().reshape({-1}) < _params->prune_opacity;
+        const auto rotation_raw = _splat_data.rotation_raw();
+        is_prune |= (rotation_raw * rotation_raw).sum(-1) < 1e-8f;
+
+        if (is_prune.any().item<bool>()) {
+            compact_gaussians(is_prune.logical_not(), _optimizer, _splat_data);
+        }
+    }
+
+    void TamingStrategy::remove_gaussians(const torch::Tensor& mask) {
+        torch::NoGradGuard no_grad;
+
+        if (mask.sum().item<int>() == 0) {
+            LOG_DEBUG("No Gaussians to remove");
+            return;
+        }
+
+        LOG_DEBUG("Taming: Removing {} Gaussians", mask.sum().item<int>());
+        compact_gaussians(mask.logical_not(), _optimizer, _splat_data);
+    }
+
+    void TamingStrategy::reorder_gaussians(const torch::Tensor& order) {
+        permute_gaussians(order, _optimizer, _splat_data);
+    }
+
+    void TamingStrategy::quantize_sh(const int codebook_size) {
+        quantize_sh_codebook(codebook_size, _optimizer, _splat_data);
+    }
+
+    void TamingStrategy::factor_sh(const int rank) {
+        factor_sh_basis(rank, _optimizer, _splat_data);
+    }
+
+    void TamingStrategy::post_backward(int iter, RenderOutput& render_output) {
+        torch::NoGradGuard no_grad;
+        if (iter % _params->sh_degree_interval == 0) {
+            grow_sh_degree(_optimizer, _splat_data);
+        }
+
+        if (iter == _params->stop_refine) {
+            // The statistics are only needed while the model grows
+            _splat_data._densification_info = torch::empty({0});
+        }
+
+        if (iter >= _params->stop_refine) {
+            return;
+        }
+
+        if (is_refining(iter)) {
+            VramManager::get().begin_refinement(_splat_data.size());
+            grow_gs(iter);
+            prune_gs();
+
+            _splat_data._densification_info = zero_densification_info(_splat_data.size(),
+                                                                      _splat_data.means().device());
+        }
+
+        if (iter % _params->reset_every == 0 && iter > 0) {
+            reset_opacities(_optimizer, _splat_data, 2.0f * _params->prune_opacity);
+        }
+    }
+
+    void TamingStrategy::step(int iter) {
+        if (iter < _params->iterations) {
+            auto* fused_adam = dynamic_cast<FusedAdam*>(_optimizer.get());
+            fused_adam->step(iter);
+            fused_adam->zero_grad(true, iter);
+            _scheduler->step();
+        }
+    }
+
+    void TamingStrategy::set_optimizer_visibility(const torch::Tensor& visibility) {
+        dynamic_cast<FusedAdam*>(_optimizer.get())->set_visibility(visibility);
+    }
+
+    void TamingStrategy::save_checkpoint(TrainingCheckpoint& checkpoint) const {
+        save_strategy_checkpoint(*_optimizer, _splat_data, checkpoint);
+        checkpoint.meta()["strategy"] = "taming";
+        checkpoint.meta()["taming_initial_count"] = _initial_count;
+    }
+
+    std::expected<void, std::string> TamingStrategy::load_checkpoint(const TrainingCheckpoint& checkpoint) {
+        if (const auto strategy = checkpoint.meta().value("strategy", ""); strategy != "taming") {
+            return std::unexpected(std::format("Checkpoint was written by the '{}' strategy, not 'taming'", strategy));
+        }
+        if (auto result = load_strategy_checkpoint(*_optimizer, _splat_data, checkpoint); !result) {
+            return result;
+        }
+        // The growth schedule starts from the count the original run was initialized with
+        _initial_count = checkpoint.meta().value("taming_initial_count", _initial_count);
+        return {};
+    }
+} // namespace gs::training
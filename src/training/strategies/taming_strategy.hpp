@@ -0,0 +1,78 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "istrategy.hpp"
+#include "optimizers/scheduler.hpp"
+#include <memory>
+#include <torch/torch.h>
+
+namespace gs::training {
+    // Forward declarations
+    struct RenderOutput;
+
+    // Score-based densification after "Taming 3DGS" (Mallick et al. 2024): at every refinement the
+    // model grows to a fixed count schedule that reaches max_cap at stop_refine, the Gaussians with
+    // the highest importance scores are the ones duplicated or split. The deterministic budget lets
+    // runs converge in fewer iterations than the open-ended adaptive density control.
+    class TamingStrategy : public IStrategy {
+    public:
+        TamingStrategy() = delete;
+
+        TamingStrategy(gs::SplatData&& splat_data);
+
+        TamingStrategy(const TamingStrategy&) = delete;
+
+        TamingStrategy& operator=(const TamingStrategy&) = delete;
+
+        TamingStrategy(TamingStrategy&&) = default;
+
+        TamingStrategy& operator=(TamingStrategy&&) = default;
+
+        // IStrategy interface implementation
+        void initialize(const gs::param::OptimizationParameters& optimParams) override;
+
+        void post_backward(int iter, RenderOutput& render_output) override;
+
+        void step(int iter) override;
+
+        void set_optimizer_visibility(const torch::Tensor& visibility) override;
+
+        bool is_refining(int iter) const override;
+
+        gs::SplatData& get_model() override { return _splat_data; }
+        const gs::SplatData& get_model() const override { return _splat_data; }
+
+        void remove_gaussians(const torch::Tensor& mask) override;
+
+        void reorder_gaussians(const torch::Tensor& order) override;
+
+        void quantize_sh(int codebook_size) override;
+
+        void factor_sh(int rank) override;
+
+        void save_checkpoint(TrainingCheckpoint& checkpoint) const override;
+
+        std::expected<void, std::string> load_checkpoint(const TrainingCheckpoint& checkpoint) override;
+
+        // Gaussian count the schedule asks for after the refinement at iter
+        int64_t target_count(int iter) const;
+
+    private:
+        // Per-Gaussian importance from the statistics of the last refinement window
+        torch::Tensor importance_scores() const;
+
+        void grow_gs(int iter);
+
+        void prune_gs();
+
+        // Member variables
+        std::unique_ptr<torch::optim::Optimizer> _optimizer;
+        std::unique_ptr<ExponentialLR> _scheduler;
+        gs::SplatData _splat_data;
+        std::unique_ptr<const gs::param::OptimizationParameters> _params;
+        int64_t _initial_count = 0;
+    };
+} // namespace gs::training
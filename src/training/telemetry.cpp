@@ -0,0 +1,287 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "telemetry.hpp"
+#include "core/logger.hpp"
+#include <algorithm>
+#include <bit>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAFunctions.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <format>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace gs::training {
+
+    namespace {
+        // Steps whose events may still be pending on the device, a few iterations of lag
+        constexpr size_t IN_FLIGHT_STEPS = 8;
+        constexpr auto WRITER_IDLE = std::chrono::milliseconds(20);
+        constexpr std::string_view SOCKET_PREFIX = "unix:";
+
+        void close_fd(const int fd) {
+#ifdef _WIN32
+            _close(fd);
+#else
+            close(fd);
+#endif
+        }
+
+        std::expected<int, std::string> open_target(const std::string& target) {
+            if (target.starts_with(SOCKET_PREFIX)) {
+#ifdef _WIN32
+                return std::unexpected("Telemetry sockets are not supported on Windows, use a file");
+#else
+                const std::string path = target.substr(SOCKET_PREFIX.size());
+                sockaddr_un address{};
+                if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+                    return std::unexpected(std::format("Invalid telemetry socket path '{}'", path));
+                }
+                address.sun_family = AF_UNIX;
+                std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+                const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+                if (fd < 0) {
+                    return std::unexpected(std::format("Failed to create telemetry socket: {}", std::strerror(errno)));
+                }
+                if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+                    const std::string error = std::strerror(errno);
+                    close(fd);
+                    return std::unexpected(std::format("Failed to connect to telemetry socket {}: {}", path, error));
+                }
+                return fd;
+#endif
+            }
+#ifdef _WIN32
+            const int fd = _open(target.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644);
+#else
+            const int fd = ::open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+            if (fd < 0) {
+                return std::unexpected(std::format("Failed to open telemetry file {}: {}", target, std::strerror(errno)));
+            }
+            return fd;
+        }
+
+        std::string csv_row(const TelemetrySample& s) {
+            return std::format("{},{},{:.6g},{:.6g},{:.3f},{:.3f},{:.3f},{:.3f},{:.3f},{:.1f},{:.1f}\n",
+                               s.iteration, s.num_gaussians, s.loss, s.photometric_loss, s.step_ms, s.forward_ms,
+                               s.backward_ms, s.refine_ms, s.optimizer_ms, s.vram_allocated_mb, s.vram_reserved_mb);
+        }
+
+        constexpr std::string_view CSV_HEADER =
+            "iteration,num_gaussians,loss,photometric_loss,step_ms,forward_ms,backward_ms,refine_ms,optimizer_ms,"
+            "vram_allocated_mb,vram_reserved_mb\n";
+    } // namespace
+
+    std::expected<std::unique_ptr<TelemetryStream>, std::string> TelemetryStream::open(
+        const std::string& target, const Format format, const size_t capacity) {
+        auto fd = open_target(target);
+        if (!fd) {
+            return std::unexpected(fd.error());
+        }
+        auto stream = std::unique_ptr<TelemetryStream>(new TelemetryStream(*fd, format, capacity));
+        const bool header_written = format == Format::Csv
+                                        ? stream->write_all(CSV_HEADER.data(), CSV_HEADER.size())
+                                        : stream->write_all(TELEMETRY_MAGIC, sizeof(TELEMETRY_MAGIC));
+        if (!header_written) {
+            return std::unexpected(std::format("Failed to write the telemetry header to {}", target));
+        }
+        LOG_INFO("Streaming training telemetry ({}) to {}", format == Format::Csv ? "csv" : "binary", target);
+        return stream;
+    }
+
+    TelemetryStream::TelemetryStream(const int fd, const Format format, const size_t capacity)
+        : fd_(fd),
+          format_(format),
+          steps_(IN_FLIGHT_STEPS),
+          ring_(std::bit_ceil(std::max<size_t>(capacity, 2))) {
+        photometric_host_ = torch::zeros({static_cast<int64_t>(steps_.size())},
+                                         torch::TensorOptions().dtype(torch::kFloat32).pinned_memory(true));
+        writer_ = std::jthread([this] { write_loop(); });
+    }
+
+    TelemetryStream::~TelemetryStream() {
+        flush();
+        stop_.store(true, std::memory_order_release);
+        if (writer_.joinable()) {
+            writer_.join();
+        }
+        if (const uint64_t n = dropped(); n > 0) {
+            LOG_WARN("Telemetry dropped {} samples, the writer could not keep up", n);
+        }
+        close_fd(fd_);
+    }
+
+    void TelemetryStream::begin_step(const int iteration) {
+        if (pending_ == steps_.size()) {
+            // Every slot is in flight: wait for the oldest rather than losing its timings
+            collect(/*wait=*/true);
+        }
+        Step& step = steps_[head_];
+        step.iteration = iteration;
+        step.marked.fill(false);
+        step.begin.record();
+        in_step_ = true;
+    }
+
+    void TelemetryStream::mark(const Phase phase) {
+        if (!in_step_) {
+            return;
+        }
+        Step& step = steps_[head_];
+        step.marks[static_cast<size_t>(phase)].record();
+        step.marked[static_cast<size_t>(phase)] = true;
+    }
+
+    void TelemetryStream::end_step(const torch::Tensor& photometric_loss, const float loss, const int64_t num_gaussians) {
+        if (!in_step_) {
+            return;
+        }
+        in_step_ = false;
+        Step& step = steps_[head_];
+        auto slot = photometric_host_.narrow(0, static_cast<int64_t>(head_), 1);
+        if (photometric_loss.defined()) {
+            slot.copy_(photometric_loss.detach().reshape({1}).to(torch::kFloat32), /*non_blocking=*/true);
+        } else {
+            slot.fill_(0.f);
+        }
+        step.loss = loss;
+        step.num_gaussians = num_gaussians;
+        const auto stats = c10::cuda::CUDACachingAllocator::getDeviceStats(c10::cuda::current_device());
+        const auto aggregate = static_cast<size_t>(c10::CachingAllocator::StatType::AGGREGATE);
+        step.vram_allocated_mb = static_cast<float>(stats.allocated_bytes[aggregate].current) / (1024.f * 1024.f);
+        step.vram_reserved_mb = static_cast<float>(stats.reserved_bytes[aggregate].current) / (1024.f * 1024.f);
+        step.end.record();
+
+        head_ = (head_ + 1) % steps_.size();
+        ++pending_;
+        collect(/*wait=*/false);
+    }
+
+    void TelemetryStream::flush() {
+        in_step_ = false;
+        while (pending_ > 0) {
+            collect(/*wait=*/true);
+        }
+        while (ring_tail_.load(std::memory_order_acquire) != ring_head_.load(std::memory_order_acquire) &&
+               writer_.joinable()) {
+            std::this_thread::sleep_for(WRITER_IDLE);
+        }
+    }
+
+    void TelemetryStream::collect(const bool wait) {
+        while (pending_ > 0) {
+            Step& step = steps_[tail_];
+            if (wait) {
+                step.end.synchronize();
+            } else if (!step.end.query()) {
+                return;
+            }
+
+            TelemetrySample sample;
+            sample.iteration = step.iteration;
+            sample.num_gaussians = static_cast<int32_t>(step.num_gaussians);
+            sample.loss = step.loss;
+            sample.photometric_loss = photometric_host_.data_ptr<float>()[tail_];
+            sample.step_ms = step.begin.elapsed_time(step.end);
+            sample.vram_allocated_mb = step.vram_allocated_mb;
+            sample.vram_reserved_mb = step.vram_reserved_mb;
+
+            // Each phase runs from the previous recorded boundary to its own mark
+            const at::cuda::CUDAEvent* previous = &step.begin;
+            float* phase_ms[] = {&sample.forward_ms, &sample.backward_ms, &sample.refine_ms, &sample.optimizer_ms};
+            for (size_t p = 0; p < step.marks.size(); ++p) {
+                if (step.marked[p]) {
+                    *phase_ms[p] = previous->elapsed_time(step.marks[p]);
+                    previous = &step.marks[p];
+                }
+            }
+
+            publish(sample);
+            tail_ = (tail_ + 1) % steps_.size();
+            --pending_;
+            wait = false;
+        }
+    }
+
+    void TelemetryStream::publish(const TelemetrySample& sample) {
+        const uint64_t head = ring_head_.load(std::memory_order_relaxed);
+        if (head - ring_tail_.load(std::memory_order_acquire) == ring_.size()) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        ring_[head & (ring_.size() - 1)] = sample;
+        ring_head_.store(head + 1, std::memory_order_release);
+    }
+
+    void TelemetryStream::write_loop() {
+        std::string buffer;
+        bool failed = false;
+        while (true) {
+            // Read stop first, so the last samples published before it are still written
+            const bool stopping = stop_.load(std::memory_order_acquire);
+            const uint64_t head = ring_head_.load(std::memory_order_acquire);
+            uint64_t tail = ring_tail_.load(std::memory_order_relaxed);
+            if (tail == head) {
+                if (stopping) {
+                    return;
+                }
+                std::this_thread::sleep_for(WRITER_IDLE);
+                continue;
+            }
+
+            buffer.clear();
+            for (; tail != head; ++tail) {
+                const TelemetrySample& sample = ring_[tail & (ring_.size() - 1)];
+                if (format_ == Format::Csv) {
+                    buffer += csv_row(sample);
+                } else {
+                    buffer.append(reinterpret_cast<const char*>(&sample), sizeof(sample));
+                }
+            }
+            ring_tail_.store(tail, std::memory_order_release);
+
+            if (!failed && !write_all(buffer.data(), buffer.size())) {
+                // A closed socket or full disk stops the stream, training carries on
+                LOG_WARN("Telemetry write failed ({}), no further samples are written", std::strerror(errno));
+                failed = true;
+            }
+        }
+    }
+
+    bool TelemetryStream::write_all(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+#ifdef _WIN32
+            const int written = _write(fd_, bytes, static_cast<unsigned int>(size));
+#else
+            // MSG_NOSIGNAL is socket-only, a plain write on a closed socket would raise SIGPIPE
+            ssize_t written = send(fd_, bytes, size, MSG_NOSIGNAL);
+            if (written < 0 && errno == ENOTSOCK) {
+                written = write(fd_, bytes, size);
+            }
+#endif
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+} // namespace gs::training
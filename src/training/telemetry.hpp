@@ -0,0 +1,121 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <ATen/cuda/CUDAEvent.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <string>
+#include <thread>
+#include <torch/torch.h>
+#include <vector>
+
+namespace gs::training {
+
+    // One training iteration as the telemetry stream records it. Plain 4-byte fields, the binary
+    // format writes it as is after the TELEMETRY_MAGIC header.
+    struct TelemetrySample {
+        int32_t iteration = 0;
+        int32_t num_gaussians = 0;
+        float loss = 0.f;             // Total loss as the progress bar shows it
+        float photometric_loss = 0.f; // L1 + D-SSIM term of the step's last view
+        float step_ms = 0.f;          // GPU time of the whole step
+        float forward_ms = 0.f;       // Render and loss terms
+        float backward_ms = 0.f;
+        float refine_ms = 0.f;        // Strategy post_backward: densification, pruning, relocation
+        float optimizer_ms = 0.f;
+        float vram_allocated_mb = 0.f;
+        float vram_reserved_mb = 0.f;
+    };
+    static_assert(sizeof(TelemetrySample) == 11 * 4, "TelemetrySample must stay packed");
+
+    inline constexpr char TELEMETRY_MAGIC[8] = {'L', 'F', 'S', 'T', 'E', 'L', '0', '1'};
+
+    // Per-iteration training stats streamed to a file or a local socket without stalling training.
+    // The training thread marks phase boundaries with CUDA events, a completed step is moved into a
+    // lock-free single-producer ring and a writer thread formats it. When the writer falls behind,
+    // samples are dropped and counted rather than blocking the step.
+    class TelemetryStream {
+    public:
+        enum class Format {
+            Csv,
+            Binary
+        };
+
+        enum class Phase {
+            Forward,
+            Backward,
+            Refine,
+            Optimizer,
+            Count
+        };
+
+        // target is a file path or unix:<socket path> of a listening SOCK_STREAM socket
+        static std::expected<std::unique_ptr<TelemetryStream>, std::string> open(
+            const std::string& target, Format format, size_t capacity = 1024);
+
+        ~TelemetryStream();
+
+        TelemetryStream(const TelemetryStream&) = delete;
+        TelemetryStream& operator=(const TelemetryStream&) = delete;
+
+        // Training thread only. begin_step and the marks record events on the current stream,
+        // end_step queues the photometric loss copy and hands completed steps to the writer.
+        void begin_step(int iteration);
+        void mark(Phase phase);
+        void end_step(const torch::Tensor& photometric_loss, float loss, int64_t num_gaussians);
+
+        // Waits for the queued steps and the writer, called once training ends
+        void flush();
+
+        uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    private:
+        struct Step {
+            int iteration = 0;
+            float loss = 0.f;
+            int64_t num_gaussians = 0;
+            float vram_allocated_mb = 0.f;
+            float vram_reserved_mb = 0.f;
+            at::cuda::CUDAEvent begin{cudaEventDefault};
+            std::array<at::cuda::CUDAEvent, static_cast<size_t>(Phase::Count)> marks{
+                at::cuda::CUDAEvent(cudaEventDefault), at::cuda::CUDAEvent(cudaEventDefault),
+                at::cuda::CUDAEvent(cudaEventDefault), at::cuda::CUDAEvent(cudaEventDefault)};
+            std::array<bool, static_cast<size_t>(Phase::Count)> marked{};
+            at::cuda::CUDAEvent end{cudaEventDefault};
+        };
+
+        TelemetryStream(int fd, Format format, size_t capacity);
+
+        // Moves completed steps into the ring, blocking on them only with wait
+        void collect(bool wait);
+        void publish(const TelemetrySample& sample);
+        void write_loop();
+        bool write_all(const void* data, size_t size);
+
+        int fd_;
+        Format format_;
+
+        // In-flight steps on the device, touched by the training thread only
+        std::vector<Step> steps_;
+        torch::Tensor photometric_host_; // Pinned float32 [steps]
+        size_t head_ = 0;
+        size_t tail_ = 0;
+        size_t pending_ = 0;
+        bool in_step_ = false;
+
+        // Single-producer single-consumer ring of completed samples, capacity is a power of two
+        std::vector<TelemetrySample> ring_;
+        std::atomic<uint64_t> ring_head_{0}; // Next slot the training thread writes
+        std::atomic<uint64_t> ring_tail_{0}; // Next slot the writer reads
+        std::atomic<uint64_t> dropped_{0};
+        std::atomic<bool> stop_{false};
+        std::jthread writer_;
+    };
+
+} // namespace gs::training
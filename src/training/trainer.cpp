@@ -3,23 +3,181 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "trainer.hpp"
+#include "adam_api.h"
+#include "checkpoint.hpp"
 #include "components/bilateral_grid.hpp"
 #include "components/poseopt.hpp"
+#include "components/sog_quantizer.hpp"
 #include "components/sparsity_optimizer.hpp"
 #include "core/image_io.hpp"
 #include "core/logger.hpp"
+#include "core/profiler.hpp"
+#include "core/thread_placement.hpp"
+#include "core/trace_recorder.hpp"
+#include "dataloader.hpp"
+#include "dataloader_benchmark.hpp"
 #include "kernels/fused_ssim.cuh"
+#include "kernels/morton_encoding.cuh"
+#include "kernels/regularization.cuh"
 #include "rasterization/fast_rasterizer.hpp"
 #include "rasterization/rasterizer.hpp"
+#include "rasterization/spatial_index.hpp"
+#include "rasterization/tile_autotune.hpp"
+#include "vram_manager.hpp"
+#include <ATen/Context.h>
 #include <ATen/cuda/CUDAEvent.h>
+#include <algorithm>
 #include <atomic>
+#include <c10/cuda/CUDAFunctions.h>
+#include <c10/cuda/CUDAGuard.h>
 #include <chrono>
 #include <cuda_runtime.h>
 #include <expected>
 #include <memory>
+#include <optional>
+#include <thread>
 
 namespace gs::training {
 
+    namespace {
+        constexpr const char* CHECKPOINT_DIR = "training_checkpoint";
+        constexpr int PERF_STATS_EVERY = 50; // Steps between the refreshes of the viewer's performance stats
+
+        // Non-blocking stream at the device's highest priority, nullptr if it could not be created.
+        // Never destroyed, tensors of a run return to the caching allocator under this stream.
+        cudaStream_t high_priority_stream() {
+            static const cudaStream_t stream = [] {
+                int least_priority = 0;
+                int greatest_priority = 0;
+                cudaDeviceGetStreamPriorityRange(&least_priority, &greatest_priority);
+                cudaStream_t created = nullptr;
+                if (const cudaError_t err = cudaStreamCreateWithPriority(&created, cudaStreamNonBlocking, greatest_priority);
+                    err != cudaSuccess) {
+                    LOG_WARN("Failed to create a high-priority CUDA stream: {}", cudaGetErrorString(err));
+                    return static_cast<cudaStream_t>(nullptr);
+                }
+                return created;
+            }();
+            return stream;
+        }
+
+        // Moves the calling thread's CUDA work onto stream, ordered after what was queued on the
+        // previous one (the setup), and waits for it on the way out so that other streams see the
+        // finished model
+        class StreamScope {
+        public:
+            explicit StreamScope(cudaStream_t stream)
+                : stream_(c10::cuda::getStreamFromExternal(stream, c10::cuda::current_device())) {
+                at::cuda::CUDAEvent setup_done;
+                setup_done.record(at::cuda::getCurrentCUDAStream());
+                setup_done.block(stream_);
+                guard_.emplace(stream_);
+            }
+            ~StreamScope() {
+                stream_.synchronize();
+            }
+
+            StreamScope(const StreamScope&) = delete;
+            StreamScope& operator=(const StreamScope&) = delete;
+
+        private:
+            c10::cuda::CUDAStream stream_;
+            std::optional<c10::cuda::CUDAStreamGuard> guard_;
+        };
+
+        // Moves the calling thread's CUDA work onto stream for its lifetime, ordered after ready and
+        // before what the current stream queues next by events, the host never waits
+        class SideStreamScope {
+        public:
+            SideStreamScope(c10::cuda::CUDAStream stream, at::cuda::CUDAEvent& ready)
+                : origin_(at::cuda::getCurrentCUDAStream()),
+                  stream_(stream) {
+                ready.block(stream_);
+                guard_.emplace(stream_);
+            }
+            ~SideStreamScope() {
+                guard_.reset();
+                at::cuda::CUDAEvent done;
+                done.record(stream_);
+                done.block(origin_);
+            }
+
+            SideStreamScope(const SideStreamScope&) = delete;
+            SideStreamScope& operator=(const SideStreamScope&) = delete;
+
+        private:
+            c10::cuda::CUDAStream origin_;
+            c10::cuda::CUDAStream stream_;
+            std::optional<c10::cuda::CUDAStreamGuard> guard_;
+        };
+
+        // Parameters, moments and learning rates of a FusedAdam, tensors named <prefix>.<index>
+        void save_adam_state(const FusedAdam& optimizer,
+                             const std::string& prefix,
+                             TrainingCheckpoint& checkpoint) {
+            nlohmann::json lrs = nlohmann::json::array();
+            nlohmann::json steps = nlohmann::json::object();
+            size_t index = 0;
+            for (const auto& group : optimizer.param_groups()) {
+                lrs.push_back(static_cast<const FusedAdam::Options&>(group.options()).lr());
+                for (const auto& param : group.params()) {
+                    const std::string name = std::format("{}.{}", prefix, index++);
+                    checkpoint.put(name, param);
+
+                    const auto it = optimizer.state().find(param.unsafeGetTensorImpl());
+                    if (it != optimizer.state().end()) {
+                        const auto& state = static_cast<const FusedAdam::AdamParamState&>(*it->second);
+                        checkpoint.put(name + ".exp_avg", state.exp_avg);
+                        checkpoint.put(name + ".exp_avg_sq", state.exp_avg_sq);
+                        steps[name] = state.step_count;
+                    }
+                }
+            }
+            checkpoint.meta()[prefix] = {{"lrs", std::move(lrs)}, {"steps", std::move(steps)}};
+        }
+
+        // Copies into the existing parameters so modules holding them keep working
+        std::expected<void, std::string> load_adam_state(FusedAdam& optimizer,
+                                                         const std::string& prefix,
+                                                         const TrainingCheckpoint& checkpoint) {
+            torch::NoGradGuard no_grad;
+
+            const auto meta = checkpoint.meta().value(prefix, nlohmann::json::object());
+            if (!meta.contains("lrs")) {
+                return std::unexpected(std::format("Checkpoint has no {} state", prefix));
+            }
+
+            size_t index = 0;
+            for (size_t g = 0; g < optimizer.param_groups().size(); ++g) {
+                auto& group = optimizer.param_groups()[g];
+                if (g < meta["lrs"].size()) {
+                    static_cast<FusedAdam::Options&>(group.options()).lr(meta["lrs"][g].get<double>());
+                }
+                for (auto& param : group.params()) {
+                    const std::string name = std::format("{}.{}", prefix, index++);
+                    const auto value = checkpoint.get(name, param.device());
+                    if (!value.defined() || value.sizes() != param.sizes()) {
+                        return std::unexpected(std::format("Checkpoint {} does not match the current configuration", name));
+                    }
+                    param.copy_(value);
+
+                    optimizer.state().erase(param.unsafeGetTensorImpl());
+                    if (checkpoint.contains(name + ".exp_avg")) {
+                        // A run may resume with another storage precision, the current one wins
+                        const auto moment_dtype = fast_gs::optimizer::moment_dtype(param.scalar_type());
+                        auto state = std::make_unique<FusedAdam::AdamParamState>();
+                        state->exp_avg = checkpoint.get(name + ".exp_avg", param.device()).to(moment_dtype);
+                        state->exp_avg_sq = checkpoint.get(name + ".exp_avg_sq", param.device()).to(moment_dtype);
+                        state->step_count = meta["steps"].value(name, int64_t{0});
+                        optimizer.state()[param.unsafeGetTensorImpl()] = std::move(state);
+                    }
+                }
+            }
+            return {};
+        }
+
+    } // namespace
+
     void Trainer::cleanup() {
         LOG_DEBUG("Cleaning up trainer for re-initialization");
 
@@ -39,15 +197,30 @@ namespace gs::training {
         bilateral_grid_scheduler_.reset();
         poseopt_module_.reset();
         poseopt_optimizer_.reset();
+        poseopt_ids_ = torch::Tensor();
+        step_views_ = torch::Tensor();
         sparsity_optimizer_.reset();
+        convergence_.reset();
         evaluator_.reset();
+        telemetry_.reset();
+        delta_writer_.reset();
+        model_snapshot_.reset();
+        // Samples still in flight belong to the previous run
+        loss_readback_.reset();
+        view_loss_readback_.reset();
+
+        // Detach preloaded images, the base dataset outlives re-initialization. image_cache_ keeps
+        // them for initialize_image_cache() in case the new parameters want the same cache.
+        if (base_dataset_) {
+            base_dataset_->set_image_cache(nullptr);
+        }
 
         // Clear datasets (will be recreated)
         train_dataset_.reset();
         val_dataset_.reset();
 
         // Clear camera cache
-        m_cam_id_to_cam.clear();
+        camera_set_ = CameraSet();
 
         // Reset flags
         pause_requested_ = false;
@@ -59,6 +232,8 @@ namespace gs::training {
         ready_to_start_ = false;
         current_iteration_ = 0;
         current_loss_ = 0.0f;
+        start_iteration_ = 1;
+        last_checkpoint_iteration_ = 0;
 
         LOG_DEBUG("Trainer cleanup complete");
     }
@@ -68,17 +243,23 @@ namespace gs::training {
             return {};
         }
 
+        if (params_.optimization.crop_size > 0) {
+            LOG_WARN("crop_size: the bilateral grid spans each crop, not the whole image");
+        }
+
         try {
             bilateral_grid_ = std::make_unique<BilateralGrid>(
                 train_dataset_size_,
                 params_.optimization.bilateral_grid_X,
                 params_.optimization.bilateral_grid_Y,
-                params_.optimization.bilateral_grid_W);
+                params_.optimization.bilateral_grid_W,
+                params_.optimization.bilateral_grid_precision);
 
-            bilateral_grid_optimizer_ = std::make_unique<torch::optim::Adam>(
-                std::vector<torch::Tensor>{bilateral_grid_->parameters()},
-                torch::optim::AdamOptions(params_.optimization.bilateral_grid_lr)
-                    .eps(1e-15));
+            // Row-sparse: each step only updates the grids of the views it rendered
+            auto options = std::make_unique<FusedAdam::Options>(params_.optimization.bilateral_grid_lr);
+            options->eps(1e-15);
+            bilateral_grid_optimizer_ = std::make_unique<FusedAdam>(
+                std::vector<torch::Tensor>{bilateral_grid_->parameters()}, std::move(options));
 
             // Create scheduler with warmup
             const double gamma = std::pow(0.01, 1.0 / params_.optimization.iterations);
@@ -90,25 +271,172 @@ namespace gs::training {
                 -1    // all param groups
             );
 
-            LOG_DEBUG("Bilateral grid initialized with size {}x{}x{} and warmup scheduler",
+            LOG_DEBUG("Bilateral grid initialized with size {}x{}x{} ({}) and warmup scheduler",
                       params_.optimization.bilateral_grid_X,
                       params_.optimization.bilateral_grid_Y,
-                      params_.optimization.bilateral_grid_W);
+                      params_.optimization.bilateral_grid_W,
+                      params_.optimization.bilateral_grid_precision);
             return {};
         } catch (const std::exception& e) {
             return std::unexpected(std::format("Failed to initialize bilateral grid: {}", e.what()));
         }
     }
 
+    void Trainer::initialize_image_info(bool probe) {
+        const auto& cameras = base_dataset_->get_cameras();
+
+        if (lf_project_) {
+            const auto& known = lf_project_->getProjectData().data_set_info.image_info;
+            for (const auto& cam : cameras) {
+                if (const auto it = known.find(cam->image_name()); it != known.end()) {
+                    cam->set_source_image_info(it->second[0], it->second[1], it->second[2]);
+                }
+            }
+        }
+
+        if (!probe) {
+            return;
+        }
+
+        probe_source_image_info(cameras);
+
+        if (lf_project_) {
+            std::map<std::string, std::array<int, 3>> image_info;
+            for (const auto& cam : cameras) {
+                if (cam->has_source_image_info()) {
+                    const auto [w, h, c] = cam->source_image_info();
+                    image_info[cam->image_name()] = {w, h, c};
+                }
+            }
+            if (image_info != lf_project_->getProjectData().data_set_info.image_info) {
+                lf_project_->setImageInfo(std::move(image_info));
+            }
+        }
+    }
+
+    std::expected<void, std::string> Trainer::initialize_image_cache() {
+        const auto& opt = params_.optimization;
+        if (!opt.preload_to_ram && !opt.preload_to_vram && opt.shared_image_cache.empty()) {
+            image_cache_.reset();
+            return {};
+        }
+        if (opt.preload_max_mb == 0) {
+            LOG_INFO("preload_max_mb is 0, images are read from disk");
+            image_cache_.reset();
+            return {};
+        }
+        if (opt.preload_to_vram && !opt.shared_image_cache.empty()) {
+            LOG_WARN("preload_to_vram keeps private copies in VRAM, shared_image_cache is ignored");
+        }
+
+        // Train images first so they win the budget over validation images
+        std::vector<Camera*> cameras;
+        for (size_t i = 0; i < train_dataset_->size().value(); ++i) {
+            cameras.push_back(train_dataset_->get_camera(i));
+        }
+        if (val_dataset_) {
+            for (size_t i = 0; i < val_dataset_->size().value(); ++i) {
+                cameras.push_back(val_dataset_->get_camera(i));
+            }
+        }
+
+        ImageCache::Options options{
+            .resize_factor = params_.dataset.resize_factor,
+            .max_width = params_.dataset.max_width,
+            .max_bytes = opt.preload_max_mb < 0 ? 0 : static_cast<size_t>(opt.preload_max_mb) * 1024 * 1024, // 0: unlimited
+            .device = opt.preload_to_vram,
+            .gpu_decode = opt.gpu_decode,
+            .shared_dir = opt.shared_image_cache};
+
+        // A re-initialization with the same images and budget, a reset from the GUI, keeps the decoded
+        // cache. Anything else frees it before the new one is decoded.
+        const bool cache_eval = val_dataset_ != nullptr;
+        if (image_cache_ && image_cache_options_ == options && image_cache_eval_ == cache_eval) {
+            LOG_INFO("Reusing {} preloaded images", image_cache_->size());
+            train_dataset_->set_image_cache(image_cache_);
+            if (val_dataset_) {
+                val_dataset_->set_image_cache(image_cache_);
+            }
+            return {};
+        }
+        image_cache_.reset();
+        image_cache_options_ = options;
+        image_cache_eval_ = cache_eval;
+
+        // Budget planning needs every image size, probe them up front instead of one by one
+        initialize_image_info(/*probe=*/true);
+
+        // Model footprint: means, scaling, rotation, opacity and SH, each with gradient and two Adam moments
+        const size_t sh_coeffs = static_cast<size_t>((opt.sh_degree + 1) * (opt.sh_degree + 1));
+        const size_t bytes_per_gaussian = (3 + 3 + 4 + 1 + 3 * sh_coeffs) * sizeof(float) * 4;
+        const size_t num_gaussians = static_cast<size_t>(strategy_->get_model().size());
+
+        if (options.device) {
+            size_t free_bytes = 0, total_bytes = 0;
+            if (cudaMemGetInfo(&free_bytes, &total_bytes) != cudaSuccess) {
+                return std::unexpected("preload_to_vram: failed to query free VRAM");
+            }
+
+            // MCMC and taming grow up to max_cap; rasterizer buffers scale with the model too, reserve the same again
+            const size_t peak_gaussians = opt.strategy == "mcmc" || opt.strategy == "taming"
+                                              ? std::max(num_gaussians, static_cast<size_t>(std::max(0, opt.max_cap)))
+                                              : num_gaussians;
+            const size_t model_reserve = 2 * peak_gaussians * bytes_per_gaussian;
+            const size_t vram_budget = free_bytes > model_reserve ? free_bytes - model_reserve : 0;
+            options.max_bytes = options.max_bytes > 0 ? std::min(options.max_bytes, vram_budget) : vram_budget;
+
+            LOG_INFO("preload_to_vram: {:.0f} MB free of {:.0f} MB, reserving {:.0f} MB for up to {} Gaussians, {:.0f} MB available for images",
+                     free_bytes / (1024.0 * 1024.0), total_bytes / (1024.0 * 1024.0),
+                     model_reserve / (1024.0 * 1024.0), peak_gaussians, options.max_bytes / (1024.0 * 1024.0));
+        }
+
+        auto cache = ImageCache::build(cameras, options);
+        if (!cache) {
+            return std::unexpected(cache.error());
+        }
+
+        if (options.device) {
+            const size_t model_bytes = num_gaussians * bytes_per_gaussian;
+            LOG_INFO("Ground truth in VRAM: {:.0f} MB for {} images ({:.1f}x the current model: {} Gaussians, ~{:.0f} MB with optimizer state)",
+                     (*cache)->num_bytes() / (1024.0 * 1024.0), (*cache)->size(),
+                     model_bytes > 0 ? static_cast<double>((*cache)->num_bytes()) / static_cast<double>(model_bytes) : 0.,
+                     num_gaussians, model_bytes / (1024.0 * 1024.0));
+        }
+
+        image_cache_ = std::move(*cache);
+        train_dataset_->set_image_cache(image_cache_);
+        if (val_dataset_) {
+            val_dataset_->set_image_cache(image_cache_);
+        }
+        return {};
+    }
+
     std::expected<torch::Tensor, std::string> Trainer::compute_photometric_loss(
         const RenderOutput& render_output,
         const torch::Tensor& gt_image,
         const SplatData& splatData,
-        const param::OptimizationParameters& opt_params) {
+        const param::OptimizationParameters& opt_params,
+        const torch::Tensor& valid_mask) {
+        PROFILE_ZONE("photometric loss");
         try {
+            if (opt_params.fused_loss) {
+                // Compositing and masking happen while the kernel loads the pixels
+                TORCH_CHECK(render_output.image.sizes() == gt_image.sizes(),
+                            "ERROR: size mismatch – rendered ", render_output.image.sizes(),
+                            " vs. ground truth ", gt_image.sizes());
+                const bool composite = render_output.background.defined();
+                return fused_photometric_loss(render_output.image, gt_image, opt_params.lambda_dssim,
+                                              composite ? render_output.alpha : torch::Tensor(),
+                                              render_output.background, valid_mask, render_output.bilateral_grid);
+            }
+
             // Ensure images have same dimensions
             torch::Tensor rendered = render_output.image;
             torch::Tensor gt = gt_image;
+            if (valid_mask.defined()) {
+                rendered = rendered * valid_mask;
+                gt = gt * valid_mask;
+            }
 
             // Ensure both tensors are 4D (batch, height, width, channels)
             rendered = rendered.dim() == 3 ? rendered.unsqueeze(0) : rendered;
@@ -129,6 +457,29 @@ namespace gs::training {
         }
     }
 
+    torch::Tensor Trainer::valid_pixel_mask(const Camera& cam, const torch::Tensor& gt_image) {
+        if (cam.valid_mask_path().empty() && cam.mask_path().empty()) {
+            return {};
+        }
+        const int64_t height = gt_image.size(-2);
+        const int64_t width = gt_image.size(-1);
+        const std::string key = std::format("{}|{}|{}x{}", cam.valid_mask_path().string(), cam.mask_path().string(),
+                                            width, height);
+        auto it = valid_masks_.find(key);
+        if (it == valid_masks_.end()) {
+            torch::Tensor mask;
+            for (const auto& path : {cam.valid_mask_path(), cam.mask_path()}) {
+                if (!path.empty()) {
+                    auto loaded = load_binary_mask(path, height, width);
+                    mask = mask.defined() ? mask.bitwise_and_(loaded) : loaded;
+                }
+            }
+            it = valid_masks_.emplace(key, std::move(mask)).first;
+        }
+        // The cache stays on the host at a byte per pixel, each step uploads its mask asynchronously
+        return it->second.to(gt_image.device(), /*non_blocking=*/true).to(torch::kFloat32);
+    }
+
     std::expected<torch::Tensor, std::string> Trainer::compute_scale_reg_loss(
         const SplatData& splatData,
         const param::OptimizationParameters& opt_params) {
@@ -157,12 +508,47 @@ namespace gs::training {
         }
     }
 
+    bool Trainer::use_fused_regularizers() const {
+        const auto& opt = params_.optimization;
+        if (opt.scale_reg <= 0.0f && opt.opacity_reg <= 0.0f) {
+            return false;
+        }
+        const auto fusable = [](const torch::Tensor& param) {
+            return param.is_cuda() && param.scalar_type() == torch::kFloat32 && param.is_contiguous();
+        };
+        const auto& model = strategy_->get_model();
+        return fusable(model.scaling_raw()) && fusable(model.opacity_raw());
+    }
+
+    std::expected<torch::Tensor, std::string> Trainer::apply_fused_regularizers() {
+        try {
+            torch::NoGradGuard no_grad;
+            const auto& opt = params_.optimization;
+            auto& model = strategy_->get_model();
+            // A term's gradient is created when the backward left none, e.g. nothing was visible
+            const auto grad_for = [](torch::Tensor& param, float weight) {
+                if (weight > 0.0f && !param.grad().defined()) {
+                    param.mutable_grad() = torch::zeros_like(param);
+                }
+                return param.grad();
+            };
+            auto scaling_grad = grad_for(model.scaling_raw(), opt.scale_reg);
+            auto opacity_grad = grad_for(model.opacity_raw(), opt.opacity_reg);
+            return regularization::scale_opacity_reg_cuda(
+                model.scaling_raw(), scaling_grad, opt.scale_reg,
+                model.opacity_raw(), opacity_grad, opt.opacity_reg);
+        } catch (const std::exception& e) {
+            return std::unexpected(std::format("Error applying fused regularization: {}", e.what()));
+        }
+    }
+
     std::expected<torch::Tensor, std::string> Trainer::compute_bilateral_grid_tv_loss(
         const std::unique_ptr<BilateralGrid>& bilateral_grid,
+        const Camera& cam,
         const param::OptimizationParameters& opt_params) {
         try {
             if (opt_params.use_bilateral_grid) {
-                return opt_params.tv_loss_weight * bilateral_grid->tv_loss();
+                return opt_params.tv_loss_weight * bilateral_grid->tv_loss(cam.uid());
             }
             return torch::zeros({1}, torch::kFloat32).requires_grad_();
         } catch (const std::exception& e) {
@@ -213,6 +599,17 @@ namespace gs::training {
         }
     }
 
+    std::unique_ptr<ISparsityOptimizer> Trainer::create_sparsity_optimizer(const int start_iteration) const {
+        const ADMMSparsityOptimizer::Config sparsity_config{
+            .sparsify_steps = params_.optimization.sparsify_steps,
+            .init_rho = params_.optimization.init_rho,
+            .prune_ratio = params_.optimization.prune_ratio,
+            .update_every = 50,
+            .start_iteration = start_iteration // Start after base training completes
+        };
+        return SparsityOptimizerFactory::create("admm", sparsity_config);
+    }
+
     std::expected<void, std::string> Trainer::apply_sparsity_pruning(
         int iter,
         SplatData& splatData) {
@@ -257,11 +654,18 @@ namespace gs::training {
     }
 
     void Trainer::load_cameras_info() {
-        m_cam_id_to_cam.clear();
-        // Setup camera cache
-        for (const auto& cam : base_dataset_->get_cameras()) {
-            m_cam_id_to_cam[cam->uid()] = cam;
-        }
+        const auto& cameras = base_dataset_->get_cameras();
+        camera_set_ = CameraSet(std::vector<std::shared_ptr<const Camera>>(cameras.begin(), cameras.end()));
+    }
+
+    void Trainer::reset_model(std::unique_ptr<IStrategy> strategy) {
+        std::unique_lock<std::shared_mutex> lock(render_mutex_);
+        strategy_ = std::move(strategy);
+        model_snapshot_.reset();
+        current_iteration_ = 0;
+        current_loss_ = 0.0f;
+        training_complete_ = false;
+        LOG_DEBUG("Trainer model reset to {} Gaussians", strategy_->get_model().size());
     }
 
     std::expected<void, std::string> Trainer::initialize(const param::TrainingParameters& params) {
@@ -280,6 +684,118 @@ namespace gs::training {
         try {
             params_ = params;
 
+            // A seeded run repeats exactly: everything random below and during training draws from
+            // the seed, --benchmark falls back to a fixed one
+            benchmark_.reset();
+            run_seed_.reset();
+            if (params.optimization.seed >= 0) {
+                run_seed_ = static_cast<uint32_t>(params.optimization.seed);
+            } else if (!params.optimization.benchmark_output.empty()) {
+                run_seed_ = BENCHMARK_SEED;
+            }
+            if (run_seed_) {
+                torch::manual_seed(*run_seed_);
+                crop_rng_.seed(*run_seed_);
+                bg_rng_.seed(*run_seed_);
+                LOG_INFO("Random number generators seeded with {}", *run_seed_);
+            }
+            if (params.optimization.deterministic) {
+                // The flags are process-wide, whatever runs after this trainer gets them back
+                if (!saved_determinism_) {
+                    const auto& global = at::globalContext();
+                    saved_determinism_ = std::array{global.deterministicAlgorithms(), global.deterministicAlgorithmsWarnOnly(),
+                                                    global.deterministicCuDNN(), global.benchmarkCuDNN()};
+                }
+                // Warn only: the ops without a deterministic kernel keep running
+                at::globalContext().setDeterministicAlgorithms(true, /*warn_only=*/true);
+                at::globalContext().setDeterministicCuDNN(true);
+                at::globalContext().setBenchmarkCuDNN(false);
+                LOG_INFO("Deterministic torch algorithms enabled");
+            }
+
+            // Host threads go next to the GPU on request and share one CPU budget, decode workers
+            // first and OIIO's pool the rest, instead of each sizing itself to the whole machine
+            auto& placement = core::ThreadPlacement::get();
+            placement.configure(c10::cuda::current_device(), params.optimization.pin_threads);
+            placement.pin_current_thread();
+            // num_workers 0 autotunes up to the whole budget, or the whole machine without one
+            autotune_loader_workers_ = params.optimization.num_workers == 0;
+            const int requested_workers = autotune_loader_workers_
+                                              ? static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))
+                                              : params.optimization.num_workers;
+            num_loader_workers_ = requested_workers;
+            int cpu_budget = params.optimization.cpu_threads;
+            if (cpu_budget == 0 && params.optimization.pin_threads) {
+                cpu_budget = static_cast<int>(placement.cpus().size());
+            }
+            if (cpu_budget > 0) {
+                const auto split = core::split_thread_budget(cpu_budget, requested_workers);
+                num_loader_workers_ = split.loader_workers;
+                set_image_io_threads(split.image_io_threads);
+                LOG_INFO("CPU budget of {} threads: {} dataloader workers, {} image I/O threads",
+                         cpu_budget, split.loader_workers, split.image_io_threads);
+            }
+            if (!params.optimization.benchmark_output.empty()) {
+                benchmark_ = std::make_unique<BenchmarkRecorder>(params.optimization.iterations);
+            }
+
+            VramManager::get().set_budget_mb(params.optimization.vram_budget_mb);
+
+            // A re-initialization keeps the streams and the grown buffer arenas of the last run
+            if (!raster_context_ || raster_context_->upper_bound_allocation != params.optimization.upper_bound_allocation) {
+                raster_context_ = std::make_unique<fast_gs::rasterization::RasterizerContext>(
+                    params.optimization.upper_bound_allocation);
+            } else {
+                raster_context_->stats_pending = false;
+                raster_context_->stats_totals = {};
+            }
+            raster_context_->collect_instance_stats = params.optimization.instance_stats || benchmark_;
+            raster_context_->load_balanced_blend = params.optimization.load_balanced_blend;
+            raster_context_->bucket_state_budget = static_cast<size_t>(params.optimization.bucket_state_budget_mb) << 20;
+            tile_shape_autotune_ = params.optimization.tile_shape == "auto" && !params.optimization.gut;
+            tile_shape_bucket_.clear();
+            if (params.optimization.tile_shape != "auto" &&
+                !fast_gs::rasterization::tile_shape_from_name(params.optimization.tile_shape, raster_context_->tile_shape)) {
+                return std::unexpected(std::format("Invalid tile shape '{}'", params.optimization.tile_shape));
+            }
+            // The palette is shared, so the Gaussian count is frozen once it is trained
+            if (params.optimization.sh_codebook_iteration > 0) {
+                if (params.optimization.sh_codebook_iteration < params.optimization.stop_refine) {
+                    return std::unexpected(std::format("sh_codebook_iteration {} must not precede stop_refine {}",
+                                                       params.optimization.sh_codebook_iteration,
+                                                       params.optimization.stop_refine));
+                }
+                if (params.optimization.enable_sparsity) {
+                    return std::unexpected("sh_codebook_iteration cannot be combined with sparsity pruning");
+                }
+            }
+            // Likewise for the weights of a low-rank SH basis
+            if (params.optimization.sh_basis_iteration > 0) {
+                if (params.optimization.sh_basis_iteration < params.optimization.stop_refine) {
+                    return std::unexpected(std::format("sh_basis_iteration {} must not precede stop_refine {}",
+                                                       params.optimization.sh_basis_iteration,
+                                                       params.optimization.stop_refine));
+                }
+                if (params.optimization.enable_sparsity) {
+                    return std::unexpected("sh_basis_iteration cannot be combined with sparsity pruning");
+                }
+                if (params.optimization.sh_codebook_iteration > 0) {
+                    return std::unexpected("sh_basis_iteration cannot be combined with sh_codebook_iteration");
+                }
+            }
+            sog_quantizer_ = params.optimization.sog_qat_iteration > 0
+                                 ? std::make_unique<SogQuantizer>(params.optimization.sog_iterations)
+                                 : nullptr;
+            auto rasterizer = create_rasterizer_backend(params.optimization.gut ? "gut" : "fastgs",
+                                                        params.optimization, raster_context_.get());
+            if (!rasterizer) {
+                return std::unexpected(rasterizer.error());
+            }
+            rasterizer_ = std::move(*rasterizer);
+            spatial_index_ = params.optimization.spatial_index && !params.optimization.gut
+                                 ? std::make_unique<SpatialIndex>()
+                                 : nullptr;
+
             // Handle dataset split based on evaluation flag
             if (params.optimization.enable_eval) {
                 // Create train/val split
@@ -312,12 +828,15 @@ namespace gs::training {
 
             train_dataset_size_ = train_dataset_->size().value();
 
-            m_cam_id_to_cam.clear();
-            // Setup camera cache
-            for (const auto& cam : base_dataset_->get_cameras()) {
-                m_cam_id_to_cam[cam->uid()] = cam;
+            // Image headers are only opened when something needs them (preload budget, timelapse)
+            initialize_image_info(/*probe=*/false);
+
+            if (auto result = initialize_image_cache(); !result) {
+                return std::unexpected(result.error());
             }
-            LOG_DEBUG("Camera cache initialized with {} cameras", m_cam_id_to_cam.size());
+
+            load_cameras_info();
+            LOG_DEBUG("Camera cache initialized with {} cameras", camera_set_.size());
 
             // Re-initialize strategy with new parameters
             strategy_->initialize(params.optimization);
@@ -338,15 +857,7 @@ namespace gs::training {
                 // Extend the total training iterations
                 params_.optimization.iterations = total_iterations;
 
-                ADMMSparsityOptimizer::Config sparsity_config{
-                    .sparsify_steps = params.optimization.sparsify_steps,
-                    .init_rho = params.optimization.init_rho,
-                    .prune_ratio = params.optimization.prune_ratio,
-                    .update_every = 50,
-                    .start_iteration = sparsity_start // Start after base training completes
-                };
-
-                sparsity_optimizer_ = SparsityOptimizerFactory::create("admm", sparsity_config);
+                sparsity_optimizer_ = create_sparsity_optimizer(sparsity_start);
 
                 if (sparsity_optimizer_) {
                     // Don't initialize yet - will initialize when we reach start_iteration
@@ -360,7 +871,17 @@ namespace gs::training {
                 }
             }
 
-            background_ = torch::tensor({0.f, 0.f, 0.f},
+            // Refinement changes the loss on its own, the plateau test starts once it is over
+            if (params.optimization.early_stop_window > 0) {
+                convergence_ = std::make_unique<ConvergenceMonitor>(
+                    params.optimization.early_stop_window,
+                    params.optimization.early_stop_threshold,
+                    static_cast<int>(params.optimization.stop_refine));
+                LOG_INFO("Early stopping: loss checked every {} iterations from iteration {}",
+                         params.optimization.early_stop_window, params.optimization.stop_refine);
+            }
+
+            background_ = torch::tensor({background_color_[0], background_color_[1], background_color_[2]},
                                         torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA));
 
             if (params.optimization.pose_optimization != "none") {
@@ -368,9 +889,10 @@ namespace gs::training {
                     return std::unexpected("Evaluating with pose optimization is not supported yet. "
                                            "Please disable pose optimization or evaluation.");
                 }
-                if (params.optimization.gut) {
-                    return std::unexpected("The 3DGUT rasterizer doesn't have camera gradients yet. "
-                                           "Please disable pose optimization or disable gut.");
+                if (!rasterizer_->capabilities().camera_gradients) {
+                    return std::unexpected(std::format("The {} rasterizer doesn't have camera gradients yet. "
+                                                       "Please disable pose optimization or disable gut.",
+                                                       rasterizer_->name()));
                 }
                 if (params.optimization.pose_optimization == "direct") {
                     poseopt_module_ = std::make_unique<DirectPoseOptimizationModule>(train_dataset_->get_cameras().size());
@@ -381,12 +903,33 @@ namespace gs::training {
                 } else {
                     return std::unexpected("Invalid pose optimization type: " + params.optimization.pose_optimization);
                 }
-                poseopt_optimizer_ = std::make_unique<torch::optim::Adam>(
-                    std::vector<torch::Tensor>{poseopt_module_->parameters()},
-                    torch::optim::AdamOptions(1e-5));
+                // FusedAdam steps device parameters, and the view's uid is written into one
+                // device index in place instead of a fresh host tensor per step
+                poseopt_module_->to(torch::kCUDA);
+                poseopt_ids_ = torch::zeros({1}, torch::TensorOptions().dtype(torch::kInt64).device(torch::kCUDA));
+                // The camera embedding rows are updated for the rendered views only, the shared
+                // MLP of the "mlp" variant densely
+                std::vector<torch::Tensor> embedding_params, shared_params;
+                for (const auto& [name, param] : poseopt_module_->named_parameters()) {
+                    (name.starts_with("camera_embeddings.") ? embedding_params : shared_params).push_back(param);
+                }
+                std::vector<torch::optim::OptimizerParamGroup> groups;
+                groups.emplace_back(std::move(embedding_params),
+                                    std::unique_ptr<torch::optim::OptimizerOptions>(std::make_unique<FusedAdam::Options>(1e-5)));
+                if (!shared_params.empty()) {
+                    auto shared_options = std::make_unique<FusedAdam::Options>(1e-5);
+                    shared_options->dense(true);
+                    groups.emplace_back(std::move(shared_params),
+                                        std::unique_ptr<torch::optim::OptimizerOptions>(std::move(shared_options)));
+                }
+                poseopt_optimizer_ = std::make_unique<FusedAdam>(std::move(groups), std::make_unique<FusedAdam::Options>(1e-5));
             } else {
                 poseopt_module_ = std::make_unique<PoseOptimizationModule>();
             }
+            if (bilateral_grid_optimizer_ || poseopt_optimizer_) {
+                step_views_ = torch::zeros({static_cast<int64_t>(train_dataset_size_)},
+                                           torch::TensorOptions().dtype(torch::kBool).device(torch::kCUDA));
+            }
 
             // Create progress bar based on headless flag
             if (params.optimization.headless) {
@@ -400,6 +943,41 @@ namespace gs::training {
             evaluator_ = std::make_unique<MetricsEvaluator>(params_);
             LOG_DEBUG("Metrics evaluator initialized");
 
+            telemetry_.reset();
+            if (!params.optimization.telemetry_output.empty()) {
+                const auto format = params.optimization.telemetry_format == "binary" ? TelemetryStream::Format::Binary
+                                                                                     : TelemetryStream::Format::Csv;
+                auto stream = TelemetryStream::open(params.optimization.telemetry_output, format);
+                if (!stream) {
+                    return std::unexpected(stream.error());
+                }
+                telemetry_ = std::move(*stream);
+            }
+
+            start_iteration_ = 1;
+            if (params.resume_checkpoint) {
+                if (auto result = restore_checkpoint(*params.resume_checkpoint); !result) {
+                    return std::unexpected(result.error());
+                }
+            } else if (params.init_checkpoint) {
+                if (auto result = warm_start(*params.init_checkpoint); !result) {
+                    return std::unexpected(result.error());
+                }
+            }
+
+            // Ids start with the model as it is now, after a resume the first delta is a keyframe
+            if (params.optimization.save_delta) {
+                strategy_->get_model().enable_gaussian_ids();
+                delta_writer_ = std::make_unique<core::SplatDeltaWriter>(
+                    core::SplatDeltaWriter::Options{.directory = params.dataset.output_path / "delta"});
+            }
+
+            model_snapshot_.reset();
+            last_snapshot_iteration_ = start_iteration_ - 1;
+            if (!params.optimization.headless && params.optimization.viewer_snapshot_every > 0) {
+                model_snapshot_ = std::make_shared<ModelSnapshot>();
+            }
+
             // Print configuration
             LOG_INFO("Render mode: {}", params.optimization.render_mode);
             LOG_INFO("Visualization: {}", params.optimization.headless ? "disabled" : "enabled");
@@ -421,6 +999,12 @@ namespace gs::training {
         if (callback_busy_.load()) {
             callback_stream_.synchronize();
         }
+        if (saved_determinism_) {
+            const auto [algorithms, warn_only, cudnn, benchmark] = *saved_determinism_;
+            at::globalContext().setDeterministicAlgorithms(algorithms, warn_only);
+            at::globalContext().setDeterministicCuDNN(cudnn);
+            at::globalContext().setBenchmarkCuDNN(benchmark);
+        }
         LOG_DEBUG("Trainer destroyed");
     }
 
@@ -438,6 +1022,7 @@ namespace gs::training {
                 progress_->pause();
             }
             LOG_INFO("Training paused at iteration {}", iter);
+            publish_snapshot(iter, /*force=*/true);
             LOG_DEBUG("Click 'Resume Training' to continue.");
         } else if (!pause_requested_.load() && is_paused_.load()) {
             is_paused_ = false;
@@ -451,9 +1036,12 @@ namespace gs::training {
         if (save_requested_.exchange(false)) {
             LOG_INFO("Saving checkpoint at iteration {}...", iter);
             auto checkpoint_path = params_.dataset.output_path / "checkpoints";
-            save_ply(checkpoint_path, iter, /*join=*/true);
+            // Snapshot save, the PLY is written in the background while training continues
+            save_ply(checkpoint_path, iter, /*join=*/false);
+            save_checkpoint(iter);
 
-            LOG_INFO("Checkpoint saved to {}", checkpoint_path.string());
+            // The PLY writer logs once the file is complete
+            LOG_INFO("Checkpoint at iteration {} queued for {}", iter, checkpoint_path.string());
 
             // Emit checkpoint saved event
             events::state::CheckpointSaved{
@@ -467,6 +1055,7 @@ namespace gs::training {
             LOG_INFO("Stopping training permanently at iteration {}...", iter);
             LOG_DEBUG("Saving final model...");
             save_ply(params_.dataset.output_path, iter, /*join=*/true);
+            save_checkpoint(iter);
             is_running_ = false;
         }
     }
@@ -494,10 +1083,10 @@ namespace gs::training {
         }
     }
 
-    torch::Tensor sine_background_for_step(
-        int step, int periodR = 37, int periodG = 41, int periodB = 43, bool grayscale_only = false, float jitter_amp = 0.03f) {
+    std::array<float, 3> sine_background_for_step(
+        int step, std::mt19937& rng, int periodR = 37, int periodG = 41, int periodB = 43, bool grayscale_only = false,
+        float jitter_amp = 0.03f) {
         const float eps = 1e-4f;
-        auto opts = torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA);
         const float two_pi = M_PI * 2.0f;
 
         // Phase 0..2PI
@@ -510,47 +1099,30 @@ namespace gs::training {
         const float tB = (periodB > 0) ? float(step % periodB) / float(periodB) : 0.0f;
         const float phaseB = two_pi * tB;
 
-        torch::Tensor bg;
+        std::array<float, 3> bg;
         if (grayscale_only) {
             // Grayscale: g in [0,1]
-            float g = 0.5f * (1.0f + std::sin(phaseG));
-            bg = torch::tensor({g, g, g}, opts);
+            const float g = 0.5f * (1.0f + std::sin(phaseG));
+            bg = {g, g, g};
         } else {
             // Phase-shifted RGB: covers the color wheel over the cycle
-            float r = 0.5f * (1.0f + std::sin(phaseR + 0.0f * two_pi / 3.0f));
-            float g = 0.5f * (1.0f + std::sin(phaseG + 1.0f * two_pi / 3.0f));
-            float b = 0.5f * (1.0f + std::sin(phaseB + 2.0f * two_pi / 3.0f));
-            bg = torch::tensor({r, g, b}, opts);
+            bg = {0.5f * (1.0f + std::sin(phaseR + 0.0f * two_pi / 3.0f)),
+                  0.5f * (1.0f + std::sin(phaseG + 1.0f * two_pi / 3.0f)),
+                  0.5f * (1.0f + std::sin(phaseB + 2.0f * two_pi / 3.0f))};
         }
 
         // Small jitter to prevent exact periodic lock-in
-        if (jitter_amp > 0.0f) {
-            auto jitter = (torch::rand({3}, opts) - 0.5f) * (2.0f * jitter_amp);
-            bg = (bg + jitter).clamp(eps, 1.0f - eps);
-        } else {
-            bg = bg.clamp(eps, 1.0f - eps);
+        std::uniform_real_distribution<float> jitter(-jitter_amp, jitter_amp);
+        for (float& channel : bg) {
+            if (jitter_amp > 0.0f) {
+                channel += jitter(rng);
+            }
+            channel = std::clamp(channel, eps, 1.0f - eps);
         }
         return bg;
     }
 
-    // Helper to ensure buf matches base (defined, dtype, device, shape)
-    static inline void ensure_like(torch::Tensor& buf, const torch::Tensor& base) {
-        bool is_undefined = !buf.defined();
-        bool dtype_mismatch = (buf.dtype() != base.dtype());
-
-        bool need = (is_undefined || dtype_mismatch);
-        if (!need) {
-            bool device_mismatch = (buf.device() != base.device());
-            bool shape_mismatch = (buf.sizes().vec() != base.sizes().vec());
-            need = (device_mismatch || shape_mismatch);
-        }
-
-        if (need)
-            buf = torch::empty_like(base);
-    }
-
     torch::Tensor& Trainer::background_for_step(int iter) {
-        torch::NoGradGuard no_grad;
         const auto& opt = params_.optimization;
 
         // Fast path: modulation disabled: return base background_
@@ -563,19 +1135,198 @@ namespace gs::training {
             return background_;
         }
 
-        // Generate per-iteration sine background
-        auto sine_bg = sine_background_for_step(iter);
-
-        // Ensure reusable buffer exists
-        ensure_like(bg_mix_buffer_, background_);
+        // Three floats are cheaper mixed on the host than in a chain of tiny kernels, the step only
+        // pays one async copy out of a pinned slot
+        const auto sine_bg = sine_background_for_step(iter, bg_rng_);
+        if (!bg_host_ring_.defined()) {
+            bg_host_ring_ = torch::empty({static_cast<int64_t>(bg_host_ready_.size()), 3},
+                                         torch::TensorOptions().dtype(torch::kFloat32).pinned_memory(true));
+            bg_mix_buffer_ = torch::empty_like(background_);
+        }
 
-        bg_mix_buffer_.copy_(background_); // d2d copy of 3 floats
-        bg_mix_buffer_.mul_(1.0f - w_mix);
-        bg_mix_buffer_.add_(sine_bg, w_mix);
+        // The slot is rewritten only once its previous copy has left, which is long done by now
+        at::cuda::CUDAEvent& ready = bg_host_ready_[bg_host_slot_];
+        ready.synchronize();
+        float* slot = bg_host_ring_.data_ptr<float>() + 3 * bg_host_slot_;
+        for (int c = 0; c < 3; ++c) {
+            slot[c] = background_color_[c] * (1.0f - w_mix) + sine_bg[c] * w_mix;
+        }
+        bg_mix_buffer_.copy_(bg_host_ring_[static_cast<int64_t>(bg_host_slot_)], /*non_blocking=*/true);
+        ready.record();
+        bg_host_slot_ = (bg_host_slot_ + 1) % bg_host_ready_.size();
 
         return bg_mix_buffer_; // const ref to mixed background
     }
 
+    std::expected<void, std::string> Trainer::validate_camera(const Camera* cam) const {
+        return check_camera_supported(*rasterizer_, *cam);
+    }
+
+    int Trainer::resolution_divisor(int iter, const Camera& cam) const {
+        constexpr int MIN_PROGRESSIVE_SIDE = 64;
+        const int steps = params_.optimization.progressive_resolution;
+        if (steps <= 0 || iter >= steps) {
+            return 1;
+        }
+        int divisor = iter < steps / 2 ? 4 : 2;
+        const int short_side = std::min(cam.image_width(), cam.image_height());
+        while (divisor > 1 && short_side / divisor < MIN_PROGRESSIVE_SIDE) {
+            divisor /= 2;
+        }
+        return divisor;
+    }
+
+    torch::Tensor Trainer::training_image(int iter, const Camera& cam, const torch::Tensor& gt_image) const {
+        const int divisor = resolution_divisor(iter, cam);
+        if (divisor == 1) {
+            return gt_image;
+        }
+        // A divisor x divisor box equals that many 2x2 mip reductions, trailing pixels are dropped
+        // exactly like the integer division of the render size
+        return torch::nn::functional::avg_pool2d(
+            gt_image, torch::nn::functional::AvgPool2dFuncOptions(divisor).stride(divisor));
+    }
+
+    Trainer::ViewCrop Trainer::sample_crop(const torch::Tensor& gt_image) {
+        const int height = static_cast<int>(gt_image.size(-2));
+        const int width = static_cast<int>(gt_image.size(-1));
+        const int crop_size = params_.optimization.crop_size;
+        if (crop_size <= 0 || (crop_size >= width && crop_size >= height)) {
+            return {0, 0, width, height};
+        }
+        ViewCrop crop{0, 0, std::min(crop_size, width), std::min(crop_size, height)};
+        crop.x = std::uniform_int_distribution<int>(0, width - crop.width)(crop_rng_);
+        crop.y = std::uniform_int_distribution<int>(0, height - crop.height)(crop_rng_);
+        return crop;
+    }
+
+    torch::Tensor Trainer::apply_crop(const torch::Tensor& image, const ViewCrop& crop) {
+        if (!image.defined() || (crop.width == image.size(-1) && crop.height == image.size(-2))) {
+            return image;
+        }
+        return image.narrow(-2, crop.y, crop.height).narrow(-1, crop.x, crop.width).contiguous();
+    }
+
+    void Trainer::record_view_loss(const Camera& cam, const torch::Tensor& loss) {
+        if (!view_sampler_) {
+            return;
+        }
+        if (!params_.optimization.sync_free_step) {
+            view_sampler_->record(cam.uid(), loss.item<float>());
+            return;
+        }
+        view_loss_readback_.push(cam.uid(), loss);
+        for (const auto& sample : view_loss_readback_.poll_all()) {
+            view_sampler_->record(sample.iteration, sample.loss);
+        }
+    }
+
+    RenderOutput Trainer::render_view(int iter, Camera* cam, RenderMode render_mode, const ViewCrop& crop,
+                                      const torch::Tensor& pixel_mask) {
+        // The dataset camera renders as is unless the pose, resolution or crop differ for this step
+        const int divisor = resolution_divisor(iter, *cam);
+        const int image_width = divisor > 1 ? cam->image_width() / divisor : cam->image_width();
+        const int image_height = divisor > 1 ? cam->image_height() / divisor : cam->image_height();
+        const bool cropped = crop.width != image_width || crop.height != image_height;
+        std::optional<Camera> adjusted_cam;
+        if (poseopt_optimizer_) {
+            poseopt_ids_.fill_(cam->uid());
+            adjusted_cam.emplace(*cam, poseopt_module_->forward(cam->world_view_transform(), poseopt_ids_));
+        } else if (divisor > 1 || cropped) {
+            adjusted_cam.emplace(*cam, cam->world_view_transform());
+        }
+        // The intrinsics follow the image size, so this rescales them too
+        if (divisor > 1) {
+            adjusted_cam->update_image_dimensions(image_width, image_height);
+        }
+        if (cropped) {
+            adjusted_cam->crop_image(crop.x, crop.y, crop.width, crop.height);
+        }
+        Camera& render_cam = adjusted_cam ? *adjusted_cam : *cam;
+
+        torch::Tensor& bg = background_for_step(iter);
+        if (step_views_.defined()) {
+            step_views_[cam->uid()].fill_(true);
+        }
+
+        // Every backward needs its own gather graph into the palette, or product with the basis
+        if (strategy_->get_model().has_sh_codebook() || strategy_->get_model().has_sh_basis()) {
+            if (model_snapshot_) {
+                model_snapshot_->fence();
+            }
+            std::unique_lock<std::shared_mutex> lock(render_mutex_);
+            if (strategy_->get_model().has_sh_codebook()) {
+                strategy_->get_model().gather_sh_codebook();
+            } else {
+                strategy_->get_model().expand_sh_basis();
+            }
+        }
+
+        // Late in training the forward sees what the SOG export will store
+        std::optional<SplatData> quantized;
+        if (sog_quantizer_ && iter >= params_.optimization.sog_qat_iteration) {
+            PROFILE_ZONE("sog quantize");
+            sog_quantizer_->update(iter, strategy_->get_model());
+            quantized.emplace(sog_quantizer_->quantize(strategy_->get_model()));
+        }
+
+        // Use the render mode from parameters
+        core::ProfileZone rasterize_zone("rasterize");
+        RenderOutput r_output = rasterizer_->render(render_cam, quantized ? *quantized : strategy_->get_model(),
+                                                    bg, render_mode, pixel_mask);
+        rasterize_zone.end();
+
+        // Apply bilateral grid if enabled, the fused loss slices it while loading the pixels
+        if (bilateral_grid_ && params_.optimization.use_bilateral_grid) {
+            if (params_.optimization.fused_loss) {
+                r_output.bilateral_grid = bilateral_grid_->grid(cam->uid());
+            } else {
+                r_output.image = bilateral_grid_->apply(r_output.image, cam->uid());
+            }
+        }
+        return r_output;
+    }
+
+    std::expected<void, std::string> Trainer::accumulate_view(
+        int iter,
+        Camera* cam,
+        const torch::Tensor& gt_image,
+        RenderMode render_mode) {
+        PROFILE_ZONE("extra view");
+        try {
+            if (auto valid = validate_camera(cam); !valid) {
+                return valid;
+            }
+
+            const torch::Tensor full_gt = training_image(iter, *cam, gt_image);
+            const ViewCrop crop = sample_crop(full_gt);
+            const torch::Tensor gt = apply_crop(full_gt, crop);
+            const torch::Tensor mask = apply_crop(valid_pixel_mask(*cam, full_gt), crop);
+            const RenderOutput r_output = render_view(iter, cam, render_mode, crop, mask);
+            auto loss_result = compute_photometric_loss(r_output, gt, strategy_->get_model(), params_.optimization, mask);
+            if (!loss_result) {
+                return std::unexpected(loss_result.error());
+            }
+
+            // Backward now: the ground truth aliases a loader buffer that the next fetch recycles
+            const torch::Tensor loss = *loss_result / static_cast<float>(params_.optimization.views_per_step);
+            loss.backward();
+            record_view_loss(*cam, loss_result->detach());
+            if (params_.optimization.sparse_adam && r_output.visibility.defined()) {
+                const auto visibility = r_output.visibility.reshape({-1});
+                step_visibility_ = step_visibility_.defined() ? step_visibility_.logical_or(visibility) : visibility;
+            }
+            if (params_.optimization.sync_free_step) {
+                batch_loss_tensor_ = batch_loss_tensor_.defined() ? batch_loss_tensor_ + loss.detach() : loss.detach();
+            } else {
+                batch_loss_ += loss.item<float>();
+            }
+            return {};
+        } catch (const std::exception& e) {
+            return std::unexpected(std::format("Training view failed: {}", e.what()));
+        }
+    }
+
     std::expected<Trainer::StepResult, std::string> Trainer::train_step(
         int iter,
         Camera* cam,
@@ -583,18 +1334,8 @@ namespace gs::training {
         RenderMode render_mode,
         std::stop_token stop_token) {
         try {
-            if (params_.optimization.gut) {
-                if (cam->camera_model_type() == gsplat::CameraModelType::ORTHO) {
-                    return std::unexpected("Training on cameras with ortho model is not supported yet.");
-                }
-            } else {
-                if (cam->radial_distortion().numel() != 0 ||
-                    cam->tangential_distortion().numel() != 0) {
-                    return std::unexpected("Distorted images detected.  You can use --gut option to train on cameras with distortion.");
-                }
-                if (cam->camera_model_type() != gsplat::CameraModelType::PINHOLE) {
-                    return std::unexpected("You must use --gut option to train on cameras with non-pinhole model.");
-                }
+            if (auto valid = validate_camera(cam); !valid) {
+                return std::unexpected(valid.error());
             }
 
             current_iteration_ = iter;
@@ -645,76 +1386,121 @@ namespace gs::training {
                 }
             }
 
-            auto adjusted_cam_pos = poseopt_module_->forward(cam->world_view_transform(), torch::tensor({cam->uid()}));
-            auto adjusted_cam = Camera(*cam, adjusted_cam_pos);
-
-            torch::Tensor& bg = background_for_step(iter);
-
-            RenderOutput r_output;
-            // Use the render mode from parameters
-            if (!params_.optimization.gut) {
-                r_output = fast_rasterize(adjusted_cam, strategy_->get_model(), bg);
-            } else {
-                r_output = rasterize(adjusted_cam, strategy_->get_model(), bg, 1.0f, false, false, render_mode,
-                                     nullptr);
-            }
-
-            // Apply bilateral grid if enabled
-            if (bilateral_grid_ && params_.optimization.use_bilateral_grid) {
-                r_output.image = bilateral_grid_->apply(r_output.image, cam->uid());
-            }
+            core::ProfileZone forward_zone("forward");
+            gt_image = training_image(iter, *cam, gt_image);
+            const ViewCrop crop = sample_crop(gt_image);
+            const torch::Tensor mask = apply_crop(valid_pixel_mask(*cam, gt_image), crop);
+            gt_image = apply_crop(gt_image, crop);
+            RenderOutput r_output = render_view(iter, cam, render_mode, crop, mask);
 
             // Compute losses
             auto loss_result = compute_photometric_loss(r_output,
                                                         gt_image,
                                                         strategy_->get_model(),
-                                                        params_.optimization);
+                                                        params_.optimization,
+                                                        mask);
             if (!loss_result) {
                 return std::unexpected(loss_result.error());
             }
-
-            torch::Tensor loss = *loss_result;
-            loss.backward();
-            float loss_value = loss.item<float>();
-
-            // Scale regularization loss
-            auto scale_loss_result = compute_scale_reg_loss(strategy_->get_model(), params_.optimization);
-            if (!scale_loss_result) {
-                return std::unexpected(scale_loss_result.error());
+            if (telemetry_) {
+                telemetry_->mark(TelemetryStream::Phase::Forward);
             }
-            loss = *scale_loss_result;
-            loss.backward();
-            loss_value += loss.item<float>();
+            forward_zone.end();
+            core::ProfileZone backward_zone("backward");
+
+            // sync_free_step: sum all terms for a single backward and never read the loss here
+            const bool sync_free = params_.optimization.sync_free_step;
+            torch::Tensor total_loss;
+            float loss_value = 0.f;
+            const auto accumulate = [&](const torch::Tensor& loss) {
+                if (!sync_free) {
+                    loss.backward();
+                    loss_value += loss.item<float>();
+                    return;
+                }
+                // Disabled terms are zero placeholder leaves with no path to any parameter
+                if (!loss.grad_fn()) {
+                    return;
+                }
+                total_loss = total_loss.defined() ? total_loss + loss.sum() : loss.sum();
+            };
+
+            // With views_per_step the photometric term is the mean over the step's views
+            const int views_per_step = params_.optimization.views_per_step;
+            accumulate(views_per_step > 1 ? *loss_result / static_cast<float>(views_per_step) : *loss_result);
+            record_view_loss(*cam, loss_result->detach());
+
+            // Scale and opacity regularization, fused after the backward when the parameters allow
+            const bool fused_regularizers = use_fused_regularizers();
+            if (!fused_regularizers) {
+                auto scale_loss_result = compute_scale_reg_loss(strategy_->get_model(), params_.optimization);
+                if (!scale_loss_result) {
+                    return std::unexpected(scale_loss_result.error());
+                }
+                accumulate(*scale_loss_result);
 
-            // Opacity regularization loss
-            auto opacity_loss_result = compute_opacity_reg_loss(strategy_->get_model(), params_.optimization);
-            if (!opacity_loss_result) {
-                return std::unexpected(opacity_loss_result.error());
+                auto opacity_loss_result = compute_opacity_reg_loss(strategy_->get_model(), params_.optimization);
+                if (!opacity_loss_result) {
+                    return std::unexpected(opacity_loss_result.error());
+                }
+                accumulate(*opacity_loss_result);
             }
-            loss = *opacity_loss_result;
-            loss.backward();
-            loss_value += loss.item<float>();
 
             // Bilateral grid TV loss
-            auto tv_loss_result = compute_bilateral_grid_tv_loss(bilateral_grid_, params_.optimization);
+            auto tv_loss_result = compute_bilateral_grid_tv_loss(bilateral_grid_, *cam, params_.optimization);
             if (!tv_loss_result) {
                 return std::unexpected(tv_loss_result.error());
             }
-            loss = *tv_loss_result;
-            loss.backward();
-            loss_value += loss.item<float>();
+            accumulate(*tv_loss_result);
 
             // Add sparsity loss
             auto sparsity_loss_result = compute_sparsity_loss(iter, strategy_->get_model());
             if (!sparsity_loss_result) {
                 return std::unexpected(sparsity_loss_result.error());
             }
-            loss = *sparsity_loss_result;
-            loss.backward();
-            loss_value += loss.item<float>();
+            accumulate(*sparsity_loss_result);
 
-            // Store the loss value immediately
-            current_loss_ = loss_value;
+            if (sync_free) {
+                total_loss.backward();
+            }
+
+            // Added into the gradients the backward produced
+            torch::Tensor fused_reg_loss;
+            if (fused_regularizers) {
+                auto reg_result = apply_fused_regularizers();
+                if (!reg_result) {
+                    return std::unexpected(reg_result.error());
+                }
+                fused_reg_loss = std::move(*reg_result);
+            }
+
+            if (sync_free) {
+                if (fused_reg_loss.defined()) {
+                    total_loss = total_loss.detach() + fused_reg_loss;
+                }
+                if (batch_loss_tensor_.defined()) {
+                    total_loss = total_loss.detach() + batch_loss_tensor_;
+                    batch_loss_tensor_ = torch::Tensor();
+                }
+                // Progress and events see the loss of an iteration a few steps back
+                loss_readback_.push(iter, total_loss);
+                if (const auto sample = loss_readback_.poll()) {
+                    current_loss_ = sample->loss;
+                }
+                loss_value = current_loss_.load();
+            } else {
+                if (fused_reg_loss.defined()) {
+                    loss_value += fused_reg_loss.item<float>();
+                }
+                loss_value += batch_loss_;
+                batch_loss_ = 0.f;
+                // Store the loss value immediately
+                current_loss_ = loss_value;
+            }
+            if (telemetry_) {
+                telemetry_->mark(TelemetryStream::Phase::Backward);
+            }
+            backward_zone.end();
 
             // Update progress synchronously if needed
             if (progress_) {
@@ -738,33 +1524,97 @@ namespace gs::training {
 
                 DeferredEvents deferred;
                 {
+                    if (model_snapshot_) {
+                        model_snapshot_->fence();
+                    }
                     std::unique_lock<std::shared_mutex> lock(render_mutex_);
 
+                    // The bilateral grid and the poses don't depend on the Gaussians, their steps
+                    // are queued first and a refinement only waits for the backward
+                    const bool refining = strategy_->is_refining(iter);
+                    at::cuda::CUDAEvent backward_done;
+                    if (refining) {
+                        backward_done.record(at::cuda::getCurrentCUDAStream());
+                    }
+                    core::ProfileZone camera_zone("camera optimizers");
+                    if (params_.optimization.use_bilateral_grid) {
+                        bilateral_grid_optimizer_->set_visibility(step_views_);
+                        bilateral_grid_optimizer_->step(iter);
+                        bilateral_grid_optimizer_->zero_grad(true, iter);
+                        bilateral_grid_scheduler_->step();
+                    }
+                    if (params_.optimization.pose_optimization != "none") {
+                        poseopt_optimizer_->set_visibility(step_views_);
+                        poseopt_optimizer_->step(iter);
+                        poseopt_optimizer_->zero_grad(true, iter);
+                    }
+                    if (step_views_.defined()) {
+                        step_views_.zero_();
+                    }
+                    camera_zone.end();
+
                     // Execute strategy post-backward and step
                     // Only call post_backward during base training (not during sparsification)
+                    core::ProfileZone refine_zone("refine");
+                    bool refined = false;
+                    // Refinement runs on its own stream between the backward and the step, beside
+                    // the camera optimizer work and while the host blocks on its syncs
+                    std::optional<SideStreamScope> refine_scope;
+                    if (refining) {
+                        refine_scope.emplace(refine_stream_, backward_done);
+                    }
                     if (params_.optimization.enable_sparsity) {
                         int base_iterations = params_.optimization.iterations - params_.optimization.sparsify_steps;
                         if (iter <= base_iterations) {
                             strategy_->post_backward(iter, r_output);
+                            refined = strategy_->is_refining(iter);
                         }
                         // During sparsification phase, skip post_backward entirely
                     } else {
                         // No sparsity, always call post_backward
                         strategy_->post_backward(iter, r_output);
+                        refined = strategy_->is_refining(iter);
                     }
-
+                    refine_scope.reset();
+                    if (telemetry_) {
+                        telemetry_->mark(TelemetryStream::Phase::Refine);
+                    }
+                    refine_zone.end();
+                    core::ProfileZone optimizer_zone("optimizer");
+
+                    if (params_.optimization.sparse_adam && r_output.visibility.defined()) {
+                        const auto visibility = r_output.visibility.reshape({-1});
+                        // refinement in post_backward may have resized the model, the optimizer then steps densely
+                        strategy_->set_optimizer_visibility(
+                            step_visibility_.defined() ? step_visibility_.logical_or(visibility) : visibility);
+                    }
+                    step_visibility_ = torch::Tensor();
                     strategy_->step(iter);
 
-                    if (params_.optimization.use_bilateral_grid) {
-                        bilateral_grid_optimizer_->step();
-                        bilateral_grid_optimizer_->zero_grad(true);
-                        bilateral_grid_scheduler_->step();
+                    // Densified Gaussians are appended at the end, sorting after the step keeps the
+                    // step's visibility mask valid. The spatial index rebuilds on the next iteration.
+                    if (refined && params_.optimization.morton_order) {
+                        sort_model_morton();
                     }
-                    if (params_.optimization.pose_optimization != "none") {
-                        poseopt_optimizer_->step();
-                        poseopt_optimizer_->zero_grad(true);
+
+                    // A resumed run past the iteration quantizes on its first step
+                    const int codebook_iteration = params_.optimization.sh_codebook_iteration;
+                    if (codebook_iteration > 0 && iter >= codebook_iteration && !strategy_->get_model().has_sh_codebook()) {
+                        strategy_->quantize_sh(params_.optimization.sh_codebook_size);
+                    }
+                    const int basis_iteration = params_.optimization.sh_basis_iteration;
+                    if (basis_iteration > 0 && iter >= basis_iteration && !strategy_->get_model().has_sh_basis()) {
+                        strategy_->factor_sh(params_.optimization.sh_basis_rank);
                     }
 
+                    if (telemetry_) {
+                        telemetry_->mark(TelemetryStream::Phase::Optimizer);
+                    }
+                    optimizer_zone.end();
+
+                    // Trims the CUDA cache only while the reserved pool is over budget
+                    VramManager::get().relieve();
+
                     // Queue event for emission after lock release
                     deferred.add(events::state::ModelUpdated{
                         .iteration = iter,
@@ -783,13 +1633,44 @@ namespace gs::training {
                     LOG_ERROR("Sparsity pruning failed: {}", result.error());
                 }
 
-                // Clean evaluation - let the evaluator handle everything
-                if (evaluator_->is_enabled() && evaluator_->should_evaluate(iter)) {
+                // A converged base phase ends here: training stops, or sparsification starts now
+                bool stopped_early = false;
+                const bool base_phase = !params_.optimization.enable_sparsity ||
+                                        iter <= static_cast<int>(params_.optimization.iterations - params_.optimization.sparsify_steps);
+                if (convergence_ && base_phase && convergence_->update(iter, loss_value)) {
+                    convergence_.reset();
+                    if (params_.optimization.enable_sparsity) {
+                        LOG_INFO("Loss converged at iteration {}, sparsifying from here", iter);
+                        params_.optimization.iterations = iter + params_.optimization.sparsify_steps;
+                        sparsity_optimizer_ = create_sparsity_optimizer(iter);
+                    } else {
+                        LOG_INFO("Loss converged at iteration {}, ending training", iter);
+                        params_.optimization.iterations = iter;
+                        stopped_early = true;
+                    }
+                }
+
+                publish_snapshot(iter, /*force=*/iter == params_.optimization.iterations);
+
+                // Evaluation and saving below are not part of the step's telemetry
+                if (telemetry_) {
+                    telemetry_->end_step(loss_result->detach(), loss_value, strategy_->get_model().size());
+                }
+                core::Profiler::get().end_iteration(iter);
+
+                // Clean evaluation - let the evaluator handle everything, an early end is evaluated too
+                // Only the last iteration gets the full evaluation, the others may be fast ones
+                const bool evaluate = evaluator_->is_enabled() && (evaluator_->should_evaluate(iter) || stopped_early);
+                const bool full_eval = iter == static_cast<int>(params_.optimization.iterations);
+                if (evaluate && params_.optimization.async_eval) {
+                    evaluator_->evaluate_async(iter, strategy_->get_model(), val_dataset_, background_, full_eval);
+                } else if (evaluate) {
                     evaluator_->print_evaluation_header(iter);
                     auto metrics = evaluator_->evaluate(iter,
                                                         strategy_->get_model(),
                                                         val_dataset_,
-                                                        background_);
+                                                        background_,
+                                                        full_eval);
                     LOG_INFO("{}", metrics.to_string());
                 }
 
@@ -799,7 +1680,12 @@ namespace gs::training {
                         if (iter == static_cast<int>(save_step) && iter != params_.optimization.iterations) {
                             const bool join_threads = (iter == params_.optimization.save_steps.back());
                             auto save_path = params_.dataset.output_path;
-                            save_ply(save_path, iter, /*join=*/join_threads);
+                            if (delta_writer_) {
+                                delta_writer_->save(strategy_->get_model(), iter, join_threads);
+                            } else {
+                                save_ply(save_path, iter, /*join=*/join_threads);
+                            }
+                            save_checkpoint(iter);
                             // Emit checkpoint saved event
                             events::state::CheckpointSaved{
                                 .iteration = iter,
@@ -809,7 +1695,15 @@ namespace gs::training {
                     }
                 }
 
+                // Periodic resumable state, e.g. for preemptible machines
+                const int checkpoint_every = params_.optimization.checkpoint_every;
+                if (checkpoint_every > 0 && iter % checkpoint_every == 0 && iter != params_.optimization.iterations) {
+                    save_checkpoint(iter);
+                }
+
                 if (!params_.dataset.timelapse_images.empty() && iter % params_.dataset.timelapse_every == 0) {
+                    std::vector<Camera*> timelapse_cameras;
+                    std::vector<std::string> timelapse_names;
                     for (const auto& img_name : params_.dataset.timelapse_images) {
                         auto train_cam = train_dataset_->get_camera_by_filename(img_name);
                         auto val_cam = val_dataset_ ? val_dataset_->get_camera_by_filename(img_name) : std::nullopt;
@@ -823,25 +1717,36 @@ namespace gs::training {
                                 cam_to_use->image_width() > params_.dataset.max_width) {
                                 cam_to_use->load_image_size(params_.dataset.resize_factor, params_.dataset.max_width);
                             }
+                            timelapse_cameras.push_back(cam_to_use);
+                            timelapse_names.push_back(img_name);
+                        } else {
+                            LOG_WARN("Timelapse image '{}' not found in dataset.", img_name);
+                        }
+                    }
 
-                            RenderOutput rendered_timelapse_output = fast_rasterize(
-                                *cam_to_use, strategy_->get_model(), background_);
+                    // 3DGUT renders all timelapse views in one batch, fastgs one at a time
+                    std::vector<RenderOutput> timelapse_outputs;
+                    if (params_.optimization.gut) {
+                        timelapse_outputs = rasterize_batch(timelapse_cameras, strategy_->get_model(), background_);
+                    } else {
+                        for (Camera* cam_to_use : timelapse_cameras) {
+                            timelapse_outputs.push_back(fast_rasterize(*cam_to_use, strategy_->get_model(), background_));
+                        }
+                    }
 
-                            // Get folder name to save in by stripping file extension
-                            std::string folder_name = img_name;
-                            auto last_dot = folder_name.find_last_of('.');
-                            if (last_dot != std::string::npos) {
-                                folder_name = folder_name.substr(0, last_dot);
-                            }
+                    for (size_t i = 0; i < timelapse_outputs.size(); ++i) {
+                        // Get folder name to save in by stripping file extension
+                        std::string folder_name = timelapse_names[i];
+                        auto last_dot = folder_name.find_last_of('.');
+                        if (last_dot != std::string::npos) {
+                            folder_name = folder_name.substr(0, last_dot);
+                        }
 
-                            auto output_path = params_.dataset.output_path / "timelapse" / folder_name;
-                            std::filesystem::create_directories(output_path);
+                        auto output_path = params_.dataset.output_path / "timelapse" / folder_name;
+                        std::filesystem::create_directories(output_path);
 
-                            image_io::save_image_async(output_path / std::format("{:06d}.jpg", iter),
-                                                       rendered_timelapse_output.image);
-                        } else {
-                            LOG_WARN("Timelapse image '{}' not found in dataset.", img_name);
-                        }
+                        image_io::save_image_async(output_path / std::format("{:06d}.jpg", iter),
+                                                   timelapse_outputs[i].image);
                     }
                 }
             }
@@ -885,11 +1790,36 @@ namespace gs::training {
         }
 
         is_running_ = true; // Now we can start
-        LOG_INFO("Starting training loop with {} workers", params_.optimization.num_workers);
+        LOG_INFO("Starting training loop with {} workers", num_loader_workers_);
+
+        // The viewer renders at the lowest priority and then only gets the SMs training leaves idle.
+        // A viewer on the live model needs training on its stream, nothing else orders the two.
+        std::optional<StreamScope> priority_stream;
+        if (params_.optimization.prioritize_training) {
+            if (!params_.optimization.headless && !model_snapshot_) {
+                LOG_WARN("prioritize_training needs viewer snapshots (viewer_snapshot_every > 0), training at the default priority");
+            } else if (const cudaStream_t stream = high_priority_stream()) {
+                priority_stream.emplace(stream);
+                LOG_INFO("Training on a high-priority CUDA stream");
+            }
+        }
+        // Zone events go to the training stream, so this drains before the stream scope does.
+        // A benchmark needs the phase times but only logs them once, at the end.
+        // The viewer's performance section times the zones without logging them.
+        int profile_every = params_.optimization.profile_zones_every;
+        bool log_zones = true;
+        if (profile_every == 0 && benchmark_) {
+            profile_every = params_.optimization.iterations + 1;
+        } else if (profile_every == 0 && !params_.optimization.headless) {
+            profile_every = PERF_STATS_EVERY;
+            log_zones = false;
+        }
+        const core::ProfilingSession profiling(profile_every, log_zones);
+        core::TraceRecorder::get().set_thread_name("training");
 
         try {
-            int iter = 1;
-            const int num_workers = params_.optimization.num_workers;
+            int iter = start_iteration_;
+            int num_workers = num_loader_workers_;
             const RenderMode render_mode = stringToRenderMode(params_.optimization.render_mode);
 
             if (progress_) {
@@ -898,11 +1828,46 @@ namespace gs::training {
                                   strategy_->is_refining(iter));
             }
 
+            view_sampler_.reset();
+            if (params_.optimization.importance_sampling) {
+                view_sampler_ = std::make_shared<ViewImportanceSampler>(*train_dataset_,
+                                                                        params_.optimization.importance_sampling_floor);
+                LOG_INFO("Loss-weighted view sampling, {:.0f}% of draws uniform",
+                         params_.optimization.importance_sampling_floor * 100.f);
+            }
+
+            const ReadAheadOptions read_ahead{.depth = static_cast<size_t>(params_.optimization.read_ahead),
+                                              .mirror_dir = params_.optimization.read_ahead_mirror};
+            std::optional<WorkerCountTuner> worker_tuner;
+            if (autotune_loader_workers_) {
+                const auto& cache = train_dataset_->get_image_cache();
+                if (params_.optimization.dataloader == "efficient" && !(cache && cache->on_device())) {
+                    num_workers = autotune_worker_count(train_dataset_, num_loader_workers_,
+                                                        params_.optimization.gpu_decode, read_ahead);
+                    worker_tuner.emplace(1, num_loader_workers_);
+                } else {
+                    num_workers = std::max(1, num_loader_workers_ / 2);
+                }
+            }
+
             // Use infinite dataloader to avoid epoch restarts
-            auto train_dataloader = create_infinite_dataloader_from_dataset(train_dataset_, num_workers);
-            auto loader = train_dataloader->begin();
+            auto loader_result = create_train_dataloader(train_dataset_, params_.optimization.dataloader, num_workers,
+                                                         params_.optimization.gpu_decode, view_sampler_,
+                                                         run_seed_, read_ahead);
+            if (!loader_result) {
+                is_running_ = false;
+                return std::unexpected(loader_result.error());
+            }
+            auto train_dataloader = std::move(*loader_result);
+            LOG_INFO("Using {} dataloader", train_dataloader->name());
+            if (params_.optimization.gpu_decode && !gpu_image_decode_available()) {
+                LOG_WARN("gpu_decode requested but nvJPEG is unavailable, decoding on the CPU");
+            }
 
             LOG_DEBUG("Starting training iterations");
+            if (benchmark_) {
+                benchmark_->start();
+            }
             // Single loop without epochs
             while (iter <= params_.optimization.iterations) {
                 if (stop_token.stop_requested() || stop_requested_.load()) {
@@ -914,10 +1879,40 @@ namespace gs::training {
                     callback_stream_.synchronize();
                 }
 
-                auto& batch = *loader;
-                auto camera_with_image = batch[0].data;
+                // The step's GPU time starts here, so the extra views of a micro-batch count as forward time
+                if (telemetry_) {
+                    telemetry_->begin_step(iter);
+                }
+
+                if (spatial_index_) {
+                    spatial_index_->update(strategy_->get_model(), iter, strategy_->is_refining(iter - 1), *raster_context_);
+                }
+
+                // Extra views of a micro-batch are rendered and backpropagated one at a time,
+                // every loader image is only valid until the following next()
+                std::expected<void, std::string> batch_result;
+                for (int view = 1; view < params_.optimization.views_per_step && batch_result; ++view) {
+                    auto extra_view = train_dataloader->next();
+                    batch_result = accumulate_view(iter, extra_view.camera, extra_view.image, render_mode);
+                }
+                if (!batch_result) {
+                    return std::unexpected(batch_result.error());
+                }
+
+                auto camera_with_image = train_dataloader->next();
+                if (worker_tuner) {
+                    worker_tuner->update(*train_dataloader);
+                }
                 Camera* cam = camera_with_image.camera;
-                torch::Tensor gt_image = std::move(camera_with_image.image).to(torch::kCUDA, /*non_blocking=*/true);
+                torch::Tensor gt_image = std::move(camera_with_image.image);
+
+                // Resolution changes and densification move the best shape, re-tune per bucket
+                if (tile_shape_autotune_) {
+                    if (auto bucket = tile_shape_bucket(*cam, strategy_->get_model()); bucket != tile_shape_bucket_) {
+                        raster_context_->tile_shape = autotune_tile_shape(*cam, strategy_->get_model());
+                        tile_shape_bucket_ = std::move(bucket);
+                    }
+                }
 
                 auto step_result = train_step(iter, cam, gt_image, render_mode, stop_token);
                 if (!step_result) {
@@ -927,6 +1922,9 @@ namespace gs::training {
                 if (*step_result == StepResult::Stop) {
                     break;
                 }
+                if (benchmark_) {
+                    benchmark_->record(iter, strategy_->get_model().size());
+                }
 
                 // Launch callback for async progress update (except first iteration)
                 if (iter > 1 && callback_) {
@@ -947,8 +1945,51 @@ namespace gs::training {
                     }
                 }
 
+                if (iter % 1000 == 0) {
+                    LOG_DEBUG("Dataloader at iteration {}: {}", iter, train_dataloader->stats().to_string());
+                }
+                if (!params_.optimization.headless && iter % PERF_STATS_EVERY == 0) {
+                    update_perf_stats(iter, train_dataloader->stats());
+                }
+
                 ++iter;
-                ++loader;
+            }
+
+            LOG_INFO("Dataloader ({}): {}", train_dataloader->name(), train_dataloader->stats().to_string());
+            LOG_INFO("Rasterizer buffers: {:.1f} MB peak, {:.1f} MB reserved",
+                     raster_context_->high_water_bytes() / (1024.0 * 1024.0),
+                     raster_context_->reserved_bytes() / (1024.0 * 1024.0));
+            if (raster_context_->collect_instance_stats) {
+                const auto stats = raster_context_->instance_stats();
+                if (stats.frames > 0 && stats.bounding_instances > 0) {
+                    LOG_INFO("Tile instances: {:.0f} per frame, {:.0f} from bounding rectangles ({:.1f}% removed by the exact ellipse-tile test)",
+                             static_cast<double>(stats.instances) / stats.frames,
+                             static_cast<double>(stats.bounding_instances) / stats.frames,
+                             100.0 * (1.0 - static_cast<double>(stats.instances) / stats.bounding_instances));
+                }
+            }
+
+            if (const auto sample = loss_readback_.drain()) {
+                current_loss_ = sample->loss;
+            }
+            if (telemetry_) {
+                telemetry_->flush();
+            }
+
+            if (benchmark_) {
+                const BenchmarkRecorder::RunStats stats{
+                    .strategy = params_.optimization.strategy,
+                    .seed = run_seed_.value_or(BENCHMARK_SEED),
+                    .deterministic = params_.optimization.deterministic,
+                    .dataloader = std::string(train_dataloader->name()),
+                    .loader = train_dataloader->stats(),
+                    .instances = raster_context_->instance_stats(),
+                    .raster_high_water_bytes = raster_context_->high_water_bytes(),
+                    .raster_reserved_bytes = raster_context_->reserved_bytes()};
+                if (auto written = benchmark_->write(params_.optimization.benchmark_output, stats); !written) {
+                    is_running_ = false;
+                    return std::unexpected(written.error());
+                }
             }
 
             // Ensure callback is finished before final save
@@ -956,10 +1997,14 @@ namespace gs::training {
                 callback_stream_.synchronize();
             }
 
-            // Final save if not already saved by stop request
-            if (!stop_requested_.load() && !stop_token.stop_requested()) {
+            // Final save if not already saved by stop request, a benchmark saves nothing
+            if (!stop_requested_.load() && !stop_token.stop_requested() && !benchmark_) {
                 auto final_path = params_.dataset.output_path;
                 save_ply(final_path, params_.optimization.iterations, /*join=*/true);
+                // The final model also ends the delta chain
+                if (delta_writer_) {
+                    delta_writer_->save(strategy_->get_model(), params_.optimization.iterations, true);
+                }
                 // Emit final checkpoint saved event
                 events::state::CheckpointSaved{
                     static_cast<int>(params_.optimization.iterations),
@@ -987,34 +2032,187 @@ namespace gs::training {
     }
 
     std::shared_ptr<const Camera> Trainer::getCamById(int camId) const {
-        const auto it = m_cam_id_to_cam.find(camId);
-        if (it == m_cam_id_to_cam.end()) {
+        auto cam = camera_set_.find(camId);
+        if (!cam) {
             LOG_ERROR("getCamById - could not find cam with cam id {}", camId);
-            return nullptr;
         }
-        return it->second;
+        return cam;
     }
 
     std::vector<std::shared_ptr<const Camera>> Trainer::getCamList() const {
-        std::vector<std::shared_ptr<const Camera>> cams;
-        cams.reserve(m_cam_id_to_cam.size());
-        for (auto& [key, value] : m_cam_id_to_cam) {
-            cams.push_back(value);
+        return camera_set_.cameras();
+    }
+
+    void Trainer::save_checkpoint(int iter) {
+        // Save steps, periodic checkpoints and stop requests may land on the same iteration
+        if (iter == last_checkpoint_iteration_) {
+            return;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+
+        TrainingCheckpoint checkpoint;
+        checkpoint.set_iteration(iter);
+        strategy_->save_checkpoint(checkpoint);
+        if (bilateral_grid_optimizer_) {
+            save_adam_state(*bilateral_grid_optimizer_, "bilateral_grid", checkpoint);
+            checkpoint.meta()["bilateral_grid"]["scheduler_step"] = bilateral_grid_scheduler_->current_step();
+        }
+        if (poseopt_optimizer_) {
+            save_adam_state(*poseopt_optimizer_, "poseopt", checkpoint);
         }
 
-        return cams;
+        const auto path = params_.dataset.output_path / CHECKPOINT_DIR;
+        if (auto result = checkpoint.write(path); !result) {
+            LOG_ERROR("{}", result.error());
+            return;
+        }
+        last_checkpoint_iteration_ = iter;
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        LOG_INFO("Training checkpoint for iteration {} written to {} in {:.2f}s", iter, path.string(), seconds);
+    }
+
+    Trainer::PerfStats Trainer::get_perf_stats() const {
+        std::lock_guard lock(perf_mutex_);
+        return perf_stats_;
+    }
+
+    void Trainer::update_perf_stats(int iter, const DataLoaderStats& loader) {
+        PerfStats stats;
+        stats.iteration = iter;
+        stats.zones = core::Profiler::get().recent_times();
+
+        // Only the training thread writes perf_stats_, reading the last refresh needs no lock
+        if (const int steps = iter - perf_stats_.iteration; steps > 0 && loader.images_served >= perf_loader_.images_served) {
+            stats.load_wait_ms = (loader.stall_ms_total - perf_loader_.stall_ms_total) / steps;
+        }
+        stats.queue_depth_avg = loader.queue_depth_avg;
+        stats.queue_capacity = loader.queue_capacity;
+        perf_loader_ = loader;
+
+        const auto& model = strategy_->get_model();
+        for (const torch::Tensor* param : {&model.means(), &model.sh0(), &model.shN(),
+                                           &model.scaling_raw(), &model.rotation_raw(), &model.opacity_raw()}) {
+            if (!param->defined()) {
+                continue;
+            }
+            stats.param_bytes += param->nbytes();
+            const auto moment = fast_gs::optimizer::moment_dtype(param->scalar_type());
+            stats.optimizer_bytes += 2 * static_cast<size_t>(param->numel()) * c10::elementSize(moment);
+        }
+        stats.raster_bytes = raster_context_ ? raster_context_->reserved_bytes() : 0;
+        if (const auto& cache = train_dataset_->get_image_cache(); cache && cache->on_device()) {
+            stats.image_bytes = cache->num_bytes();
+        }
+
+        std::lock_guard lock(perf_mutex_);
+        perf_stats_ = std::move(stats);
+    }
+
+    std::expected<void, std::string> Trainer::restore_checkpoint(const std::filesystem::path& path) {
+        auto checkpoint = TrainingCheckpoint::read(path);
+        if (!checkpoint) {
+            return std::unexpected(checkpoint.error());
+        }
+
+        if (auto result = strategy_->load_checkpoint(*checkpoint); !result) {
+            return std::unexpected(std::format("Cannot resume from {}: {}", path.string(), result.error()));
+        }
+
+        if (bilateral_grid_optimizer_) {
+            if (auto result = load_adam_state(*bilateral_grid_optimizer_, "bilateral_grid", *checkpoint); !result) {
+                return std::unexpected(std::format("Cannot resume from {}: {}", path.string(), result.error()));
+            }
+            const auto& grid_meta = checkpoint->meta()["bilateral_grid"];
+            bilateral_grid_scheduler_->set_current_step(grid_meta.value("scheduler_step", 0));
+        } else if (checkpoint->meta().contains("bilateral_grid")) {
+            LOG_WARN("Checkpoint contains bilateral grid state but the bilateral grid is disabled, ignoring it");
+        }
+
+        if (poseopt_optimizer_) {
+            if (auto result = load_adam_state(*poseopt_optimizer_, "poseopt", *checkpoint); !result) {
+                return std::unexpected(std::format("Cannot resume from {}: {}", path.string(), result.error()));
+            }
+        } else if (checkpoint->meta().contains("poseopt")) {
+            LOG_WARN("Checkpoint contains pose optimization state but pose optimization is disabled, ignoring it");
+        }
+
+        start_iteration_ = checkpoint->iteration() + 1;
+        last_checkpoint_iteration_ = checkpoint->iteration();
+        current_iteration_ = checkpoint->iteration();
+
+        LOG_INFO("Resuming from {} at iteration {} with {} Gaussians",
+                 path.string(), start_iteration_, strategy_->get_model().size());
+        if (start_iteration_ > params_.optimization.iterations) {
+            LOG_WARN("Checkpoint iteration {} is already past the configured {} iterations",
+                     checkpoint->iteration(), params_.optimization.iterations);
+        }
+        return {};
+    }
+
+    std::expected<void, std::string> Trainer::warm_start(const std::filesystem::path& path) {
+        auto checkpoint = TrainingCheckpoint::read(path);
+        if (!checkpoint) {
+            return std::unexpected(checkpoint.error());
+        }
+
+        // The learning rates are the ones the prior run ended with, a fine-tune refines from there.
+        // Bilateral grid and pose state belong to the prior cameras and start over.
+        if (auto result = strategy_->load_checkpoint(*checkpoint); !result) {
+            return std::unexpected(std::format("Cannot warm-start from {}: {}", path.string(), result.error()));
+        }
+
+        LOG_INFO("Warm-starting from {} (iteration {}) with {} Gaussians",
+                 path.string(), checkpoint->iteration(), strategy_->get_model().size());
+        return {};
+    }
+
+    void Trainer::sort_model_morton() {
+        torch::NoGradGuard no_grad;
+        auto& model = strategy_->get_model();
+        if (model.size() == 0) {
+            return;
+        }
+        strategy_->reorder_gaussians(morton_sort_indices(morton_encode(model.means().contiguous())));
+    }
+
+    void Trainer::publish_snapshot(int iter, bool force) {
+        if (!model_snapshot_ || (!force && iter - last_snapshot_iteration_ < params_.optimization.viewer_snapshot_every)) {
+            return;
+        }
+        // A skipped publish (the viewer still holds the back copy) is retried on the next iteration
+        if (model_snapshot_->publish(strategy_->get_model(), iter)) {
+            last_snapshot_iteration_ = iter;
+        }
     }
 
     void Trainer::save_ply(const std::filesystem::path& save_path, int iter_num, bool join_threads) {
+        // The ADMM state is per Gaussian and not reordered, sorting waits until sparsification ended
+        if (params_.optimization.morton_order && !(sparsity_optimizer_ && sparsity_optimizer_->is_initialized())) {
+            if (model_snapshot_) {
+                model_snapshot_->fence();
+            }
+            std::unique_lock<std::shared_mutex> lock(render_mutex_);
+            sort_model_morton();
+            if (spatial_index_) {
+                spatial_index_->rebuild(strategy_->get_model());
+            }
+        }
+
         // Save PLY format - join_threads controls sync vs async
-        strategy_->get_model().save_ply(save_path, iter_num, join_threads);
+        strategy_->get_model().save_ply(save_path, iter_num, join_threads, "", params_.optimization.ply_direct_io);
 
-        // Save SOG format if requested - ALWAYS synchronous
+        // Save SOG format if requested, an async save works on a snapshot of the model
         std::filesystem::path sog_path;
         if (params_.optimization.save_sog) {
             sog_path = strategy_->get_model().save_sog(save_path, iter_num,
                                                        params_.optimization.sog_iterations,
-                                                       true); // Always synchronous
+                                                       join_threads,
+                                                       params_.optimization.sog_webp_level);
+        }
+        if (params_.optimization.save_lod) {
+            strategy_->get_model().save_lod(save_path, iter_num);
         }
 
         // Update project with PLY info
@@ -1028,6 +2226,6 @@ namespace gs::training {
             }
         }
 
-        LOG_DEBUG("PLY save initiated: {} (sync={}), SOG always sync", save_path.string(), join_threads);
+        LOG_DEBUG("PLY save initiated: {} (sync={})", save_path.string(), join_threads);
     }
 } // namespace gs::training
\ No newline at end of file
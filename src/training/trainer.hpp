@@ -4,31 +4,53 @@
 
 #pragma once
 
+#include "benchmark.hpp"
 #include "components/bilateral_grid.hpp"
 #include "components/poseopt.hpp"
+#include "components/sog_quantizer.hpp"
 #include "components/sparsity_optimizer.hpp"
+#include "convergence_monitor.hpp"
+#include "core/camera_set.hpp"
 #include "core/events.hpp"
 #include "core/parameters.hpp"
+#include "core/profiler.hpp"
+#include "core/splat_delta.hpp"
 #include "dataset.hpp"
+#include "loss_readback.hpp"
 #include "metrics/metrics.hpp"
+#include "model_snapshot.hpp"
+#include "optimizers/fused_adam.hpp"
 #include "optimizers/scheduler.hpp"
 #include "progress.hpp"
 #include "project/project.hpp"
 #include "rasterization/rasterizer.hpp"
+#include "rasterization/rasterizer_backend.hpp"
+#include "telemetry.hpp"
 #include "strategies/istrategy.hpp"
 #include <ATen/cuda/CUDAEvent.h>
+#include <array>
 #include <atomic>
 #include <expected>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <random>
 #include <shared_mutex>
 #include <stop_token>
+#include <unordered_map>
 #include <torch/torch.h>
 
+namespace fast_gs::rasterization {
+    struct RasterizerContext;
+}
+
 // Forward declaration
 class Camera;
 
 namespace gs::training {
+    class SpatialIndex;
+    class ViewImportanceSampler;
+
     class Trainer {
     public:
         // Constructor that takes ownership of strategy and shares datasets
@@ -50,6 +72,10 @@ namespace gs::training {
         // Initialize trainer - must be called before training
         std::expected<void, std::string> initialize(const param::TrainingParameters& params);
 
+        // Warm restart with a freshly initialized model, the dataset, its preloaded images and the
+        // rasterizer buffers stay. The next initialize() sets up the optimizer of the new model.
+        void reset_model(std::unique_ptr<IStrategy> strategy);
+
         // Check if trainer is initialized
         bool isInitialized() const { return initialized_.load(); }
 
@@ -71,12 +97,30 @@ namespace gs::training {
         int get_current_iteration() const { return current_iteration_.load(); }
         float get_current_loss() const { return current_loss_.load(); }
 
+        // Where the steps of a viewer run spend their time and VRAM, refreshed every few steps
+        struct PerfStats {
+            int iteration = 0;                           // 0 until the first refresh
+            std::vector<core::Profiler::ZoneTime> zones; // Mean GPU time per step of the profiling zones
+            double load_wait_ms = 0.0;                   // Mean wait for the dataloader per step
+            double queue_depth_avg = 0.0;
+            size_t queue_capacity = 0;
+            size_t param_bytes = 0;
+            size_t optimizer_bytes = 0; // Adam moments of the model parameters
+            size_t raster_bytes = 0;    // Rasterizer buffers reserved
+            size_t image_bytes = 0;     // Ground truth kept resident in VRAM
+        };
+        PerfStats get_perf_stats() const;
+
         // just for viewer to get model
         const IStrategy& get_strategy() const { return *strategy_; }
 
         // Allow viewer to lock for rendering
         std::shared_mutex& getRenderMutex() const { return render_mutex_; }
 
+        // Copies of the model the viewer renders without the lock, null headless or when
+        // viewer_snapshot_every is 0
+        std::shared_ptr<ModelSnapshot> get_model_snapshot() const { return model_snapshot_; }
+
         const param::TrainingParameters& getParams() const { return params_; }
 
         std::shared_ptr<const Camera> getCamById(int camId) const;
@@ -113,6 +157,48 @@ namespace gs::training {
         // Returns the background color to use at a given iteration
         torch::Tensor& background_for_step(int iter);
 
+        // Rejects cameras the selected rasterizer cannot train on
+        std::expected<void, std::string> validate_camera(const Camera* cam) const;
+
+        // Downscale of the training resolution at iter under progressive_resolution: 4, 2, then 1.
+        // Views stay at least MIN_PROGRESSIVE_SIDE pixels on their short side.
+        int resolution_divisor(int iter, const Camera& cam) const;
+
+        // gt_image [(B,) 3, H, W] box-filtered to the resolution_divisor level, as a mip chain would hold it
+        torch::Tensor training_image(int iter, const Camera& cam, const torch::Tensor& gt_image) const;
+
+        // Pixel window of a training view, the whole image unless crop_size is set
+        struct ViewCrop {
+            int x = 0;
+            int y = 0;
+            int width = 0;
+            int height = 0;
+        };
+
+        // Random crop_size x crop_size window of gt_image, clamped to the image's sides
+        ViewCrop sample_crop(const torch::Tensor& gt_image);
+
+        // The window of an image or mask [(B,) C, H, W], as a contiguous copy when it is smaller
+        static torch::Tensor apply_crop(const torch::Tensor& image, const ViewCrop& crop);
+
+        // Feeds a view's photometric loss to the importance_sampling sampler. Under sync_free_step
+        // it goes through view_loss_readback_ and reaches the sampler a few iterations late.
+        void record_view_loss(const Camera& cam, const torch::Tensor& loss);
+
+        // Pose-adjusted render of one training view at the resolution_divisor level, restricted to
+        // crop, with the bilateral grid applied. Tiles a defined pixel_mask [1, H, W] fully excludes
+        // are skipped by backends that support it, their pixels are undefined
+        RenderOutput render_view(int iter, Camera* cam, RenderMode render_mode, const ViewCrop& crop,
+                                 const torch::Tensor& pixel_mask = {});
+
+        // Extra view of a views_per_step batch: renders it and backpropagates its weighted
+        // photometric loss right away, gradients accumulate until the step's optimizer update
+        std::expected<void, std::string> accumulate_view(
+            int iter,
+            Camera* cam,
+            const torch::Tensor& gt_image,
+            RenderMode render_mode);
+
         // Protected method for processing a single training step
         std::expected<StepResult, std::string> train_step(
             int iter,
@@ -121,12 +207,18 @@ namespace gs::training {
             RenderMode render_mode,
             std::stop_token stop_token = {});
 
-        // Protected methods for computing loss
+        // Protected methods for computing loss. A defined valid_mask [1, H, W] zeroes the masked
+        // pixels in both images, so they contribute neither L1 nor SSIM gradient
         std::expected<torch::Tensor, std::string> compute_photometric_loss(
             const RenderOutput& render_output,
             const torch::Tensor& gt_image,
             const SplatData& splatData,
-            const param::OptimizationParameters& opt_params);
+            const param::OptimizationParameters& opt_params,
+            const torch::Tensor& valid_mask = {});
+
+        // Device mask of the camera's valid pixels at gt_image's size: the undistortion mask times
+        // the user mask (Camera::mask_path), cached on the host per camera and size, undefined without either
+        torch::Tensor valid_pixel_mask(const Camera& cam, const torch::Tensor& gt_image);
 
         std::expected<torch::Tensor, std::string> compute_scale_reg_loss(
             const SplatData& splatData,
@@ -136,8 +228,15 @@ namespace gs::training {
             const SplatData& splatData,
             const param::OptimizationParameters& opt_params);
 
+        // Float32 CUDA parameters take the scale and opacity terms through one fused kernel after the
+        // backward instead of two autograd graphs over every Gaussian
+        bool use_fused_regularizers() const;
+        // Adds the gradients of both terms into the parameter gradients, returns their loss [0-dim]
+        std::expected<torch::Tensor, std::string> apply_fused_regularizers();
+
         std::expected<torch::Tensor, std::string> compute_bilateral_grid_tv_loss(
             const std::unique_ptr<BilateralGrid>& bilateral_grid,
+            const Camera& cam,
             const param::OptimizationParameters& opt_params);
 
         // Sparsity-related methods
@@ -153,16 +252,44 @@ namespace gs::training {
             int iter,
             SplatData& splatData);
 
+        // ADMM sparsification with the params_ settings, from start_iteration on
+        std::unique_ptr<ISparsityOptimizer> create_sparsity_optimizer(int start_iteration) const;
+
         // Cleanup method for re-initialization
         void cleanup();
 
         std::expected<void, std::string> initialize_bilateral_grid();
 
+        // Decode train (then val) images into RAM or VRAM when preload_to_ram / preload_to_vram is set
+        std::expected<void, std::string> initialize_image_cache();
+
+        // Seed camera source image info from the project; with probe set, open the rest in
+        // parallel and store the result back in the project
+        void initialize_image_info(bool probe);
+
         // Handle control requests
         void handle_control_requests(int iter, std::stop_token stop_token = {});
 
+        // Publishes the model to model_snapshot_ every viewer_snapshot_every iterations, or now with force
+        void publish_snapshot(int iter, bool force);
+
         void save_ply(const std::filesystem::path& save_path, int iter_num, bool join_threads = true);
 
+        // Reorders the model along the Morton curve of its means, caller holds render_mutex_
+        void sort_model_morton();
+
+        // Writes the resumable training state to <output_path>/training_checkpoint
+        void save_checkpoint(int iter);
+
+        // Refreshes perf_stats_ from the profiler, the dataloader and the model
+        void update_perf_stats(int iter, const DataLoaderStats& loader);
+
+        // Restores strategy, bilateral grid and pose optimization state written by save_checkpoint
+        std::expected<void, std::string> restore_checkpoint(const std::filesystem::path& path);
+
+        // Takes over the model and its optimizer state from a checkpoint, the run still starts at iteration 1
+        std::expected<void, std::string> warm_start(const std::filesystem::path& path);
+
         // Member variables
         std::shared_ptr<CameraDataset> base_dataset_;
         std::shared_ptr<CameraDataset> train_dataset_;
@@ -170,25 +297,50 @@ namespace gs::training {
         std::unique_ptr<IStrategy> strategy_;
         param::TrainingParameters params_;
 
+        // Preloaded images and what they were built for, kept across re-initialization
+        std::shared_ptr<const ImageCache> image_cache_;
+        ImageCache::Options image_cache_options_;
+        bool image_cache_eval_ = false;
+
+        std::array<float, 3> background_color_{}; // Host copy of background_
         torch::Tensor background_{};
         torch::Tensor bg_mix_buffer_;
+        torch::Tensor bg_host_ring_;                       // Pinned [slots, 3] staging of the modulated background
+        std::array<at::cuda::CUDAEvent, 4> bg_host_ready_; // The copy out of each slot
+        size_t bg_host_slot_ = 0;
         std::unique_ptr<TrainingProgress> progress_;
         size_t train_dataset_size_ = 0;
 
         // Bilateral grid components
         std::unique_ptr<BilateralGrid> bilateral_grid_;
-        std::unique_ptr<torch::optim::Adam> bilateral_grid_optimizer_;
+        std::unique_ptr<FusedAdam> bilateral_grid_optimizer_;
         std::unique_ptr<WarmupExponentialLR> bilateral_grid_scheduler_;
 
         std::unique_ptr<PoseOptimizationModule> poseopt_module_; // Pose optimization module
-        std::unique_ptr<torch::optim::Adam> poseopt_optimizer_;  // Optimizer for pose optimization
+        std::unique_ptr<FusedAdam> poseopt_optimizer_;           // Optimizer for pose optimization
+        torch::Tensor poseopt_ids_;                              // [1] int64 embedding id of the rendered view
+
+        // [cameras] bool, the views rendered this step: the only grid and pose embedding rows
+        // the two optimizers above update
+        torch::Tensor step_views_;
 
         // Sparsity optimizer
         std::unique_ptr<ISparsityOptimizer> sparsity_optimizer_;
+        std::unique_ptr<SogQuantizer> sog_quantizer_; // sog_qat_iteration, null when off
+
+        // Train loss plateau test of early_stop_window, cleared once it fired
+        std::unique_ptr<ConvergenceMonitor> convergence_;
 
         // Metrics evaluator - handles all evaluation logic
         std::unique_ptr<MetricsEvaluator> evaluator_;
 
+        // Streams and upper-bound allocation state of the training renders
+        std::unique_ptr<fast_gs::rasterization::RasterizerContext> raster_context_;
+        std::unique_ptr<IRasterizerBackend> rasterizer_; // fastgs, or gsplat 3DGUT with --gut
+        bool tile_shape_autotune_ = false; // tile_shape "auto": benchmark per resolution and model size bucket
+        std::string tile_shape_bucket_;    // tile_shape_bucket() the current shape was tuned for
+        std::unique_ptr<SpatialIndex> spatial_index_; // Frustum culling chunks of the training renders, optional
+
         // Single mutex that protects the model during training
         mutable std::shared_mutex render_mutex_;
 
@@ -207,16 +359,40 @@ namespace gs::training {
 
         // Current training state
         std::atomic<int> current_iteration_{0};
+        int start_iteration_ = 1; // First iteration of train(), past 1 when resuming
+        int last_checkpoint_iteration_ = 0;
         std::atomic<float> current_loss_{0.0f};
+        LossReadbackRing loss_readback_; // sync_free_step loss values in flight
+        float batch_loss_ = 0.f;          // Photometric loss of this step's extra views (synchronous mode)
+        torch::Tensor batch_loss_tensor_; // Same, kept on the device for sync_free_step
+        std::shared_ptr<ViewImportanceSampler> view_sampler_; // importance_sampling, shared with the train loader
+        LossReadbackRing view_loss_readback_{32};             // Per-view losses for view_sampler_, tagged with camera uids
+        torch::Tensor step_visibility_;   // Gaussians any view of this step rendered, for sparse_adam
+        std::unordered_map<std::string, torch::Tensor> valid_masks_; // valid_pixel_mask() by mask path and size, pinned uint8
+        std::optional<uint32_t> run_seed_;                           // seed or the benchmark seed, none: random
+        std::optional<std::array<bool, 4>> saved_determinism_;       // Global torch flags before deterministic, restored on destruction
+        int num_loader_workers_ = 1;                                 // num_workers, cut to the cpu_threads budget; the ceiling when autotuned
+        bool autotune_loader_workers_ = false;                       // num_workers 0
+        std::mt19937 crop_rng_{std::random_device{}()};              // sample_crop() windows
+        std::mt19937 bg_rng_{std::random_device{}()};                // bg_modulation jitter
+        std::unique_ptr<TelemetryStream> telemetry_;                 // telemetry_output, null when off
+        std::unique_ptr<BenchmarkRecorder> benchmark_;               // benchmark_output, null when off
+        std::unique_ptr<core::SplatDeltaWriter> delta_writer_;       // save_delta, null when off
+        std::shared_ptr<ModelSnapshot> model_snapshot_;              // For the viewer, see get_model_snapshot()
+        int last_snapshot_iteration_ = 0;
+        mutable std::mutex perf_mutex_;
+        PerfStats perf_stats_;          // See get_perf_stats(), under perf_mutex_
+        DataLoaderStats perf_loader_;   // Loader totals at the previous refresh
 
         // Callback system for async operations
         std::function<void()> callback_;
         std::atomic<bool> callback_busy_{false};
         at::cuda::CUDAStream callback_stream_ = at::cuda::getStreamFromPool(false);
         at::cuda::CUDAEvent callback_launch_event_;
+        at::cuda::CUDAStream refine_stream_ = at::cuda::getStreamFromPool(false); // See SideStreamScope
 
-        // camera id to cam
-        std::map<int, std::shared_ptr<const Camera>> m_cam_id_to_cam;
+        // Dataset cameras by uid, with their poses and intrinsics as batched device tensors
+        CameraSet camera_set_;
 
         // LichtFeld project
         std::shared_ptr<gs::management::Project> lf_project_ = nullptr;
@@ -7,10 +7,66 @@
 #include "core/point_cloud.hpp"
 #include "loader/loader.hpp"
 #include "strategies/default_strategy.hpp"
+#include "strategies/taming_strategy.hpp"
 #include "strategies/mcmc.hpp"
 #include <format>
 
 namespace gs::training {
+    std::expected<std::unique_ptr<IStrategy>, std::string> createStrategy(const param::TrainingParameters& params,
+                                                                          const ModelSeed& seed) {
+        // Initialize model directly with point cloud
+        std::expected<SplatData, std::string> splat_result;
+        if (params.init_ply.has_value()) {
+            // I don't like this
+            // PLYLoader is not exposed publicly so I have to use the general Loader class
+            // which might load any format, SOG included
+            auto loader = loader::Loader::create();
+            auto ply_load_result = loader->load(params.init_ply.value());
+
+            if (!ply_load_result) {
+                splat_result = std::unexpected(std::format(
+                    "Failed to load initialization PLY file '{}': {}",
+                    params.init_ply.value(),
+                    ply_load_result.error()));
+            } else {
+                try {
+                    splat_result = std::move(*std::get<std::shared_ptr<SplatData>>(ply_load_result->data));
+                    // A prior model has trained all of its SH bands, a fine-tune refines them from the start
+                    splat_result->set_active_sh_degree(splat_result->get_max_sh_degree());
+                } catch (const std::bad_variant_access&) {
+                    splat_result = std::unexpected(std::format(
+                        "Initialization PLY file '{}' did not contain valid SplatData",
+                        params.init_ply.value()));
+                }
+            }
+        } else if (seed.empty()) {
+            return std::unexpected("No point cloud to initialize the model from");
+        } else {
+            splat_result = SplatData::init_model_from_pointcloud(
+                params,
+                seed.scene_center,
+                *seed.point_cloud);
+        }
+
+        if (!splat_result) {
+            return std::unexpected(
+                std::format("Failed to initialize model: {}", splat_result.error()));
+        }
+
+        std::unique_ptr<IStrategy> strategy;
+        if (params.optimization.strategy == "mcmc") {
+            strategy = std::make_unique<MCMC>(std::move(*splat_result));
+            LOG_DEBUG("Created MCMC strategy");
+        } else if (params.optimization.strategy == "taming") {
+            strategy = std::make_unique<TamingStrategy>(std::move(*splat_result));
+            LOG_DEBUG("Created taming strategy");
+        } else {
+            strategy = std::make_unique<DefaultStrategy>(std::move(*splat_result));
+            LOG_DEBUG("Created default strategy");
+        }
+        return strategy;
+    }
+
     std::expected<TrainingSetup, std::string> setupTraining(const param::TrainingParameters& params) {
         // 1. Create loader
         auto loader = loader::Loader::create();
@@ -23,7 +79,8 @@ namespace gs::training {
             .validate_only = false,
             .progress = [](float percentage, const std::string& message) {
                 LOG_DEBUG("[{:5.1f}%] {}", percentage, message);
-            }};
+            },
+            .undistort = params.dataset.undistort};
 
         // 3. Load the dataset
         LOG_INFO("Loading dataset from: {}", params.dataset.data_path.string());
@@ -45,81 +102,43 @@ namespace gs::training {
             } else if constexpr (std::is_same_v<T, loader::LoadedScene>) {
                 // Full scene data - set up training
 
-                // Initialize model directly with point cloud
-                std::expected<SplatData, std::string> splat_result;
-                if (params.init_ply.has_value()) {
-                    // I don't like this
-                    // PLYLoader is not exposed publicly so I have to use the general Loader class
-                    // which might load any format
-                    auto loader = loader::Loader::create();
-                    auto ply_load_result = loader->load(params.init_ply.value());
-
-                    if (!ply_load_result) {
-                        splat_result = std::unexpected(std::format(
-                            "Failed to load initialization PLY file '{}': {}",
-                            params.init_ply.value(),
-                            ply_load_result.error()));
-                    } else {
-                        try {
-                            splat_result = std::move(*std::get<std::shared_ptr<SplatData>>(ply_load_result->data));
-                        } catch (const std::bad_variant_access&) {
-                            splat_result = std::unexpected(std::format(
-                                "Initialization PLY file '{}' did not contain valid SplatData",
-                                params.init_ply.value()));
-                        }
-                    }
-
-                } else {
-                    // Get point cloud or generate random one
-                    PointCloud point_cloud_to_use;
-                    if (data.point_cloud && data.point_cloud->size() > 0) {
-                        point_cloud_to_use = *data.point_cloud;
-                        LOG_INFO("Using point cloud with {} points", point_cloud_to_use.size());
-                    } else {
-                        // Generate random point cloud if needed
-                        LOG_INFO("No point cloud provided, using random initialization");
-                        // Need to generate random point cloud - this should be provided by the loader or a utility
-                        int numInitGaussian = 10000;
-                        uint64_t seed = 8128;
-                        torch::manual_seed(seed);
-
-                        torch::Tensor positions = torch::rand({numInitGaussian, 3}); // in [0, 1]
-                        positions = positions * 2.0 - 1.0;                           // now in [-1, 1]
-                        torch::Tensor colors =
-                            torch::randint(0, 256, {numInitGaussian, 3}, torch::kUInt8);
-
-                        point_cloud_to_use = PointCloud(positions, colors);
-                    }
-                    splat_result = SplatData::init_model_from_pointcloud(
-                        params,
-                        load_result->scene_center,
-                        point_cloud_to_use);
-                }
-
-                if (!splat_result) {
-                    return std::unexpected(
-                        std::format("Failed to initialize model: {}", splat_result.error()));
+                // Get point cloud or generate random one, an init_ply model needs neither
+                ModelSeed seed{.scene_center = load_result->scene_center};
+                if (data.point_cloud && data.point_cloud->size() > 0) {
+                    seed.point_cloud = data.point_cloud;
+                    LOG_INFO("Using point cloud with {} points", seed.point_cloud->size());
+                } else if (!params.init_ply.has_value()) {
+                    // Generate random point cloud if needed
+                    LOG_INFO("No point cloud provided, using random initialization");
+                    // Need to generate random point cloud - this should be provided by the loader or a utility
+                    int numInitGaussian = 10000;
+                    uint64_t seed_value = 8128;
+                    torch::manual_seed(seed_value);
+
+                    torch::Tensor positions = torch::rand({numInitGaussian, 3}); // in [0, 1]
+                    positions = positions * 2.0 - 1.0;                           // now in [-1, 1]
+                    torch::Tensor colors =
+                        torch::randint(0, 256, {numInitGaussian, 3}, torch::kUInt8);
+
+                    seed.point_cloud = std::make_shared<const PointCloud>(positions, colors);
                 }
 
                 // 5. Create strategy
-                std::unique_ptr<IStrategy> strategy;
-                if (params.optimization.strategy == "mcmc") {
-                    strategy = std::make_unique<MCMC>(std::move(*splat_result));
-                    LOG_DEBUG("Created MCMC strategy");
-                } else {
-                    strategy = std::make_unique<DefaultStrategy>(std::move(*splat_result));
-                    LOG_DEBUG("Created default strategy");
+                auto strategy = createStrategy(params, seed);
+                if (!strategy) {
+                    return std::unexpected(strategy.error());
                 }
 
                 // Create trainer (without parameters)
                 auto trainer = std::make_unique<Trainer>(
                     data.cameras,
-                    std::move(strategy));
+                    std::move(*strategy));
 
                 return TrainingSetup{
                     .trainer = std::move(trainer),
                     .dataset = data.cameras,
-                    .scene_center = load_result->scene_center};
+                    .scene_center = load_result->scene_center,
+                    .seed = std::move(seed)};
             } else {
                 return std::unexpected("Unknown data type returned from loader");
             }
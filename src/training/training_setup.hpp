@@ -4,18 +4,32 @@
 
 #pragma once
 
+#include "core/point_cloud.hpp"
 #include "dataset.hpp"
 #include "trainer.hpp"
 #include <expected>
 #include <memory>
 
 namespace gs::training {
+    // What the initial model is built from, kept so a reset doesn't have to load the dataset again
+    struct ModelSeed {
+        std::shared_ptr<const PointCloud> point_cloud; // Dataset or random points, unused with init_ply
+        torch::Tensor scene_center;
+
+        bool empty() const { return !point_cloud; }
+    };
+
     struct TrainingSetup {
         std::unique_ptr<Trainer> trainer;
         std::shared_ptr<CameraDataset> dataset;
         torch::Tensor scene_center;
+        ModelSeed seed;
     };
 
     // Reusable function to set up training from parameters
     std::expected<TrainingSetup, std::string> setupTraining(const param::TrainingParameters& params);
+
+    // Initial model of params.optimization.strategy, from init_ply when set and the seed's points otherwise
+    std::expected<std::unique_ptr<IStrategy>, std::string> createStrategy(const param::TrainingParameters& params,
+                                                                          const ModelSeed& seed);
 } // namespace gs::training
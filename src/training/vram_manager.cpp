@@ -0,0 +1,141 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "vram_manager.hpp"
+#include "core/logger.hpp"
+#include <algorithm>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAFunctions.h>
+#include <cuda_runtime.h>
+#include <torch/torch.h>
+
+namespace gs::training {
+
+    namespace {
+        constexpr double MB = 1024.0 * 1024.0;
+        constexpr int DEVICE_SAMPLE_EVERY = 10;            // cudaMemGetInfo is a driver call, the allocator stats are not
+        constexpr size_t MIN_RESERVATION = 32ull << 20;    // Smaller growth is left to the allocator
+        constexpr size_t AGGREGATE = static_cast<size_t>(c10::CachingAllocator::StatType::AGGREGATE);
+    } // namespace
+
+    VramManager& VramManager::get() {
+        static VramManager instance;
+        return instance;
+    }
+
+    void VramManager::set_budget_mb(int budget_mb) {
+        budget_mb_ = std::max(0, budget_mb);
+        steps_ = 0;
+        trim_floor_ = 0;
+    }
+
+    size_t VramManager::budget_bytes(size_t device_total) const {
+        return budget_mb_ > 0 ? static_cast<size_t>(budget_mb_) << 20
+                              : static_cast<size_t>(0.9 * static_cast<double>(device_total));
+    }
+
+    void VramManager::begin_refinement(int64_t num_gaussians) {
+        using namespace c10::cuda::CUDACachingAllocator;
+        const int device = c10::cuda::current_device();
+        const auto peak = getDeviceStats(device).allocated_bytes[AGGREGATE].peak;
+        // The peak covers the model, its moments and the render buffers of every view. Most of it
+        // scales with the Gaussian count, so a per-Gaussian cost overestimates growth slightly.
+        if (peak > 0 && num_gaussians > 0) {
+            bytes_per_gaussian_ = static_cast<double>(peak) / static_cast<double>(num_gaussians);
+        }
+        resetPeakStats(device);
+    }
+
+    void VramManager::reserve_growth(int64_t added) {
+        if (added <= 0 || bytes_per_gaussian_ <= 0.0) {
+            return;
+        }
+        const int device = c10::cuda::current_device();
+        const auto stats = c10::cuda::CUDACachingAllocator::getDeviceStats(device);
+        const auto allocated = static_cast<size_t>(stats.allocated_bytes[AGGREGATE].current);
+        const auto reserved = static_cast<size_t>(stats.reserved_bytes[AGGREGATE].current);
+
+        const auto needed = static_cast<size_t>(bytes_per_gaussian_ * static_cast<double>(added));
+        const size_t cached = reserved - std::min(reserved, allocated);
+        if (needed <= cached + MIN_RESERVATION) {
+            return;
+        }
+
+        size_t free_bytes = 0;
+        size_t total_bytes = 0;
+        if (cudaMemGetInfo(&free_bytes, &total_bytes) != cudaSuccess) {
+            return;
+        }
+        const size_t budget = budget_bytes(total_bytes);
+        const size_t room = std::min(budget - std::min(budget, reserved), free_bytes);
+        const size_t extra = std::min(needed - cached, room);
+        if (extra < MIN_RESERVATION) {
+            return;
+        }
+
+        // Freed at once, the block stays in the pool and is split for the growing tensors
+        try {
+            torch::empty({static_cast<int64_t>(extra)}, torch::TensorOptions().dtype(torch::kUInt8).device(torch::kCUDA, device));
+            LOG_DEBUG("Reserved {:.0f} MB ahead of {} new Gaussians", extra / MB, added);
+        } catch (const c10::OutOfMemoryError&) {
+            LOG_DEBUG("Could not reserve {:.0f} MB ahead of densification", extra / MB);
+        }
+    }
+
+    void VramManager::relieve() {
+        const int device = c10::cuda::current_device();
+        const auto stats = c10::cuda::CUDACachingAllocator::getDeviceStats(device);
+        const auto reserved = static_cast<size_t>(stats.reserved_bytes[AGGREGATE].current);
+        allocated_bytes_.store(static_cast<size_t>(stats.allocated_bytes[AGGREGATE].current), std::memory_order_relaxed);
+        reserved_bytes_.store(reserved, std::memory_order_relaxed);
+        inactive_split_bytes_.store(static_cast<size_t>(stats.inactive_split_bytes[AGGREGATE].current), std::memory_order_relaxed);
+        alloc_retries_.store(static_cast<uint64_t>(stats.num_alloc_retries), std::memory_order_relaxed);
+
+        if (steps_++ % DEVICE_SAMPLE_EVERY == 0) {
+            size_t free_bytes = 0;
+            size_t total_bytes = 0;
+            if (cudaMemGetInfo(&free_bytes, &total_bytes) == cudaSuccess) {
+                device_used_bytes_.store(total_bytes - free_bytes, std::memory_order_relaxed);
+                device_total_bytes_.store(total_bytes, std::memory_order_relaxed);
+                budget_.store(budget_bytes(total_bytes), std::memory_order_relaxed);
+            }
+        }
+
+        // A model that alone exceeds the budget would trim every step, after a trim the pool has to
+        // grow by a tenth of the budget again first
+        const size_t budget = budget_.load(std::memory_order_relaxed);
+        if (budget > 0 && reserved > std::max(budget, trim_floor_ + budget / 10)) {
+            trim("reserved memory over budget");
+        }
+    }
+
+    void VramManager::release_cached() {
+        trim("trainer released");
+        trim_floor_ = 0;
+        cudaDeviceSynchronize();
+    }
+
+    void VramManager::trim(const char* reason) {
+        const size_t before = reserved_bytes_.load(std::memory_order_relaxed);
+        c10::cuda::CUDACachingAllocator::emptyCache();
+        const auto stats = c10::cuda::CUDACachingAllocator::getDeviceStats(c10::cuda::current_device());
+        const auto after = static_cast<size_t>(stats.reserved_bytes[AGGREGATE].current);
+        reserved_bytes_.store(after, std::memory_order_relaxed);
+        trim_floor_ = after;
+        trims_.fetch_add(1, std::memory_order_relaxed);
+        LOG_DEBUG("Trimmed the CUDA cache ({}): {:.0f} -> {:.0f} MB reserved", reason, before / MB, after / MB);
+    }
+
+    VramManager::Stats VramManager::stats() const {
+        return {.allocated_bytes = allocated_bytes_.load(std::memory_order_relaxed),
+                .reserved_bytes = reserved_bytes_.load(std::memory_order_relaxed),
+                .device_used_bytes = device_used_bytes_.load(std::memory_order_relaxed),
+                .device_total_bytes = device_total_bytes_.load(std::memory_order_relaxed),
+                .budget_bytes = budget_.load(std::memory_order_relaxed),
+                .inactive_split_bytes = inactive_split_bytes_.load(std::memory_order_relaxed),
+                .alloc_retries = alloc_retries_.load(std::memory_order_relaxed),
+                .trims = trims_.load(std::memory_order_relaxed)};
+    }
+
+} // namespace gs::training
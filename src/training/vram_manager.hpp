@@ -0,0 +1,74 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace gs::training {
+
+    // Pressure on the CUDA caching allocator during training. Cached blocks are released only while
+    // the reserved pool exceeds the budget, rather than unconditionally at refinement points, since
+    // emptyCache synchronizes the device. Before densification the pool is grown once to hold the
+    // new Gaussians, so the growth is carved from one reservation instead of many cudaMallocs.
+    class VramManager {
+    public:
+        struct Stats {
+            size_t allocated_bytes = 0;
+            size_t reserved_bytes = 0;
+            size_t device_used_bytes = 0; // Other processes included
+            size_t device_total_bytes = 0;
+            size_t budget_bytes = 0;
+            size_t inactive_split_bytes = 0; // Free space stranded inside split cached blocks
+            uint64_t alloc_retries = 0;      // cudaMalloc failures that flushed the cache and retried
+            uint64_t trims = 0;
+        };
+
+        static VramManager& get();
+
+        // Reserved bytes allowed before the cache is trimmed, 0: 90% of the device memory
+        void set_budget_mb(int budget_mb);
+
+        // At a refinement point, before the model changes. Measures the allocation peak per
+        // Gaussian since the previous refinement and restarts the peak.
+        void begin_refinement(int64_t num_gaussians);
+        double bytes_per_gaussian() const { return bytes_per_gaussian_; }
+
+        // Grows the cached pool to fit added more Gaussians at the measured cost, within the budget
+        void reserve_growth(int64_t added);
+
+        // Once per step, outside of any kernel sequence. Refreshes the stats and trims the cache
+        // while the reserved pool exceeds the budget.
+        void relieve();
+
+        // Returns every cached block to the device, after the trainer is torn down
+        void release_cached();
+
+        // Safe from any thread, as of the last relieve
+        Stats stats() const;
+
+    private:
+        VramManager() = default;
+
+        size_t budget_bytes(size_t device_total) const;
+        void trim(const char* reason);
+
+        int budget_mb_ = 0;
+        double bytes_per_gaussian_ = 0.0;
+        int steps_ = 0;
+        size_t trim_floor_ = 0; // Reserved bytes left by the last trim
+
+        std::atomic<size_t> allocated_bytes_{0};
+        std::atomic<size_t> reserved_bytes_{0};
+        std::atomic<size_t> device_used_bytes_{0};
+        std::atomic<size_t> device_total_bytes_{0};
+        std::atomic<size_t> budget_{0};
+        std::atomic<size_t> inactive_split_bytes_{0};
+        std::atomic<uint64_t> alloc_retries_{0};
+        std::atomic<uint64_t> trims_{0};
+    };
+
+} // namespace gs::training
@@ -31,14 +31,14 @@ namespace gs::visualizer {
             loadDataset(path);
         } else {
             scene_manager_->changeContentType(SceneManager::ContentType::SplatFiles);
-            // Determine file type and load appropriately
+            // Files dropped together arrive as one command each, they still load concurrently
             if (isSOGFile(path) || isPLYFile(path)) {
                 std::string ply_name = path.stem().string();
-                scene_manager_->addSplatFile(path, ply_name);
+                scene_manager_->addSplatFiles({{.path = path, .name = ply_name}});
                 scene_manager_->getProject()->addPly(true, path, -1, ply_name);
             } else {
                 // Let scene manager determine the type
-                scene_manager_->addSplatFile(path);
+                scene_manager_->addSplatFiles({{.path = path}});
             }
         }
     }
@@ -232,6 +232,29 @@ namespace gs::visualizer {
         }
     }
 
+    std::expected<void, std::string> DataLoadingService::loadDatasetAsync(const std::filesystem::path& path) {
+        if (params_.dataset.data_path.empty() && path.empty()) {
+            LOG_ERROR("No dataset path specified");
+            return std::unexpected("No dataset path specified");
+        }
+
+        try {
+            scene_manager_->loadDatasetAsync(path, params_);
+            return {};
+        } catch (const std::exception& e) {
+            std::string error_msg = std::format("Failed to load dataset: {}", e.what());
+            LOG_ERROR("{} (Path: {})", error_msg, path.string());
+            return std::unexpected(error_msg);
+        }
+    }
+
+    void DataLoadingService::loadSplatFileAsync(const std::filesystem::path& path) {
+        LOG_INFO("Loading splat file in the background: {}", path.string());
+        scene_manager_->clear();
+        scene_manager_->changeContentType(SceneManager::ContentType::SplatFiles);
+        scene_manager_->addSplatFiles({{.path = path, .name = path.stem().string()}});
+    }
+
     void DataLoadingService::clearScene() {
         try {
             LOG_DEBUG("Clearing scene");
@@ -30,6 +30,10 @@ namespace gs::visualizer {
         std::expected<void, std::string> loadSOG(const std::filesystem::path& path);
         std::expected<void, std::string> loadSplatFile(const std::filesystem::path& path);
         std::expected<void, std::string> loadDataset(const std::filesystem::path& path);
+        // Starts the dataset loading in the background, failures arrive as DatasetLoadCompleted
+        std::expected<void, std::string> loadDatasetAsync(const std::filesystem::path& path);
+        // Queues a splat file on the background loader, it joins the scene from pollLoads
+        void loadSplatFileAsync(const std::filesystem::path& path);
         void clearScene();
 
     private:
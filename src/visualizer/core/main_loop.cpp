@@ -4,6 +4,7 @@
 
 #include "main_loop.hpp"
 #include "core/logger.hpp"
+#include "core/trace_recorder.hpp"
 
 namespace gs::visualizer {
 
@@ -18,6 +19,7 @@ namespace gs::visualizer {
         }
 
         LOG_DEBUG("Entering main render loop");
+        core::TraceRecorder::get().set_thread_name("gui");
 
         // Continue running while:
         // - Either we don't have a should_close callback (run forever)
@@ -29,10 +31,12 @@ namespace gs::visualizer {
             }
 
             if (update_callback_) {
+                TRACE_SPAN("gui update");
                 update_callback_();
             }
 
             if (render_callback_) {
+                TRACE_SPAN("gui render");
                 render_callback_();
             }
         }
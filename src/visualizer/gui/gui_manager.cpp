@@ -45,6 +45,8 @@ namespace gs::gui {
         window_states_["show_save_browser"] = false;
         window_states_["system_console"] = false;
         window_states_["training_tab"] = false;
+        window_states_["top_view"] = false;
+        window_states_["camera_view"] = false;
 
         // Initialize speed overlay state
         speed_overlay_visible_ = false;
@@ -296,6 +298,8 @@ namespace gs::gui {
                 panels::DrawRenderingSettings(ctx);
                 ImGui::Separator();
                 panels::DrawToolsPanel(ctx);
+                ImGui::Separator();
+                panels::DrawWindowControls(ctx);
                 panels::DrawSystemConsoleButton(ctx);
             }
             ImGui::End();
@@ -326,6 +330,8 @@ namespace gs::gui {
             scene_panel_->render(&window_states_["scene_panel"]);
         }
 
+        renderAuxiliaryViews();
+
         // Render floating windows (these remain movable)
         if (window_states_["file_browser"]) {
             file_browser_->render(&window_states_["file_browser"]);
@@ -596,6 +602,44 @@ namespace gs::gui {
                 rel_y < viewport_pos_.y + viewport_size_.y);
     }
 
+    void GuiManager::renderAuxiliaryViews() {
+        auto* rendering_manager = viewer_->getRenderingManager();
+        if (!rendering_manager) {
+            return;
+        }
+
+        using visualizer::AuxiliaryView;
+        constexpr struct {
+            const char* title;
+            const char* state;
+            AuxiliaryView view;
+        } views[] = {
+            {"Top View", "top_view", AuxiliaryView::Top},
+            {"Camera View", "camera_view", AuxiliaryView::Camera},
+        };
+
+        for (const auto& [title, state, view] : views) {
+            if (!window_states_[state]) {
+                continue;
+            }
+            ImGui::SetNextWindowSize(ImVec2(320.0f, 240.0f), ImGuiCond_FirstUseEver);
+            if (ImGui::Begin(title, &window_states_[state])) {
+                const ImVec2 avail = ImGui::GetContentRegionAvail();
+                const bool active = ImGui::IsWindowHovered() || ImGui::IsWindowFocused();
+                const unsigned int texture = rendering_manager->requestAuxiliaryView(
+                    view, glm::ivec2(static_cast<int>(avail.x), static_cast<int>(avail.y)), active);
+                if (texture != 0) {
+                    // The texture is a GL render target, its first row is the bottom one
+                    ImGui::Image((ImTextureID)(uintptr_t)texture, avail, ImVec2(0, 1), ImVec2(1, 0));
+                } else if (view == AuxiliaryView::Camera &&
+                           rendering_manager->getCurrentCameraId() < 0) {
+                    ImGui::TextDisabled("Select a training camera");
+                }
+            }
+            ImGui::End();
+        }
+    }
+
     void GuiManager::renderSpeedOverlay() {
         // Check if overlay should be hidden
         if (speed_overlay_visible_) {
@@ -92,6 +92,7 @@ namespace gs {
 
             // Method declarations
             void renderSpeedOverlay();
+            void renderAuxiliaryViews();
             void showSpeedOverlay(float current_speed, float max_speed);
 
             std::unique_ptr<SaveProjectBrowser> save_project_browser_;
@@ -20,6 +20,9 @@ namespace gs::gui::panels {
 
         ImGui::Text("Windows");
         ImGui::Checkbox("Scene Panel", &(*ctx.window_states)["scene_panel"]);
+        ImGui::Checkbox("Top View", &(*ctx.window_states)["top_view"]);
+        ImGui::SameLine();
+        ImGui::Checkbox("Camera View", &(*ctx.window_states)["camera_view"]);
     }
 
     void DrawSystemConsoleButton(const UIContext& ctx) {
@@ -88,6 +91,85 @@ namespace gs::gui::panels {
             }
         }
 
+        // SH level of detail
+        if (ImGui::Checkbox("SH Level of Detail", &settings.sh_lod)) {
+            settings_changed = true;
+        }
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Small splats skip the higher SH bands");
+        }
+
+        if (settings.sh_lod) {
+            ImGui::Indent();
+            if (widgets::SliderWithReset("Degree 0 Below (px)", &settings.sh_lod_pixels, 0.5f, 16.0f, 2.0f)) {
+                settings_changed = true;
+            }
+            ImGui::Unindent();
+        }
+
+        // Occlusion culling
+        if (ImGui::Checkbox("Occlusion Culling", &settings.occlusion_culling)) {
+            settings_changed = true;
+        }
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Skip splats hidden behind what the last frame rendered opaque");
+        }
+
+        // Half precision blending
+        if (ImGui::Checkbox("Half Precision", &settings.half_precision)) {
+            settings_changed = true;
+        }
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Blend splats from 16-bit attributes, faster on large scenes at slightly lower quality");
+        }
+
+        // Rasterizer workload heatmap
+        const char* heatmaps[] = {"Off", "Instances per Tile", "Contributors per Pixel"};
+        int current_heatmap = static_cast<int>(settings.workload_heatmap);
+        if (ImGui::Combo("Workload Heatmap", &current_heatmap, heatmaps, IM_ARRAYSIZE(heatmaps))) {
+            settings.workload_heatmap = static_cast<gs::rendering::WorkloadHeatmap>(current_heatmap);
+            settings_changed = true;
+        }
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Where the blend spends its time, from a training forward of the view");
+        }
+
+        if (settings.workload_heatmap != gs::rendering::WorkloadHeatmap::Off) {
+            if (const auto report = render_manager->getWorkloadReport()) {
+                ImGui::Indent();
+                ImGui::Text("%dx%d tiles of %dx%d px, %.1f instances/tile, %d max contributors/px",
+                            report->grid_size.x, report->grid_size.y, report->tile_size.x, report->tile_size.y,
+                            report->mean_instances, report->max_contributors);
+                for (const auto& tile : report->worst_tiles) {
+                    ImGui::Text("Tile (%d, %d) at px (%d, %d): %d instances, %d max contributors",
+                                tile.tile.x, tile.tile.y, tile.pixels.x, tile.pixels.y,
+                                tile.instances, tile.max_contributors);
+                }
+                ImGui::Unindent();
+            }
+        }
+
+        // Foveated rendering
+        if (ImGui::Checkbox("Foveated Rendering", &settings.foveated)) {
+            settings_changed = true;
+        }
+
+        if (settings.foveated) {
+            ImGui::Indent();
+            if (ImGui::SliderFloat2("Gaze", &settings.fovea_center.x, 0.0f, 1.0f)) {
+                settings_changed = true;
+            }
+            if (ImGui::SliderFloat("Inner Radius", &settings.fovea_inner_radius, 0.0f, 1.0f)) {
+                settings.fovea_outer_radius = std::max(settings.fovea_outer_radius, settings.fovea_inner_radius);
+                settings_changed = true;
+            }
+            if (ImGui::SliderFloat("Outer Radius", &settings.fovea_outer_radius, 0.0f, 1.5f)) {
+                settings.fovea_inner_radius = std::min(settings.fovea_inner_radius, settings.fovea_outer_radius);
+                settings_changed = true;
+            }
+            ImGui::Unindent();
+        }
+
         // Background Color
         ImGui::Separator();
         ImGui::Text("Background");
@@ -7,6 +7,7 @@
 #include "core/logger.hpp"
 #include "gui/ui_widgets.hpp"
 #include "gui/utils/windows_utils.hpp"
+#include "training/vram_manager.hpp"
 #include "visualizer_impl.hpp"
 
 #include <chrono>
@@ -142,7 +143,7 @@ namespace gs::gui::panels {
                 ImGui::Text("%zu", opt_params.iterations);
             }
 
-            if (opt_params.strategy == "mcmc") {
+            if (opt_params.strategy == "mcmc" || opt_params.strategy == "taming") {
                 ImGui::TableNextRow();
                 ImGui::TableNextColumn();
                 ImGui::Text("Max Gaussians:");
@@ -848,6 +849,42 @@ namespace gs::gui::panels {
         }
 
         ImGui::TextColored(memColor, "Used GPU Memory: %.1f%% (%.1f/%.1f GB)", pctUsed, used_t / 1e9f, total_t / 1e9f);
+
+        // Caching allocator pool of the training thread, as of its last step
+        const auto vram = gs::training::VramManager::get().stats();
+        if (vram.budget_bytes > 0) {
+            ImGui::Text("Allocated/Reserved: %.1f/%.1f GB (budget %.1f GB, %llu trims)",
+                        vram.allocated_bytes / 1e9f, vram.reserved_bytes / 1e9f, vram.budget_bytes / 1e9f,
+                        static_cast<unsigned long long>(vram.trims));
+            ImGui::Text("Fragmented: %.2f GB (%llu alloc retries)", vram.inactive_split_bytes / 1e9f,
+                        static_cast<unsigned long long>(vram.alloc_retries));
+        }
+
+        if (ImGui::CollapsingHeader("Performance")) {
+            const auto perf = trainer_manager->getPerfStats();
+            if (perf.iteration == 0) {
+                ImGui::TextDisabled("Waiting for the first steps...");
+                return;
+            }
+            ImGui::Text("%.1f iters/sec, %.1f ms/iter", iters_per_sec, iters_per_sec > 0.f ? 1000.f / iters_per_sec : 0.f);
+
+            // Mean zone times of the last report window, the dataloader wait is measured separately
+            ImGui::Text("load: %.2f ms", perf.load_wait_ms);
+            for (const auto& zone : perf.zones) {
+                ImGui::Text("%*s%s: %.2f ms", zone.depth * 2, "", zone.name, zone.ms);
+            }
+            if (perf.queue_capacity > 0) {
+                ImGui::Text("Dataloader queue: %.1f/%zu", perf.queue_depth_avg, perf.queue_capacity);
+            }
+
+            ImGui::Separator();
+            ImGui::Text("VRAM params: %.2f GB", perf.param_bytes / 1e9f);
+            ImGui::Text("VRAM optimizer: %.2f GB", perf.optimizer_bytes / 1e9f);
+            ImGui::Text("VRAM rasterizer: %.2f GB", perf.raster_bytes / 1e9f);
+            if (perf.image_bytes > 0) {
+                ImGui::Text("VRAM images: %.2f GB", perf.image_bytes / 1e9f);
+            }
+        }
     }
 
 } // namespace gs::gui::panels
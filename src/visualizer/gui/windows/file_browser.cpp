@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "gui/windows/file_browser.hpp"
+#include "core/splat_lod.hpp"
 #include "loader/loader.hpp"
 #include "project/project.hpp"
 #include <algorithm>
@@ -71,7 +72,8 @@ namespace gs::gui {
                         std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
 
                         // Add .sog to the list of supported file extensions
-                        if (ext == ".ply" || ext == ".sog" || ext == ".json" || ext == Project::EXTENSION ||
+                        if (ext == ".ply" || ext == ".sog" || ext == gs::core::SPLAT_LOD_EXTENSION || ext == ".json" ||
+                            ext == Project::EXTENSION ||
                             entry.path().filename() == "cameras.bin" ||
                             entry.path().filename() == "cameras.txt" ||
                             entry.path().filename() == "images.bin" ||
@@ -268,6 +270,15 @@ namespace gs::gui {
                         }
                     }
                     ImGui::PopStyleColor();
+                } else if (ext == gs::core::SPLAT_LOD_EXTENSION) {
+                    ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.6f, 0.2f, 1.0f));
+                    if (ImGui::Button("Stream LOD", ImVec2(120, 0))) {
+                        if (on_file_selected_) {
+                            on_file_selected_(selected_path, false);
+                            *p_open = false;
+                        }
+                    }
+                    ImGui::PopStyleColor();
                 } else if (ext == ".sog") {
                     ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.8f, 0.5f, 0.1f, 1.0f)); // Orange button
                     if (ImGui::Button("Load SOG", ImVec2(120, 0))) {
@@ -6,13 +6,14 @@
 #include "core/events.hpp"
 #include "core/image_io.hpp"
 #include "core/logger.hpp"
+#include <ATen/cuda/CUDAContext.h>
 #include <algorithm>
+#include <c10/cuda/CUDAGuard.h>
 #include <format>
 #include <future>
 #include <glad/glad.h>
 #include <imgui.h>
 #include <stdexcept>
-#include <thread>
 
 namespace gs::gui {
 
@@ -57,13 +58,13 @@ namespace gs::gui {
                   image_paths.size(), current_index_);
 
         // Load current image
-        if (!loadImage(image_paths_[current_index_])) {
+        if (!loadImage(current_index_)) {
             LOG_ERROR("Failed to load initial image: {}", load_error_);
             throw std::runtime_error(std::format("Failed to load image: {}", load_error_));
         }
 
         // Start preloading adjacent images
-        preloadAdjacentImages();
+        requestImages();
 
         LOG_INFO("Opened image {}/{}: {}",
                  current_index_ + 1,
@@ -79,27 +80,30 @@ namespace gs::gui {
         is_open_ = false;
         image_paths_.clear();
         current_texture_.reset();
-        prev_texture_.reset();
-        next_texture_.reset();
+        texture_lru_.clear();
+        texture_cache_bytes_ = 0;
 
-        // Clear preload results
+        // Queued decodes are dropped, the ones running finish into a stale generation
         {
-            std::lock_guard<std::mutex> lock(preload_mutex_);
-            prev_result_.reset();
-            next_result_.reset();
+            std::lock_guard<std::mutex> lock(decode_mutex_);
+            decode_queue_.clear();
+            decoded_.clear();
+            in_flight_.clear();
+            ++generation_;
         }
 
+        is_loading_ = false;
         load_error_.clear();
         LOG_DEBUG("Image preview closed");
     }
 
-    std::unique_ptr<ImageData> ImagePreview::loadImageData(const std::filesystem::path& path) {
+    std::unique_ptr<ImageData> ImagePreview::loadImageData(const std::filesystem::path& path, int max_size) {
         LOG_TIMER_TRACE("LoadImageData");
 
         LOG_TRACE("Loading image data from: {}", path.string());
 
-        // Load image
-        auto [data, width, height, channels] = ::load_image(path);
+        // Load image, resized to fit a texture in the same pass
+        auto [data, width, height, channels] = ::load_image(path, -1, std::min(3840, max_size));
 
         // Wrap in RAII immediately
         auto image_data = std::make_unique<ImageData>(data, width, height, channels);
@@ -125,7 +129,7 @@ namespace gs::gui {
     }
 
     std::unique_ptr<ImagePreview::ImageTexture> ImagePreview::createTexture(
-        ImageData&& data, const std::filesystem::path& path) {
+        ImageData&& data, const std::filesystem::path& path, const visualizer::CompressedTexture* compressed) {
         LOG_TIMER_TRACE("CreateTexture");
 
         ensureMaxTextureSizeInitialized();
@@ -134,35 +138,17 @@ namespace gs::gui {
         int height = data.height();
         int channels = data.channels();
 
-        // Check if we need to downscale
+        // loadImageData already fit the image to the texture limit
         if (width > max_texture_size_ || height > max_texture_size_) {
-            // Calculate scale factor
-            int scale_factor = 1;
-            while (width / scale_factor > max_texture_size_ ||
-                   height / scale_factor > max_texture_size_) {
-                scale_factor *= 2;
-            }
-
-            LOG_DEBUG("Image too large ({}x{}), downscaling by factor of {}",
-                      width, height, scale_factor);
-
-            // Reload at lower resolution
-            auto scaled_data = loadImageData(path);
-            if (!scaled_data) {
-                LOG_ERROR("Failed to reload image at lower resolution");
-                throw std::runtime_error("Failed to reload image at lower resolution");
-            }
-
-            // Move the scaled data
-            data = std::move(*scaled_data);
-            width = data.width();
-            height = data.height();
-            channels = data.channels();
+            LOG_ERROR("Image {}x{} exceeds the max texture size: {}", width, height, path.string());
+            throw std::runtime_error(std::format("Image too large for a texture: {}x{}", width, height));
         }
 
         auto texture = std::make_unique<ImageTexture>();
         texture->width = width;
         texture->height = height;
+        texture->bytes = compressed ? compressed->bytes()
+                                    : static_cast<size_t>(width) * height * (channels == 3 ? 4 : channels); // RGB8 pads to 4
         texture->path = path;
 
         // Clear any existing OpenGL errors
@@ -209,9 +195,13 @@ namespace gs::gui {
 
         LOG_TRACE("Creating {}x{} texture with {} channels", width, height, channels);
 
-        // Upload texture
-        glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0,
-                     format, GL_UNSIGNED_BYTE, data.data());
+        // Upload texture, grayscale BC7 blocks hold the value in R like GL_R8 does
+        if (compressed) {
+            visualizer::uploadCompressedTexture(texture->texture.id(), *compressed);
+        } else {
+            glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0,
+                         format, GL_UNSIGNED_BYTE, data.data());
+        }
 
         // Check for errors
         GLenum error = glGetError();
@@ -240,18 +230,20 @@ namespace gs::gui {
         return texture;
     }
 
-    bool ImagePreview::loadImage(const std::filesystem::path& path) {
+    bool ImagePreview::loadImage(size_t index) {
+        const auto& path = image_paths_[index];
         try {
-            is_loading_ = true;
             load_error_.clear();
+            ensureMaxTextureSizeInitialized();
 
             LOG_DEBUG("Loading image: {}", path.string());
 
             // Load image data with RAII
-            auto image_data = loadImageData(path);
+            auto image_data = loadImageData(path, max_texture_size_);
 
             // Create texture from data
             current_texture_ = createTexture(std::move(*image_data), path);
+            insertCached(index, current_texture_);
 
             is_loading_ = false;
             return true;
@@ -264,228 +256,222 @@ namespace gs::gui {
         }
     }
 
-    void ImagePreview::preloadAdjacentImages() {
-        LOG_TIMER_TRACE("PreloadAdjacentImages");
+    std::shared_ptr<ImagePreview::ImageTexture> ImagePreview::findCached(size_t index) {
+        auto it = std::find_if(texture_lru_.begin(), texture_lru_.end(),
+                               [index](const auto& entry) { return entry.first == index; });
+        if (it == texture_lru_.end()) {
+            return nullptr;
+        }
+        texture_lru_.splice(texture_lru_.begin(), texture_lru_, it);
+        return it->second;
+    }
 
-        // Don't start new preload if one is already in progress
-        bool expected = false;
-        if (!preload_in_progress_.compare_exchange_strong(expected, true)) {
-            LOG_TRACE("Preload already in progress, skipping");
-            return;
+    void ImagePreview::insertCached(size_t index, std::shared_ptr<ImageTexture> texture) {
+        auto it = std::find_if(texture_lru_.begin(), texture_lru_.end(),
+                               [index](const auto& entry) { return entry.first == index; });
+        if (it != texture_lru_.end()) {
+            texture_cache_bytes_ -= it->second->bytes;
+            texture_lru_.erase(it);
         }
+        texture_cache_bytes_ += texture->bytes;
+        texture_lru_.emplace_front(index, std::move(texture));
 
-        // Clear existing preloaded data
-        {
-            std::lock_guard<std::mutex> lock(preload_mutex_);
-            prev_result_.reset();
-            next_result_.reset();
+        // The newest entry always stays, even alone over the budget
+        while (texture_cache_bytes_ > TEXTURE_CACHE_BYTES && texture_lru_.size() > 1) {
+            texture_cache_bytes_ -= texture_lru_.back().second->bytes;
+            LOG_TRACE("Evicting preview texture {}", texture_lru_.back().second->path.filename().string());
+            texture_lru_.pop_back();
         }
-        prev_texture_.reset();
-        next_texture_.reset();
+    }
 
-        // Ensure we have max texture size for the background threads
-        ensureMaxTextureSizeInitialized();
+    std::vector<size_t> ImagePreview::wantedIndices() const {
+        // The current image first, then the neighbours with the scroll direction leading
+        std::vector<size_t> wanted{current_index_};
+        for (const long offset : {1L, -1L, 2L}) {
+            const long index = static_cast<long>(current_index_) + offset * direction_;
+            if (index >= 0 && index < static_cast<long>(image_paths_.size())) {
+                wanted.push_back(static_cast<size_t>(index));
+            }
+        }
+        return wanted;
+    }
 
-        // Capture needed values
-        GLint max_size = max_texture_size_;
-
-        // Preload previous image
-        if (current_index_ > 0) {
-            LOG_TRACE("Starting preload of previous image (index {})", current_index_ - 1);
-            std::thread([this, prev_idx = current_index_ - 1, max_size]() {
-                try {
-                    auto image_data = loadImageData(image_paths_[prev_idx]);
-
-                    // Check if downscaling is needed
-                    if (image_data->width() > max_size || image_data->height() > max_size) {
-                        int scale = 2;
-                        while (image_data->width() / scale > max_size ||
-                               image_data->height() / scale > max_size) {
-                            scale *= 2;
-                        }
-
-                        LOG_TRACE("Preloaded image needs downscaling by factor of {}", scale);
-                        // Reload at lower resolution
-                        auto [data, w, h, c] = ::load_image(image_paths_[prev_idx], scale);
-                        image_data = std::make_unique<ImageData>(data, w, h, c);
-                    }
+    void ImagePreview::requestImages() {
+        LOG_TIMER_TRACE("RequestImages");
 
-                    auto result = std::make_unique<LoadResult>();
-                    auto preloaded = std::make_unique<PreloadedImage>();
-                    preloaded->data = std::move(*image_data);
-                    preloaded->path = image_paths_[prev_idx];
-                    result->image = std::move(preloaded);
-
-                    std::lock_guard<std::mutex> lock(preload_mutex_);
-                    prev_result_ = std::move(result);
-                    LOG_TRACE("Successfully preloaded previous image");
-                } catch (const std::exception& e) {
-                    auto result = std::make_unique<LoadResult>();
-                    result->error = e.what();
-
-                    std::lock_guard<std::mutex> lock(preload_mutex_);
-                    prev_result_ = std::move(result);
-                    LOG_WARN("Failed to preload previous image: {}", e.what());
-                }
-            }).detach();
-        }
-
-        // Preload next image
-        if (current_index_ + 1 < image_paths_.size()) {
-            LOG_TRACE("Starting preload of next image (index {})", current_index_ + 1);
-            std::thread([this, next_idx = current_index_ + 1, max_size]() {
-                try {
-                    auto image_data = loadImageData(image_paths_[next_idx]);
-
-                    // Check if downscaling is needed
-                    if (image_data->width() > max_size || image_data->height() > max_size) {
-                        int scale = 2;
-                        while (image_data->width() / scale > max_size ||
-                               image_data->height() / scale > max_size) {
-                            scale *= 2;
-                        }
-
-                        LOG_TRACE("Preloaded image needs downscaling by factor of {}", scale);
-                        // Reload at lower resolution
-                        auto [data, w, h, c] = ::load_image(image_paths_[next_idx], scale);
-                        image_data = std::make_unique<ImageData>(data, w, h, c);
-                    }
+        // The workers need the texture limit
+        ensureMaxTextureSizeInitialized();
 
-                    auto result = std::make_unique<LoadResult>();
-                    auto preloaded = std::make_unique<PreloadedImage>();
-                    preloaded->data = std::move(*image_data);
-                    preloaded->path = image_paths_[next_idx];
-                    result->image = std::move(preloaded);
-
-                    std::lock_guard<std::mutex> lock(preload_mutex_);
-                    next_result_ = std::move(result);
-                    LOG_TRACE("Successfully preloaded next image");
-                } catch (const std::exception& e) {
-                    auto result = std::make_unique<LoadResult>();
-                    result->error = e.what();
-
-                    std::lock_guard<std::mutex> lock(preload_mutex_);
-                    next_result_ = std::move(result);
-                    LOG_WARN("Failed to preload next image: {}", e.what());
+        const auto wanted = wantedIndices();
+        std::vector<size_t> missing;
+        for (const size_t index : wanted) {
+            if (!findCached(index)) {
+                missing.push_back(index);
+            }
+        }
+        // findCached moved the wanted textures to the front, the current one first
+        if (auto current = findCached(current_index_)) {
+            current_texture_ = std::move(current);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(decode_mutex_);
+            // Requests for images scrolled past are dropped before they start
+            decode_queue_.clear();
+            for (const size_t index : missing) {
+                if (!in_flight_.contains(index)) {
+                    decode_queue_.push_back({index, image_paths_[index], generation_, max_texture_size_});
                 }
+            }
+            if (decode_queue_.empty()) {
+                return;
+            }
+        }
 
-                preload_in_progress_ = false;
-            }).detach();
-        } else {
-            preload_in_progress_ = false;
+        if (decode_workers_.empty()) {
+            for (size_t i = 0; i < NUM_DECODE_WORKERS; ++i) {
+                decode_workers_.emplace_back([this](std::stop_token stop) { decodeWorker(stop); });
+            }
         }
+        decode_cv_.notify_all();
     }
 
-    void ImagePreview::checkPreloadedImages() {
-        std::lock_guard<std::mutex> lock(preload_mutex_);
-
-        // Check previous image
-        if (prev_result_ && !prev_texture_) {
-            if (prev_result_->image) {
-                try {
-                    prev_texture_ = createTexture(
-                        std::move(prev_result_->image->data),
-                        prev_result_->image->path);
-                    LOG_TRACE("Created texture for preloaded previous image");
-                } catch (const std::exception& e) {
-                    LOG_WARN("Failed to create prev texture: {}", e.what());
+    void ImagePreview::decodeWorker(std::stop_token stop) {
+        // BC7 encodes of this worker run on their own stream
+        std::optional<at::cuda::CUDAStream> stream;
+
+        while (true) {
+            DecodeRequest request;
+            {
+                std::unique_lock<std::mutex> lock(decode_mutex_);
+                if (!decode_cv_.wait(lock, stop, [this] { return !decode_queue_.empty(); })) {
+                    return;
                 }
+                request = std::move(decode_queue_.front());
+                decode_queue_.pop_front();
+                in_flight_.insert(request.index);
             }
-            prev_result_.reset();
-        }
-
-        // Check next image
-        if (next_result_ && !next_texture_) {
-            if (next_result_->image) {
-                try {
-                    next_texture_ = createTexture(
-                        std::move(next_result_->image->data),
-                        next_result_->image->path);
-                    LOG_TRACE("Created texture for preloaded next image");
-                } catch (const std::exception& e) {
-                    LOG_WARN("Failed to create next texture: {}", e.what());
+
+            DecodeResult result{.index = request.index, .generation = request.generation, .path = request.path};
+            try {
+                result.data = loadImageData(request.path, request.max_size);
+                if (visualizer::textureCompressionEnabled() && result.data->channels() != 2) {
+                    if (!stream) {
+                        stream = at::cuda::getStreamFromPool(false);
+                    }
+                    c10::cuda::CUDAStreamGuard guard(*stream);
+                    const auto& data = *result.data;
+                    const auto pixels = torch::from_blob(data.data(), {data.height(), data.width(), data.channels()}, torch::kUInt8);
+                    result.compressed = visualizer::compressTexture(pixels, /*mipmaps=*/false);
                 }
+            } catch (const std::exception& e) {
+                result.error = e.what();
+            }
+
+            std::lock_guard<std::mutex> lock(decode_mutex_);
+            if (request.generation == generation_) {
+                in_flight_.erase(request.index);
+                decoded_.push_back(std::move(result));
             }
-            next_result_.reset();
         }
     }
 
-    void ImagePreview::nextImage() {
-        if (image_paths_.empty() || current_index_ + 1 >= image_paths_.size()) {
+    void ImagePreview::collectDecoded() {
+        std::vector<DecodeResult> results;
+        uint64_t generation = 0;
+        {
+            std::lock_guard<std::mutex> lock(decode_mutex_);
+            results.swap(decoded_);
+            generation = generation_;
+        }
+        if (results.empty()) {
             return;
         }
 
-        current_index_++;
-
-        // Always reset view when changing images
-        zoom_ = 1.0f;
-        pan_x_ = 0.0f;
-        pan_y_ = 0.0f;
+        const auto wanted = wantedIndices();
+        for (auto& result : results) {
+            const bool is_current = result.index == current_index_;
+            // Scrolled past while decoding, not worth an upload
+            if (result.generation != generation ||
+                std::find(wanted.begin(), wanted.end(), result.index) == wanted.end()) {
+                continue;
+            }
 
-        LOG_DEBUG("Navigating to next image (index {})", current_index_);
+            if (!result.data) {
+                if (is_current) {
+                    load_error_ = result.error;
+                    is_loading_ = false;
+                    LOG_ERROR("Error loading image '{}': {}", result.path.string(), result.error);
+                } else {
+                    LOG_WARN("Failed to preload image '{}': {}", result.path.string(), result.error);
+                }
+                continue;
+            }
 
-        // Use preloaded texture if available
-        if (next_texture_) {
-            current_texture_ = std::move(next_texture_);
-            LOG_TRACE("Using preloaded texture for next image");
-        } else {
-            if (!loadImage(image_paths_[current_index_])) {
-                LOG_ERROR("Failed to load next image: {}", load_error_);
-                // Don't throw here, GUI will display error
+            try {
+                const auto* compressed = result.compressed.blocks.defined() ? &result.compressed : nullptr;
+                std::shared_ptr<ImageTexture> texture = createTexture(std::move(*result.data), result.path, compressed);
+                insertCached(result.index, texture);
+                if (is_current) {
+                    current_texture_ = std::move(texture);
+                    is_loading_ = false;
+                    load_error_.clear();
+                }
+                LOG_TRACE("Created texture for preloaded image {}", result.index);
+            } catch (const std::exception& e) {
+                if (is_current) {
+                    load_error_ = e.what();
+                    is_loading_ = false;
+                }
+                LOG_WARN("Failed to create texture for '{}': {}", result.path.string(), e.what());
             }
         }
-
-        preloadAdjacentImages();
     }
 
-    void ImagePreview::previousImage() {
-        if (image_paths_.empty() || current_index_ == 0) {
-            return;
-        }
-
-        current_index_--;
+    void ImagePreview::showImage(size_t index) {
+        direction_ = index < current_index_ ? -1 : 1;
+        current_index_ = index;
 
         // Always reset view when changing images
         zoom_ = 1.0f;
         pan_x_ = 0.0f;
         pan_y_ = 0.0f;
 
-        LOG_DEBUG("Navigating to previous image (index {})", current_index_);
-
-        // Use preloaded texture if available
-        if (prev_texture_) {
-            current_texture_ = std::move(prev_texture_);
-            LOG_TRACE("Using preloaded texture for previous image");
+        // A cached texture shows right away, otherwise the previous one stays up until the decode lands
+        if (auto cached = findCached(index)) {
+            current_texture_ = std::move(cached);
+            is_loading_ = false;
+            LOG_TRACE("Using cached texture for image {}", index);
         } else {
-            if (!loadImage(image_paths_[current_index_])) {
-                LOG_ERROR("Failed to load previous image: {}", load_error_);
-                // Don't throw here, GUI will display error
-            }
+            is_loading_ = true;
         }
+        load_error_.clear();
 
-        preloadAdjacentImages();
+        requestImages();
     }
 
-    void ImagePreview::goToImage(size_t index) {
-        if (index >= image_paths_.size()) {
+    void ImagePreview::nextImage() {
+        if (image_paths_.empty() || current_index_ + 1 >= image_paths_.size()) {
             return;
         }
+        LOG_DEBUG("Navigating to next image (index {})", current_index_ + 1);
+        showImage(current_index_ + 1);
+    }
 
-        current_index_ = index;
-
-        // Always reset view
-        zoom_ = 1.0f;
-        pan_x_ = 0.0f;
-        pan_y_ = 0.0f;
-
-        LOG_DEBUG("Jumping to image index {}", index);
-
-        if (!loadImage(image_paths_[current_index_])) {
-            LOG_ERROR("Failed to load image at index {}: {}", index, load_error_);
-            // Don't throw here, GUI will display error
+    void ImagePreview::previousImage() {
+        if (image_paths_.empty() || current_index_ == 0) {
+            return;
         }
+        LOG_DEBUG("Navigating to previous image (index {})", current_index_ - 1);
+        showImage(current_index_ - 1);
+    }
 
-        preloadAdjacentImages();
+    void ImagePreview::goToImage(size_t index) {
+        if (index >= image_paths_.size()) {
+            return;
+        }
+        LOG_DEBUG("Jumping to image index {}", index);
+        showImage(index);
     }
 
     std::pair<float, float> ImagePreview::calculateDisplaySize(int window_width, int window_height) const {
@@ -513,8 +499,8 @@ namespace gs::gui {
             return;
         }
 
-        // Check for preloaded images and convert to textures
-        checkPreloadedImages();
+        // Upload decoded images that are still wanted
+        collectDecoded();
 
         // Window setup
         ImGui::SetNextWindowSize(ImVec2(800, 600), ImGuiCond_FirstUseEver);
@@ -576,7 +562,7 @@ namespace gs::gui {
 
         ImVec2 content_size = ImGui::GetContentRegionAvail();
 
-        if (is_loading_) {
+        if (is_loading_ && !current_texture_) {
             ImGui::SetCursorPos(ImVec2(content_size.x * 0.5f - 50, content_size.y * 0.5f));
             ImGui::Text("Loading...");
             ImGui::End();
@@ -602,7 +588,13 @@ namespace gs::gui {
         float x_offset = (content_size.x - display_width) * 0.5f + pan_x_;
         float y_offset = (content_size.y - display_height) * 0.5f + pan_y_;
 
-        ImGui::SetCursorPos(ImVec2(x_offset, y_offset + ImGui::GetCursorPosY()));
+        // The previous image stays up while the current one decodes
+        const float image_top = ImGui::GetCursorPosY();
+        if (is_loading_) {
+            ImGui::TextDisabled("Loading...");
+        }
+
+        ImGui::SetCursorPos(ImVec2(x_offset, y_offset + image_top));
         ImGui::Image(
             (ImTextureID)(uintptr_t)current_texture_->texture.id(),
             ImVec2(display_width, display_height));
@@ -5,13 +5,19 @@
 #pragma once
 
 #include "core/image_io.hpp"
+#include "rendering/compressed_texture.hpp"
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
 #include <glad/glad.h>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 
 // Forward declarations
@@ -141,6 +147,10 @@ namespace gs::gui {
 
     /**
      * @brief Image preview window with navigation support
+     *
+     * The current image and its neighbours in the scroll direction are decoded by a small worker
+     * pool. Navigating replaces the queued requests, so scrubbing never piles up decodes of images
+     * already scrolled past, and uploaded textures stay in an LRU bounded in bytes.
      */
     class ImagePreview {
     public:
@@ -167,56 +177,75 @@ namespace gs::gui {
         size_t getImageCount() const { return image_paths_.size(); }
 
     private:
+        static constexpr size_t NUM_DECODE_WORKERS = 2;
+        static constexpr size_t TEXTURE_CACHE_BYTES = size_t(512) << 20;
+
         // Image texture data
         struct ImageTexture {
             GLTexture texture;
             int width = 0;
             int height = 0;
+            size_t bytes = 0;
             std::filesystem::path path;
         };
 
-        // Preloaded image data
-        struct PreloadedImage {
-            ImageData data;
+        struct DecodeRequest {
+            size_t index = 0;
             std::filesystem::path path;
+            uint64_t generation = 0;
+            int max_size = 0;
         };
 
-        // Thread-safe loading result
-        struct LoadResult {
-            std::unique_ptr<PreloadedImage> image;
+        // A decoded image, or the error, waiting for the GL thread to upload it
+        struct DecodeResult {
+            size_t index = 0;
+            uint64_t generation = 0;
+            std::filesystem::path path;
+            std::unique_ptr<ImageData> data;
+            visualizer::CompressedTexture compressed; // BC7 blocks of data with texture compression
             std::string error;
         };
 
         // Helper methods
         void ensureMaxTextureSizeInitialized();
-        std::unique_ptr<ImageData> loadImageData(const std::filesystem::path& path);
-        std::unique_ptr<ImageTexture> createTexture(ImageData&& data, const std::filesystem::path& path);
-        bool loadImage(const std::filesystem::path& path);
-        void preloadAdjacentImages();
-        void checkPreloadedImages();
+        static std::unique_ptr<ImageData> loadImageData(const std::filesystem::path& path, int max_size);
+        std::unique_ptr<ImageTexture> createTexture(ImageData&& data, const std::filesystem::path& path,
+                                                    const visualizer::CompressedTexture* compressed = nullptr);
+        bool loadImage(size_t index);
+        void showImage(size_t index);
+        std::vector<size_t> wantedIndices() const;
+        void requestImages();
+        void collectDecoded();
+        void decodeWorker(std::stop_token stop);
+        std::shared_ptr<ImageTexture> findCached(size_t index);
+        void insertCached(size_t index, std::shared_ptr<ImageTexture> texture);
         std::pair<float, float> calculateDisplaySize(int window_width, int window_height) const;
 
         // State
         bool is_open_ = false;
         std::vector<std::filesystem::path> image_paths_;
         size_t current_index_ = 0;
+        int direction_ = 1; // Of the last navigation step, the preloads lead that way
 
-        // Current image texture
-        std::unique_ptr<ImageTexture> current_texture_;
+        // Current image texture, kept shown while the next one is decoding
+        std::shared_ptr<ImageTexture> current_texture_;
 
-        // Thread-safe preload results
-        mutable std::mutex preload_mutex_;
-        std::unique_ptr<LoadResult> prev_result_;
-        std::unique_ptr<LoadResult> next_result_;
+        // Uploaded textures by image index, most recently used first. GL thread only.
+        std::list<std::pair<size_t, std::shared_ptr<ImageTexture>>> texture_lru_;
+        size_t texture_cache_bytes_ = 0;
 
-        // Preloaded textures
-        std::unique_ptr<ImageTexture> prev_texture_;
-        std::unique_ptr<ImageTexture> next_texture_;
+        // Decode queue and results, guarded by decode_mutex_. The generation changes with the
+        // image list, results of an older list are dropped.
+        std::mutex decode_mutex_;
+        std::condition_variable_any decode_cv_;
+        std::deque<DecodeRequest> decode_queue_;
+        std::vector<DecodeResult> decoded_;
+        std::unordered_set<size_t> in_flight_;
+        uint64_t generation_ = 0;
 
         // Loading state
-        std::atomic<bool> is_loading_{false};
+        bool is_loading_ = false; // The current image is still decoding
         std::string load_error_;
-        std::atomic<bool> preload_in_progress_{false};
 
         // UI state
         float zoom_ = 1.0f;
@@ -226,6 +255,9 @@ namespace gs::gui {
 
         // OpenGL limits
         GLint max_texture_size_ = 4096;
+
+        // Last, so the workers stop before the state they use goes away
+        std::vector<std::jthread> decode_workers_;
     };
 
 } // namespace gs::gui
@@ -4,6 +4,7 @@
 
 #include "input/input_controller.hpp"
 #include "core/logger.hpp"
+#include "core/splat_lod.hpp"
 #include "rendering/rendering_manager.hpp"
 #include "tools/tool_base.hpp"
 #include "tools/translation_gizmo_tool.hpp"
@@ -669,7 +670,7 @@ namespace gs::visualizer {
             auto ext = filepath.extension().string();
             std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
 
-            if (ext == ".ply" || ext == ".sog") {
+            if (ext == ".ply" || ext == ".sog" || ext == gs::core::SPLAT_LOD_EXTENSION) {
                 splat_files.push_back(filepath);
             } else if (!dataset_path && std::filesystem::is_directory(filepath)) {
                 // Check for dataset markers
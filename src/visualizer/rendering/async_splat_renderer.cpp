@@ -0,0 +1,93 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "async_splat_renderer.hpp"
+#include "core/logger.hpp"
+#include <exception>
+#include <utility>
+
+namespace gs::visualizer {
+
+    AsyncSplatRenderer::AsyncSplatRenderer(gs::rendering::RenderingEngine& engine)
+        : engine_(engine),
+          worker_([this](std::stop_token stop) { workerLoop(stop); }) {
+        LOG_DEBUG("Splat render thread started");
+    }
+
+    AsyncSplatRenderer::~AsyncSplatRenderer() {
+        worker_.request_stop();
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    void AsyncSplatRenderer::submit(Job job) {
+        {
+            std::lock_guard lock(mutex_);
+            job_ = std::move(job);
+        }
+        job_cv_.notify_one();
+    }
+
+    std::optional<AsyncSplatRenderer::Frame> AsyncSplatRenderer::takeCompleted() {
+        std::lock_guard lock(mutex_);
+        if (!completed_) {
+            return std::nullopt;
+        }
+        shown_model_ = std::move(completed_model_);
+        return std::exchange(completed_, std::nullopt);
+    }
+
+    void AsyncSplatRenderer::cancel() {
+        std::lock_guard lock(mutex_);
+        job_.reset();
+        completed_.reset();
+        ++epoch_;
+    }
+
+    void AsyncSplatRenderer::wait() {
+        std::unique_lock lock(mutex_);
+        idle_cv_.wait(lock, [this] { return !running_ && !job_; });
+    }
+
+    bool AsyncSplatRenderer::pending() const {
+        std::lock_guard lock(mutex_);
+        return running_ || job_ || completed_;
+    }
+
+    void AsyncSplatRenderer::workerLoop(std::stop_token stop) {
+        std::unique_lock lock(mutex_);
+        while (job_cv_.wait(lock, stop, [this] { return job_.has_value(); })) {
+            Job job = std::move(*job_);
+            job_.reset();
+            running_ = true;
+            const uint64_t epoch = epoch_;
+            lock.unlock();
+
+            std::optional<Frame> frame;
+            try {
+                if (auto result = engine_.renderGaussians(job.model, job.request)) {
+                    frame = Frame{.result = std::move(*result), .reduced = job.reduced};
+                } else {
+                    LOG_ERROR("Failed to render gaussians: {}", result.error());
+                }
+            } catch (const std::exception& e) {
+                LOG_ERROR("Splat render thread: {}", e.what());
+            }
+
+            lock.lock();
+            running_ = false;
+            if (frame && epoch == epoch_) {
+                completed_ = std::move(frame);
+                completed_model_ = std::move(job.model);
+            }
+            idle_cv_.notify_all();
+        }
+        // A wait() racing the stop returns
+        running_ = false;
+        job_.reset();
+        idle_cv_.notify_all();
+    }
+
+} // namespace gs::visualizer
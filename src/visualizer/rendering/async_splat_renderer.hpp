@@ -0,0 +1,76 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/splat_data.hpp"
+#include "rendering/rendering.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+
+namespace gs::visualizer {
+
+    // Rasterizes the main view on a worker thread, so a slow splat render doesn't hold up the GUI and
+    // heavy panels don't hold up the render. The GUI thread submits what the next frame should show
+    // and keeps presenting the newest completed frame meanwhile. Only CUDA work runs on the worker:
+    // uploads, overlays and point cloud mode stay on the GUI thread with the GL context, which has to
+    // wait() before it rasterizes through the same engine itself.
+    class AsyncSplatRenderer {
+    public:
+        struct Job {
+            SplatData model; // SplatData::share() of the model, outlives whatever the GUI does to it
+            gs::rendering::RenderRequest request;
+            bool reduced = false; // Below the full resolution or SH degree
+        };
+
+        struct Frame {
+            gs::rendering::RenderResult result;
+            bool reduced = false;
+        };
+
+        explicit AsyncSplatRenderer(gs::rendering::RenderingEngine& engine);
+        ~AsyncSplatRenderer();
+
+        AsyncSplatRenderer(const AsyncSplatRenderer&) = delete;
+        AsyncSplatRenderer& operator=(const AsyncSplatRenderer&) = delete;
+
+        // Replaces a job that hasn't started yet, the newest view wins
+        void submit(Job job);
+
+        // The newest frame completed since the last call. Its model stays referenced until the next
+        // frame is taken, the upload of this one is queued after its render on the viewer stream.
+        std::optional<Frame> takeCompleted();
+
+        // Drops the queued job and the frame of the running one, after a model or size switch
+        void cancel();
+
+        // Blocks until the worker is idle
+        void wait();
+
+        // A job queued or running, or a completed frame not taken yet
+        bool pending() const;
+
+    private:
+        void workerLoop(std::stop_token stop);
+
+        gs::rendering::RenderingEngine& engine_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable_any job_cv_;
+        std::condition_variable idle_cv_;
+        std::optional<Job> job_;
+        std::optional<Frame> completed_;
+        SplatData completed_model_;
+        SplatData shown_model_; // Model of the frame takeCompleted() returned last
+        bool running_ = false;
+        uint64_t epoch_ = 0; // Bumped by cancel(), a job of an older epoch completes into nothing
+
+        std::jthread worker_; // Last, it stops and joins before the state above goes away
+    };
+
+} // namespace gs::visualizer
@@ -0,0 +1,98 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "compressed_texture.hpp"
+#include "core/logger.hpp"
+#include "kernels/bc7_encode.cuh"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <glad/glad.h>
+
+namespace gs::visualizer {
+
+    namespace {
+        std::atomic<bool> texture_compression{false};
+    } // namespace
+
+    void setTextureCompression(bool enabled) {
+        if (enabled && !torch::cuda::is_available()) {
+            LOG_WARN("Texture compression needs CUDA, GT images stay uncompressed");
+            enabled = false;
+        }
+        texture_compression = enabled;
+    }
+
+    bool textureCompressionEnabled() {
+        return texture_compression;
+    }
+
+    CompressedTexture compressTexture(const torch::Tensor& pixels, bool mipmaps) {
+        TORCH_CHECK(pixels.dim() == 3 && pixels.scalar_type() == torch::kUInt8, "pixels must be uint8 [H, W, C]");
+
+        CompressedTexture texture;
+        std::vector<torch::Tensor> encoded;
+        auto level = pixels.to(torch::kCUDA).contiguous();
+        size_t offset = 0;
+        for (;;) {
+            const int height = static_cast<int>(level.size(0));
+            const int width = static_cast<int>(level.size(1));
+            encoded.push_back(encode_bc7(level));
+            const auto bytes = static_cast<size_t>(encoded.back().numel());
+            texture.levels.push_back({width, height, offset, bytes});
+            offset += bytes;
+            if (!mipmaps || (width == 1 && height == 1)) {
+                break;
+            }
+
+            // Area filtering averages the texels each smaller one covers, as glGenerateMipmap would
+            auto resized = torch::nn::functional::interpolate(
+                level.permute({2, 0, 1}).unsqueeze(0).to(torch::kFloat32),
+                torch::nn::functional::InterpolateFuncOptions()
+                    .size(std::vector<int64_t>{std::max(1, height / 2), std::max(1, width / 2)})
+                    .mode(torch::kArea));
+            level = resized.squeeze(0).permute({1, 2, 0}).round().clamp(0, 255).to(torch::kUInt8).contiguous();
+        }
+        texture.blocks = torch::cat(encoded).cpu();
+        return texture;
+    }
+
+    void uploadCompressedTexture(unsigned int id, const CompressedTexture& texture, unsigned int pbo) {
+        const auto* blocks = texture.blocks.data_ptr<unsigned char>();
+        const auto total = static_cast<GLsizeiptr>(texture.bytes());
+
+        // With a bound unpack buffer the data pointers below are offsets into it
+        const unsigned char* source = blocks;
+        if (pbo != 0) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, total, nullptr, GL_STREAM_DRAW);
+            if (void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, total,
+                                                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT)) {
+                std::memcpy(mapped, blocks, static_cast<size_t>(total));
+                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+                source = nullptr;
+            } else {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            }
+        }
+
+        glBindTexture(GL_TEXTURE_2D, id);
+        for (size_t i = 0; i < texture.levels.size(); ++i) {
+            const auto& level = texture.levels[i];
+            glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), GL_COMPRESSED_RGBA_BPTC_UNORM,
+                                   level.width, level.height, 0, static_cast<GLsizei>(level.bytes),
+                                   source ? static_cast<const void*>(source + level.offset)
+                                          : reinterpret_cast<const void*>(level.offset));
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(texture.levels.size()) - 1);
+        if (source == nullptr) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+
+        LOG_TRACE("Uploaded BC7 texture {} ({}x{}, {} levels, {} KB)", id, texture.levels.front().width,
+                  texture.levels.front().height, texture.levels.size(), texture.bytes() >> 10);
+    }
+
+} // namespace gs::visualizer
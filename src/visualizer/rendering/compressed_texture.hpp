@@ -0,0 +1,40 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <cstddef>
+#include <torch/torch.h>
+#include <vector>
+
+namespace gs::visualizer {
+
+    // BC7 blocks of an image and its mip chain, levels back to back in one host buffer
+    struct CompressedTexture {
+        struct Level {
+            int width;
+            int height;
+            size_t offset; // Into blocks
+            size_t bytes;
+        };
+        std::vector<Level> levels;
+        torch::Tensor blocks; // uint8 on the host
+
+        size_t bytes() const { return blocks.defined() ? static_cast<size_t>(blocks.numel()) : 0; }
+    };
+
+    // Whether GT images and previews become compressed textures, off unless enabled and CUDA is present
+    void setTextureCompression(bool enabled);
+    bool textureCompressionEnabled();
+
+    // Encodes pixels (uint8 [H, W, C] on the host or the GPU, C in 1..4, rows in upload order) to
+    // BC7 on the current CUDA stream, with a box-filtered mip chain down to 1x1 when mipmaps is set.
+    // Blocks at 1 byte per texel are a quarter of RGBA8, the one download waits for the encode.
+    CompressedTexture compressTexture(const torch::Tensor& pixels, bool mipmaps);
+
+    // Uploads every level of texture into the GL texture id and leaves it bound, staged through pbo
+    // unless it is 0. GL_COMPRESSED_RGBA_BPTC_UNORM is core since GL 4.2. Filtering is left to the caller.
+    void uploadCompressedTexture(unsigned int id, const CompressedTexture& texture, unsigned int pbo = 0);
+
+} // namespace gs::visualizer
@@ -3,6 +3,8 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "framerate_controller.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace gs::visualizer {
 
@@ -74,6 +76,27 @@ namespace gs::visualizer {
         return false;
     }
 
+    float FramerateController::updateRenderScale(bool camera_moving) {
+        if (!settings_.adaptive_resolution || !camera_moving) {
+            render_scale_ = 1.0f;
+            motion_fps_ = 0.0f;
+            return render_scale_;
+        }
+        if (current_fps_ <= 0.0f) {
+            return render_scale_;
+        }
+
+        motion_fps_ = motion_fps_ > 0.0f ? 0.7f * motion_fps_ + 0.3f * current_fps_ : current_fps_;
+        const float ratio = motion_fps_ / settings_.target_fps;
+        // Dead band around the target keeps the resolution from oscillating
+        if (ratio < 0.9f || ratio > 1.2f) {
+            const float target_scale = render_scale_ * std::sqrt(std::clamp(ratio, 0.25f, 4.0f));
+            render_scale_ = 0.5f * (render_scale_ + target_scale);
+        }
+        render_scale_ = std::clamp(render_scale_, settings_.min_render_scale, 1.0f);
+        return render_scale_;
+    }
+
     void FramerateController::cleanupOldFrames() {
         auto now = std::chrono::high_resolution_clock::now();
 
@@ -137,6 +160,8 @@ namespace gs::visualizer {
         average_fps_ = 0.0f;
         is_performance_critical_ = false;
         consecutive_skips_ = 0;
+        render_scale_ = 1.0f;
+        motion_fps_ = 0.0f;
 
         auto now = std::chrono::high_resolution_clock::now();
         frame_start_time_ = now;
@@ -17,6 +17,14 @@ namespace gs::visualizer {
         float time_window_seconds = 5.0f; // Time window to keep frame samples (seconds)
         size_t max_frame_samples = 1000;  // Maximum number of frame samples to keep
         float training_frame_refresh_time_sec = 1;
+        bool adaptive_resolution = true; // Render at reduced resolution while the camera moves below target_fps
+        float min_render_scale = 0.25f;  // Lowest per-axis resolution scale of adaptive_resolution
+        float inactive_view_fps = 2.0f;  // Secondary views the user is not interacting with render at most this often
+        int training_refresh_bands = 4;  // While training with a still camera, refresh the image one horizontal band at a time
+        bool async_render = true;        // Rasterize the main view on its own thread, the GUI presents the newest finished frame
+        bool idle_wait = true;           // With nothing to render, sleep until input instead of redrawing the same frame
+        float idle_fps = 4.0f;           // GUI refresh while idle, picks up background loads and decoded images
+        float idle_training_fps = 10.0f; // Same while training runs, for the progress readouts
     };
 
     class FramerateController {
@@ -41,6 +49,22 @@ namespace gs::visualizer {
         float getAverageFPS() const { return average_fps_; }
         bool isPerformanceCritical() const { return is_performance_critical_; }
 
+        // Per-axis resolution scale of the next scene render. While the camera moves it follows the
+        // frame rate toward target_fps, assuming the frame time scales with the pixel count; once
+        // the camera stops it is back to 1.
+        float updateRenderScale(bool camera_moving);
+        float getRenderScale() const { return render_scale_; }
+
+        // Only the DC band while the resolution cannot drop any further
+        int renderShDegree(int sh_degree) const {
+            return render_scale_ <= settings_.min_render_scale ? 0 : sh_degree;
+        }
+
+        // Minimum time between two renders of a secondary view
+        std::chrono::duration<float> viewRenderInterval(bool active) const {
+            return std::chrono::duration<float>(1.0f / (active ? settings_.target_fps : settings_.inactive_view_fps));
+        }
+
         // Reset state (useful when scene changes significantly)
         void reset();
 
@@ -67,6 +91,10 @@ namespace gs::visualizer {
         float average_fps_ = 0.0f; // average is over time_window_seconds
         bool is_performance_critical_ = false;
 
+        // Adaptive resolution state
+        float render_scale_ = 1.0f;
+        float motion_fps_ = 0.0f; // Smoothed FPS while the camera moves
+
         // Skip logic state
         int consecutive_skips_ = 0;
         // in the worst case - we drop max_consecutive_skips_ of of max_consecutive_skips_+1 frames
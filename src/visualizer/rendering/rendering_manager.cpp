@@ -10,18 +10,39 @@
 #include "rendering/rendering.hpp"
 #include "scene/scene_manager.hpp"
 #include "training/training_manager.hpp"
+#include <ATen/cuda/CUDAContext.h>
+#include <algorithm>
+#include <c10/cuda/CUDAGuard.h>
+#include <cmath>
+#include <cstring>
 #include <glad/glad.h>
 #include <stdexcept>
+#include <utility>
 
 namespace gs::visualizer {
 
     // GTTextureCache Implementation
-    GTTextureCache::GTTextureCache() {
-        LOG_DEBUG("GTTextureCache created");
+    GTTextureCache::GTTextureCache(size_t vram_budget)
+        : vram_budget_(vram_budget) {
+        for (int i = 0; i < NUM_WORKERS; ++i) {
+            workers_.emplace_back([this] { workerLoop(); });
+        }
+        LOG_DEBUG("GTTextureCache created with a {} MB budget", vram_budget_ >> 20);
     }
 
     GTTextureCache::~GTTextureCache() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            stop_ = true;
+        }
+        queue_cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
         clear();
+        if (pbo_ > 0) {
+            glDeleteBuffers(1, &pbo_);
+        }
     }
 
     void GTTextureCache::clear() {
@@ -31,133 +52,248 @@ namespace gs::visualizer {
             }
         }
         texture_cache_.clear();
+        lru_.clear();
+        cached_bytes_ = 0;
+        in_flight_.clear();
+        failed_.clear();
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            jobs_.clear();
+            decoded_.clear();
+            ++generation_;
+        }
         LOG_DEBUG("GTTextureCache cleared");
     }
 
     unsigned int GTTextureCache::getGTTexture(int cam_id, const std::filesystem::path& image_path) {
         // Check if already cached
         if (auto it = texture_cache_.find(cam_id); it != texture_cache_.end()) {
-            it->second.last_access = std::chrono::steady_clock::now();
+            lru_.splice(lru_.begin(), lru_, it->second.lru);
             LOG_TRACE("GT texture cache hit for camera {}", cam_id);
             return it->second.texture_id;
         }
 
-        // Load new texture
-        LOG_DEBUG("Loading GT image for camera {}: {}", cam_id, image_path.string());
-        unsigned int texture_id = loadTexture(image_path);
+        request(cam_id, image_path, /*urgent=*/true);
+        return 0;
+    }
 
-        if (texture_id == 0) {
-            LOG_ERROR("Failed to load GT texture for camera {}", cam_id);
-            return 0;
+    void GTTextureCache::prefetch(int cam_id, const std::filesystem::path& image_path) {
+        if (!texture_cache_.contains(cam_id)) {
+            request(cam_id, image_path, /*urgent=*/false);
         }
+    }
 
-        // Evict oldest if cache is full
-        if (texture_cache_.size() >= MAX_CACHE_SIZE) {
-            evictOldest();
+    void GTTextureCache::request(int cam_id, const std::filesystem::path& image_path, bool urgent) {
+        if (failed_.contains(cam_id)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (in_flight_.contains(cam_id)) {
+            // Still queued as a prefetch: move it ahead of the others
+            if (urgent) {
+                auto it = std::find_if(jobs_.begin(), jobs_.end(), [&](const Job& job) { return job.cam_id == cam_id; });
+                if (it != jobs_.end() && it != jobs_.begin()) {
+                    Job job = std::move(*it);
+                    jobs_.erase(it);
+                    jobs_.push_front(std::move(job));
+                }
+            }
+            return;
         }
 
-        // Add to cache
-        texture_cache_[cam_id] = {texture_id, std::chrono::steady_clock::now()};
-        LOG_DEBUG("Cached GT texture {} for camera {}", texture_id, cam_id);
-
-        return texture_id;
+        in_flight_.insert(cam_id);
+        Job job{cam_id, image_path, generation_};
+        if (urgent) {
+            jobs_.push_front(std::move(job));
+        } else {
+            jobs_.push_back(std::move(job));
+        }
+        queue_cv_.notify_one();
     }
 
-    void GTTextureCache::evictOldest() {
-        if (texture_cache_.empty())
-            return;
+    void GTTextureCache::workerLoop() {
+        // GPU decodes of this worker run on their own stream, only the final pixels are downloaded
+        at::cuda::CUDAStream stream = at::cuda::getStreamFromPool(false);
 
-        auto oldest = texture_cache_.begin();
-        auto oldest_time = oldest->second.last_access;
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex_);
+                queue_cv_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+                if (stop_) {
+                    return;
+                }
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
 
-        for (auto it = texture_cache_.begin(); it != texture_cache_.end(); ++it) {
-            if (it->second.last_access < oldest_time) {
-                oldest = it;
-                oldest_time = it->second.last_access;
+            Decoded decoded{job.cam_id, job.generation, {}, {}};
+            const bool compress = textureCompressionEnabled();
+            try {
+                if (!std::filesystem::exists(job.path)) {
+                    LOG_ERROR("GT image file does not exist: {}", job.path.string());
+                } else if (gpu_image_decode_available()) {
+                    // OpenGL expects the bottom row first, images have it last
+                    c10::cuda::CUDAStreamGuard guard(stream);
+                    auto pixels = load_image_cuda(job.path).flip({1}).permute({1, 2, 0}).contiguous();
+                    if (compress) {
+                        decoded.compressed = compressTexture(pixels, /*mipmaps=*/true);
+                    } else {
+                        decoded.pixels = pixels.cpu();
+                    }
+                } else if (auto [data, width, height, channels] = load_image(job.path); data) {
+                    decoded.pixels = torch::empty({height, width, channels}, torch::kUInt8);
+                    const size_t row_size = static_cast<size_t>(width) * channels;
+                    auto* pixels = decoded.pixels.data_ptr<unsigned char>();
+                    for (int y = 0; y < height; ++y) {
+                        std::memcpy(pixels + y * row_size, data + (height - 1 - y) * row_size, row_size);
+                    }
+                    free_image(data);
+                } else {
+                    LOG_ERROR("Failed to load image data: {}", job.path.string());
+                }
+                if (compress && decoded.pixels.defined()) {
+                    c10::cuda::CUDAStreamGuard guard(stream);
+                    decoded.compressed = compressTexture(decoded.pixels, /*mipmaps=*/true);
+                    decoded.pixels = torch::Tensor();
+                }
+            } catch (const std::exception& e) {
+                LOG_ERROR("Exception loading image {}: {}", job.path.string(), e.what());
+                decoded.pixels = torch::Tensor();
+                decoded.compressed = {};
             }
-        }
 
-        LOG_TRACE("Evicting GT texture for camera {} from cache", oldest->first);
-        glDeleteTextures(1, &oldest->second.texture_id);
-        texture_cache_.erase(oldest);
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            if (job.generation == generation_) {
+                decoded_.push_back(std::move(decoded));
+            }
+        }
     }
 
-    unsigned int GTTextureCache::loadTexture(const std::filesystem::path& path) {
-        if (!std::filesystem::exists(path)) {
-            LOG_ERROR("GT image file does not exist: {}", path.string());
-            return 0;
+    bool GTTextureCache::uploadPending() {
+        std::deque<Decoded> ready;
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            // Spread large batches (a burst of prefetches) over several frames
+            size_t bytes = 0;
+            while (!decoded_.empty() && (ready.empty() || bytes < MAX_UPLOAD_BYTES_PER_FRAME)) {
+                if (decoded_.front().valid()) {
+                    bytes += decoded_.front().bytes();
+                }
+                ready.push_back(std::move(decoded_.front()));
+                decoded_.pop_front();
+            }
+            for (const auto& decoded : ready) {
+                in_flight_.erase(decoded.cam_id);
+            }
         }
 
-        try {
-            // Use image_io to load the image
-            auto [data, width, height, channels] = load_image(path);
-
-            if (!data) {
-                LOG_ERROR("Failed to load image data: {}", path.string());
-                return 0;
+        bool uploaded = false;
+        for (auto& decoded : ready) {
+            if (!decoded.valid()) {
+                LOG_ERROR("Failed to load GT texture for camera {}", decoded.cam_id);
+                failed_.insert(decoded.cam_id);
+                continue;
             }
 
-            LOG_TRACE("Loaded GT image: {}x{} with {} channels", width, height, channels);
-
-            // FLIP vertically: OpenGL expects origin at bottom-left, images have origin at top-left
-            // This matches what the renderer produces
-            std::vector<unsigned char> flipped_data(width * height * channels);
-            size_t row_size = width * channels;
-            for (int y = 0; y < height; ++y) {
-                std::memcpy(
-                    flipped_data.data() + y * row_size,
-                    data + (height - 1 - y) * row_size,
-                    row_size);
-            }
+            // GL stores RGB as RGBA, mipmaps add a third. BC7 blocks are exactly what they take.
+            const size_t bytes = decoded.pixels.defined()
+                                     ? static_cast<size_t>(decoded.pixels.size(0)) * decoded.pixels.size(1) * 4 * 4 / 3
+                                     : decoded.compressed.bytes();
+            evictToFit(bytes);
+
+            const unsigned int texture_id = decoded.pixels.defined() ? uploadTexture(decoded.pixels)
+                                                                     : uploadTexture(decoded.compressed);
+            lru_.push_front(decoded.cam_id);
+            texture_cache_[decoded.cam_id] = {texture_id, bytes, lru_.begin()};
+            cached_bytes_ += bytes;
+            uploaded = true;
+            LOG_DEBUG("Cached GT texture {} for camera {} ({} MB cached)", texture_id, decoded.cam_id, cached_bytes_ >> 20);
+        }
+        return uploaded;
+    }
 
-            // Create OpenGL texture
-            unsigned int texture;
-            glGenTextures(1, &texture);
-            glBindTexture(GL_TEXTURE_2D, texture);
-
-            // Determine format based on channels
-            GLenum format = GL_RGB;
-            GLenum internal_format = GL_RGB8;
-
-            if (channels == 1) {
-                format = GL_RED;
-                internal_format = GL_R8;
-            } else if (channels == 2) {
-                format = GL_RG;
-                internal_format = GL_RG8;
-            } else if (channels == 3) {
-                format = GL_RGB;
-                internal_format = GL_RGB8;
-            } else if (channels == 4) {
-                format = GL_RGBA;
-                internal_format = GL_RGBA8;
-            }
+    void GTTextureCache::evictToFit(size_t incoming) {
+        while (!lru_.empty() && cached_bytes_ + incoming > vram_budget_) {
+            const int cam_id = lru_.back();
+            lru_.pop_back();
+            auto it = texture_cache_.find(cam_id);
+            LOG_TRACE("Evicting GT texture for camera {} from cache", cam_id);
+            glDeleteTextures(1, &it->second.texture_id);
+            cached_bytes_ -= it->second.bytes;
+            texture_cache_.erase(it);
+        }
+    }
+
+    unsigned int GTTextureCache::uploadTexture(const torch::Tensor& pixels) {
+        const int height = static_cast<int>(pixels.size(0));
+        const int width = static_cast<int>(pixels.size(1));
+        const int channels = static_cast<int>(pixels.size(2));
+        const size_t bytes = static_cast<size_t>(pixels.numel());
+
+        // Determine format based on channels
+        GLenum format = GL_RGB;
+        GLenum internal_format = GL_RGB8;
+
+        if (channels == 1) {
+            format = GL_RED;
+            internal_format = GL_R8;
+        } else if (channels == 2) {
+            format = GL_RG;
+            internal_format = GL_RG8;
+        } else if (channels == 4) {
+            format = GL_RGBA;
+            internal_format = GL_RGBA8;
+        }
 
-            // Upload flipped texture data
-            glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0,
-                         format, GL_UNSIGNED_BYTE, flipped_data.data());
+        // Stage in an orphaned pixel buffer, glTexImage2D then returns before the transfer ends
+        if (pbo_ == 0) {
+            glGenBuffers(1, &pbo_);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo_);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+        if (void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+                                            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT)) {
+            std::memcpy(mapped, pixels.data_ptr<unsigned char>(), bytes);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        }
 
-            // Set texture parameters
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        unsigned int texture;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
 
-            // Generate mipmaps for better quality when scaled
-            glGenerateMipmap(GL_TEXTURE_2D);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        // Rows of odd-width RGB images are not 4-byte aligned
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
-            // Free image data
-            free_image(data);
+        // Set texture parameters
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        // Generate mipmaps for better quality when scaled
+        glGenerateMipmap(GL_TEXTURE_2D);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 
-            LOG_DEBUG("Created GL texture {} for image: {} ({}x{})",
-                      texture, path.filename().string(), width, height);
-            return texture;
+        LOG_TRACE("Uploaded GT texture {} ({}x{} with {} channels)", texture, width, height, channels);
+        return texture;
+    }
 
-        } catch (const std::exception& e) {
-            LOG_ERROR("Exception loading image {}: {}", path.string(), e.what());
-            return 0;
+    unsigned int GTTextureCache::uploadTexture(const CompressedTexture& texture) {
+        if (pbo_ == 0) {
+            glGenBuffers(1, &pbo_);
         }
+        unsigned int id;
+        glGenTextures(1, &id);
+        uploadCompressedTexture(id, texture, pbo_);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        return id;
     }
 
     // RenderingManager Implementation
@@ -166,9 +302,17 @@ namespace gs::visualizer {
     }
 
     RenderingManager::~RenderingManager() {
+        async_renderer_.reset();
         if (cached_render_texture_ > 0) {
             glDeleteTextures(1, &cached_render_texture_);
         }
+        for (auto& view : auxiliary_views_) {
+            if (view.fbo > 0) {
+                glDeleteFramebuffers(1, &view.fbo);
+                glDeleteTextures(1, &view.texture);
+                glDeleteRenderbuffers(1, &view.depth_rbo);
+            }
+        }
     }
 
     void RenderingManager::initialize() {
@@ -183,6 +327,7 @@ namespace gs::visualizer {
             LOG_ERROR("Failed to initialize rendering engine: {}", init_result.error());
             throw std::runtime_error("Failed to initialize rendering engine: " + init_result.error());
         }
+        async_renderer_ = std::make_unique<AsyncSplatRenderer>(*engine_);
 
         // Create cached render texture
         glGenTextures(1, &cached_render_texture_);
@@ -196,6 +341,37 @@ namespace gs::visualizer {
         LOG_INFO("Rendering engine initialized successfully");
     }
 
+    namespace {
+        // Whether switching between the settings changes the rasterized splats, the rest (grid,
+        // axes, gizmo, frustums, crop box wireframe) only changes the overlays drawn over them
+        bool affectsSplatLayer(const RenderSettings& a, const RenderSettings& b) {
+            return a.fov != b.fov ||
+                   a.scaling_modifier != b.scaling_modifier ||
+                   a.antialiasing != b.antialiasing ||
+                   a.sh_degree != b.sh_degree ||
+                   a.use_crop_box != b.use_crop_box ||
+                   (b.use_crop_box && (a.crop_min != b.crop_min || a.crop_max != b.crop_max ||
+                                       a.crop_transform.toMat4() != b.crop_transform.toMat4())) ||
+                   a.background_color != b.background_color ||
+                   a.world_transform.toMat4() != b.world_transform.toMat4() ||
+                   a.point_cloud_mode != b.point_cloud_mode ||
+                   a.voxel_size != b.voxel_size ||
+                   a.split_view_mode != b.split_view_mode ||
+                   a.split_position != b.split_position ||
+                   a.split_view_offset != b.split_view_offset ||
+                   a.gut != b.gut ||
+                   a.foveated != b.foveated ||
+                   (b.foveated && (a.fovea_center != b.fovea_center ||
+                                   a.fovea_inner_radius != b.fovea_inner_radius ||
+                                   a.fovea_outer_radius != b.fovea_outer_radius)) ||
+                   a.sh_lod != b.sh_lod ||
+                   (b.sh_lod && a.sh_lod_pixels != b.sh_lod_pixels) ||
+                   a.occlusion_culling != b.occlusion_culling ||
+                   a.half_precision != b.half_precision ||
+                   a.workload_heatmap != b.workload_heatmap;
+        }
+    } // namespace
+
     void RenderingManager::setupEventHandlers() {
         // Listen for split view toggle
         events::cmd::ToggleSplitView::when([this](const auto&) {
@@ -308,7 +484,7 @@ namespace gs::visualizer {
             settings_.grid_opacity = event.opacity;
             LOG_TRACE("Grid settings updated - enabled: {}, plane: {}, opacity: {}",
                       event.enabled, event.plane, event.opacity);
-            markDirty();
+            // Overlay only, the next frame draws it over the cached splats
         });
 
         // Scene changes
@@ -371,13 +547,26 @@ namespace gs::visualizer {
     void RenderingManager::markDirty() {
         needs_render_ = true;
         render_texture_valid_ = false;
+        ++splat_generation_;
         LOG_TRACE("Render marked dirty");
     }
 
+    bool RenderingManager::hasPendingWork() const {
+        // A sweep in progress, or the full quality render after an adaptive resolution one
+        if (needs_render_.load() || !cached_result_.image || refresh_band_ > 0 || pending_refresh_band_ >= 0 ||
+            last_render_reduced_ || (async_renderer_ && async_renderer_->pending())) {
+            return true;
+        }
+        return std::chrono::steady_clock::now() - last_camera_motion_ < camera_settle_time_;
+    }
+
     void RenderingManager::updateSettings(const RenderSettings& new_settings) {
         std::lock_guard<std::mutex> lock(settings_mutex_);
+        const bool splats_changed = affectsSplatLayer(settings_, new_settings);
         settings_ = new_settings;
-        markDirty();
+        if (splats_changed) {
+            markDirty();
+        }
     }
 
     RenderSettings RenderingManager::getSettings() const {
@@ -443,7 +632,90 @@ namespace gs::visualizer {
         return hovered_camera_id_; // Return current value
     }
 
+    gs::rendering::RenderRequest RenderingManager::makeRenderRequest(const RenderContext& context,
+                                                                      const glm::ivec2& raster_size,
+                                                                      int sh_degree) const {
+        // Create viewport data
+        gs::rendering::ViewportData viewport_data{
+            .rotation = context.viewport.getRotationMatrix(),
+            .translation = context.viewport.getTranslation(),
+            .size = raster_size,
+            .fov = settings_.fov};
+
+        // Apply world transform
+        if (!settings_.world_transform.isIdentity()) {
+            glm::mat3 world_rot = settings_.world_transform.getRotationMat();
+            glm::vec3 world_trans = settings_.world_transform.getTranslation();
+            viewport_data.rotation = glm::transpose(world_rot) * viewport_data.rotation;
+            viewport_data.translation = glm::transpose(world_rot) * (viewport_data.translation - world_trans);
+        }
+
+        gs::rendering::RenderRequest request{
+            .viewport = viewport_data,
+            .scaling_modifier = settings_.scaling_modifier,
+            .antialiasing = settings_.antialiasing,
+            .background_color = settings_.background_color,
+            .crop_box = std::nullopt,
+            .point_cloud_mode = settings_.point_cloud_mode,
+            .voxel_size = settings_.voxel_size,
+            .gut = settings_.gut,
+            .sh_degree = sh_degree,
+            .sh_lod_pixels = settings_.sh_lod ? settings_.sh_lod_pixels : 0.0f,
+            .occlusion_culling = settings_.occlusion_culling,
+            .half_precision = settings_.half_precision,
+            .workload_heatmap = settings_.workload_heatmap};
+
+        if (settings_.foveated) {
+            request.foveation = gs::rendering::Foveation{
+                .center = settings_.fovea_center,
+                .inner_radius = settings_.fovea_inner_radius,
+                .outer_radius = settings_.fovea_outer_radius};
+        }
+
+        // Add crop box if enabled
+        if (settings_.use_crop_box) {
+            auto transform = settings_.crop_transform;
+            request.crop_box = gs::rendering::BoundingBox{
+                .min = settings_.crop_min,
+                .max = settings_.crop_max,
+                .transform = transform.inv().toMat4()};
+        }
+
+        // Instances and node transforms, read together with the model they index
+        if (context.scene_manager) {
+            for (const auto& placement : context.scene_manager->getPlacementsForRendering()) {
+                request.instances.push_back({.first_row = placement.first_row,
+                                             .row_count = placement.row_count,
+                                             .transform = placement.transform});
+            }
+        }
+        return request;
+    }
+
+    bool RenderingManager::useAsyncRender() const {
+        // Split views composite on the GL thread and point clouds are drawn with GL
+        return async_renderer_ && framerate_controller_.getSettings().async_render &&
+               settings_.split_view_mode == SplitViewMode::Disabled && !settings_.point_cloud_mode;
+    }
+
+    void RenderingManager::submitAsyncRender(const RenderContext& context, const SplatData& model,
+                                             const glm::ivec2& render_size) {
+        const glm::ivec2 raster_size = glm::max(glm::ivec2(glm::round(glm::vec2(render_size) * render_scale_)), glm::ivec2(1));
+        const int sh_degree = framerate_controller_.renderShDegree(settings_.sh_degree);
+        last_render_reduced_ = raster_size != render_size || sh_degree != settings_.sh_degree;
+        async_renderer_->submit({.model = model.share(),
+                                 .request = makeRenderRequest(context, raster_size, sh_degree),
+                                 .reduced = last_render_reduced_});
+    }
+
+    void RenderingManager::waitForAsyncRender() {
+        if (async_renderer_) {
+            async_renderer_->wait();
+        }
+    }
+
     void RenderingManager::renderToTexture(const RenderContext& context, SceneManager* scene_manager, const SplatData* model) {
+        waitForAsyncRender();
         if (!model || model->size() == 0) {
             render_texture_valid_ = false;
             return;
@@ -514,45 +786,42 @@ namespace gs::visualizer {
         glClearColor(settings_.background_color.r, settings_.background_color.g, settings_.background_color.b, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // Create viewport data
-        gs::rendering::ViewportData viewport_data{
-            .rotation = context.viewport.getRotationMatrix(),
-            .translation = context.viewport.getTranslation(),
-            .size = render_size,
-            .fov = settings_.fov};
-
-        // Apply world transform
-        if (!settings_.world_transform.isIdentity()) {
-            glm::mat3 world_rot = settings_.world_transform.getRotationMat();
-            glm::vec3 world_trans = settings_.world_transform.getTranslation();
-            viewport_data.rotation = glm::transpose(world_rot) * viewport_data.rotation;
-            viewport_data.translation = glm::transpose(world_rot) * (viewport_data.translation - world_trans);
+        // Rasterize at the adaptive scale, the screen quad stretches the result over render_size
+        glm::ivec2 raster_size = render_size;
+        int sh_degree = settings_.sh_degree;
+        if (settings_.split_view_mode == SplitViewMode::Disabled) {
+            raster_size = glm::max(glm::ivec2(glm::round(glm::vec2(render_size) * render_scale_)), glm::ivec2(1));
+            sh_degree = framerate_controller_.renderShDegree(sh_degree);
         }
-
-        gs::rendering::RenderRequest request{
-            .viewport = viewport_data,
-            .scaling_modifier = settings_.scaling_modifier,
-            .antialiasing = settings_.antialiasing,
-            .background_color = settings_.background_color,
-            .crop_box = std::nullopt,
-            .point_cloud_mode = settings_.point_cloud_mode,
-            .voxel_size = settings_.voxel_size,
-            .gut = settings_.gut,
-            .sh_degree = settings_.sh_degree};
-
-        // Add crop box if enabled
-        if (settings_.use_crop_box) {
-            auto transform = settings_.crop_transform;
-            request.crop_box = gs::rendering::BoundingBox{
-                .min = settings_.crop_min,
-                .max = settings_.crop_max,
-                .transform = transform.inv().toMat4()};
+        last_render_reduced_ = raster_size != render_size || sh_degree != settings_.sh_degree;
+
+        auto request = makeRenderRequest(context, raster_size, sh_degree);
+
+        // A refresh band only rasterizes its rows, they replace those of the cached image
+        const int band = std::exchange(pending_refresh_band_, -1);
+        const auto& cached_image = cached_result_.image;
+        // The workload of a band would only report its rows
+        const bool band_refresh = band >= 0 && !settings_.gut && !settings_.point_cloud_mode &&
+                                  settings_.workload_heatmap == gs::rendering::WorkloadHeatmap::Off &&
+                                  cached_image && cached_image->dim() == 3 &&
+                                  cached_image->size(1) == raster_size.y && cached_image->size(2) == raster_size.x;
+        int band_begin = 0;
+        int band_rows = raster_size.y;
+        if (band_refresh) {
+            const int bands = std::max(framerate_controller_.getSettings().training_refresh_bands, 1);
+            band_begin = raster_size.y * band / bands;
+            band_rows = raster_size.y * (band + 1) / bands - band_begin;
+            request.render_rect = glm::ivec4(0, band_begin, raster_size.x, band_rows);
         }
 
         // Render the gaussians
         auto render_result = engine_->renderGaussians(*model, request);
         if (render_result) {
-            cached_result_ = *render_result;
+            if (band_refresh) {
+                cached_result_.image->narrow(1, band_begin, band_rows).copy_(render_result->image->narrow(1, band_begin, band_rows));
+            } else {
+                cached_result_ = *render_result;
+            }
 
             // Present to texture
             auto present_result = engine_->presentToScreen(
@@ -582,6 +851,10 @@ namespace gs::visualizer {
             initialize();
         }
 
+        if (gt_texture_cache_.uploadPending() && settings_.split_view_mode == SplitViewMode::GTComparison) {
+            needs_render_ = true;
+        }
+
         // Calculate current render size
         glm::ivec2 current_size = context.viewport.windowSize;
         if (context.viewport_region) {
@@ -606,6 +879,23 @@ namespace gs::visualizer {
             cached_result_ = {};
             render_texture_valid_ = false;
             last_render_size_ = current_size;
+            if (async_renderer_) {
+                async_renderer_->cancel();
+            }
+        }
+
+        // Streamed LOD files follow the camera, in model space like the rasterizer's viewpoint
+        if (scene_manager) {
+            glm::vec3 camera_position = context.viewport.getTranslation();
+            if (!settings_.world_transform.isIdentity()) {
+                camera_position = glm::transpose(settings_.world_transform.getRotationMat()) *
+                                  (camera_position - settings_.world_transform.getTranslation());
+            }
+            scene_manager->updateStreaming(camera_position);
+            // The snapshot slot a render on the worker reads stays leased until it is done
+            if (!async_renderer_ || !async_renderer_->pending()) {
+                scene_manager->updateTrainingSnapshot();
+            }
         }
 
         // Get current model
@@ -619,6 +909,18 @@ namespace gs::visualizer {
             render_texture_valid_ = false;
             last_model_ptr_ = model_ptr;
             cached_result_ = {};
+            ++splat_generation_;
+            if (async_renderer_) {
+                async_renderer_->cancel();
+            }
+        }
+
+        // The newest frame the render thread finished replaces the cached layer
+        if (async_renderer_) {
+            if (auto frame = async_renderer_->takeCompleted()) {
+                cached_result_ = std::move(frame->result);
+                render_texture_valid_ = false;
+            }
         }
 
         // Check if split view is enabled
@@ -635,27 +937,57 @@ namespace gs::visualizer {
             }
         }
 
-        // Determine if we should do a full render
-        bool should_render = false;
-        bool needs_render_now = needs_render_.load();
+        // Lower the resolution while the camera moves, then render once more at full quality
+        const auto now = std::chrono::steady_clock::now();
+        if (context.viewport.getRotationMatrix() != last_view_rotation_ ||
+            context.viewport.getTranslation() != last_view_translation_) {
+            last_view_rotation_ = context.viewport.getRotationMatrix();
+            last_view_translation_ = context.viewport.getTranslation();
+            last_camera_motion_ = now;
+            needs_render_ = true;
+        }
+        const bool camera_moving = now - last_camera_motion_ < camera_settle_time_;
+        render_scale_ = framerate_controller_.updateRenderScale(camera_moving);
+        if (!camera_moving && last_render_reduced_) {
+            needs_render_ = true;
+        }
 
-        // Always render if we need to update the display
-        if (!cached_result_.image || needs_render_now || split_view_active) {
-            should_render = true;
-            needs_render_ = false;
-        } else if (context.has_focus) {
-            should_render = true;
-        } else if (scene_manager && scene_manager->hasDataset()) {
-            const auto* trainer_manager = scene_manager->getTrainerManager();
-            if (trainer_manager && trainer_manager->isRunning()) {
-                auto now = std::chrono::steady_clock::now();
-                if (now - last_training_render_ > std::chrono::seconds(1)) {
-                    should_render = true;
-                    last_training_render_ = now;
+        // Model edits that come without an event: streamed LOD swaps and training progress, the
+        // latter at most once per refresh interval so the viewer leaves the GPU to the trainer. With
+        // a still camera training progress is swept in bands, spreading one render over several frames.
+        if (const uint64_t revision = scene_manager ? scene_manager->getModelRevision() : 0;
+            revision != last_model_revision_ || refresh_band_ > 0) {
+            const auto* trainer_manager = scene_manager ? scene_manager->getTrainerManager() : nullptr;
+            const bool training = scene_manager && scene_manager->hasDataset() &&
+                                  trainer_manager && trainer_manager->isRunning();
+            const auto& framerate_settings = framerate_controller_.getSettings();
+            const int bands = training && !camera_moving && cached_result_.image && !needs_render_ && !useAsyncRender()
+                                  ? std::max(framerate_settings.training_refresh_bands, 1)
+                                  : 1;
+            const std::chrono::duration<float> interval(framerate_settings.training_frame_refresh_time_sec / bands);
+            if (!training || now - last_training_render_ > interval) {
+                if (refresh_band_ == 0) {
+                    last_model_revision_ = revision;
+                }
+                if (bands > 1) {
+                    pending_refresh_band_ = refresh_band_;
+                    refresh_band_ = (refresh_band_ + 1) % bands;
+                } else {
+                    needs_render_ = true;
                 }
+                ++splat_generation_;
+                last_training_render_ = now;
             }
         }
 
+        // The splats are only rasterized again when something they depend on changed, otherwise
+        // the cached layer is presented and just the overlays are drawn over it
+        bool should_render = false;
+        if (!cached_result_.image || needs_render_.load() || split_view_active) {
+            should_render = true;
+            needs_render_ = false;
+        }
+
         // Clear and set viewport
         glViewport(0, 0, context.viewport.frameBufferSize.x, context.viewport.frameBufferSize.y);
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
@@ -670,9 +1002,23 @@ namespace gs::visualizer {
                 static_cast<GLsizei>(context.viewport_region->height));
         }
 
-        if (should_render || !model) {
+        // Off the GUI thread the splats are only submitted, the cached layer is shown until they are done
+        const bool async_render = should_render && model && model->size() > 0 && useAsyncRender();
+        if (async_render) {
+            refresh_band_ = 0;
+            pending_refresh_band_ = -1;
+            submitAsyncRender(context, *model, current_size);
+        }
+
+        if ((should_render || !model) && !async_render) {
+            // A full render supersedes a band sweep in progress
+            refresh_band_ = 0;
+            pending_refresh_band_ = -1;
             doFullRender(context, scene_manager, model);
         } else if (cached_result_.image) {
+            if (pending_refresh_band_ >= 0) {
+                renderToTexture(context, scene_manager, model);
+            }
             glm::ivec2 viewport_pos(0, 0);
             glm::ivec2 render_size = current_size;
 
@@ -684,13 +1030,197 @@ namespace gs::visualizer {
 
             engine_->presentToScreen(cached_result_, viewport_pos, render_size);
             renderOverlays(context);
+        } else {
+            renderOverlays(context);
         }
 
+        renderAuxiliaryViews(context, scene_manager, model);
+
         framerate_controller_.endFrame();
     }
 
+    unsigned int RenderingManager::requestAuxiliaryView(AuxiliaryView view, const glm::ivec2& size, bool active) {
+        auto& state = auxiliary_views_[static_cast<size_t>(view)];
+        state.requested = true;
+        state.requested_size = size;
+        state.active = active;
+        return state.generation != 0 ? state.texture : 0;
+    }
+
+    std::optional<gs::rendering::ViewportData> RenderingManager::getAuxiliaryViewpoint(AuxiliaryView view,
+                                                                                         const RenderContext& context,
+                                                                                         SceneManager* scene_manager,
+                                                                                         const SplatData& model,
+                                                                                         const glm::ivec2& size) {
+        if (view == AuxiliaryView::Camera) {
+            // Training cameras live in model space, as in GoToCamView
+            auto* trainer_manager = scene_manager ? scene_manager->getTrainerManager() : nullptr;
+            if (current_camera_id_ < 0 || !trainer_manager || !trainer_manager->hasTrainer()) {
+                return std::nullopt;
+            }
+            const auto cam = trainer_manager->getCamById(current_camera_id_);
+            if (!cam) {
+                return std::nullopt;
+            }
+            glm::mat3 world_to_cam_R;
+            const auto R = cam->R().accessor<float, 2>();
+            for (int i = 0; i < 3; ++i) {
+                for (int j = 0; j < 3; ++j) {
+                    world_to_cam_R[j][i] = R[i][j];
+                }
+            }
+            const auto T = cam->T().accessor<float, 1>();
+            const glm::mat3 rotation = glm::transpose(world_to_cam_R);
+            const auto [focal_x, focal_y, center_x, center_y] = cam->get_intrinsics();
+            return gs::rendering::ViewportData{
+                .rotation = rotation,
+                .translation = -rotation * glm::vec3(T[0], T[1], T[2]),
+                .size = size,
+                .fov = glm::degrees(2.0f * std::atan(static_cast<float>(cam->image_height()) / (2.0f * focal_y)))};
+        }
+
+        // Robust bounds of the means, stray Gaussians far out would only shrink the scene
+        const uint64_t revision = scene_manager ? scene_manager->getModelRevision() : 0;
+        if (revision != bounds_revision_ || reinterpret_cast<size_t>(&model) != bounds_model_ptr_) {
+            torch::NoGradGuard no_grad;
+            const auto means = model.means().to(torch::kFloat32);
+            const auto stats = torch::stack({means.mean(0), means.std(0)}).cpu();
+            const auto s = stats.accessor<float, 2>();
+            bounds_center_ = glm::vec3(s[0][0], s[0][1], s[0][2]);
+            bounds_extent_ = glm::max(2.0f * glm::vec3(s[1][0], s[1][1], s[1][2]), glm::vec3(1e-3f));
+            bounds_revision_ = revision;
+            bounds_model_ptr_ = reinterpret_cast<size_t>(&model);
+        }
+
+        // Along the vertical axis towards the main camera's down, heading where it looks
+        glm::mat3 main_rotation = context.viewport.getRotationMatrix();
+        if (!settings_.world_transform.isIdentity()) {
+            main_rotation = glm::transpose(settings_.world_transform.getRotationMat()) * main_rotation;
+        }
+        const glm::vec3 forward(0.0f, main_rotation[1].y < 0.0f ? -1.0f : 1.0f, 0.0f);
+        glm::vec3 right(main_rotation[0].x, 0.0f, main_rotation[0].z);
+        right = glm::length(right) > 1e-4f ? glm::normalize(right) : glm::vec3(1.0f, 0.0f, 0.0f);
+        const glm::mat3 rotation(right, glm::cross(forward, right), forward);
+
+        const float aspect = static_cast<float>(size.x) / static_cast<float>(size.y);
+        const float tan_half_fov = std::tan(glm::radians(settings_.fov) * 0.5f) * std::min(aspect, 1.0f);
+        const float distance = std::max(bounds_extent_.x, bounds_extent_.z) / tan_half_fov + bounds_extent_.y;
+        return gs::rendering::ViewportData{
+            .rotation = rotation,
+            .translation = bounds_center_ - forward * distance,
+            .size = size,
+            .fov = settings_.fov};
+    }
+
+    void RenderingManager::renderAuxiliaryViews(const RenderContext& context, SceneManager* scene_manager, const SplatData* model) {
+        const auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < auxiliary_views_.size(); ++i) {
+            auto& state = auxiliary_views_[i];
+            if (!state.requested) {
+                // Its window is closed, give the memory back
+                if (state.fbo > 0) {
+                    glDeleteFramebuffers(1, &state.fbo);
+                    glDeleteTextures(1, &state.texture);
+                    glDeleteRenderbuffers(1, &state.depth_rbo);
+                    state = {};
+                }
+                continue;
+            }
+            state.requested = false;
+
+            const glm::ivec2 size = state.requested_size;
+            if (!model || model->size() == 0 || size.x <= 0 || size.y <= 0) {
+                continue;
+            }
+            const auto viewpoint = getAuxiliaryViewpoint(static_cast<AuxiliaryView>(i), context, scene_manager, *model, size);
+            if (!viewpoint) {
+                continue;
+            }
+
+            // Only rasterized again for a change, and then no more often than its rate allows
+            const uint64_t generation = splat_generation_.load();
+            if (state.generation == generation && state.texture_size == size &&
+                state.rotation == viewpoint->rotation && state.translation == viewpoint->translation) {
+                continue;
+            }
+            if (state.generation != 0 && now - state.last_render < framerate_controller_.viewRenderInterval(state.active)) {
+                continue;
+            }
+
+            if (state.fbo == 0) {
+                glGenFramebuffers(1, &state.fbo);
+                glGenTextures(1, &state.texture);
+                glGenRenderbuffers(1, &state.depth_rbo);
+                glBindTexture(GL_TEXTURE_2D, state.texture);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            }
+
+            GLint current_fbo;
+            glGetIntegerv(GL_FRAMEBUFFER_BINDING, &current_fbo);
+            GLint current_viewport[4];
+            glGetIntegerv(GL_VIEWPORT, current_viewport);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, state.fbo);
+            if (state.texture_size != size) {
+                glBindTexture(GL_TEXTURE_2D, state.texture);
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+                glBindRenderbuffer(GL_RENDERBUFFER, state.depth_rbo);
+                glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, size.x, size.y);
+                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, state.texture, 0);
+                glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, state.depth_rbo);
+                state.texture_size = size;
+            }
+
+            if (const GLenum fb_status = glCheckFramebufferStatus(GL_FRAMEBUFFER); fb_status != GL_FRAMEBUFFER_COMPLETE) {
+                LOG_ERROR("Auxiliary view framebuffer incomplete: 0x{:x}", fb_status);
+            } else {
+                glViewport(0, 0, size.x, size.y);
+                glClearColor(settings_.background_color.r, settings_.background_color.g, settings_.background_color.b, 1.0f);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+                // The same model and engine as the main view, only the viewpoint differs
+                gs::rendering::RenderRequest request{
+                    .viewport = *viewpoint,
+                    .scaling_modifier = settings_.scaling_modifier,
+                    .antialiasing = settings_.antialiasing,
+                    .background_color = settings_.background_color,
+                    .crop_box = std::nullopt,
+                    .point_cloud_mode = settings_.point_cloud_mode,
+                    .voxel_size = settings_.voxel_size,
+                    .gut = settings_.gut,
+                    .sh_degree = settings_.sh_degree};
+                if (settings_.use_crop_box) {
+                    request.crop_box = gs::rendering::BoundingBox{
+                        .min = settings_.crop_min,
+                        .max = settings_.crop_max,
+                        .transform = settings_.crop_transform.inv().toMat4()};
+                }
+
+                // The engine rasterizes one view at a time
+                waitForAsyncRender();
+                if (auto result = engine_->renderGaussians(*model, request); !result) {
+                    LOG_ERROR("Failed to render auxiliary view: {}", result.error());
+                } else if (auto presented = engine_->presentToScreen(*result, glm::ivec2(0, 0), size); !presented) {
+                    LOG_ERROR("Failed to present auxiliary view: {}", presented.error());
+                } else {
+                    state.generation = generation;
+                    state.rotation = viewpoint->rotation;
+                    state.translation = viewpoint->translation;
+                    state.last_render = now;
+                }
+            }
+
+            glBindFramebuffer(GL_FRAMEBUFFER, current_fbo);
+            glViewport(current_viewport[0], current_viewport[1], current_viewport[2], current_viewport[3]);
+        }
+    }
+
     void RenderingManager::doFullRender(const RenderContext& context, SceneManager* scene_manager, const SplatData* model) {
         LOG_TIMER_TRACE("Full render pass");
+        waitForAsyncRender();
 
         render_count_++;
         LOG_TRACE("Render #{}, pick_requested: {}", render_count_, pick_requested_);
@@ -827,10 +1357,18 @@ namespace gs::visualizer {
                 return std::nullopt;
             }
 
-            // Get GT texture
+            // Get GT texture, then queue the cameras the arrow keys step to next
             unsigned int gt_texture = gt_texture_cache_.getGTTexture(current_camera_id_, cam->image_path());
+            const int num_cams = static_cast<int>(trainer_manager->getCamList().size());
+            for (const int step : {1, -1, 2, -2}) {
+                const int neighbour_id = ((current_camera_id_ + step) % num_cams + num_cams) % num_cams;
+                if (auto neighbour = trainer_manager->getCamById(neighbour_id)) {
+                    gt_texture_cache_.prefetch(neighbour_id, neighbour->image_path());
+                }
+            }
             if (gt_texture == 0) {
-                LOG_ERROR("Failed to get GT texture for camera {}", current_camera_id_);
+                // Still decoding, uploadPending() marks the view dirty once it is ready
+                LOG_TRACE("GT texture for camera {} not ready yet", current_camera_id_);
                 return std::nullopt;
             }
 
@@ -1031,8 +1569,10 @@ namespace gs::visualizer {
                     LOG_ERROR("Failed to render camera frustums: {}", frustum_result.error());
                 }
 
-                // Perform picking if requested
-                if (pick_requested_ && context.viewport_region) {
+                // Perform picking if requested, and for a few frames after so the asynchronous
+                // readback of the last request comes back
+                if ((pick_requested_ || pick_settle_frames_ > 0) && context.viewport_region) {
+                    pick_settle_frames_ = pick_requested_ ? pick_settle_frames : pick_settle_frames_ - 1;
                     pick_requested_ = false;
 
                     auto pick_result = engine_->pickCameraFrustum(
@@ -1046,20 +1586,16 @@ namespace gs::visualizer {
                     if (pick_result) {
                         int cam_id = *pick_result;
 
-                        // Only process if camera ID actually changed
+                        // The highlight is part of the overlay, redrawn next frame without the splats
                         if (cam_id != hovered_camera_id_) {
                             int old_hover = hovered_camera_id_;
                             hovered_camera_id_ = cam_id;
-
-                            // Only mark dirty on actual change
-                            markDirty();
                             LOG_DEBUG("Camera hover changed: {} -> {}", old_hover, cam_id);
                         }
                     } else if (hovered_camera_id_ != -1) {
                         // Lost hover - only update if we had a hover before
                         int old_hover = hovered_camera_id_;
                         hovered_camera_id_ = -1;
-                        markDirty();
                         LOG_DEBUG("Camera hover lost (was ID: {})", old_hover);
                     }
                 }
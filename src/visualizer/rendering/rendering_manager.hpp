@@ -4,16 +4,26 @@
 
 #pragma once
 
+#include "async_splat_renderer.hpp"
+#include "compressed_texture.hpp"
 #include "framerate_controller.hpp"
 #include "internal/viewport.hpp"
 #include "rendering/rendering.hpp"
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <thread>
+#include <torch/types.h>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace gs {
     class SceneManager;
@@ -82,6 +92,32 @@ namespace gs::visualizer {
         size_t split_view_offset = 0;
 
         bool gut = false;
+
+        // Foveated rendering, full quality only around the gaze point
+        bool foveated = false;
+        glm::vec2 fovea_center = glm::vec2(0.5f, 0.5f); // Normalized image coordinates
+        float fovea_inner_radius = 0.15f;               // Fractions of the image diagonal
+        float fovea_outer_radius = 0.45f;
+
+        // SH degree per Gaussian from its screen radius, full degree only for large splats
+        bool sh_lod = true;
+        float sh_lod_pixels = 2.0f;
+
+        // Skip Gaussians hidden behind what the previous frame rendered opaque, for occluded interiors
+        bool occlusion_culling = false;
+
+        // Blend from half precision conics, opacities and colors, less bandwidth on large scenes
+        bool half_precision = false;
+
+        // Debug overlay of the rasterizer's per-tile work
+        gs::rendering::WorkloadHeatmap workload_heatmap = gs::rendering::WorkloadHeatmap::Off;
+    };
+
+    // Secondary views of the shown model, each in its own GUI window
+    enum class AuxiliaryView {
+        Top,    // Straight down onto the scene, heading along the main camera
+        Camera, // From the selected training camera
+        Count
     };
 
     struct SplitViewInfo {
@@ -95,28 +131,78 @@ namespace gs::visualizer {
     };
 
     // GT Image Cache for efficient GPU-resident texture management
+    // GT images of the training cameras as GL textures. Images decode on worker threads and are
+    // uploaded through a pixel buffer on the render thread, a bounded amount per frame. The cache
+    // is bounded by the textures' VRAM, the least recently shown ones are evicted first. With
+    // texture compression the workers also transcode each image and its mip chain to BC7 on the GPU.
     class GTTextureCache {
     public:
-        GTTextureCache();
+        explicit GTTextureCache(size_t vram_budget = DEFAULT_VRAM_BUDGET);
         ~GTTextureCache();
 
-        // Get or load GT texture for a camera
+        // Texture of the camera, 0 while its image is still decoding (it is then decoded next)
         unsigned int getGTTexture(int cam_id, const std::filesystem::path& image_path);
 
+        // Queues the camera's image behind the requested ones, no-op when cached or queued
+        void prefetch(int cam_id, const std::filesystem::path& image_path);
+
+        // Uploads finished decodes, call once per frame on the GL thread. True when a texture
+        // became available.
+        bool uploadPending();
+
         // Clear cache
         void clear();
 
     private:
+        static constexpr size_t DEFAULT_VRAM_BUDGET = size_t{512} << 20;
+        static constexpr size_t MAX_UPLOAD_BYTES_PER_FRAME = size_t{64} << 20;
+        static constexpr int NUM_WORKERS = 2;
+
         struct CacheEntry {
             unsigned int texture_id;
-            std::chrono::steady_clock::time_point last_access;
+            size_t bytes; // VRAM with mipmaps, estimated for uncompressed textures
+            std::list<int>::iterator lru;
         };
 
-        std::unordered_map<int, CacheEntry> texture_cache_;
-        static constexpr size_t MAX_CACHE_SIZE = 20;
+        struct Job {
+            int cam_id;
+            std::filesystem::path path;
+            uint64_t generation;
+        };
+
+        struct Decoded {
+            int cam_id;
+            uint64_t generation;
+            torch::Tensor pixels;         // uint8 [H, W, C] on the host, bottom row first
+            CompressedTexture compressed; // Instead of pixels with texture compression; both empty on failure
+
+            bool valid() const { return pixels.defined() || compressed.blocks.defined(); }
+            size_t bytes() const { return pixels.defined() ? static_cast<size_t>(pixels.numel()) : compressed.bytes(); }
+        };
+
+        void request(int cam_id, const std::filesystem::path& image_path, bool urgent);
+        void workerLoop();
+        void evictToFit(size_t incoming);
+        unsigned int uploadTexture(const torch::Tensor& pixels);
+        unsigned int uploadTexture(const CompressedTexture& texture);
 
-        void evictOldest();
-        unsigned int loadTexture(const std::filesystem::path& path);
+        // Render thread only
+        std::unordered_map<int, CacheEntry> texture_cache_;
+        std::list<int> lru_; // Most recently shown first
+        size_t cached_bytes_ = 0;
+        size_t vram_budget_;
+        std::unordered_set<int> in_flight_; // Queued or decoding
+        std::unordered_set<int> failed_;    // Not retried until clear()
+        unsigned int pbo_ = 0;
+
+        // Shared with the workers
+        std::mutex queue_mutex_;
+        std::condition_variable queue_cv_;
+        std::deque<Job> jobs_;
+        std::deque<Decoded> decoded_;
+        uint64_t generation_ = 0; // Bumped by clear(), decodes of an older generation are dropped
+        bool stop_ = false;
+        std::vector<std::thread> workers_;
     };
 
     class RenderingManager {
@@ -144,9 +230,19 @@ namespace gs::visualizer {
         // Main render function
         void renderFrame(const RenderContext& context, SceneManager* scene_manager);
 
-        // Mark that rendering is needed
+        // Keeps an auxiliary view rendered at size while called every frame, the frame after. Active
+        // views follow the target frame rate, the others FramerateSettings::inactive_view_fps.
+        // Returns its texture (bottom-up like any GL render target), 0 until first rendered.
+        unsigned int requestAuxiliaryView(AuxiliaryView view, const glm::ivec2& size, bool active);
+
+        // Mark that the splats need rasterizing again. Overlays are drawn every frame over the
+        // cached splat layer, changes to them alone need no call.
         void markDirty();
 
+        // Whether the next frame has splats to rasterize or a camera motion to settle. False when it
+        // would present the cached layer again, the main loop may then wait for events.
+        bool hasPendingWork() const;
+
         // Settings management
         void updateSettings(const RenderSettings& settings);
         RenderSettings getSettings() const;
@@ -161,6 +257,9 @@ namespace gs::visualizer {
         void advanceSplitOffset();
         SplitViewInfo getSplitViewInfo() const;
 
+        // Heaviest tiles of the shown frame, null unless it has a workload heatmap
+        std::shared_ptr<const gs::rendering::WorkloadReport> getWorkloadReport() const { return cached_result_.workload; }
+
         // Current camera tracking for GT comparison
         void setCurrentCameraId(int cam_id) {
             current_camera_id_ = cam_id;
@@ -168,6 +267,8 @@ namespace gs::visualizer {
         }
         int getCurrentCameraId() const { return current_camera_id_; }
 
+        const FramerateSettings& getFramerateSettings() const { return framerate_controller_.getSettings(); }
+
         // FPS monitoring
         float getCurrentFPS() const { return framerate_controller_.getCurrentFPS(); }
         float getAverageFPS() const { return framerate_controller_.getAverageFPS(); }
@@ -185,6 +286,20 @@ namespace gs::visualizer {
         void renderOverlays(const RenderContext& context);
         void setupEventHandlers();
         void renderToTexture(const RenderContext& context, SceneManager* scene_manager, const SplatData* model);
+        // Request of the main view from the settings and camera of this frame
+        gs::rendering::RenderRequest makeRenderRequest(const RenderContext& context, const glm::ivec2& raster_size,
+                                                       int sh_degree) const;
+        // Whether the main view renders on async_renderer_, not in split view or point cloud mode
+        bool useAsyncRender() const;
+        void submitAsyncRender(const RenderContext& context, const SplatData& model, const glm::ivec2& render_size);
+        // Called before the GUI thread rasterizes through engine_ itself
+        void waitForAsyncRender();
+        void renderAuxiliaryViews(const RenderContext& context, SceneManager* scene_manager, const SplatData* model);
+        std::optional<gs::rendering::ViewportData> getAuxiliaryViewpoint(AuxiliaryView view,
+                                                                          const RenderContext& context,
+                                                                          SceneManager* scene_manager,
+                                                                          const SplatData& model,
+                                                                          const glm::ivec2& size);
 
         std::optional<gs::rendering::SplitViewRequest> createSplitViewRequest(
             const RenderContext& context,
@@ -192,12 +307,13 @@ namespace gs::visualizer {
 
         // Core components
         std::unique_ptr<gs::rendering::RenderingEngine> engine_;
+        std::unique_ptr<AsyncSplatRenderer> async_renderer_; // Main view render thread, see useAsyncRender()
         FramerateController framerate_controller_;
 
         // GT texture cache
         GTTextureCache gt_texture_cache_;
 
-        // Cached render texture for reuse in split view
+        // The last splat render (cached_result_, with its depth) as a texture, for split view reuse
         unsigned int cached_render_texture_ = 0;
         bool render_texture_valid_ = false;
 
@@ -205,8 +321,46 @@ namespace gs::visualizer {
         std::atomic<bool> needs_render_{true};
         gs::rendering::RenderResult cached_result_;
         size_t last_model_ptr_ = 0;
+        uint64_t last_model_revision_ = 0;
         glm::ivec2 last_render_size_{0, 0};
         std::chrono::steady_clock::time_point last_training_render_;
+        // Band-wise refresh while training: the band the next sweep step renders, and the band
+        // renderToTexture has to rasterize this frame (-1: none)
+        int refresh_band_ = 0;
+        int pending_refresh_band_ = -1;
+
+        // Adaptive resolution: camera motion tracking and what the last scene render used
+        glm::mat3 last_view_rotation_{1.0f};
+        glm::vec3 last_view_translation_{0.0f};
+        std::chrono::steady_clock::time_point last_camera_motion_;
+        float render_scale_ = 1.0f;
+        bool last_render_reduced_ = false;
+        // The camera counts as moving this long after its last change, so a drag does not
+        // alternate between reduced and full frames
+        static constexpr auto camera_settle_time_ = std::chrono::milliseconds(150);
+
+        // Auxiliary views, rendered with the same engine and model as the main view
+        struct AuxiliaryViewState {
+            unsigned int fbo = 0;
+            unsigned int texture = 0;
+            unsigned int depth_rbo = 0;
+            glm::ivec2 texture_size{0, 0};
+            glm::ivec2 requested_size{0, 0};
+            bool requested = false; // Its window asked for it since the last frame
+            bool active = false;
+            // What the texture shows
+            uint64_t generation = 0;
+            glm::mat3 rotation{1.0f};
+            glm::vec3 translation{0.0f};
+            std::chrono::steady_clock::time_point last_render;
+        };
+        std::array<AuxiliaryViewState, static_cast<size_t>(AuxiliaryView::Count)> auxiliary_views_;
+        std::atomic<uint64_t> splat_generation_{1}; // Bumped whenever the splats need rendering again
+        // Robust bounds of the model the top view frames, per model revision
+        uint64_t bounds_revision_ = 0;
+        size_t bounds_model_ptr_ = 0;
+        glm::vec3 bounds_center_{0.0f};
+        glm::vec3 bounds_extent_{1.0f};
 
         // Split view state
         mutable std::mutex split_info_mutex_;
@@ -227,6 +381,8 @@ namespace gs::visualizer {
         int highlighted_camera_index_ = -1;
         glm::vec2 pending_pick_pos_{-1, -1};
         bool pick_requested_ = false;
+        int pick_settle_frames_ = 0;
+        static constexpr int pick_settle_frames = 3; // The frustum renderer's readback depth
         std::chrono::steady_clock::time_point last_pick_time_;
         static constexpr auto pick_throttle_interval_ = std::chrono::milliseconds(50);
 
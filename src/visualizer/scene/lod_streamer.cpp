@@ -0,0 +1,154 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "scene/lod_streamer.hpp"
+#include "core/logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cuda_runtime.h>
+#include <numeric>
+
+namespace gs {
+
+    namespace {
+        // A chunk keeps its level until the distance moves this far (in levels) past either edge
+        constexpr float LEVEL_HYSTERESIS = 0.25f;
+    } // namespace
+
+    bool LodStreamer::isLodFile(const std::filesystem::path& path) {
+        auto ext = path.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        return ext == core::SPLAT_LOD_EXTENSION;
+    }
+
+    std::expected<std::unique_ptr<LodStreamer>, std::string> LodStreamer::open(const std::filesystem::path& path,
+                                                                              const Options& options) {
+        auto file = loader::SplatLodFile::open(path);
+        if (!file) {
+            return std::unexpected(file.error());
+        }
+
+        auto streamer = std::unique_ptr<LodStreamer>(new LodStreamer());
+        streamer->file_ = std::move(*file);
+        streamer->options_ = options;
+
+        const auto& lod = *streamer->file_;
+        streamer->chunks_.reserve(lod.num_chunks());
+        for (uint32_t c = 0; c < lod.num_chunks(); ++c) {
+            const auto& block = lod.block(c, 0);
+            const glm::vec3 lo(block.bounds_min[0], block.bounds_min[1], block.bounds_min[2]);
+            const glm::vec3 hi(block.bounds_max[0], block.bounds_max[1], block.bounds_max[2]);
+            streamer->chunks_.push_back({.center = 0.5f * (lo + hi), .radius = std::max(0.5f * glm::length(hi - lo), 1e-6f)});
+        }
+
+        size_t free_bytes = 0, total_bytes = 0;
+        if (cudaMemGetInfo(&free_bytes, &total_bytes) != cudaSuccess) {
+            return std::unexpected("Failed to query free VRAM for LOD streaming");
+        }
+        const uint64_t bytes_per_gaussian = core::splat_lod_floats_per_gaussian(lod.header().shN_coeffs) * sizeof(float);
+        streamer->budget_ = static_cast<size_t>(options.vram_fraction * static_cast<float>(free_bytes)) / bytes_per_gaussian;
+
+        // Everything at its coarsest level until the first camera update
+        const std::vector<float> distances(streamer->chunks_.size(), 0.f);
+        streamer->levels_.assign(streamer->chunks_.size(), static_cast<int>(lod.num_levels()) - 1);
+        streamer->fitBudget(streamer->levels_, distances);
+        streamer->resident_ = streamer->selectionSize(streamer->levels_);
+
+        LOG_INFO("Streaming {} ({} gaussians, {} chunks x {} levels) within {} resident gaussians",
+                 path.filename().string(), lod.header().num_gaussians, lod.num_chunks(), lod.num_levels(),
+                 streamer->budget_);
+        return streamer;
+    }
+
+    size_t LodStreamer::selectionSize(const std::vector<int>& levels) const {
+        size_t total = 0;
+        for (uint32_t c = 0; c < levels.size(); ++c) {
+            if (levels[c] >= 0) {
+                total += file_->block(c, static_cast<uint32_t>(levels[c])).count;
+            }
+        }
+        return total;
+    }
+
+    void LodStreamer::fitBudget(std::vector<int>& levels, const std::vector<float>& distances) const {
+        size_t total = selectionSize(levels);
+        if (total <= budget_) {
+            return;
+        }
+
+        std::vector<uint32_t> far_first(levels.size());
+        std::iota(far_first.begin(), far_first.end(), 0u);
+        std::stable_sort(far_first.begin(), far_first.end(),
+                         [&](const uint32_t a, const uint32_t b) { return distances[a] > distances[b]; });
+
+        const int coarsest = static_cast<int>(file_->num_levels()) - 1;
+        const auto count = [&](const uint32_t c, const int level) {
+            return static_cast<size_t>(file_->block(c, static_cast<uint32_t>(level)).count);
+        };
+
+        // Coarsen one level at a time from the far end, then drop the farthest chunks
+        for (bool changed = true; total > budget_ && changed;) {
+            changed = false;
+            for (const uint32_t c : far_first) {
+                if (total <= budget_) {
+                    break;
+                }
+                if (levels[c] >= 0 && levels[c] < coarsest) {
+                    total -= count(c, levels[c]) - count(c, levels[c] + 1);
+                    ++levels[c];
+                    changed = true;
+                }
+            }
+        }
+        for (const uint32_t c : far_first) {
+            if (total <= budget_) {
+                break;
+            }
+            if (levels[c] >= 0) {
+                total -= count(c, levels[c]);
+                levels[c] = -1;
+            }
+        }
+    }
+
+    bool LodStreamer::update(const glm::vec3& camera_position) {
+        const int coarsest = static_cast<int>(file_->num_levels()) - 1;
+        std::vector<float> distances(chunks_.size());
+        std::vector<int> levels(chunks_.size());
+
+        for (size_t c = 0; c < chunks_.size(); ++c) {
+            const auto& chunk = chunks_[c];
+            distances[c] = std::max(0.f, glm::length(camera_position - chunk.center) - chunk.radius);
+            const float level = std::log2(1.f + distances[c] / (options_.lod_distance * chunk.radius));
+
+            const int current = levels_[c];
+            if (current >= 0 && level >= current - LEVEL_HYSTERESIS && level < current + 1 + LEVEL_HYSTERESIS) {
+                levels[c] = current;
+            } else {
+                levels[c] = std::min(static_cast<int>(level), coarsest);
+            }
+        }
+        fitBudget(levels, distances);
+
+        if (levels == levels_) {
+            return false;
+        }
+        levels_ = std::move(levels);
+        resident_ = selectionSize(levels_);
+        return true;
+    }
+
+    std::unique_ptr<SplatData> LodStreamer::assemble() const {
+        std::vector<loader::SplatLodFile::BlockRef> blocks;
+        blocks.reserve(levels_.size());
+        for (uint32_t c = 0; c < levels_.size(); ++c) {
+            if (levels_[c] >= 0) {
+                blocks.push_back({c, static_cast<uint32_t>(levels_[c])});
+            }
+        }
+        file_->prefetch(blocks);
+        return std::make_unique<SplatData>(file_->load(blocks, torch::kCUDA));
+    }
+
+} // namespace gs
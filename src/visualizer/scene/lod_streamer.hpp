@@ -0,0 +1,63 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/splat_data.hpp"
+#include "loader/formats/splat_lod.hpp"
+#include <expected>
+#include <filesystem>
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gs {
+
+    // Keeps a .lfslod file mapped and picks one level per chunk from the camera distance, so only
+    // the chunks near the camera are resident at full resolution. The selection stays within a
+    // Gaussian budget taken from the free VRAM when the file is opened: far chunks are coarsened
+    // first and dropped once even their coarsest level does not fit.
+    class LodStreamer {
+    public:
+        struct Options {
+            float vram_fraction = 0.4f; // Of the free VRAM at open time, bounds the resident Gaussians
+            float lod_distance = 1.0f;  // Level l is used from (2^l - 1) * lod_distance chunk radii away
+        };
+
+        static bool isLodFile(const std::filesystem::path& path);
+
+        static std::expected<std::unique_ptr<LodStreamer>, std::string> open(const std::filesystem::path& path,
+                                                                            const Options& options);
+
+        // camera_position in model space. Returns true when the selection changed and the model
+        // has to be assembled again.
+        bool update(const glm::vec3& camera_position);
+
+        // The selected blocks as one model on the GPU
+        std::unique_ptr<SplatData> assemble() const;
+
+        size_t residentGaussians() const { return resident_; }
+        size_t gaussianBudget() const { return budget_; }
+
+    private:
+        struct Chunk {
+            glm::vec3 center;
+            float radius;
+        };
+
+        LodStreamer() = default;
+
+        size_t selectionSize(const std::vector<int>& levels) const;
+        void fitBudget(std::vector<int>& levels, const std::vector<float>& distances) const;
+
+        std::unique_ptr<loader::SplatLodFile> file_;
+        Options options_;
+        std::vector<Chunk> chunks_;
+        std::vector<int> levels_; // Per chunk, -1 when not resident
+        size_t resident_ = 0;
+        size_t budget_ = 0;
+    };
+
+} // namespace gs
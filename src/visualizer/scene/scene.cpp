@@ -4,8 +4,10 @@
 
 #include "scene/scene.hpp"
 #include "core/logger.hpp"
+#include "core/row_storage.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <print>
 #include <ranges>
 #include <torch/torch.h>
@@ -24,6 +26,7 @@ namespace gs {
             // Replace existing
             it->model = std::move(model);
             it->gaussian_count = gaussian_count;
+            it->revision = ++last_revision_;
         } else {
             // Add new node
             Node node{
@@ -31,7 +34,8 @@ namespace gs {
                 .model = std::move(model),
                 .transform = glm::mat4(1.0f),
                 .visible = true,
-                .gaussian_count = gaussian_count};
+                .gaussian_count = gaussian_count,
+                .revision = ++last_revision_};
             nodes_.push_back(std::move(node));
         }
 
@@ -39,17 +43,62 @@ namespace gs {
         std::println("Scene: Added node '{}' with {} gaussians", name, gaussian_count);
     }
 
-    void Scene::removeNode(const std::string& name) {
+    void Scene::replaceNodeModel(const std::string& name, std::unique_ptr<SplatData> model) {
         auto it = std::find_if(nodes_.begin(), nodes_.end(),
                                [&name](const Node& node) { return node.name == name; });
 
         if (it != nodes_.end()) {
-            nodes_.erase(it);
+            it->gaussian_count = static_cast<size_t>(model->size());
+            it->model = std::move(model);
+            it->revision = ++last_revision_;
+            invalidateCache();
+        }
+    }
+
+    bool Scene::addInstance(const std::string& name, const std::string& source, const glm::mat4& transform) {
+        const Node* source_node = getNode(source);
+        if (!source_node || !source_node->model || getNode(name)) {
+            LOG_WARN("Scene: Cannot add instance '{}' of '{}'", name, source);
+            return false;
+        }
+
+        Node node{
+            .name = name,
+            .model = nullptr,
+            .transform = transform,
+            .instance_of = source,
+            .visible = true,
+            .gaussian_count = source_node->gaussian_count,
+            .revision = ++last_revision_};
+        nodes_.push_back(std::move(node));
+
+        invalidateCache();
+        LOG_INFO("Scene: Added instance '{}' of '{}'", name, source);
+        return true;
+    }
+
+    void Scene::removeNode(const std::string& name) {
+        const auto removed = std::erase_if(nodes_, [&name](const Node& node) {
+            return node.name == name || node.instance_of == name;
+        });
+
+        if (removed > 0) {
             invalidateCache();
             std::println("Scene: Removed node '{}'", name);
         }
     }
 
+    void Scene::setNodeTransform(const std::string& name, const glm::mat4& transform) {
+        auto it = std::find_if(nodes_.begin(), nodes_.end(),
+                               [&name](const Node& node) { return node.name == name; });
+
+        if (it != nodes_.end() && it->transform != transform) {
+            it->transform = transform;
+            // The rows stay as they are, only the scene revision tells the renderer
+            ++last_revision_;
+        }
+    }
+
     void Scene::setNodeVisibility(const std::string& name, bool visible) {
         auto it = std::find_if(nodes_.begin(), nodes_.end(),
                                [&name](const Node& node) { return node.name == name; });
@@ -63,6 +112,8 @@ namespace gs {
     void Scene::clear() {
         nodes_.clear();
         cached_combined_.reset();
+        combined_ranges_.clear();
+        single_visible_ = nullptr;
         cache_valid_ = false;
     }
 
@@ -100,15 +151,43 @@ namespace gs {
 
     const SplatData* Scene::getCombinedModel() const {
         rebuildCacheIfNeeded();
-        return cached_combined_.get();
+        return single_visible_ ? single_visible_ : cached_combined_.get();
+    }
+
+    std::vector<Scene::Placement> Scene::getPlacements() const {
+        const bool placed = std::ranges::any_of(nodes_, [](const Node& node) {
+            return !node.instance_of.empty() || node.transform != glm::mat4(1.0f);
+        });
+        if (!placed) {
+            return {};
+        }
+
+        rebuildCacheIfNeeded();
+        std::vector<Placement> placements;
+        for (const auto& node : nodes_) {
+            const Node* source = node.instance_of.empty() ? &node : getNode(node.instance_of);
+            if (!node.visible || !source || !source->model) {
+                continue;
+            }
+            const SplatData* model = source->model.get();
+            if (single_visible_ == model) {
+                placements.push_back({.first_row = 0, .row_count = model->size(), .transform = node.transform});
+            } else if (auto range = std::ranges::find(combined_ranges_, model, &CombinedRange::model);
+                       range != combined_ranges_.end()) {
+                placements.push_back({.first_row = range->offset, .row_count = range->count, .transform = node.transform});
+            }
+        }
+        return placements;
     }
 
     size_t Scene::getTotalGaussianCount() const {
         size_t total = 0;
         for (const auto& node : nodes_) {
-            if (node.visible) {
-                total += node.gaussian_count;
+            if (!node.visible) {
+                continue;
             }
+            const Node* source = node.instance_of.empty() ? &node : getNode(node.instance_of);
+            total += source ? source->gaussian_count : 0;
         }
         return total;
     }
@@ -142,145 +221,190 @@ namespace gs {
         auto it = std::find_if(nodes_.begin(), nodes_.end(),
                                [&name](const Node& node) { return node.name == name; });
         if (it != nodes_.end()) {
+            // The caller may change the model in place
+            it->revision = ++last_revision_;
             invalidateCache();
             return &(*it);
         }
         return nullptr;
     }
 
+    namespace {
+        // Opacity logit of hidden nodes' rows in the combined model, below the rasterizer's cull threshold
+        constexpr float HIDDEN_OPACITY_LOGIT = -1e4f;
+
+        // Number of shN coefficients of a model, (degree + 1)^2 - 1
+        int64_t shN_coeffs_of(const SplatData& model) {
+            return (model.shN().defined() && model.shN().dim() >= 2) ? model.shN().size(1) : 0;
+        }
+
+        // Copies model into rows [offset, offset + count) of combined, shN zero padded to combined's width
+        void copy_rows(SplatData& combined, const SplatData& model, const int64_t offset, const bool visible) {
+            const auto count = model.size();
+            combined.means().narrow(0, offset, count).copy_(model.means());
+            combined.sh0().narrow(0, offset, count).copy_(model.sh0());
+            combined.scaling_raw().narrow(0, offset, count).copy_(model.scaling_raw());
+            combined.rotation_raw().narrow(0, offset, count).copy_(model.rotation_raw());
+            if (combined.shN().size(1) > 0) {
+                auto shN = combined.shN().narrow(0, offset, count);
+                const auto coeffs = std::min(shN_coeffs_of(model), combined.shN().size(1));
+                if (coeffs < shN.size(1)) {
+                    shN.zero_();
+                }
+                if (coeffs > 0) {
+                    shN.narrow(1, 0, coeffs).copy_(model.shN().narrow(1, 0, coeffs));
+                }
+            }
+            auto opacity = combined.opacity_raw().narrow(0, offset, count);
+            if (visible) {
+                opacity.copy_(model.opacity_raw());
+            } else {
+                opacity.fill_(HIDDEN_OPACITY_LOGIT);
+            }
+        }
+    } // namespace
+
     void Scene::rebuildCacheIfNeeded() const {
         if (cache_valid_)
             return;
 
-        // Collect visible models using ranges
-        auto visible_models = nodes_ | std::views::filter([](const auto& node) {
-                                  return node.visible && node.model;
-                              }) |
-                              std::views::transform([](const auto& node) {
-                                  return node.model.get();
-                              }) |
-                              std::ranges::to<std::vector>();
-
-        if (visible_models.empty()) {
+        struct Target {
+            const SplatData* model;
+            bool visible;
+            uint64_t revision;
+        };
+        // A model's rows are shown while its node or any instance of it is
+        const auto shown = [this](const Node& source) {
+            return std::ranges::any_of(nodes_, [&source](const Node& node) {
+                return node.visible && (&node == &source || node.instance_of == source.name);
+            });
+        };
+        auto targets = nodes_ | std::views::filter([](const auto& node) { return node.model != nullptr; }) |
+                       std::views::transform([&shown](const auto& node) {
+                           return Target{node.model.get(), shown(node), node.revision};
+                       }) |
+                       std::ranges::to<std::vector>();
+        const auto visible_count = std::ranges::count_if(targets, [](const Target& t) { return t.visible; });
+
+        single_visible_ = nullptr;
+        cache_valid_ = true;
+        if (targets.size() <= 1) {
             cached_combined_.reset();
-            cache_valid_ = true;
+            combined_ranges_.clear();
+        }
+        if (visible_count == 0) {
             return;
         }
 
-        // Calculate totals and find max SH degree in one pass
-        struct ModelStats {
-            size_t total_gaussians = 0;
-            int max_sh_degree = 0;
-            float total_scene_scale = 0.0f;
-            bool has_shN = false;
-        };
-
-        auto stats = std::accumulate(
-            visible_models.begin(), visible_models.end(), ModelStats{},
-            [](ModelStats acc, const SplatData* model) {
-                acc.total_gaussians += model->size();
-
-                // Calculate SH degree from the actual shN tensor dimensions
-                // Degree 0: shN is empty or has 0 coefficients
-                // Degree 1: shN has 3 coefficients (for l=1)
-                // Degree 2: shN has 8 coefficients (for l=1,2)
-                // Degree 3: shN has 15 coefficients (for l=1,2,3)
-                int sh_degree = 0;
-                if (model->shN().defined() && model->shN().dim() >= 2 && model->shN().size(1) > 0) {
-                    int shN_coeffs = model->shN().size(1);
-                    // shN contains (degree+1)^2 - 1 coefficients
-                    // Solve: shN_coeffs = (degree+1)^2 - 1
-                    // Therefore: degree = sqrt(shN_coeffs + 1) - 1
-                    sh_degree = static_cast<int>(std::round(std::sqrt(shN_coeffs + 1))) - 1;
-
-                    // Validate the degree is reasonable (0-3)
-                    sh_degree = std::clamp(sh_degree, 0, 3);
-                }
+        // Nothing to combine, copying would only double the VRAM of large (streamed) models
+        if (visible_count == 1) {
+            single_visible_ = std::ranges::find_if(targets, [](const Target& t) { return t.visible; })->model;
+            return;
+        }
 
-                acc.max_sh_degree = std::max(acc.max_sh_degree, sh_degree);
-                acc.total_scene_scale += model->get_scene_scale();
-                acc.has_shN = acc.has_shN || (model->shN().numel() > 0 && model->shN().size(1) > 0);
-                return acc;
-            });
+        torch::NoGradGuard no_grad;
+        int64_t shN_coeffs = 0;
+        float total_scene_scale = 0.0f;
+        for (const auto& target : targets) {
+            shN_coeffs = std::max(shN_coeffs, shN_coeffs_of(*target.model));
+            total_scene_scale += target.model->get_scene_scale();
+        }
 
-        std::println("Scene: Combining {} models, {} gaussians, max SH degree {}",
-                     visible_models.size(), stats.total_gaussians, stats.max_sh_degree);
-
-        // Setup tensor options from first model
-        const auto [device, dtype] = [&] {
-            const auto& first = visible_models[0]->means();
-            return std::pair{first.device(), first.dtype()};
-        }();
-        auto opts = torch::TensorOptions().dtype(dtype).device(device);
-
-        // Calculate SH dimensions based on max degree
-        // Degree 0: sh0=1, shN=0
-        // Degree 1: sh0=1, shN=3
-        // Degree 2: sh0=1, shN=8
-        // Degree 3: sh0=1, shN=15
-        int sh0_coeffs = 1; // Always 1 for l=0
-        int shN_coeffs = (stats.max_sh_degree > 0) ? ((stats.max_sh_degree + 1) * (stats.max_sh_degree + 1) - 1) : 0;
-
-        // Pre-allocate all tensors at once
-        struct CombinedTensors {
-            torch::Tensor means, sh0, shN, opacity, scaling, rotation;
-        } combined{
-            .means = torch::empty({static_cast<int64_t>(stats.total_gaussians), 3}, opts),
-            .sh0 = torch::empty({static_cast<int64_t>(stats.total_gaussians), sh0_coeffs, 3}, opts),
-            .shN = (shN_coeffs > 0) ? torch::zeros({static_cast<int64_t>(stats.total_gaussians), shN_coeffs, 3}, opts) : torch::empty({static_cast<int64_t>(stats.total_gaussians), 0, 3}, opts),
-            .opacity = torch::empty({static_cast<int64_t>(stats.total_gaussians), 1}, opts),
-            .scaling = torch::empty({static_cast<int64_t>(stats.total_gaussians), 3}, opts),
-            .rotation = torch::empty({static_cast<int64_t>(stats.total_gaussians), 4}, opts)};
-
-        // Helper to create a slice for current model
-        auto make_slice = [](size_t start, size_t size) {
-            return torch::indexing::Slice(start, start + size);
-        };
+        // A different SH width changes every row
+        if (cached_combined_ && cached_combined_->shN().size(1) != shN_coeffs) {
+            cached_combined_.reset();
+            combined_ranges_.clear();
+        }
 
-        // Copy data from each model
-        size_t offset = 0;
-        for (const auto* model : visible_models) {
-            const auto size = model->size();
-            const auto slice = make_slice(offset, size);
-
-            // Direct copy for simple tensors
-            combined.means.index({slice}) = model->means();
-            combined.opacity.index({slice}) = model->opacity_raw();
-            combined.scaling.index({slice}) = model->scaling_raw();
-            combined.rotation.index({slice}) = model->rotation_raw();
-
-            // Copy sh0 (always present)
-            combined.sh0.index({slice}) = model->sh0();
-
-            // Copy shN if we have coefficients to copy
-            if (shN_coeffs > 0) {
-                // Check how many coefficients this model has
-                int model_shN_coeffs = (model->shN().defined() && model->shN().dim() >= 2) ? model->shN().size(1) : 0;
-
-                if (model_shN_coeffs > 0) {
-                    // Copy as many coefficients as the model has, up to our max
-                    int coeffs_to_copy = std::min(model_shN_coeffs, shN_coeffs);
-                    combined.shN.index({slice, torch::indexing::Slice(0, coeffs_to_copy)}) =
-                        model->shN().index({torch::indexing::Slice(), torch::indexing::Slice(0, coeffs_to_copy)});
+        // Ranges up to the first added, removed or replaced node are kept, the rest re-appended
+        size_t kept = 0;
+        while (kept < combined_ranges_.size() && kept < targets.size() &&
+               combined_ranges_[kept].model == targets[kept].model &&
+               combined_ranges_[kept].count == targets[kept].model->size()) {
+            ++kept;
+        }
+        combined_ranges_.resize(kept);
+        const int64_t kept_rows = kept > 0 ? combined_ranges_.back().offset + combined_ranges_.back().count : 0;
+
+        // Kept ranges whose model changed at the same size are copied again, the others only
+        // follow visibility
+        size_t rewritten = 0;
+        for (size_t i = 0; i < kept; ++i) {
+            auto& range = combined_ranges_[i];
+            if (range.revision != targets[i].revision) {
+                copy_rows(*cached_combined_, *range.model, range.offset, targets[i].visible);
+                range.revision = targets[i].revision;
+                ++rewritten;
+            } else if (range.visible != targets[i].visible) {
+                auto opacity = cached_combined_->opacity_raw().narrow(0, range.offset, range.count);
+                if (targets[i].visible) {
+                    opacity.copy_(range.model->opacity_raw());
+                } else {
+                    opacity.fill_(HIDDEN_OPACITY_LOGIT);
                 }
-                // If model has fewer coefficients than max, the rest remain zero (already initialized)
             }
+            range.visible = targets[i].visible;
+        }
 
-            offset += size;
+        int64_t total_rows = kept_rows;
+        for (size_t i = kept; i < targets.size(); ++i) {
+            total_rows += targets[i].model->size();
         }
 
-        // Create the combined model
-        cached_combined_ = std::make_unique<SplatData>(
-            stats.max_sh_degree,
-            std::move(combined.means),
-            std::move(combined.sh0),
-            std::move(combined.shN),
-            std::move(combined.scaling),
-            std::move(combined.rotation),
-            std::move(combined.opacity),
-            stats.total_scene_scale / visible_models.size());
+        if (!cached_combined_ || cached_combined_->size() != total_rows || kept < targets.size()) {
+            // Rows past the kept ones are rewritten in place while the allocation lasts, it grows
+            // to half again as many rows as needed like append_rows
+            const auto resize = [&](const torch::Tensor& tensor, std::vector<int64_t> row_shape) {
+                row_shape.insert(row_shape.begin(), int64_t{0});
+                const auto kept_part = tensor.defined() ? tensor.narrow(0, 0, kept_rows)
+                                                        : torch::empty(row_shape, targets[0].model->means().options());
+                const auto storage = row_capacity(kept_part) >= total_rows
+                                         ? kept_part
+                                         : reserve_rows(kept_part, total_rows + total_rows / 2);
+                return rows_view(storage, total_rows);
+            };
+
+            if (!cached_combined_) {
+                cached_combined_ = std::make_unique<SplatData>(
+                    shN_coeffs > 0 ? static_cast<int>(std::lround(std::sqrt(shN_coeffs + 1))) - 1 : 0,
+                    torch::Tensor(), torch::Tensor(), torch::Tensor(),
+                    torch::Tensor(), torch::Tensor(), torch::Tensor(), 0.0f);
+            }
+            auto& combined = *cached_combined_;
+            combined.means() = resize(combined.means(), {3});
+            combined.sh0() = resize(combined.sh0(), {1, 3});
+            combined.shN() = resize(combined.shN(), {shN_coeffs, 3});
+            combined.scaling_raw() = resize(combined.scaling_raw(), {3});
+            combined.rotation_raw() = resize(combined.rotation_raw(), {4});
+            combined.opacity_raw() = resize(combined.opacity_raw(), {1});
+
+            int64_t offset = kept_rows;
+            for (size_t i = kept; i < targets.size(); ++i) {
+                const auto& model = *targets[i].model;
+                copy_rows(combined, model, offset, targets[i].visible);
+                combined_ranges_.push_back({.model = &model,
+                                            .offset = offset,
+                                            .count = model.size(),
+                                            .visible = targets[i].visible,
+                                            .revision = targets[i].revision});
+                offset += model.size();
+                ++rewritten;
+            }
+        }
 
-        cache_valid_ = true;
+        LOG_DEBUG("Scene: Combined {} models ({} visible), {} gaussians, {} ranges rewritten",
+                  targets.size(), visible_count, cached_combined_->size(), rewritten);
+
+        // SplatData has no scale setter, the tensors move into a new model when the mean scale changed
+        const float scene_scale = total_scene_scale / static_cast<float>(targets.size());
+        if (cached_combined_->get_scene_scale() != scene_scale) {
+            auto& combined = *cached_combined_;
+            cached_combined_ = std::make_unique<SplatData>(
+                combined.get_max_sh_degree(),
+                std::move(combined.means()), std::move(combined.sh0()), std::move(combined.shN()),
+                std::move(combined.scaling_raw()), std::move(combined.rotation_raw()), std::move(combined.opacity_raw()),
+                scene_scale);
+        }
     }
 
     bool Scene::renameNode(const std::string& old_name, const std::string& new_name) {
@@ -309,6 +433,11 @@ namespace gs {
         if (it != nodes_.end()) {
             std::string prev_name = it->name;
             it->name = new_name;
+            for (auto& node : nodes_) {
+                if (node.instance_of == prev_name) {
+                    node.instance_of = new_name;
+                }
+            }
             invalidateCache();
             LOG_INFO("Scene: Renamed node '{}' to '{}'", prev_name, new_name);
             return true;
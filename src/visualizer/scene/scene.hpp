@@ -5,6 +5,7 @@
 #pragma once
 
 #include "core/splat_data.hpp"
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <memory>
 #include <string>
@@ -17,10 +18,19 @@ namespace gs {
     public:
         struct Node {
             std::string name;
-            std::unique_ptr<SplatData> model;
-            glm::mat4 transform{1.0f};
+            std::unique_ptr<SplatData> model; // Null for an instance
+            glm::mat4 transform{1.0f};         // World from model, only the fastgs RGB path draws it
+            std::string instance_of;           // Node whose model an instance draws at its own transform
             bool visible = true;
             size_t gaussian_count = 0;
+            uint64_t revision = 0; // Changes whenever the model may have, unique within the scene
+        };
+
+        // Rows of the combined model drawn at a transform, see getPlacements
+        struct Placement {
+            int64_t first_row = 0;
+            int64_t row_count = 0;
+            glm::mat4 transform{1.0f};
         };
 
         Scene() = default;
@@ -36,7 +46,14 @@ namespace gs {
 
         // Node management
         void addNode(const std::string& name, std::unique_ptr<SplatData> model);
+        // Swaps the model of an existing node, keeping its name, transform and visibility
+        void replaceNodeModel(const std::string& name, std::unique_ptr<SplatData> model);
+        // Draws the model of source again at transform without copying it. False when the name is
+        // taken or source has no model of its own.
+        bool addInstance(const std::string& name, const std::string& source, const glm::mat4& transform);
+        // Removes the instances of the node too
         void removeNode(const std::string& name);
+        void setNodeTransform(const std::string& name, const glm::mat4& transform);
         void setNodeVisibility(const std::string& name, bool visible);
         bool renameNode(const std::string& old_name, const std::string& new_name);
         void clear();
@@ -44,6 +61,9 @@ namespace gs {
 
         // Get combined model for rendering
         const SplatData* getCombinedModel() const;
+        // Rows of getCombinedModel() each visible node draws and where, empty while no node has an
+        // instance or a transform, the combined model is then drawn as is
+        std::vector<Placement> getPlacements() const;
 
         // Direct queries
         size_t getNodeCount() const { return nodes_.size(); }
@@ -52,15 +72,32 @@ namespace gs {
         const Node* getNode(const std::string& name) const;
         Node* getMutableNode(const std::string& name);
         bool hasNodes() const { return !nodes_.empty(); }
+        // Changes whenever a node's model may have, e.g. on a streamed LOD swap
+        uint64_t getRevision() const { return last_revision_; }
 
         // Get visible nodes for split view
         std::vector<const Node*> getVisibleNodes() const;
 
     private:
         std::vector<Node> nodes_;
+        uint64_t last_revision_ = 0;
+
+        // A node's rows in cached_combined_ and what they were copied from
+        struct CombinedRange {
+            const SplatData* model;
+            int64_t offset;
+            int64_t count;
+            bool visible;
+            uint64_t revision;
+        };
 
-        // Caching for combined model
+        // Caching for combined model, a single visible model is used as is. The combined model
+        // holds every node with a model, hidden or not; the rasterizer culls the hidden ones by
+        // their masked opacities. A rebuild only rewrites the ranges that changed: a toggle
+        // touches one node's opacities, adding a node appends its rows.
         mutable std::unique_ptr<SplatData> cached_combined_;
+        mutable std::vector<CombinedRange> combined_ranges_;
+        mutable const SplatData* single_visible_ = nullptr;
         mutable bool cache_valid_ = false;
 
         void invalidateCache() { cache_valid_ = false; }
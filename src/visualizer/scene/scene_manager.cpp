@@ -8,11 +8,13 @@
 #include "rendering/rendering_manager.hpp"
 #include "training/training_manager.hpp"
 #include "training_setup.hpp"
+#include <chrono>
 #include <stdexcept>
 
 namespace gs {
 
-    SceneManager::SceneManager() {
+    SceneManager::SceneManager()
+        : loader_(gs::loader::Loader::create()) {
         setupEventHandlers();
         LOG_DEBUG("SceneManager initialized");
     }
@@ -39,6 +41,10 @@ namespace gs {
             clear();
         });
 
+        cmd::CancelSplatFilesLoad::when([this](const auto&) {
+            cancelLoads();
+        });
+
         // Handle PLY cycling with proper event emission for UI updates
         cmd::CyclePLY::when([this](const auto&) {
             // Check if rendering manager has split view enabled (in PLY comparison mode)
@@ -96,34 +102,13 @@ namespace gs {
             // Clear existing scene
             clear();
 
-            // Load the file
-            LOG_DEBUG("Creating loader for splat file");
-            auto loader = gs::loader::Loader::create();
-            gs::loader::LoadOptions options{
-                .resize_factor = -1,
-                .max_width = 3840,
-                .images_folder = "images",
-                .validate_only = false};
-
-            LOG_TRACE("Loading splat file with loader");
-            auto load_result = loader->load(path, options);
-            if (!load_result) {
-                LOG_ERROR("Failed to load splat file: {}", load_result.error());
-                throw std::runtime_error(load_result.error());
-            }
-
-            auto* splat_data = std::get_if<std::shared_ptr<gs::SplatData>>(&load_result->data);
-            if (!splat_data || !*splat_data) {
-                LOG_ERROR("Expected splat file but got different data type from: {}", path.string());
-                throw std::runtime_error("Expected splat file but got different data type");
-            }
-
             // Add to scene
             std::string name = path.stem().string();
-            size_t gaussian_count = (*splat_data)->size();
+            auto model = loadSplatModel(path, name);
+            size_t gaussian_count = model->size();
             LOG_DEBUG("Adding '{}' to scene with {} gaussians", name, gaussian_count);
 
-            scene_.addNode(name, std::make_unique<SplatData>(std::move(**splat_data)));
+            scene_.addNode(name, std::move(model));
 
             // Update content state
             {
@@ -177,70 +162,214 @@ namespace gs {
 
             LOG_INFO("Adding splat file to scene: {}", path.string());
 
-            // Load the file
-            auto loader = gs::loader::Loader::create();
-            gs::loader::LoadOptions options{
-                .resize_factor = -1,
-                .max_width = 3840,
-                .images_folder = "images",
-                .validate_only = false};
-
-            LOG_TRACE("Loading splat data");
-            auto load_result = loader->load(path, options);
-            if (!load_result) {
-                LOG_ERROR("Failed to load splat file: {}", load_result.error());
-                throw std::runtime_error(load_result.error());
-            }
+            const std::string name = uniqueNodeName(path, name_hint);
+            addSplatNode(name, path, loadSplatModel(path, name), is_visible);
 
-            auto* splat_data = std::get_if<std::shared_ptr<gs::SplatData>>(&load_result->data);
-            if (!splat_data || !*splat_data) {
-                LOG_ERROR("Expected splat file from: {}", path.string());
-                throw std::runtime_error("Expected splat file");
-            }
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to add splat file: {} (path: {})", e.what(), path.string());
+            throw;
+        }
+    }
+
+    std::string SceneManager::uniqueNodeName(const std::filesystem::path& path, const std::string& name_hint) const {
+        const std::string base_name = name_hint.empty() ? path.stem().string() : name_hint;
+        std::string name = base_name;
+        int counter = 1;
+
+        while (scene_.getNode(name) != nullptr) {
+            name = std::format("{}_{}", base_name, counter++);
+            LOG_TRACE("Name '{}' already exists, trying '{}'", base_name, name);
+        }
+        return name;
+    }
+
+    void SceneManager::addSplatNode(const std::string& name, const std::filesystem::path& path,
+                                    std::unique_ptr<SplatData> model, bool is_visible) {
+        size_t gaussian_count = model->size();
+        LOG_DEBUG("Adding node '{}' with {} gaussians", name, gaussian_count);
+
+        scene_.addNode(name, std::move(model));
+
+        // Update paths
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            splat_paths_[name] = path;
+        }
+
+        events::state::PLYAdded{
+            .name = name,
+            .node_gaussians = gaussian_count,
+            .total_gaussians = scene_.getTotalGaussianCount(),
+            .is_visible = is_visible}
+            .emit();
 
-            // Generate unique name
-            std::string base_name = name_hint.empty() ? path.stem().string() : name_hint;
-            std::string name = base_name;
-            int counter = 1;
+        emitSceneChanged();
+
+        LOG_INFO("Added '{}' to scene ({} gaussians, visible: {})",
+                 name, gaussian_count, is_visible);
+    }
 
-            while (scene_.getNode(name) != nullptr) {
-                name = std::format("{}_{}", base_name, counter++);
-                LOG_TRACE("Name '{}' already exists, trying '{}'", base_name, name);
+    void SceneManager::addSplatFiles(const std::vector<SplatFileRequest>& requests) {
+        if (requests.empty()) {
+            return;
+        }
+
+        const gs::loader::LoadOptions options{
+            .resize_factor = -1,
+            .max_width = 3840,
+            .images_folder = "images",
+            .validate_only = false,
+            .cache = true,
+            .cancel = load_stop_.get_token()};
+
+        for (const auto& request : requests) {
+            ++loads_total_;
+            // LOD files only read their header and coarsest levels here, the rest streams
+            if (LodStreamer::isLodFile(request.path)) {
+                bool success = true;
+                try {
+                    const std::string name = uniqueNodeName(request.path, request.name);
+                    addSplatNode(name, request.path, loadSplatModel(request.path, name), request.is_visible);
+                    setPLYVisibility(name, request.is_visible);
+                } catch (const std::exception& e) {
+                    LOG_ERROR("Failed to add splat file: {} (path: {})", e.what(), request.path.string());
+                    success = false;
+                }
+                ++loads_done_;
+                loads_failed_ += success ? 0 : 1;
+                events::state::SplatFilesLoadProgress{
+                    .path = request.path, .success = success, .done = loads_done_, .total = loads_total_}
+                    .emit();
+                continue;
             }
+            pending_loads_.push_back({request, loader_->loadAsync(request.path, options)});
+        }
+        LOG_INFO("Loading {} splat files in the background", pending_loads_.size());
 
-            size_t gaussian_count = (*splat_data)->size();
-            LOG_DEBUG("Adding node '{}' with {} gaussians", name, gaussian_count);
+        // Nothing queued, the batch is complete already
+        pollLoads();
+    }
 
-            scene_.addNode(name, std::make_unique<SplatData>(std::move(**splat_data)));
+    void SceneManager::pollLoads() {
+        pollDatasetLoad();
 
-            // Update paths
-            {
-                std::lock_guard<std::mutex> lock(state_mutex_);
-                splat_paths_[name] = path;
+        if (loads_total_ == 0) {
+            return;
+        }
+
+        for (auto it = pending_loads_.begin(); it != pending_loads_.end();) {
+            if (it->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++it;
+                continue;
             }
 
-            events::state::PLYAdded{
-                .name = name,
-                .node_gaussians = gaussian_count,
-                .total_gaussians = scene_.getTotalGaussianCount(),
-                .is_visible = is_visible}
+            const auto& request = it->request;
+            bool success = false;
+            auto result = it->result.get();
+            if (!result) {
+                LOG_ERROR("Failed to load splat file: {} (path: {})", result.error(), request.path.string());
+            } else if (auto* splat = std::get_if<std::shared_ptr<SplatData>>(&result->data); !splat || !*splat) {
+                LOG_ERROR("Expected splat file but got different data type from: {}", request.path.string());
+            } else {
+                const std::string name = uniqueNodeName(request.path, request.name);
+                addSplatNode(name, request.path, std::make_unique<SplatData>(std::move(**splat)), request.is_visible);
+                setPLYVisibility(name, request.is_visible);
+                success = true;
+            }
+
+            ++loads_done_;
+            loads_failed_ += success ? 0 : 1;
+            events::state::SplatFilesLoadProgress{
+                .path = request.path, .success = success, .done = loads_done_, .total = loads_total_}
                 .emit();
+            it = pending_loads_.erase(it);
+        }
 
-            emitSceneChanged();
+        if (pending_loads_.empty()) {
+            LOG_INFO("Loaded {} of {} splat files", loads_done_ - loads_failed_, loads_total_);
+            events::state::SplatFilesLoadCompleted{
+                .loaded = loads_done_ - loads_failed_, .failed = loads_failed_, .cancelled = false}
+                .emit();
+            loads_total_ = loads_done_ = loads_failed_ = 0;
+        }
+    }
 
-            LOG_INFO("Added '{}' to scene ({} gaussians, visible: {})",
-                     name, gaussian_count, is_visible);
+    void SceneManager::cancelLoads() {
+        if (pending_loads_.empty()) {
+            return;
+        }
 
-        } catch (const std::exception& e) {
-            LOG_ERROR("Failed to add splat file: {} (path: {})", e.what(), path.string());
-            throw;
+        LOG_INFO("Cancelling {} splat file loads", pending_loads_.size());
+        load_stop_.request_stop();
+        pending_loads_.clear();
+        load_stop_ = std::stop_source();
+
+        events::state::SplatFilesLoadCompleted{
+            .loaded = loads_done_ - loads_failed_, .failed = loads_failed_, .cancelled = true}
+            .emit();
+        loads_total_ = loads_done_ = loads_failed_ = 0;
+    }
+
+    std::unique_ptr<SplatData> SceneManager::loadSplatModel(const std::filesystem::path& path, const std::string& name) {
+        // LOD files are streamed, the node starts at the coarsest levels until the first frame
+        if (LodStreamer::isLodFile(path)) {
+            auto streamer = LodStreamer::open(path, {});
+            if (!streamer) {
+                LOG_ERROR("Failed to open LOD splat file: {}", streamer.error());
+                throw std::runtime_error(streamer.error());
+            }
+            auto model = (*streamer)->assemble();
+            lod_streamers_[name] = std::move(*streamer);
+            return model;
+        }
+
+        gs::loader::LoadOptions options{
+            .resize_factor = -1,
+            .max_width = 3840,
+            .images_folder = "images",
+            .validate_only = false,
+            .cache = true};
+
+        LOG_TRACE("Loading splat file with loader");
+        auto load_result = loader_->load(path, options);
+        if (!load_result) {
+            LOG_ERROR("Failed to load splat file: {}", load_result.error());
+            throw std::runtime_error(load_result.error());
+        }
+
+        auto* splat_data = std::get_if<std::shared_ptr<gs::SplatData>>(&load_result->data);
+        if (!splat_data || !*splat_data) {
+            LOG_ERROR("Expected splat file but got different data type from: {}", path.string());
+            throw std::runtime_error("Expected splat file but got different data type");
+        }
+        return std::make_unique<SplatData>(std::move(**splat_data));
+    }
+
+    void SceneManager::updateStreaming(const glm::vec3& camera_position) {
+        for (const auto& [name, streamer] : lod_streamers_) {
+            const auto* node = scene_.getNode(name);
+            if (node && node->visible && streamer->update(camera_position)) {
+                // Release the old selection first, both would not fit the budget together
+                scene_.getMutableNode(name)->model.reset();
+                scene_.replaceNodeModel(name, streamer->assemble());
+                LOG_TRACE("Streamed '{}': {} resident gaussians", name, streamer->residentGaussians());
+            }
         }
     }
 
     void SceneManager::removePLY(const std::string& name) {
         LOG_DEBUG("Removing '{}' from scene", name);
 
+        // Instances go with their source
+        std::vector<std::string> instances;
+        for (const auto* node : scene_.getNodes()) {
+            if (node->instance_of == name) {
+                instances.push_back(node->name);
+            }
+        }
+
         scene_.removeNode(name);
+        lod_streamers_.erase(name);
         {
             std::lock_guard<std::mutex> lock(state_mutex_);
             splat_paths_.erase(name);
@@ -257,6 +386,9 @@ namespace gs {
             LOG_DEBUG("No nodes remaining, transitioning to empty state");
         }
 
+        for (const auto& instance : instances) {
+            events::state::PLYRemoved{.name = instance}.emit();
+        }
         events::state::PLYRemoved{.name = name}.emit();
         emitSceneChanged();
 
@@ -269,6 +401,30 @@ namespace gs {
         emitSceneChanged();
     }
 
+    std::string SceneManager::addInstance(const std::string& source, const glm::mat4& transform) {
+        std::string name;
+        for (int i = 1; name.empty() || scene_.getNode(name); ++i) {
+            name = std::format("{}_instance_{}", source, i);
+        }
+        if (!scene_.addInstance(name, source, transform)) {
+            return {};
+        }
+
+        events::state::PLYAdded{
+            .name = name,
+            .node_gaussians = scene_.getNode(source)->gaussian_count,
+            .total_gaussians = scene_.getTotalGaussianCount(),
+            .is_visible = true}
+            .emit();
+        emitSceneChanged();
+        return name;
+    }
+
+    void SceneManager::setNodeTransform(const std::string& name, const glm::mat4& transform) {
+        scene_.setNodeTransform(name, transform);
+        emitSceneChanged();
+    }
+
     void SceneManager::loadDataset(const std::filesystem::path& path,
                                    const param::TrainingParameters& params) {
         LOG_TIMER("SceneManager::loadDataset");
@@ -300,15 +456,6 @@ namespace gs {
                 throw std::runtime_error(setup_result.error());
             }
 
-            // Pass trainer to manager
-            if (trainer_manager_) {
-                LOG_DEBUG("Setting trainer in manager");
-                trainer_manager_->setTrainer(std::move(setup_result->trainer));
-            } else {
-                LOG_ERROR("No trainer manager available");
-                throw std::runtime_error("No trainer manager available");
-            }
-
             // Update content state
             {
                 std::lock_guard<std::mutex> lock(state_mutex_);
@@ -316,40 +463,128 @@ namespace gs {
                 dataset_path_ = path;
             }
 
-            // Emit events
-            const size_t num_gaussians = trainer_manager_->getTrainer()
-                                             ->get_strategy()
-                                             .get_model()
-                                             .size();
+            finishDatasetLoad(path, std::move(*setup_result));
 
-            LOG_INFO("Dataset loaded successfully - {} images, {} initial gaussians",
-                     setup_result->dataset->size().value(), num_gaussians);
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to load dataset: {} (path: {})", e.what(), path.string());
+            throw;
+        }
+    }
 
-            events::state::SceneLoaded{
-                .scene = nullptr,
-                .path = path,
-                .type = events::state::SceneLoaded::Type::Dataset,
-                .num_gaussians = num_gaussians}
-                .emit();
+    void SceneManager::loadDatasetAsync(const std::filesystem::path& path,
+                                        const param::TrainingParameters& params) {
+        if (pending_dataset_.valid() && pending_dataset_path_ == path) {
+            LOG_DEBUG("Dataset {} is already loading", path.string());
+            return;
+        }
 
-            events::state::DatasetLoadCompleted{
-                .path = path,
-                .success = true,
-                .error = std::nullopt,
-                .num_images = setup_result->dataset->size().value(),
-                .num_points = num_gaussians}
-                .emit();
+        LOG_INFO("Loading dataset in the background: {}", path.string());
 
-            emitSceneChanged();
+        if (trainer_manager_) {
+            trainer_manager_->clearTrainer();
+        }
+        clear();
+
+        auto dataset_params = params;
+        dataset_params.dataset.data_path = path;
+        cached_params_ = dataset_params;
+
+        // The content type switches now, so splat files added while the setup runs keep theirs
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            content_type_ = ContentType::Dataset;
+            dataset_path_ = path;
+        }
+
+        pending_dataset_path_ = path;
+        pending_dataset_ = std::async(std::launch::async, [dataset_params = std::move(dataset_params)] {
+            return gs::training::setupTraining(dataset_params);
+        });
+
+        events::state::DatasetLoadStarted{.path = path}.emit();
+    }
+
+    void SceneManager::finishDatasetLoad(const std::filesystem::path& path, gs::training::TrainingSetup setup) {
+        // Pass trainer to manager
+        if (trainer_manager_) {
+            LOG_DEBUG("Setting trainer in manager");
+            trainer_manager_->setTrainer(std::move(setup.trainer), std::move(setup.seed));
+        } else {
+            LOG_ERROR("No trainer manager available");
+            throw std::runtime_error("No trainer manager available");
+        }
+
+        // Emit events
+        const size_t num_gaussians = trainer_manager_->getTrainer()
+                                         ->get_strategy()
+                                         .get_model()
+                                         .size();
+
+        LOG_INFO("Dataset loaded successfully - {} images, {} initial gaussians",
+                 setup.dataset->size().value(), num_gaussians);
+
+        events::state::SceneLoaded{
+            .scene = nullptr,
+            .path = path,
+            .type = events::state::SceneLoaded::Type::Dataset,
+            .num_gaussians = num_gaussians}
+            .emit();
+
+        events::state::DatasetLoadCompleted{
+            .path = path,
+            .success = true,
+            .error = std::nullopt,
+            .num_images = setup.dataset->size().value(),
+            .num_points = num_gaussians}
+            .emit();
 
+        emitSceneChanged();
+    }
+
+    void SceneManager::pollDatasetLoad() {
+        std::erase_if(discarded_datasets_, [](const auto& setup) {
+            return setup.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        });
+
+        if (!pending_dataset_.valid() ||
+            pending_dataset_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+
+        const auto path = std::move(pending_dataset_path_);
+        pending_dataset_path_.clear();
+        try {
+            auto setup = pending_dataset_.get();
+            if (!setup) {
+                throw std::runtime_error(setup.error());
+            }
+            finishDatasetLoad(path, std::move(*setup));
         } catch (const std::exception& e) {
             LOG_ERROR("Failed to load dataset: {} (path: {})", e.what(), path.string());
-            throw;
+            events::state::DatasetLoadCompleted{
+                .path = path,
+                .success = false,
+                .error = e.what(),
+                .num_images = 0,
+                .num_points = 0}
+                .emit();
+        }
+    }
+
+    void SceneManager::dropDatasetLoad() {
+        if (!pending_dataset_.valid()) {
+            return;
         }
+        // The setup cannot be interrupted, it finishes in the background and is discarded
+        LOG_INFO("Discarding the dataset still loading from {}", pending_dataset_path_.string());
+        discarded_datasets_.push_back(std::move(pending_dataset_));
+        pending_dataset_path_.clear();
     }
 
     void SceneManager::clear() {
         LOG_DEBUG("Clearing scene");
+        cancelLoads();
+        dropDatasetLoad();
 
         // Stop training if active
         if (trainer_manager_ && content_type_ == ContentType::Dataset) {
@@ -357,8 +592,10 @@ namespace gs {
             events::cmd::StopTraining{}.emit();
             trainer_manager_->clearTrainer();
         }
+        training_snapshot_.release();
 
         scene_.clear();
+        lod_streamers_.clear();
 
         {
             std::lock_guard<std::mutex> lock(state_mutex_);
@@ -379,6 +616,9 @@ namespace gs {
         if (content_type_ == ContentType::SplatFiles) {
             return scene_.getCombinedModel();
         } else if (content_type_ == ContentType::Dataset) {
+            if (training_snapshot_) {
+                return training_snapshot_.get();
+            }
             if (trainer_manager_ && trainer_manager_->getTrainer()) {
                 return &trainer_manager_->getTrainer()->get_strategy().get_model();
             }
@@ -387,6 +627,43 @@ namespace gs {
         return nullptr;
     }
 
+    std::vector<Scene::Placement> SceneManager::getPlacementsForRendering() const {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+        return content_type_ == ContentType::SplatFiles ? scene_.getPlacements() : std::vector<Scene::Placement>{};
+    }
+
+    void SceneManager::updateTrainingSnapshot() {
+        std::shared_ptr<training::ModelSnapshot> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            if (content_type_ == ContentType::Dataset && trainer_manager_ && trainer_manager_->getTrainer()) {
+                snapshot = trainer_manager_->getTrainer()->get_model_snapshot();
+            }
+        }
+        // Released first: holding both slots would stall the trainer's next publish
+        training_snapshot_.release();
+        if (snapshot) {
+            training_snapshot_ = snapshot->acquire();
+        }
+    }
+
+    uint64_t SceneManager::getModelRevision() const {
+        std::lock_guard<std::mutex> lock(state_mutex_);
+
+        if (content_type_ == ContentType::SplatFiles) {
+            return scene_.getRevision();
+        } else if (content_type_ == ContentType::Dataset) {
+            if (training_snapshot_) {
+                return training_snapshot_.version();
+            }
+            if (trainer_manager_) {
+                return static_cast<uint64_t>(trainer_manager_->getCurrentIteration());
+            }
+        }
+
+        return 0;
+    }
+
     SceneManager::SceneInfo SceneManager::getSceneInfo() const {
         std::lock_guard<std::mutex> lock(state_mutex_);
 
@@ -411,6 +688,8 @@ namespace gs {
                     info.source_type = "SOG";
                 } else if (ext == ".ply") {
                     info.source_type = "PLY";
+                } else if (ext == core::SPLAT_LOD_EXTENSION) {
+                    info.source_type = "LOD";
                 }
             }
             break;
@@ -565,6 +844,10 @@ namespace gs {
         bool success = scene_.renameNode(old_name, new_name);
 
         if (success && old_name != new_name) {
+            if (auto streamer = lod_streamers_.extract(old_name)) {
+                streamer.key() = new_name;
+                lod_streamers_.insert(std::move(streamer));
+            }
             // Update the splat_paths_ map to use the new name
             {
                 std::lock_guard<std::mutex> lock(state_mutex_);
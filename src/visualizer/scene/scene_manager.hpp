@@ -6,10 +6,17 @@
 
 #include "core/events.hpp"
 #include "core/parameters.hpp"
+#include "loader/loader.hpp"
+#include "model_snapshot.hpp"
+#include "scene/lod_streamer.hpp"
 #include "scene/scene.hpp"
+#include "training_setup.hpp"
 #include <filesystem>
+#include <future>
 #include <mutex>
 #include <project/project.hpp>
+#include <stop_token>
+#include <vector>
 
 namespace gs {
 
@@ -102,15 +109,57 @@ namespace gs {
         void loadSplatFile(const std::filesystem::path& path);
         void addSplatFile(const std::filesystem::path& path, const std::string& name = "", bool is_visible = true);
 
+        struct SplatFileRequest {
+            std::filesystem::path path;
+            std::string name; // Hint, the stem when empty
+            bool is_visible = true;
+        };
+
+        // Loads the files concurrently in the background, pollLoads adds each to the scene once it
+        // has loaded, whatever the content type is by then. LOD files open right away.
+        void addSplatFiles(const std::vector<SplatFileRequest>& requests);
+        // Once per frame on the GUI thread, emits SplatFilesLoadProgress per finished file and
+        // hands over the trainer of a dataset loaded with loadDatasetAsync
+        void pollLoads();
+        // Drops the loads still in flight, files already parsing finish and are discarded
+        void cancelLoads();
+        bool isLoading() const { return !pending_loads_.empty() || pending_dataset_.valid(); }
+        // Files loaded again (checkpoints of a project) come from a cache of recent models, on the
+        // device within vram_bytes and in pinned host memory within ram_bytes
+        void setModelCacheBudget(size_t vram_bytes, size_t ram_bytes) { loader_->setCacheBudget(vram_bytes, ram_bytes); }
+
         void removePLY(const std::string& name);
         void setPLYVisibility(const std::string& name, bool visible);
+        // Places the loaded splat source again at transform, sharing its Gaussians. Returns the
+        // name of the new node, empty when source can't be instanced.
+        std::string addInstance(const std::string& source, const glm::mat4& transform);
+        void setNodeTransform(const std::string& name, const glm::mat4& transform);
 
         void loadDataset(const std::filesystem::path& path,
                          const param::TrainingParameters& params);
+        // Sets up training on a background thread, the content type switches to Dataset right
+        // away and pollLoads passes the trainer on once it is ready. Loading the path already
+        // loading is a no-op.
+        void loadDatasetAsync(const std::filesystem::path& path,
+                              const param::TrainingParameters& params);
         void clear();
 
         // For rendering - gets appropriate model
         const SplatData* getModelForRendering() const;
+        // Rows of that model drawn at the node transforms, empty to draw it as is
+        std::vector<Scene::Placement> getPlacementsForRendering() const;
+
+        // Picks the resident chunks of streamed LOD files for a camera at camera_position (model
+        // space), call before getModelForRendering
+        void updateStreaming(const glm::vec3& camera_position);
+
+        // Leases the trainer's newest model snapshot for this frame, releasing the previous one,
+        // call once per frame before getModelForRendering
+        void updateTrainingSnapshot();
+
+        // Changes whenever the model getModelForRendering returns may have, including edits that
+        // come without an event (streamed LOD swaps, training steps)
+        uint64_t getModelRevision() const;
 
         // Direct info queries
         struct SceneInfo {
@@ -132,6 +181,15 @@ namespace gs {
 
     private:
         void setupEventHandlers();
+        // Loads path through the loader, or opens it as a LOD stream registered under name
+        std::unique_ptr<SplatData> loadSplatModel(const std::filesystem::path& path, const std::string& name);
+        std::string uniqueNodeName(const std::filesystem::path& path, const std::string& name_hint) const;
+        void addSplatNode(const std::string& name, const std::filesystem::path& path,
+                          std::unique_ptr<SplatData> model, bool is_visible);
+        // Hands the trainer over and emits the loaded events, the content type is already set
+        void finishDatasetLoad(const std::filesystem::path& path, gs::training::TrainingSetup setup);
+        void pollDatasetLoad();
+        void dropDatasetLoad();
         void emitSceneChanged();
         void handleCropActivePly(const gs::geometry::BoundingBox& crop_box);
         void handleRenamePly(const events::cmd::RenamePLY& event);
@@ -142,10 +200,31 @@ namespace gs {
         ContentType content_type_ = ContentType::Empty;
         // splat name to splat path
         std::map<std::string, std::filesystem::path> splat_paths_;
+        // splat name to the stream of a LOD file
+        std::map<std::string, std::unique_ptr<LodStreamer>> lod_streamers_;
         std::filesystem::path dataset_path_;
 
+        // One loader for the scene's lifetime, its cache serves files loaded again (project reloads)
+        std::unique_ptr<loader::Loader> loader_;
+        struct PendingLoad {
+            SplatFileRequest request;
+            std::future<std::expected<loader::LoadResult, std::string>> result;
+        };
+        std::vector<PendingLoad> pending_loads_;
+        std::stop_source load_stop_;
+        size_t loads_total_ = 0;
+        size_t loads_done_ = 0;
+        size_t loads_failed_ = 0;
+
+        using DatasetSetup = std::future<std::expected<gs::training::TrainingSetup, std::string>>;
+        DatasetSetup pending_dataset_;
+        std::filesystem::path pending_dataset_path_;
+        // Setups dropped by clear() while running, an async future would block on destruction
+        std::vector<DatasetSetup> discarded_datasets_;
+
         // Training support
         TrainerManager* trainer_manager_ = nullptr;
+        training::ModelSnapshot::Lease training_snapshot_; // Rendered in place of the live model while held
 
         // Rendering support
         visualizer::RenderingManager* rendering_manager_ = nullptr;
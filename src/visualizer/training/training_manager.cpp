@@ -5,7 +5,7 @@
 #include "training/training_manager.hpp"
 #include "core/logger.hpp"
 #include "training/training_setup.hpp"
-#include <c10/cuda/CUDACachingAllocator.h>
+#include "training/vram_manager.hpp"
 #include <stdexcept>
 
 namespace gs {
@@ -24,7 +24,7 @@ namespace gs {
         }
     }
 
-    void TrainerManager::setTrainer(std::unique_ptr<gs::training::Trainer> trainer) {
+    void TrainerManager::setTrainer(std::unique_ptr<gs::training::Trainer> trainer, gs::training::ModelSeed seed) {
         LOG_TIMER_TRACE("TrainerManager::setTrainer");
 
         // Clear any existing trainer first
@@ -33,6 +33,7 @@ namespace gs {
         if (trainer) {
             LOG_DEBUG("Setting new trainer");
             trainer_ = std::move(trainer);
+            model_seed_ = std::move(seed);
             trainer_->setProject(project_);
 
             if (project_) {
@@ -86,6 +87,7 @@ namespace gs {
 
         // Now safe to clear the trainer
         trainer_.reset();
+        model_seed_ = {};
         last_error_.clear();
         setState(State::Idle);
 
@@ -103,14 +105,8 @@ namespace gs {
             return std::unexpected("No project available");
         }
 
-        // Create training parameters from project
-        param::TrainingParameters params;
-        params.dataset = project_->getProjectData().data_set_info;
-        params.optimization = project_->getOptimizationParams();
-        params.dataset.output_path = project_->getProjectOutputFolder();
-
         // Initialize trainer
-        auto init_result = trainer_->initialize(params);
+        auto init_result = trainer_->initialize(nextTrainingParams());
         if (!init_result) {
             return std::unexpected(init_result.error());
         }
@@ -118,6 +114,19 @@ namespace gs {
         return true;
     }
 
+    param::TrainingParameters TrainerManager::nextTrainingParams() const {
+        if (!project_) {
+            return trainer_->getParams();
+        }
+
+        // Create training parameters from project
+        param::TrainingParameters params;
+        params.dataset = project_->getProjectData().data_set_info;
+        params.optimization = project_->getOptimizationParams();
+        params.dataset.output_path = project_->getProjectOutputFolder();
+        return params;
+    }
+
     bool TrainerManager::startTraining() {
         LOG_TIMER("TrainerManager::startTraining");
 
@@ -251,30 +260,13 @@ namespace gs {
         }
 
         if (trainer_->isInitialized()) {
-            LOG_DEBUG("Clearing GPU memory from previous training");
-
-            // Save params before destroying
-            auto params = trainer_->getParams();
-
-            // Destroy the trainer to release all tensors
-            trainer_.reset();
-
-            // Force PyTorch to release cached memory back to system
-            c10::cuda::CUDACachingAllocator::emptyCache();
-            cudaDeviceSynchronize();
-
-            LOG_DEBUG("GPU memory cache cleared");
-
-            // Recreate trainer
-            auto setup_result = gs::training::setupTraining(params);
-            if (setup_result) {
-                trainer_ = std::move(setup_result->trainer);
-                trainer_->setProject(project_);
-                if (project_) {
-                    trainer_->load_cameras_info();
-                }
-            } else {
-                LOG_ERROR("Failed to recreate trainer after reset: {}", setup_result.error());
+            auto result = warmReset();
+            if (!result) {
+                LOG_DEBUG("Warm reset not possible: {}", result.error());
+                result = fullReset();
+            }
+            if (!result) {
+                LOG_ERROR("Failed to recreate trainer after reset: {}", result.error());
                 setState(State::Error);
                 return false;
             }
@@ -286,10 +278,61 @@ namespace gs {
         // Set to Ready state
         setState(State::Ready);
 
-        LOG_INFO("Training reset complete - GPU memory freed, ready to start with current parameters");
+        LOG_INFO("Training reset complete - ready to start with current parameters");
         return true;
     }
 
+    std::expected<void, std::string> TrainerManager::warmReset() {
+        if (model_seed_.empty() && !trainer_->getParams().init_ply) {
+            return std::unexpected("no initial point cloud kept");
+        }
+
+        // The dataset stays loaded, which only holds while it is the same one
+        const auto params = nextTrainingParams();
+        const auto& loaded = trainer_->getParams().dataset;
+        if (params.dataset.data_path != loaded.data_path || params.dataset.images != loaded.images ||
+            params.dataset.undistort != loaded.undistort) {
+            return std::unexpected("dataset parameters changed");
+        }
+
+        auto strategy = gs::training::createStrategy(params, model_seed_);
+        if (!strategy) {
+            return std::unexpected(strategy.error());
+        }
+        trainer_->reset_model(std::move(*strategy));
+        LOG_DEBUG("Model reinitialized, dataset and buffers kept");
+        return {};
+    }
+
+    std::expected<void, std::string> TrainerManager::fullReset() {
+        LOG_DEBUG("Clearing GPU memory from previous training");
+
+        // Save params before destroying
+        auto params = trainer_->getParams();
+
+        // Destroy the trainer to release all tensors
+        trainer_.reset();
+        model_seed_ = {};
+
+        // Force PyTorch to release cached memory back to system
+        gs::training::VramManager::get().release_cached();
+
+        LOG_DEBUG("GPU memory cache cleared");
+
+        // Recreate trainer
+        auto setup_result = gs::training::setupTraining(params);
+        if (!setup_result) {
+            return std::unexpected(setup_result.error());
+        }
+        trainer_ = std::move(setup_result->trainer);
+        model_seed_ = std::move(setup_result->seed);
+        trainer_->setProject(project_);
+        if (project_) {
+            trainer_->load_cameras_info();
+        }
+        return {};
+    }
+
     void TrainerManager::waitForCompletion() {
         if (!training_thread_ || !training_thread_->joinable()) {
             return;
@@ -326,6 +369,12 @@ namespace gs {
         return static_cast<int>(trainer_->get_strategy().get_model().size());
     }
 
+    gs::training::Trainer::PerfStats TrainerManager::getPerfStats() const {
+        if (!trainer_)
+            return {};
+        return trainer_->get_perf_stats();
+    }
+
     void TrainerManager::updateLoss(float loss) {
         std::lock_guard<std::mutex> lock(loss_buffer_mutex_);
         loss_buffer_.push_back(loss);
@@ -419,8 +468,8 @@ namespace gs {
     void TrainerManager::setupEventHandlers() {
         using namespace events;
 
-        // Listen for training progress events - only update loss buffer
-        state::TrainingProgress::when([this](const auto& event) {
+        // Listen for training progress events - only update loss buffer, on the GUI thread
+        state::TrainingProgress::when_queued([this](const auto& event) {
             updateLoss(event.loss);
         });
     }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "trainer.hpp"
+#include "training_setup.hpp"
 #include <atomic>
 #include <deque>
 #include <memory>
@@ -42,8 +43,9 @@ namespace gs {
         TrainerManager(TrainerManager&&) = default;
         TrainerManager& operator=(TrainerManager&&) = default;
 
-        // Setup and teardown
-        void setTrainer(std::unique_ptr<gs::training::Trainer> trainer);
+        // Setup and teardown. With the seed of its initial model a reset rebuilds the model in place
+        // instead of loading the dataset again.
+        void setTrainer(std::unique_ptr<gs::training::Trainer> trainer, gs::training::ModelSeed seed = {});
         void clearTrainer();
         bool hasTrainer() const;
 
@@ -80,6 +82,8 @@ namespace gs {
         float getCurrentLoss() const;
         int getTotalIterations() const;
         int getNumSplats() const;
+        // Refreshed by the training thread every few steps
+        gs::training::Trainer::PerfStats getPerfStats() const;
 
         // Loss buffer management (this needs to be stored)
         std::deque<float> getLossBuffer() const;
@@ -107,6 +111,14 @@ namespace gs {
         // Helper method to avoid duplicated initialization logic
         std::expected<bool, std::string> initializeTrainerFromProject();
 
+        // Parameters of the next initialization: the project's when there is one, the trainer's otherwise
+        param::TrainingParameters nextTrainingParams() const;
+
+        // Reset keeping the trainer, its dataset, preloaded images and rasterizer buffers
+        std::expected<void, std::string> warmReset();
+        // Reset through a new trainer from setupTraining, reloading the dataset
+        std::expected<void, std::string> fullReset();
+
         // Training thread function
         void trainingThreadFunc(std::stop_token stop_token);
 
@@ -117,6 +129,7 @@ namespace gs {
 
         // Member variables
         std::unique_ptr<gs::training::Trainer> trainer_;
+        gs::training::ModelSeed model_seed_; // Initial model of trainer_, empty: resets reload the dataset
         std::unique_ptr<std::jthread> training_thread_;
         visualizer::VisualizerImpl* viewer_ = nullptr;
 
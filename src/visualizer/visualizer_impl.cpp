@@ -7,6 +7,7 @@
 #include "core/logger.hpp"
 #include "scene/scene_manager.hpp"
 #include "tools/translation_gizmo_tool.hpp"
+#include <cuda_runtime.h>
 #include <stdexcept>
 #ifdef WIN32
 #include <windows.h>
@@ -21,6 +22,14 @@ namespace gs::visualizer {
 
         LOG_DEBUG("Creating visualizer with window size {}x{}", options.width, options.height);
 
+        // Creating the CUDA context takes a while, it overlaps the window, OpenGL and ImGui
+        // setup and the first loads, all of which share it
+        cuda_context_ = std::async(std::launch::async, [] {
+            if (const cudaError_t err = cudaFree(nullptr); err != cudaSuccess) {
+                LOG_WARN("Failed to create the CUDA context early: {}", cudaGetErrorString(err));
+            }
+        });
+
         // Create scene manager - it creates its own Scene internally
         scene_manager_ = std::make_unique<SceneManager>();
 
@@ -57,6 +66,8 @@ namespace gs::visualizer {
 
     VisualizerImpl::~VisualizerImpl() {
         trainer_manager_.reset();
+        // Training has stopped, what it queued is delivered while the handlers' objects still exist
+        event::bus().release_dispatch_thread();
         translation_gizmo_tool_.reset();
         tool_context_.reset();
         if (gui_manager_) {
@@ -174,7 +185,7 @@ namespace gs::visualizer {
         });
 
         // Training progress - don't mark dirty, let throttling handle it
-        state::TrainingProgress::when([this]([[maybe_unused]] const auto& event) {
+        state::TrainingProgress::when_queued([this]([[maybe_unused]] const auto& event) {
             // Just update loss buffer, don't force render
             // The 1 FPS throttle will handle rendering
         });
@@ -185,7 +196,8 @@ namespace gs::visualizer {
         });
 
         // Listen to TrainingCompleted
-        events::state::TrainingCompleted::when([this](const auto& event) {
+        // Emitted by the training thread, the project reload belongs on this one
+        events::state::TrainingCompleted::when_queued([this](const auto& event) {
             handleTrainingCompleted(event);
         });
 
@@ -215,6 +227,9 @@ namespace gs::visualizer {
             }
             window_initialized_ = true;
 
+            // Queued event handlers run on the thread that owns the window
+            event::bus().set_dispatch_thread();
+
             // CRITICAL: Poll events once to get actual window dimensions from the OS
             window_manager_->pollEvents();
             window_manager_->updateWindowSize();
@@ -252,6 +267,10 @@ namespace gs::visualizer {
 
         // Initialize rendering with proper viewport dimensions
         if (!rendering_manager_->isInitialized()) {
+            // The engine creates its CUDA stream and interop buffers right away
+            if (cuda_context_.valid()) {
+                cuda_context_.get();
+            }
             // Pass viewport dimensions to rendering manager
             rendering_manager_->setInitialViewportSize(viewport_.windowSize);
             rendering_manager_->initialize();
@@ -267,6 +286,12 @@ namespace gs::visualizer {
     }
 
     void VisualizerImpl::update() {
+        // Training events for queued handlers arrive here, outside of any training step
+        event::bus().dispatch_queued();
+
+        // Splat files finished loading in the background join the scene
+        scene_manager_->pollLoads();
+
         window_manager_->updateWindowSize();
 
         // Update the main viewport with window size
@@ -335,7 +360,27 @@ namespace gs::visualizer {
         gui_manager_->render();
 
         window_manager_->swapBuffers();
-        window_manager_->pollEvents();
+        waitOrPollEvents();
+    }
+
+    void VisualizerImpl::waitOrPollEvents() {
+        // Hover states, popups and layout changes show up over the frames after an event
+        constexpr int FRAMES_AFTER_EVENT = 3;
+
+        const auto& framerate = rendering_manager_->getFramerateSettings();
+        if (!framerate.idle_wait || active_frames_ > 0 || rendering_manager_->hasPendingWork()) {
+            active_frames_ = std::max(active_frames_ - 1, 0);
+            window_manager_->pollEvents();
+            return;
+        }
+
+        // Input and requestRedraw() wake the wait, training progress and background work are picked
+        // up by the timeout
+        const bool training = trainer_manager_ && trainer_manager_->isRunning();
+        const float fps = std::max(training ? framerate.idle_training_fps : framerate.idle_fps, 0.1f);
+        if (window_manager_->waitEvents(1.0 / fps)) {
+            active_frames_ = FRAMES_AFTER_EVENT;
+        }
     }
 
     bool VisualizerImpl::allowclose() {
@@ -403,7 +448,7 @@ namespace gs::visualizer {
                 auto dataset = static_cast<const param::DatasetConfig&>(project_->getProjectData().data_set_info);
                 if (!dataset.data_path.empty()) {
                     LOG_DEBUG("Loading dataset from project: {}", dataset.data_path.string());
-                    auto result = data_loader_->loadDataset(dataset.data_path);
+                    auto result = data_loader_->loadDatasetAsync(dataset.data_path);
                     if (!result) {
                         LOG_ERROR("Failed to load dataset from project: {}", result.error());
                         throw std::runtime_error(std::format("Failed to load dataset from project: {}", result.error()));
@@ -445,23 +490,20 @@ namespace gs::visualizer {
             scene_manager_->changeContentType(SceneManager::ContentType::SplatFiles);
         }
 
-        // set all of the nodes to invisible except the last one
+        // set all of the nodes to invisible except the last one, they load concurrently and
+        // appear as each one finishes
+        std::vector<SceneManager::SplatFileRequest> requests;
         for (auto it = plys.begin(); it != plys.end(); ++it) {
-            std::string ply_name = it->ply_name;
             if (!std::filesystem::exists(it->ply_path)) {
                 LOG_ERROR("ply path not exists {}. skip loading", it->ply_path.string());
                 continue;
             }
             bool is_last = (std::next(it) == plys.end());
 
-            LOG_TRACE("Adding PLY '{}' to scene (visible: {})", ply_name, is_last);
-            try {
-                scene_manager_->addSplatFile(it->ply_path, ply_name, is_last);
-                scene_manager_->setPLYVisibility(ply_name, is_last);
-            } catch (const std::exception& e) {
-                LOG_ERROR("failed loading ply path {}. reason {} ", it->ply_path.string(), e.what());
-            }
+            LOG_TRACE("Adding PLY '{}' to scene (visible: {})", it->ply_name, is_last);
+            requests.push_back({.path = it->ply_path, .name = it->ply_name, .is_visible = is_last});
         }
+        scene_manager_->addSplatFiles(requests);
     }
 
     void VisualizerImpl::run() {
@@ -473,32 +515,25 @@ namespace gs::visualizer {
 
     void VisualizerImpl::setParameters(const param::TrainingParameters& params) {
         data_loader_->setParameters(params);
+        scene_manager_->setModelCacheBudget(static_cast<size_t>(params.model_cache_vram_mb) << 20,
+                                            static_cast<size_t>(params.model_cache_ram_mb) << 20);
+        setTextureCompression(params.compress_textures);
     }
 
     std::expected<void, std::string> VisualizerImpl::loadPLY(const std::filesystem::path& path) {
-        LOG_TIMER("LoadPLY");
-
-        // Ensure full initialization before loading PLY
-        // This will only initialize once due to the guard in initialize()
-        if (!initialize()) {
-            return std::unexpected("Failed to initialize visualizer");
+        // Parsing starts now, before the window exists, and the model joins the scene in the
+        // first update after it has loaded
+        if (!std::filesystem::exists(path)) {
+            return std::unexpected(std::format("File does not exist: {}", path.string()));
         }
-
-        LOG_INFO("Loading PLY file: {}", path.string());
-        return data_loader_->loadPLY(path);
+        data_loader_->loadSplatFileAsync(path);
+        return {};
     }
 
     std::expected<void, std::string> VisualizerImpl::loadDataset(const std::filesystem::path& path) {
-        LOG_TIMER("LoadDataset");
-
-        // Ensure full initialization before loading dataset
-        // This will only initialize once due to the guard in initialize()
-        if (!initialize()) {
-            return std::unexpected("Failed to initialize visualizer");
-        }
-
+        // Training is set up in the background while the window opens, see loadPLY
         LOG_INFO("Loading dataset: {}", path.string());
-        auto result = data_loader_->loadDataset(path);
+        auto result = data_loader_->loadDatasetAsync(path);
         if (result && project_) {
             auto data_config = project_->getProjectData().data_set_info;
             if (data_config.data_path.empty() || data_config.data_path == path) { // empty project or same data
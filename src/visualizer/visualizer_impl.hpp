@@ -17,6 +17,7 @@
 #include "training/training_manager.hpp"
 #include "visualizer/visualizer.hpp"
 #include "window/window_manager.hpp"
+#include <future>
 #include <memory>
 #include <string>
 
@@ -125,9 +126,15 @@ namespace gs::visualizer {
         // Tool initialization
         void initializeTools();
 
+        // Polls events, or waits for them when the next frame would look the same as this one
+        void waitOrPollEvents();
+
         // Options
         ViewerOptions options_;
 
+        // Primary CUDA context creation, started by the constructor
+        std::future<void> cuda_context_;
+
         // Core components
         Viewport viewport_;
         std::unique_ptr<WindowManager> window_manager_;
@@ -145,6 +152,7 @@ namespace gs::visualizer {
         bool window_initialized_ = false;
         bool gui_initialized_ = false;
         bool tools_initialized_ = false; // Added this member!
+        int active_frames_ = 0;          // Frames still drawn without waiting, ImGui settles over a few after input
         // Project
         std::shared_ptr<gs::management::Project> project_ = nullptr;
         void updateProjectOnModules();
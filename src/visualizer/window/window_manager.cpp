@@ -108,6 +108,12 @@ namespace gs {
         glfwPollEvents();
     }
 
+    bool WindowManager::waitEvents(double timeout_sec) {
+        const double start = glfwGetTime();
+        glfwWaitEventsTimeout(timeout_sec);
+        return glfwGetTime() - start < timeout_sec;
+    }
+
     bool WindowManager::shouldClose() const {
         return glfwWindowShouldClose(window_);
     }
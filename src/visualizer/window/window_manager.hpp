@@ -30,6 +30,8 @@ namespace gs {
         void updateWindowSize();
         void swapBuffers();
         void pollEvents();
+        // Sleeps until an event arrives or timeout_sec passes, true when an event woke it
+        bool waitEvents(double timeout_sec);
         bool shouldClose() const;
         void cancelClose();
         void setVSync(bool enabled);
@@ -1,5 +1,9 @@
 #include "Ops.h"
+#include "components/bilateral_grid.hpp"
 #include "core/debug_utils.hpp"
+#include "kernels/fused_ssim.cuh"
+#include "kernels/regularization.cuh"
+#include "kernels/sparsity.cuh"
 #include "rasterization/rasterizer_autograd.hpp"
 #include <cuda_runtime.h>
 #include <gtest/gtest.h>
@@ -453,4 +457,158 @@ TEST_F(AutogradTest, GradientAccumulationTest) {
 
     assertTensorClose(quats.grad(), expected_quats_grad, 1e-5, 1e-5);
     assertTensorClose(scales.grad(), expected_scales_grad, 1e-5, 1e-5);
-}
\ No newline at end of file
+}
+
+TEST_F(AutogradTest, FusedPhotometricLossMatchesUnfused) {
+    torch::manual_seed(42);
+    constexpr int H = 53, W = 71;
+    constexpr float lambda = 0.2f;
+    const auto opts = torch::TensorOptions().dtype(torch::kFloat32).device(device);
+
+    const auto image_data = torch::rand({3, H, W}, opts) * 0.8f;
+    const auto alpha_data = torch::rand({1, H, W}, opts);
+    const auto background = torch::rand({3}, opts);
+    const auto gt = torch::rand({3, H, W}, opts);
+    const auto mask = (torch::rand({1, H, W}, opts) > 0.1f).to(torch::kFloat32);
+
+    // Reference: composite, mask, then torch::l1_loss and fused_ssim
+    auto image_ref = image_data.clone().requires_grad_(true);
+    auto alpha_ref = alpha_data.clone().requires_grad_(true);
+    const auto rendered = (image_ref + (1.0f - alpha_ref) * background.view({3, 1, 1})) * mask;
+    const auto loss_ref = (1.0f - lambda) * torch::l1_loss(rendered, gt * mask) +
+                          lambda * (1.0f - fused_ssim(rendered, gt * mask, "valid", true));
+    loss_ref.backward();
+
+    auto image = image_data.clone().requires_grad_(true);
+    auto alpha = alpha_data.clone().requires_grad_(true);
+    const auto loss = fused_photometric_loss(image, gt, lambda, alpha, background, mask);
+    loss.backward();
+
+    assertTensorClose(loss, loss_ref, 1e-4, 1e-5);
+    assertTensorClose(image.grad(), image_ref.grad(), 1e-3, 1e-6);
+    assertTensorClose(alpha.grad(), alpha_ref.grad(), 1e-3, 1e-6);
+
+    // uint8 ground truth reads as value / 255
+    const auto gt_u8 = (gt * 255.0f).round().to(torch::kUInt8);
+    const auto loss_u8 = fused_photometric_loss(image_data, gt_u8, lambda);
+    const auto loss_float = fused_photometric_loss(image_data, gt_u8.to(torch::kFloat32) / 255.0f, lambda);
+    assertTensorClose(loss_u8, loss_float, 1e-5, 1e-6);
+}
+
+TEST_F(AutogradTest, FusedSSIMValidPaddingMatchesCroppedSameMap) {
+    using torch::indexing::Slice;
+    torch::manual_seed(7);
+    const auto opts = torch::TensorOptions().dtype(torch::kFloat32).device(device);
+    const auto img1_data = torch::rand({1, 3, 37, 45}, opts);
+    const auto img2 = torch::rand({1, 3, 37, 45}, opts);
+
+    auto img1_ref = img1_data.clone().requires_grad_(true);
+    const auto map = fs_internal::_FusedSSIM::apply(img1_ref, img2, std::string("same"), true);
+    const auto ssim_ref = map.index({Slice(), Slice(), Slice(5, -5), Slice(5, -5)}).mean();
+    ssim_ref.backward();
+
+    auto img1 = img1_data.clone().requires_grad_(true);
+    const auto ssim = fused_ssim(img1, img2, "valid", true);
+    ssim.backward();
+
+    assertTensorClose(ssim, ssim_ref, 1e-5, 1e-6);
+    assertTensorClose(img1.grad(), img1_ref.grad(), 1e-4, 1e-7);
+}
+
+TEST_F(AutogradTest, FusedPhotometricLossSlicesBilateralGrid) {
+    torch::manual_seed(11);
+    constexpr int H = 61, W = 83;
+    constexpr float lambda = 0.2f;
+    const auto opts = torch::TensorOptions().dtype(torch::kFloat32).device(device);
+
+    const auto image_data = torch::rand({3, H, W}, opts);
+    const auto alpha_data = torch::rand({1, H, W}, opts);
+    const auto background = torch::rand({3}, opts);
+    const auto gt = torch::rand({3, H, W}, opts);
+    const auto mask = (torch::rand({1, H, W}, opts) > 0.1f).to(torch::kFloat32);
+
+    // Two grids away from identity with identical values
+    gs::training::BilateralGrid grid_ref(1), grid(1);
+    {
+        torch::NoGradGuard no_grad;
+        grid_ref.parameters().add_(0.05f * torch::randn_like(grid_ref.parameters()));
+        grid.parameters().copy_(grid_ref.parameters());
+    }
+
+    auto image_ref = image_data.clone().requires_grad_(true);
+    auto alpha_ref = alpha_data.clone().requires_grad_(true);
+    const auto composite = image_ref + (1.0f - alpha_ref) * background.view({3, 1, 1});
+    const auto rendered = grid_ref.apply(composite, 0) * mask;
+    const auto loss_ref = (1.0f - lambda) * torch::l1_loss(rendered, gt * mask) +
+                          lambda * (1.0f - fused_ssim(rendered, gt * mask, "valid", true));
+    loss_ref.backward();
+
+    auto image = image_data.clone().requires_grad_(true);
+    auto alpha = alpha_data.clone().requires_grad_(true);
+    const auto loss = fused_photometric_loss(image, gt, lambda, alpha, background, mask, grid.grid(0));
+    loss.backward();
+
+    assertTensorClose(loss, loss_ref, 1e-4, 1e-5);
+    assertTensorClose(image.grad(), image_ref.grad(), 1e-3, 1e-6);
+    assertTensorClose(alpha.grad(), alpha_ref.grad(), 1e-3, 1e-6);
+    assertTensorClose(grid.parameters().grad(), grid_ref.parameters().grad(), 1e-3, 1e-6);
+}
+
+TEST_F(AutogradTest, ADMMSparsityUpdateMatchesSortedThreshold) {
+    torch::manual_seed(13);
+    constexpr int64_t N = 10007, n_prune = 6004;
+    constexpr float rho = 0.0005f;
+    const auto opts = torch::TensorOptions().dtype(torch::kFloat32).device(device);
+    const auto opacities = torch::randn({N, 1}, opts) * 3.0f;
+    const auto u_init = 0.1f * torch::randn({N, 1}, opts);
+
+    // Reference: the sort-based proximal step
+    const auto opa = torch::sigmoid(opacities);
+    const auto z_temp = opa + u_init;
+    const auto threshold = std::get<0>(torch::sort(z_temp.flatten()))[n_prune - 1];
+    const auto z_ref = (z_temp > threshold) * z_temp;
+    const auto u_ref = u_init + opa - z_ref;
+
+    auto z = torch::empty_like(opacities);
+    auto u = u_init.clone();
+    gs::sparsity::admm_update_cuda(opacities, z, u, n_prune);
+
+    EXPECT_EQ((z == 0).sum().item<int64_t>(), n_prune);
+    assertTensorClose(z, z_ref, 1e-5, 1e-6);
+    assertTensorClose(u, u_ref, 1e-5, 1e-6);
+
+    auto opacities_ref = opacities.clone().requires_grad_(true);
+    const auto loss_ref = 0.5f * rho * (torch::sigmoid(opacities_ref) - z + u).pow(2).sum();
+    loss_ref.backward();
+
+    const auto loss = gs::sparsity::admm_loss_forward_cuda(opacities, z, u, rho);
+    const auto grad = gs::sparsity::admm_loss_backward_cuda(opacities, z, u, rho, torch::ones({}, opts));
+    assertTensorClose(loss, loss_ref, 1e-4, 1e-7);
+    assertTensorClose(grad, opacities_ref.grad(), 1e-4, 1e-9);
+}
+
+TEST_F(AutogradTest, FusedScaleOpacityRegMatchesAutograd) {
+    torch::manual_seed(17);
+    constexpr int64_t N = 5003;
+    constexpr float scale_weight = 0.01f, opacity_weight = 0.02f;
+    const auto opts = torch::TensorOptions().dtype(torch::kFloat32).device(device);
+    const auto scaling = torch::randn({N, 3}, opts) - 3.0f;
+    const auto opacity = torch::randn({N, 1}, opts);
+    // Gradients the photometric backward already left behind
+    auto scaling_grad = 1e-3f * torch::randn({N, 3}, opts);
+    auto opacity_grad = 1e-3f * torch::randn({N, 1}, opts);
+
+    auto scaling_ref = scaling.clone().requires_grad_(true);
+    auto opacity_ref = opacity.clone().requires_grad_(true);
+    const auto loss_ref = scale_weight * torch::exp(scaling_ref).mean() +
+                          opacity_weight * torch::sigmoid(opacity_ref).squeeze(-1).mean();
+    loss_ref.backward();
+    const auto scaling_grad_ref = scaling_grad + scaling_ref.grad();
+    const auto opacity_grad_ref = opacity_grad + opacity_ref.grad();
+
+    const auto loss = gs::regularization::scale_opacity_reg_cuda(
+        scaling, scaling_grad, scale_weight, opacity, opacity_grad, opacity_weight);
+    assertTensorClose(loss, loss_ref, 1e-4, 1e-7);
+    assertTensorClose(scaling_grad, scaling_grad_ref, 1e-4, 1e-9);
+    assertTensorClose(opacity_grad, opacity_grad_ref, 1e-4, 1e-9);
+}
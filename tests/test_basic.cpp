@@ -1,10 +1,17 @@
 #include "Ops.h"
 #include "core/debug_utils.hpp"
 #include "core/image_io.hpp"
+#include "core/row_storage.hpp"
+#include "core/splat_data.hpp"
+#include "geometry/bounding_box.hpp"
+#include "kernels/knn.cuh"
+#include "loader/loader.hpp"
+#include "optimizers/fused_adam.hpp"
 #include "rasterization/rasterizer.hpp"
 #include <cmath>
 #include <filesystem>
 #include <fstream>
+#include <glm/gtc/matrix_transform.hpp>
 #include <gtest/gtest.h>
 #include <iostream>
 #include <torch/torch.h>
@@ -489,4 +496,194 @@ TEST_F(BasicOpsTest, CameraModelsTest) {
         auto num_visible = visible.sum();
         EXPECT_GT(num_visible.template item<int64_t>(), 0);
     }
-}
\ No newline at end of file
+}
+
+TEST_F(BasicOpsTest, RowStorageTest) {
+    torch::NoGradGuard no_grad;
+    const auto rows = torch::rand({100, 3}, device);
+
+    // Appending within the reserve writes in place
+    auto reserved = gs::reserve_rows(rows, 200);
+    EXPECT_EQ(gs::row_capacity(reserved), 200);
+    assertTensorClose(reserved, rows);
+    const void* data = reserved.data_ptr();
+    const auto extra = torch::rand({50, 3}, device);
+    auto grown = gs::append_rows(reserved, extra);
+    EXPECT_EQ(grown.data_ptr(), data);
+    assertTensorClose(grown, torch::cat({rows, extra}));
+
+    // Compaction keeps the allocation
+    const auto keep = torch::arange(0, 150, 3, torch::TensorOptions().dtype(torch::kLong).device(device));
+    const auto expected = grown.index_select(0, keep);
+    auto kept = gs::keep_rows(grown, keep);
+    EXPECT_EQ(kept.data_ptr(), data);
+    EXPECT_EQ(gs::row_capacity(kept), 200);
+    assertTensorClose(kept, expected);
+
+    // Past the reserve it moves, with headroom for later growth
+    auto moved = gs::append_rows(kept, torch::rand({180, 3}, device));
+    EXPECT_NE(moved.data_ptr(), data);
+    EXPECT_EQ(moved.size(0), 230);
+    EXPECT_GT(gs::row_capacity(moved), 230);
+    assertTensorClose(moved.narrow(0, 0, kept.size(0)), expected);
+}
+
+TEST_F(BasicOpsTest, SplatTransformTest) {
+    torch::manual_seed(42);
+    torch::NoGradGuard no_grad;
+    constexpr int N = 1000;
+    const auto opts = torch::TensorOptions().dtype(torch::kFloat32).device(device);
+
+    auto means = torch::randn({N, 3}, opts);
+    auto sh0 = torch::randn({N, 1, 3}, opts);
+    auto shN = torch::randn({N, 15, 3}, opts);
+    auto scaling = torch::randn({N, 3}, opts);
+    auto rotation = torch::nn::functional::normalize(torch::randn({N, 4}, opts),
+                                                     torch::nn::functional::NormalizeFuncOptions().dim(-1));
+    auto opacity = torch::randn({N, 1}, opts);
+    gs::SplatData splat(3, means.clone(), sh0.clone(), shN.clone(), scaling.clone(), rotation.clone(),
+                        opacity.clone(), 1.0f);
+
+    const glm::mat4 rigid = glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, -2.0f, 0.5f)),
+                                        0.7f, glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f)));
+    const glm::mat4 transform = glm::scale(rigid, glm::vec3(2.0f));
+    splat.transform(transform);
+
+    torch::Tensor matrix = torch::empty({4, 4}, torch::kFloat32);
+    for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            matrix[r][c] = transform[c][r];
+        }
+    }
+    matrix = matrix.to(device);
+    const auto R = matrix.narrow(0, 0, 3).narrow(1, 0, 3) / 2.0f;
+    assertTensorClose(splat.means(), means.matmul(matrix.narrow(0, 0, 3).narrow(1, 0, 3).t()) +
+                                         matrix.narrow(0, 0, 3).select(1, 3));
+    assertTensorClose(splat.scaling_raw(), scaling + std::log(2.0f));
+
+    // Rotations compose: R(q_new) = R(transform) R(q)
+    const auto rotmats = gsplat::quats_to_rotmats(rotation);
+    const auto new_rotmats = gsplat::quats_to_rotmats(splat.get_rotation());
+    assertTensorClose(new_rotmats, R.unsqueeze(0).matmul(rotmats), 1e-3, 1e-3);
+
+    // View-dependent color follows the rotation: c'(d) = c(R^T d)
+    const auto dirs = torch::randn({N, 3}, opts);
+    const auto masks = torch::ones({N}, torch::TensorOptions().dtype(torch::kBool).device(device));
+    const auto colors = gsplat::spherical_harmonics_fwd(3, dirs.matmul(R), torch::cat({sh0, shN}, 1), masks);
+    const auto new_colors = gsplat::spherical_harmonics_fwd(3, dirs, splat.get_shs(), masks);
+    assertTensorClose(new_colors, colors, 1e-3, 1e-3);
+
+    // Cropping to the box [-1, 1]^3 keeps exactly the means inside it
+    gs::geometry::BoundingBox box;
+    box.setBounds(glm::vec3(-1.0f), glm::vec3(1.0f));
+    const auto cropped = splat.crop_by_cropbox(box);
+    const auto inside = (splat.means().abs() <= 1.0f).all(1);
+    assertTensorClose(cropped.means(), splat.means().index({inside}));
+}
+
+TEST_F(BasicOpsTest, MeanNeighborDistancesTest) {
+    torch::manual_seed(42);
+    const auto opts = torch::TensorOptions().dtype(torch::kFloat32).device(device);
+
+    // A dense cluster, a flat sheet, a few outliers far out and a duplicated point
+    auto points = torch::cat({torch::randn({3000, 3}, opts) * 0.1f,
+                              torch::rand({2000, 3}, opts) * torch::tensor({10.0f, 10.0f, 0.0f}, opts),
+                              torch::randn({5, 3}, opts) * 1000.0f});
+    points = torch::cat({points, points.narrow(0, 0, 1)});
+
+    // Brute force: the 3 nearest non-coincident points among the 4 nearest, the point itself included
+    const auto nearest = std::get<0>(torch::cdist(points, points).topk(4, 1, false));
+    const auto valid = nearest.pow(2) > 1e-8f;
+    const auto first3 = valid.to(torch::kInt32).cumsum(1) <= 3;
+    const auto keep = valid.logical_and(first3);
+    const auto counts = keep.sum(1);
+    const auto expected = torch::where(counts > 0, (nearest * keep).sum(1) / counts.clamp_min(1), 0.01f);
+
+    const auto result = gs::mean_neighbor_distances(points);
+    ASSERT_EQ(result.sizes(), expected.sizes());
+    assertTensorClose(result, expected, 1e-3, 1e-4);
+}
+
+TEST_F(BasicOpsTest, PlyRoundTripTest) {
+    torch::manual_seed(42);
+    torch::NoGradGuard no_grad;
+    constexpr int N = 3000;
+    const auto opts = torch::TensorOptions().dtype(torch::kFloat32).device(device);
+
+    auto means = torch::randn({N, 3}, opts);
+    auto sh0 = torch::randn({N, 1, 3}, opts);
+    auto shN = torch::randn({N, 15, 3}, opts);
+    auto scaling = torch::randn({N, 3}, opts);
+    auto rotation = torch::nn::functional::normalize(torch::randn({N, 4}, opts),
+                                                     torch::nn::functional::NormalizeFuncOptions().dim(-1));
+    auto opacity = torch::randn({N, 1}, opts);
+    gs::SplatData splat(3, means.clone(), sh0.clone(), shN.clone(), scaling.clone(), rotation.clone(),
+                        opacity.clone(), 1.0f);
+
+    const auto root = std::filesystem::temp_directory_path() / "lfs_ply_round_trip";
+    std::filesystem::remove_all(root);
+    // The CUDA model goes through interleave_ply_vertices and the chunked snapshot writer
+    splat.save_ply(root, 0, /*join_threads=*/true, "round_trip");
+
+    auto loaded = gs::loader::Loader::create()->load(root / "round_trip.ply");
+    std::filesystem::remove_all(root);
+    ASSERT_TRUE(loaded.has_value()) << loaded.error();
+    ASSERT_TRUE(std::holds_alternative<std::shared_ptr<gs::SplatData>>(loaded->data));
+    const auto& result = *std::get<std::shared_ptr<gs::SplatData>>(loaded->data);
+
+    ASSERT_EQ(result.size(), N);
+    assertTensorClose(result.means().to(device), means);
+    assertTensorClose(result.sh0().to(device), sh0);
+    assertTensorClose(result.shN().to(device), shN);
+    assertTensorClose(result.scaling_raw().to(device), scaling);
+    assertTensorClose(result.rotation_raw().to(device), rotation);
+    assertTensorClose(result.opacity_raw().to(device), opacity);
+}
+
+TEST_F(BasicOpsTest, BinaryMaskAlignmentTest) {
+    // An asymmetric pattern: the left quarter and the top half are masked
+    constexpr int64_t W = 64;
+    constexpr int64_t H = 32;
+    auto pattern = torch::ones({1, H, W}, torch::kFloat32);
+    pattern.narrow(2, 0, W / 4).zero_();
+    pattern.narrow(1, 0, H / 2).zero_();
+
+    const auto path = std::filesystem::temp_directory_path() / "lfs_binary_mask_test.png";
+    save_image(path, pattern);
+
+    // Same size, then the size of an image two times larger
+    const auto same = load_binary_mask(path, H, W);
+    const auto upscaled = load_binary_mask(path, 2 * H, 2 * W);
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(same.sizes(), torch::IntArrayRef({1, H, W}));
+    EXPECT_EQ(same.scalar_type(), torch::kUInt8);
+    EXPECT_TRUE(same.is_pinned());
+    EXPECT_TRUE(torch::equal(same, pattern.to(torch::kUInt8)));
+
+    ASSERT_EQ(upscaled.sizes(), torch::IntArrayRef({1, 2 * H, 2 * W}));
+    const auto expected = pattern.repeat_interleave(2, 1).repeat_interleave(2, 2).to(torch::kUInt8);
+    EXPECT_TRUE(torch::equal(upscaled, expected));
+}
+
+TEST_F(BasicOpsTest, SparseAdamKeepsInvisibleGradients) {
+    auto param = torch::zeros({4, 3}, torch::TensorOptions().dtype(torch::kFloat32).device(device)).requires_grad_(true);
+    param.mutable_grad() = torch::ones_like(param);
+    gs::training::FusedAdam adam(std::vector<torch::Tensor>{param}, std::make_unique<gs::training::FusedAdam::Options>(0.1));
+
+    const auto visibility = torch::tensor({true, false, true, false}, torch::TensorOptions().dtype(torch::kBool)).to(device);
+    adam.set_visibility(visibility);
+    adam.step(1);
+    adam.zero_grad(true, 1);
+
+    // Only the visible rows moved and were cleared, the others wait for their next visible step
+    const auto moved = (param.detach() != 0).all(1);
+    EXPECT_TRUE(torch::equal(moved, visibility));
+    ASSERT_TRUE(param.grad().defined());
+    EXPECT_TRUE(torch::equal((param.grad() != 0).all(1), ~visibility));
+
+    // Without a mask the gradients are dropped as before
+    adam.step(2);
+    adam.zero_grad(true, 2);
+    EXPECT_FALSE(param.grad().defined());
+}
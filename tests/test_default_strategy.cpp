@@ -452,3 +452,28 @@ TEST_F(DefaultStrategyTest, ConsistentRenderingAfterOperationsTest) {
     // Images should be different due to optimization
     EXPECT_FALSE(torch::allclose(render1.image, render2.image));
 }
+
+TEST_F(DefaultStrategyTest, ReducedPrecisionSHStorageTest) {
+    params.optimization.sh_precision = "bfloat16";
+    auto splat_data = createTestSplatData(50);
+    auto strategy = std::make_unique<DefaultStrategy>(std::move(splat_data));
+    strategy->initialize(params.optimization);
+
+    EXPECT_EQ(strategy->get_model().shN().scalar_type(), torch::kBFloat16);
+    EXPECT_EQ(strategy->get_model().sh0().scalar_type(), torch::kFloat32);
+    auto shN_before = strategy->get_model().shN().clone();
+
+    // shN is only stepped after iteration 1000
+    auto render_output = performRendering(*strategy);
+    auto loss = render_output.image.sum();
+    loss.backward();
+    EXPECT_TRUE(strategy->get_model().shN().grad().defined());
+    strategy->step(1001);
+
+    EXPECT_EQ(strategy->get_model().shN().scalar_type(), torch::kBFloat16);
+    auto diff = (strategy->get_model().shN().to(torch::kFloat32) - shN_before.to(torch::kFloat32)).abs().sum();
+    EXPECT_GT(diff.item<float>(), 0) << "Reduced-precision SH coefficients should change after optimizer step";
+
+    render_output = performRendering(*strategy);
+    EXPECT_FALSE(render_output.image.isnan().any().item<bool>());
+}
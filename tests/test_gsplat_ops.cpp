@@ -62,6 +62,55 @@ TEST_F(GsplatOpsTest, RelocationTest) {
     EXPECT_TRUE((new_scales > 0).all().item<bool>());
 }
 
+TEST_F(GsplatOpsTest, RelocateRowsMatchesIndexPut) {
+    torch::manual_seed(42);
+
+    const int N = 64;
+    auto perm = torch::randperm(N, torch::TensorOptions().dtype(torch::kLong).device(device));
+    auto dst = perm.slice(0, 0, 10).contiguous();
+    // Sources repeat, as multinomial sampling with replacement does
+    auto src = perm.slice(0, 10, 15).repeat({2}).contiguous();
+
+    auto means = torch::randn({N, 3}, device);
+    auto shN = torch::randn({N, 15, 3}, device).to(torch::kFloat16); // odd number of halves per row
+    auto moment = torch::rand({N, 3}, device) + 1.0f;
+
+    auto expected_means = means.clone();
+    expected_means.index_put_({dst}, means.index_select(0, src));
+    auto expected_shN = shN.clone();
+    expected_shN.index_put_({dst}, shN.index_select(0, src));
+    auto expected_moment = moment.clone();
+    expected_moment.index_put_({src}, 0);
+
+    gsplat::relocate_rows(src, dst, {means, shN}, {moment});
+
+    EXPECT_TRUE(torch::equal(means, expected_means));
+    EXPECT_TRUE(torch::equal(shN, expected_shN));
+    EXPECT_TRUE(torch::equal(moment, expected_moment));
+}
+
+TEST_F(GsplatOpsTest, CompactRowsMatchesIndexSelect) {
+    torch::manual_seed(42);
+
+    const int N = 1000;
+    auto keep = torch::rand({N}, device) > 0.3f;
+    auto keep_idxs = keep.nonzero().squeeze(-1);
+    const int64_t M = keep_idxs.numel();
+
+    auto means = torch::randn({N, 3}, device);
+    auto shN = torch::randn({N, 15, 3}, device).to(torch::kBFloat16);
+    auto opacity = torch::randn({N, 1}, device);
+    auto expected_means = means.index_select(0, keep_idxs);
+    auto expected_shN = shN.index_select(0, keep_idxs);
+    auto expected_opacity = opacity.index_select(0, keep_idxs);
+
+    gsplat::compact_rows(keep_idxs, {means, shN, opacity});
+
+    EXPECT_TRUE(torch::equal(means.slice(0, 0, M), expected_means));
+    EXPECT_TRUE(torch::equal(shN.slice(0, 0, M), expected_shN));
+    EXPECT_TRUE(torch::equal(opacity.slice(0, 0, M), expected_opacity));
+}
+
 TEST_F(GsplatOpsTest, QuatScaleToCovarPreciGradientTest) {
     torch::manual_seed(42);
 
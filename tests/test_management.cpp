@@ -59,6 +59,13 @@ protected:
         data.data_set_info.images = generateRandomString(8);
         data.data_set_info.resize_factor = std::uniform_int_distribution<>(0, 5)(rng_);
         data.data_set_info.test_every = std::uniform_int_distribution<>(0, 5)(rng_);
+        int image_count = std::uniform_int_distribution<>(0, 5)(rng_);
+        for (int i = 0; i < image_count; ++i) {
+            data.data_set_info.image_info[generateRandomString(10) + ".jpg"] = {
+                std::uniform_int_distribution<>(1, 8000)(rng_),
+                std::uniform_int_distribution<>(1, 8000)(rng_),
+                3};
+        }
 
         // too lazy to test all fields - only test 2
         data.optimization.grad_threshold = std::uniform_real_distribution<float>(0, 10)(rng_);
@@ -137,6 +144,11 @@ protected:
             return false;
         }
 
+        if (a.data_set_info.image_info != b.data_set_info.image_info) {
+            std::cout << "image_info mismatch: " << a.data_set_info.image_info.size() << " vs " << b.data_set_info.image_info.size() << " entries" << std::endl;
+            return false;
+        }
+
         // Compare PLY outputs
         if (a.outputs.plys.size() != b.outputs.plys.size()) {
             std::cout << "PLY count mismatch: " << a.outputs.plys.size() << " vs " << b.outputs.plys.size() << std::endl;
@@ -260,4 +272,35 @@ TEST_F(ProjectTest, EmptyPlyArrayHandling) {
     const auto& loaded_data = loaded_project.getProjectData();
     EXPECT_TRUE(compareProjectData(data, loaded_data));
     EXPECT_TRUE(loaded_data.outputs.plys.empty());
-}
\ No newline at end of file
+}
+
+TEST_F(ProjectTest, ChangeTriggeredWritesCoalesce) {
+    std::filesystem::path temp_file = temp_dir_ / ("debounced" + gs::management::Project::EXTENSION);
+    auto data = generateRandomProjectData();
+    const size_t plys_before = data.outputs.plys.size();
+
+    {
+        gs::management::Project project(data, true);
+        project.setProjectFileName(temp_file);
+
+        // Written in the background once the changes settle, flushWrites writes them now
+        for (int i = 0; i < 50; ++i) {
+            ASSERT_TRUE(project.addPly(false, temp_dir_ / ("ply_" + std::to_string(i) + ".ply"), i,
+                                       "ply_" + std::to_string(i)));
+        }
+        project.flushWrites();
+        ASSERT_TRUE(std::filesystem::exists(temp_file));
+
+        gs::management::Project flushed(false);
+        ASSERT_TRUE(flushed.readFromFile(temp_file));
+        EXPECT_EQ(flushed.getPlys().size(), plys_before + 50);
+
+        // Destruction writes what is still pending
+        project.removePly("ply_0");
+    }
+
+    gs::management::Project loaded_project(false);
+    ASSERT_TRUE(loaded_project.readFromFile(temp_file));
+    EXPECT_EQ(loaded_project.getPlys().size(), plys_before + 49);
+    EXPECT_FALSE(std::filesystem::exists(temp_dir_ / ("debounced" + gs::management::Project::EXTENSION + ".tmp")));
+}
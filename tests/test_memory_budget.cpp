@@ -0,0 +1,287 @@
+#include "core/camera.hpp"
+#include "core/parameters.hpp"
+#include "core/splat_data.hpp"
+#include "rasterization/fast_rasterizer.hpp"
+#include "strategies/mcmc.hpp"
+#include "test_data_loader.hpp"
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAFunctions.h>
+#include <cstdlib>
+#include <cuda_runtime.h>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <torch/torch.h>
+
+using namespace test_utils;
+
+// Peak CUDA memory and host RSS of short fixed runs on the garden data, checked against the
+// committed budgets in tests/data/memory_budgets.json. Each budget is a fixed part plus bytes per
+// Gaussian and per image pixel, so it follows the size of the test data. A run without a budget
+// fails; LFS_RECORD_MEMORY_BUDGETS=1 writes the measured peaks to memory_budgets.recorded.json in
+// the build directory instead of checking, to tighten the committed file after an intended change.
+
+#ifndef LFS_TEST_DATA_DIR
+#define LFS_TEST_DATA_DIR "tests/data"
+#endif
+#ifndef LFS_TEST_OUTPUT_DIR
+#define LFS_TEST_OUTPUT_DIR "."
+#endif
+
+namespace {
+
+    constexpr double MB = 1024.0 * 1024.0;
+    constexpr double TOLERANCE = 1.10; // Run to run noise, a 20% regression still fails
+    constexpr int TRAINING_STEPS = 20;
+    constexpr size_t AGGREGATE = static_cast<size_t>(c10::CachingAllocator::StatType::AGGREGATE);
+
+    struct MemoryPeaks {
+        double allocated_mb = 0.0;
+        double reserved_mb = 0.0;
+        double rss_mb = 0.0; // Over the RSS when measuring started, negative where unsupported
+    };
+
+    // Linux only, VmHWM is the peak since the last reset through clear_refs
+    double read_status_mb(const std::string& key) {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.starts_with(key + ":")) {
+                return std::stod(line.substr(key.size() + 1)) / 1024.0; // kB
+            }
+        }
+        return -1.0;
+    }
+
+    bool reset_peak_rss() {
+        std::ofstream clear_refs("/proc/self/clear_refs");
+        clear_refs << "5";
+        return clear_refs.good();
+    }
+
+    class MemoryMeter {
+    public:
+        MemoryMeter() {
+            torch::cuda::synchronize();
+            c10::cuda::CUDACachingAllocator::emptyCache();
+            device_ = c10::cuda::current_device();
+            c10::cuda::CUDACachingAllocator::resetPeakStats(device_);
+            rss_supported_ = reset_peak_rss();
+            rss_start_mb_ = read_status_mb("VmRSS");
+        }
+
+        MemoryPeaks stop() const {
+            torch::cuda::synchronize();
+            const auto stats = c10::cuda::CUDACachingAllocator::getDeviceStats(device_);
+            MemoryPeaks peaks;
+            peaks.allocated_mb = static_cast<double>(stats.allocated_bytes[AGGREGATE].peak) / MB;
+            peaks.reserved_mb = static_cast<double>(stats.reserved_bytes[AGGREGATE].peak) / MB;
+            const double rss_peak_mb = read_status_mb("VmHWM");
+            peaks.rss_mb = rss_supported_ && rss_peak_mb >= 0.0 ? rss_peak_mb - rss_start_mb_ : -1.0;
+            return peaks;
+        }
+
+    private:
+        int device_ = 0;
+        bool rss_supported_ = false;
+        double rss_start_mb_ = 0.0;
+    };
+
+    // Size of the run a budget scales with
+    struct Workload {
+        int64_t gaussians = 0;
+        int64_t pixels = 0; // Of one view
+    };
+
+    std::filesystem::path budgets_path() {
+        return std::filesystem::path(LFS_TEST_DATA_DIR) / "memory_budgets.json";
+    }
+
+    // Written by record mode only, never into the source tree
+    std::filesystem::path recorded_path() {
+        return std::filesystem::path(LFS_TEST_OUTPUT_DIR) / "memory_budgets.recorded.json";
+    }
+
+    nlohmann::json load_json(const std::filesystem::path& path) {
+        std::ifstream file(path);
+        if (!file.good()) {
+            return nlohmann::json::object();
+        }
+        return nlohmann::json::parse(file, nullptr, false, true);
+    }
+
+    bool record_mode() {
+        const char* record = std::getenv("LFS_RECORD_MEMORY_BUDGETS");
+        return record && std::string(record) == "1";
+    }
+
+    void record_peaks(const std::string& name, const MemoryPeaks& peaks, const Workload& workload) {
+        auto recorded = load_json(recorded_path());
+        if (!recorded.is_object()) {
+            recorded = nlohmann::json::object();
+        }
+        recorded[name] = {{"gaussians", workload.gaussians},
+                          {"pixels", workload.pixels},
+                          {"peak_allocated_mb", peaks.allocated_mb},
+                          {"peak_reserved_mb", peaks.reserved_mb},
+                          {"peak_rss_mb", peaks.rss_mb}};
+        std::ofstream(recorded_path()) << recorded.dump(4) << "\n";
+    }
+
+    // Budget in MB of one metric: {"fixed_mb", "bytes_per_gaussian", "bytes_per_pixel"}
+    double allowed_mb(const nlohmann::json& budget, const Workload& workload) {
+        return budget.value("fixed_mb", 0.0) +
+               (budget.value("bytes_per_gaussian", 0.0) * static_cast<double>(workload.gaussians) +
+                budget.value("bytes_per_pixel", 0.0) * static_cast<double>(workload.pixels)) /
+                   MB;
+    }
+
+    // True when the peaks were checked, false when record mode wrote them out instead
+    bool check_budget(const std::string& name, const MemoryPeaks& peaks, const Workload& workload) {
+        std::cout << name << ": peak allocated " << peaks.allocated_mb << " MB, peak reserved "
+                  << peaks.reserved_mb << " MB, peak RSS growth " << peaks.rss_mb << " MB" << std::endl;
+
+        if (record_mode()) {
+            record_peaks(name, peaks, workload);
+            return false;
+        }
+
+        const auto budgets = load_json(budgets_path());
+        if (!budgets.is_object() || !budgets.contains(name)) {
+            ADD_FAILURE() << "No memory budget for " << name << " in " << budgets_path()
+                          << ", run with LFS_RECORD_MEMORY_BUDGETS=1 to measure one";
+            return true;
+        }
+
+        const auto& budget = budgets.at(name);
+        const auto expect_within = [&](const char* key, double measured) {
+            ASSERT_TRUE(budget.contains(key)) << name << " has no " << key << " budget";
+            const double allowed = allowed_mb(budget.at(key), workload);
+            EXPECT_LE(measured, allowed * TOLERANCE) << name << " " << key << " " << measured
+                                                     << " MB exceeds the budget of " << allowed << " MB";
+        };
+        expect_within("peak_allocated_mb", peaks.allocated_mb);
+        expect_within("peak_reserved_mb", peaks.reserved_mb);
+        // Small host budgets are within allocator noise
+        if (peaks.rss_mb >= 0.0 && budget.contains("peak_rss_mb") && allowed_mb(budget.at("peak_rss_mb"), workload) >= 64.0) {
+            expect_within("peak_rss_mb", peaks.rss_mb);
+        }
+        return true;
+    }
+
+} // namespace
+
+class MemoryBudgetTest : public ::testing::Test {
+protected:
+    static TestData test_data;
+    static bool data_loaded;
+
+    static void SetUpTestSuite() {
+        if (!torch::cuda::is_available()) {
+            return;
+        }
+        try {
+            test_data = load_test_data(torch::kCUDA);
+            data_loaded = true;
+        } catch (const std::exception& e) {
+            std::cerr << "Failed to load test data: " << e.what() << std::endl;
+        }
+    }
+
+    void SetUp() override {
+        if (!torch::cuda::is_available()) {
+            GTEST_SKIP() << "CUDA not available";
+        }
+        if (!data_loaded) {
+            GTEST_SKIP() << "Test data not available";
+        }
+        torch::manual_seed(0);
+    }
+
+    // The garden Gaussians as a degree 3 model with zero higher bands
+    gs::SplatData createGardenSplatData() const {
+        torch::NoGradGuard no_grad;
+        const int64_t n = test_data.means.size(0);
+        const auto colors = test_data.colors.dim() == 3 ? test_data.colors[0] : test_data.colors;
+        constexpr float SH_C0 = 0.28209479177387814f;
+        auto sh0 = ((colors - 0.5f) / SH_C0).view({n, 1, 3}).contiguous();
+        auto shN = torch::zeros({n, 15, 3}, sh0.options());
+        auto scaling = torch::log(test_data.scales.clamp_min(1e-8f));
+        auto opacity = torch::logit(test_data.opacities.clamp(1e-4f, 1.0f - 1e-4f)).view({n, 1});
+        return gs::SplatData(3, test_data.means.clone(), sh0, shN, scaling, test_data.quats.clone(), opacity, 1.0f);
+    }
+
+    gs::Camera createCamera(int64_t index) const {
+        const auto viewmat = test_data.viewmats[index].cpu();
+        const auto K = test_data.Ks[index].cpu();
+        return gs::Camera(viewmat.slice(0, 0, 3).slice(1, 0, 3).contiguous(),
+                          viewmat.slice(0, 0, 3).select(1, 3).contiguous(),
+                          K[0][0].item<float>(), K[1][1].item<float>(),
+                          K[0][2].item<float>(), K[1][2].item<float>(),
+                          torch::empty({0}, torch::kFloat32),
+                          torch::empty({0}, torch::kFloat32),
+                          gsplat::CameraModelType::PINHOLE,
+                          "garden_" + std::to_string(index),
+                          "", test_data.width, test_data.height, static_cast<int>(index));
+    }
+
+};
+
+TestData MemoryBudgetTest::test_data;
+bool MemoryBudgetTest::data_loaded = false;
+
+// fastgs forward, backward and MCMC steps without refinement: model, moments and the
+// rasterizer's forward and backward buffers
+TEST_F(MemoryBudgetTest, FastgsTrainingPeak) {
+    gs::param::TrainingParameters params{};
+    params.optimization.iterations = TRAINING_STEPS;
+    params.optimization.sh_degree = 3;
+    params.optimization.max_cap = static_cast<int>(test_data.means.size(0));
+    params.optimization.start_refine = TRAINING_STEPS + 1;
+    params.optimization.stop_refine = TRAINING_STEPS + 1;
+
+    MemoryMeter meter;
+    {
+        auto strategy = std::make_unique<gs::training::MCMC>(createGardenSplatData());
+        strategy->initialize(params.optimization);
+        auto background = torch::zeros({3}, torch::kCUDA);
+        const int64_t cameras = test_data.viewmats.size(0);
+        for (int iter = 1; iter <= TRAINING_STEPS; ++iter) {
+            auto camera = createCamera((iter - 1) % cameras);
+            auto output = gs::training::fast_rasterize(camera, strategy->get_model(), background);
+            auto loss = (output.image - 0.5f).abs().mean();
+            loss.backward();
+            strategy->post_backward(iter, output);
+            strategy->step(iter);
+        }
+    }
+    const auto peaks = meter.stop();
+
+    const Workload workload{test_data.means.size(0), static_cast<int64_t>(test_data.width) * test_data.height};
+    if (!check_budget("fastgs_training", peaks, workload)) {
+        GTEST_SKIP() << "Recorded the fastgs_training peaks in " << recorded_path();
+    }
+}
+
+// Inference renders of every camera, as evaluation and the viewer run them
+TEST_F(MemoryBudgetTest, FastgsRenderPeak) {
+    MemoryMeter meter;
+    {
+        auto model = createGardenSplatData();
+        const auto background = torch::zeros({3}, torch::kCUDA);
+        for (int64_t i = 0; i < test_data.viewmats.size(0); ++i) {
+            auto camera = createCamera(i);
+            const auto output = gs::training::fast_render(camera, model, background);
+            ASSERT_EQ(output.image.size(1), test_data.height);
+        }
+    }
+    const auto peaks = meter.stop();
+
+    const Workload workload{test_data.means.size(0), static_cast<int64_t>(test_data.width) * test_data.height};
+    if (!check_budget("fastgs_render", peaks, workload)) {
+        GTEST_SKIP() << "Recorded the fastgs_render peaks in " << recorded_path();
+    }
+}
@@ -1,9 +1,13 @@
 #include "Ops.h"
 #include "core/camera.hpp"
 #include "core/splat_data.hpp"
+#include "rasterization/fast_rasterizer.hpp"
 #include "rasterization/rasterizer.hpp"
 #include "rasterization/rasterizer_autograd.hpp"
+#include "rasterization/rasterizer_backend.hpp"
+#include "rasterizer_context.h"
 #include "torch_impl.hpp"
+#include <chrono>
 #include <cmath>
 #include <gtest/gtest.h>
 #include <iostream>
@@ -854,4 +858,320 @@ TEST_F(RasterizationComparisonTest, TestEdgeCases) {
         EXPECT_TRUE((ref_render <= 1.1f).all().item<bool>()) << "Values too large in render";
         EXPECT_FALSE(ref_render.isnan().any().item<bool>()) << "NaN in render";
     }
-}
\ No newline at end of file
+}
+
+TEST_F(RasterizationComparisonTest, PackedMatchesDense) {
+    torch::manual_seed(42);
+
+    const int N = 2000;
+    const int width = 64;
+    const int height = 64;
+    const float focal = 100.0f;
+    const int sh_degree = 2;
+
+    // Spread wide enough that a good share of the Gaussians is culled
+    auto means = (torch::rand({N, 3}, device) - 0.5f) * 6.0f;
+    means.select(1, 2) = torch::abs(means.select(1, 2)) + 1.0f;
+    auto quats = torch::nn::functional::normalize(
+        torch::randn({N, 4}, device), torch::nn::functional::NormalizeFuncOptions().dim(-1));
+    auto scales = torch::rand({N, 3}, device) * 0.05f + 0.01f;
+    auto opacities = torch::rand({N}, device) * 0.8f + 0.1f;
+    const int num_sh_coeffs = (sh_degree + 1) * (sh_degree + 1);
+    auto sh_coeffs = torch::randn({N, num_sh_coeffs, 3}, device) * 0.1f;
+
+    Camera camera(torch::eye(3, torch::kCPU), torch::zeros({3}, torch::kCPU), focal, focal,
+                  0.5 * width, 0.5 * height,
+                  torch::empty({0}, torch::kFloat32), torch::empty({0}, torch::kFloat32),
+                  gsplat::CameraModelType::PINHOLE, "test_camera", "", width, height, 0);
+    auto bg = torch::full({3}, 0.2f, device);
+
+    auto render = [&](bool packed) {
+        auto gaussians = SplatData(
+            sh_degree, means.clone(), sh_coeffs.slice(1, 0, 1).clone(), sh_coeffs.slice(1, 1, num_sh_coeffs).clone(),
+            torch::log(scales), quats.clone(), torch::logit(opacities).unsqueeze(-1), 1.0f);
+        while (gaussians.get_active_sh_degree() < sh_degree) {
+            gaussians.increment_sh_degree();
+        }
+        gaussians.means().set_requires_grad(true);
+        gaussians.opacity_raw().set_requires_grad(true);
+        gaussians.sh0().set_requires_grad(true);
+
+        auto output = gs::rasterize(camera, gaussians, bg, 1.0f, packed);
+        output.image.sum().backward();
+        return std::make_tuple(output.image.detach(), output.radii,
+                               gaussians.means().grad(), gaussians.opacity_raw().grad(), gaussians.sh0().grad());
+    };
+
+    auto [dense_image, dense_radii, dense_v_means, dense_v_opacities, dense_v_sh0] = render(false);
+    auto [packed_image, packed_radii, packed_v_means, packed_v_opacities, packed_v_sh0] = render(true);
+
+    const auto visible = (dense_radii > 0).sum().item<int64_t>();
+    std::cout << "Visible gaussians: " << visible << "/" << N << std::endl;
+    EXPECT_GT(visible, 0);
+    EXPECT_LT(visible, N) << "Test scene should cull some Gaussians";
+
+    EXPECT_TRUE(torch::equal(dense_radii, packed_radii));
+    EXPECT_TRUE(torch::allclose(dense_image, packed_image, 1e-5, 1e-5));
+    EXPECT_TRUE(torch::allclose(dense_v_means, packed_v_means, 1e-4, 1e-5));
+    EXPECT_TRUE(torch::allclose(dense_v_opacities, packed_v_opacities, 1e-4, 1e-5));
+    EXPECT_TRUE(torch::allclose(dense_v_sh0, packed_v_sh0, 1e-4, 1e-5));
+}
+
+TEST_F(RasterizationComparisonTest, BackendParity) {
+    torch::manual_seed(42);
+
+    const int N = 5000;
+    const int width = 128;
+    const int height = 96;
+    const float focal = 120.0f;
+    const int sh_degree = 1;
+    constexpr int timed_runs = 10;
+
+    auto means = (torch::rand({N, 3}, device) - 0.5f) * 3.0f;
+    means.select(1, 2) = torch::abs(means.select(1, 2)) + 2.0f;
+    auto quats = torch::nn::functional::normalize(
+        torch::randn({N, 4}, device), torch::nn::functional::NormalizeFuncOptions().dim(-1));
+    auto scales = torch::rand({N, 3}, device) * 0.03f + 0.01f;
+    auto opacities = torch::rand({N}, device) * 0.8f + 0.1f;
+    const int num_sh_coeffs = (sh_degree + 1) * (sh_degree + 1);
+    auto sh_coeffs = torch::randn({N, num_sh_coeffs, 3}, device) * 0.1f;
+
+    Camera camera(torch::eye(3, torch::kCPU), torch::zeros({3}, torch::kCPU), focal, focal,
+                  0.5 * width, 0.5 * height,
+                  torch::empty({0}, torch::kFloat32), torch::empty({0}, torch::kFloat32),
+                  gsplat::CameraModelType::PINHOLE, "test_camera", "", width, height, 0);
+    auto bg = torch::full({3}, 0.1f, device);
+
+    fast_gs::rasterization::RasterizerContext context;
+    param::OptimizationParameters params;
+    std::vector<std::unique_ptr<training::IRasterizerBackend>> backends;
+    for (const auto& name : training::rasterizer_backend_names()) {
+        auto backend = training::create_rasterizer_backend(name, params, &context);
+        ASSERT_TRUE(backend.has_value()) << backend.error();
+        ASSERT_TRUE(training::check_camera_supported(**backend, camera).has_value()) << name;
+        backends.push_back(std::move(*backend));
+    }
+    EXPECT_FALSE(training::create_rasterizer_backend("unknown", params).has_value());
+
+    struct Result {
+        torch::Tensor image;
+        torch::Tensor v_means;
+        torch::Tensor v_opacities;
+        double ms;
+    };
+    auto run = [&](training::IRasterizerBackend& backend) {
+        auto gaussians = SplatData(
+            sh_degree, means.clone(), sh_coeffs.slice(1, 0, 1).clone(), sh_coeffs.slice(1, 1, num_sh_coeffs).clone(),
+            torch::log(scales), quats.clone(), torch::logit(opacities).unsqueeze(-1), 1.0f);
+        while (gaussians.get_active_sh_degree() < sh_degree) {
+            gaussians.increment_sh_degree();
+        }
+        gaussians.means().set_requires_grad(true);
+        gaussians.opacity_raw().set_requires_grad(true);
+
+        auto step = [&] {
+            gaussians.means().mutable_grad() = torch::Tensor();
+            gaussians.opacity_raw().mutable_grad() = torch::Tensor();
+            auto output = backend.render(camera, gaussians, bg);
+            output.image.sum().backward();
+            return output.image.detach();
+        };
+
+        step(); // warmup
+        torch::cuda::synchronize();
+        const auto start = std::chrono::steady_clock::now();
+        torch::Tensor image;
+        for (int i = 0; i < timed_runs; ++i) {
+            image = step();
+        }
+        torch::cuda::synchronize();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / timed_runs;
+        return Result{image, gaussians.means().grad().clone(), gaussians.opacity_raw().grad().clone(), ms};
+    };
+
+    std::vector<Result> results;
+    for (auto& backend : backends) {
+        results.push_back(run(*backend));
+        std::cout << backend->name() << ": " << results.back().ms << " ms per forward + backward" << std::endl;
+    }
+
+    auto cosine = [](const torch::Tensor& a, const torch::Tensor& b) {
+        return torch::nn::functional::cosine_similarity(
+                   a.flatten().unsqueeze(0), b.flatten().unsqueeze(0),
+                   torch::nn::functional::CosineSimilarityFuncOptions().dim(1))
+            .item<float>();
+    };
+
+    // The backends project differently (EWA against the unscented transform), so images and
+    // gradients agree closely but not exactly
+    const auto& reference = results[0];
+    for (size_t i = 1; i < results.size(); ++i) {
+        const auto& other = results[i];
+        ASSERT_EQ(reference.image.sizes(), other.image.sizes());
+        const float mean_diff = (reference.image - other.image).abs().mean().item<float>();
+        std::cout << backends[0]->name() << " vs " << backends[i]->name()
+                  << ": image mean abs diff " << mean_diff
+                  << ", v_means cosine " << cosine(reference.v_means, other.v_means)
+                  << ", v_opacities cosine " << cosine(reference.v_opacities, other.v_opacities) << std::endl;
+        EXPECT_LT(mean_diff, 0.01f);
+        EXPECT_GT(cosine(reference.v_means, other.v_means), 0.9f);
+        EXPECT_GT(cosine(reference.v_opacities, other.v_opacities), 0.95f);
+    }
+}
+
+TEST_F(RasterizationComparisonTest, BatchMatchesSingle) {
+    torch::manual_seed(42);
+
+    const int N = 3000;
+    const float focal = 100.0f;
+    const int sh_degree = 2;
+
+    auto means = (torch::rand({N, 3}, device) - 0.5f) * 3.0f;
+    means.select(1, 2) = torch::abs(means.select(1, 2)) + 2.0f;
+    auto quats = torch::nn::functional::normalize(
+        torch::randn({N, 4}, device), torch::nn::functional::NormalizeFuncOptions().dim(-1));
+    auto scales = torch::rand({N, 3}, device) * 0.03f + 0.01f;
+    auto opacities = torch::rand({N}, device) * 0.8f + 0.1f;
+    const int num_sh_coeffs = (sh_degree + 1) * (sh_degree + 1);
+    auto sh_coeffs = torch::randn({N, num_sh_coeffs, 3}, device) * 0.1f;
+
+    auto gaussians = SplatData(
+        sh_degree, means.clone(), sh_coeffs.slice(1, 0, 1).clone(), sh_coeffs.slice(1, 1, num_sh_coeffs).clone(),
+        torch::log(scales), quats.clone(), torch::logit(opacities).unsqueeze(-1), 1.0f);
+    while (gaussians.get_active_sh_degree() < sh_degree) {
+        gaussians.increment_sh_degree();
+    }
+
+    // Two resolutions and a distorted camera in one batch, the last one is its own group
+    struct View {
+        float tx;
+        int width;
+        int height;
+        std::vector<float> radial;
+    };
+    const std::vector<View> views = {{0.0f, 64, 48, {}}, {0.3f, 64, 48, {0.05f, -0.01f}}, {-0.3f, 64, 48, {}}, {0.1f, 80, 40, {}}};
+    std::vector<std::unique_ptr<Camera>> cameras;
+    std::vector<Camera*> camera_ptrs;
+    for (size_t i = 0; i < views.size(); ++i) {
+        const auto& view = views[i];
+        cameras.push_back(std::make_unique<Camera>(
+            torch::eye(3, torch::kCPU), torch::tensor({view.tx, 0.0f, 0.0f}), focal, focal,
+            0.5f * view.width, 0.5f * view.height,
+            torch::tensor(view.radial, torch::kFloat32), torch::empty({0}, torch::kFloat32),
+            gsplat::CameraModelType::PINHOLE, "test_camera", "", view.width, view.height, static_cast<int>(i)));
+        camera_ptrs.push_back(cameras.back().get());
+    }
+    auto bg = torch::full({3}, 0.2f, device);
+
+    const auto batched = training::rasterize_batch(camera_ptrs, gaussians, bg);
+    // A 1 MB budget forces one camera per chunk
+    const auto chunked = training::rasterize_batch(camera_ptrs, gaussians, bg, 1);
+    ASSERT_EQ(batched.size(), cameras.size());
+
+    torch::NoGradGuard no_grad;
+    for (size_t i = 0; i < cameras.size(); ++i) {
+        const auto single = training::rasterize(*cameras[i], gaussians, bg);
+        ASSERT_EQ(batched[i].image.sizes(), single.image.sizes()) << "view " << i;
+        EXPECT_TRUE(torch::allclose(batched[i].image, single.image, 1e-5, 1e-5)) << "view " << i;
+        EXPECT_TRUE(torch::allclose(chunked[i].image, single.image, 1e-5, 1e-5)) << "view " << i;
+        EXPECT_TRUE(torch::allclose(batched[i].alpha, single.alpha, 1e-5, 1e-5)) << "view " << i;
+    }
+}
+
+TEST_F(RasterizationComparisonTest, UpperBoundOverflowMatchesExact) {
+    torch::manual_seed(42);
+
+    const int N = 4000;
+    const int width = 128;
+    const int height = 96;
+    const float focal = 120.0f;
+
+    auto means = (torch::rand({N, 3}, device) - 0.5f) * 3.0f;
+    means.select(1, 2) = torch::abs(means.select(1, 2)) + 2.0f;
+    auto quats = torch::nn::functional::normalize(
+        torch::randn({N, 4}, device), torch::nn::functional::NormalizeFuncOptions().dim(-1));
+    auto scales = torch::rand({N, 3}, device) * 0.03f + 0.01f;
+    auto opacities = torch::rand({N}, device) * 0.8f + 0.1f;
+    auto sh0 = torch::randn({N, 1, 3}, device) * 0.1f;
+
+    Camera camera(torch::eye(3, torch::kCPU), torch::zeros({3}, torch::kCPU), focal, focal,
+                  0.5 * width, 0.5 * height,
+                  torch::empty({0}, torch::kFloat32), torch::empty({0}, torch::kFloat32),
+                  gsplat::CameraModelType::PINHOLE, "test_camera", "", width, height, 0);
+    auto bg = torch::full({3}, 0.1f, device);
+
+    auto make_gaussians = [&](int64_t n) {
+        auto gaussians = SplatData(
+            1, means.narrow(0, 0, n).clone(), sh0.narrow(0, 0, n).clone(), torch::zeros({n, 3, 3}, device),
+            torch::log(scales.narrow(0, 0, n)), quats.narrow(0, 0, n).clone(),
+            torch::logit(opacities.narrow(0, 0, n)).unsqueeze(-1), 1.0f);
+        gaussians.means().set_requires_grad(true);
+        gaussians.opacity_raw().set_requires_grad(true);
+        return gaussians;
+    };
+    auto render = [&](fast_gs::rasterization::RasterizerContext& context, SplatData& gaussians) {
+        auto output = training::fast_rasterize(camera, gaussians, bg, &context);
+        output.image.sum().backward();
+        return output.image.detach();
+    };
+
+    // A few Gaussians size the upper-bound capacity far below what the full model needs
+    fast_gs::rasterization::RasterizerContext upper_bound_context(true);
+    auto sparse = make_gaussians(N / 100);
+    render(upper_bound_context, sparse);
+    render(upper_bound_context, sparse);
+    const int capacity = upper_bound_context.instance_capacity;
+
+    auto full = make_gaussians(N);
+    const auto image = render(upper_bound_context, full);
+    EXPECT_EQ(upper_bound_context.instance_overflows, 1);
+    EXPECT_GT(upper_bound_context.instance_capacity, capacity);
+
+    fast_gs::rasterization::RasterizerContext exact_context;
+    auto reference = make_gaussians(N);
+    const auto expected = render(exact_context, reference);
+
+    EXPECT_TRUE(torch::allclose(image, expected, 1e-5, 1e-5))
+        << "max diff " << (image - expected).abs().max().item<float>();
+    EXPECT_TRUE(torch::allclose(full.means().grad(), reference.means().grad(), 1e-4, 1e-5));
+    EXPECT_TRUE(torch::allclose(full.opacity_raw().grad(), reference.opacity_raw().grad(), 1e-4, 1e-5));
+}
+
+TEST_F(RasterizationComparisonTest, PixelMaskSkipsMaskedTiles) {
+    torch::manual_seed(42);
+
+    const int N = 3000;
+    const int width = 128;
+    const int height = 96;
+    const float focal = 120.0f;
+
+    auto means = (torch::rand({N, 3}, device) - 0.5f) * 3.0f;
+    means.select(1, 2) = torch::abs(means.select(1, 2)) + 2.0f;
+    auto quats = torch::nn::functional::normalize(
+        torch::randn({N, 4}, device), torch::nn::functional::NormalizeFuncOptions().dim(-1));
+    auto scales = torch::rand({N, 3}, device) * 0.03f + 0.01f;
+    auto opacities = torch::rand({N}, device) * 0.8f + 0.1f;
+    auto gaussians = SplatData(
+        1, means, torch::randn({N, 1, 3}, device) * 0.1f, torch::zeros({N, 3, 3}, device),
+        torch::log(scales), quats, torch::logit(opacities).unsqueeze(-1), 1.0f);
+
+    Camera camera(torch::eye(3, torch::kCPU), torch::zeros({3}, torch::kCPU), focal, focal,
+                  0.5 * width, 0.5 * height,
+                  torch::empty({0}, torch::kFloat32), torch::empty({0}, torch::kFloat32),
+                  gsplat::CameraModelType::PINHOLE, "test_camera", "", width, height, 0);
+    auto bg = torch::full({3}, 0.25f, device);
+
+    // The left 40 columns: tiles 0 and 1 are fully masked, tile 2 only partly and still blends
+    auto pixel_mask = torch::ones({1, height, width}, device);
+    pixel_mask.narrow(2, 0, 40).zero_();
+
+    torch::NoGradGuard no_grad;
+    const auto unmasked = training::fast_rasterize(camera, gaussians, bg);
+    const auto masked = training::fast_rasterize(camera, gaussians, bg, nullptr, true, pixel_mask);
+
+    const auto skipped = masked.image.narrow(2, 0, 32);
+    EXPECT_TRUE(torch::allclose(skipped, bg.view({3, 1, 1}).expand_as(skipped)));
+    EXPECT_TRUE(torch::equal(masked.alpha.narrow(2, 0, 32), torch::zeros_like(masked.alpha.narrow(2, 0, 32))));
+    EXPECT_GT(unmasked.alpha.narrow(2, 0, 32).max().item<float>(), 0.0f);
+    EXPECT_TRUE(torch::allclose(masked.image.narrow(2, 32, width - 32), unmasked.image.narrow(2, 32, width - 32)));
+}
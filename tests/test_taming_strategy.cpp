@@ -0,0 +1,115 @@
+#include "core/camera.hpp"
+#include "core/parameters.hpp"
+#include "core/splat_data.hpp"
+#include "rasterization/rasterizer.hpp"
+#include "strategies/taming_strategy.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <torch/torch.h>
+
+using namespace gs;
+
+class TamingStrategyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!torch::cuda::is_available()) {
+            GTEST_SKIP() << "CUDA not available";
+        }
+        device = torch::kCUDA;
+
+        params.optimization.iterations = 18000;
+        params.optimization.max_cap = 400;
+        params.optimization.start_refine = 500;
+        params.optimization.stop_refine = 1500;
+        params.optimization.refine_every = 100;
+        params.optimization.sh_degree = 3;
+
+        auto R = torch::eye(3, torch::kFloat32);
+        auto T = torch::tensor({0.0f, 0.0f, 5.0f}, torch::kFloat32);
+        float fov = M_PI / 3.0f;
+        int width = 256;
+        int height = 256;
+        test_camera = std::make_unique<Camera>(
+            R, T, fov2focal(fov, width),
+            fov2focal(fov, height),
+            0.5 * width,
+            0.5 * height,
+            torch::empty({0}, torch::kFloat32),
+            torch::empty({0}, torch::kFloat32),
+            gsplat::CameraModelType::PINHOLE,
+            "test_camera",
+            "", width, height, 0);
+
+        background = torch::zeros({3}, device);
+    }
+
+    SplatData createTestSplatData(int N) {
+        torch::NoGradGuard no_grad;
+
+        auto means = torch::randn({N, 3}, torch::kFloat32);
+        auto sh0 = torch::randn({N, 1, 3}, torch::kFloat32);
+        auto shN = torch::randn({N, (params.optimization.sh_degree + 1) * (params.optimization.sh_degree + 1) - 1, 3}, torch::kFloat32);
+        auto scaling = torch::randn({N, 3}, torch::kFloat32) - 2.0f;
+        auto rotation = torch::randn({N, 4}, torch::kFloat32);
+        // Opaque enough to survive the pruning after growth
+        auto opacity = torch::full({N, 1}, 2.0f, torch::kFloat32);
+
+        return SplatData(params.optimization.sh_degree, means, sh0, shN, scaling, rotation, opacity, 1.0f);
+    }
+
+    gs::RenderOutput performRendering(training::TamingStrategy& strategy) {
+        auto bg_copy = background.clone();
+        return gs::rasterize(*test_camera, strategy.get_model(), bg_copy, 1.0f, false);
+    }
+
+    torch::Device device{torch::kCPU};
+    gs::param::TrainingParameters params{};
+    std::unique_ptr<Camera> test_camera;
+    torch::Tensor background;
+};
+
+TEST_F(TamingStrategyTest, GrowthScheduleReachesBudget) {
+    auto strategy = std::make_unique<training::TamingStrategy>(createTestSplatData(100));
+    strategy->initialize(params.optimization);
+
+    EXPECT_EQ(strategy->target_count(params.optimization.start_refine), 100);
+    EXPECT_EQ(strategy->target_count(params.optimization.stop_refine), params.optimization.max_cap);
+
+    int64_t previous = 0;
+    for (int iter = 0; iter <= 2000; iter += 100) {
+        const int64_t target = strategy->target_count(iter);
+        EXPECT_GE(target, previous);
+        previous = target;
+    }
+}
+
+TEST_F(TamingStrategyTest, RefinementGrowsTowardsTarget) {
+    auto strategy = std::make_unique<training::TamingStrategy>(createTestSplatData(100));
+    strategy->initialize(params.optimization);
+
+    auto render_output = performRendering(*strategy);
+    render_output.image.mean().backward();
+    strategy->step(1);
+
+    // gs::rasterize does not accumulate screen-space gradients, seed them as fastgs would:
+    // every Gaussian seen once with a positive gradient norm
+    auto seed_densification_info = [&] {
+        auto& model = strategy->get_model();
+        const auto n = model.size();
+        model._densification_info = torch::stack({torch::ones({n}, device), torch::rand({n}, device) + 0.1f}, 1)
+                                        .to(torch::kHalf);
+    };
+
+    int64_t previous = strategy->get_model().size();
+    for (const int iter : {600, 700, 800}) {
+        seed_densification_info();
+        strategy->post_backward(iter, render_output);
+
+        // Growth moves towards the schedule without overshooting it, pruning only removes
+        const int64_t size = strategy->get_model().size();
+        EXPECT_GT(size, previous) << "iteration " << iter;
+        EXPECT_LE(size, strategy->target_count(iter)) << "iteration " << iter;
+        EXPECT_EQ(strategy->get_model().means().size(0), strategy->get_model().opacity_raw().size(0));
+        previous = size;
+    }
+}